@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Forward.h>
+#include <AK/kmalloc.h>
+
+namespace AK {
+
+// The allocator that containers use unless they're given another one, e.g. an ArenaAllocator.
+// Allocators are stored in the containers they're used by, so stateless ones like this don't take up any space.
+struct DefaultAllocator {
+    // The returned memory is aligned to at least alignof(max_align_t), which covers anything our containers store.
+    [[nodiscard]] static void* allocate(size_t size, [[maybe_unused]] size_t alignment) { return kmalloc(size); }
+    [[nodiscard]] static void* allocate_zeroed(size_t size, [[maybe_unused]] size_t alignment) { return kcalloc(1, size); }
+    static void deallocate(void* ptr, size_t size) { kfree_sized(ptr, size); }
+
+    // How many bytes an allocation of the given size actually gets, so that containers can make use of all of them.
+    static size_t good_size(size_t size) { return kmalloc_good_size(size); }
+};
+
+}
+
+#if USING_AK_GLOBALLY
+using AK::DefaultAllocator;
+#endif
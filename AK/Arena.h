@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <AK/Noncopyable.h>
+#include <AK/NumericLimits.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+#include <AK/kmalloc.h>
+
+namespace AK {
+
+// Hands out memory by bumping a pointer through large chunks, and frees all of it at once when it's cleared or destroyed.
+// This is meant for lots of short-lived allocations that all die together, like the data built up while parsing something.
+class Arena {
+    AK_MAKE_NONCOPYABLE(Arena);
+    AK_MAKE_NONMOVABLE(Arena);
+
+public:
+    static constexpr size_t default_chunk_size = 64 * KiB;
+
+    explicit Arena(size_t chunk_size = default_chunk_size)
+        : m_chunk_size(kmalloc_good_size(chunk_size))
+    {
+    }
+
+    ~Arena()
+    {
+        clear();
+    }
+
+    // Returns nullptr if we ran out of memory.
+    [[nodiscard]] void* allocate(size_t size, size_t alignment)
+    {
+        VERIFY(is_power_of_two(alignment));
+        auto aligned_ptr = align_up_to(m_next, alignment);
+        if (aligned_ptr > m_end || size > m_end - aligned_ptr) [[unlikely]]
+            return allocate_in_new_chunk(size, alignment);
+        m_next = aligned_ptr + size;
+        m_allocated_size += size;
+        return reinterpret_cast<void*>(aligned_ptr);
+    }
+
+    // Memory is only given back to the arena if it was the last thing allocated from it, e.g. a Vector that's resized while nothing else is being allocated.
+    // Everything else stays around until the arena is cleared.
+    void deallocate(void* ptr, size_t size)
+    {
+        if (!ptr)
+            return;
+        m_allocated_size -= size;
+        if (reinterpret_cast<FlatPtr>(ptr) + size == m_next)
+            m_next = reinterpret_cast<FlatPtr>(ptr);
+    }
+
+    // Frees everything that was allocated from this arena.
+    void clear()
+    {
+        while (m_chunks) {
+            auto* next = m_chunks->next;
+            kfree_sized(m_chunks, m_chunks->size);
+            m_chunks = next;
+        }
+        m_next = 0;
+        m_end = 0;
+        m_allocated_size = 0;
+    }
+
+    // The number of bytes that are currently in use, not counting what is lost to alignment or held on to after being deallocated.
+    size_t allocated_size() const { return m_allocated_size; }
+
+private:
+    struct Chunk {
+        Chunk* next;
+        size_t size;
+    };
+
+    static constexpr size_t chunk_header_size = align_up_to(sizeof(Chunk), 2 * sizeof(void*));
+
+    void* allocate_in_new_chunk(size_t size, size_t alignment)
+    {
+        if (size > NumericLimits<size_t>::max() - chunk_header_size - alignment)
+            return nullptr;
+        auto needed_size = chunk_header_size + size + alignment;
+
+        // Allocations that would use up a good part of a chunk get one of their own, so the current chunk can keep being used for smaller ones.
+        bool needs_own_chunk = needed_size > m_chunk_size / 4;
+        auto chunk_size = needs_own_chunk ? needed_size : m_chunk_size;
+
+        auto* chunk = static_cast<Chunk*>(kmalloc(chunk_size));
+        if (!chunk)
+            return nullptr;
+        chunk->size = chunk_size;
+
+        auto start = reinterpret_cast<FlatPtr>(chunk) + chunk_header_size;
+        auto aligned_ptr = align_up_to(start, alignment);
+        m_allocated_size += size;
+
+        chunk->next = m_chunks;
+        m_chunks = chunk;
+        if (needs_own_chunk)
+            return reinterpret_cast<void*>(aligned_ptr);
+
+        m_next = aligned_ptr + size;
+        m_end = reinterpret_cast<FlatPtr>(chunk) + chunk_size;
+        return reinterpret_cast<void*>(aligned_ptr);
+    }
+
+    size_t m_chunk_size { 0 };
+    Chunk* m_chunks { nullptr };
+    FlatPtr m_next { 0 };
+    FlatPtr m_end { 0 };
+    size_t m_allocated_size { 0 };
+};
+
+// Lets containers get their memory from an Arena. Since the arena frees everything at once, it has to outlive all containers using it.
+class ArenaAllocator {
+public:
+    ArenaAllocator(Arena& arena)
+        : m_arena(&arena)
+    {
+    }
+
+    [[nodiscard]] void* allocate(size_t size, size_t alignment) { return m_arena->allocate(size, alignment); }
+    [[nodiscard]] void* allocate_zeroed(size_t size, size_t alignment)
+    {
+        auto* ptr = m_arena->allocate(size, alignment);
+        if (ptr)
+            __builtin_memset(ptr, 0, size);
+        return ptr;
+    }
+    void deallocate(void* ptr, size_t size) { m_arena->deallocate(ptr, size); }
+
+    static size_t good_size(size_t size) { return size; }
+
+    Arena& arena() const { return *m_arena; }
+
+private:
+    Arena* m_arena { nullptr };
+};
+
+template<typename T, size_t inline_capacity = 0>
+using ArenaVector = Vector<T, inline_capacity, ArenaAllocator>;
+
+template<typename T, typename TraitsForT = Traits<T>>
+using ArenaHashTable = HashTable<T, TraitsForT, false, ArenaAllocator>;
+
+template<typename K, typename V, typename KeyTraits = Traits<K>, typename ValueTraits = Traits<V>>
+using ArenaHashMap = HashMap<K, V, KeyTraits, ValueTraits, false, AllocatorHashTablePolicy<ArenaAllocator>>;
+
+}
+
+#if USING_AK_GLOBALLY
+using AK::Arena;
+using AK::ArenaAllocator;
+using AK::ArenaHashMap;
+using AK::ArenaHashTable;
+using AK::ArenaVector;
+#endif
@@ -119,8 +119,13 @@ private:
 
 /// A stream wrapper class that allows you to read arbitrary amounts of bits
 /// in little-endian order from another stream.
+/// NOTE: To make reading (and peeking at) bits fast, this reads ahead from the underlying stream into a buffer
+///       of up to 64 bits, so its position in the underlying stream is not the same as ours. Anything that reads
+///       what comes after the bits has to do so through this stream.
 class LittleEndianInputBitStream : public Stream {
 public:
+    static constexpr size_t max_peek_bits = 56;
+
     explicit LittleEndianInputBitStream(MaybeOwned<Stream> stream)
         : m_stream(move(stream))
     {
@@ -129,21 +134,28 @@ public:
     // ^Stream
     virtual ErrorOr<Bytes> read(Bytes bytes) override
     {
-        if (m_current_byte.has_value() && is_aligned_to_byte_boundary()) {
-            bytes[0] = m_current_byte.release_value();
-            return m_stream->read(bytes.slice(1));
-        }
         align_to_byte_boundary();
-        return m_stream->read(bytes);
+
+        size_t nread = 0;
+        while (nread < bytes.size() && m_bit_count > 0) {
+            bytes[nread++] = m_bit_buffer & 0xff;
+            discard_buffered_bits(8);
+        }
+        if (nread == bytes.size())
+            return bytes;
+
+        auto read_bytes = TRY(m_stream->read(bytes.slice(nread)));
+        return bytes.trim(nread + read_bytes.size());
     }
     virtual ErrorOr<size_t> write(ReadonlyBytes bytes) override { return m_stream->write(bytes); }
     virtual ErrorOr<void> write_entire_buffer(ReadonlyBytes bytes) override { return m_stream->write_entire_buffer(bytes); }
-    virtual bool is_eof() const override { return m_stream->is_eof() && !m_current_byte.has_value(); }
+    virtual bool is_eof() const override { return m_stream->is_eof() && m_bit_count == 0; }
     virtual bool is_open() const override { return m_stream->is_open(); }
     virtual void close() override
     {
         m_stream->close();
-        align_to_byte_boundary();
+        m_bit_buffer = 0;
+        m_bit_count = 0;
     }
 
     ErrorOr<bool> read_bit()
@@ -158,66 +170,85 @@ public:
     {
         if constexpr (IsSame<bool, T>) {
             VERIFY(count == 1);
-        }
-        T result = 0;
-
-        size_t nread = 0;
-        while (nread < count) {
-            if (m_current_byte.has_value()) {
-                if constexpr (!IsSame<bool, T> && !IsSame<u8, T>) {
-                    // read as many bytes as possible directly
-                    if (((count - nread) >= 8) && is_aligned_to_byte_boundary()) {
-                        // shift existing data over
-                        result |= (m_current_byte.value() << nread);
-                        nread += 8;
-                        m_current_byte.clear();
-                    } else {
-                        auto const bit = (m_current_byte.value() >> m_bit_offset) & 1;
-                        result |= (bit << nread);
-                        ++nread;
-                        if (m_bit_offset++ == 7)
-                            m_current_byte.clear();
-                    }
-                } else {
-                    // Always take this branch for booleans or u8: there's no purpose in reading more than a single bit
-                    auto const bit = (m_current_byte.value() >> m_bit_offset) & 1;
-                    if constexpr (IsSame<bool, T>)
-                        result = bit;
-                    else
-                        result |= (bit << nread);
-                    ++nread;
-                    if (m_bit_offset++ == 7)
-                        m_current_byte.clear();
-                }
-            } else {
-                auto temp_buffer = TRY(ByteBuffer::create_uninitialized(1));
-                auto read_bytes = TRY(m_stream->read(temp_buffer.bytes()));
-                if (read_bytes.is_empty())
-                    return Error::from_string_literal("eof");
-                m_current_byte = temp_buffer[0];
-                m_bit_offset = 0;
+            auto bits = TRY(peek_bits(1));
+            TRY(discard_previously_peeked_bits(1));
+            return bits != 0;
+        } else {
+            VERIFY(count <= sizeof(T) * 8);
+
+            u64 result = 0;
+            size_t nread = 0;
+            while (nread < count) {
+                auto chunk_size = min(count - nread, max_peek_bits);
+                auto bits = TRY(peek_bits(chunk_size));
+                TRY(discard_previously_peeked_bits(chunk_size));
+                result |= bits << nread;
+                nread += chunk_size;
             }
+            return static_cast<T>(result);
         }
+    }
 
-        return result;
+    /// Returns the next `count` bits without consuming them. If the stream ends before that, the missing bits are zero.
+    ErrorOr<u64> peek_bits(size_t count)
+    {
+        VERIFY(count <= max_peek_bits);
+        if (count > m_bit_count)
+            TRY(refill_buffer_from_stream(count));
+        if (count == 0)
+            return 0;
+        return m_bit_buffer & (NumericLimits<u64>::max() >> (64 - count));
+    }
+
+    /// Consumes `count` bits that have been looked at with peek_bits() before.
+    ErrorOr<void> discard_previously_peeked_bits(size_t count)
+    {
+        if (count > m_bit_count)
+            return Error::from_string_literal("eof");
+        discard_buffered_bits(count);
+        return {};
     }
 
     /// Discards any sub-byte stream positioning the input stream may be keeping track of.
     /// Non-bitwise reads will implicitly call this.
     u8 align_to_byte_boundary()
     {
-        u8 remaining_bits = m_current_byte.value_or(0) >> m_bit_offset;
-        m_current_byte.clear();
-        m_bit_offset = 0;
+        auto bits_in_current_byte = m_bit_count % 8;
+        u8 remaining_bits = m_bit_buffer & ((1u << bits_in_current_byte) - 1);
+        discard_buffered_bits(bits_in_current_byte);
         return remaining_bits;
     }
 
     /// Whether we are (accidentally or intentionally) at a byte boundary right now.
-    ALWAYS_INLINE bool is_aligned_to_byte_boundary() const { return m_bit_offset == 0; }
+    ALWAYS_INLINE bool is_aligned_to_byte_boundary() const { return m_bit_count % 8 == 0; }
 
 private:
-    Optional<u8> m_current_byte;
-    size_t m_bit_offset { 0 };
+    // Only ever reads whole bytes, so whatever is left of the current byte is always at the bottom of the buffer.
+    ErrorOr<void> refill_buffer_from_stream(size_t requested_bit_count)
+    {
+        while (m_bit_count < requested_bit_count) {
+            u8 buffer[8];
+            auto read_bytes = TRY(m_stream->read({ buffer, (64 - m_bit_count) / 8 }));
+            if (read_bytes.is_empty())
+                break;
+
+            for (auto byte : read_bytes) {
+                m_bit_buffer |= static_cast<u64>(byte) << m_bit_count;
+                m_bit_count += 8;
+            }
+        }
+        return {};
+    }
+
+    ALWAYS_INLINE void discard_buffered_bits(size_t count)
+    {
+        VERIFY(count <= m_bit_count);
+        m_bit_buffer = count == 64 ? 0 : m_bit_buffer >> count;
+        m_bit_count -= count;
+    }
+
+    u64 m_bit_buffer { 0 };
+    size_t m_bit_count { 0 };
     MaybeOwned<Stream> m_stream;
 };
 
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/Optional.h>
+#include <AK/Platform.h>
+#include <AK/Span.h>
+#include <AK/Types.h>
+
+// The kernel is built without SSE, so vector code would only be lowered back into byte loops there.
+#if !defined(KERNEL)
+#    define AK_BYTE_SEARCH_USES_SIMD 1
+#    include <AK/SIMD.h>
+#else
+#    define AK_BYTE_SEARCH_USES_SIMD 0
+#endif
+
+// See AK/SIMDExtras.h for why this is fine here.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace AK {
+
+namespace Detail {
+
+#if AK_BYTE_SEARCH_USES_SIMD
+using ByteVector = SIMD::u8x16;
+using AlignedByteVector [[gnu::may_alias]] = SIMD::u8x16;
+static constexpr size_t byte_vector_size = sizeof(ByteVector);
+
+ALWAYS_INLINE static ByteVector load_byte_vector(u8 const* bytes)
+{
+    ByteVector vector;
+    __builtin_memcpy(&vector, bytes, sizeof(vector));
+    return vector;
+}
+
+ALWAYS_INLINE static ByteVector splat_byte_vector(u8 value)
+{
+    return ByteVector {} + value;
+}
+
+// Turns a vector of all-ones or all-zeroes lanes (as produced by comparisons) into a bit mask with bit N set for lane N.
+ALWAYS_INLINE static u32 byte_vector_mask(ByteVector matches)
+{
+#    if defined(__SSE2__)
+    return static_cast<u16>(__builtin_ia32_pmovmskb128((SIMD::c8x16)matches));
+#    else
+    // Gathers the top bit of each byte of each half into the top byte of the product, in lane order.
+    auto halves = (SIMD::u64x2)matches & 0x8080808080808080ull;
+    auto low = (halves[0] * 0x0002040810204081ull) >> 56;
+    auto high = (halves[1] * 0x0002040810204081ull) >> 56;
+    return static_cast<u32>(low | (high << 8));
+#    endif
+}
+
+ALWAYS_INLINE static u32 matching_bytes(ByteVector bytes, ByteVector needles)
+{
+    return byte_vector_mask((ByteVector)(bytes == needles));
+}
+
+// Null-terminated strings are scanned one aligned vector at a time, starting with the one containing the first byte.
+// NOTE: Aligned loads never cross a page boundary, so reading past either end of the string can't fault.
+ALWAYS_INLINE static u8 const* align_down_to_byte_vector(u8 const* bytes)
+{
+    return reinterpret_cast<u8 const*>(reinterpret_cast<FlatPtr>(bytes) & ~(byte_vector_size - 1));
+}
+#endif
+
+}
+
+// Returns the index of the first occurrence of needle in haystack.
+inline Optional<size_t> find_byte(ReadonlyBytes haystack, u8 needle)
+{
+    auto const* bytes = haystack.data();
+    size_t size = haystack.size();
+    size_t i = 0;
+#if AK_BYTE_SEARCH_USES_SIMD
+    auto needles = Detail::splat_byte_vector(needle);
+    for (; i + Detail::byte_vector_size <= size; i += Detail::byte_vector_size) {
+        if (auto mask = Detail::matching_bytes(Detail::load_byte_vector(bytes + i), needles))
+            return i + count_trailing_zeroes(mask);
+    }
+#endif
+    for (; i < size; ++i) {
+        if (bytes[i] == needle)
+            return i;
+    }
+    return {};
+}
+
+// Returns the index of the last occurrence of needle in haystack.
+inline Optional<size_t> find_last_byte(ReadonlyBytes haystack, u8 needle)
+{
+    auto const* bytes = haystack.data();
+    size_t i = haystack.size();
+#if AK_BYTE_SEARCH_USES_SIMD
+    auto needles = Detail::splat_byte_vector(needle);
+    for (; i >= Detail::byte_vector_size; i -= Detail::byte_vector_size) {
+        if (auto mask = Detail::matching_bytes(Detail::load_byte_vector(bytes + i - Detail::byte_vector_size), needles))
+            return i - Detail::byte_vector_size + (31 - count_leading_zeroes(mask));
+    }
+#endif
+    for (; i > 0; --i) {
+        if (bytes[i - 1] == needle)
+            return i - 1;
+    }
+    return {};
+}
+
+// Returns the index of the first byte in haystack that is any of the given needles.
+inline Optional<size_t> find_any_of_bytes(ReadonlyBytes haystack, ReadonlyBytes needles)
+{
+    if (needles.size() == 1)
+        return find_byte(haystack, needles[0]);
+
+    auto const* bytes = haystack.data();
+    size_t size = haystack.size();
+    size_t i = 0;
+#if AK_BYTE_SEARCH_USES_SIMD
+    // Comparing against every needle is only worth it for small sets, which is what parsers usually look for.
+    static constexpr size_t max_vectorized_needle_count = 8;
+    if (needles.size() <= max_vectorized_needle_count) {
+        for (; i + Detail::byte_vector_size <= size; i += Detail::byte_vector_size) {
+            auto vector = Detail::load_byte_vector(bytes + i);
+            u32 mask = 0;
+            for (auto needle : needles)
+                mask |= Detail::matching_bytes(vector, Detail::splat_byte_vector(needle));
+            if (mask)
+                return i + count_trailing_zeroes(mask);
+        }
+    }
+#endif
+    bool is_needle[256] {};
+    for (auto needle : needles)
+        is_needle[needle] = true;
+    for (; i < size; ++i) {
+        if (is_needle[bytes[i]])
+            return i;
+    }
+    return {};
+}
+
+// Returns the index of the first byte that differs between a and b, looking at the first size bytes of both.
+inline Optional<size_t> find_first_mismatch(u8 const* a, u8 const* b, size_t size)
+{
+    size_t i = 0;
+#if AK_BYTE_SEARCH_USES_SIMD
+    for (; i + Detail::byte_vector_size <= size; i += Detail::byte_vector_size) {
+        auto mask = Detail::matching_bytes(Detail::load_byte_vector(a + i), Detail::load_byte_vector(b + i));
+        if (mask != 0xffff)
+            return i + count_trailing_zeroes(~mask);
+    }
+#endif
+    for (; i < size; ++i) {
+        if (a[i] != b[i])
+            return i;
+    }
+    return {};
+}
+
+// Returns the length of a null-terminated string.
+inline size_t find_null_terminator(char const* string)
+{
+    auto const* bytes = reinterpret_cast<u8 const*>(string);
+#if AK_BYTE_SEARCH_USES_SIMD
+    auto const* block = Detail::align_down_to_byte_vector(bytes);
+    auto zeroes = Detail::ByteVector {};
+    u32 first_mask = Detail::matching_bytes(*reinterpret_cast<Detail::AlignedByteVector const*>(block), zeroes) >> (bytes - block);
+    if (first_mask)
+        return count_trailing_zeroes(first_mask);
+    for (;;) {
+        block += Detail::byte_vector_size;
+        if (auto mask = Detail::matching_bytes(*reinterpret_cast<Detail::AlignedByteVector const*>(block), zeroes))
+            return (block - bytes) + count_trailing_zeroes(mask);
+    }
+#else
+    size_t length = 0;
+    while (bytes[length])
+        ++length;
+    return length;
+#endif
+}
+
+// Returns a pointer to the first occurrence of needle in a null-terminated string, or to its null terminator if there is none.
+inline char const* find_byte_or_null_terminator(char const* string, char needle)
+{
+    auto const* bytes = reinterpret_cast<u8 const*>(string);
+#if AK_BYTE_SEARCH_USES_SIMD
+    auto const* block = Detail::align_down_to_byte_vector(bytes);
+    auto zeroes = Detail::ByteVector {};
+    auto needles = Detail::splat_byte_vector(needle);
+    auto matches_in_block = [&](u8 const* aligned_block) {
+        auto vector = *reinterpret_cast<Detail::AlignedByteVector const*>(aligned_block);
+        return Detail::matching_bytes(vector, zeroes) | Detail::matching_bytes(vector, needles);
+    };
+    u32 first_mask = matches_in_block(block) >> (bytes - block);
+    if (first_mask)
+        return string + count_trailing_zeroes(first_mask);
+    for (;;) {
+        block += Detail::byte_vector_size;
+        if (auto mask = matches_in_block(block))
+            return reinterpret_cast<char const*>(block) + count_trailing_zeroes(mask);
+    }
+#else
+    while (*string && *string != needle)
+        ++string;
+    return string;
+#endif
+}
+
+}
+
+#pragma GCC diagnostic pop
+
+#if USING_AK_GLOBALLY
+using AK::find_any_of_bytes;
+using AK::find_byte;
+using AK::find_byte_or_null_terminator;
+using AK::find_first_mismatch;
+using AK::find_last_byte;
+using AK::find_null_terminator;
+#endif
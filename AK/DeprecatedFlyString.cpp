@@ -9,6 +9,7 @@
 #include <AK/HashTable.h>
 #include <AK/Optional.h>
 #include <AK/Singleton.h>
+#include <AK/StringInterningTable.h>
 #include <AK/StringUtils.h>
 #include <AK/StringView.h>
 
@@ -24,16 +25,24 @@ struct DeprecatedFlyStringImplTraits : public Traits<StringImpl*> {
     }
 };
 
-static Singleton<HashTable<StringImpl*, DeprecatedFlyStringImplTraits>> s_table;
+using DeprecatedFlyStringTable = Detail::StringInterningTable<HashTable<StringImpl*, DeprecatedFlyStringImplTraits>>;
 
-static HashTable<StringImpl*, DeprecatedFlyStringImplTraits>& fly_impls()
+static Singleton<DeprecatedFlyStringTable> s_table;
+
+static DeprecatedFlyStringTable& fly_impls()
 {
     return *s_table;
 }
 
 void DeprecatedFlyString::did_destroy_impl(Badge<StringImpl>, StringImpl& impl)
 {
-    fly_impls().remove(&impl);
+    // NOTE: Another thread may have already interned a new impl with the same contents while this one was dying,
+    //       so make sure to only remove this exact impl.
+    fly_impls().with_shard(impl.existing_hash(), [&](auto& table) {
+        auto it = table.find(impl.existing_hash(), [&](auto* candidate) { return candidate == &impl; });
+        if (it != table.end())
+            table.remove(it);
+    });
 }
 
 DeprecatedFlyString::DeprecatedFlyString(DeprecatedString const& string)
@@ -44,33 +53,38 @@ DeprecatedFlyString::DeprecatedFlyString(DeprecatedString const& string)
         m_impl = string.impl();
         return;
     }
-    auto it = fly_impls().find(const_cast<StringImpl*>(string.impl()));
-    if (it == fly_impls().end()) {
-        fly_impls().set(const_cast<StringImpl*>(string.impl()));
-        string.impl()->set_fly({}, true);
-        m_impl = string.impl();
-    } else {
-        VERIFY((*it)->is_fly());
-        m_impl = *it;
-    }
+    // NOTE: The hash is computed before the impl is shared with other threads, so they only ever read it.
+    auto hash = string.impl()->hash();
+    m_impl = fly_impls().with_shard(hash, [&](auto& table) -> NonnullRefPtr<StringImpl> {
+        auto it = table.find(hash, [&](auto* candidate) { return *candidate == *string.impl(); });
+        // An impl whose last reference is already gone is about to remove itself, so we replace it.
+        if (it != table.end() && (*it)->try_ref()) {
+            VERIFY((*it)->is_fly());
+            return adopt_ref(**it);
+        }
+        auto& impl = const_cast<StringImpl&>(*string.impl());
+        table.set(&impl);
+        impl.set_fly({}, true);
+        return impl;
+    });
 }
 
 DeprecatedFlyString::DeprecatedFlyString(StringView string)
 {
     if (string.is_null())
         return;
-    auto it = fly_impls().find(string.hash(), [&](auto& candidate) {
-        return string == candidate;
-    });
-    if (it == fly_impls().end()) {
+    auto hash = string.hash();
+    m_impl = fly_impls().with_shard(hash, [&](auto& table) -> NonnullRefPtr<StringImpl> {
+        auto it = table.find(hash, [&](auto* candidate) { return string == candidate->view(); });
+        if (it != table.end() && (*it)->try_ref()) {
+            VERIFY((*it)->is_fly());
+            return adopt_ref(**it);
+        }
         auto new_string = string.to_deprecated_string();
-        fly_impls().set(new_string.impl());
+        table.set(new_string.impl());
         new_string.impl()->set_fly({}, true);
-        m_impl = new_string.impl();
-    } else {
-        VERIFY((*it)->is_fly());
-        m_impl = *it;
-    }
+        return *new_string.impl();
+    });
 }
 
 template<typename T>
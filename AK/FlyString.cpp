@@ -5,16 +5,31 @@
  */
 
 #include <AK/FlyString.h>
-#include <AK/HashMap.h>
+#include <AK/HashTable.h>
 #include <AK/Singleton.h>
+#include <AK/StringInterningTable.h>
 #include <AK/StringView.h>
 #include <AK/Utf8View.h>
 
 namespace AK {
 
+struct FlyStringTableEntry {
+    unsigned hash { 0 };
+    StringView string;
+    uintptr_t data { 0 };
+};
+
+struct FlyStringTableEntryTraits : public Traits<FlyStringTableEntry> {
+    static unsigned hash(FlyStringTableEntry const& entry) { return entry.hash; }
+    static bool equals(FlyStringTableEntry const& a, FlyStringTableEntry const& b)
+    {
+        return a.hash == b.hash && a.string == b.string;
+    }
+};
+
 static auto& all_fly_strings()
 {
-    static Singleton<HashMap<StringView, uintptr_t>> table;
+    static Singleton<Detail::StringInterningTable<HashTable<FlyStringTableEntry, FlyStringTableEntryTraits>>> table;
     return *table;
 }
 
@@ -40,17 +55,21 @@ FlyString::FlyString(String const& string)
         return;
     }
 
-    auto it = all_fly_strings().find(string.bytes_as_string_view());
-    if (it == all_fly_strings().end()) {
-        m_data = string.to_fly_string_data({});
-
-        all_fly_strings().set(string.bytes_as_string_view(), m_data);
+    // NOTE: The hash is computed before the string data is shared with other threads, so they only ever read it.
+    auto hash = string.hash();
+    auto view = string.bytes_as_string_view();
+    m_data = all_fly_strings().with_shard(hash, [&](auto& table) {
+        auto it = table.find(hash, [&](auto& entry) { return entry.string == view; });
+        // String data whose last reference is already gone is about to remove itself, so we replace it.
+        if (it != table.end() && String::try_ref_fly_string_data({}, it->data))
+            return it->data;
+
+        auto data = string.to_fly_string_data({});
+        table.set({ hash, view, data });
         string.did_create_fly_string({});
-    } else {
-        m_data = it->value;
-    }
-
-    String::ref_fly_string_data({}, m_data);
+        String::ref_fly_string_data({}, data);
+        return data;
+    });
 }
 
 FlyString::FlyString(FlyString const& other)
@@ -90,7 +109,7 @@ bool FlyString::is_empty() const
 
 unsigned FlyString::hash() const
 {
-    return bytes_as_string_view().hash();
+    return String::fly_string_data_to_hash({}, m_data);
 }
 
 FlyString::operator String() const
@@ -141,9 +160,15 @@ bool FlyString::operator==(char const* string) const
     return bytes_as_string_view() == string;
 }
 
-void FlyString::did_destroy_fly_string_data(Badge<Detail::StringData>, StringView string_data)
+void FlyString::did_destroy_fly_string_data(Badge<Detail::StringData>, uintptr_t data, unsigned hash)
 {
-    all_fly_strings().remove(string_data);
+    // NOTE: Another thread may have already interned new data for the same string while this one was dying,
+    //       so make sure to only remove the entry for this exact data.
+    all_fly_strings().with_shard(hash, [&](auto& table) {
+        auto it = table.find(hash, [&](auto& entry) { return entry.data == data; });
+        if (it != table.end())
+            table.remove(it);
+    });
 }
 
 uintptr_t FlyString::data(Badge<String>) const
@@ -44,7 +44,7 @@ public:
     [[nodiscard]] bool operator==(StringView) const;
     [[nodiscard]] bool operator==(char const*) const;
 
-    static void did_destroy_fly_string_data(Badge<Detail::StringData>, StringView);
+    static void did_destroy_fly_string_data(Badge<Detail::StringData>, uintptr_t data, unsigned hash);
     [[nodiscard]] uintptr_t data(Badge<String>) const;
 
     // This is primarily interesting to unit tests.
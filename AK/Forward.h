@@ -78,18 +78,32 @@ class CircularQueue;
 template<typename T>
 struct Traits;
 
-template<typename T, typename TraitsForT = Traits<T>, bool IsOrdered = false>
+struct DefaultAllocator;
+
+template<typename T, typename TraitsForT = Traits<T>, bool IsOrdered = false, typename Allocator = DefaultAllocator>
 class HashTable;
 
 template<typename T, typename TraitsForT = Traits<T>>
 using OrderedHashTable = HashTable<T, TraitsForT, true>;
 
-template<typename K, typename V, typename KeyTraits = Traits<K>, typename ValueTraits = Traits<V>, bool IsOrdered = false>
+template<typename T, typename TraitsForT = Traits<T>>
+class SwissHashTable;
+
+struct DefaultHashTablePolicy;
+struct SwissHashTablePolicy;
+
+template<typename Allocator>
+struct AllocatorHashTablePolicy;
+
+template<typename K, typename V, typename KeyTraits = Traits<K>, typename ValueTraits = Traits<V>, bool IsOrdered = false, typename HashTablePolicy = DefaultHashTablePolicy>
 class HashMap;
 
 template<typename K, typename V, typename KeyTraits = Traits<K>, typename ValueTraits = Traits<V>>
 using OrderedHashMap = HashMap<K, V, KeyTraits, ValueTraits, true>;
 
+template<typename K, typename V, typename KeyTraits = Traits<K>, typename ValueTraits = Traits<V>>
+using SwissHashMap = HashMap<K, V, KeyTraits, ValueTraits, false, SwissHashTablePolicy>;
+
 template<typename T>
 class Badge;
 
@@ -99,11 +113,28 @@ class FixedArray;
 template<size_t precision, typename Underlying = i32>
 class FixedPoint;
 
-template<typename>
+namespace Detail {
+#ifndef KERNEL
+// Empirically determined to fit most lambdas and functions.
+inline constexpr size_t default_function_inline_capacity = 4 * sizeof(void*);
+inline constexpr bool function_may_allocate_by_default = true;
+#else
+// FIXME: Try to decrease this.
+inline constexpr size_t default_function_inline_capacity = 6 * sizeof(void*);
+// The kernel never puts callables on the heap behind its back.
+inline constexpr bool function_may_allocate_by_default = false;
+#endif
+}
+
+template<typename, size_t InlineCapacity = Detail::default_function_inline_capacity, bool MayAllocate = Detail::function_may_allocate_by_default>
 class Function;
 
-template<typename Out, typename... In>
-class Function<Out(In...)>;
+template<typename Out, typename... In, size_t InlineCapacity, bool MayAllocate>
+class Function<Out(In...), InlineCapacity, MayAllocate>;
+
+// A Function that never allocates, for callbacks that are created and moved around often, e.g. ones that are only ever invoked once.
+template<typename Signature, size_t InlineCapacity = Detail::default_function_inline_capacity>
+using InlineFunction = Function<Signature, InlineCapacity, false>;
 
 template<typename T>
 class NonnullRefPtr;
@@ -143,7 +174,7 @@ class OwnPtr;
 template<typename T>
 class WeakPtr;
 
-template<typename T, size_t inline_capacity = 0>
+template<typename T, size_t inline_capacity = 0, typename Allocator = DefaultAllocator>
 requires(!IsRvalueReference<T>) class Vector;
 
 template<typename T, typename ErrorType = Error>
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Function.h>
+
+#if FUNCTION_DEBUG
+#    include <AK/Atomic.h>
+#    include <AK/Format.h>
+
+namespace AK {
+
+static Atomic<size_t> s_function_heap_allocation_count;
+
+size_t function_heap_allocation_count()
+{
+    return s_function_heap_allocation_count.load(MemoryOrder::memory_order_relaxed);
+}
+
+namespace Detail {
+
+void did_heap_allocate_function(char const* callable_description, size_t size)
+{
+    // The description is the signature of Function::init_with_callable(), which names the type of the callable,
+    // and for lambdas, the function they're defined in.
+    auto count = s_function_heap_allocation_count.fetch_add(1, MemoryOrder::memory_order_relaxed) + 1;
+    dbgln("Function: Heap allocation #{} of {} bytes for {}", count, size, callable_description);
+}
+
+}
+
+}
+#endif
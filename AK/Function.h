@@ -29,6 +29,8 @@
 #include <AK/Assertions.h>
 #include <AK/Atomic.h>
 #include <AK/BitCast.h>
+#include <AK/Debug.h>
+#include <AK/Forward.h>
 #include <AK/Noncopyable.h>
 #include <AK/ScopeGuard.h>
 #include <AK/StdLibExtras.h>
@@ -52,8 +54,13 @@ inline constexpr bool IsCallableWithArguments = requires(T t) {
 
 using Detail::IsCallableWithArguments;
 
-template<typename>
-class Function;
+#if FUNCTION_DEBUG
+// Both of these are defined in AK/Function.cpp.
+size_t function_heap_allocation_count();
+namespace Detail {
+void did_heap_allocate_function(char const* callable_description, size_t size);
+}
+#endif
 
 template<typename F>
 inline constexpr bool IsFunctionPointer = (IsPointer<F> && IsFunction<RemovePointer<F>>);
@@ -62,8 +69,10 @@ inline constexpr bool IsFunctionPointer = (IsPointer<F> && IsFunction<RemovePoin
 template<typename F>
 inline constexpr bool IsFunctionObject = (!IsFunctionPointer<F> && IsRvalueReference<F&&>);
 
-template<typename Out, typename... In>
-class Function<Out(In...)> {
+// Callables that don't fit into the inline capacity of a Function are put on the heap, unless MayAllocate is false,
+// in which case they don't compile. The defaults are in AK/Forward.h.
+template<typename Out, typename... In, size_t InlineCapacity, bool MayAllocate>
+class Function<Out(In...), InlineCapacity, MayAllocate> {
     AK_MAKE_NONCOPYABLE(Function);
 
 public:
@@ -235,18 +244,17 @@ private:
     {
         VERIFY(m_call_nesting_level == 0);
         using WrapperType = CallableWrapper<Callable>;
-#ifndef KERNEL
-        if constexpr (sizeof(WrapperType) > inline_capacity) {
+        if constexpr (MayAllocate && sizeof(WrapperType) > inline_capacity) {
+#if FUNCTION_DEBUG
+            Detail::did_heap_allocate_function(__PRETTY_FUNCTION__, sizeof(WrapperType));
+#endif
             *bit_cast<CallableWrapperBase**>(&m_storage) = new WrapperType(forward<Callable>(callable));
             m_kind = FunctionKind::Outline;
         } else {
-#endif
-            static_assert(sizeof(WrapperType) <= inline_capacity);
+            static_assert(sizeof(WrapperType) <= inline_capacity, "Callable doesn't fit into a Function that may not allocate");
             new (m_storage) WrapperType(forward<Callable>(callable));
             m_kind = FunctionKind::Inline;
-#ifndef KERNEL
         }
-#endif
     }
 
     void move_from(Function&& other)
@@ -273,13 +281,7 @@ private:
     FunctionKind m_kind { FunctionKind::NullPointer };
     bool m_deferred_clear { false };
     mutable Atomic<u16> m_call_nesting_level { 0 };
-#ifndef KERNEL
-    // Empirically determined to fit most lambdas and functions.
-    static constexpr size_t inline_capacity = 4 * sizeof(void*);
-#else
-    // FIXME: Try to decrease this.
-    static constexpr size_t inline_capacity = 6 * sizeof(void*);
-#endif
+    static constexpr size_t inline_capacity = InlineCapacity;
     alignas(max(alignof(CallableWrapperBase), alignof(CallableWrapperBase*))) u8 m_storage[inline_capacity];
 };
 
@@ -287,5 +289,6 @@ private:
 
 #if USING_AK_GLOBALLY
 using AK::Function;
+using AK::InlineFunction;
 using AK::IsCallableWithArguments;
 #endif
@@ -14,7 +14,7 @@
 
 namespace AK {
 
-template<typename K, typename V, typename KeyTraits, typename ValueTraits, bool IsOrdered>
+template<typename K, typename V, typename KeyTraits, typename ValueTraits, bool IsOrdered, typename HashTablePolicy>
 class HashMap {
 private:
     struct Entry {
@@ -31,8 +31,18 @@ public:
     using KeyType = K;
     using ValueType = V;
 
+    using HashTableType = typename HashTablePolicy::template Table<Entry, EntryTraits, IsOrdered>;
+    using IteratorType = typename HashTableType::Iterator;
+    using ConstIteratorType = typename HashTableType::ConstIterator;
+
     HashMap() = default;
 
+    template<typename Table = HashTableType>
+    explicit HashMap(typename Table::AllocatorType allocator)
+        : m_table(move(allocator))
+    {
+    }
+
     HashMap(std::initializer_list<Entry> list)
     {
         MUST(try_ensure_capacity(list.size()));
@@ -85,10 +95,6 @@ public:
         });
     }
 
-    using HashTableType = HashTable<Entry, EntryTraits, IsOrdered>;
-    using IteratorType = typename HashTableType::Iterator;
-    using ConstIteratorType = typename HashTableType::ConstIterator;
-
     [[nodiscard]] IteratorType begin() { return m_table.begin(); }
     [[nodiscard]] IteratorType end() { return m_table.end(); }
     [[nodiscard]] IteratorType find(K const& key)
@@ -298,4 +304,5 @@ private:
 #if USING_AK_GLOBALLY
 using AK::HashMap;
 using AK::OrderedHashMap;
+using AK::SwissHashMap;
 #endif
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Allocator.h>
 #include <AK/Concepts.h>
 #include <AK/Error.h>
 #include <AK/Forward.h>
@@ -13,7 +14,6 @@
 #include <AK/StdLibExtras.h>
 #include <AK/Traits.h>
 #include <AK/Types.h>
-#include <AK/kmalloc.h>
 
 namespace AK {
 
@@ -106,7 +106,7 @@ private:
     BucketType* m_bucket { nullptr };
 };
 
-template<typename T, typename TraitsForT, bool IsOrdered>
+template<typename T, typename TraitsForT, bool IsOrdered, typename Allocator>
 class HashTable {
     static constexpr size_t load_factor_in_percent = 60;
 
@@ -140,9 +140,16 @@ class HashTable {
     using CollectionDataType = Conditional<IsOrdered, OrderedCollectionData, CollectionData>;
 
 public:
+    using AllocatorType = Allocator;
+
     HashTable() = default;
     explicit HashTable(size_t capacity) { rehash(capacity); }
 
+    explicit HashTable(Allocator allocator)
+        : m_allocator(move(allocator))
+    {
+    }
+
     ~HashTable()
     {
         if (!m_buckets)
@@ -153,10 +160,11 @@ public:
                 m_buckets[i].slot()->~T();
         }
 
-        kfree_sized(m_buckets, size_in_bytes(m_capacity));
+        m_allocator.deallocate(m_buckets, size_in_bytes(m_capacity));
     }
 
     HashTable(HashTable const& other)
+        : m_allocator(other.m_allocator)
     {
         rehash(other.capacity());
         for (auto& it : other)
@@ -176,6 +184,7 @@ public:
         , m_size(other.m_size)
         , m_capacity(other.m_capacity)
         , m_deleted_count(other.m_deleted_count)
+        , m_allocator(move(other.m_allocator))
     {
         other.m_size = 0;
         other.m_capacity = 0;
@@ -198,6 +207,7 @@ public:
         swap(a.m_size, b.m_size);
         swap(a.m_capacity, b.m_capacity);
         swap(a.m_deleted_count, b.m_deleted_count);
+        swap(a.m_allocator, b.m_allocator);
 
         if constexpr (IsOrdered)
             swap(a.m_collection_data, b.m_collection_data);
@@ -287,7 +297,7 @@ public:
 
     void clear()
     {
-        *this = HashTable();
+        *this = HashTable(m_allocator);
     }
     void clear_with_capacity()
     {
@@ -495,13 +505,13 @@ private:
         }
 
         new_capacity = max(new_capacity, static_cast<size_t>(4));
-        new_capacity = kmalloc_good_size(new_capacity * sizeof(BucketType)) / sizeof(BucketType);
+        new_capacity = m_allocator.good_size(new_capacity * sizeof(BucketType)) / sizeof(BucketType);
 
         auto* old_buckets = m_buckets;
         auto old_capacity = m_capacity;
         Iterator old_iter = begin();
 
-        auto* new_buckets = kcalloc(1, size_in_bytes(new_capacity));
+        auto* new_buckets = m_allocator.allocate_zeroed(size_in_bytes(new_capacity), alignof(BucketType));
         if (!new_buckets)
             return Error::from_errno(ENOMEM);
 
@@ -523,7 +533,7 @@ private:
             it->~T();
         }
 
-        kfree_sized(old_buckets, size_in_bytes(old_capacity));
+        m_allocator.deallocate(old_buckets, size_in_bytes(old_capacity));
         return {};
     }
     void rehash(size_t new_capacity)
@@ -739,7 +749,25 @@ private:
     size_t m_size { 0 };
     size_t m_capacity { 0 };
     size_t m_deleted_count { 0 };
+    [[no_unique_address]] Allocator m_allocator;
+};
+}
+
+namespace AK {
+
+// HashMap uses this to pick the hash table it stores its entries in, see SwissHashTablePolicy for the alternative.
+struct DefaultHashTablePolicy {
+    template<typename T, typename TraitsForT, bool IsOrdered>
+    using Table = HashTable<T, TraitsForT, IsOrdered>;
 };
+
+// Like DefaultHashTablePolicy, but the table gets its memory from the given allocator, e.g. an ArenaAllocator.
+template<typename Allocator>
+struct AllocatorHashTablePolicy {
+    template<typename T, typename TraitsForT, bool IsOrdered>
+    using Table = HashTable<T, TraitsForT, IsOrdered, Allocator>;
+};
+
 }
 
 #if USING_AK_GLOBALLY
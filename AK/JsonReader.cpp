@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/CharacterTypes.h>
+#include <AK/JsonReader.h>
+#include <AK/Stream.h>
+#include <AK/StringUtils.h>
+#include <AK/UnicodeUtils.h>
+
+namespace AK {
+
+// Large enough that reading from a stream is rarely what we're waiting on.
+static constexpr size_t stream_buffer_size = 64 * KiB;
+
+static constexpr bool is_space(u8 ch)
+{
+    return ch == '\t' || ch == '\n' || ch == '\r' || ch == ' ';
+}
+
+static constexpr bool is_number_character(u8 ch)
+{
+    return is_ascii_digit(ch) || ch == '-' || ch == '+' || ch == '.' || ch == 'e' || ch == 'E';
+}
+
+// Numbers are scanned with is_number_character() first, this checks that they also follow the JSON grammar.
+static bool is_valid_number(StringView number)
+{
+    size_t i = 0;
+    auto skip_digits = [&] {
+        auto start = i;
+        while (i < number.length() && is_ascii_digit(number[i]))
+            ++i;
+        return i != start;
+    };
+
+    if (i < number.length() && number[i] == '-')
+        ++i;
+    if (i < number.length() && number[i] == '0')
+        ++i;
+    else if (!skip_digits())
+        return false;
+
+    if (i < number.length() && number[i] == '.') {
+        ++i;
+        if (!skip_digits())
+            return false;
+    }
+
+    if (i < number.length() && (number[i] == 'e' || number[i] == 'E')) {
+        ++i;
+        if (i < number.length() && (number[i] == '+' || number[i] == '-'))
+            ++i;
+        if (!skip_digits())
+            return false;
+    }
+
+    return i == number.length();
+}
+
+JsonReader::JsonReader(StringView input)
+    : m_data(input.bytes())
+{
+}
+
+JsonReader::JsonReader(Stream& stream)
+    : m_stream(&stream)
+{
+}
+
+ErrorOr<bool> JsonReader::fill_buffer()
+{
+    if (!m_stream || m_stream_is_exhausted)
+        return false;
+
+    if (m_buffer.is_empty())
+        TRY(m_buffer.try_resize(stream_buffer_size));
+
+    // Everything before the current position has been consumed, so the rest moves to the front.
+    auto remaining = m_data.size() - m_position;
+    if (m_position > 0) {
+        __builtin_memmove(m_buffer.data(), m_data.offset_pointer(m_position), remaining);
+        m_buffer_offset += m_position;
+        m_position = 0;
+    }
+
+    for (;;) {
+        auto bytes_read = TRY(m_stream->read(m_buffer.bytes().slice(remaining)));
+        m_data = m_buffer.bytes().trim(remaining + bytes_read.size());
+        if (!bytes_read.is_empty())
+            return true;
+        if (m_stream->is_eof()) {
+            m_stream_is_exhausted = true;
+            return false;
+        }
+    }
+}
+
+ErrorOr<bool> JsonReader::ensure_available(size_t count)
+{
+    while (m_data.size() - m_position < count) {
+        if (!TRY(fill_buffer()))
+            return false;
+    }
+    return true;
+}
+
+ErrorOr<void> JsonReader::skip_whitespace()
+{
+    for (;;) {
+        while (m_position < m_data.size() && is_space(m_data[m_position]))
+            ++m_position;
+        if (!is_at_end() || !TRY(fill_buffer()))
+            return {};
+    }
+}
+
+ErrorOr<JsonEvent> JsonReader::next()
+{
+    TRY(skip_whitespace());
+    m_token_start_offset = offset();
+
+    if (m_state == State::ExpectColon) {
+        if (is_at_end() || m_data[m_position] != ':')
+            return Error::from_string_literal("JsonReader: Expected ':'");
+        ++m_position;
+        TRY(skip_whitespace());
+        m_token_start_offset = offset();
+        m_state = State::ExpectValue;
+    } else if (m_state == State::ExpectCommaOrEnd) {
+        if (m_containers.is_empty()) {
+            if (!is_at_end())
+                return Error::from_string_literal("JsonReader: Didn't consume all input");
+            return JsonEvent {};
+        }
+        if (is_at_end())
+            return Error::from_string_literal("JsonReader: Unexpected end of input");
+
+        auto ch = m_data[m_position];
+        if (m_containers.last() == Container::Object) {
+            if (ch == '}')
+                return end_container(JsonEvent::Type::EndObject);
+            m_state = State::ExpectKey;
+        } else {
+            if (ch == ']')
+                return end_container(JsonEvent::Type::EndArray);
+            m_state = State::ExpectValue;
+        }
+        if (ch != ',')
+            return Error::from_string_literal("JsonReader: Expected ','");
+        ++m_position;
+        TRY(skip_whitespace());
+        m_token_start_offset = offset();
+    }
+
+    if (is_at_end())
+        return Error::from_string_literal("JsonReader: Unexpected end of input");
+
+    auto ch = m_data[m_position];
+    switch (m_state) {
+    case State::ExpectKeyOrEndOfObject:
+        if (ch == '}')
+            return end_container(JsonEvent::Type::EndObject);
+        [[fallthrough]];
+    case State::ExpectKey: {
+        if (ch != '"')
+            return Error::from_string_literal("JsonReader: Expected object property name");
+        auto key = TRY(read_string());
+        m_state = State::ExpectColon;
+        return JsonEvent { JsonEvent::Type::Key, key };
+    }
+    case State::ExpectValueOrEndOfArray:
+        if (ch == ']')
+            return end_container(JsonEvent::Type::EndArray);
+        [[fallthrough]];
+    case State::ExpectValue:
+        return read_value();
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+ErrorOr<void> JsonReader::skip_rest_of_container()
+{
+    auto depth = m_containers.size();
+    VERIFY(depth > 0);
+    while (m_containers.size() >= depth)
+        (void)TRY(next());
+    return {};
+}
+
+JsonEvent JsonReader::end_container(JsonEvent::Type type)
+{
+    ++m_position;
+    m_containers.take_last();
+    m_state = State::ExpectCommaOrEnd;
+    return JsonEvent { type, {} };
+}
+
+ErrorOr<JsonEvent> JsonReader::read_value()
+{
+    switch (m_data[m_position]) {
+    case '{':
+        ++m_position;
+        TRY(m_containers.try_append(Container::Object));
+        m_state = State::ExpectKeyOrEndOfObject;
+        return JsonEvent { JsonEvent::Type::StartObject, {} };
+    case '[':
+        ++m_position;
+        TRY(m_containers.try_append(Container::Array));
+        m_state = State::ExpectValueOrEndOfArray;
+        return JsonEvent { JsonEvent::Type::StartArray, {} };
+    case '"': {
+        auto string = TRY(read_string());
+        m_state = State::ExpectCommaOrEnd;
+        return JsonEvent { JsonEvent::Type::String, string };
+    }
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9': {
+        auto number = TRY(read_number());
+        m_state = State::ExpectCommaOrEnd;
+        return JsonEvent { JsonEvent::Type::Number, number };
+    }
+    case 't':
+        return read_literal("true"sv, JsonEvent::Type::True);
+    case 'f':
+        return read_literal("false"sv, JsonEvent::Type::False);
+    case 'n':
+        return read_literal("null"sv, JsonEvent::Type::Null);
+    }
+
+    return Error::from_string_literal("JsonReader: Unexpected character");
+}
+
+ErrorOr<JsonEvent> JsonReader::read_literal(StringView literal, JsonEvent::Type type)
+{
+    if (!TRY(ensure_available(literal.length())) || StringView { m_data.slice(m_position, literal.length()) } != literal)
+        return Error::from_string_literal("JsonReader: Invalid literal");
+    m_position += literal.length();
+    m_state = State::ExpectCommaOrEnd;
+    return JsonEvent { type, {} };
+}
+
+ErrorOr<StringView> JsonReader::read_string()
+{
+    ++m_position;
+
+    // Strings without escapes that are entirely in the buffer are returned as is, everything else is put together in m_scratch.
+    bool uses_scratch = false;
+    m_scratch.clear_with_capacity();
+
+    for (;;) {
+        auto i = m_position;
+        while (i < m_data.size()) {
+            auto ch = m_data[i];
+            if (ch == '"' || ch == '\\' || is_ascii_c0_control(ch))
+                break;
+            ++i;
+        }
+        auto run = m_data.slice(m_position, i - m_position);
+        m_position = i;
+
+        if (is_at_end()) {
+            TRY(m_scratch.try_append(run.data(), run.size()));
+            uses_scratch = true;
+            if (!TRY(fill_buffer()))
+                return Error::from_string_literal("JsonReader: Unexpected end of input while parsing string");
+            continue;
+        }
+
+        auto ch = m_data[m_position];
+        if (ch == '"') {
+            ++m_position;
+            if (!uses_scratch)
+                return StringView { run };
+            TRY(m_scratch.try_append(run.data(), run.size()));
+            return StringView { m_scratch.span() };
+        }
+        if (ch != '\\')
+            return Error::from_string_literal("JsonReader: Error while parsing string");
+
+        TRY(m_scratch.try_append(run.data(), run.size()));
+        uses_scratch = true;
+        TRY(read_escape_sequence());
+    }
+}
+
+ErrorOr<void> JsonReader::read_escape_sequence()
+{
+    if (!TRY(ensure_available(2)))
+        return Error::from_string_literal("JsonReader: Unexpected end of input while parsing string");
+
+    auto escaped = [&]() -> Optional<u8> {
+        switch (m_data[m_position + 1]) {
+        case '"':
+            return '"';
+        case '\\':
+            return '\\';
+        case '/':
+            return '/';
+        case 'n':
+            return '\n';
+        case 'r':
+            return '\r';
+        case 't':
+            return '\t';
+        case 'b':
+            return '\b';
+        case 'f':
+            return '\f';
+        }
+        return {};
+    }();
+
+    if (escaped.has_value()) {
+        TRY(m_scratch.try_append(*escaped));
+        m_position += 2;
+        return {};
+    }
+
+    if (m_data[m_position + 1] != 'u')
+        return Error::from_string_literal("JsonReader: Error while parsing string");
+
+    if (!TRY(ensure_available(6)))
+        return Error::from_string_literal("JsonReader: EOF while parsing Unicode escape");
+    auto code_point = StringUtils::convert_to_uint_from_hex(StringView { m_data.slice(m_position + 2, 4) });
+    if (!code_point.has_value())
+        return Error::from_string_literal("JsonReader: Error while parsing Unicode escape");
+
+    auto length = TRY(UnicodeUtils::try_code_point_to_utf8(*code_point, [&](char byte) { return m_scratch.try_append(static_cast<u8>(byte)); }));
+    if (length < 0)
+        TRY(m_scratch.try_append(reinterpret_cast<u8 const*>("\xef\xbf\xbd"), 3));
+    m_position += 6;
+    return {};
+}
+
+ErrorOr<StringView> JsonReader::read_number()
+{
+    auto start = m_position;
+    bool uses_scratch = false;
+    m_scratch.clear_with_capacity();
+
+    StringView number;
+    for (;;) {
+        auto i = m_position;
+        while (i < m_data.size() && is_number_character(m_data[i]))
+            ++i;
+        auto run = m_data.slice(m_position, i - m_position);
+        m_position = i;
+
+        auto may_continue_in_next_buffer = is_at_end() && m_stream;
+        if (!uses_scratch && !may_continue_in_next_buffer) {
+            number = StringView { m_data.slice(start, m_position - start) };
+            break;
+        }
+
+        TRY(m_scratch.try_append(run.data(), run.size()));
+        uses_scratch = true;
+        if (!may_continue_in_next_buffer || !TRY(fill_buffer())) {
+            number = StringView { m_scratch.span() };
+            break;
+        }
+    }
+
+    if (!is_valid_number(number))
+        return Error::from_string_literal("JsonReader: Invalid number");
+    return number;
+}
+
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Concepts.h>
+#include <AK/Error.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Vector.h>
+
+namespace AK {
+
+struct JsonEvent {
+    enum class Type : u8 {
+        StartObject,
+        EndObject,
+        StartArray,
+        EndArray,
+        Key,
+        String,
+        Number,
+        True,
+        False,
+        Null,
+        EndOfDocument,
+    };
+
+    bool is_start_of_container() const { return type == Type::StartObject || type == Type::StartArray; }
+
+    // Numbers are converted on demand, so callers only pay for the ones they look at.
+    template<Arithmetic T>
+    Optional<T> to_number() const;
+
+    Type type { Type::EndOfDocument };
+
+    // For keys and strings, this is the unescaped string. For numbers, it is the number as it was written.
+    // NOTE: This only stays valid until the next call to JsonReader::next().
+    StringView text;
+};
+
+// A pull parser that produces one JsonEvent at a time, without building up a JsonValue.
+// It accepts the same documents as JsonParser, and can read them from a Stream as they come in.
+class JsonReader {
+    AK_MAKE_NONCOPYABLE(JsonReader);
+    AK_MAKE_NONMOVABLE(JsonReader);
+
+public:
+    explicit JsonReader(StringView input);
+    explicit JsonReader(Stream& stream);
+
+    ErrorOr<JsonEvent> next();
+
+    // Skips to the end of the innermost object or array that is currently open, including its closing event.
+    ErrorOr<void> skip_rest_of_container();
+
+    // The number of objects and arrays that are currently open.
+    size_t depth() const { return m_containers.size(); }
+
+    // The offset in the input at which the token of the last event started, and the offset just past its end.
+    size_t token_start_offset() const { return m_token_start_offset; }
+    size_t offset() const { return m_buffer_offset + m_position; }
+
+private:
+    enum class Container : u8 {
+        Object,
+        Array,
+    };
+
+    enum class State : u8 {
+        ExpectValue,
+        ExpectValueOrEndOfArray,
+        ExpectKey,
+        ExpectKeyOrEndOfObject,
+        ExpectColon,
+        ExpectCommaOrEnd,
+    };
+
+    ErrorOr<bool> fill_buffer();
+    ErrorOr<bool> ensure_available(size_t);
+    ErrorOr<void> skip_whitespace();
+    bool is_at_end() const { return m_position == m_data.size(); }
+
+    ErrorOr<JsonEvent> read_value();
+    ErrorOr<StringView> read_string();
+    ErrorOr<void> read_escape_sequence();
+    ErrorOr<StringView> read_number();
+    ErrorOr<JsonEvent> read_literal(StringView, JsonEvent::Type);
+
+    JsonEvent end_container(JsonEvent::Type);
+
+    ReadonlyBytes m_data;
+    size_t m_position { 0 };
+
+    Stream* m_stream { nullptr };
+    ByteBuffer m_buffer;
+    size_t m_buffer_offset { 0 };
+    bool m_stream_is_exhausted { false };
+
+    size_t m_token_start_offset { 0 };
+    Vector<u8, 64> m_scratch;
+
+    Vector<Container, 32> m_containers;
+    State m_state { State::ExpectValue };
+};
+
+template<Arithmetic T>
+Optional<T> JsonEvent::to_number() const
+{
+    if (type != Type::Number)
+        return {};
+    if constexpr (IsSame<T, float>)
+        return text.to_float(TrimWhitespace::No);
+    else if constexpr (IsFloatingPoint<T>)
+        return text.to_double(TrimWhitespace::No);
+    else if constexpr (IsSigned<T>)
+        return text.to_int<T>();
+    else
+        return text.to_uint<T>();
+}
+
+}
+
+#if USING_AK_GLOBALLY
+using AK::JsonEvent;
+using AK::JsonReader;
+#endif
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonParser.h>
+#include <AK/JsonTape.h>
+
+namespace AK {
+
+ErrorOr<JsonTape> JsonTape::create(StringView input)
+{
+    if (input.length() > NumericLimits<u32>::max())
+        return Error::from_string_literal("JsonTape: Input is too large");
+
+    JsonTape tape { input };
+    JsonReader reader { input };
+    Vector<size_t, 32> open_containers;
+
+    // Typical documents have a token every few bytes, so this saves most of the reallocations along the way.
+    TRY(tape.m_entries.try_ensure_capacity(input.length() / 8));
+
+    for (;;) {
+        auto event = TRY(reader.next());
+        if (event.type == JsonEvent::Type::EndOfDocument)
+            break;
+
+        if (event.type == JsonEvent::Type::EndObject || event.type == JsonEvent::Type::EndArray) {
+            auto& container = tape.m_entries[open_containers.take_last()];
+            container.length = reader.offset() - container.offset;
+            container.next_index = tape.m_entries.size();
+            continue;
+        }
+
+        // Members are counted by their key, elements by their value.
+        if (!open_containers.is_empty()) {
+            auto& container = tape.m_entries[open_containers.last()];
+            if ((container.type == JsonEvent::Type::StartObject) == (event.type == JsonEvent::Type::Key))
+                ++container.count;
+        }
+
+        auto index = tape.m_entries.size();
+        Entry entry {};
+        entry.type = event.type;
+        entry.offset = reader.token_start_offset();
+        entry.length = reader.offset() - reader.token_start_offset();
+        entry.next_index = index + 1;
+
+        if (event.type == JsonEvent::Type::Key || event.type == JsonEvent::Type::String) {
+            // Strings without escapes are returned as a view into the input, right after the opening quote.
+            auto const* unquoted_start = input.characters_without_null_termination() + entry.offset + 1;
+            if (event.text.characters_without_null_termination() != unquoted_start) {
+                entry.is_unescaped = true;
+                entry.unescaped_offset = tape.m_unescaped_strings.size();
+                entry.unescaped_length = event.text.length();
+                TRY(tape.m_unescaped_strings.try_append(event.text.bytes().data(), event.text.length()));
+            }
+        } else if (event.is_start_of_container()) {
+            TRY(open_containers.try_append(index));
+        }
+
+        TRY(tape.m_entries.try_append(entry));
+    }
+
+    return tape;
+}
+
+JsonEvent::Type JsonTapeValue::type() const
+{
+    return m_tape->m_entries[m_index].type;
+}
+
+StringView JsonTapeValue::text() const
+{
+    auto const& entry = m_tape->m_entries[m_index];
+    if (entry.is_unescaped)
+        return StringView { m_tape->m_unescaped_strings.span().slice(entry.unescaped_offset, entry.unescaped_length) };
+    if (entry.type == JsonEvent::Type::Key || entry.type == JsonEvent::Type::String)
+        return m_tape->m_input.substring_view(entry.offset + 1, entry.length - 2);
+    return m_tape->m_input.substring_view(entry.offset, entry.length);
+}
+
+size_t JsonTapeValue::next_index() const
+{
+    return m_tape->m_entries[m_index].next_index;
+}
+
+size_t JsonTapeValue::size() const
+{
+    VERIFY(is_object() || is_array());
+    return m_tape->m_entries[m_index].count;
+}
+
+Optional<JsonTapeValue> JsonTapeValue::get(StringView key) const
+{
+    VERIFY(is_object());
+    auto index = m_index + 1;
+    for (size_t i = 0, count = size(); i < count; ++i) {
+        JsonTapeValue value { *m_tape, index + 1 };
+        if (JsonTapeValue { *m_tape, index }.text() == key)
+            return value;
+        index = value.next_index();
+    }
+    return {};
+}
+
+JsonTapeValue JsonTapeValue::at(size_t index) const
+{
+    VERIFY(is_array());
+    VERIFY(index < size());
+    JsonTapeValue value { *m_tape, m_index + 1 };
+    for (size_t i = 0; i < index; ++i)
+        value.m_index = value.next_index();
+    return value;
+}
+
+StringView JsonTapeValue::source() const
+{
+    auto const& entry = m_tape->m_entries[m_index];
+    return m_tape->m_input.substring_view(entry.offset, entry.length);
+}
+
+ErrorOr<JsonValue> JsonTapeValue::to_json_value() const
+{
+    switch (type()) {
+    case JsonEvent::Type::String:
+        return JsonValue { DeprecatedString { as_string() } };
+    case JsonEvent::Type::True:
+    case JsonEvent::Type::False:
+        return JsonValue { as_bool() };
+    case JsonEvent::Type::Null:
+        return JsonValue {};
+    default:
+        // Numbers and containers go through JsonParser, so they come out exactly like they would from there.
+        return JsonParser { source() }.parse();
+    }
+}
+
+}
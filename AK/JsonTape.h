@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/JsonReader.h>
+#include <AK/JsonValue.h>
+#include <AK/Vector.h>
+
+namespace AK {
+
+class JsonTape;
+
+// A value in a JsonTape. Looking things up in it only walks the tape, nothing is converted until it's asked for.
+class JsonTapeValue {
+public:
+    bool is_object() const { return type() == JsonEvent::Type::StartObject; }
+    bool is_array() const { return type() == JsonEvent::Type::StartArray; }
+    bool is_string() const { return type() == JsonEvent::Type::String; }
+    bool is_number() const { return type() == JsonEvent::Type::Number; }
+    bool is_bool() const { return type() == JsonEvent::Type::True || type() == JsonEvent::Type::False; }
+    bool is_null() const { return type() == JsonEvent::Type::Null; }
+
+    // The number of members of an object, or elements of an array.
+    size_t size() const;
+
+    Optional<JsonTapeValue> get(StringView key) const;
+    JsonTapeValue at(size_t index) const;
+
+    template<typename Callback>
+    void for_each_member(Callback callback) const
+    {
+        VERIFY(is_object());
+        auto index = m_index + 1;
+        for (size_t i = 0, count = size(); i < count; ++i) {
+            JsonTapeValue value { *m_tape, index + 1 };
+            callback(JsonTapeValue { *m_tape, index }.text(), value);
+            index = value.next_index();
+        }
+    }
+
+    template<typename Callback>
+    void for_each_element(Callback callback) const
+    {
+        VERIFY(is_array());
+        auto index = m_index + 1;
+        for (size_t i = 0, count = size(); i < count; ++i) {
+            JsonTapeValue value { *m_tape, index };
+            callback(value);
+            index = value.next_index();
+        }
+    }
+
+    StringView as_string() const
+    {
+        VERIFY(is_string());
+        return text();
+    }
+
+    bool as_bool() const
+    {
+        VERIFY(is_bool());
+        return type() == JsonEvent::Type::True;
+    }
+
+    template<Arithmetic T>
+    Optional<T> to_number() const
+    {
+        return JsonEvent { type(), text() }.to_number<T>();
+    }
+
+    // The whole value as it was written in the input.
+    StringView source() const;
+
+    ErrorOr<JsonValue> to_json_value() const;
+
+private:
+    friend class JsonTape;
+
+    JsonTapeValue(JsonTape const& tape, size_t index)
+        : m_tape(&tape)
+        , m_index(index)
+    {
+    }
+
+    JsonEvent::Type type() const;
+    StringView text() const;
+    size_t next_index() const;
+
+    JsonTape const* m_tape { nullptr };
+    size_t m_index { 0 };
+};
+
+// Indexes the structure of a JSON document in a single pass, so that it can be looked at on demand.
+// NOTE: The tape refers to the input it was created from, which has to outlive it.
+class JsonTape {
+public:
+    static ErrorOr<JsonTape> create(StringView input);
+
+    JsonTapeValue root() const { return { *this, 0 }; }
+
+private:
+    friend class JsonTapeValue;
+
+    struct Entry {
+        JsonEvent::Type type { JsonEvent::Type::Null };
+        // Where the value was written in the input.
+        u32 offset { 0 };
+        u32 length { 0 };
+        // The index after this value and everything in it.
+        u32 next_index { 0 };
+        // The number of members or elements in an object or array.
+        u32 count { 0 };
+        // Strings with escapes are unescaped into m_unescaped_strings, all others are read from between their quotes.
+        bool is_unescaped { false };
+        u32 unescaped_offset { 0 };
+        u32 unescaped_length { 0 };
+    };
+
+    explicit JsonTape(StringView input)
+        : m_input(input)
+    {
+    }
+
+    StringView m_input;
+    Vector<Entry> m_entries;
+    Vector<u8> m_unescaped_strings;
+};
+
+}
+
+#if USING_AK_GLOBALLY
+using AK::JsonTape;
+using AK::JsonTapeValue;
+#endif
@@ -8,6 +8,7 @@
 
 #include <AK/Array.h>
 #include <AK/Assertions.h>
+#include <AK/ByteSearch.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
@@ -115,16 +116,28 @@ inline Optional<size_t> memmem_optional(void const* haystack, size_t haystack_le
         return {};
     }
 
+    // Skip ahead to the first possible match, which also gets us out of here quickly if there isn't one at all.
+    auto first_candidate = find_byte({ (u8 const*)haystack, haystack_length - needle_length + 1 }, *(u8 const*)needle);
+    if (!first_candidate.has_value())
+        return {};
+    if (needle_length == 1)
+        return first_candidate;
+    haystack = (u8 const*)haystack + *first_candidate;
+    haystack_length -= *first_candidate;
+
     if (needle_length < 32) {
         auto const* ptr = Detail::bitap_bitwise(haystack, haystack_length, needle, needle_length);
         if (ptr)
-            return static_cast<size_t>((FlatPtr)ptr - (FlatPtr)haystack);
+            return static_cast<size_t>((FlatPtr)ptr - (FlatPtr)haystack) + *first_candidate;
         return {};
     }
 
     // Fallback to KMP.
     Array<ReadonlyBytes, 1> spans { ReadonlyBytes { (u8 const*)haystack, haystack_length } };
-    return memmem(spans.begin(), spans.end(), { (u8 const*)needle, needle_length });
+    auto index = memmem(spans.begin(), spans.end(), { (u8 const*)needle, needle_length });
+    if (index.has_value())
+        return *index + *first_candidate;
+    return {};
 }
 
 inline void const* memmem(void const* haystack, size_t haystack_length, void const* needle, size_t needle_length)
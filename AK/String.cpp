@@ -5,6 +5,7 @@
  */
 
 #include <AK/Array.h>
+#include <AK/AtomicRefCounted.h>
 #include <AK/Checked.h>
 #include <AK/FlyString.h>
 #include <AK/Format.h>
@@ -18,7 +19,7 @@ namespace AK {
 
 namespace Detail {
 
-class StringData final : public RefCounted<StringData> {
+class StringData final : public AtomicRefCounted<StringData> {
 public:
     static ErrorOr<NonnullRefPtr<StringData>> create_uninitialized(size_t, u8*& buffer);
     static ErrorOr<NonnullRefPtr<StringData>> create_substring(StringData const& superstring, size_t start, size_t byte_count);
@@ -103,7 +104,7 @@ StringData::StringData(StringData const& superstring, size_t start, size_t byte_
 StringData::~StringData()
 {
     if (m_is_fly_string)
-        FlyString::did_destroy_fly_string_data({}, bytes_as_string_view());
+        FlyString::did_destroy_fly_string_data({}, reinterpret_cast<uintptr_t>(this), hash());
     if (m_substring)
         substring_data().superstring->unref();
 }
@@ -499,6 +500,18 @@ StringView String::fly_string_data_to_string_view(Badge<FlyString>, uintptr_t co
     return string_data->bytes_as_string_view();
 }
 
+u32 String::fly_string_data_to_hash(Badge<FlyString>, uintptr_t const& data)
+{
+    if (has_short_string_bit(data)) {
+        auto bytes = reinterpret_cast<ShortString const*>(&data)->bytes();
+        return string_hash(reinterpret_cast<char const*>(bytes.data()), bytes.size());
+    }
+
+    // NOTE: Fly strings get their hash computed when they are interned, so this only reads the cached one.
+    auto const* string_data = reinterpret_cast<Detail::StringData const*>(data);
+    return string_data->hash();
+}
+
 uintptr_t String::to_fly_string_data(Badge<FlyString>) const
 {
     return reinterpret_cast<uintptr_t>(m_data);
@@ -513,6 +526,15 @@ void String::ref_fly_string_data(Badge<FlyString>, uintptr_t data)
     string_data->ref();
 }
 
+bool String::try_ref_fly_string_data(Badge<FlyString>, uintptr_t data)
+{
+    if (has_short_string_bit(data))
+        return true;
+
+    auto const* string_data = reinterpret_cast<Detail::StringData const*>(data);
+    return string_data->try_ref();
+}
+
 void String::unref_fly_string_data(Badge<FlyString>, uintptr_t data)
 {
     if (has_short_string_bit(data))
@@ -202,9 +202,11 @@ public:
 
     [[nodiscard]] static String fly_string_data_to_string(Badge<FlyString>, uintptr_t const&);
     [[nodiscard]] static StringView fly_string_data_to_string_view(Badge<FlyString>, uintptr_t const&);
+    [[nodiscard]] static u32 fly_string_data_to_hash(Badge<FlyString>, uintptr_t const&);
     [[nodiscard]] uintptr_t to_fly_string_data(Badge<FlyString>) const;
 
     static void ref_fly_string_data(Badge<FlyString>, uintptr_t);
+    [[nodiscard]] static bool try_ref_fly_string_data(Badge<FlyString>, uintptr_t);
     static void unref_fly_string_data(Badge<FlyString>, uintptr_t);
     void did_create_fly_string(Badge<FlyString>) const;
 
@@ -6,8 +6,8 @@
 
 #pragma once
 
+#include <AK/AtomicRefCounted.h>
 #include <AK/Badge.h>
-#include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
@@ -22,7 +22,7 @@ enum ShouldChomp {
 
 size_t allocation_size_for_stringimpl(size_t length);
 
-class StringImpl : public RefCounted<StringImpl> {
+class StringImpl : public AtomicRefCounted<StringImpl> {
 public:
     static NonnullRefPtr<StringImpl> create_uninitialized(size_t length, char*& buffer);
     static RefPtr<StringImpl> create(char const* cstring, ShouldChomp = NoChomp);
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/IntegralMath.h>
+#include <AK/Noncopyable.h>
+#include <AK/Platform.h>
+#include <AK/Types.h>
+
+#if defined(AK_OS_WINDOWS)
+// Forward declare to avoid pulling Windows.h into every file in existence.
+extern "C" __declspec(dllimport) void __stdcall Sleep(unsigned long);
+#    ifndef sched_yield
+#        define sched_yield() Sleep(0)
+#    endif
+#elif !defined(KERNEL)
+#    include <sched.h>
+#endif
+
+namespace AK::Detail {
+
+// The tables behind FlyString and DeprecatedFlyString, split into shards that each have their own lock.
+// Interning is short and almost never contended, so a spinning lock that yields is all we need here.
+template<typename TableType, size_t ShardCount = 32>
+class StringInterningTable {
+    AK_MAKE_NONCOPYABLE(StringInterningTable);
+    AK_MAKE_NONMOVABLE(StringInterningTable);
+
+    static_assert(is_power_of_two(ShardCount));
+
+public:
+    StringInterningTable() = default;
+
+    // Runs callback with exclusive access to the shard that strings with the given hash live in.
+    template<typename Callback>
+    decltype(auto) with_shard(unsigned hash, Callback callback)
+    {
+        auto& shard = shard_for_hash(hash);
+        Locker locker { shard.lock };
+        return callback(shard.table);
+    }
+
+    size_t size()
+    {
+        size_t size = 0;
+        for (auto& shard : m_shards) {
+            Locker locker { shard.lock };
+            size += shard.table.size();
+        }
+        return size;
+    }
+
+private:
+    class Lock {
+    public:
+        void lock()
+        {
+            while (m_locked.exchange(true, AK::MemoryOrder::memory_order_acquire))
+                sched_yield();
+        }
+
+        void unlock() { m_locked.store(false, AK::MemoryOrder::memory_order_release); }
+
+    private:
+        Atomic<bool> m_locked { false };
+    };
+
+    class Locker {
+    public:
+        explicit Locker(Lock& lock)
+            : m_lock(lock)
+        {
+            m_lock.lock();
+        }
+        ~Locker() { m_lock.unlock(); }
+
+    private:
+        Lock& m_lock;
+    };
+
+    struct Shard {
+        Lock lock;
+        TableType table;
+    };
+
+    Shard& shard_for_hash(unsigned hash)
+    {
+        // The tables themselves bucket by the low bits, so pick the shard by the high ones.
+        static constexpr size_t shard_shift = 32 - AK::log2(ShardCount);
+        return m_shards[(static_cast<u32>(hash) * 0x9e3779b1u) >> shard_shift];
+    }
+
+    Array<Shard, ShardCount> m_shards;
+};
+
+}
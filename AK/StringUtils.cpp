@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteSearch.h>
 #include <AK/CharacterTypes.h>
 #include <AK/MemMem.h>
 #include <AK/Optional.h>
@@ -384,11 +385,10 @@ Optional<size_t> find(StringView haystack, char needle, size_t start)
 {
     if (start >= haystack.length())
         return {};
-    for (size_t i = start; i < haystack.length(); ++i) {
-        if (haystack[i] == needle)
-            return i;
-    }
-    return {};
+    auto index = find_byte(haystack.bytes().slice(start), needle);
+    if (!index.has_value())
+        return {};
+    return *index + start;
 }
 
 Optional<size_t> find(StringView haystack, StringView needle, size_t start)
@@ -403,11 +403,7 @@ Optional<size_t> find(StringView haystack, StringView needle, size_t start)
 
 Optional<size_t> find_last(StringView haystack, char needle)
 {
-    for (size_t i = haystack.length(); i > 0; --i) {
-        if (haystack[i - 1] == needle)
-            return i - 1;
-    }
-    return {};
+    return find_last_byte(haystack.bytes(), needle);
 }
 
 Optional<size_t> find_last(StringView haystack, StringView needle)
@@ -451,10 +447,7 @@ Optional<size_t> find_any_of(StringView haystack, StringView needles, SearchDire
     if (haystack.is_empty() || needles.is_empty())
         return {};
     if (direction == SearchDirection::Forward) {
-        for (size_t i = 0; i < haystack.length(); ++i) {
-            if (needles.contains(haystack[i]))
-                return i;
-        }
+        return find_any_of_bytes(haystack.bytes(), needles.bytes());
     } else if (direction == SearchDirection::Backward) {
         for (size_t i = haystack.length(); i > 0; --i) {
             if (needles.contains(haystack[i - 1]))
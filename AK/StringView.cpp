@@ -6,6 +6,7 @@
 
 #include <AK/AnyOf.h>
 #include <AK/ByteBuffer.h>
+#include <AK/ByteSearch.h>
 #include <AK/Find.h>
 #include <AK/Function.h>
 #include <AK/StringBuilder.h>
@@ -144,11 +145,7 @@ bool StringView::matches(StringView mask, CaseSensitivity case_sensitivity) cons
 
 bool StringView::contains(char needle) const
 {
-    for (char current : *this) {
-        if (current == needle)
-            return true;
-    }
-    return false;
+    return find_byte(bytes(), needle).has_value();
 }
 
 bool StringView::contains(u32 needle) const
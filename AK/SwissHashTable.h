@@ -0,0 +1,591 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/ByteSearch.h>
+#include <AK/Concepts.h>
+#include <AK/Error.h>
+#include <AK/Forward.h>
+#include <AK/HashTable.h>
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Traits.h>
+#include <AK/Types.h>
+#include <AK/kmalloc.h>
+
+namespace AK {
+
+// A SwissHashTable keeps one control byte per slot in an array of its own, separate from the slots themselves.
+// Full slots store 7 bits of their hash in the control byte, so lookups can check a whole group of control bytes
+// at once and only touch the slots whose bits match. Groups are probed quadratically, and the table is allowed
+// to fill up to 7/8 of its capacity, since missing lookups stop at the first group that has an empty slot.
+//
+// Unlike HashTable, it does not support keeping the insertion order.
+
+namespace Detail {
+
+enum class SwissControlByte : u8 {
+    Empty = 0x80,
+    Deleted = 0xfe,
+    // Anything with the top bit clear is a full slot.
+};
+
+static constexpr size_t swiss_group_size = 16;
+
+// A SwissGroup is a view of swiss_group_size consecutive control bytes.
+struct SwissGroup {
+    explicit SwissGroup(u8 const* control_bytes)
+        : control_bytes(control_bytes)
+    {
+    }
+
+    // Returns a mask with bit N set if the control byte N is equal to value.
+    ALWAYS_INLINE u32 match(u8 value) const
+    {
+#if AK_BYTE_SEARCH_USES_SIMD
+        return matching_bytes(load_byte_vector(control_bytes), splat_byte_vector(value));
+#else
+        u32 mask = 0;
+        for (size_t i = 0; i < swiss_group_size; ++i) {
+            if (control_bytes[i] == value)
+                mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    ALWAYS_INLINE u32 match_empty() const { return match(to_underlying(SwissControlByte::Empty)); }
+
+    // Returns a mask of the full slots in the group, which are the ones with the top bit clear.
+    ALWAYS_INLINE u32 match_full() const
+    {
+#if AK_BYTE_SEARCH_USES_SIMD
+        return ~byte_vector_mask(load_byte_vector(control_bytes)) & 0xffff;
+#else
+        u32 mask = 0;
+        for (size_t i = 0; i < swiss_group_size; ++i) {
+            if (!(control_bytes[i] & 0x80))
+                mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    u8 const* control_bytes;
+};
+
+// The upper bits of the hash pick the group to start probing at, these select the slots to look at within a group.
+// The hash is mixed first, so that hashes that only differ in their lower bits don't all end up with the same bits here.
+ALWAYS_INLINE static u8 swiss_hash_bits_for_control_byte(unsigned hash)
+{
+    return static_cast<u8>((hash * 0x9e3779b1u) >> 25);
+}
+
+}
+
+template<typename HashTableType, typename T>
+class SwissHashTableIterator {
+    friend HashTableType;
+
+public:
+    bool operator==(SwissHashTableIterator const& other) const { return m_index == other.m_index; }
+    bool operator!=(SwissHashTableIterator const& other) const { return m_index != other.m_index; }
+    T& operator*() { return m_table->m_slots[m_index]; }
+    T* operator->() { return &m_table->m_slots[m_index]; }
+    void operator++()
+    {
+        ++m_index;
+        skip_to_next_full_slot();
+    }
+
+private:
+    SwissHashTableIterator(HashTableType* table, size_t index)
+        : m_table(table)
+        , m_index(index)
+    {
+    }
+
+    void skip_to_next_full_slot()
+    {
+        auto capacity = m_table->m_capacity;
+        while (m_index < capacity) {
+            // Look at the remainder of the group the index is in, and skip right past it if it has no full slots.
+            auto group_index = m_index & ~(Detail::swiss_group_size - 1);
+            auto mask = Detail::SwissGroup(m_table->m_control_bytes + group_index).match_full() >> (m_index - group_index);
+            if (mask) {
+                m_index += count_trailing_zeroes(mask);
+                return;
+            }
+            m_index = group_index + Detail::swiss_group_size;
+        }
+        m_index = capacity;
+    }
+
+    HashTableType* m_table { nullptr };
+    size_t m_index { 0 };
+};
+
+template<typename T, typename TraitsForT>
+class SwissHashTable {
+    using ControlByte = Detail::SwissControlByte;
+    using Group = Detail::SwissGroup;
+    static constexpr size_t group_size = Detail::swiss_group_size;
+
+public:
+    SwissHashTable() = default;
+    explicit SwissHashTable(size_t capacity) { rehash(capacity_for_size(capacity)); }
+
+    ~SwissHashTable()
+    {
+        if (!m_slots)
+            return;
+
+        if constexpr (!IsTriviallyDestructible<T>) {
+            for (auto& value : *this)
+                value.~T();
+        }
+
+        kfree_sized(m_slots, size_in_bytes(m_capacity));
+    }
+
+    SwissHashTable(SwissHashTable const& other)
+    {
+        rehash(capacity_for_size(other.size()));
+        for (auto& it : other)
+            set(it);
+    }
+
+    SwissHashTable& operator=(SwissHashTable const& other)
+    {
+        SwissHashTable temporary(other);
+        swap(*this, temporary);
+        return *this;
+    }
+
+    SwissHashTable(SwissHashTable&& other) noexcept
+        : m_slots(exchange(other.m_slots, nullptr))
+        , m_control_bytes(exchange(other.m_control_bytes, nullptr))
+        , m_size(exchange(other.m_size, 0))
+        , m_capacity(exchange(other.m_capacity, 0))
+        , m_deleted_count(exchange(other.m_deleted_count, 0))
+    {
+    }
+
+    SwissHashTable& operator=(SwissHashTable&& other) noexcept
+    {
+        SwissHashTable temporary { move(other) };
+        swap(*this, temporary);
+        return *this;
+    }
+
+    friend void swap(SwissHashTable& a, SwissHashTable& b) noexcept
+    {
+        swap(a.m_slots, b.m_slots);
+        swap(a.m_control_bytes, b.m_control_bytes);
+        swap(a.m_size, b.m_size);
+        swap(a.m_capacity, b.m_capacity);
+        swap(a.m_deleted_count, b.m_deleted_count);
+    }
+
+    [[nodiscard]] bool is_empty() const { return m_size == 0; }
+    [[nodiscard]] size_t size() const { return m_size; }
+    [[nodiscard]] size_t capacity() const { return m_capacity; }
+
+    template<typename U, size_t N>
+    ErrorOr<void> try_set_from(U (&from_array)[N])
+    {
+        for (size_t i = 0; i < N; ++i)
+            TRY(try_set(from_array[i]));
+        return {};
+    }
+    template<typename U, size_t N>
+    void set_from(U (&from_array)[N])
+    {
+        MUST(try_set_from(from_array));
+    }
+
+    void ensure_capacity(size_t capacity)
+    {
+        MUST(try_ensure_capacity(capacity));
+    }
+
+    ErrorOr<void> try_ensure_capacity(size_t capacity)
+    {
+        VERIFY(capacity >= size());
+        auto new_capacity = capacity_for_size(capacity);
+        if (new_capacity <= m_capacity)
+            return {};
+        return try_rehash(new_capacity);
+    }
+
+    [[nodiscard]] bool contains(T const& value) const
+    {
+        return find(value) != end();
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] bool contains(K const& value) const
+    {
+        return find(value) != end();
+    }
+
+    using Iterator = SwissHashTableIterator<SwissHashTable, T>;
+    using ConstIterator = SwissHashTableIterator<SwissHashTable const, T const>;
+
+    [[nodiscard]] Iterator begin()
+    {
+        Iterator iterator { this, 0 };
+        iterator.skip_to_next_full_slot();
+        return iterator;
+    }
+    [[nodiscard]] Iterator end() { return Iterator { this, m_capacity }; }
+
+    [[nodiscard]] ConstIterator begin() const
+    {
+        ConstIterator iterator { this, 0 };
+        iterator.skip_to_next_full_slot();
+        return iterator;
+    }
+    [[nodiscard]] ConstIterator end() const { return ConstIterator { this, m_capacity }; }
+
+    void clear()
+    {
+        *this = SwissHashTable();
+    }
+    void clear_with_capacity()
+    {
+        if (m_capacity == 0)
+            return;
+        if constexpr (!IsTriviallyDestructible<T>) {
+            for (auto& value : *this)
+                value.~T();
+        }
+        __builtin_memset(m_control_bytes, to_underlying(ControlByte::Empty), m_capacity);
+        m_size = 0;
+        m_deleted_count = 0;
+    }
+
+    template<typename U = T>
+    ErrorOr<HashSetResult> try_set(U&& value, HashSetExistingEntryBehavior existing_entry_behavior = HashSetExistingEntryBehavior::Replace)
+    {
+        if (should_grow())
+            TRY(try_grow());
+
+        auto hash = TraitsForT::hash(value);
+        auto index_or_existing = lookup_for_writing(hash, [&](auto& other) { return TraitsForT::equals(other, value); });
+        if (index_or_existing.found_existing) {
+            if (existing_entry_behavior == HashSetExistingEntryBehavior::Keep)
+                return HashSetResult::KeptExistingEntry;
+            m_slots[index_or_existing.index] = forward<U>(value);
+            return HashSetResult::ReplacedExistingEntry;
+        }
+
+        new (&m_slots[index_or_existing.index]) T(forward<U>(value));
+        fill_slot(index_or_existing.index, hash);
+        return HashSetResult::InsertedNewEntry;
+    }
+    template<typename U = T>
+    HashSetResult set(U&& value, HashSetExistingEntryBehavior existing_entry_behaviour = HashSetExistingEntryBehavior::Replace)
+    {
+        return MUST(try_set(forward<U>(value), existing_entry_behaviour));
+    }
+
+    template<typename TUnaryPredicate>
+    [[nodiscard]] Iterator find(unsigned hash, TUnaryPredicate predicate)
+    {
+        return Iterator { this, lookup_with_hash(hash, move(predicate)) };
+    }
+
+    [[nodiscard]] Iterator find(T const& value)
+    {
+        return find(TraitsForT::hash(value), [&](auto& other) { return TraitsForT::equals(value, other); });
+    }
+
+    template<typename TUnaryPredicate>
+    [[nodiscard]] ConstIterator find(unsigned hash, TUnaryPredicate predicate) const
+    {
+        return ConstIterator { this, lookup_with_hash(hash, move(predicate)) };
+    }
+
+    [[nodiscard]] ConstIterator find(T const& value) const
+    {
+        return find(TraitsForT::hash(value), [&](auto& other) { return TraitsForT::equals(value, other); });
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] Iterator find(K const& value)
+    {
+        return find(Traits<K>::hash(value), [&](auto& other) { return Traits<T>::equals(other, value); });
+    }
+
+    template<Concepts::HashCompatible<T> K, typename TUnaryPredicate>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] Iterator find(K const& value, TUnaryPredicate predicate)
+    {
+        return find(Traits<K>::hash(value), move(predicate));
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] ConstIterator find(K const& value) const
+    {
+        return find(Traits<K>::hash(value), [&](auto& other) { return Traits<T>::equals(other, value); });
+    }
+
+    template<Concepts::HashCompatible<T> K, typename TUnaryPredicate>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] ConstIterator find(K const& value, TUnaryPredicate predicate) const
+    {
+        return find(Traits<K>::hash(value), move(predicate));
+    }
+
+    bool remove(T const& value)
+    {
+        auto it = find(value);
+        if (it != end()) {
+            remove(it);
+            return true;
+        }
+        return false;
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) bool remove(K const& value)
+    {
+        auto it = find(value);
+        if (it != end()) {
+            remove(it);
+            return true;
+        }
+        return false;
+    }
+
+    void remove(Iterator iterator)
+    {
+        VERIFY(iterator.m_index < m_capacity);
+        VERIFY(is_full(iterator.m_index));
+        delete_slot(iterator.m_index);
+    }
+
+    template<typename TUnaryPredicate>
+    bool remove_all_matching(TUnaryPredicate const& predicate)
+    {
+        size_t removed_count = 0;
+        for (auto it = begin(); it != end(); ++it) {
+            if (predicate(*it)) {
+                delete_slot(it.m_index);
+                ++removed_count;
+            }
+        }
+        return removed_count;
+    }
+
+    T pop()
+    {
+        VERIFY(!is_empty());
+        auto it = begin();
+        T element = move(*it);
+        remove(it);
+        return element;
+    }
+
+private:
+    friend Iterator;
+    friend ConstIterator;
+
+    static constexpr size_t max_size_for_capacity(size_t capacity) { return capacity - capacity / 8; }
+
+    static constexpr size_t capacity_for_size(size_t size)
+    {
+        size_t capacity = group_size;
+        while (max_size_for_capacity(capacity) < size)
+            capacity *= 2;
+        return capacity;
+    }
+
+    // The slots come first, so they get the alignment of the allocation, and the control bytes follow them.
+    [[nodiscard]] static constexpr size_t size_in_bytes(size_t capacity)
+    {
+        return (sizeof(T) + 1) * capacity;
+    }
+
+    [[nodiscard]] bool should_grow() const { return m_size + m_deleted_count + 1 > max_size_for_capacity(m_capacity); }
+
+    ErrorOr<void> try_grow()
+    {
+        // If a lot of the used slots have only been deleted, getting rid of them is enough to make room again.
+        if (m_capacity > 0 && m_size + 1 <= max_size_for_capacity(m_capacity) / 2)
+            return try_rehash(m_capacity);
+        return try_rehash(m_capacity == 0 ? group_size : m_capacity * 2);
+    }
+
+    ErrorOr<void> try_rehash(size_t new_capacity)
+    {
+        VERIFY(new_capacity % group_size == 0 && is_power_of_two(new_capacity));
+
+        auto* new_slots = static_cast<T*>(kmalloc(size_in_bytes(new_capacity)));
+        if (!new_slots)
+            return Error::from_errno(ENOMEM);
+
+        auto* old_slots = m_slots;
+        auto* old_control_bytes = m_control_bytes;
+        auto old_capacity = m_capacity;
+
+        m_slots = new_slots;
+        m_control_bytes = reinterpret_cast<u8*>(new_slots + new_capacity);
+        m_capacity = new_capacity;
+        m_size = 0;
+        m_deleted_count = 0;
+        __builtin_memset(m_control_bytes, to_underlying(ControlByte::Empty), m_capacity);
+
+        if (!old_slots)
+            return {};
+
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (old_control_bytes[i] & 0x80)
+                continue;
+            auto& value = old_slots[i];
+            auto hash = TraitsForT::hash(value);
+            auto index = find_free_slot(hash);
+            new (&m_slots[index]) T(move(value));
+            fill_slot(index, hash);
+            value.~T();
+        }
+
+        kfree_sized(old_slots, size_in_bytes(old_capacity));
+        return {};
+    }
+    void rehash(size_t new_capacity)
+    {
+        MUST(try_rehash(new_capacity));
+    }
+
+    // Visits the groups that may contain a value with the given hash, in the order they have to be looked at.
+    // The callback returns true to stop probing. Since the group count is a power of two, this eventually visits all of them.
+    template<typename Callback>
+    ALWAYS_INLINE void for_each_group_to_probe(unsigned hash, Callback callback) const
+    {
+        size_t group_mask = m_capacity / group_size - 1;
+        size_t group_index = hash & group_mask;
+        for (size_t step = 1;; ++step) {
+            if (callback(group_index * group_size))
+                return;
+            group_index = (group_index + step) & group_mask;
+        }
+    }
+
+    template<typename TUnaryPredicate>
+    [[nodiscard]] size_t lookup_with_hash(unsigned hash, TUnaryPredicate predicate) const
+    {
+        if (is_empty())
+            return m_capacity;
+
+        auto hash_bits = Detail::swiss_hash_bits_for_control_byte(hash);
+        size_t result = m_capacity;
+        for_each_group_to_probe(hash, [&](size_t first_index) {
+            Group group { m_control_bytes + first_index };
+            for (auto mask = group.match(hash_bits); mask; mask &= mask - 1) {
+                auto index = first_index + count_trailing_zeroes(mask);
+                if (predicate(m_slots[index])) {
+                    result = index;
+                    return true;
+                }
+            }
+            // A value would never have been put past a group that still has room.
+            return group.match_empty() != 0;
+        });
+        return result;
+    }
+
+    struct SlotForWriting {
+        size_t index;
+        bool found_existing;
+    };
+
+    // Finds the slot holding the value matching predicate, or the first free slot on its probe sequence otherwise.
+    template<typename TUnaryPredicate>
+    [[nodiscard]] SlotForWriting lookup_for_writing(unsigned hash, TUnaryPredicate predicate) const
+    {
+        auto hash_bits = Detail::swiss_hash_bits_for_control_byte(hash);
+        Optional<size_t> first_free_index;
+        Optional<size_t> existing_index;
+        for_each_group_to_probe(hash, [&](size_t first_index) {
+            Group group { m_control_bytes + first_index };
+            for (auto mask = group.match(hash_bits); mask; mask &= mask - 1) {
+                auto index = first_index + count_trailing_zeroes(mask);
+                if (predicate(m_slots[index])) {
+                    existing_index = index;
+                    return true;
+                }
+            }
+            if (!first_free_index.has_value()) {
+                if (auto mask = group.match_empty() | group.match(to_underlying(ControlByte::Deleted)))
+                    first_free_index = first_index + count_trailing_zeroes(mask);
+            }
+            return group.match_empty() != 0;
+        });
+        if (existing_index.has_value())
+            return { *existing_index, true };
+        // should_grow() makes sure there's always at least one free slot.
+        return { first_free_index.value(), false };
+    }
+
+    [[nodiscard]] size_t find_free_slot(unsigned hash) const
+    {
+        size_t result = 0;
+        for_each_group_to_probe(hash, [&](size_t first_index) {
+            Group group { m_control_bytes + first_index };
+            if (auto mask = group.match_empty() | group.match(to_underlying(ControlByte::Deleted))) {
+                result = first_index + count_trailing_zeroes(mask);
+                return true;
+            }
+            return false;
+        });
+        return result;
+    }
+
+    [[nodiscard]] bool is_full(size_t index) const { return !(m_control_bytes[index] & 0x80); }
+
+    void fill_slot(size_t index, unsigned hash)
+    {
+        if (m_control_bytes[index] == to_underlying(ControlByte::Deleted))
+            --m_deleted_count;
+        m_control_bytes[index] = Detail::swiss_hash_bits_for_control_byte(hash);
+        ++m_size;
+    }
+
+    void delete_slot(size_t index)
+    {
+        m_slots[index].~T();
+        --m_size;
+
+        // Lookups only continue past groups that have no empty slots. If this group already has one,
+        // nobody can be relying on this slot being in use, and it can go straight back to being empty.
+        auto group_index = index & ~(group_size - 1);
+        if (Group(m_control_bytes + group_index).match_empty()) {
+            m_control_bytes[index] = to_underlying(ControlByte::Empty);
+            return;
+        }
+        m_control_bytes[index] = to_underlying(ControlByte::Deleted);
+        ++m_deleted_count;
+    }
+
+    T* m_slots { nullptr };
+    u8* m_control_bytes { nullptr };
+    size_t m_size { 0 };
+    size_t m_capacity { 0 };
+    size_t m_deleted_count { 0 };
+};
+
+struct SwissHashTablePolicy {
+    template<typename T, typename TraitsForT, bool IsOrdered>
+    requires(!IsOrdered) using Table = SwissHashTable<T, TraitsForT>;
+};
+
+}
+
+#if USING_AK_GLOBALLY
+using AK::SwissHashTable;
+#endif
@@ -7,7 +7,9 @@
 
 #pragma once
 
+#include <AK/Allocator.h>
 #include <AK/Assertions.h>
+#include <AK/Checked.h>
 #include <AK/Error.h>
 #include <AK/Find.h>
 #include <AK/Forward.h>
@@ -18,7 +20,6 @@
 #include <AK/StdLibExtras.h>
 #include <AK/Traits.h>
 #include <AK/TypedTransfer.h>
-#include <AK/kmalloc.h>
 #include <initializer_list>
 
 namespace AK {
@@ -41,7 +42,7 @@ struct CanBePlacedInsideVectorHelper<StorageType, false> {
 };
 }
 
-template<typename T, size_t inline_capacity>
+template<typename T, size_t inline_capacity, typename Allocator>
 requires(!IsRvalueReference<T>) class Vector {
 private:
     static constexpr bool contains_reference = IsLvalueReference<T>;
@@ -54,10 +55,17 @@ private:
 
 public:
     using ValueType = T;
+    using AllocatorType = Allocator;
+
     Vector()
     {
     }
 
+    explicit Vector(Allocator allocator)
+        : m_allocator(move(allocator))
+    {
+    }
+
     Vector(std::initializer_list<T> list)
     requires(!IsLvalueReference<T>)
     {
@@ -70,6 +78,7 @@ public:
         : m_size(other.m_size)
         , m_capacity(other.m_capacity)
         , m_outline_buffer(other.m_outline_buffer)
+        , m_allocator(move(other.m_allocator))
     {
         if constexpr (inline_capacity > 0) {
             if (!m_outline_buffer) {
@@ -83,6 +92,7 @@ public:
     }
 
     Vector(Vector const& other)
+        : m_allocator(other.m_allocator)
     {
         ensure_capacity(other.size());
         TypedTransfer<StorageType>::copy(data(), other.data(), other.size());
@@ -331,6 +341,8 @@ public:
             m_size = other.m_size;
             m_capacity = other.m_capacity;
             m_outline_buffer = other.m_outline_buffer;
+            // The buffer has to be given back to the allocator it came from.
+            m_allocator = move(other.m_allocator);
             if constexpr (inline_capacity > 0) {
                 if (!m_outline_buffer) {
                     for (size_t i = 0; i < m_size; ++i) {
@@ -371,7 +383,7 @@ public:
     {
         clear_with_capacity();
         if (m_outline_buffer) {
-            kfree_sized(m_outline_buffer, m_capacity * sizeof(StorageType));
+            m_allocator.deallocate(m_outline_buffer, m_capacity * sizeof(StorageType));
             m_outline_buffer = nullptr;
         }
         reset_capacity();
@@ -645,8 +657,12 @@ public:
     {
         if (m_capacity >= needed_capacity)
             return {};
-        size_t new_capacity = kmalloc_good_size(needed_capacity * sizeof(StorageType)) / sizeof(StorageType);
-        auto* new_buffer = static_cast<StorageType*>(kmalloc_array(new_capacity, sizeof(StorageType)));
+        Checked<size_t> needed_size = needed_capacity;
+        needed_size *= sizeof(StorageType);
+        if (needed_size.has_overflow())
+            return Error::from_errno(ENOMEM);
+        size_t new_capacity = m_allocator.good_size(needed_size.value()) / sizeof(StorageType);
+        auto* new_buffer = static_cast<StorageType*>(m_allocator.allocate(new_capacity * sizeof(StorageType), alignof(StorageType)));
         if (new_buffer == nullptr)
             return Error::from_errno(ENOMEM);
 
@@ -659,7 +675,7 @@ public:
             }
         }
         if (m_outline_buffer)
-            kfree_sized(m_outline_buffer, m_capacity * sizeof(StorageType));
+            m_allocator.deallocate(m_outline_buffer, m_capacity * sizeof(StorageType));
         m_outline_buffer = new_buffer;
         m_capacity = new_capacity;
         return {};
@@ -852,6 +868,7 @@ private:
 
     alignas(storage_alignment()) unsigned char m_inline_buffer_storage[storage_size()];
     StorageType* m_outline_buffer { nullptr };
+    [[no_unique_address]] Allocator m_allocator;
 };
 
 template<class... Args>
@@ -114,4 +114,17 @@ ALWAYS_INLINE int fb_flush_head(int fd)
     return ioctl(fd, GRAPHICS_IOCTL_FLUSH_HEAD, nullptr);
 }
 
+ALWAYS_INLINE int graphics_connector_set_head_cursor(int fd, GraphicsHeadCursor const* cursor)
+{
+    return ioctl(fd, GRAPHICS_IOCTL_SET_HEAD_CURSOR, cursor);
+}
+
+ALWAYS_INLINE int graphics_connector_move_head_cursor(int fd, int x, int y)
+{
+    GraphicsHeadCursorPosition position;
+    position.x = x;
+    position.y = y;
+    return ioctl(fd, GRAPHICS_IOCTL_MOVE_HEAD_CURSOR, &position);
+}
+
 __END_DECLS
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// An I/O ring is a pair of single-producer/single-consumer queues living in memory shared between
+// a process and the kernel (mmap the descriptor returned by io_ring_create() with MAP_SHARED).
+// Userspace appends submissions and advances submission.tail, then calls io_ring_enter() to have
+// the kernel run a whole batch of them; results show up in the completion queue and can be reaped
+// without another syscall.
+
+enum class IORingOperation : u8 {
+    Nop = 0,
+    Read,
+    Write,
+    PRead,
+    PWrite,
+};
+
+struct IORingSubmission {
+    IORingOperation operation;
+    u8 flags;
+    u16 reserved;
+    i32 fd;
+    u64 offset;
+    u64 address;
+    u32 length;
+    u32 reserved2;
+    // Passed through untouched to the matching IORingCompletion.
+    u64 user_data;
+};
+
+struct IORingCompletion {
+    u64 user_data;
+    // Number of bytes transferred, or a negated errno value.
+    i64 result;
+};
+
+struct IORingQueueHeader {
+    // The consumer owns head, the producer owns tail. Both only ever increase and wrap around naturally,
+    // so an index into the entries is (head & mask).
+    u32 head;
+    u32 tail;
+    u32 mask;
+    u32 entry_count;
+    // Offset of the first entry from the start of the shared mapping.
+    u32 entries_offset;
+    u32 reserved[3];
+};
+
+struct IORingHeader {
+    IORingQueueHeader submission;
+    IORingQueueHeader completion;
+};
+
+constexpr u32 IO_RING_MAX_ENTRIES = 4096;
+
+constexpr u32 io_ring_submission_entries_offset()
+{
+    return sizeof(IORingHeader);
+}
+
+constexpr u32 io_ring_completion_entries_offset(u32 entries)
+{
+    return io_ring_submission_entries_offset() + entries * sizeof(IORingSubmission);
+}
+
+// The completion queue is twice as deep as the submission queue, so a full batch
+// can be submitted while the previous one is still waiting to be reaped.
+constexpr u32 io_ring_mapping_size(u32 entries)
+{
+    constexpr u32 page_size = 4096;
+    u32 size = io_ring_completion_entries_offset(entries) + 2 * entries * sizeof(IORingCompletion);
+    return (size + page_size - 1) & ~(page_size - 1);
+}
@@ -24,6 +24,7 @@ struct GraphicsConnectorProperties {
     unsigned char flushing_support;
     unsigned char partial_flushing_support;
     unsigned char refresh_rate_support;
+    unsigned char hardware_cursor_support;
     unsigned max_buffer_bytes;
 };
 
@@ -52,6 +53,22 @@ struct GraphicsHeadVerticalOffset {
     int offsetted;
 };
 
+// Hardware cursors are always GRAPHICS_HEAD_CURSOR_SIZE pixels wide and high.
+#define GRAPHICS_HEAD_CURSOR_SIZE 64
+
+struct GraphicsHeadCursor {
+    int hotspot_x;
+    int hotspot_y;
+    // GRAPHICS_HEAD_CURSOR_SIZE * GRAPHICS_HEAD_CURSOR_SIZE ARGB32 pixels, row by row, or null to hide the cursor.
+    unsigned const* pixels;
+};
+
+// The position of the cursor's hotspot on the head.
+struct GraphicsHeadCursorPosition {
+    int x;
+    int y;
+};
+
 struct FBRect {
     int head_index;
     unsigned x;
@@ -104,6 +121,8 @@ enum IOCtlNumber {
     GRAPHICS_IOCTL_SET_SAFE_HEAD_MODE_SETTING,
     GRAPHICS_IOCTL_SET_RESPONSIBLE,
     GRAPHICS_IOCTL_UNSET_RESPONSIBLE,
+    GRAPHICS_IOCTL_SET_HEAD_CURSOR,
+    GRAPHICS_IOCTL_MOVE_HEAD_CURSOR,
     KEYBOARD_IOCTL_GET_NUM_LOCK,
     KEYBOARD_IOCTL_SET_NUM_LOCK,
     KEYBOARD_IOCTL_GET_CAPS_LOCK,
@@ -140,6 +159,8 @@ enum IOCtlNumber {
     VIRGL_IOCTL_TRANSFER_DATA,
     KDSETMODE,
     KDGETMODE,
+    TRACEPOINT_SET_MASK,
+    TRACEPOINT_GET_CPU_COUNT,
 };
 
 #define TIOCGPGRP TIOCGPGRP
@@ -165,6 +186,8 @@ enum IOCtlNumber {
 #define GRAPHICS_IOCTL_SET_SAFE_HEAD_MODE_SETTING GRAPHICS_IOCTL_SET_SAFE_HEAD_MODE_SETTING
 #define GRAPHICS_IOCTL_SET_RESPONSIBLE GRAPHICS_IOCTL_SET_RESPONSIBLE
 #define GRAPHICS_IOCTL_UNSET_RESPONSIBLE GRAPHICS_IOCTL_UNSET_RESPONSIBLE
+#define GRAPHICS_IOCTL_SET_HEAD_CURSOR GRAPHICS_IOCTL_SET_HEAD_CURSOR
+#define GRAPHICS_IOCTL_MOVE_HEAD_CURSOR GRAPHICS_IOCTL_MOVE_HEAD_CURSOR
 #define KEYBOARD_IOCTL_GET_NUM_LOCK KEYBOARD_IOCTL_GET_NUM_LOCK
 #define KEYBOARD_IOCTL_SET_NUM_LOCK KEYBOARD_IOCTL_SET_NUM_LOCK
 #define KEYBOARD_IOCTL_GET_CAPS_LOCK KEYBOARD_IOCTL_GET_CAPS_LOCK
@@ -196,3 +219,5 @@ enum IOCtlNumber {
 #define VIRGL_IOCTL_TRANSFER_DATA VIRGL_IOCTL_TRANSFER_DATA
 #define KDSETMODE KDSETMODE
 #define KDGETMODE KDGETMODE
+#define TRACEPOINT_SET_MASK TRACEPOINT_SET_MASK
+#define TRACEPOINT_GET_CPU_COUNT TRACEPOINT_GET_CPU_COUNT
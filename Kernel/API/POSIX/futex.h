@@ -51,6 +51,7 @@ extern "C" {
 #define FUTEX_WAKE_OP 5
 #define FUTEX_WAIT_BITSET 9
 #define FUTEX_WAKE_BITSET 10
+#define FUTEX_WAIT_MULTIPLE 13
 
 #define FUTEX_CLOCK_REALTIME (1 << 8)
 #define FUTEX_PRIVATE_FLAG (1 << 9)
@@ -58,6 +59,15 @@ extern "C" {
 
 #define FUTEX_BITSET_MATCH_ANY 0xffffffff
 
+// FUTEX_WAIT_MULTIPLE takes an array of these as its address and their count as its value. It waits (with a relative
+// timeout, like FUTEX_WAIT) until any of the futexes is woken up, and returns the index of that one.
+#define FUTEX_WAIT_MULTIPLE_MAX 128
+
+struct futex_wait_block {
+    uint32_t* uaddr;
+    uint32_t val;
+};
+
 #ifdef __cplusplus
 }
 #endif
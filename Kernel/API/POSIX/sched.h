@@ -21,6 +21,9 @@ struct sched_param {
 #define THREAD_PRIORITY_NORMAL 30
 #define THREAD_PRIORITY_HIGH 50
 #define THREAD_PRIORITY_MAX 99
+// Runs ahead of all other threads for as long as it blocks before its time slice is used up (as an audio mixer would),
+// and is treated like THREAD_PRIORITY_MAX until it blocks again otherwise.
+#define THREAD_PRIORITY_REALTIME 100
 
 #ifdef __cplusplus
 }
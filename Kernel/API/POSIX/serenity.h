@@ -33,6 +33,7 @@ enum {
     PERF_EVENT_SYSCALL = 16384,
     PERF_EVENT_SIGNPOST = 32768,
     PERF_EVENT_READ = 65536,
+    PERF_EVENT_OFF_CPU = 131072,
 };
 
 #define PERF_EVENT_MASK_ALL (~0ull)
@@ -42,6 +43,9 @@ enum {
 #define THREAD_PRIORITY_NORMAL 30
 #define THREAD_PRIORITY_HIGH 50
 #define THREAD_PRIORITY_MAX 99
+// Runs ahead of all other threads for as long as it blocks before its time slice is used up (as an audio mixer would),
+// and is treated like THREAD_PRIORITY_MAX until it blocks again otherwise.
+#define THREAD_PRIORITY_REALTIME 100
 
 #ifdef __cplusplus
 }
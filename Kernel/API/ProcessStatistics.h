@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// /sys/kernel/process_statistics has the same information as /sys/kernel/processes, but as a stream of binary records
+// instead of a JSON document, so collectors that poll it often don't have to generate and parse all that text.
+//
+// It starts with a ProcessStatisticsHeader, which is followed by one ProcessStatisticsRecord per process, each followed
+// by one ThreadStatisticsRecord per thread of that process. Every record starts with a ProcessStatisticsRecordHeader.
+// Fields only ever get appended to the records, so readers should use fixed_size and size from the record header to
+// find the strings and the next record, and treat fields past fixed_size as missing.
+
+static constexpr u32 process_statistics_magic = 0x53434f50; // "POCS"
+static constexpr u16 process_statistics_version = 1;
+
+struct [[gnu::packed]] ProcessStatisticsHeader {
+    u32 magic;
+    u16 version;
+    u16 header_size;
+    u64 total_time_scheduled;
+    u64 total_time_scheduled_kernel;
+};
+
+enum class ProcessStatisticsRecordType : u16 {
+    Process = 1,
+    Thread = 2,
+};
+
+struct [[gnu::packed]] ProcessStatisticsRecordHeader {
+    ProcessStatisticsRecordType type;
+    // The size of the fixed part of the record, after which its strings start.
+    u16 fixed_size;
+    // The size of the whole record, including its strings.
+    u32 size;
+};
+
+// Followed by the name, executable, tty, pledge and veil strings, in that order, without null terminators.
+struct [[gnu::packed]] ProcessStatisticsRecord {
+    ProcessStatisticsRecordHeader header;
+    i32 pid;
+    i32 pgid;
+    i32 pgp;
+    i32 sid;
+    u32 uid;
+    u32 gid;
+    i32 ppid;
+    u32 nfds;
+    u8 kernel;
+    u8 dumpable;
+    u16 padding;
+    u64 amount_virtual;
+    u64 amount_resident;
+    u64 amount_shared;
+    u64 amount_dirty_private;
+    u64 amount_clean_inode;
+    u64 amount_purgeable_volatile;
+    u64 amount_purgeable_nonvolatile;
+    u32 name_length;
+    u32 executable_length;
+    u32 tty_length;
+    u32 pledge_length;
+    u32 veil_length;
+};
+
+// Followed by the name and state strings, in that order, without null terminators.
+struct [[gnu::packed]] ThreadStatisticsRecord {
+    ProcessStatisticsRecordHeader header;
+    i32 tid;
+    u32 times_scheduled;
+    u64 time_user;
+    u64 time_kernel;
+    u32 cpu;
+    u32 priority;
+    u32 syscall_count;
+    u32 inode_faults;
+    u32 zero_faults;
+    u32 cow_faults;
+    u64 unix_socket_read_bytes;
+    u64 unix_socket_write_bytes;
+    u64 ipv4_socket_read_bytes;
+    u64 ipv4_socket_write_bytes;
+    u64 file_read_bytes;
+    u64 file_write_bytes;
+    u32 name_length;
+    u32 state_length;
+};
+
+}
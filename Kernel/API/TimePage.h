@@ -21,9 +21,19 @@ inline bool time_page_supports(clockid_t clock_id)
     return clock_id == CLOCK_REALTIME_COARSE || clock_id == CLOCK_MONOTONIC_COARSE;
 }
 
+// These clocks are only available from the time page while tsc_to_ns_multiplier is non-zero.
+inline bool time_page_supports_precise(clockid_t clock_id)
+{
+    return clock_id == CLOCK_REALTIME || clock_id == CLOCK_MONOTONIC || clock_id == CLOCK_MONOTONIC_RAW;
+}
+
 struct TimePage {
     volatile u32 update1;
     struct timespec clocks[CLOCK_ID_COUNT];
+    // The precise clocks were sampled when the time stamp counter read tsc_base. Userspace extrapolates
+    // them with (rdtsc() - tsc_base) * tsc_to_ns_multiplier >> 32, which is nanoseconds in 32.32 fixed point.
+    u64 tsc_base;
+    u64 tsc_to_ns_multiplier;
     volatile u32 update2;
 };
 
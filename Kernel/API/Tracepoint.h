@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// Tracepoints are static probes compiled into hot kernel paths. They cost a single load and branch
+// until a consumer enables them with TRACEPOINT_SET_MASK on /dev/tracepoints. Every CPU then writes
+// records into its own ring in a buffer shared with the consumer (mmap the device with MAP_SHARED),
+// so producers never contend with each other and the consumer can stream without a syscall per record.
+
+enum class TracepointType : u16 {
+    // args: syscall number, arg1, arg2
+    SyscallEntry = 0,
+    // args: syscall number, return value (negated errno on failure)
+    SyscallExit,
+    // args: request id, block index, (block count << 1) | is_write
+    BlockIOSubmit,
+    // args: request id, AsyncDeviceRequest::RequestResult
+    BlockIOComplete,
+    // args: faulting address, instruction pointer, TRACEPOINT_PAGE_FAULT_* flags
+    PageFault,
+    // args: next tid, next pid
+    ContextSwitch,
+    // args: socket id, byte count, address family
+    SocketEnqueue,
+    // args: socket id, byte count, address family
+    SocketDequeue,
+    __Count,
+};
+
+constexpr u64 tracepoint_type_bit(TracepointType type)
+{
+    return 1ull << static_cast<u16>(type);
+}
+
+constexpr u64 TRACEPOINT_ALL = (1ull << static_cast<u16>(TracepointType::__Count)) - 1;
+
+constexpr u64 TRACEPOINT_PAGE_FAULT_NOT_PRESENT = 1 << 0;
+constexpr u64 TRACEPOINT_PAGE_FAULT_WRITE = 1 << 1;
+constexpr u64 TRACEPOINT_PAGE_FAULT_USER = 1 << 2;
+constexpr u64 TRACEPOINT_PAGE_FAULT_INSTRUCTION_FETCH = 1 << 3;
+
+struct TracepointRecord {
+    // Precise monotonic clock, comparable across all CPUs.
+    u64 timestamp_ns;
+    u16 type;
+    u16 cpu;
+    i32 pid;
+    i32 tid;
+    u32 reserved;
+    u64 args[3];
+};
+
+static_assert(sizeof(TracepointRecord) == 48);
+
+struct TracepointRingHeader {
+    // The kernel owns head, the consumer owns tail. Both only ever increase and wrap around naturally,
+    // so an index into the entries is (index & mask). The kernel never overwrites unconsumed records;
+    // when the ring is full it bumps dropped instead.
+    u32 head;
+    u32 tail;
+    u32 mask;
+    u32 entry_count;
+    u32 dropped;
+    // Offset of the first entry from the start of this ring.
+    u32 entries_offset;
+    u32 reserved[10];
+};
+
+static_assert(sizeof(TracepointRingHeader) == 64);
+
+constexpr u32 TRACEPOINT_RING_ENTRIES = 4096;
+
+// The shared mapping holds one ring per CPU (query the count with TRACEPOINT_GET_CPU_COUNT),
+// each starting at (cpu * tracepoint_ring_size()).
+constexpr u32 tracepoint_ring_size()
+{
+    constexpr u32 page_size = 4096;
+    u32 size = sizeof(TracepointRingHeader) + TRACEPOINT_RING_ENTRIES * sizeof(TracepointRecord);
+    return (size + page_size - 1) & ~(page_size - 1);
+}
@@ -27,6 +27,9 @@ struct VirGLCommandBuffer {
     u32 num_elems;
 };
 
+// Every context has a region of this many pages that backs all of its resources, and transfers go through it.
+#define VIRGL_TRANSFER_REGION_PAGES 1024
+
 #define VIRGL_DATA_DIR_GUEST_TO_HOST 1
 #define VIRGL_DATA_DIR_HOST_TO_GUEST 2
 
@@ -11,6 +11,7 @@
 #include <Kernel/Arch/SafeMem.h>
 #include <Kernel/PerformanceManager.h>
 #include <Kernel/Thread.h>
+#include <Kernel/Tracepoints.h>
 #include <LibC/mallocdefs.h>
 
 namespace Kernel {
@@ -34,6 +35,14 @@ void PageFault::handle(RegisterState& regs)
 
     auto current_thread = Thread::current();
 
+    if (Tracepoints::is_enabled(TracepointType::PageFault)) {
+        u64 flags = (is_not_present() ? TRACEPOINT_PAGE_FAULT_NOT_PRESENT : 0)
+            | (is_write() ? TRACEPOINT_PAGE_FAULT_WRITE : 0)
+            | (is_user() ? TRACEPOINT_PAGE_FAULT_USER : 0)
+            | (is_instruction_fetch() ? TRACEPOINT_PAGE_FAULT_INSTRUCTION_FETCH : 0);
+        Tracepoints::emit(TracepointType::PageFault, fault_address, regs.ip(), flags);
+    }
+
     if (current_thread) {
         current_thread->set_handling_page_fault(true);
         PerformanceManager::add_page_fault_event(*current_thread, regs);
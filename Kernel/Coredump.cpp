@@ -16,6 +16,7 @@
 #include <Kernel/FileSystem/VirtualFileSystem.h>
 #include <Kernel/KLexicalPath.h>
 #include <Kernel/Locking/Spinlock.h>
+#include <Kernel/Memory/InodeVMObject.h>
 #include <Kernel/Memory/ScopedAddressSpaceSwitcher.h>
 #include <Kernel/Process.h>
 #include <LibC/elf.h>
@@ -37,6 +38,23 @@ bool Coredump::FlatRegionData::looks_like_userspace_heap_region() const
     return name().starts_with("LibJS:"sv) || name().starts_with("malloc:"sv);
 }
 
+size_t Coredump::FlatRegionData::compute_dumped_page_count(Memory::Region const& region)
+{
+    // Code and read-only data of the executable and its libraries can be read back from their files, so leave them out.
+    if (region.vmobject().is_inode() && !region.is_writable()) {
+        if (static_cast<Memory::InodeVMObject const&>(region.vmobject()).amount_dirty() == 0)
+            return 0;
+    }
+
+    // Pages that were never written to read as zeroes, so there's no need to store them if they are at the end.
+    for (size_t i = region.page_count(); i > 0; --i) {
+        auto page = region.physical_page(i - 1);
+        if (page && !page->is_shared_zero_page() && !page->is_lazy_committed_page())
+            return i;
+    }
+    return 0;
+}
+
 bool Coredump::FlatRegionData::is_consistent_with_region(Memory::Region const& region) const
 {
     if (m_access != region.access())
@@ -178,7 +196,7 @@ ErrorOr<void> Coredump::write_program_headers(size_t notes_size)
         phdr.p_vaddr = region.vaddr().get();
         phdr.p_paddr = 0;
 
-        phdr.p_filesz = region.page_count() * PAGE_SIZE;
+        phdr.p_filesz = region.dumped_page_count() * PAGE_SIZE;
         phdr.p_memsz = region.page_count() * PAGE_SIZE;
         phdr.p_align = 0;
 
@@ -208,9 +226,12 @@ ErrorOr<void> Coredump::write_program_headers(size_t notes_size)
     return {};
 }
 
+// Regions are copied out and written in chunks of this many pages, so we don't need a buffer as large as the largest region.
+static constexpr size_t region_copy_chunk_page_count = 64;
+
 ErrorOr<void> Coredump::write_regions()
 {
-    u8 zero_buffer[PAGE_SIZE] = {};
+    auto buffer = TRY(KBuffer::try_create_with_size("Coredump Region Copy Buffer"sv, region_copy_chunk_page_count * PAGE_SIZE));
 
     for (auto& region : m_regions) {
         VERIFY(!region.is_kernel());
@@ -223,43 +244,52 @@ ErrorOr<void> Coredump::write_regions()
         if (region.access() == Memory::Region::Access::None)
             continue;
 
-        auto buffer = TRY(KBuffer::try_create_with_size("Coredump Region Copy Buffer"sv, region.page_count() * PAGE_SIZE));
-
-        TRY(m_process->address_space().with([&](auto& space) -> ErrorOr<void> {
-            auto* real_region = space->region_tree().regions().find(region.vaddr().get());
-
-            if (!real_region) {
-                dmesgln("Coredump::write_regions: Failed to find matching region in the process");
-                return Error::from_errno(EFAULT);
-            }
-
-            if (!region.is_consistent_with_region(*real_region)) {
-                dmesgln("Coredump::write_regions: Found region does not match stored metadata");
-                return Error::from_errno(EINVAL);
-            }
-
-            // If we crashed in the middle of mapping in Regions, they do not have a page directory yet, and will crash on a remap() call
-            if (!real_region->is_mapped())
-                return {};
-
-            real_region->set_readable(true);
-            real_region->remap();
-
-            for (size_t i = 0; i < region.page_count(); i++) {
-                auto page = real_region->physical_page(i);
-                auto src_buffer = [&]() -> ErrorOr<UserOrKernelBuffer> {
-                    if (page)
-                        return UserOrKernelBuffer::for_user_buffer(reinterpret_cast<uint8_t*>((region.vaddr().as_ptr() + (i * PAGE_SIZE))), PAGE_SIZE);
+        for (size_t chunk_start = 0; chunk_start < region.dumped_page_count(); chunk_start += region_copy_chunk_page_count) {
+            auto chunk_page_count = min(region_copy_chunk_page_count, region.dumped_page_count() - chunk_start);
+            auto chunk = buffer->bytes().trim(chunk_page_count * PAGE_SIZE);
+
+            TRY(m_process->address_space().with([&](auto& space) -> ErrorOr<void> {
+                auto* real_region = space->region_tree().regions().find(region.vaddr().get());
+
+                if (!real_region) {
+                    dmesgln("Coredump::write_regions: Failed to find matching region in the process");
+                    return Error::from_errno(EFAULT);
+                }
+
+                if (!region.is_consistent_with_region(*real_region)) {
+                    dmesgln("Coredump::write_regions: Found region does not match stored metadata");
+                    return Error::from_errno(EINVAL);
+                }
+
+                // If we crashed in the middle of mapping in Regions, they do not have a page directory yet, and will crash on a remap() call
+                if (!real_region->is_mapped()) {
+                    chunk.fill(0);
+                    return {};
+                }
+
+                if (!real_region->is_readable()) {
+                    real_region->set_readable(true);
+                    real_region->remap();
+                }
+
+                for (size_t i = 0; i < chunk_page_count; i++) {
+                    auto page_index = chunk_start + i;
+                    auto page_bytes = chunk.slice(i * PAGE_SIZE, PAGE_SIZE);
+                    auto page = real_region->physical_page(page_index);
                     // If the current page is not backed by a physical page, we zero it in the coredump file.
-                    return UserOrKernelBuffer::for_kernel_buffer(zero_buffer);
-                }();
-                TRY(src_buffer.value().read(buffer->bytes().slice(i * PAGE_SIZE, PAGE_SIZE)));
-            }
+                    if (!page || page->is_shared_zero_page() || page->is_lazy_committed_page()) {
+                        page_bytes.fill(0);
+                        continue;
+                    }
+                    auto src_buffer = UserOrKernelBuffer::for_user_buffer(reinterpret_cast<uint8_t*>((region.vaddr().as_ptr() + (page_index * PAGE_SIZE))), PAGE_SIZE);
+                    TRY(src_buffer.value().read(page_bytes));
+                }
 
-            return {};
-        }));
+                return {};
+            }));
 
-        TRY(m_description->write(UserOrKernelBuffer::for_kernel_buffer(buffer->data()), buffer->size()));
+            TRY(m_description->write(UserOrKernelBuffer::for_kernel_buffer(chunk.data()), chunk.size()));
+        }
     }
 
     return {};
@@ -29,6 +29,7 @@ private:
     public:
         explicit FlatRegionData(Memory::Region const& region, NonnullOwnPtr<KString> name)
             : m_access(region.access())
+            , m_dumped_page_count(compute_dumped_page_count(region))
             , m_is_executable(region.is_executable())
             , m_is_kernel(region.is_kernel())
             , m_is_readable(region.is_readable())
@@ -47,6 +48,9 @@ private:
         auto is_readable() const { return m_is_readable; }
         auto is_writable() const { return m_is_writable; }
         auto page_count() const { return m_page_count; }
+        // The number of pages (from the start of the region) whose contents go into the coredump file.
+        // The rest of the region is either all zeroes or still available from the file it was mapped from.
+        auto dumped_page_count() const { return m_dumped_page_count; }
         auto size() const { return m_size; }
         auto vaddr() const { return m_vaddr; }
 
@@ -54,7 +58,10 @@ private:
         bool is_consistent_with_region(Memory::Region const& region) const;
 
     private:
+        static size_t compute_dumped_page_count(Memory::Region const&);
+
         Memory::Region::Access m_access;
+        size_t m_dumped_page_count;
         bool m_is_executable;
         bool m_is_kernel;
         bool m_is_readable;
@@ -6,6 +6,7 @@
 
 #include <Kernel/Devices/AsyncDeviceRequest.h>
 #include <Kernel/Devices/Device.h>
+#include <Kernel/Tracepoints.h>
 
 namespace Kernel {
 
@@ -135,6 +136,7 @@ void AsyncDeviceRequest::complete(RequestResult result)
         VERIFY(m_result == Started);
         m_result = result;
     }
+    Tracepoints::emit(TracepointType::BlockIOComplete, bit_cast<FlatPtr>(this), result);
     if (Processor::current_in_irq()) {
         ref(); // Make sure we don't get freed
         Processor::deferred_call_queue([this]() {
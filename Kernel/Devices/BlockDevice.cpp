@@ -6,6 +6,7 @@
 
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/DeviceIdentifiers/BlockDevicesDirectory.h>
+#include <Kernel/Tracepoints.h>
 
 namespace Kernel {
 
@@ -22,6 +23,7 @@ AsyncBlockDeviceRequest::AsyncBlockDeviceRequest(Device& block_device, RequestTy
 
 void AsyncBlockDeviceRequest::start()
 {
+    Tracepoints::emit(TracepointType::BlockIOSubmit, bit_cast<FlatPtr>(this), m_block_index, (static_cast<u64>(m_block_count) << 1) | (m_request_type == Write ? 1 : 0));
     m_block_device.start_request(*this);
 }
 
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/API/Ioctl.h>
+#include <Kernel/Devices/DeviceManagement.h>
+#include <Kernel/Devices/TracepointDevice.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Process.h>
+#include <Kernel/Sections.h>
+#include <Kernel/StdLib.h>
+#include <Kernel/Tracepoints.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT NonnullLockRefPtr<TracepointDevice> TracepointDevice::must_create()
+{
+    auto device_or_error = DeviceManagement::try_create_device<TracepointDevice>();
+    // FIXME: Find a way to propagate errors
+    VERIFY(!device_or_error.is_error());
+    return device_or_error.release_value();
+}
+
+UNMAP_AFTER_INIT TracepointDevice::TracepointDevice()
+    : CharacterDevice(31, 0)
+{
+}
+
+ErrorOr<NonnullLockRefPtr<OpenFileDescription>> TracepointDevice::open(int options)
+{
+    if (!Process::current().credentials()->is_superuser())
+        return EPERM;
+
+    // The rings have a single consumer-owned tail each, so only one consumer can be attached at a time.
+    MutexLocker locker(m_lock);
+    if (m_has_consumer)
+        return EBUSY;
+    (void)TRY(Tracepoints::ensure_buffer());
+    auto description = TRY(Device::open(options));
+    m_has_consumer = true;
+    return description;
+}
+
+ErrorOr<void> TracepointDevice::close()
+{
+    if (attach_count() > 0)
+        return {};
+    MutexLocker locker(m_lock);
+    // Nobody is left to drain the rings, so stop paying for the records.
+    Tracepoints::set_enabled_mask(0);
+    m_has_consumer = false;
+    return {};
+}
+
+ErrorOr<void> TracepointDevice::ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg)
+{
+    switch (request) {
+    case TRACEPOINT_SET_MASK:
+        Tracepoints::set_enabled_mask((FlatPtr)arg.unsafe_userspace_ptr());
+        return {};
+    case TRACEPOINT_GET_CPU_COUNT: {
+        u32 cpu_count = Tracepoints::cpu_count();
+        return copy_to_user(static_ptr_cast<u32*>(arg), &cpu_count);
+    }
+    default:
+        return EINVAL;
+    }
+}
+
+ErrorOr<NonnullLockRefPtr<Memory::VMObject>> TracepointDevice::vmobject_for_mmap(Process&, Memory::VirtualRange const& range, u64& offset, bool shared)
+{
+    if (!shared || offset != 0)
+        return EINVAL;
+    if (range.size() > static_cast<size_t>(Tracepoints::cpu_count()) * tracepoint_ring_size())
+        return EINVAL;
+    return TRY(Tracepoints::ensure_buffer());
+}
+
+}
@@ -7,14 +7,16 @@
 #include <AK/StringView.h>
 #include <Kernel/DoubleBuffer.h>
 #include <Kernel/InterruptDisabler.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/MemoryManager.h>
 
 namespace Kernel {
 
 inline void DoubleBuffer::compute_lockfree_metadata()
 {
     InterruptDisabler disabler;
-    m_empty = m_read_buffer_index >= m_read_buffer->size && m_write_buffer->size == 0;
-    m_space_for_writing = m_capacity - m_write_buffer->size;
+    m_empty = m_read_buffer_index >= m_read_buffer->size && m_write_buffer->size == 0 && !m_transferred_pages;
+    m_space_for_writing = m_transferred_pages ? 0 : m_capacity - m_write_buffer->size;
 }
 
 ErrorOr<NonnullOwnPtr<DoubleBuffer>> DoubleBuffer::try_create(StringView name, size_t capacity)
@@ -60,14 +62,75 @@ ErrorOr<size_t> DoubleBuffer::write(UserOrKernelBuffer const& data, size_t size)
     return bytes_to_write;
 }
 
+ErrorOr<size_t> DoubleBuffer::write_pages(Span<NonnullRefPtr<Memory::PhysicalPage>> pages)
+{
+    if (pages.is_empty())
+        return 0;
+    MutexLocker locker(m_lock);
+    if (m_transferred_pages)
+        return 0;
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_physical_pages(pages));
+    m_transferred_pages = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, pages.size() * PAGE_SIZE, "DoubleBuffer: Transferred pages"sv, Memory::Region::Access::Read));
+    m_transferred_pages_offset = 0;
+    compute_lockfree_metadata();
+    if (m_unblock_callback)
+        m_unblock_callback();
+    return pages.size() * PAGE_SIZE;
+}
+
+ErrorOr<void> DoubleBuffer::try_grow(size_t capacity)
+{
+    MutexLocker locker(m_lock);
+    if (capacity <= m_capacity)
+        return {};
+    auto storage = TRY(KBuffer::try_create_with_size(m_storage->name(), capacity * 2, Memory::Region::Access::ReadWrite));
+
+    // The unread part of the read buffer goes to the front of the new one, the write buffer stays as it is.
+    auto unread_size = m_read_buffer->size - m_read_buffer_index;
+    auto written_size = m_write_buffer->size;
+    memcpy(storage->data(), m_read_buffer->data + m_read_buffer_index, unread_size);
+    memcpy(storage->data() + capacity, m_write_buffer->data, written_size);
+
+    m_buffer1 = { storage->data(), unread_size };
+    m_buffer2 = { storage->data() + capacity, written_size };
+    m_read_buffer = &m_buffer1;
+    m_write_buffer = &m_buffer2;
+    m_read_buffer_index = 0;
+    m_storage = move(storage);
+    m_capacity = capacity;
+    compute_lockfree_metadata();
+    if (m_unblock_callback && m_space_for_writing > 0)
+        m_unblock_callback();
+    return {};
+}
+
+ErrorOr<size_t> DoubleBuffer::read_transferred_pages(UserOrKernelBuffer& data, size_t size, bool advance_buffer_index)
+{
+    VERIFY(m_transferred_pages);
+    size_t nread = min(m_transferred_pages->size() - m_transferred_pages_offset, size);
+    TRY(data.write(m_transferred_pages->vaddr().offset(m_transferred_pages_offset).as_ptr(), nread));
+    if (advance_buffer_index) {
+        m_transferred_pages_offset += nread;
+        if (m_transferred_pages_offset == m_transferred_pages->size())
+            m_transferred_pages = nullptr;
+    }
+    compute_lockfree_metadata();
+    if (m_unblock_callback && m_space_for_writing > 0)
+        m_unblock_callback();
+    return nread;
+}
+
 ErrorOr<size_t> DoubleBuffer::read_impl(UserOrKernelBuffer& data, size_t size, MutexLocker&, bool advance_buffer_index)
 {
     if (size == 0)
         return 0;
     if (m_read_buffer_index >= m_read_buffer->size && m_write_buffer->size != 0)
         flip();
-    if (m_read_buffer_index >= m_read_buffer->size)
+    if (m_read_buffer_index >= m_read_buffer->size) {
+        if (m_transferred_pages)
+            return read_transferred_pages(data, size, advance_buffer_index);
         return 0;
+    }
     size_t nread = min(m_read_buffer->size - m_read_buffer_index, size);
     TRY(data.write(m_read_buffer->data + m_read_buffer_index, nread));
     if (advance_buffer_index)
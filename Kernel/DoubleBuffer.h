@@ -6,9 +6,13 @@
 
 #pragma once
 
+#include <AK/NonnullRefPtr.h>
+#include <AK/Span.h>
 #include <AK/Types.h>
 #include <Kernel/KBuffer.h>
 #include <Kernel/Locking/Mutex.h>
+#include <Kernel/Memory/PhysicalPage.h>
+#include <Kernel/Memory/Region.h>
 #include <Kernel/Thread.h>
 #include <Kernel/UserOrKernelBuffer.h>
 
@@ -35,12 +39,23 @@ public:
         return peek(buffer, size);
     }
 
+    // Queues whole pages behind the buffered data, they are read from directly instead of being copied in first.
+    // No more data can be written until they have been read, so everything is read back in the order it was written.
+    // Returns 0 if there already are pages waiting to be read.
+    ErrorOr<size_t> write_pages(Span<NonnullRefPtr<Memory::PhysicalPage>>);
+    bool has_pages_to_read() const { return !m_transferred_pages.is_null(); }
+
+    // Grows both halves of the buffer to the given capacity, keeping any data that hasn't been read yet.
+    ErrorOr<void> try_grow(size_t capacity);
+    size_t capacity() const { return m_capacity; }
+
     bool is_empty() const { return m_empty; }
 
     size_t space_for_writing() const { return m_space_for_writing; }
     size_t immediately_readable() const
     {
-        return (m_read_buffer->size - m_read_buffer_index) + m_write_buffer->size;
+        size_t pending_transferred_bytes = m_transferred_pages ? m_transferred_pages->size() - m_transferred_pages_offset : 0;
+        return (m_read_buffer->size - m_read_buffer_index) + m_write_buffer->size + pending_transferred_bytes;
     }
 
     void set_unblock_callback(Function<void()> callback)
@@ -55,6 +70,7 @@ private:
     void compute_lockfree_metadata();
 
     ErrorOr<size_t> read_impl(UserOrKernelBuffer&, size_t, MutexLocker&, bool advance_buffer_index);
+    ErrorOr<size_t> read_transferred_pages(UserOrKernelBuffer&, size_t, bool advance_buffer_index);
 
     struct InnerBuffer {
         u8* data { nullptr };
@@ -67,6 +83,8 @@ private:
     InnerBuffer m_buffer2;
 
     NonnullOwnPtr<KBuffer> m_storage;
+    OwnPtr<Memory::Region> m_transferred_pages;
+    size_t m_transferred_pages_offset { 0 };
     Function<void()> m_unblock_callback;
     size_t m_capacity { 0 };
     size_t m_read_buffer_index { 0 };
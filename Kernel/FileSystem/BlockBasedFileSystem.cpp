@@ -5,9 +5,12 @@
  */
 
 #include <AK/IntrusiveList.h>
+#include <AK/QuickSort.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Process.h>
+#include <Kernel/WorkQueue.h>
 
 namespace Kernel {
 
@@ -16,41 +19,52 @@ struct CacheEntry {
     BlockBasedFileSystem::BlockIndex block_index { 0 };
     u8* data { nullptr };
     bool has_data { false };
+    bool is_dirty { false };
+    bool is_protected { false };
 };
 
+// The disk cache uses a simplified 2Q replacement policy: Blocks enter the cache on a
+// probationary queue, and only move to the protected queue once they are accessed again.
+// Evicting from the probationary queue first keeps one-off scans (e.g. reading a large
+// file once) from pushing the frequently used metadata blocks out of the cache.
 class DiskCache {
 public:
-    static constexpr size_t EntryCount = 10000;
-    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
+    explicit DiskCache(BlockBasedFileSystem& fs, size_t entry_count, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
         : m_fs(fs)
+        , m_entry_count(entry_count)
         , m_cached_block_data(move(cached_block_data))
         , m_entries(move(entries_buffer))
     {
-        for (size_t i = 0; i < EntryCount; ++i) {
-            entries()[i].data = m_cached_block_data->data() + i * m_fs->block_size();
-            m_clean_list.append(entries()[i]);
+        for (size_t i = 0; i < m_entry_count; ++i) {
+            auto* entry = new (&entries()[i]) CacheEntry;
+            entry->data = m_cached_block_data->data() + i * m_fs->block_size();
+            enqueue(*entry);
         }
     }
 
     ~DiskCache() = default;
 
     bool is_dirty() const { return !m_dirty_list.is_empty(); }
-    bool entry_is_dirty(CacheEntry const& entry) const { return m_dirty_list.contains(entry); }
+    bool entry_is_dirty(CacheEntry const& entry) const { return entry.is_dirty; }
 
     void mark_all_clean()
     {
         while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
+            mark_clean(*entry);
     }
 
     void mark_dirty(CacheEntry& entry)
     {
-        m_dirty_list.prepend(entry);
+        dequeue(entry);
+        entry.is_dirty = true;
+        enqueue(entry);
     }
 
     void mark_clean(CacheEntry& entry)
     {
-        m_clean_list.prepend(entry);
+        dequeue(entry);
+        entry.is_dirty = false;
+        enqueue(entry);
     }
 
     CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index) const
@@ -63,34 +77,48 @@ public:
         return &entry;
     }
 
-    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index) const
+    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index)
     {
-        if (auto* entry = get(block_index))
+        if (auto* entry = get(block_index)) {
+            if (!entry->is_protected || m_protected_list.first() != entry) {
+                dequeue(*entry);
+                entry->is_protected = true;
+                enqueue(*entry);
+            }
             return entry;
+        }
 
-        if (m_clean_list.is_empty()) {
+        auto* new_entry = entry_to_evict();
+        if (!new_entry) {
             // Not a single clean entry! Flush writes and try again.
-            // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
-            //       not some FileBackedFileSystem subclass flush!
-            m_fs->flush_writes_impl();
+            flush_writes();
             return ensure(block_index);
         }
 
-        VERIFY(m_clean_list.last());
-        auto& new_entry = *m_clean_list.last();
-        m_clean_list.prepend(new_entry);
-
-        m_hash.remove(new_entry.block_index);
-        TRY(m_hash.try_set(block_index, &new_entry));
+        dequeue(*new_entry);
+        m_hash.remove(new_entry->block_index);
+        TRY(m_hash.try_set(block_index, new_entry));
 
-        new_entry.block_index = block_index;
-        new_entry.has_data = false;
+        new_entry->block_index = block_index;
+        new_entry->has_data = false;
+        new_entry->is_protected = false;
+        enqueue(*new_entry);
 
-        return &new_entry;
+        return new_entry;
     }
 
-    CacheEntry const* entries() const { return (CacheEntry const*)m_entries->data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
+    size_t flush_writes()
+    {
+        size_t count = 0;
+        for (auto& entry : m_dirty_list) {
+            auto base_offset = entry.block_index.value() * m_fs->block_size();
+            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+            [[maybe_unused]] auto rc = m_fs->file_description().write(base_offset, entry_data_buffer, m_fs->block_size());
+            ++count;
+        }
+        mark_all_clean();
+        return count;
+    }
 
     template<typename Callback>
     void for_each_dirty_entry(Callback callback)
@@ -99,15 +127,64 @@ public:
             callback(entry);
     }
 
+    CacheEntry const* entries() const { return (CacheEntry const*)m_entries->data(); }
+    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
+
 private:
-    mutable NonnullRefPtr<BlockBasedFileSystem> m_fs;
-    mutable IntrusiveList<&CacheEntry::list_node> m_dirty_list;
-    mutable IntrusiveList<&CacheEntry::list_node> m_clean_list;
-    mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+    CacheEntry* entry_to_evict()
+    {
+        // Keep at least a quarter of the clean entries around for blocks that have been
+        // accessed just once, otherwise new blocks would never get a chance to prove themselves.
+        if (!m_probationary_list.is_empty() && (m_probationary_count > m_entry_count / 4 || m_protected_list.is_empty()))
+            return m_probationary_list.last();
+        if (!m_protected_list.is_empty())
+            return m_protected_list.last();
+        return nullptr;
+    }
+
+    void enqueue(CacheEntry& entry)
+    {
+        VERIFY(!entry.list_node.is_in_list());
+        if (entry.is_dirty) {
+            m_dirty_list.prepend(entry);
+        } else if (entry.is_protected) {
+            m_protected_list.prepend(entry);
+        } else {
+            m_probationary_list.prepend(entry);
+            ++m_probationary_count;
+        }
+    }
+
+    void dequeue(CacheEntry& entry)
+    {
+        VERIFY(entry.list_node.is_in_list());
+        if (!entry.is_dirty && !entry.is_protected)
+            --m_probationary_count;
+        entry.list_node.remove();
+    }
+
+    NonnullRefPtr<BlockBasedFileSystem> m_fs;
+    size_t m_entry_count { 0 };
+    IntrusiveList<&CacheEntry::list_node> m_dirty_list;
+    IntrusiveList<&CacheEntry::list_node> m_probationary_list;
+    IntrusiveList<&CacheEntry::list_node> m_protected_list;
+    size_t m_probationary_count { 0 };
+    HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
     NonnullOwnPtr<KBuffer> m_cached_block_data;
     NonnullOwnPtr<KBuffer> m_entries;
 };
 
+static size_t disk_cache_entry_count_for_block_size(size_t block_size)
+{
+    // Let each file system cache up to 1/32 of physical memory.
+    static constexpr size_t minimum_entry_count = 1024;
+    static constexpr size_t maximum_cache_size = 1 * GiB;
+
+    size_t physical_memory_size = MM.get_system_memory_info().physical_pages * PAGE_SIZE;
+    auto cache_size = min(physical_memory_size / 32, maximum_cache_size);
+    return max(cache_size / block_size, minimum_entry_count);
+}
+
 BlockBasedFileSystem::BlockBasedFileSystem(OpenFileDescription& file_description)
     : FileBackedFileSystem(file_description)
 {
@@ -119,9 +196,11 @@ BlockBasedFileSystem::~BlockBasedFileSystem() = default;
 void BlockBasedFileSystem::remove_disk_cache_before_last_unmount()
 {
     VERIFY(m_lock.is_locked());
-    m_cache.with_exclusive([&](auto& cache) {
-        cache.clear();
-    });
+    for (auto& shard : m_cache_shards) {
+        shard.with_exclusive([&](auto& cache) {
+            cache.clear();
+        });
+    }
 }
 
 ErrorOr<void> BlockBasedFileSystem::initialize_while_locked()
@@ -129,13 +208,19 @@ ErrorOr<void> BlockBasedFileSystem::initialize_while_locked()
     VERIFY(m_lock.is_locked());
     VERIFY(!is_initialized_while_locked());
     VERIFY(block_size() != 0);
-    auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCache::EntryCount * block_size()));
-    auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, DiskCache::EntryCount * sizeof(CacheEntry)));
-    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data))));
 
-    m_cache.with_exclusive([&](auto& cache) {
-        cache = move(disk_cache);
-    });
+    auto entries_per_shard = ceil_div(disk_cache_entry_count_for_block_size(block_size()), cache_shard_count);
+    dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem: Using {} cache shards with {} entries each", cache_shard_count, entries_per_shard);
+
+    for (auto& shard : m_cache_shards) {
+        auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, entries_per_shard * block_size()));
+        auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, entries_per_shard * sizeof(CacheEntry)));
+        auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, entries_per_shard, move(cached_block_data), move(entries_data))));
+
+        shard.with_exclusive([&](auto& cache) {
+            cache = move(disk_cache);
+        });
+    }
     return {};
 }
 
@@ -152,7 +237,7 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
 
     TRY(data.read(buffered_data.bytes()));
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    return cache_shard_for(index).with_exclusive([&](auto& cache) -> ErrorOr<void> {
         if (!allow_cache) {
             flush_specific_block_if_needed(index);
             u64 base_offset = index.value() * block_size() + offset;
@@ -192,20 +277,28 @@ ErrorOr<void> BlockBasedFileSystem::raw_write(BlockIndex index, UserOrKernelBuff
 
 ErrorOr<void> BlockBasedFileSystem::raw_read_blocks(BlockIndex index, size_t count, UserOrKernelBuffer& buffer)
 {
-    auto current = buffer;
-    for (auto block = index.value(); block < (index.value() + count); block++) {
-        TRY(raw_read(BlockIndex { block }, current));
-        current = current.offset(logical_block_size());
+    // Note: Hand the whole run to the device at once, so it can be split into as few requests as the device allows.
+    auto base_offset = index.value() * m_logical_block_size;
+    size_t total_size = count * m_logical_block_size;
+    size_t nread = 0;
+    while (nread < total_size) {
+        auto current = buffer.offset(nread);
+        auto chunk_size = TRY(file_description().read(current, base_offset + nread, total_size - nread));
+        VERIFY(chunk_size > 0);
+        nread += chunk_size;
     }
     return {};
 }
 
 ErrorOr<void> BlockBasedFileSystem::raw_write_blocks(BlockIndex index, size_t count, UserOrKernelBuffer const& buffer)
 {
-    auto current = buffer;
-    for (auto block = index.value(); block < (index.value() + count); block++) {
-        TRY(raw_write(block, current));
-        current = current.offset(logical_block_size());
+    auto base_offset = index.value() * m_logical_block_size;
+    size_t total_size = count * m_logical_block_size;
+    size_t nwritten = 0;
+    while (nwritten < total_size) {
+        auto chunk_size = TRY(file_description().write(base_offset + nwritten, buffer.offset(nwritten), total_size - nwritten));
+        VERIFY(chunk_size > 0);
+        nwritten += chunk_size;
     }
     return {};
 }
@@ -226,7 +319,7 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
     VERIFY(offset + count <= block_size());
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_block {}", index);
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    return cache_shard_for(index).with_exclusive([&](auto& cache) -> ErrorOr<void> {
         if (!allow_cache) {
             const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(index);
             u64 base_offset = index.value() * block_size() + offset;
@@ -236,7 +329,10 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
         }
 
         auto* entry = TRY(cache->ensure(index));
-        if (!entry->has_data) {
+        if (entry->has_data) {
+            m_cache_hit_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        } else {
+            m_cache_miss_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
             auto base_offset = index.value() * block_size();
             auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
             auto nread = TRY(file_description().read(entry_data_buffer, base_offset, block_size()));
@@ -265,9 +361,76 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
     return {};
 }
 
+void BlockBasedFileSystem::schedule_readahead(Vector<BlockIndex>&& blocks)
+{
+    if (blocks.is_empty())
+        return;
+    // NOTE: Readahead is only a hint, so it's fine if we can't queue it.
+    [[maybe_unused]] auto result = g_readahead_work->try_queue([fs = NonnullRefPtr<BlockBasedFileSystem>(*this), blocks = move(blocks)] {
+        fs->read_ahead(blocks);
+    });
+}
+
+void BlockBasedFileSystem::read_ahead(Vector<BlockIndex> const& blocks)
+{
+    static constexpr size_t maximum_blocks_per_read = 64;
+
+    auto is_cached = [&](BlockIndex index) {
+        return cache_shard_for(index).with_exclusive([&](auto& cache) {
+            // The cache is gone once the file system is being unmounted, so pretend we already have everything.
+            if (!cache)
+                return true;
+            auto* entry = cache->get(index);
+            return entry && entry->has_data;
+        });
+    };
+
+    size_t i = 0;
+    while (i < blocks.size()) {
+        if (is_cached(blocks[i])) {
+            ++i;
+            continue;
+        }
+
+        size_t run_length = 1;
+        while (i + run_length < blocks.size()
+            && run_length < maximum_blocks_per_read
+            && blocks[i + run_length].value() == blocks[i].value() + run_length
+            && !is_cached(blocks[i + run_length]))
+            ++run_length;
+
+        auto buffer_or_error = KBuffer::try_create_with_size("BlockBasedFS: Readahead"sv, run_length * block_size());
+        if (buffer_or_error.is_error())
+            return;
+        auto buffer = buffer_or_error.release_value();
+        auto user_or_kernel_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer->data());
+        auto nread_or_error = file_description().read(user_or_kernel_buffer, blocks[i].value() * block_size(), run_length * block_size());
+        if (nread_or_error.is_error() || nread_or_error.value() != run_length * block_size())
+            return;
+
+        for (size_t j = 0; j < run_length; ++j) {
+            auto index = blocks[i + j];
+            cache_shard_for(index).with_exclusive([&](auto& cache) {
+                if (!cache)
+                    return;
+                auto entry_or_error = cache->ensure(index);
+                if (entry_or_error.is_error())
+                    return;
+                auto* entry = entry_or_error.release_value();
+                // Someone else may have read or written this block while we were waiting for the device.
+                if (entry->has_data)
+                    return;
+                memcpy(entry->data, buffer->data() + j * block_size(), block_size());
+                entry->has_data = true;
+            });
+        }
+        i += run_length;
+    }
+}
+
 void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
 {
-    m_cache.with_exclusive([&](auto& cache) {
+    cache_shard_for(index).with_exclusive([&](auto& cache) {
         if (!cache->is_dirty())
             return;
         auto* entry = cache->get(index);
@@ -281,21 +444,83 @@ void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
     });
 }
 
+template<typename Callback>
+static void with_all_cache_shards_locked(Span<MutexProtected<OwnPtr<DiskCache>>> shards, Vector<DiskCache*, 8>& caches, Callback& callback)
+{
+    if (shards.is_empty()) {
+        callback(caches);
+        return;
+    }
+    shards[0].with_exclusive([&](auto& cache) {
+        if (cache)
+            caches.append(cache.ptr());
+        with_all_cache_shards_locked(shards.slice(1), caches, callback);
+    });
+}
+
 void BlockBasedFileSystem::flush_writes_impl()
 {
+    // Consecutive blocks live in different shards, so we have to look at all of them at once
+    // to be able to merge the dirty blocks into large sequential writes.
+    static constexpr size_t maximum_blocks_per_write = 64;
+
     size_t count = 0;
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
+    size_t write_count = 0;
+    auto flush = [&](Vector<DiskCache*, 8>& caches) {
+        Vector<CacheEntry*> dirty_entries;
+        bool found_all_dirty_entries = true;
+        for (auto* cache : caches) {
+            cache->for_each_dirty_entry([&](CacheEntry& entry) {
+                if (dirty_entries.try_append(&entry).is_error())
+                    found_all_dirty_entries = false;
+            });
+        }
+        if (!found_all_dirty_entries) {
+            // Fall back to writing out each block on its own.
+            for (auto* cache : caches) {
+                auto flushed = cache->flush_writes();
+                count += flushed;
+                write_count += flushed;
+            }
             return;
-        cache->for_each_dirty_entry([&](CacheEntry& entry) {
-            auto base_offset = entry.block_index.value() * block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, block_size());
-            ++count;
-        });
-        cache->mark_all_clean();
-        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
-    });
+        }
+        quick_sort(dirty_entries, [](auto* a, auto* b) { return a->block_index < b->block_index; });
+
+        auto buffer_or_error = KBuffer::try_create_with_size("BlockBasedFS: Write-back"sv, maximum_blocks_per_write * block_size());
+
+        size_t i = 0;
+        while (i < dirty_entries.size()) {
+            size_t run_length = 1;
+            if (!buffer_or_error.is_error()) {
+                while (i + run_length < dirty_entries.size()
+                    && run_length < maximum_blocks_per_write
+                    && dirty_entries[i + run_length]->block_index.value() == dirty_entries[i]->block_index.value() + run_length)
+                    ++run_length;
+            }
+
+            auto base_offset = dirty_entries[i]->block_index.value() * block_size();
+            if (run_length == 1) {
+                auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(dirty_entries[i]->data);
+                [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, block_size());
+            } else {
+                auto& buffer = *buffer_or_error.value();
+                for (size_t j = 0; j < run_length; ++j)
+                    memcpy(buffer.data() + j * block_size(), dirty_entries[i + j]->data, block_size());
+                auto run_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer.data());
+                [[maybe_unused]] auto rc = file_description().write(base_offset, run_buffer, run_length * block_size());
+            }
+            ++write_count;
+            i += run_length;
+        }
+
+        for (auto* cache : caches)
+            cache->mark_all_clean();
+        count += dirty_entries.size();
+    };
+    Vector<DiskCache*, 8> caches;
+    with_all_cache_shards_locked(m_cache_shards.span(), caches, flush);
+    if (count)
+        dbgln("{}: Flushed {} blocks to disk in {} writes", class_name(), count, write_count);
 }
 
 void BlockBasedFileSystem::flush_writes()
@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/Vector.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/Locking/MutexProtected.h>
 
@@ -22,6 +25,15 @@ public:
     virtual void flush_writes() override;
     void flush_writes_impl();
 
+    virtual bool is_block_based() const override { return true; }
+
+    // Asynchronously pulls the given blocks into the disk cache, reading runs of
+    // consecutive blocks from the device in one go.
+    void schedule_readahead(Vector<BlockIndex>&&);
+
+    u64 cache_hit_count() const { return m_cache_hit_count.load(AK::MemoryOrder::memory_order_relaxed); }
+    u64 cache_miss_count() const { return m_cache_miss_count.load(AK::MemoryOrder::memory_order_relaxed); }
+
 protected:
     explicit BlockBasedFileSystem(OpenFileDescription&);
 
@@ -45,8 +57,17 @@ protected:
 
 private:
     void flush_specific_block_if_needed(BlockIndex index);
+    void read_ahead(Vector<BlockIndex> const&);
+
+    // The cache is split into shards by block index, so that accesses to unrelated blocks
+    // don't all contend on the same lock.
+    static constexpr size_t cache_shard_count = 8;
+    MutexProtected<OwnPtr<DiskCache>>& cache_shard_for(BlockIndex index) const { return m_cache_shards[index.value() % cache_shard_count]; }
+
+    mutable Array<MutexProtected<OwnPtr<DiskCache>>, cache_shard_count> m_cache_shards;
 
-    mutable MutexProtected<OwnPtr<DiskCache>> m_cache;
+    mutable Atomic<u64> m_cache_hit_count { 0 };
+    mutable Atomic<u64> m_cache_miss_count { 0 };
 };
 
 }
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/KString.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+static BlockFlags block_flags_for_events(u32 events)
+{
+    BlockFlags block_flags = BlockFlags::None;
+    if (events & EPOLLIN)
+        block_flags |= BlockFlags::Read;
+    if (events & EPOLLOUT)
+        block_flags |= BlockFlags::Write;
+    if (events & EPOLLPRI)
+        block_flags |= BlockFlags::ReadPriority;
+    return block_flags;
+}
+
+static u32 events_for_unblock_flags(BlockFlags unblock_flags)
+{
+    u32 events = 0;
+    if (has_flag(unblock_flags, BlockFlags::Read))
+        events |= EPOLLIN;
+    if (has_flag(unblock_flags, BlockFlags::Write))
+        events |= EPOLLOUT;
+    if (has_flag(unblock_flags, BlockFlags::ReadPriority))
+        events |= EPOLLPRI;
+    return events;
+}
+
+ErrorOr<NonnullLockRefPtr<EventPoll>> EventPoll::try_create()
+{
+    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) EventPoll);
+}
+
+EventPoll::~EventPoll()
+{
+    for (auto& it : m_interests)
+        remove_interest_impl(*it.value);
+}
+
+EventPoll::Interest::Interest(EventPoll& event_poll, int fd, OpenFileDescription& description, epoll_event const& event)
+    : event_poll(event_poll)
+    , fd(fd)
+    , file(description.file())
+    , events(event.events)
+    , data(event.data.u64)
+    , description(&description)
+{
+}
+
+void EventPoll::Interest::file_readiness_may_have_changed()
+{
+    event_poll.interest_may_be_ready(*this);
+}
+
+bool EventPoll::Interest::description_will_be_destroyed(OpenFileDescription& destroyed_description)
+{
+    SpinlockLocker lock(event_poll.m_ready_lock);
+    if (description != &destroyed_description)
+        return false;
+    description = nullptr;
+    if (ready_list_node.is_in_list())
+        event_poll.m_ready_interests.remove(*this);
+    event_poll.m_has_dead_interests = true;
+    return true;
+}
+
+void EventPoll::interest_may_be_ready(Interest& interest)
+{
+    {
+        SpinlockLocker lock(m_ready_lock);
+        if (interest.disabled || !interest.description || interest.ready_list_node.is_in_list())
+            return;
+        m_ready_interests.append(interest);
+    }
+    evaluate_block_conditions();
+}
+
+void EventPoll::remove_interest_impl(Interest& interest)
+{
+    // Once the observer is gone nobody else can put the interest back on the ready list.
+    interest.file->blocker_set().remove_readiness_observer(interest);
+    SpinlockLocker lock(m_ready_lock);
+    if (interest.ready_list_node.is_in_list())
+        m_ready_interests.remove(interest);
+}
+
+void EventPoll::remove_dead_interests()
+{
+    VERIFY(m_lock.is_locked());
+    if (!m_has_dead_interests.exchange(false))
+        return;
+    m_interests.remove_all_matching([&](int, NonnullOwnPtr<Interest>& interest) {
+        SpinlockLocker lock(m_ready_lock);
+        return interest->description == nullptr;
+    });
+}
+
+ErrorOr<void> EventPoll::add_interest(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    // An EventPoll watching another one could wake it from inside its own notification, so don't allow nesting them.
+    if (description.file().is_event_poll())
+        return EINVAL;
+
+    MutexLocker locker(m_lock);
+    remove_dead_interests();
+
+    if (auto it = m_interests.find(fd); it != m_interests.end()) {
+        auto& existing = *it->value;
+        bool is_same_description = false;
+        {
+            SpinlockLocker lock(m_ready_lock);
+            is_same_description = existing.description == &description;
+        }
+        if (is_same_description)
+            return EEXIST;
+        // The fd was closed and reused since this interest was added, replace it.
+        remove_interest_impl(existing);
+        m_interests.remove(it);
+    }
+
+    auto interest = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Interest(*this, fd, description, event)));
+    auto& interest_ref = *interest;
+    TRY(m_interests.try_set(fd, move(interest)));
+
+    description.blocker_set().add_readiness_observer(interest_ref);
+    // Put it on the ready list straight away, so the next wait reports whatever the file is already ready for.
+    interest_may_be_ready(interest_ref);
+    return {};
+}
+
+ErrorOr<void> EventPoll::modify_interest(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    MutexLocker locker(m_lock);
+    remove_dead_interests();
+
+    auto it = m_interests.find(fd);
+    if (it == m_interests.end())
+        return ENOENT;
+    auto& interest = *it->value;
+    {
+        SpinlockLocker lock(m_ready_lock);
+        if (interest.description != &description)
+            return ENOENT;
+        interest.disabled = false;
+    }
+    interest.events = event.events;
+    interest.data = event.data.u64;
+    interest_may_be_ready(interest);
+    return {};
+}
+
+ErrorOr<void> EventPoll::remove_interest(int fd)
+{
+    MutexLocker locker(m_lock);
+    auto it = m_interests.find(fd);
+    if (it == m_interests.end())
+        return ENOENT;
+    remove_interest_impl(*it->value);
+    m_interests.remove(it);
+    remove_dead_interests();
+    return {};
+}
+
+ErrorOr<size_t> EventPoll::collect_ready_events(Span<epoll_event> events)
+{
+    MutexLocker locker(m_lock);
+    remove_dead_interests();
+
+    // Level-triggered interests that were reported go back on the ready list once we're done,
+    // so they are checked again by the next wait but not reported twice by this one.
+    Vector<Interest*, 32> still_ready;
+    size_t event_count = 0;
+
+    while (event_count < events.size()) {
+        Interest* interest = nullptr;
+        LockRefPtr<OpenFileDescription> description;
+        {
+            SpinlockLocker lock(m_ready_lock);
+            interest = m_ready_interests.take_first();
+            if (!interest)
+                break;
+            // NOTE: The description may already be on its way out, in which case its destructor will drop the interest.
+            if (!interest->description->try_ref())
+                continue;
+            description = adopt_lock_ref(*interest->description);
+        }
+
+        auto unblock_flags = description->should_unblock(block_flags_for_events(interest->events));
+        if (unblock_flags == BlockFlags::None)
+            continue;
+
+        events[event_count].events = events_for_unblock_flags(unblock_flags);
+        events[event_count].data.u64 = interest->data;
+        ++event_count;
+
+        if (interest->events & EPOLLONESHOT) {
+            SpinlockLocker lock(m_ready_lock);
+            interest->disabled = true;
+        } else if (!(interest->events & EPOLLET)) {
+            TRY(still_ready.try_append(interest));
+        }
+    }
+
+    if (!still_ready.is_empty()) {
+        SpinlockLocker lock(m_ready_lock);
+        for (auto* interest : still_ready) {
+            if (interest->description && !interest->ready_list_node.is_in_list())
+                m_ready_interests.append(*interest);
+        }
+    }
+
+    return event_count;
+}
+
+bool EventPoll::can_read(OpenFileDescription const&, u64) const
+{
+    SpinlockLocker lock(m_ready_lock);
+    return !m_ready_interests.is_empty();
+}
+
+ErrorOr<NonnullOwnPtr<KString>> EventPoll::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::formatted("EventPoll:({})", m_interests.size());
+}
+
+}
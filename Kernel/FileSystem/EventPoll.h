@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Span.h>
+#include <Kernel/API/POSIX/sys/epoll.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/Spinlock.h>
+
+namespace Kernel {
+
+// An EventPoll keeps a persistent set of interests in other files. Each interest observes its file's
+// FileBlockerSet and puts itself on the ready list when the file changes state, so waiting only has to
+// look at the interests that may actually be ready instead of every file in the set.
+class EventPoll final : public File {
+public:
+    static ErrorOr<NonnullLockRefPtr<EventPoll>> try_create();
+    virtual ~EventPoll() override;
+
+    virtual bool is_event_poll() const override { return true; }
+
+    ErrorOr<void> add_interest(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> modify_interest(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> remove_interest(int fd);
+
+    // Fills in events for as many ready interests as fit without blocking and returns how many were reported.
+    ErrorOr<size_t> collect_ready_events(Span<epoll_event>);
+
+private:
+    class Interest final : public FileReadinessObserver {
+    public:
+        Interest(EventPoll&, int fd, OpenFileDescription&, epoll_event const&);
+
+        virtual void file_readiness_may_have_changed() override;
+        virtual bool description_will_be_destroyed(OpenFileDescription&) override;
+
+        EventPoll& event_poll;
+        int const fd;
+        NonnullLockRefPtr<File> const file;
+
+        // These are protected by the EventPoll's m_lock.
+        u32 events { 0 };
+        u64 data { 0 };
+
+        // These are protected by the EventPoll's m_ready_lock.
+        // NOTE: The interest does not keep the description alive, it is cleared when the description is destroyed.
+        OpenFileDescription* description { nullptr };
+        bool disabled { false };
+        IntrusiveListNode<Interest> ready_list_node;
+    };
+
+    EventPoll() = default;
+
+    virtual StringView class_name() const override { return "EventPoll"sv; }
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+
+    void interest_may_be_ready(Interest&);
+    void remove_interest_impl(Interest&);
+    void remove_dead_interests();
+
+    Mutex m_lock { "EventPoll"sv };
+    HashMap<int, NonnullOwnPtr<Interest>> m_interests;
+
+    mutable Spinlock<LockRank::None> m_ready_lock {};
+    IntrusiveList<&Interest::ready_list_node> m_ready_interests;
+    Atomic<bool> m_has_dead_interests { false };
+};
+
+}
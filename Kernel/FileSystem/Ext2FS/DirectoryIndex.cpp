@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <Kernel/FileSystem/Ext2FS/Definitions.h>
+#include <Kernel/FileSystem/Ext2FS/DirectoryIndex.h>
+
+namespace Kernel {
+
+// NOTE: These have to produce exactly the same values as the Linux implementation, since the hashes end up on disk.
+
+static u32 legacy_hash(StringView name, bool is_unsigned)
+{
+    u32 hash = 0;
+    u32 hash0 = 0x12a3fe2d;
+    u32 hash1 = 0x37abe8f9;
+    for (auto c : name) {
+        i32 value = is_unsigned ? static_cast<i32>(static_cast<u8>(c)) : static_cast<i32>(static_cast<i8>(c));
+        hash = hash1 + (hash0 ^ static_cast<u32>(value * 7152373));
+        if (hash & 0x80000000)
+            hash -= 0x7fffffff;
+        hash1 = hash0;
+        hash0 = hash;
+    }
+    return hash0 << 1;
+}
+
+static void string_to_hash_buffer(StringView name, u32* buffer, int word_count, bool is_unsigned)
+{
+    u32 pad = static_cast<u32>(name.length()) | (static_cast<u32>(name.length()) << 8);
+    pad |= pad << 16;
+
+    u32 value = pad;
+    size_t length = min(name.length(), static_cast<size_t>(word_count) * 4);
+    for (size_t i = 0; i < length; ++i) {
+        i32 c = is_unsigned ? static_cast<i32>(static_cast<u8>(name[i])) : static_cast<i32>(static_cast<i8>(name[i]));
+        value = static_cast<u32>(c) + (value << 8);
+        if ((i % 4) == 3) {
+            *buffer++ = value;
+            value = pad;
+            --word_count;
+        }
+    }
+    if (--word_count >= 0)
+        *buffer++ = value;
+    while (--word_count >= 0)
+        *buffer++ = pad;
+}
+
+static void tea_transform(u32* buffer, u32 const* input)
+{
+    static constexpr u32 delta = 0x9E3779B9;
+    u32 sum = 0;
+    u32 b0 = buffer[0];
+    u32 b1 = buffer[1];
+    u32 a = input[0];
+    u32 b = input[1];
+    u32 c = input[2];
+    u32 d = input[3];
+    for (int n = 0; n < 16; ++n) {
+        sum += delta;
+        b0 += ((b1 << 4) + a) ^ (b1 + sum) ^ ((b1 >> 5) + b);
+        b1 += ((b0 << 4) + c) ^ (b0 + sum) ^ ((b0 >> 5) + d);
+    }
+    buffer[0] += b0;
+    buffer[1] += b1;
+}
+
+static constexpr u32 rotate_left(u32 value, unsigned shift)
+{
+    return (value << shift) | (value >> (32 - shift));
+}
+
+static void half_md4_transform(u32* buffer, u32 const* input)
+{
+    static constexpr u32 k1 = 0;
+    static constexpr u32 k2 = 013240474631u;
+    static constexpr u32 k3 = 015666365641u;
+
+    auto f = [](u32 x, u32 y, u32 z) { return z ^ (x & (y ^ z)); };
+    auto g = [](u32 x, u32 y, u32 z) { return (x & y) + ((x ^ y) & z); };
+    auto h = [](u32 x, u32 y, u32 z) { return x ^ y ^ z; };
+    auto round = [](auto function, u32& a, u32 b, u32 c, u32 d, u32 x, unsigned s) {
+        a += function(b, c, d) + x;
+        a = rotate_left(a, s);
+    };
+
+    u32 a = buffer[0];
+    u32 b = buffer[1];
+    u32 c = buffer[2];
+    u32 d = buffer[3];
+
+    round(f, a, b, c, d, input[0] + k1, 3);
+    round(f, d, a, b, c, input[1] + k1, 7);
+    round(f, c, d, a, b, input[2] + k1, 11);
+    round(f, b, c, d, a, input[3] + k1, 19);
+    round(f, a, b, c, d, input[4] + k1, 3);
+    round(f, d, a, b, c, input[5] + k1, 7);
+    round(f, c, d, a, b, input[6] + k1, 11);
+    round(f, b, c, d, a, input[7] + k1, 19);
+
+    round(g, a, b, c, d, input[1] + k2, 3);
+    round(g, d, a, b, c, input[3] + k2, 5);
+    round(g, c, d, a, b, input[5] + k2, 9);
+    round(g, b, c, d, a, input[7] + k2, 13);
+    round(g, a, b, c, d, input[0] + k2, 3);
+    round(g, d, a, b, c, input[2] + k2, 5);
+    round(g, c, d, a, b, input[4] + k2, 9);
+    round(g, b, c, d, a, input[6] + k2, 13);
+
+    round(h, a, b, c, d, input[3] + k3, 3);
+    round(h, d, a, b, c, input[7] + k3, 9);
+    round(h, c, d, a, b, input[2] + k3, 11);
+    round(h, b, c, d, a, input[6] + k3, 15);
+    round(h, a, b, c, d, input[1] + k3, 3);
+    round(h, d, a, b, c, input[5] + k3, 9);
+    round(h, c, d, a, b, input[0] + k3, 11);
+    round(h, b, c, d, a, input[4] + k3, 15);
+
+    buffer[0] += a;
+    buffer[1] += b;
+    buffer[2] += c;
+    buffer[3] += d;
+}
+
+bool ext2_directory_hash_version_is_supported(u8 hash_version)
+{
+    return hash_version <= EXT2_HASH_TEA_UNSIGNED;
+}
+
+u32 ext2_directory_hash(StringView name, u8 hash_version, u32 const* seed)
+{
+    VERIFY(ext2_directory_hash_version_is_supported(hash_version));
+
+    Array<u32, 4> buffer { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+    if (seed && (seed[0] | seed[1] | seed[2] | seed[3]))
+        buffer = { seed[0], seed[1], seed[2], seed[3] };
+
+    u32 hash = 0;
+    switch (hash_version) {
+    case EXT2_HASH_LEGACY:
+    case EXT2_HASH_LEGACY_UNSIGNED:
+        hash = legacy_hash(name, hash_version == EXT2_HASH_LEGACY_UNSIGNED);
+        break;
+    case EXT2_HASH_HALF_MD4:
+    case EXT2_HASH_HALF_MD4_UNSIGNED: {
+        Array<u32, 8> input;
+        for (auto remaining = name; !remaining.is_empty(); remaining = remaining.substring_view(min<size_t>(32, remaining.length()))) {
+            string_to_hash_buffer(remaining, input.data(), 8, hash_version == EXT2_HASH_HALF_MD4_UNSIGNED);
+            half_md4_transform(buffer.data(), input.data());
+        }
+        hash = buffer[1];
+        break;
+    }
+    case EXT2_HASH_TEA:
+    case EXT2_HASH_TEA_UNSIGNED: {
+        Array<u32, 4> input;
+        for (auto remaining = name; !remaining.is_empty(); remaining = remaining.substring_view(min<size_t>(16, remaining.length()))) {
+            string_to_hash_buffer(remaining, input.data(), 4, hash_version == EXT2_HASH_TEA_UNSIGNED);
+            tea_transform(buffer.data(), input.data());
+        }
+        hash = buffer[0];
+        break;
+    }
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+    hash &= ~1u;
+    // The largest hash is reserved to mark the end of the index.
+    if (hash == (0x7fffffffu << 1))
+        hash = (0x7fffffffu - 1) << 1;
+    return hash;
+}
+
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/StringView.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// Layout of the blocks of a hash-indexed (dir_index) directory.
+// The root block starts with the "." and ".." entries, followed by an ext2_dx_root_info.
+// Interior index blocks start with an unused entry spanning the whole block, so they look empty to
+// anyone reading the directory linearly. The index entries follow, with an ext2_dx_countlimit
+// overlaying the hash of the first one.
+static constexpr size_t ext2_dx_root_info_offset = 24;
+static constexpr size_t ext2_dx_root_entries_offset = 32;
+static constexpr size_t ext2_dx_node_entries_offset = 8;
+static constexpr u32 ext2_dx_block_mask = 0x0fffffff;
+static constexpr u8 ext2_dx_maximum_indirect_levels = 1;
+
+bool ext2_directory_hash_version_is_supported(u8 hash_version);
+
+// Hashes a name with one of the EXT2_HASH_* functions. The lowest bit of the result is always clear,
+// since index entries use it to mark that a range of colliding hashes continues from the previous block.
+u32 ext2_directory_hash(StringView name, u8 hash_version, u32 const* seed);
+
+}
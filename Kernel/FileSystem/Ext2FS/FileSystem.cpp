@@ -223,9 +223,9 @@ ErrorOr<void> Ext2FS::write_ext2_inode(InodeIndex inode, ext2_inode const& e2ino
     return write_block(block_index, buffer, inode_size(), offset);
 }
 
-auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) -> ErrorOr<Vector<BlockIndex>>
+auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count, BlockIndex goal) -> ErrorOr<Vector<BlockIndex>>
 {
-    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {})", preferred_group_index, count);
+    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {}, goal {})", preferred_group_index, count, goal);
     if (count == 0)
         return Vector<BlockIndex> {};
 
@@ -233,6 +233,31 @@ auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) ->
     TRY(blocks.try_ensure_capacity(count));
 
     MutexLocker locker(m_lock);
+
+    // If we were given a goal (usually the block right after the last one of the file), try to continue
+    // the existing run from there first, so the file stays contiguous on disk.
+    if (goal != 0 && goal.value() < super_block().s_blocks_count) {
+        auto goal_group_index = group_index_from_block_index(goal);
+        auto const& bgd = group_descriptor(goal_group_index);
+        if (bgd.bg_free_blocks_count) {
+            auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+            int blocks_in_group = min(blocks_per_group(), super_block().s_blocks_count);
+            auto block_bitmap = cached_bitmap->bitmap(blocks_in_group);
+            BlockIndex first_block_in_group = (goal_group_index.value() - 1) * blocks_per_group() + first_block_index().value();
+            for (auto bit_index = goal.value() - first_block_in_group.value(); blocks.size() < count && bit_index < static_cast<u64>(blocks_in_group); ++bit_index) {
+                if (block_bitmap.get(bit_index))
+                    break;
+                BlockIndex block_index = first_block_in_group.value() + bit_index;
+                TRY(set_block_allocation_state(block_index, true));
+                blocks.unchecked_append(block_index);
+                dbgln_if(EXT2_DEBUG, "  allocated at goal > {}", block_index);
+            }
+            preferred_group_index = goal_group_index;
+        }
+        if (blocks.size() == count)
+            return blocks;
+    }
+
     auto group_index = preferred_group_index;
 
     if (!group_descriptor(preferred_group_index).bg_free_blocks_count) {
@@ -517,7 +542,23 @@ unsigned Ext2FS::total_block_count() const
 unsigned Ext2FS::free_block_count() const
 {
     MutexLocker locker(m_lock);
-    return super_block().s_free_blocks_count;
+    return super_block().s_free_blocks_count - min<size_t>(m_reserved_block_count, super_block().s_free_blocks_count);
+}
+
+ErrorOr<void> Ext2FS::reserve_blocks(size_t count)
+{
+    MutexLocker locker(m_lock);
+    if (m_reserved_block_count + count > super_block().s_free_blocks_count)
+        return ENOSPC;
+    m_reserved_block_count += count;
+    return {};
+}
+
+void Ext2FS::release_reserved_blocks(size_t count)
+{
+    MutexLocker locker(m_lock);
+    VERIFY(count <= m_reserved_block_count);
+    m_reserved_block_count -= count;
 }
 
 unsigned Ext2FS::total_inode_count() const
@@ -552,6 +593,9 @@ ErrorOr<void> Ext2FS::free_inode(Ext2FSInode& inode)
     VERIFY(inode.m_raw_inode.i_links_count == 0);
     dbgln_if(EXT2_DEBUG, "Ext2FS[{}]::free_inode(): Inode {} has no more links, time to delete!", fsid(), inode.index());
 
+    // Nothing has been allocated for data that never made it to disk, so just forget about it.
+    inode.discard_delayed_allocations();
+
     // Mark all blocks used by this inode as free.
     {
         auto blocks = TRY(inode.compute_block_list_with_meta_blocks());
@@ -60,6 +60,16 @@ private:
     u64 blocks_per_group() const;
     u64 inode_size() const;
 
+    bool supports_directory_index() const { return m_super_block.s_feature_compat & EXT2_FEATURE_COMPAT_DIR_INDEX; }
+    // The hash version stored in an index doesn't say whether chars are signed, the superblock does.
+    u8 effective_directory_hash_version(u8 stored_hash_version) const
+    {
+        if (stored_hash_version <= EXT2_HASH_TEA && (m_super_block.s_flags & EXT2_FLAGS_UNSIGNED_HASH))
+            return stored_hash_version + 3;
+        return stored_hash_version;
+    }
+    u32 const* directory_hash_seed() const { return m_super_block.s_hash_seed; }
+
     ErrorOr<NonnullLockRefPtr<Ext2FSInode>> build_root_inode() const;
 
     ErrorOr<void> write_ext2_inode(InodeIndex, ext2_inode const&);
@@ -78,7 +88,9 @@ private:
 
     BlockIndex first_block_index() const;
     ErrorOr<InodeIndex> allocate_inode(GroupIndex preferred_group = 0);
-    ErrorOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count);
+    ErrorOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count, BlockIndex goal = 0);
+    ErrorOr<void> reserve_blocks(size_t count);
+    void release_reserved_blocks(size_t count);
     GroupIndex group_index_from_inode(InodeIndex) const;
     GroupIndex group_index_from_block_index(BlockIndex) const;
 
@@ -106,6 +118,10 @@ private:
 
     mutable HashMap<InodeIndex, LockRefPtr<Ext2FSInode>> m_inode_cache;
 
+    // Blocks promised to delayed allocations that haven't been placed on disk yet.
+    // They are not handed out to anyone else, but still show up as free in the bitmaps.
+    size_t m_reserved_block_count { 0 };
+
     bool m_super_block_dirty { false };
     bool m_block_group_descriptors_dirty { false };
 
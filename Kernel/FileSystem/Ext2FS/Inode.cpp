@@ -6,6 +6,7 @@
  */
 
 #include <AK/MemoryStream.h>
+#include <AK/QuickSort.h>
 #include <Kernel/API/POSIX/errno.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/Ext2FS/Inode.h>
@@ -211,7 +212,7 @@ ErrorOr<void> Ext2FSInode::flush_block_list()
     }
 
     // NOTE: There is a mismatch between i_blocks and blocks.size() since i_blocks includes meta blocks and blocks.size() does not.
-    auto const old_block_count = ceil_div(size(), static_cast<u64>(fs().block_size()));
+    auto const old_block_count = ceil_div(on_disk_size(), static_cast<u64>(fs().block_size()));
 
     auto old_shape = fs().compute_block_list_shape(old_block_count);
     auto const new_shape = fs().compute_block_list_shape(m_block_list.size());
@@ -354,7 +355,7 @@ ErrorOr<Vector<Ext2FS::BlockIndex>> Ext2FSInode::compute_block_list_impl_interna
 {
     unsigned entries_per_block = EXT2_ADDR_PER_BLOCK(&fs().super_block());
 
-    unsigned block_count = ceil_div(size(), static_cast<u64>(fs().block_size()));
+    unsigned block_count = ceil_div(on_disk_size(), static_cast<u64>(fs().block_size()));
 
     // If we are handling a symbolic link, the path is stored in the 60 bytes in
     // the inode that are used for the 12 direct and 3 indirect block pointers,
@@ -458,6 +459,13 @@ Ext2FSInode::~Ext2FSInode()
 }
 
 u64 Ext2FSInode::size() const
+{
+    if (has_delayed_allocations())
+        return m_delayed_size;
+    return on_disk_size();
+}
+
+u64 Ext2FSInode::on_disk_size() const
 {
     if (Kernel::is_regular_file(m_raw_inode.i_mode) && ((u32)fs().get_features_readonly() & (u32)Ext2FS::FeaturesReadOnly::FileSize64bits))
         return static_cast<u64>(m_raw_inode.i_dir_acl) << 32 | m_raw_inode.i_size;
@@ -494,6 +502,9 @@ InodeMetadata Ext2FSInode::metadata() const
 ErrorOr<void> Ext2FSInode::flush_metadata()
 {
     MutexLocker locker(m_inode_lock);
+    // The inode on disk must never point past the blocks that have actually been allocated.
+    if (m_raw_inode.i_links_count != 0)
+        TRY(flush_delayed_allocations());
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::flush_metadata(): Flushing inode", identifier());
     TRY(fs().write_ext2_inode(index(), m_raw_inode));
     if (is_directory()) {
@@ -524,7 +535,7 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
 {
     VERIFY(m_inode_lock.is_locked());
     VERIFY(offset >= 0);
-    if (m_raw_inode.i_size == 0)
+    if (size() == 0)
         return 0;
 
     if (static_cast<u64>(offset) >= size())
@@ -546,7 +557,7 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
     // shared mode.
     TRY(const_cast<Ext2FSInode&>(*this).compute_block_list_with_exclusive_locking());
 
-    if (m_block_list.is_empty()) {
+    if (m_block_list.is_empty() && !has_delayed_allocations()) {
         dmesgln("Ext2FSInode[{}]::read_bytes(): Empty block list", identifier());
         return EIO;
     }
@@ -555,10 +566,13 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
 
     int const block_size = fs().block_size();
 
+    // Blocks past the end of the block list haven't been allocated yet, their contents are still in memory.
+    size_t block_count = has_delayed_allocations() ? ceil_div(size(), static_cast<u64>(block_size)) : m_block_list.size();
+
     BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
     BlockBasedFileSystem::BlockIndex last_block_logical_index = (offset + count) / block_size;
-    if (last_block_logical_index >= m_block_list.size())
-        last_block_logical_index = m_block_list.size() - 1;
+    if (last_block_logical_index >= block_count)
+        last_block_logical_index = block_count - 1;
 
     int offset_into_first_block = offset % block_size;
 
@@ -568,10 +582,19 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
     dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::read_bytes(): Reading up to {} bytes, {} bytes into inode to {}", identifier(), count, offset, buffer.user_or_kernel_ptr());
 
     for (auto bi = first_block_logical_index; remaining_count && bi <= last_block_logical_index; bi = bi.value() + 1) {
-        auto block_index = m_block_list[bi.value()];
         size_t offset_into_block = (bi == first_block_logical_index) ? offset_into_first_block : 0;
         size_t num_bytes_to_copy = min((size_t)block_size - offset_into_block, (size_t)remaining_count);
         auto buffer_offset = buffer.offset(nread);
+        if (bi.value() >= m_block_list.size()) {
+            if (auto it = m_delayed_blocks.find(bi.value()); it != m_delayed_blocks.end())
+                TRY(buffer_offset.write(it->value->data() + offset_into_block, num_bytes_to_copy));
+            else
+                TRY(buffer_offset.memset(0, num_bytes_to_copy));
+            remaining_count -= num_bytes_to_copy;
+            nread += num_bytes_to_copy;
+            continue;
+        }
+        auto block_index = m_block_list[bi.value()];
         if (block_index.value() == 0) {
             // This is a hole, act as if it's filled with zeroes.
             TRY(buffer_offset.memset(0, num_bytes_to_copy));
@@ -585,11 +608,33 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
         nread += num_bytes_to_copy;
     }
 
+    if (allow_cache && description && is_regular_file() && !m_block_list.is_empty()) {
+        auto readahead = description->update_readahead(offset, nread);
+        if (readahead.size != 0 && readahead.offset < on_disk_size()) {
+            auto first_readahead_block_index = readahead.offset / block_size;
+            auto last_readahead_block_index = min((readahead.offset + readahead.size - 1) / block_size, m_block_list.size() - 1);
+            Vector<BlockBasedFileSystem::BlockIndex> blocks_to_read_ahead;
+            if (!blocks_to_read_ahead.try_ensure_capacity(last_readahead_block_index - first_readahead_block_index + 1).is_error()) {
+                for (auto bi = first_readahead_block_index; bi <= last_readahead_block_index; ++bi) {
+                    // Holes are not backed by any block on disk.
+                    if (auto block_index = m_block_list[bi]; block_index.value() != 0)
+                        blocks_to_read_ahead.unchecked_append(block_index);
+                }
+                fs().schedule_readahead(move(blocks_to_read_ahead));
+            }
+        }
+    }
+
     return nread;
 }
 
 ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 {
+    if (size() == new_size)
+        return {};
+
+    TRY(flush_delayed_allocations());
+
     auto old_size = size();
     if (old_size == new_size)
         return {};
@@ -608,7 +653,7 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 
     if (blocks_needed_after > blocks_needed_before) {
         auto additional_blocks_needed = blocks_needed_after - blocks_needed_before;
-        if (additional_blocks_needed > fs().super_block().s_free_blocks_count)
+        if (additional_blocks_needed > fs().free_block_count())
             return ENOSPC;
     }
 
@@ -684,6 +729,14 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
     bool allow_cache = !description || !description->is_direct();
 
     auto const block_size = fs().block_size();
+
+    // Appending to a regular file through the cache doesn't need any blocks right away.
+    if (allow_cache && is_regular_file() && static_cast<u64>(offset) >= ceil_div(on_disk_size(), static_cast<u64>(block_size)) * block_size)
+        return write_bytes_delayed(offset, count, data);
+
+    if (static_cast<u64>(offset) + count > on_disk_size())
+        TRY(flush_delayed_allocations());
+
     auto new_size = max(static_cast<u64>(offset) + count, size());
 
     TRY(resize(new_size));
@@ -726,6 +779,121 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
     return nwritten;
 }
 
+ErrorOr<size_t> Ext2FSInode::write_bytes_delayed(u64 offset, size_t count, UserOrKernelBuffer const& data)
+{
+    VERIFY(m_inode_lock.is_locked());
+
+    // Don't keep too much of a single file in memory, at some point we'd rather get it onto the disk.
+    static constexpr size_t maximum_delayed_block_count = 256;
+
+    auto new_size = max(offset + count, size());
+    if (!((u32)fs().get_features_readonly() & (u32)Ext2FS::FeaturesReadOnly::FileSize64bits) && (new_size >= static_cast<u32>(-1)))
+        return ENOSPC;
+
+    u64 const block_size = fs().block_size();
+
+    if (m_block_list.is_empty())
+        m_block_list = TRY(compute_block_list());
+
+    // Every block between the allocated end of the file and the new end is going to be allocated eventually,
+    // including the ones that are going to be holes, and so is any block list block needed to point to them.
+    auto const allocated_block_count = m_block_list.size();
+    auto const block_count_after = ceil_div(new_size, block_size);
+    auto const meta_blocks_before = fs().compute_block_list_shape(allocated_block_count).meta_blocks;
+    auto const meta_blocks_after = fs().compute_block_list_shape(block_count_after).meta_blocks;
+    size_t const reserved_block_count_after = (block_count_after - allocated_block_count) + (meta_blocks_after - meta_blocks_before);
+    if (reserved_block_count_after > m_reserved_block_count) {
+        TRY(fs().reserve_blocks(reserved_block_count_after - m_reserved_block_count));
+        m_reserved_block_count = reserved_block_count_after;
+    }
+
+    if (!has_delayed_allocations()) {
+        // The rest of the last allocated block is becoming part of the file, so it has to read back as zeroes.
+        auto old_size = on_disk_size();
+        if (auto offset_into_last_block = old_size % block_size; offset_into_last_block != 0 && !m_block_list.is_empty() && m_block_list.last().value() != 0) {
+            u8 zero_buffer[max_block_size] {};
+            TRY(fs().write_block(m_block_list.last(), UserOrKernelBuffer::for_kernel_buffer(zero_buffer), block_size - offset_into_last_block, offset_into_last_block));
+        }
+    }
+
+    u64 first_block_logical_index = offset / block_size;
+    u64 last_block_logical_index = (offset + count - 1) / block_size;
+    size_t nwritten = 0;
+
+    for (auto bi = first_block_logical_index; bi <= last_block_logical_index; ++bi) {
+        size_t offset_into_block = (bi == first_block_logical_index) ? offset % block_size : 0;
+        size_t num_bytes_to_copy = min(block_size - offset_into_block, count - nwritten);
+
+        auto it = m_delayed_blocks.find(bi);
+        if (it == m_delayed_blocks.end()) {
+            auto block = TRY(KBuffer::try_create_with_size("Ext2FSInode: Delayed block"sv, block_size));
+            memset(block->data(), 0, block_size);
+            TRY(m_delayed_blocks.try_set(bi, move(block)));
+            it = m_delayed_blocks.find(bi);
+        }
+        TRY(data.offset(nwritten).read(it->value->data() + offset_into_block, num_bytes_to_copy));
+        nwritten += num_bytes_to_copy;
+    }
+
+    m_delayed_size = new_size;
+    set_metadata_dirty(true);
+    did_modify_contents();
+
+    dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::write_bytes_delayed(): Delayed {} bytes at offset {}, {} blocks pending", identifier(), count, offset, m_delayed_blocks.size());
+
+    if (m_delayed_blocks.size() >= maximum_delayed_block_count)
+        TRY(flush_delayed_allocations());
+
+    return nwritten;
+}
+
+ErrorOr<void> Ext2FSInode::flush_delayed_allocations()
+{
+    MutexLocker locker(m_inode_lock);
+    if (!has_delayed_allocations())
+        return {};
+
+    u64 const block_size = fs().block_size();
+    auto const allocated_block_count = m_block_list.size();
+    auto const block_count_after = ceil_div(m_delayed_size, block_size);
+
+    // Continue right after the last block of the file, so the whole thing ends up in one run if possible.
+    BlockBasedFileSystem::BlockIndex goal = 0;
+    if (!m_block_list.is_empty() && m_block_list.last().value() != 0)
+        goal = m_block_list.last().value() + 1;
+
+    auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), block_count_after - allocated_block_count, goal));
+    dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::flush_delayed_allocations(): Placing {} blocks ({} with data) starting at {}", identifier(), blocks.size(), m_delayed_blocks.size(), blocks.is_empty() ? 0 : blocks.first().value());
+
+    u8 zero_buffer[max_block_size] {};
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        auto it = m_delayed_blocks.find(allocated_block_count + i);
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(it != m_delayed_blocks.end() ? it->value->data() : zero_buffer);
+        TRY(fs().write_block(blocks[i], buffer, block_size));
+    }
+
+    TRY(m_block_list.try_extend(move(blocks)));
+    TRY(flush_block_list());
+
+    m_raw_inode.i_size = m_delayed_size;
+    if (Kernel::is_regular_file(m_raw_inode.i_mode))
+        m_raw_inode.i_dir_acl = m_delayed_size >> 32;
+    set_metadata_dirty(true);
+
+    discard_delayed_allocations();
+    return {};
+}
+
+void Ext2FSInode::discard_delayed_allocations()
+{
+    m_delayed_blocks.clear();
+    m_delayed_size = 0;
+    if (m_reserved_block_count != 0) {
+        fs().release_reserved_blocks(m_reserved_block_count);
+        m_reserved_block_count = 0;
+    }
+}
+
 ErrorOr<void> Ext2FSInode::traverse_as_directory(Function<ErrorOr<void>(FileSystem::DirectoryEntryView const&)> callback) const
 {
     VERIFY(is_directory());
@@ -757,6 +925,429 @@ ErrorOr<void> Ext2FSInode::traverse_as_directory(Function<ErrorOr<void>(FileSyst
     return {};
 }
 
+struct HashedDirectoryEntry {
+    StringView name;
+    InodeIndex inode_index { 0 };
+    u8 file_type { 0 };
+    u32 hash { 0 };
+};
+
+static size_t dx_entries_offset_for_level(size_t level)
+{
+    return level == 0 ? ext2_dx_root_entries_offset : ext2_dx_node_entries_offset;
+}
+
+static ext2_dx_countlimit& dx_countlimit(Bytes block, size_t entries_offset)
+{
+    return *reinterpret_cast<ext2_dx_countlimit*>(block.offset_pointer(entries_offset));
+}
+
+static ext2_dx_entry* dx_entries(Bytes block, size_t entries_offset)
+{
+    return reinterpret_cast<ext2_dx_entry*>(block.offset_pointer(entries_offset));
+}
+
+// Calls the callback with each entry of a directory block, its offset and the offset of the entry before it.
+template<typename Callback>
+static ErrorOr<void> for_each_entry_in_directory_block(Bytes block, Callback callback)
+{
+    size_t offset = 0;
+    Optional<size_t> previous_offset;
+    while (offset + 8 <= block.size()) {
+        auto& entry = *reinterpret_cast<ext2_dir_entry_2*>(block.offset_pointer(offset));
+        if (entry.rec_len < 8 || offset + entry.rec_len > block.size() || entry.name_len + 8u > entry.rec_len)
+            return EIO;
+        if (callback(entry, offset, previous_offset) == IterationDecision::Break)
+            return {};
+        previous_offset = offset;
+        offset += entry.rec_len;
+    }
+    return {};
+}
+
+static void write_directory_block_entries(Bytes block, Span<HashedDirectoryEntry const> entries)
+{
+    block.fill(0);
+    if (entries.is_empty()) {
+        auto& entry = *reinterpret_cast<ext2_dir_entry_2*>(block.data());
+        entry.rec_len = block.size();
+        return;
+    }
+    size_t offset = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        auto& entry = *reinterpret_cast<ext2_dir_entry_2*>(block.offset_pointer(offset));
+        // The last entry takes up the rest of the block.
+        u16 record_length = i + 1 == entries.size() ? block.size() - offset : EXT2_DIR_REC_LEN(entries[i].name.length());
+        entry.inode = entries[i].inode_index.value();
+        entry.rec_len = record_length;
+        entry.name_len = entries[i].name.length();
+        entry.file_type = entries[i].file_type;
+        memcpy(entry.name, entries[i].name.characters_without_null_termination(), entries[i].name.length());
+        offset += record_length;
+    }
+}
+
+bool Ext2FSInode::is_indexed_directory() const
+{
+    return is_directory() && (m_raw_inode.i_flags & EXT2_INDEX_FL) && fs().supports_directory_index();
+}
+
+ErrorOr<ByteBuffer> Ext2FSInode::read_directory_block(u64 block_index) const
+{
+    auto block_size = fs().block_size();
+    if ((block_index + 1) * block_size > size())
+        return EIO;
+    auto block = TRY(ByteBuffer::create_uninitialized(block_size));
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(block.data());
+    auto nread = TRY(read_bytes(block_index * block_size, block_size, buffer, nullptr));
+    if (nread != block_size)
+        return EIO;
+    return block;
+}
+
+ErrorOr<void> Ext2FSInode::write_directory_block(u64 block_index, ByteBuffer const& block)
+{
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(block.data()));
+    auto nwritten = TRY(write_bytes(block_index * fs().block_size(), block.size(), buffer, nullptr));
+    if (nwritten != block.size())
+        return EIO;
+    return {};
+}
+
+ErrorOr<Optional<Ext2FSInode::DirectoryIndexLookup>> Ext2FSInode::probe_directory_index(StringView name) const
+{
+    if (!is_indexed_directory())
+        return OptionalNone {};
+
+    auto block = TRY(read_directory_block(0));
+    auto const& root_info = *reinterpret_cast<ext2_dx_root_info const*>(block.offset_pointer(ext2_dx_root_info_offset));
+    if (root_info.reserved_zero != 0 || root_info.info_length != 8 || root_info.indirect_levels > ext2_dx_maximum_indirect_levels || (root_info.unused_flags & EXT2_HASH_FLAG_INCOMPAT)) {
+        dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::probe_directory_index(): Unsupported index, falling back to a linear scan", identifier());
+        return OptionalNone {};
+    }
+
+    DirectoryIndexLookup lookup;
+    lookup.hash_version = fs().effective_directory_hash_version(root_info.hash_version);
+    if (!ext2_directory_hash_version_is_supported(lookup.hash_version))
+        return OptionalNone {};
+    lookup.hash = ext2_directory_hash(name, lookup.hash_version, fs().directory_hash_seed());
+    lookup.indirect_levels = root_info.indirect_levels;
+
+    u64 block_index = 0;
+    for (size_t level = 0; level <= lookup.indirect_levels; ++level) {
+        auto entries_offset = dx_entries_offset_for_level(level);
+        auto const& countlimit = dx_countlimit(block, entries_offset);
+        if (countlimit.count == 0 || countlimit.count > countlimit.limit || countlimit.limit > (block.size() - entries_offset) / sizeof(ext2_dx_entry))
+            return OptionalNone {};
+        auto const* entries = dx_entries(block, entries_offset);
+
+        // Find the last entry whose hash isn't larger than ours. The first entry (which has no hash) covers everything below the second one.
+        size_t low = 1;
+        size_t high = countlimit.count;
+        while (low < high) {
+            auto middle = low + (high - low) / 2;
+            if (entries[middle].hash > lookup.hash)
+                high = middle;
+            else
+                low = middle + 1;
+        }
+
+        lookup.index_blocks[level] = block_index;
+        lookup.entry_positions[level] = low - 1;
+        block_index = entries[low - 1].block & ext2_dx_block_mask;
+        if (level < lookup.indirect_levels)
+            block = TRY(read_directory_block(block_index));
+    }
+    lookup.leaf_block = block_index;
+    return lookup;
+}
+
+ErrorOr<bool> Ext2FSInode::advance_to_next_directory_index_leaf(DirectoryIndexLookup& lookup) const
+{
+    // Find the deepest level that has another entry after the one we followed.
+    for (int level = lookup.indirect_levels; level >= 0; --level) {
+        auto block = TRY(read_directory_block(lookup.index_blocks[level]));
+        auto entries_offset = dx_entries_offset_for_level(level);
+        auto next_position = lookup.entry_positions[level] + 1;
+        if (next_position >= dx_countlimit(block, entries_offset).count)
+            continue;
+
+        // Only keep going if the next block continues the range of our hash.
+        auto const& next_entry = dx_entries(block, entries_offset)[next_position];
+        if ((next_entry.hash & ~1u) != lookup.hash)
+            return false;
+
+        lookup.entry_positions[level] = next_position;
+        u64 block_index = next_entry.block & ext2_dx_block_mask;
+        for (size_t lower_level = level + 1; lower_level <= lookup.indirect_levels; ++lower_level) {
+            lookup.index_blocks[lower_level] = block_index;
+            lookup.entry_positions[lower_level] = 0;
+            block = TRY(read_directory_block(block_index));
+            block_index = dx_entries(block, dx_entries_offset_for_level(lower_level))[0].block & ext2_dx_block_mask;
+        }
+        lookup.leaf_block = block_index;
+        return true;
+    }
+    return false;
+}
+
+ErrorOr<Optional<Ext2FSInode::DirectoryEntryLocation>> Ext2FSInode::locate_in_directory_index(StringView name) const
+{
+    if (!is_indexed_directory())
+        return OptionalNone {};
+
+    auto find_in_block = [&](u64 block_index, ByteBuffer& block, bool only_dot_entries) -> ErrorOr<Optional<DirectoryEntryLocation>> {
+        Optional<DirectoryEntryLocation> location;
+        TRY(for_each_entry_in_directory_block(block, [&](auto& entry, size_t offset, auto) {
+            if (entry.inode != 0 && name == StringView { entry.name, entry.name_len }) {
+                location = DirectoryEntryLocation { block_index, offset, entry.inode };
+                return IterationDecision::Break;
+            }
+            // The root block only has "." and "..", the rest of it is the index.
+            if (only_dot_entries && offset != 0)
+                return IterationDecision::Break;
+            return IterationDecision::Continue;
+        }));
+        return location;
+    };
+
+    if (name == "."sv || name == ".."sv) {
+        auto root = TRY(read_directory_block(0));
+        auto location = TRY(find_in_block(0, root, true));
+        if (!location.has_value())
+            return EIO;
+        return location;
+    }
+
+    auto lookup = TRY(probe_directory_index(name));
+    if (!lookup.has_value())
+        return OptionalNone {};
+
+    for (;;) {
+        auto leaf = TRY(read_directory_block(lookup->leaf_block));
+        if (auto location = TRY(find_in_block(lookup->leaf_block, leaf, false)); location.has_value())
+            return location;
+        // Names whose hashes collide may continue in the next leaf.
+        if (!TRY(advance_to_next_directory_index_leaf(*lookup)))
+            return ENOENT;
+    }
+}
+
+ErrorOr<bool> Ext2FSInode::add_child_to_directory_index(DirectoryIndexLookup const& lookup, StringView name, InodeIndex inode_index, u8 file_type)
+{
+    auto leaf = TRY(read_directory_block(lookup.leaf_block));
+
+    size_t const record_length = EXT2_DIR_REC_LEN(name.length());
+    Optional<size_t> free_offset;
+    TRY(for_each_entry_in_directory_block(leaf, [&](auto& entry, size_t offset, auto) {
+        size_t used_length = entry.inode != 0 ? EXT2_DIR_REC_LEN(entry.name_len) : 0;
+        if (entry.rec_len - used_length >= record_length) {
+            free_offset = offset;
+            return IterationDecision::Break;
+        }
+        return IterationDecision::Continue;
+    }));
+
+    if (!free_offset.has_value())
+        return split_directory_index_leaf(lookup, leaf, name, inode_index, file_type);
+
+    auto& entry = *reinterpret_cast<ext2_dir_entry_2*>(leaf.offset_pointer(*free_offset));
+    auto* new_entry = &entry;
+    if (entry.inode != 0) {
+        u16 used_length = EXT2_DIR_REC_LEN(entry.name_len);
+        new_entry = reinterpret_cast<ext2_dir_entry_2*>(leaf.offset_pointer(*free_offset + used_length));
+        new_entry->rec_len = entry.rec_len - used_length;
+        entry.rec_len = used_length;
+    }
+    new_entry->inode = inode_index.value();
+    new_entry->name_len = name.length();
+    new_entry->file_type = file_type;
+    memcpy(new_entry->name, name.characters_without_null_termination(), name.length());
+
+    TRY(write_directory_block(lookup.leaf_block, leaf));
+    return true;
+}
+
+ErrorOr<bool> Ext2FSInode::split_directory_index_leaf(DirectoryIndexLookup const& lookup, ByteBuffer& leaf, StringView name, InodeIndex inode_index, u8 file_type)
+{
+    auto const parent_level = lookup.indirect_levels;
+    auto const parent_block_index = lookup.index_blocks[parent_level];
+    auto parent = TRY(read_directory_block(parent_block_index));
+    auto const entries_offset = dx_entries_offset_for_level(parent_level);
+    auto& countlimit = dx_countlimit(parent, entries_offset);
+    if (countlimit.count >= countlimit.limit) {
+        dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::split_directory_index_leaf(): Index block {} is full", identifier(), parent_block_index);
+        return false;
+    }
+
+    Vector<HashedDirectoryEntry> entries;
+    size_t total_length = 0;
+    ErrorOr<void> append_result;
+    TRY(for_each_entry_in_directory_block(leaf, [&](auto& entry, size_t, auto) {
+        if (entry.inode == 0)
+            return IterationDecision::Continue;
+        StringView entry_name { entry.name, entry.name_len };
+        append_result = entries.try_append({ entry_name, entry.inode, entry.file_type, ext2_directory_hash(entry_name, lookup.hash_version, fs().directory_hash_seed()) });
+        total_length += EXT2_DIR_REC_LEN(entry.name_len);
+        return append_result.is_error() ? IterationDecision::Break : IterationDecision::Continue;
+    }));
+    TRY(append_result);
+    TRY(entries.try_append({ name, inode_index, file_type, lookup.hash }));
+    total_length += EXT2_DIR_REC_LEN(name.length());
+    if (entries.size() < 2)
+        return false;
+
+    quick_sort(entries, [](auto& a, auto& b) { return a.hash < b.hash; });
+
+    // Split where both halves end up about equally full.
+    size_t split_position = 0;
+    size_t lower_length = 0;
+    while (split_position < entries.size() && lower_length + EXT2_DIR_REC_LEN(entries[split_position].name.length()) <= total_length / 2)
+        lower_length += EXT2_DIR_REC_LEN(entries[split_position++].name.length());
+    split_position = clamp(split_position, static_cast<size_t>(1), entries.size() - 1);
+
+    u32 split_hash = entries[split_position].hash;
+    // The index can't tell colliding hashes apart, so mark the new block as a continuation of the one before it.
+    if (entries[split_position - 1].hash == split_hash)
+        split_hash |= 1;
+
+    auto const block_size = fs().block_size();
+    auto const new_block_index = size() / block_size;
+    auto lower_block = TRY(ByteBuffer::create_zeroed(block_size));
+    auto upper_block = TRY(ByteBuffer::create_zeroed(block_size));
+    write_directory_block_entries(lower_block, entries.span().slice(0, split_position));
+    write_directory_block_entries(upper_block, entries.span().slice(split_position));
+
+    dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::split_directory_index_leaf(): Splitting leaf {} at hash {:#x} into new block {}", identifier(), lookup.leaf_block, split_hash, new_block_index);
+
+    TRY(write_directory_block(new_block_index, upper_block));
+    TRY(write_directory_block(lookup.leaf_block, lower_block));
+
+    // Point to the new block right after the entry for the one we split.
+    auto* parent_entries = dx_entries(parent, entries_offset);
+    auto const position = lookup.entry_positions[parent_level] + 1;
+    memmove(&parent_entries[position + 1], &parent_entries[position], (countlimit.count - position) * sizeof(ext2_dx_entry));
+    parent_entries[position].hash = split_hash;
+    parent_entries[position].block = new_block_index;
+    ++countlimit.count;
+    TRY(write_directory_block(parent_block_index, parent));
+    return true;
+}
+
+ErrorOr<bool> Ext2FSInode::write_indexed_directory(Vector<Ext2FSDirectoryEntry>& entries)
+{
+    if (!fs().supports_directory_index())
+        return false;
+    auto const stored_hash_version = fs().super_block().s_def_hash_version;
+    auto const hash_version = fs().effective_directory_hash_version(stored_hash_version);
+    if (!ext2_directory_hash_version_is_supported(hash_version))
+        return false;
+    if (entries.size() < 2 || entries[0].name->view() != "."sv || entries[1].name->view() != ".."sv)
+        return false;
+
+    auto const block_size = fs().block_size();
+
+    Vector<HashedDirectoryEntry> hashed_entries;
+    TRY(hashed_entries.try_ensure_capacity(entries.size() - 2));
+    for (size_t i = 2; i < entries.size(); ++i) {
+        auto name = entries[i].name->view();
+        hashed_entries.unchecked_append({ name, entries[i].inode_index, entries[i].file_type, ext2_directory_hash(name, hash_version, fs().directory_hash_seed()) });
+    }
+    quick_sort(hashed_entries, [](auto& a, auto& b) { return a.hash < b.hash; });
+
+    // Leave some room in each leaf, so adding entries doesn't start splitting them right away.
+    size_t const leaf_fill_limit = block_size * 3 / 4;
+    Vector<size_t> leaf_starts;
+    TRY(leaf_starts.try_append(0));
+    size_t used_length = 0;
+    for (size_t i = 0; i < hashed_entries.size(); ++i) {
+        auto record_length = EXT2_DIR_REC_LEN(hashed_entries[i].name.length());
+        if (used_length + record_length > leaf_fill_limit && used_length != 0) {
+            TRY(leaf_starts.try_append(i));
+            used_length = 0;
+        }
+        used_length += record_length;
+    }
+
+    size_t const leaf_count = leaf_starts.size();
+    u16 const root_limit = (block_size - ext2_dx_root_entries_offset) / sizeof(ext2_dx_entry);
+    u16 const node_limit = (block_size - ext2_dx_node_entries_offset) / sizeof(ext2_dx_entry);
+    u8 indirect_levels = 0;
+    size_t node_count = 0;
+    if (leaf_count > root_limit) {
+        indirect_levels = 1;
+        node_count = ceil_div(leaf_count, static_cast<size_t>(node_limit));
+        if (node_count > root_limit)
+            return false;
+    }
+
+    dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_indexed_directory(): {} entries in {} leaves, {} index blocks", identifier(), hashed_entries.size(), leaf_count, node_count + 1);
+
+    auto directory_data = TRY(ByteBuffer::create_zeroed((1 + node_count + leaf_count) * block_size));
+    auto block = [&](size_t block_index) { return directory_data.bytes().slice(block_index * block_size, block_size); };
+    auto const first_leaf_block = 1 + node_count;
+
+    auto leaf_hash = [&](size_t leaf) {
+        auto hash = hashed_entries.is_empty() ? 0 : hashed_entries[leaf_starts[leaf]].hash;
+        if (leaf != 0 && hashed_entries[leaf_starts[leaf] - 1].hash == hash)
+            hash |= 1;
+        return hash;
+    };
+
+    for (size_t leaf = 0; leaf < leaf_count; ++leaf) {
+        auto end = leaf + 1 < leaf_count ? leaf_starts[leaf + 1] : hashed_entries.size();
+        write_directory_block_entries(block(first_leaf_block + leaf), hashed_entries.span().slice(leaf_starts[leaf], end - leaf_starts[leaf]));
+    }
+
+    auto write_index_entries = [&](Bytes index_block, size_t entries_offset, u16 limit, size_t count, auto entry_for) {
+        auto* index_entries = dx_entries(index_block, entries_offset);
+        for (size_t i = 0; i < count; ++i)
+            index_entries[i] = entry_for(i);
+        // This overlays the hash of the first entry.
+        dx_countlimit(index_block, entries_offset) = { limit, static_cast<u16>(count) };
+    };
+
+    auto root = block(0);
+    auto& dot = *reinterpret_cast<ext2_dir_entry_2*>(root.data());
+    dot = { static_cast<u32>(entries[0].inode_index.value()), 12, 1, entries[0].file_type, {} };
+    dot.name[0] = '.';
+    auto& dot_dot = *reinterpret_cast<ext2_dir_entry_2*>(root.offset_pointer(12));
+    dot_dot = { static_cast<u32>(entries[1].inode_index.value()), static_cast<u16>(block_size - 12), 2, entries[1].file_type, {} };
+    dot_dot.name[0] = '.';
+    dot_dot.name[1] = '.';
+    auto& root_info = *reinterpret_cast<ext2_dx_root_info*>(root.offset_pointer(ext2_dx_root_info_offset));
+    root_info = { 0, stored_hash_version, 8, indirect_levels, 0 };
+
+    if (indirect_levels == 0) {
+        write_index_entries(root, ext2_dx_root_entries_offset, root_limit, leaf_count, [&](size_t leaf) {
+            return ext2_dx_entry { leaf_hash(leaf), static_cast<u32>(first_leaf_block + leaf) };
+        });
+    } else {
+        write_index_entries(root, ext2_dx_root_entries_offset, root_limit, node_count, [&](size_t node) {
+            return ext2_dx_entry { leaf_hash(node * node_limit), static_cast<u32>(1 + node) };
+        });
+        for (size_t node = 0; node < node_count; ++node) {
+            auto node_block = block(1 + node);
+            // An unused entry spanning the whole block, so the node looks empty when reading the directory linearly.
+            reinterpret_cast<ext2_dir_entry_2*>(node_block.data())->rec_len = block_size;
+            auto first_leaf = node * node_limit;
+            write_index_entries(node_block, ext2_dx_node_entries_offset, node_limit, min(static_cast<size_t>(node_limit), leaf_count - first_leaf), [&](size_t i) {
+                return ext2_dx_entry { leaf_hash(first_leaf + i), static_cast<u32>(first_leaf_block + first_leaf + i) };
+            });
+        }
+    }
+
+    TRY(resize(directory_data.size()));
+
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(directory_data.data());
+    auto nwritten = TRY(write_bytes(0, directory_data.size(), buffer, nullptr));
+    m_raw_inode.i_flags |= EXT2_INDEX_FL;
+    set_metadata_dirty(true);
+    if (nwritten != directory_data.size())
+        return EIO;
+    return true;
+}
+
 ErrorOr<void> Ext2FSInode::write_directory(Vector<Ext2FSDirectoryEntry>& entries)
 {
     MutexLocker locker(m_inode_lock);
@@ -784,6 +1375,11 @@ ErrorOr<void> Ext2FSInode::write_directory(Vector<Ext2FSDirectoryEntry>& entries
         directory_size += entry.record_length;
     }
 
+    // Once a directory doesn't fit into a single block anymore, give it an index if we can.
+    if (directory_size > block_size && TRY(write_indexed_directory(entries)))
+        return {};
+    m_raw_inode.i_flags &= ~EXT2_INDEX_FL;
+
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_directory(): New directory contents to write (size {}):", identifier(), directory_size);
 
     auto directory_data = TRY(ByteBuffer::create_uninitialized(directory_size));
@@ -832,6 +1428,34 @@ ErrorOr<void> Ext2FSInode::add_child(Inode& child, StringView name, mode_t mode)
 
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::add_child(): Adding inode {} with name '{}' and mode {:o} to directory {}", identifier(), child.index(), name, mode, index());
 
+    Optional<DirectoryIndexLookup> index_lookup;
+    if (auto location_or_error = locate_in_directory_index(name); location_or_error.is_error()) {
+        if (location_or_error.error().code() != ENOENT)
+            return location_or_error.release_error();
+        index_lookup = TRY(probe_directory_index(name));
+    } else if (location_or_error.value().has_value()) {
+        return EEXIST;
+    }
+
+    if (index_lookup.has_value()) {
+        TRY(child.increment_link_count());
+        if (!TRY(add_child_to_directory_index(*index_lookup, name, child.index(), to_ext2_file_type(mode)))) {
+            // The index has run out of space, so rebuild the whole directory with a deeper one.
+            Vector<Ext2FSDirectoryEntry> entries;
+            TRY(traverse_as_directory([&](auto& entry) -> ErrorOr<void> {
+                auto entry_name = TRY(KString::try_create(entry.name));
+                TRY(entries.try_append({ move(entry_name), entry.inode.index(), entry.file_type }));
+                return {};
+            }));
+            auto entry_name = TRY(KString::try_create(name));
+            TRY(entries.try_empend(move(entry_name), child.index(), to_ext2_file_type(mode)));
+            TRY(write_directory(entries));
+        }
+        m_lookup_cache.clear();
+        did_add_child(child.identifier(), name);
+        return {};
+    }
+
     Vector<Ext2FSDirectoryEntry> entries;
     TRY(traverse_as_directory([&](auto& entry) -> ErrorOr<void> {
         if (name == entry.name)
@@ -847,10 +1471,15 @@ ErrorOr<void> Ext2FSInode::add_child(Inode& child, StringView name, mode_t mode)
     TRY(entries.try_empend(move(entry_name), child.index(), to_ext2_file_type(mode)));
 
     TRY(write_directory(entries));
-    TRY(populate_lookup_cache());
 
-    auto cache_entry_name = TRY(KString::try_create(name));
-    TRY(m_lookup_cache.try_set(move(cache_entry_name), child.index()));
+    // Indexed directories are looked up through the index, there's no need to keep all of their entries around.
+    if (!is_indexed_directory()) {
+        TRY(populate_lookup_cache());
+        auto cache_entry_name = TRY(KString::try_create(name));
+        TRY(m_lookup_cache.try_set(move(cache_entry_name), child.index()));
+    } else {
+        m_lookup_cache.clear();
+    }
     did_add_child(child.identifier(), name);
     return {};
 }
@@ -861,6 +1490,30 @@ ErrorOr<void> Ext2FSInode::remove_child(StringView name)
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::remove_child(): Removing '{}'", identifier(), name);
     VERIFY(is_directory());
 
+    if (name != "."sv && name != ".."sv) {
+        if (auto location = TRY(locate_in_directory_index(name)); location.has_value()) {
+            // Just merge the entry into the one before it (or mark it as unused if it's the first one), without touching the rest of the directory.
+            auto block = TRY(read_directory_block(location->block));
+            TRY(for_each_entry_in_directory_block(block, [&](auto& entry, size_t offset, Optional<size_t> previous_offset) {
+                if (offset != location->offset)
+                    return IterationDecision::Continue;
+                if (previous_offset.has_value())
+                    reinterpret_cast<ext2_dir_entry_2*>(block.offset_pointer(*previous_offset))->rec_len += entry.rec_len;
+                else
+                    entry.inode = 0;
+                return IterationDecision::Break;
+            }));
+            TRY(write_directory_block(location->block, block));
+
+            InodeIndex child_index = location->inode_index;
+            auto child_inode = TRY(fs().get_inode({ fsid(), child_index }));
+            TRY(child_inode->decrement_link_count());
+
+            did_remove_child(child_inode->identifier(), name);
+            return {};
+        }
+    }
+
     TRY(populate_lookup_cache());
 
     auto it = m_lookup_cache.find(name);
@@ -896,11 +1549,28 @@ ErrorOr<void> Ext2FSInode::replace_child(StringView name, Inode& child)
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::replace_child(): Replacing '{}' with inode {}", identifier(), name, child.index());
     VERIFY(is_directory());
 
-    TRY(populate_lookup_cache());
-
     if (name.length() > EXT2_NAME_LEN)
         return ENAMETOOLONG;
 
+    if (auto location = TRY(locate_in_directory_index(name)); location.has_value()) {
+        auto old_child = TRY(fs().get_inode({ fsid(), location->inode_index }));
+
+        TRY(child.increment_link_count());
+        if (auto result = old_child->decrement_link_count(); result.is_error()) {
+            MUST(child.decrement_link_count());
+            return result;
+        }
+
+        auto block = TRY(read_directory_block(location->block));
+        auto& entry = *reinterpret_cast<ext2_dir_entry_2*>(block.offset_pointer(location->offset));
+        entry.inode = child.index().value();
+        entry.file_type = to_ext2_file_type(child.mode());
+        TRY(write_directory_block(location->block, block));
+        return {};
+    }
+
+    TRY(populate_lookup_cache());
+
     Vector<Ext2FSDirectoryEntry> entries;
 
     Optional<InodeIndex> old_child_index;
@@ -973,13 +1643,17 @@ ErrorOr<NonnullLockRefPtr<Inode>> Ext2FSInode::lookup(StringView name)
     InodeIndex inode_index;
     {
         MutexLocker locker(m_inode_lock);
-        TRY(populate_lookup_cache());
-        auto it = m_lookup_cache.find(name);
-        if (it == m_lookup_cache.end()) {
-            dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]:lookup(): '{}' not found", identifier(), name);
-            return ENOENT;
+        if (auto location = TRY(locate_in_directory_index(name)); location.has_value()) {
+            inode_index = location->inode_index;
+        } else {
+            TRY(populate_lookup_cache());
+            auto it = m_lookup_cache.find(name);
+            if (it == m_lookup_cache.end()) {
+                dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]:lookup(): '{}' not found", identifier(), name);
+                return ENOENT;
+            }
+            inode_index = it->value;
         }
-        inode_index = it->value;
     }
 
     return fs().get_inode({ fsid(), inode_index });
@@ -1061,7 +1735,7 @@ ErrorOr<void> Ext2FSInode::chown(UserID uid, GroupID gid)
 ErrorOr<void> Ext2FSInode::truncate(u64 size)
 {
     MutexLocker locker(m_inode_lock);
-    if (static_cast<u64>(m_raw_inode.i_size) == size)
+    if (this->size() == size)
         return {};
     TRY(resize(size));
     set_metadata_dirty(true);
@@ -1072,6 +1746,8 @@ ErrorOr<int> Ext2FSInode::get_block_address(int index)
 {
     MutexLocker locker(m_inode_lock);
 
+    TRY(flush_delayed_allocations());
+
     if (m_block_list.is_empty())
         m_block_list = TRY(compute_block_list());
 
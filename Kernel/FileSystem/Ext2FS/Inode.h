@@ -6,9 +6,11 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/HashMap.h>
 #include <Kernel/FileSystem/Ext2FS/Definitions.h>
 #include <Kernel/FileSystem/Ext2FS/DirectoryEntry.h>
+#include <Kernel/FileSystem/Ext2FS/DirectoryIndex.h>
 #include <Kernel/FileSystem/Ext2FS/FileSystem.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/UnixTypes.h>
@@ -46,6 +48,33 @@ private:
     virtual ErrorOr<int> get_block_address(int) override;
 
     ErrorOr<void> write_directory(Vector<Ext2FSDirectoryEntry>&);
+    ErrorOr<bool> write_indexed_directory(Vector<Ext2FSDirectoryEntry>&);
+
+    // Hash-indexed directories are looked up and modified through their index,
+    // touching only the blocks on the path to the entry.
+    struct DirectoryIndexLookup {
+        u32 hash { 0 };
+        u8 hash_version { 0 };
+        u8 indirect_levels { 0 };
+        // The index block and position of the entry we followed on each level, starting at the root.
+        Array<u64, ext2_dx_maximum_indirect_levels + 1> index_blocks {};
+        Array<size_t, ext2_dx_maximum_indirect_levels + 1> entry_positions {};
+        u64 leaf_block { 0 };
+    };
+    struct DirectoryEntryLocation {
+        u64 block { 0 };
+        size_t offset { 0 };
+        InodeIndex inode_index { 0 };
+    };
+    bool is_indexed_directory() const;
+    ErrorOr<ByteBuffer> read_directory_block(u64) const;
+    ErrorOr<void> write_directory_block(u64, ByteBuffer const&);
+    // These return an empty Optional if the index can't be used, in which case we fall back to a linear scan.
+    ErrorOr<Optional<DirectoryIndexLookup>> probe_directory_index(StringView name) const;
+    ErrorOr<Optional<DirectoryEntryLocation>> locate_in_directory_index(StringView name) const;
+    ErrorOr<bool> advance_to_next_directory_index_leaf(DirectoryIndexLookup&) const;
+    ErrorOr<bool> add_child_to_directory_index(DirectoryIndexLookup const&, StringView name, InodeIndex, u8 file_type);
+    ErrorOr<bool> split_directory_index_leaf(DirectoryIndexLookup const&, ByteBuffer& leaf, StringView name, InodeIndex, u8 file_type);
     ErrorOr<void> populate_lookup_cache();
     ErrorOr<void> resize(u64);
     ErrorOr<void> write_indirect_block(BlockBasedFileSystem::BlockIndex, Span<BlockBasedFileSystem::BlockIndex>);
@@ -55,6 +84,15 @@ private:
     ErrorOr<void> shrink_triply_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, size_t, unsigned&);
     ErrorOr<void> flush_block_list();
 
+    // Writes past the allocated end of a regular file are kept in memory with their blocks only reserved,
+    // and get placed on disk together once they are flushed. That way the whole run can be allocated
+    // contiguously instead of block by block as the file grows.
+    bool has_delayed_allocations() const { return m_delayed_size != 0; }
+    ErrorOr<size_t> write_bytes_delayed(u64 offset, size_t count, UserOrKernelBuffer const& data);
+    ErrorOr<void> flush_delayed_allocations();
+    void discard_delayed_allocations();
+    u64 on_disk_size() const;
+
     ErrorOr<void> compute_block_list_with_exclusive_locking();
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list() const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list_with_meta_blocks() const;
@@ -69,6 +107,11 @@ private:
     HashMap<NonnullOwnPtr<KString>, InodeIndex> m_lookup_cache;
     ext2_inode m_raw_inode {};
 
+    // Logical block index to contents, for blocks that have been written but not allocated yet.
+    HashMap<u64, NonnullOwnPtr<KBuffer>> m_delayed_blocks;
+    u64 m_delayed_size { 0 };
+    size_t m_reserved_block_count { 0 };
+
     Mutex m_block_list_lock { "BlockList"sv };
 };
 
@@ -8,6 +8,7 @@
 
 #include <AK/AtomicRefCounted.h>
 #include <AK/Error.h>
+#include <AK/IntrusiveList.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
@@ -21,10 +22,60 @@ namespace Kernel {
 
 class File;
 
+// A readiness observer is told about every change that could make a File readable or writable,
+// without having to be a Blocker (which would tie it to a blocked thread). EventPoll uses this
+// to keep persistent interests in files instead of re-registering them on every wait.
+class FileReadinessObserver {
+public:
+    virtual ~FileReadinessObserver() = default;
+
+    // Called with the FileBlockerSet lock held, so this must not block or take any Mutex.
+    virtual void file_readiness_may_have_changed() = 0;
+
+    // Called with the FileBlockerSet lock held, just before an OpenFileDescription of the file goes away.
+    // Returns true if this observer was watching that description, in which case it is removed from the set.
+    virtual bool description_will_be_destroyed(OpenFileDescription&) = 0;
+
+private:
+    friend class FileBlockerSet;
+    IntrusiveListNode<FileReadinessObserver> m_readiness_observer_list_node;
+};
+
 class FileBlockerSet final : public Thread::BlockerSet {
 public:
     FileBlockerSet() { }
 
+    virtual ~FileBlockerSet() override
+    {
+        VERIFY(m_readiness_observers.is_empty());
+    }
+
+    void add_readiness_observer(FileReadinessObserver& observer)
+    {
+        SpinlockLocker lock(m_lock);
+        VERIFY(!observer.m_readiness_observer_list_node.is_in_list());
+        m_readiness_observers.append(observer);
+    }
+
+    void remove_readiness_observer(FileReadinessObserver& observer)
+    {
+        SpinlockLocker lock(m_lock);
+        // NOTE: The observer may already have been removed when its description was destroyed.
+        if (observer.m_readiness_observer_list_node.is_in_list())
+            m_readiness_observers.remove(observer);
+    }
+
+    void description_will_be_destroyed(OpenFileDescription& description)
+    {
+        SpinlockLocker lock(m_lock);
+        for (auto it = m_readiness_observers.begin(); it != m_readiness_observers.end();) {
+            auto& observer = *it;
+            ++it;
+            if (observer.description_will_be_destroyed(description))
+                m_readiness_observers.remove(observer);
+        }
+    }
+
     virtual bool should_add_blocker(Thread::Blocker& b, void* data) override
     {
         VERIFY(b.blocker_type() == Thread::Blocker::Type::File);
@@ -40,7 +91,12 @@ public:
             auto& blocker = static_cast<Thread::FileBlocker&>(b);
             return blocker.unblock_if_conditions_are_met(false, data);
         });
+        for (auto& observer : m_readiness_observers)
+            observer.file_readiness_may_have_changed();
     }
+
+private:
+    IntrusiveList<&FileReadinessObserver::m_readiness_observer_list_node> m_readiness_observers;
 };
 
 // File is the base class for anything that can be referenced by a OpenFileDescription.
@@ -114,6 +170,8 @@ public:
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_io_ring() const { return false; }
+    virtual bool is_event_poll() const { return false; }
 
     virtual bool is_regular_file() const { return false; }
 
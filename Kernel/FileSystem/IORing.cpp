@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/StdLib.h>
+
+namespace Kernel {
+
+ErrorOr<NonnullLockRefPtr<IORing>> IORing::try_create(u32 entries)
+{
+    if (entries == 0 || entries > IO_RING_MAX_ENTRIES || !is_power_of_two(entries))
+        return EINVAL;
+
+    auto size = io_ring_mapping_size(entries);
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(size, AllocationStrategy::AllocateNow));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, size, "IORing"sv, Memory::Region::Access::ReadWrite));
+    return adopt_nonnull_lock_ref_or_enomem(new (nothrow) IORing(move(vmobject), move(region), entries));
+}
+
+IORing::IORing(NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject, NonnullOwnPtr<Memory::Region> region, u32 entries)
+    : m_vmobject(move(vmobject))
+    , m_region(move(region))
+    , m_submission_entry_count(entries)
+    , m_completion_entry_count(entries * 2)
+{
+    auto& ring_header = header();
+    memset(&ring_header, 0, sizeof(IORingHeader));
+    ring_header.submission.mask = m_submission_entry_count - 1;
+    ring_header.submission.entry_count = m_submission_entry_count;
+    ring_header.submission.entries_offset = io_ring_submission_entries_offset();
+    ring_header.completion.mask = m_completion_entry_count - 1;
+    ring_header.completion.entry_count = m_completion_entry_count;
+    ring_header.completion.entries_offset = io_ring_completion_entries_offset(entries);
+}
+
+IORing::~IORing() = default;
+
+ErrorOr<NonnullLockRefPtr<Memory::VMObject>> IORing::vmobject_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared)
+{
+    // A private mapping would only ever see a copy of the ring, which is never what anyone wants.
+    if (offset != 0 || !shared)
+        return EINVAL;
+    return m_vmobject;
+}
+
+Optional<IORingSubmission> IORing::pop_submission()
+{
+    VERIFY(m_submission_lock.is_exclusively_locked_by_current_thread());
+    auto& queue = header().submission;
+    auto head = AK::atomic_load(&queue.head, AK::MemoryOrder::memory_order_relaxed);
+    auto tail = AK::atomic_load(&queue.tail, AK::MemoryOrder::memory_order_acquire);
+    if (head == tail)
+        return {};
+
+    // Note: Copy the entry out before looking at it, userspace may keep scribbling over the shared memory.
+    IORingSubmission submission;
+    auto const* entries = reinterpret_cast<IORingSubmission const*>(m_region->vaddr().offset(io_ring_submission_entries_offset()).as_ptr());
+    memcpy(&submission, &entries[head & (m_submission_entry_count - 1)], sizeof(IORingSubmission));
+    AK::atomic_store(&queue.head, head + 1, AK::MemoryOrder::memory_order_release);
+    return submission;
+}
+
+bool IORing::completion_queue_full() const
+{
+    auto const& queue = header().completion;
+    auto head = AK::atomic_load(&queue.head, AK::MemoryOrder::memory_order_acquire);
+    auto tail = AK::atomic_load(&queue.tail, AK::MemoryOrder::memory_order_relaxed);
+    return tail - head >= m_completion_entry_count;
+}
+
+void IORing::push_completion(IORingCompletion const& completion)
+{
+    VERIFY(m_submission_lock.is_exclusively_locked_by_current_thread());
+    VERIFY(!completion_queue_full());
+    auto& queue = header().completion;
+    auto tail = AK::atomic_load(&queue.tail, AK::MemoryOrder::memory_order_relaxed);
+    auto* entries = reinterpret_cast<IORingCompletion*>(m_region->vaddr().offset(io_ring_completion_entries_offset(m_submission_entry_count)).as_ptr());
+    entries[tail & (m_completion_entry_count - 1)] = completion;
+    AK::atomic_store(&queue.tail, tail + 1, AK::MemoryOrder::memory_order_release);
+}
+
+ErrorOr<NonnullOwnPtr<KString>> IORing::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::try_create(":io-ring:"sv);
+}
+
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <Kernel/API/IORing.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/Region.h>
+
+namespace Kernel {
+
+class IORing final : public File {
+public:
+    static ErrorOr<NonnullLockRefPtr<IORing>> try_create(u32 entries);
+    virtual ~IORing() override;
+
+    virtual ErrorOr<NonnullLockRefPtr<Memory::VMObject>> vmobject_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared) override;
+    virtual bool is_io_ring() const override { return true; }
+
+    // Serializes io_ring_enter() calls on the same ring, as they all consume the same submission queue.
+    Mutex& submission_lock() { return m_submission_lock; }
+
+    Optional<IORingSubmission> pop_submission();
+    bool completion_queue_full() const;
+    void push_completion(IORingCompletion const&);
+
+private:
+    virtual StringView class_name() const override { return "IORing"sv; }
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual bool can_read(OpenFileDescription const&, u64) const override { return false; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return ENOTSUP; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return ENOTSUP; }
+
+    IORing(NonnullLockRefPtr<Memory::AnonymousVMObject>, NonnullOwnPtr<Memory::Region>, u32 entries);
+
+    IORingHeader& header() { return *reinterpret_cast<IORingHeader*>(m_region->vaddr().as_ptr()); }
+    IORingHeader const& header() const { return *reinterpret_cast<IORingHeader const*>(m_region->vaddr().as_ptr()); }
+
+    NonnullLockRefPtr<Memory::AnonymousVMObject> m_vmobject;
+    // Note: This is the kernel's own mapping of the ring, the process maps the same pages via mmap().
+    NonnullOwnPtr<Memory::Region> m_region;
+    Mutex m_submission_lock { "IORing"sv };
+
+    // Note: The masks and entry counts in the shared header are for userspace's convenience only,
+    // we never trust them and use our own copies instead.
+    u32 const m_submission_entry_count { 0 };
+    u32 const m_completion_entry_count { 0 };
+};
+
+}
@@ -52,6 +52,7 @@ OpenFileDescription::OpenFileDescription(File& file)
 
 OpenFileDescription::~OpenFileDescription()
 {
+    blocker_set().description_will_be_destroyed(*this);
     m_file->detach(*this);
     if (is_fifo())
         static_cast<FIFO*>(m_file.ptr())->detach(fifo_direction());
@@ -484,6 +485,34 @@ void OpenFileDescription::set_rw_mode(int options)
     });
 }
 
+OpenFileDescription::ReadaheadRange OpenFileDescription::update_readahead(u64 offset, size_t count)
+{
+    static constexpr size_t initial_readahead_window = 16 * KiB;
+    static constexpr size_t maximum_readahead_window = 512 * KiB;
+
+    return m_state.with([&](auto& state) -> ReadaheadRange {
+        bool is_sequential = offset == state.readahead_expected_offset;
+        state.readahead_expected_offset = offset + count;
+        if (!is_sequential) {
+            state.readahead_window = 0;
+            state.readahead_end = 0;
+            return {};
+        }
+
+        // Keep doubling the window for as long as the reader keeps reading sequentially.
+        state.readahead_window = state.readahead_window ? min(state.readahead_window * 2, maximum_readahead_window) : initial_readahead_window;
+
+        // Only issue more readahead once the reader has consumed half of what we read ahead last time.
+        auto read_end = offset + count;
+        if (state.readahead_end > read_end && state.readahead_end - read_end > state.readahead_window / 2)
+            return {};
+
+        auto readahead_start = max(state.readahead_end, read_end);
+        state.readahead_end = read_end + state.readahead_window;
+        return { readahead_start, static_cast<size_t>(state.readahead_end - readahead_start) };
+    });
+}
+
 bool OpenFileDescription::is_direct() const
 {
     return m_state.with([](auto& state) { return state.direct; });
@@ -122,6 +122,14 @@ public:
 
     off_t offset() const;
 
+    struct ReadaheadRange {
+        u64 offset { 0 };
+        size_t size { 0 };
+    };
+    // Records a read of `count` bytes at `offset`, and returns the range that should be
+    // read ahead of it. The range is empty unless this description is read sequentially.
+    ReadaheadRange update_readahead(u64 offset, size_t count);
+
     ErrorOr<void> chown(Credentials const& credentials, UserID, GroupID);
 
     FileBlockerSet& blocker_set();
@@ -147,6 +155,9 @@ private:
         OwnPtr<OpenFileDescriptionData> data;
         RefPtr<Custody> custody;
         off_t current_offset { 0 };
+        u64 readahead_expected_offset { 0 };
+        u64 readahead_end { 0 };
+        size_t readahead_window { 0 };
         u32 file_flags { 0 };
         bool readable : 1 { false };
         bool writable : 1 { false };
@@ -5,6 +5,7 @@
  */
 
 #include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/DiskUsage.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
@@ -46,6 +47,12 @@ ErrorOr<void> SysFSDiskUsage::try_generate(KBufferBuilder& builder)
             TRY(fs_object.add("source"sv, "none"));
         }
 
+        if (fs.is_block_based()) {
+            auto const& block_based_fs = static_cast<BlockBasedFileSystem const&>(fs);
+            TRY(fs_object.add("cache_hit_count"sv, block_based_fs.cache_hit_count()));
+            TRY(fs_object.add("cache_miss_count"sv, block_based_fs.cache_miss_count()));
+        }
+
         TRY(fs_object.finish());
         return {};
     }));
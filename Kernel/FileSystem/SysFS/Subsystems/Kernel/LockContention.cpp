@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/LockContention.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSLockContention::SysFSLockContention(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullLockRefPtr<SysFSLockContention> SysFSLockContention::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_lock_ref_if_nonnull(new (nothrow) SysFSLockContention(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSLockContention::try_generate(KBufferBuilder& builder)
+{
+    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    TRY(Mutex::try_for_each_contention_statistics([&](auto const& statistics) -> ErrorOr<void> {
+        auto obj = TRY(array.add_object());
+        TRY(obj.add("name"sv, statistics.name));
+        TRY(obj.add("contended"sv, statistics.contended_count));
+        TRY(obj.add("acquired_by_spinning"sv, statistics.acquired_by_spinning_count));
+        TRY(obj.add("blocked"sv, statistics.blocked_count));
+        TRY(obj.finish());
+        return {};
+    }));
+    TRY(array.finish());
+    return {};
+}
+
+}
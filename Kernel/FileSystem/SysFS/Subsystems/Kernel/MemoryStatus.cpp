@@ -27,6 +27,8 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     get_kmalloc_stats(stats);
 
     auto system_memory = MM.get_system_memory_info();
+    auto huge_pages = MM.get_huge_page_statistics();
+    auto zeroed_page_pool = MM.get_zeroed_page_pool_statistics();
 
     auto json = TRY(JsonObjectSerializer<>::try_create(builder));
     TRY(json.add("kmalloc_allocated"sv, stats.bytes_allocated));
@@ -37,6 +39,21 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     TRY(json.add("physical_uncommitted"sv, system_memory.physical_pages_uncommitted));
     TRY(json.add("kmalloc_call_count"sv, stats.kmalloc_call_count));
     TRY(json.add("kfree_call_count"sv, stats.kfree_call_count));
+    TRY(json.add("huge_page_promotions"sv, huge_pages.promotions));
+    TRY(json.add("huge_page_demotions"sv, huge_pages.demotions));
+    TRY(json.add("huge_page_allocation_failures"sv, huge_pages.allocation_failures));
+    TRY(json.add("zeroed_page_pool_size"sv, zeroed_page_pool.size));
+    TRY(json.add("zeroed_page_pool_hits"sv, zeroed_page_pool.hits));
+    TRY(json.add("zeroed_page_pool_misses"sv, zeroed_page_pool.misses));
+    auto slabheaps = TRY(json.add_array("kmalloc_slabheaps"sv));
+    for (auto const& slabheap : stats.slabheaps) {
+        auto slabheap_object = TRY(slabheaps.add_object());
+        TRY(slabheap_object.add("slab_size"sv, slabheap.slab_size));
+        TRY(slabheap_object.add("cache_hit_count"sv, slabheap.cache_hit_count));
+        TRY(slabheap_object.add("cache_miss_count"sv, slabheap.cache_miss_count));
+        TRY(slabheap_object.finish());
+    }
+    TRY(slabheaps.finish());
     TRY(json.finish());
     return {};
 }
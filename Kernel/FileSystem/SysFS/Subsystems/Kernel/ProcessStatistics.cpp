@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Try.h>
+#include <Kernel/API/ProcessStatistics.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/ProcessStatistics.h>
+#include <Kernel/Process.h>
+#include <Kernel/Scheduler.h>
+#include <Kernel/Sections.h>
+#include <Kernel/TTY/TTY.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSProcessStatistics::SysFSProcessStatistics(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullLockRefPtr<SysFSProcessStatistics> SysFSProcessStatistics::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_lock_ref_if_nonnull(new (nothrow) SysFSProcessStatistics(parent_directory)).release_nonnull();
+}
+
+template<typename RecordType>
+static ErrorOr<void> append_record(KBufferBuilder& builder, RecordType& record, ProcessStatisticsRecordType type, ReadonlySpan<StringView> strings)
+{
+    size_t size = sizeof(RecordType);
+    for (auto string : strings)
+        size += string.length();
+
+    record.header.type = type;
+    record.header.fixed_size = sizeof(RecordType);
+    record.header.size = size;
+    TRY(builder.append_bytes({ &record, sizeof(RecordType) }));
+    for (auto string : strings)
+        TRY(builder.append_bytes(string.bytes()));
+    return {};
+}
+
+static StringView veil_state_name(VeilState veil_state)
+{
+    switch (veil_state) {
+    case VeilState::None:
+        return "None"sv;
+    case VeilState::Dropped:
+        return "Dropped"sv;
+    case VeilState::Locked:
+    // Note: We don't reveal if the locked state is either by our choice
+    // or someone else applied it.
+    case VeilState::LockedInherited:
+        return "Locked"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+ErrorOr<void> SysFSProcessStatistics::try_generate(KBufferBuilder& builder)
+{
+    auto total_time_scheduled = Scheduler::get_total_time_scheduled();
+    ProcessStatisticsHeader header {};
+    header.magic = process_statistics_magic;
+    header.version = process_statistics_version;
+    header.header_size = sizeof(ProcessStatisticsHeader);
+    header.total_time_scheduled = total_time_scheduled.total;
+    header.total_time_scheduled_kernel = total_time_scheduled.total_kernel;
+    TRY(builder.append_bytes({ &header, sizeof(header) }));
+
+    // Keep this in sync with SysFSOverallProcesses.
+    auto build_process = [&](Process const& process) -> ErrorOr<void> {
+        ProcessStatisticsRecord record {};
+
+        StringBuilder pledge_builder;
+        StringView veil;
+        if (process.is_user_process()) {
+#define __ENUMERATE_PLEDGE_PROMISE(promise)    \
+    if (process.has_promised(Pledge::promise)) \
+        TRY(pledge_builder.try_append(#promise " "sv));
+            ENUMERATE_PLEDGE_PROMISES
+#undef __ENUMERATE_PLEDGE_PROMISE
+            veil = veil_state_name(process.veil_state());
+        }
+
+        record.pid = process.pid().value();
+        record.pgid = process.tty() ? process.tty()->pgid().value() : 0;
+        record.pgp = process.pgid().value();
+        record.sid = process.sid().value();
+        auto credentials = process.credentials();
+        record.uid = credentials->uid().value();
+        record.gid = credentials->gid().value();
+        record.ppid = process.ppid().value();
+        record.nfds = process.fds().with_shared([](auto& fds) { return fds.open_count(); });
+        record.kernel = process.is_kernel_process();
+        record.dumpable = process.is_dumpable();
+
+        TRY(process.address_space().with([&](auto& space) -> ErrorOr<void> {
+            record.amount_virtual = space->amount_virtual();
+            record.amount_resident = space->amount_resident();
+            record.amount_dirty_private = space->amount_dirty_private();
+            record.amount_clean_inode = TRY(space->amount_clean_inode());
+            record.amount_shared = space->amount_shared();
+            record.amount_purgeable_volatile = space->amount_purgeable_volatile();
+            record.amount_purgeable_nonvolatile = space->amount_purgeable_nonvolatile();
+            return {};
+        }));
+
+        OwnPtr<KString> tty_name;
+        if (process.tty())
+            tty_name = TRY(process.tty()->pseudo_name());
+        OwnPtr<KString> executable_path;
+        if (process.executable())
+            executable_path = TRY(process.executable()->try_serialize_absolute_path());
+        auto name = TRY(process.name().with([](auto& process_name) { return process_name->try_clone(); }));
+
+        StringView strings[] = {
+            name->view(),
+            executable_path ? executable_path->view() : ""sv,
+            tty_name ? tty_name->view() : ""sv,
+            pledge_builder.string_view(),
+            veil,
+        };
+        record.name_length = strings[0].length();
+        record.executable_length = strings[1].length();
+        record.tty_length = strings[2].length();
+        record.pledge_length = strings[3].length();
+        record.veil_length = strings[4].length();
+        TRY(append_record(builder, record, ProcessStatisticsRecordType::Process, strings));
+
+        return process.try_for_each_thread([&](Thread const& thread) -> ErrorOr<void> {
+            SpinlockLocker locker(thread.get_lock());
+            ThreadStatisticsRecord thread_record {};
+            thread_record.tid = thread.tid().value();
+            thread_record.times_scheduled = thread.times_scheduled();
+            thread_record.time_user = thread.time_in_user();
+            thread_record.time_kernel = thread.time_in_kernel();
+            thread_record.cpu = thread.cpu();
+            thread_record.priority = thread.priority();
+            thread_record.syscall_count = thread.syscall_count();
+            thread_record.inode_faults = thread.inode_faults();
+            thread_record.zero_faults = thread.zero_faults();
+            thread_record.cow_faults = thread.cow_faults();
+            thread_record.unix_socket_read_bytes = thread.unix_socket_read_bytes();
+            thread_record.unix_socket_write_bytes = thread.unix_socket_write_bytes();
+            thread_record.ipv4_socket_read_bytes = thread.ipv4_socket_read_bytes();
+            thread_record.ipv4_socket_write_bytes = thread.ipv4_socket_write_bytes();
+            thread_record.file_read_bytes = thread.file_read_bytes();
+            thread_record.file_write_bytes = thread.file_write_bytes();
+
+            return thread.name().with([&](auto& thread_name) -> ErrorOr<void> {
+                StringView thread_strings[] = { thread_name->view(), thread.state_string() };
+                thread_record.name_length = thread_strings[0].length();
+                thread_record.state_length = thread_strings[1].length();
+                return append_record(builder, thread_record, ProcessStatisticsRecordType::Thread, thread_strings);
+            });
+        });
+    };
+
+    // FIXME: Do we actually want to expose the colonel process in a Jail environment?
+    TRY(build_process(*Scheduler::colonel()));
+    return Process::for_each_in_same_jail([&](Process& process) -> ErrorOr<void> {
+        return build_process(process);
+    });
+}
+
+}
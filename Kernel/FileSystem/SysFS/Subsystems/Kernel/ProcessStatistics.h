@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/GlobalInformation.h>
+#include <Kernel/KBufferBuilder.h>
+#include <Kernel/Library/LockRefPtr.h>
+#include <Kernel/UserOrKernelBuffer.h>
+
+namespace Kernel {
+
+// The binary counterpart of SysFSOverallProcesses, see Kernel/API/ProcessStatistics.h for the format.
+class SysFSProcessStatistics final : public SysFSGlobalInformation {
+public:
+    virtual StringView name() const override { return "process_statistics"sv; }
+
+    static NonnullLockRefPtr<SysFSProcessStatistics> must_create(SysFSDirectory const& parent_directory);
+
+private:
+    explicit SysFSProcessStatistics(SysFSDirectory const& parent_directory);
+    virtual ErrorOr<void> try_generate(KBufferBuilder& builder) override;
+
+    virtual bool is_readable_by_jailed_processes() const override { return true; }
+};
+
+}
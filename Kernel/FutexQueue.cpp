@@ -38,19 +38,39 @@ ErrorOr<u32> FutexQueue::wake_n_requeue(u32 wake_count, Function<ErrorOr<FutexQu
     dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n_requeue({}, {})", this, wake_count, requeue_count);
 
     u32 did_wake = 0, did_requeue = 0;
-    unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void*, bool& stop_iterating) {
-        VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
-        auto& blocker = static_cast<Thread::FutexBlocker&>(b);
-
-        dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n_requeue unblocking {}", this, blocker.thread());
-        VERIFY(did_wake < wake_count);
-        if (blocker.unblock()) {
-            if (++did_wake >= wake_count)
-                stop_iterating = true;
-            return true;
-        }
-        return false;
-    });
+    // NOTE: A wake count of 0 is allowed here, which lets condition variables move all of their waiters
+    //       onto the mutex without waking any of them just to have them go back to sleep right away.
+    if (wake_count > 0) {
+        unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void* data, bool& stop_iterating) {
+            VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
+            auto& blocker = static_cast<Thread::FutexBlocker&>(b);
+
+            dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n_requeue unblocking {}", this, blocker.thread());
+            VERIFY(did_wake < wake_count);
+            if (blocker.unblock(data)) {
+                if (++did_wake >= wake_count)
+                    stop_iterating = true;
+                return true;
+            }
+            return false;
+        });
+    }
+    if (requeue_count > 0) {
+        // A thread waiting on multiple futexes is also queued elsewhere, so it can't be moved. Wake it up instead,
+        // which is indistinguishable from a spurious wakeup for it.
+        unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void* data, bool& stop_iterating) {
+            auto& blocker = static_cast<Thread::FutexBlocker&>(b);
+            if (!blocker.is_waiting_on_multiple_queues())
+                return false;
+            if (blocker.unblock(data)) {
+                if (++did_requeue >= requeue_count)
+                    stop_iterating = true;
+                return true;
+            }
+            return false;
+        });
+        requeue_count -= did_requeue;
+    }
     is_empty = is_empty_and_no_imminent_waits_locked();
     if (requeue_count > 0) {
         auto blockers_to_requeue = do_take_blockers(requeue_count);
@@ -66,7 +86,7 @@ ErrorOr<u32> FutexQueue::wake_n_requeue(u32 wake_count, Function<ErrorOr<FutexQu
                 }
 
                 lock.unlock();
-                did_requeue = blockers_to_requeue.size();
+                did_requeue += blockers_to_requeue.size();
 
                 SpinlockLocker target_lock(target_futex_queue->m_lock);
                 // Now that we have the lock of the target, append the blockers
@@ -96,13 +116,13 @@ u32 FutexQueue::wake_n(u32 wake_count, Optional<u32> const& bitset, bool& is_emp
     SpinlockLocker lock(m_lock);
     dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n({})", this, wake_count);
     u32 did_wake = 0;
-    unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void*, bool& stop_iterating) {
+    unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void* data, bool& stop_iterating) {
         VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
         auto& blocker = static_cast<Thread::FutexBlocker&>(b);
 
         dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n unblocking {}", this, blocker.thread());
         VERIFY(did_wake < wake_count);
-        if (bitset.has_value() ? blocker.unblock_bitset(bitset.value()) : blocker.unblock()) {
+        if (bitset.has_value() ? blocker.unblock_bitset(bitset.value(), data) : blocker.unblock(data)) {
             if (++did_wake >= wake_count)
                 stop_iterating = true;
             return true;
@@ -118,11 +138,11 @@ u32 FutexQueue::wake_all(bool& is_empty)
     SpinlockLocker lock(m_lock);
     dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_all", this);
     u32 did_wake = 0;
-    unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void*, bool&) {
+    unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void* data, bool&) {
         VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
         auto& blocker = static_cast<Thread::FutexBlocker&>(b);
         dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_all unblocking {}", this, blocker.thread());
-        if (blocker.unblock(true)) {
+        if (blocker.unblock(data, true)) {
             did_wake++;
             return true;
         }
@@ -146,6 +166,13 @@ bool FutexQueue::queue_imminent_wait()
     return true;
 }
 
+void FutexQueue::cancel_imminent_wait()
+{
+    SpinlockLocker lock(m_lock);
+    VERIFY(m_imminent_waits > 0);
+    m_imminent_waits--;
+}
+
 bool FutexQueue::try_remove()
 {
     SpinlockLocker lock(m_lock);
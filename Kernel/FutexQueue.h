@@ -29,7 +29,15 @@ public:
         return Thread::current()->block<Thread::FutexBlocker>(timeout, *this, forward<Args>(args)...);
     }
 
+    // Blocks until any of the queues wakes us up, the index of that queue is stored in woken_index.
+    static Thread::BlockResult wait_on_any(Thread::BlockTimeout const& timeout, ReadonlySpan<NonnullLockRefPtr<FutexQueue>> futex_queues, size_t& woken_index)
+    {
+        return Thread::current()->block<Thread::FutexBlocker>(timeout, futex_queues, woken_index);
+    }
+
     bool queue_imminent_wait();
+    // Undoes queue_imminent_wait() for a wait that ended up not happening.
+    void cancel_imminent_wait();
     bool try_remove();
 
     bool is_empty_and_no_imminent_waits()
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/FixedArray.h>
 #include <Kernel/API/Ioctl.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/DeviceIdentifiers/CharacterDevicesDirectory.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Devices/Graphics/DisplayConnector/DeviceDirectory.h>
@@ -257,6 +258,16 @@ ErrorOr<void> DisplayConnector::flush_rectangle(size_t, FBRect const&)
     return Error::from_errno(ENOTSUP);
 }
 
+ErrorOr<void> DisplayConnector::set_cursor(ReadonlySpan<u32>, size_t, size_t)
+{
+    return Error::from_errno(ENOTSUP);
+}
+
+ErrorOr<void> DisplayConnector::move_cursor(int, int)
+{
+    return Error::from_errno(ENOTSUP);
+}
+
 DisplayConnector::ModeSetting DisplayConnector::current_mode_setting() const
 {
     SpinlockLocker locker(m_modeset_lock);
@@ -287,6 +298,8 @@ static constexpr GraphicsIOCtlChecker s_checkers[] = {
     { GRAPHICS_IOCTL_SET_SAFE_HEAD_MODE_SETTING, "GRAPHICS_IOCTL_SET_SAFE_HEAD_MODE_SETTING"sv, true },
     { GRAPHICS_IOCTL_SET_RESPONSIBLE, "GRAPHICS_IOCTL_SET_RESPONSIBLE"sv, false },
     { GRAPHICS_IOCTL_UNSET_RESPONSIBLE, "GRAPHICS_IOCTL_UNSET_RESPONSIBLE"sv, true },
+    { GRAPHICS_IOCTL_SET_HEAD_CURSOR, "GRAPHICS_IOCTL_SET_HEAD_CURSOR"sv, true },
+    { GRAPHICS_IOCTL_MOVE_HEAD_CURSOR, "GRAPHICS_IOCTL_MOVE_HEAD_CURSOR"sv, true },
 };
 
 static StringView ioctl_to_stringview(unsigned request)
@@ -355,6 +368,7 @@ ErrorOr<void> DisplayConnector::ioctl(OpenFileDescription&, unsigned request, Us
         properties.doublebuffer_support = double_framebuffering_capable();
         properties.partial_flushing_support = partial_flush_support();
         properties.refresh_rate_support = refresh_rate_support();
+        properties.hardware_cursor_support = hardware_cursor_support();
         properties.max_buffer_bytes = m_shared_framebuffer_vmobject->size();
 
         return copy_to_user(user_properties, &properties);
@@ -505,6 +519,44 @@ ErrorOr<void> DisplayConnector::ioctl(OpenFileDescription&, unsigned request, Us
         TRY(flush_first_surface());
         return {};
     }
+    case GRAPHICS_IOCTL_SET_HEAD_CURSOR: {
+        if (!hardware_cursor_support())
+            return Error::from_errno(ENOTSUP);
+        auto user_cursor = static_ptr_cast<GraphicsHeadCursor const*>(arg);
+        auto cursor = TRY(copy_typed_from_user(user_cursor));
+        if (cursor.hotspot_x < 0 || cursor.hotspot_x >= GRAPHICS_HEAD_CURSOR_SIZE)
+            return Error::from_errno(EINVAL);
+        if (cursor.hotspot_y < 0 || cursor.hotspot_y >= GRAPHICS_HEAD_CURSOR_SIZE)
+            return Error::from_errno(EINVAL);
+
+        if (!cursor.pixels) {
+            MutexLocker locker(m_flushing_lock);
+            SpinlockLocker control_locker(m_control_lock);
+            TRY(set_cursor({}, 0, 0));
+            return {};
+        }
+
+        auto pixels = TRY(FixedArray<u32>::create(GRAPHICS_HEAD_CURSOR_SIZE * GRAPHICS_HEAD_CURSOR_SIZE));
+        TRY(copy_n_from_user(pixels.data(), cursor.pixels, pixels.size()));
+
+        MutexLocker locker(m_flushing_lock);
+        SpinlockLocker control_locker(m_control_lock);
+        // Note: The cursor is hidden while we are in console mode, but we still take the new
+        // image, so that it shows up as soon as we switch back to graphical mode.
+        TRY(set_cursor(pixels.span(), cursor.hotspot_x, cursor.hotspot_y));
+        return {};
+    }
+    case GRAPHICS_IOCTL_MOVE_HEAD_CURSOR: {
+        if (!hardware_cursor_support())
+            return Error::from_errno(ENOTSUP);
+        auto user_position = static_ptr_cast<GraphicsHeadCursorPosition const*>(arg);
+        auto position = TRY(copy_typed_from_user(user_position));
+
+        MutexLocker locker(m_flushing_lock);
+        SpinlockLocker control_locker(m_control_lock);
+        TRY(move_cursor(position.x, position.y));
+        return {};
+    }
     }
     // Note: We already verify that the IOCTL is supported and not unknown in
     // the call to the ioctl_requires_ownership method, so if we reached this
@@ -89,6 +89,9 @@ public:
     // a defined refresh rate being supplied when modesetting the screen resolution.
     // Paravirtualized hardware don't need such setting and can safely ignore this.
     virtual bool refresh_rate_support() const = 0;
+    // Note: A hardware cursor is drawn by the hardware on top of the framebuffer,
+    // so moving it around doesn't require userland to touch the framebuffer.
+    virtual bool hardware_cursor_support() const { return false; }
 
     bool console_mode() const;
     ErrorOr<ByteBuffer> get_edid() const;
@@ -112,6 +115,12 @@ protected:
     virtual ErrorOr<void> flush_first_surface() = 0;
     virtual ErrorOr<void> flush_rectangle(size_t buffer_index, FBRect const& rect);
 
+    // Note: An empty span of pixels hides the cursor. Otherwise, it holds
+    // GRAPHICS_HEAD_CURSOR_SIZE * GRAPHICS_HEAD_CURSOR_SIZE ARGB32 pixels.
+    virtual ErrorOr<void> set_cursor(ReadonlySpan<u32> pixels, size_t hotspot_x, size_t hotspot_y);
+    // Note: This places the hotspot of the cursor at the given position.
+    virtual ErrorOr<void> move_cursor(int x, int y);
+
     ErrorOr<void> initialize_edid_for_generic_monitor(Optional<Array<u8, 3>> manufacturer_id_string);
 
     mutable Spinlock<LockRank::None> m_control_lock {};
@@ -148,10 +148,27 @@ ErrorOr<void> VirtIODisplayConnector::flush_first_surface()
     return {};
 }
 
+ErrorOr<void> VirtIODisplayConnector::set_cursor(ReadonlySpan<u32> pixels, size_t hotspot_x, size_t hotspot_y)
+{
+    VERIFY(m_flushing_lock.is_locked());
+    TRY(m_graphics_adapter->update_cursor({}, *this, pixels, hotspot_x, hotspot_y));
+    return {};
+}
+
+ErrorOr<void> VirtIODisplayConnector::move_cursor(int x, int y)
+{
+    VERIFY(m_flushing_lock.is_locked());
+    TRY(m_graphics_adapter->move_cursor({}, *this, x, y));
+    return {};
+}
+
 void VirtIODisplayConnector::enable_console()
 {
     VERIFY(m_control_lock.is_locked());
     VERIFY(m_console);
+    // Note: The host draws the cursor on top of everything, including the console.
+    if (auto result = m_graphics_adapter->set_cursor_visible({}, *this, false); result.is_error())
+        dbgln("VirtIODisplayConnector: Failed to hide the cursor: {}", result.error());
     m_console->enable();
 }
 
@@ -160,6 +177,8 @@ void VirtIODisplayConnector::disable_console()
     VERIFY(m_control_lock.is_locked());
     VERIFY(m_console);
     m_console->disable();
+    if (auto result = m_graphics_adapter->set_cursor_visible({}, *this, true); result.is_error())
+        dbgln("VirtIODisplayConnector: Failed to show the cursor: {}", result.error());
 }
 
 void VirtIODisplayConnector::set_edid_bytes(Badge<VirtIOGraphicsAdapter>, Array<u8, 128> const& edid_bytes)
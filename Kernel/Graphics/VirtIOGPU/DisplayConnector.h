@@ -54,10 +54,14 @@ private:
     virtual bool flush_support() const override { return true; }
     // Note: Paravirtualized hardware doesn't require a defined refresh rate for modesetting.
     virtual bool refresh_rate_support() const override { return false; }
+    virtual bool hardware_cursor_support() const override { return true; }
 
     virtual ErrorOr<void> flush_first_surface() override;
     virtual ErrorOr<void> flush_rectangle(size_t buffer_index, FBRect const& rect) override;
 
+    virtual ErrorOr<void> set_cursor(ReadonlySpan<u32> pixels, size_t hotspot_x, size_t hotspot_y) override;
+    virtual ErrorOr<void> move_cursor(int x, int y) override;
+
     virtual void enable_console() override;
     virtual void disable_console() override;
 
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/DistinctNumeric.h>
+#include <Kernel/API/VirGL.h>
 #include <Kernel/Devices/CharacterDevice.h>
 #include <Kernel/Devices/DeviceManagement.h>
 #include <Kernel/Graphics/VirtIOGPU/Protocol.h>
@@ -139,7 +140,7 @@ private:
     HashMap<OpenFileDescription*, LockRefPtr<PerContextState>> m_context_state_lookup;
     // Memory management for backing buffers
     NonnullOwnPtr<Memory::Region> m_transfer_buffer_region;
-    constexpr static size_t NUM_TRANSFER_REGION_PAGES = 1024;
+    constexpr static size_t NUM_TRANSFER_REGION_PAGES = VIRGL_TRANSFER_REGION_PAGES;
 };
 
 }
@@ -5,6 +5,7 @@
  */
 
 #include <AK/BinaryBufferWriter.h>
+#include <AK/BitCast.h>
 #include <Kernel/Arch/Delay.h>
 #include <Kernel/Bus/PCI/API.h>
 #include <Kernel/Bus/PCI/IDs.h>
@@ -49,6 +50,8 @@ ErrorOr<void> VirtIOGraphicsAdapter::initialize_adapter()
     for (size_t index = 0; index < m_num_scanouts; index++) {
         auto display_connector = VirtIODisplayConnector::must_create(*this, index);
         m_scanouts[index].display_connector = display_connector;
+        auto cursor_region_size = TRY(calculate_framebuffer_size(GRAPHICS_HEAD_CURSOR_SIZE, GRAPHICS_HEAD_CURSOR_SIZE));
+        m_scanouts[index].cursor.region = TRY(MM.allocate_kernel_region(cursor_region_size, "VirtGPU Cursor"sv, Memory::Region::Access::ReadWrite));
         TRY(query_and_set_edid(index, *display_connector));
         display_connector->set_safe_mode_setting_after_initialization({});
         display_connector->initialize_console({});
@@ -101,6 +104,75 @@ ErrorOr<void> VirtIOGraphicsAdapter::transfer_framebuffer_data_to_host(Badge<Vir
     return {};
 }
 
+ErrorOr<void> VirtIOGraphicsAdapter::update_cursor(Badge<VirtIODisplayConnector>, VirtIODisplayConnector& connector, ReadonlySpan<u32> pixels, u32 hotspot_x, u32 hotspot_y)
+{
+    SpinlockLocker locker(m_operation_lock);
+    VERIFY(connector.scanout_id() < VIRTIO_GPU_MAX_SCANOUTS);
+    auto& cursor = m_scanouts[connector.scanout_id().value()].cursor;
+
+    if (pixels.is_empty()) {
+        cursor.has_image = false;
+        if (!cursor.visible)
+            return {};
+        // Note: Updating the cursor to resource ID 0 hides it.
+        return submit_cursor_command(connector.scanout_id(), Graphics::VirtIOGPU::Protocol::CommandType::VIRTIO_GPU_CMD_UPDATE_CURSOR, 0);
+    }
+
+    Graphics::VirtIOGPU::Protocol::Rect cursor_rect {
+        .x = 0,
+        .y = 0,
+        .width = GRAPHICS_HEAD_CURSOR_SIZE,
+        .height = GRAPHICS_HEAD_CURSOR_SIZE
+    };
+    VERIFY(pixels.size() == cursor_rect.width * cursor_rect.height);
+
+    if (cursor.resource_id.value() == 0) {
+        // Note: Our ARGB32 pixels are laid out as B, G, R, A in memory.
+        auto resource_id = TRY(create_2d_resource(cursor_rect, Graphics::VirtIOGPU::Protocol::TextureFormat::VIRTIO_GPU_FORMAT_B8G8R8A8_UNORM));
+        TRY(ensure_backing_storage(resource_id, *cursor.region, 0, cursor.region->size()));
+        cursor.resource_id = resource_id;
+    }
+
+    memcpy(cursor.region->vaddr().as_ptr(), pixels.data(), pixels.size() * sizeof(u32));
+    TRY(transfer_resource_data_to_host(cursor.resource_id, cursor_rect, 0));
+
+    cursor.hotspot_x = hotspot_x;
+    cursor.hotspot_y = hotspot_y;
+    cursor.has_image = true;
+    if (!cursor.visible)
+        return {};
+    return submit_cursor_command(connector.scanout_id(), Graphics::VirtIOGPU::Protocol::CommandType::VIRTIO_GPU_CMD_UPDATE_CURSOR, cursor.resource_id);
+}
+
+ErrorOr<void> VirtIOGraphicsAdapter::move_cursor(Badge<VirtIODisplayConnector>, VirtIODisplayConnector& connector, i32 x, i32 y)
+{
+    SpinlockLocker locker(m_operation_lock);
+    VERIFY(connector.scanout_id() < VIRTIO_GPU_MAX_SCANOUTS);
+    auto& cursor = m_scanouts[connector.scanout_id().value()].cursor;
+
+    // Note: The specification says these are unsigned, but the host treats them as signed,
+    // which lets the cursor hang off the left and top edges of the screen.
+    cursor.position.x = bit_cast<u32>(x);
+    cursor.position.y = bit_cast<u32>(y);
+    if (!cursor.has_image || !cursor.visible)
+        return {};
+    return submit_cursor_command(connector.scanout_id(), Graphics::VirtIOGPU::Protocol::CommandType::VIRTIO_GPU_CMD_MOVE_CURSOR, cursor.resource_id);
+}
+
+ErrorOr<void> VirtIOGraphicsAdapter::set_cursor_visible(Badge<VirtIODisplayConnector>, VirtIODisplayConnector& connector, bool visible)
+{
+    SpinlockLocker locker(m_operation_lock);
+    VERIFY(connector.scanout_id() < VIRTIO_GPU_MAX_SCANOUTS);
+    auto& cursor = m_scanouts[connector.scanout_id().value()].cursor;
+
+    if (cursor.visible == visible)
+        return {};
+    cursor.visible = visible;
+    if (!cursor.has_image)
+        return {};
+    return submit_cursor_command(connector.scanout_id(), Graphics::VirtIOGPU::Protocol::CommandType::VIRTIO_GPU_CMD_UPDATE_CURSOR, visible ? cursor.resource_id : Graphics::VirtIOGPU::ResourceID(0));
+}
+
 ErrorOr<void> VirtIOGraphicsAdapter::attach_physical_range_to_framebuffer(VirtIODisplayConnector& connector, bool main_buffer, size_t framebuffer_offset, size_t framebuffer_size)
 {
     VERIFY(m_operation_lock.is_locked());
@@ -250,7 +322,7 @@ ErrorOr<void> VirtIOGraphicsAdapter::query_and_set_edid(u32 scanout_id, VirtIODi
     return {};
 }
 
-ErrorOr<Graphics::VirtIOGPU::ResourceID> VirtIOGraphicsAdapter::create_2d_resource(Graphics::VirtIOGPU::Protocol::Rect rect)
+ErrorOr<Graphics::VirtIOGPU::ResourceID> VirtIOGraphicsAdapter::create_2d_resource(Graphics::VirtIOGPU::Protocol::Rect rect, Graphics::VirtIOGPU::Protocol::TextureFormat format)
 {
     VERIFY(m_operation_lock.is_locked());
     auto writer = create_scratchspace_writer();
@@ -263,7 +335,7 @@ ErrorOr<Graphics::VirtIOGPU::ResourceID> VirtIOGraphicsAdapter::create_2d_resour
     request.resource_id = resource_id.value();
     request.width = rect.width;
     request.height = rect.height;
-    request.format = to_underlying(Graphics::VirtIOGPU::Protocol::TextureFormat::VIRTIO_GPU_FORMAT_B8G8R8X8_UNORM);
+    request.format = to_underlying(format);
 
     TRY(synchronous_virtio_gpu_command(100, start_of_scratch_space(), sizeof(request), sizeof(response)));
 
@@ -378,6 +450,13 @@ ErrorOr<void> VirtIOGraphicsAdapter::set_scanout_resource(Graphics::VirtIOGPU::S
 }
 
 ErrorOr<void> VirtIOGraphicsAdapter::transfer_framebuffer_data_to_host(Graphics::VirtIOGPU::ScanoutID scanout, Graphics::VirtIOGPU::ResourceID resource_id, Graphics::VirtIOGPU::Protocol::Rect const& dirty_rect)
+{
+    VERIFY(m_operation_lock.is_locked());
+    auto offset = (dirty_rect.x + (dirty_rect.y * m_scanouts[scanout.value()].display_connector->display_information({}).rect.width)) * sizeof(u32);
+    return transfer_resource_data_to_host(resource_id, dirty_rect, offset);
+}
+
+ErrorOr<void> VirtIOGraphicsAdapter::transfer_resource_data_to_host(Graphics::VirtIOGPU::ResourceID resource_id, Graphics::VirtIOGPU::Protocol::Rect const& rect, u64 offset)
 {
     VERIFY(m_operation_lock.is_locked());
     auto writer = create_scratchspace_writer();
@@ -385,9 +464,9 @@ ErrorOr<void> VirtIOGraphicsAdapter::transfer_framebuffer_data_to_host(Graphics:
     auto& response = writer.append_structure<Graphics::VirtIOGPU::Protocol::ControlHeader>();
 
     populate_virtio_gpu_request_header(request.header, Graphics::VirtIOGPU::Protocol::CommandType::VIRTIO_GPU_CMD_TRANSFER_TO_HOST_2D, 0);
-    request.offset = (dirty_rect.x + (dirty_rect.y * m_scanouts[scanout.value()].display_connector->display_information({}).rect.width)) * sizeof(u32);
+    request.offset = offset;
     request.resource_id = resource_id.value();
-    request.rect = dirty_rect;
+    request.rect = rect;
 
     TRY(synchronous_virtio_gpu_command(100, start_of_scratch_space(), sizeof(request), sizeof(response)));
 
@@ -440,6 +519,51 @@ ErrorOr<void> VirtIOGraphicsAdapter::synchronous_virtio_gpu_command(size_t micro
     return Error::from_errno(EBUSY);
 }
 
+ErrorOr<void> VirtIOGraphicsAdapter::synchronous_virtio_gpu_cursor_command(size_t microseconds_timeout, PhysicalAddress buffer_start, size_t request_size)
+{
+    VERIFY(m_operation_lock.is_locked());
+    VERIFY(microseconds_timeout > 10);
+    VERIFY(microseconds_timeout < 100000);
+    auto& queue = get_queue(CURSORQ);
+    queue.disable_interrupts();
+    SpinlockLocker lock(queue.lock());
+    VirtIO::QueueChain chain { queue };
+    // Note: The device doesn't write a response for commands on the cursor queue.
+    chain.add_buffer_to_chain(buffer_start, request_size, VirtIO::BufferType::DeviceReadable);
+    supply_chain_and_notify(CURSORQ, chain);
+    full_memory_barrier();
+    size_t current_time = 0;
+    ScopeGuard clear_used_buffers([&] {
+        queue.discard_used_buffers();
+    });
+    while (current_time < microseconds_timeout) {
+        if (queue.new_data_available())
+            return {};
+        microseconds_delay(1);
+        current_time++;
+    }
+    return Error::from_errno(EBUSY);
+}
+
+ErrorOr<void> VirtIOGraphicsAdapter::submit_cursor_command(Graphics::VirtIOGPU::ScanoutID scanout_id, Graphics::VirtIOGPU::Protocol::CommandType command_type, Graphics::VirtIOGPU::ResourceID resource_id)
+{
+    VERIFY(m_operation_lock.is_locked());
+    auto& cursor = m_scanouts[scanout_id.value()].cursor;
+    auto writer = create_scratchspace_writer();
+    auto& request = writer.append_structure<Graphics::VirtIOGPU::Protocol::UpdateCursor>();
+
+    populate_virtio_gpu_request_header(request.header, command_type, 0);
+    request.position = cursor.position;
+    request.position.scanout_id = scanout_id.value();
+    request.position.padding = 0;
+    request.resource_id = resource_id.value();
+    request.hot_x = cursor.hotspot_x;
+    request.hot_y = cursor.hotspot_y;
+    request.padding = 0;
+
+    return synchronous_virtio_gpu_cursor_command(100, start_of_scratch_space(), sizeof(request));
+}
+
 ErrorOr<void> VirtIOGraphicsAdapter::flush_dirty_rectangle(Graphics::VirtIOGPU::ScanoutID scanout_id, Graphics::VirtIOGPU::ResourceID resource_id, Graphics::VirtIOGPU::Protocol::Rect const& dirty_rect)
 {
     VERIFY(m_operation_lock.is_locked());
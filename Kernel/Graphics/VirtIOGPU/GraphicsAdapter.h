@@ -49,11 +49,17 @@ public:
     ErrorOr<void> flush_displayed_image(Badge<VirtIODisplayConnector>, VirtIODisplayConnector&, Graphics::VirtIOGPU::Protocol::Rect const& dirty_rect, bool main_buffer);
     ErrorOr<void> transfer_framebuffer_data_to_host(Badge<VirtIODisplayConnector>, VirtIODisplayConnector&, Graphics::VirtIOGPU::Protocol::Rect const& rect, bool main_buffer);
 
+    ErrorOr<void> update_cursor(Badge<VirtIODisplayConnector>, VirtIODisplayConnector&, ReadonlySpan<u32> pixels, u32 hotspot_x, u32 hotspot_y);
+    ErrorOr<void> move_cursor(Badge<VirtIODisplayConnector>, VirtIODisplayConnector&, i32 x, i32 y);
+    ErrorOr<void> set_cursor_visible(Badge<VirtIODisplayConnector>, VirtIODisplayConnector&, bool visible);
+
 private:
     ErrorOr<void> attach_physical_range_to_framebuffer(VirtIODisplayConnector& connector, bool main_buffer, size_t framebuffer_offset, size_t framebuffer_size);
 
     ErrorOr<void> initialize_3d_device();
 
+    ErrorOr<void> submit_cursor_command(Graphics::VirtIOGPU::ScanoutID, Graphics::VirtIOGPU::Protocol::CommandType, Graphics::VirtIOGPU::ResourceID);
+
     ErrorOr<void> flush_dirty_rectangle(Graphics::VirtIOGPU::ScanoutID, Graphics::VirtIOGPU::ResourceID, Graphics::VirtIOGPU::Protocol::Rect const& dirty_rect);
     struct Scanout {
         struct PhysicalBuffer {
@@ -62,9 +68,21 @@ private:
             Graphics::VirtIOGPU::ResourceID resource_id { 0 };
         };
 
+        // The host draws the cursor on top of whatever is scanned out, from a resource of its own.
+        struct Cursor {
+            OwnPtr<Memory::Region> region;
+            Graphics::VirtIOGPU::ResourceID resource_id { 0 };
+            bool has_image { false };
+            bool visible { true };
+            Graphics::VirtIOGPU::Protocol::CursorPosition position {};
+            u32 hotspot_x { 0 };
+            u32 hotspot_y { 0 };
+        };
+
         LockRefPtr<VirtIODisplayConnector> display_connector;
         PhysicalBuffer main_buffer;
         PhysicalBuffer back_buffer;
+        Cursor cursor;
     };
 
     VirtIOGraphicsAdapter(PCI::DeviceIdentifier const&, Bitmap&& active_context_ids, NonnullOwnPtr<Memory::Region> scratch_space_region);
@@ -99,13 +117,16 @@ private:
     }
     ErrorOr<void> synchronous_virtio_gpu_command(size_t microseconds_timeout, PhysicalAddress buffer_start, size_t request_size, size_t response_size);
 
-    ErrorOr<Graphics::VirtIOGPU::ResourceID> create_2d_resource(Graphics::VirtIOGPU::Protocol::Rect rect);
+    ErrorOr<void> synchronous_virtio_gpu_cursor_command(size_t microseconds_timeout, PhysicalAddress buffer_start, size_t request_size);
+
+    ErrorOr<Graphics::VirtIOGPU::ResourceID> create_2d_resource(Graphics::VirtIOGPU::Protocol::Rect rect, Graphics::VirtIOGPU::Protocol::TextureFormat = Graphics::VirtIOGPU::Protocol::TextureFormat::VIRTIO_GPU_FORMAT_B8G8R8X8_UNORM);
     ErrorOr<Graphics::VirtIOGPU::ResourceID> create_3d_resource(Graphics::VirtIOGPU::Protocol::Resource3DSpecification const& resource_3d_specification);
     ErrorOr<void> delete_resource(Graphics::VirtIOGPU::ResourceID resource_id);
     ErrorOr<void> ensure_backing_storage(Graphics::VirtIOGPU::ResourceID resource_id, Memory::Region const& region, size_t buffer_offset, size_t buffer_length);
     ErrorOr<void> detach_backing_storage(Graphics::VirtIOGPU::ResourceID resource_id);
     ErrorOr<void> set_scanout_resource(Graphics::VirtIOGPU::ScanoutID scanout, Graphics::VirtIOGPU::ResourceID resource_id, Graphics::VirtIOGPU::Protocol::Rect rect);
     ErrorOr<void> transfer_framebuffer_data_to_host(Graphics::VirtIOGPU::ScanoutID scanout, Graphics::VirtIOGPU::ResourceID resource_id, Graphics::VirtIOGPU::Protocol::Rect const& rect);
+    ErrorOr<void> transfer_resource_data_to_host(Graphics::VirtIOGPU::ResourceID resource_id, Graphics::VirtIOGPU::Protocol::Rect const& rect, u64 offset);
     ErrorOr<void> flush_displayed_image(Graphics::VirtIOGPU::ResourceID resource_id, Graphics::VirtIOGPU::Protocol::Rect const& dirty_rect);
     ErrorOr<void> query_and_set_edid(u32 scanout_id, VirtIODisplayConnector& display_connector);
 
@@ -266,6 +266,24 @@ struct GetEDIDResponse {
     u8 edid[1024];
 };
 
+// Specification equivalent: struct virtio_gpu_cursor_pos
+struct CursorPosition {
+    u32 scanout_id;
+    u32 x;
+    u32 y;
+    u32 padding;
+};
+
+// Specification equivalent: struct virtio_gpu_update_cursor
+struct UpdateCursor {
+    ControlHeader header;
+    CursorPosition position;
+    u32 resource_id;
+    u32 hot_x;
+    u32 hot_y;
+    u32 padding;
+};
+
 // No equivalent in specification
 struct ContextCreate {
     ControlHeader header;
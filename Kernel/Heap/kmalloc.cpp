@@ -10,6 +10,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
 #include <Kernel/Heap/kmalloc.h>
+#include <Kernel/InterruptDisabler.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Memory/MemoryManager.h>
@@ -81,11 +82,18 @@ public:
         m_freelist = freelist_entry;
     }
 
+    static KmallocSlabBlock& from_slab(void* ptr)
+    {
+        return *(KmallocSlabBlock*)((FlatPtr)ptr & block_mask);
+    }
+
     bool is_full() const
     {
         return m_freelist == nullptr;
     }
 
+    size_t slab_size() const { return m_slab_size; }
+
     size_t allocated_bytes() const
     {
         return m_allocated_slabs * m_slab_size;
@@ -150,11 +158,11 @@ public:
     {
         memset(ptr, KFREE_SCRUB_BYTE, m_slab_size);
 
-        auto* block = (KmallocSlabBlock*)((FlatPtr)ptr & KmallocSlabBlock::block_mask);
-        bool block_was_full = block->is_full();
-        block->deallocate(ptr);
+        auto& block = KmallocSlabBlock::from_slab(ptr);
+        bool block_was_full = block.is_full();
+        block.deallocate(ptr);
         if (block_was_full)
-            m_usable_blocks.append(*block);
+            m_usable_blocks.append(block);
     }
 
     size_t allocated_bytes() const
@@ -394,7 +402,18 @@ struct KmallocGlobalData {
 
     KmallocSubheap::List subheaps;
 
-    KmallocSlabheap slabheaps[6] = { 16, 32, 64, 128, 256, 512 };
+    KmallocSlabheap slabheaps[KMALLOC_SLABHEAP_COUNT] = { 16, 32, 64, 128, 256, 512 };
+
+    static constexpr size_t largest_slab_size = 512;
+
+    Optional<size_t> slabheap_index_for(size_t size, size_t alignment) const
+    {
+        for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+            if (size <= slabheaps[i].slab_size() && alignment <= slabheaps[i].slab_size())
+                return i;
+        }
+        return {};
+    }
 
     bool expansion_in_progress { false };
 };
@@ -407,9 +426,92 @@ static size_t g_kfree_call_count;
 static size_t g_nested_kfree_calls;
 bool g_dump_kmalloc_stacks;
 
+// Each processor keeps a small stack ("magazine") of free slabs for every slabheap,
+// so that most small allocations and frees are served without taking s_lock.
+// Magazines are refilled from and drained back to the slabheaps in batches.
+// They are only ever touched by their own processor with interrupts disabled.
+struct KmallocMagazine {
+    static constexpr size_t capacity = 32;
+    static constexpr size_t batch_size = capacity / 2;
+
+    size_t count { 0 };
+    void* slabs[capacity];
+
+    size_t hit_count { 0 };
+    size_t miss_count { 0 };
+};
+
+struct KmallocProcessorCache {
+    KmallocMagazine magazines[KMALLOC_SLABHEAP_COUNT];
+
+    size_t kmalloc_call_count { 0 };
+    size_t kfree_call_count { 0 };
+};
+
+static KmallocProcessorCache g_kmalloc_processor_caches[MAX_CPU_COUNT];
+static bool g_kmalloc_processor_caches_enabled;
+
 void kmalloc_enable_expand()
 {
     g_kmalloc_global->enable_expansion();
+
+    // By now the processor structures are set up, so we can start using the per-processor caches.
+    g_kmalloc_processor_caches_enabled = true;
+}
+
+static void* allocate_from_processor_cache(size_t slabheap_index, CallerWillInitializeMemory caller_will_initialize_memory)
+{
+    InterruptDisabler disabler;
+    auto& cache = g_kmalloc_processor_caches[Processor::current_id()];
+    auto& magazine = cache.magazines[slabheap_index];
+    auto slab_size = g_kmalloc_global->slabheaps[slabheap_index].slab_size();
+    ++cache.kmalloc_call_count;
+
+    if (magazine.count == 0) {
+        ++magazine.miss_count;
+        SpinlockLocker lock(s_lock);
+        while (magazine.count < KmallocMagazine::batch_size) {
+            auto* slab = g_kmalloc_global->allocate(slab_size, KMALLOC_DEFAULT_ALIGNMENT, CallerWillInitializeMemory::Yes);
+            if (!slab)
+                break;
+            magazine.slabs[magazine.count++] = slab;
+        }
+        if (magazine.count == 0)
+            return nullptr;
+    } else {
+        ++magazine.hit_count;
+    }
+
+    auto* ptr = magazine.slabs[--magazine.count];
+    if (caller_will_initialize_memory == CallerWillInitializeMemory::No)
+        memset(ptr, KMALLOC_SCRUB_BYTE, slab_size);
+    return ptr;
+}
+
+static void deallocate_to_processor_cache(void* ptr)
+{
+    VERIFY(g_kmalloc_global->is_valid_kmalloc_address(VirtualAddress { ptr }));
+
+    // NOTE: We file the slab under the slabheap it was actually allocated from, which may
+    //       differ from the one matching its size if it was allocated with a larger alignment.
+    auto slab_size = KmallocSlabBlock::from_slab(ptr).slab_size();
+    auto slabheap_index = g_kmalloc_global->slabheap_index_for(slab_size, 1);
+    VERIFY(slabheap_index.has_value());
+    VERIFY(g_kmalloc_global->slabheaps[*slabheap_index].slab_size() == slab_size);
+
+    memset(ptr, KFREE_SCRUB_BYTE, slab_size);
+
+    InterruptDisabler disabler;
+    auto& cache = g_kmalloc_processor_caches[Processor::current_id()];
+    auto& magazine = cache.magazines[*slabheap_index];
+    ++cache.kfree_call_count;
+
+    if (magazine.count == KmallocMagazine::capacity) {
+        SpinlockLocker lock(s_lock);
+        while (magazine.count > KmallocMagazine::batch_size)
+            g_kmalloc_global->deallocate(magazine.slabs[--magazine.count], slab_size);
+    }
+    magazine.slabs[magazine.count++] = ptr;
 }
 
 UNMAP_AFTER_INIT void kmalloc_init()
@@ -431,16 +533,22 @@ static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMem
     // Alignment must be a power of two.
     VERIFY(is_power_of_two(alignment));
 
-    SpinlockLocker lock(s_lock);
-    ++g_kmalloc_call_count;
+    void* ptr = nullptr;
+    auto slabheap_index = g_kmalloc_global->slabheap_index_for(size, alignment);
+    if (slabheap_index.has_value() && g_kmalloc_processor_caches_enabled && !g_dump_kmalloc_stacks) {
+        ptr = allocate_from_processor_cache(*slabheap_index, caller_will_initialize_memory);
+    } else {
+        SpinlockLocker lock(s_lock);
+        ++g_kmalloc_call_count;
+
+        if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available) {
+            dbgln("kmalloc({})", size);
+            Kernel::dump_backtrace();
+        }
 
-    if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available) {
-        dbgln("kmalloc({})", size);
-        Kernel::dump_backtrace();
+        ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
     }
 
-    void* ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
-
     Thread* current_thread = Thread::current();
     if (!current_thread)
         current_thread = Processor::idle_thread();
@@ -482,6 +590,18 @@ void kfree_sized(void* ptr, size_t size)
         Processor::verify_no_spinlocks_held();
     }
 
+    if (size <= KmallocGlobalData::largest_slab_size && g_kmalloc_processor_caches_enabled) {
+        Thread* current_thread = Thread::current();
+        if (!current_thread)
+            current_thread = Processor::idle_thread();
+        if (current_thread) {
+            VERIFY(current_thread->is_allocation_enabled());
+            PerformanceManager::add_kfree_perf_event(*current_thread, 0, (FlatPtr)ptr);
+        }
+        deallocate_to_processor_cache(ptr);
+        return;
+    }
+
     SpinlockLocker lock(s_lock);
     ++g_kfree_call_count;
     ++g_nested_kfree_calls;
@@ -586,4 +706,21 @@ void get_kmalloc_stats(kmalloc_stats& stats)
     stats.bytes_free = g_kmalloc_global->free_bytes();
     stats.kmalloc_call_count = g_kmalloc_call_count;
     stats.kfree_call_count = g_kfree_call_count;
+
+    for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+        auto& slabheap_stats = stats.slabheaps[i];
+        slabheap_stats.slab_size = g_kmalloc_global->slabheaps[i].slab_size();
+        slabheap_stats.cache_hit_count = 0;
+        slabheap_stats.cache_miss_count = 0;
+    }
+
+    // NOTE: The per-processor counters are updated without holding s_lock, so these are only a snapshot.
+    for (auto const& cache : g_kmalloc_processor_caches) {
+        stats.kmalloc_call_count += cache.kmalloc_call_count;
+        stats.kfree_call_count += cache.kfree_call_count;
+        for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+            stats.slabheaps[i].cache_hit_count += cache.magazines[i].hit_count;
+            stats.slabheaps[i].cache_miss_count += cache.magazines[i].miss_count;
+        }
+    }
 }
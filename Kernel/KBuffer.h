@@ -42,6 +42,7 @@ public:
     [[nodiscard]] u8 const* data() const { return m_region->vaddr().as_ptr(); }
     [[nodiscard]] size_t size() const { return m_size; }
     [[nodiscard]] size_t capacity() const { return m_region->size(); }
+    [[nodiscard]] StringView name() const { return m_region->name(); }
 
     [[nodiscard]] ReadonlyBytes bytes() const { return { data(), size() }; }
     [[nodiscard]] Bytes bytes() { return { data(), size() }; }
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/HashFunctions.h>
 #include <Kernel/Debug.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Locking/LockLocation.h>
@@ -16,6 +17,101 @@ extern bool g_in_early_boot;
 
 namespace Kernel {
 
+// How many times we re-check a contended mutex before giving up and blocking.
+static constexpr size_t max_spin_iterations = 1000;
+
+namespace {
+struct ContentionBucket {
+    Atomic<char const*> name_characters { nullptr };
+    Atomic<size_t> name_length { 0 };
+    Atomic<u64> contended_count { 0 };
+    Atomic<u64> acquired_by_spinning_count { 0 };
+    Atomic<u64> blocked_count { 0 };
+};
+}
+
+static constexpr size_t contention_bucket_count = 256;
+static ContentionBucket s_contention_buckets[contention_bucket_count];
+
+static ContentionBucket* contention_bucket_for(StringView name)
+{
+    if (name.is_empty())
+        name = "(unnamed)"sv;
+    // Mutex names are string literals, so the characters pointer is a good enough key.
+    auto const* key = name.characters_without_null_termination();
+    auto start = ptr_hash(key) % contention_bucket_count;
+    for (size_t i = 0; i < contention_bucket_count; ++i) {
+        auto& bucket = s_contention_buckets[(start + i) % contention_bucket_count];
+        auto const* existing_key = bucket.name_characters.load(AK::MemoryOrder::memory_order_acquire);
+        if (existing_key == key)
+            return &bucket;
+        if (existing_key)
+            continue;
+        char const* expected = nullptr;
+        if (bucket.name_characters.compare_exchange_strong(expected, key, AK::MemoryOrder::memory_order_acq_rel)) {
+            bucket.name_length.store(name.length(), AK::MemoryOrder::memory_order_release);
+            return &bucket;
+        }
+        if (expected == key)
+            return &bucket;
+    }
+    // The table is full, so this name goes untracked.
+    return nullptr;
+}
+
+ErrorOr<void> Mutex::try_for_each_contention_statistics(Function<ErrorOr<void>(ContentionStatistics const&)> callback)
+{
+    for (auto& bucket : s_contention_buckets) {
+        auto const* name_characters = bucket.name_characters.load(AK::MemoryOrder::memory_order_acquire);
+        if (!name_characters)
+            continue;
+        ContentionStatistics statistics {
+            StringView { name_characters, bucket.name_length.load(AK::MemoryOrder::memory_order_acquire) },
+            bucket.contended_count.load(AK::MemoryOrder::memory_order_relaxed),
+            bucket.acquired_by_spinning_count.load(AK::MemoryOrder::memory_order_relaxed),
+            bucket.blocked_count.load(AK::MemoryOrder::memory_order_relaxed),
+        };
+        TRY(callback(statistics));
+    }
+    return {};
+}
+
+bool Mutex::would_block(Thread* current_thread, Mode mode) const
+{
+    VERIFY(m_lock.is_locked());
+    if (m_mode == Mode::Exclusive)
+        return m_holder != current_thread;
+    if (m_mode == Mode::Shared)
+        return mode == Mode::Exclusive;
+    return false;
+}
+
+void Mutex::spin_while_holder_is_running(Thread* current_thread, Mode mode, SpinlockLocker<Spinlock<LockRank::None>>& lock)
+{
+    auto* bucket = contention_bucket_for(m_name);
+    if (bucket)
+        bucket->contended_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+
+    // FIXME: remove this after annihilating Process::m_big_lock
+    if (m_behavior == MutexBehavior::BigLock)
+        return;
+
+    // Most of our mutexes are only held for a short while, so as long as the holder is
+    // running on another processor it's cheaper to wait for it than to block and be woken.
+    for (size_t i = 0; i < max_spin_iterations; ++i) {
+        if (m_mode != Mode::Exclusive || !m_holder || m_holder->state() != Thread::State::Running)
+            return;
+        lock.unlock();
+        Processor::pause();
+        lock.lock();
+        if (!would_block(current_thread, mode)) {
+            if (bucket)
+                bucket->acquired_by_spinning_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
 void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
 {
     // NOTE: This may be called from an interrupt handler (not an IRQ handler)
@@ -30,6 +126,9 @@ void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
     auto* current_thread = Thread::current();
 
     SpinlockLocker lock(m_lock);
+    if (would_block(current_thread, mode)) [[unlikely]]
+        spin_while_holder_is_running(current_thread, mode, lock);
+
     bool did_block = false;
     Mode current_mode = m_mode;
     switch (current_mode) {
@@ -218,6 +317,9 @@ void Mutex::block(Thread& current_thread, Mode mode, SpinlockLocker<Spinlock<Loc
         if (!g_in_early_boot)
             VERIFY_INTERRUPTS_ENABLED();
     }
+    if (auto* bucket = contention_bucket_for(m_name))
+        bucket->blocked_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+
     m_blocked_thread_lists.with([&](auto& lists) {
         auto append_to_list = [&]<typename L>(L& list) {
             VERIFY(!list.contains(current_thread));
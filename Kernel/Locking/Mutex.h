@@ -9,6 +9,7 @@
 
 #include <AK/Assertions.h>
 #include <AK/Atomic.h>
+#include <AK/Function.h>
 #include <AK/HashMap.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
@@ -76,6 +77,16 @@ public:
         }
     }
 
+    // Contention is tracked per mutex name, so all instances of e.g. "Inode" share one entry.
+    struct ContentionStatistics {
+        StringView name;
+        u64 contended_count { 0 };
+        u64 acquired_by_spinning_count { 0 };
+        u64 blocked_count { 0 };
+    };
+
+    static ErrorOr<void> try_for_each_contention_statistics(Function<ErrorOr<void>(ContentionStatistics const&)>);
+
 private:
     using BlockedThreadList = IntrusiveList<&Thread::m_blocked_threads_list_node>;
 
@@ -84,6 +95,8 @@ private:
 
     // FIXME: Allow any lock rank.
     void block(Thread&, Mode, SpinlockLocker<Spinlock<LockRank::None>>&, u32);
+    [[nodiscard]] bool would_block(Thread*, Mode) const;
+    void spin_while_holder_is_running(Thread*, Mode, SpinlockLocker<Spinlock<LockRank::None>>&);
     void unblock_waiters(Mode);
 
     StringView m_name;
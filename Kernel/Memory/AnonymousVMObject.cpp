@@ -276,6 +276,41 @@ NonnullRefPtr<PhysicalPage> AnonymousVMObject::allocate_committed_page(Badge<Reg
     return m_unused_committed_pages->take_one();
 }
 
+void AnonymousVMObject::allocate_committed_pages(Badge<Region>, Span<RefPtr<PhysicalPage>> pages)
+{
+    m_unused_committed_pages->take(pages);
+}
+
+bool AnonymousVMObject::can_install_huge_page(size_t first_page_index) const
+{
+    VERIFY(m_lock.is_locked_by_current_processor());
+    if (m_purgeable || !m_cow_parent.is_null() || m_shared_committed_cow_pages)
+        return false;
+    if (first_page_index + HUGE_PAGE_SIZE / PAGE_SIZE > page_count())
+        return false;
+    for (size_t i = 0; i < HUGE_PAGE_SIZE / PAGE_SIZE; ++i) {
+        auto const& page = physical_pages()[first_page_index + i];
+        if (!page || !(page->is_shared_zero_page() || page->is_lazy_committed_page()))
+            return false;
+    }
+    return true;
+}
+
+void AnonymousVMObject::install_huge_page(Badge<Region>, size_t first_page_index, NonnullRefPtrVector<PhysicalPage> const& pages)
+{
+    VERIFY(m_lock.is_locked_by_current_processor());
+    VERIFY(pages.size() == HUGE_PAGE_SIZE / PAGE_SIZE);
+    for (size_t i = 0; i < pages.size(); ++i) {
+        auto& page_slot = physical_pages()[first_page_index + i];
+        // The fresh pages came out of the uncommitted pool, so hand back what we had reserved for this slot.
+        if (page_slot->is_lazy_committed_page())
+            m_unused_committed_pages->uncommit_one();
+        page_slot = pages.ptr_at(i);
+        if (!m_cow_map.is_null())
+            m_cow_map.set(first_page_index + i, false);
+    }
+}
+
 ErrorOr<void> AnonymousVMObject::ensure_cow_map()
 {
     if (m_cow_map.is_null())
@@ -309,6 +344,50 @@ ErrorOr<void> AnonymousVMObject::set_should_cow(size_t page_index, bool cow)
     return {};
 }
 
+ErrorOr<void> AnonymousVMObject::share_pages_copy_on_write(size_t first_page_index, size_t count, NonnullRefPtrVector<PhysicalPage>& pages)
+{
+    VERIFY(first_page_index + count <= page_count());
+    TRY(pages.try_ensure_capacity(pages.size() + count));
+
+    SpinlockLocker lock(m_lock);
+
+    if (is_purgeable())
+        return EAGAIN;
+
+    for (size_t i = 0; i < count; ++i) {
+        auto const& page = physical_pages()[first_page_index + i];
+        if (!page || page->is_shared_zero_page() || page->is_lazy_committed_page())
+            return EAGAIN;
+    }
+
+    // Shared mappings never COW, so writes through them would show up on the other end.
+    bool is_mapped_shared = false;
+    for_each_region([&](auto& region) {
+        if (region.is_shared())
+            is_mapped_shared = true;
+    });
+    if (is_mapped_shared)
+        return EAGAIN;
+
+    TRY(ensure_cow_map());
+
+    auto first_shared_page = pages.size();
+    for (size_t i = 0; i < count; ++i) {
+        m_cow_map.set(first_page_index + i, true);
+        pages.unchecked_append(*physical_pages()[first_page_index + i]);
+    }
+
+    // Drop write access from the existing mappings, the next write will fault and copy (or simply
+    // get its access back if nobody else holds on to the page anymore).
+    for_each_region([&](auto& region) {
+        for (size_t i = 0; i < count; ++i) {
+            // NOTE: This only fails if there was no page table to begin with, in which case there's no mapping to update either.
+            (void)region.remap_vmobject_page(first_page_index + i, pages.ptr_at(first_shared_page + i));
+        }
+    });
+    return {};
+}
+
 size_t AnonymousVMObject::cow_pages() const
 {
     if (m_cow_map.is_null())
@@ -26,11 +26,19 @@ public:
     virtual ErrorOr<NonnullLockRefPtr<VMObject>> try_clone() override;
 
     [[nodiscard]] NonnullRefPtr<PhysicalPage> allocate_committed_page(Badge<Region>);
+    void allocate_committed_pages(Badge<Region>, Span<RefPtr<PhysicalPage>>);
+    [[nodiscard]] bool can_install_huge_page(size_t first_page_index) const;
+    void install_huge_page(Badge<Region>, size_t first_page_index, NonnullRefPtrVector<PhysicalPage> const&);
     PageFaultResponse handle_cow_fault(size_t, VirtualAddress);
     size_t cow_pages() const;
     bool should_cow(size_t page_index, bool) const;
     ErrorOr<void> set_should_cow(size_t page_index, bool);
 
+    // Marks the pages copy-on-write in every region mapping them and hands out references to them,
+    // so their current contents can be passed on without copying. Fails with EAGAIN if any of them
+    // isn't backed by a page of its own yet, or is mapped shared.
+    ErrorOr<void> share_pages_copy_on_write(size_t first_page_index, size_t page_count, NonnullRefPtrVector<PhysicalPage>&);
+
     bool is_purgeable() const { return m_purgeable; }
     bool is_volatile() const { return m_volatile; }
 
@@ -567,6 +567,12 @@ PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress
     u32 page_table_index = (vaddr.get() >> 12) & 0x1ff;
 
     auto* pd = quickmap_pd(const_cast<PageDirectory&>(page_directory), page_directory_table_index);
+#if ARCH(X86_64)
+    if (pd[page_directory_index].is_present() && pd[page_directory_index].is_huge()) {
+        demote_huge_page(page_directory, vaddr);
+        pd = quickmap_pd(page_directory, page_directory_table_index);
+    }
+#endif
     PageDirectoryEntry const& pde = pd[page_directory_index];
     if (!pde.is_present())
         return nullptr;
@@ -583,6 +589,12 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
     u32 page_table_index = (vaddr.get() >> 12) & 0x1ff;
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+#if ARCH(X86_64)
+    if (pd[page_directory_index].is_present() && pd[page_directory_index].is_huge()) {
+        demote_huge_page(page_directory, vaddr);
+        pd = quickmap_pd(page_directory, page_directory_table_index);
+    }
+#endif
     auto& pde = pd[page_directory_index];
     if (pde.is_present())
         return &quickmap_pt(PhysicalAddress(pde.page_table_base()))[page_table_index];
@@ -625,6 +637,15 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     PageDirectoryEntry& pde = pd[page_directory_index];
+#if ARCH(X86_64)
+    if (pde.is_present() && pde.is_huge()) {
+        // The backing pages belong to the VMObject, so dropping the whole huge mapping is safe.
+        // Any part of it that is still mapped by a region is simply faulted back in.
+        pde.clear();
+        flush_tlb(&page_directory, VirtualAddress { vaddr.get() & ~(HUGE_PAGE_SIZE - 1) }, HUGE_PAGE_SIZE / PAGE_SIZE);
+        return;
+    }
+#endif
     if (pde.is_present()) {
         auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
         auto& pte = page_table[page_table_index];
@@ -648,6 +669,105 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     }
 }
 
+bool MemoryManager::map_huge_page(PageDirectory& page_directory, VirtualAddress vaddr, PhysicalAddress paddr, bool writable, bool executable)
+{
+#if ARCH(X86_64)
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY(!(vaddr.get() % HUGE_PAGE_SIZE));
+    VERIFY(!(paddr.get() % HUGE_PAGE_SIZE));
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    if (pde.is_present() && !pde.is_huge()) {
+        // Every PTE in this page table maps the range we're about to cover, so the table can go.
+        auto page_table_paddr = PhysicalAddress { pde.page_table_base() };
+        pde.clear();
+        get_physical_page_entry(page_table_paddr).allocated.physical_page.unref();
+    }
+
+    pde.clear();
+    pde.set_page_table_base(paddr.get());
+    pde.set_huge(true);
+    pde.set_user_allowed(true);
+    pde.set_writable(writable);
+    if (Processor::current().has_nx())
+        pde.set_execute_disabled(!executable);
+    pde.set_present(true);
+
+    flush_tlb(&page_directory, vaddr, HUGE_PAGE_SIZE / PAGE_SIZE);
+    m_huge_page_promotions.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    return true;
+#else
+    (void)page_directory;
+    (void)vaddr;
+    (void)paddr;
+    (void)writable;
+    (void)executable;
+    return false;
+#endif
+}
+
+void MemoryManager::demote_huge_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+#if ARCH(X86_64)
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    auto huge_page_vaddr = VirtualAddress { vaddr.get() & ~(HUGE_PAGE_SIZE - 1) };
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto huge_pde = quickmap_pd(page_directory, page_directory_table_index)[page_directory_index];
+    VERIFY(huge_pde.is_present() && huge_pde.is_huge());
+
+    m_huge_page_demotions.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+
+    auto page_table_or_error = allocate_physical_page(ShouldZeroFill::No);
+    // NOTE: Allocating may have purged memory and remapped the pd, so look it up again.
+    auto& pde = quickmap_pd(page_directory, page_directory_table_index)[page_directory_index];
+    if (page_table_or_error.is_error()) {
+        // We can't split the mapping, so drop it instead. The pages stay in their VMObject
+        // and get faulted back in one at a time.
+        dbgln("MM: Unable to allocate page table to split huge page at {}", huge_page_vaddr);
+        pde.clear();
+        flush_tlb(&page_directory, huge_page_vaddr, HUGE_PAGE_SIZE / PAGE_SIZE);
+        return;
+    }
+    auto page_table = page_table_or_error.release_value();
+
+    auto* ptes = quickmap_pt(page_table->paddr());
+    for (size_t i = 0; i < HUGE_PAGE_SIZE / PAGE_SIZE; ++i) {
+        auto& pte = ptes[i];
+        pte.clear();
+        pte.set_physical_page_base(huge_pde.page_table_base() + i * PAGE_SIZE);
+        pte.set_cache_disabled(huge_pde.is_cache_disabled());
+        pte.set_writable(huge_pde.is_writable());
+        pte.set_user_allowed(huge_pde.is_user_allowed());
+        if (Processor::current().has_nx())
+            pte.set_execute_disabled(huge_pde.is_execute_disabled());
+        pte.set_present(true);
+    }
+
+    pde.clear();
+    pde.set_page_table_base(page_table->paddr().get());
+    pde.set_user_allowed(true);
+    pde.set_present(true);
+    pde.set_writable(true);
+    pde.set_global(&page_directory == m_kernel_page_directory.ptr());
+
+    // NOTE: This leaked ref is matched by the unref in MemoryManager::release_pte()
+    (void)page_table.leak_ref();
+
+    flush_tlb(&page_directory, huge_page_vaddr, HUGE_PAGE_SIZE / PAGE_SIZE);
+#else
+    (void)page_directory;
+    (void)vaddr;
+    VERIFY_NOT_REACHED();
+#endif
+}
+
 UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
 {
     dmesgln("Initialize MMU");
@@ -911,9 +1031,17 @@ void MemoryManager::deallocate_physical_page(PhysicalAddress paddr)
     });
 }
 
-RefPtr<PhysicalPage> MemoryManager::find_free_physical_page(bool committed)
+PhysicalPage* MemoryManager::take_zeroed_page_from_pool(GlobalData& global_data)
+{
+    if (global_data.zeroed_page_count == 0)
+        return nullptr;
+    return global_data.zeroed_pages[--global_data.zeroed_page_count];
+}
+
+RefPtr<PhysicalPage> MemoryManager::find_free_physical_page(bool committed, ShouldZeroFill should_zero_fill)
 {
     RefPtr<PhysicalPage> page;
+    bool page_is_zeroed = false;
     m_global_data.with([&](auto& global_data) {
         if (committed) {
             // Draw from the committed pages pool. We should always have these pages available
@@ -925,38 +1053,155 @@ RefPtr<PhysicalPage> MemoryManager::find_free_physical_page(bool committed)
                 return;
             global_data.system_memory_info.physical_pages_uncommitted--;
         }
-        for (auto& region : global_data.physical_regions) {
-            page = region.take_free_page();
-            if (!page.is_null()) {
-                ++global_data.system_memory_info.physical_pages_used;
-                break;
+        if (should_zero_fill == ShouldZeroFill::Yes) {
+            if (auto* zeroed_page = take_zeroed_page_from_pool(global_data)) {
+                page = adopt_ref(*zeroed_page);
+                page_is_zeroed = true;
+            }
+        }
+        if (page.is_null()) {
+            for (auto& region : global_data.physical_regions) {
+                page = region.take_free_page();
+                if (!page.is_null())
+                    break;
+            }
+        }
+        // The pool pages are still accounted as free, so fall back to them if the regions ran dry.
+        if (page.is_null()) {
+            if (auto* zeroed_page = take_zeroed_page_from_pool(global_data)) {
+                page = adopt_ref(*zeroed_page);
+                page_is_zeroed = true;
             }
         }
+        if (!page.is_null())
+            ++global_data.system_memory_info.physical_pages_used;
     });
 
-    if (page.is_null())
+    if (page.is_null()) {
         dbgln("MM: couldn't find free physical page. Continuing...");
+        return page;
+    }
 
+    if (should_zero_fill == ShouldZeroFill::Yes) {
+        if (page_is_zeroed) {
+            m_zeroed_page_pool_hits.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        } else {
+            m_zeroed_page_pool_misses.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            InterruptDisabler disabler;
+            auto* ptr = quickmap_page(*page);
+            memset(ptr, 0, PAGE_SIZE);
+            unquickmap_page();
+        }
+    }
     return page;
 }
 
 NonnullRefPtr<PhysicalPage> MemoryManager::allocate_committed_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill should_zero_fill)
 {
-    auto page = find_free_physical_page(true);
+    auto page = find_free_physical_page(true, should_zero_fill);
     VERIFY(page);
+    return page.release_nonnull();
+}
+
+void MemoryManager::allocate_committed_physical_pages(Badge<CommittedPhysicalPageSet>, Span<RefPtr<PhysicalPage>> pages, ShouldZeroFill should_zero_fill)
+{
+    // Take all the pages under a single acquisition of the global lock, so that
+    // concurrent faults don't bounce it once per page.
+    size_t zeroed_page_count = 0;
+    m_global_data.with([&](auto& global_data) {
+        VERIFY(global_data.system_memory_info.physical_pages_committed >= pages.size());
+        global_data.system_memory_info.physical_pages_committed -= pages.size();
+        for (auto& page : pages) {
+            // Pre-zeroed pages go first, so only the tail of the span needs zeroing below.
+            if (should_zero_fill == ShouldZeroFill::Yes) {
+                if (auto* zeroed_page = take_zeroed_page_from_pool(global_data)) {
+                    page = adopt_ref(*zeroed_page);
+                    ++zeroed_page_count;
+                }
+            }
+            if (page.is_null()) {
+                for (auto& region : global_data.physical_regions) {
+                    page = region.take_free_page();
+                    if (!page.is_null())
+                        break;
+                }
+            }
+            if (page.is_null()) {
+                if (auto* zeroed_page = take_zeroed_page_from_pool(global_data))
+                    page = adopt_ref(*zeroed_page);
+            }
+            VERIFY(page);
+            ++global_data.system_memory_info.physical_pages_used;
+        }
+    });
+
     if (should_zero_fill == ShouldZeroFill::Yes) {
-        InterruptDisabler disabler;
-        auto* ptr = quickmap_page(*page);
-        memset(ptr, 0, PAGE_SIZE);
-        unquickmap_page();
+        m_zeroed_page_pool_hits.fetch_add(zeroed_page_count, AK::MemoryOrder::memory_order_relaxed);
+        m_zeroed_page_pool_misses.fetch_add(pages.size() - zeroed_page_count, AK::MemoryOrder::memory_order_relaxed);
+        for (auto& page : pages.slice(zeroed_page_count)) {
+            InterruptDisabler disabler;
+            auto* ptr = quickmap_page(*page);
+            memset(ptr, 0, PAGE_SIZE);
+            unquickmap_page();
+        }
     }
-    return page.release_nonnull();
+}
+
+bool MemoryManager::zeroed_page_pool_needs_refill()
+{
+    return m_global_data.with([&](auto& global_data) {
+        return global_data.zeroed_page_count < zeroed_page_pool_low_watermark;
+    });
+}
+
+void MemoryManager::refill_zeroed_page_pool()
+{
+    for (;;) {
+        auto page = m_global_data.with([&](auto& global_data) -> RefPtr<PhysicalPage> {
+            if (global_data.zeroed_page_count >= zeroed_page_pool_high_watermark)
+                return nullptr;
+            // Don't hoard pages when memory is getting tight, we'd only fragment the zones further.
+            auto const& info = global_data.system_memory_info;
+            if (info.physical_pages - info.physical_pages_used < 4 * zeroed_page_pool_high_watermark)
+                return nullptr;
+            for (auto& region : global_data.physical_regions) {
+                if (auto page = region.take_free_page())
+                    return page;
+            }
+            return nullptr;
+        });
+        if (!page)
+            return;
+
+        {
+            InterruptDisabler disabler;
+            auto* ptr = quickmap_page(*page);
+            memset(ptr, 0, PAGE_SIZE);
+            unquickmap_page();
+        }
+
+        m_global_data.with([&](auto& global_data) {
+            // NOTE: This leaked ref is matched by the adopt_ref() in find_free_physical_page() and friends.
+            VERIFY(global_data.zeroed_page_count < zeroed_page_pool_high_watermark);
+            global_data.zeroed_pages[global_data.zeroed_page_count++] = &page.leak_ref();
+        });
+    }
+}
+
+MemoryManager::ZeroedPagePoolStatistics MemoryManager::get_zeroed_page_pool_statistics()
+{
+    auto size = m_global_data.with([&](auto& global_data) { return global_data.zeroed_page_count; });
+    return {
+        size,
+        m_zeroed_page_pool_hits.load(AK::MemoryOrder::memory_order_relaxed),
+        m_zeroed_page_pool_misses.load(AK::MemoryOrder::memory_order_relaxed),
+    };
 }
 
 ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge)
 {
     return m_global_data.with([&](auto&) -> ErrorOr<NonnullRefPtr<PhysicalPage>> {
-        auto page = find_free_physical_page(false);
+        auto page = find_free_physical_page(false, should_zero_fill);
         bool purged_pages = false;
 
         if (!page) {
@@ -970,7 +1215,7 @@ ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_physical_page(Shoul
                     return IterationDecision::Continue;
                 if (auto purged_page_count = anonymous_vmobject.purge()) {
                     dbgln("MM: Purge saved the day! Purged {} pages from AnonymousVMObject", purged_page_count);
-                    page = find_free_physical_page(false);
+                    page = find_free_physical_page(false, should_zero_fill);
                     purged_pages = true;
                     VERIFY(page);
                     return IterationDecision::Break;
@@ -986,7 +1231,7 @@ ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_physical_page(Shoul
                 auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject);
                 if (auto released_page_count = inode_vmobject.try_release_clean_pages(1)) {
                     dbgln("MM: Clean inode release saved the day! Released {} pages from InodeVMObject", released_page_count);
-                    page = find_free_physical_page(false);
+                    page = find_free_physical_page(false, should_zero_fill);
                     VERIFY(page);
                     return IterationDecision::Break;
                 }
@@ -998,12 +1243,6 @@ ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_physical_page(Shoul
             return ENOMEM;
         }
 
-        if (should_zero_fill == ShouldZeroFill::Yes) {
-            auto* ptr = quickmap_page(*page);
-            memset(ptr, 0, PAGE_SIZE);
-            unquickmap_page();
-        }
-
         if (did_purge)
             *did_purge = purged_pages;
         return page.release_nonnull();
@@ -1039,6 +1278,39 @@ ErrorOr<NonnullRefPtrVector<PhysicalPage>> MemoryManager::allocate_contiguous_ph
     return physical_pages;
 }
 
+ErrorOr<NonnullRefPtrVector<PhysicalPage>> MemoryManager::allocate_huge_physical_pages()
+{
+    constexpr size_t page_count = HUGE_PAGE_SIZE / PAGE_SIZE;
+
+    auto physical_pages_or_error = m_global_data.with([&](auto& global_data) -> ErrorOr<NonnullRefPtrVector<PhysicalPage>> {
+        if (global_data.system_memory_info.physical_pages_uncommitted < page_count)
+            return ENOMEM;
+
+        for (auto& physical_region : global_data.physical_regions) {
+            auto physical_pages = physical_region.take_naturally_aligned_free_pages(page_count);
+            if (!physical_pages.is_empty()) {
+                global_data.system_memory_info.physical_pages_uncommitted -= page_count;
+                global_data.system_memory_info.physical_pages_used += page_count;
+                return physical_pages;
+            }
+        }
+        return ENOMEM;
+    });
+    if (physical_pages_or_error.is_error()) {
+        m_huge_page_allocation_failures.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        return physical_pages_or_error.release_error();
+    }
+
+    auto physical_pages = physical_pages_or_error.release_value();
+    for (auto& physical_page : physical_pages) {
+        InterruptDisabler disabler;
+        auto* ptr = quickmap_page(physical_page);
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+    }
+    return physical_pages;
+}
+
 void MemoryManager::enter_process_address_space(Process& process)
 {
     process.address_space().with([](auto& space) {
@@ -1195,6 +1467,13 @@ NonnullRefPtr<PhysicalPage> CommittedPhysicalPageSet::take_one()
     return MM.allocate_committed_physical_page({}, MemoryManager::ShouldZeroFill::Yes);
 }
 
+void CommittedPhysicalPageSet::take(Span<RefPtr<PhysicalPage>> pages)
+{
+    VERIFY(m_page_count >= pages.size());
+    m_page_count -= pages.size();
+    MM.allocate_committed_physical_pages({}, pages, MemoryManager::ShouldZeroFill::Yes);
+}
+
 void CommittedPhysicalPageSet::uncommit_one()
 {
     VERIFY(m_page_count > 0);
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/Array.h>
+#include <AK/Atomic.h>
 #include <AK/Badge.h>
 #include <AK/Concepts.h>
 #include <AK/HashTable.h>
@@ -28,6 +30,9 @@ namespace Kernel::Memory {
 class PageDirectoryEntry;
 class PageTableEntry;
 
+// Size of the memory covered by a single page directory entry, which is what we map with one huge page.
+static constexpr size_t HUGE_PAGE_SIZE = 512 * PAGE_SIZE;
+
 ErrorOr<FlatPtr> page_round_up(FlatPtr x);
 
 constexpr FlatPtr page_round_down(FlatPtr x)
@@ -93,7 +98,7 @@ struct MemoryManagerData {
 
 // This class represents a set of committed physical pages.
 // When you ask MemoryManager to commit pages for you, you get one of these in return.
-// You can allocate pages from it via `take_one()`
+// You can allocate pages from it via `take_one()`, or several at once via `take()`.
 // It will uncommit any (unallocated) remaining pages when destroyed.
 class CommittedPhysicalPageSet {
     AK_MAKE_NONCOPYABLE(CommittedPhysicalPageSet);
@@ -115,6 +120,7 @@ public:
     size_t page_count() const { return m_page_count; }
 
     [[nodiscard]] NonnullRefPtr<PhysicalPage> take_one();
+    void take(Span<RefPtr<PhysicalPage>>);
     void uncommit_one();
 
     void operator=(CommittedPhysicalPageSet&&) = delete;
@@ -165,8 +171,10 @@ public:
     void uncommit_physical_pages(Badge<CommittedPhysicalPageSet>, size_t page_count);
 
     NonnullRefPtr<PhysicalPage> allocate_committed_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill = ShouldZeroFill::Yes);
+    void allocate_committed_physical_pages(Badge<CommittedPhysicalPageSet>, Span<RefPtr<PhysicalPage>>, ShouldZeroFill = ShouldZeroFill::Yes);
     ErrorOr<NonnullRefPtr<PhysicalPage>> allocate_physical_page(ShouldZeroFill = ShouldZeroFill::Yes, bool* did_purge = nullptr);
     ErrorOr<NonnullRefPtrVector<PhysicalPage>> allocate_contiguous_physical_pages(size_t size);
+    ErrorOr<NonnullRefPtrVector<PhysicalPage>> allocate_huge_physical_pages();
     void deallocate_physical_page(PhysicalAddress);
 
     ErrorOr<NonnullOwnPtr<Region>> allocate_contiguous_kernel_region(size_t, StringView name, Region::Access access, Region::Cacheable = Region::Cacheable::Yes);
@@ -189,6 +197,36 @@ public:
 
     SystemMemoryInfo get_system_memory_info();
 
+    struct HugePageStatistics {
+        u64 promotions { 0 };
+        u64 demotions { 0 };
+        u64 allocation_failures { 0 };
+    };
+
+    // The pool is refilled once it drops below the low watermark, up to the high watermark.
+    static constexpr size_t zeroed_page_pool_low_watermark = 256;
+    static constexpr size_t zeroed_page_pool_high_watermark = 1024;
+
+    void refill_zeroed_page_pool();
+    bool zeroed_page_pool_needs_refill();
+
+    struct ZeroedPagePoolStatistics {
+        size_t size { 0 };
+        u64 hits { 0 };
+        u64 misses { 0 };
+    };
+
+    ZeroedPagePoolStatistics get_zeroed_page_pool_statistics();
+
+    HugePageStatistics get_huge_page_statistics() const
+    {
+        return {
+            m_huge_page_promotions.load(AK::MemoryOrder::memory_order_relaxed),
+            m_huge_page_demotions.load(AK::MemoryOrder::memory_order_relaxed),
+            m_huge_page_allocation_failures.load(AK::MemoryOrder::memory_order_relaxed),
+        };
+    }
+
     template<IteratorFunction<VMObject&> Callback>
     static void for_each_vmobject(Callback callback)
     {
@@ -255,7 +293,8 @@ private:
 
     static Region* find_region_from_vaddr(VirtualAddress);
 
-    RefPtr<PhysicalPage> find_free_physical_page(bool);
+    RefPtr<PhysicalPage> find_free_physical_page(bool committed, ShouldZeroFill = ShouldZeroFill::No);
+    PhysicalPage* take_zeroed_page_from_pool(GlobalData&);
 
     ALWAYS_INLINE u8* quickmap_page(PhysicalPage& page)
     {
@@ -275,6 +314,9 @@ private:
     };
     void release_pte(PageDirectory&, VirtualAddress, IsLastPTERelease);
 
+    bool map_huge_page(PageDirectory&, VirtualAddress, PhysicalAddress, bool writable, bool executable);
+    void demote_huge_page(PageDirectory&, VirtualAddress);
+
     // NOTE: These are outside of GlobalData as they are only assigned on startup,
     //       and then never change. Atomic ref-counting covers that case without
     //       the need for additional synchronization.
@@ -287,6 +329,12 @@ private:
     PhysicalPageEntry* m_physical_page_entries { nullptr };
     size_t m_physical_page_entries_count { 0 };
 
+    Atomic<u64> m_huge_page_promotions { 0 };
+    Atomic<u64> m_huge_page_demotions { 0 };
+    Atomic<u64> m_huge_page_allocation_failures { 0 };
+    Atomic<u64> m_zeroed_page_pool_hits { 0 };
+    Atomic<u64> m_zeroed_page_pool_misses { 0 };
+
     struct GlobalData {
         GlobalData();
 
@@ -300,6 +348,11 @@ private:
         Vector<UsedMemoryRange> used_memory_ranges;
         Vector<PhysicalMemoryRange> physical_memory_ranges;
         Vector<ContiguousReservedMemoryRange> reserved_memory_ranges;
+
+        // Free pages that have already been zeroed by the page zeroing task. They still count as
+        // available in system_memory_info, and each entry holds a leaked reference to its page.
+        Array<PhysicalPage*, zeroed_page_pool_high_watermark> zeroed_pages;
+        size_t zeroed_page_count { 0 };
     };
 
     SpinlockProtected<GlobalData, LockRank::None> m_global_data;
@@ -35,6 +35,7 @@ public:
 
     RefPtr<PhysicalPage> take_free_page();
     NonnullRefPtrVector<PhysicalPage> take_contiguous_free_pages(size_t count);
+    NonnullRefPtrVector<PhysicalPage> take_naturally_aligned_free_pages(size_t count);
     void return_page(PhysicalAddress);
 
 private:
@@ -64,6 +64,30 @@ Optional<PhysicalAddress> PhysicalZone::allocate_block(size_t order)
     return m_base_address.offset(result.value() * ZONE_CHUNK_SIZE);
 }
 
+Optional<PhysicalAddress> PhysicalZone::allocate_naturally_aligned_block(size_t order)
+{
+    size_t block_size_in_bytes = PAGE_SIZE << order;
+    if ((m_base_address.get() % block_size_in_bytes) == 0)
+        return allocate_block(order);
+
+    // Buddy blocks are only aligned relative to the zone base, so carve an aligned
+    // block out of one twice its size and give the unaligned head and tail back.
+    if (order + 1 > max_order)
+        return {};
+    auto double_block = allocate_block(order + 1);
+    if (!double_block.has_value())
+        return {};
+
+    auto double_block_base = double_block.value().get();
+    auto aligned_base = align_up_to(double_block_base, block_size_in_bytes);
+    auto double_block_end = double_block_base + 2 * block_size_in_bytes;
+    for (auto address = double_block_base; address < aligned_base; address += PAGE_SIZE)
+        deallocate_block(PhysicalAddress { address }, 0);
+    for (auto address = aligned_base + block_size_in_bytes; address < double_block_end; address += PAGE_SIZE)
+        deallocate_block(PhysicalAddress { address }, 0);
+    return PhysicalAddress { aligned_base };
+}
+
 Optional<PhysicalZone::ChunkIndex> PhysicalZone::allocate_block_impl(size_t order)
 {
     if (order > max_order)
@@ -27,6 +27,7 @@ public:
     PhysicalZone(PhysicalAddress base, size_t page_count);
 
     Optional<PhysicalAddress> allocate_block(size_t order);
+    Optional<PhysicalAddress> allocate_naturally_aligned_block(size_t order);
     void deallocate_block(PhysicalAddress, size_t order);
 
     void dump() const;
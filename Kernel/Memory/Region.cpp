@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/StringView.h>
 #include <Kernel/Arch/PageDirectory.h>
 #include <Kernel/Arch/PageFault.h>
@@ -132,6 +133,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
     }
     clone_region->set_syscall_region(is_syscall_region());
     clone_region->set_mmap(m_mmap, m_mmapped_from_readable, m_mmapped_from_writable);
+    clone_region->set_huge_pages_disabled(m_huge_pages_disabled);
     return clone_region;
 }
 
@@ -363,6 +365,25 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
             return handle_inode_fault(page_index_in_region);
         }
 
+        RefPtr<PhysicalPage> zero_page;
+        {
+            SpinlockLocker vmobject_locker(vmobject().m_lock);
+            auto& page_slot = physical_page_slot(page_index_in_region);
+            if (page_slot && page_slot->is_shared_zero_page()) {
+                // Regions cloned by fork() start out without page tables, so untouched zero pages end up here.
+                if (fault.is_read()) {
+                    if (!remap_vmobject_page(translate_to_vmobject_page(page_index_in_region), *page_slot))
+                        return PageFaultResponse::OutOfMemory;
+                    return PageFaultResponse::Continue;
+                }
+                zero_page = page_slot;
+            }
+        }
+        if (zero_page) {
+            dbgln_if(PAGE_FAULT_DEBUG, "NP(zero) fault in Region({})[{}] at {}", this, page_index_in_region, fault.vaddr());
+            return handle_zero_fault(page_index_in_region, *zero_page);
+        }
+
         SpinlockLocker vmobject_locker(vmobject().m_lock);
         auto& page_slot = physical_page_slot(page_index_in_region);
         if (page_slot->is_lazy_committed_page()) {
@@ -373,6 +394,14 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
                 return PageFaultResponse::OutOfMemory;
             return PageFaultResponse::Continue;
         }
+        if (page_slot && !page_slot->is_shared_zero_page()) {
+            // The page is resident, but it was never mapped into a region cloned by fork(), or its mapping
+            // was dropped along with a huge page we couldn't split.
+            dbgln_if(PAGE_FAULT_DEBUG, "NP(resident) fault in Region({})[{}] at {}", this, page_index_in_region, fault.vaddr());
+            if (!remap_vmobject_page(translate_to_vmobject_page(page_index_in_region), *page_slot))
+                return PageFaultResponse::OutOfMemory;
+            return PageFaultResponse::Continue;
+        }
         dbgln("BUG! Unexpected NP fault at {}", fault.vaddr());
         dbgln("     - Physical page slot pointer: {:p}", page_slot.ptr());
         if (page_slot) {
@@ -406,6 +435,12 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     if (current_thread != nullptr)
         current_thread->did_zero_fault();
 
+    if (try_map_huge_page(page_index_in_region))
+        return PageFaultResponse::Continue;
+
+    if (page_in_slot_at_time_of_fault.is_lazy_committed_page())
+        return handle_lazy_committed_fault_around(page_index_in_region);
+
     RefPtr<PhysicalPage> new_physical_page;
 
     if (page_in_slot_at_time_of_fault.is_lazy_committed_page()) {
@@ -444,6 +479,104 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     return PageFaultResponse::Continue;
 }
 
+static constexpr size_t fault_around_page_count = 16;
+
+PageFaultResponse Region::handle_lazy_committed_fault_around(size_t page_index_in_region)
+{
+    VERIFY(vmobject().is_anonymous());
+    auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject());
+
+    // These pages are already committed to us, so populating the neighbors of the faulting page
+    // costs nothing extra and saves taking a fault (and the page directory lock) for each of them.
+    auto window_vaddr = VirtualAddress { vaddr_from_page_index(page_index_in_region).get() & ~(fault_around_page_count * PAGE_SIZE - 1) };
+    auto window_end_vaddr = window_vaddr.offset(fault_around_page_count * PAGE_SIZE);
+    size_t first_page_index = window_vaddr < vaddr() ? 0 : page_index_from_address(window_vaddr);
+    size_t end_page_index = window_end_vaddr >= range().end() ? page_count() : page_index_from_address(window_end_vaddr);
+
+    Array<size_t, fault_around_page_count> page_indices;
+    Array<RefPtr<PhysicalPage>, fault_around_page_count> new_pages;
+    size_t new_page_count = 0;
+    {
+        SpinlockLocker locker(vmobject().m_lock);
+        if (physical_page_slot(page_index_in_region)->is_lazy_committed_page()) {
+            for (size_t i = first_page_index; i < end_page_index; ++i) {
+                if (physical_page_slot(i)->is_lazy_committed_page())
+                    page_indices[new_page_count++] = i;
+            }
+            anonymous_vmobject.allocate_committed_pages({}, new_pages.span().trim(new_page_count));
+            for (size_t i = 0; i < new_page_count; ++i)
+                physical_page_slot(page_indices[i]) = new_pages[i];
+        }
+    }
+
+    if (new_page_count == 0) {
+        // Someone else already faulted in a new page in this slot. That's fine, we'll just remap with their page.
+        RefPtr<PhysicalPage> page;
+        {
+            SpinlockLocker locker(vmobject().m_lock);
+            page = physical_page_slot(page_index_in_region);
+        }
+        if (!remap_vmobject_page(translate_to_vmobject_page(page_index_in_region), page.release_nonnull()))
+            return PageFaultResponse::OutOfMemory;
+        return PageFaultResponse::Continue;
+    }
+
+    dbgln_if(PAGE_FAULT_DEBUG, "      >> ALLOCATED {} COMMITTED PAGES AROUND {}", new_page_count, vaddr_from_page_index(page_index_in_region));
+
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    for (size_t i = 0; i < new_page_count; ++i) {
+        if (!map_individual_page_impl(page_indices[i], new_pages[i])) {
+            MemoryManager::flush_tlb(m_page_directory, vaddr_from_page_index(first_page_index), end_page_index - first_page_index);
+            dmesgln("MM: handle_zero_fault was unable to allocate a page table to map {}", new_pages[i]);
+            return PageFaultResponse::OutOfMemory;
+        }
+    }
+    MemoryManager::flush_tlb(m_page_directory, vaddr_from_page_index(first_page_index), end_page_index - first_page_index);
+    return PageFaultResponse::Continue;
+}
+
+bool Region::try_map_huge_page(size_t page_index_in_region)
+{
+#if ARCH(X86_64)
+    if (!is_user() || m_shared || m_stack || m_huge_pages_disabled || !m_cacheable || m_write_combine || !is_writable())
+        return false;
+
+    // Only a fully covered, naturally aligned 2 MiB slice of the region can be backed by a huge page.
+    auto huge_page_vaddr = VirtualAddress { vaddr_from_page_index(page_index_in_region).get() & ~(HUGE_PAGE_SIZE - 1) };
+    if (huge_page_vaddr < vaddr() || huge_page_vaddr.offset(HUGE_PAGE_SIZE) > vaddr().offset(size()))
+        return false;
+    auto first_page_index_in_region = page_index_from_address(huge_page_vaddr);
+    auto first_page_index_in_vmobject = translate_to_vmobject_page(first_page_index_in_region);
+
+    auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject());
+    {
+        SpinlockLocker locker(vmobject().m_lock);
+        if (!anonymous_vmobject.can_install_huge_page(first_page_index_in_vmobject))
+            return false;
+    }
+
+    auto pages_or_error = MM.allocate_huge_physical_pages();
+    if (pages_or_error.is_error())
+        return false;
+    auto pages = pages_or_error.release_value();
+
+    {
+        SpinlockLocker locker(vmobject().m_lock);
+        // Someone else may have faulted in part of this range while we were allocating.
+        if (!anonymous_vmobject.can_install_huge_page(first_page_index_in_vmobject))
+            return false;
+        anonymous_vmobject.install_huge_page({}, first_page_index_in_vmobject, pages);
+    }
+
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    dbgln_if(PAGE_FAULT_DEBUG, "      >> HUGE PAGE {} at {}", pages[0].paddr(), huge_page_vaddr);
+    return MM.map_huge_page(*m_page_directory, huge_page_vaddr, pages[0].paddr(), is_writable(), is_executable());
+#else
+    (void)page_index_in_region;
+    return false;
+#endif
+}
+
 PageFaultResponse Region::handle_cow_fault(size_t page_index_in_region)
 {
     auto current_thread = Thread::current();
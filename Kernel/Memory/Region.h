@@ -33,6 +33,7 @@ enum class ShouldFlushTLB {
 class Region final
     : public LockWeakable<Region> {
     friend class AddressSpace;
+    friend class AnonymousVMObject;
     friend class MemoryManager;
     friend class RegionTree;
 
@@ -207,6 +208,9 @@ public:
     [[nodiscard]] bool mmapped_from_readable() const { return m_mmapped_from_readable; }
     [[nodiscard]] bool mmapped_from_writable() const { return m_mmapped_from_writable; }
 
+    [[nodiscard]] bool are_huge_pages_disabled() const { return m_huge_pages_disabled; }
+    void set_huge_pages_disabled(bool b) { m_huge_pages_disabled = b; }
+
 private:
     Region();
     Region(NonnullLockRefPtr<VMObject>, size_t offset_in_vmobject, OwnPtr<KString>, Region::Access access, Cacheable, bool shared);
@@ -225,6 +229,8 @@ private:
     [[nodiscard]] PageFaultResponse handle_cow_fault(size_t page_index);
     [[nodiscard]] PageFaultResponse handle_inode_fault(size_t page_index);
     [[nodiscard]] PageFaultResponse handle_zero_fault(size_t page_index, PhysicalPage& page_in_slot_at_time_of_fault);
+    [[nodiscard]] PageFaultResponse handle_lazy_committed_fault_around(size_t page_index);
+    [[nodiscard]] bool try_map_huge_page(size_t page_index);
 
     [[nodiscard]] bool map_individual_page_impl(size_t page_index);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, RefPtr<PhysicalPage>);
@@ -244,6 +250,7 @@ private:
     bool m_write_combine : 1 { false };
     bool m_mmapped_from_readable : 1 { false };
     bool m_mmapped_from_writable : 1 { false };
+    bool m_huge_pages_disabled : 1 { false };
 
     IntrusiveRedBlackTreeNode<FlatPtr, Region, RawPtr<Region>> m_tree_node;
     IntrusiveListNode<Region> m_vmobject_list_node;
@@ -22,6 +22,7 @@
 #include <Kernel/Net/UDP.h>
 #include <Kernel/Net/UDPSocket.h>
 #include <Kernel/Process.h>
+#include <Kernel/Tracepoints.h>
 #include <Kernel/UnixTypes.h>
 
 namespace Kernel {
@@ -408,8 +409,10 @@ ErrorOr<size_t> IPv4Socket::recvfrom(OpenFileDescription& description, UserOrKer
             total_nreceived.value() += nreceived.value();
     } while ((flags & MSG_WAITALL) && !total_nreceived.is_error() && total_nreceived.value() < buffer_length);
 
-    if (!total_nreceived.is_error())
+    if (!total_nreceived.is_error()) {
         Thread::current()->did_ipv4_socket_read(total_nreceived.value());
+        Tracepoints::emit(TracepointType::SocketDequeue, bit_cast<FlatPtr>(this), total_nreceived.value(), AF_INET);
+    }
     return total_nreceived;
 }
 
@@ -457,6 +460,7 @@ bool IPv4Socket::did_receive(IPv4Address const& source_address, u16 source_port,
         set_can_read(true);
     }
     m_bytes_received += packet_size;
+    Tracepoints::emit(TracepointType::SocketEnqueue, bit_cast<FlatPtr>(this), packet_size, AF_INET);
 
     if constexpr (IPV4_SOCKET_DEBUG) {
         if (buffer_mode() == BufferMode::Bytes)
@@ -504,10 +508,10 @@ ErrorOr<NonnullOwnPtr<KString>> IPv4Socket::pseudo_path(OpenFileDescription cons
     return KString::try_create(builder.string_view());
 }
 
-ErrorOr<void> IPv4Socket::setsockopt(int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
+ErrorOr<void> IPv4Socket::setsockopt(OpenFileDescription& description, int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
 {
     if (level != IPPROTO_IP)
-        return Socket::setsockopt(level, option, user_value, user_value_size);
+        return Socket::setsockopt(description, level, option, user_value, user_value_size);
 
     MutexLocker locker(mutex());
 
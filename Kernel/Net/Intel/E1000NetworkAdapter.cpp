@@ -8,6 +8,7 @@
 #include <Kernel/Bus/PCI/API.h>
 #include <Kernel/Bus/PCI/IDs.h>
 #include <Kernel/Debug.h>
+#include <Kernel/Net/EtherType.h>
 #include <Kernel/Net/Intel/E1000NetworkAdapter.h>
 #include <Kernel/Net/NetworkingManagement.h>
 #include <Kernel/Sections.h>
@@ -400,6 +401,19 @@ u32 E1000NetworkAdapter::in32(u16 address)
     return m_registers_io_window->read32(address);
 }
 
+static Optional<u8> tcp_header_offset(ReadonlyBytes frame)
+{
+    if (frame.size() < sizeof(EthernetFrameHeader) + sizeof(IPv4Packet))
+        return {};
+    auto const& ethernet_frame = *reinterpret_cast<EthernetFrameHeader const*>(frame.data());
+    if (ethernet_frame.ether_type() != EtherType::IPv4)
+        return {};
+    auto const& ipv4_packet = *reinterpret_cast<IPv4Packet const*>(ethernet_frame.payload());
+    if (ipv4_packet.protocol() != (u8)IPv4Protocol::TCP || ipv4_packet.is_a_fragment())
+        return {};
+    return sizeof(EthernetFrameHeader) + sizeof(IPv4Packet);
+}
+
 void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
 {
     disable_irq();
@@ -413,6 +427,15 @@ void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
     descriptor.length = payload.size();
     descriptor.status = 0;
     descriptor.cmd = CMD_EOP | CMD_IFCS | CMD_RS;
+    descriptor.css = 0;
+    descriptor.cso = 0;
+    if (auto tcp_offset = tcp_header_offset(payload); tcp_offset.has_value()) {
+        // Let the hardware sum up everything from the TCP header to the end of the frame and
+        // store it in the TCP checksum field, which the TCP stack seeded with the pseudo-header sum.
+        descriptor.css = tcp_offset.value();
+        descriptor.cso = tcp_offset.value() + 16;
+        descriptor.cmd = descriptor.cmd | CMD_IC;
+    }
     dbgln_if(E1000_DEBUG, "E1000: Using tx descriptor {} (head is at {})", tx_current, in32(REG_TXDESCHEAD));
     tx_current = (tx_current + 1) % number_of_tx_descriptors;
     Processor::disable_interrupts();
@@ -30,6 +30,7 @@ public:
     virtual bool link_up() override { return m_link_up; };
     virtual i32 link_speed() override;
     virtual bool link_full_duplex() override;
+    virtual bool supports_tcp_checksum_offload() const override { return true; }
 
     virtual StringView purpose() const override { return class_name(); }
     virtual StringView device_name() const override { return "E1000"sv; }
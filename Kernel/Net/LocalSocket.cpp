@@ -13,15 +13,24 @@
 #include <Kernel/FileSystem/VirtualFileSystem.h>
 #include <Kernel/Locking/Mutex.h>
 #include <Kernel/Locking/MutexProtected.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
 #include <Kernel/Net/LocalSocket.h>
 #include <Kernel/Process.h>
 #include <Kernel/StdLib.h>
+#include <Kernel/Tracepoints.h>
 #include <Kernel/UnixTypes.h>
 
 namespace Kernel {
 
 static Singleton<MutexProtected<LocalSocket::List>> s_list;
 
+// Writes at least this large hand over the pages of the sender's buffer instead of copying them into the socket buffer.
+static constexpr size_t page_transfer_threshold = 64 * KiB;
+// Sending more than this at once would pin a lot of the sender's memory until the receiver catches up.
+static constexpr size_t max_pages_per_transfer = 256;
+// SO_SNDBUF and SO_RCVBUF are clamped to this, every byte of it is allocated twice.
+static constexpr size_t max_buffer_capacity = 4 * MiB;
+
 static MutexProtected<LocalSocket::List>& all_sockets()
 {
     return *s_list;
@@ -301,6 +310,38 @@ bool LocalSocket::can_write(OpenFileDescription const& description, u64) const
     return false;
 }
 
+// Large writes from private anonymous memory share the sender's pages copy-on-write with the socket buffer,
+// so the data is only copied once, straight into the receiver's buffer. Returns 0 if the data has to be copied.
+static ErrorOr<size_t> try_write_pages(DoubleBuffer& socket_buffer, UserOrKernelBuffer const& data, size_t data_size)
+{
+    if (data.is_kernel_buffer() || data_size < page_transfer_threshold || socket_buffer.has_pages_to_read())
+        return 0;
+
+    auto vaddr = VirtualAddress { data.user_or_kernel_ptr() };
+    if (!vaddr.is_page_aligned()) {
+        // Copy up to the next page boundary, the caller comes back for the rest.
+        auto bytes_until_page_boundary = PAGE_SIZE - (vaddr.get() % PAGE_SIZE);
+        return socket_buffer.write(data, bytes_until_page_boundary);
+    }
+
+    auto page_count = min(data_size / PAGE_SIZE, max_pages_per_transfer);
+    NonnullRefPtrVector<Memory::PhysicalPage> pages;
+    auto result = Process::current().address_space().with([&](auto& space) -> ErrorOr<void> {
+        auto* region = space->find_region_containing(Memory::VirtualRange { vaddr, page_count * PAGE_SIZE });
+        if (!region || !region->is_readable() || region->is_shared() || !region->vmobject().is_anonymous())
+            return EAGAIN;
+        auto& vmobject = static_cast<Memory::AnonymousVMObject&>(region->vmobject());
+        auto first_page_index = region->translate_to_vmobject_page(region->page_index_from_address(vaddr));
+        return vmobject.share_pages_copy_on_write(first_page_index, page_count, pages);
+    });
+    if (result.is_error()) {
+        if (result.error().code() == EAGAIN)
+            return 0;
+        return result.release_error();
+    }
+    return socket_buffer.write_pages(pages.span());
+}
+
 ErrorOr<size_t> LocalSocket::sendto(OpenFileDescription& description, UserOrKernelBuffer const& data, size_t data_size, int, Userspace<sockaddr const*>, socklen_t)
 {
     if (!has_attached_peer(description))
@@ -308,9 +349,13 @@ ErrorOr<size_t> LocalSocket::sendto(OpenFileDescription& description, UserOrKern
     auto* socket_buffer = send_buffer_for(description);
     if (!socket_buffer)
         return set_so_error(EINVAL);
-    auto nwritten_or_error = socket_buffer->write(data, data_size);
-    if (!nwritten_or_error.is_error() && nwritten_or_error.value() > 0)
+    auto nwritten_or_error = try_write_pages(*socket_buffer, data, data_size);
+    if (!nwritten_or_error.is_error() && nwritten_or_error.value() == 0)
+        nwritten_or_error = socket_buffer->write(data, data_size);
+    if (!nwritten_or_error.is_error() && nwritten_or_error.value() > 0) {
         Thread::current()->did_unix_socket_write(nwritten_or_error.value());
+        Tracepoints::emit(TracepointType::SocketEnqueue, bit_cast<FlatPtr>(this), nwritten_or_error.value(), AF_LOCAL);
+    }
     return nwritten_or_error;
 }
 
@@ -354,8 +399,10 @@ ErrorOr<size_t> LocalSocket::recvfrom(OpenFileDescription& description, UserOrKe
         return 0;
     VERIFY(!socket_buffer->is_empty());
     auto nread_or_error = socket_buffer->read(buffer, buffer_size);
-    if (!nread_or_error.is_error() && nread_or_error.value() > 0)
+    if (!nread_or_error.is_error() && nread_or_error.value() > 0) {
         Thread::current()->did_unix_socket_read(nread_or_error.value());
+        Tracepoints::emit(TracepointType::SocketDequeue, bit_cast<FlatPtr>(this), nread_or_error.value(), AF_LOCAL);
+    }
     return nread_or_error;
 }
 
@@ -392,6 +439,28 @@ ErrorOr<NonnullOwnPtr<KString>> LocalSocket::pseudo_path(OpenFileDescription con
     return KString::try_create(builder.string_view());
 }
 
+ErrorOr<void> LocalSocket::setsockopt(OpenFileDescription& description, int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
+{
+    if (level != SOL_SOCKET || (option != SO_SNDBUF && option != SO_RCVBUF))
+        return Socket::setsockopt(description, level, option, user_value, user_value_size);
+
+    MutexLocker locker(mutex());
+
+    if (user_value_size != sizeof(int))
+        return EINVAL;
+    auto requested_capacity = TRY(copy_typed_from_user(static_ptr_cast<int const*>(user_value)));
+    if (requested_capacity <= 0)
+        return EINVAL;
+
+    // Both ends share the buffer, so the sender's SO_SNDBUF and the receiver's SO_RCVBUF size the same thing.
+    // Buffers only ever grow, asking for less than there already is leaves them alone.
+    auto* socket_buffer = option == SO_SNDBUF ? send_buffer_for(description) : receive_buffer_for(description);
+    if (!socket_buffer)
+        return ENOTCONN;
+    auto capacity = min(static_cast<size_t>(requested_capacity), max_buffer_capacity);
+    return socket_buffer->try_grow(capacity);
+}
+
 ErrorOr<void> LocalSocket::getsockopt(OpenFileDescription& description, int level, int option, Userspace<void*> value, Userspace<socklen_t*> value_size)
 {
     if (level != SOL_SOCKET)
@@ -404,9 +473,17 @@ ErrorOr<void> LocalSocket::getsockopt(OpenFileDescription& description, int leve
 
     switch (option) {
     case SO_SNDBUF:
-        return ENOTSUP;
-    case SO_RCVBUF:
-        return ENOTSUP;
+    case SO_RCVBUF: {
+        if (size < sizeof(int))
+            return EINVAL;
+        auto* socket_buffer = option == SO_SNDBUF ? send_buffer_for(description) : receive_buffer_for(description);
+        if (!socket_buffer)
+            return ENOTCONN;
+        int capacity = static_cast<int>(socket_buffer->capacity());
+        TRY(copy_to_user(static_ptr_cast<int*>(value), &capacity));
+        size = sizeof(int);
+        return copy_to_user(value_size, &size);
+    }
     case SO_PEERCRED: {
         if (size < sizeof(ucred))
             return EINVAL;
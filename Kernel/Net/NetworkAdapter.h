@@ -73,6 +73,10 @@ public:
     }
     virtual bool link_full_duplex() { return false; }
 
+    // Note: An adapter that returns true here inserts the TCP checksum of outgoing IPv4 packets itself,
+    //       the TCP stack only seeds the checksum field with the pseudo-header sum (see TCPSocket::fill_in_tcp_checksum).
+    virtual bool supports_tcp_checksum_offload() const { return false; }
+
     void set_ipv4_address(IPv4Address const&);
     void set_ipv4_netmask(IPv4Address const&);
 
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Singleton.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Locking/Mutex.h>
 #include <Kernel/Locking/MutexProtected.h>
@@ -22,6 +23,7 @@
 #include <Kernel/Net/UDP.h>
 #include <Kernel/Net/UDPSocket.h>
 #include <Kernel/Process.h>
+#include <Kernel/Scheduler.h>
 
 namespace Kernel {
 
@@ -36,9 +38,26 @@ static void flush_delayed_tcp_acks();
 static void retransmit_tcp_packets();
 
 static Thread* network_task = nullptr;
-static HashTable<LockRefPtr<TCPSocket>>* delayed_ack_sockets;
+static Singleton<MutexProtected<HashTable<LockRefPtr<TCPSocket>>>> s_delayed_ack_sockets;
+
+// Note: Every adapter gets its own receive worker thread, so one busy adapter can't starve the others
+//       and packet processing for different adapters can run on different processors. As each adapter
+//       only has a single receive queue, all packets of a TCP connection end up on the same worker.
+struct NetworkReceiveWorker {
+    explicit NetworkReceiveWorker(NetworkAdapter& adapter)
+        : adapter(adapter)
+    {
+    }
+
+    NonnullLockRefPtr<NetworkAdapter> adapter;
+    WaitQueue wait_queue;
+};
+
+// How many frames a worker processes per wakeup before doing its housekeeping and giving others a chance to run.
+static constexpr size_t receive_batch_size = 64;
 
 [[noreturn]] static void NetworkTask_main(void*);
+[[noreturn]] static void receive_worker_main(void*);
 
 void NetworkTask::spawn()
 {
@@ -52,15 +71,12 @@ void NetworkTask::spawn()
 
 bool NetworkTask::is_current()
 {
-    return Thread::current() == network_task;
+    // All receive workers are threads of the Network Task process.
+    return network_task && Thread::current()->pid() == network_task->pid();
 }
 
 void NetworkTask_main(void*)
 {
-    delayed_ack_sockets = new HashTable<LockRefPtr<TCPSocket>>;
-
-    WaitQueue packet_wait_queue;
-    int pending_packets = 0;
     NetworkingManagement::the().for_each([&](auto& adapter) {
         dmesgln("NetworkTask: {} network adapter found: hw={}", adapter.class_name(), adapter.mac_address().to_string());
 
@@ -69,25 +85,57 @@ void NetworkTask_main(void*)
             adapter.set_ipv4_netmask({ 255, 0, 0, 0 });
         }
 
-        adapter.on_receive = [&]() {
-            pending_packets++;
-            packet_wait_queue.wake_all();
+        auto* worker = new (nothrow) NetworkReceiveWorker(adapter);
+        if (!worker)
+            TODO();
+        adapter.on_receive = [worker]() {
+            worker->wait_queue.wake_all();
         };
+
+        auto name = KString::formatted("Network Task ({})", adapter.name());
+        if (name.is_error())
+            TODO();
+        auto thread = Process::current().create_kernel_thread(receive_worker_main, worker, THREAD_PRIORITY_NORMAL, name.release_value(), THREAD_AFFINITY_DEFAULT, false);
+        if (!thread)
+            TODO();
     });
 
-    auto dequeue_packet = [&pending_packets](u8* buffer, size_t buffer_size, Time& packet_timestamp) -> size_t {
-        if (pending_packets == 0)
-            return 0;
-        size_t packet_size = 0;
-        NetworkingManagement::the().for_each([&](auto& adapter) {
-            if (packet_size || !adapter.has_queued_packets())
-                return;
-            packet_size = adapter.dequeue_packet(buffer, buffer_size, packet_timestamp);
-            pending_packets--;
-            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
-        });
-        return packet_size;
-    };
+    // The main thread only drives the timers, everything else happens on the receive workers.
+    for (;;) {
+        flush_delayed_tcp_acks();
+        retransmit_tcp_packets();
+        (void)Thread::current()->sleep(Time::from_milliseconds(500));
+    }
+}
+
+static void handle_frame(u8 const* buffer, size_t packet_size, Time const& packet_timestamp)
+{
+    if (packet_size < sizeof(EthernetFrameHeader)) {
+        dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
+        return;
+    }
+    auto& eth = *(EthernetFrameHeader const*)buffer;
+    dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
+
+    switch (eth.ether_type()) {
+    case EtherType::ARP:
+        handle_arp(eth, packet_size);
+        break;
+    case EtherType::IPv4:
+        handle_ipv4(eth, packet_size, packet_timestamp);
+        break;
+    case EtherType::IPv6:
+        // ignore
+        break;
+    default:
+        dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
+    }
+}
+
+void receive_worker_main(void* data)
+{
+    auto& worker = *static_cast<NetworkReceiveWorker*>(data);
+    auto& adapter = *worker.adapter;
 
     size_t buffer_size = 64 * KiB;
     auto region_or_error = MM.allocate_kernel_region(buffer_size, "Kernel Packet Buffer"sv, Memory::Region::Access::ReadWrite);
@@ -98,35 +146,31 @@ void NetworkTask_main(void*)
     Time packet_timestamp;
 
     for (;;) {
-        flush_delayed_tcp_acks();
-        retransmit_tcp_packets();
-        size_t packet_size = dequeue_packet(buffer, buffer_size, packet_timestamp);
-        if (!packet_size) {
-            auto timeout_time = Time::from_milliseconds(500);
-            auto timeout = Thread::BlockTimeout { false, &timeout_time };
-            [[maybe_unused]] auto result = packet_wait_queue.wait_on(timeout, "NetworkTask"sv);
-            continue;
+        // Note: Drain a whole batch of frames per wakeup instead of sleeping and waking up for every single one.
+        size_t processed = 0;
+        for (; processed < receive_batch_size; ++processed) {
+            size_t packet_size = adapter.dequeue_packet(buffer, buffer_size, packet_timestamp);
+            if (!packet_size)
+                break;
+            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
+            handle_frame(buffer, packet_size, packet_timestamp);
         }
-        if (packet_size < sizeof(EthernetFrameHeader)) {
-            dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
-            continue;
+
+        if (processed > 0) {
+            flush_delayed_tcp_acks();
+            retransmit_tcp_packets();
         }
-        auto& eth = *(EthernetFrameHeader const*)buffer;
-        dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
-
-        switch (eth.ether_type()) {
-        case EtherType::ARP:
-            handle_arp(eth, packet_size);
-            break;
-        case EtherType::IPv4:
-            handle_ipv4(eth, packet_size, packet_timestamp);
-            break;
-        case EtherType::IPv6:
-            // ignore
-            break;
-        default:
-            dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
+
+        if (processed == receive_batch_size) {
+            Scheduler::yield();
+            continue;
         }
+        if (adapter.has_queued_packets())
+            continue;
+
+        auto timeout_time = Time::from_milliseconds(500);
+        auto timeout = Thread::BlockTimeout { false, &timeout_time };
+        [[maybe_unused]] auto result = worker.wait_queue.wait_on(timeout, "NetworkTask"sv);
     }
 }
 
@@ -310,13 +354,23 @@ void send_delayed_tcp_ack(LockRefPtr<TCPSocket> socket)
         return;
     }
 
-    delayed_ack_sockets->set(move(socket));
+    s_delayed_ack_sockets->with_exclusive([&](auto& delayed_ack_sockets) {
+        delayed_ack_sockets.set(move(socket));
+    });
 }
 
 void flush_delayed_tcp_acks()
 {
+    // Note: Take the sockets out of the set before locking any of them, as send_delayed_tcp_ack()
+    //       is called with the socket already locked and then locks the set.
+    auto sockets = s_delayed_ack_sockets->with_exclusive([](auto& delayed_ack_sockets) {
+        return move(delayed_ack_sockets);
+    });
+    if (sockets.is_empty())
+        return;
+
     Vector<LockRefPtr<TCPSocket>, 32> remaining_sockets;
-    for (auto& socket : *delayed_ack_sockets) {
+    for (auto& socket : sockets) {
         MutexLocker locker(socket->mutex());
         if (socket->should_delay_next_ack()) {
             MUST(remaining_sockets.try_append(socket));
@@ -325,13 +379,13 @@ void flush_delayed_tcp_acks()
         [[maybe_unused]] auto result = socket->send_ack();
     }
 
-    if (remaining_sockets.size() != delayed_ack_sockets->size()) {
-        delayed_ack_sockets->clear();
-        if (remaining_sockets.size() > 0)
-            dbgln("flush_delayed_tcp_acks: {} sockets remaining", remaining_sockets.size());
+    if (remaining_sockets.is_empty())
+        return;
+    dbgln_if(NETWORK_TASK_DEBUG, "flush_delayed_tcp_acks: {} sockets remaining", remaining_sockets.size());
+    s_delayed_ack_sockets->with_exclusive([&](auto& delayed_ack_sockets) {
         for (auto&& socket : remaining_sockets)
-            delayed_ack_sockets->set(move(socket));
-    }
+            delayed_ack_sockets.set(move(socket));
+    });
 }
 
 void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, LockRefPtr<NetworkAdapter> adapter)
@@ -362,7 +416,7 @@ void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, Lo
     rst_packet.set_ack_number(tcp_packet.sequence_number() + 1);
     rst_packet.set_data_offset(tcp_header_size / sizeof(u32));
     rst_packet.set_flags(TCPFlags::RST | TCPFlags::ACK);
-    rst_packet.set_checksum(TCPSocket::compute_tcp_checksum(ipv4_packet.source(), ipv4_packet.destination(), rst_packet, 0));
+    TCPSocket::fill_in_tcp_checksum(*routing_decision.adapter, ipv4_packet.destination(), ipv4_packet.source(), rst_packet, 0);
 
     routing_decision.adapter->send_packet(packet->bytes());
     routing_decision.adapter->release_packet_buffer(*packet);
@@ -206,9 +206,27 @@ ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t
     if (routing_decision.is_zero())
         return set_so_error(EHOSTUNREACH);
     size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
-    data_length = min(data_length, mss);
-    TRY(send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, &data, data_length, &routing_decision));
-    return data_length;
+
+    // Note: Cut everything the send window has room for into segments right here, so that bulk
+    //       writes don't have to come back through the whole socket layer for every single segment.
+    auto window_available = m_unacked_packets.with_shared([&](auto& unacked_packets) -> size_t {
+        return unacked_packets.size < m_send_window_size ? m_send_window_size - unacked_packets.size : 0;
+    });
+    data_length = min(data_length, max(mss, window_available));
+
+    size_t nsent = 0;
+    while (nsent < data_length) {
+        auto segment_size = min(data_length - nsent, mss);
+        auto segment = data.offset(nsent);
+        auto result = send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, &segment, segment_size, &routing_decision);
+        if (result.is_error()) {
+            if (nsent == 0)
+                return result.release_error();
+            break;
+        }
+        nsent += segment_size;
+    }
+    return nsent;
 }
 
 ErrorOr<void> TCPSocket::send_ack(bool allow_duplicate)
@@ -272,7 +290,7 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
         memcpy(packet->buffer->data() + ipv4_payload_offset + sizeof(TCPPacket), &mss_option, sizeof(mss_option));
     }
 
-    tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    fill_in_tcp_checksum(*routing_decision.adapter, local_address(), peer_address(), tcp_packet, payload_size);
 
     bool expect_ack { tcp_packet.has_syn() || payload_size > 0 };
     if (expect_ack) {
@@ -358,17 +376,47 @@ bool TCPSocket::should_delay_next_ack() const
     return true;
 }
 
-NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const& packet, u16 payload_size)
+// Note: The ones' complement sum doesn't depend on byte order, so we add up the data in memory order,
+// 32 bits at a time, and only swap the folded result into host order at the end.
+static u64 add_to_ones_complement_sum(u64 sum, void const* data, size_t size)
+{
+    auto const* bytes = static_cast<u8 const*>(data);
+    for (; size >= sizeof(u32); bytes += sizeof(u32), size -= sizeof(u32)) {
+        u32 word;
+        memcpy(&word, bytes, sizeof(word));
+        sum += word;
+    }
+    if (size >= sizeof(u16)) {
+        u16 half_word;
+        memcpy(&half_word, bytes, sizeof(half_word));
+        sum += half_word;
+        bytes += sizeof(u16);
+        size -= sizeof(u16);
+    }
+    if (size) {
+        u8 const padded[2] = { bytes[0], 0 };
+        u16 half_word;
+        memcpy(&half_word, padded, sizeof(half_word));
+        sum += half_word;
+    }
+    return sum;
+}
+
+static u16 fold_ones_complement_sum(u64 sum)
+{
+    while (sum >> 16)
+        sum = (sum & 0xffff) + (sum >> 16);
+    return AK::convert_between_host_and_network_endian(static_cast<u16>(sum));
+}
+
+static u64 tcp_pseudo_header_sum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const& packet, u16 payload_size)
 {
-    union PseudoHeader {
-        struct [[gnu::packed]] {
-            IPv4Address source;
-            IPv4Address destination;
-            u8 zero;
-            u8 protocol;
-            NetworkOrdered<u16> payload_size;
-        } header;
-        u16 raw[6];
+    struct [[gnu::packed]] PseudoHeader {
+        IPv4Address source;
+        IPv4Address destination;
+        u8 zero;
+        u8 protocol;
+        NetworkOrdered<u16> payload_size;
     };
     static_assert(sizeof(PseudoHeader) == 12);
 
@@ -376,35 +424,29 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, I
     packet_size += payload_size;
     VERIFY(!packet_size.has_overflow());
 
-    PseudoHeader pseudo_header { .header = { source, destination, 0, (u8)IPv4Protocol::TCP, packet_size.value() } };
+    PseudoHeader pseudo_header { source, destination, 0, (u8)IPv4Protocol::TCP, packet_size.value() };
+    return add_to_ones_complement_sum(0, &pseudo_header, sizeof(pseudo_header));
+}
 
-    u32 checksum = 0;
-    auto* raw_pseudo_header = pseudo_header.raw;
-    for (size_t i = 0; i < sizeof(pseudo_header) / sizeof(u16); ++i) {
-        checksum += AK::convert_between_host_and_network_endian(raw_pseudo_header[i]);
-        if (checksum > 0xffff)
-            checksum = (checksum >> 16) + (checksum & 0xffff);
-    }
-    auto* raw_packet = bit_cast<u16*>(&packet);
-    for (size_t i = 0; i < packet.header_size() / sizeof(u16); ++i) {
-        checksum += AK::convert_between_host_and_network_endian(raw_packet[i]);
-        if (checksum > 0xffff)
-            checksum = (checksum >> 16) + (checksum & 0xffff);
-    }
+NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const& packet, u16 payload_size)
+{
     VERIFY(packet.data_offset() * 4 == packet.header_size());
-    auto* raw_payload = bit_cast<u16*>(packet.payload());
-    for (size_t i = 0; i < payload_size / sizeof(u16); ++i) {
-        checksum += AK::convert_between_host_and_network_endian(raw_payload[i]);
-        if (checksum > 0xffff)
-            checksum = (checksum >> 16) + (checksum & 0xffff);
-    }
-    if (payload_size & 1) {
-        u16 expanded_byte = ((u8 const*)packet.payload())[payload_size - 1] << 8;
-        checksum += expanded_byte;
-        if (checksum > 0xffff)
-            checksum = (checksum >> 16) + (checksum & 0xffff);
+    auto sum = tcp_pseudo_header_sum(source, destination, packet, payload_size);
+    sum = add_to_ones_complement_sum(sum, &packet, packet.header_size());
+    sum = add_to_ones_complement_sum(sum, packet.payload(), payload_size);
+    return static_cast<u16>(~fold_ones_complement_sum(sum));
+}
+
+void TCPSocket::fill_in_tcp_checksum(NetworkAdapter const& adapter, IPv4Address const& source, IPv4Address const& destination, TCPPacket& packet, u16 payload_size)
+{
+    if (!adapter.supports_tcp_checksum_offload()) {
+        packet.set_checksum(0);
+        packet.set_checksum(compute_tcp_checksum(source, destination, packet, payload_size));
+        return;
     }
-    return ~(checksum & 0xffff);
+    // The adapter sums up the TCP header and payload itself and only needs the (uncomplemented)
+    // pseudo-header sum to be seeded into the checksum field.
+    packet.set_checksum(fold_ones_complement_sum(tcp_pseudo_header_sum(source, destination, packet, payload_size)));
 }
 
 ErrorOr<void> TCPSocket::protocol_bind()
@@ -633,6 +675,10 @@ void TCPSocket::retransmit_packets()
             routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
                 local_address(), routing_decision.next_hop, peer_address(),
                 IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
+            // Note: The route may have moved us to an adapter with different checksum offload capabilities.
+            auto& tcp_packet = *(TCPPacket*)(packet_buffer.data() + ipv4_payload_offset);
+            auto payload_size = packet_buffer.size() - ipv4_payload_offset - tcp_packet.header_size();
+            fill_in_tcp_checksum(*routing_decision.adapter, local_address(), peer_address(), tcp_packet, payload_size);
             routing_decision.adapter->send_packet(packet_buffer);
             m_packets_out++;
             m_bytes_out += packet_buffer.size();
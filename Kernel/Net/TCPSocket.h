@@ -163,6 +163,7 @@ public:
     virtual bool can_write(OpenFileDescription const&, u64) const override;
 
     static NetworkOrdered<u16> compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const&, u16 payload_size);
+    static void fill_in_tcp_checksum(NetworkAdapter const&, IPv4Address const& source, IPv4Address const& destination, TCPPacket&, u16 payload_size);
 
 protected:
     void set_direction(Direction direction) { m_direction = direction; }
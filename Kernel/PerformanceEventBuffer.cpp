@@ -165,6 +165,11 @@ ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, Threa
         event.data.read.start_timestamp = arg5;
         event.data.read.success = !arg6.is_error();
         break;
+    case PERF_EVENT_OFF_CPU:
+        event.data.off_cpu.reason_index = arg1;
+        event.data.off_cpu.wait_channel_index = arg2;
+        event.data.off_cpu.duration_ns = arg5;
+        break;
     default:
         return EINVAL;
     }
@@ -296,6 +301,12 @@ ErrorOr<void> PerformanceEventBuffer::to_json_impl(Serializer& object) const
             TRY(event_object.add("start_timestamp"sv, event.data.read.start_timestamp));
             TRY(event_object.add("success"sv, event.data.read.success));
             break;
+        case PERF_EVENT_OFF_CPU:
+            TRY(event_object.add("type"sv, "off_cpu"));
+            TRY(event_object.add("reason_index"sv, event.data.off_cpu.reason_index));
+            TRY(event_object.add("wait_channel_index"sv, event.data.off_cpu.wait_channel_index));
+            TRY(event_object.add("duration_ns"sv, event.data.off_cpu.duration_ns));
+            break;
         }
         TRY(event_object.add("pid"sv, event.pid));
         TRY(event_object.add("tid"sv, event.tid));
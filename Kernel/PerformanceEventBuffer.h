@@ -76,6 +76,12 @@ struct [[gnu::packed]] ReadPerformanceEvent {
     bool success;
 };
 
+struct [[gnu::packed]] OffCPUPerformanceEvent {
+    size_t reason_index;
+    size_t wait_channel_index;
+    u64 duration_ns;
+};
+
 struct [[gnu::packed]] PerformanceEvent {
     u32 type { 0 };
     u8 stack_size { 0 };
@@ -96,6 +102,7 @@ struct [[gnu::packed]] PerformanceEvent {
         KFreePerformanceEvent kfree;
         SignpostPerformanceEvent signpost;
         ReadPerformanceEvent read;
+        OffCPUPerformanceEvent off_cpu;
     } data;
     static constexpr size_t max_stack_frame_count = 64;
     FlatPtr stack[max_stack_frame_count];
@@ -161,6 +161,33 @@ public:
         [[maybe_unused]] auto rc = event_buffer->append(PERF_EVENT_READ, fd, size, {}, &thread, filepath_string_index, start_timestamp, result); // wrong arguments
     }
 
+    static bool should_record_off_cpu_events(Thread& thread)
+    {
+        if ((g_profiling_event_mask & PERF_EVENT_OFF_CPU) == 0)
+            return false;
+        return !thread.is_profiling_suppressed() && thread.process().current_perf_events_buffer();
+    }
+
+    // Called once a thread is running again, so the recorded stack is the one it blocked on.
+    static void add_off_cpu_event(Thread& thread, StringView reason, StringView wait_channel, u64 duration_ns)
+    {
+        if (!should_record_off_cpu_events(thread))
+            return;
+        auto* event_buffer = thread.process().current_perf_events_buffer();
+
+        auto register_string = [&](StringView string) -> ErrorOr<FlatPtr> {
+            return event_buffer->register_string(TRY(KString::try_create(string)));
+        };
+        auto reason_index = register_string(reason);
+        if (reason_index.is_error())
+            return;
+        auto wait_channel_index = register_string(wait_channel.is_empty() ? reason : wait_channel);
+        if (wait_channel_index.is_error())
+            return;
+
+        [[maybe_unused]] auto rc = event_buffer->append(PERF_EVENT_OFF_CPU, reason_index.value(), wait_channel_index.value(), {}, &thread, 0, duration_ns);
+    }
+
     static void timer_tick(RegisterState const& regs)
     {
         static Time last_wakeup;
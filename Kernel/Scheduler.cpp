@@ -17,6 +17,7 @@
 #include <Kernel/Scheduler.h>
 #include <Kernel/Sections.h>
 #include <Kernel/Time/TimeManagement.h>
+#include <Kernel/Tracepoints.h>
 #include <Kernel/kstdio.h>
 
 namespace Kernel {
@@ -46,89 +47,137 @@ struct ThreadReadyQueues {
     Array<ThreadReadyQueue, count> queues;
 };
 
-static Singleton<SpinlockProtected<ThreadReadyQueues, LockRank::None>> g_ready_queues;
+// Every processor owns a set of ready queues. Threads are queued on the processor
+// they last ran on (if their affinity allows it), and processors that run out of
+// local work steal runnable threads from the queues of other processors.
+using PerProcessorReadyQueues = Array<SpinlockProtected<ThreadReadyQueues, LockRank::None>, MAX_CPU_COUNT>;
+static Singleton<PerProcessorReadyQueues> g_ready_queues;
+
+// Mask of processors that have entered the scheduler and may be stolen from.
+static Atomic<u32> s_scheduling_processors_mask { 0 };
 
 static SpinlockProtected<TotalTimeScheduled, LockRank::None> g_total_time_scheduled {};
 
 static void dump_thread_list(bool = false);
 
-static inline u32 thread_priority_to_priority_index(u32 thread_priority)
+static inline u32 thread_priority_to_priority_index(Thread const& thread)
 {
+    // Realtime threads have the highest priority bucket to themselves.
+    if (thread.is_realtime())
+        return 0;
+
     // Converts the priority in the range of THREAD_PRIORITY_MIN...THREAD_PRIORITY_MAX
-    // to a index into g_ready_queues where 0 is the highest priority bucket
-    VERIFY(thread_priority >= THREAD_PRIORITY_MIN && thread_priority <= THREAD_PRIORITY_MAX);
+    // to a index into the remaining buckets of g_ready_queues, where 1 is the highest priority bucket
+    auto thread_priority = min(thread.priority(), (u32)THREAD_PRIORITY_MAX);
+    VERIFY(thread_priority >= THREAD_PRIORITY_MIN);
     constexpr u32 thread_priority_count = THREAD_PRIORITY_MAX - THREAD_PRIORITY_MIN + 1;
     static_assert(thread_priority_count > 0);
-    auto priority_bucket = ((thread_priority_count - (thread_priority - THREAD_PRIORITY_MIN)) / thread_priority_count) * (ThreadReadyQueues::count - 1);
+    auto priority_bucket = 1 + ((thread_priority_count - (thread_priority - THREAD_PRIORITY_MIN)) / thread_priority_count) * (ThreadReadyQueues::count - 2);
     VERIFY(priority_bucket < ThreadReadyQueues::count);
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+static u32 ready_queue_processor_for(Thread const& thread)
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread& {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                thread.m_runnable_priority = -1;
-                ready_queue.thread_list.remove(thread);
-                if (ready_queue.thread_list.is_empty())
-                    ready_queues.mask &= ~(1u << priority);
-                // Mark it as active because we are using this thread. This is similar
-                // to comparing it with Processor::current_thread, but when there are
-                // multiple processors there's no easy way to check whether the thread
-                // is actually still needed. This prevents accidental finalization when
-                // a thread is no longer in Running state, but running on another core.
-
-                // We need to mark it active here so that this thread won't be
-                // scheduled on another core if it were to be queued before actually
-                // switching to it.
-                // FIXME: Figure out a better way maybe?
-                thread.set_active(true);
+    auto affinity = thread.affinity();
+    VERIFY(affinity != 0);
+
+    // Prefer the processor the thread last ran on, as its caches are most likely still warm.
+    auto last_processor = thread.cpu();
+    if (last_processor < MAX_CPU_COUNT && (affinity & (1u << last_processor)))
+        return last_processor;
+
+    auto current_processor = Processor::current_id();
+    if (affinity & (1u << current_processor))
+        return current_processor;
+
+    auto allowed_processors = affinity & s_scheduling_processors_mask.load(AK::MemoryOrder::memory_order_relaxed);
+    if (allowed_processors == 0)
+        allowed_processors = affinity;
+    u32 processor = bit_scan_forward(allowed_processors) - 1;
+    if (processor >= MAX_CPU_COUNT)
+        return current_processor;
+    return processor;
+}
+
+template<typename Callback>
+Thread* Scheduler::find_runnable_thread(Callback callback)
+{
+    auto current_processor = Processor::current_id();
+    auto affinity_mask = 1u << current_processor;
+
+    auto try_processor = [&](u32 processor) {
+        return (*g_ready_queues)[processor].with([&](auto& ready_queues) -> Thread* {
+            auto priority_mask = ready_queues.mask;
+            while (priority_mask != 0) {
+                auto priority = bit_scan_forward(priority_mask);
+                VERIFY(priority > 0);
+                auto& ready_queue = ready_queues.queues[--priority];
+                for (auto& thread : ready_queue.thread_list) {
+                    VERIFY(thread.m_runnable_priority == (int)priority);
+                    if (thread.is_active())
+                        continue;
+                    if (!(thread.affinity() & affinity_mask))
+                        continue;
+                    callback(thread, ready_queues, ready_queue, priority);
+                    return &thread;
+                }
+                priority_mask &= ~(1u << priority);
+            }
+            return nullptr;
+        });
+    };
+
+    if (auto* thread = try_processor(current_processor))
+        return thread;
+
+    // Nothing to do locally, try to steal work from the other processors, starting
+    // with our neighbor so that not every idle processor hammers the same queue.
+    auto other_processors = s_scheduling_processors_mask.load(AK::MemoryOrder::memory_order_relaxed) & ~affinity_mask;
+    auto processors_after_us = other_processors & ~((affinity_mask << 1) - 1);
+    for (auto mask : Array { processors_after_us, other_processors & ~processors_after_us }) {
+        while (mask != 0) {
+            u32 processor = bit_scan_forward(mask) - 1;
+            mask &= ~(1u << processor);
+            if (auto* thread = try_processor(processor)) {
+                dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Stole {} from processor {}", current_processor, *thread, processor);
                 return thread;
             }
-            priority_mask &= ~(1u << priority);
         }
-        return *Processor::idle_thread();
+    }
+    return nullptr;
+}
+
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    auto* thread = find_runnable_thread([](Thread& thread, auto& ready_queues, auto& ready_queue, u32 priority) {
+        thread.m_runnable_priority = -1;
+        ready_queue.thread_list.remove(thread);
+        if (ready_queue.thread_list.is_empty())
+            ready_queues.mask &= ~(1u << priority);
+        // Mark it as active because we are using this thread. This is similar
+        // to comparing it with Processor::current_thread, but when there are
+        // multiple processors there's no easy way to check whether the thread
+        // is actually still needed. This prevents accidental finalization when
+        // a thread is no longer in Running state, but running on another core.
+
+        // We need to mark it active here so that this thread won't be
+        // scheduled on another core if it were to be queued before actually
+        // switching to it.
+        // FIXME: Figure out a better way maybe?
+        thread.set_active(true);
     });
+    if (thread)
+        return *thread;
+    return *Processor::idle_thread();
 }
 
 Thread* Scheduler::peek_next_runnable_thread()
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread* {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                return &thread;
-            }
-            priority_mask &= ~(1u << priority);
-        }
-
-        // Unlike in pull_next_runnable_thread() we don't want to fall back to
-        // the idle thread. We just want to see if we have any other thread ready
-        // to be scheduled.
-        return nullptr;
-    });
+    // Unlike in pull_next_runnable_thread() we don't want to fall back to
+    // the idle thread. We just want to see if we have any other thread ready
+    // to be scheduled.
+    return find_runnable_thread([](Thread&, auto&, auto&, u32) {});
 }
 
 bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
@@ -136,12 +185,15 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
     if (thread.is_idle_thread())
         return true;
 
-    return g_ready_queues->with([&](auto& ready_queues) {
+    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
+    if (thread.m_runnable_priority < 0) {
+        VERIFY(!thread.m_ready_queue_node.is_in_list());
+        return false;
+    }
+
+    return (*g_ready_queues)[thread.m_runnable_processor].with([&](auto& ready_queues) {
         auto priority = thread.m_runnable_priority;
-        if (priority < 0) {
-            VERIFY(!thread.m_ready_queue_node.is_in_list());
-            return false;
-        }
+        VERIFY(priority >= 0);
 
         if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
             return false;
@@ -161,11 +213,17 @@ void Scheduler::enqueue_runnable_thread(Thread& thread)
     VERIFY(g_scheduler_lock.is_locked_by_current_processor());
     if (thread.is_idle_thread())
         return;
-    auto priority = thread_priority_to_priority_index(thread.priority());
-
-    g_ready_queues->with([&](auto& ready_queues) {
+    auto priority = thread_priority_to_priority_index(thread);
+    auto processor = ready_queue_processor_for(thread);
+    // A realtime thread that is woken up shouldn't have to wait for another processor to get around to it.
+    auto current_processor = Processor::current_id();
+    if (thread.is_realtime() && (thread.affinity() & (1u << current_processor)))
+        processor = current_processor;
+
+    (*g_ready_queues)[processor].with([&](auto& ready_queues) {
         VERIFY(thread.m_runnable_priority < 0);
         thread.m_runnable_priority = (int)priority;
+        thread.m_runnable_processor = processor;
         VERIFY(!thread.m_ready_queue_node.is_in_list());
         auto& ready_queue = ready_queues.queues[priority];
         bool was_empty = ready_queue.thread_list.is_empty();
@@ -173,6 +231,13 @@ void Scheduler::enqueue_runnable_thread(Thread& thread)
         if (was_empty)
             ready_queues.mask |= (1u << priority);
     });
+
+    // Nor should it have to wait for the time slice of the thread that's running to end.
+    if (thread.is_realtime() && processor == current_processor && !Processor::current_in_scheduler()) {
+        auto* current_thread = Processor::current_thread();
+        if (current_thread && !current_thread->is_realtime())
+            Processor::current().invoke_scheduler_async();
+    }
 }
 
 UNMAP_AFTER_INIT void Scheduler::start()
@@ -193,6 +258,7 @@ UNMAP_AFTER_INIT void Scheduler::start()
     processor.init_context(idle_thread, false);
     idle_thread.set_state(Thread::State::Running);
     VERIFY(idle_thread.affinity() == (1u << processor.id()));
+    s_scheduling_processors_mask.fetch_or(1u << processor.id(), AK::MemoryOrder::memory_order_relaxed);
     processor.initialize_context_switching(idle_thread);
     VERIFY_NOT_REACHED();
 }
@@ -285,6 +351,7 @@ void Scheduler::context_switch(Thread* thread)
     thread->set_state(Thread::State::Running);
 
     PerformanceManager::add_context_switch_perf_event(*from_thread, *thread);
+    Tracepoints::emit(TracepointType::ContextSwitch, thread->tid().value(), thread->pid().value());
 
     proc.switch_context(from_thread, thread);
 
@@ -438,6 +505,10 @@ void Scheduler::timer_tick(RegisterState const& regs)
     if (current_thread->tick())
         return;
 
+    // A realtime thread that didn't block within its time slice doesn't get to run ahead of everything else anymore.
+    if (current_thread->is_realtime())
+        current_thread->set_realtime_throttled(true);
+
     if (!current_thread->is_idle_thread() && !peek_next_runnable_thread()) {
         // If no other thread is ready to be scheduled we don't need to
         // switch to the idle thread. Just give the current thread another
@@ -55,6 +55,10 @@ public:
     static bool is_initialized();
     static TotalTimeScheduled get_total_time_scheduled();
     static void add_time_scheduled(u64, bool);
+
+private:
+    template<typename Callback>
+    static Thread* find_runnable_thread(Callback);
 };
 
 }
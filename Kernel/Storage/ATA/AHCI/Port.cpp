@@ -38,7 +38,7 @@ ErrorOr<void> AHCIPort::allocate_resources_and_initialize_ports()
 
     m_fis_receive_page = TRY(MM.allocate_physical_page());
 
-    for (size_t index = 0; index < 1; index++) {
+    for (size_t index = 0; index < max_transfer_size / PAGE_SIZE; index++) {
         auto dma_page = TRY(MM.allocate_physical_page());
         m_dma_buffers.append(move(dma_page));
     }
@@ -130,7 +130,13 @@ void AHCIPort::handle_interrupt()
         }
         return;
     }
-    if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::DHR) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::PS)) {
+    if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::DHR) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::PS) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::SDB)) {
+        // Note: A queued command first gets a Register FIS that only says it was accepted, and is done once the
+        // device has cleared its tag with a Set Device Bits FIS. Until then, there's nothing to do here.
+        if (m_native_command_queuing_enabled && m_current_request && !is_queued_command_done()) {
+            m_interrupt_status.clear();
+            return;
+        }
         m_wait_for_completion = false;
 
         // Now schedule reading/writing the buffer as soon as we leave the irq handler.
@@ -352,6 +358,12 @@ bool AHCIPort::initialize()
             m_port_registers.cmd = m_port_registers.cmd | (1 << 24);
         }
 
+        // Note: Word 76 is either all zeros or all ones if the device doesn't report its Serial ATA capabilities.
+        bool device_supports_native_command_queuing = identify_block->serial_ata_capabilities != 0xffff && (identify_block->serial_ata_capabilities & (1 << 8));
+        m_native_command_queuing_enabled = !is_atapi_attached() && m_hba_capabilities.native_command_queuing_supported && device_supports_native_command_queuing;
+        if (m_native_command_queuing_enabled)
+            dmesgln("AHCI Port {}: Using Native Command Queuing, queue depth {}", representative_port_index(), (identify_block->queue_depth & 0x1f) + 1);
+
         dmesgln("AHCI Port {}: Device found, Capacity={}, Bytes per logical sector={}, Bytes per physical sector={}", representative_port_index(), max_addressable_sector * logical_sector_size, logical_sector_size, physical_sector_size);
 
         // FIXME: We don't support ATAPI devices yet, so for now we don't "create" them
@@ -361,7 +373,7 @@ bool AHCIPort::initialize()
                 dmesgln("AHCI Port {}: Device found, but parent controller is not available, abort.", representative_port_index());
                 return false;
             }
-            m_connected_device = ATADiskDevice::create(*controller, { m_port_index, 0 }, 0, logical_sector_size, max_addressable_sector);
+            m_connected_device = ATADiskDevice::create(*controller, { m_port_index, 0 }, 0, logical_sector_size, max_addressable_sector, max_transfer_size);
         } else {
             dbgln("AHCI Port {}: Ignoring ATAPI devices for now as we don't currently support them.", representative_port_index());
         }
@@ -542,6 +554,7 @@ void AHCIPort::start_request(AsyncBlockDeviceRequest& request)
 void AHCIPort::complete_current_request(AsyncDeviceRequest::RequestResult result)
 {
     VERIFY(m_current_request);
+    m_current_command_slot = {};
     auto current_request = m_current_request;
     m_current_request.clear();
     current_request->complete(result);
@@ -577,6 +590,7 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
 
     auto unused_command_header = try_to_find_unused_command_header();
     VERIFY(unused_command_header.has_value());
+    m_current_command_slot = unused_command_header.value();
     auto* command_list_entries = (volatile AHCI::CommandHeader*)m_command_list_region->vaddr().as_ptr();
     command_list_entries[unused_command_header.value()].ctba = m_command_table_pages[unused_command_header.value()].paddr().get();
     command_list_entries[unused_command_header.value()].ctbau = 0;
@@ -624,6 +638,11 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
     if (is_atapi_attached()) {
         fis.command = ATA_CMD_PACKET;
         TODO();
+    } else if (m_native_command_queuing_enabled) {
+        if (direction == AsyncBlockDeviceRequest::RequestType::Write)
+            fis.command = ATA_CMD_WRITE_FPDMA_QUEUED;
+        else
+            fis.command = ATA_CMD_READ_FPDMA_QUEUED;
     } else {
         if (direction == AsyncBlockDeviceRequest::RequestType::Write)
             fis.command = ATA_CMD_WRITE_DMA_EXT;
@@ -642,13 +661,24 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
     fis.lba_low[0] = lba & 0xff;
     fis.lba_low[1] = (lba >> 8) & 0xff;
     fis.lba_low[2] = (lba >> 16) & 0xff;
-    fis.count = (block_count);
+    if (m_native_command_queuing_enabled) {
+        // Note: For queued commands, the block count moves to the features register, and the count register
+        // carries the tag instead, which is the same as the command slot.
+        fis.features_low = block_count;
+        fis.features_high = 0;
+        fis.count = unused_command_header.value() << 3;
+    } else {
+        fis.count = (block_count);
+    }
 
     // The below loop waits until the port is no longer busy before issuing a new command
     if (!spin_until_ready())
         return false;
 
     full_memory_barrier();
+    // Note: The tag of a queued command has to be marked as outstanding in PxSACT before the command is issued.
+    if (m_native_command_queuing_enabled)
+        m_port_registers.sact = 1u << unused_command_header.value();
     mark_command_header_ready_to_process(unused_command_header.value());
     full_memory_barrier();
 
@@ -757,8 +787,10 @@ bool AHCIPort::shutdown()
 Optional<u8> AHCIPort::try_to_find_unused_command_header()
 {
     VERIFY(m_lock.is_locked());
-    u32 commands_issued = m_port_registers.ci;
-    for (size_t index = 0; index < 32; index++) {
+    // Note: A queued command keeps its slot taken in PxSACT even after the HBA has cleared it in PxCI.
+    u32 commands_issued = m_port_registers.ci | m_port_registers.sact;
+    size_t slots_count = min(m_command_table_pages.size(), m_hba_capabilities.max_command_list_entries_count);
+    for (size_t index = 0; index < slots_count; index++) {
         if (!(commands_issued & 1)) {
             dbgln_if(AHCI_DEBUG, "AHCI Port {}: unused command header at index {}", representative_port_index(), index);
             return index;
@@ -768,6 +800,14 @@ Optional<u8> AHCIPort::try_to_find_unused_command_header()
     return {};
 }
 
+bool AHCIPort::is_queued_command_done() const
+{
+    VERIFY(m_native_command_queuing_enabled);
+    if (!m_current_command_slot.has_value())
+        return true;
+    return !(m_port_registers.sact & (1u << m_current_command_slot.value()));
+}
+
 void AHCIPort::start_command_list_processing() const
 {
     VERIFY(m_lock.is_locked());
@@ -38,6 +38,9 @@ class AHCIPort
     friend class AHCIController;
 
 public:
+    // The DMA buffers are made of this many bytes, so a request of up to that size is done with a single command.
+    static constexpr size_t max_transfer_size = 16 * PAGE_SIZE;
+
     static ErrorOr<NonnullLockRefPtr<AHCIPort>> create(AHCIController const&, AHCI::HBADefinedCapabilities, volatile AHCI::PortRegisters&, u32 port_index);
 
     u32 port_index() const { return m_port_index; }
@@ -98,6 +101,7 @@ private:
     void set_interface_state(AHCI::DeviceDetectionInitialization);
 
     Optional<u8> try_to_find_unused_command_header();
+    bool is_queued_command_done() const;
 
     ALWAYS_INLINE bool is_interface_disabled() const { return (m_port_registers.ssts & 0xf) == 4; };
 
@@ -112,6 +116,11 @@ private:
 
     mutable bool m_wait_for_completion { false };
 
+    // Set if both the HBA and the device support Native Command Queuing, in which case reads and writes are done with
+    // READ/WRITE FPDMA QUEUED, and are tagged with the command slot they were issued in.
+    bool m_native_command_queuing_enabled { false };
+    Optional<u8> m_current_command_slot;
+
     NonnullRefPtrVector<Memory::PhysicalPage> m_dma_buffers;
     NonnullRefPtrVector<Memory::PhysicalPage> m_command_table_pages;
     RefPtr<Memory::PhysicalPage> m_command_list_page;
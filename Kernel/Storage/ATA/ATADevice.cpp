@@ -16,12 +16,14 @@ static StorageDevice::LUNAddress convert_ata_address_to_lun_address(ATAControlle
     return StorageDevice::LUNAddress { controller.controller_id(), ata_address.port, ata_address.subport };
 }
 
-ATADevice::ATADevice(ATAController const& controller, ATADevice::Address ata_address, u16 capabilities, u16 logical_sector_size, u64 max_addressable_block)
+ATADevice::ATADevice(ATAController const& controller, ATADevice::Address ata_address, u16 capabilities, u16 logical_sector_size, u64 max_addressable_block, size_t max_transfer_size)
     : StorageDevice(convert_ata_address_to_lun_address(controller, ata_address), controller.hardware_relative_controller_id(), logical_sector_size, max_addressable_block)
     , m_controller(controller)
     , m_ata_address(ata_address)
     , m_capabilities(capabilities)
+    , m_max_transfer_size(max_transfer_size)
 {
+    VERIFY(m_max_transfer_size >= block_size());
 }
 
 ATADevice::~ATADevice() = default;
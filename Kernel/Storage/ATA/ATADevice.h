@@ -32,15 +32,20 @@ public:
     // ^BlockDevice
     virtual void start_request(AsyncBlockDeviceRequest&) override;
 
+    // ^StorageDevice
+    virtual size_t max_blocks_per_request() const override { return m_max_transfer_size / block_size(); }
+
     u16 ata_capabilites() const { return m_capabilities; }
     Address const& ata_address() const { return m_ata_address; }
 
 protected:
-    ATADevice(ATAController const&, Address, u16, u16, u64);
+    ATADevice(ATAController const&, Address, u16, u16, u64, size_t max_transfer_size);
 
     LockWeakPtr<ATAController> m_controller;
     const Address m_ata_address;
     const u16 m_capabilities;
+    // How many bytes the controller's DMA buffers can take in one request.
+    const size_t m_max_transfer_size;
 };
 
 }
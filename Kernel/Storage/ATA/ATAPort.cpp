@@ -95,7 +95,7 @@ ErrorOr<void> ATAPort::detect_connected_devices()
             max_addressable_block = identify_block.user_addressable_logical_sectors_count;
         // FIXME: Don't assume all drives will have logical sector size of 512 bytes.
         ATADevice::Address address = { m_port_index, static_cast<u8>(device_index) };
-        m_ata_devices.append(ATADiskDevice::create(m_parent_ata_controller, address, capabilities, 512, max_addressable_block));
+        m_ata_devices.append(ATADiskDevice::create(m_parent_ata_controller, address, capabilities, 512, max_addressable_block, PAGE_SIZE));
     }
     return {};
 }
@@ -15,6 +15,7 @@
 #include <Kernel/Scheduler.h>
 #include <Kernel/Sections.h>
 #include <Kernel/ThreadTracer.h>
+#include <Kernel/Tracepoints.h>
 
 namespace Kernel {
 
@@ -42,6 +43,7 @@ ErrorOr<FlatPtr> handle(RegisterState& regs, FlatPtr function, FlatPtr arg1, Fla
     current_thread->did_syscall();
 
     PerformanceManager::add_syscall_event(*current_thread, regs);
+    Tracepoints::emit(TracepointType::SyscallEntry, function, arg1, arg2);
 
     if (function >= Function::__Count) {
         dbgln("Unknown syscall {} requested ({:p}, {:p}, {:p}, {:p})", function, arg1, arg2, arg3, arg4);
@@ -163,6 +165,7 @@ NEVER_INLINE void syscall_handler(TrapFrame* trap)
     } else {
         regs.set_return_reg(result.value());
     }
+    Tracepoints::emit(TracepointType::SyscallExit, function, result.is_error() ? -result.error().code() : result.value());
 
     if (auto* tracer = process.tracer(); tracer && tracer->is_tracing_syscalls()) {
         tracer->set_trace_syscalls(false);
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+// Larger requests are clamped, the caller just gets the remaining events on its next wait.
+static constexpr size_t max_events_per_wait = 1024;
+
+ErrorOr<FlatPtr> Process::sys$epoll_create(int flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if (flags & ~EPOLL_CLOEXEC)
+        return EINVAL;
+
+    auto event_poll = TRY(EventPoll::try_create());
+    auto description = TRY(OpenFileDescription::try_create(move(event_poll)));
+
+    description->set_readable(true);
+
+    u32 fd_flags = 0;
+    if (flags & EPOLL_CLOEXEC)
+        fd_flags |= FD_CLOEXEC;
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto new_fd = TRY(fds.allocate());
+        fds[new_fd.fd].set(move(description), fd_flags);
+        return new_fd.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_ctl(int epfd, int op, int fd, Userspace<struct epoll_event const*> user_event)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto epoll_description = TRY(open_file_description(epfd));
+    if (!epoll_description->file().is_event_poll())
+        return EINVAL;
+    auto& event_poll = static_cast<EventPoll&>(epoll_description->file());
+
+    if (op == EPOLL_CTL_DEL) {
+        // NOTE: We don't require fd to still be open, so callers can drop interests in files they've already closed.
+        TRY(event_poll.remove_interest(fd));
+        return 0;
+    }
+
+    auto event = TRY(copy_typed_from_user(user_event));
+    auto description = TRY(open_file_description(fd));
+
+    switch (op) {
+    case EPOLL_CTL_ADD:
+        TRY(event_poll.add_interest(fd, *description, event));
+        return 0;
+    case EPOLL_CTL_MOD:
+        TRY(event_poll.modify_interest(fd, *description, event));
+        return 0;
+    }
+    return EINVAL;
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_wait(Userspace<Syscall::SC_epoll_wait_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto params = TRY(copy_typed_from_user(user_params));
+    if (params.maxevents <= 0)
+        return EINVAL;
+
+    auto description = TRY(open_file_description(params.epfd));
+    if (!description->file().is_event_poll())
+        return EINVAL;
+    auto& event_poll = static_cast<EventPoll&>(description->file());
+
+    Thread::BlockTimeout timeout;
+    if (params.timeout) {
+        auto timeout_time = TRY(copy_time_from_user(params.timeout));
+        timeout = Thread::BlockTimeout(false, &timeout_time);
+    }
+
+    sigset_t sigmask = {};
+    if (params.sigmask)
+        TRY(copy_from_user(&sigmask, params.sigmask));
+
+    Vector<epoll_event, 32> events;
+    TRY(events.try_resize(min(static_cast<size_t>(params.maxevents), max_events_per_wait)));
+
+    auto* current_thread = Thread::current();
+
+    u32 previous_signal_mask = 0;
+    if (params.sigmask)
+        previous_signal_mask = current_thread->update_signal_mask(sigmask);
+    ScopeGuard rollback_signal_mask([&]() {
+        if (params.sigmask)
+            current_thread->update_signal_mask(previous_signal_mask);
+    });
+
+    size_t event_count = 0;
+    for (;;) {
+        event_count = TRY(event_poll.collect_ready_events(events.span()));
+        if (event_count > 0)
+            break;
+
+        // Interests that turned out not to be ready anymore were dropped from the ready list above,
+        // so this only returns once something has changed state again (or the deadline passes).
+        dbgln_if(POLL_SELECT_DEBUG, "epoll_wait: blocking on EventPoll {}", params.epfd);
+        auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+        auto block_result = current_thread->block<Thread::ReadBlocker>(timeout, *description, unblock_flags);
+        if (block_result.was_interrupted())
+            return EINTR;
+        if (block_result == Thread::BlockResult::InterruptedByTimeout)
+            break;
+    }
+
+    if (event_count > 0)
+        TRY(copy_to_user(params.events, events.data(), event_count * sizeof(epoll_event)));
+
+    return event_count;
+}
+
+}
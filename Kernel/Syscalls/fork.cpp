@@ -138,7 +138,12 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
             for (auto& region : parent_space->region_tree().regions()) {
                 dbgln_if(FORK_DEBUG, "fork: cloning Region '{}' @ {}", region.name(), region.vaddr());
                 auto region_clone = TRY(region.try_clone());
-                TRY(region_clone->map(child_space->page_directory(), Memory::ShouldFlushTLB::No));
+                // Anonymous and inode-backed pages can be faulted into the child on first access, so skip building
+                // page tables for them here. Most children exec() right away and would just throw them away.
+                if (region_clone->vmobject().is_anonymous() || region_clone->vmobject().is_inode())
+                    region_clone->set_page_directory(child_space->page_directory());
+                else
+                    TRY(region_clone->map(child_space->page_directory(), Memory::ShouldFlushTLB::No));
                 TRY(child_space->region_tree().place_specifically(*region_clone, region.range()));
                 auto* child_region = region_clone.leak_ptr();
 
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ScopeGuard.h>
 #include <AK/Singleton.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Memory/InodeVMObject.h>
@@ -106,11 +107,11 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     switch (cmd) {
     case FUTEX_WAIT:
     case FUTEX_WAIT_BITSET:
-    case FUTEX_REQUEUE:
-    case FUTEX_CMP_REQUEUE: {
+    case FUTEX_WAIT_MULTIPLE: {
+        // NOTE: FUTEX_REQUEUE and FUTEX_CMP_REQUEUE don't have a timeout, they use the same slot for the requeue count.
         if (params.timeout) {
             auto timeout_time = TRY(copy_time_from_user(params.timeout));
-            bool is_absolute = cmd != FUTEX_WAIT;
+            bool is_absolute = cmd == FUTEX_WAIT_BITSET;
             clockid_t clock_id = use_realtime_clock ? CLOCK_REALTIME_COARSE : CLOCK_MONOTONIC_COARSE;
             timeout = Thread::BlockTimeout(is_absolute, &timeout_time, nullptr, clock_id);
         }
@@ -205,6 +206,66 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
         return 0;
     };
 
+    auto do_wait_multiple = [&]() -> ErrorOr<FlatPtr> {
+        if (params.val == 0 || params.val > FUTEX_WAIT_MULTIPLE_MAX)
+            return EINVAL;
+
+        Vector<futex_wait_block, 8> wait_blocks;
+        TRY(wait_blocks.try_resize(params.val));
+        TRY(copy_n_from_user(wait_blocks.data(), reinterpret_cast<futex_wait_block const*>(params.userspace_address), wait_blocks.size()));
+
+        Vector<GlobalFutexKey, 8> futex_keys;
+        Vector<NonnullLockRefPtr<FutexQueue>, 8> futex_queues;
+        TRY(futex_keys.try_ensure_capacity(wait_blocks.size()));
+        TRY(futex_queues.try_ensure_capacity(wait_blocks.size()));
+
+        auto remove_empty_futex_queues = [&] {
+            for (size_t i = 0; i < futex_queues.size(); ++i) {
+                if (futex_queues[i]->is_empty_and_no_imminent_waits())
+                    remove_futex_queue(futex_keys[i]);
+            }
+        };
+
+        // If any of the futexes doesn't have the expected value, we won't be waiting on the ones we already queued for either.
+        ArmedScopeGuard cancel_imminent_waits([&] {
+            for (auto& futex_queue : futex_queues)
+                futex_queue->cancel_imminent_wait();
+            remove_empty_futex_queues();
+        });
+
+        for (auto& wait_block : wait_blocks) {
+            auto futex_key = TRY(get_futex_key(FlatPtr(wait_block.uaddr), shared));
+            bool did_create;
+            LockRefPtr<FutexQueue> futex_queue;
+            do {
+                auto user_value = user_atomic_load_relaxed(wait_block.uaddr);
+                if (!user_value.has_value())
+                    return EFAULT;
+                if (user_value.value() != wait_block.val) {
+                    dbgln_if(FUTEX_DEBUG, "futex wait multiple: EAGAIN. user value: {:p} @ {:p} != val: {}", user_value.value(), wait_block.uaddr, wait_block.val);
+                    return EAGAIN;
+                }
+                atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+
+                did_create = false;
+                futex_queue = TRY(find_futex_queue(futex_key, true, &did_create));
+                VERIFY(futex_queue);
+            } while (!did_create && !futex_queue->queue_imminent_wait());
+
+            futex_keys.unchecked_append(futex_key);
+            futex_queues.unchecked_append(futex_queue.release_nonnull());
+        }
+        cancel_imminent_waits.disarm();
+
+        size_t woken_index = 0;
+        Thread::BlockResult block_result = FutexQueue::wait_on_any(timeout, futex_queues.span(), woken_index);
+
+        remove_empty_futex_queues();
+        if (block_result == Thread::BlockResult::InterruptedByTimeout)
+            return ETIMEDOUT;
+        return woken_index;
+    };
+
     auto do_requeue = [&](Optional<u32> val3) -> ErrorOr<FlatPtr> {
         auto user_value = user_atomic_load_relaxed(params.userspace_address);
         if (!user_value.has_value())
@@ -319,6 +380,9 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
             return EINVAL;
         return do_wait(params.val3);
 
+    case FUTEX_WAIT_MULTIPLE:
+        return do_wait_multiple();
+
     case FUTEX_WAKE_BITSET:
         VERIFY(params.val3 != FUTEX_BITSET_MATCH_ANY); // we should have turned it into FUTEX_WAKE
         if (params.val3 == 0)
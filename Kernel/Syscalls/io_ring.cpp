@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+ErrorOr<FlatPtr> Process::sys$io_ring_create(u32 entries, int options)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto ring = TRY(IORing::try_create(entries));
+    auto description = TRY(OpenFileDescription::try_create(move(ring)));
+
+    description->set_readable(true);
+    description->set_writable(true);
+
+    u32 fd_flags = 0;
+    if (options & O_CLOEXEC)
+        fd_flags |= FD_CLOEXEC;
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto new_fd = TRY(fds.allocate());
+        fds[new_fd.fd].set(move(description), fd_flags);
+        return new_fd.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::perform_io_ring_submission(IORingSubmission const& submission)
+{
+    if (submission.length > NumericLimits<ssize_t>::max())
+        return EINVAL;
+    auto user_address = static_cast<FlatPtr>(submission.address);
+    auto size = static_cast<size_t>(submission.length);
+
+    switch (submission.operation) {
+    case IORingOperation::Nop:
+        return 0;
+    case IORingOperation::Read:
+        return read_impl(submission.fd, Userspace<u8*> { user_address }, size);
+    case IORingOperation::Write:
+        return sys$write(submission.fd, Userspace<u8 const*> { user_address }, size);
+    case IORingOperation::PRead: {
+        if (submission.offset > static_cast<u64>(NumericLimits<off_t>::max()))
+            return EINVAL;
+        auto description = TRY(open_file_description(submission.fd));
+        if (!description->is_readable())
+            return EBADF;
+        if (description->is_directory())
+            return EISDIR;
+        if (!description->file().is_seekable())
+            return EINVAL;
+        if (size == 0)
+            return 0;
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(Userspace<u8*> { user_address }, size));
+        return TRY(description->read(buffer, submission.offset, size));
+    }
+    case IORingOperation::PWrite: {
+        if (submission.offset > static_cast<u64>(NumericLimits<off_t>::max()))
+            return EINVAL;
+        auto description = TRY(open_file_description(submission.fd));
+        if (!description->is_writable())
+            return EBADF;
+        if (!description->file().is_seekable())
+            return EINVAL;
+        if (size == 0)
+            return 0;
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(Userspace<u8 const*> { user_address }, size));
+        return do_write(*description, buffer, size, static_cast<off_t>(submission.offset));
+    }
+    }
+    return EINVAL;
+}
+
+ErrorOr<FlatPtr> Process::sys$io_ring_enter(int fd, u32 to_submit)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto description = TRY(open_file_description(fd));
+    if (!description->file().is_io_ring())
+        return EBADF;
+    auto& ring = static_cast<IORing&>(description->file());
+
+    MutexLocker locker(ring.submission_lock());
+    u32 submitted = 0;
+    // Note: Never consume a submission we don't have room to post the completion for.
+    while (submitted < to_submit && !ring.completion_queue_full()) {
+        auto submission = ring.pop_submission();
+        if (!submission.has_value())
+            break;
+        ++submitted;
+
+        auto result = perform_io_ring_submission(submission.value());
+        i64 completion_result = result.is_error() ? -static_cast<i64>(result.error().code()) : static_cast<i64>(result.value());
+        dbgln_if(IO_DEBUG, "sys$io_ring_enter({}): operation {} on fd {} -> {}", fd, to_underlying(submission->operation), submission->fd, completion_result);
+        ring.push_completion({ .user_data = submission->user_data, .result = completion_result });
+
+        // Let the signal that interrupted us be dispatched instead of blocking on the rest of the batch.
+        if (result.is_error() && result.error().code() == EINTR)
+            break;
+    }
+    return submitted;
+}
+
+}
@@ -208,6 +208,10 @@ ErrorOr<FlatPtr> Process::sys$mmap(Userspace<Syscall::SC_mmap_params const*> use
         } else {
             vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(rounded_size, strategy));
         }
+
+        // Place large private mappings on a huge page boundary so the fault handler can back them with huge pages.
+        if (!map_shared && !map_stack && !(flags & MAP_PURGEABLE) && requested_range.base().is_null() && rounded_size >= Memory::HUGE_PAGE_SIZE && alignment < Memory::HUGE_PAGE_SIZE)
+            alignment = Memory::HUGE_PAGE_SIZE;
     } else {
         if (offset < 0)
             return EINVAL;
@@ -436,6 +440,13 @@ ErrorOr<FlatPtr> Process::sys$madvise(Userspace<void*> address, size_t size, int
             TRY(vmobject.set_volatile(advice == MADV_SET_VOLATILE, was_purged));
             return was_purged ? 1 : 0;
         }
+        if (advice == MADV_HUGEPAGE || advice == MADV_NOHUGEPAGE) {
+            if (!region->vmobject().is_anonymous())
+                return EINVAL;
+            // NOTE: This only affects future faults, huge pages that are already mapped stay as they are.
+            region->set_huge_pages_disabled(advice == MADV_NOHUGEPAGE);
+            return 0;
+        }
         return EINVAL;
     });
 }
@@ -64,7 +64,7 @@ ErrorOr<FlatPtr> Process::sys$scheduler_set_parameters(Userspace<Syscall::SC_sch
     TRY(require_promise(Pledge::proc));
     auto parameters = TRY(copy_typed_from_user(user_param));
 
-    if (parameters.parameters.sched_priority < THREAD_PRIORITY_MIN || parameters.parameters.sched_priority > THREAD_PRIORITY_MAX)
+    if (parameters.parameters.sched_priority < THREAD_PRIORITY_MIN || parameters.parameters.sched_priority > THREAD_PRIORITY_REALTIME)
         return EINVAL;
 
     SpinlockLocker lock(g_scheduler_lock);
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/KBuffer.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+// Note: The data still bounces through one kernel buffer (the socket layer copies it into packet buffers
+//       anyway), but it never has to be copied out to and back in from userspace, and a whole file can go
+//       out with a single syscall.
+static constexpr size_t sendfile_chunk_size = 64 * KiB;
+
+// NOTE: The offset is passed by pointer because off_t is 64bit,
+// hence it can't be passed by register on 32bit platforms.
+ErrorOr<FlatPtr> Process::sys$sendfile(int out_fd, int in_fd, Userspace<off_t*> userspace_offset, size_t count)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    if (count == 0)
+        return 0;
+    if (count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    auto in_description = TRY(open_file_description(in_fd));
+    if (!in_description->is_readable())
+        return EBADF;
+    if (in_description->is_directory())
+        return EISDIR;
+    if (!in_description->inode() || !in_description->file().is_seekable())
+        return EINVAL;
+
+    auto out_description = TRY(open_file_description(out_fd));
+    if (!out_description->is_writable())
+        return EBADF;
+
+    Optional<off_t> offset;
+    if (userspace_offset.ptr()) {
+        offset = TRY(copy_typed_from_user(userspace_offset));
+        if (offset.value() < 0)
+            return EINVAL;
+    }
+
+    dbgln_if(IO_DEBUG, "sys$sendfile({}, {}, {}, {})", out_fd, in_fd, offset.value_or(-1), count);
+
+    auto chunk = TRY(KBuffer::try_create_with_size("sendfile"sv, min(count, sendfile_chunk_size)));
+    auto chunk_buffer = UserOrKernelBuffer::for_kernel_buffer(chunk->data());
+
+    size_t total_nsent = 0;
+    while (total_nsent < count) {
+        auto to_read = min(count - total_nsent, chunk->size());
+        auto nread_or_error = offset.has_value()
+            ? in_description->read(chunk_buffer, offset.value() + total_nsent, to_read)
+            : in_description->read(chunk_buffer, to_read);
+        if (nread_or_error.is_error()) {
+            if (total_nsent == 0)
+                return nread_or_error.release_error();
+            break;
+        }
+        auto nread = nread_or_error.value();
+        if (nread == 0)
+            break;
+
+        auto nwritten_or_error = do_write(*out_description, chunk_buffer, nread);
+        size_t nwritten = nwritten_or_error.is_error() ? 0 : nwritten_or_error.value();
+        if (nwritten < nread && !offset.has_value()) {
+            // Put back whatever we have read but couldn't get rid of.
+            (void)in_description->seek(-static_cast<off_t>(nread - nwritten), SEEK_CUR);
+        }
+        if (nwritten_or_error.is_error()) {
+            if (total_nsent == 0)
+                return nwritten_or_error.release_error();
+            break;
+        }
+        total_nsent += nwritten;
+        if (nwritten < nread)
+            break;
+    }
+
+    if (offset.has_value()) {
+        off_t new_offset = offset.value() + total_nsent;
+        TRY(copy_to_user(userspace_offset, &new_offset));
+    }
+    return total_nsent;
+}
+
+}
@@ -362,7 +362,7 @@ ErrorOr<FlatPtr> Process::sys$setsockopt(Userspace<Syscall::SC_setsockopt_params
         return ENOTSOCK;
     auto& socket = *description->socket();
     REQUIRE_PROMISE_FOR_SOCKET_DOMAIN(socket.domain());
-    TRY(socket.setsockopt(params.level, params.option, user_value, params.value_size));
+    TRY(socket.setsockopt(*description, params.level, params.option, user_value, params.value_size));
     return 0;
 }
 
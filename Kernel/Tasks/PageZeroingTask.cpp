@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Process.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/PageZeroingTask.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT void PageZeroingTask::spawn()
+{
+    LockRefPtr<Thread> page_zeroing_thread;
+    (void)Process::create_kernel_process(page_zeroing_thread, KString::must_create("Page Zeroing Task"sv), [] {
+        Thread::current()->set_priority(THREAD_PRIORITY_MIN);
+        for (;;) {
+            if (MM.zeroed_page_pool_needs_refill())
+                MM.refill_zeroed_page_pool();
+            (void)Thread::current()->sleep(Time::from_milliseconds(50));
+        }
+    });
+}
+
+}
@@ -21,13 +21,14 @@
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/ScopedAddressSpaceSwitcher.h>
 #include <Kernel/Panic.h>
-#include <Kernel/PerformanceEventBuffer.h>
+#include <Kernel/PerformanceManager.h>
 #include <Kernel/Process.h>
 #include <Kernel/ProcessExposed.h>
 #include <Kernel/Scheduler.h>
 #include <Kernel/Sections.h>
 #include <Kernel/Thread.h>
 #include <Kernel/ThreadTracer.h>
+#include <Kernel/Time/TimeManagement.h>
 #include <Kernel/TimerQueue.h>
 #include <Kernel/kstdio.h>
 
@@ -104,6 +105,35 @@ Thread::~Thread()
     VERIFY(m_runnable_priority < 0);
 }
 
+static StringView blocker_type_name(Thread::Blocker::Type type)
+{
+    switch (type) {
+    case Thread::Blocker::Type::File:
+        return "file"sv;
+    case Thread::Blocker::Type::Futex:
+        return "futex"sv;
+    case Thread::Blocker::Type::Plan9FS:
+        return "plan9fs"sv;
+    case Thread::Blocker::Type::Join:
+        return "join"sv;
+    case Thread::Blocker::Type::Queue:
+        return "queue"sv;
+    case Thread::Blocker::Type::Routing:
+        return "routing"sv;
+    case Thread::Blocker::Type::Sleep:
+        return "sleep"sv;
+    case Thread::Blocker::Type::Signal:
+        return "signal"sv;
+    case Thread::Blocker::Type::Wait:
+        return "wait"sv;
+    case Thread::Blocker::Type::Flock:
+        return "flock"sv;
+    case Thread::Blocker::Type::Unknown:
+        break;
+    }
+    return "unknown"sv;
+}
+
 Thread::BlockResult Thread::block_impl(BlockTimeout const& timeout, Blocker& blocker)
 {
     VERIFY(!Processor::current_in_irq());
@@ -172,6 +202,10 @@ Thread::BlockResult Thread::block_impl(BlockTimeout const& timeout, Blocker& blo
     scheduler_lock.unlock();
 
     dbgln_if(THREAD_DEBUG, "Thread {} blocking on {} ({}) -->", *this, &blocker, blocker.state_string());
+    bool const record_off_cpu = PerformanceManager::should_record_off_cpu_events(*this);
+    Time off_cpu_start;
+    if (record_off_cpu)
+        off_cpu_start = TimeManagement::the().monotonic_time(TimePrecision::Precise);
     bool did_timeout = false;
     u32 lock_count_to_restore = 0;
     auto previous_locked = unlock_process_if_locked(lock_count_to_restore);
@@ -205,6 +239,11 @@ Thread::BlockResult Thread::block_impl(BlockTimeout const& timeout, Blocker& blo
     // to clean up now while we're still holding m_lock
     auto result = blocker.end_blocking({}, did_timeout); // calls was_unblocked internally
 
+    if (record_off_cpu) {
+        auto off_cpu_duration = TimeManagement::the().monotonic_time(TimePrecision::Precise) - off_cpu_start;
+        PerformanceManager::add_off_cpu_event(*this, blocker_type_name(blocker.blocker_type()), blocker.state_string(), off_cpu_duration.to_nanoseconds());
+    }
+
     if (timer_was_added && !did_timeout) {
         // Cancel the timer while not holding any locks. This allows
         // the timer function to complete before we remove it
@@ -258,6 +297,11 @@ void Thread::block(Kernel::Mutex& lock, SpinlockLocker<Spinlock<LockRank::None>>
 
     dbgln_if(THREAD_DEBUG, "Thread {} blocking on Mutex {}", *this, &lock);
 
+    bool const record_off_cpu = PerformanceManager::should_record_off_cpu_events(*this);
+    Time off_cpu_start;
+    if (record_off_cpu)
+        off_cpu_start = TimeManagement::the().monotonic_time(TimePrecision::Precise);
+
     for (;;) {
         // Yield to the scheduler, and wait for us to resume unblocked.
         VERIFY(!g_scheduler_lock.is_locked_by_current_processor());
@@ -280,6 +324,11 @@ void Thread::block(Kernel::Mutex& lock, SpinlockLocker<Spinlock<LockRank::None>>
         break;
     }
 
+    if (record_off_cpu) {
+        auto off_cpu_duration = TimeManagement::the().monotonic_time(TimePrecision::Precise) - off_cpu_start;
+        PerformanceManager::add_off_cpu_event(*this, "mutex"sv, lock.name(), off_cpu_duration.to_nanoseconds());
+    }
+
     lock_lock.lock();
 }
 
@@ -1271,6 +1320,10 @@ void Thread::set_state(State new_state, u8 stop_signal)
         }
     }
 
+    // A realtime thread that blocks gets to run ahead of everything else again once it's woken up.
+    if (m_state == Thread::State::Blocked)
+        m_realtime_throttled = false;
+
     if (m_state == Thread::State::Runnable) {
         Scheduler::enqueue_runnable_thread(*this);
         Processor::smp_wake_n_idle_processors(1);
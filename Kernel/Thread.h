@@ -79,6 +79,9 @@ public:
     void set_priority(u32 p) { m_priority = p; }
     u32 priority() const { return m_priority; }
 
+    bool is_realtime() const { return m_priority == THREAD_PRIORITY_REALTIME && !m_realtime_throttled; }
+    void set_realtime_throttled(bool throttled) { m_realtime_throttled = throttled; }
+
     void detach()
     {
         SpinlockLocker lock(m_lock);
@@ -389,7 +392,7 @@ public:
             Vector<BlockerInfo, 4> taken_blockers;
             taken_blockers.ensure_capacity(move_count);
             for (size_t i = 0; i < move_count; i++)
-                taken_blockers.append(m_blockers.take(i));
+                taken_blockers.unchecked_append(m_blockers[i]);
             m_blockers.remove(0, move_count);
             return taken_blockers;
         }
@@ -403,8 +406,8 @@ public:
                 return;
             }
             m_blockers.ensure_capacity(m_blockers.size() + blockers_to_append.size());
-            for (size_t i = 0; i < blockers_to_append.size(); i++)
-                m_blockers.append(blockers_to_append.take(i));
+            for (auto& info : blockers_to_append)
+                m_blockers.unchecked_append(info);
             blockers_to_append.clear();
         }
 
@@ -441,7 +444,7 @@ public:
         virtual ~WaitQueueBlocker();
 
         virtual Type blocker_type() const override { return Type::Queue; }
-        virtual StringView state_string() const override { return m_block_reason.is_null() ? m_block_reason : "Queue"sv; }
+        virtual StringView state_string() const override { return m_block_reason.is_null() ? "Queue"sv : m_block_reason; }
         virtual void will_unblock_immediately_without_blocking(UnblockImmediatelyReason) override { }
         virtual bool setup_blocker() override;
 
@@ -456,14 +459,19 @@ public:
     class FutexBlocker final : public Blocker {
     public:
         explicit FutexBlocker(FutexQueue&, u32);
+        // Waits on all of the given queues at once, until any one of them wakes us up.
+        // The index of that queue, in the order they were passed in, is stored in woken_queue_index.
+        FutexBlocker(ReadonlySpan<NonnullLockRefPtr<FutexQueue>>, size_t& woken_queue_index);
         virtual ~FutexBlocker();
 
         virtual Type blocker_type() const override { return Type::Futex; }
         virtual StringView state_string() const override { return "Futex"sv; }
         virtual void will_unblock_immediately_without_blocking(UnblockImmediatelyReason) override { }
         virtual bool setup_blocker() override;
+        virtual void finalize() override;
 
         u32 bitset() const { return m_bitset; }
+        bool is_waiting_on_multiple_queues() const { return m_futex_queues.size() > 1; }
 
         void begin_requeue()
         {
@@ -472,13 +480,18 @@ public:
         }
         void finish_requeue(FutexQueue&);
 
-        bool unblock_bitset(u32 bitset);
-        bool unblock(bool force = false);
+        // The data is what the blocker was added to the queue with, i.e. the index of that queue.
+        bool unblock_bitset(u32 bitset, void* data);
+        bool unblock(void* data, bool force = false);
 
     protected:
-        FutexQueue& m_futex_queue;
+        bool do_unblock(void* data);
+
+        FutexQueue* m_single_futex_queue { nullptr };
+        ReadonlySpan<NonnullLockRefPtr<FutexQueue>> m_futex_queues;
         u32 m_bitset { 0 };
         InterruptsState m_previous_interrupts_state { InterruptsState::Disabled };
+        size_t* m_woken_queue_index { nullptr };
         bool m_did_unblock { false };
     };
 
@@ -1089,6 +1102,7 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    u32 m_runnable_processor { 0 };
 
     friend class WaitQueue;
 
@@ -1223,6 +1237,7 @@ private:
     State m_state { Thread::State::Invalid };
     SpinlockProtected<NonnullOwnPtr<KString>, LockRank::None> m_name;
     u32 m_priority { THREAD_PRIORITY_NORMAL };
+    bool m_realtime_throttled { false };
 
     State m_stop_state { Thread::State::Invalid };
 
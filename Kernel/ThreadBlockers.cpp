@@ -8,6 +8,7 @@
 #include <AK/BuiltinWrappers.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/FutexQueue.h>
 #include <Kernel/Net/Socket.h>
 #include <Kernel/Process.h>
 #include <Kernel/Scheduler.h>
@@ -147,14 +148,40 @@ bool Thread::WaitQueueBlocker::unblock()
 }
 
 Thread::FutexBlocker::FutexBlocker(FutexQueue& futex_queue, u32 bitset)
-    : m_futex_queue(futex_queue)
+    : m_single_futex_queue(&futex_queue)
     , m_bitset(bitset)
 {
 }
 
+Thread::FutexBlocker::FutexBlocker(ReadonlySpan<NonnullLockRefPtr<FutexQueue>> futex_queues, size_t& woken_queue_index)
+    : m_futex_queues(futex_queues)
+    , m_bitset(FUTEX_BITSET_MATCH_ANY)
+    , m_woken_queue_index(&woken_queue_index)
+{
+    VERIFY(!m_futex_queues.is_empty());
+}
+
 bool Thread::FutexBlocker::setup_blocker()
 {
-    return add_to_blocker_set(m_futex_queue);
+    if (m_single_futex_queue)
+        return add_to_blocker_set(*m_single_futex_queue);
+
+    // NOTE: We keep going after a queue refuses us, every queue expects us to show up after queueing an imminent wait.
+    //       If we don't end up blocking, finalize() takes us off the queues again.
+    bool added_to_all = add_to_blocker_set(*m_futex_queues[0]);
+    for (size_t i = 1; i < m_futex_queues.size(); ++i) {
+        if (!m_futex_queues[i]->add_blocker(*this, reinterpret_cast<void*>(i)))
+            added_to_all = false;
+    }
+    return added_to_all;
+}
+
+void Thread::FutexBlocker::finalize()
+{
+    Blocker::finalize();
+    // The first queue is the one we're registered with as our blocker set, only the others are left to us.
+    for (size_t i = 1; i < m_futex_queues.size(); ++i)
+        m_futex_queues[i]->remove_blocker(*this);
 }
 
 Thread::FutexBlocker::~FutexBlocker() = default;
@@ -162,32 +189,43 @@ Thread::FutexBlocker::~FutexBlocker() = default;
 void Thread::FutexBlocker::finish_requeue(FutexQueue& futex_queue)
 {
     VERIFY(m_lock.is_locked_by_current_processor());
+    VERIFY(!is_waiting_on_multiple_queues());
     set_blocker_set_raw_locked(&futex_queue);
     // We can now release the lock
     m_lock.unlock(m_previous_interrupts_state);
 }
 
-bool Thread::FutexBlocker::unblock_bitset(u32 bitset)
+bool Thread::FutexBlocker::do_unblock(void* data)
+{
+    VERIFY(m_lock.is_locked());
+    if (m_did_unblock)
+        return false;
+    m_did_unblock = true;
+    if (m_woken_queue_index)
+        *m_woken_queue_index = reinterpret_cast<size_t>(data);
+    return true;
+}
+
+bool Thread::FutexBlocker::unblock_bitset(u32 bitset, void* data)
 {
     {
         SpinlockLocker lock(m_lock);
-        if (m_did_unblock || (bitset != FUTEX_BITSET_MATCH_ANY && (m_bitset & bitset) == 0))
+        if (bitset != FUTEX_BITSET_MATCH_ANY && (m_bitset & bitset) == 0)
+            return false;
+        if (!do_unblock(data))
             return false;
-
-        m_did_unblock = true;
     }
 
     unblock_from_blocker();
     return true;
 }
 
-bool Thread::FutexBlocker::unblock(bool force)
+bool Thread::FutexBlocker::unblock(void* data, bool force)
 {
     {
         SpinlockLocker lock(m_lock);
-        if (m_did_unblock)
+        if (!do_unblock(data))
             return force;
-        m_did_unblock = true;
     }
 
     unblock_from_blocker();
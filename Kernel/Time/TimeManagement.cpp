@@ -241,6 +241,11 @@ UNMAP_AFTER_INIT TimeManagement::TimeManagement()
     : m_time_page_region(MM.allocate_kernel_region(PAGE_SIZE, "Time page"sv, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow).release_value_but_fixme_should_propagate_errors())
 {
 #if ARCH(X86_64)
+    // Userspace can only extrapolate from the TSC if it ticks at the same rate on every processor, in every power state.
+    m_can_use_tsc_for_time_page = Processor::current().has_feature(CPUFeature::TSC)
+        && Processor::current().has_feature(CPUFeature::CONSTANT_TSC)
+        && Processor::current().has_feature(CPUFeature::NONSTOP_TSC);
+
     bool probe_non_legacy_hardware_timers = !(kernel_command_line().is_legacy_time_enabled());
     if (ACPI::is_enabled()) {
         if (!ACPI::Parser::the()->x86_specific_flags().cmos_rtc_not_present) {
@@ -535,9 +540,44 @@ void TimeManagement::update_time_page()
     u32 update_iteration = AK::atomic_fetch_add(&page.update2, 1u, AK::MemoryOrder::memory_order_acquire);
     page.clocks[CLOCK_REALTIME_COARSE] = m_epoch_time;
     page.clocks[CLOCK_MONOTONIC_COARSE] = monotonic_time(TimePrecision::Coarse).to_timespec();
+#if ARCH(X86_64)
+    update_time_page_tsc_calibration(page);
+#endif
     AK::atomic_store(&page.update1, update_iteration + 1u, AK::MemoryOrder::memory_order_release);
 }
 
+#if ARCH(X86_64)
+void TimeManagement::update_time_page_tsc_calibration(TimePage& page)
+{
+    if (!m_can_use_tsc_for_time_page)
+        return;
+
+    auto monotonic = monotonic_time(TimePrecision::Precise);
+    auto tsc = Processor::read_cpu_counter();
+    auto now_ns = monotonic.to_nanoseconds();
+
+    // Recalibrate against the time keeper about once a second. The window has to stay
+    // below 2^32 ns so that the shifted numerator doesn't overflow.
+    constexpr i64 calibration_window_ns = 1'000'000'000;
+    constexpr i64 max_calibration_window_ns = 4'000'000'000;
+    auto elapsed_ns = now_ns - m_tsc_calibration_base_ns;
+    if (m_tsc_calibration_base_tsc == 0 || elapsed_ns >= max_calibration_window_ns || tsc <= m_tsc_calibration_base_tsc) {
+        m_tsc_calibration_base_tsc = tsc;
+        m_tsc_calibration_base_ns = now_ns;
+    } else if (elapsed_ns >= calibration_window_ns) {
+        m_tsc_to_ns_multiplier = (static_cast<u64>(elapsed_ns) << 32) / (tsc - m_tsc_calibration_base_tsc);
+        m_tsc_calibration_base_tsc = tsc;
+        m_tsc_calibration_base_ns = now_ns;
+    }
+
+    page.tsc_base = tsc;
+    page.tsc_to_ns_multiplier = m_tsc_to_ns_multiplier;
+    page.clocks[CLOCK_MONOTONIC] = monotonic.to_timespec();
+    page.clocks[CLOCK_MONOTONIC_RAW] = monotonic.to_timespec();
+    page.clocks[CLOCK_REALTIME] = m_epoch_time;
+}
+#endif
+
 TimePage& TimeManagement::time_page()
 {
     return *static_cast<TimePage*>((void*)m_time_page_region->vaddr().as_ptr());
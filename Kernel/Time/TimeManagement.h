@@ -79,6 +79,9 @@ public:
 private:
     TimePage& time_page();
     void update_time_page();
+#if ARCH(X86_64)
+    void update_time_page_tsc_calibration(TimePage&);
+#endif
 
 #if ARCH(X86_64)
     bool probe_and_set_x86_legacy_hardware_timers();
@@ -117,6 +120,14 @@ private:
     LockRefPtr<HardwareTimerBase> m_profile_timer;
 
     NonnullOwnPtr<Memory::Region> m_time_page_region;
+
+#if ARCH(X86_64)
+    // Only touched from update_time_page(), which runs on the time keeper interrupt.
+    bool m_can_use_tsc_for_time_page { false };
+    u64 m_tsc_calibration_base_tsc { 0 };
+    i64 m_tsc_calibration_base_ns { 0 };
+    u64 m_tsc_to_ns_multiplier { 0 };
+#endif
 };
 
 }
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/InterruptDisabler.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Process.h>
+#include <Kernel/StdLib.h>
+#include <Kernel/Thread.h>
+#include <Kernel/Time/TimeManagement.h>
+#include <Kernel/Tracepoints.h>
+
+namespace Kernel {
+
+Atomic<u64, AK::MemoryOrder::memory_order_relaxed> g_tracepoint_mask;
+
+static Memory::AnonymousVMObject* s_vmobject;
+static Atomic<u8*> s_rings;
+
+u32 Tracepoints::cpu_count()
+{
+#if ARCH(X86_64)
+    return Processor::count();
+#else
+    // FIXME: Use Processor::count() once it is implemented on other architectures.
+    return 1;
+#endif
+}
+
+ErrorOr<NonnullLockRefPtr<Memory::AnonymousVMObject>> Tracepoints::ensure_buffer()
+{
+    if (s_vmobject)
+        return NonnullLockRefPtr<Memory::AnonymousVMObject>(*s_vmobject);
+
+    size_t ring_size = tracepoint_ring_size();
+    size_t size = cpu_count() * ring_size;
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(size, AllocationStrategy::AllocateNow));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, size, "Tracepoints"sv, Memory::Region::Access::ReadWrite));
+
+    // Touch every page now, the record path runs with interrupts disabled and must not fault.
+    auto* rings = region->vaddr().as_ptr();
+    memset(rings, 0, size);
+    for (u32 cpu = 0; cpu < cpu_count(); ++cpu) {
+        auto& header = *reinterpret_cast<TracepointRingHeader*>(rings + cpu * ring_size);
+        header.mask = TRACEPOINT_RING_ENTRIES - 1;
+        header.entry_count = TRACEPOINT_RING_ENTRIES;
+        header.entries_offset = sizeof(TracepointRingHeader);
+    }
+
+    (void)region.leak_ptr();
+    s_vmobject = &vmobject.leak_ref();
+    s_rings.store(rings, AK::MemoryOrder::memory_order_release);
+    return NonnullLockRefPtr<Memory::AnonymousVMObject>(*s_vmobject);
+}
+
+void Tracepoints::set_enabled_mask(u64 mask)
+{
+    g_tracepoint_mask.store(mask & TRACEPOINT_ALL);
+}
+
+void Tracepoints::record(TracepointType type, u64 arg0, u64 arg1, u64 arg2)
+{
+    auto* rings = s_rings.load(AK::MemoryOrder::memory_order_acquire);
+    if (!rings)
+        return;
+
+    auto timestamp = TimeManagement::the().monotonic_time(TimePrecision::Precise).to_nanoseconds();
+    auto* current_thread = Thread::current();
+
+    // Each CPU only ever appends to its own ring, so with interrupts off there is exactly one producer.
+    // The header is shared with userspace, so only tail is read from it and everything else is derived
+    // from our own constants.
+    InterruptDisabler disabler;
+    auto cpu = Processor::current_id();
+    auto* ring = rings + cpu * tracepoint_ring_size();
+    auto& header = *reinterpret_cast<TracepointRingHeader*>(ring);
+
+    auto head = AK::atomic_load(&header.head, AK::MemoryOrder::memory_order_relaxed);
+    auto tail = AK::atomic_load(&header.tail, AK::MemoryOrder::memory_order_acquire);
+    if (head - tail >= TRACEPOINT_RING_ENTRIES) {
+        AK::atomic_fetch_add(&header.dropped, 1u, AK::MemoryOrder::memory_order_relaxed);
+        return;
+    }
+
+    auto* entries = reinterpret_cast<TracepointRecord*>(ring + sizeof(TracepointRingHeader));
+    auto& entry = entries[head & (TRACEPOINT_RING_ENTRIES - 1)];
+    entry.timestamp_ns = timestamp;
+    entry.type = static_cast<u16>(type);
+    entry.cpu = cpu;
+    entry.pid = current_thread ? current_thread->pid().value() : 0;
+    entry.tid = current_thread ? current_thread->tid().value() : 0;
+    entry.reserved = 0;
+    entry.args[0] = arg0;
+    entry.args[1] = arg1;
+    entry.args[2] = arg2;
+    AK::atomic_store(&header.head, head + 1, AK::MemoryOrder::memory_order_release);
+}
+
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Error.h>
+#include <Kernel/API/Tracepoint.h>
+#include <Kernel/Library/NonnullLockRefPtr.h>
+
+namespace Kernel {
+
+namespace Memory {
+class AnonymousVMObject;
+}
+
+extern Atomic<u64, AK::MemoryOrder::memory_order_relaxed> g_tracepoint_mask;
+
+class Tracepoints {
+public:
+    ALWAYS_INLINE static bool is_enabled(TracepointType type)
+    {
+        return (g_tracepoint_mask.load() & tracepoint_type_bit(type)) != 0;
+    }
+
+    ALWAYS_INLINE static void emit(TracepointType type, u64 arg0 = 0, u64 arg1 = 0, u64 arg2 = 0)
+    {
+        if (is_enabled(type)) [[unlikely]]
+            record(type, arg0, arg1, arg2);
+    }
+
+    static u32 cpu_count();
+
+    // Allocates the per-CPU rings the first time a consumer asks for them. They are kept around
+    // afterwards, so the record path never has to worry about them going away underneath it.
+    static ErrorOr<NonnullLockRefPtr<Memory::AnonymousVMObject>> ensure_buffer();
+
+    static void set_enabled_mask(u64);
+
+private:
+    static void record(TracepointType, u64 arg0, u64 arg1, u64 arg2);
+};
+
+}
@@ -188,6 +188,13 @@ BrowserWindow::BrowserWindow(Browser::CookieJar& cookie_jar, StringView webdrive
         debug_request("dump-style-sheets");
     });
 
+    auto* dump_rendering_timings_action = new QAction("Dump Rendering Timings", this);
+    dump_rendering_timings_action->setIcon(QIcon(QString("%1/res/icons/16x16/layout.png").arg(s_serenity_resource_root.characters())));
+    debug_menu->addAction(dump_rendering_timings_action);
+    QObject::connect(dump_rendering_timings_action, &QAction::triggered, this, [this] {
+        debug_request("dump-rendering-timings");
+    });
+
     auto* dump_history_action = new QAction("Dump History", this);
     dump_history_action->setIcon(QIcon(QString("%1/res/icons/16x16/history.png").arg(s_serenity_resource_root.characters())));
     debug_menu->addAction(dump_history_action);
@@ -604,6 +604,8 @@ void WebContentView::create_client()
 
     auto new_client = MUST(adopt_nonnull_ref_or_enomem(new (nothrow) WebView::WebContentClient(std::move(socket), *this)));
     new_client->set_fd_passing_socket(MUST(Core::LocalSocket::adopt_fd(ui_fd_passing_fd)));
+    // If the server doesn't want it, messages keep going through the socket.
+    (void)new_client->request_shared_ring_transport();
 
     m_web_content_notifier.setSocket(new_client->socket().fd().value());
     m_web_content_notifier.setEnabled(true);
@@ -60,6 +60,7 @@ set(FILE_WATCHER_DEBUG ON)
 set(FILL_PATH_DEBUG ON)
 set(FORK_DEBUG ON)
 set(FRAMEBUFFER_DEVICE_DEBUG ON)
+set(FUNCTION_DEBUG ON)
 set(FUTEX_DEBUG ON)
 set(FUTEXQUEUE_DEBUG ON)
 set(GEMINI_DEBUG ON)
@@ -78,6 +79,7 @@ set(HIGHLIGHT_FOCUSED_FRAME_DEBUG ON)
 set(HPET_COMPARATOR_DEBUG ON)
 set(HPET_DEBUG ON)
 set(HTML_SCRIPT_DEBUG ON)
+set(HTTP2_DEBUG ON)
 set(HTTPJOB_DEBUG ON)
 set(HTTPSJOB_DEBUG ON)
 set(HUNKS_DEBUG ON)
@@ -89,6 +91,7 @@ set(INTEL_GRAPHICS_DEBUG ON)
 set(INTERRUPT_DEBUG ON)
 set(IOAPIC_DEBUG ON)
 set(IO_DEBUG ON)
+set(IPC_LATENCY_DEBUG ON)
 set(IPV4_DEBUG ON)
 set(IPV4_SOCKET_DEBUG ON)
 set(IRQ_DEBUG ON)
@@ -98,6 +101,7 @@ set(ITEM_RECTS_DEBUG ON)
 set(JOB_DEBUG ON)
 set(JPG_DEBUG ON)
 set(JS_BYTECODE_DEBUG ON)
+set(JS_JIT_DEBUG ON)
 set(JS_MODULE_DEBUG ON)
 set(KEYBOARD_DEBUG ON)
 set(KEYBOARD_SHORTCUTS_DEBUG ON)
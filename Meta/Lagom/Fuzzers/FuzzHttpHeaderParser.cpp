@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibHTTP/HeaderParser.h>
+#include <stddef.h>
+#include <stdint.h>
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size)
+{
+    if (size < 1)
+        return 0;
+
+    // The first byte picks the kind of message and how many bytes to feed the parser at a time, as the result must
+    // not depend on how the input was split up.
+    auto kind = static_cast<HTTP::HeaderParser::Kind>((data[0] & 0x3) % 3);
+    size_t piece_size = (data[0] >> 2) + 1;
+    ReadonlyBytes input { data + 1, size - 1 };
+
+    HTTP::HeaderParser whole { kind };
+    auto whole_consumed = whole.parse(input);
+
+    HTTP::HeaderParser pieces { kind };
+    size_t pieces_consumed = 0;
+    while (pieces_consumed < input.size() && !pieces.is_done() && !pieces.has_failed())
+        pieces_consumed += pieces.parse(input.slice(pieces_consumed, min(piece_size, input.size() - pieces_consumed)));
+
+    VERIFY(whole.state() == pieces.state());
+    if (!whole.has_failed())
+        VERIFY(whole_consumed == pieces_consumed);
+    VERIFY(whole.field_count() == pieces.field_count());
+    for (size_t i = 0; i < whole.field_count(); ++i) {
+        VERIFY(whole.field(i).name == pieces.field(i).name);
+        VERIFY(whole.field(i).value == pieces.field(i).value);
+        (void)whole.find(whole.field(i).name);
+    }
+
+    return 0;
+}
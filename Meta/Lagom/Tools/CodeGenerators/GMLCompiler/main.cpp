@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/CharacterTypes.h>
+#include <AK/HashTable.h>
+#include <AK/JsonObject.h>
+#include <AK/LexicalPath.h>
+#include <AK/NumericLimits.h>
+#include <AK/QuickSort.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/File.h>
+#include <LibGUI/GML/AST.h>
+#include <LibGUI/GML/Parser.h>
+#include <LibMain/Main.h>
+
+// Turns a GML file into a function that builds the same widget tree as Widget::load_from_gml() would, without
+// parsing anything at runtime. Widgets and layouts from LibGUI are constructed directly, and properties are set
+// with their setters where possible (see GML_SET_PROPERTY). Other classes are constructed through their registrations.
+
+struct KnownClass {
+    StringView name;
+    StringView header;
+};
+
+static constexpr Array known_classes {
+    KnownClass { "GUI::Breadcrumbbar"sv, "LibGUI/Breadcrumbbar.h"sv },
+    KnownClass { "GUI::Button"sv, "LibGUI/Button.h"sv },
+    KnownClass { "GUI::Calendar"sv, "LibGUI/Calendar.h"sv },
+    KnownClass { "GUI::CheckBox"sv, "LibGUI/CheckBox.h"sv },
+    KnownClass { "GUI::ColorInput"sv, "LibGUI/ColorInput.h"sv },
+    KnownClass { "GUI::ComboBox"sv, "LibGUI/ComboBox.h"sv },
+    KnownClass { "GUI::DialogButton"sv, "LibGUI/Button.h"sv },
+    KnownClass { "GUI::Frame"sv, "LibGUI/Frame.h"sv },
+    KnownClass { "GUI::GlyphMapWidget"sv, "LibGUI/GlyphMapWidget.h"sv },
+    KnownClass { "GUI::GroupBox"sv, "LibGUI/GroupBox.h"sv },
+    KnownClass { "GUI::HorizontalBoxLayout"sv, "LibGUI/BoxLayout.h"sv },
+    KnownClass { "GUI::HorizontalOpacitySlider"sv, "LibGUI/OpacitySlider.h"sv },
+    KnownClass { "GUI::HorizontalProgressbar"sv, "LibGUI/Progressbar.h"sv },
+    KnownClass { "GUI::HorizontalSeparator"sv, "LibGUI/SeparatorWidget.h"sv },
+    KnownClass { "GUI::HorizontalSlider"sv, "LibGUI/Slider.h"sv },
+    KnownClass { "GUI::HorizontalSplitter"sv, "LibGUI/Splitter.h"sv },
+    KnownClass { "GUI::IconView"sv, "LibGUI/IconView.h"sv },
+    KnownClass { "GUI::ImageWidget"sv, "LibGUI/ImageWidget.h"sv },
+    KnownClass { "GUI::Label"sv, "LibGUI/Label.h"sv },
+    KnownClass { "GUI::LazyWidget"sv, "LibGUI/LazyWidget.h"sv },
+    KnownClass { "GUI::LinkLabel"sv, "LibGUI/LinkLabel.h"sv },
+    KnownClass { "GUI::ListView"sv, "LibGUI/ListView.h"sv },
+    KnownClass { "GUI::MultiView"sv, "LibGUI/MultiView.h"sv },
+    KnownClass { "GUI::PasswordBox"sv, "LibGUI/TextBox.h"sv },
+    KnownClass { "GUI::Progressbar"sv, "LibGUI/Progressbar.h"sv },
+    KnownClass { "GUI::RadioButton"sv, "LibGUI/RadioButton.h"sv },
+    KnownClass { "GUI::ScrollableContainerWidget"sv, "LibGUI/ScrollableContainerWidget.h"sv },
+    KnownClass { "GUI::Scrollbar"sv, "LibGUI/Scrollbar.h"sv },
+    KnownClass { "GUI::Slider"sv, "LibGUI/Slider.h"sv },
+    KnownClass { "GUI::SpinBox"sv, "LibGUI/SpinBox.h"sv },
+    KnownClass { "GUI::StackWidget"sv, "LibGUI/StackWidget.h"sv },
+    KnownClass { "GUI::Statusbar"sv, "LibGUI/Statusbar.h"sv },
+    KnownClass { "GUI::TabWidget"sv, "LibGUI/TabWidget.h"sv },
+    KnownClass { "GUI::TableView"sv, "LibGUI/TableView.h"sv },
+    KnownClass { "GUI::TextBox"sv, "LibGUI/TextBox.h"sv },
+    KnownClass { "GUI::TextEditor"sv, "LibGUI/TextEditor.h"sv },
+    KnownClass { "GUI::Toolbar"sv, "LibGUI/Toolbar.h"sv },
+    KnownClass { "GUI::ToolbarContainer"sv, "LibGUI/ToolbarContainer.h"sv },
+    KnownClass { "GUI::Tray"sv, "LibGUI/Tray.h"sv },
+    KnownClass { "GUI::TreeView"sv, "LibGUI/TreeView.h"sv },
+    KnownClass { "GUI::UrlBox"sv, "LibGUI/TextBox.h"sv },
+    KnownClass { "GUI::ValueSlider"sv, "LibGUI/ValueSlider.h"sv },
+    KnownClass { "GUI::VerticalBoxLayout"sv, "LibGUI/BoxLayout.h"sv },
+    KnownClass { "GUI::VerticalOpacitySlider"sv, "LibGUI/OpacitySlider.h"sv },
+    KnownClass { "GUI::VerticalProgressbar"sv, "LibGUI/Progressbar.h"sv },
+    KnownClass { "GUI::VerticalSeparator"sv, "LibGUI/SeparatorWidget.h"sv },
+    KnownClass { "GUI::VerticalSlider"sv, "LibGUI/Slider.h"sv },
+    KnownClass { "GUI::VerticalSplitter"sv, "LibGUI/Splitter.h"sv },
+    KnownClass { "GUI::Widget"sv, "LibGUI/Widget.h"sv },
+};
+
+static Optional<KnownClass> find_known_class(StringView class_name)
+{
+    for (auto const& known_class : known_classes) {
+        if (known_class.name == class_name)
+            return known_class;
+    }
+    return {};
+}
+
+static bool is_identifier(StringView name)
+{
+    if (name.is_empty() || is_ascii_digit(name[0]))
+        return false;
+    for (char c : name) {
+        if (!is_ascii_alphanumeric(c) && c != '_')
+            return false;
+    }
+    return true;
+}
+
+static DeprecatedString string_literal(StringView string)
+{
+    StringBuilder builder;
+    builder.append('"');
+    for (u8 c : string) {
+        if (c == '"' || c == '\\')
+            builder.appendff("\\{:c}", c);
+        else if (c == '\n')
+            builder.append("\\n"sv);
+        else if (c < 0x20 || c == 0x7f)
+            builder.appendff("\\{:03o}", c);
+        else
+            builder.append(c);
+    }
+    builder.append("\"sv"sv);
+    return builder.to_deprecated_string();
+}
+
+// Returns the value as a C++ literal of the type JsonValue would store it as, or nothing if it doesn't have one.
+static Optional<DeprecatedString> cpp_literal(JsonValue const& value)
+{
+    if (value.is_bool())
+        return DeprecatedString(value.as_bool() ? "true"sv : "false"sv);
+    if (value.is_string())
+        return string_literal(value.as_string());
+    if (value.is_i32() && value.as_i32() != NumericLimits<i32>::min())
+        return DeprecatedString::number(value.as_i32());
+    if (value.is_u32())
+        return DeprecatedString::formatted("{}u", value.as_u32());
+    if (value.is_i64() && value.as_i64() != NumericLimits<i64>::min())
+        return DeprecatedString::formatted("{}ll", value.as_i64());
+    if (value.is_u64())
+        return DeprecatedString::formatted("{}ull", value.as_u64());
+    if (value.is_double()) {
+        auto literal = value.to_deprecated_string();
+        if (!literal.contains('.') && !literal.contains('e') && !literal.contains('E'))
+            return DeprecatedString::formatted("{}.0", literal);
+        return literal;
+    }
+    return {};
+}
+
+class GMLCompiler {
+public:
+    ErrorOr<void> compile(GUI::GML::GMLFile& file, StringView function_name, StringBuilder& output)
+    {
+        // The root widget already exists, and might be any subclass of the one named in the GML, so it is only treated as a GUI::Widget.
+        Object root;
+        root.reference = "widget"sv;
+        TRY(compile_object_contents(file.main_class(), root, 1));
+
+        m_includes.set("AK/Error.h"sv);
+        m_includes.set("LibGUI/GML/CompiledGML.h"sv);
+        m_includes.set("LibGUI/Widget.h"sv);
+        Vector<StringView> includes;
+        for (auto include : m_includes)
+            includes.append(include);
+        quick_sort(includes);
+
+        output.append("#pragma once\n\n"sv);
+        for (auto include : includes)
+            output.appendff("#include <{}>\n", include);
+        output.appendff("\ninline ErrorOr<void> {}(GUI::Widget& widget)\n{{\n", function_name);
+        output.append(m_body.string_view());
+        output.append("    return {};\n}\n"sv);
+        return {};
+    }
+
+private:
+    struct Object {
+        DeprecatedString reference;
+        // Whether we know the object's class doesn't derive from GUI::TabWidget.
+        bool is_known_not_to_be_tab_widget { false };
+        bool is_known_tab_widget { false };
+    };
+
+    template<typename... Parameters>
+    void append_line(size_t indentation, CheckedFormatString<Parameters...>&& format, Parameters const&... parameters)
+    {
+        for (size_t i = 0; i < indentation; ++i)
+            m_body.append("    "sv);
+        m_body.appendff(move(format), parameters...);
+        m_body.append('\n');
+    }
+
+    DeprecatedString make_variable(StringView prefix)
+    {
+        return DeprecatedString::formatted("{}_{}", prefix, ++m_last_variable_index);
+    }
+
+    ErrorOr<void> compile_json_array(JsonArray const& array, StringView variable, size_t indentation)
+    {
+        append_line(indentation, "JsonArray {};", variable);
+        for (auto const& element : array.values()) {
+            if (element.is_array()) {
+                auto element_variable = make_variable("array"sv);
+                append_line(indentation, "{{");
+                TRY(compile_json_array(element.as_array(), element_variable, indentation + 1));
+                append_line(indentation + 1, "{}.append(move({}));", variable, element_variable);
+                append_line(indentation, "}}");
+                continue;
+            }
+            if (element.is_null()) {
+                append_line(indentation, "{}.append(JsonValue {{}});", variable);
+                continue;
+            }
+            auto literal = cpp_literal(element);
+            if (!literal.has_value())
+                return Error::from_string_literal("Unsupported value in array");
+            append_line(indentation, "{}.append(JsonValue({}));", variable, *literal);
+        }
+        return {};
+    }
+
+    ErrorOr<void> compile_properties(GUI::GML::Object& object, StringView reference, size_t indentation)
+    {
+        ErrorOr<void> result {};
+        object.for_each_property([&](auto key, auto value_node) {
+            if (result.is_error())
+                return;
+            JsonValue const& value = *value_node;
+
+            if (value.is_array()) {
+                auto variable = make_variable("array"sv);
+                append_line(indentation, "{{");
+                result = compile_json_array(value.as_array(), variable, indentation + 1);
+                append_line(indentation + 1, "{}.set_property({}, move({}));", reference, string_literal(key), variable);
+                append_line(indentation, "}}");
+                return;
+            }
+            if (value.is_null()) {
+                append_line(indentation, "{}.set_property({}, JsonValue {{}});", reference, string_literal(key));
+                return;
+            }
+
+            auto literal = cpp_literal(value);
+            if (!literal.has_value()) {
+                warnln("Unsupported value for property '{}' of {}", key, object.name());
+                result = Error::from_string_literal("Unsupported property value");
+                return;
+            }
+            if (!is_identifier(key)) {
+                append_line(indentation, "{}.set_property({}, JsonValue({}));", reference, string_literal(key), *literal);
+                return;
+            }
+            append_line(indentation, "GML_SET_PROPERTY({}, {}, {}, JsonValue({}));", reference, key, *literal, *literal);
+        });
+        return result;
+    }
+
+    ErrorOr<void> compile_layout(GUI::GML::Object& layout, Object const& widget, size_t indentation)
+    {
+        auto class_name = layout.name();
+        if (class_name.is_empty())
+            return Error::from_string_literal("Invalid layout class name");
+
+        auto variable = make_variable("layout"sv);
+        append_line(indentation, "{{");
+        if (auto known_class = find_known_class(class_name); known_class.has_value()) {
+            m_includes.set(known_class->header);
+            append_line(indentation + 1, "auto {} = {}::construct();", variable, class_name);
+        } else {
+            append_line(indentation + 1, "auto {} = TRY(GUI::GML::construct_registered_layout({}));", variable, string_literal(class_name));
+        }
+        append_line(indentation + 1, "{}.set_layout({});", widget.reference, variable);
+        TRY(compile_properties(layout, DeprecatedString::formatted("(*{})", variable), indentation + 1));
+        append_line(indentation, "}}");
+        return {};
+    }
+
+    ErrorOr<void> compile_object_contents(GUI::GML::Object& object, Object const& widget, size_t indentation)
+    {
+        TRY(compile_properties(object, widget.reference, indentation));
+
+        if (auto layout = object.layout_object())
+            TRY(compile_layout(*layout, widget, indentation));
+
+        return object.try_for_each_child_object([&](auto child) -> ErrorOr<void> {
+            auto class_name = child->name();
+
+            // It is very questionable if this pseudo object should exist, but it works fine like this for now.
+            if (class_name == "GUI::Layout::Spacer"sv) {
+                m_includes.set("LibGUI/Layout.h"sv);
+                append_line(indentation, "if (!{}.layout())", widget.reference);
+                append_line(indentation + 1, "return Error::from_string_literal(\"Specified GUI::Layout::Spacer in GML, but the parent has no Layout.\");");
+                append_line(indentation, "{}.layout()->add_spacer();", widget.reference);
+                return {};
+            }
+
+            auto variable = make_variable("widget"sv);
+            Object child_widget;
+            child_widget.reference = DeprecatedString::formatted("(*{})", variable);
+
+            append_line(indentation, "{{");
+            if (auto known_class = find_known_class(class_name); known_class.has_value()) {
+                m_includes.set(known_class->header);
+                append_line(indentation + 1, "auto {} = TRY({}::try_create());", variable, class_name);
+                child_widget.is_known_tab_widget = class_name == "GUI::TabWidget"sv;
+                child_widget.is_known_not_to_be_tab_widget = !child_widget.is_known_tab_widget;
+            } else {
+                append_line(indentation + 1, "auto {} = TRY(GUI::GML::construct_registered_widget({}));", variable, string_literal(class_name));
+            }
+            append_line(indentation + 1, "{}.add_child(*{});", widget.reference, variable);
+
+            TRY(compile_object_contents(*child, child_widget, indentation + 1));
+
+            // FIXME: We need to have the child added before loading it so that it can access us. But the TabWidget logic requires the child to not be present yet.
+            if (widget.is_known_tab_widget) {
+                append_line(indentation + 1, "{}.remove_child(*{});", widget.reference, variable);
+                append_line(indentation + 1, "{}.add_widget(*{});", widget.reference, variable);
+            } else if (!widget.is_known_not_to_be_tab_widget) {
+                m_includes.set("LibGUI/TabWidget.h"sv);
+                append_line(indentation + 1, "if (auto* tab_widget = dynamic_cast<GUI::TabWidget*>(&{})) {{", widget.reference);
+                append_line(indentation + 2, "tab_widget->remove_child(*{});", variable);
+                append_line(indentation + 2, "tab_widget->add_widget(*{});", variable);
+                append_line(indentation + 1, "}}");
+            }
+            append_line(indentation, "}}");
+            return {};
+        });
+    }
+
+    StringBuilder m_body;
+    HashTable<StringView> m_includes;
+    size_t m_last_variable_index { 0 };
+};
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    StringView gml_file_path;
+    StringView function_name;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_positional_argument(gml_file_path, "GML file to compile", "GML_FILE");
+    args_parser.add_positional_argument(function_name, "Name of the function to generate", "FUNCTION_NAME");
+    args_parser.parse(arguments);
+
+    auto file = TRY(Core::File::open(gml_file_path, Core::File::OpenMode::Read));
+    auto gml_text = TRY(file->read_until_eof());
+    auto gml_file = TRY(GUI::GML::parse_gml(gml_text));
+
+    StringBuilder builder;
+    GMLCompiler compiler;
+    if (auto result = compiler.compile(gml_file, function_name, builder); result.is_error()) {
+        warnln("Unable to compile {}: {}", LexicalPath::basename(gml_file_path), result.error());
+        return 1;
+    }
+
+    outln("{}", builder.string_view());
+    return 0;
+}
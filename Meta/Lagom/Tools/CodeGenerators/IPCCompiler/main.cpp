@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
 #include <AK/Debug.h>
 #include <AK/Function.h>
 #include <AK/GenericLexer.h>
@@ -72,9 +73,20 @@ static bool is_simple_type(DeprecatedString const& type)
     return type.is_one_of("Gfx::Color", "Gfx::IntPoint", "Gfx::FloatPoint", "Gfx::IntSize", "Gfx::FloatSize", "Core::File::OpenMode");
 }
 
+static bool is_view_type(DeprecatedString const& type)
+{
+    // These are decoded as views into the buffer that the message was received in, instead of being copied out of it.
+    return type.is_one_of("StringView", "ReadonlyBytes");
+}
+
 static bool is_primitive_or_simple_type(DeprecatedString const& type)
 {
-    return is_primitive_type(type) || is_simple_type(type);
+    return is_primitive_type(type) || is_simple_type(type) || is_view_type(type);
+}
+
+static bool has_view_parameters(Vector<Parameter> const& parameters)
+{
+    return any_of(parameters, [](auto const& parameter) { return is_view_type(parameter.type); });
 }
 
 static DeprecatedString message_name(DeprecatedString const& endpoint, DeprecatedString const& message, bool is_response)
@@ -184,6 +196,12 @@ Vector<Endpoint> parse(ByteBuffer const& file_contents)
             assert_specific('(');
             parse_parameters(message.outputs);
             assert_specific(')');
+
+            // Responses are handed to the caller after the buffer they were received in is gone, so they can't borrow from it.
+            if (has_view_parameters(message.outputs)) {
+                warnln("Response of message '{}' can't have view parameters", message.name);
+                VERIFY_NOT_REACHED();
+            }
         }
 
         consume_whitespace();
@@ -338,7 +356,7 @@ public:)~~~");
     static i32 static_message_id() { return (int)MessageID::@message.pascal_name@; }
     virtual const char* message_name() const override { return "@endpoint.name@::@message.pascal_name@"; }
 
-    static ErrorOr<NonnullOwnPtr<@message.pascal_name@>> decode(Stream& stream, Core::LocalSocket& socket)
+    static ErrorOr<NonnullOwnPtr<@message.pascal_name@>> decode(FixedMemoryStream& stream, Core::LocalSocket& socket, [[maybe_unused]] IPC::ReceivedBuffer& received_buffer)
     {
         IPC::Decoder decoder { stream, socket };)~~~");
 
@@ -372,9 +390,17 @@ public:)~~~");
     }
 
     message_generator.set("message.constructor_call_parameters", builder.to_deprecated_string());
-    message_generator.appendln(R"~~~(
+    if (has_view_parameters(parameters)) {
+        message_generator.appendln(R"~~~(
+        auto message = make<@message.pascal_name@>(@message.constructor_call_parameters@);
+        message->m_ipc_received_buffer = received_buffer;
+        return message;
+    })~~~");
+    } else {
+        message_generator.appendln(R"~~~(
         return make<@message.pascal_name@>(@message.constructor_call_parameters@);
     })~~~");
+    }
 
     message_generator.appendln(R"~~~(
     virtual bool valid() const override { return m_ipc_message_valid; }
@@ -413,6 +439,11 @@ public:)~~~");
 private:
     bool m_ipc_message_valid { true };)~~~");
 
+    if (has_view_parameters(parameters)) {
+        message_generator.appendln(R"~~~(
+    RefPtr<IPC::ReceivedBuffer> m_ipc_received_buffer;)~~~");
+    }
+
     for (auto const& parameter : parameters) {
         auto parameter_generator = message_generator.fork();
         parameter_generator.set("parameter.type", parameter.type);
@@ -525,10 +556,47 @@ void do_message_for_proxy(SourceGenerator message_generator, Endpoint const& end
     })~~~");
     };
 
+    auto do_implement_pipelined_proxy = [&](DeprecatedString const& name, Vector<Parameter> const& parameters) {
+        message_generator.set("message.pascal_name", pascal_case(message.name));
+        message_generator.set("message.response_type", pascal_case(message.response_name()));
+        message_generator.set("handler_name", name);
+        message_generator.appendln(R"~~~(
+    IPC::PendingResponse<Messages::@endpoint.name@::@message.response_type@> pipelined_@handler_name@()~~~");
+
+        for (size_t i = 0; i < parameters.size(); ++i) {
+            auto const& parameter = parameters[i];
+            auto argument_generator = message_generator.fork();
+            argument_generator.set("argument.type", parameter.type);
+            argument_generator.set("argument.name", parameter.name);
+            argument_generator.append("@argument.type@ @argument.name@");
+            if (i != parameters.size() - 1)
+                argument_generator.append(", ");
+        }
+
+        message_generator.append(R"~~~() {
+        return m_connection.template send_pipelined<Messages::@endpoint.name@::@message.pascal_name@>()~~~");
+
+        for (size_t i = 0; i < parameters.size(); ++i) {
+            auto const& parameter = parameters[i];
+            auto argument_generator = message_generator.fork();
+            argument_generator.set("argument.name", parameter.name);
+            if (is_primitive_or_simple_type(parameters[i].type))
+                argument_generator.append("@argument.name@");
+            else
+                argument_generator.append("move(@argument.name@)");
+            if (i != parameters.size() - 1)
+                argument_generator.append(", ");
+        }
+
+        message_generator.appendln(R"~~~();
+    })~~~");
+    };
+
     do_implement_proxy(message.name, message.inputs, message.is_synchronous, false);
     if (message.is_synchronous) {
         do_implement_proxy(message.name, message.inputs, false, false);
         do_implement_proxy(message.name, message.inputs, true, true);
+        do_implement_pipelined_proxy(message.name, message.inputs);
     }
 }
 
@@ -584,7 +652,7 @@ public:
 
     static u32 static_magic() { return @endpoint.magic@; }
 
-    static ErrorOr<NonnullOwnPtr<IPC::Message>> decode_message(ReadonlyBytes buffer, [[maybe_unused]] Core::LocalSocket& socket)
+    static ErrorOr<NonnullOwnPtr<IPC::Message>> decode_message(ReadonlyBytes buffer, [[maybe_unused]] Core::LocalSocket& socket, [[maybe_unused]] IPC::ReceivedBuffer& received_buffer)
     {
         FixedMemoryStream stream { buffer };
         auto message_endpoint_magic = TRY(stream.read_value<u32>());)~~~");
@@ -613,7 +681,7 @@ public:
 
             message_generator.append(R"~~~(
         case (int)Messages::@endpoint.name@::MessageID::@message.pascal_name@:
-            return TRY(Messages::@endpoint.name@::@message.pascal_name@::decode(stream, socket));)~~~");
+            return TRY(Messages::@endpoint.name@::@message.pascal_name@::decode(stream, socket, received_buffer));)~~~");
         };
 
         do_decode_message(message.name);
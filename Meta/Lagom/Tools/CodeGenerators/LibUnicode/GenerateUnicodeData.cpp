@@ -870,6 +870,119 @@ ReadonlySpan<CaseFolding const*> case_folding_mapping(u32 code_point);
     return {};
 }
 
+// A two-stage lookup table of the properties of a property list that each code point has. The code points are split into
+// blocks, and each block that occurs is only stored once. Each entry of a block is an index into the sets of properties
+// that occur, which are bit sets of the property's index (i.e. their position when sorted by name, like the enum).
+struct CodePointPropertyTables {
+    size_t size_in_bytes() const;
+
+    u32 shift { 0 };
+    Vector<u32> stage1;
+    Vector<u32> stage2;
+    size_t words_per_property_set { 0 };
+    Vector<u64> property_sets;
+};
+
+static constexpr u32 code_point_count = 0x110000;
+
+static size_t size_of_type_that_fits(size_t max_value)
+{
+    if (max_value <= NumericLimits<u8>::max())
+        return sizeof(u8);
+    if (max_value <= NumericLimits<u16>::max())
+        return sizeof(u16);
+    return sizeof(u32);
+}
+
+static StringView type_that_fits(size_t max_value)
+{
+    switch (size_of_type_that_fits(max_value)) {
+    case sizeof(u8):
+        return "u8"sv;
+    case sizeof(u16):
+        return "u16"sv;
+    default:
+        return "u32"sv;
+    }
+}
+
+size_t CodePointPropertyTables::size_in_bytes() const
+{
+    auto property_set_count = property_sets.size() / words_per_property_set;
+    return stage1.size() * size_of_type_that_fits(stage2.size() >> shift)
+        + stage2.size() * size_of_type_that_fits(property_set_count)
+        + property_sets.size() * sizeof(u64);
+}
+
+static CodePointPropertyTables generate_code_point_property_tables(PropList const& property_list)
+{
+    auto property_names = property_list.keys();
+    quick_sort(property_names);
+
+    CodePointPropertyTables tables;
+    tables.words_per_property_set = max(ceil_div(property_names.size(), static_cast<size_t>(64)), static_cast<size_t>(1));
+    auto words_per_set = tables.words_per_property_set;
+
+    Vector<u64> code_point_properties;
+    code_point_properties.resize(code_point_count * words_per_set);
+    for (size_t index = 0; index < property_names.size(); ++index) {
+        for (auto const& range : property_list.get(property_names[index]).value()) {
+            for (u32 code_point = range.first; code_point <= min(range.last, code_point_count - 1); ++code_point)
+                code_point_properties[code_point * words_per_set + index / 64] |= static_cast<u64>(1) << (index % 64);
+        }
+    }
+
+    // The empty set comes first, so that most blocks are filled with zeroes.
+    HashMap<Vector<u64>, u32> property_set_indices;
+    Vector<u64> empty_set;
+    empty_set.resize(words_per_set);
+    tables.property_sets.extend(empty_set);
+    property_set_indices.set(move(empty_set), 0);
+
+    Vector<u32> code_point_property_sets;
+    code_point_property_sets.resize(code_point_count);
+    for (u32 code_point = 0; code_point < code_point_count; ++code_point) {
+        Vector<u64> property_set { code_point_properties.span().slice(code_point * words_per_set, words_per_set) };
+        if (auto index = property_set_indices.get(property_set); index.has_value()) {
+            code_point_property_sets[code_point] = *index;
+            continue;
+        }
+
+        auto index = static_cast<u32>(tables.property_sets.size() / words_per_set);
+        tables.property_sets.extend(property_set);
+        property_set_indices.set(move(property_set), index);
+        code_point_property_sets[code_point] = index;
+    }
+
+    // The best block size depends on how the properties are spread out, so the one that makes the smallest tables is picked.
+    Optional<CodePointPropertyTables> best_tables;
+    for (u32 shift = 4; shift <= 10; ++shift) {
+        auto block_size = static_cast<u32>(1) << shift;
+        tables.shift = shift;
+        tables.stage1.clear();
+        tables.stage2.clear();
+
+        HashMap<Vector<u32>, u32> block_indices;
+        for (u32 block_start = 0; block_start < code_point_count; block_start += block_size) {
+            Vector<u32> block { code_point_property_sets.span().slice(block_start, block_size) };
+            if (auto index = block_indices.get(block); index.has_value()) {
+                tables.stage1.append(*index);
+                continue;
+            }
+
+            auto index = static_cast<u32>(tables.stage2.size() >> shift);
+            tables.stage2.extend(block);
+            block_indices.set(move(block), index);
+            tables.stage1.append(index);
+        }
+
+        if (!best_tables.has_value() || tables.size_in_bytes() < best_tables->size_in_bytes())
+            best_tables = tables;
+    }
+
+    return best_tables.release_value();
+}
+
 static ErrorOr<void> generate_unicode_data_implementation(Core::BufferedFile& file, UnicodeData const& unicode_data)
 {
     StringBuilder builder;
@@ -1145,14 +1258,73 @@ static constexpr Array<ReadonlySpan<CodePointRange>, @size@> @name@ { {)~~~");
 )~~~");
     };
 
-    append_prop_list("s_general_categories"sv, "s_general_category_{}"sv, unicode_data.general_categories);
-    append_prop_list("s_properties"sv, "s_property_{}"sv, unicode_data.prop_list);
     append_prop_list("s_scripts"sv, "s_script_{}"sv, unicode_data.script_list);
     append_prop_list("s_script_extensions"sv, "s_script_extension_{}"sv, unicode_data.script_extensions);
     append_prop_list("s_blocks"sv, "s_block_{}"sv, unicode_data.block_list);
-    append_prop_list("s_grapheme_break_properties"sv, "s_grapheme_break_property_{}"sv, unicode_data.grapheme_break_props);
-    append_prop_list("s_word_break_properties"sv, "s_word_break_property_{}"sv, unicode_data.word_break_props);
-    append_prop_list("s_sentence_break_properties"sv, "s_sentence_break_property_{}"sv, unicode_data.sentence_break_props);
+
+    enum class Hexadecimal {
+        No,
+        Yes,
+    };
+    auto append_table = [&](StringView type, StringView name, auto const& values, Hexadecimal hexadecimal) {
+        constexpr size_t max_values_per_row = 32;
+        size_t values_in_current_row = 0;
+
+        generator.set("type", type);
+        generator.set("name", name);
+        generator.set("size", DeprecatedString::number(values.size()));
+        generator.append(R"~~~(
+static constexpr Array<@type@, @size@> @name@ { {
+    )~~~");
+
+        for (auto value : values) {
+            if (values_in_current_row++ > 0)
+                generator.append(" ");
+
+            if (hexadecimal == Hexadecimal::Yes)
+                generator.append(DeprecatedString::formatted("{:#x}", value));
+            else
+                generator.append(DeprecatedString::number(value));
+            generator.append(",");
+
+            if (values_in_current_row == max_values_per_row) {
+                values_in_current_row = 0;
+                generator.append("\n    ");
+            }
+        }
+
+        generator.append(R"~~~(
+} };
+)~~~");
+    };
+
+    // The properties that are looked up for every code point of a text get lookup tables, instead of being binary searched.
+    auto append_property_tables = [&](StringView enum_title, StringView enum_snake, PropList const& property_list) {
+        auto tables = generate_code_point_property_tables(property_list);
+        auto property_set_count = tables.property_sets.size() / tables.words_per_property_set;
+
+        append_table(type_that_fits(tables.stage2.size() >> tables.shift), DeprecatedString::formatted("s_{}_stage1", enum_snake), tables.stage1, Hexadecimal::No);
+        append_table(type_that_fits(property_set_count), DeprecatedString::formatted("s_{}_stage2", enum_snake), tables.stage2, Hexadecimal::No);
+        append_table("u64"sv, DeprecatedString::formatted("s_{}_property_sets", enum_snake), tables.property_sets, Hexadecimal::Yes);
+
+        generator.set("enum_title", enum_title);
+        generator.set("enum_snake", enum_snake);
+        generator.set("shift", DeprecatedString::number(tables.shift));
+        generator.set("words", DeprecatedString::number(tables.words_per_property_set));
+        generator.append(R"~~~(
+bool code_point_has_@enum_snake@(u32 code_point, @enum_title@ @enum_snake@)
+{
+    if (code_point >= 0x110000)
+        return false;
+
+    auto index = static_cast<size_t>(@enum_snake@);
+    auto block = static_cast<size_t>(s_@enum_snake@_stage1[code_point >> @shift@]);
+    auto property_set = static_cast<size_t>(s_@enum_snake@_stage2[(block << @shift@) | (code_point & ((1u << @shift@) - 1))]);
+
+    return (s_@enum_snake@_property_sets[property_set * @words@ + index / 64] >> (index % 64)) & 1;
+}
+)~~~");
+    };
 
     auto append_code_point_display_names = [&](StringView type, StringView name, auto const& display_names) {
         constexpr size_t max_values_per_row = 30;
@@ -1333,10 +1505,10 @@ bool code_point_has_@enum_snake@(u32 code_point, @enum_title@ @enum_snake@)
 
     TRY(append_from_string("Locale"sv, "locale"sv, unicode_data.locales, {}));
 
-    append_prop_search("GeneralCategory"sv, "general_category"sv, "s_general_categories"sv);
+    append_property_tables("GeneralCategory"sv, "general_category"sv, unicode_data.general_categories);
     TRY(append_from_string("GeneralCategory"sv, "general_category"sv, unicode_data.general_categories, unicode_data.general_category_aliases));
 
-    append_prop_search("Property"sv, "property"sv, "s_properties"sv);
+    append_property_tables("Property"sv, "property"sv, unicode_data.prop_list);
     TRY(append_from_string("Property"sv, "property"sv, unicode_data.prop_list, unicode_data.prop_aliases));
 
     append_prop_search("Script"sv, "script"sv, "s_scripts"sv);
@@ -1346,9 +1518,9 @@ bool code_point_has_@enum_snake@(u32 code_point, @enum_title@ @enum_snake@)
     append_prop_search("Block"sv, "block"sv, "s_blocks"sv);
     TRY(append_from_string("Block"sv, "block"sv, unicode_data.block_list, unicode_data.block_aliases));
 
-    append_prop_search("GraphemeBreakProperty"sv, "grapheme_break_property"sv, "s_grapheme_break_properties"sv);
-    append_prop_search("WordBreakProperty"sv, "word_break_property"sv, "s_word_break_properties"sv);
-    append_prop_search("SentenceBreakProperty"sv, "sentence_break_property"sv, "s_sentence_break_properties"sv);
+    append_property_tables("GraphemeBreakProperty"sv, "grapheme_break_property"sv, unicode_data.grapheme_break_props);
+    append_property_tables("WordBreakProperty"sv, "word_break_property"sv, unicode_data.word_break_props);
+    append_property_tables("SentenceBreakProperty"sv, "sentence_break_property"sv, unicode_data.sentence_break_props);
 
     generator.append(R"~~~(
 }
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Arena.h>
+#include <AK/DeprecatedString.h>
+
+TEST_CASE(allocations_are_aligned)
+{
+    Arena arena;
+    for (size_t alignment = 1; alignment <= 64; alignment *= 2) {
+        (void)arena.allocate(1, 1);
+        auto* ptr = arena.allocate(alignment, alignment);
+        EXPECT_NE(ptr, nullptr);
+        EXPECT_EQ(reinterpret_cast<FlatPtr>(ptr) % alignment, 0u);
+    }
+}
+
+TEST_CASE(large_allocations)
+{
+    Arena arena(4 * KiB);
+    auto* small = static_cast<u8*>(arena.allocate(16, 8));
+    auto* large = static_cast<u8*>(arena.allocate(1 * MiB, 8));
+    EXPECT_NE(large, nullptr);
+    __builtin_memset(large, 0xaa, 1 * MiB);
+
+    // The large allocation got a chunk of its own, so the small one's chunk is still being used.
+    auto* next_small = static_cast<u8*>(arena.allocate(16, 8));
+    EXPECT_EQ(next_small, small + 16);
+    EXPECT_EQ(arena.allocated_size(), 1 * MiB + 32);
+}
+
+TEST_CASE(last_allocation_is_given_back)
+{
+    Arena arena;
+    auto* first = arena.allocate(32, 8);
+    arena.deallocate(first, 32);
+    EXPECT_EQ(arena.allocate(32, 8), first);
+
+    auto* second = arena.allocate(32, 8);
+    arena.deallocate(first, 32);
+    EXPECT_NE(arena.allocate(32, 8), first);
+    EXPECT_NE(second, first);
+}
+
+TEST_CASE(clear)
+{
+    Arena arena;
+    for (size_t i = 0; i < 10000; ++i)
+        (void)arena.allocate(100, 4);
+    EXPECT_EQ(arena.allocated_size(), 1000000u);
+    arena.clear();
+    EXPECT_EQ(arena.allocated_size(), 0u);
+    EXPECT_NE(arena.allocate(100, 4), nullptr);
+}
+
+TEST_CASE(vector)
+{
+    Arena arena;
+    ArenaVector<DeprecatedString> strings { arena };
+    for (size_t i = 0; i < 1000; ++i)
+        strings.append(DeprecatedString::number(i));
+    EXPECT_EQ(strings.size(), 1000u);
+    EXPECT_EQ(strings[999], "999"sv);
+
+    auto copy = strings;
+    EXPECT_EQ(&copy.data()[0] == &strings.data()[0], false);
+    EXPECT_EQ(copy[123], "123"sv);
+
+    auto moved = move(copy);
+    EXPECT(copy.is_empty());
+    EXPECT_EQ(moved.size(), 1000u);
+
+    ArenaVector<int, 4> with_inline_capacity { arena };
+    for (int i = 0; i < 100; ++i)
+        with_inline_capacity.append(i);
+    EXPECT_EQ(with_inline_capacity[42], 42);
+    with_inline_capacity.clear();
+    EXPECT(with_inline_capacity.is_empty());
+}
+
+TEST_CASE(hash_table)
+{
+    Arena arena;
+    ArenaHashTable<DeprecatedString> table { arena };
+    for (size_t i = 0; i < 1000; ++i)
+        table.set(DeprecatedString::number(i));
+    EXPECT_EQ(table.size(), 1000u);
+    EXPECT(table.contains("500"sv));
+    EXPECT(!table.contains("1000"sv));
+
+    EXPECT(table.remove("500"sv));
+    EXPECT(!table.contains("500"sv));
+
+    auto copy = table;
+    EXPECT_EQ(copy.size(), 999u);
+
+    table.clear();
+    EXPECT(table.is_empty());
+    table.set("still works"sv);
+    EXPECT(table.contains("still works"sv));
+}
+
+TEST_CASE(hash_map)
+{
+    Arena arena;
+    ArenaHashMap<int, DeprecatedString> map { arena };
+    for (int i = 0; i < 1000; ++i)
+        map.set(i, DeprecatedString::number(i));
+    EXPECT_EQ(map.size(), 1000u);
+    EXPECT_EQ(map.get(321).value(), "321"sv);
+    EXPECT(!map.get(1000).has_value());
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <AK/ByteSearch.h>
+#include <AK/StringView.h>
+
+// Long enough to exercise both the vectorized loops and the scalar tails.
+static constexpr auto haystack = "The quick brown fox jumps over the lazy dog, and then it naps.\n"sv;
+
+TEST_CASE(find_byte)
+{
+    EXPECT_EQ(AK::find_byte(haystack.bytes(), 'T'), 0u);
+    EXPECT_EQ(AK::find_byte(haystack.bytes(), 'q'), 4u);
+    EXPECT_EQ(AK::find_byte(haystack.bytes(), ','), 43u);
+    EXPECT_EQ(AK::find_byte(haystack.bytes(), '\n'), haystack.length() - 1);
+    EXPECT(!AK::find_byte(haystack.bytes(), 'Z').has_value());
+    EXPECT(!AK::find_byte({}, 'a').has_value());
+
+    // A match right past the end of the span must not be found.
+    EXPECT(!AK::find_byte(haystack.bytes().trim(43), ',').has_value());
+}
+
+TEST_CASE(find_last_byte)
+{
+    EXPECT_EQ(AK::find_last_byte(haystack.bytes(), 'T'), 0u);
+    EXPECT_EQ(AK::find_last_byte(haystack.bytes(), 'o'), 41u);
+    EXPECT_EQ(AK::find_last_byte(haystack.bytes(), '\n'), haystack.length() - 1);
+    EXPECT(!AK::find_last_byte(haystack.bytes(), 'Z').has_value());
+    EXPECT(!AK::find_last_byte({}, 'a').has_value());
+}
+
+TEST_CASE(find_any_of_bytes)
+{
+    EXPECT_EQ(AK::find_any_of_bytes(haystack.bytes(), ",."sv.bytes()), 43u);
+    EXPECT_EQ(AK::find_any_of_bytes(haystack.bytes(), ".\n"sv.bytes()), haystack.length() - 2);
+    EXPECT_EQ(AK::find_any_of_bytes(haystack.bytes(), "zyx"sv.bytes()), 18u);
+    EXPECT(!AK::find_any_of_bytes(haystack.bytes(), "XYZ"sv.bytes()).has_value());
+
+    // Larger sets take a different path.
+    EXPECT_EQ(AK::find_any_of_bytes(haystack.bytes(), "0123456789,"sv.bytes()), 43u);
+}
+
+TEST_CASE(find_first_mismatch)
+{
+    Array<u8, 40> a {};
+    Array<u8, 40> b {};
+    EXPECT(!AK::find_first_mismatch(a.data(), b.data(), a.size()).has_value());
+
+    for (size_t i : Array<size_t, 5> { 0, 15, 16, 31, 39 }) {
+        b[i] = 1;
+        EXPECT_EQ(AK::find_first_mismatch(a.data(), b.data(), a.size()), i);
+        EXPECT(!AK::find_first_mismatch(a.data(), b.data(), i).has_value());
+        b[i] = 0;
+    }
+}
+
+TEST_CASE(find_null_terminator)
+{
+    // Try every alignment of the string, so that the vectors cover both ends of it in all possible ways.
+    alignas(64) char buffer[128];
+    for (size_t offset = 0; offset < 32; ++offset) {
+        for (size_t length = 0; length < 64; ++length) {
+            __builtin_memset(buffer, 'a', sizeof(buffer));
+            auto* string = buffer + offset;
+            string[length] = '\0';
+            EXPECT_EQ(AK::find_null_terminator(string), length);
+            EXPECT_EQ(AK::find_byte_or_null_terminator(string, 'b'), string + length);
+            if (length > 0) {
+                string[length / 2] = 'b';
+                EXPECT_EQ(AK::find_byte_or_null_terminator(string, 'b'), string + length / 2);
+            }
+        }
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <AK/Function.h>
+
+TEST_CASE(call_and_clear)
+{
+    int calls = 0;
+    Function<void()> function = [&] { ++calls; };
+    EXPECT(static_cast<bool>(function));
+    function();
+    function();
+    EXPECT_EQ(calls, 2);
+    function = nullptr;
+    EXPECT(!function);
+}
+
+TEST_CASE(larger_inline_capacity)
+{
+    Array<u64, 6> captures { 1, 2, 3, 4, 5, 6 };
+    auto sum_captures = [captures] {
+        u64 sum = 0;
+        for (auto value : captures)
+            sum += value;
+        return sum;
+    };
+
+    Function<u64(), 8 * sizeof(void*)> function = move(sum_captures);
+    EXPECT_EQ(function(), 21u);
+
+    auto moved_function = move(function);
+    EXPECT(!function);
+    EXPECT_EQ(moved_function(), 21u);
+}
+
+TEST_CASE(inline_function)
+{
+    static_assert(sizeof(InlineFunction<void(), 2 * sizeof(void*)>) < sizeof(Function<void()>));
+
+    int value = 0;
+    InlineFunction<void(int)> function = [&value](int new_value) { value = new_value; };
+    function(42);
+    EXPECT_EQ(value, 42);
+
+    InlineFunction<void(int)> other = move(function);
+    EXPECT(!function);
+    other(7);
+    EXPECT_EQ(value, 7);
+}
+
+TEST_CASE(wrap_function_with_different_capacity)
+{
+    Function<int(int)> function = [](int value) { return value * 2; };
+    Function<int(int), 8 * sizeof(void*)> wrapper = move(function);
+    EXPECT_EQ(wrapper(21), 42);
+}
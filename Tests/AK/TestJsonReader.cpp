@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonParser.h>
+#include <AK/JsonReader.h>
+#include <AK/JsonTape.h>
+#include <AK/Stream.h>
+#include <AK/StringBuilder.h>
+
+// Hands out the input a few bytes at a time, so that every token ends up crossing a buffer boundary at some point.
+class TrickleStream final : public Stream {
+public:
+    TrickleStream(StringView input, size_t bytes_per_read)
+        : m_input(input)
+        , m_bytes_per_read(bytes_per_read)
+    {
+    }
+
+    virtual ErrorOr<Bytes> read(Bytes bytes) override
+    {
+        auto count = min(min(bytes.size(), m_bytes_per_read), m_input.length() - m_offset);
+        m_is_eof = count == 0;
+        m_input.bytes().slice(m_offset, count).copy_to(bytes);
+        m_offset += count;
+        return bytes.trim(count);
+    }
+
+    virtual ErrorOr<size_t> write(ReadonlyBytes) override { return Error::from_errno(EBADF); }
+    virtual bool is_eof() const override { return m_is_eof; }
+    virtual bool is_open() const override { return true; }
+    virtual void close() override { }
+
+private:
+    StringView m_input;
+    size_t m_bytes_per_read { 0 };
+    size_t m_offset { 0 };
+    bool m_is_eof { false };
+};
+
+// Writes the events back out as JSON, which is easy to compare against what JsonParser makes of the same input.
+static ErrorOr<DeprecatedString> events_to_json(JsonReader& reader)
+{
+    StringBuilder builder;
+    Vector<bool> needs_comma { false };
+    for (;;) {
+        auto event = TRY(reader.next());
+        if (event.type == JsonEvent::Type::EndOfDocument)
+            return builder.to_deprecated_string();
+        if (event.type == JsonEvent::Type::EndObject || event.type == JsonEvent::Type::EndArray) {
+            needs_comma.take_last();
+            builder.append(event.type == JsonEvent::Type::EndObject ? '}' : ']');
+            continue;
+        }
+        if (needs_comma.last())
+            builder.append(',');
+        needs_comma.last() = event.type != JsonEvent::Type::Key;
+
+        switch (event.type) {
+        case JsonEvent::Type::StartObject:
+        case JsonEvent::Type::StartArray:
+            builder.append(event.type == JsonEvent::Type::StartObject ? '{' : '[');
+            needs_comma.append(false);
+            break;
+        case JsonEvent::Type::Key:
+            builder.append(JsonValue(event.text).serialized<StringBuilder>());
+            builder.append(':');
+            break;
+        case JsonEvent::Type::String:
+            builder.append(JsonValue(event.text).serialized<StringBuilder>());
+            break;
+        case JsonEvent::Type::Number:
+            builder.append(TRY(JsonParser(event.text).parse()).serialized<StringBuilder>());
+            break;
+        case JsonEvent::Type::True:
+            builder.append("true"sv);
+            break;
+        case JsonEvent::Type::False:
+            builder.append("false"sv);
+            break;
+        case JsonEvent::Type::Null:
+            builder.append("null"sv);
+            break;
+        default:
+            VERIFY_NOT_REACHED();
+        }
+    }
+}
+
+static StringView const s_documents[] = {
+    R"({"name": "Form1", "widgets": [{"x": 155, "enabled": true, "tooltip": null, "visible":false}], "empty": {}, "none": []})"sv,
+    R"(  [1, -2, 3.5, -0, 0.25e3, 1E-2, 4294967296, -2147483649, 18446744073709551616]  )"sv,
+    R"(["", "\"quoted\"", "back\\slash", "\/\b\f\n\r\t", "éA", "日本語"])"sv,
+    R"("just a string")"sv,
+    "12345"sv,
+    "true"sv,
+    "null"sv,
+    R"({"nested": {"deeper": [[[{"deepest": [true, false]}]]]}})"sv,
+};
+
+static StringView const s_invalid_documents[] = {
+    ""sv,
+    "   "sv,
+    "[1,]"sv,
+    R"({"a": 1,})"sv,
+    R"({"a" 1})"sv,
+    R"({1: 2})"sv,
+    "[1 2]"sv,
+    "[01]"sv,
+    "[-]"sv,
+    "[1.]"sv,
+    "[1e]"sv,
+    "[tru]"sv,
+    "[nul]"sv,
+    R"(["unterminated)"sv,
+    R"(["bad \x escape"])"sv,
+    R"(["\u12"])"sv,
+    "[\"control\x01" "character\"]"sv,
+    "[1] [2]"sv,
+    "[1"sv,
+    R"({"a": 1)"sv,
+    "{]"sv,
+};
+
+TEST_CASE(events_match_json_parser)
+{
+    for (auto document : s_documents) {
+        auto expected = MUST(JsonParser(document).parse()).serialized<StringBuilder>();
+
+        JsonReader reader { document };
+        EXPECT_EQ(MUST(events_to_json(reader)), expected);
+
+        for (size_t bytes_per_read : Array<size_t, 4> { 1, 2, 3, 7 }) {
+            TrickleStream stream { document, bytes_per_read };
+            JsonReader stream_reader { stream };
+            EXPECT_EQ(MUST(events_to_json(stream_reader)), expected);
+        }
+    }
+}
+
+TEST_CASE(invalid_documents)
+{
+    for (auto document : s_invalid_documents) {
+        EXPECT(JsonParser(document).parse().is_error());
+
+        JsonReader reader { document };
+        EXPECT(events_to_json(reader).is_error());
+
+        TrickleStream stream { document, 1 };
+        JsonReader stream_reader { stream };
+        EXPECT(events_to_json(stream_reader).is_error());
+
+        EXPECT(JsonTape::create(document).is_error());
+    }
+}
+
+TEST_CASE(event_sequence)
+{
+    JsonReader reader { R"({"a": [1, "two"], "b": false})"sv };
+
+    auto expect_event = [&](JsonEvent::Type type, StringView text = {}) {
+        auto event = MUST(reader.next());
+        EXPECT_EQ(event.type, type);
+        EXPECT_EQ(event.text, text);
+    };
+
+    expect_event(JsonEvent::Type::StartObject);
+    EXPECT_EQ(reader.depth(), 1u);
+    expect_event(JsonEvent::Type::Key, "a"sv);
+    expect_event(JsonEvent::Type::StartArray);
+    EXPECT_EQ(reader.depth(), 2u);
+    expect_event(JsonEvent::Type::Number, "1"sv);
+    expect_event(JsonEvent::Type::String, "two"sv);
+    expect_event(JsonEvent::Type::EndArray);
+    expect_event(JsonEvent::Type::Key, "b"sv);
+    expect_event(JsonEvent::Type::False);
+    expect_event(JsonEvent::Type::EndObject);
+    EXPECT_EQ(reader.depth(), 0u);
+    expect_event(JsonEvent::Type::EndOfDocument);
+    expect_event(JsonEvent::Type::EndOfDocument);
+}
+
+TEST_CASE(numbers)
+{
+    JsonReader reader { "[42, -7, 2.5, 1e3, 4294967296]"sv };
+    EXPECT_EQ(MUST(reader.next()).type, JsonEvent::Type::StartArray);
+
+    auto event = MUST(reader.next());
+    EXPECT_EQ(event.to_number<u32>(), 42u);
+    EXPECT_EQ(event.to_number<double>(), 42.0);
+
+    event = MUST(reader.next());
+    EXPECT_EQ(event.to_number<i32>(), -7);
+    EXPECT(!event.to_number<u32>().has_value());
+
+    event = MUST(reader.next());
+    EXPECT_EQ(event.to_number<double>(), 2.5);
+    EXPECT(!event.to_number<i32>().has_value());
+
+    event = MUST(reader.next());
+    EXPECT_EQ(event.to_number<double>(), 1000.0);
+
+    event = MUST(reader.next());
+    EXPECT_EQ(event.to_number<u64>(), 4294967296ull);
+    EXPECT(!event.to_number<u32>().has_value());
+}
+
+TEST_CASE(skip_rest_of_container)
+{
+    JsonReader reader { R"({"skipped": {"a": [1, {"b": 2}], "c": "d"}, "wanted": 3})"sv };
+    EXPECT_EQ(MUST(reader.next()).type, JsonEvent::Type::StartObject);
+    EXPECT_EQ(MUST(reader.next()).text, "skipped"sv);
+    EXPECT_EQ(MUST(reader.next()).type, JsonEvent::Type::StartObject);
+    MUST(reader.skip_rest_of_container());
+    EXPECT_EQ(reader.depth(), 1u);
+    EXPECT_EQ(MUST(reader.next()).text, "wanted"sv);
+    EXPECT_EQ(MUST(reader.next()).to_number<u32>(), 3u);
+}
+
+TEST_CASE(tape)
+{
+    auto input = R"({"name": "Form1", "escaped\tkey": "with \"escapes\"", "widgets": [{"x": 155}, {"x": 10, "y": [1, 2]}, null], "visible": true})"sv;
+    auto tape = MUST(JsonTape::create(input));
+    auto root = tape.root();
+
+    EXPECT(root.is_object());
+    EXPECT_EQ(root.size(), 4u);
+    EXPECT_EQ(root.get("name"sv)->as_string(), "Form1"sv);
+    EXPECT_EQ(root.get("escaped\tkey"sv)->as_string(), "with \"escapes\""sv);
+    EXPECT_EQ(root.get("escaped\tkey"sv)->source(), R"("with \"escapes\"")"sv);
+    EXPECT(root.get("visible"sv)->as_bool());
+    EXPECT(!root.get("missing"sv).has_value());
+
+    auto widgets = root.get("widgets"sv).value();
+    EXPECT(widgets.is_array());
+    EXPECT_EQ(widgets.size(), 3u);
+    EXPECT_EQ(widgets.at(0).get("x"sv)->to_number<u32>(), 155u);
+    EXPECT_EQ(widgets.at(1).get("y"sv)->at(1).to_number<u32>(), 2u);
+    EXPECT_EQ(widgets.at(1).source(), R"({"x": 10, "y": [1, 2]})"sv);
+    EXPECT(widgets.at(2).is_null());
+
+    Vector<StringView> keys;
+    root.for_each_member([&](StringView key, JsonTapeValue) { keys.append(key); });
+    EXPECT_EQ(keys, (Vector<StringView> { "name"sv, "escaped\tkey"sv, "widgets"sv, "visible"sv }));
+
+    size_t elements = 0;
+    widgets.for_each_element([&](JsonTapeValue) { ++elements; });
+    EXPECT_EQ(elements, 3u);
+
+    auto expected = MUST(JsonParser(input).parse()).serialized<StringBuilder>();
+    EXPECT_EQ(MUST(root.to_json_value()).serialized<StringBuilder>(), expected);
+
+    for (auto document : s_documents) {
+        auto document_tape = MUST(JsonTape::create(document));
+        EXPECT_EQ(MUST(document_tape.root().to_json_value()).serialized<StringBuilder>(), MUST(JsonParser(document).parse()).serialized<StringBuilder>());
+    }
+}
+
+// Something shaped like /sys/kernel/processes, which is the largest document we routinely parse.
+static DeprecatedString const& benchmark_corpus()
+{
+    static DeprecatedString corpus = [] {
+        StringBuilder builder;
+        builder.append(R"({"total_time":982374982,"total_time_kernel":12093,"processes":[)"sv);
+        for (size_t pid = 0; pid < 500; ++pid) {
+            if (pid > 0)
+                builder.append(',');
+            builder.appendff(R"({{"pid":{},"pgid":{},"uid":100,"gid":100,"ppid":1,"name":"Process {}","executable":"/bin/Process{}",)"sv, pid, pid, pid, pid);
+            builder.appendff(R"("pledge":"stdio rpath unix recvfd sendfd","veil":"Locked","amount_virtual":{},"amount_resident":{},"kernel":false,"threads":[)"sv, pid * 4096, pid * 1024);
+            for (size_t tid = 0; tid < 8; ++tid) {
+                if (tid > 0)
+                    builder.append(',');
+                builder.appendff(R"({{"tid":{},"name":"Thread {}","times_scheduled":{},"time_user":{},"time_kernel":{},"state":"Blocking","cpu":0,"priority":30,"lock_count":0,"file_read_bytes":{},"file_write_bytes":0}})"sv, tid, tid, pid * tid, pid * 3, tid * 7, pid * 512);
+            }
+            builder.append("]}"sv);
+        }
+        builder.append("]}"sv);
+        return builder.to_deprecated_string();
+    }();
+    return corpus;
+}
+
+static constexpr size_t benchmark_iterations = 20;
+
+BENCHMARK_CASE(benchmark_json_parser)
+{
+    for (size_t i = 0; i < benchmark_iterations; ++i) {
+        auto value = MUST(JsonParser(benchmark_corpus()).parse());
+        EXPECT_EQ(value.as_object().get_array("processes"sv)->size(), 500u);
+    }
+}
+
+BENCHMARK_CASE(benchmark_json_reader)
+{
+    for (size_t i = 0; i < benchmark_iterations; ++i) {
+        JsonReader reader { benchmark_corpus() };
+        size_t threads = 0;
+        for (;;) {
+            auto event = MUST(reader.next());
+            if (event.type == JsonEvent::Type::EndOfDocument)
+                break;
+            if (event.type == JsonEvent::Type::Key && event.text == "tid"sv)
+                ++threads;
+        }
+        EXPECT_EQ(threads, 4000u);
+    }
+}
+
+BENCHMARK_CASE(benchmark_json_tape)
+{
+    for (size_t i = 0; i < benchmark_iterations; ++i) {
+        auto tape = MUST(JsonTape::create(benchmark_corpus()));
+        EXPECT_EQ(tape.root().get("processes"sv)->size(), 500u);
+    }
+}
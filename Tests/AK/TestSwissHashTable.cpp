@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/DeprecatedString.h>
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/SwissHashTable.h>
+
+TEST_CASE(construct)
+{
+    using IntTable = SwissHashTable<int>;
+    EXPECT(IntTable().is_empty());
+    EXPECT_EQ(IntTable().size(), 0u);
+    EXPECT(IntTable().begin() == IntTable().end());
+}
+
+TEST_CASE(basic_move)
+{
+    SwissHashTable<int> foo;
+    foo.set(1);
+    EXPECT_EQ(foo.size(), 1u);
+    auto bar = move(foo);
+    EXPECT_EQ(bar.size(), 1u);
+    EXPECT_EQ(foo.size(), 0u);
+    foo = move(bar);
+    EXPECT_EQ(bar.size(), 0u);
+    EXPECT_EQ(foo.size(), 1u);
+}
+
+TEST_CASE(set_and_replace)
+{
+    SwissHashTable<DeprecatedString> strings;
+    EXPECT_EQ(strings.set("One"), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.set("Two"), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.set("One"), AK::HashSetResult::ReplacedExistingEntry);
+    EXPECT_EQ(strings.set("Two", AK::HashSetExistingEntryBehavior::Keep), AK::HashSetResult::KeptExistingEntry);
+    EXPECT_EQ(strings.size(), 2u);
+    EXPECT(strings.contains("One"sv));
+    EXPECT(!strings.contains("Three"sv));
+}
+
+TEST_CASE(many_integers)
+{
+    SwissHashTable<int> numbers;
+    for (int i = 0; i < 10'000; ++i)
+        EXPECT_EQ(numbers.set(i * 3), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(numbers.size(), 10'000u);
+
+    for (int i = 0; i < 10'000; ++i) {
+        EXPECT(numbers.contains(i * 3));
+        EXPECT(!numbers.contains(i * 3 + 1));
+    }
+
+    for (int i = 0; i < 10'000; i += 2)
+        EXPECT(numbers.remove(i * 3));
+    EXPECT_EQ(numbers.size(), 5'000u);
+
+    for (int i = 0; i < 10'000; ++i)
+        EXPECT_EQ(numbers.contains(i * 3), i % 2 == 1);
+}
+
+TEST_CASE(iteration_visits_every_value_once)
+{
+    SwissHashTable<int> numbers;
+    for (int i = 0; i < 1'000; ++i)
+        numbers.set(i);
+
+    SwissHashTable<int> seen;
+    for (auto number : numbers)
+        EXPECT_EQ(seen.set(number), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(seen.size(), 1'000u);
+}
+
+TEST_CASE(reuse_deleted_slots)
+{
+    // Repeatedly inserting and removing must not grow the table forever.
+    SwissHashTable<int> numbers;
+    numbers.set(-1);
+    auto capacity = numbers.capacity();
+    for (int i = 0; i < 100'000; ++i) {
+        numbers.set(i);
+        EXPECT(numbers.remove(i));
+    }
+    EXPECT_EQ(numbers.size(), 1u);
+    EXPECT_EQ(numbers.capacity(), capacity);
+    EXPECT(numbers.contains(-1));
+}
+
+TEST_CASE(remove_all_matching)
+{
+    SwissHashTable<int> numbers;
+    for (int i = 0; i < 100; ++i)
+        numbers.set(i);
+
+    EXPECT(numbers.remove_all_matching([](int value) { return value % 10 != 0; }));
+    EXPECT_EQ(numbers.size(), 10u);
+    for (int i = 0; i < 100; i += 10)
+        EXPECT(numbers.contains(i));
+
+    EXPECT(!numbers.remove_all_matching([](int) { return false; }));
+    EXPECT(numbers.remove_all_matching([](int) { return true; }));
+    EXPECT(numbers.is_empty());
+}
+
+TEST_CASE(ensure_capacity)
+{
+    SwissHashTable<int> numbers;
+    numbers.ensure_capacity(1'000);
+    auto capacity = numbers.capacity();
+    EXPECT(capacity >= 1'000u);
+    for (int i = 0; i < 1'000; ++i)
+        numbers.set(i);
+    EXPECT_EQ(numbers.capacity(), capacity);
+}
+
+TEST_CASE(non_trivial_values)
+{
+    SwissHashTable<NonnullOwnPtr<DeprecatedString>> strings;
+    for (int i = 0; i < 100; ++i)
+        strings.set(make<DeprecatedString>(DeprecatedString::number(i)));
+    EXPECT_EQ(strings.size(), 100u);
+    strings.clear_with_capacity();
+    EXPECT(strings.is_empty());
+    EXPECT(strings.begin() == strings.end());
+}
+
+TEST_CASE(hash_map)
+{
+    SwissHashMap<DeprecatedString, int> map;
+    map.set("one", 1);
+    map.set("two", 2);
+    map.set("three", 3);
+    EXPECT_EQ(map.size(), 3u);
+    EXPECT_EQ(map.get("two"sv), 2);
+    EXPECT(!map.get("four"sv).has_value());
+
+    map.ensure("four", [] { return 4; });
+    EXPECT_EQ(map.take("one"sv), 1);
+    EXPECT_EQ(map.size(), 3u);
+
+    int sum = 0;
+    for (auto& it : map)
+        sum += it.value;
+    EXPECT_EQ(sum, 9);
+}
+
+// These compare HashTable and SwissHashTable on the same workloads.
+
+static constexpr int benchmark_value_count = 100'000;
+
+template<typename TableType>
+static void insert_benchmark()
+{
+    for (int round = 0; round < 10; ++round) {
+        TableType table;
+        for (int i = 0; i < benchmark_value_count; ++i)
+            table.set(i);
+        EXPECT_EQ(table.size(), static_cast<size_t>(benchmark_value_count));
+    }
+}
+
+template<typename TableType>
+static void lookup_benchmark()
+{
+    TableType table;
+    for (int i = 0; i < benchmark_value_count; ++i)
+        table.set(i * 2);
+
+    size_t found = 0;
+    for (int round = 0; round < 10; ++round) {
+        // Half of these miss.
+        for (int i = 0; i < benchmark_value_count * 2; ++i)
+            found += table.contains(i);
+    }
+    EXPECT_EQ(found, static_cast<size_t>(benchmark_value_count) * 10);
+}
+
+template<typename TableType>
+static void iteration_benchmark()
+{
+    TableType table;
+    for (int i = 0; i < benchmark_value_count; ++i)
+        table.set(i);
+
+    u64 sum = 0;
+    for (int round = 0; round < 100; ++round) {
+        for (auto value : table)
+            sum += value;
+    }
+    EXPECT_EQ(sum, static_cast<u64>(benchmark_value_count - 1) * benchmark_value_count / 2 * 100);
+}
+
+BENCHMARK_CASE(hash_table_insert) { insert_benchmark<HashTable<int>>(); }
+BENCHMARK_CASE(swiss_hash_table_insert) { insert_benchmark<SwissHashTable<int>>(); }
+BENCHMARK_CASE(hash_table_lookup) { lookup_benchmark<HashTable<int>>(); }
+BENCHMARK_CASE(swiss_hash_table_lookup) { lookup_benchmark<SwissHashTable<int>>(); }
+BENCHMARK_CASE(hash_table_iteration) { iteration_benchmark<HashTable<int>>(); }
+BENCHMARK_CASE(swiss_hash_table_iteration) { iteration_benchmark<SwissHashTable<int>>(); }
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <unistd.h>
+
+static void add_interest(int epoll_fd, int fd, u32 events)
+{
+    epoll_event event {};
+    event.events = events;
+    event.data.fd = fd;
+    MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event));
+}
+
+static int wait_for_events(int epoll_fd, Span<epoll_event> events)
+{
+    return MUST(Core::System::epoll_wait(epoll_fd, events, 0));
+}
+
+TEST_CASE(level_triggered)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create(EPOLL_CLOEXEC));
+    auto pipe_fds = MUST(Core::System::pipe2(O_CLOEXEC));
+    add_interest(epoll_fd, pipe_fds[0], EPOLLIN);
+
+    Array<epoll_event, 4> events;
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 0);
+
+    MUST(Core::System::write(pipe_fds[1], "a"sv.bytes()));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+    EXPECT_EQ(events[0].data.fd, pipe_fds[0]);
+    EXPECT_EQ(events[0].events, EPOLLIN);
+
+    // Still readable, so it's reported again.
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+
+    u8 buffer[1];
+    MUST(Core::System::read(pipe_fds[0], { buffer, sizeof(buffer) }));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 0);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(edge_triggered)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create(EPOLL_CLOEXEC));
+    auto pipe_fds = MUST(Core::System::pipe2(O_CLOEXEC));
+    add_interest(epoll_fd, pipe_fds[0], EPOLLIN | EPOLLET);
+
+    Array<epoll_event, 4> events;
+    MUST(Core::System::write(pipe_fds[1], "a"sv.bytes()));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+
+    // Nothing changed since, so it's not reported again even though it's still readable.
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 0);
+
+    MUST(Core::System::write(pipe_fds[1], "b"sv.bytes()));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(oneshot_and_modify)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create(EPOLL_CLOEXEC));
+    auto pipe_fds = MUST(Core::System::pipe2(O_CLOEXEC));
+    add_interest(epoll_fd, pipe_fds[0], EPOLLIN | EPOLLONESHOT);
+
+    Array<epoll_event, 4> events;
+    MUST(Core::System::write(pipe_fds[1], "a"sv.bytes()));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 0);
+
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.u64 = 1234;
+    MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, pipe_fds[0], &event));
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 1);
+    EXPECT_EQ(events[0].data.u64, 1234u);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(interest_goes_away_with_its_description)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create(EPOLL_CLOEXEC));
+    auto pipe_fds = MUST(Core::System::pipe2(O_CLOEXEC));
+    add_interest(epoll_fd, pipe_fds[0], EPOLLIN);
+
+    epoll_event event {};
+    auto result = Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event);
+    EXPECT_EQ(result.error().code(), EEXIST);
+
+    MUST(Core::System::write(pipe_fds[1], "a"sv.bytes()));
+    MUST(Core::System::close(pipe_fds[0]));
+
+    Array<epoll_event, 4> events;
+    EXPECT_EQ(wait_for_events(epoll_fd, events), 0);
+
+    result = Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe_fds[0], nullptr);
+    EXPECT_EQ(result.error().code(), ENOENT);
+
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(cannot_nest)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create(EPOLL_CLOEXEC));
+    auto other_epoll_fd = MUST(Core::System::epoll_create(EPOLL_CLOEXEC));
+
+    epoll_event event {};
+    event.events = EPOLLIN;
+    auto result = Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, other_epoll_fd, &event);
+    EXPECT_EQ(result.error().code(), EINVAL);
+
+    MUST(Core::System::close(other_epoll_fd));
+    MUST(Core::System::close(epoll_fd));
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <pthread.h>
+#include <serenity.h>
+#include <unistd.h>
+
+static u32 s_futexes[3];
+static Atomic<int> s_wait_result { -2 };
+
+static void* wait_on_all_futexes(void*)
+{
+    futex_wait_block wait_blocks[3];
+    for (size_t i = 0; i < 3; ++i)
+        wait_blocks[i] = { &s_futexes[i], 0 };
+    s_wait_result = futex_wait_multiple(wait_blocks, 3, nullptr, false);
+    return nullptr;
+}
+
+TEST_CASE(wait_multiple_returns_index_of_woken_futex)
+{
+    s_futexes[0] = s_futexes[1] = s_futexes[2] = 0;
+    s_wait_result = -2;
+
+    pthread_t thread;
+    EXPECT_EQ(pthread_create(&thread, nullptr, wait_on_all_futexes, nullptr), 0);
+
+    // Keep poking until the waiter is actually asleep, a wake before that goes nowhere.
+    int woken = 0;
+    while (woken == 0) {
+        usleep(1000);
+        woken = futex_wake(&s_futexes[2], 1, false);
+    }
+    EXPECT_EQ(pthread_join(thread, nullptr), 0);
+    EXPECT_EQ(s_wait_result.load(), 2);
+}
+
+TEST_CASE(wait_multiple_checks_every_value)
+{
+    u32 futexes[2] { 0, 1 };
+    futex_wait_block wait_blocks[2] { { &futexes[0], 0 }, { &futexes[1], 0 } };
+    EXPECT_EQ(futex_wait_multiple(wait_blocks, 2, nullptr, false), -1);
+    EXPECT_EQ(errno, EAGAIN);
+}
+
+TEST_CASE(wait_multiple_times_out)
+{
+    u32 futexes[2] { 0, 0 };
+    futex_wait_block wait_blocks[2] { { &futexes[0], 0 }, { &futexes[1], 0 } };
+    timespec timeout { 0, 10'000'000 };
+    EXPECT_EQ(futex_wait_multiple(wait_blocks, 2, &timeout, false), -1);
+    EXPECT_EQ(errno, ETIMEDOUT);
+}
+
+TEST_CASE(wait_multiple_rejects_bad_counts)
+{
+    u32 futex_value = 0;
+    futex_wait_block wait_block { &futex_value, 0 };
+    EXPECT_EQ(futex_wait_multiple(&wait_block, 0, nullptr, false), -1);
+    EXPECT_EQ(errno, EINVAL);
+    EXPECT_EQ(futex_wait_multiple(&wait_block, FUTEX_WAIT_MULTIPLE_MAX + 1, nullptr, false), -1);
+    EXPECT_EQ(errno, EINVAL);
+}
+
+static u32 s_requeue_from;
+static u32 s_requeue_to;
+
+static void* wait_on_requeue_source(void*)
+{
+    futex_wait(&s_requeue_from, 0, nullptr, 0, false);
+    return nullptr;
+}
+
+TEST_CASE(cmp_requeue_moves_waiters)
+{
+    s_requeue_from = s_requeue_to = 0;
+
+    pthread_t thread;
+    EXPECT_EQ(pthread_create(&thread, nullptr, wait_on_requeue_source, nullptr), 0);
+
+    // Requeue without waking anyone, which is what condition variables do to move their waiters onto the mutex.
+    int requeued = 0;
+    while (requeued == 0) {
+        usleep(1000);
+        requeued = futex(&s_requeue_from, FUTEX_CMP_REQUEUE | FUTEX_PRIVATE_FLAG, 0, reinterpret_cast<timespec const*>(1), &s_requeue_to, 0);
+        EXPECT(requeued >= 0);
+    }
+
+    // The waiter is now waiting on the other futex, and only a wake on that one gets it going again.
+    EXPECT_EQ(futex_wake(&s_requeue_from, 1, false), 0);
+    EXPECT_EQ(futex_wake(&s_requeue_to, 1, false), 1);
+    EXPECT_EQ(pthread_join(thread, nullptr), 0);
+}
+
+TEST_CASE(cmp_requeue_checks_value)
+{
+    u32 from = 1;
+    u32 to = 0;
+    EXPECT_EQ(futex(&from, FUTEX_CMP_REQUEUE | FUTEX_PRIVATE_FLAG, 0, reinterpret_cast<timespec const*>(1), &to, 0), -1);
+    EXPECT_EQ(errno, EAGAIN);
+}
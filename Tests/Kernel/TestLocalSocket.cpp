@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static int buffer_capacity(int fd, int option)
+{
+    int capacity = 0;
+    socklen_t capacity_size = sizeof(capacity);
+    MUST(Core::System::getsockopt(fd, SOL_SOCKET, option, &capacity, &capacity_size));
+    EXPECT_EQ(capacity_size, sizeof(capacity));
+    return capacity;
+}
+
+TEST_CASE(grow_buffers)
+{
+    int fds[2];
+    MUST(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, fds));
+    EXPECT_EQ(buffer_capacity(fds[0], SO_SNDBUF), 65536);
+    EXPECT_EQ(buffer_capacity(fds[1], SO_RCVBUF), 65536);
+
+    int capacity = 256 * KiB;
+    MUST(Core::System::setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &capacity, sizeof(capacity)));
+    EXPECT_EQ(buffer_capacity(fds[0], SO_SNDBUF), 256 * KiB);
+    // The sender's send buffer is the receiver's receive buffer.
+    EXPECT_EQ(buffer_capacity(fds[1], SO_RCVBUF), 256 * KiB);
+    EXPECT_EQ(buffer_capacity(fds[1], SO_SNDBUF), 65536);
+
+    // Buffers don't shrink.
+    capacity = 4096;
+    MUST(Core::System::setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &capacity, sizeof(capacity)));
+    EXPECT_EQ(buffer_capacity(fds[0], SO_SNDBUF), 256 * KiB);
+
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+}
+
+TEST_CASE(data_written_before_growing_is_kept)
+{
+    int fds[2];
+    MUST(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, fds));
+    MUST(Core::System::write(fds[0], "hello"sv.bytes()));
+
+    int capacity = 128 * KiB;
+    MUST(Core::System::setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &capacity, sizeof(capacity)));
+    MUST(Core::System::write(fds[0], " friends"sv.bytes()));
+
+    char buffer[32] {};
+    auto nread = MUST(Core::System::read(fds[1], { buffer, sizeof(buffer) }));
+    EXPECT_EQ(StringView(buffer, nread), "hello friends"sv);
+
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+}
+
+TEST_CASE(large_write_sees_data_at_time_of_write)
+{
+    int fds[2];
+    // The write stops short once the transferred pages are waiting to be read, rather than blocking.
+    MUST(Core::System::socketpair(AF_LOCAL, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+
+    size_t const size = 128 * KiB;
+    auto* data = static_cast<u8*>(MUST(Core::System::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0)));
+    for (size_t i = 0; i < size; ++i)
+        data[i] = static_cast<u8>(i % 251);
+
+    // A small prefix keeps the large write from starting on a page boundary.
+    MUST(Core::System::write(fds[0], "!"sv.bytes()));
+    size_t nwritten = MUST(Core::System::write(fds[0], { data + 1, size - 1 }));
+    EXPECT(nwritten > 0);
+
+    // Writing to the buffer after sending it must not change what the receiver reads.
+    memset(data, 0, size);
+
+    auto* received = static_cast<u8*>(MUST(Core::System::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0)));
+    size_t nread = 0;
+    while (nread < nwritten + 1)
+        nread += MUST(Core::System::read(fds[1], { received + nread, nwritten + 1 - nread }));
+
+    EXPECT_EQ(received[0], '!');
+    for (size_t i = 1; i <= nwritten; ++i) {
+        if (received[i] != static_cast<u8>(i % 251)) {
+            FAIL("Received data doesn't match what was written");
+            break;
+        }
+    }
+
+    MUST(Core::System::munmap(data, size));
+    MUST(Core::System::munmap(received, size));
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+}
@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibCore/File.h>
+#include <LibCore/ProcessStatisticsReader.h>
 #include <LibTest/TestCase.h>
 #include <cstring>
 #include <sys/stat.h>
@@ -74,3 +76,32 @@ TEST_CASE(test_process_fd_readlink)
     buf[link_length] = '\0';
     EXPECT_EQ(0, strcmp(buf, expected_link));
 }
+
+TEST_CASE(binary_process_statistics_match_json)
+{
+    auto json_file = MUST(Core::File::open("/sys/kernel/processes"sv, Core::File::OpenMode::Read));
+    auto binary_file = MUST(Core::File::open("/sys/kernel/process_statistics"sv, Core::File::OpenMode::Read));
+    auto from_json = MUST(Core::ProcessStatisticsReader::get_all(*json_file, false));
+    auto from_binary = MUST(Core::ProcessStatisticsReader::get_all(*binary_file, false));
+
+    auto find_self = [](Core::AllProcessesStatistics const& statistics) -> Core::ProcessStatistics const* {
+        for (auto& process : statistics.processes) {
+            if (process.pid == getpid())
+                return &process;
+        }
+        return nullptr;
+    };
+    auto const* self_from_json = find_self(from_json);
+    auto const* self_from_binary = find_self(from_binary);
+    VERIFY(self_from_json && self_from_binary);
+
+    EXPECT_EQ(self_from_binary->name, self_from_json->name);
+    EXPECT_EQ(self_from_binary->executable, self_from_json->executable);
+    EXPECT_EQ(self_from_binary->pledge, self_from_json->pledge);
+    EXPECT_EQ(self_from_binary->veil, self_from_json->veil);
+    EXPECT_EQ(self_from_binary->uid, self_from_json->uid);
+    EXPECT_EQ(self_from_binary->ppid, self_from_json->ppid);
+    EXPECT_EQ(self_from_binary->threads.size(), self_from_json->threads.size());
+    EXPECT_EQ(self_from_binary->threads.first().tid, self_from_json->threads.first().tid);
+    EXPECT_EQ(self_from_binary->threads.first().name, self_from_json->threads.first().name);
+}
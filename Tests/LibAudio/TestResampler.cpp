@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Math.h>
+#include <LibAudio/Resampler.h>
+#include <LibTest/TestCase.h>
+
+static Vector<Audio::Sample> sine_wave(u32 sample_rate, float frequency, size_t sample_count)
+{
+    Vector<Audio::Sample> samples;
+    for (size_t i = 0; i < sample_count; ++i) {
+        auto value = AK::sin(2 * AK::Pi<float> * frequency * static_cast<float>(i) / static_cast<float>(sample_rate)) * 0.5f;
+        samples.append({ value, -value });
+    }
+    return samples;
+}
+
+static void expect_resampled_sine(u32 source, u32 target)
+{
+    constexpr float frequency = 1000;
+    constexpr size_t chunk_size = 1000;
+
+    auto input = sine_wave(source, frequency, source);
+    auto resampler = MUST(Audio::SincResampler::try_create(source, target));
+
+    // The stream is resampled in pieces, which must not make a difference.
+    Vector<Audio::Sample> output;
+    for (size_t i = 0; i < input.size(); i += chunk_size)
+        MUST(resampler.try_resample_into_end(output, input.span().slice(i, min(chunk_size, input.size() - i))));
+
+    // The output lags behind by half the filter's length, so it has to be that much shorter.
+    EXPECT(output.size() <= target);
+    EXPECT(output.size() >= target - 200);
+
+    // Find the delay by where the output first crosses zero going upwards, and compare with the ideal sine from there.
+    size_t start = 0;
+    while (start + 1 < output.size() && !(output[start].left <= 0 && output[start + 1].left > 0))
+        ++start;
+    auto crossing = static_cast<float>(start) - output[start].left / (output[start + 1].left - output[start].left);
+
+    float max_error = 0;
+    for (size_t i = start + 100; i < output.size(); ++i) {
+        auto expected = AK::sin(2 * AK::Pi<float> * frequency * (static_cast<float>(i) - crossing) / static_cast<float>(target)) * 0.5f;
+        max_error = max(max_error, AK::fabs(output[i].left - expected));
+        max_error = max(max_error, AK::fabs(output[i].right + expected));
+    }
+    EXPECT(max_error < 0.01f);
+}
+
+TEST_CASE(resample_up)
+{
+    expect_resampled_sine(44100, 48000);
+    expect_resampled_sine(22050, 44100);
+}
+
+TEST_CASE(resample_down)
+{
+    expect_resampled_sine(48000, 44100);
+    expect_resampled_sine(96000, 44100);
+}
+
+TEST_CASE(resample_irregular_ratio)
+{
+    // 44100 and 44117 have no common factor, so the filter's phases are rounded.
+    expect_resampled_sine(44100, 44117);
+}
+
+TEST_CASE(constant_signal_is_unchanged)
+{
+    Vector<Audio::Sample> input;
+    input.resize(4000, true);
+    for (auto& sample : input)
+        sample = { 0.25f, -0.5f };
+
+    auto resampler = MUST(Audio::SincResampler::try_create(48000, 44100));
+    auto output = MUST(resampler.try_resample(input.span()));
+
+    // The first samples contain the silence from before the start.
+    for (size_t i = 100; i < output.size(); ++i) {
+        EXPECT_APPROXIMATE(output[i].left, 0.25f);
+        EXPECT_APPROXIMATE(output[i].right, -0.5f);
+    }
+}
+
+TEST_CASE(reset_forgets_previous_input)
+{
+    auto input = sine_wave(44100, 1000, 2000);
+    auto resampler = MUST(Audio::SincResampler::try_create(44100, 48000));
+
+    auto first = MUST(resampler.try_resample(input.span()));
+    resampler.reset();
+    auto second = MUST(resampler.try_resample(input.span()));
+
+    EXPECT_EQ(first.size(), second.size());
+    for (size_t i = 0; i < first.size(); ++i) {
+        EXPECT_EQ(first[i].left, second[i].left);
+        EXPECT_EQ(first[i].right, second[i].right);
+    }
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+static constexpr size_t waiter_count = 8;
+
+struct SharedState {
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+    size_t waiting { 0 };
+    bool go { false };
+    size_t woken { 0 };
+};
+
+static void* wait_for_go(void* argument)
+{
+    auto& state = *static_cast<SharedState*>(argument);
+    pthread_mutex_lock(&state.mutex);
+    ++state.waiting;
+    while (!state.go)
+        pthread_cond_wait(&state.cond, &state.mutex);
+    ++state.woken;
+    pthread_mutex_unlock(&state.mutex);
+    return nullptr;
+}
+
+static void wait_until_all_are_waiting(SharedState& state, size_t count)
+{
+    for (;;) {
+        pthread_mutex_lock(&state.mutex);
+        bool all_waiting = state.waiting == count;
+        pthread_mutex_unlock(&state.mutex);
+        if (all_waiting)
+            return;
+        usleep(1000);
+    }
+}
+
+TEST_CASE(broadcast_wakes_all_waiters)
+{
+    SharedState state;
+    pthread_t threads[waiter_count];
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread, nullptr, wait_for_go, &state), 0);
+    wait_until_all_are_waiting(state, waiter_count);
+
+    pthread_mutex_lock(&state.mutex);
+    state.go = true;
+    pthread_cond_broadcast(&state.cond);
+    pthread_mutex_unlock(&state.mutex);
+
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+    EXPECT_EQ(state.woken, waiter_count);
+}
+
+TEST_CASE(broadcast_without_holding_the_mutex)
+{
+    SharedState state;
+    pthread_t threads[waiter_count];
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread, nullptr, wait_for_go, &state), 0);
+    wait_until_all_are_waiting(state, waiter_count);
+
+    pthread_mutex_lock(&state.mutex);
+    state.go = true;
+    pthread_mutex_unlock(&state.mutex);
+    pthread_cond_broadcast(&state.cond);
+
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+    EXPECT_EQ(state.woken, waiter_count);
+}
+
+TEST_CASE(signal_wakes_every_waiter_eventually)
+{
+    SharedState state;
+    pthread_t threads[waiter_count];
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread, nullptr, wait_for_go, &state), 0);
+    wait_until_all_are_waiting(state, waiter_count);
+
+    pthread_mutex_lock(&state.mutex);
+    state.go = true;
+    pthread_mutex_unlock(&state.mutex);
+    for (size_t i = 0; i < waiter_count; ++i)
+        pthread_cond_signal(&state.cond);
+
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+    EXPECT_EQ(state.woken, waiter_count);
+}
+
+TEST_CASE(timedwait_holds_mutex_after_timeout)
+{
+    SharedState state;
+    timespec deadline {};
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &deadline);
+    deadline.tv_nsec += 10'000'000;
+    if (deadline.tv_nsec >= 1'000'000'000) {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1'000'000'000;
+    }
+
+    pthread_mutex_lock(&state.mutex);
+    EXPECT_EQ(pthread_cond_timedwait(&state.cond, &state.mutex, &deadline), ETIMEDOUT);
+    EXPECT_EQ(pthread_mutex_trylock(&state.mutex), EBUSY);
+    pthread_mutex_unlock(&state.mutex);
+}
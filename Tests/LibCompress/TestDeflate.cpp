@@ -11,6 +11,7 @@
 #include <AK/MemoryStream.h>
 #include <AK/Random.h>
 #include <LibCompress/Deflate.h>
+#include <LibCore/File.h>
 #include <cstring>
 
 TEST_CASE(canonical_code_simple)
@@ -148,6 +149,29 @@ TEST_CASE(deflate_round_trip_compress_large)
     EXPECT(uncompressed.value() == original);
 }
 
+TEST_CASE(deflate_concatenate_sync_flushed_streams)
+{
+    auto original = ByteBuffer::create_zeroed(3 * Compress::DeflateCompressor::block_size).release_value();
+    fill_with_random(original.data(), Compress::DeflateCompressor::block_size);
+
+    AllocatingMemoryStream output_stream;
+    auto chunk_size = original.size() / 3;
+    for (size_t offset = 0; offset < original.size(); offset += chunk_size) {
+        auto compressor = MUST(Compress::DeflateCompressor::construct(MaybeOwned<Stream>(output_stream), Compress::DeflateCompressor::CompressionLevel::FAST));
+        MUST(compressor->write_entire_buffer(original.bytes().slice(offset, chunk_size)));
+        if (offset + chunk_size == original.size())
+            MUST(compressor->final_flush());
+        else
+            MUST(compressor->sync_flush_and_finish());
+    }
+
+    auto compressed = MUST(ByteBuffer::create_uninitialized(output_stream.used_buffer_size()));
+    MUST(output_stream.read_entire_buffer(compressed));
+    auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed);
+    EXPECT(!uncompressed.is_error());
+    EXPECT(uncompressed.value() == original);
+}
+
 TEST_CASE(deflate_compress_literals)
 {
     // This byte array is known to not produce any back references with our lz77 implementation even at the highest compression settings
@@ -155,3 +179,91 @@ TEST_CASE(deflate_compress_literals)
     auto compressed = Compress::DeflateCompressor::compress_all(test, Compress::DeflateCompressor::CompressionLevel::GOOD);
     EXPECT(!compressed.is_error());
 }
+
+BENCHMARK_CASE(deflate_decompress_large)
+{
+    // A small alphabet gives us plenty of both literals and back references, like text does.
+    auto size = 16 * MiB;
+    auto original = ByteBuffer::create_uninitialized(size).release_value();
+    fill_with_random(original.data(), size);
+    for (auto& byte : original.bytes())
+        byte = 'a' + byte % 16;
+
+    auto compressed = MUST(Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FAST));
+    auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed);
+    EXPECT(!uncompressed.is_error());
+    EXPECT(uncompressed.value() == original);
+}
+
+static ByteBuffer load_corpus()
+{
+    // This makes sure that the tests will run both on target and in Lagom.
+#ifdef AK_OS_SERENITY
+    auto directory = "/usr/Tests/LibCompress/brotli-test-files"sv;
+#else
+    auto directory = "brotli-test-files"sv;
+#endif
+
+    ByteBuffer corpus;
+    for (auto file_name : { "KaticaRegular10.font"sv, "happy3rd.html"sv, "transform.txt"sv, "serenityos.html"sv, "lorem.txt"sv }) {
+        auto file = MUST(Core::File::open(DeprecatedString::formatted("{}/{}", directory, file_name), Core::File::OpenMode::Read));
+        corpus.append(MUST(file->read_until_eof()));
+    }
+    return corpus;
+}
+
+static size_t compressed_corpus_size(ByteBuffer const& corpus, Compress::DeflateCompressor::CompressionLevel level)
+{
+    auto compressed = MUST(Compress::DeflateCompressor::compress_all(corpus, level));
+    auto uncompressed = MUST(Compress::DeflateDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == corpus);
+    return compressed.size();
+}
+
+TEST_CASE(deflate_compression_ratio)
+{
+    using Level = Compress::DeflateCompressor::CompressionLevel;
+    auto corpus = load_corpus();
+    EXPECT_EQ(corpus.size(), 1260331u);
+
+    // These are a little above what each level achieved when they were last changed, so that we notice if one gets worse.
+    auto fastest_size = compressed_corpus_size(corpus, Level::FASTEST);
+    EXPECT(fastest_size <= 104000u);
+    auto fast_size = compressed_corpus_size(corpus, Level::FAST);
+    EXPECT(fast_size <= 95500u);
+    auto good_size = compressed_corpus_size(corpus, Level::GOOD);
+    EXPECT(good_size <= 78500u);
+    auto great_size = compressed_corpus_size(corpus, Level::GREAT);
+    EXPECT(great_size <= 77500u);
+
+    EXPECT(fast_size <= fastest_size);
+    EXPECT(good_size <= fast_size);
+    EXPECT(great_size <= good_size);
+}
+
+static void benchmark_compression_level(Compress::DeflateCompressor::CompressionLevel level)
+{
+    auto corpus = load_corpus();
+    for (size_t i = 0; i < 4; ++i)
+        EXPECT(!Compress::DeflateCompressor::compress_all(corpus, level).is_error());
+}
+
+BENCHMARK_CASE(deflate_compress_fastest)
+{
+    benchmark_compression_level(Compress::DeflateCompressor::CompressionLevel::FASTEST);
+}
+
+BENCHMARK_CASE(deflate_compress_fast)
+{
+    benchmark_compression_level(Compress::DeflateCompressor::CompressionLevel::FAST);
+}
+
+BENCHMARK_CASE(deflate_compress_good)
+{
+    benchmark_compression_level(Compress::DeflateCompressor::CompressionLevel::GOOD);
+}
+
+BENCHMARK_CASE(deflate_compress_great)
+{
+    benchmark_compression_level(Compress::DeflateCompressor::CompressionLevel::GREAT);
+}
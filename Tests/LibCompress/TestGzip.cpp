@@ -9,6 +9,7 @@
 #include <AK/Array.h>
 #include <AK/Random.h>
 #include <LibCompress/Gzip.h>
+#include <LibThreading/ThreadPool.h>
 
 TEST_CASE(gzip_decompress_simple)
 {
@@ -95,3 +96,25 @@ TEST_CASE(gzip_round_trip)
     EXPECT(!uncompressed.is_error());
     EXPECT(uncompressed.value() == original);
 }
+
+TEST_CASE(gzip_round_trip_parallel)
+{
+    // A small alphabet gives us plenty of back references, some of which reach into the chunk before.
+    auto size = 3 * MiB;
+    auto original = ByteBuffer::create_uninitialized(size).release_value();
+    fill_with_random(original.data(), size);
+    for (auto& byte : original.bytes())
+        byte = 'a' + byte % 8;
+
+    Threading::ThreadPool thread_pool { 4 };
+    auto compressed = Compress::GzipCompressor::compress_all(original, &thread_pool);
+    EXPECT(!compressed.is_error());
+    auto uncompressed = Compress::GzipDecompressor::decompress_all(compressed.value());
+    EXPECT(!uncompressed.is_error());
+    EXPECT(uncompressed.value() == original);
+
+    // Each chunk should only cost us the sync flush after it.
+    auto compressed_sequentially = MUST(Compress::GzipCompressor::compress_all(original));
+    auto chunk_count = ceil_div(size, 8 * Compress::DeflateCompressor::block_size);
+    EXPECT(compressed.value().size() <= compressed_sequentially.size() + 6 * chunk_count);
+}
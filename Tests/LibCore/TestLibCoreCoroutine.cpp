@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/Coroutine.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Promise.h>
+#include <LibCore/Socket.h>
+#include <LibTest/TestCase.h>
+#include <sys/socket.h>
+
+static Core::Task<int> add(int a, int b)
+{
+    co_return a + b;
+}
+
+static Core::Task<int> add_twice(int a, int b)
+{
+    auto first = co_await add(a, b);
+    auto second = co_await add(first, b);
+    co_return second;
+}
+
+TEST_CASE(tasks_can_await_tasks)
+{
+    Core::EventLoop loop;
+    EXPECT_EQ(add_twice(1, 2).await(), 5);
+}
+
+TEST_CASE(tasks_are_lazy)
+{
+    Core::EventLoop loop;
+    bool did_run = false;
+    // Coroutine lambdas must not capture anything, as the lambda is gone by the time the task runs.
+    auto task = [](bool& did_run) -> Core::Task<> {
+        did_run = true;
+        co_return;
+    }(did_run);
+    EXPECT(!did_run);
+    task.await();
+    EXPECT(did_run);
+}
+
+TEST_CASE(delay)
+{
+    Core::EventLoop loop;
+    auto start = Time::now_monotonic();
+    []() -> Core::Task<> {
+        co_await Core::delay(20);
+        co_await Core::delay(20);
+    }()
+                .await();
+    EXPECT((Time::now_monotonic() - start).to_milliseconds() >= 40);
+}
+
+TEST_CASE(detached_task_runs_to_completion)
+{
+    Core::EventLoop loop;
+    int steps = 0;
+    [](int& steps) -> Core::Task<> {
+        ++steps;
+        co_await Core::delay(10);
+        ++steps;
+    }(steps)
+                          .detach();
+    EXPECT_EQ(steps, 1);
+    while (steps != 2)
+        loop.pump();
+}
+
+TEST_CASE(await_promise)
+{
+    Core::EventLoop loop;
+    auto promise = Core::Promise<int>::construct();
+    auto timer = MUST(Core::Timer::create_single_shot(10, [&] { promise->resolve(42); }));
+    timer->start();
+
+    auto result = [](Core::Promise<int>& promise) -> Core::Task<int> {
+        co_return co_await promise;
+    }(*promise)
+                      .await();
+    EXPECT_EQ(result, 42);
+}
+
+TEST_CASE(read_some_from_socket)
+{
+    Core::EventLoop loop;
+    int fds[2];
+    EXPECT_EQ(socketpair(AF_LOCAL, SOCK_STREAM, 0, fds), 0);
+    auto reader = MUST(Core::LocalSocket::adopt_fd(fds[0]));
+    auto writer = MUST(Core::LocalSocket::adopt_fd(fds[1]));
+
+    auto timer = MUST(Core::Timer::create_repeating(5, [&, count = 0]() mutable {
+        MUST(writer->write_entire_buffer("ping"sv.bytes()));
+        if (++count == 3)
+            writer->close();
+    }));
+    timer->start();
+
+    auto received = [](Core::LocalSocket& reader) -> Core::Task<DeprecatedString> {
+        StringBuilder builder;
+        u8 buffer[16];
+        for (;;) {
+            auto result = co_await reader.read_some({ buffer, sizeof(buffer) });
+            auto bytes = MUST(move(result));
+            if (bytes.is_empty())
+                break;
+            builder.append(StringView { bytes });
+        }
+        co_return builder.to_deprecated_string();
+    }(*reader)
+                        .await();
+    EXPECT_EQ(received, "pingpingping");
+}
@@ -5,9 +5,11 @@
  */
 
 #include <AK/Format.h>
+#include <AK/Vector.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/Timer.h>
 #include <LibTest/TestCase.h>
+#include <LibThreading/Thread.h>
 
 TEST_CASE(deferred_invoke)
 {
@@ -23,3 +25,43 @@ TEST_CASE(deferred_invoke)
 
     event_loop.exec();
 }
+
+TEST_CASE(deferred_invoke_from_other_threads)
+{
+    static constexpr size_t thread_count = 4;
+    static constexpr size_t invocations_per_thread = 10000;
+
+    Core::EventLoop event_loop;
+    auto reaper = MUST(Core::Timer::create_single_shot(5000, [] {
+        warnln("Not all invocations from the other threads arrived!");
+        VERIFY_NOT_REACHED();
+    }));
+    reaper->start();
+
+    // Only the event loop's thread touches these, so they don't need any locking.
+    Vector<size_t> next_invocation;
+    next_invocation.resize(thread_count);
+    size_t remaining_invocations = thread_count * invocations_per_thread;
+
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    for (size_t thread_index = 0; thread_index < thread_count; ++thread_index) {
+        threads.append(Threading::Thread::construct([&, thread_index] {
+            for (size_t i = 0; i < invocations_per_thread; ++i) {
+                event_loop.deferred_invoke([&, thread_index, i] {
+                    // Invocations from the same thread have to arrive in the order they were made.
+                    EXPECT_EQ(next_invocation[thread_index], i);
+                    next_invocation[thread_index] = i + 1;
+                    if (--remaining_invocations == 0)
+                        event_loop.quit(0);
+                });
+                event_loop.wake();
+            }
+            return 0;
+        }));
+        threads.last()->start();
+    }
+
+    EXPECT_EQ(event_loop.exec(), 0);
+    for (auto& thread : threads)
+        (void)thread->join();
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Random.h>
+#include <AK/Vector.h>
+#include <LibCore/TimerWheel.h>
+#include <LibTest/TestCase.h>
+
+using Ticks = Core::TimerWheel::Ticks;
+
+// Entries have to outlive the wheel they're scheduled on, so the tests declare them first.
+struct TestEntry : public Core::TimerWheel::Entry {
+    int id { 0 };
+};
+
+static Vector<int> advance_and_collect(Core::TimerWheel& wheel, Ticks now)
+{
+    Vector<int> ids;
+    wheel.advance(now, [&](auto& entry) { ids.append(static_cast<TestEntry&>(entry).id); });
+    return ids;
+}
+
+TEST_CASE(expires_in_order)
+{
+    TestEntry entries[3];
+    Core::TimerWheel wheel { 1000 };
+    for (int i = 0; i < 3; ++i)
+        entries[i].id = i;
+    wheel.schedule(entries[0], 1300);
+    wheel.schedule(entries[1], 1010);
+    wheel.schedule(entries[2], 1100);
+    EXPECT_EQ(wheel.size(), 3u);
+    EXPECT_EQ(wheel.next_expiration(), 1010u);
+
+    EXPECT(advance_and_collect(wheel, 1009).is_empty());
+    EXPECT_EQ(advance_and_collect(wheel, 1010), (Vector<int> { 1 }));
+    EXPECT_EQ(wheel.next_expiration(), 1100u);
+    EXPECT_EQ(advance_and_collect(wheel, 2000), (Vector<int> { 2, 0 }));
+    EXPECT(wheel.is_empty());
+    EXPECT(!wheel.next_expiration().has_value());
+}
+
+TEST_CASE(same_tick_expires_together)
+{
+    TestEntry entries[4];
+    Core::TimerWheel wheel;
+    for (int i = 0; i < 4; ++i) {
+        entries[i].id = i;
+        wheel.schedule(entries[i], 5000);
+    }
+    EXPECT_EQ(wheel.next_expiration(), 5000u);
+    EXPECT(advance_and_collect(wheel, 4999).is_empty());
+    EXPECT_EQ(advance_and_collect(wheel, 5000), (Vector<int> { 0, 1, 2, 3 }));
+}
+
+TEST_CASE(cancel)
+{
+    TestEntry first;
+    TestEntry second;
+    Core::TimerWheel wheel;
+    first.id = 1;
+    second.id = 2;
+    wheel.schedule(first, 100);
+    wheel.schedule(second, 200'000);
+    wheel.cancel(first);
+    EXPECT_EQ(wheel.next_expiration(), 200'000u);
+    wheel.cancel(second);
+    EXPECT(wheel.is_empty());
+    EXPECT(advance_and_collect(wheel, 1'000'000).is_empty());
+}
+
+TEST_CASE(past_expiration_fires_on_next_advance)
+{
+    TestEntry entry;
+    Core::TimerWheel wheel { 500 };
+    wheel.schedule(entry, 10);
+    EXPECT_EQ(wheel.next_expiration(), 500u);
+    EXPECT_EQ(advance_and_collect(wheel, 500).size(), 1u);
+}
+
+TEST_CASE(reschedule_from_callback)
+{
+    TestEntry entry;
+    Core::TimerWheel wheel;
+    int fire_count = 0;
+    wheel.schedule(entry, 10);
+    // Rescheduling for the tick that's being handed out must not fire again in the same advance.
+    wheel.advance(10, [&](auto& expired) {
+        ++fire_count;
+        wheel.schedule(expired, 10);
+    });
+    EXPECT_EQ(fire_count, 1);
+    EXPECT_EQ(wheel.next_expiration(), 11u);
+}
+
+TEST_CASE(beyond_range)
+{
+    TestEntry entry;
+    Core::TimerWheel wheel;
+    Ticks expiration = 100'000'000'000;
+    wheel.schedule(entry, expiration);
+    EXPECT_EQ(wheel.next_expiration(), expiration);
+    EXPECT(advance_and_collect(wheel, expiration - 1).is_empty());
+    EXPECT_EQ(advance_and_collect(wheel, expiration).size(), 1u);
+}
+
+TEST_CASE(matches_sorted_order)
+{
+    static constexpr size_t entry_count = 2000;
+    Vector<TestEntry> entries;
+    entries.resize(entry_count);
+    Core::TimerWheel wheel { 12345 };
+    Vector<Ticks> expirations;
+    for (size_t i = 0; i < entry_count; ++i) {
+        entries[i].id = i;
+        // Spread the expirations over all levels of the wheel.
+        auto expiration = 12345 + (get_random<u32>() % (1u << (get_random<u8>() % 26)));
+        expirations.append(expiration);
+        wheel.schedule(entries[i], expiration);
+    }
+
+    Ticks now = 12345;
+    size_t expired_count = 0;
+    while (!wheel.is_empty()) {
+        auto next = wheel.next_expiration();
+        VERIFY(next.has_value());
+        // Nothing may expire before the announced tick, and something has to expire on it.
+        EXPECT(advance_and_collect(wheel, *next - 1).is_empty());
+        now = *next;
+        auto expired = advance_and_collect(wheel, now);
+        EXPECT(!expired.is_empty());
+        for (auto id : expired)
+            EXPECT_EQ(expirations[id], now);
+        expired_count += expired.size();
+    }
+    EXPECT_EQ(expired_count, entry_count);
+}
@@ -331,6 +331,65 @@ TEST_CASE(test_bigint_modular_power_extra_tests)
     }
 }
 
+static Crypto::UnsignedBigInteger bigint_with_words(size_t word_count, u32 seed)
+{
+    Vector<u32, Crypto::STARTING_WORD_SIZE> words;
+    for (size_t i = 0; i < word_count; ++i) {
+        seed = seed * 1664525 + 1013904223;
+        words.append(seed);
+    }
+    words.last() |= 0x80000000;
+    return Crypto::UnsignedBigInteger(move(words));
+}
+
+TEST_CASE(test_bigint_karatsuba_multiplication)
+{
+    // These are long enough for Karatsuba, and of different lengths, so the longer one is multiplied piece by piece.
+    auto a = bigint_with_words(97, 1);
+    auto b = bigint_with_words(250, 2);
+    auto c = bigint_with_words(64, 3);
+
+    auto ab = a.multiplied_by(b);
+    EXPECT_EQ(ab, b.multiplied_by(a));
+    EXPECT_EQ(ab.trimmed_length(), 97u + 250u);
+
+    // (a + c)^2 == a^2 + 2ac + c^2
+    auto sum = a.plus(c);
+    auto expected = a.multiplied_by(a).plus(a.multiplied_by(c).shift_left(1)).plus(c.multiplied_by(c));
+    EXPECT_EQ(sum.multiplied_by(sum), expected);
+
+    // All ones in every word is where carries are most likely to go wrong.
+    Vector<u32, Crypto::STARTING_WORD_SIZE> ones;
+    for (size_t i = 0; i < 80; ++i)
+        ones.append(UINT32_MAX);
+    Crypto::UnsignedBigInteger all_ones(move(ones));
+    auto square = all_ones.multiplied_by(all_ones);
+    // (2^n - 1)^2 == 2^2n - 2^(n+1) + 1
+    auto n = 80 * Crypto::UnsignedBigInteger::BITS_IN_WORD;
+    EXPECT_EQ(square, Crypto::UnsignedBigInteger(1).shift_left(2 * n).minus(Crypto::UnsignedBigInteger(1).shift_left(n + 1)).plus(1));
+}
+
+TEST_CASE(test_bigint_long_division)
+{
+    auto a = bigint_with_words(97, 4);
+    auto b = bigint_with_words(40, 5);
+    auto c = bigint_with_words(39, 6);
+
+    auto result = a.multiplied_by(b).plus(c).divided_by(b);
+    EXPECT_EQ(result.quotient, a);
+    EXPECT_EQ(result.remainder, c);
+
+    // A denominator of a single word takes a shortcut.
+    auto single_word = Crypto::UnsignedBigInteger(0xfedcba98u);
+    result = a.multiplied_by(single_word).plus(12345).divided_by(single_word);
+    EXPECT_EQ(result.quotient, a);
+    EXPECT_EQ(result.remainder, Crypto::UnsignedBigInteger(12345));
+
+    result = c.divided_by(b);
+    EXPECT_EQ(result.quotient, Crypto::UnsignedBigInteger(0));
+    EXPECT_EQ(result.remainder, c);
+}
+
 TEST_CASE(test_bigint_primality_test)
 {
     struct {
@@ -1015,6 +1074,43 @@ TEST_CASE(unsigned_bigint_double_comparisons)
 #undef EXPECT_EQUAL_TO
 }
 
+BENCHMARK_CASE(bigint_multiplication_4096_bits)
+{
+    auto a = bigint_with_words(128, 7);
+    auto b = bigint_with_words(128, 8);
+    for (size_t i = 0; i < 1000; ++i)
+        (void)a.multiplied_by(b);
+}
+
+BENCHMARK_CASE(bigint_division_4096_by_2048_bits)
+{
+    auto a = bigint_with_words(128, 9);
+    auto b = bigint_with_words(64, 10);
+    for (size_t i = 0; i < 1000; ++i)
+        (void)a.divided_by(b);
+}
+
+BENCHMARK_CASE(bigint_modular_power_2048_bits)
+{
+    // The same sizes as an RSA-2048 private key operation.
+    auto modulo = bigint_with_words(64, 11);
+    modulo.set_bit_inplace(0);
+    auto base = bigint_with_words(63, 12);
+    auto exponent = bigint_with_words(64, 13);
+    for (size_t i = 0; i < 10; ++i)
+        (void)Crypto::NumberTheory::ModularPower(base, exponent, modulo);
+}
+
+BENCHMARK_CASE(bigint_modular_power_2048_bits_public_exponent)
+{
+    // The same sizes as verifying an RSA-2048 signature.
+    auto modulo = bigint_with_words(64, 14);
+    modulo.set_bit_inplace(0);
+    auto base = bigint_with_words(63, 15);
+    for (size_t i = 0; i < 100; ++i)
+        (void)Crypto::NumberTheory::ModularPower(base, 65537, modulo);
+}
+
 namespace AK {
 
 template<>
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Checksum/CRC32.h>
 #include <LibTest/TestCase.h>
@@ -22,6 +23,16 @@ TEST_CASE(test_adler32)
     do_test(DeprecatedString("abcdefghijklmnopqrstuvwxyz").bytes(), 0x90860b20);
 }
 
+TEST_CASE(test_adler32_combine)
+{
+    auto input = DeprecatedString("abcdefghijklmnopqrstuvwxyz").bytes();
+    for (size_t split = 0; split <= input.size(); ++split) {
+        auto first = Crypto::Checksum::Adler32(input.trim(split)).digest();
+        auto second = Crypto::Checksum::Adler32(input.slice(split)).digest();
+        EXPECT_EQ(Crypto::Checksum::Adler32::combine(first, second, input.size() - split), 0x90860b20u);
+    }
+}
+
 TEST_CASE(test_crc32)
 {
     auto do_test = [](ReadonlyBytes input, u32 expected_result) {
@@ -33,3 +44,36 @@ TEST_CASE(test_crc32)
     do_test(DeprecatedString("The quick brown fox jumps over the lazy dog").bytes(), 0x414FA339);
     do_test(DeprecatedString("various CRC algorithms input data").bytes(), 0x9BD366AE);
 }
+
+TEST_CASE(test_crc32_combine)
+{
+    auto input = DeprecatedString("The quick brown fox jumps over the lazy dog").bytes();
+    for (size_t split = 0; split <= input.size(); ++split) {
+        auto first = Crypto::Checksum::CRC32(input.trim(split)).digest();
+        auto second = Crypto::Checksum::CRC32(input.slice(split)).digest();
+        EXPECT_EQ(Crypto::Checksum::CRC32::combine(first, second, input.size() - split), 0x414FA339u);
+    }
+}
+
+TEST_CASE(test_checksums_of_long_inputs)
+{
+    // Longer inputs go through the vectorized code, so make sure it agrees with feeding the same bytes one at a time.
+    Array<u8, 2000> data;
+    u32 seed = 1;
+    for (auto& byte : data) {
+        seed = seed * 1103515245 + 12345;
+        byte = static_cast<u8>(seed >> 24);
+    }
+
+    for (size_t length = 0; length <= data.size(); length += 37) {
+        auto input = ReadonlyBytes { data }.slice(data.size() - length);
+        Crypto::Checksum::Adler32 adler32;
+        Crypto::Checksum::CRC32 crc32;
+        for (size_t i = 0; i < input.size(); ++i) {
+            adler32.update(input.slice(i, 1));
+            crc32.update(input.slice(i, 1));
+        }
+        EXPECT_EQ(Crypto::Checksum::Adler32(input).digest(), adler32.digest());
+        EXPECT_EQ(Crypto::Checksum::CRC32(input).digest(), crc32.digest());
+    }
+}
@@ -224,3 +224,31 @@ TEST_CASE(test_secp256r1)
     ReadonlyBytes expected_public_key { expected_public_key_data, 65 };
     EXPECT_EQ(expected_public_key, generated_public);
 }
+
+TEST_CASE(test_fixed_base_matches_variable_base)
+{
+    // generate_public_key() uses precomputed multiples of the base point, so make sure it agrees with the generic scalar multiplication.
+    u8 x25519_base_point[32] { 9 };
+
+    // clang-format off
+    u8 secp256r1_generator[65] {
+        0x04,
+        0x6B, 0x17, 0xD1, 0xF2, 0xE1, 0x2C, 0x42, 0x47, 0xF8, 0xBC, 0xE6, 0xE5, 0x63, 0xA4, 0x40, 0xF2,
+        0x77, 0x03, 0x7D, 0x81, 0x2D, 0xEB, 0x33, 0xA0, 0xF4, 0xA1, 0x39, 0x45, 0xD8, 0x98, 0xC2, 0x96,
+        0x4F, 0xE3, 0x42, 0xE2, 0xFE, 0x1A, 0x7F, 0x9B, 0x8E, 0xE7, 0xEB, 0x4A, 0x7C, 0x0F, 0x9E, 0x16,
+        0x2B, 0xCE, 0x33, 0x57, 0x6B, 0x31, 0x5E, 0xCE, 0xCB, 0xB6, 0x40, 0x68, 0x37, 0xBF, 0x51, 0xF5,
+    };
+    // clang-format on
+
+    Crypto::Curves::X25519 x25519;
+    Crypto::Curves::SECP256r1 secp256r1;
+
+    u8 scalar[32];
+    for (u8 i = 0; i < 16; ++i) {
+        for (size_t j = 0; j < sizeof(scalar); ++j)
+            scalar[j] = static_cast<u8>((j * 0x3b + i * 0x95) ^ (i << 4));
+
+        EXPECT_EQ(MUST(x25519.generate_public_key({ scalar, 32 })), MUST(x25519.compute_coordinate({ scalar, 32 }, { x25519_base_point, 32 })));
+        EXPECT_EQ(MUST(secp256r1.generate_public_key({ scalar, 32 })), MUST(secp256r1.compute_coordinate({ scalar, 32 }, { secp256r1_generator, 65 })));
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCrypto/Hash/HKDF.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibTest/TestCase.h>
+
+// The test vectors are from RFC 5869, Appendix A.
+
+TEST_CASE(test_hkdf_sha256_basic)
+{
+    u8 input_keying_material[] {
+        0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+        0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b
+    };
+    u8 salt[] {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c
+    };
+    u8 info[] {
+        0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9
+    };
+    u8 expected_pseudorandom_key[] {
+        0x07, 0x77, 0x09, 0x36, 0x2c, 0x2e, 0x32, 0xdf, 0x0d, 0xdc, 0x3f, 0x0d, 0xc4, 0x7b, 0xba, 0x63,
+        0x90, 0xb6, 0xc7, 0x3b, 0xb5, 0x0f, 0x9c, 0x31, 0x22, 0xec, 0x84, 0x4a, 0xd7, 0xc2, 0xb3, 0xe5
+    };
+    u8 expected_output_keying_material[] {
+        0x3c, 0xb2, 0x5f, 0x25, 0xfa, 0xac, 0xd5, 0x7a, 0x90, 0x43, 0x4f, 0x64, 0xd0, 0x36, 0x2f, 0x2a,
+        0x2d, 0x2d, 0x0a, 0x90, 0xcf, 0x1a, 0x5a, 0x4c, 0x5d, 0xb0, 0x2d, 0x56, 0xec, 0xc4, 0xc5, 0xbf,
+        0x34, 0x00, 0x72, 0x08, 0xd5, 0xb8, 0x87, 0x18, 0x58, 0x65
+    };
+
+    auto pseudorandom_key = Crypto::Hash::HKDF<Crypto::Hash::SHA256>::extract({ salt, sizeof(salt) }, { input_keying_material, sizeof(input_keying_material) }).release_value();
+    EXPECT_EQ(pseudorandom_key.bytes(), ReadonlyBytes(expected_pseudorandom_key, sizeof(expected_pseudorandom_key)));
+
+    auto output_keying_material = Crypto::Hash::HKDF<Crypto::Hash::SHA256>::expand(pseudorandom_key, { info, sizeof(info) }, 42).release_value();
+    EXPECT_EQ(output_keying_material.bytes(), ReadonlyBytes(expected_output_keying_material, sizeof(expected_output_keying_material)));
+}
+
+TEST_CASE(test_hkdf_sha256_without_salt_and_info)
+{
+    u8 input_keying_material[] {
+        0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+        0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b
+    };
+    u8 expected_pseudorandom_key[] {
+        0x19, 0xef, 0x24, 0xa3, 0x2c, 0x71, 0x7b, 0x16, 0x7f, 0x33, 0xa9, 0x1d, 0x6f, 0x64, 0x8b, 0xdf,
+        0x96, 0x59, 0x67, 0x76, 0xaf, 0xdb, 0x63, 0x77, 0xac, 0x43, 0x4c, 0x1c, 0x29, 0x3c, 0xcb, 0x04
+    };
+    u8 expected_output_keying_material[] {
+        0x8d, 0xa4, 0xe7, 0x75, 0xa5, 0x63, 0xc1, 0x8f, 0x71, 0x5f, 0x80, 0x2a, 0x06, 0x3c, 0x5a, 0x31,
+        0xb8, 0xa1, 0x1f, 0x5c, 0x5e, 0xe1, 0x87, 0x9e, 0xc3, 0x45, 0x4e, 0x5f, 0x3c, 0x73, 0x8d, 0x2d,
+        0x9d, 0x20, 0x13, 0x95, 0xfa, 0xa4, 0xb6, 0x1a, 0x96, 0xc8
+    };
+
+    auto pseudorandom_key = Crypto::Hash::HKDF<Crypto::Hash::SHA256>::extract({}, { input_keying_material, sizeof(input_keying_material) }).release_value();
+    EXPECT_EQ(pseudorandom_key.bytes(), ReadonlyBytes(expected_pseudorandom_key, sizeof(expected_pseudorandom_key)));
+
+    auto output_keying_material = Crypto::Hash::HKDF<Crypto::Hash::SHA256>::expand(pseudorandom_key, {}, 42).release_value();
+    EXPECT_EQ(output_keying_material.bytes(), ReadonlyBytes(expected_output_keying_material, sizeof(expected_output_keying_material)));
+}
+
+TEST_CASE(test_hkdf_output_too_long)
+{
+    u8 pseudorandom_key[32] {};
+    EXPECT(Crypto::Hash::HKDF<Crypto::Hash::SHA256>::expand({ pseudorandom_key, sizeof(pseudorandom_key) }, {}, 255 * 32 + 1).is_error());
+}
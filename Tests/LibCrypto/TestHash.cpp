@@ -166,6 +166,49 @@ TEST_CASE(test_SHA256_hash_empty_string)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA256_hash_many)
+{
+    Vector<u8> data;
+    for (size_t i = 0; i < 4096; ++i)
+        data.append(i * 7 + (i >> 5));
+
+    // Enough inputs of different sizes that lanes get reused, and some are left over for the end.
+    Vector<ReadonlyBytes> inputs;
+    for (size_t i = 0; i < 100; ++i)
+        inputs.append(data.span().slice(i, (i * 37) % 300));
+    inputs.append(data.span());
+
+    Vector<Crypto::Hash::SHA256::DigestType> digests;
+    digests.resize(inputs.size());
+    Crypto::Hash::SHA256::hash_many(inputs, digests);
+    for (size_t i = 0; i < inputs.size(); ++i)
+        EXPECT_EQ(digests[i], Crypto::Hash::SHA256::hash(inputs[i].data(), inputs[i].size()));
+}
+
+TEST_CASE(test_SHA256_peek_keeps_state)
+{
+    // Enough data to leave a full block behind, and a partial one.
+    auto first = "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmno"sv;
+    auto second = "Well hello friends"sv;
+
+    Crypto::Hash::SHA256 sha;
+    sha.update(first);
+    auto peeked = sha.peek();
+    auto expected = Crypto::Hash::SHA256::hash(first);
+    EXPECT_EQ(peeked.bytes(), expected.bytes());
+
+    sha.update(second);
+    peeked = sha.peek();
+    auto digest = sha.digest();
+    EXPECT_EQ(peeked.bytes(), digest.bytes());
+
+    Crypto::Hash::SHA256 reference;
+    reference.update(first);
+    reference.update(second);
+    expected = reference.digest();
+    EXPECT_EQ(digest.bytes(), expected.bytes());
+}
+
 TEST_CASE(test_SHA384_name)
 {
     Crypto::Hash::SHA384 sha;
@@ -191,6 +234,17 @@ TEST_CASE(test_SHA384_hash_bug)
     EXPECT_EQ(result_bytes, digest.bytes());
 }
 
+TEST_CASE(test_SHA384_peek_keeps_state)
+{
+    Crypto::Hash::SHA384 sha;
+    sha.update("Well hello "sv);
+    (void)sha.peek();
+    sha.update("friends"sv);
+    auto digest = sha.digest();
+    auto expected = Crypto::Hash::SHA384::hash("Well hello friends"sv);
+    EXPECT_EQ(digest.bytes(), expected.bytes());
+}
+
 TEST_CASE(test_SHA512_name)
 {
     Crypto::Hash::SHA512 sha;
@@ -5,6 +5,7 @@
  */
 
 #include <LibCrypto/Hash/SHA2.h>
+#include <LibCrypto/PK/Code/EMSA_PSS.h>
 #include <LibCrypto/PK/PK.h>
 #include <LibCrypto/PK/RSA.h>
 #include <LibTest/TestCase.h>
@@ -135,3 +136,40 @@ TEST_CASE(test_RSA_EMSA_PSS_construction)
     Crypto::PK::RSA rsa;
     Crypto::PK::RSA_EMSA_PSS<Crypto::Hash::SHA256> rsa_esma_pss(rsa);
 }
+
+TEST_CASE(test_RSA_EMSA_PSS_verify)
+{
+    // A 1025-bit key, so the encoded message is a byte shorter than the modulus (RFC 8017 section 9.1.2).
+    u8 modulus[] {
+        0x01, 0x8b, 0x00, 0xa1, 0x32, 0x65, 0xe7, 0x9c, 0xa1, 0x88, 0xf6, 0xb7, 0x1e, 0xd7, 0xd8, 0xac,
+        0x73, 0x0c, 0x77, 0x79, 0x90, 0xcf, 0x87, 0xe6, 0xd0, 0xda, 0x59, 0xd1, 0x50, 0xf8, 0x37, 0x7f,
+        0x59, 0x12, 0xa2, 0x3f, 0x10, 0xb7, 0xba, 0xfc, 0xd5, 0x14, 0x28, 0x73, 0x0c, 0xc9, 0x48, 0x52,
+        0xc8, 0xf8, 0x7f, 0xa8, 0xa4, 0x33, 0x60, 0x27, 0x20, 0x39, 0x39, 0xbc, 0x36, 0x09, 0x9f, 0xc0,
+        0xcd, 0xd3, 0x76, 0x3a, 0x75, 0x97, 0x1e, 0xff, 0xf0, 0xe8, 0x09, 0x31, 0x59, 0x9f, 0x60, 0xbe,
+        0xfb, 0x78, 0xab, 0x2f, 0x02, 0x83, 0xfb, 0x8d, 0x4e, 0x5d, 0x71, 0x1e, 0x83, 0xa4, 0x88, 0xd4,
+        0x61, 0x30, 0x9f, 0xf6, 0x2c, 0x8d, 0x07, 0xb8, 0x23, 0x92, 0x94, 0x86, 0x90, 0x73, 0x5d, 0x62,
+        0x2b, 0x7a, 0xf3, 0x76, 0x4c, 0x1e, 0xc1, 0x54, 0x78, 0x66, 0x77, 0x0e, 0x58, 0x0a, 0x0b, 0x59,
+        0x79,
+    };
+    u8 signature[] {
+        0x00, 0xa6, 0xec, 0x36, 0xc5, 0x74, 0xc8, 0x0d, 0xea, 0xbe, 0xa5, 0x3a, 0xd1, 0x17, 0x59, 0x4a,
+        0x8e, 0xe9, 0x0e, 0xbf, 0x32, 0x34, 0x71, 0x33, 0x4f, 0x66, 0x07, 0xce, 0xbb, 0x23, 0xf0, 0xb3,
+        0x90, 0x0b, 0xd2, 0x5c, 0x0b, 0x73, 0xb8, 0x45, 0x30, 0xb5, 0xcb, 0x0a, 0xd5, 0x38, 0x58, 0x0e,
+        0x4d, 0x18, 0xb9, 0xf8, 0xc0, 0x7b, 0x60, 0x80, 0x22, 0xcc, 0x28, 0x19, 0x91, 0x06, 0x62, 0x52,
+        0x49, 0xc2, 0x3b, 0xbc, 0xe4, 0x73, 0x01, 0xb6, 0xd5, 0x00, 0x80, 0x15, 0x8f, 0x2f, 0x24, 0x3b,
+        0x64, 0xa2, 0x55, 0x79, 0x74, 0x36, 0x37, 0x6b, 0xbb, 0x09, 0xf9, 0xe7, 0x04, 0x1f, 0x44, 0x52,
+        0x63, 0xf7, 0xb2, 0x5d, 0x69, 0x7a, 0x7b, 0x22, 0x1c, 0x3d, 0xba, 0xc6, 0x86, 0x5d, 0x86, 0x4c,
+        0xf3, 0x3b, 0xd2, 0x92, 0xb7, 0x95, 0xea, 0xee, 0x73, 0x52, 0x9e, 0x72, 0x2e, 0x07, 0x4d, 0x4a,
+        0x53,
+    };
+    auto message = "The quick brown fox jumps over the lazy dog"sv;
+
+    Crypto::PK::RSA rsa(Crypto::UnsignedBigInteger::import_data(modulus, sizeof(modulus)), 0, 65537);
+    u8 encoded_message_buffer[sizeof(signature)];
+    auto encoded_message = Bytes { encoded_message_buffer, sizeof(encoded_message_buffer) };
+    rsa.verify({ signature, sizeof(signature) }, encoded_message);
+
+    Crypto::PK::EMSA_PSS<Crypto::Hash::SHA256, Crypto::Hash::SHA256::DigestSize> emsa_pss;
+    EXPECT_EQ(emsa_pss.verify(message.bytes(), encoded_message, 1024), Crypto::VerificationConsistency::Consistent);
+    EXPECT_EQ(emsa_pss.verify("The quick brown fox jumps over the lazy cog"sv.bytes(), encoded_message, 1024), Crypto::VerificationConsistency::Inconsistent);
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/DeprecatedString.h>
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+// How long it takes from starting to spawn an application until the loader is done and jumps to its entry point.
+// The loader reports the time it got there through the file descriptor passed in _LOADER_ENTRY_TIME_FD.
+static constexpr Array applications = {
+    "/bin/Browser"sv,
+    "/bin/Calculator"sv,
+    "/bin/FileManager"sv,
+    "/bin/HackStudio"sv,
+    "/bin/PixelPaint"sv,
+    "/bin/SystemMonitor"sv,
+    "/bin/Terminal"sv,
+    "/bin/TextEditor"sv,
+};
+
+static constexpr size_t runs_per_application = 5;
+
+static ErrorOr<u64> exec_to_main_microseconds(StringView path)
+{
+    auto pipe_fds = TRY(Core::System::pipe2(0));
+    auto entry_time_variable = DeprecatedString::formatted("_LOADER_ENTRY_TIME_FD={}", pipe_fds[1]);
+
+    DeprecatedString path_string = path;
+    char* arguments[] = { const_cast<char*>(path_string.characters()), nullptr };
+    char* environment[] = { const_cast<char*>(entry_time_variable.characters()), nullptr };
+
+    timespec start {};
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    auto pid = TRY(Core::System::posix_spawn(path, nullptr, nullptr, arguments, environment));
+    TRY(Core::System::close(pipe_fds[1]));
+
+    timespec entry {};
+    auto nread = TRY(Core::System::read(pipe_fds[0], { reinterpret_cast<u8*>(&entry), sizeof(entry) }));
+    TRY(Core::System::close(pipe_fds[0]));
+
+    // We only care about getting to main, there's no need to have the application actually show up.
+    TRY(Core::System::kill(pid, SIGKILL));
+    (void)TRY(Core::System::waitpid(pid));
+
+    if (nread != sizeof(entry))
+        return Error::from_string_literal("Loader didn't report when it reached the entry point");
+
+    auto elapsed_nanoseconds = (entry.tv_sec - start.tv_sec) * 1'000'000'000ll + (entry.tv_nsec - start.tv_nsec);
+    return static_cast<u64>(elapsed_nanoseconds / 1000);
+}
+
+BENCHMARK_CASE(exec_to_main)
+{
+    for (auto path : applications) {
+        if (access(DeprecatedString(path).characters(), X_OK) < 0)
+            continue;
+
+        u64 total_microseconds = 0;
+        u64 fastest_microseconds = NumericLimits<u64>::max();
+        for (size_t i = 0; i < runs_per_application; ++i) {
+            auto microseconds_or_error = exec_to_main_microseconds(path);
+            if (microseconds_or_error.is_error()) {
+                FAIL(DeprecatedString::formatted("{}: {}", path, microseconds_or_error.error()));
+                return;
+            }
+            total_microseconds += microseconds_or_error.value();
+            fastest_microseconds = min(fastest_microseconds, microseconds_or_error.value());
+        }
+        outln("{}: {} us average, {} us fastest", path, total_microseconds / runs_per_application, fastest_microseconds);
+    }
+}
@@ -6,8 +6,10 @@
 
 #include <LibTest/TestCase.h>
 
+#include <AK/Array.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Font/FontDatabase.h>
+#include <LibGfx/Gradients.h>
 #include <LibGfx/Painter.h>
 #include <stdio.h>
 
@@ -52,3 +54,126 @@ BENCHMARK_CASE(fill_with_gradient)
         painter.fill_rect_with_gradient(bitmap->rect(), Color::Blue, Color::Red);
     }
 }
+
+static constexpr Gfx::IntSize full_hd_size { 1920, 1080 };
+
+static Array<Gfx::ColorStop, 3> const gradient_color_stops {
+    Gfx::ColorStop { Color(255, 128, 0), 0.0f },
+    Gfx::ColorStop { Color(20, 200, 120, 200), 0.6f },
+    Gfx::ColorStop { Color(40, 0, 160), 1.0f },
+};
+
+// Every run changes the gradient a little, so that none of them are painted from the cache.
+BENCHMARK_CASE(fill_full_hd_with_linear_gradient)
+{
+    int const run_count = 20;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, full_hd_size).release_value_but_fixme_should_propagate_errors();
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.fill_rect_with_linear_gradient(bitmap->rect(), gradient_color_stops, 30.0f + run);
+    }
+}
+
+BENCHMARK_CASE(fill_full_hd_with_radial_gradient)
+{
+    int const run_count = 20;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, full_hd_size).release_value_but_fixme_should_propagate_errors();
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.fill_rect_with_radial_gradient(bitmap->rect(), gradient_color_stops, { 960 + run, 540 }, { 800, 600 });
+    }
+}
+
+BENCHMARK_CASE(fill_full_hd_with_conic_gradient)
+{
+    int const run_count = 20;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, full_hd_size).release_value_but_fixme_should_propagate_errors();
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.fill_rect_with_conic_gradient(bitmap->rect(), gradient_color_stops, { 960, 540 }, 10.0f + run);
+    }
+}
+
+BENCHMARK_CASE(repaint_full_hd_with_unchanged_linear_gradient)
+{
+    int const run_count = 100;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, full_hd_size).release_value_but_fixme_should_propagate_errors();
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.fill_rect_with_linear_gradient(bitmap->rect(), gradient_color_stops, 30.0f);
+    }
+}
+
+BENCHMARK_CASE(fill_with_alpha)
+{
+    int const run_count = 200;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    Gfx::Painter painter(bitmap);
+    painter.clear_rect(bitmap->rect(), Color::White);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.fill_rect(bitmap->rect(), Color(0, 0, 255, 100));
+    }
+}
+
+static NonnullRefPtr<Gfx::Bitmap> create_translucent_bitmap(int size)
+{
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { size, size }).release_value_but_fixme_should_propagate_errors();
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x)
+            bitmap->set_pixel(x, y, Color(x & 0xff, y & 0xff, (x + y) & 0xff, (x * y) & 0xff));
+    }
+    return bitmap;
+}
+
+BENCHMARK_CASE(blit_with_alpha)
+{
+    int const run_count = 200;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = create_translucent_bitmap(bitmap_size);
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({}, source, source->rect());
+    }
+}
+
+BENCHMARK_CASE(blit_with_opacity)
+{
+    int const run_count = 200;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({}, source, source->rect(), 0.5f);
+    }
+}
+
+BENCHMARK_CASE(draw_scaled_bitmap_with_alpha)
+{
+    int const run_count = 50;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = create_translucent_bitmap(bitmap_size / 2);
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.draw_scaled_bitmap(bitmap->rect(), source, source->rect());
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LibGfx/Bitmap.h>
+
+static constexpr Gfx::ResamplingFilter filters[] = {
+    Gfx::ResamplingFilter::Box,
+    Gfx::ResamplingFilter::Bilinear,
+    Gfx::ResamplingFilter::Bicubic,
+    Gfx::ResamplingFilter::Automatic,
+};
+
+TEST_CASE(scaling_a_single_color_keeps_that_color)
+{
+    auto color = Color(10, 200, 30, 128);
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 37, 23 }).release_value_but_fixme_should_propagate_errors();
+    bitmap->fill(color);
+
+    Gfx::IntSize const sizes[] = { { 1, 1 }, { 5, 3 }, { 100, 71 } };
+    for (auto filter : filters) {
+        for (auto size : sizes) {
+            auto scaled = bitmap->scaled_to(size, filter).release_value_but_fixme_should_propagate_errors();
+            EXPECT_EQ(scaled->size(), size);
+            EXPECT_EQ(scaled->format(), Gfx::BitmapFormat::BGRA8888);
+            for (int y = 0; y < scaled->height(); ++y) {
+                for (int x = 0; x < scaled->width(); ++x)
+                    EXPECT_EQ(scaled->get_pixel(x, y), color);
+            }
+        }
+    }
+}
+
+TEST_CASE(scaling_to_the_same_size_keeps_every_pixel)
+{
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { 64, 48 }).release_value_but_fixme_should_propagate_errors();
+    for (int y = 0; y < bitmap->height(); ++y) {
+        for (int x = 0; x < bitmap->width(); ++x)
+            bitmap->set_pixel(x, y, Color(x * 4, y * 5, (x * y) & 0xff));
+    }
+
+    for (auto filter : filters) {
+        auto scaled = bitmap->scaled_to(bitmap->size(), filter).release_value_but_fixme_should_propagate_errors();
+        EXPECT_EQ(scaled->format(), Gfx::BitmapFormat::BGRx8888);
+        for (int y = 0; y < bitmap->height(); ++y) {
+            for (int x = 0; x < bitmap->width(); ++x)
+                EXPECT_EQ(scaled->get_pixel(x, y), bitmap->get_pixel(x, y));
+        }
+    }
+}
+
+TEST_CASE(downscaling_averages_every_source_pixel)
+{
+    // A checkerboard that's scaled down to a quarter of its size should come out as an even gray, with nothing left of the pattern.
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { 64, 64 }).release_value_but_fixme_should_propagate_errors();
+    for (int y = 0; y < bitmap->height(); ++y) {
+        for (int x = 0; x < bitmap->width(); ++x)
+            bitmap->set_pixel(x, y, (x + y) % 2 ? Color::White : Color::Black);
+    }
+
+    auto scaled = bitmap->scaled_to({ 16, 16 }).release_value_but_fixme_should_propagate_errors();
+    for (int y = 0; y < scaled->height(); ++y) {
+        for (int x = 0; x < scaled->width(); ++x)
+            EXPECT_EQ(scaled->get_pixel(x, y), Color(128, 128, 128));
+    }
+}
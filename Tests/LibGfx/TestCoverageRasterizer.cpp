@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Math.h>
+#include <LibGfx/CoverageRasterizer.h>
+
+static Gfx::IntRect const bounds { 0, 0, 32, 24 };
+
+static Vector<float> rasterize(Gfx::Path const& path, Gfx::Painter::WindingRule winding_rule, Gfx::IntRect rasterizer_bounds = bounds)
+{
+    Gfx::CoverageRasterizer rasterizer { rasterizer_bounds };
+    rasterizer.add_path(path);
+
+    Vector<float> coverages;
+    coverages.resize(bounds.width() * bounds.height());
+    rasterizer.for_each_span(winding_rule, [&](Gfx::IntPoint start, int width, float coverage) {
+        EXPECT(rasterizer_bounds.contains(start));
+        EXPECT(start.x() + width <= rasterizer_bounds.x() + rasterizer_bounds.width());
+        for (int x = start.x(); x < start.x() + width; ++x) {
+            EXPECT_EQ(coverages[start.y() * bounds.width() + x], 0.0f);
+            coverages[start.y() * bounds.width() + x] = coverage;
+        }
+    });
+    return coverages;
+}
+
+static bool is_close(float coverage, float expected_coverage)
+{
+    return AK::fabs(coverage - expected_coverage) < 0.001f;
+}
+
+static float coverage_at(Vector<float> const& coverages, int x, int y)
+{
+    return coverages[y * bounds.width() + x];
+}
+
+static float total_coverage(Vector<float> const& coverages)
+{
+    float total = 0;
+    for (auto coverage : coverages)
+        total += coverage;
+    return total;
+}
+
+static Gfx::Path rectangle(Gfx::FloatRect rect)
+{
+    Gfx::Path path;
+    auto right = rect.x() + rect.width();
+    auto bottom = rect.y() + rect.height();
+    path.move_to(rect.top_left());
+    path.line_to({ right, rect.y() });
+    path.line_to({ right, bottom });
+    path.line_to({ rect.x(), bottom });
+    path.close();
+    return path;
+}
+
+TEST_CASE(coverage_is_the_area_inside_the_path)
+{
+    auto coverages = rasterize(rectangle({ 10.25f, 5.5f, 10.5f, 9.5f }), Gfx::Painter::WindingRule::Nonzero);
+    EXPECT(is_close(total_coverage(coverages), 10.5f * 9.5f));
+    EXPECT(is_close(coverage_at(coverages, 15, 10), 1.0f));
+    EXPECT(is_close(coverage_at(coverages, 10, 10), 0.75f));
+    EXPECT(is_close(coverage_at(coverages, 15, 5), 0.5f));
+    EXPECT(is_close(coverage_at(coverages, 10, 5), 0.375f));
+    EXPECT_EQ(coverage_at(coverages, 9, 10), 0.0f);
+    EXPECT_EQ(coverage_at(coverages, 21, 10), 0.0f);
+
+    Gfx::Path triangle;
+    triangle.move_to({ 2, 2 });
+    triangle.line_to({ 22, 2 });
+    triangle.line_to({ 2, 20 });
+    triangle.close();
+    EXPECT(is_close(total_coverage(rasterize(triangle, Gfx::Painter::WindingRule::Nonzero)), 20.0f * 18.0f / 2));
+}
+
+TEST_CASE(open_subpaths_are_closed)
+{
+    Gfx::Path path;
+    path.move_to({ 4, 4 });
+    path.line_to({ 12, 4 });
+    path.line_to({ 12, 8 });
+    path.line_to({ 4, 8 });
+    EXPECT(is_close(total_coverage(rasterize(path, Gfx::Painter::WindingRule::Nonzero)), 32.0f));
+}
+
+TEST_CASE(winding_rules)
+{
+    // Two overlapping squares, going around in the same direction.
+    auto path = rectangle({ 2, 2, 10, 10 });
+    path.move_to({ 6, 6 });
+    path.line_to({ 16, 6 });
+    path.line_to({ 16, 16 });
+    path.line_to({ 6, 16 });
+    path.close();
+
+    auto nonzero = rasterize(path, Gfx::Painter::WindingRule::Nonzero);
+    EXPECT(is_close(total_coverage(nonzero), 100.0f + 100.0f - 36.0f));
+    EXPECT(is_close(coverage_at(nonzero, 8, 8), 1.0f));
+
+    auto even_odd = rasterize(path, Gfx::Painter::WindingRule::EvenOdd);
+    EXPECT(is_close(total_coverage(even_odd), 100.0f + 100.0f - 2 * 36.0f));
+    EXPECT_EQ(coverage_at(even_odd, 8, 8), 0.0f);
+}
+
+TEST_CASE(edges_outside_of_the_bounds_still_count)
+{
+    auto path = rectangle({ -20, -20, 100, 30.5f });
+    auto coverages = rasterize(path, Gfx::Painter::WindingRule::Nonzero);
+    EXPECT(is_close(total_coverage(coverages), bounds.width() * 10.5f));
+
+    Gfx::IntRect smaller_bounds { 5, 3, 20, 15 };
+    coverages = rasterize(path, Gfx::Painter::WindingRule::Nonzero, smaller_bounds);
+    EXPECT(is_close(total_coverage(coverages), smaller_bounds.width() * 7.5f));
+    EXPECT(is_close(coverage_at(coverages, smaller_bounds.x(), 5), 1.0f));
+    EXPECT_EQ(coverage_at(coverages, smaller_bounds.x() - 1, 5), 0.0f);
+}
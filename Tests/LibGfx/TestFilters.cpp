@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Filters/BrightnessFilter.h>
+#include <LibGfx/Filters/ContrastFilter.h>
+#include <LibGfx/Filters/FastBoxBlurFilter.h>
+#include <LibGfx/Filters/GrayscaleFilter.h>
+#include <LibGfx/Filters/HueRotateFilter.h>
+#include <LibGfx/Filters/SaturateFilter.h>
+#include <LibGfx/Filters/SpatialGaussianBlurFilter.h>
+#include <LibGfx/Filters/StackBlurFilter.h>
+
+static NonnullRefPtr<Gfx::Bitmap> create_test_bitmap()
+{
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 67, 41 }).release_value_but_fixme_should_propagate_errors();
+    for (int y = 0; y < bitmap->height(); ++y) {
+        for (int x = 0; x < bitmap->width(); ++x)
+            bitmap->set_pixel(x, y, Color(x * 3, y * 5, (x * y) % 256, 255 - x));
+    }
+    return bitmap;
+}
+
+static NonnullRefPtr<Gfx::Bitmap> create_uniform_bitmap(Color color)
+{
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 53, 37 }).release_value_but_fixme_should_propagate_errors();
+    bitmap->fill(color);
+    return bitmap;
+}
+
+static void expect_same_pixels(Gfx::Bitmap const& a, Gfx::Bitmap const& b)
+{
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x)
+            EXPECT_EQ(a.get_pixel(x, y), b.get_pixel(x, y));
+    }
+}
+
+TEST_CASE(a_chain_of_color_filters_is_the_same_as_applying_them_one_by_one)
+{
+    auto chained = create_test_bitmap();
+    auto one_by_one = create_test_bitmap();
+
+    Gfx::SaturateFilter saturate { 1.7f };
+    Gfx::BrightnessFilter brightness { 0.8f };
+    Gfx::GrayscaleFilter grayscale { 0.3f };
+    Gfx::HueRotateFilter hue_rotate { 95.0f };
+    Gfx::ContrastFilter contrast { 1.2f };
+    Gfx::ColorFilter* filters[] = { &saturate, &brightness, &grayscale, &hue_rotate, &contrast };
+
+    Gfx::ColorFilter::apply_chain(filters, chained, chained->rect(), chained, chained->rect());
+    for (auto* filter : filters)
+        filter->apply(one_by_one, one_by_one->rect(), one_by_one, one_by_one->rect());
+
+    expect_same_pixels(chained, one_by_one);
+}
+
+TEST_CASE(blurring_a_single_color_keeps_that_color)
+{
+    auto color = Color(10, 200, 30, 255);
+
+    auto stack_blurred = create_uniform_bitmap(color);
+    Gfx::StackBlurFilter { stack_blurred }.process_rgba(12);
+    expect_same_pixels(stack_blurred, create_uniform_bitmap(color));
+
+    auto box_blurred = create_uniform_bitmap(color);
+    Gfx::FastBoxBlurFilter { box_blurred }.apply_three_passes(7);
+    expect_same_pixels(box_blurred, create_uniform_bitmap(color));
+
+    Gfx::Matrix<5, float> kernel;
+    float const weights[] = { 1, 4, 6, 4, 1 };
+    for (size_t i = 0; i < 5; ++i) {
+        for (size_t j = 0; j < 5; ++j)
+            kernel.elements()[i][j] = weights[i] * weights[j] / 256;
+    }
+    auto source = create_uniform_bitmap(color);
+    auto gaussian_blurred = create_uniform_bitmap(Color::Black);
+    Gfx::SpatialGaussianBlurFilter<5> filter;
+    filter.apply(gaussian_blurred, gaussian_blurred->rect(), source, source->rect(), Gfx::SpatialGaussianBlurFilter<5>::Parameters { kernel, true });
+    for (int y = 0; y < gaussian_blurred->height(); ++y) {
+        for (int x = 0; x < gaussian_blurred->width(); ++x) {
+            auto pixel = gaussian_blurred->get_pixel(x, y);
+            EXPECT(abs(pixel.red() - color.red()) <= 1);
+            EXPECT(abs(pixel.green() - color.green()) <= 1);
+            EXPECT(abs(pixel.blue() - color.blue()) <= 1);
+            EXPECT_EQ(pixel.alpha(), color.alpha());
+        }
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LibGfx/Font/GlyphAtlas.h>
+
+static NonnullRefPtr<Gfx::Bitmap> create_glyph_bitmap(Gfx::IntSize size, Color color)
+{
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, size).release_value_but_fixme_should_propagate_errors();
+    bitmap->fill(color);
+    return bitmap;
+}
+
+static Gfx::GlyphIndexWithSubpixelOffset glyph_index(u32 glyph_id)
+{
+    return { glyph_id, Gfx::GlyphSubpixelOffset { 0, 0 } };
+}
+
+static void expect_glyph_is(Gfx::GlyphAtlas::Glyph const& glyph, Gfx::IntSize size, Color color)
+{
+    EXPECT_EQ(glyph.rect.size(), size);
+    EXPECT(glyph.page->rect().contains(glyph.rect));
+    for (int y = glyph.rect.top(); y <= glyph.rect.bottom(); ++y) {
+        for (int x = glyph.rect.left(); x <= glyph.rect.right(); ++x)
+            EXPECT_EQ(glyph.page->get_pixel(x, y), color);
+    }
+}
+
+TEST_CASE(glyphs_share_a_page_without_overlapping)
+{
+    Gfx::GlyphAtlas atlas;
+    for (u32 i = 0; i < 100; ++i) {
+        auto color = Color(i, 255 - i, i * 2, 255);
+        auto size = Gfx::IntSize { 5 + i % 7, 8 + i % 5 };
+        auto glyph = atlas.add(glyph_index(i), create_glyph_bitmap(size, color)).release_value_but_fixme_should_propagate_errors();
+        expect_glyph_is(glyph, size, color);
+    }
+    EXPECT_EQ(atlas.page_count(), 1u);
+    EXPECT_EQ(atlas.glyph_count(), 100u);
+
+    // Every glyph must still be intact after all the others were added.
+    for (u32 i = 0; i < 100; ++i) {
+        auto glyph = atlas.find(glyph_index(i));
+        VERIFY(glyph.has_value());
+        expect_glyph_is(*glyph, { 5 + i % 7, 8 + i % 5 }, Color(i, 255 - i, i * 2, 255));
+    }
+    EXPECT(!atlas.find(glyph_index(100)).has_value());
+}
+
+TEST_CASE(glyphs_larger_than_a_page_get_their_own)
+{
+    Gfx::GlyphAtlas atlas { 32, 1 * MiB };
+    auto glyph = atlas.add(glyph_index(1), create_glyph_bitmap({ 40, 50 }, Color::Red)).release_value_but_fixme_should_propagate_errors();
+    expect_glyph_is(glyph, { 40, 50 }, Color::Red);
+    EXPECT_EQ(atlas.page_count(), 1u);
+}
+
+TEST_CASE(least_recently_used_page_is_evicted)
+{
+    // Room for two pages, which hold one 32x32 glyph each.
+    Gfx::GlyphAtlas atlas { 32, 2 * 32 * 32 * sizeof(Gfx::ARGB32) };
+    auto first = atlas.add(glyph_index(1), create_glyph_bitmap({ 32, 32 }, Color::Red)).release_value_but_fixme_should_propagate_errors();
+    (void)atlas.add(glyph_index(2), create_glyph_bitmap({ 32, 32 }, Color::Green)).release_value_but_fixme_should_propagate_errors();
+    EXPECT_EQ(atlas.page_count(), 2u);
+
+    // Using the first glyph makes the second one the least recently used.
+    EXPECT(atlas.find(glyph_index(1)).has_value());
+    (void)atlas.add(glyph_index(3), create_glyph_bitmap({ 32, 32 }, Color::Blue)).release_value_but_fixme_should_propagate_errors();
+
+    EXPECT_EQ(atlas.page_count(), 2u);
+    EXPECT(atlas.size_in_bytes() <= 2 * 32 * 32 * sizeof(Gfx::ARGB32));
+    EXPECT(atlas.find(glyph_index(1)).has_value());
+    EXPECT(!atlas.find(glyph_index(2)).has_value());
+    EXPECT(atlas.find(glyph_index(3)).has_value());
+
+    // Evicted pages aren't reused, so glyphs handed out before stay intact.
+    expect_glyph_is(first, { 32, 32 }, Color::Red);
+}
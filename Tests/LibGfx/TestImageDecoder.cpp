@@ -42,6 +42,27 @@ TEST_CASE(test_bmp)
     EXPECT(frame.duration == 0);
 }
 
+static void expect_region_matches_frame(NonnullOwnPtr<Gfx::ImageDecoderPlugin> region_decoder, NonnullOwnPtr<Gfx::ImageDecoderPlugin> frame_decoder, Gfx::IntRect region)
+{
+    EXPECT(region_decoder->initialize());
+    EXPECT(frame_decoder->initialize());
+
+    auto region_frame = MUST(region_decoder->frame_region(0, region));
+    auto frame = MUST(frame_decoder->frame(0));
+    EXPECT_EQ(region_frame.image->size(), region.size());
+
+    for (int y = 0; y < region.height(); ++y) {
+        for (int x = 0; x < region.width(); ++x)
+            EXPECT_EQ(region_frame.image->get_pixel(x, y), frame.image->get_pixel(region.x() + x, region.y() + y));
+    }
+}
+
+TEST_CASE(test_bmp_region)
+{
+    auto file = MUST(Core::MappedFile::map(TEST_INPUT("rgba32-1.bmp"sv)));
+    expect_region_matches_frame(MUST(Gfx::BMPImageDecoderPlugin::create(file->bytes())), MUST(Gfx::BMPImageDecoderPlugin::create(file->bytes())), { 10, 5, 20, 30 });
+}
+
 TEST_CASE(test_gif)
 {
     auto file = MUST(Core::MappedFile::map(TEST_INPUT("download-animation.gif"sv)));
@@ -208,6 +229,14 @@ TEST_CASE(test_targa_top_left)
     EXPECT(frame.duration == 0);
 }
 
+TEST_CASE(test_targa_region)
+{
+    for (auto path : { TEST_INPUT("buggie-bottom-left-uncompressed.tga"sv), TEST_INPUT("buggie-top-left-uncompressed.tga"sv), TEST_INPUT("buggie-top-left-compressed.tga"sv) }) {
+        auto file = MUST(Core::MappedFile::map(path));
+        expect_region_matches_frame(MUST(Gfx::TGAImageDecoderPlugin::create(file->bytes())), MUST(Gfx::TGAImageDecoderPlugin::create(file->bytes())), { 3, 7, 50, 100 });
+    }
+}
+
 TEST_CASE(test_targa_bottom_left_compressed)
 {
     auto file = MUST(Core::MappedFile::map(TEST_INPUT("buggie-bottom-left-compressed.tga"sv)));
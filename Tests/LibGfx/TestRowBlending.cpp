@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <AK/Random.h>
+#include <LibGfx/RowBlending.h>
+
+static void expect_same_as_color_blend(Gfx::RowBlendingOptions options)
+{
+    // NOTE: An odd length makes sure the pixels after the last full vector are blended too.
+    constexpr size_t pixel_count = 67;
+
+    for (size_t run = 0; run < 100; ++run) {
+        Array<Gfx::ARGB32, pixel_count> destination;
+        Array<Gfx::ARGB32, pixel_count> source;
+        Array<Gfx::ARGB32, pixel_count> expected;
+        for (size_t i = 0; i < pixel_count; ++i) {
+            destination[i] = get_random<u32>();
+            // Most pixels we paint onto are opaque, so that's what most of these are as well.
+            if (i % 4)
+                destination[i] |= 0xff000000;
+            source[i] = get_random<u32>();
+
+            u32 alpha = options.source_has_alpha ? source[i] >> 24 : 255;
+            auto source_color = Gfx::Color::from_argb((source[i] & 0x00ffffff) | (((alpha * options.opacity) >> 8) << 24));
+            auto destination_color = options.destination_has_alpha ? Gfx::Color::from_argb(destination[i]) : Gfx::Color::from_rgb(destination[i]);
+            expected[i] = destination_color.blend(source_color).value();
+        }
+
+        Gfx::blend_row(destination.data(), source.data(), pixel_count, options);
+        EXPECT_EQ(destination, expected);
+    }
+}
+
+TEST_CASE(blend_row_matches_color_blend)
+{
+    expect_same_as_color_blend({});
+    expect_same_as_color_blend({ .opacity = 100 });
+    expect_same_as_color_blend({ .source_has_alpha = false });
+    expect_same_as_color_blend({ .opacity = 200, .source_has_alpha = false, .destination_has_alpha = false });
+    expect_same_as_color_blend({ .destination_has_alpha = false });
+}
+
+TEST_CASE(blend_color_onto_row)
+{
+    Array<Gfx::ARGB32, 13> row;
+    row.fill(Gfx::Color(Gfx::Color::White).value());
+    Gfx::blend_color_onto_row(row.data(), Gfx::Color(0, 0, 255, 128), row.size());
+    for (auto pixel : row)
+        EXPECT_EQ(pixel, Gfx::Color::from_argb(Gfx::Color(Gfx::Color::White).value()).blend(Gfx::Color(0, 0, 255, 128)).value());
+}
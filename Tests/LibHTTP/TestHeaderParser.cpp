@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringBuilder.h>
+#include <LibHTTP/HeaderParser.h>
+#include <LibHTTP/HttpRequest.h>
+#include <LibTest/TestCase.h>
+
+using HTTP::HeaderParser;
+
+static constexpr auto response = "HTTP/1.1 200 OK\r\n"
+                                 "Content-Type: text/html\r\n"
+                                 "Content-Length:12\r\n"
+                                 "X-Padded: \t value with spaces \t\r\n"
+                                 "\r\n"
+                                 "Hello world!"sv;
+
+TEST_CASE(response_in_one_piece)
+{
+    HeaderParser parser { HeaderParser::Kind::Response };
+    auto consumed = parser.parse(response.bytes());
+
+    EXPECT(parser.is_done());
+    EXPECT_EQ(response.substring_view(consumed), "Hello world!"sv);
+    EXPECT_EQ(parser.status_code(), 200u);
+    EXPECT_EQ(parser.reason_phrase(), "OK"sv);
+    EXPECT_EQ(parser.major_version(), 1);
+    EXPECT_EQ(parser.minor_version(), 1);
+
+    EXPECT_EQ(parser.field_count(), 3u);
+    EXPECT_EQ(parser.field(0).name, "Content-Type"sv);
+    EXPECT_EQ(parser.field(0).value, "text/html"sv);
+    EXPECT_EQ(parser.find("content-length"sv), "12"sv);
+    EXPECT_EQ(parser.find("X-PADDED"sv), "value with spaces"sv);
+    EXPECT(!parser.find("Transfer-Encoding"sv).has_value());
+}
+
+TEST_CASE(response_byte_by_byte)
+{
+    HeaderParser parser { HeaderParser::Kind::Response };
+    size_t consumed = 0;
+    while (!parser.is_done()) {
+        EXPECT(!parser.has_failed());
+        consumed += parser.parse(response.bytes().slice(consumed, 1));
+    }
+
+    EXPECT_EQ(response.substring_view(consumed), "Hello world!"sv);
+    EXPECT_EQ(parser.field_count(), 3u);
+    EXPECT_EQ(parser.find("Content-Type"sv), "text/html"sv);
+}
+
+TEST_CASE(pipelined_requests)
+{
+    auto requests = "GET /first HTTP/1.1\r\nHost: example.com\r\n\r\n"
+                    "\r\n"
+                    "GET /second?query HTTP/1.0\nHost: example.com\n\n"sv;
+
+    HeaderParser parser { HeaderParser::Kind::Request };
+    auto consumed = parser.parse(requests.bytes());
+    EXPECT(parser.is_done());
+    EXPECT_EQ(parser.method(), "GET"sv);
+    EXPECT_EQ(parser.request_target(), "/first"sv);
+
+    parser.reset(HeaderParser::Kind::Request);
+    consumed += parser.parse(requests.bytes().slice(consumed));
+    EXPECT(parser.is_done());
+    EXPECT_EQ(consumed, requests.length());
+    EXPECT_EQ(parser.request_target(), "/second?query"sv);
+    EXPECT_EQ(parser.minor_version(), 0);
+    EXPECT_EQ(parser.find("Host"sv), "example.com"sv);
+}
+
+TEST_CASE(trailers)
+{
+    HeaderParser parser { HeaderParser::Kind::Trailers };
+    EXPECT(!parser.has_start_line());
+
+    parser.parse("Expires: never\r\n"sv.bytes());
+    EXPECT(!parser.is_done());
+    parser.parse("\r\n"sv.bytes());
+    EXPECT(parser.is_done());
+    EXPECT_EQ(parser.find("Expires"sv), "never"sv);
+}
+
+TEST_CASE(obsolete_line_folding)
+{
+    HeaderParser parser { HeaderParser::Kind::Response };
+    parser.parse("HTTP/1.0 301\r\nX-Folded: first\r\n  second \r\n\tthird\r\nX-Empty:\r\n  value\r\n\r\n"sv.bytes());
+
+    EXPECT(parser.is_done());
+    EXPECT_EQ(parser.status_code(), 301u);
+    EXPECT_EQ(parser.reason_phrase(), ""sv);
+    EXPECT_EQ(parser.find("X-Folded"sv), "first    second    third"sv);
+    EXPECT_EQ(parser.find("X-Empty"sv), "value"sv);
+}
+
+TEST_CASE(malformed_messages)
+{
+    auto fails = [](HeaderParser::Kind kind, StringView message) {
+        HeaderParser parser { kind };
+        parser.parse(message.bytes());
+        return parser.has_failed();
+    };
+
+    EXPECT(fails(HeaderParser::Kind::Response, "HTTP/1.1 20 OK\r\n"sv));
+    EXPECT(fails(HeaderParser::Kind::Response, "HTTP/11 200 OK\r\n"sv));
+    EXPECT(fails(HeaderParser::Kind::Response, "HTTP/1.1 200 OK\r\nName : value\r\n"sv));
+    EXPECT(fails(HeaderParser::Kind::Response, "HTTP/1.1 200 OK\r\n folded\r\n"sv));
+    EXPECT(fails(HeaderParser::Kind::Request, "GET  / HTTP/1.1\r\n"sv));
+    EXPECT(fails(HeaderParser::Kind::Request, "GET /\r\n"sv));
+    EXPECT(fails(HeaderParser::Kind::Request, "GET / HTTP/1.1\r\nNo colon here\r\n"sv));
+    EXPECT(fails(HeaderParser::Kind::Request, "GET / HTTP/1.1\r\nName: bare\rcarriage return\r\n"sv));
+    EXPECT(!fails(HeaderParser::Kind::Request, "GET / HTTP/1.1\r\nName: value"sv));
+
+    HeaderParser small_parser { HeaderParser::Kind::Request, 32 };
+    small_parser.parse("GET / HTTP/1.1\r\nX-Long: way too long for the limit\r\n\r\n"sv.bytes());
+    EXPECT(small_parser.has_failed());
+}
+
+TEST_CASE(http_request_from_raw_request)
+{
+    auto request = HTTP::HttpRequest::from_raw_request("POST /session?x=1 HTTP/1.1\r\nContent-Length: 2\r\n\r\n{}"sv.bytes());
+    EXPECT(request.has_value());
+    EXPECT_EQ(request->method(), HTTP::HttpRequest::Method::POST);
+    EXPECT_EQ(request->resource(), "/session"sv);
+    EXPECT_EQ(request->url().query(), "x=1"sv);
+    EXPECT_EQ(request->headers().size(), 1u);
+    EXPECT_EQ(request->headers()[0].value, "2"sv);
+    EXPECT_EQ(StringView { request->body() }, "{}"sv);
+
+    EXPECT(!HTTP::HttpRequest::from_raw_request("POST /session HTTP/1.1\r\nContent-Length: 2\r\n"sv.bytes()).has_value());
+    EXPECT(!HTTP::HttpRequest::from_raw_request("BREW /pot HTTP/1.1\r\n\r\n"sv.bytes()).has_value());
+}
+
+BENCHMARK_CASE(parse_many_responses)
+{
+    StringBuilder builder;
+    builder.append("HTTP/1.1 200 OK\r\n"sv);
+    for (size_t i = 0; i < 30; ++i)
+        builder.appendff("X-Header-{}: some reasonably long value number {}\r\n", i, i);
+    builder.append("\r\n"sv);
+    auto message = builder.to_deprecated_string();
+
+    HeaderParser parser { HeaderParser::Kind::Response };
+    for (size_t i = 0; i < 100'000; ++i) {
+        parser.reset(HeaderParser::Kind::Response);
+        // Feed it the way a socket would, in pieces that don't line up with the lines.
+        for (size_t offset = 0; offset < message.length(); offset += 100)
+            parser.parse(message.bytes().slice(offset, min<size_t>(100, message.length() - offset)));
+        VERIFY(parser.is_done());
+        VERIFY(parser.find("X-Header-29"sv).has_value());
+    }
+}
@@ -139,3 +139,80 @@ TEST_CASE(catch_exception)
                             "if (hitCatch !== true) throw new Exception('failed');\n"
                             "if (hitFinally !== true) throw new Exception('failed');");
 }
+
+TEST_CASE(constant_folding)
+{
+    EXPECT_NO_EXCEPTION_ALL("if (1 + 2 * 3 !== 7) throw new Exception('failed');\n"
+                            "if (7 % -3 !== 1 || -7 % 3 !== -1) throw new Exception('failed');\n"
+                            "if (-1 >>> 0 !== 4294967295) throw new Exception('failed');\n"
+                            "if (1 << 33 !== 2) throw new Exception('failed');\n"
+                            "if (!(1 / 0 > 1e308)) throw new Exception('failed');\n"
+                            "if (NaN === NaN) throw new Exception('failed');");
+}
+
+TEST_CASE(registers_live_across_loops)
+{
+    EXPECT_NO_EXCEPTION_ALL("var sum = 0;\n"
+                            "for (var i = 0; i < 10; ++i) {\n"
+                            "    var array = [i, i + 1, i + 2];\n"
+                            "    sum += array[0] + array[2] + { x: i }.x;\n"
+                            "}\n"
+                            "if (sum !== 155) throw new Exception('failed');");
+}
+
+TEST_CASE(arithmetic_fast_paths)
+{
+    EXPECT_NO_EXCEPTION_ALL("var max = 2147483647, min = -2147483648, zero = 0, minusFive = -5;\n"
+                            "if (max + 1 !== 2147483648 || min - 1 !== -2147483649) throw new Exception('failed');\n"
+                            "if (max * 2 !== 4294967294 || min * -1 !== 2147483648) throw new Exception('failed');\n"
+                            "if (!Object.is(zero * minusFive, -0) || !Object.is(minusFive * zero, -0)) throw new Exception('failed');\n"
+                            "if (!Object.is(zero - zero, 0) || 7 / 2 !== 3.5) throw new Exception('failed');\n"
+                            "if (!(0.5 < 1) || 1 <= NaN || NaN >= NaN || !(min < max)) throw new Exception('failed');\n"
+                            "if ((minusFive >>> 0) !== 4294967291 || (minusFive >> 1) !== -3 || (1 << -1) !== min) throw new Exception('failed');\n"
+                            "if ('1' + 2 !== '12' || '3' - 1 !== 2 || '10' < '9' !== true) throw new Exception('failed');");
+}
+
+BENCHMARK_CASE(int32_arithmetic_loop)
+{
+    EXPECT_NO_EXCEPTION_ALL("var sum = 0;\n"
+                            "for (var i = 0; i < 1000000; ++i)\n"
+                            "    sum = (sum + i * 3 - (i & 7)) | 0;");
+}
+
+BENCHMARK_CASE(double_arithmetic_loop)
+{
+    EXPECT_NO_EXCEPTION_ALL("var sum = 0.5;\n"
+                            "for (var i = 0.5; i < 1000000; i += 1)\n"
+                            "    sum = sum * 0.5 + i / 3;");
+}
+
+BENCHMARK_CASE(relational_loop)
+{
+    EXPECT_NO_EXCEPTION_ALL("var count = 0;\n"
+                            "for (var i = 0; i < 1000000; ++i) {\n"
+                            "    if (i >= 500000 && i <= 750000)\n"
+                            "        ++count;\n"
+                            "}");
+}
+
+BENCHMARK_CASE(promise_chain)
+{
+    EXPECT_NO_EXCEPTION_ALL("var promise = Promise.resolve(0);\n"
+                            "for (var i = 0; i < 100000; ++i)\n"
+                            "    promise = promise.then(value => value + 1);\n"
+                            "promise.then(value => { globalThis.result = value; });");
+    vm->run_queued_promise_jobs();
+    EXPECT_EQ(MUST(ast_interpreter->realm().global_object().get("result")).as_double(), 100000.0);
+}
+
+BENCHMARK_CASE(await_loop)
+{
+    EXPECT_NO_EXCEPTION_ALL("(async () => {\n"
+                            "    var sum = 0;\n"
+                            "    for (var i = 0; i < 100000; ++i)\n"
+                            "        sum += await i;\n"
+                            "    globalThis.result = sum;\n"
+                            "})();");
+    vm->run_queued_promise_jobs();
+    EXPECT_EQ(MUST(ast_interpreter->realm().global_object().get("result")).as_double(), 4999950000.0);
+}
@@ -951,6 +951,91 @@ TEST_CASE(theoretically_infinite_loop)
     }
 }
 
+TEST_CASE(fork_memoization)
+{
+    // Without memoizing failed forks, these take exponential time to fail.
+    Array failing_patterns {
+        "(a|aa)*c"sv,
+        "(a+a+)+b"sv,
+        "^(\\w+\\s?)*$"sv,
+    };
+    for (auto& pattern : failing_patterns) {
+        Regex<ECMA262> re(pattern);
+        auto result = re.match(DeprecatedString::formatted("{}!", DeprecatedString::repeated('a', 100)));
+        EXPECT_EQ(result.success, false);
+    }
+
+    // Memoization must not change which match and captures are found.
+    {
+        Regex<ECMA262> re("(a|ab)(c|bcd)(d*)");
+        auto result = re.match("abcd"sv);
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.matches.first().view.to_deprecated_string(), "abcd"sv);
+        EXPECT_EQ(result.capture_group_matches.first()[0].view.to_deprecated_string(), "a"sv);
+        EXPECT_EQ(result.capture_group_matches.first()[1].view.to_deprecated_string(), "bcd"sv);
+        EXPECT_EQ(result.capture_group_matches.first()[2].view.to_deprecated_string(), ""sv);
+    }
+    {
+        Regex<ECMA262> re("(\\w+\\s?)*="sv, ECMAScriptFlags::Global);
+        auto result = re.match("aa bb cc = dd ="sv);
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.matches.size(), 2u);
+        EXPECT_EQ(result.matches[0].view.to_deprecated_string(), "aa bb cc ="sv);
+        EXPECT_EQ(result.matches[1].view.to_deprecated_string(), "dd ="sv);
+    }
+}
+
+TEST_CASE(literal_prefix)
+{
+    Regex<ECMA262> re("foo(\\d)"sv, ECMAScriptFlags::Global);
+    EXPECT_EQ(re.literal_prefix, "foo"sv);
+
+    auto result = re.match("xxfoo1 fofoo2 foo"sv);
+    EXPECT_EQ(result.success, true);
+    EXPECT_EQ(result.matches.size(), 2u);
+    EXPECT_EQ(result.matches[0].view.to_deprecated_string(), "foo1"sv);
+    EXPECT_EQ(result.matches[0].column, 2u);
+    EXPECT_EQ(result.matches[1].view.to_deprecated_string(), "foo2"sv);
+    EXPECT_EQ(result.capture_group_matches[1][0].view.to_deprecated_string(), "2"sv);
+
+    auto subject = MUST(AK::utf8_to_utf16("\u00e9foo3 foo"sv));
+    result = re.match(Utf16View { subject });
+    EXPECT_EQ(result.success, true);
+    EXPECT_EQ(result.matches.size(), 1u);
+    EXPECT_EQ(result.matches[0].view.to_deprecated_string(), "foo3"sv);
+
+    Regex<ECMA262> insensitive_re("foo"sv, ECMAScriptFlags::Global | ECMAScriptFlags::Insensitive);
+    result = insensitive_re.match("xFOO"sv);
+    EXPECT_EQ(result.success, true);
+
+    // Alternatives and classes don't have a literal prefix.
+    EXPECT(Regex<ECMA262>("foo|bar"sv).literal_prefix.is_empty());
+    EXPECT_EQ(Regex<ECMA262>("ab[cd]"sv).literal_prefix, "ab"sv);
+}
+
+TEST_CASE(compiled_pattern_cache)
+{
+    auto statistics_before = Regex<ECMA262>::compiled_pattern_cache_statistics();
+
+    Regex<ECMA262> first("(c[a-z]+)e"sv, ECMAScriptFlags::Global);
+    Regex<ECMA262> second("(c[a-z]+)e"sv, ECMAScriptFlags::Global);
+    Regex<ECMA262> different_flags("(c[a-z]+)e"sv, ECMAScriptFlags::Insensitive);
+
+    auto statistics_after = Regex<ECMA262>::compiled_pattern_cache_statistics();
+    EXPECT_EQ(statistics_after.hits, statistics_before.hits + 1);
+    EXPECT_EQ(statistics_after.misses, statistics_before.misses + 2);
+
+    auto first_result = first.match("cache CODE"sv);
+    auto second_result = second.match("cache CODE"sv);
+    EXPECT_EQ(first_result.success, true);
+    EXPECT_EQ(second_result.success, true);
+    EXPECT_EQ(second_result.matches.first().view.to_deprecated_string(), "cache"sv);
+    EXPECT_EQ(second_result.capture_group_matches.first()[0].view.to_deprecated_string(), "cach"sv);
+
+    auto different_flags_result = different_flags.match("CODE"sv);
+    EXPECT_EQ(different_flags_result.success, true);
+}
+
 static auto g_lots_of_a_s = DeprecatedString::repeated('a', 10'000'000);
 
 BENCHMARK_CASE(fork_performance)
@@ -318,3 +318,53 @@ TEST_CASE(btree_scan_50_keys)
 {
     insert_into_and_scan_btree(50);
 }
+
+TEST_CASE(btree_bulk_insert)
+{
+    ScopeGuard guard([]() { unlink("/tmp/test.db"); });
+    constexpr int num_keys = 2000;
+    auto key_value = [](int ix) { return (ix * 7919) % num_keys; };
+
+    {
+        auto heap = SQL::Heap::construct("/tmp/test.db");
+        EXPECT(!heap->open().is_error());
+        SQL::Serializer serializer(heap);
+        auto btree = setup_btree(serializer);
+
+        // The first batch builds the tree, and the second one is inserted into it.
+        for (auto begin : { 0, num_keys / 2 }) {
+            Vector<SQL::Key> batch;
+            for (auto ix = begin; ix < begin + num_keys / 2; ix++) {
+                SQL::Key k(btree->descriptor());
+                k[0] = key_value(ix);
+                k.set_pointer(ix + 1);
+                batch.append(k);
+            }
+            EXPECT(btree->bulk_insert(batch));
+        }
+
+        SQL::Key duplicate(btree->descriptor());
+        duplicate[0] = key_value(0);
+        EXPECT(!btree->bulk_insert({ duplicate }));
+    }
+
+    {
+        auto heap = SQL::Heap::construct("/tmp/test.db");
+        EXPECT(!heap->open().is_error());
+        SQL::Serializer serializer(heap);
+        auto btree = setup_btree(serializer);
+
+        int count = 0;
+        for (auto iter = btree->begin(); !iter.is_end(); iter++, count++)
+            EXPECT_EQ((*iter)[0].to_int<i32>(), count);
+        EXPECT_EQ(count, num_keys);
+
+        for (auto ix = 0; ix < num_keys; ix++) {
+            SQL::Key k(btree->descriptor());
+            k[0] = key_value(ix);
+            auto pointer = btree->get(k);
+            EXPECT(pointer.has_value());
+            EXPECT_EQ(pointer.value_or(0), static_cast<u32>(ix + 1));
+        }
+    }
+}
@@ -7,6 +7,7 @@
 #include <unistd.h>
 
 #include <AK/ScopeGuard.h>
+#include <LibCore/File.h>
 #include <LibSQL/BTree.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Heap.h>
@@ -216,3 +217,41 @@ TEST_CASE(insert_100_into_table)
 {
     insert_and_verify(100);
 }
+
+TEST_CASE(recover_from_write_ahead_log)
+{
+    ScopeGuard guard([]() {
+        unlink("/tmp/test.db");
+        unlink("/tmp/test.db-wal");
+    });
+    unlink("/tmp/test.db-wal");
+
+    ByteBuffer write_ahead_log;
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        EXPECT(!db->open().is_error());
+        (void)setup_table(db);
+        insert_into_table(db, 10);
+        commit(db);
+
+        // This is what the log looks like if the process dies now, before the heap file is known to be on disk.
+        auto file = MUST(Core::File::open("/tmp/test.db-wal"sv, Core::File::OpenMode::Read));
+        write_ahead_log = MUST(file->read_until_eof());
+        EXPECT(!write_ahead_log.is_empty());
+    }
+
+    {
+        // None of the writes made it to the heap file, and the process died while writing the next flush to the log.
+        MUST(Core::File::open("/tmp/test.db"sv, Core::File::OpenMode::Write | Core::File::OpenMode::Truncate));
+
+        auto file = MUST(Core::File::open("/tmp/test.db-wal"sv, Core::File::OpenMode::Write | Core::File::OpenMode::Truncate));
+        MUST(file->write_entire_buffer(write_ahead_log));
+        MUST(file->write_entire_buffer("SBLK and then some garbage"sv.bytes()));
+    }
+
+    {
+        auto db = SQL::Database::construct("/tmp/test.db");
+        EXPECT(!db->open().is_error());
+        verify_table_contents(db, 10);
+    }
+}
@@ -282,6 +282,31 @@ TEST_CASE(binary_operator)
     }
 }
 
+TEST_CASE(binary_operator_precedence)
+{
+    auto validate = [](StringView sql, SQL::AST::BinaryOperator expected_operator, SQL::AST::BinaryOperator expected_lhs_operator, bool expect_lhs_is_binary = true) {
+        auto result = parse(sql);
+        EXPECT(!result.is_error());
+
+        auto expression = result.release_value();
+        EXPECT(is<SQL::AST::BinaryOperatorExpression>(*expression));
+
+        auto const& binary = static_cast<SQL::AST::BinaryOperatorExpression const&>(*expression);
+        EXPECT_EQ(binary.type(), expected_operator);
+        EXPECT_EQ(is<SQL::AST::BinaryOperatorExpression>(*binary.lhs()), expect_lhs_is_binary);
+        if (expect_lhs_is_binary)
+            EXPECT_EQ(static_cast<SQL::AST::BinaryOperatorExpression const&>(*binary.lhs()).type(), expected_lhs_operator);
+    };
+
+    validate("a = 1 AND b = 2"sv, SQL::AST::BinaryOperator::And, SQL::AST::BinaryOperator::Equals);
+    validate("a = 1 OR b = 2 AND c = 3"sv, SQL::AST::BinaryOperator::Or, SQL::AST::BinaryOperator::Equals);
+    validate("a < 1 = b"sv, SQL::AST::BinaryOperator::Equals, SQL::AST::BinaryOperator::LessThan);
+    validate("1 + 2 * 3"sv, SQL::AST::BinaryOperator::Plus, {}, false);
+    validate("1 * 2 + 3"sv, SQL::AST::BinaryOperator::Plus, SQL::AST::BinaryOperator::Multiplication);
+    validate("1 - 2 - 3"sv, SQL::AST::BinaryOperator::Minus, SQL::AST::BinaryOperator::Minus);
+    validate("(1 - 2) * 3"sv, SQL::AST::BinaryOperator::Multiplication, {}, false);
+}
+
 TEST_CASE(chained_expression)
 {
     EXPECT(parse("()"sv).is_error());
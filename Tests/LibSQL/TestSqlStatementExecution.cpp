@@ -10,6 +10,7 @@
 #include <AK/QuickSort.h>
 #include <AK/ScopeGuard.h>
 #include <LibSQL/AST/Parser.h>
+#include <LibSQL/AST/SelectCursor.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Result.h>
 #include <LibSQL/ResultSet.h>
@@ -1064,4 +1065,222 @@ TEST_CASE(update_all_rows)
     }
 }
 
+
+TEST_CASE(create_index)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    {
+        auto database = SQL::Database::construct(db_name);
+        EXPECT(!database->open().is_error());
+
+        create_table(database);
+        for (auto count = 0; count < 100; ++count)
+            execute(database, DeprecatedString::formatted("INSERT INTO TestSchema.TestTable VALUES ( 'T{}', {} );", count, count));
+
+        auto result = execute(database, "CREATE INDEX TestSchema.IntIndex ON TestTable ( IntColumn );");
+        EXPECT_EQ(result.command(), SQL::SQLCommand::Create);
+
+        auto index_or_error = try_execute(database, "CREATE INDEX TestSchema.IntIndex ON TestTable ( TextColumn );");
+        EXPECT(index_or_error.is_error());
+        EXPECT_EQ(index_or_error.error().error(), SQL::SQLErrorCode::IndexExists);
+        execute(database, "CREATE INDEX IF NOT EXISTS TestSchema.IntIndex ON TestTable ( TextColumn );");
+
+        index_or_error = try_execute(database, "CREATE INDEX TestSchema.TextIndex ON TestTable ( DoesNotExist );");
+        EXPECT(index_or_error.is_error());
+        EXPECT_EQ(index_or_error.error().error(), SQL::SQLErrorCode::ColumnDoesNotExist);
+
+        execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 'T100', 100 );");
+    }
+    {
+        auto database = SQL::Database::construct(db_name);
+        EXPECT(!database->open().is_error());
+
+        auto result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 42;");
+        EXPECT_EQ(result.size(), 1u);
+        EXPECT_EQ(result[0].row[0], "T42"sv);
+
+        result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 100;");
+        EXPECT_EQ(result.size(), 1u);
+        EXPECT_EQ(result[0].row[0], "T100"sv);
+
+        result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = ?;", placeholders(42));
+        EXPECT_EQ(result.size(), 1u);
+        EXPECT_EQ(result[0].row[0], "T42"sv);
+
+        result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn > 90;");
+        EXPECT_EQ(result.size(), 10u);
+
+        result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn >= 10 AND IntColumn < 20 ORDER BY IntColumn;");
+        EXPECT_EQ(result.size(), 10u);
+        for (auto i = 0u; i < result.size(); ++i)
+            EXPECT_EQ(result[i].row[0], static_cast<int>(i + 10));
+
+        result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE 20 < IntColumn AND IntColumn <= 22;");
+        EXPECT_EQ(result.size(), 2u);
+
+        result = execute(database, "SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn = 'T42';");
+        EXPECT(result.is_empty());
+    }
+}
+
+TEST_CASE(index_is_updated_with_table)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+
+    create_table(database);
+    execute(database, "CREATE INDEX TestSchema.IntIndex ON TestTable ( IntColumn );");
+    for (auto count = 0; count < 10; ++count)
+        execute(database, DeprecatedString::formatted("INSERT INTO TestSchema.TestTable VALUES ( 'T{}', {} );", count, count));
+
+    execute(database, "UPDATE TestSchema.TestTable SET IntColumn = 42 WHERE TextColumn = 'T3';");
+    auto result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 3;");
+    EXPECT(result.is_empty());
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 42;");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0], "T3"sv);
+
+    execute(database, "UPDATE TestSchema.TestTable SET IntColumn = 3 WHERE TextColumn = 'T3';");
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 3;");
+    EXPECT_EQ(result.size(), 1u);
+
+    execute(database, "DELETE FROM TestSchema.TestTable WHERE IntColumn = 3;");
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 3;");
+    EXPECT(result.is_empty());
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn < 5;");
+    EXPECT_EQ(result.size(), 4u);
+}
+
+TEST_CASE(unique_index)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+
+    create_table(database);
+    execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 'T0', 0 ), ( 'T1', 1 ), ( 'T1', 2 );");
+
+    auto result = try_execute(database, "CREATE UNIQUE INDEX TestSchema.TextIndex ON TestTable ( TextColumn );");
+    EXPECT(result.is_error());
+    EXPECT_EQ(result.error().error(), SQL::SQLErrorCode::UniqueConstraintViolated);
+
+    execute(database, "CREATE UNIQUE INDEX TestSchema.IntIndex ON TestTable ( IntColumn );");
+    result = try_execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 'T3', 1 );");
+    EXPECT(result.is_error());
+    EXPECT_EQ(result.error().error(), SQL::SQLErrorCode::UniqueConstraintViolated);
+
+    // The rows of one INSERT can't violate the constraint with each other either, and none of them are inserted then.
+    result = try_execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 'T4', 4 ), ( 'T5', 4 );");
+    EXPECT(result.is_error());
+    EXPECT_EQ(result.error().error(), SQL::SQLErrorCode::UniqueConstraintViolated);
+    EXPECT(execute(database, "SELECT * FROM TestSchema.TestTable WHERE IntColumn = 4;").is_empty());
+
+    result = try_execute(database, "UPDATE TestSchema.TestTable SET IntColumn = 1 WHERE TextColumn = 'T0';");
+    EXPECT(result.is_error());
+    EXPECT_EQ(result.error().error(), SQL::SQLErrorCode::UniqueConstraintViolated);
+
+    execute(database, "DELETE FROM TestSchema.TestTable WHERE IntColumn = 1;");
+    execute(database, "INSERT INTO TestSchema.TestTable VALUES ( 'T3', 1 );");
+
+    auto rows = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 1;");
+    EXPECT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0].row[0], "T3"sv);
+}
+
+TEST_CASE(select_inner_join_using_index)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+    create_two_tables(database);
+
+    for (auto count = 0; count < 20; ++count) {
+        execute(database, DeprecatedString::formatted("INSERT INTO TestSchema.TestTable1 VALUES ( 'A{}', {} );", count, count));
+        execute(database, DeprecatedString::formatted("INSERT INTO TestSchema.TestTable2 VALUES ( 'B{}', {} );", count, count * 2));
+    }
+
+    auto query = "SELECT TextColumn1, TextColumn2 FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+                 "WHERE TestTable1.IntColumn = TestTable2.IntColumn AND TestTable1.IntColumn < 10 ORDER BY TextColumn1;"sv;
+    auto expect_join_result = [&]() {
+        auto result = execute(database, query);
+        EXPECT_EQ(result.size(), 5u);
+        for (auto i = 0u; i < result.size(); ++i) {
+            EXPECT_EQ(result[i].row[0], DeprecatedString::formatted("A{}", i * 2));
+            EXPECT_EQ(result[i].row[1], DeprecatedString::formatted("B{}", i));
+        }
+    };
+
+    expect_join_result();
+    auto plan = execute(database, DeprecatedString::formatted("EXPLAIN {}", query));
+    EXPECT_EQ(plan.size(), 3u);
+    EXPECT_EQ(plan[0].row[0], "SCAN TESTSCHEMA.TESTTABLE1"sv);
+    EXPECT_EQ(plan[1].row[0], "HASH JOIN TESTSCHEMA.TESTTABLE2 (INTCOLUMN=?)"sv);
+    EXPECT_EQ(plan[2].row[0], "SORT RESULTS FOR ORDER BY"sv);
+
+    execute(database, "CREATE INDEX TestSchema.IntIndex1 ON TestTable1 ( IntColumn );");
+    execute(database, "CREATE INDEX TestSchema.IntIndex2 ON TestTable2 ( IntColumn );");
+
+    expect_join_result();
+    plan = execute(database, DeprecatedString::formatted("EXPLAIN {}", query));
+    EXPECT_EQ(plan.size(), 3u);
+    EXPECT_EQ(plan[0].row[0], "SEARCH TESTSCHEMA.TESTTABLE1 USING INDEX INTINDEX1 (INTCOLUMN<?)"sv);
+    EXPECT_EQ(plan[1].row[0], "SEARCH TESTSCHEMA.TESTTABLE2 USING INDEX INTINDEX2 (INTCOLUMN=?)"sv);
+}
+
+
+TEST_CASE(select_cursor)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+    create_table(database);
+    for (auto count = 0; count < 100; count++) {
+        auto result = execute(database,
+            DeprecatedString::formatted("INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( 'Test_{}', {} );", count, count));
+        EXPECT(result.size() == 1);
+    }
+
+    auto open_cursor = [&](StringView sql, Vector<SQL::Value> placeholder_values = {}) {
+        auto parser = SQL::AST::Parser(SQL::AST::Lexer(sql));
+        auto statement = parser.next_statement();
+        EXPECT(!parser.has_errors());
+        EXPECT(is<SQL::AST::Select>(*statement));
+
+        auto cursor = SQL::AST::SelectCursor::create(database, static_cast<SQL::AST::Select const&>(*statement), placeholder_values);
+        EXPECT(!cursor.is_error());
+        return cursor.release_value();
+    };
+
+    auto cursor = open_cursor("SELECT TextColumn, IntColumn FROM TestSchema.TestTable WHERE IntColumn >= ? LIMIT 5;"sv, placeholders(90));
+    EXPECT_EQ(cursor->column_names().size(), 2u);
+    EXPECT_EQ(cursor->column_names()[0], "TEXTCOLUMN"sv);
+
+    Vector<int> values;
+    while (true) {
+        auto row = cursor->next();
+        EXPECT(!row.is_error());
+        if (!row.value().has_value())
+            break;
+        EXPECT((*row.value())[1].to_int<int>().value() >= 90);
+        values.append((*row.value())[1].to_int<int>().value());
+    }
+    EXPECT_EQ(values.size(), 5u);
+
+    auto next = cursor->next();
+    EXPECT(!next.is_error());
+    EXPECT(!next.value().has_value());
+
+    cursor = open_cursor("SELECT IntColumn FROM TestSchema.TestTable ORDER BY IntColumn DESC LIMIT 3 OFFSET 1;"sv);
+    for (auto expected : { 98, 97, 96 }) {
+        auto row = cursor->next();
+        EXPECT(!row.is_error());
+        EXPECT(row.value().has_value());
+        EXPECT_EQ((*row.value())[0].to_int<int>(), expected);
+    }
+    next = cursor->next();
+    EXPECT(!next.is_error());
+    EXPECT(!next.value().has_value());
+}
+
 }
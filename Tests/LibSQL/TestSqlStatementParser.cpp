@@ -783,3 +783,74 @@ TEST_CASE(describe_table)
     validate("DESCRIBE TABLE TableName;"sv, {}, "TABLENAME"sv);
     validate("DESCRIBE TABLE SchemaName.TableName;"sv, "SCHEMANAME"sv, "TABLENAME"sv);
 }
+
+TEST_CASE(create_index)
+{
+    EXPECT(parse("CREATE INDEX"sv).is_error());
+    EXPECT(parse("CREATE INDEX index_name;"sv).is_error());
+    EXPECT(parse("CREATE INDEX index_name ON;"sv).is_error());
+    EXPECT(parse("CREATE INDEX index_name ON table_name;"sv).is_error());
+    EXPECT(parse("CREATE INDEX index_name ON table_name ();"sv).is_error());
+    EXPECT(parse("CREATE INDEX index_name ON table_name ( column1, );"sv).is_error());
+    EXPECT(parse("CREATE UNIQUE index_name ON table_name ( column1 );"sv).is_error());
+    EXPECT(parse("CREATE INDEX IF index_name ON table_name ( column1 );"sv).is_error());
+
+    struct IndexedColumn {
+        StringView name;
+        SQL::Order order { SQL::Order::Ascending };
+    };
+
+    auto validate = [](StringView sql, StringView expected_schema, StringView expected_index, StringView expected_table, Vector<IndexedColumn> expected_columns, bool expected_is_unique = false, bool expected_is_error_if_index_exists = true) {
+        auto result = parse(sql);
+        if (result.is_error())
+            outln("{}: {}", sql, result.error());
+        EXPECT(!result.is_error());
+
+        auto statement = result.release_value();
+        EXPECT(is<SQL::AST::CreateIndex>(*statement));
+
+        auto const& create_index = static_cast<SQL::AST::CreateIndex const&>(*statement);
+        EXPECT_EQ(create_index.schema_name(), expected_schema);
+        EXPECT_EQ(create_index.index_name(), expected_index);
+        EXPECT_EQ(create_index.table_name(), expected_table);
+        EXPECT_EQ(create_index.is_unique(), expected_is_unique);
+        EXPECT_EQ(create_index.is_error_if_index_exists(), expected_is_error_if_index_exists);
+
+        auto const& columns = create_index.indexed_columns();
+        EXPECT_EQ(columns.size(), expected_columns.size());
+        for (size_t i = 0; i < columns.size(); ++i) {
+            EXPECT_EQ(columns[i].column_name(), expected_columns[i].name);
+            EXPECT_EQ(columns[i].order(), expected_columns[i].order);
+        }
+    };
+
+    validate("CREATE INDEX index_name ON table_name ( column1 );"sv, {}, "INDEX_NAME"sv, "TABLE_NAME"sv, { { "COLUMN1"sv } });
+    validate("CREATE INDEX schema_name.index_name ON table_name ( column1 );"sv, "SCHEMA_NAME"sv, "INDEX_NAME"sv, "TABLE_NAME"sv, { { "COLUMN1"sv } });
+    validate("CREATE UNIQUE INDEX index_name ON table_name ( column1 );"sv, {}, "INDEX_NAME"sv, "TABLE_NAME"sv, { { "COLUMN1"sv } }, true);
+    validate("CREATE INDEX IF NOT EXISTS index_name ON table_name ( column1 );"sv, {}, "INDEX_NAME"sv, "TABLE_NAME"sv, { { "COLUMN1"sv } }, false, false);
+    validate("CREATE INDEX index_name ON table_name ( column1 ASC, column2 DESC );"sv, {}, "INDEX_NAME"sv, "TABLE_NAME"sv, { { "COLUMN1"sv }, { "COLUMN2"sv, SQL::Order::Descending } });
+}
+
+TEST_CASE(explain)
+{
+    EXPECT(parse("EXPLAIN"sv).is_error());
+    EXPECT(parse("EXPLAIN;"sv).is_error());
+    EXPECT(parse("EXPLAIN QUERY;"sv).is_error());
+    EXPECT(parse("EXPLAIN QUERY PLAN;"sv).is_error());
+
+    auto validate = [](StringView sql) {
+        auto result = parse(sql);
+        if (result.is_error())
+            outln("{}: {}", sql, result.error());
+        EXPECT(!result.is_error());
+
+        auto statement = result.release_value();
+        EXPECT(is<SQL::AST::Explain>(*statement));
+
+        auto const& explain = static_cast<SQL::AST::Explain const&>(*statement);
+        EXPECT(is<SQL::AST::Select>(*explain.statement()));
+    };
+
+    validate("EXPLAIN SELECT * FROM table_name;"sv);
+    validate("EXPLAIN QUERY PLAN SELECT * FROM table_name WHERE column1 = 1;"sv);
+}
@@ -7,6 +7,7 @@
 
 #include <unistd.h>
 
+#include <LibSQL/Key.h>
 #include <LibSQL/Meta.h>
 #include <LibSQL/Row.h>
 #include <LibSQL/Tuple.h>
@@ -681,6 +682,58 @@ TEST_CASE(compare_tuples)
     EXPECT(tuple3 > tuple1);
 }
 
+TEST_CASE(compare_keys_by_sort_key)
+{
+    NonnullRefPtr<SQL::TupleDescriptor> descriptor = adopt_ref(*new SQL::TupleDescriptor);
+    descriptor->append({ "schema", "table", "col1", SQL::SQLType::Text, SQL::Order::Ascending });
+    descriptor->append({ "schema", "table", "col2", SQL::SQLType::Integer, SQL::Order::Descending });
+    descriptor->append({ "schema", "table", "col3", SQL::SQLType::Float, SQL::Order::Ascending });
+
+    auto make_key = [&](SQL::Value text, SQL::Value integer, SQL::Value number) {
+        SQL::Key key(descriptor);
+        key["col1"] = move(text);
+        key["col2"] = move(integer);
+        key["col3"] = move(number);
+        return key;
+    };
+
+    Vector<SQL::Key> keys;
+    keys.append(make_key(SQL::Value { SQL::SQLType::Text }, SQL::Value { 1 }, SQL::Value { 1.5 }));
+    keys.append(make_key(SQL::Value { ""sv }, SQL::Value { -3 }, SQL::Value { -0.0 }));
+    keys.append(make_key(SQL::Value { "Test"sv }, SQL::Value { 42 }, SQL::Value { -2.5 }));
+    keys.append(make_key(SQL::Value { "Test"sv }, SQL::Value { 42 }, SQL::Value { 0.0 }));
+    keys.append(make_key(SQL::Value { "Test"sv }, SQL::Value { -42 }, SQL::Value { SQL::SQLType::Float }));
+    keys.append(make_key(SQL::Value { "Test"sv }, SQL::Value { SQL::SQLType::Integer }, SQL::Value { 1e100 }));
+    keys.append(make_key(SQL::Value { "Test\0"sv }, SQL::Value { 0 }, SQL::Value { 1.0 }));
+    keys.append(make_key(SQL::Value { "Tests"sv }, SQL::Value { NumericLimits<i64>::min() }, SQL::Value { -1e100 }));
+    keys.append(make_key(SQL::Value { "\xff"sv }, SQL::Value { NumericLimits<i64>::max() }, SQL::Value { 2.0 }));
+
+    for (auto& key : keys) {
+        key.cache_sort_key();
+        EXPECT(key.has_sort_key());
+    }
+
+    auto sign = [](int result) { return (result > 0) - (result < 0); };
+    for (auto const& key1 : keys) {
+        for (auto const& key2 : keys)
+            EXPECT_EQ(sign(key1.compare(key2)), sign(key1.SQL::Tuple::compare(key2)));
+    }
+
+    // A key that's a prefix of another one compares as equal to it.
+    SQL::Key prefix(descriptor);
+    prefix.clear();
+    prefix.append(SQL::Value { "Test"sv });
+    prefix.cache_sort_key();
+    EXPECT_EQ(prefix.compare(keys[2]), 0);
+    EXPECT(prefix.compare(keys[1]) > 0);
+    EXPECT(prefix.compare(keys[7]) < 0);
+
+    // Values that don't have the type of their column can't be encoded.
+    auto mismatched = make_key(SQL::Value { "Test"sv }, SQL::Value { 1.5 }, SQL::Value { 1.25 });
+    mismatched.cache_sort_key();
+    EXPECT(!mismatched.has_sort_key());
+}
+
 TEST_CASE(add)
 {
     {
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/DeprecatedFlyString.h>
+#include <AK/FlyString.h>
+#include <AK/Vector.h>
+#include <LibTest/TestCase.h>
+#include <LibThreading/Thread.h>
+
+static constexpr size_t thread_count = 8;
+static constexpr size_t string_count = 64;
+static constexpr size_t iteration_count = 200;
+
+static String string_for_index(size_t index)
+{
+    return MUST(String::formatted("interned-string-that-is-not-short-{}", index));
+}
+
+TEST_CASE(fly_strings_can_be_interned_from_many_threads)
+{
+    Vector<Vector<FlyString>> results;
+    results.resize(thread_count);
+
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads.append(Threading::Thread::construct([&results, i]() {
+            for (size_t iteration = 0; iteration < iteration_count; ++iteration) {
+                // Dropping each batch keeps strings dying and being re-interned by other threads.
+                Vector<FlyString> strings;
+                for (size_t j = 0; j < string_count; ++j)
+                    strings.append(FlyString { string_for_index(j) });
+                if (iteration == iteration_count - 1)
+                    results[i] = move(strings);
+            }
+            return 0;
+        }));
+    }
+    for (auto& thread : threads)
+        thread->start();
+    for (auto& thread : threads)
+        (void)thread->join();
+
+    for (size_t i = 1; i < thread_count; ++i) {
+        for (size_t j = 0; j < string_count; ++j)
+            EXPECT_EQ(results[i][j], results[0][j]);
+    }
+    EXPECT_EQ(FlyString::number_of_fly_strings(), string_count);
+
+    results.clear();
+    EXPECT_EQ(FlyString::number_of_fly_strings(), 0u);
+}
+
+TEST_CASE(deprecated_fly_strings_can_be_interned_from_many_threads)
+{
+    Vector<Vector<DeprecatedFlyString>> results;
+    results.resize(thread_count);
+
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads.append(Threading::Thread::construct([&results, i]() {
+            for (size_t iteration = 0; iteration < iteration_count; ++iteration) {
+                Vector<DeprecatedFlyString> strings;
+                for (size_t j = 0; j < string_count; ++j)
+                    strings.append(DeprecatedFlyString { string_for_index(j).bytes_as_string_view() });
+                if (iteration == iteration_count - 1)
+                    results[i] = move(strings);
+            }
+            return 0;
+        }));
+    }
+    for (auto& thread : threads)
+        thread->start();
+    for (auto& thread : threads)
+        (void)thread->join();
+
+    for (size_t i = 1; i < thread_count; ++i) {
+        for (size_t j = 0; j < string_count; ++j)
+            EXPECT_EQ(results[i][j].impl(), results[0][j].impl());
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Random.h>
+#include <LibTest/TestCase.h>
+#include <LibThreading/ThreadPool.h>
+
+TEST_CASE(runs_all_submitted_jobs)
+{
+    Atomic<size_t> jobs_run { 0 };
+    {
+        Threading::ThreadPool pool { 4 };
+        for (size_t i = 0; i < 1000; ++i)
+            pool.submit([&] { jobs_run.fetch_add(1); });
+    }
+    EXPECT_EQ(jobs_run.load(), 1000u);
+}
+
+TEST_CASE(jobs_can_submit_jobs)
+{
+    Atomic<size_t> jobs_run { 0 };
+    {
+        Threading::ThreadPool pool { 4 };
+        for (size_t i = 0; i < 10; ++i) {
+            pool.submit([&] {
+                for (size_t j = 0; j < 100; ++j)
+                    pool.submit([&] { jobs_run.fetch_add(1); });
+            });
+        }
+    }
+    EXPECT_EQ(jobs_run.load(), 1000u);
+}
+
+TEST_CASE(parallel_for_visits_every_index_once)
+{
+    Threading::ThreadPool pool { 4 };
+    Vector<u32> visits;
+    visits.resize(10000);
+    Threading::parallel_for(
+        visits.size(), [&](size_t i) { AK::atomic_fetch_add(&visits[i], 1u); }, 1, pool);
+    for (auto count : visits)
+        EXPECT_EQ(count, 1u);
+}
+
+TEST_CASE(nested_parallel_for)
+{
+    Threading::ThreadPool pool { 2 };
+    Atomic<size_t> sum { 0 };
+    Threading::parallel_for(
+        100, [&](size_t i) {
+            Threading::parallel_for(
+                100, [&](size_t j) { sum.fetch_add(i * j); }, 1, pool);
+        },
+        1, pool);
+    EXPECT_EQ(sum.load(), 4950u * 4950u);
+}
+
+TEST_CASE(parallel_sort)
+{
+    Threading::ThreadPool pool { 4 };
+    for (size_t size : { 0, 1, 100, 50000, 100003 }) {
+        Vector<u32> values;
+        for (size_t i = 0; i < size; ++i)
+            values.append(get_random_uniform(1000));
+        MUST(Threading::parallel_sort(values.span(), pool));
+        for (size_t i = 1; i < values.size(); ++i)
+            EXPECT(values[i - 1] <= values[i]);
+    }
+}
+
+TEST_CASE(parallel_sort_with_comparator)
+{
+    Threading::ThreadPool pool { 3 };
+    Vector<int> values;
+    for (int i = 0; i < 30000; ++i)
+        values.append(i);
+    MUST(Threading::parallel_sort(values.span(), [](int a, int b) { return a > b; }, pool));
+    for (int i = 0; i < 30000; ++i)
+        EXPECT_EQ(values[i], 29999 - i);
+}
@@ -64,6 +64,19 @@ TEST_CASE(normalize_nfc)
     EXPECT_EQ(MUST(normalize("\u1103\u1161\u11B0"sv, NormalizationForm::NFC)), "닭"sv);
     EXPECT_EQ(MUST(normalize("\u1100\uAC00\u11A8"sv, NormalizationForm::NFC)), "\u1100\uAC01"sv);
     EXPECT_EQ(MUST(normalize("\u1103\u1161\u11B0\u11B0"sv, NormalizationForm::NFC)), "닭\u11B0");
+
+    // Only the last starter may be composed with a following character.
+    EXPECT_EQ(MUST(normalize("\u0049\U0001D158\U0001D165\u0300"sv, NormalizationForm::NFC)), "\u0049\U0001D158\U0001D165\u0300"sv);
+}
+
+TEST_CASE(normalize_partially_normalized_text)
+{
+    EXPECT_EQ(MUST(normalize("Amélie, Ame\u0301lie and \u1103\u1161\u11B0 닭"sv, NormalizationForm::NFC)), "Amélie, Amélie and 닭 닭"sv);
+    EXPECT_EQ(MUST(normalize("Amélie, Ame\u0301lie and \u1103\u1161\u11B0 닭"sv, NormalizationForm::NFD)), "Ame\u0301lie, Ame\u0301lie and \u1103\u1161\u11B0 \u1103\u1161\u11B0"sv);
+
+    // Canonical ordering has to be checked for, even if every code point is allowed on its own.
+    EXPECT_EQ(MUST(normalize("a\u0301\u0323b"sv, NormalizationForm::NFD)), "a\u0323\u0301b"sv);
+    EXPECT_EQ(MUST(normalize("\u1E0B\u0323"sv, NormalizationForm::NFC)), "\u1E0D\u0307"sv);
 }
 
 TEST_CASE(normalize_nfkd)
@@ -0,0 +1,28 @@
+#!/usr/bin/env bash
+
+set -eo pipefail
+
+SCRIPT_DIR="$(cd -P -- "$(dirname -- "${0}")" && pwd -P)"
+HEADLESS_BROWSER_BINARY="${1}"
+
+if [[ -z "${HEADLESS_BROWSER_BINARY}" ]] ; then
+    echo "Provide path to the headless-browser binary, followed by any extra arguments for it (like --resources)"
+    exit 1
+fi
+shift
+
+# Each page gets a process of its own, so the peak memory usage we report is that page's alone.
+echo "["
+first=1
+for page_path in "${SCRIPT_DIR}"/pages/*.html; do
+    if ! result=$("${HEADLESS_BROWSER_BINARY}" "$@" --benchmark "file://${page_path}" 2>/dev/null) ; then
+        result="{\"url\":\"file://${page_path}\",\"failed\":true}"
+    fi
+    if [[ "${first}" -eq 0 ]] ; then
+        echo ","
+    fi
+    first=0
+    echo -n "    ${result}"
+done
+echo
+echo "]"
@@ -76,6 +76,30 @@ static Vector<Token> run_tokenizer(StringView input)
     return tokens;
 }
 
+static Vector<Token> run_tokenizer_incrementally(StringView input, size_t chunk_size)
+{
+    Vector<Token> tokens;
+    Tokenizer tokenizer { ""sv, "UTF-8"sv };
+    tokenizer.expect_more_input();
+    while (true) {
+        auto maybe_token = tokenizer.next_token();
+        if (!maybe_token.has_value()) {
+            if (tokenizer.is_input_complete())
+                break;
+            if (input.is_empty()) {
+                tokenizer.finish_input();
+                continue;
+            }
+            auto chunk_length = min(chunk_size, input.length());
+            tokenizer.append_input(input.substring_view(0, chunk_length));
+            input = input.substring_view(chunk_length);
+            continue;
+        }
+        tokens.append(maybe_token.release_value());
+    }
+    return tokens;
+}
+
 // FIXME: It's not very nice to rely on the format of HTMLToken::to_string() to stay the same.
 static u32 hash_tokens(Vector<Token> const& tokens)
 {
@@ -197,6 +221,14 @@ TEST_CASE(doctype)
     EXPECT_END_TAG_TOKEN(html);
 }
 
+TEST_CASE(incremental_input)
+{
+    auto input = "<!DOCTYPE html>\r\n<p class=\"a&amp;b\" id=x>caf\xc3\xa9 &notin; &noti \xf0\x9f\x98\x80</p><!-- comment -->"sv;
+    auto expected_hash = hash_tokens(run_tokenizer(input));
+    for (size_t chunk_size : { 1, 2, 3, 7, 64 })
+        EXPECT_EQ(hash_tokens(run_tokenizer_incrementally(input, chunk_size)), expected_hash);
+}
+
 // NOTE: This relies on the format of HTMLToken::to_string() staying the same.
 //       If that changes, or something is added to the test HTML, the hash needs to be adjusted.
 TEST_CASE(regression)
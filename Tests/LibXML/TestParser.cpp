@@ -29,3 +29,37 @@ TEST_CASE(character_reference_integer_overflow)
         return Test::Crash::Failure::DidNotCrash;
     });
 }
+
+TEST_CASE(listener_sees_every_element)
+{
+    struct RecordingListener final : public XML::Listener {
+        virtual void element_start(XML::Name const& name, HashMap<XML::Name, DeprecatedString> const& attributes) override
+        {
+            events.append(DeprecatedString::formatted("<{} {}>", name, attributes.get("id"sv).value_or("-")));
+        }
+        virtual void element_end(XML::Name const& name) override { events.append(DeprecatedString::formatted("</{}>", name)); }
+        virtual void text(StringView text) override { events.append(text); }
+
+        Vector<DeprecatedString> events;
+    };
+
+    XML::Parser parser("<svg id='a'><g><path id='b'/>text<path/></g></svg>"sv);
+    RecordingListener listener;
+    EXPECT(!parser.parse_with_listener(listener).is_error());
+
+    Vector<DeprecatedString> expected_events { "<svg a>", "<g ->", "<path b>", "</path>", "text", "<path ->", "</path>", "</g>", "</svg>" };
+    EXPECT_EQ(listener.events, expected_events);
+}
+
+TEST_CASE(empty_elements_are_part_of_the_tree)
+{
+    XML::Parser parser("<a><b/><c/></a>"sv);
+    auto document = MUST(parser.parse());
+
+    auto& root = document.root().content.get<XML::Node::Element>();
+    EXPECT_EQ(root.name, "a"sv);
+    EXPECT_EQ(root.children.size(), 2u);
+    EXPECT_EQ(root.children[0].content.get<XML::Node::Element>().name, "b"sv);
+    EXPECT_EQ(root.children[0].parent, &document.root());
+    EXPECT_EQ(root.children[1].content.get<XML::Node::Element>().name, "c"sv);
+}
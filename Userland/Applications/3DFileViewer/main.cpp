@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibCore/ArgsParser.h>
 #include <LibCore/ElapsedTimer.h>
 #include <LibCore/System.h>
 #include <LibFileSystemAccessClient/Client.h>
@@ -45,6 +46,16 @@ public:
     void set_texture_enabled(bool texture_enabled) { m_texture_enabled = texture_enabled; }
     void set_mag_filter(GLint filter) { m_mag_filter = filter; }
 
+    // Draws the given number of frames as fast as possible, prints how long they took, and quits.
+    void start_benchmark(int frame_count)
+    {
+        m_benchmark_frames_left = frame_count;
+        m_benchmark_frame_count = frame_count;
+        m_benchmark_time = {};
+        stop_timer();
+        start_timer(0);
+    }
+
     void toggle_show_frame_rate()
     {
         m_show_frame_rate = !m_show_frame_rate;
@@ -123,6 +134,9 @@ private:
     float m_texture_scale = 1.0f;
     GLint m_mag_filter = GL_NEAREST;
     float m_zoom = 1;
+    int m_benchmark_frames_left { 0 };
+    int m_benchmark_frame_count { 0 };
+    Time m_benchmark_time {};
 };
 
 void GLContextWidget::drag_enter_event(GUI::DragEvent& event)
@@ -286,6 +300,16 @@ void GLContextWidget::timer_event(Core::TimerEvent&)
 
     m_accumulated_time += timer.elapsed_time();
     m_cycles++;
+
+    if (m_benchmark_frames_left > 0) {
+        m_benchmark_time += timer.elapsed_time();
+        if (--m_benchmark_frames_left == 0) {
+            auto total_time = static_cast<double>(m_benchmark_time.to_microseconds()) / 1'000'000;
+            auto frame_rate = total_time > 0 ? m_benchmark_frame_count / total_time : 0;
+            outln("{} frames in {:.3f} s: {:.1f} fps, {:.2f} ms per frame", m_benchmark_frame_count, total_time, frame_rate, total_time * 1000 / m_benchmark_frame_count);
+            GUI::Application::the()->quit();
+        }
+    }
 }
 
 bool GLContextWidget::load_path(DeprecatedString const& filename)
@@ -367,6 +391,14 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     auto app = TRY(GUI::Application::try_create(arguments));
 
+    StringView filename = "/home/anon/Documents/3D Models/teapot.obj"sv;
+    int benchmark_frame_count = 0;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(benchmark_frame_count, "Draw this many frames as fast as possible, print the frame rate, and exit", "benchmark", 'b', "frame count");
+    args_parser.add_positional_argument(filename, "Model to show", "file", Core::ArgsParser::Required::No);
+    args_parser.parse(arguments);
+
     TRY(Core::System::pledge("stdio thread recvfd sendfd rpath unix prot_exec"));
 
     TRY(Core::System::unveil("/tmp/session/%sid/portal/filesystemaccess", "rw"));
@@ -589,11 +621,13 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     window->show();
 
-    auto filename = arguments.argc > 1 ? arguments.argv[1] : "/home/anon/Documents/3D Models/teapot.obj";
     if (widget->load_path(filename)) {
         auto canonical_path = Core::DeprecatedFile::absolute_path(filename);
         window->set_title(DeprecatedString::formatted("{} - 3D File Viewer", canonical_path));
     }
 
+    if (benchmark_frame_count > 0)
+        widget->start_benchmark(benchmark_frame_count);
+
     return app->exec();
 }
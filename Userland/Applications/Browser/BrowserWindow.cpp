@@ -374,6 +374,16 @@ void BrowserWindow::build_menus()
             active_tab().view().debug_request("dump-style-sheets");
         },
         this));
+    debug_menu.add_action(GUI::Action::create(
+        "Dump Style &Memory", g_icon_bag.filetype_css, [this](auto&) {
+            active_tab().view().debug_request("dump-style-memory");
+        },
+        this));
+    debug_menu.add_action(GUI::Action::create(
+        "Dump &Rendering Timings", g_icon_bag.layout, [this](auto&) {
+            active_tab().view().debug_request("dump-rendering-timings");
+        },
+        this));
     debug_menu.add_action(GUI::Action::create("Dump &History", { Mod_Ctrl, Key_H }, g_icon_bag.history, [this](auto&) {
         active_tab().m_history.dump();
     }));
@@ -136,7 +136,7 @@ static void unlink_coredump(StringView coredump_path)
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
-    TRY(Core::System::pledge("stdio recvfd sendfd cpath rpath unix proc exec thread"));
+    TRY(Core::System::pledge("stdio recvfd sendfd cpath rpath wpath unix proc exec thread"));
 
     auto app = TRY(GUI::Application::try_create(arguments));
 
@@ -43,8 +43,6 @@ PDFViewer::PDFViewer()
     set_focus_policy(GUI::FocusPolicy::StrongFocus);
     set_scrollbars_enabled(true);
 
-    start_timer(30'000);
-
     m_page_view_mode = static_cast<PageViewMode>(Config::read_i32("PDFViewer"sv, "Display"sv, "PageMode"sv, 0));
     m_rendering_preferences.show_clipping_paths = Config::read_bool("PDFViewer"sv, "Rendering"sv, "ShowClippingPaths"sv, false);
     m_rendering_preferences.show_images = Config::read_bool("PDFViewer"sv, "Rendering"sv, "ShowImages"sv, true);
@@ -55,11 +53,7 @@ PDF::PDFErrorOr<void> PDFViewer::set_document(RefPtr<PDF::Document> document)
     m_document = document;
     m_current_page_index = document->get_first_page_index();
     m_zoom_level = initial_zoom_level;
-    m_rendered_page_list.clear();
-
-    m_rendered_page_list.ensure_capacity(document->get_page_count());
-    for (u32 i = 0; i < document->get_page_count(); i++)
-        m_rendered_page_list.unchecked_append(HashMap<u32, RenderedPage>());
+    discard_rendered_pages();
 
     TRY(cache_page_dimensions(true));
     update();
@@ -67,17 +61,122 @@ PDF::PDFErrorOr<void> PDFViewer::set_document(RefPtr<PDF::Document> document)
     return {};
 }
 
-PDF::PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> PDFViewer::get_rendered_page(u32 index)
+u32 PDFViewer::render_key() const
+{
+    return pair_int_hash(m_rendering_preferences.hash(), m_zoom_level);
+}
+
+void PDFViewer::discard_rendered_pages()
+{
+    for (auto& it : m_pending_renders)
+        it.value.action->cancel();
+    m_pending_renders.clear();
+    m_rendered_pages.clear();
+}
+
+RefPtr<Gfx::Bitmap> PDFViewer::get_rendered_page(u32 index)
+{
+    auto key = render_key();
+    for (size_t i = 0; i < m_rendered_pages.size(); ++i) {
+        auto const& rendered_page = m_rendered_pages[i];
+        if (rendered_page.page_index != index || rendered_page.key != key || rendered_page.rotation != m_rotations)
+            continue;
+
+        // The most recently used pages are at the end, and the ones at the start are thrown out first.
+        auto bitmap = rendered_page.bitmap;
+        m_rendered_pages.append(m_rendered_pages.take(i));
+        return bitmap;
+    }
+
+    request_render(index);
+    return nullptr;
+}
+
+void PDFViewer::request_render(u32 page_index)
+{
+    auto key = render_key();
+    if (auto pending = m_pending_renders.get(page_index); pending.has_value()) {
+        if (pending->key == key && pending->rotation == m_rotations)
+            return;
+        m_pending_renders.take(page_index)->action->cancel();
+    }
+
+    auto render_id = m_next_render_id++;
+    auto page_size = m_page_dimension_cache.render_info[page_index].size.to_type<int>();
+    auto action = Threading::BackgroundAction<RenderResult>::construct(
+        [document = NonnullRefPtr { *m_document }, page_index, page_size, rendering_preferences = m_rendering_preferences, rotations = m_rotations](auto& task) -> RenderResult {
+            if (task.is_cancelled())
+                return {};
+
+            auto result = render_page(*document, page_index, page_size, rendering_preferences, rotations, [&task] { return task.is_cancelled(); });
+            if (task.is_cancelled())
+                return {};
+            return result;
+        },
+        [viewer = make_weak_ptr<PDFViewer>(), page_index, render_id](RenderResult result) -> ErrorOr<void> {
+            if (viewer)
+                viewer->handle_render_result(page_index, render_id, move(result));
+            return {};
+        });
+
+    m_pending_renders.set(page_index, { render_id, key, m_rotations, move(action) });
+}
+
+void PDFViewer::cancel_stale_renders(u32 first_page_index, u32 last_page_index)
 {
-    auto key = pair_int_hash(m_rendering_preferences.hash(), m_zoom_level);
-    auto& rendered_page_map = m_rendered_page_list[index];
-    auto existing_rendered_page = rendered_page_map.get(key);
-    if (existing_rendered_page.has_value() && existing_rendered_page.value().rotation == m_rotations)
-        return existing_rendered_page.value().bitmap;
-
-    auto rendered_page = TRY(render_page(index));
-    rendered_page_map.set(key, { rendered_page, m_rotations });
-    return rendered_page;
+    auto key = render_key();
+    Vector<u32> stale_page_indices;
+    for (auto& it : m_pending_renders) {
+        auto const& pending = it.value;
+        if (it.key < first_page_index || it.key > last_page_index || pending.key != key || pending.rotation != m_rotations)
+            stale_page_indices.append(it.key);
+    }
+
+    for (auto page_index : stale_page_indices)
+        m_pending_renders.take(page_index)->action->cancel();
+}
+
+void PDFViewer::render_pages_around(u32 first_page_index, u32 last_page_index)
+{
+    // The pages right before and after the ones that are shown are rendered after them, so that they're ready by the
+    // time they're scrolled to.
+    if (first_page_index > 0)
+        (void)get_rendered_page(first_page_index - 1);
+    if (last_page_index + 1 < m_document->get_page_count())
+        (void)get_rendered_page(last_page_index + 1);
+}
+
+void PDFViewer::handle_render_result(u32 page_index, u64 render_id, RenderResult result)
+{
+    // The render may have been cancelled, and a newer one of the same page may have been started since.
+    auto pending = m_pending_renders.get(page_index);
+    if (!pending.has_value() || pending->id != render_id)
+        return;
+
+    auto key = pending->key;
+    auto rotation = pending->rotation;
+    m_pending_renders.remove(page_index);
+
+    if (!result.has_value())
+        return;
+
+    if (result->is_error()) {
+        warnln("{}", result->error().message());
+        GUI::MessageBox::show_error(nullptr, "Failed to render the page."sv);
+        discard_rendered_pages();
+        m_document.clear();
+        update();
+        return;
+    }
+
+    auto output = result->release_value();
+    if (output.errors.has_value() && on_render_errors)
+        on_render_errors(page_index, output.errors.value());
+
+    m_rendered_pages.append({ page_index, key, rotation, move(output.bitmap) });
+    if (m_rendered_pages.size() > max_cached_pages)
+        m_rendered_pages.remove(0);
+    update();
 }
 
 void PDFViewer::paint_event(GUI::PaintEvent& event)
@@ -92,29 +191,29 @@ void PDFViewer::paint_event(GUI::PaintEvent& event)
     if (!m_document)
         return;
 
-    auto handle_error = [&](PDF::Error& error) {
-        warnln("{}", error.message());
-        GUI::MessageBox::show_error(nullptr, "Failed to render the page."sv);
-        m_document.clear();
+    // Pages that haven't been rendered yet are shown as blank pages until they are.
+    auto paint_page = [&](Gfx::IntPoint position, u32 page_index, RefPtr<Gfx::Bitmap> const& page) {
+        if (page)
+            painter.blit(position, *page, page->rect());
+        else
+            painter.fill_rect({ position, m_page_dimension_cache.render_info[page_index].size.to_type<int>() }, Color::White);
     };
 
     if (m_page_view_mode == PageViewMode::Single) {
-        auto maybe_page = get_rendered_page(m_current_page_index);
-        if (maybe_page.is_error()) {
-            handle_error(maybe_page.error());
-            return;
-        }
+        cancel_stale_renders(m_current_page_index > 0 ? m_current_page_index - 1 : 0, m_current_page_index + 1);
 
-        auto page = maybe_page.release_value();
-        set_content_size(page->size());
+        auto page = get_rendered_page(m_current_page_index);
+        auto page_size = page ? page->size() : m_page_dimension_cache.render_info[m_current_page_index].size.to_type<int>();
+        set_content_size(page_size);
 
         painter.translate(frame_thickness(), frame_thickness());
         painter.translate(-horizontal_scrollbar().value(), -vertical_scrollbar().value());
 
-        int x = max(0, (width() - page->width()) / 2);
-        int y = max(0, (height() - page->height()) / 2);
+        int x = max(0, (width() - page_size.width()) / 2);
+        int y = max(0, (height() - page_size.height()) / 2);
 
-        painter.blit({ x, y }, *page, page->rect());
+        paint_page({ x, y }, m_current_page_index, page);
+        render_pages_around(m_current_page_index, m_current_page_index);
         return;
     }
 
@@ -138,19 +237,17 @@ void PDFViewer::paint_event(GUI::PaintEvent& event)
     auto middle = height() / 2;
     auto y_offset = initial_offset;
 
-    for (size_t page_index = first_page_index; page_index <= last_page_index; page_index++) {
-        auto maybe_page = get_rendered_page(page_index);
-        if (maybe_page.is_error()) {
-            handle_error(maybe_page.error());
-            return;
-        }
+    // Scrolling past pages that are still being rendered makes their renders pointless, so they're cancelled.
+    cancel_stale_renders(first_page_index > 0 ? first_page_index - 1 : 0, last_page_index + 1);
 
-        auto page = maybe_page.release_value();
+    for (size_t page_index = first_page_index; page_index <= last_page_index; page_index++) {
+        auto page = get_rendered_page(page_index);
+        auto page_size = page ? page->size() : m_page_dimension_cache.render_info[page_index].size.to_type<int>();
 
-        auto x = max(0, (width() - page->width()) / 2);
+        auto x = max(0, (width() - page_size.width()) / 2);
 
-        painter.blit({ x, PAGE_PADDING }, *page, page->rect());
-        auto diff_y = page->height() + PAGE_PADDING * 2;
+        paint_page({ x, PAGE_PADDING }, page_index, page);
+        auto diff_y = page_size.height() + PAGE_PADDING * 2;
         painter.translate(0, diff_y);
 
         if (y_offset < middle && y_offset + diff_y >= middle)
@@ -158,6 +255,8 @@ void PDFViewer::paint_event(GUI::PaintEvent& event)
 
         y_offset += diff_y;
     }
+
+    render_pages_around(first_page_index, last_page_index);
 }
 
 void PDFViewer::set_current_page(u32 current_page)
@@ -183,8 +282,8 @@ void PDFViewer::set_show_images(bool show_images)
 
 void PDFViewer::resize_event(GUI::ResizeEvent&)
 {
-    for (auto& map : m_rendered_page_list)
-        map.clear();
+    // The size of the pages depends on the size of the viewer.
+    discard_rendered_pages();
     if (m_document)
         MUST(cache_page_dimensions());
     update();
@@ -265,15 +364,6 @@ void PDFViewer::mousemove_event(GUI::MouseEvent& event)
     }
 }
 
-void PDFViewer::timer_event(Core::TimerEvent&)
-{
-    // Clear the bitmap vector of all pages except the current page
-    for (size_t i = 0; i < m_rendered_page_list.size(); i++) {
-        if (i != m_current_page_index)
-            m_rendered_page_list[i].clear();
-    }
-}
-
 void PDFViewer::zoom_in()
 {
     if (m_zoom_level < zoom_levels.size() - 1) {
@@ -313,21 +403,18 @@ void PDFViewer::set_page_view_mode(PageViewMode mode)
     update();
 }
 
-PDF::PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> PDFViewer::render_page(u32 page_index)
+// This runs on the background thread, so it must only use what it's given.
+PDF::PDFErrorOr<PDFViewer::RenderOutput> PDFViewer::render_page(PDF::Document& document, u32 page_index, Gfx::IntSize page_size, PDF::RenderingPreferences rendering_preferences, int rotations, Function<bool()> is_cancelled)
 {
-    auto page = TRY(m_document->get_page(page_index));
-    auto& page_size = m_page_dimension_cache.render_info[page_index].size;
-    auto bitmap = TRY(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, page_size.to_type<int>()));
-
-    auto maybe_errors = PDF::Renderer::render(*m_document, page, bitmap, m_rendering_preferences);
-    if (maybe_errors.is_error()) {
-        auto errors = maybe_errors.release_error();
-        on_render_errors(page_index, errors);
-        return bitmap;
-    }
+    auto page = TRY(document.get_page(page_index));
+    auto bitmap = TRY(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, page_size));
+
+    auto maybe_errors = PDF::Renderer::render(document, page, bitmap, rendering_preferences, move(is_cancelled));
+    if (maybe_errors.is_error())
+        return RenderOutput { move(bitmap), maybe_errors.release_error() };
 
-    if (page.rotate + m_rotations != 0) {
-        int rotation_count = ((page.rotate + m_rotations) / 90) % 4;
+    if (page.rotate + rotations != 0) {
+        int rotation_count = ((page.rotate + rotations) / 90) % 4;
         if (rotation_count == 3) {
             bitmap = TRY(bitmap->rotated(Gfx::RotationDirection::CounterClockwise));
         } else {
@@ -336,7 +423,7 @@ PDF::PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> PDFViewer::render_page(u32 page_inde
         }
     }
 
-    return bitmap;
+    return RenderOutput { move(bitmap), {} };
 }
 
 PDF::PDFErrorOr<void> PDFViewer::cache_page_dimensions(bool recalculate_fixed_info)
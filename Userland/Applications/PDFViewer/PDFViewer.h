@@ -12,6 +12,7 @@
 #include <LibGfx/Bitmap.h>
 #include <LibPDF/Document.h>
 #include <LibPDF/Renderer.h>
+#include <LibThreading/BackgroundAction.h>
 
 static constexpr size_t initial_zoom_level = 8;
 
@@ -76,22 +77,51 @@ protected:
     virtual void mousedown_event(GUI::MouseEvent&) override;
     virtual void mouseup_event(GUI::MouseEvent&) override;
     virtual void mousemove_event(GUI::MouseEvent&) override;
-    virtual void timer_event(Core::TimerEvent&) override;
 
 private:
+    // Pages are rendered on the background thread, and only the ones that were shown or rendered most recently are
+    // kept. A bitmap is only used with the zoom level, rendering preferences and rotation it was rendered with.
+    static constexpr size_t max_cached_pages = 8;
+
     struct RenderedPage {
+        u32 page_index;
+        u32 key;
+        int rotation;
         NonnullRefPtr<Gfx::Bitmap> bitmap;
+    };
+
+    struct RenderOutput {
+        NonnullRefPtr<Gfx::Bitmap> bitmap;
+        Optional<PDF::Errors> errors;
+    };
+    // Nothing if the render was cancelled.
+    using RenderResult = Optional<PDF::PDFErrorOr<RenderOutput>>;
+
+    struct PendingRender {
+        u64 id;
+        u32 key;
         int rotation;
+        NonnullRefPtr<Threading::BackgroundAction<RenderResult>> action;
     };
 
-    PDF::PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> get_rendered_page(u32 index);
-    PDF::PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> render_page(u32 page_index);
+    u32 render_key() const;
+    void discard_rendered_pages();
+    RefPtr<Gfx::Bitmap> get_rendered_page(u32 index);
+    void request_render(u32 page_index);
+    // Cancels the renders that haven't finished yet of pages that aren't in [first_page_index, last_page_index], or
+    // that would end up rendered differently than they're wanted now.
+    void cancel_stale_renders(u32 first_page_index, u32 last_page_index);
+    void render_pages_around(u32 first_page_index, u32 last_page_index);
+    void handle_render_result(u32 page_index, u64 render_id, RenderResult);
+    static PDF::PDFErrorOr<RenderOutput> render_page(PDF::Document&, u32 page_index, Gfx::IntSize, PDF::RenderingPreferences, int rotations, Function<bool()> is_cancelled);
     PDF::PDFErrorOr<void> cache_page_dimensions(bool recalculate_fixed_info = false);
     void change_page(u32 new_page);
 
     RefPtr<PDF::Document> m_document;
     u32 m_current_page_index { 0 };
-    Vector<HashMap<u32, RenderedPage>> m_rendered_page_list;
+    Vector<RenderedPage> m_rendered_pages;
+    HashMap<u32, PendingRender> m_pending_renders;
+    u64 m_next_render_id { 0 };
 
     u8 m_zoom_level { initial_zoom_level };
     PageDimensionCache m_page_dimension_cache;
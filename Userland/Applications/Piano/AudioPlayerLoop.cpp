@@ -64,6 +64,8 @@ AudioPlayerLoop::AudioPlayerLoop(TrackManager& track_manager, Atomic<bool>& need
     if (target_sample_rate == 0)
         target_sample_rate = Music::sample_rate;
     m_resampler = Audio::ResampleHelper<DSP::Sample>(Music::sample_rate, target_sample_rate);
+    // Notes should be heard as soon as they're played, so the mixer shouldn't add more latency than it has to.
+    m_audio_client->request_buffer_size(128);
 
     MUST(m_pipeline_thread->set_priority(sched_get_priority_max(0)));
     m_pipeline_thread->start();
@@ -16,8 +16,10 @@
 #include <LibGUI/MessageBox.h>
 #include <LibGUI/Statusbar.h>
 #include <LibGUI/Window.h>
+#include <LibGfx/PNGWriter.h>
 #include <LibGfx/Painter.h>
 #include <LibMain/Main.h>
+#include <LibThreading/ThreadPool.h>
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
@@ -38,6 +40,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     TRY(Core::System::unveil("/etc/FileIconProvider.ini", "r"));
     TRY(Core::System::unveil(nullptr, nullptr));
 
+    Gfx::PNGWriter::set_encoding_thread_pool(&Threading::ThreadPool::the());
+
     auto app_icon = GUI::Icon::default_icon("app-pixel-paint"sv);
 
     PixelPaint::g_icon_bag = TRY(PixelPaint::IconBag::create());
@@ -9,29 +9,50 @@
 
 PlaybackManager::PlaybackManager(NonnullRefPtr<Audio::ConnectionToServer> connection)
     : m_connection(connection)
+    , m_decoder_thread(Threading::Thread::construct([this]() {
+        decode_ahead();
+        return 0;
+    },
+          "SoundPlayer decoder"sv))
 {
-    // FIXME: The buffer enqueuing should happen on a wholly independent second thread.
     m_timer = Core::Timer::create_repeating(PlaybackManager::update_rate_ms, [&]() {
         if (!m_loader)
             return;
         next_buffer();
     }).release_value_but_fixme_should_propagate_errors();
     m_device_sample_rate = connection->get_sample_rate();
+    m_decoder_thread->start();
+}
+
+PlaybackManager::~PlaybackManager()
+{
+    {
+        Threading::MutexLocker locker(m_decoded_buffers_mutex);
+        m_decoder_should_exit = true;
+    }
+    m_decoder_wakeup.signal();
+    (void)m_decoder_thread->join();
 }
 
 void PlaybackManager::set_loader(NonnullRefPtr<Audio::Loader>&& loader)
 {
     stop();
-    m_loader = loader;
-    if (m_loader) {
-        m_total_length = m_loader->total_samples() / static_cast<float>(m_loader->sample_rate());
-        m_device_samples_per_buffer = PlaybackManager::buffer_size_ms / 1000.0f * m_device_sample_rate;
-        m_samples_to_load_per_buffer = PlaybackManager::buffer_size_ms / 1000.0f * m_loader->sample_rate();
-        m_resampler = Audio::ResampleHelper<Audio::Sample>(m_loader->sample_rate(), m_device_sample_rate);
+    {
+        Threading::MutexLocker locker(m_loader_mutex);
+        m_loader = loader;
+        if (m_loader) {
+            m_total_length = m_loader->total_samples() / static_cast<float>(m_loader->sample_rate());
+            m_device_samples_per_buffer = PlaybackManager::buffer_size_ms / 1000.0f * m_device_sample_rate;
+            m_samples_to_load_per_buffer = PlaybackManager::buffer_size_ms / 1000.0f * m_loader->sample_rate();
+            // FIXME: Handle OOM better.
+            m_resampler = MUST(Audio::SincResampler::try_create(m_loader->sample_rate(), m_device_sample_rate));
+        }
+        restart_decoding();
+    }
+    if (m_loader)
         m_timer->start();
-    } else {
+    else
         m_timer->stop();
-    }
 }
 
 void PlaybackManager::stop()
@@ -39,8 +60,12 @@ void PlaybackManager::stop()
     set_paused(true);
     m_connection->async_clear_buffer();
 
+    Threading::MutexLocker locker(m_loader_mutex);
     if (m_loader)
         (void)m_loader->reset();
+    if (m_resampler.has_value())
+        m_resampler->reset();
+    restart_decoding();
 }
 
 void PlaybackManager::play()
@@ -61,7 +86,13 @@ void PlaybackManager::seek(int const position)
     bool paused_state = m_paused;
     set_paused(true);
 
-    [[maybe_unused]] auto result = m_loader->seek(position);
+    {
+        Threading::MutexLocker locker(m_loader_mutex);
+        [[maybe_unused]] auto result = m_loader->seek(position);
+        if (m_resampler.has_value())
+            m_resampler->reset();
+        restart_decoding();
+    }
 
     m_connection->clear_client_buffer();
     m_connection->async_clear_buffer();
@@ -69,6 +100,17 @@ void PlaybackManager::seek(int const position)
         set_paused(false);
 }
 
+void PlaybackManager::restart_decoding()
+{
+    m_loaded_samples = m_loader ? m_loader->loaded_samples() : 0;
+    {
+        Threading::MutexLocker locker(m_decoded_buffers_mutex);
+        m_decoded_buffers.clear();
+        m_decoding_finished = !m_loader;
+    }
+    m_decoder_wakeup.signal();
+}
+
 void PlaybackManager::pause()
 {
     set_paused(true);
@@ -93,6 +135,44 @@ bool PlaybackManager::toggle_pause()
     return m_paused;
 }
 
+void PlaybackManager::decode_ahead()
+{
+    for (;;) {
+        {
+            Threading::MutexLocker locker(m_decoded_buffers_mutex);
+            m_decoder_wakeup.wait_while([this] {
+                return !m_decoder_should_exit && (m_decoding_finished || m_decoded_buffers.size() >= read_ahead_buffer_count);
+            });
+            if (m_decoder_should_exit)
+                return;
+        }
+
+        // Holding the loader lock while decoding means that a seek waits for the buffer that's being decoded, and
+        // then throws it away, instead of the buffer ending up after the seek.
+        Threading::MutexLocker loader_locker(m_loader_mutex);
+        if (!m_loader)
+            continue;
+
+        auto buffer_or_error = m_loader->get_more_samples(m_samples_to_load_per_buffer);
+        Optional<DecodedBuffer> decoded_buffer;
+        if (buffer_or_error.is_error()) {
+            // FIXME: These errors should be shown to the user instead of being logged and then ignored
+            dbgln("Error while loading samples: {}", buffer_or_error.error().description);
+        } else if (!buffer_or_error.value().is_empty()) {
+            VERIFY(m_resampler.has_value());
+            // FIXME: Handle OOM better.
+            auto resampled = MUST(FixedArray<Audio::Sample>::create(MUST(m_resampler->try_resample(buffer_or_error.value().span())).span()));
+            decoded_buffer = DecodedBuffer { move(resampled), m_loader->loaded_samples() };
+        }
+
+        Threading::MutexLocker locker(m_decoded_buffers_mutex);
+        if (decoded_buffer.has_value())
+            m_decoded_buffers.enqueue(decoded_buffer.release_value());
+        if (!decoded_buffer.has_value() || m_loader->loaded_samples() >= m_loader->total_samples())
+            m_decoding_finished = true;
+    }
+}
+
 void PlaybackManager::next_buffer()
 {
     if (on_update)
@@ -101,31 +181,27 @@ void PlaybackManager::next_buffer()
     if (m_paused)
         return;
 
-    while (m_connection->remaining_samples() < m_device_samples_per_buffer * always_enqueued_buffer_count) {
-        bool all_samples_loaded = (m_loader->loaded_samples() >= m_loader->total_samples());
-        bool audio_server_done = (m_connection->remaining_samples() == 0);
-
-        if (all_samples_loaded && audio_server_done) {
-            stop();
-            if (on_finished_playing)
-                on_finished_playing();
-            return;
-        }
-
-        auto buffer_or_error = m_loader->get_more_samples(m_samples_to_load_per_buffer);
-        if (buffer_or_error.is_error()) {
-            // FIXME: These errors should be shown to the user instead of being logged and then ignored
-            dbgln("Error while loading samples: {}", buffer_or_error.error().description);
-            return;
+    bool finished_playing = false;
+    {
+        Threading::MutexLocker locker(m_decoded_buffers_mutex);
+        while (m_connection->remaining_samples() < m_device_samples_per_buffer * always_enqueued_buffer_count) {
+            if (m_decoded_buffers.is_empty()) {
+                bool audio_server_done = (m_connection->remaining_samples() == 0);
+                finished_playing = m_decoding_finished && audio_server_done;
+                break;
+            }
+
+            auto buffer = m_decoded_buffers.dequeue();
+            m_current_buffer.swap(buffer.samples);
+            m_loaded_samples = buffer.loaded_samples;
+            MUST(m_connection->async_enqueue(m_current_buffer));
+            m_decoder_wakeup.signal();
         }
-        auto buffer = buffer_or_error.release_value();
-        m_current_buffer.swap(buffer);
-        VERIFY(m_resampler.has_value());
+    }
 
-        m_resampler->reset();
-        // FIXME: Handle OOM better.
-        auto resampled = MUST(FixedArray<Audio::Sample>::create(m_resampler->resample(move(m_current_buffer)).span()));
-        m_current_buffer.swap(resampled);
-        MUST(m_connection->async_enqueue(m_current_buffer));
+    if (finished_playing) {
+        stop();
+        if (on_finished_playing)
+            on_finished_playing();
     }
 }
@@ -15,11 +15,14 @@
 #include <LibAudio/Resampler.h>
 #include <LibAudio/Sample.h>
 #include <LibCore/Timer.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/Thread.h>
 
 class PlaybackManager final {
 public:
     PlaybackManager(NonnullRefPtr<Audio::ConnectionToServer>);
-    ~PlaybackManager() = default;
+    ~PlaybackManager();
 
     void play();
     void stop();
@@ -30,6 +33,8 @@ public:
     void set_loader(NonnullRefPtr<Audio::Loader>&&);
     RefPtr<Audio::Loader> loader() const { return m_loader; }
     size_t device_sample_rate() const { return m_device_sample_rate; }
+    // How far into the file the audio that was given to the audio server goes. The loader itself is further ahead.
+    int loaded_samples() const { return m_loaded_samples; }
 
     bool is_paused() const { return m_paused; }
     float total_length() const { return m_total_length; }
@@ -43,9 +48,21 @@ public:
 private:
     // Number of buffers we want to always keep enqueued.
     static constexpr size_t always_enqueued_buffer_count = 5;
+    // Number of buffers that are decoded ahead of the ones that are enqueued, so that decoding a slow part of the file
+    // (or the GUI being busy) doesn't make the audio server run out of samples.
+    static constexpr size_t read_ahead_buffer_count = 10;
+
+    struct DecodedBuffer {
+        FixedArray<Audio::Sample> samples;
+        // The loader's position after this buffer.
+        int loaded_samples { 0 };
+    };
 
     void next_buffer();
     void set_paused(bool);
+    void decode_ahead();
+    // Throws away whatever was decoded ahead, after the loader moved somewhere else.
+    void restart_decoding();
 
     bool m_paused { true };
     bool m_loop = { false };
@@ -53,12 +70,23 @@ private:
     size_t m_device_sample_rate { 44100 };
     size_t m_device_samples_per_buffer { 0 };
     size_t m_samples_to_load_per_buffer { 0 };
+    int m_loaded_samples { 0 };
+    // Changing the loader and resampler, or using them, needs this lock, as they're used by the decoder thread.
     RefPtr<Audio::Loader> m_loader { nullptr };
+    Optional<Audio::SincResampler> m_resampler;
+    Threading::Mutex m_loader_mutex;
     NonnullRefPtr<Audio::ConnectionToServer> m_connection;
     FixedArray<Audio::Sample> m_current_buffer;
-    Optional<Audio::ResampleHelper<Audio::Sample>> m_resampler;
     RefPtr<Core::Timer> m_timer;
 
+    // The decoder thread keeps the read-ahead queue filled. Whoever holds both locks takes the loader lock first.
+    NonnullRefPtr<Threading::Thread> m_decoder_thread;
+    Threading::Mutex m_decoded_buffers_mutex;
+    Threading::ConditionVariable m_decoder_wakeup { m_decoded_buffers_mutex };
+    Queue<DecodedBuffer> m_decoded_buffers;
+    bool m_decoding_finished { true };
+    bool m_decoder_should_exit { false };
+
     // Controls the GUI update rate. A smaller value makes the visualizations nicer.
     static constexpr u32 update_rate_ms = 50;
     // Number of milliseconds of audio data contained in each audio buffer
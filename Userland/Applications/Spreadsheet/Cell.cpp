@@ -32,6 +32,7 @@ void Cell::set_data(DeprecatedString new_data)
     m_data = move(new_data);
     m_dirty = true;
     m_evaluated_externally = false;
+    m_compiled_formula = nullptr;
 }
 
 void Cell::set_data(JS::Value new_data)
@@ -43,6 +44,7 @@ void Cell::set_data(JS::Value new_data)
 
     builder.append(new_data.to_string_without_side_effects());
     m_data = builder.to_deprecated_string();
+    m_compiled_formula = nullptr;
 
     m_evaluated_data = move(new_data);
 }
@@ -98,9 +100,13 @@ void Cell::update_data(Badge<Sheet>)
 
     if (m_dirty) {
         m_dirty = false;
+        // NOTE: The cells that refer to this one are updated by Sheet::update(), after all cells that they refer to.
+        if (!m_evaluated_externally)
+            clear_references();
+
         if (m_kind == Formula) {
             if (!m_evaluated_externally) {
-                auto value_or_error = m_sheet->evaluate(m_data, this);
+                auto value_or_error = evaluate_formula();
                 if (value_or_error.is_error()) {
                     m_evaluated_data = JS::js_undefined();
                     m_thrown_value = *value_or_error.release_error().release_value();
@@ -110,13 +116,6 @@ void Cell::update_data(Badge<Sheet>)
                 }
             }
         }
-
-        for (auto& ref : m_referencing_cells) {
-            if (ref) {
-                ref->m_dirty = true;
-                ref->update();
-            }
-        }
     }
 
     m_evaluated_formats.background_color.clear();
@@ -140,6 +139,13 @@ void Cell::update_data(Badge<Sheet>)
     }
 }
 
+JS::ThrowCompletionOr<JS::Value> Cell::evaluate_formula()
+{
+    if (!m_compiled_formula)
+        m_compiled_formula = TRY(m_sheet->parse(m_data, this));
+    return m_sheet->evaluate(*m_compiled_formula, this);
+}
+
 void Cell::update()
 {
     m_sheet->update(*this);
@@ -176,6 +182,16 @@ void Cell::reference_from(Cell* other)
         return;
 
     m_referencing_cells.append(other->make_weak_ptr());
+    other->m_referenced_cells.append(make_weak_ptr());
+}
+
+void Cell::clear_references()
+{
+    for (auto& referenced_cell : m_referenced_cells) {
+        if (referenced_cell)
+            referenced_cell->m_referencing_cells.remove_first_matching([this](auto const& ptr) { return ptr.ptr() == this; });
+    }
+    m_referenced_cells.clear();
 }
 
 void Cell::copy_from(Cell const& other)
@@ -184,6 +200,7 @@ void Cell::copy_from(Cell const& other)
     m_evaluated_externally = other.m_evaluated_externally;
     m_data = other.m_data;
     m_evaluated_data = other.m_evaluated_data;
+    m_compiled_formula = nullptr;
     m_kind = other.m_kind;
     m_type = other.m_type;
     m_type_metadata = other.m_type_metadata;
@@ -44,10 +44,13 @@ struct Cell : public Weakable<Cell> {
     }
 
     void reference_from(Cell*);
+    // Forgets which cells this one was reading from, before its formula is evaluated again and finds out anew.
+    void clear_references();
 
     void set_data(DeprecatedString new_data);
     void set_data(JS::Value new_data);
     bool dirty() const { return m_dirty; }
+    void set_dirty() { m_dirty = true; }
     void clear_dirty() { m_dirty = false; }
 
     StringView name_for_javascript(Sheet const& sheet) const
@@ -71,6 +74,8 @@ struct Cell : public Weakable<Cell> {
     const JS::Value& evaluated_data() const { return m_evaluated_data; }
     Kind kind() const { return m_kind; }
     Vector<WeakPtr<Cell>> const& referencing_cells() const { return m_referencing_cells; }
+    Vector<WeakPtr<Cell>> const& referenced_cells() const { return m_referenced_cells; }
+    JS::GCPtr<JS::Script> compiled_formula() const { return m_compiled_formula; }
 
     void set_type(StringView name);
     void set_type(CellType const*);
@@ -114,6 +119,8 @@ struct Cell : public Weakable<Cell> {
     void copy_from(Cell const&);
 
 private:
+    JS::ThrowCompletionOr<JS::Value> evaluate_formula();
+
     bool m_dirty { false };
     bool m_evaluated_externally { false };
     DeprecatedString m_data;
@@ -122,6 +129,9 @@ private:
     Kind m_kind { LiteralString };
     WeakPtr<Sheet> m_sheet;
     Vector<WeakPtr<Cell>> m_referencing_cells;
+    Vector<WeakPtr<Cell>> m_referenced_cells;
+    // The parsed formula is kept until the formula changes, as most updates only change the values it reads.
+    JS::GCPtr<JS::Script> m_compiled_formula;
     CellType const* m_type { nullptr };
     CellTypeMetadata m_type_metadata;
     Position m_position;
@@ -121,6 +121,24 @@ DeprecatedString Sheet::add_column()
     return next_column;
 }
 
+static bool is_part_of_reference_cycle(Cell& cell)
+{
+    HashTable<Cell*> seen_cells;
+    Vector<Cell*> cells_to_visit { &cell };
+    while (!cells_to_visit.is_empty()) {
+        auto* current = cells_to_visit.take_last();
+        for (auto& referencing_cell : current->referencing_cells()) {
+            if (!referencing_cell)
+                continue;
+            if (referencing_cell.ptr() == &cell)
+                return true;
+            if (seen_cells.set(referencing_cell.ptr()) == HashSetResult::InsertedNewEntry)
+                cells_to_visit.append(referencing_cell.ptr());
+        }
+    }
+    return false;
+}
+
 void Sheet::update()
 {
     if (m_should_ignore_updates) {
@@ -128,20 +146,76 @@ void Sheet::update()
         return;
     }
     m_visited_cells_in_update.clear();
-    Vector<Cell&> cells_copy;
+    Vector<Cell&> dirty_cells;
 
     // Grab a copy as updates might insert cells into the table.
     for (auto& it : m_cells) {
         if (it.value->dirty()) {
-            cells_copy.append(*it.value);
+            dirty_cells.append(*it.value);
             m_workbook.set_dirty(true);
         }
     }
 
-    for (auto& cell : cells_copy)
+    Vector<Cell&> cells_in_cycles;
+    for (auto& cell : cells_to_update_in_order(move(dirty_cells), cells_in_cycles))
         update(cell);
 
     m_visited_cells_in_update.clear();
+
+    // The references were found out anew while evaluating, so only the cycles that are still there are reported.
+    for (auto& cell : cells_in_cycles) {
+        if (is_part_of_reference_cycle(cell))
+            cell.set_thrown_value(JS::Error::create(interpreter().realm(), DeprecatedString::formatted("Circular reference in {}", cell.name_for_javascript(*this))));
+    }
+}
+
+// Finds all cells that have to be updated because of the dirty ones, ordered such that each cell comes after all cells it
+// refers to, which means that every cell is evaluated once. The cells that can't be put in such an order because they are
+// in (or depend on) a reference cycle come last, and are also put into cells_in_cycles.
+Vector<Cell&> Sheet::cells_to_update_in_order(Vector<Cell&> dirty_cells, Vector<Cell&>& cells_in_cycles)
+{
+    Vector<Cell&> affected_cells;
+    HashMap<Cell*, size_t> unresolved_reference_counts;
+    for (auto& cell : dirty_cells) {
+        if (unresolved_reference_counts.set(&cell, 0) == HashSetResult::InsertedNewEntry)
+            affected_cells.append(cell);
+    }
+    for (size_t i = 0; i < affected_cells.size(); ++i) {
+        for (auto& referencing_cell : affected_cells[i].referencing_cells()) {
+            if (referencing_cell && unresolved_reference_counts.set(referencing_cell.ptr(), 0) == HashSetResult::InsertedNewEntry) {
+                referencing_cell->set_dirty();
+                affected_cells.append(*referencing_cell);
+            }
+        }
+    }
+
+    for (auto& cell : affected_cells) {
+        for (auto& referencing_cell : cell.referencing_cells()) {
+            if (referencing_cell)
+                ++unresolved_reference_counts.find(referencing_cell.ptr())->value;
+        }
+    }
+
+    Vector<Cell&> ordered_cells;
+    ordered_cells.ensure_capacity(affected_cells.size());
+    for (auto& cell : affected_cells) {
+        if (unresolved_reference_counts.get(&cell).value() == 0)
+            ordered_cells.append(cell);
+    }
+    for (size_t i = 0; i < ordered_cells.size(); ++i) {
+        for (auto& referencing_cell : ordered_cells[i].referencing_cells()) {
+            if (referencing_cell && --unresolved_reference_counts.find(referencing_cell.ptr())->value == 0)
+                ordered_cells.append(*referencing_cell);
+        }
+    }
+
+    for (auto& cell : affected_cells) {
+        if (unresolved_reference_counts.get(&cell).value() != 0) {
+            ordered_cells.append(cell);
+            cells_in_cycles.append(cell);
+        }
+    }
+    return ordered_cells;
 }
 
 void Sheet::update(Cell& cell)
@@ -163,8 +237,19 @@ void Sheet::update(Cell& cell)
 }
 
 JS::ThrowCompletionOr<JS::Value> Sheet::evaluate(StringView source, Cell* on_behalf_of)
+{
+    auto script = TRY(parse(source, on_behalf_of));
+    return evaluate(*script, on_behalf_of);
+}
+
+JS::ThrowCompletionOr<JS::Value> Sheet::evaluate(JS::Script& script, Cell* on_behalf_of)
 {
     TemporaryChange cell_change { m_current_cell_being_evaluated, on_behalf_of };
+    return interpreter().run(script);
+}
+
+JS::ThrowCompletionOr<JS::NonnullGCPtr<JS::Script>> Sheet::parse(StringView source, Cell* on_behalf_of)
+{
     auto name = on_behalf_of ? on_behalf_of->name_for_javascript(*this) : "cell <unknown>"sv;
     auto script_or_error = JS::Script::parse(
         source,
@@ -174,7 +259,7 @@ JS::ThrowCompletionOr<JS::Value> Sheet::evaluate(StringView source, Cell* on_beh
     if (script_or_error.is_error())
         return interpreter().vm().throw_completion<JS::SyntaxError>(script_or_error.error().first().to_deprecated_string());
 
-    return interpreter().run(script_or_error.value());
+    return script_or_error.release_value();
 }
 
 Cell* Sheet::at(StringView name)
@@ -122,6 +122,8 @@ public:
     }
 
     JS::ThrowCompletionOr<JS::Value> evaluate(StringView, Cell* = nullptr);
+    JS::ThrowCompletionOr<JS::Value> evaluate(JS::Script&, Cell* = nullptr);
+    JS::ThrowCompletionOr<JS::NonnullGCPtr<JS::Script>> parse(StringView, Cell* = nullptr);
     JS::Interpreter& interpreter() const;
     SheetGlobalObject& global_object() const { return *m_global_object; }
 
@@ -148,6 +150,8 @@ private:
     explicit Sheet(Workbook&);
     explicit Sheet(StringView name, Workbook&);
 
+    Vector<Cell&> cells_to_update_in_order(Vector<Cell&> dirty_cells, Vector<Cell&>& cells_in_cycles);
+
     DeprecatedString m_name;
     Vector<DeprecatedString> m_columns;
     size_t m_rows { 0 };
@@ -20,6 +20,7 @@
 #include <Applications/SystemMonitor/SystemMonitorGML.h>
 #include <LibConfig/Client.h>
 #include <LibCore/ArgsParser.h>
+#include <LibCore/Directory.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/Object.h>
 #include <LibCore/System.h>
@@ -50,6 +51,7 @@
 #include <LibGfx/Font/FontDatabase.h>
 #include <LibGfx/Palette.h>
 #include <LibMain/Main.h>
+#include <LibSymbolication/SymbolIndex.h>
 #include <LibThreading/BackgroundAction.h>
 #include <serenity.h>
 #include <signal.h>
@@ -234,7 +236,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         sched_setparam(0, &param);
     }
 
-    TRY(Core::System::pledge("stdio thread proc recvfd sendfd rpath exec unix"));
+    TRY(Core::System::pledge("stdio thread proc recvfd sendfd rpath wpath cpath exec unix"));
 
     auto app = TRY(GUI::Application::try_create(arguments));
 
@@ -262,6 +264,12 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     if (auto result = Core::System::unveil("/boot/Kernel.debug", "r"); result.is_error() && (result.error().code() != EACCES && result.error().code() != ENOENT))
         return result.release_error();
 
+    // Symbolicating thread stacks reads the cached symbol indices, and adds the ones that are missing.
+    auto symbol_index_directory = Symbolication::SymbolIndex::cache_directory();
+    (void)Core::Directory::create(symbol_index_directory, Core::Directory::CreateDirectories::Yes);
+    if (auto result = Core::System::unveil(symbol_index_directory, "rwc"); result.is_error() && result.error().code() != ENOENT)
+        return result.release_error();
+
     TRY(Core::System::unveil("/bin/Profiler", "rx"));
     TRY(Core::System::unveil("/bin/Inspector", "rx"));
     TRY(Core::System::unveil(nullptr, nullptr));
@@ -12,6 +12,8 @@
 #include <Applications/TextEditor/TextEditorWindowGML.h>
 #include <LibConfig/Client.h>
 #include <LibCore/Debounce.h>
+#include <LibCore/MappedFile.h>
+#include <LibCore/System.h>
 #include <LibCpp/SyntaxHighlighter.h>
 #include <LibDesktop/Launcher.h>
 #include <LibGUI/Action.h>
@@ -748,7 +750,13 @@ void MainWidget::update_title()
 
 ErrorOr<void> MainWidget::read_file(String const& filename, Core::File& file)
 {
-    m_editor->set_text(TRY(file.read_until_eof()));
+    // Mapping the file spares us from copying all of it onto the heap, just to split it into lines.
+    // That doesn't work for empty files or pipes though, so we read those.
+    auto mapped_file = Core::MappedFile::map_from_fd_and_close(TRY(Core::System::dup(file.fd())), filename);
+    if (!mapped_file.is_error())
+        m_editor->set_text(StringView { mapped_file.value()->bytes() });
+    else
+        m_editor->set_text(TRY(file.read_until_eof()));
     set_path(filename);
     m_editor->set_focus(true);
     return {};
@@ -33,10 +33,18 @@ void ConnectionFromClient::greet(DeprecatedString const& project_root)
         perror("unveil");
         exit(1);
     }
+    // Language servers keep what they cache between runs, like the index of the project's symbols, in here.
+    auto cache_directory = LexicalPath::join(project_root, ".hackstudio"sv).string();
+    if (unveil(cache_directory.characters(), "rwc") < 0) {
+        perror("unveil");
+        exit(1);
+    }
     if (unveil(nullptr, nullptr) < 0) {
         perror("unveil");
         exit(1);
     }
+
+    m_autocomplete_engine->project_opened();
 }
 
 void ConnectionFromClient::file_opened(DeprecatedString const& filename, IPC::File const& file)
@@ -5,6 +5,7 @@
  */
 
 #include "ProjectDeclarations.h"
+#include <LibCore/EventLoop.h>
 
 HackStudio::ProjectDeclarations& HackStudio::ProjectDeclarations::the()
 {
@@ -14,8 +15,17 @@ HackStudio::ProjectDeclarations& HackStudio::ProjectDeclarations::the()
 void HackStudio::ProjectDeclarations::set_declared_symbols(DeprecatedString const& filename, Vector<CodeComprehension::Declaration> const& declarations)
 {
     m_document_to_declarations.set(filename, declarations);
-    if (on_update)
-        on_update();
+
+    // Language servers send the declarations of every file in the project at once after indexing it, so the views
+    // are only updated once for all of them.
+    if (m_update_pending)
+        return;
+    m_update_pending = true;
+    Core::deferred_invoke([this] {
+        m_update_pending = false;
+        if (on_update)
+            on_update();
+    });
 }
 
 Optional<GUI::Icon> HackStudio::ProjectDeclarations::get_icon_for(CodeComprehension::DeclarationType type)
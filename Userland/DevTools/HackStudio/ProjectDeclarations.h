@@ -32,6 +32,7 @@ public:
 private:
     ProjectDeclarations() = default;
     HashMap<DeprecatedString, Vector<CodeComprehension::Declaration>> m_document_to_declarations;
+    bool m_update_pending { false };
 };
 
 template<typename Func>
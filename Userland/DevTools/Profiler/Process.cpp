@@ -61,6 +61,7 @@ static MappedObject* get_or_create_mapped_object(DeprecatedString const& path)
     auto new_mapped_object = adopt_own(*new MappedObject {
         .file = file_or_error.release_value(),
         .elf = elf,
+        .path = path,
     });
     auto* ptr = new_mapped_object.ptr();
     g_mapped_object_cache.set(path, move(new_mapped_object));
@@ -121,7 +122,22 @@ DeprecatedString LibraryMetadata::Library::symbolicate(FlatPtr ptr, u32* offset)
     if (!object)
         return DeprecatedString::formatted("?? <{:p}>", ptr);
 
-    return object->elf.symbolicate(ptr - base, offset);
+    return object->symbolicate(ptr - base, offset);
+}
+
+DeprecatedString MappedObject::symbolicate(FlatPtr address, u32* offset) const
+{
+    if (!tried_loading_symbol_index) {
+        tried_loading_symbol_index = true;
+        if (auto symbol_index_or_error = Symbolication::SymbolIndex::load_or_create(path); !symbol_index_or_error.is_error())
+            symbol_index = symbol_index_or_error.release_value();
+        else
+            dbgln("Failed to load symbol index of {}: {}", path, symbol_index_or_error.error());
+    }
+
+    if (symbol_index)
+        return symbol_index->symbolicate(address, offset);
+    return elf.symbolicate(address, offset);
 }
 
 LibraryMetadata::Library const* LibraryMetadata::library_containing(FlatPtr ptr) const
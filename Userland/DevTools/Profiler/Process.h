@@ -13,12 +13,19 @@
 #include <LibCore/MappedFile.h>
 #include <LibDebug/DebugInfo.h>
 #include <LibELF/Image.h>
+#include <LibSymbolication/SymbolIndex.h>
 
 namespace Profiler {
 
 struct MappedObject {
     NonnullRefPtr<Core::MappedFile> file;
     ELF::Image elf;
+    DeprecatedString path {};
+    // This is loaded lazily, and stays null if the object couldn't be indexed.
+    mutable RefPtr<Symbolication::SymbolIndex> symbol_index {};
+    mutable bool tried_loading_symbol_index { false };
+
+    DeprecatedString symbolicate(FlatPtr, u32* offset) const;
 };
 
 extern HashMap<DeprecatedString, OwnPtr<MappedObject>> g_mapped_object_cache;
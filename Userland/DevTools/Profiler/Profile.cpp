@@ -40,6 +40,8 @@ Profile::Profile(Vector<Process> processes, Vector<Event> events)
     for (size_t i = 0; i < m_events.size(); ++i) {
         if (m_events[i].data.has<Event::SignpostData>())
             m_signpost_indices.append(i);
+        if (m_events[i].data.has<Event::OffCPUData>())
+            m_has_off_cpu_events = true;
     }
 
     m_first_timestamp = m_events.first().timestamp;
@@ -49,6 +51,8 @@ Profile::Profile(Vector<Process> processes, Vector<Event> events)
     m_samples_model = SamplesModel::create(*this);
     m_signposts_model = SignpostsModel::create(*this);
     m_file_event_model = FileEventModel::create(*this);
+    m_off_cpu_model = ProfileModel::create(*this, ProfileModel::Tree::OffCPU);
+    m_wait_time_model = WaitTimeModel::create(*this);
 
     rebuild_tree();
 }
@@ -68,24 +72,38 @@ GUI::Model& Profile::signposts_model()
     return *m_signposts_model;
 }
 
+GUI::Model& Profile::off_cpu_model()
+{
+    return *m_off_cpu_model;
+}
+
+GUI::Model& Profile::wait_time_model()
+{
+    return *m_wait_time_model;
+}
+
 void Profile::rebuild_tree()
 {
     Vector<NonnullRefPtr<ProfileNode>> roots;
+    Vector<NonnullRefPtr<ProfileNode>> off_cpu_roots;
 
-    auto find_or_create_process_node = [this, &roots](pid_t pid, EventSerialNumber serial) -> ProfileNode& {
+    auto find_or_create_process_node_in = [this](Vector<NonnullRefPtr<ProfileNode>>& target_roots, pid_t pid, EventSerialNumber serial) -> ProfileNode& {
         auto const* process = find_process(pid, serial);
         if (!process) {
             dbgln("Profile contains event for unknown process with pid={}, serial={}", pid, serial.to_number());
             VERIFY_NOT_REACHED();
         }
-        for (auto root : roots) {
+        for (auto root : target_roots) {
             if (&root->process() == process)
                 return root;
         }
         auto new_root = ProfileNode::create_process_node(*process);
-        roots.append(new_root);
+        target_roots.append(new_root);
         return new_root;
     };
+    auto find_or_create_process_node = [&](pid_t pid, EventSerialNumber serial) -> ProfileNode& {
+        return find_or_create_process_node_in(roots, pid, serial);
+    };
 
     HashTable<FlatPtr> live_allocations;
 
@@ -103,6 +121,9 @@ void Profile::rebuild_tree()
     m_filtered_event_indices.clear();
     m_filtered_signpost_indices.clear();
     m_file_event_nodes->children().clear();
+    m_filtered_off_cpu_microseconds = 0;
+    m_wait_channel_statistics.clear();
+    HashMap<DeprecatedString, size_t> wait_channel_indices;
 
     for (size_t event_index = 0; event_index < m_events.size(); ++event_index) {
         auto& event = m_events.at(event_index);
@@ -121,14 +142,6 @@ void Profile::rebuild_tree()
             continue;
         }
 
-        m_filtered_event_indices.append(event_index);
-
-        if (auto* malloc_data = event.data.get_pointer<Event::MallocData>(); malloc_data && !live_allocations.contains(malloc_data->ptr))
-            continue;
-
-        if (event.data.has<Event::FreeData>())
-            continue;
-
         auto for_each_frame = [&]<typename Callback>(Callback callback) {
             if (!m_inverted) {
                 for (size_t i = 0; i < event.frames.size(); ++i) {
@@ -143,6 +156,42 @@ void Profile::rebuild_tree()
             }
         };
 
+        if (auto const* off_cpu_data = event.data.get_pointer<Event::OffCPUData>()) {
+            auto& statistics_index = wait_channel_indices.ensure(off_cpu_data->wait_channel, [&] {
+                m_wait_channel_statistics.append({ off_cpu_data->wait_channel, off_cpu_data->reason });
+                return m_wait_channel_statistics.size() - 1;
+            });
+            auto& statistics = m_wait_channel_statistics[statistics_index];
+            ++statistics.count;
+            statistics.total_ns += off_cpu_data->duration_ns;
+            statistics.max_ns = max(statistics.max_ns, off_cpu_data->duration_ns);
+
+            auto weight = static_cast<u32>(clamp<u64>(off_cpu_data->duration_ns / 1000, 1, NumericLimits<u32>::max()));
+            m_filtered_off_cpu_microseconds += weight;
+
+            auto& process_node = find_or_create_process_node_in(off_cpu_roots, event.pid, event.serial);
+            process_node.increment_event_count(weight);
+            ProfileNode* node = &process_node;
+            for_each_frame([&](Frame const& frame, bool is_innermost_frame) {
+                if (frame.symbol.is_empty())
+                    return IterationDecision::Break;
+                node = &node->find_or_create_child(frame.object_name, frame.symbol, frame.address, frame.offset, event.timestamp, event.pid);
+                node->increment_event_count(weight);
+                if (is_innermost_frame)
+                    node->increment_self_count(weight);
+                return IterationDecision::Continue;
+            });
+            continue;
+        }
+
+        m_filtered_event_indices.append(event_index);
+
+        if (auto* malloc_data = event.data.get_pointer<Event::MallocData>(); malloc_data && !live_allocations.contains(malloc_data->ptr))
+            continue;
+
+        if (event.data.has<Event::FreeData>())
+            continue;
+
         if (!m_show_top_functions) {
             ProfileNode* node = nullptr;
             auto& process_node = find_or_create_process_node(event.pid, event.serial);
@@ -225,9 +274,16 @@ void Profile::rebuild_tree()
     }
 
     sort_profile_nodes(roots);
+    sort_profile_nodes(off_cpu_roots);
+    quick_sort(m_wait_channel_statistics, [](auto& a, auto& b) {
+        return a.total_ns > b.total_ns;
+    });
 
     m_roots = move(roots);
+    m_off_cpu_roots = move(off_cpu_roots);
     m_model->invalidate();
+    m_off_cpu_model->invalidate();
+    m_wait_time_model->invalidate();
 }
 
 Optional<MappedObject> g_kernel_debuginfo_object;
@@ -248,7 +304,7 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
         if (!debuginfo_file_or_error.is_error()) {
             auto debuginfo_file = debuginfo_file_or_error.release_value();
             auto debuginfo_image = ELF::Image(debuginfo_file->bytes());
-            g_kernel_debuginfo_object = { { debuginfo_file, move(debuginfo_image) } };
+            g_kernel_debuginfo_object = { { debuginfo_file, move(debuginfo_image), "/boot/Kernel.debug"sv } };
         }
     }
 
@@ -395,6 +451,14 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
                 .start_timestamp = perf_event.get_integer<size_t>("start_timestamp"sv).value_or(0),
                 .success = perf_event.get_bool("success"sv).value_or(false)
             };
+        } else if (type_string == "off_cpu"sv) {
+            auto const reason_index = perf_event.get_addr("reason_index"sv).value_or(0);
+            auto const wait_channel_index = perf_event.get_addr("wait_channel_index"sv).value_or(0);
+            event.data = Event::OffCPUData {
+                .reason = profile_strings.get(reason_index).value_or("unknown"),
+                .wait_channel = profile_strings.get(wait_channel_index).value_or("unknown"),
+                .duration_ns = perf_event.get_u64("duration_ns"sv).value_or(0),
+            };
         } else {
             dbgln("Unknown event type '{}'", type_string);
             VERIFY_NOT_REACHED();
@@ -414,7 +478,7 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
 
             if (maybe_kernel_base.has_value() && ptr >= maybe_kernel_base.value()) {
                 if (g_kernel_debuginfo_object.has_value()) {
-                    symbol = g_kernel_debuginfo_object->elf.symbolicate(ptr - maybe_kernel_base.value(), &offset);
+                    symbol = g_kernel_debuginfo_object->symbolicate(ptr - maybe_kernel_base.value(), &offset);
                 } else {
                     symbol = DeprecatedString::formatted("?? <{:p}>", ptr);
                 }
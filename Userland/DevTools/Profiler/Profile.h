@@ -14,6 +14,7 @@
 #include "SamplesModel.h"
 #include "SignpostsModel.h"
 #include "SourceModel.h"
+#include "WaitTimeModel.h"
 #include <AK/Bitmap.h>
 #include <AK/DeprecatedFlyString.h>
 #include <AK/JsonArray.h>
@@ -90,8 +91,8 @@ public:
     ProfileNode* parent() { return m_parent; }
     ProfileNode const* parent() const { return m_parent; }
 
-    void increment_event_count() { ++m_event_count; }
-    void increment_self_count() { ++m_self_count; }
+    void increment_event_count(u32 amount = 1) { m_event_count += amount; }
+    void increment_self_count(u32 amount = 1) { m_self_count += amount; }
 
     void sort_children();
 
@@ -148,6 +149,8 @@ public:
     GUI::Model& model();
     GUI::Model& samples_model();
     GUI::Model& signposts_model();
+    GUI::Model& off_cpu_model();
+    GUI::Model& wait_time_model();
     GUI::Model* disassembly_model();
     GUI::Model* source_model();
     GUI::Model* file_event_model();
@@ -165,6 +168,21 @@ public:
 
     Vector<NonnullRefPtr<ProfileNode>> const& roots() const { return m_roots; }
 
+    // The off-CPU tree is weighted by the microseconds threads spent blocked rather than by sample count.
+    Vector<NonnullRefPtr<ProfileNode>> const& off_cpu_roots() const { return m_off_cpu_roots; }
+    u64 filtered_off_cpu_microseconds() const { return m_filtered_off_cpu_microseconds; }
+    bool has_off_cpu_events() const { return m_has_off_cpu_events; }
+
+    struct WaitChannelStatistics {
+        DeprecatedString wait_channel;
+        DeprecatedString reason;
+        u64 count { 0 };
+        u64 total_ns { 0 };
+        u64 max_ns { 0 };
+    };
+
+    Vector<WaitChannelStatistics> const& wait_channel_statistics() const { return m_wait_channel_statistics; }
+
     struct Frame {
         DeprecatedFlyString object_name;
         DeprecatedString symbol;
@@ -231,7 +249,13 @@ public:
             bool success;
         };
 
-        Variant<nullptr_t, SampleData, MallocData, FreeData, SignpostData, MmapData, MunmapData, ProcessCreateData, ProcessExecData, ThreadCreateData, ReadData> data { nullptr };
+        struct OffCPUData {
+            DeprecatedString reason;
+            DeprecatedString wait_channel;
+            u64 duration_ns { 0 };
+        };
+
+        Variant<nullptr_t, SampleData, MallocData, FreeData, SignpostData, MmapData, MunmapData, ProcessCreateData, ProcessExecData, ThreadCreateData, ReadData, OffCPUData> data { nullptr };
     };
 
     Vector<Event> const& events() const { return m_events; }
@@ -294,6 +318,8 @@ private:
     RefPtr<ProfileModel> m_model;
     RefPtr<SamplesModel> m_samples_model;
     RefPtr<SignpostsModel> m_signposts_model;
+    RefPtr<ProfileModel> m_off_cpu_model;
+    RefPtr<WaitTimeModel> m_wait_time_model;
     RefPtr<DisassemblyModel> m_disassembly_model;
     RefPtr<SourceModel> m_source_model;
     RefPtr<FileEventModel> m_file_event_model;
@@ -302,6 +328,10 @@ private:
     GUI::ModelIndex m_source_index;
 
     Vector<NonnullRefPtr<ProfileNode>> m_roots;
+    Vector<NonnullRefPtr<ProfileNode>> m_off_cpu_roots;
+    u64 m_filtered_off_cpu_microseconds { 0 };
+    bool m_has_off_cpu_events { false };
+    Vector<WaitChannelStatistics> m_wait_channel_statistics;
     Vector<size_t> m_filtered_event_indices;
     u64 m_first_timestamp { 0 };
     u64 m_last_timestamp { 0 };
@@ -8,17 +8,25 @@
 #pragma once
 
 #include <AK/IntegralMath.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Vector.h>
 #include <LibGUI/Model.h>
 
 namespace Profiler {
 
 class Profile;
+class ProfileNode;
 
 class ProfileModel final : public GUI::Model {
 public:
-    static NonnullRefPtr<ProfileModel> create(Profile& profile)
+    enum class Tree {
+        OnCPU,
+        OffCPU,
+    };
+
+    static NonnullRefPtr<ProfileModel> create(Profile& profile, Tree tree = Tree::OnCPU)
     {
-        return adopt_ref(*new ProfileModel(profile));
+        return adopt_ref(*new ProfileModel(profile, tree));
     }
 
     enum Column {
@@ -44,9 +52,13 @@ public:
     virtual Vector<GUI::ModelIndex> matches(StringView, unsigned flags, GUI::ModelIndex const&) override;
 
 private:
-    explicit ProfileModel(Profile&);
+    ProfileModel(Profile&, Tree);
+
+    Vector<NonnullRefPtr<ProfileNode>> const& roots() const;
+    size_t total_weight() const;
 
     Profile& m_profile;
+    Tree m_tree { Tree::OnCPU };
 
     GUI::Icon m_user_frame_icon;
     GUI::Icon m_kernel_frame_icon;
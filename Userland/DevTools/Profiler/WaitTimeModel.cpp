@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "WaitTimeModel.h"
+#include "Profile.h"
+
+namespace Profiler {
+
+WaitTimeModel::WaitTimeModel(Profile& profile)
+    : m_profile(profile)
+{
+}
+
+int WaitTimeModel::row_count(GUI::ModelIndex const&) const
+{
+    return m_profile.wait_channel_statistics().size();
+}
+
+int WaitTimeModel::column_count(GUI::ModelIndex const&) const
+{
+    return Column::__Count;
+}
+
+DeprecatedString WaitTimeModel::column_name(int column) const
+{
+    switch (column) {
+    case Column::WaitChannel:
+        return "Waiting On";
+    case Column::Reason:
+        return "Reason";
+    case Column::Count:
+        return "Count";
+    case Column::TotalTime:
+        return "Total (us)";
+    case Column::AverageTime:
+        return "Average (us)";
+    case Column::MaxTime:
+        return "Max (us)";
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+GUI::Variant WaitTimeModel::data(GUI::ModelIndex const& index, GUI::ModelRole role) const
+{
+    auto const& statistics = m_profile.wait_channel_statistics()[index.row()];
+
+    if (role == GUI::ModelRole::TextAlignment) {
+        if (index.column() != Column::WaitChannel && index.column() != Column::Reason)
+            return Gfx::TextAlignment::CenterRight;
+    }
+
+    if (role == GUI::ModelRole::Display) {
+        switch (index.column()) {
+        case Column::WaitChannel:
+            return statistics.wait_channel;
+        case Column::Reason:
+            return statistics.reason;
+        case Column::Count:
+            return statistics.count;
+        case Column::TotalTime:
+            return statistics.total_ns / 1000;
+        case Column::AverageTime:
+            return statistics.count ? statistics.total_ns / statistics.count / 1000 : 0;
+        case Column::MaxTime:
+            return statistics.max_ns / 1000;
+        default:
+            return {};
+        }
+    }
+    return {};
+}
+
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <LibGUI/Model.h>
+
+namespace Profiler {
+
+class Profile;
+
+// Aggregates off-CPU events by what the thread was waiting on (a mutex name or a blocker state).
+class WaitTimeModel final : public GUI::Model {
+public:
+    static NonnullRefPtr<WaitTimeModel> create(Profile& profile)
+    {
+        return adopt_ref(*new WaitTimeModel(profile));
+    }
+
+    enum Column {
+        WaitChannel,
+        Reason,
+        Count,
+        TotalTime,
+        AverageTime,
+        MaxTime,
+        __Count
+    };
+
+    virtual ~WaitTimeModel() override = default;
+
+    virtual int row_count(GUI::ModelIndex const& = GUI::ModelIndex()) const override;
+    virtual int column_count(GUI::ModelIndex const& = GUI::ModelIndex()) const override;
+    virtual DeprecatedString column_name(int) const override;
+    virtual GUI::Variant data(GUI::ModelIndex const&, GUI::ModelRole) const override;
+    virtual bool is_column_sortable(int) const override { return false; }
+
+private:
+    explicit WaitTimeModel(Profile&);
+
+    Profile& m_profile;
+};
+
+}
@@ -217,6 +217,20 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     auto flamegraph_view = TRY(flamegraph_tab->try_add<FlameGraphView>(profile->model(), ProfileModel::Column::StackFrame, ProfileModel::Column::SampleCount));
 
+    RefPtr<FlameGraphView> off_cpu_flamegraph_view;
+    if (profile->has_off_cpu_events()) {
+        auto off_cpu_flamegraph_tab = TRY(tab_widget->try_add_tab<GUI::Widget>("Off-CPU Flame Graph"));
+        off_cpu_flamegraph_tab->set_layout<GUI::VerticalBoxLayout>();
+        off_cpu_flamegraph_tab->layout()->set_margins({ 4, 4, 4, 4 });
+        off_cpu_flamegraph_view = TRY(off_cpu_flamegraph_tab->try_add<FlameGraphView>(profile->off_cpu_model(), ProfileModel::Column::StackFrame, ProfileModel::Column::SampleCount));
+
+        auto wait_time_tab = TRY(tab_widget->try_add_tab<GUI::Widget>("Wait Time"));
+        wait_time_tab->set_layout<GUI::VerticalBoxLayout>();
+        wait_time_tab->layout()->set_margins(4);
+        auto wait_time_table_view = TRY(wait_time_tab->try_add<GUI::TableView>());
+        wait_time_table_view->set_model(profile->wait_time_model());
+    }
+
     u64 const start_of_trace = profile->first_timestamp();
     u64 const end_of_trace = start_of_trace + profile->length_in_ms();
     auto const clamp_timestamp = [start_of_trace, end_of_trace](u64 timestamp) -> u64 {
@@ -236,7 +250,14 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         StringBuilder builder;
 
         auto flamegraph_hovered_index = flamegraph_view->hovered_index();
-        if (flamegraph_hovered_index.is_valid()) {
+        auto off_cpu_hovered_index = off_cpu_flamegraph_view ? off_cpu_flamegraph_view->hovered_index() : GUI::ModelIndex {};
+        if (off_cpu_hovered_index.is_valid()) {
+            auto stack = profile->off_cpu_model().data(off_cpu_hovered_index.sibling_at_column(ProfileModel::Column::StackFrame)).to_deprecated_string();
+            auto blocked = profile->off_cpu_model().data(off_cpu_hovered_index.sibling_at_column(ProfileModel::Column::SampleCount)).to_deprecated_string();
+            auto self = profile->off_cpu_model().data(off_cpu_hovered_index.sibling_at_column(ProfileModel::Column::SelfCount)).to_deprecated_string();
+            auto unit = profile->show_percentages() ? "%"sv : " us"sv;
+            builder.appendff("{}, Blocked: {}{}, Self: {}{}", stack, blocked, unit, self, unit);
+        } else if (flamegraph_hovered_index.is_valid()) {
             auto stack = profile->model().data(flamegraph_hovered_index.sibling_at_column(ProfileModel::Column::StackFrame)).to_deprecated_string();
             auto sample_count = profile->model().data(flamegraph_hovered_index.sibling_at_column(ProfileModel::Column::SampleCount));
             auto self_count = profile->model().data(flamegraph_hovered_index.sibling_at_column(ProfileModel::Column::SelfCount));
@@ -259,6 +280,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     };
     timeline_view->on_selection_change = [&] { statusbar_update(); };
     flamegraph_view->on_hover_change = [&] { statusbar_update(); };
+    if (off_cpu_flamegraph_view)
+        off_cpu_flamegraph_view->on_hover_change = [&] { statusbar_update(); };
 
     auto filesystem_events_tab = TRY(tab_widget->try_add_tab<GUI::Widget>("Filesystem events"));
     filesystem_events_tab->set_layout<GUI::VerticalBoxLayout>();
@@ -364,7 +387,8 @@ bool generate_profile(pid_t& pid)
     }
 
     static constexpr u64 event_mask = PERF_EVENT_SAMPLE | PERF_EVENT_MMAP | PERF_EVENT_MUNMAP | PERF_EVENT_PROCESS_CREATE
-        | PERF_EVENT_PROCESS_EXEC | PERF_EVENT_PROCESS_EXIT | PERF_EVENT_THREAD_CREATE | PERF_EVENT_THREAD_EXIT;
+        | PERF_EVENT_PROCESS_EXEC | PERF_EVENT_PROCESS_EXIT | PERF_EVENT_THREAD_CREATE | PERF_EVENT_THREAD_EXIT
+        | PERF_EVENT_OFF_CPU;
 
     if (profiling_enable(pid, event_mask) < 0) {
         int saved_errno = errno;
@@ -217,6 +217,16 @@ bool Emulator::load_elf()
     return true;
 }
 
+void Emulator::did_write_to_code(FlatPtr address, size_t size)
+{
+    m_cpu->did_write_to_code(address, size);
+}
+
+void Emulator::invalidate_decoded_code()
+{
+    m_cpu->invalidate_decoded_code();
+}
+
 int Emulator::exec()
 {
     // X86::ELFSymbolProvider symbol_provider(*m_elf);
@@ -231,7 +241,8 @@ int Emulator::exec()
     while (!m_shutdown) {
         if (m_steps_til_pause) [[likely]] {
             m_cpu->save_base_eip();
-            auto insn = X86::Instruction::from_stream(*m_cpu, X86::ProcessorMode::Protected);
+            // The instruction is copied, since running it might throw away the block it was decoded in.
+            auto insn = m_cpu->fetch_instruction();
             // Exec cycle
             if constexpr (trace) {
                 outln("{:p}  \033[33;1m{}\033[0m", m_cpu->base_eip(), insn.to_deprecated_string(m_cpu->base_eip(), symbol_provider));
@@ -66,6 +66,10 @@ public:
 
     SoftMMU& mmu() { return m_mmu; }
 
+    // The CPU keeps the instructions it has decoded until the memory they were decoded from is written to or unmapped.
+    void did_write_to_code(FlatPtr address, size_t size);
+    void invalidate_decoded_code();
+
     MallocTracer* malloc_tracer() { return m_malloc_tracer; }
 
     bool is_in_loader_code() const;
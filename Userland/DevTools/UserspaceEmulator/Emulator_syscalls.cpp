@@ -1005,6 +1005,7 @@ u32 Emulator::virt$mprotect(FlatPtr base, size_t size, int prot)
         }
         return IterationDecision::Continue;
     });
+    m_cpu->invalidate_decoded_code();
     if (has_non_mmapped_region)
         return -EINVAL;
 
@@ -141,11 +141,85 @@ void SoftCPU::update_code_cache()
         TODO();
     }
 
-    // FIXME: This cache needs to be invalidated if the code region is ever unmapped.
     m_cached_code_region = region;
     m_cached_code_base_ptr = region->data();
 }
 
+static bool ends_decoded_block(X86::Instruction const& instruction)
+{
+    switch (instruction.op()) {
+    case 0xC2: // RET imm16
+    case 0xC3: // RET
+    case 0xCA: // RETF imm16
+    case 0xCB: // RETF
+    case 0xCF: // IRET
+    case 0xE8: // CALL rel32
+    case 0xE9: // JMP rel32
+    case 0xEA: // JMP far
+    case 0xEB: // JMP rel8
+    case 0xF4: // HLT
+        return true;
+    case 0xFF:
+        // CALL and JMP through a register or memory.
+        return instruction.slash() >= 2 && instruction.slash() <= 5;
+    default:
+        return false;
+    }
+}
+
+void SoftCPU::enter_decoded_block()
+{
+    static constexpr size_t max_decoded_block_length = 64;
+    static constexpr u32 max_instruction_length = 15;
+
+    m_current_block_index = 0;
+    if (auto it = m_decoded_blocks.find(m_eip); it != m_decoded_blocks.end()) {
+        m_current_block = it->value.ptr();
+        return;
+    }
+
+    auto block = make<DecodedBlock>();
+    auto block_eip = m_eip;
+    while (block->instructions.size() < max_decoded_block_length) {
+        auto instruction_eip = m_eip;
+        auto instruction = X86::Instruction::from_stream(*this, X86::ProcessorMode::Protected);
+        block->instructions.append({ instruction, instruction_eip, m_eip });
+        if (!instruction.is_valid() || ends_decoded_block(instruction))
+            break;
+        // Don't read ahead into the next region, which might not be code at all.
+        if (!m_cached_code_region->contains(m_eip + max_instruction_length - 1))
+            break;
+    }
+
+    for (u32 page = block_eip / PAGE_SIZE; page <= (m_eip - 1) / PAGE_SIZE; ++page)
+        m_decoded_code_pages.set(page);
+
+    m_eip = block_eip;
+    m_current_block = block.ptr();
+    m_decoded_blocks.set(block_eip, move(block));
+}
+
+void SoftCPU::did_write_to_code(u32 address, size_t size)
+{
+    if (m_decoded_code_pages.is_empty() || size == 0)
+        return;
+    for (u32 page = address / PAGE_SIZE; page <= (address + size - 1) / PAGE_SIZE; ++page) {
+        if (m_decoded_code_pages.contains(page)) {
+            invalidate_decoded_code();
+            return;
+        }
+    }
+}
+
+void SoftCPU::invalidate_decoded_code()
+{
+    m_decoded_blocks.clear();
+    m_decoded_code_pages.clear();
+    m_current_block = nullptr;
+    m_cached_code_region = nullptr;
+    m_cached_code_base_ptr = nullptr;
+}
+
 ValueWithShadow<u8> SoftCPU::read_memory8(X86::LogicalAddress address)
 {
     VERIFY(address.selector() == 0x1b || address.selector() == 0x23 || address.selector() == 0x2b);
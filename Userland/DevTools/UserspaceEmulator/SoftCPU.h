@@ -13,6 +13,10 @@
 #include "ValueWithShadow.h"
 #include <AK/ByteReader.h>
 #include <AK/Debug.h>
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Vector.h>
 #include <LibX86/Instruction.h>
 #include <LibX86/Interpreter.h>
 
@@ -56,6 +60,12 @@ public:
     void save_base_eip() { m_base_eip = m_eip; }
 
     u32 eip() const { return m_eip; }
+
+    // Returns the instruction at eip(), and moves eip() past it. The instructions are decoded a block at a time, and
+    // are kept until the code they were decoded from is changed.
+    X86::Instruction const& fetch_instruction();
+    void did_write_to_code(u32 address, size_t size);
+    void invalidate_decoded_code();
     void set_eip(u32 eip)
     {
         m_eip = eip;
@@ -1347,6 +1357,7 @@ private:
     void generic_RM32_CL(Op, const X86::Instruction&);
 
     void update_code_cache();
+    void enter_decoded_block();
 
     void write_segment_register(X86::SegmentRegister, ValueWithShadow<u16>);
 
@@ -1366,8 +1377,35 @@ private:
 
     Region* m_cached_code_region { nullptr };
     u8* m_cached_code_base_ptr { nullptr };
+
+    struct DecodedInstruction {
+        X86::Instruction instruction;
+        u32 eip { 0 };
+        u32 next_eip { 0 };
+    };
+
+    // A straight run of instructions, which ends at the first jump, call or return.
+    struct DecodedBlock {
+        Vector<DecodedInstruction> instructions;
+    };
+
+    HashMap<u32, NonnullOwnPtr<DecodedBlock>> m_decoded_blocks;
+    HashTable<u32> m_decoded_code_pages;
+    DecodedBlock const* m_current_block { nullptr };
+    size_t m_current_block_index { 0 };
 };
 
+ALWAYS_INLINE X86::Instruction const& SoftCPU::fetch_instruction()
+{
+    // Most of the time, the next instruction is the one after the last one in the current block.
+    if (!m_current_block || m_current_block_index >= m_current_block->instructions.size() || m_current_block->instructions[m_current_block_index].eip != m_eip) [[unlikely]]
+        enter_decoded_block();
+
+    auto const& decoded = m_current_block->instructions[m_current_block_index++];
+    m_eip = decoded.next_eip;
+    return decoded.instruction;
+}
+
 ALWAYS_INLINE u8 SoftCPU::read8()
 {
     if (!m_cached_code_region || !m_cached_code_region->contains(m_eip))
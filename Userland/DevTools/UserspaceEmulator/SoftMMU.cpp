@@ -40,6 +40,9 @@ void SoftMMU::remove_region(Region& region)
         m_page_to_region_map[first_page_in_region + i] = nullptr;
     }
 
+    // Code that was decoded from the region must not be run anymore.
+    m_emulator.invalidate_decoded_code();
+
     m_regions.remove_first_matching([&](auto& entry) { return entry.ptr() == &region; });
 }
 
@@ -212,6 +215,9 @@ void SoftMMU::write8(X86::LogicalAddress address, ValueWithShadow<u8> value)
         m_emulator.dump_backtrace();
         TODO();
     }
+    if (region->is_executable()) [[unlikely]]
+        m_emulator.did_write_to_code(address.offset(), sizeof(u8));
+
     region->write8(address.offset() - region->base(), value);
 }
 
@@ -230,6 +236,9 @@ void SoftMMU::write16(X86::LogicalAddress address, ValueWithShadow<u16> value)
         TODO();
     }
 
+    if (region->is_executable()) [[unlikely]]
+        m_emulator.did_write_to_code(address.offset(), sizeof(u16));
+
     region->write16(address.offset() - region->base(), value);
 }
 
@@ -248,6 +257,9 @@ void SoftMMU::write32(X86::LogicalAddress address, ValueWithShadow<u32> value)
         TODO();
     }
 
+    if (region->is_executable()) [[unlikely]]
+        m_emulator.did_write_to_code(address.offset(), sizeof(u32));
+
     region->write32(address.offset() - region->base(), value);
 }
 
@@ -266,6 +278,9 @@ void SoftMMU::write64(X86::LogicalAddress address, ValueWithShadow<u64> value)
         TODO();
     }
 
+    if (region->is_executable()) [[unlikely]]
+        m_emulator.did_write_to_code(address.offset(), sizeof(u64));
+
     region->write64(address.offset() - region->base(), value);
 }
 
@@ -284,6 +299,9 @@ void SoftMMU::write128(X86::LogicalAddress address, ValueWithShadow<u128> value)
         TODO();
     }
 
+    if (region->is_executable()) [[unlikely]]
+        m_emulator.did_write_to_code(address.offset(), sizeof(u128));
+
     region->write128(address.offset() - region->base(), value);
 }
 
@@ -302,6 +320,9 @@ void SoftMMU::write256(X86::LogicalAddress address, ValueWithShadow<u256> value)
         TODO();
     }
 
+    if (region->is_executable()) [[unlikely]]
+        m_emulator.did_write_to_code(address.offset(), sizeof(u256));
+
     region->write256(address.offset() - region->base(), value);
 }
 
@@ -345,6 +366,9 @@ bool SoftMMU::fast_fill_memory8(X86::LogicalAddress address, size_t size, ValueW
         }
     }
 
+    if (region->is_executable()) [[unlikely]]
+        m_emulator.did_write_to_code(address.offset(), size);
+
     size_t offset_in_region = address.offset() - region->base();
     memset(region->data() + offset_in_region, value.value(), size);
     memset(region->shadow_data() + offset_in_region, value.shadow()[0], size);
@@ -370,6 +394,9 @@ bool SoftMMU::fast_fill_memory32(X86::LogicalAddress address, size_t count, Valu
         }
     }
 
+    if (region->is_executable()) [[unlikely]]
+        m_emulator.did_write_to_code(address.offset(), count * sizeof(u32));
+
     size_t offset_in_region = address.offset() - region->base();
     fast_u32_fill((u32*)(region->data() + offset_in_region), value.value(), count);
     fast_u32_fill((u32*)(region->shadow_data() + offset_in_region), value.shadow_as_value(), count);
@@ -36,6 +36,8 @@ ConnectionToServer::ConnectionToServer(NonnullOwnPtr<Core::LocalSocket> socket)
         return (intptr_t) nullptr;
     }))
 {
+    // If the server doesn't want it, messages keep going through the socket.
+    (void)request_shared_ring_transport();
     async_pause_playback();
     set_buffer(*m_buffer);
 }
@@ -12,6 +12,7 @@
 #include <AK/IntegralMath.h>
 #include <AK/Math.h>
 #include <AK/MemoryStream.h>
+#include <AK/SIMD.h>
 #include <AK/ScopeGuard.h>
 #include <AK/StdLibExtras.h>
 #include <AK/Try.h>
@@ -255,38 +256,59 @@ MaybeLoaderError FlacLoaderPlugin::seek(int int_sample_index)
     if (sample_index == m_loaded_samples)
         return {};
 
-    auto maybe_target_seekpoint = m_seektable.last_matching([sample_index](auto& seekpoint) { return seekpoint.sample_index <= sample_index; });
-    // No seektable or no fitting entry: Perform normal forward read
-    if (!maybe_target_seekpoint.has_value()) {
-        if (sample_index < m_loaded_samples) {
-            LOADER_TRY(m_stream->seek(m_data_start_location, SeekMode::SetPosition));
-            m_loaded_samples = 0;
-        }
-        auto to_read = sample_index - m_loaded_samples;
-        if (to_read == 0)
-            return {};
-        dbgln_if(AFLACLOADER_DEBUG, "Seeking {} samples manually", to_read);
-        (void)TRY(get_more_samples(to_read));
-    } else {
-        auto target_seekpoint = maybe_target_seekpoint.release_value();
+    // Find the last seek point at or before the target. Seek points are sorted by their sample index, and the
+    // placeholder points that come last have the largest possible one.
+    size_t seekpoints_before_target = 0;
+    size_t seekpoints_end = m_seektable.size();
+    while (seekpoints_before_target < seekpoints_end) {
+        auto middle = seekpoints_before_target + (seekpoints_end - seekpoints_before_target) / 2;
+        if (m_seektable[middle].sample_index <= sample_index)
+            seekpoints_before_target = middle + 1;
+        else
+            seekpoints_end = middle;
+    }
+    auto target_seekpoint = seekpoints_before_target > 0 ? m_seektable[seekpoints_before_target - 1] : FlacSeekPoint { 0, 0, 0 };
 
-        // When a small seek happens, we may already be closer to the target than the seekpoint.
-        if (sample_index - target_seekpoint.sample_index > sample_index - m_loaded_samples) {
-            dbgln_if(AFLACLOADER_DEBUG, "Close enough to target: seeking {} samples manually", sample_index - m_loaded_samples);
-            (void)TRY(get_more_samples(sample_index - m_loaded_samples));
-            return {};
-        }
+    // When a small seek forward happens, we may already be closer to the target than the seek point.
+    if (sample_index > m_loaded_samples && target_seekpoint.sample_index <= m_loaded_samples) {
+        dbgln_if(AFLACLOADER_DEBUG, "Close enough to target: seeking {} samples manually", sample_index - m_loaded_samples);
+        return skip_samples(sample_index - m_loaded_samples);
+    }
 
-        dbgln_if(AFLACLOADER_DEBUG, "Seeking to seektable: sample index {}, byte offset {}, sample count {}", target_seekpoint.sample_index, target_seekpoint.byte_offset, target_seekpoint.num_samples);
-        auto position = target_seekpoint.byte_offset + m_data_start_location;
-        if (m_stream->seek(static_cast<i64>(position), SeekMode::SetPosition).is_error())
-            return LoaderError { LoaderError::Category::IO, m_loaded_samples, DeprecatedString::formatted("Invalid seek position {}", position) };
+    dbgln_if(AFLACLOADER_DEBUG, "Seeking to seek point: sample index {}, byte offset {}", target_seekpoint.sample_index, target_seekpoint.byte_offset);
+    auto position = target_seekpoint.byte_offset + m_data_start_location;
+    if (m_stream->seek(static_cast<i64>(position), SeekMode::SetPosition).is_error())
+        return LoaderError { LoaderError::Category::IO, m_loaded_samples, DeprecatedString::formatted("Invalid seek position {}", position) };
 
-        auto remaining_samples_after_seekpoint = sample_index - m_data_start_location;
-        if (remaining_samples_after_seekpoint > 0)
-            (void)TRY(get_more_samples(remaining_samples_after_seekpoint));
-        m_loaded_samples = target_seekpoint.sample_index;
+    m_loaded_samples = target_seekpoint.sample_index;
+    m_unread_data.clear_with_capacity();
+    return skip_samples(sample_index - m_loaded_samples);
+}
+
+MaybeLoaderError FlacLoaderPlugin::skip_samples(size_t sample_count)
+{
+    // The samples are decoded in pieces, so long skips don't need a buffer for all of them at once.
+    while (sample_count > 0) {
+        auto samples = TRY(get_more_samples(min(sample_count, FLAC_BUFFER_SIZE)));
+        if (samples.is_empty())
+            break;
+        sample_count -= samples.size();
+    }
+    return {};
+}
+
+MaybeLoaderError FlacLoaderPlugin::remember_seekpoint(u64 sample_index)
+{
+    // Files without a seek table get one as they're read, which makes seeking back to where playback already was cheap.
+    // One point per second is plenty, as seeking only has to decode up to a second of audio past it.
+    if (!m_seektable.is_empty()) {
+        auto last_sample_index = m_seektable.last().sample_index;
+        if (sample_index < last_sample_index || sample_index - last_sample_index < m_sample_rate)
+            return {};
     }
+
+    auto position = LOADER_TRY(m_stream->tell());
+    m_seektable.append({ .sample_index = sample_index, .byte_offset = position - m_data_start_location, .num_samples = 0 });
     return {};
 }
 
@@ -314,6 +336,7 @@ LoaderSamples FlacLoaderPlugin::get_more_samples(size_t max_bytes_to_read_from_i
     }
 
     while (sample_index < samples_to_read) {
+        TRY(remember_seekpoint(m_loaded_samples + sample_index));
         TRY(next_frame(samples.span().slice(sample_index)));
         sample_index += m_current_frame->sample_count;
     }
@@ -723,6 +746,9 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_custom_lpc(FlacSubfra
 
     // shift needed on the data (signed!)
     i8 lpc_shift = sign_extend(LOADER_TRY(bit_input.read_bits<u8>(5)), 5);
+    // The specification says that the shift must not be negative, and encoders never produce such a shift.
+    if (lpc_shift < 0)
+        return LoaderError { LoaderError::Category::Format, static_cast<size_t>(m_current_sample_or_frame), "Negative linear predictor shift" };
 
     Vector<i32> coefficients;
     coefficients.ensure_capacity(subframe.order);
@@ -738,18 +764,51 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_custom_lpc(FlacSubfra
     TRY(decode_residual(decoded, subframe, bit_input));
 
     // approximate the waveform with the predictor
-    for (size_t i = subframe.order; i < m_current_frame->sample_count; ++i) {
-        // (see below)
+    auto* samples = decoded.data();
+    auto predict_in_64_bits = [&](size_t i) {
+        // It's really important that we compute in 64-bit land here.
+        // Even though FLAC operates at a maximum bit depth of 32 bits, modern encoders use super-large coefficients for maximum compression.
+        // These will easily overflow 32 bits and cause strange white noise that abruptly stops intermittently (at the end of a frame).
+        // The simple fix of course is to do intermediate computations in 64 bits.
+        // These considerations are not in the original FLAC spec, but have been added to the IETF standard: https://datatracker.ietf.org/doc/html/draft-ietf-cellar-flac-03#appendix-A.3
         i64 sample = 0;
-        for (size_t t = 0; t < subframe.order; ++t) {
-            // It's really important that we compute in 64-bit land here.
-            // Even though FLAC operates at a maximum bit depth of 32 bits, modern encoders use super-large coefficients for maximum compression.
-            // These will easily overflow 32 bits and cause strange white noise that abruptly stops intermittently (at the end of a frame).
-            // The simple fix of course is to do intermediate computations in 64 bits.
-            // These considerations are not in the original FLAC spec, but have been added to the IETF standard: https://datatracker.ietf.org/doc/html/draft-ietf-cellar-flac-03#appendix-A.3
-            sample += static_cast<i64>(coefficients[t]) * static_cast<i64>(decoded[i - t - 1]);
+        for (size_t t = 0; t < subframe.order; ++t)
+            sample += static_cast<i64>(coefficients[t]) * static_cast<i64>(samples[i - t - 1]);
+        samples[i] += sample >> lpc_shift;
+    };
+
+    // Most streams have samples and coefficients that are small enough for the sum to always fit into 32 bits though,
+    // in which case four products can be computed at once.
+    auto sample_bits = subframe.bits_per_sample - subframe.wasted_bits_per_sample;
+    if (sample_bits + lpc_precision + AK::log2(subframe.order) > 32) {
+        for (size_t i = subframe.order; i < m_current_frame->sample_count; ++i)
+            predict_in_64_bits(i);
+        return decoded;
+    }
+
+    // The coefficients are reversed, so that they line up with the samples they're multiplied with, and padded with zeros
+    // in front to a multiple of four.
+    auto padded_order = align_up_to(static_cast<size_t>(subframe.order), 4);
+    Array<AK::SIMD::i32x4, 32 / 4> coefficient_vectors {};
+    for (size_t t = 0; t < subframe.order; ++t) {
+        auto index = padded_order - 1 - t;
+        coefficient_vectors[index / 4][index % 4] = coefficients[t];
+    }
+
+    // The first samples don't have enough samples before them for the padding.
+    size_t i = subframe.order;
+    for (; i < min<size_t>(padded_order, m_current_frame->sample_count); ++i)
+        predict_in_64_bits(i);
+
+    for (; i < m_current_frame->sample_count; ++i) {
+        auto const* previous_samples = &samples[i - padded_order];
+        AK::SIMD::i32x4 sum {};
+        for (size_t t = 0; t < padded_order; t += 4) {
+            AK::SIMD::i32x4 previous;
+            __builtin_memcpy(&previous, &previous_samples[t], sizeof(previous));
+            sum += coefficient_vectors[t / 4] * previous;
         }
-        decoded[i] += sample >> lpc_shift;
+        samples[i] += (sum[0] + sum[1] + sum[2] + sum[3]) >> lpc_shift;
     }
 
     return decoded;
@@ -84,6 +84,9 @@ private:
     // decode a single rice partition that has its own rice parameter
     ALWAYS_INLINE ErrorOr<Vector<i32>, LoaderError> decode_rice_partition(u8 partition_type, u32 partitions, u32 partition_index, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input);
     MaybeLoaderError load_seektable(FlacRawMetadataBlock&);
+    // Adds a seek point for the frame that's about to be read, if there's none close to it yet.
+    MaybeLoaderError remember_seekpoint(u64 sample_index);
+    MaybeLoaderError skip_samples(size_t sample_count);
     MaybeLoaderError load_picture(FlacRawMetadataBlock&);
 
     // Converters for special coding used in frame headers
@@ -8,6 +8,7 @@
 #include "MP3HuffmanTables.h"
 #include "MP3Tables.h"
 #include <AK/FixedArray.h>
+#include <AK/SIMD.h>
 #include <LibCore/File.h>
 
 namespace Audio {
@@ -75,18 +76,42 @@ MaybeLoaderError MP3LoaderPlugin::reset()
 
 MaybeLoaderError MP3LoaderPlugin::seek(int const position)
 {
-    for (auto const& seek_entry : m_seek_table) {
-        if (seek_entry.get<1>() >= position) {
-            LOADER_TRY(m_stream->seek(seek_entry.get<0>(), SeekMode::SetPosition));
-            m_loaded_samples = seek_entry.get<1>();
-            break;
-        }
+    // A frame's data can start in the frames before it (through the bit reservoir), and its first samples are overlapped
+    // with the last ones of the frame before. So decoding starts a few frames before the target, and the samples before
+    // it are thrown away.
+    auto decoding_start = max(0, position - static_cast<int>(seek_preroll_frames * MP3::frame_sample_count));
+
+    // Find the last seek table entry at or before where decoding should start.
+    size_t entries_before_start = 0;
+    size_t entries_end = m_seek_table.size();
+    while (entries_before_start < entries_end) {
+        auto middle = entries_before_start + (entries_end - entries_before_start) / 2;
+        if (m_seek_table[middle].get<1>() <= decoding_start)
+            entries_before_start = middle + 1;
+        else
+            entries_end = middle;
     }
+    if (entries_before_start == 0)
+        return LoaderError { LoaderError::Category::IO, m_loaded_samples, "No frame to seek to" };
+
+    auto const& seek_entry = m_seek_table[entries_before_start - 1];
+    LOADER_TRY(m_stream->seek(seek_entry.get<0>(), SeekMode::SetPosition));
+    m_loaded_samples = seek_entry.get<1>();
+
     m_current_frame = {};
     m_current_frame_read = 0;
     m_synthesis_buffer = {};
+    m_last_values = {};
     LOADER_TRY(m_bit_reservoir.discard(m_bit_reservoir.used_buffer_size()));
     m_bitstream->align_to_byte_boundary();
+
+    // The samples are decoded in pieces, so that this doesn't need a buffer for all of them at once.
+    while (m_loaded_samples < static_cast<size_t>(position)) {
+        auto samples_to_skip = min(static_cast<size_t>(position) - m_loaded_samples, MP3::frame_sample_count);
+        auto samples = TRY(get_more_samples(samples_to_skip));
+        if (samples.is_empty())
+            break;
+    }
     return {};
 }
 
@@ -147,12 +172,13 @@ MaybeLoaderError MP3LoaderPlugin::build_seek_table()
         if (error_or_header.is_error() || error_or_header.value().id != 1 || error_or_header.value().layer != 3) {
             continue;
         }
-        frame_count++;
-        sample_count += 1152;
-
+        // Each entry points at a frame, and the number of samples of all frames before it.
         if (frame_count % 10 == 0)
             m_seek_table.append({ frame_pos, sample_count });
 
+        frame_count++;
+        sample_count += MP3::frame_sample_count;
+
         LOADER_TRY(m_stream->seek(error_or_header.value().frame_size - 6, SeekMode::FromCurrentPosition));
 
         // TODO: This is just here to clear the bitstream buffer.
@@ -805,36 +831,32 @@ void MP3LoaderPlugin::transform_samples_to_time(Array<float, 576> const& input,
 // ISO/IEC 11172-3 (Figure A.2)
 void MP3LoaderPlugin::synthesis(Array<float, 1024>& V, Array<float, 32>& samples, Array<float, 32>& result)
 {
-    for (size_t i = 1023; i >= 64; i--) {
-        V[i] = V[i - 64];
-    }
-
-    for (size_t i = 0; i < 64; i++) {
-        V[i] = 0;
-        for (size_t k = 0; k < 32; k++) {
-            float const N = MP3::Tables::SynthesisSubbandFilterCoefficients[i][k];
-            V[i] += N * samples[k];
-        }
-    }
+    using AK::SIMD::f32x4;
+    auto load4 = [](float const* values) {
+        f32x4 vector;
+        __builtin_memcpy(&vector, values, sizeof(vector));
+        return vector;
+    };
 
-    Array<float, 512> U;
-    for (size_t i = 0; i < 8; i++) {
-        for (size_t j = 0; j < 32; j++) {
-            U[i * 64 + j] = V[i * 128 + j];
-            U[i * 64 + 32 + j] = V[i * 128 + 96 + j];
-        }
-    }
+    __builtin_memmove(V.data() + 64, V.data(), (V.size() - 64) * sizeof(float));
 
-    Array<float, 512> W;
-    for (size_t i = 0; i < 512; i++) {
-        W[i] = U[i] * MP3::Tables::WindowSynthesis[i];
+    for (size_t i = 0; i < 64; i++) {
+        auto const& N = MP3::Tables::SynthesisSubbandFilterCoefficients[i];
+        f32x4 sum {};
+        for (size_t k = 0; k < 32; k += 4)
+            sum += load4(&N[k]) * load4(&samples[k]);
+        V[i] = sum[0] + sum[1] + sum[2] + sum[3];
     }
 
-    for (size_t j = 0; j < 32; j++) {
-        result[j] = 0;
-        for (size_t k = 0; k < 16; k++) {
-            result[j] += W[j + 32 * k];
+    // The specification builds a vector U of 512 values from V, windows it into W, and sums 16 values of W into each
+    // output sample. Doing all of that at once spares the copies.
+    for (size_t j = 0; j < 32; j += 4) {
+        f32x4 sum {};
+        for (size_t i = 0; i < 8; i++) {
+            sum += load4(&V[i * 128 + j]) * load4(&MP3::Tables::WindowSynthesis[i * 64 + j]);
+            sum += load4(&V[i * 128 + 96 + j]) * load4(&MP3::Tables::WindowSynthesis[i * 64 + 32 + j]);
         }
+        __builtin_memcpy(&result[j], &sum, sizeof(sum));
     }
 }
 
@@ -12,6 +12,9 @@
 
 namespace Audio::MP3 {
 
+// Every MPEG-1 layer 3 frame has two granules of 576 samples.
+constexpr size_t frame_sample_count = 1152;
+
 enum class Mode {
     Stereo = 0,
     JointStereo = 1,
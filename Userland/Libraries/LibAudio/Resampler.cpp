@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Math.h>
+#include <AK/SIMD.h>
+#include <LibAudio/Resampler.h>
+
+namespace Audio {
+
+using AK::SIMD::f32x4;
+
+// The number of taps of the filter when upsampling. When downsampling, the filter's cutoff is lowered, and the filter
+// gets longer by the same factor, so that its transition band stays as steep.
+static constexpr size_t BASE_TAP_COUNT = 32;
+static constexpr size_t MAX_TAP_COUNT = 256;
+// For rates that don't have a small common factor, the output samples are rounded to the nearest of this many
+// positions between two input samples.
+static constexpr size_t MAX_PHASE_COUNT = 256;
+// Where the filter starts cutting off, relative to the lower of the two Nyquist frequencies.
+static constexpr double CUTOFF = 0.95;
+
+// Two stereo samples fit into one vector.
+static_assert(sizeof(Sample) == 2 * sizeof(float));
+
+static ALWAYS_INLINE f32x4 load_unaligned(void const* data)
+{
+    f32x4 vector;
+    __builtin_memcpy(&vector, data, sizeof(vector));
+    return vector;
+}
+
+static u64 greatest_common_divisor(u64 a, u64 b)
+{
+    while (b != 0) {
+        auto remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+    return a;
+}
+
+ErrorOr<SincResampler> SincResampler::try_create(u32 source, u32 target)
+{
+    SincResampler resampler { source, target };
+    TRY(resampler.compute_filter());
+    resampler.reset();
+    return resampler;
+}
+
+SincResampler::SincResampler(u32 source, u32 target)
+    : m_source(source)
+    , m_target(target)
+{
+    VERIFY(source > 0);
+    VERIFY(target > 0);
+
+    auto divisor = greatest_common_divisor(source, target);
+    m_upsampling_factor = target / divisor;
+    m_downsampling_factor = source / divisor;
+}
+
+ErrorOr<void> SincResampler::compute_filter()
+{
+    // The filter's cutoff is relative to the input's Nyquist frequency.
+    auto scale = min(1.0, static_cast<double>(m_target) / static_cast<double>(m_source));
+    auto cutoff = CUTOFF * scale;
+
+    m_tap_count = min(MAX_TAP_COUNT, static_cast<size_t>(AK::ceil(BASE_TAP_COUNT / scale)));
+    // Two taps are summed at a time.
+    m_tap_count = align_up_to(m_tap_count, 2);
+    m_phase_count = min<u64>(m_upsampling_factor, MAX_PHASE_COUNT);
+
+    TRY(m_coefficients.try_resize(m_phase_count * m_tap_count * 2));
+
+    auto half_length = static_cast<double>(m_tap_count) / 2;
+    for (size_t phase = 0; phase < m_phase_count; ++phase) {
+        auto offset = static_cast<double>(phase) / static_cast<double>(m_phase_count);
+        auto* coefficients = &m_coefficients[phase * m_tap_count * 2];
+
+        double sum = 0;
+        for (size_t tap = 0; tap < m_tap_count; ++tap) {
+            // How far the input sample of this tap is from the output sample.
+            auto distance = static_cast<double>(tap) - (half_length - 1) - offset;
+
+            auto x = AK::Pi<double> * cutoff * distance;
+            auto sinc = x == 0 ? 1.0 : AK::sin(x) / x;
+            // A Blackman window, centered on the output sample.
+            auto window_position = AK::Pi<double> * distance / half_length;
+            auto window = 0.42 + 0.5 * AK::cos(window_position) + 0.08 * AK::cos(2 * window_position);
+
+            auto coefficient = sinc * max(window, 0.0);
+            coefficients[tap * 2] = static_cast<float>(coefficient);
+            sum += coefficient;
+        }
+
+        // Each phase passes a constant signal through unchanged.
+        for (size_t tap = 0; tap < m_tap_count; ++tap) {
+            coefficients[tap * 2] = static_cast<float>(coefficients[tap * 2] / sum);
+            coefficients[tap * 2 + 1] = coefficients[tap * 2];
+        }
+    }
+
+    return {};
+}
+
+void SincResampler::reset()
+{
+    // The output starts at the first input sample, with silence before it.
+    m_input.clear_with_capacity();
+    m_input.resize(history_size());
+    m_position = history_size();
+    m_phase = 0;
+}
+
+ErrorOr<Vector<Sample>> SincResampler::try_resample(ReadonlySpan<Sample> samples)
+{
+    Vector<Sample> resampled;
+    TRY(try_resample_into_end(resampled, samples));
+    return resampled;
+}
+
+ErrorOr<void> SincResampler::try_resample_into_end(Vector<Sample>& destination, ReadonlySpan<Sample> samples)
+{
+    TRY(m_input.try_append(samples.data(), samples.size()));
+    TRY(destination.try_ensure_capacity(destination.size() + samples.size() * m_upsampling_factor / m_downsampling_factor + 1));
+
+    auto const taps_after_position = m_tap_count / 2;
+    while (m_position + taps_after_position < m_input.size()) {
+        auto phase = m_phase_count == m_upsampling_factor ? m_phase : m_phase * m_phase_count / m_upsampling_factor;
+        auto const* coefficients = &m_coefficients[phase * m_tap_count * 2];
+        auto const* input = &m_input[m_position - history_size()];
+
+        // Each vector holds the left and right channels of two taps.
+        f32x4 sum {};
+        for (size_t tap = 0; tap < m_tap_count; tap += 2)
+            sum += load_unaligned(&input[tap]) * load_unaligned(&coefficients[tap * 2]);
+        TRY(destination.try_append(Sample { sum[0] + sum[2], sum[1] + sum[3] }));
+
+        m_phase += m_downsampling_factor;
+        m_position += m_phase / m_upsampling_factor;
+        m_phase %= m_upsampling_factor;
+    }
+
+    // Only the samples that the next output samples still need are kept.
+    auto used_samples = min(m_position - history_size(), m_input.size());
+    m_input.remove(0, used_samples);
+    m_position -= used_samples;
+    return {};
+}
+
+}
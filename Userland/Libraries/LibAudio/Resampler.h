@@ -7,8 +7,10 @@
 #pragma once
 
 #include <AK/Concepts.h>
+#include <AK/Span.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
+#include <LibAudio/Sample.h>
 
 namespace Audio {
 
@@ -97,4 +99,48 @@ private:
     SampleType m_last_sample_r {};
 };
 
+// A windowed-sinc resampler for stereo streams. Each output sample is a weighted sum of the input samples around it,
+// with the weights of a low-pass filter that depend on where the output sample falls between two input samples. A
+// set of weights is computed up front for each of those positions (the "phases" of the filter), and both channels are
+// summed at once with SIMD.
+//
+// Unlike ResampleHelper, this keeps the last few input samples around between calls, so that a stream can be
+// resampled one piece at a time without clicks in between. The output lags behind the input by half the filter's
+// length; call reset() whenever the stream jumps.
+class SincResampler {
+public:
+    static ErrorOr<SincResampler> try_create(u32 source, u32 target);
+
+    ErrorOr<Vector<Sample>> try_resample(ReadonlySpan<Sample>);
+    ErrorOr<void> try_resample_into_end(Vector<Sample>& destination, ReadonlySpan<Sample>);
+
+    void reset();
+
+    u32 source() const { return m_source; }
+    u32 target() const { return m_target; }
+
+private:
+    SincResampler(u32 source, u32 target);
+
+    ErrorOr<void> compute_filter();
+    size_t history_size() const { return m_tap_count / 2 - 1; }
+
+    u32 m_source { 0 };
+    u32 m_target { 0 };
+    // The ratio of the rates: every m_upsampling_factor output samples take up m_downsampling_factor input samples.
+    u64 m_upsampling_factor { 1 };
+    u64 m_downsampling_factor { 1 };
+
+    size_t m_tap_count { 0 };
+    size_t m_phase_count { 0 };
+    // For each phase, the weight of each tap twice, once for every channel.
+    Vector<float> m_coefficients;
+
+    // The input samples that haven't been used up yet, starting with the ones that come before the next output sample.
+    Vector<Sample> m_input;
+    // The next output sample lies m_phase / m_upsampling_factor input samples after m_input[m_position].
+    size_t m_position { 0 };
+    u64 m_phase { 0 };
+};
+
 }
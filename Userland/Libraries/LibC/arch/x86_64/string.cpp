@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/SIMD.h>
+#include <AK/Types.h>
+#include <cpuid.h>
+#include <string.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+extern "C" {
+
+// These are the SSE2 implementations from ../../string.cpp.
+extern size_t strlen_generic(char const*);
+extern void* memchr_generic(void const*, int, size_t);
+
+// Bit 5 of ebx in cpuid[eax = 7] indicates support for AVX2.
+constexpr u32 cpuid_7_ebx_bit_avx2 = 1 << 5;
+// Bit 27 of ecx in cpuid[eax = 1] indicates that the OS saves the extended register state with XSAVE.
+constexpr u32 cpuid_1_ecx_bit_osxsave = 1 << 27;
+// Bits 1 and 2 of XCR0 indicate that the SSE and AVX register state is enabled.
+constexpr u32 xcr0_sse_and_avx_state = (1 << 1) | (1 << 2);
+
+namespace {
+
+using ByteVector = AK::SIMD::u8x32;
+using AlignedByteVector [[gnu::may_alias]] = AK::SIMD::u8x32;
+
+[[gnu::target("avx2")]] ALWAYS_INLINE u32 matching_bytes(ByteVector bytes, ByteVector needles)
+{
+    return static_cast<u32>(__builtin_ia32_pmovmskb256((AK::SIMD::c8x32)(bytes == needles)));
+}
+
+[[gnu::target("avx2")]] size_t strlen_avx2(char const* str)
+{
+    auto const* bytes = reinterpret_cast<u8 const*>(str);
+    // NOTE: Aligned loads never cross a page boundary, so reading past either end of the string can't fault.
+    auto const* block = reinterpret_cast<u8 const*>(reinterpret_cast<FlatPtr>(bytes) & ~(sizeof(ByteVector) - 1));
+    ByteVector zeroes {};
+    u32 first_mask = matching_bytes(*reinterpret_cast<AlignedByteVector const*>(block), zeroes) >> (bytes - block);
+    if (first_mask)
+        return count_trailing_zeroes(first_mask);
+    for (;;) {
+        block += sizeof(ByteVector);
+        if (auto mask = matching_bytes(*reinterpret_cast<AlignedByteVector const*>(block), zeroes))
+            return (block - bytes) + count_trailing_zeroes(mask);
+    }
+}
+
+[[gnu::target("avx2")]] void* memchr_avx2(void const* ptr, int c, size_t size)
+{
+    auto const* bytes = static_cast<u8 const*>(ptr);
+    auto needles = ByteVector {} + static_cast<u8>(c);
+    size_t i = 0;
+    for (; i + sizeof(ByteVector) <= size; i += sizeof(ByteVector)) {
+        ByteVector vector;
+        __builtin_memcpy(&vector, bytes + i, sizeof(vector));
+        if (auto mask = matching_bytes(vector, needles))
+            return const_cast<u8*>(bytes + i + count_trailing_zeroes(mask));
+    }
+    return memchr_generic(bytes + i, c, size - i);
+}
+
+bool cpu_supports_avx2()
+{
+    if (__get_cpuid_max(0, nullptr) < 7)
+        return false;
+
+    u32 eax, ebx, ecx, edx;
+    __cpuid(1, eax, ebx, ecx, edx);
+    if (!(ecx & cpuid_1_ecx_bit_osxsave))
+        return false;
+
+    // The kernel has to have enabled saving both the SSE and AVX register state.
+    u32 xcr0_low, xcr0_high;
+    asm volatile("xgetbv"
+                 : "=a"(xcr0_low), "=d"(xcr0_high)
+                 : "c"(0));
+    if ((xcr0_low & xcr0_sse_and_avx_state) != xcr0_sse_and_avx_state)
+        return false;
+
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return ebx & cpuid_7_ebx_bit_avx2;
+}
+
+[[gnu::used]] decltype(&strlen) resolve_strlen()
+{
+    if (cpu_supports_avx2())
+        return strlen_avx2;
+    return strlen_generic;
+}
+
+[[gnu::used]] decltype(&memchr) resolve_memchr()
+{
+    if (cpu_supports_avx2())
+        return memchr_avx2;
+    return memchr_generic;
+}
+
+}
+
+#if !defined(AK_COMPILER_CLANG) && !defined(_DYNAMIC_LOADER)
+[[gnu::ifunc("resolve_strlen")]] size_t strlen(char const*);
+[[gnu::ifunc("resolve_memchr")]] void* memchr(void const*, int, size_t);
+#else
+// DynamicLoader can't self-relocate IFUNCs, see memset.cpp.
+size_t strlen(char const* str)
+{
+    static decltype(&strlen) s_impl = nullptr;
+    if (s_impl == nullptr)
+        s_impl = resolve_strlen();
+
+    return s_impl(str);
+}
+
+void* memchr(void const* ptr, int c, size_t size)
+{
+    static decltype(&memchr) s_impl = nullptr;
+    if (s_impl == nullptr)
+        s_impl = resolve_memchr();
+
+    return s_impl(ptr, c, size);
+}
+#endif
+}
+
+#pragma GCC diagnostic pop
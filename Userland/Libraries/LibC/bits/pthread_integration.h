@@ -19,6 +19,7 @@ void __pthread_fork_atfork_register_parent(void (*)(void));
 void __pthread_fork_atfork_register_child(void (*)(void));
 
 int __pthread_mutex_lock_pessimistic_np(pthread_mutex_t*);
+void __pthread_mutex_did_requeue_waiters_np(pthread_mutex_t*);
 
 typedef void (*KeyDestructor)(void*);
 
@@ -55,6 +55,7 @@ static bool s_scrub_malloc = true;
 static bool s_scrub_free = true;
 static bool s_profiling = false;
 static bool s_in_userspace_emulator = false;
+static bool s_use_thread_cache = true;
 
 ALWAYS_INLINE static void ue_notify_malloc(void const* ptr, size_t size)
 {
@@ -115,6 +116,10 @@ struct MallocStats {
     size_t number_of_hot_keeps;
     size_t number_of_cold_keeps;
     size_t number_of_frees;
+
+    size_t number_of_thread_cache_hits;
+    size_t number_of_thread_cache_keeps;
+    size_t number_of_thread_cache_flushes;
 };
 static MallocStats g_malloc_stats = {};
 
@@ -291,6 +296,35 @@ enum class CallerWillInitializeMemory {
 
 #ifndef NO_TLS
 __thread bool s_allocation_enabled = true;
+
+// Every thread keeps a small, bounded cache of freed chunks for the smaller size classes.
+// This allows malloc() and free() of small sizes to skip s_malloc_mutex entirely.
+// The cached chunks still count as used by their ChunkedBlock, so the blocks stay alive.
+constexpr size_t number_of_thread_cached_size_classes = 7; // 16 to 1008 bytes
+constexpr size_t number_of_chunks_to_cache_per_size_class = 16;
+static_assert(number_of_thread_cached_size_classes <= num_size_classes);
+
+struct ThreadCacheBin {
+    size_t count { 0 };
+    void* chunks[number_of_chunks_to_cache_per_size_class];
+};
+
+struct ThreadCache {
+    bool is_registered { false };
+    ThreadCacheBin bins[number_of_thread_cached_size_classes];
+};
+
+static __thread ThreadCache s_thread_cache;
+static pthread_key_t s_thread_cache_key;
+
+static Optional<size_t> thread_cache_bin_index_for_size(size_t chunk_size)
+{
+    for (size_t i = 0; i < number_of_thread_cached_size_classes; ++i) {
+        if (chunk_size == size_classes[i])
+            return i;
+    }
+    return {};
+}
 #endif
 
 static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializeMemory caller_will_initialize_memory)
@@ -321,6 +355,21 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
     size_t good_size;
     auto* allocator = allocator_for_size(size, good_size, align);
 
+#ifndef NO_TLS
+    if (allocator && align <= 16 && s_use_thread_cache) {
+        size_t bin_index = allocator - allocators();
+        if (bin_index < number_of_thread_cached_size_classes && s_thread_cache.bins[bin_index].count) {
+            g_malloc_stats.number_of_thread_cache_hits++;
+            auto& bin = s_thread_cache.bins[bin_index];
+            void* ptr = bin.chunks[--bin.count];
+            if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+                memset(ptr, MALLOC_SCRUB_BYTE, good_size);
+            ue_notify_malloc(ptr, size);
+            return ptr;
+        }
+    }
+#endif
+
     PthreadMutexLocker locker(s_malloc_mutex);
 
     if (!allocator) {
@@ -443,6 +492,99 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
     return ptr;
 }
 
+// Must be called with s_malloc_mutex held.
+static void release_chunk(ChunkedBlock* block, void* ptr)
+{
+    auto* entry = (FreelistEntry*)ptr;
+    entry->next = block->m_freelist;
+    block->m_freelist = entry;
+
+    if (block->is_full()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, good_size);
+        g_malloc_stats.number_of_freed_full_blocks++;
+        allocator->full_blocks.remove(*block);
+        allocator->usable_blocks.prepend(*block);
+    }
+
+    ++block->m_free_chunks;
+
+    if (!block->used_chunks()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
+            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
+            g_malloc_stats.number_of_hot_keeps++;
+            allocator->usable_blocks.remove(*block);
+            s_hot_empty_blocks[s_hot_empty_block_count++] = block;
+            return;
+        }
+        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
+            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
+            g_malloc_stats.number_of_cold_keeps++;
+            allocator->usable_blocks.remove(*block);
+            s_cold_empty_blocks[s_cold_empty_block_count++] = block;
+            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
+            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
+            return;
+        }
+        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
+        g_malloc_stats.number_of_frees++;
+        allocator->usable_blocks.remove(*block);
+        --allocator->block_count;
+        os_free(block, ChunkedBlock::block_size);
+    }
+}
+
+#ifndef NO_TLS
+// Must be called with s_malloc_mutex held.
+static void flush_thread_cache_bin(ThreadCacheBin& bin, size_t chunks_to_keep)
+{
+    g_malloc_stats.number_of_thread_cache_flushes++;
+    while (bin.count > chunks_to_keep) {
+        void* ptr = bin.chunks[--bin.count];
+        release_chunk((ChunkedBlock*)((FlatPtr)ptr & ChunkedBlock::block_mask), ptr);
+    }
+}
+
+static void flush_thread_cache(void*)
+{
+    PthreadMutexLocker locker(s_malloc_mutex);
+    for (auto& bin : s_thread_cache.bins)
+        flush_thread_cache_bin(bin, 0);
+    s_thread_cache.is_registered = false;
+}
+
+static bool try_keep_in_thread_cache(ChunkedBlock* block, void* ptr)
+{
+    if (!s_use_thread_cache)
+        return false;
+    auto bin_index = thread_cache_bin_index_for_size(block->m_size);
+    if (!bin_index.has_value())
+        return false;
+
+    if (!s_thread_cache.is_registered) {
+        // The key's destructor hands the cached chunks back when this thread exits.
+        s_thread_cache.is_registered = true;
+        pthread_setspecific(s_thread_cache_key, &s_thread_cache);
+    }
+
+    if (s_scrub_free)
+        memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
+
+    auto& bin = s_thread_cache.bins[*bin_index];
+    if (bin.count == number_of_chunks_to_cache_per_size_class) {
+        // Hand back half of the bin at once, so we don't have to take the lock on every free.
+        PthreadMutexLocker locker(s_malloc_mutex);
+        flush_thread_cache_bin(bin, number_of_chunks_to_cache_per_size_class / 2);
+    }
+    g_malloc_stats.number_of_thread_cache_keeps++;
+    bin.chunks[bin.count++] = ptr;
+    return true;
+}
+#endif
+
 static void free_impl(void* ptr)
 {
 #ifndef NO_TLS
@@ -459,6 +601,11 @@ static void free_impl(void* ptr)
     void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
     size_t magic = *(size_t*)block_base;
 
+#ifndef NO_TLS
+    if (magic == MAGIC_PAGE_HEADER && try_keep_in_thread_cache((ChunkedBlock*)block_base, ptr))
+        return;
+#endif
+
     PthreadMutexLocker locker(s_malloc_mutex);
 
     if (magic == MAGIC_BIGALLOC_HEADER) {
@@ -494,46 +641,7 @@ static void free_impl(void* ptr)
     if (s_scrub_free)
         memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
 
-    auto* entry = (FreelistEntry*)ptr;
-    entry->next = block->m_freelist;
-    block->m_freelist = entry;
-
-    if (block->is_full()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, good_size);
-        g_malloc_stats.number_of_freed_full_blocks++;
-        allocator->full_blocks.remove(*block);
-        allocator->usable_blocks.prepend(*block);
-    }
-
-    ++block->m_free_chunks;
-
-    if (!block->used_chunks()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
-            g_malloc_stats.number_of_hot_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_hot_empty_blocks[s_hot_empty_block_count++] = block;
-            return;
-        }
-        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
-            g_malloc_stats.number_of_cold_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_cold_empty_blocks[s_cold_empty_block_count++] = block;
-            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
-            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
-            return;
-        }
-        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
-        g_malloc_stats.number_of_frees++;
-        allocator->usable_blocks.remove(*block);
-        --allocator->block_count;
-        os_free(block, ChunkedBlock::block_size);
-    }
+    release_chunk(block, ptr);
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/malloc.html
@@ -673,6 +781,17 @@ void __malloc_init()
         s_log_malloc = true;
     if (secure_getenv("LIBC_PROFILE_MALLOC"))
         s_profiling = true;
+    if (secure_getenv("LIBC_NO_THREAD_CACHE_MALLOC"))
+        s_use_thread_cache = false;
+
+    // UE keeps track of every chunk on its own, so don't hide freed chunks from it.
+    if (s_in_userspace_emulator)
+        s_use_thread_cache = false;
+
+#ifndef NO_TLS
+    if (s_use_thread_cache && pthread_key_create(&s_thread_cache_key, flush_thread_cache) != 0)
+        s_use_thread_cache = false;
+#endif
 
     for (size_t i = 0; i < num_size_classes; ++i) {
         new (&allocators()[i]) Allocator();
@@ -705,5 +824,9 @@ void serenity_dump_malloc_stats()
     dbgln("number of hot keeps: {}", g_malloc_stats.number_of_hot_keeps);
     dbgln("number of cold keeps: {}", g_malloc_stats.number_of_cold_keeps);
     dbgln("number of frees: {}", g_malloc_stats.number_of_frees);
+    dbgln();
+    dbgln("thread cache hits: {}", g_malloc_stats.number_of_thread_cache_hits);
+    dbgln("thread cache keeps: {}", g_malloc_stats.number_of_thread_cache_keeps);
+    dbgln("thread cache flushes: {}", g_malloc_stats.number_of_thread_cache_flushes);
 }
 }
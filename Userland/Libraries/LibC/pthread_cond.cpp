@@ -102,15 +102,38 @@ int pthread_cond_timedwait(pthread_cond_t* cond, pthread_mutex_t* mutex, const s
     u32 value = AK::atomic_fetch_or(&cond->value, NEED_TO_WAKE_ONE | NEED_TO_WAKE_ALL, AK::memory_order_release) | NEED_TO_WAKE_ONE | NEED_TO_WAKE_ALL;
     pthread_mutex_unlock(mutex);
     int rc = futex_wait(&cond->value, value, abstime, cond->clockid, false);
-    if (rc < 0 && errno != EAGAIN)
-        return errno;
+    int saved_errno = errno;
 
-    // We might have been re-queued onto the mutex while we were sleeping. Take
-    // the pessimistic locking path.
+    // We have most likely been re-queued onto the mutex while we were sleeping,
+    // and woken up by whoever unlocked it. Take the pessimistic locking path.
+    // NOTE: We have to hold the mutex again when returning, even if we timed out.
     __pthread_mutex_lock_pessimistic_np(mutex);
+    if (rc < 0 && saved_errno != EAGAIN)
+        return saved_errno;
     return 0;
 }
 
+// Moves up to count waiters over to the mutex without waking them up. They get woken up one at a time when the mutex
+// is unlocked, rather than having all of them wake up at once just to go back to sleep waiting for the mutex.
+// Returns the number of waiters that were moved.
+static int requeue_waiters_onto_mutex(pthread_cond_t* cond, u32 count)
+{
+    pthread_mutex_t* mutex = AK::atomic_load(&cond->mutex, AK::memory_order_relaxed);
+    VERIFY(mutex);
+
+    int rc;
+    do {
+        // If the value changes under us, someone started waiting or signaled the variable in the meantime, try again.
+        u32 value = AK::atomic_load(&cond->value, AK::memory_order_relaxed);
+        rc = futex(&cond->value, FUTEX_CMP_REQUEUE | FUTEX_PRIVATE_FLAG, 0, reinterpret_cast<timespec const*>(static_cast<uintptr_t>(count)), &mutex->lock, value);
+    } while (rc < 0 && errno == EAGAIN);
+    VERIFY(rc >= 0);
+
+    if (rc > 0)
+        __pthread_mutex_did_requeue_waiters_np(mutex);
+    return rc;
+}
+
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_cond_signal.html
 int pthread_cond_signal(pthread_cond_t* cond)
 {
@@ -132,8 +155,7 @@ int pthread_cond_signal(pthread_cond_t* cond)
     if (!(value & NEED_TO_WAKE_ONE)) [[likely]]
         return 0;
     // ...try to wake someone...
-    int rc = futex_wake(&cond->value, 1, false);
-    VERIFY(rc >= 0);
+    int rc = requeue_waiters_onto_mutex(cond, 1);
     // ...and if we have woken someone, put the flag back.
     if (rc > 0)
         AK::atomic_fetch_or(&cond->value, NEED_TO_WAKE_ONE, AK::memory_order_relaxed);
@@ -152,10 +174,6 @@ int pthread_cond_broadcast(pthread_cond_t* cond)
 
     AK::atomic_fetch_and(&cond->value, ~(NEED_TO_WAKE_ONE | NEED_TO_WAKE_ALL), AK::memory_order_acquire);
 
-    pthread_mutex_t* mutex = AK::atomic_load(&cond->mutex, AK::memory_order_relaxed);
-    VERIFY(mutex);
-
-    int rc = futex(&cond->value, FUTEX_REQUEUE | FUTEX_PRIVATE_FLAG, 1, nullptr, &mutex->lock, INT_MAX);
-    VERIFY(rc >= 0);
+    requeue_waiters_onto_mutex(cond, INT_MAX);
     return 0;
 }
@@ -182,6 +182,26 @@ int __pthread_mutex_lock_pessimistic_np(pthread_mutex_t* mutex)
     return 0;
 }
 
+void __pthread_mutex_did_requeue_waiters_np(pthread_mutex_t* mutex)
+{
+    // Threads have been moved onto the mutex's futex without being woken up, which the mutex itself doesn't know
+    // about. Make sure one of them gets woken up: either the mutex is currently held, in which case we make the
+    // owner wake someone up when it unlocks it, or it isn't, in which case we have to do that ourselves.
+    // The woken up thread takes the pessimistic path, so it goes on to wake up the next one, and so on.
+    u32 value = AK::atomic_load(&mutex->lock, AK::memory_order_relaxed);
+    for (;;) {
+        if (value == MUTEX_LOCKED_NEED_TO_WAKE)
+            return;
+        if (value == MUTEX_UNLOCKED) {
+            int rc = futex_wake(&mutex->lock, 1, false);
+            VERIFY(rc >= 0);
+            return;
+        }
+        if (AK::atomic_compare_exchange_strong(&mutex->lock, value, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_relaxed))
+            return;
+    }
+}
+
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_mutex_unlock.html
 int pthread_mutex_unlock(pthread_mutex_t* mutex)
 {
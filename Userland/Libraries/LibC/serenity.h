@@ -48,6 +48,12 @@ static ALWAYS_INLINE int futex_wake(uint32_t* userspace_address, uint32_t count,
     return futex(userspace_address, FUTEX_WAKE | (process_shared ? 0 : FUTEX_PRIVATE_FLAG), count, NULL, NULL, 0);
 }
 
+// Waits until any of the futexes is woken up, and returns its index. timeout is relative, like for FUTEX_WAIT.
+static ALWAYS_INLINE int futex_wait_multiple(struct futex_wait_block* wait_blocks, uint32_t count, const struct timespec* timeout, int process_shared)
+{
+    return futex((uint32_t*)wait_blocks, FUTEX_WAIT_MULTIPLE | (process_shared ? 0 : FUTEX_PRIVATE_FLAG), count, timeout, NULL, 0);
+}
+
 #ifdef ALWAYS_INLINE_SERENITY_H
 #    undef ALWAYS_INLINE
 #endif
@@ -61,6 +67,9 @@ int get_stack_bounds(uintptr_t* user_stack_base, size_t* user_stack_size);
 
 int anon_create(size_t size, int options);
 
+int io_ring_create(unsigned entries, int options);
+int io_ring_enter(int fd, unsigned to_submit);
+
 int serenity_readlink(char const* path, size_t path_length, char* buffer, size_t buffer_size);
 
 int getkeymap(char* name_buffer, size_t name_buffer_size, uint32_t* map, uint32_t* shift_map, uint32_t* alt_map, uint32_t* altgr_map, uint32_t* shift_altgr_map);
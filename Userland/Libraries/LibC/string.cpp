@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteSearch.h>
 #include <AK/Format.h>
 #include <AK/MemMem.h>
 #include <AK/Memory.h>
@@ -50,12 +51,14 @@ size_t strcspn(char const* s, char const* reject)
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strlen.html
+// For x86-64, this picks an AVX2 implementation at runtime if possible, see ./arch/x86_64/string.cpp
+#if ARCH(X86_64)
+size_t strlen_generic(char const* str)
+#else
 size_t strlen(char const* str)
+#endif
 {
-    size_t len = 0;
-    while (*(str++))
-        ++len;
-    return len;
+    return AK::find_null_terminator(str);
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strnlen.html
@@ -115,11 +118,10 @@ int memcmp(void const* v1, void const* v2, size_t n)
 {
     auto* s1 = (uint8_t const*)v1;
     auto* s2 = (uint8_t const*)v2;
-    while (n-- > 0) {
-        if (*s1++ != *s2++)
-            return s1[-1] < s2[-1] ? -1 : 1;
-    }
-    return 0;
+    auto index = AK::find_first_mismatch(s1, s2, n);
+    if (!index.has_value())
+        return 0;
+    return s1[*index] < s2[*index] ? -1 : 1;
 }
 
 int timingsafe_memcmp(void const* b1, void const* b2, size_t len)
@@ -216,12 +218,10 @@ size_t strlcpy(char* dest, char const* src, size_t n)
 char* strchr(char const* str, int c)
 {
     char ch = c;
-    for (;; ++str) {
-        if (*str == ch)
-            return const_cast<char*>(str);
-        if (!*str)
-            return nullptr;
-    }
+    auto const* result = AK::find_byte_or_null_terminator(str, ch);
+    if (*result != ch)
+        return nullptr;
+    return const_cast<char*>(result);
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699959399/functions/index.html
@@ -232,23 +232,22 @@ char* index(char const* str, int c)
 
 char* strchrnul(char const* str, int c)
 {
-    char ch = c;
-    for (;; ++str) {
-        if (*str == ch || !*str)
-            return const_cast<char*>(str);
-    }
+    return const_cast<char*>(AK::find_byte_or_null_terminator(str, c));
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/memchr.html
+// For x86-64, this picks an AVX2 implementation at runtime if possible, see ./arch/x86_64/string.cpp
+#if ARCH(X86_64)
+void* memchr_generic(void const* ptr, int c, size_t size)
+#else
 void* memchr(void const* ptr, int c, size_t size)
+#endif
 {
-    char ch = c;
-    auto* cptr = (char const*)ptr;
-    for (size_t i = 0; i < size; ++i) {
-        if (cptr[i] == ch)
-            return const_cast<char*>(cptr + i);
-    }
-    return nullptr;
+    auto* cptr = (u8 const*)ptr;
+    auto index = AK::find_byte({ cptr, size }, c);
+    if (!index.has_value())
+        return nullptr;
+    return const_cast<u8*>(cptr + *index);
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/strrchr.html
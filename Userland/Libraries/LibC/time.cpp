@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
 #include <AK/DateConstants.h>
 #include <AK/DeprecatedString.h>
 #include <AK/StringBuilder.h>
@@ -34,6 +35,8 @@ long altzone = 0;
 char* tzname[2] = { const_cast<char*>(__utc), const_cast<char*>(__utc) };
 int daylight = 0;
 
+static bool time_page_has_precise_clocks();
+
 time_t time(time_t* tloc)
 {
     struct timeval tv;
@@ -59,7 +62,7 @@ int gettimeofday(struct timeval* __restrict__ tv, void* __restrict__)
     }
 
     struct timespec ts = {};
-    if (clock_gettime(CLOCK_REALTIME_COARSE, &ts) < 0)
+    if (clock_gettime(time_page_has_precise_clocks() ? CLOCK_REALTIME : CLOCK_REALTIME_COARSE, &ts) < 0)
         return -1;
 
     TIMESPEC_TO_TIMEVAL(tv, &ts);
@@ -447,8 +450,71 @@ static Kernel::TimePage* get_kernel_time_page()
     return s_kernel_time_page;
 }
 
+static bool read_precise_clock_from_time_page([[maybe_unused]] Kernel::TimePage& time_page, [[maybe_unused]] clockid_t clock_id, [[maybe_unused]] struct timespec* ts)
+{
+#if ARCH(X86_64)
+    u32 update_iteration;
+    u64 tsc_base;
+    u64 tsc_to_ns_multiplier;
+    struct timespec base_time;
+    u64 tsc;
+    do {
+        update_iteration = AK::atomic_load(&time_page.update1, AK::memory_order_acquire);
+        tsc_base = time_page.tsc_base;
+        tsc_to_ns_multiplier = time_page.tsc_to_ns_multiplier;
+        base_time = time_page.clocks[clock_id];
+        tsc = __builtin_ia32_rdtsc();
+    } while (update_iteration != AK::atomic_load(&time_page.update2, AK::memory_order_acquire));
+
+    if (tsc_to_ns_multiplier == 0)
+        return false;
+
+    u64 elapsed_ns = 0;
+    if (tsc > tsc_base)
+        elapsed_ns = static_cast<u64>((static_cast<unsigned __int128>(tsc - tsc_base) * tsc_to_ns_multiplier) >> 32);
+    auto time = Time::from_timespec(base_time) + Time::from_nanoseconds(static_cast<i64>(elapsed_ns));
+
+    if (clock_id != CLOCK_REALTIME) {
+        // The calibration is never perfect, so don't let the extrapolated time run backwards
+        // when the kernel publishes a new base that is slightly behind our last reading.
+        static Atomic<i64> s_last_monotonic_ns { 0 };
+        auto now_ns = time.to_nanoseconds();
+        auto last_ns = s_last_monotonic_ns.load(AK::memory_order_relaxed);
+        while (now_ns > last_ns && !s_last_monotonic_ns.compare_exchange_strong(last_ns, now_ns, AK::memory_order_relaxed)) {
+        }
+        if (now_ns < last_ns)
+            time = Time::from_nanoseconds(last_ns);
+    }
+
+    *ts = time.to_timespec();
+    return true;
+#else
+    return false;
+#endif
+}
+
+static bool time_page_has_precise_clocks()
+{
+    auto* kernel_time_page = get_kernel_time_page();
+    if (!kernel_time_page)
+        return false;
+    return AK::atomic_load(&kernel_time_page->tsc_to_ns_multiplier, AK::memory_order_relaxed) != 0;
+}
+
 int clock_gettime(clockid_t clock_id, struct timespec* ts)
 {
+    if (Kernel::time_page_supports_precise(clock_id)) {
+        if (!ts) {
+            errno = EFAULT;
+            return -1;
+        }
+
+        if (auto* kernel_time_page = get_kernel_time_page()) {
+            if (read_precise_clock_from_time_page(*kernel_time_page, clock_id, ts))
+                return 0;
+        }
+    }
+
     if (Kernel::time_page_supports(clock_id)) {
         if (!ts) {
             errno = EFAULT;
@@ -30,6 +30,9 @@ public:
     virtual void on_edit([[maybe_unused]] DeprecatedString const& file) {};
     virtual void file_opened([[maybe_unused]] DeprecatedString const& file) {};
 
+    // Called once the project root of the FileDB is known.
+    virtual void project_opened() {};
+
     virtual Optional<ProjectLocation> find_declaration_of(DeprecatedString const&, GUI::TextPosition const&) { return {}; }
 
     struct FunctionParamsHint {
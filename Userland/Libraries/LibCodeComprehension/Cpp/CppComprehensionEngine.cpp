@@ -7,15 +7,20 @@
 #include "CppComprehensionEngine.h"
 #include <AK/Assertions.h>
 #include <AK/HashTable.h>
+#include <AK/LexicalPath.h>
 #include <AK/OwnPtr.h>
 #include <AK/ScopeGuard.h>
 #include <LibCore/DeprecatedFile.h>
 #include <LibCore/DirIterator.h>
+#include <LibCore/Directory.h>
+#include <LibCore/File.h>
+#include <LibCore/System.h>
 #include <LibCpp/AST.h>
 #include <LibCpp/Lexer.h>
 #include <LibCpp/Parser.h>
 #include <LibCpp/Preprocessor.h>
 #include <LibRegex/Regex.h>
+#include <LibThreading/ThreadPool.h>
 #include <Userland/DevTools/HackStudio/LanguageServers/ConnectionFromClient.h>
 
 namespace CodeComprehension::Cpp {
@@ -25,6 +30,12 @@ CppComprehensionEngine::CppComprehensionEngine(FileDB const& filedb)
 {
 }
 
+CppComprehensionEngine::~CppComprehensionEngine()
+{
+    if (m_indexing_action)
+        m_indexing_action->cancel();
+}
+
 CppComprehensionEngine::DocumentData const* CppComprehensionEngine::get_or_create_document_data(DeprecatedString const& file)
 {
     auto absolute_path = filedb().to_absolute_path(file);
@@ -336,12 +347,12 @@ CppComprehensionEngine::Symbol CppComprehensionEngine::Symbol::create(StringView
     return { { name, scope }, move(declaration), is_local == IsLocal::Yes };
 }
 
-Vector<CppComprehensionEngine::Symbol> CppComprehensionEngine::get_child_symbols(ASTNode const& node) const
+Vector<CppComprehensionEngine::Symbol> CppComprehensionEngine::get_child_symbols(ASTNode const& node)
 {
     return get_child_symbols(node, {}, Symbol::IsLocal::No);
 }
 
-Vector<CppComprehensionEngine::Symbol> CppComprehensionEngine::get_child_symbols(ASTNode const& node, Vector<StringView> const& scope, Symbol::IsLocal is_local) const
+Vector<CppComprehensionEngine::Symbol> CppComprehensionEngine::get_child_symbols(ASTNode const& node, Vector<StringView> const& scope, Symbol::IsLocal is_local)
 {
     Vector<Symbol> symbols;
 
@@ -401,6 +412,181 @@ void CppComprehensionEngine::file_opened([[maybe_unused]] DeprecatedString const
     get_or_create_document_data(file);
 }
 
+void CppComprehensionEngine::project_opened()
+{
+    auto project_root = filedb().project_root();
+    if (project_root.is_null())
+        return;
+
+    auto index_path = LexicalPath::join(project_root, ".hackstudio"sv, "cpp_symbol_index.json"sv).string();
+    m_indexing_action = Threading::BackgroundAction<SymbolIndex>::construct(
+        Threading::ThreadPool::the(),
+        [project_root = move(project_root), index_path = move(index_path)](auto& action) {
+            return build_symbol_index(project_root, index_path, action);
+        },
+        [weak_this = make_weak_ptr()](SymbolIndex index) -> ErrorOr<void> {
+            if (weak_this)
+                weak_this->set_symbol_index(move(index));
+            return {};
+        });
+}
+
+struct SourceFile {
+    DeprecatedString path;
+    i64 modification_time { 0 };
+};
+
+static bool is_source_file(StringView path)
+{
+    return path.ends_with(".cpp"sv) || path.ends_with(".h"sv) || path.ends_with(".c"sv) || path.ends_with(".hpp"sv) || path.ends_with(".cc"sv);
+}
+
+static void find_source_files(DeprecatedString const& directory, Vector<SourceFile>& source_files)
+{
+    // This skips hidden directories as well, like .git and .hackstudio.
+    Core::DirIterator iterator(directory, Core::DirIterator::Flags::SkipDots);
+    while (iterator.has_next()) {
+        auto path = iterator.next_full_path();
+        auto stat = Core::System::lstat(path);
+        if (stat.is_error())
+            continue;
+
+        if (S_ISDIR(stat.value().st_mode))
+            find_source_files(path, source_files);
+        else if (S_ISREG(stat.value().st_mode) && is_source_file(path))
+            source_files.append({ move(path), stat.value().st_mtim.tv_sec * 1'000'000'000ll + stat.value().st_mtim.tv_nsec });
+    }
+}
+
+SymbolIndex CppComprehensionEngine::build_symbol_index(DeprecatedString const& project_root, DeprecatedString const& index_path, Threading::BackgroundAction<SymbolIndex> const& action)
+{
+    SymbolIndex index;
+    if (auto saved_index = SymbolIndex::load_from_file(index_path); !saved_index.is_error())
+        index = saved_index.release_value();
+    else
+        dbgln_if(CPP_LANGUAGE_SERVER_DEBUG, "Not using the symbol index at {}: {}", index_path, saved_index.error());
+
+    Vector<SourceFile> source_files;
+    find_source_files(project_root, source_files);
+
+    HashTable<DeprecatedString> existing_files;
+    for (auto const& source_file : source_files)
+        existing_files.set(source_file.path);
+
+    Vector<DeprecatedString> removed_files;
+    for (auto const& [file, entry] : index.file_entries()) {
+        if (!existing_files.contains(file))
+            removed_files.append(file);
+    }
+    for (auto const& file : removed_files)
+        index.remove_file_entry(file);
+
+    // Only the files that changed since the index was saved have to be parsed again.
+    Vector<SourceFile> outdated_files;
+    for (auto& source_file : source_files) {
+        if (!index.is_up_to_date(source_file.path, source_file.modification_time))
+            outdated_files.append(move(source_file));
+    }
+
+    Vector<Optional<SymbolIndex::FileEntry>> entries;
+    entries.resize(outdated_files.size());
+    Threading::parallel_for(outdated_files.size(), [&](size_t i) {
+        if (!action.is_cancelled())
+            entries[i] = index_file(outdated_files[i].path, outdated_files[i].modification_time);
+    });
+
+    if (action.is_cancelled())
+        return index;
+
+    for (size_t i = 0; i < outdated_files.size(); ++i) {
+        if (entries[i].has_value())
+            index.set_file_entry(outdated_files[i].path, entries[i].release_value());
+        else
+            index.remove_file_entry(outdated_files[i].path);
+    }
+
+    if (removed_files.is_empty() && outdated_files.is_empty())
+        return index;
+
+    auto result = [&]() -> ErrorOr<void> {
+        (void)TRY(Core::Directory::create(LexicalPath { index_path }.parent(), Core::Directory::CreateDirectories::Yes));
+        return index.save_to_file(index_path);
+    }();
+    if (result.is_error())
+        dbgln("Failed to save the symbol index to {}: {}", index_path, result.error());
+
+    return index;
+}
+
+// This runs on the thread pool, so it only looks at the file itself. The headers it includes are only parsed when
+// the file is opened, since finding them needs the engine.
+Optional<SymbolIndex::FileEntry> CppComprehensionEngine::index_file(DeprecatedString const& file, i64 modification_time)
+{
+    auto text = [&]() -> ErrorOr<DeprecatedString> {
+        auto stream = TRY(Core::File::open(file, Core::File::OpenMode::Read));
+        return DeprecatedString::copy(TRY(stream->read_until_eof()));
+    }();
+    if (text.is_error())
+        return {};
+
+    Preprocessor preprocessor(file, text.value());
+    preprocessor.set_ignore_unsupported_keywords(true);
+    preprocessor.set_ignore_invalid_statements(true);
+    preprocessor.set_keep_include_statements(true);
+    auto tokens = preprocessor.process_and_lex();
+
+    Parser parser(move(tokens), file);
+    auto root = parser.parse();
+
+    HashMap<SymbolName, Symbol> symbols;
+    for (auto& symbol : get_child_symbols(*root))
+        symbols.set(symbol.name, move(symbol));
+
+    SymbolIndex::FileEntry entry;
+    entry.modification_time = modification_time;
+    for (auto included_path : preprocessor.included_paths())
+        entry.included_paths.append(included_path);
+    entry.declarations = declarations_of(file, symbols, preprocessor.definitions());
+    return entry;
+}
+
+void CppComprehensionEngine::set_symbol_index(SymbolIndex index)
+{
+    m_symbol_index = move(index);
+    m_indexing_action = nullptr;
+
+    // The documents that were parsed while the project was being indexed may have unsaved changes.
+    for (auto const& [file, document] : m_documents) {
+        if (document)
+            update_symbol_index(*document, declarations_of(document->filename(), document->m_symbols, document->preprocessor().definitions()));
+    }
+
+    for (auto const& [file, entry] : m_symbol_index->file_entries()) {
+        if (m_documents.contains(file))
+            continue;
+        auto declarations = entry.declarations;
+        set_declarations_of_document(file, move(declarations));
+    }
+}
+
+Optional<CodeComprehension::ProjectLocation> CppComprehensionEngine::find_indexed_declaration_of(DocumentData const& document, GUI::TextPosition const& identifier_position) const
+{
+    if (!m_symbol_index.has_value())
+        return {};
+
+    auto token = document.parser().token_at({ identifier_position.line(), identifier_position.column() });
+    if (!token.has_value() || token->type() != Token::Type::Identifier)
+        return {};
+
+    // This only goes by the name, so it's used for the symbols that aren't declared in the document or the headers it includes.
+    Optional<CodeComprehension::ProjectLocation> location;
+    m_symbol_index->for_each_declaration_named(token->text(), [&](CodeComprehension::Declaration const& declaration) {
+        location = declaration.position;
+        return IterationDecision::Break;
+    });
+    return location;
+}
+
 Optional<CodeComprehension::ProjectLocation> CppComprehensionEngine::find_declaration_of(DeprecatedString const& filename, const GUI::TextPosition& identifier_position)
 {
     auto const* document_ptr = get_or_create_document_data(filename);
@@ -413,7 +599,10 @@ Optional<CodeComprehension::ProjectLocation> CppComprehensionEngine::find_declar
         return CodeComprehension::ProjectLocation { decl->filename(), decl->start().line, decl->start().column };
     }
 
-    return find_preprocessor_definition(document, identifier_position);
+    if (auto location = find_preprocessor_definition(document, identifier_position); location.has_value())
+        return location;
+
+    return find_indexed_declaration_of(document, identifier_position);
 }
 
 RefPtr<Cpp::Declaration> CppComprehensionEngine::find_declaration_of(DocumentData const& document, const GUI::TextPosition& identifier_position)
@@ -578,16 +767,36 @@ void CppComprehensionEngine::update_declared_symbols(DocumentData& document)
         document.m_symbols.set(symbol.name, move(symbol));
     }
 
+    auto declarations = declarations_of(document.filename(), document.m_symbols, document.preprocessor().definitions());
+    update_symbol_index(document, declarations);
+    set_declarations_of_document(document.filename(), move(declarations));
+}
+
+void CppComprehensionEngine::update_symbol_index(DocumentData const& document, Vector<CodeComprehension::Declaration> declarations)
+{
+    if (!m_symbol_index.has_value())
+        return;
+
+    // This entry has no modification time, since the document may have unsaved changes.
+    SymbolIndex::FileEntry entry;
+    for (auto included_path : document.preprocessor().included_paths())
+        entry.included_paths.append(included_path);
+    entry.declarations = move(declarations);
+    m_symbol_index->set_file_entry(document.filename(), move(entry));
+}
+
+Vector<CodeComprehension::Declaration> CppComprehensionEngine::declarations_of(DeprecatedString const& filename, HashMap<SymbolName, Symbol> const& symbols, Preprocessor::Definitions const& definitions)
+{
     Vector<CodeComprehension::Declaration> declarations;
-    for (auto& symbol_entry : document.m_symbols) {
+    for (auto& symbol_entry : symbols) {
         auto& symbol = symbol_entry.value;
-        declarations.append({ symbol.name.name, { document.filename(), symbol.declaration->start().line, symbol.declaration->start().column }, type_of_declaration(symbol.declaration), symbol.name.scope_as_string() });
+        declarations.append({ symbol.name.name, { filename, symbol.declaration->start().line, symbol.declaration->start().column }, type_of_declaration(symbol.declaration), symbol.name.scope_as_string() });
     }
 
-    for (auto& definition : document.preprocessor().definitions()) {
-        declarations.append({ definition.key, { document.filename(), definition.value.line, definition.value.column }, CodeComprehension::DeclarationType::PreprocessorDefinition, {} });
+    for (auto& definition : definitions) {
+        declarations.append({ definition.key, { filename, definition.value.line, definition.value.column }, CodeComprehension::DeclarationType::PreprocessorDefinition, {} });
     }
-    set_declarations_of_document(document.filename(), move(declarations));
+    return declarations;
 }
 
 void CppComprehensionEngine::update_todo_entries(DocumentData& document)
@@ -9,6 +9,8 @@
 #include <AK/DeprecatedString.h>
 #include <AK/Function.h>
 #include <AK/Vector.h>
+#include <AK/WeakPtr.h>
+#include <AK/Weakable.h>
 #include <DevTools/HackStudio/AutoCompleteResponse.h>
 #include <DevTools/HackStudio/LanguageServers/FileDB.h>
 #include <LibCpp/AST.h>
@@ -16,18 +18,23 @@
 #include <LibCpp/Preprocessor.h>
 #include <LibGUI/TextPosition.h>
 #include <Libraries/LibCodeComprehension/CodeComprehensionEngine.h>
+#include <Libraries/LibCodeComprehension/SymbolIndex.h>
+#include <LibThreading/BackgroundAction.h>
 
 namespace CodeComprehension::Cpp {
 
 using namespace ::Cpp;
 
-class CppComprehensionEngine : public CodeComprehensionEngine {
+class CppComprehensionEngine : public CodeComprehensionEngine
+    , public Weakable<CppComprehensionEngine> {
 public:
     CppComprehensionEngine(FileDB const& filedb);
+    virtual ~CppComprehensionEngine() override;
 
     virtual Vector<CodeComprehension::AutocompleteResultEntry> get_suggestions(DeprecatedString const& file, GUI::TextPosition const& autocomplete_position) override;
     virtual void on_edit(DeprecatedString const& file) override;
     virtual void file_opened([[maybe_unused]] DeprecatedString const& file) override;
+    virtual void project_opened() override;
     virtual Optional<CodeComprehension::ProjectLocation> find_declaration_of(DeprecatedString const& filename, GUI::TextPosition const& identifier_position) override;
     virtual Optional<FunctionParamsHint> get_function_params_hint(DeprecatedString const&, GUI::TextPosition const&) override;
     virtual Vector<CodeComprehension::TokenInfo> get_tokens_info(DeprecatedString const& filename) override;
@@ -111,8 +118,8 @@ private:
     };
 
     Vector<Symbol> properties_of_type(DocumentData const& document, DeprecatedString const& type) const;
-    Vector<Symbol> get_child_symbols(ASTNode const&) const;
-    Vector<Symbol> get_child_symbols(ASTNode const&, Vector<StringView> const& scope, Symbol::IsLocal) const;
+    static Vector<Symbol> get_child_symbols(ASTNode const&);
+    static Vector<Symbol> get_child_symbols(ASTNode const&, Vector<StringView> const& scope, Symbol::IsLocal);
 
     DocumentData const* get_document_data(DeprecatedString const& file) const;
     DocumentData const* get_or_create_document_data(DeprecatedString const& file);
@@ -122,7 +129,14 @@ private:
     DeprecatedString document_path_from_include_path(StringView include_path) const;
     void update_declared_symbols(DocumentData&);
     void update_todo_entries(DocumentData&);
-    CodeComprehension::DeclarationType type_of_declaration(Cpp::Declaration const&);
+    static Vector<CodeComprehension::Declaration> declarations_of(DeprecatedString const& filename, HashMap<SymbolName, Symbol> const&, Preprocessor::Definitions const&);
+    static CodeComprehension::DeclarationType type_of_declaration(Cpp::Declaration const&);
+
+    static SymbolIndex build_symbol_index(DeprecatedString const& project_root, DeprecatedString const& index_path, Threading::BackgroundAction<SymbolIndex> const&);
+    static Optional<SymbolIndex::FileEntry> index_file(DeprecatedString const& file, i64 modification_time);
+    void set_symbol_index(SymbolIndex);
+    void update_symbol_index(DocumentData const&, Vector<CodeComprehension::Declaration>);
+    Optional<CodeComprehension::ProjectLocation> find_indexed_declaration_of(DocumentData const&, GUI::TextPosition const&) const;
     Vector<StringView> scope_of_node(ASTNode const&) const;
     Vector<StringView> scope_of_reference_to_symbol(ASTNode const&) const;
 
@@ -151,6 +165,11 @@ private:
     // A document is added to this set when we start processing it (e.g because it was #included) and removed when we're done.
     // We use this to prevent circular #includes from looping indefinitely.
     HashTable<DeprecatedString> m_unfinished_documents;
+
+    // The declarations of every file in the project, which is filled in on a background thread after the project is opened.
+    // Until then, it's empty and only the documents that have been parsed are searched.
+    Optional<SymbolIndex> m_symbol_index;
+    RefPtr<Threading::BackgroundAction<SymbolIndex>> m_indexing_action;
 };
 
 template<typename Func>
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "SymbolIndex.h"
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <LibCore/File.h>
+
+namespace CodeComprehension {
+
+// Bump this whenever the format changes, so that indices written by older versions are thrown away.
+static constexpr i64 SYMBOL_INDEX_VERSION = 1;
+
+// Every declaration is stored as [name, line, column, type, scope], since there are a lot of them.
+static JsonArray declaration_to_json(Declaration const& declaration)
+{
+    JsonArray json;
+    json.append(declaration.name);
+    json.append(declaration.position.line);
+    json.append(declaration.position.column);
+    json.append(to_underlying(declaration.type));
+    // Macros have no scope, which is stored as null.
+    if (declaration.scope.is_null())
+        json.append(JsonValue {});
+    else
+        json.append(declaration.scope);
+    return json;
+}
+
+static ErrorOr<Declaration> declaration_from_json(DeprecatedString const& file, JsonValue const& json)
+{
+    if (!json.is_array() || json.as_array().size() != 5)
+        return Error::from_string_literal("Invalid declaration in symbol index");
+
+    auto const& values = json.as_array();
+    if (!values[0].is_string() || !values[1].is_integer<size_t>() || !values[2].is_integer<size_t>() || !values[3].is_integer<u8>() || !(values[4].is_string() || values[4].is_null()))
+        return Error::from_string_literal("Invalid declaration in symbol index");
+
+    auto type = values[3].as_integer<u8>();
+    if (type > to_underlying(DeclarationType::Member))
+        return Error::from_string_literal("Invalid declaration type in symbol index");
+
+    return Declaration {
+        values[0].as_string(),
+        { file, values[1].as_integer<size_t>(), values[2].as_integer<size_t>() },
+        static_cast<DeclarationType>(type),
+        values[4].is_null() ? DeprecatedString {} : values[4].as_string(),
+    };
+}
+
+static ErrorOr<SymbolIndex::FileEntry> file_entry_from_json(DeprecatedString const& file, JsonValue const& json)
+{
+    if (!json.is_object())
+        return Error::from_string_literal("Invalid file in symbol index");
+
+    auto const& object = json.as_object();
+    auto modification_time = object.get_i64("modification_time"sv);
+    auto included_paths = object.get_array("included_paths"sv);
+    auto declarations = object.get_array("declarations"sv);
+    if (!modification_time.has_value() || !included_paths.has_value() || !declarations.has_value())
+        return Error::from_string_literal("Invalid file in symbol index");
+
+    SymbolIndex::FileEntry entry;
+    entry.modification_time = *modification_time;
+
+    TRY(entry.included_paths.try_ensure_capacity(included_paths->size()));
+    for (auto const& included_path : included_paths->values()) {
+        if (!included_path.is_string())
+            return Error::from_string_literal("Invalid include in symbol index");
+        entry.included_paths.unchecked_append(included_path.as_string());
+    }
+
+    TRY(entry.declarations.try_ensure_capacity(declarations->size()));
+    for (auto const& declaration : declarations->values())
+        entry.declarations.unchecked_append(TRY(declaration_from_json(file, declaration)));
+
+    return entry;
+}
+
+ErrorOr<SymbolIndex> SymbolIndex::load_from_file(StringView path)
+{
+    auto file = TRY(Core::File::open(path, Core::File::OpenMode::Read));
+    auto contents = TRY(file->read_until_eof());
+
+    auto json = TRY(JsonValue::from_string(contents));
+    if (!json.is_object())
+        return Error::from_string_literal("Symbol index is not a JSON object");
+
+    auto const& object = json.as_object();
+    if (object.get_i64("version"sv) != SYMBOL_INDEX_VERSION)
+        return Error::from_string_literal("Symbol index has an unsupported version");
+
+    auto files = object.get_object("files"sv);
+    if (!files.has_value())
+        return Error::from_string_literal("Symbol index has no files");
+
+    SymbolIndex index;
+    TRY(files->try_for_each_member([&](auto const& file, auto const& value) -> ErrorOr<void> {
+        index.set_file_entry(file, TRY(file_entry_from_json(file, value)));
+        return {};
+    }));
+    return index;
+}
+
+ErrorOr<void> SymbolIndex::save_to_file(StringView path) const
+{
+    JsonObject files;
+    for (auto const& [file, entry] : m_file_entries) {
+        // Entries made from unsaved changes don't describe what's on disk.
+        if (entry.modification_time == 0)
+            continue;
+
+        JsonArray included_paths;
+        for (auto const& included_path : entry.included_paths)
+            included_paths.append(included_path);
+
+        JsonArray declarations;
+        declarations.ensure_capacity(entry.declarations.size());
+        for (auto const& declaration : entry.declarations)
+            declarations.append(declaration_to_json(declaration));
+
+        JsonObject json_entry;
+        json_entry.set("modification_time", entry.modification_time);
+        json_entry.set("included_paths", move(included_paths));
+        json_entry.set("declarations", move(declarations));
+        files.set(file, move(json_entry));
+    }
+
+    JsonObject json;
+    json.set("version", SYMBOL_INDEX_VERSION);
+    json.set("files", move(files));
+
+    auto file = TRY(Core::File::open(path, Core::File::OpenMode::Write | Core::File::OpenMode::Truncate));
+    TRY(file->write_entire_buffer(json.to_deprecated_string().bytes()));
+    return {};
+}
+
+SymbolIndex::FileEntry const* SymbolIndex::file_entry(DeprecatedString const& file) const
+{
+    auto it = m_file_entries.find(file);
+    if (it == m_file_entries.end())
+        return nullptr;
+    return &it->value;
+}
+
+bool SymbolIndex::is_up_to_date(DeprecatedString const& file, i64 modification_time) const
+{
+    auto const* entry = file_entry(file);
+    return entry && entry->modification_time != 0 && entry->modification_time == modification_time;
+}
+
+void SymbolIndex::set_file_entry(DeprecatedString const& file, FileEntry entry)
+{
+    remove_file_entry(file);
+    add_declared_names(file, entry);
+    m_file_entries.set(file, move(entry));
+}
+
+void SymbolIndex::remove_file_entry(DeprecatedString const& file)
+{
+    auto it = m_file_entries.find(file);
+    if (it == m_file_entries.end())
+        return;
+
+    remove_declared_names(file, it->value);
+    m_file_entries.remove(it);
+}
+
+void SymbolIndex::add_declared_names(DeprecatedString const& file, FileEntry const& entry)
+{
+    for (auto const& declaration : entry.declarations) {
+        auto& files = m_files_by_declared_name.ensure(declaration.name);
+        // All names of a file are added at once, so a file that declares a name twice is always the last one in the list.
+        if (files.is_empty() || files.last() != file)
+            files.append(file);
+    }
+}
+
+void SymbolIndex::remove_declared_names(DeprecatedString const& file, FileEntry const& entry)
+{
+    for (auto const& declaration : entry.declarations) {
+        auto it = m_files_by_declared_name.find(declaration.name);
+        if (it == m_files_by_declared_name.end())
+            continue;
+
+        it->value.remove_first_matching([&](auto const& other_file) { return other_file == file; });
+        if (it->value.is_empty())
+            m_files_by_declared_name.remove(it);
+    }
+}
+
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "Types.h"
+#include <AK/DeprecatedString.h>
+#include <AK/Error.h>
+#include <AK/HashMap.h>
+#include <AK/IterationDecision.h>
+#include <AK/Vector.h>
+
+namespace CodeComprehension {
+
+// The declarations and includes of every file in a project, as they were when the file was last parsed.
+// It's kept on disk between runs, so that only the files that changed since then have to be parsed again.
+class SymbolIndex {
+public:
+    struct FileEntry {
+        // The modification time of the file when it was indexed, or 0 if the entry was made from unsaved changes.
+        i64 modification_time { 0 };
+        Vector<DeprecatedString> included_paths;
+        Vector<Declaration> declarations;
+    };
+
+    static ErrorOr<SymbolIndex> load_from_file(StringView path);
+    ErrorOr<void> save_to_file(StringView path) const;
+
+    FileEntry const* file_entry(DeprecatedString const& file) const;
+    bool is_up_to_date(DeprecatedString const& file, i64 modification_time) const;
+    void set_file_entry(DeprecatedString const& file, FileEntry);
+    void remove_file_entry(DeprecatedString const& file);
+
+    HashMap<DeprecatedString, FileEntry> const& file_entries() const { return m_file_entries; }
+
+    template<typename Callback>
+    void for_each_declaration_named(StringView name, Callback callback) const
+    {
+        auto files = m_files_by_declared_name.get(name);
+        if (!files.has_value())
+            return;
+
+        for (auto& file : *files) {
+            for (auto& declaration : m_file_entries.get(file)->declarations) {
+                if (declaration.name != name)
+                    continue;
+                if (callback(declaration) == IterationDecision::Break)
+                    return;
+            }
+        }
+    }
+
+private:
+    void add_declared_names(DeprecatedString const& file, FileEntry const&);
+    void remove_declared_names(DeprecatedString const& file, FileEntry const&);
+
+    HashMap<DeprecatedString, FileEntry> m_file_entries;
+
+    // The files that declare each name, so that looking a name up doesn't have to go through every file.
+    HashMap<DeprecatedString, Vector<DeprecatedString>> m_files_by_declared_name;
+};
+
+}
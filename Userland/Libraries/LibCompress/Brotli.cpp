@@ -11,18 +11,51 @@
 
 namespace Compress {
 
-ErrorOr<size_t> BrotliDecompressionStream::CanonicalCode::read_symbol(LittleEndianInputBitStream& input_stream)
+void BrotliDecompressionStream::CanonicalCode::add_symbol(size_t code_bits, size_t value)
 {
+    m_symbol_codes.append(code_bits);
+    m_symbol_values.append(value);
+
+    size_t code_length = 0;
+    while ((code_bits >> (code_length + 1)) != 0)
+        code_length++;
+    if (code_length == 0 || code_length > fast_lookup_bits)
+        return;
+
+    // Codes are sent with their most significant bit first, so the first bit we peek at is the top one.
+    size_t reversed_code = 0;
+    for (size_t i = 0; i < code_length; i++)
+        reversed_code |= ((code_bits >> i) & 1) << (code_length - 1 - i);
+
+    for (size_t i = reversed_code; i < m_fast_lookup.size(); i += 1 << code_length)
+        m_fast_lookup[i] = (value << 4) | code_length;
+}
+
+ErrorOr<size_t> BrotliDecompressionStream::CanonicalCode::read_symbol(LittleEndianInputBitStream& input_stream) const
+{
+    // A code with a single symbol doesn't take up any bits.
+    if (m_symbol_codes.size() == 1 && m_symbol_codes[0] == 1)
+        return m_symbol_values[0];
+
+    auto bits = TRY(input_stream.peek_bits(max_code_length));
+
+    if (auto entry = m_fast_lookup[bits & ((1 << fast_lookup_bits) - 1)]; entry != 0) {
+        TRY(input_stream.discard_previously_peeked_bits(entry & 0xf));
+        return entry >> 4;
+    }
+
+    // The code is longer than the lookup table covers, so we look for it one more bit at a time.
     size_t code_bits = 1;
+    for (size_t code_length = 1; code_length <= max_code_length; code_length++) {
+        code_bits = (code_bits << 1) | ((bits >> (code_length - 1)) & 1);
+        if (code_length <= fast_lookup_bits)
+            continue;
 
-    while (code_bits < (1 << 16)) {
-        // FIXME: This is very inefficient and could greatly be improved by implementing this
-        //        algorithm: https://www.hanshq.net/zip.html#huffdec
         size_t index;
-        if (binary_search(m_symbol_codes.span(), code_bits, &index))
+        if (binary_search(m_symbol_codes.span(), code_bits, &index)) {
+            TRY(input_stream.discard_previously_peeked_bits(code_length));
             return m_symbol_values[index];
-
-        code_bits = (code_bits << 1) | TRY(input_stream.read_bit());
+        }
     }
 
     return Error::from_string_literal("no matching code found");
@@ -204,33 +237,32 @@ ErrorOr<void> BrotliDecompressionStream::read_simple_prefix_code(CanonicalCode&
             return Error::from_string_literal("symbol larger than alphabet");
     }
 
+    Vector<size_t> symbol_codes;
     if (number_of_symbols == 1) {
-        code.m_symbol_codes.append(0b1);
-        code.m_symbol_values = move(symbols);
+        symbol_codes.append(0b1);
     } else if (number_of_symbols == 2) {
-        code.m_symbol_codes.extend({ 0b10, 0b11 });
+        symbol_codes.extend({ 0b10, 0b11 });
         if (symbols[0] > symbols[1])
             swap(symbols[0], symbols[1]);
-        code.m_symbol_values = move(symbols);
     } else if (number_of_symbols == 3) {
-        code.m_symbol_codes.extend({ 0b10, 0b110, 0b111 });
+        symbol_codes.extend({ 0b10, 0b110, 0b111 });
         if (symbols[1] > symbols[2])
             swap(symbols[1], symbols[2]);
-        code.m_symbol_values = move(symbols);
     } else if (number_of_symbols == 4) {
         bool tree_select = TRY(m_input_stream.read_bit());
         if (tree_select) {
-            code.m_symbol_codes.extend({ 0b10, 0b110, 0b1110, 0b1111 });
+            symbol_codes.extend({ 0b10, 0b110, 0b1110, 0b1111 });
             if (symbols[2] > symbols[3])
                 swap(symbols[2], symbols[3]);
-            code.m_symbol_values = move(symbols);
         } else {
-            code.m_symbol_codes.extend({ 0b100, 0b101, 0b110, 0b111 });
+            symbol_codes.extend({ 0b100, 0b101, 0b110, 0b111 });
             quick_sort(symbols);
-            code.m_symbol_values = move(symbols);
         }
     }
 
+    for (size_t i = 0; i < number_of_symbols; i++)
+        code.add_symbol(symbol_codes[i], symbols[i]);
+
     return {};
 }
 
@@ -273,8 +305,7 @@ ErrorOr<void> BrotliDecompressionStream::read_complex_prefix_code(CanonicalCode&
             for (size_t i = 0; i < 18; i++) {
                 size_t len = code_length[i];
                 if (len == bits) {
-                    temp_code.m_symbol_codes.append((1 << bits) | current_code_value);
-                    temp_code.m_symbol_values.append(i);
+                    temp_code.add_symbol((1 << bits) | current_code_value, i);
                     current_code_value++;
                 }
             }
@@ -283,8 +314,7 @@ ErrorOr<void> BrotliDecompressionStream::read_complex_prefix_code(CanonicalCode&
         for (size_t i = 0; i < 18; i++) {
             size_t len = code_length[i];
             if (len != 0) {
-                temp_code.m_symbol_codes.append(1);
-                temp_code.m_symbol_values.append(i);
+                temp_code.add_symbol(1, i);
                 break;
             }
         }
@@ -376,8 +406,7 @@ ErrorOr<void> BrotliDecompressionStream::read_complex_prefix_code(CanonicalCode&
         for (size_t n = 0; n < result_symbols.size(); n++) {
             size_t len = result_lengths[n];
             if (len == bits) {
-                code.m_symbol_codes.append((1 << bits) | current_code_value);
-                code.m_symbol_values.append(result_symbols[n]);
+                code.add_symbol((1 << bits) | current_code_value, result_symbols[n]);
                 current_code_value++;
             }
         }
@@ -744,6 +773,7 @@ ErrorOr<Bytes> BrotliDecompressionStream::read(Bytes output_buffer)
             auto uncompressed_bytes = TRY(m_input_stream.read(output_buffer.slice(bytes_read, number_of_fitting_bytes)));
             if (uncompressed_bytes.is_empty())
                 return Error::from_string_literal("eof");
+            m_lookback_buffer.value().write(uncompressed_bytes);
 
             m_bytes_left -= uncompressed_bytes.size();
             bytes_read += uncompressed_bytes.size();
@@ -786,19 +816,22 @@ ErrorOr<Bytes> BrotliDecompressionStream::read(Bytes output_buffer)
                 m_current_state = State::CompressedDistance;
             }
         } else if (m_current_state == State::CompressedLiteral) {
-            if (m_literal_block.length == 0) {
-                TRY(block_read_new_state(m_literal_block));
-            }
-            m_literal_block.length--;
+            // Literals only change the state once the last one of them was read, so we stay here for as many as we can.
+            do {
+                if (m_literal_block.length == 0) {
+                    TRY(block_read_new_state(m_literal_block));
+                }
+                m_literal_block.length--;
 
-            size_t literal_code_index = literal_code_index_from_context();
-            size_t literal_value = TRY(m_literal_codes[literal_code_index].read_symbol(m_input_stream));
+                size_t literal_code_index = literal_code_index_from_context();
+                size_t literal_value = TRY(m_literal_codes[literal_code_index].read_symbol(m_input_stream));
 
-            output_buffer[bytes_read] = literal_value;
-            m_lookback_buffer.value().write(literal_value);
-            bytes_read++;
-            m_insert_length--;
-            m_bytes_left--;
+                output_buffer[bytes_read] = literal_value;
+                m_lookback_buffer.value().write(literal_value);
+                bytes_read++;
+                m_insert_length--;
+                m_bytes_left--;
+            } while (m_insert_length > 0 && m_bytes_left > 0 && bytes_read < output_buffer.size());
 
             if (m_bytes_left == 0)
                 m_current_state = State::Idle;
@@ -887,6 +920,8 @@ ErrorOr<Bytes> BrotliDecompressionStream::read(Bytes output_buffer)
                 size_t offset = ((2 + (hcode & 1)) << ndistbits) - 4;
                 distance = ((offset + dextra) << m_postfix_bits) + lcode + m_direct_distances + 1;
             }
+            if (distance == 0)
+                return Error::from_string_literal("invalid distance");
             m_distance = distance;
 
             size_t total_written = m_lookback_buffer.value().total_written();
@@ -912,13 +947,12 @@ ErrorOr<Bytes> BrotliDecompressionStream::read(Bytes output_buffer)
                 m_current_state = State::CompressedCopy;
             }
         } else if (m_current_state == State::CompressedCopy) {
-            u8 copy_value = m_lookback_buffer.value().lookback(m_distance);
+            size_t number_of_fitting_bytes = min(min(output_buffer.size() - bytes_read, m_bytes_left), m_copy_length);
 
-            output_buffer[bytes_read] = copy_value;
-            m_lookback_buffer.value().write(copy_value);
-            bytes_read++;
-            m_copy_length--;
-            m_bytes_left--;
+            m_lookback_buffer.value().copy_from_lookback(m_distance, output_buffer.slice(bytes_read, number_of_fitting_bytes));
+            bytes_read += number_of_fitting_bytes;
+            m_copy_length -= number_of_fitting_bytes;
+            m_bytes_left -= number_of_fitting_bytes;
 
             if (m_bytes_left == 0)
                 m_current_state = State::Idle;
@@ -926,13 +960,14 @@ ErrorOr<Bytes> BrotliDecompressionStream::read(Bytes output_buffer)
                 m_current_state = State::CompressedCommand;
         } else if (m_current_state == State::CompressedDictionary) {
             size_t offset = m_dictionary_data.size() - m_copy_length;
-            u8 dictionary_value = m_dictionary_data[offset];
-
-            output_buffer[bytes_read] = dictionary_value;
-            m_lookback_buffer.value().write(dictionary_value);
-            bytes_read++;
-            m_copy_length--;
-            m_bytes_left--;
+            size_t number_of_fitting_bytes = min(min(output_buffer.size() - bytes_read, m_bytes_left), m_copy_length);
+            auto dictionary_bytes = m_dictionary_data.bytes().slice(offset, number_of_fitting_bytes);
+
+            dictionary_bytes.copy_to(output_buffer.slice(bytes_read));
+            m_lookback_buffer.value().write(dictionary_bytes);
+            bytes_read += number_of_fitting_bytes;
+            m_copy_length -= number_of_fitting_bytes;
+            m_bytes_left -= number_of_fitting_bytes;
 
             if (m_bytes_left == 0)
                 m_current_state = State::Idle;
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/BitStream.h>
 #include <AK/CircularQueue.h>
 #include <AK/FixedArray.h>
@@ -31,16 +32,27 @@ public:
 
     public:
         CanonicalCode() = default;
-        ErrorOr<size_t> read_symbol(LittleEndianInputBitStream&);
+        ErrorOr<size_t> read_symbol(LittleEndianInputBitStream&) const;
         void clear()
         {
             m_symbol_codes.clear();
             m_symbol_values.clear();
+            m_fast_lookup.fill(0);
         }
 
     private:
+        static constexpr size_t max_code_length = 15;
+        static constexpr size_t fast_lookup_bits = 9;
+
+        // Codes have to be added in the order of their code_bits, which is the code with a 1 bit in front of it.
+        void add_symbol(size_t code_bits, size_t value);
+
         Vector<size_t> m_symbol_codes;
         Vector<size_t> m_symbol_values;
+
+        // Codes of up to fast_lookup_bits bits are looked up by the next fast_lookup_bits bits of input in m_fast_lookup,
+        // which holds (symbol << 4) | code_length, or zero if the code is longer.
+        Array<u16, 1 << fast_lookup_bits> m_fast_lookup {};
     };
 
     struct Block {
@@ -93,6 +105,45 @@ public:
             return m_buffer[index];
         }
 
+        void write(ReadonlyBytes bytes)
+        {
+            while (!bytes.is_empty()) {
+                size_t chunk_size = min(bytes.size(), m_buffer.size() - m_offset);
+                memcpy(&m_buffer[m_offset], bytes.data(), chunk_size);
+                m_offset = (m_offset + chunk_size) % m_buffer.size();
+                m_total_written += chunk_size;
+                bytes = bytes.slice(chunk_size);
+            }
+        }
+
+        // Fills `output` with the bytes from `offset` bytes back on, and writes them to the buffer as well,
+        // so a copy that's longer than its offset repeats itself.
+        void copy_from_lookback(size_t offset, Bytes output)
+        {
+            VERIFY(offset > 0);
+            VERIFY(offset <= m_total_written);
+            VERIFY(offset <= m_buffer.size());
+
+            // Every chunk may only read bytes that were there before it, but once a repeating copy has written some bytes,
+            // they repeat just as well from any multiple of the offset back.
+            size_t distance = offset;
+            size_t bytes_copied = 0;
+            while (!output.is_empty()) {
+                size_t index = (m_offset + m_buffer.size() - distance) % m_buffer.size();
+                size_t chunk_size = min(min(output.size(), distance), min(m_buffer.size() - index, m_buffer.size() - m_offset));
+                memmove(&m_buffer[m_offset], &m_buffer[index], chunk_size);
+                memcpy(output.data(), &m_buffer[m_offset], chunk_size);
+                m_offset = (m_offset + chunk_size) % m_buffer.size();
+                m_total_written += chunk_size;
+                output = output.slice(chunk_size);
+
+                bytes_copied += chunk_size;
+                size_t repeating_distance = (offset + bytes_copied) / offset * offset;
+                if (repeating_distance <= m_buffer.size())
+                    distance = repeating_distance;
+            }
+        }
+
         size_t total_written() { return m_total_written; }
 
     private:
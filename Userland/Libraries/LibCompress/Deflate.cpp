@@ -8,8 +8,8 @@
 #include <AK/Array.h>
 #include <AK/Assertions.h>
 #include <AK/BinaryHeap.h>
-#include <AK/BinarySearch.h>
 #include <AK/BitStream.h>
+#include <AK/BuiltinWrappers.h>
 #include <AK/MemoryStream.h>
 #include <string.h>
 
@@ -64,18 +64,23 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
         }
     }
     if (non_zero_symbols == 1) { // special case - only 1 symbol
-        code.m_symbol_codes.append(0b10);
         code.m_symbol_values.append(last_non_zero);
+        code.m_code_count_of_length[1] = 1;
         code.m_bit_codes[last_non_zero] = 0;
         code.m_bit_code_lengths[last_non_zero] = 1;
+        for (size_t i = 0; i < code.m_fast_lookup.size(); i += 2)
+            code.m_fast_lookup[i] = (last_non_zero << 4) | 1;
         return code;
     }
 
     auto next_code = 0;
-    for (size_t code_length = 1; code_length <= 15; ++code_length) {
+    for (size_t code_length = 1; code_length <= max_code_length; ++code_length) {
         next_code <<= 1;
         auto start_bit = 1 << code_length;
 
+        code.m_first_code_of_length[code_length] = next_code;
+        code.m_first_index_of_length[code_length] = code.m_symbol_values.size();
+
         for (size_t symbol = 0; symbol < bytes.size(); ++symbol) {
             if (bytes[symbol] != code_length)
                 continue;
@@ -83,11 +88,16 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
             if (next_code > start_bit)
                 return {};
 
-            code.m_symbol_codes.append(start_bit | next_code);
             code.m_symbol_values.append(symbol);
+            code.m_code_count_of_length[code_length]++;
             code.m_bit_codes[symbol] = fast_reverse16(start_bit | next_code, code_length); // DEFLATE writes huffman encoded symbols as lsb-first
             code.m_bit_code_lengths[symbol] = code_length;
 
+            if (code_length <= fast_lookup_bits) {
+                for (size_t i = code.m_bit_codes[symbol]; i < code.m_fast_lookup.size(); i += 1 << code_length)
+                    code.m_fast_lookup[i] = (symbol << 4) | code_length;
+            }
+
             next_code++;
         }
     }
@@ -101,19 +111,27 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
 
 ErrorOr<u32> CanonicalCode::read_symbol(LittleEndianInputBitStream& stream) const
 {
-    u32 code_bits = 1;
-
-    for (;;) {
-        code_bits = code_bits << 1 | TRY(stream.read_bits(1));
-        if (code_bits >= (1 << 16))
-            return Error::from_string_literal("Symbol exceeds maximum symbol number");
-
-        // FIXME: This is very inefficient and could greatly be improved by implementing this
-        //        algorithm: https://www.hanshq.net/zip.html#huffdec
-        size_t index;
-        if (binary_search(m_symbol_codes.span(), code_bits, &index))
-            return m_symbol_values[index];
+    auto bits = TRY(stream.peek_bits(max_code_length));
+
+    if (auto entry = m_fast_lookup[bits & ((1 << fast_lookup_bits) - 1)]; entry != 0) {
+        TRY(stream.discard_previously_peeked_bits(entry & 0xf));
+        return entry >> 4;
     }
+
+    // The code is longer than the lookup table covers, so we look at one more bit at a time. Codes are sent with their
+    // most significant bit first, and the codes of each length are consecutive numbers.
+    u32 code = 0;
+    for (size_t code_length = 1; code_length <= max_code_length; ++code_length) {
+        code = (code << 1) | ((bits >> (code_length - 1)) & 1);
+
+        auto first_code = m_first_code_of_length[code_length];
+        if (code >= first_code && code - first_code < m_code_count_of_length[code_length]) {
+            TRY(stream.discard_previously_peeked_bits(code_length));
+            return m_symbol_values[m_first_index_of_length[code_length] + code - first_code];
+        }
+    }
+
+    return Error::from_string_literal("Symbol exceeds maximum symbol number");
 }
 
 ErrorOr<void> CanonicalCode::write_symbol(LittleEndianOutputBitStream& stream, u32 symbol) const
@@ -134,38 +152,51 @@ ErrorOr<bool> DeflateDecompressor::CompressedBlock::try_read_more()
     if (m_eof == true)
         return false;
 
-    auto const symbol = TRY(m_literal_codes.read_symbol(*m_decompressor.m_input_stream));
+    auto& input_stream = *m_decompressor.m_input_stream;
+    auto& output_buffer = m_decompressor.m_output_buffer;
 
-    if (symbol >= 286)
-        return Error::from_string_literal("Invalid deflate literal/length symbol");
+    // Decode as many symbols as surely fit into the output buffer, rather than going back to the caller for each one.
+    bool produced_output = false;
+    while (output_buffer.empty_space() >= DeflateCompressor::max_match_length) {
+        auto const symbol = TRY(m_literal_codes.read_symbol(input_stream));
+
+        if (symbol >= 286)
+            return Error::from_string_literal("Invalid deflate literal/length symbol");
+
+        if (symbol < 256) {
+            u8 byte_symbol = symbol;
+            output_buffer.write({ &byte_symbol, sizeof(byte_symbol) });
+            produced_output = true;
+            continue;
+        }
+
+        if (symbol == 256) {
+            m_eof = true;
+            return produced_output;
+        }
 
-    if (symbol < 256) {
-        u8 byte_symbol = symbol;
-        m_decompressor.m_output_buffer.write({ &byte_symbol, sizeof(byte_symbol) });
-        return true;
-    } else if (symbol == 256) {
-        m_eof = true;
-        return false;
-    } else {
         if (!m_distance_codes.has_value())
             return Error::from_string_literal("Distance codes have not been initialized");
 
         auto const length = TRY(m_decompressor.decode_length(symbol));
-        auto const distance_symbol = TRY(m_distance_codes.value().read_symbol(*m_decompressor.m_input_stream));
+        auto const distance_symbol = TRY(m_distance_codes.value().read_symbol(input_stream));
         if (distance_symbol >= 30)
             return Error::from_string_literal("Invalid deflate distance symbol");
 
         auto const distance = TRY(m_decompressor.decode_distance(distance_symbol));
 
-        for (size_t idx = 0; idx < length; ++idx) {
-            u8 byte = 0;
-            TRY(m_decompressor.m_output_buffer.read_with_seekback({ &byte, sizeof(byte) }, distance));
-
-            m_decompressor.m_output_buffer.write({ &byte, sizeof(byte) });
+        // A match may overlap the bytes it produces, so we copy at most `distance` bytes at a time.
+        Array<u8, DeflateCompressor::max_match_length> match_buffer;
+        size_t copied = 0;
+        while (copied < length) {
+            auto chunk = TRY(output_buffer.read_with_seekback(match_buffer.span().trim(min<size_t>(length - copied, distance)), distance));
+            output_buffer.write(chunk);
+            copied += chunk.size();
         }
-
-        return true;
+        produced_output = true;
     }
+
+    return true;
 }
 
 DeflateDecompressor::UncompressedBlock::UncompressedBlock(DeflateDecompressor& decompressor, size_t length)
@@ -190,13 +221,19 @@ ErrorOr<bool> DeflateDecompressor::UncompressedBlock::try_read_more()
 }
 
 ErrorOr<NonnullOwnPtr<DeflateDecompressor>> DeflateDecompressor::construct(MaybeOwned<Stream> stream)
+{
+    auto bit_stream = TRY(try_make<LittleEndianInputBitStream>(move(stream)));
+    return construct(MaybeOwned<LittleEndianInputBitStream>(move(bit_stream)));
+}
+
+ErrorOr<NonnullOwnPtr<DeflateDecompressor>> DeflateDecompressor::construct(MaybeOwned<LittleEndianInputBitStream> stream)
 {
     auto output_buffer = TRY(CircularBuffer::create_empty(32 * KiB));
     return TRY(adopt_nonnull_own_or_enomem(new (nothrow) DeflateDecompressor(move(stream), move(output_buffer))));
 }
 
-DeflateDecompressor::DeflateDecompressor(MaybeOwned<Stream> stream, CircularBuffer output_buffer)
-    : m_input_stream(make<LittleEndianInputBitStream>(move(stream)))
+DeflateDecompressor::DeflateDecompressor(MaybeOwned<LittleEndianInputBitStream> stream, CircularBuffer output_buffer)
+    : m_input_stream(move(stream))
     , m_output_buffer(move(output_buffer))
 {
 }
@@ -449,18 +486,25 @@ ErrorOr<void> DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Opt
 
 ErrorOr<NonnullOwnPtr<DeflateCompressor>> DeflateCompressor::construct(MaybeOwned<Stream> stream, CompressionLevel compression_level)
 {
+    return construct(move(stream), compression_constants[static_cast<int>(compression_level)]);
+}
+
+ErrorOr<NonnullOwnPtr<DeflateCompressor>> DeflateCompressor::construct(MaybeOwned<Stream> stream, CompressionConstants constants)
+{
+    VERIFY(constants.great_match_length <= max_match_length);
     auto bit_stream = TRY(try_make<LittleEndianOutputBitStream>(move(stream)));
-    auto deflate_compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DeflateCompressor(move(bit_stream), compression_level)));
+    auto deflate_compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DeflateCompressor(move(bit_stream), constants)));
     return deflate_compressor;
 }
 
-DeflateCompressor::DeflateCompressor(NonnullOwnPtr<LittleEndianOutputBitStream> stream, CompressionLevel compression_level)
-    : m_compression_level(compression_level)
-    , m_compression_constants(compression_constants[static_cast<int>(m_compression_level)])
+DeflateCompressor::DeflateCompressor(NonnullOwnPtr<LittleEndianOutputBitStream> stream, CompressionConstants constants)
+    : m_compression_constants(constants)
     , m_output_stream(move(stream))
 {
     m_symbol_frequencies.fill(0);
     m_distance_frequencies.fill(0);
+    for (auto& slot : m_hash_head)
+        slot = empty_slot;
 }
 
 DeflateCompressor::~DeflateCompressor()
@@ -514,14 +558,37 @@ size_t DeflateCompressor::compare_match_candidate(size_t start, size_t candidate
 {
     VERIFY(previous_match_length < maximum_match_length);
 
+    // Compares eight bytes at once, and returns how many of them are the same before the first one that differs.
+    auto matching_bytes_at = [&](size_t offset) -> size_t {
+        u64 start_bytes;
+        u64 candidate_bytes;
+        memcpy(&start_bytes, &m_rolling_window[start + offset], sizeof(u64));
+        memcpy(&candidate_bytes, &m_rolling_window[candidate + offset], sizeof(u64));
+        auto difference = AK::convert_between_host_and_little_endian(start_bytes ^ candidate_bytes);
+        return difference == 0 ? sizeof(u64) : count_trailing_zeroes(difference) / 8;
+    };
+
     // We firstly check that the match is at least (prev_match_length + 1) long, we check backwards as there's a higher chance the end mismatches
-    for (ssize_t i = previous_match_length; i >= 0; i--) {
-        if (m_rolling_window[start + i] != m_rolling_window[candidate + i])
+    size_t offset = previous_match_length + 1;
+    while (offset >= sizeof(u64)) {
+        offset -= sizeof(u64);
+        if (matching_bytes_at(offset) != sizeof(u64))
+            return 0;
+    }
+    while (offset > 0) {
+        offset--;
+        if (m_rolling_window[start + offset] != m_rolling_window[candidate + offset])
             return 0;
     }
 
     // Find the actual length
     auto match_length = previous_match_length + 1;
+    while (match_length + sizeof(u64) <= maximum_match_length) {
+        auto matching_bytes = matching_bytes_at(match_length);
+        match_length += matching_bytes;
+        if (matching_bytes != sizeof(u64))
+            return match_length;
+    }
     while (match_length < maximum_match_length && m_rolling_window[start + match_length] == m_rolling_window[candidate + match_length]) {
         match_length++;
     }
@@ -534,14 +601,16 @@ size_t DeflateCompressor::compare_match_candidate(size_t start, size_t candidate
 size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previous_match_length, size_t maximum_match_length, size_t& match_position)
 {
     auto max_chain_length = m_compression_constants.max_chain;
-    if (previous_match_length == 0)
+    if (previous_match_length == 0) {
         previous_match_length = min_match_length - 1; // we only care about matches that are at least min_match_length long
-    if (previous_match_length >= maximum_match_length)
-        return 0; // we can't improve a maximum length match
-    if (previous_match_length >= m_compression_constants.max_lazy_length)
-        return 0; // the previous match is already pretty, we shouldn't waste another full search
-    if (previous_match_length >= m_compression_constants.good_match_length)
-        max_chain_length /= 4; // we already have a pretty good much, so do a shorter search
+    } else {
+        if (previous_match_length >= maximum_match_length)
+            return 0; // we can't improve a maximum length match
+        if (previous_match_length >= m_compression_constants.max_lazy_length)
+            return 0; // the previous match is already pretty, we shouldn't waste another full search
+        if (previous_match_length >= m_compression_constants.good_match_length)
+            max_chain_length /= 4; // we already have a pretty good much, so do a shorter search
+    }
 
     auto candidate = m_hash_head[hash];
     auto match_found = false;
@@ -550,7 +619,7 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             break; // no remaining candidates
 
         VERIFY(candidate < start);
-        if (start - candidate > window_size)
+        if (start - candidate > max_match_distance)
             break; // outside the window
 
         auto match_length = compare_match_candidate(start, candidate, previous_match_length, maximum_match_length);
@@ -560,8 +629,8 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             match_position = candidate;
             previous_match_length = match_length;
 
-            if (match_length == maximum_match_length)
-                return match_length; // bail if we got the maximum possible length
+            if (match_length >= m_compression_constants.great_match_length || match_length == maximum_match_length)
+                return match_length; // bail if we got a great match, or the maximum possible length
         }
 
         candidate = m_hash_prev[candidate % window_size];
@@ -648,17 +717,29 @@ void DeflateCompressor::generate_huffman_lengths(Array<u8, Size>& lengths, Array
     }
 }
 
-void DeflateCompressor::lz77_compress_block()
+ALWAYS_INLINE void DeflateCompressor::insert_hash(size_t position, u16 hash)
 {
-    for (auto& slot : m_hash_head) { // initialize chained hash table
-        slot = empty_slot;
-    }
+    auto window_position = position % window_size;
+    m_hash_prev[window_position] = m_hash_head[hash];
+    m_hash_head[hash] = window_position;
+}
 
-    auto insert_hash = [&](auto pos, auto hash) {
-        auto window_pos = pos % window_size;
-        m_hash_prev[window_pos] = m_hash_head[hash];
-        m_hash_head[hash] = window_pos;
+void DeflateCompressor::slide_hash_chains()
+{
+    auto slide = [](u16 position) -> u16 {
+        return (position == empty_slot || position < block_size) ? empty_slot : position - block_size;
     };
+    for (auto& slot : m_hash_head)
+        slot = slide(slot);
+    for (size_t position = 0; position < block_size; position++)
+        m_hash_prev[position] = slide(m_hash_prev[position + block_size]);
+}
+
+void DeflateCompressor::lz77_compress_block()
+{
+    // The last few sequences of the previous block (or the preset dictionary) continue into this one, so they couldn't be hashed before.
+    for (size_t position = block_size - min(m_history_size, min_match_length - 1); position < block_size; position++)
+        insert_hash(position, hash_sequence(&m_rolling_window[position]));
 
     auto emit_literal = [&](auto literal) {
         VERIFY(m_pending_symbol_size <= block_size + 1);
@@ -680,25 +761,41 @@ void DeflateCompressor::lz77_compress_block()
     size_t previous_match_length = 0;
     size_t previous_match_position = 0;
 
-    VERIFY(m_compression_constants.great_match_length <= max_match_length);
-
     // our block starts at block_size and is m_pending_block_size in length
     auto block_end = block_size + m_pending_block_size;
+    auto hashable_end = block_end - min_match_length + 1;
     size_t current_position;
-    for (current_position = block_size; current_position < block_end - min_match_length + 1; current_position++) {
+    for (current_position = block_size; current_position < hashable_end; current_position++) {
         auto hash = hash_sequence(&m_rolling_window[current_position]);
         size_t match_position;
         auto match_length = find_back_match(current_position, hash, previous_match_length,
-            min(m_compression_constants.great_match_length, block_end - current_position), match_position);
+            min(max_match_length, block_end - current_position), match_position);
 
         insert_hash(current_position, hash);
 
+        if (!m_compression_constants.lazy_matching) {
+            if (match_length == 0) {
+                emit_literal(m_rolling_window[current_position]);
+                continue;
+            }
+
+            emit_back_reference(current_position - match_position, match_length);
+
+            // Adding every byte of long matches to the hash chains takes a while, and their bytes are likely to be found elsewhere as well.
+            if (match_length <= m_compression_constants.max_lazy_length) {
+                for (size_t j = current_position + 1; j < min(current_position + match_length, hashable_end); j++)
+                    insert_hash(j, hash_sequence(&m_rolling_window[j]));
+            }
+            current_position += match_length - 1;
+            continue;
+        }
+
         // if the previous match is as good as the new match, just use it
         if (previous_match_length != 0 && previous_match_length >= match_length) {
             emit_back_reference((current_position - 1) - previous_match_position, previous_match_length);
 
             // skip all the bytes that are included in this match
-            for (size_t j = current_position + 1; j < min(current_position - 1 + previous_match_length, block_end - min_match_length + 1); j++) {
+            for (size_t j = current_position + 1; j < min(current_position - 1 + previous_match_length, hashable_end); j++) {
                 insert_hash(j, hash_sequence(&m_rolling_window[j]));
             }
             current_position = (current_position - 1) + previous_match_length - 1;
@@ -933,7 +1030,7 @@ ErrorOr<void> DeflateCompressor::flush()
         return {};
     };
 
-    if (m_compression_level == CompressionLevel::STORE) { // disabled compression fast path
+    if (m_compression_constants.max_chain == 0) { // disabled compression fast path
         TRY(write_uncompressed());
         m_pending_block_size = 0;
         return {};
@@ -996,13 +1093,17 @@ ErrorOr<void> DeflateCompressor::flush()
     if (m_finished)
         TRY(m_output_stream->align_to_byte_boundary());
 
+    // The pending block becomes the history of the next one. Only the last block can be short, and nothing comes after it.
+    pending_block().trim(m_pending_block_size).copy_to({ m_rolling_window + block_size - m_pending_block_size, m_pending_block_size });
+    m_history_size = m_pending_block_size;
+    if (m_pending_block_size == block_size)
+        slide_hash_chains();
+
     // reset all block specific members
     m_pending_block_size = 0;
     m_pending_symbol_size = 0;
     m_symbol_frequencies.fill(0);
     m_distance_frequencies.fill(0);
-    // On the final block this copy will potentially produce an invalid search window, but since its the final block we dont care
-    pending_block().copy_trimmed_to({ m_rolling_window, block_size });
 
     return {};
 }
@@ -1015,6 +1116,34 @@ ErrorOr<void> DeflateCompressor::final_flush()
     return {};
 }
 
+void DeflateCompressor::set_preset_dictionary(ReadonlyBytes dictionary)
+{
+    VERIFY(m_pending_block_size == 0 && m_history_size == 0);
+    auto history = dictionary.slice_from_end(min(dictionary.size(), block_size));
+    history.copy_to({ m_rolling_window + block_size - history.size(), history.size() });
+    m_history_size = history.size();
+
+    // Matches may start anywhere in the dictionary, but its last few sequences continue into the first block.
+    for (size_t position = block_size - m_history_size; position + min_match_length <= block_size; position++)
+        insert_hash(position, hash_sequence(&m_rolling_window[position]));
+}
+
+ErrorOr<void> DeflateCompressor::sync_flush_and_finish()
+{
+    VERIFY(!m_finished);
+    if (m_pending_block_size > 0)
+        TRY(flush());
+    m_finished = true;
+
+    TRY(m_output_stream->write_bits(0b000u, 3)); // not the final block, no compression
+    TRY(m_output_stream->align_to_byte_boundary());
+    LittleEndian<u16> len = 0;
+    TRY(m_output_stream->write_entire_buffer(len.bytes()));
+    LittleEndian<u16> nlen = ~static_cast<u16>(0);
+    TRY(m_output_stream->write_entire_buffer(nlen.bytes()));
+    return {};
+}
+
 ErrorOr<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, CompressionLevel compression_level)
 {
     auto output_stream = TRY(try_make<AllocatingMemoryStream>());
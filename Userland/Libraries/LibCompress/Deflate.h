@@ -30,9 +30,17 @@ public:
     static Optional<CanonicalCode> from_bytes(ReadonlyBytes);
 
 private:
-    // Decompression - indexed by code
-    Vector<u16> m_symbol_codes;
-    Vector<u16> m_symbol_values;
+    static constexpr size_t max_code_length = 15;
+    static constexpr size_t fast_lookup_bits = 9;
+
+    // Decompression - codes of up to fast_lookup_bits bits are looked up by the next fast_lookup_bits bits of input
+    // in m_fast_lookup, which holds (symbol << 4) | code_length, or zero if the code is longer. Longer codes are found
+    // by walking the codes of each length, like in https://www.hanshq.net/zip.html#huffdec.
+    Array<u16, 1 << fast_lookup_bits> m_fast_lookup {};
+    Array<u16, max_code_length + 1> m_first_code_of_length {};
+    Array<u16, max_code_length + 1> m_first_index_of_length {};
+    Array<u16, max_code_length + 1> m_code_count_of_length {};
+    Vector<u16> m_symbol_values; // In the order of their codes
 
     // Compression - indexed by symbol
     Array<u16, 288> m_bit_codes {}; // deflate uses a maximum of 288 symbols (maximum of 32 for distances)
@@ -77,6 +85,8 @@ public:
     friend UncompressedBlock;
 
     static ErrorOr<NonnullOwnPtr<DeflateDecompressor>> construct(MaybeOwned<Stream> stream);
+    // Reads through a bit stream that something else reads from as well, e.g. the container around the deflate stream.
+    static ErrorOr<NonnullOwnPtr<DeflateDecompressor>> construct(MaybeOwned<LittleEndianInputBitStream> stream);
     ~DeflateDecompressor();
 
     virtual ErrorOr<Bytes> read(Bytes) override;
@@ -88,7 +98,7 @@ public:
     static ErrorOr<ByteBuffer> decompress_all(ReadonlyBytes);
 
 private:
-    DeflateDecompressor(MaybeOwned<Stream> stream, CircularBuffer buffer);
+    DeflateDecompressor(MaybeOwned<LittleEndianInputBitStream> stream, CircularBuffer buffer);
 
     ErrorOr<u32> decode_length(u32);
     ErrorOr<u32> decode_distance(u32);
@@ -115,26 +125,31 @@ public:
     static constexpr size_t max_huffman_distances = 32;
     static constexpr size_t min_match_length = 4;   // matches smaller than these are not worth the size of the back reference
     static constexpr size_t max_match_length = 258; // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t max_match_distance = 32 * KiB;
     static constexpr u16 empty_slot = UINT16_MAX;
 
     struct CompressionConstants {
         size_t good_match_length;  // Once we find a match of at least this length (a good enough match) we reduce max_chain to lower processing time
         size_t max_lazy_length;    // If the match is at least this long we dont defer matching to the next byte (which takes time) as its good enough
+                                   // Without lazy matching, only the bytes of matches up to this long are added to the hash chains
         size_t great_match_length; // Once we find a match of at least this length (a great match) we can just stop searching for longer ones
-        size_t max_chain;          // We only check the actual length of the max_chain closest matches
+        size_t max_chain;          // We only check the actual length of the max_chain closest matches, and store blocks if this is 0
+        bool lazy_matching;        // Whether we check if the match starting at the next byte is longer before using a match
     };
 
     // These constants were shamelessly "borrowed" from zlib
     static constexpr CompressionConstants compression_constants[] = {
-        { 0, 0, 0, 0 },
-        { 4, 4, 8, 4 },
-        { 8, 16, 128, 128 },
-        { 32, 258, 258, 4096 },
-        { max_match_length, max_match_length, max_match_length, 1 << hash_bits } // disable all limits
+        { 0, 0, 0, 0, false },
+        { 4, 0, 8, 1, false }, // a single probe into the hash chains, for when the data is compressed on the fly
+        { 4, 5, 16, 8, false },
+        { 8, 16, 128, 128, true },
+        { 32, 258, 258, 4096, true },
+        { max_match_length, max_match_length, max_match_length, 1 << hash_bits, true } // disable all limits
     };
 
     enum class CompressionLevel : int {
         STORE = 0,
+        FASTEST,
         FAST,
         GOOD,
         GREAT,
@@ -142,6 +157,7 @@ public:
     };
 
     static ErrorOr<NonnullOwnPtr<DeflateCompressor>> construct(MaybeOwned<Stream>, CompressionLevel = CompressionLevel::GOOD);
+    static ErrorOr<NonnullOwnPtr<DeflateCompressor>> construct(MaybeOwned<Stream>, CompressionConstants);
     ~DeflateCompressor();
 
     virtual ErrorOr<Bytes> read(Bytes) override;
@@ -151,10 +167,19 @@ public:
     virtual void close() override;
     ErrorOr<void> final_flush();
 
+    // Lets the first block refer back into `dictionary` (or rather, its last block_size bytes), as if it had come right before
+    // the data that is written. The decompressor has to have seen it as well, e.g. because it's the end of the data that was
+    // compressed into the same deflate stream before a sync flush. Must be called before anything is written.
+    void set_preset_dictionary(ReadonlyBytes dictionary);
+
+    // Ends the stream without a final block, but with an empty stored block that leaves the output byte-aligned
+    // (a "sync flush"). Another deflate stream can then be appended to it, as long as it doesn't refer back into this one.
+    ErrorOr<void> sync_flush_and_finish();
+
     static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD);
 
 private:
-    DeflateCompressor(NonnullOwnPtr<LittleEndianOutputBitStream>, CompressionLevel = CompressionLevel::GOOD);
+    DeflateCompressor(NonnullOwnPtr<LittleEndianOutputBitStream>, CompressionConstants);
 
     Bytes pending_block() { return { m_rolling_window + block_size, block_size }; }
 
@@ -162,7 +187,9 @@ private:
     static u16 hash_sequence(u8 const* bytes);
     size_t compare_match_candidate(size_t start, size_t candidate, size_t prev_match_length, size_t max_match_length);
     size_t find_back_match(size_t start, u16 hash, size_t previous_match_length, size_t max_match_length, size_t& match_position);
+    void insert_hash(size_t position, u16 hash);
     void lz77_compress_block();
+    void slide_hash_chains();
 
     // Huffman Coding
     struct code_length_symbol {
@@ -184,11 +211,12 @@ private:
     ErrorOr<void> flush();
 
     bool m_finished { false };
-    CompressionLevel m_compression_level;
     CompressionConstants m_compression_constants;
     NonnullOwnPtr<LittleEndianOutputBitStream> m_output_stream;
 
+    // The previous block (or the preset dictionary) ends at block_size, where the pending block starts.
     u8 m_rolling_window[window_size];
+    size_t m_history_size { 0 };
     size_t m_pending_block_size { 0 };
 
     struct [[gnu::packed]] {
@@ -202,7 +230,8 @@ private:
     Array<u16, max_huffman_literals> m_symbol_frequencies;    // there are 286 valid symbol values (symbols 286-287 never occur)
     Array<u16, max_huffman_distances> m_distance_frequencies; // there are 30 valid distance values (distances 30-31 never occur)
 
-    // LZ77 Chained hash table
+    // LZ77 Chained hash table, which holds positions in the rolling window. When a block is done, everything slides
+    // down by block_size, like the window itself.
     u16 m_hash_head[1 << hash_bits];
     u16 m_hash_prev[window_size];
 };
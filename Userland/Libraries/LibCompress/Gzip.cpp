@@ -10,6 +10,7 @@
 #include <AK/DeprecatedString.h>
 #include <AK/MemoryStream.h>
 #include <LibCore/DateTime.h>
+#include <LibThreading/ThreadPool.h>
 
 namespace Compress {
 
@@ -38,9 +39,9 @@ bool BlockHeader::supported_by_implementation() const
     return true;
 }
 
-ErrorOr<NonnullOwnPtr<GzipDecompressor::Member>> GzipDecompressor::Member::construct(BlockHeader header, Stream& stream)
+ErrorOr<NonnullOwnPtr<GzipDecompressor::Member>> GzipDecompressor::Member::construct(BlockHeader header, LittleEndianInputBitStream& stream)
 {
-    auto deflate_stream = TRY(DeflateDecompressor::construct(MaybeOwned<Stream>(stream)));
+    auto deflate_stream = TRY(DeflateDecompressor::construct(MaybeOwned<LittleEndianInputBitStream>(stream)));
     return TRY(adopt_nonnull_own_or_enomem(new (nothrow) Member(header, move(deflate_stream))));
 }
 
@@ -51,7 +52,7 @@ GzipDecompressor::Member::Member(BlockHeader header, NonnullOwnPtr<DeflateDecomp
 }
 
 GzipDecompressor::GzipDecompressor(NonnullOwnPtr<Stream> stream)
-    : m_input_stream(move(stream))
+    : m_input_stream(make<LittleEndianInputBitStream>(move(stream)))
 {
 }
 
@@ -186,8 +187,9 @@ ErrorOr<size_t> GzipDecompressor::write(ReadonlyBytes)
     return Error::from_errno(EBADF);
 }
 
-GzipCompressor::GzipCompressor(MaybeOwned<Stream> stream)
+GzipCompressor::GzipCompressor(MaybeOwned<Stream> stream, Threading::ThreadPool* thread_pool)
     : m_output_stream(move(stream))
+    , m_thread_pool(thread_pool)
 {
 }
 
@@ -196,6 +198,72 @@ ErrorOr<Bytes> GzipCompressor::read(Bytes)
     return Error::from_errno(EBADF);
 }
 
+// Chunks are made of whole deflate blocks, and each one gets the end of the chunk before it as its preset dictionary,
+// so the only difference to deflating everything at once is the empty stored block of the sync flush after every chunk.
+static constexpr size_t parallel_chunk_size = 8 * DeflateCompressor::block_size;
+
+struct DeflatedChunk {
+    ByteBuffer data;
+    u32 crc32 { 0 };
+    size_t uncompressed_size { 0 };
+    Optional<Error> error;
+};
+
+static ErrorOr<void> deflate_chunk(DeflatedChunk& chunk, ReadonlyBytes bytes, ReadonlyBytes preceding_bytes, bool is_last_chunk)
+{
+    chunk.crc32 = Crypto::Checksum::CRC32(bytes).digest();
+    chunk.uncompressed_size = bytes.size();
+
+    AllocatingMemoryStream output_stream;
+    auto deflate_stream = TRY(DeflateCompressor::construct(MaybeOwned<Stream>(output_stream)));
+    deflate_stream->set_preset_dictionary(preceding_bytes);
+    TRY(deflate_stream->write_entire_buffer(bytes));
+    if (is_last_chunk)
+        TRY(deflate_stream->final_flush());
+    else
+        TRY(deflate_stream->sync_flush_and_finish());
+
+    chunk.data = TRY(ByteBuffer::create_uninitialized(output_stream.used_buffer_size()));
+    TRY(output_stream.read_entire_buffer(chunk.data));
+    return {};
+}
+
+ErrorOr<u32> GzipCompressor::write_deflated_in_parallel(ReadonlyBytes bytes)
+{
+    auto chunk_count = ceil_div(bytes.size(), parallel_chunk_size);
+
+    // We only keep a few chunks per worker around at once, so that huge inputs don't need all of their output in memory.
+    auto chunks_per_batch = m_thread_pool->worker_count() * 2;
+    Vector<DeflatedChunk> chunks;
+    TRY(chunks.try_resize(min(chunk_count, chunks_per_batch)));
+
+    u32 crc32 = 0;
+    for (size_t first_chunk = 0; first_chunk < chunk_count; first_chunk += chunks_per_batch) {
+        auto batch_size = min(chunks_per_batch, chunk_count - first_chunk);
+        Threading::parallel_for(
+            batch_size, [&](size_t index) {
+                auto chunk_index = first_chunk + index;
+                auto start = chunk_index * parallel_chunk_size;
+                auto chunk_bytes = bytes.slice(start, min(parallel_chunk_size, bytes.size() - start));
+                auto& chunk = chunks[index];
+                chunk.error.clear();
+                if (auto result = deflate_chunk(chunk, chunk_bytes, bytes.trim(start), chunk_index == chunk_count - 1); result.is_error())
+                    chunk.error = result.release_error();
+            },
+            1, *m_thread_pool);
+
+        for (size_t index = 0; index < batch_size; ++index) {
+            auto& chunk = chunks[index];
+            if (chunk.error.has_value())
+                return chunk.error.release_value();
+            TRY(m_output_stream->write_entire_buffer(chunk.data));
+            crc32 = Crypto::Checksum::CRC32::combine(crc32, chunk.crc32, chunk.uncompressed_size);
+        }
+    }
+
+    return crc32;
+}
+
 ErrorOr<size_t> GzipCompressor::write(ReadonlyBytes bytes)
 {
     BlockHeader header;
@@ -207,12 +275,18 @@ ErrorOr<size_t> GzipCompressor::write(ReadonlyBytes bytes)
     header.extra_flags = 3;      // DEFLATE sets 2 for maximum compression and 4 for minimum compression
     header.operating_system = 3; // unix
     TRY(m_output_stream->write_entire_buffer({ &header, sizeof(header) }));
-    auto compressed_stream = TRY(DeflateCompressor::construct(MaybeOwned(*m_output_stream)));
-    TRY(compressed_stream->write_entire_buffer(bytes));
-    TRY(compressed_stream->final_flush());
-    Crypto::Checksum::CRC32 crc32;
-    crc32.update(bytes);
-    LittleEndian<u32> digest = crc32.digest();
+
+    LittleEndian<u32> digest;
+    if (m_thread_pool && bytes.size() > parallel_chunk_size) {
+        digest = TRY(write_deflated_in_parallel(bytes));
+    } else {
+        auto compressed_stream = TRY(DeflateCompressor::construct(MaybeOwned(*m_output_stream)));
+        TRY(compressed_stream->write_entire_buffer(bytes));
+        TRY(compressed_stream->final_flush());
+        Crypto::Checksum::CRC32 crc32;
+        crc32.update(bytes);
+        digest = crc32.digest();
+    }
     LittleEndian<u32> size = bytes.size();
     TRY(m_output_stream->write_entire_buffer(digest.bytes()));
     TRY(m_output_stream->write_entire_buffer(size.bytes()));
@@ -233,10 +307,10 @@ void GzipCompressor::close()
 {
 }
 
-ErrorOr<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes)
+ErrorOr<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes, Threading::ThreadPool* thread_pool)
 {
     auto output_stream = TRY(try_make<AllocatingMemoryStream>());
-    GzipCompressor gzip_stream { MaybeOwned<Stream>(*output_stream) };
+    GzipCompressor gzip_stream { MaybeOwned<Stream>(*output_stream), thread_pool };
 
     TRY(gzip_stream.write_entire_buffer(bytes));
 
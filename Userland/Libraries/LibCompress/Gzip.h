@@ -7,12 +7,17 @@
 
 #pragma once
 
+#include <AK/BitStream.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/OwnPtr.h>
 #include <AK/Stream.h>
 #include <LibCompress/Deflate.h>
 #include <LibCrypto/Checksum/CRC32.h>
 
+namespace Threading {
+class ThreadPool;
+}
+
 namespace Compress {
 
 constexpr u8 gzip_magic_1 = 0x1f;
@@ -58,7 +63,7 @@ public:
 private:
     class Member {
     public:
-        static ErrorOr<NonnullOwnPtr<Member>> construct(BlockHeader header, Stream&);
+        static ErrorOr<NonnullOwnPtr<Member>> construct(BlockHeader header, LittleEndianInputBitStream&);
 
         BlockHeader m_header;
         NonnullOwnPtr<DeflateDecompressor> m_stream;
@@ -72,7 +77,8 @@ private:
     Member const& current_member() const { return *m_current_member; }
     Member& current_member() { return *m_current_member; }
 
-    NonnullOwnPtr<Stream> m_input_stream;
+    // The deflate stream of each member reads ahead, so everything in between them has to be read through the same bit stream.
+    NonnullOwnPtr<LittleEndianInputBitStream> m_input_stream;
     u8 m_partial_header[sizeof(BlockHeader)];
     size_t m_partial_header_offset { 0 };
     OwnPtr<Member> m_current_member {};
@@ -82,7 +88,9 @@ private:
 
 class GzipCompressor final : public Stream {
 public:
-    GzipCompressor(MaybeOwned<Stream>);
+    // With a thread pool, large writes are split into chunks that are deflated at the same time. They still make up a
+    // single deflate stream, so the output is a regular gzip file, which is only a few bytes bigger per chunk.
+    GzipCompressor(MaybeOwned<Stream>, Threading::ThreadPool* = nullptr);
 
     virtual ErrorOr<Bytes> read(Bytes) override;
     virtual ErrorOr<size_t> write(ReadonlyBytes) override;
@@ -90,10 +98,13 @@ public:
     virtual bool is_open() const override;
     virtual void close() override;
 
-    static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes);
+    static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, Threading::ThreadPool* = nullptr);
 
 private:
+    ErrorOr<u32> write_deflated_in_parallel(ReadonlyBytes);
+
     MaybeOwned<Stream> m_output_stream;
+    Threading::ThreadPool* m_thread_pool { nullptr };
 };
 
 }
@@ -74,8 +74,7 @@ ErrorOr<NonnullOwnPtr<ZlibCompressor>> ZlibCompressor::construct(MaybeOwned<Stre
     // Zlib only defines Deflate as a compression method.
     auto compression_method = ZlibCompressionMethod::Deflate;
 
-    // FIXME: Find a way to compress with Deflate's "Best" compression level.
-    auto compressor_stream = TRY(DeflateCompressor::construct(MaybeOwned(*stream), static_cast<DeflateCompressor::CompressionLevel>(compression_level)));
+    auto compressor_stream = TRY(DeflateCompressor::construct(MaybeOwned(*stream), deflate_compression_level(compression_level)));
 
     auto zlib_compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) ZlibCompressor(move(stream), move(compressor_stream))));
     TRY(zlib_compressor->write_header(compression_method, compression_level));
@@ -94,7 +93,23 @@ ZlibCompressor::~ZlibCompressor()
     VERIFY(m_finished);
 }
 
-ErrorOr<void> ZlibCompressor::write_header(ZlibCompressionMethod compression_method, ZlibCompressionLevel compression_level)
+DeflateCompressor::CompressionLevel ZlibCompressor::deflate_compression_level(ZlibCompressionLevel compression_level)
+{
+    // FIXME: Find a way to compress with Deflate's "Best" compression level.
+    switch (compression_level) {
+    case ZlibCompressionLevel::Fastest:
+        return DeflateCompressor::CompressionLevel::FASTEST;
+    case ZlibCompressionLevel::Fast:
+        return DeflateCompressor::CompressionLevel::FAST;
+    case ZlibCompressionLevel::Default:
+        return DeflateCompressor::CompressionLevel::GOOD;
+    case ZlibCompressionLevel::Best:
+        return DeflateCompressor::CompressionLevel::GREAT;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+ZlibHeader ZlibCompressor::header_for(ZlibCompressionMethod compression_method, ZlibCompressionLevel compression_level)
 {
     u8 compression_info = 0;
     if (compression_method == ZlibCompressionMethod::Deflate) {
@@ -110,9 +125,13 @@ ErrorOr<void> ZlibCompressor::write_header(ZlibCompressionMethod compression_met
         .compression_level = compression_level,
     };
     header.check_bits = 0b11111 - header.as_u16 % 31;
+    return header;
+}
 
+ErrorOr<void> ZlibCompressor::write_header(ZlibCompressionMethod compression_method, ZlibCompressionLevel compression_level)
+{
     // FIXME: Support pre-defined dictionaries.
-
+    auto header = header_for(compression_method, compression_level);
     TRY(m_output_stream->write(header.as_u16.bytes()));
 
     return {};
@@ -14,6 +14,7 @@
 #include <AK/Span.h>
 #include <AK/Stream.h>
 #include <AK/Types.h>
+#include <LibCompress/Deflate.h>
 #include <LibCrypto/Checksum/Adler32.h>
 
 namespace Compress {
@@ -76,6 +77,12 @@ public:
 
     static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, ZlibCompressionLevel = ZlibCompressionLevel::Default);
 
+    // The header that starts every stream compressed at this level, for writers that put together the rest of the stream themselves.
+    static ZlibHeader header_for(ZlibCompressionMethod, ZlibCompressionLevel);
+
+    // The level that DeflateCompressor compresses at for each of the levels a zlib header can announce.
+    static DeflateCompressor::CompressionLevel deflate_compression_level(ZlibCompressionLevel);
+
 private:
     ZlibCompressor(MaybeOwned<Stream> stream, NonnullOwnPtr<Stream> compressor_stream);
     ErrorOr<void> write_header(ZlibCompressionMethod, ZlibCompressionLevel);
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/BuiltinWrappers.h>
+#include <AK/kmalloc.h>
+#include <LibCore/Coroutine.h>
+
+namespace Core {
+
+// Frames are rounded up to a power of two from 64 bytes up to 4 KiB, larger ones come straight from malloc.
+static constexpr size_t smallest_frame_size_class = 6;
+static constexpr size_t largest_frame_size_class = 12;
+// How many freed frames of each size we hold on to, so that a burst of tasks doesn't keep its memory forever.
+static constexpr size_t max_cached_frames_per_size_class = 64;
+
+struct FreeFrame {
+    FreeFrame* next;
+};
+
+struct FrameCache {
+    FreeFrame* first { nullptr };
+    size_t count { 0 };
+};
+
+// Every thread has its own cache, so taking and returning frames doesn't need any locking.
+static thread_local Array<FrameCache, largest_frame_size_class - smallest_frame_size_class + 1> s_frame_caches;
+
+static size_t size_class_for(size_t size)
+{
+    if (size <= (1u << smallest_frame_size_class))
+        return smallest_frame_size_class;
+    return sizeof(size_t) * 8 - count_leading_zeroes(size - 1);
+}
+
+void* CoroutineFrameAllocator::allocate(size_t size)
+{
+    auto size_class = size_class_for(size);
+    if (size_class > largest_frame_size_class) {
+        auto* frame = kmalloc(size);
+        VERIFY(frame);
+        return frame;
+    }
+
+    auto& cache = s_frame_caches[size_class - smallest_frame_size_class];
+    if (auto* frame = cache.first) {
+        cache.first = frame->next;
+        --cache.count;
+        return frame;
+    }
+
+    auto* frame = kmalloc(1u << size_class);
+    VERIFY(frame);
+    return frame;
+}
+
+void CoroutineFrameAllocator::deallocate(void* pointer, size_t size)
+{
+    auto size_class = size_class_for(size);
+    if (size_class > largest_frame_size_class) {
+        kfree_sized(pointer, size);
+        return;
+    }
+
+    auto& cache = s_frame_caches[size_class - smallest_frame_size_class];
+    if (cache.count == max_cached_frames_per_size_class) {
+        kfree_sized(pointer, 1u << size_class);
+        return;
+    }
+
+    auto* frame = static_cast<FreeFrame*>(pointer);
+    frame->next = cache.first;
+    cache.first = frame;
+    ++cache.count;
+}
+
+}
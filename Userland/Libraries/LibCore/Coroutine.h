@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Assertions.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/RefPtr.h>
+#include <AK/StdLibExtras.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Socket.h>
+#include <LibCore/Timer.h>
+#include <coroutine>
+
+namespace Core {
+
+// Coroutine frames come and go with every task, so freed ones are kept around by size to be reused by the next task.
+class CoroutineFrameAllocator {
+public:
+    static void* allocate(size_t);
+    static void deallocate(void*, size_t);
+};
+
+// Resumes the coroutine from the event loop, once whatever woke it up has returned.
+inline void resume_from_event_loop(std::coroutine_handle<> handle)
+{
+    deferred_invoke([handle] { handle.resume(); });
+}
+
+template<typename T = void>
+class Task;
+
+namespace Detail {
+
+struct TaskPromiseBase {
+    static void* operator new(size_t size) { return CoroutineFrameAllocator::allocate(size); }
+    static void operator delete(void* pointer, size_t size) { CoroutineFrameAllocator::deallocate(pointer, size); }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            auto& promise = handle.promise();
+            if (promise.continuation)
+                return promise.continuation;
+            if (promise.is_detached)
+                handle.destroy();
+            return std::noop_coroutine();
+        }
+
+        void await_resume() noexcept { }
+    };
+
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() { VERIFY_NOT_REACHED(); }
+
+    std::coroutine_handle<> continuation;
+    bool is_detached { false };
+};
+
+template<typename T>
+struct TaskPromise : public TaskPromiseBase {
+    Task<T> get_return_object();
+
+    template<typename U>
+    void return_value(U&& value) { result = forward<U>(value); }
+
+    Optional<T> result;
+};
+
+template<>
+struct TaskPromise<void> : public TaskPromiseBase {
+    Task<void> get_return_object();
+
+    void return_void() { }
+};
+
+}
+
+// A coroutine that doesn't start until it's awaited with co_await, started with await(), or detached.
+// Destroying a task that hasn't finished destroys its coroutine wherever it is suspended.
+// NOTE: GCC can't compile co_await inside TRY() or MUST(), so await into a variable first.
+template<typename T>
+class [[nodiscard]] Task {
+    AK_MAKE_NONCOPYABLE(Task);
+
+public:
+    using promise_type = Detail::TaskPromise<T>;
+
+    Task(Task&& other)
+        : m_handle(exchange(other.m_handle, {}))
+    {
+    }
+
+    Task& operator=(Task&& other)
+    {
+        if (this != &other) {
+            if (m_handle)
+                m_handle.destroy();
+            m_handle = exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+
+    ~Task()
+    {
+        if (m_handle)
+            m_handle.destroy();
+    }
+
+    bool is_done() const { return !m_handle || m_handle.done(); }
+
+    auto operator co_await() && noexcept
+    {
+        struct Awaiter {
+            bool await_ready() noexcept { return handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+            {
+                handle.promise().continuation = caller;
+                return handle;
+            }
+
+            T await_resume()
+            {
+                if constexpr (!IsVoid<T>)
+                    return handle.promise().result.release_value();
+            }
+
+            std::coroutine_handle<promise_type> handle;
+        };
+        VERIFY(m_handle);
+        return Awaiter { m_handle };
+    }
+
+    // Starts the task and pumps the current event loop until it's done, for code that isn't a coroutine itself.
+    T await()
+    {
+        VERIFY(m_handle);
+        m_handle.resume();
+        while (!m_handle.done())
+            EventLoop::current().pump();
+        if constexpr (!IsVoid<T>)
+            return m_handle.promise().result.release_value();
+    }
+
+    // Starts the task and lets it clean up after itself once it's done. Nothing can wait for it after this.
+    void detach() &&
+    {
+        VERIFY(m_handle);
+        auto handle = exchange(m_handle, {});
+        handle.promise().is_detached = true;
+        handle.resume();
+    }
+
+private:
+    friend struct Detail::TaskPromise<T>;
+
+    explicit Task(std::coroutine_handle<promise_type> handle)
+        : m_handle(handle)
+    {
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+template<typename T>
+Task<T> Detail::TaskPromise<T>::get_return_object()
+{
+    return Task<T> { std::coroutine_handle<TaskPromise>::from_promise(*this) };
+}
+
+inline Task<void> Detail::TaskPromise<void>::get_return_object()
+{
+    return Task<void> { std::coroutine_handle<TaskPromise>::from_promise(*this) };
+}
+
+// Suspends the coroutine for the given number of milliseconds: `co_await Core::delay(100);`
+class DelayAwaiter {
+public:
+    explicit DelayAwaiter(int milliseconds)
+        : m_milliseconds(milliseconds)
+    {
+    }
+
+    bool await_ready() const { return m_milliseconds <= 0; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_timer = MUST(Timer::create_single_shot(m_milliseconds, [handle] { resume_from_event_loop(handle); }));
+        m_timer->start();
+    }
+
+    void await_resume() { }
+
+private:
+    int m_milliseconds { 0 };
+    RefPtr<Timer> m_timer;
+};
+
+inline DelayAwaiter delay(int milliseconds)
+{
+    return DelayAwaiter { milliseconds };
+}
+
+class SocketReadAwaiter {
+public:
+    SocketReadAwaiter(Socket& socket, Bytes buffer)
+        : m_socket(socket)
+        , m_buffer(buffer)
+    {
+    }
+
+    bool await_ready() const
+    {
+        // Errors are left for the read to report.
+        auto can_read = m_socket.can_read_without_blocking();
+        return can_read.is_error() || can_read.value() || !m_socket.is_open();
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_socket.set_notifications_enabled(true);
+        m_socket.on_ready_to_read = [this, handle] {
+            m_socket.on_ready_to_read = nullptr;
+            m_socket.set_notifications_enabled(false);
+            // The coroutine may want to wait for the next read right away, which it can't do while we're still inside on_ready_to_read.
+            resume_from_event_loop(handle);
+        };
+    }
+
+    ErrorOr<Bytes> await_resume() { return m_socket.read(m_buffer); }
+
+private:
+    Socket& m_socket;
+    Bytes m_buffer;
+};
+
+inline SocketReadAwaiter Socket::read_some(Bytes buffer)
+{
+    return SocketReadAwaiter { *this, buffer };
+}
+
+}
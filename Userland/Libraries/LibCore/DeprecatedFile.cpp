@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteBuffer.h>
 #include <AK/LexicalPath.h>
 #include <AK/Platform.h>
 #include <AK/ScopeGuard.h>
@@ -422,7 +423,7 @@ ErrorOr<void, DeprecatedFile::CopyError> DeprecatedFile::copy_file_or_directory(
     if (source.is_directory()) {
         if (recursion_mode == RecursionMode::Disallowed)
             return CopyError { errno, true };
-        return copy_directory(dst_path, src_path, src_stat);
+        return copy_directory(dst_path, src_path, src_stat, link_mode, preserve_mode);
     }
 
     if (link_mode == LinkMode::Allowed) {
@@ -455,16 +456,45 @@ ErrorOr<void, DeprecatedFile::CopyError> DeprecatedFile::copy_file(DeprecatedStr
             return CopyError { errno, false };
     }
 
-    for (;;) {
-        char buffer[32768];
-        ssize_t nread = ::read(source.fd(), buffer, sizeof(buffer));
+    bool copied_by_kernel = false;
+#ifdef AK_OS_LINUX
+    // Let the kernel move the data, which avoids copying it through our address space and allows for reflinks.
+    if (src_stat.st_size > 0) {
+        for (;;) {
+            auto ncopied = copy_file_range(source.fd(), nullptr, dst_fd, nullptr, 1 * MiB, 0);
+            if (ncopied < 0) {
+                // The file offsets are where the kernel left off, so reading and writing can take over from there.
+                if (errno == EXDEV || errno == EINVAL || errno == ENOSYS || errno == EOPNOTSUPP)
+                    break;
+                return CopyError { errno, false };
+            }
+            if (ncopied == 0) {
+                copied_by_kernel = true;
+                break;
+            }
+        }
+    }
+#endif
+
+    ByteBuffer buffer;
+    if (!copied_by_kernel) {
+        // Big blocks mean fewer round trips through the kernel, which matters most for large files.
+        static constexpr size_t copy_buffer_size = 256 * KiB;
+        auto buffer_or_error = ByteBuffer::create_uninitialized(copy_buffer_size);
+        if (buffer_or_error.is_error())
+            return CopyError { ENOMEM, false };
+        buffer = buffer_or_error.release_value();
+    }
+
+    while (!copied_by_kernel) {
+        ssize_t nread = ::read(source.fd(), buffer.data(), buffer.size());
         if (nread < 0) {
             return CopyError { errno, false };
         }
         if (nread == 0)
             break;
         ssize_t remaining_to_write = nread;
-        char* bufptr = buffer;
+        u8* bufptr = buffer.data();
         while (remaining_to_write) {
             ssize_t nwritten = ::write(dst_fd, bufptr, remaining_to_write);
             if (nwritten < 0)
@@ -526,10 +556,11 @@ ErrorOr<void, DeprecatedFile::CopyError> DeprecatedFile::copy_directory(Deprecat
 
     while (di.has_next()) {
         DeprecatedString filename = di.next_path();
+        // The directory was only just created, so there's nothing in it that the copies could clash with.
         auto result = copy_file_or_directory(
             DeprecatedString::formatted("{}/{}", dst_path, filename),
             DeprecatedString::formatted("{}/{}", src_path, filename),
-            RecursionMode::Allowed, link, AddDuplicateFileMarker::Yes, preserve_mode);
+            RecursionMode::Allowed, link, AddDuplicateFileMarker::No, preserve_mode);
         if (result.is_error())
             return result.release_error();
     }
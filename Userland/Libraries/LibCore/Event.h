@@ -48,11 +48,15 @@ private:
     bool m_accepted { true };
 };
 
+// Deferred invocations are created all the time, so they get enough inline capacity for most callables
+// (including the wrapper made by Object::deferred_invoke()) to not need a separate allocation.
+using DeferredInvocationFunction = Function<void(), 8 * sizeof(void*)>;
+
 class DeferredInvocationEvent : public Event {
     friend class EventLoop;
 
 public:
-    DeferredInvocationEvent(NonnullRefPtr<DeferredInvocationContext> context, Function<void()> invokee)
+    DeferredInvocationEvent(NonnullRefPtr<DeferredInvocationContext> context, DeferredInvocationFunction invokee)
         : Event(Event::Type::DeferredInvoke)
         , m_context(move(context))
         , m_invokee(move(invokee))
@@ -61,7 +65,7 @@ public:
 
 private:
     NonnullRefPtr<DeferredInvocationContext> m_context;
-    Function<void()> m_invokee;
+    DeferredInvocationFunction m_invokee;
 };
 
 class TimerEvent final : public Event {
@@ -6,11 +6,14 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/Assertions.h>
 #include <AK/Badge.h>
+#include <AK/BuiltinWrappers.h>
 #include <AK/Debug.h>
 #include <AK/Format.h>
 #include <AK/IDAllocator.h>
+#include <AK/IntrusiveList.h>
 #include <AK/JsonObject.h>
 #include <AK/JsonValue.h>
 #include <AK/NeverDestroyed.h>
@@ -24,10 +27,13 @@
 #include <LibCore/Object.h>
 #include <LibCore/SessionManagement.h>
 #include <LibCore/Socket.h>
+#include <LibCore/System.h>
+#include <LibCore/TimerWheel.h>
 #include <LibThreading/Mutex.h>
 #include <LibThreading/MutexProtected.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <signal.h>
 #include <stdio.h>
 #include <string.h>
@@ -37,6 +43,11 @@
 #include <time.h>
 #include <unistd.h>
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+#    include <sys/epoll.h>
+#    define EVENTLOOP_HAS_EPOLL
+#endif
+
 #ifdef AK_OS_SERENITY
 #    include <LibCore/Account.h>
 
@@ -49,20 +60,55 @@ class InspectorServerConnection;
 
 [[maybe_unused]] static bool connect_to_inspector_server();
 
-struct EventLoopTimer {
+// Timers are kept on a timer wheel with a tick per millisecond, or on the parked list while their owner can't see them fire.
+struct EventLoopTimer : public TimerWheel::Entry {
     int timer_id { 0 };
     Time interval;
-    Time fire_time;
     bool should_reload { false };
+    bool is_parked { false };
     TimerShouldFireWhenNotVisible fire_when_not_visible { TimerShouldFireWhenNotVisible::No };
+    TimerPrecision precision { TimerPrecision::Precise };
     WeakPtr<Object> owner;
 
-    void reload(Time const& now);
-    bool has_expired(Time const& now) const;
+    TimerWheel::Ticks next_expiration(TimerWheel::Ticks now) const;
 };
 
+static TimerWheel::Ticks current_timer_tick()
+{
+    return Time::now_monotonic_coarse().to_truncated_milliseconds();
+}
+
+static void fire_expired_timers(EventLoop&, TimerWheel::Ticks now);
+
 struct EventLoop::Private {
-    Threading::Mutex lock;
+    struct RemoteEvent {
+        WeakPtr<Object> receiver;
+        OwnPtr<Event> event;
+        // Objects can only be created on the thread that uses them, so the loop makes the context for deferred invocations.
+        DeferredInvocationFunction invokee;
+        // Dropped when the loop takes it if an identical custom event is already queued, see wake_once().
+        bool is_wake_once { false };
+        RemoteEvent* next { nullptr };
+    };
+
+    void push_remote_event(RemoteEvent* remote_event)
+    {
+        auto* head = remote_events.load(AK::MemoryOrder::memory_order_relaxed);
+        do {
+            remote_event->next = head;
+        } while (!remote_events.compare_exchange_strong(head, remote_event, AK::MemoryOrder::memory_order_acq_rel));
+    }
+
+    ~Private()
+    {
+        for (auto* remote_event = remote_events.load(); remote_event;)
+            delete exchange(remote_event, remote_event->next);
+    }
+
+    // Events posted from other threads, newest first. The loop always takes all of them at once, which leaves nothing
+    // for the posting threads to get wrong with each other but the push.
+    Atomic<RemoteEvent*> remote_events { nullptr };
+    pthread_t thread { pthread_self() };
 };
 
 static Threading::MutexProtected<NeverDestroyed<IDAllocator>> s_id_allocator;
@@ -71,11 +117,103 @@ static Threading::MutexProtected<RefPtr<InspectorServerConnection>> s_inspector_
 // Each thread has its own event loop stack, its own timers, notifiers and a wake pipe.
 static thread_local Vector<EventLoop&>* s_event_loop_stack;
 static thread_local HashMap<int, NonnullOwnPtr<EventLoopTimer>>* s_timers;
+static thread_local TimerWheel* s_timer_wheel;
+static thread_local TimerWheel::List* s_parked_timers;
 static thread_local HashTable<Notifier*>* s_notifiers;
+
+#ifdef EVENTLOOP_HAS_EPOLL
+// Where epoll is available, notifiers stay registered with it instead of being handed to select() on every
+// iteration, so waking up only costs as much as the number of fds that are actually ready.
+// s_epoll_fd is -1 if we couldn't set it up, in which case we fall back to select().
+struct EpollInterest {
+    Vector<Notifier*, 1> notifiers;
+    bool is_registered { false };
+};
+static thread_local int s_epoll_fd { -1 };
+static thread_local HashMap<int, EpollInterest>* s_epoll_interests;
+#endif
+
 // The wake pipe is both responsible for notifying us when someone calls wake(), as well as POSIX signals.
 // While wake() pushes zero into the pipe, signal numbers (by defintion nonzero, see signal_numbers.h) are pushed into the pipe verbatim.
 thread_local int EventLoop::s_wake_pipe_fds[2];
 thread_local bool EventLoop::s_wake_pipe_initialized { false };
+thread_local Atomic<bool> EventLoop::s_wake_pending { false };
+
+#ifdef EVENTLOOP_HAS_EPOLL
+static void disable_epoll()
+{
+    close(s_epoll_fd);
+    s_epoll_fd = -1;
+    s_epoll_interests->clear();
+}
+
+static void initialize_epoll(int wake_pipe_read_fd)
+{
+    // After a fork, the epoll instance is still shared with the parent, so we need a new one.
+    if (s_epoll_fd >= 0)
+        disable_epoll();
+
+    auto epoll_fd_or_error = System::epoll_create(EPOLL_CLOEXEC);
+    if (epoll_fd_or_error.is_error()) {
+        dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop: Falling back to select(): {}", epoll_fd_or_error.error());
+        return;
+    }
+    s_epoll_fd = epoll_fd_or_error.release_value();
+
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.fd = wake_pipe_read_fd;
+    if (auto result = System::epoll_ctl(s_epoll_fd, EPOLL_CTL_ADD, wake_pipe_read_fd, &event); result.is_error()) {
+        dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop: Falling back to select(): {}", result.error());
+        disable_epoll();
+    }
+}
+
+static void update_epoll_interest(int fd)
+{
+    if (s_epoll_fd < 0)
+        return;
+
+    auto it = s_epoll_interests->find(fd);
+    if (it == s_epoll_interests->end())
+        return;
+    auto& interest = it->value;
+
+    if (interest.notifiers.is_empty()) {
+        // NOTE: The fd may have been closed already, which is fine, as the kernel drops the interest along with it.
+        if (interest.is_registered)
+            (void)System::epoll_ctl(s_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        s_epoll_interests->remove(it);
+        return;
+    }
+
+    epoll_event event {};
+    for (auto* notifier : interest.notifiers) {
+        if (notifier->event_mask() & Notifier::Read)
+            event.events |= EPOLLIN;
+        if (notifier->event_mask() & Notifier::Write)
+            event.events |= EPOLLOUT;
+        if (notifier->event_mask() & Notifier::Exceptional)
+            VERIFY_NOT_REACHED();
+    }
+    event.data.fd = fd;
+
+    auto result = System::epoll_ctl(s_epoll_fd, interest.is_registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &event);
+    // If the fd was closed and reused behind our back, the old interest is gone (ENOENT), or the kernel still has it (EEXIST).
+    if (result.is_error() && result.error().code() == ENOENT)
+        result = System::epoll_ctl(s_epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    else if (result.is_error() && result.error().code() == EEXIST)
+        result = System::epoll_ctl(s_epoll_fd, EPOLL_CTL_MOD, fd, &event);
+
+    if (result.is_error()) {
+        // Some files can't be watched with epoll (e.g. regular files on Linux). select() can handle anything, so switch back to it.
+        dbgln("Core::EventLoop: Falling back to select(), couldn't watch fd {}: {}", fd, result.error());
+        disable_epoll();
+        return;
+    }
+    interest.is_registered = true;
+}
+#endif
 
 void EventLoop::initialize_wake_pipes()
 {
@@ -90,6 +228,9 @@ void EventLoop::initialize_wake_pipes()
 #endif
         VERIFY(rc == 0);
         s_wake_pipe_initialized = true;
+#ifdef EVENTLOOP_HAS_EPOLL
+        initialize_epoll(s_wake_pipe_fds[0]);
+#endif
     }
 }
 
@@ -313,6 +454,7 @@ private:
 
 EventLoop::EventLoop([[maybe_unused]] MakeInspectable make_inspectable)
     : m_wake_pipe_fds(&s_wake_pipe_fds)
+    , m_wake_pending(&s_wake_pending)
     , m_private(make<Private>())
 {
 #ifdef AK_OS_SERENITY
@@ -330,7 +472,12 @@ EventLoop::EventLoop([[maybe_unused]] MakeInspectable make_inspectable)
     if (!s_event_loop_stack) {
         s_event_loop_stack = new Vector<EventLoop&>;
         s_timers = new HashMap<int, NonnullOwnPtr<EventLoopTimer>>;
+        s_timer_wheel = new TimerWheel(current_timer_tick());
+        s_parked_timers = new TimerWheel::List;
         s_notifiers = new HashTable<Notifier*>;
+#ifdef EVENTLOOP_HAS_EPOLL
+        s_epoll_interests = new HashMap<int, EpollInterest>;
+#endif
     }
 
     if (s_event_loop_stack->is_empty()) {
@@ -457,11 +604,8 @@ size_t EventLoop::pump(WaitMode mode)
 {
     wait_for_event(mode);
 
-    decltype(m_queued_events) events;
-    {
-        Threading::MutexLocker locker(m_private->lock);
-        events = move(m_queued_events);
-    }
+    take_remote_events();
+    auto events = move(m_queued_events);
 
     size_t processed_events = 0;
     for (size_t i = 0; i < events.size(); ++i) {
@@ -489,7 +633,6 @@ size_t EventLoop::pump(WaitMode mode)
         ++processed_events;
 
         if (m_exit_requested) {
-            Threading::MutexLocker locker(m_private->lock);
             dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop: Exit requested. Rejigging {} events.", events.size() - i);
             decltype(m_queued_events) new_event_queue;
             new_event_queue.ensure_capacity(m_queued_events.size() + events.size());
@@ -504,32 +647,110 @@ size_t EventLoop::pump(WaitMode mode)
     return processed_events;
 }
 
+bool EventLoop::is_on_own_thread() const
+{
+    return pthread_equal(pthread_self(), m_private->thread);
+}
+
 void EventLoop::post_event(Object& receiver, NonnullOwnPtr<Event>&& event, ShouldWake should_wake)
 {
-    Threading::MutexLocker lock(m_private->lock);
-    dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop::post_event: ({}) << receiver={}, event={}", m_queued_events.size(), receiver, event);
-    m_queued_events.empend(receiver, move(event));
+    if (is_on_own_thread()) {
+        dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop::post_event: ({}) << receiver={}, event={}", m_queued_events.size(), receiver, event);
+        m_queued_events.empend(receiver, move(event));
+    } else {
+        dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop::post_event: (from another thread) << receiver={}, event={}", receiver, event);
+        post_remote_event(receiver, move(event), false);
+    }
     if (should_wake == ShouldWake::Yes)
         wake();
 }
 
-void EventLoop::wake_once(Object& receiver, int custom_event_type)
+void EventLoop::deferred_invoke(DeferredInvocationFunction invokee)
 {
-    Threading::MutexLocker lock(m_private->lock);
-    dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop::wake_once: event type {}", custom_event_type);
-    auto identical_events = m_queued_events.find_if([&](auto& queued_event) {
+    if (!is_on_own_thread()) {
+        post_remote_invocation(move(invokee));
+        return;
+    }
+    auto context = DeferredInvocationContext::construct();
+    post_event(context, make<Core::DeferredInvocationEvent>(context, move(invokee)));
+}
+
+void EventLoop::post_remote_event(Object& receiver, NonnullOwnPtr<Event>&& event, bool is_wake_once)
+{
+    auto* remote_event = new Private::RemoteEvent;
+    remote_event->receiver = receiver;
+    remote_event->event = move(event);
+    remote_event->is_wake_once = is_wake_once;
+    m_private->push_remote_event(remote_event);
+}
+
+void EventLoop::post_remote_invocation(DeferredInvocationFunction invokee)
+{
+    auto* remote_event = new Private::RemoteEvent;
+    remote_event->invokee = move(invokee);
+    m_private->push_remote_event(remote_event);
+}
+
+void EventLoop::take_remote_events()
+{
+    auto* remote_event = m_private->remote_events.exchange(nullptr, AK::MemoryOrder::memory_order_acq_rel);
+    if (!remote_event)
+        return;
+
+    // The events were pushed newest first, so turn them around to queue them in the order they were posted.
+    Private::RemoteEvent* oldest = nullptr;
+    while (remote_event) {
+        auto* next = remote_event->next;
+        remote_event->next = oldest;
+        oldest = remote_event;
+        remote_event = next;
+    }
+
+    while (oldest) {
+        if (oldest->invokee) {
+            auto context = DeferredInvocationContext::construct();
+            m_queued_events.empend(context, make<DeferredInvocationEvent>(context, move(oldest->invokee)));
+        } else if (auto receiver = oldest->receiver.strong_ref()) {
+            // Like events for receivers that are gone by the time the loop gets to them, events for receivers that are gone already are dropped.
+            if (!oldest->is_wake_once || !has_queued_custom_event(*receiver, static_cast<CustomEvent const&>(*oldest->event).custom_type()))
+                m_queued_events.empend(*receiver, oldest->event.release_nonnull());
+        }
+        delete exchange(oldest, oldest->next);
+    }
+}
+
+bool EventLoop::has_queued_custom_event(Object const& receiver, int custom_event_type) const
+{
+    return m_queued_events.find_if([&](auto& queued_event) {
         if (queued_event.receiver.is_null())
             return false;
         auto const& event = queued_event.event;
         auto is_receiver_identical = queued_event.receiver.ptr() == &receiver;
         auto event_id_matches = event->type() == Event::Type::Custom && static_cast<CustomEvent const*>(event.ptr())->custom_type() == custom_event_type;
         return is_receiver_identical && event_id_matches;
-    });
+    }) != m_queued_events.end();
+}
+
+void EventLoop::wake_once(Object& receiver, int custom_event_type)
+{
+    dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop::wake_once: event type {}", custom_event_type);
+    if (!is_on_own_thread()) {
+        // Only the loop's own thread can look at its queue, so the loop drops the event later if it turns out to be a duplicate.
+        post_remote_event(receiver, make<CustomEvent>(custom_event_type), true);
+        wake();
+        return;
+    }
     // Event is not in the queue yet, so we want to wake.
-    if (identical_events.is_end())
+    if (!has_queued_custom_event(receiver, custom_event_type))
         post_event(receiver, make<CustomEvent>(custom_event_type), ShouldWake::Yes);
 }
 
+void EventLoop::take_pending_events_from(EventLoop& other)
+{
+    other.take_remote_events();
+    m_queued_events.extend(move(other.m_queued_events));
+}
+
 SignalHandlers::SignalHandlers(int signo, void (*handle_signal)(int))
     : m_signo(signo)
     , m_original_handler(signal(signo, handle_signal))
@@ -664,9 +885,12 @@ void EventLoop::notify_forked(ForkEvent event)
     switch (event) {
     case ForkEvent::Child:
         s_event_loop_stack->clear();
+        s_parked_timers->clear();
+        s_timer_wheel->clear();
         s_timers->clear();
         s_notifiers->clear();
         s_wake_pipe_initialized = false;
+        s_wake_pending = false;
         initialize_wake_pipes();
         if (auto* info = signals_info<false>()) {
             info->signal_handlers.clear();
@@ -683,39 +907,44 @@ void EventLoop::wait_for_event(WaitMode mode)
 {
     fd_set rfds;
     fd_set wfds;
+#ifdef EVENTLOOP_HAS_EPOLL
+    Array<epoll_event, 64> epoll_events;
+#endif
 retry:
-
-    // Set up the file descriptors for select().
-    // Basically, we translate high-level event information into low-level selectable file descriptors.
-    FD_ZERO(&rfds);
-    FD_ZERO(&wfds);
+#ifdef EVENTLOOP_HAS_EPOLL
+    // The notifiers are already registered with epoll, so there's nothing to set up here.
+    bool const use_epoll = s_epoll_fd >= 0;
+#else
+    bool const use_epoll = false;
+#endif
 
     int max_fd = 0;
-    auto add_fd_to_set = [&max_fd](int fd, fd_set& set) {
-        FD_SET(fd, &set);
-        if (fd > max_fd)
-            max_fd = fd;
-    };
+    if (!use_epoll) {
+        // Set up the file descriptors for select().
+        // Basically, we translate high-level event information into low-level selectable file descriptors.
+        FD_ZERO(&rfds);
+        FD_ZERO(&wfds);
+
+        auto add_fd_to_set = [&max_fd](int fd, fd_set& set) {
+            FD_SET(fd, &set);
+            if (fd > max_fd)
+                max_fd = fd;
+        };
 
-    int max_fd_added = -1;
-    // The wake pipe informs us of POSIX signals as well as manual calls to wake()
-    add_fd_to_set(s_wake_pipe_fds[0], rfds);
-    max_fd = max(max_fd, max_fd_added);
+        // The wake pipe informs us of POSIX signals as well as manual calls to wake()
+        add_fd_to_set(s_wake_pipe_fds[0], rfds);
 
-    for (auto& notifier : *s_notifiers) {
-        if (notifier->event_mask() & Notifier::Read)
-            add_fd_to_set(notifier->fd(), rfds);
-        if (notifier->event_mask() & Notifier::Write)
-            add_fd_to_set(notifier->fd(), wfds);
-        if (notifier->event_mask() & Notifier::Exceptional)
-            VERIFY_NOT_REACHED();
+        for (auto& notifier : *s_notifiers) {
+            if (notifier->event_mask() & Notifier::Read)
+                add_fd_to_set(notifier->fd(), rfds);
+            if (notifier->event_mask() & Notifier::Write)
+                add_fd_to_set(notifier->fd(), wfds);
+            if (notifier->event_mask() & Notifier::Exceptional)
+                VERIFY_NOT_REACHED();
+        }
     }
 
-    bool queued_events_is_empty;
-    {
-        Threading::MutexLocker locker(m_private->lock);
-        queued_events_is_empty = m_queued_events.is_empty();
-    }
+    bool queued_events_is_empty = m_queued_events.is_empty() && !m_private->remote_events.load(AK::MemoryOrder::memory_order_acquire);
 
     // Figure out how long to wait at maximum.
     // This mainly depends on the WaitMode and whether we have pending events, but also the next expiring timer.
@@ -735,9 +964,17 @@ retry:
         }
     }
 
+    int marked_fd_count;
 try_select_again:
     // select() and wait for file system events, calls to wake(), POSIX signals, or timer expirations.
-    int marked_fd_count = select(max_fd + 1, &rfds, &wfds, nullptr, should_wait_forever ? nullptr : &timeout);
+#ifdef EVENTLOOP_HAS_EPOLL
+    if (use_epoll) {
+        // Round up, so we don't wake up just before the next timer expires.
+        int timeout_ms = should_wait_forever ? -1 : static_cast<int>(timeout.tv_sec * 1000 + (timeout.tv_usec + 999) / 1000);
+        marked_fd_count = epoll_wait(s_epoll_fd, epoll_events.data(), static_cast<int>(epoll_events.size()), timeout_ms);
+    } else
+#endif
+        marked_fd_count = select(max_fd + 1, &rfds, &wfds, nullptr, should_wait_forever ? nullptr : &timeout);
     // Because POSIX, we might spuriously return from select() with EINTR; just select again.
     if (marked_fd_count < 0) {
         int saved_errno = errno;
@@ -750,9 +987,20 @@ try_select_again:
         VERIFY_NOT_REACHED();
     }
 
+    bool wake_pipe_is_readable = false;
+#ifdef EVENTLOOP_HAS_EPOLL
+    if (use_epoll) {
+        for (int i = 0; i < marked_fd_count; ++i) {
+            if (epoll_events[i].data.fd == s_wake_pipe_fds[0])
+                wake_pipe_is_readable = true;
+        }
+    } else
+#endif
+        wake_pipe_is_readable = FD_ISSET(s_wake_pipe_fds[0], &rfds);
+
     // We woke up due to a call to wake() or a POSIX signal.
     // Handle signals and see whether we need to handle events as well.
-    if (FD_ISSET(s_wake_pipe_fds[0], &rfds)) {
+    if (wake_pipe_is_readable) {
         int wake_events[8];
         ssize_t nread;
         // We might receive another signal while read()ing here. The signal will go to the handle_signal properly,
@@ -776,40 +1024,41 @@ try_select_again:
             else
                 wake_requested = true;
         }
+        // Anything posted before this is picked up by the pump that follows, anything after it needs a new wakeup.
+        if (wake_requested)
+            s_wake_pending = false;
 
         if (!wake_requested && nread == sizeof(wake_events))
             goto retry;
     }
 
-    if (!s_timers->is_empty()) {
-        now = Time::now_monotonic_coarse();
-    }
+    if (!s_timer_wheel->is_empty() || !s_parked_timers->is_empty())
+        fire_expired_timers(*this, current_timer_tick());
 
-    // Handle expired timers.
-    for (auto& it : *s_timers) {
-        auto& timer = *it.value;
-        if (!timer.has_expired(now))
-            continue;
-        auto owner = timer.owner.strong_ref();
-        if (timer.fire_when_not_visible == TimerShouldFireWhenNotVisible::No
-            && owner && !owner->is_visible_for_timer_purposes()) {
-            continue;
-        }
-
-        dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop: Timer {} has expired, sending Core::TimerEvent to {}", timer.timer_id, *owner);
+    if (!marked_fd_count)
+        return;
 
-        if (owner)
-            post_event(*owner, make<TimerEvent>(timer.timer_id));
-        if (timer.should_reload) {
-            timer.reload(now);
-        } else {
-            // FIXME: Support removing expired timers that don't want to reload.
-            VERIFY_NOT_REACHED();
+#ifdef EVENTLOOP_HAS_EPOLL
+    if (use_epoll) {
+        // Handle file system notifiers by making them normal events.
+        for (int i = 0; i < marked_fd_count; ++i) {
+            auto const& event = epoll_events[i];
+            auto it = s_epoll_interests->find(event.data.fd);
+            if (it == s_epoll_interests->end())
+                continue;
+            // Like select(), treat hang-ups and errors as the fd being readable, and errors as it being writable.
+            bool is_readable = event.events & (EPOLLIN | EPOLLHUP | EPOLLERR);
+            bool is_writable = event.events & (EPOLLOUT | EPOLLERR);
+            for (auto* notifier : it->value.notifiers) {
+                if (is_readable && (notifier->event_mask() & Notifier::Event::Read))
+                    post_event(*notifier, make<NotifierReadEvent>(notifier->fd()));
+                if (is_writable && (notifier->event_mask() & Notifier::Event::Write))
+                    post_event(*notifier, make<NotifierWriteEvent>(notifier->fd()));
+            }
         }
-    }
-
-    if (!marked_fd_count)
         return;
+    }
+#endif
 
     // Handle file system notifiers by making them normal events.
     for (auto& notifier : *s_notifiers) {
@@ -824,49 +1073,80 @@ try_select_again:
     }
 }
 
-bool EventLoopTimer::has_expired(Time const& now) const
+TimerWheel::Ticks EventLoopTimer::next_expiration(TimerWheel::Ticks now) const
 {
-    return now > fire_time;
+    // A timer never fires on the tick it's started in, which also keeps timers without an interval from firing twice per wakeup.
+    auto expiration = now + max<i64>(interval.to_milliseconds(), 1);
+    if (precision == TimerPrecision::Precise)
+        return expiration;
+
+    // Coarse timers are pushed back to a multiple of the largest power of two that's at most an eighth of their interval,
+    // and at most about a second. Timers with similar intervals then land on the same ticks and fire together.
+    auto slack = clamp<i64>(interval.to_milliseconds() / 8, 1, 1024);
+    auto granularity = 1ull << (sizeof(u64) * 8 - 1 - count_leading_zeroes(static_cast<u64>(slack)));
+    return round_up_to_power_of_two(expiration, granularity);
 }
 
-void EventLoopTimer::reload(Time const& now)
+static void fire_timer(EventLoop& event_loop, EventLoopTimer& timer, RefPtr<Object> const& owner, TimerWheel::Ticks now)
 {
-    fire_time = now + interval;
+    dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop: Timer {} has expired, sending Core::TimerEvent to {}", timer.timer_id, *owner);
+
+    if (owner)
+        event_loop.post_event(*owner, make<TimerEvent>(timer.timer_id));
+    // Timers that don't reload stay registered, but won't fire again.
+    if (timer.should_reload)
+        s_timer_wheel->schedule(timer, timer.next_expiration(now));
 }
 
-Optional<Time> EventLoop::get_next_timer_expiration()
+static void fire_expired_timers(EventLoop& event_loop, TimerWheel::Ticks now)
 {
-    auto now = Time::now_monotonic_coarse();
-    Optional<Time> soonest {};
-    for (auto& it : *s_timers) {
-        auto& fire_time = it.value->fire_time;
-        auto owner = it.value->owner.strong_ref();
-        if (it.value->fire_when_not_visible == TimerShouldFireWhenNotVisible::No
-            && owner && !owner->is_visible_for_timer_purposes()) {
+    // Parked timers have expired while their owner wasn't visible, and fire as soon as it is again.
+    for (auto count = s_parked_timers->size_slow(); count > 0; --count) {
+        auto& timer = static_cast<EventLoopTimer&>(*s_parked_timers->take_first());
+        auto owner = timer.owner.strong_ref();
+        if (owner && !owner->is_visible_for_timer_purposes()) {
+            s_parked_timers->append(timer);
             continue;
         }
-        // OPTIMIZATION: If we have a timer that needs to fire right away, we can stop looking here.
-        // FIXME: This whole operation could be O(1) with a better data structure.
-        if (fire_time < now)
-            return now;
-        if (!soonest.has_value() || fire_time < soonest.value())
-            soonest = fire_time;
+        timer.is_parked = false;
+        fire_timer(event_loop, timer, owner, now);
     }
-    return soonest;
+
+    s_timer_wheel->advance(now, [&](TimerWheel::Entry& entry) {
+        auto& timer = static_cast<EventLoopTimer&>(entry);
+        auto owner = timer.owner.strong_ref();
+        if (timer.fire_when_not_visible == TimerShouldFireWhenNotVisible::No
+            && owner && !owner->is_visible_for_timer_purposes()) {
+            timer.is_parked = true;
+            s_parked_timers->append(timer);
+            return;
+        }
+        fire_timer(event_loop, timer, owner, now);
+    });
+}
+
+Optional<Time> EventLoop::get_next_timer_expiration()
+{
+    // Parked timers don't count, as they wait for their owner to become visible rather than for time to pass.
+    auto expiration = s_timer_wheel->next_expiration();
+    if (!expiration.has_value())
+        return {};
+    return Time::from_milliseconds(*expiration);
 }
 
-int EventLoop::register_timer(Object& object, int milliseconds, bool should_reload, TimerShouldFireWhenNotVisible fire_when_not_visible)
+int EventLoop::register_timer(Object& object, int milliseconds, bool should_reload, TimerShouldFireWhenNotVisible fire_when_not_visible, TimerPrecision precision)
 {
     VERIFY_EVENT_LOOP_INITIALIZED();
     VERIFY(milliseconds >= 0);
     auto timer = make<EventLoopTimer>();
     timer->owner = object;
     timer->interval = Time::from_milliseconds(milliseconds);
-    timer->reload(Time::now_monotonic_coarse());
     timer->should_reload = should_reload;
     timer->fire_when_not_visible = fire_when_not_visible;
+    timer->precision = precision;
     int timer_id = s_id_allocator.with_locked([](auto& allocator) { return allocator->allocate(); });
     timer->timer_id = timer_id;
+    s_timer_wheel->schedule(*timer, timer->next_expiration(current_timer_tick()));
     s_timers->set(timer_id, move(timer));
     return timer_id;
 }
@@ -878,6 +1158,11 @@ bool EventLoop::unregister_timer(int timer_id)
     auto it = s_timers->find(timer_id);
     if (it == s_timers->end())
         return false;
+    auto& timer = *it->value;
+    if (timer.is_parked)
+        s_parked_timers->remove(timer);
+    else if (timer.list_node.is_in_list())
+        s_timer_wheel->cancel(timer);
     s_timers->remove(it);
     return true;
 }
@@ -886,12 +1171,39 @@ void EventLoop::register_notifier(Badge<Notifier>, Notifier& notifier)
 {
     VERIFY_EVENT_LOOP_INITIALIZED();
     s_notifiers->set(&notifier);
+#ifdef EVENTLOOP_HAS_EPOLL
+    if (s_epoll_fd >= 0) {
+        auto& notifiers = s_epoll_interests->ensure(notifier.fd()).notifiers;
+        if (!notifiers.contains_slow(&notifier))
+            notifiers.append(&notifier);
+        update_epoll_interest(notifier.fd());
+    }
+#endif
 }
 
 void EventLoop::unregister_notifier(Badge<Notifier>, Notifier& notifier)
 {
     VERIFY_EVENT_LOOP_INITIALIZED();
     s_notifiers->remove(&notifier);
+#ifdef EVENTLOOP_HAS_EPOLL
+    if (s_epoll_fd >= 0) {
+        if (auto it = s_epoll_interests->find(notifier.fd()); it != s_epoll_interests->end()) {
+            it->value.notifiers.remove_first_matching([&](auto* entry) { return entry == &notifier; });
+            update_epoll_interest(notifier.fd());
+        }
+    }
+#endif
+}
+
+void EventLoop::notifier_event_mask_changed(Badge<Notifier>, Notifier& notifier)
+{
+    VERIFY_EVENT_LOOP_INITIALIZED();
+#ifdef EVENTLOOP_HAS_EPOLL
+    if (s_epoll_fd >= 0 && s_notifiers->contains(&notifier))
+        update_epoll_interest(notifier.fd());
+#else
+    (void)notifier;
+#endif
 }
 
 void EventLoop::wake_current()
@@ -902,6 +1214,9 @@ void EventLoop::wake_current()
 void EventLoop::wake()
 {
     dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop::wake()");
+    // A single wakeup makes the loop look at everything that was posted until then, so a burst of wakes only writes once.
+    if (m_wake_pending->exchange(true))
+        return;
     int wake_event = 0;
     int nwritten = write((*m_wake_pipe_fds)[1], &wake_event, sizeof(wake_event));
     if (nwritten < 0) {
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Forward.h>
 #include <AK/Function.h>
 #include <AK/HashMap.h>
@@ -80,15 +81,11 @@ public:
     // Pump the event loop until some condition is met.
     void spin_until(Function<bool()>);
 
-    // Post an event to this event loop and possibly wake the loop.
+    // Post an event to this event loop and possibly wake the loop. Other threads can post without taking any locks.
     void post_event(Object& receiver, NonnullOwnPtr<Event>&&, ShouldWake = ShouldWake::No);
     void wake_once(Object& receiver, int custom_event_type);
 
-    void deferred_invoke(Function<void()> invokee)
-    {
-        auto context = DeferredInvocationContext::construct();
-        post_event(context, make<Core::DeferredInvocationEvent>(context, move(invokee)));
-    }
+    void deferred_invoke(DeferredInvocationFunction);
 
     void wake();
 
@@ -97,11 +94,12 @@ public:
     bool was_exit_requested() const { return m_exit_requested; }
 
     // The registration functions act upon the current loop of the current thread.
-    static int register_timer(Object&, int milliseconds, bool should_reload, TimerShouldFireWhenNotVisible);
+    static int register_timer(Object&, int milliseconds, bool should_reload, TimerShouldFireWhenNotVisible, TimerPrecision);
     static bool unregister_timer(int timer_id);
 
     static void register_notifier(Badge<Notifier>, Notifier&);
     static void unregister_notifier(Badge<Notifier>, Notifier&);
+    static void notifier_event_mask_changed(Badge<Notifier>, Notifier&);
 
     static int register_signal(int signo, Function<void(int)> handler);
     static void unregister_signal(int handler_id);
@@ -113,10 +111,7 @@ public:
     };
     static void notify_forked(ForkEvent);
 
-    void take_pending_events_from(EventLoop& other)
-    {
-        m_queued_events.extend(move(other.m_queued_events));
-    }
+    void take_pending_events_from(EventLoop& other);
 
     static EventLoop& current();
 
@@ -124,6 +119,11 @@ public:
 
 private:
     void wait_for_event(WaitMode);
+    bool is_on_own_thread() const;
+    void post_remote_event(Object& receiver, NonnullOwnPtr<Event>&&, bool is_wake_once);
+    void post_remote_invocation(DeferredInvocationFunction);
+    void take_remote_events();
+    bool has_queued_custom_event(Object const& receiver, int custom_event_type) const;
     Optional<Time> get_next_timer_expiration();
     static void dispatch_signal(int);
     static void handle_signal(int);
@@ -148,15 +148,18 @@ private:
 
     static thread_local int s_wake_pipe_fds[2];
     static thread_local bool s_wake_pipe_initialized;
+    // Whether a wakeup has been written to the wake pipe that the loop hasn't read yet.
+    static thread_local Atomic<bool> s_wake_pending;
 
     // The wake pipe of this event loop needs to be accessible from other threads.
     int (*m_wake_pipe_fds)[2];
+    Atomic<bool>* m_wake_pending;
 
     struct Private;
     NonnullOwnPtr<Private> m_private;
 };
 
-inline void deferred_invoke(Function<void()> invokee)
+inline void deferred_invoke(DeferredInvocationFunction invokee)
 {
     EventLoop::current().deferred_invoke(move(invokee));
 }
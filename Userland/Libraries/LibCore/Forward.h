@@ -33,6 +33,7 @@ class Object;
 class ObjectClassRegistration;
 class ProcessStatisticsReader;
 class Socket;
+class SocketReadAwaiter;
 class SocketAddress;
 class TCPServer;
 class TCPSocket;
@@ -41,6 +42,7 @@ class TimerEvent;
 class UDPServer;
 class UDPSocket;
 
+enum class TimerPrecision;
 enum class TimerShouldFireWhenNotVisible;
 
 }
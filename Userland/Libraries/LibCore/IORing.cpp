@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <LibCore/IORing.h>
+#include <LibCore/System.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+namespace Core {
+
+ErrorOr<NonnullOwnPtr<IORing>> IORing::create(u32 entries)
+{
+    auto fd = TRY(System::io_ring_create(entries, O_CLOEXEC));
+    auto mapping_or_error = System::mmap(nullptr, io_ring_mapping_size(entries), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping_or_error.is_error()) {
+        (void)System::close(fd);
+        return mapping_or_error.release_error();
+    }
+    return adopt_nonnull_own_or_enomem(new (nothrow) IORing(fd, mapping_or_error.value(), entries));
+}
+
+IORing::IORing(int fd, void* mapping, u32 entries)
+    : m_fd(fd)
+    , m_mapping(mapping)
+    , m_entries(entries)
+{
+}
+
+IORing::~IORing()
+{
+    MUST(System::munmap(m_mapping, io_ring_mapping_size(m_entries)));
+    MUST(System::close(m_fd));
+}
+
+u32 IORing::pending_submission_count() const
+{
+    auto const& queue = header().submission;
+    return AK::atomic_load(&queue.tail, AK::MemoryOrder::memory_order_relaxed) - AK::atomic_load(&queue.head, AK::MemoryOrder::memory_order_acquire);
+}
+
+bool IORing::try_queue(IORingSubmission const& submission)
+{
+    if (pending_submission_count() >= m_entries)
+        return false;
+    auto& queue = header().submission;
+    auto tail = AK::atomic_load(&queue.tail, AK::MemoryOrder::memory_order_relaxed);
+    auto* entries = reinterpret_cast<IORingSubmission*>(static_cast<u8*>(m_mapping) + io_ring_submission_entries_offset());
+    entries[tail & (m_entries - 1)] = submission;
+    AK::atomic_store(&queue.tail, tail + 1, AK::MemoryOrder::memory_order_release);
+    return true;
+}
+
+ErrorOr<u32> IORing::submit()
+{
+    auto pending = pending_submission_count();
+    if (pending == 0)
+        return 0;
+    return System::io_ring_enter(m_fd, pending);
+}
+
+Optional<IORingCompletion> IORing::pop_completion()
+{
+    auto& queue = header().completion;
+    auto head = AK::atomic_load(&queue.head, AK::MemoryOrder::memory_order_relaxed);
+    if (head == AK::atomic_load(&queue.tail, AK::MemoryOrder::memory_order_acquire))
+        return {};
+    auto const* entries = reinterpret_cast<IORingCompletion const*>(static_cast<u8 const*>(m_mapping) + io_ring_completion_entries_offset(m_entries));
+    auto completion = entries[head & (2 * m_entries - 1)];
+    AK::atomic_store(&queue.head, head + 1, AK::MemoryOrder::memory_order_release);
+    return completion;
+}
+
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Types.h>
+#include <Kernel/API/IORing.h>
+
+namespace Core {
+
+// Batches file and socket I/O through a ring shared with the kernel, so that many small
+// reads and writes only cost a single io_ring_enter() syscall.
+class IORing {
+    AK_MAKE_NONCOPYABLE(IORing);
+    AK_MAKE_NONMOVABLE(IORing);
+
+public:
+    static ErrorOr<NonnullOwnPtr<IORing>> create(u32 entries);
+    ~IORing();
+
+    // Queues a submission without entering the kernel. Returns false if the submission queue is full.
+    bool try_queue(IORingSubmission const&);
+    // Hands all queued submissions to the kernel and returns how many of them it has consumed.
+    ErrorOr<u32> submit();
+    Optional<IORingCompletion> pop_completion();
+
+    u32 pending_submission_count() const;
+
+private:
+    IORing(int fd, void* mapping, u32 entries);
+
+    IORingHeader& header() { return *reinterpret_cast<IORingHeader*>(m_mapping); }
+    IORingHeader const& header() const { return *reinterpret_cast<IORingHeader const*>(m_mapping); }
+
+    int m_fd { -1 };
+    void* m_mapping { nullptr };
+    u32 m_entries { 0 };
+};
+
+}
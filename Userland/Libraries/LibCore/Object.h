@@ -65,6 +65,12 @@ enum class TimerShouldFireWhenNotVisible {
     Yes
 };
 
+// Coarse timers may fire a little later than asked, so that the event loop can wake up once for several of them.
+enum class TimerPrecision {
+    Precise = 0,
+    Coarse
+};
+
 #define C_OBJECT(klass)                                                                    \
 public:                                                                                    \
     virtual StringView class_name() const override                                         \
@@ -141,7 +147,7 @@ public:
     Object* parent() { return m_parent; }
     Object const* parent() const { return m_parent; }
 
-    void start_timer(int ms, TimerShouldFireWhenNotVisible = TimerShouldFireWhenNotVisible::No);
+    void start_timer(int ms, TimerShouldFireWhenNotVisible = TimerShouldFireWhenNotVisible::No, TimerPrecision = TimerPrecision::Precise);
     void stop_timer();
     bool has_timer() const { return m_timer_id; }
 
@@ -8,6 +8,7 @@
 #include <AK/JsonArray.h>
 #include <AK/JsonObject.h>
 #include <AK/JsonValue.h>
+#include <Kernel/API/ProcessStatistics.h>
 #include <LibCore/File.h>
 #include <LibCore/ProcessStatisticsReader.h>
 #include <pwd.h>
@@ -16,13 +17,124 @@ namespace Core {
 
 HashMap<uid_t, DeprecatedString> ProcessStatisticsReader::s_usernames;
 
-ErrorOr<AllProcessesStatistics> ProcessStatisticsReader::get_all(SeekableStream& proc_all_file, bool include_usernames)
+template<typename RecordType>
+static ErrorOr<RecordType> read_record(ReadonlyBytes record_bytes)
 {
-    TRY(proc_all_file.seek(0, SeekMode::SetPosition));
+    // Fields that the kernel didn't write (yet) are left zeroed.
+    auto const& header = *reinterpret_cast<Kernel::ProcessStatisticsRecordHeader const*>(record_bytes.data());
+    if (header.fixed_size < sizeof(Kernel::ProcessStatisticsRecordHeader) || header.fixed_size > header.size)
+        return Error::from_string_literal("Invalid process statistics record");
+    RecordType record {};
+    memcpy(&record, record_bytes.data(), min<size_t>(header.fixed_size, sizeof(RecordType)));
+    return record;
+}
+
+static ErrorOr<DeprecatedString> read_string(ReadonlyBytes record_bytes, size_t& offset, u32 length)
+{
+    if (offset + length > record_bytes.size())
+        return Error::from_string_literal("Invalid process statistics record");
+    auto string = DeprecatedString(StringView { record_bytes.slice(offset, length) });
+    offset += length;
+    return string;
+}
+
+ErrorOr<AllProcessesStatistics> ProcessStatisticsReader::get_all_from_binary(ReadonlyBytes bytes, bool include_usernames)
+{
+    if (bytes.size() < sizeof(Kernel::ProcessStatisticsHeader))
+        return Error::from_string_literal("Invalid process statistics header");
+    auto const& header = *reinterpret_cast<Kernel::ProcessStatisticsHeader const*>(bytes.data());
+    if (header.magic != Kernel::process_statistics_magic || header.header_size > bytes.size())
+        return Error::from_string_literal("Invalid process statistics header");
 
     AllProcessesStatistics all_processes_statistics;
+    all_processes_statistics.total_time_scheduled = header.total_time_scheduled;
+    all_processes_statistics.total_time_scheduled_kernel = header.total_time_scheduled_kernel;
+
+    ProcessStatistics* process = nullptr;
+    for (size_t offset = header.header_size; offset < bytes.size();) {
+        if (bytes.size() - offset < sizeof(Kernel::ProcessStatisticsRecordHeader))
+            return Error::from_string_literal("Invalid process statistics record");
+        auto const& record_header = *reinterpret_cast<Kernel::ProcessStatisticsRecordHeader const*>(bytes.offset_pointer(offset));
+        if (record_header.size > bytes.size() - offset)
+            return Error::from_string_literal("Invalid process statistics record");
+        auto record_bytes = bytes.slice(offset, record_header.size);
+        offset += record_header.size;
+        size_t string_offset = record_header.fixed_size;
+
+        switch (record_header.type) {
+        case Kernel::ProcessStatisticsRecordType::Process: {
+            auto record = TRY(read_record<Kernel::ProcessStatisticsRecord>(record_bytes));
+            ProcessStatistics new_process;
+            new_process.pid = record.pid;
+            new_process.pgid = record.pgid;
+            new_process.pgp = record.pgp;
+            new_process.sid = record.sid;
+            new_process.uid = record.uid;
+            new_process.gid = record.gid;
+            new_process.ppid = record.ppid;
+            new_process.nfds = record.nfds;
+            new_process.kernel = record.kernel;
+            new_process.name = TRY(read_string(record_bytes, string_offset, record.name_length));
+            new_process.executable = TRY(read_string(record_bytes, string_offset, record.executable_length));
+            new_process.tty = TRY(read_string(record_bytes, string_offset, record.tty_length));
+            new_process.pledge = TRY(read_string(record_bytes, string_offset, record.pledge_length));
+            new_process.veil = TRY(read_string(record_bytes, string_offset, record.veil_length));
+            new_process.amount_virtual = record.amount_virtual;
+            new_process.amount_resident = record.amount_resident;
+            new_process.amount_shared = record.amount_shared;
+            new_process.amount_dirty_private = record.amount_dirty_private;
+            new_process.amount_clean_inode = record.amount_clean_inode;
+            new_process.amount_purgeable_volatile = record.amount_purgeable_volatile;
+            new_process.amount_purgeable_nonvolatile = record.amount_purgeable_nonvolatile;
+            if (include_usernames)
+                new_process.username = username_from_uid(new_process.uid);
+            TRY(all_processes_statistics.processes.try_append(move(new_process)));
+            process = &all_processes_statistics.processes.last();
+            break;
+        }
+        case Kernel::ProcessStatisticsRecordType::Thread: {
+            if (!process)
+                return Error::from_string_literal("Thread statistics record without a process");
+            auto record = TRY(read_record<Kernel::ThreadStatisticsRecord>(record_bytes));
+            ThreadStatistics thread;
+            thread.tid = record.tid;
+            thread.times_scheduled = record.times_scheduled;
+            thread.time_user = record.time_user;
+            thread.time_kernel = record.time_kernel;
+            thread.cpu = record.cpu;
+            thread.priority = record.priority;
+            thread.syscall_count = record.syscall_count;
+            thread.inode_faults = record.inode_faults;
+            thread.zero_faults = record.zero_faults;
+            thread.cow_faults = record.cow_faults;
+            thread.unix_socket_read_bytes = record.unix_socket_read_bytes;
+            thread.unix_socket_write_bytes = record.unix_socket_write_bytes;
+            thread.ipv4_socket_read_bytes = record.ipv4_socket_read_bytes;
+            thread.ipv4_socket_write_bytes = record.ipv4_socket_write_bytes;
+            thread.file_read_bytes = record.file_read_bytes;
+            thread.file_write_bytes = record.file_write_bytes;
+            thread.name = TRY(read_string(record_bytes, string_offset, record.name_length));
+            thread.state = TRY(read_string(record_bytes, string_offset, record.state_length));
+            TRY(process->threads.try_append(move(thread)));
+            break;
+        }
+        default:
+            // Skip record types from newer kernels.
+            break;
+        }
+    }
+    return all_processes_statistics;
+}
+
+ErrorOr<AllProcessesStatistics> ProcessStatisticsReader::get_all(SeekableStream& proc_all_file, bool include_usernames)
+{
+    TRY(proc_all_file.seek(0, SeekMode::SetPosition));
 
     auto file_contents = TRY(proc_all_file.read_until_eof());
+    if (file_contents.size() >= sizeof(u32) && *reinterpret_cast<u32 const*>(file_contents.data()) == Kernel::process_statistics_magic)
+        return get_all_from_binary(file_contents, include_usernames);
+
+    AllProcessesStatistics all_processes_statistics;
     auto json_obj = TRY(JsonValue::from_string(file_contents)).as_object();
     json_obj.get_array("processes"sv)->for_each([&](auto& value) {
         const JsonObject& process_object = value.as_object();
@@ -91,8 +203,13 @@ ErrorOr<AllProcessesStatistics> ProcessStatisticsReader::get_all(SeekableStream&
 
 ErrorOr<AllProcessesStatistics> ProcessStatisticsReader::get_all(bool include_usernames)
 {
-    auto proc_all_file = TRY(Core::File::open("/sys/kernel/processes"sv, Core::File::OpenMode::Read));
-    return get_all(*proc_all_file, include_usernames);
+    // Prefer the binary interface, but fall back to the JSON one for callers that have only unveiled that.
+    auto proc_all_file = Core::File::open("/sys/kernel/process_statistics"sv, Core::File::OpenMode::Read);
+    if (proc_all_file.is_error())
+        proc_all_file = Core::File::open("/sys/kernel/processes"sv, Core::File::OpenMode::Read);
+    if (proc_all_file.is_error())
+        return proc_all_file.release_error();
+    return get_all(*proc_all_file.value(), include_usernames);
 }
 
 DeprecatedString ProcessStatisticsReader::username_from_uid(uid_t uid)
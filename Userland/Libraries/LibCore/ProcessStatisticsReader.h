@@ -34,7 +34,7 @@ struct ThreadStatistics {
 };
 
 struct ProcessStatistics {
-    // Keep this in sync with /sys/kernel/processes.
+    // Keep this in sync with /sys/kernel/processes and /sys/kernel/process_statistics.
     // From the kernel side:
     pid_t pid;
     pid_t pgid;
@@ -72,10 +72,13 @@ struct AllProcessesStatistics {
 
 class ProcessStatisticsReader {
 public:
+    // Reads either the binary format of /sys/kernel/process_statistics or the JSON of /sys/kernel/processes.
     static ErrorOr<AllProcessesStatistics> get_all(SeekableStream&, bool include_usernames = true);
     static ErrorOr<AllProcessesStatistics> get_all(bool include_usernames = true);
 
 private:
+    static ErrorOr<AllProcessesStatistics> get_all_from_binary(ReadonlyBytes, bool include_usernames);
+
     static DeprecatedString username_from_uid(uid_t);
     static HashMap<uid_t, DeprecatedString> s_usernames;
 };
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <LibCore/Coroutine.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/Object.h>
 
@@ -37,6 +38,24 @@ public:
         return m_pending.release_value();
     }
 
+    // Lets a coroutine wait for the promise with `co_await *promise`. While it waits, on_resolved is taken over.
+    auto operator co_await()
+    {
+        struct Awaiter {
+            bool await_ready() { return promise->is_resolved(); }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                promise->on_resolved = [handle](Result&) { resume_from_event_loop(handle); };
+            }
+
+            Result await_resume() { return promise->m_pending.release_value(); }
+
+            NonnullRefPtr<Promise> promise;
+        };
+        return Awaiter { *this };
+    }
+
     // Converts a Promise<A> to a Promise<B> using a function func: A -> B
     template<typename T>
     RefPtr<Promise<T>> map(T func(Result&))
@@ -11,6 +11,7 @@
 #include <AK/Function.h>
 #include <AK/Stream.h>
 #include <AK/Time.h>
+#include <LibCore/Forward.h>
 #include <LibCore/Notifier.h>
 #include <LibCore/SocketAddress.h>
 
@@ -48,6 +49,10 @@ public:
 
     Function<void()> on_ready_to_read;
 
+    // Lets a coroutine wait for data with `co_await socket.read_some(buffer)`, which resolves to what was read.
+    // While it waits, the socket's on_ready_to_read is taken over. This is defined in LibCore/Coroutine.h.
+    SocketReadAwaiter read_some(Bytes buffer);
+
     enum class PreventSIGPIPE {
         No,
         Yes,
@@ -191,6 +196,8 @@ public:
     ErrorOr<void> set_blocking(bool enabled) override { return m_helper.set_blocking(enabled); }
     ErrorOr<void> set_close_on_exec(bool enabled) override { return m_helper.set_close_on_exec(enabled); }
 
+    int fd() const { return m_helper.fd(); }
+
     virtual ~TCPSocket() override { close(); }
 
 private:
@@ -420,6 +427,9 @@ public:
 
     virtual size_t buffer_size() const override { return m_helper.buffer_size(); }
 
+    // Note: Only for writing to the socket directly (e.g. with sendfile()), reading from it would bypass the buffer.
+    auto fd() const { return m_helper.stream().fd(); }
+
     virtual ~BufferedSocket() override = default;
 
 private:
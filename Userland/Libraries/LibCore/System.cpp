@@ -32,6 +32,10 @@
 #    include <sys/ptrace.h>
 #endif
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+#    include <sys/sendfile.h>
+#endif
+
 #if defined(AK_OS_LINUX) && !defined(MFD_CLOEXEC)
 #    include <linux/memfd.h>
 #    include <sys/syscall.h>
@@ -286,6 +290,18 @@ ErrorOr<void> profiling_free_buffer(pid_t pid)
     int rc = ::profiling_free_buffer(pid);
     HANDLE_SYSCALL_RETURN_VALUE("profiling_free_buffer", rc, {});
 }
+
+ErrorOr<int> io_ring_create(u32 entries, int options)
+{
+    int rc = ::io_ring_create(entries, options);
+    HANDLE_SYSCALL_RETURN_VALUE("io_ring_create", rc, rc);
+}
+
+ErrorOr<u32> io_ring_enter(int fd, u32 to_submit)
+{
+    int rc = ::io_ring_enter(fd, to_submit);
+    HANDLE_SYSCALL_RETURN_VALUE("io_ring_enter", rc, static_cast<u32>(rc));
+}
 #endif
 
 #if !defined(AK_OS_BSD_GENERIC) && !defined(AK_OS_ANDROID)
@@ -473,6 +489,13 @@ ErrorOr<void> ftruncate(int fd, off_t length)
     return {};
 }
 
+ErrorOr<void> fsync(int fd)
+{
+    if (::fsync(fd) < 0)
+        return Error::from_syscall("fsync"sv, -errno);
+    return {};
+}
+
 ErrorOr<struct stat> stat(StringView path)
 {
     if (!path.characters_without_null_termination())
@@ -1275,6 +1298,16 @@ ErrorOr<ssize_t> send(int sockfd, void const* buffer, size_t buffer_length, int
     return sent;
 }
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count)
+{
+    auto sent = ::sendfile(out_fd, in_fd, offset, count);
+    if (sent < 0)
+        return Error::from_syscall("sendfile"sv, -errno);
+    return static_cast<size_t>(sent);
+}
+#endif
+
 ErrorOr<ssize_t> sendmsg(int sockfd, const struct msghdr* message, int flags)
 {
     auto sent = ::sendmsg(sockfd, message, flags);
@@ -1534,6 +1567,31 @@ ErrorOr<int> poll(Span<struct pollfd> poll_fds, int timeout)
     return { rc };
 }
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+ErrorOr<int> epoll_create(int flags)
+{
+    int rc = ::epoll_create1(flags);
+    if (rc < 0)
+        return Error::from_syscall("epoll_create1"sv, -errno);
+    return rc;
+}
+
+ErrorOr<void> epoll_ctl(int epfd, int op, int fd, struct epoll_event* event)
+{
+    if (::epoll_ctl(epfd, op, fd, event) < 0)
+        return Error::from_syscall("epoll_ctl"sv, -errno);
+    return {};
+}
+
+ErrorOr<int> epoll_wait(int epfd, Span<struct epoll_event> events, int timeout)
+{
+    int rc = ::epoll_wait(epfd, events.data(), static_cast<int>(events.size()), timeout);
+    if (rc < 0)
+        return Error::from_syscall("epoll_wait"sv, -errno);
+    return rc;
+}
+#endif
+
 #ifdef AK_OS_SERENITY
 ErrorOr<void> posix_fallocate(int fd, off_t offset, off_t length)
 {
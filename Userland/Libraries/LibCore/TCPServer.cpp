@@ -28,6 +28,17 @@ ErrorOr<NonnullRefPtr<TCPServer>> TCPServer::try_create(Object* parent)
     return adopt_nonnull_ref_or_enomem(new (nothrow) TCPServer(fd, parent));
 }
 
+ErrorOr<NonnullRefPtr<TCPServer>> TCPServer::try_create_sharing(TCPServer const& listening_server, Object* parent)
+{
+    VERIFY(listening_server.is_listening());
+    int fd = TRY(Core::System::dup(listening_server.m_fd));
+    TRY(Core::System::fcntl(fd, F_SETFD, FD_CLOEXEC));
+
+    auto server = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) TCPServer(fd, parent)));
+    server->did_start_listening();
+    return server;
+}
+
 TCPServer::TCPServer(int fd, Object* parent)
     : Object(parent)
     , m_fd(fd)
@@ -55,14 +66,18 @@ ErrorOr<void> TCPServer::listen(IPv4Address const& address, u16 port, AllowAddre
 
     TRY(Core::System::bind(m_fd, (sockaddr const*)&in, sizeof(in)));
     TRY(Core::System::listen(m_fd, 5));
-    m_listening = true;
+    did_start_listening();
+    return {};
+}
 
+void TCPServer::did_start_listening()
+{
+    m_listening = true;
     m_notifier = Notifier::construct(m_fd, Notifier::Event::Read, this);
     m_notifier->on_ready_to_read = [this] {
         if (on_ready_to_accept)
             on_ready_to_accept();
     };
-    return {};
 }
 
 ErrorOr<void> TCPServer::set_blocking(bool blocking)
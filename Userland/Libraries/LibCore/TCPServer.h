@@ -17,6 +17,9 @@ class TCPServer : public Object {
     C_OBJECT_ABSTRACT(TCPServer)
 public:
     static ErrorOr<NonnullRefPtr<TCPServer>> try_create(Object* parent = nullptr);
+    // Accepts connections on the same socket as a server that's already listening, so that event loops on several
+    // threads can take turns accepting them. When one of them takes a connection, accept() fails with EAGAIN on the others.
+    static ErrorOr<NonnullRefPtr<TCPServer>> try_create_sharing(TCPServer const& listening_server, Object* parent = nullptr);
     virtual ~TCPServer() override;
 
     enum class AllowAddressReuse {
@@ -38,6 +41,8 @@ public:
 private:
     explicit TCPServer(int fd, Object* parent = nullptr);
 
+    void did_start_listening();
+
     int m_fd { -1 };
     bool m_listening { false };
     RefPtr<Notifier> m_notifier;
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/StdLibExtras.h>
+#include <LibCore/TimerWheel.h>
+
+namespace Core {
+
+TimerWheel::TimerWheel(Ticks now)
+    : m_current_tick(now)
+{
+}
+
+void TimerWheel::schedule(Entry& entry, Ticks expiration)
+{
+    VERIFY(!entry.list_node.is_in_list());
+    entry.expiration = expiration;
+    insert(entry);
+    ++m_size;
+}
+
+void TimerWheel::cancel(Entry& entry)
+{
+    VERIFY(entry.list_node.is_in_list());
+    auto& slot = m_slots[entry.level][entry.slot];
+    slot.remove(entry);
+    if (slot.is_empty())
+        m_occupied_slots[entry.level] &= ~(1ull << entry.slot);
+    --m_size;
+}
+
+void TimerWheel::clear()
+{
+    for (auto& level : m_slots) {
+        for (auto& slot : level)
+            slot.clear();
+    }
+    m_occupied_slots.fill(0);
+    m_size = 0;
+}
+
+void TimerWheel::insert(Entry& entry)
+{
+    auto expiration = max(entry.expiration, m_current_tick);
+    if (expiration - m_current_tick >= range)
+        expiration = m_current_tick + range - 1;
+
+    // The lowest level whose slots still reach far enough, so that the entry's slot lies ahead of the current one.
+    auto delta = expiration - m_current_tick;
+    size_t level = 0;
+    while (delta >= (1ull << (bits_per_level * (level + 1))))
+        ++level;
+
+    entry.level = level;
+    entry.slot = (expiration >> (bits_per_level * level)) & slot_mask;
+    m_slots[level][entry.slot].append(entry);
+    m_occupied_slots[level] |= 1ull << entry.slot;
+}
+
+void TimerWheel::cascade_for_current_tick()
+{
+    for (size_t level = 1; level < level_count; ++level) {
+        auto shift = bits_per_level * level;
+        // A tick that doesn't start a slot of this level doesn't start one of the levels above it either.
+        if (m_current_tick & ((1ull << shift) - 1))
+            return;
+
+        auto index = (m_current_tick >> shift) & slot_mask;
+        if (!(m_occupied_slots[level] & (1ull << index)))
+            continue;
+        m_occupied_slots[level] &= ~(1ull << index);
+        auto& slot = m_slots[level][index];
+        while (auto* entry = slot.take_first())
+            insert(*entry);
+    }
+}
+
+Optional<TimerWheel::Ticks> TimerWheel::next_tick_with_work() const
+{
+    // Slots of the lower levels are always reached before those of the levels above them, so the lowest occupied level decides.
+    for (size_t level = 0; level < level_count; ++level) {
+        auto occupied = m_occupied_slots[level];
+        if (!occupied)
+            continue;
+
+        auto shift = bits_per_level * level;
+        auto index = (m_current_tick >> shift) & slot_mask;
+        // On the tick that starts a slot, that slot still has to be emptied. Otherwise, it already was.
+        auto first = (m_current_tick & ((1ull << shift) - 1)) == 0 ? index : index + 1;
+        auto parent_start = m_current_tick & ~((1ull << (shift + bits_per_level)) - 1);
+        if (first < slots_per_level) {
+            if (auto ahead = occupied & (~0ull << first))
+                return parent_start + (static_cast<Ticks>(count_trailing_zeroes(ahead)) << shift);
+        }
+        // The occupied slots have wrapped around into the next slot of the level above.
+        return parent_start + (1ull << (shift + bits_per_level));
+    }
+    return {};
+}
+
+Optional<TimerWheel::Ticks> TimerWheel::next_expiration() const
+{
+    Optional<Ticks> soonest;
+    for (size_t level = 0; level < level_count; ++level) {
+        auto occupied = m_occupied_slots[level];
+        if (occupied) {
+            auto shift = bits_per_level * level;
+            auto index = (m_current_tick >> shift) & slot_mask;
+            auto first = (m_current_tick & ((1ull << shift) - 1)) == 0 ? index : index + 1;
+            auto parent_start = m_current_tick & ~((1ull << (shift + bits_per_level)) - 1);
+
+            // The first occupied slot after the current one, wrapping around if there is none.
+            auto ahead = first < slots_per_level ? occupied & (~0ull << first) : 0;
+            auto slot = static_cast<size_t>(count_trailing_zeroes(ahead ? ahead : occupied));
+
+            if (level == 0) {
+                // Entries that expired in the past are handed out with the slot they were put in.
+                soonest = parent_start + slot + (ahead ? 0 : slots_per_level);
+            } else {
+                for (auto& entry : m_slots[level][slot]) {
+                    if (!soonest.has_value() || entry.expiration < *soonest)
+                        soonest = entry.expiration;
+                }
+            }
+        }
+
+        // Entries on the levels above can't expire before the next slot of the level above begins.
+        if (soonest.has_value() && level + 1 < level_count) {
+            auto parent_slot_size = 1ull << (bits_per_level * (level + 1));
+            if (*soonest < ceil_div(m_current_tick, parent_slot_size) * parent_slot_size)
+                return soonest;
+        }
+    }
+    return soonest;
+}
+
+}
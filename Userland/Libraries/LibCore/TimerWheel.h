@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/IntrusiveList.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/Types.h>
+
+namespace Core {
+
+// A hierarchical timing wheel: every level has 64 slots, each slot of a level covers 64 times as many ticks as a slot of
+// the level below it, and entries move down a level whenever time reaches the slot they're in.
+// Scheduling and cancelling are O(1), and entries that expire on the same tick are handed out together.
+class TimerWheel {
+    AK_MAKE_NONCOPYABLE(TimerWheel);
+    AK_MAKE_NONMOVABLE(TimerWheel);
+
+public:
+    using Ticks = u64;
+
+    struct Entry {
+        IntrusiveListNode<Entry> list_node;
+        Ticks expiration { 0 };
+        u8 level { 0 };
+        u8 slot { 0 };
+    };
+    using List = IntrusiveList<&Entry::list_node>;
+
+    explicit TimerWheel(Ticks now = 0);
+
+    Ticks current_tick() const { return m_current_tick; }
+    size_t size() const { return m_size; }
+    bool is_empty() const { return m_size == 0; }
+
+    // Expirations in the past are treated as the current tick, so the entry expires on the next advance().
+    void schedule(Entry&, Ticks expiration);
+    // The entry must currently be scheduled on this wheel.
+    void cancel(Entry&);
+    // Unschedules all entries at once.
+    void clear();
+
+    // The tick at which the next entry expires, if there are any entries.
+    Optional<Ticks> next_expiration() const;
+
+    // Hands every entry that expires at or before `now` to the callback, in order of expiration.
+    // Entries are unscheduled before the callback sees them, so it can schedule them again.
+    template<typename Callback>
+    void advance(Ticks now, Callback callback)
+    {
+        while (m_current_tick <= now) {
+            cascade_for_current_tick();
+            auto& slot = m_slots[0][m_current_tick & slot_mask];
+            ++m_current_tick;
+            // Anything the callbacks schedule for the tick we're handing out goes to the next one instead.
+            while (auto* entry = slot.take_first()) {
+                --m_size;
+                if (slot.is_empty())
+                    m_occupied_slots[0] &= ~(1ull << entry->slot);
+                callback(*entry);
+            }
+
+            auto next = next_tick_with_work();
+            if (!next.has_value() || *next > now) {
+                m_current_tick = now + 1;
+                return;
+            }
+            m_current_tick = *next;
+        }
+    }
+
+private:
+    static constexpr size_t bits_per_level = 6;
+    static constexpr size_t slots_per_level = 1 << bits_per_level;
+    static constexpr size_t level_count = 4;
+    static constexpr Ticks slot_mask = slots_per_level - 1;
+    // Entries that expire further in the future than this sit in the top level and are placed again once they're reached.
+    static constexpr Ticks range = 1ull << (bits_per_level * level_count);
+
+    void insert(Entry&);
+    void cascade_for_current_tick();
+    // The next tick at which an entry either expires or moves down a level. Ticks in between can be skipped.
+    Optional<Ticks> next_tick_with_work() const;
+
+    Array<Array<List, slots_per_level>, level_count> m_slots;
+    Array<u64, level_count> m_occupied_slots {};
+    Ticks m_current_tick { 0 };
+    size_t m_size { 0 };
+};
+
+}
@@ -10,35 +10,32 @@
 #include <AK/StringBuilder.h>
 #include <AK/Types.h>
 #include <LibCore/DeprecatedFile.h>
-#include <LibCore/MappedFile.h>
 #include <LibCoredump/Backtrace.h>
 #include <LibCoredump/Reader.h>
 #include <LibELF/Core.h>
-#include <LibELF/Image.h>
 
 namespace Coredump {
 
-ELFObjectInfo const* Backtrace::object_info_for_region(Reader const& coredump, MemoryRegionInfo const& region)
+Symbolication::SymbolIndex const* Backtrace::symbol_index_for_region(Reader const& coredump, MemoryRegionInfo const& region)
 {
     DeprecatedString path = coredump.resolve_object_path(region.object_name());
 
-    auto maybe_ptr = m_debug_info_cache.get(path);
+    auto maybe_ptr = m_symbol_index_cache.get(path);
     if (maybe_ptr.has_value())
-        return *maybe_ptr;
+        return maybe_ptr->ptr();
 
     if (!Core::DeprecatedFile::exists(path))
         return nullptr;
 
-    auto file_or_error = Core::MappedFile::map(path);
-    if (file_or_error.is_error())
+    auto symbol_index_or_error = Symbolication::SymbolIndex::load_or_create(path);
+    if (symbol_index_or_error.is_error()) {
+        m_symbol_index_cache.set(path, {});
         return nullptr;
+    }
 
-    auto image = make<ELF::Image>(file_or_error.value()->bytes());
-    auto& image_reference = *image;
-    auto info = make<ELFObjectInfo>(file_or_error.release_value(), make<Debug::DebugInfo>(image_reference), move(image));
-    auto* info_ptr = info.ptr();
-    m_debug_info_cache.set(path, move(info));
-    return info_ptr;
+    auto* symbol_index = symbol_index_or_error.value().ptr();
+    m_symbol_index_cache.set(path, symbol_index_or_error.release_value());
+    return symbol_index;
 }
 
 Backtrace::Backtrace(Reader const& coredump, const ELF::Core::ThreadInfo& thread_info, Function<void(size_t, size_t)> on_progress)
@@ -114,15 +111,15 @@ void Backtrace::add_entry(Reader const& coredump, FlatPtr ip)
     // the PT_LOAD header for the .text segment isn't the first one
     // in the object file.
     auto region = coredump.first_region_for_object(object_name);
-    auto object_info = object_info_for_region(coredump, *region);
-    if (!object_info) {
+    auto const* symbol_index = symbol_index_for_region(coredump, *region);
+    if (!symbol_index) {
         m_entries.append({ ip, object_name, {}, {} });
         return;
     }
 
-    auto function_name = object_info->debug_info->elf().symbolicate(ip - region->region_start);
-    auto source_position = object_info->debug_info->get_source_position_with_inlines(ip - region->region_start).release_value_but_fixme_should_propagate_errors();
-    m_entries.append({ ip, object_name, function_name, source_position });
+    auto function_name = symbol_index->symbolicate(ip - region->region_start);
+    auto source_positions = symbol_index->source_positions(ip - region->region_start);
+    m_entries.append({ ip, object_name, function_name, move(source_positions) });
 }
 
 DeprecatedString Backtrace::Entry::to_deprecated_string(bool color) const
@@ -136,17 +133,6 @@ DeprecatedString Backtrace::Entry::to_deprecated_string(bool color) const
     builder.appendff("[{}] {}", object_name, function_name.is_empty() ? "???" : function_name);
     builder.append(" ("sv);
 
-    Vector<Debug::DebugInfo::SourcePosition> source_positions;
-
-    for (auto& position : source_position_with_inlines.inline_chain) {
-        if (!source_positions.contains_slow(position))
-            source_positions.append(position);
-    }
-
-    if (source_position_with_inlines.source_position.has_value() && !source_positions.contains_slow(source_position_with_inlines.source_position.value())) {
-        source_positions.insert(0, source_position_with_inlines.source_position.value());
-    }
-
     for (size_t i = 0; i < source_positions.size(); ++i) {
         auto& position = source_positions[i];
         auto fmt = color ? "\033[34;1m{}\033[0m:{}"sv : "{}:{}"sv;
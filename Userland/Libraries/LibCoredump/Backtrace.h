@@ -11,29 +11,17 @@
 #include <LibCoredump/Reader.h>
 #include <LibDebug/DebugInfo.h>
 #include <LibELF/Core.h>
+#include <LibSymbolication/SymbolIndex.h>
 
 namespace Coredump {
 
-struct ELFObjectInfo {
-    ELFObjectInfo(NonnullRefPtr<Core::MappedFile> file, NonnullOwnPtr<Debug::DebugInfo>&& debug_info, NonnullOwnPtr<ELF::Image> image)
-        : file(move(file))
-        , debug_info(move(debug_info))
-        , image(move(image))
-    {
-    }
-
-    NonnullRefPtr<Core::MappedFile> file;
-    NonnullOwnPtr<Debug::DebugInfo> debug_info;
-    NonnullOwnPtr<ELF::Image> image;
-};
-
 class Backtrace {
 public:
     struct Entry {
         FlatPtr eip;
         DeprecatedString object_name;
         DeprecatedString function_name;
-        Debug::DebugInfo::SourcePositionWithInlines source_position_with_inlines;
+        Vector<Debug::DebugInfo::SourcePosition> source_positions;
 
         DeprecatedString to_deprecated_string(bool color = false) const;
     };
@@ -46,12 +34,12 @@ public:
 
 private:
     void add_entry(Reader const&, FlatPtr ip);
-    ELFObjectInfo const* object_info_for_region(Reader const&, MemoryRegionInfo const&);
+    Symbolication::SymbolIndex const* symbol_index_for_region(Reader const&, MemoryRegionInfo const&);
 
     bool m_skip_loader_so { false };
     ELF::Core::ThreadInfo m_thread_info;
     Vector<Entry> m_entries;
-    HashMap<DeprecatedString, NonnullOwnPtr<ELFObjectInfo>> m_debug_info_cache;
+    HashMap<DeprecatedString, RefPtr<Symbolication::SymbolIndex>> m_symbol_index_cache;
 };
 
 }
@@ -139,7 +139,11 @@ Optional<FlatPtr> Reader::peek_memory(FlatPtr address) const
         return {};
 
     FlatPtr offset_in_region = address - region->region_start;
-    auto* region_data = bit_cast<u8 const*>(image().program_header(region->program_header_index).raw_data());
+    auto program_header = image().program_header(region->program_header_index);
+    // The kernel leaves out pages at the end of a region that were never written to, they read as zeroes.
+    if (offset_in_region + sizeof(FlatPtr) > program_header.size_in_image())
+        return 0;
+    auto* region_data = bit_cast<u8 const*>(program_header.raw_data());
     FlatPtr value { 0 };
     ByteReader::load(region_data + offset_in_region, value);
     return value;
@@ -203,21 +203,24 @@ constexpr StringView s_known_types[] = {
     "wchar_t"sv,
 };
 
+// Local statics are only initialized once, even when several threads get to them at the same time, so files can be lexed on several threads at once.
 static bool is_keyword(StringView string)
 {
-    static HashTable<DeprecatedString> keywords(array_size(s_known_keywords));
-    if (keywords.is_empty()) {
+    static HashTable<DeprecatedString> const keywords = [] {
+        HashTable<DeprecatedString> keywords(array_size(s_known_keywords));
         keywords.set_from(s_known_keywords);
-    }
+        return keywords;
+    }();
     return keywords.contains(string);
 }
 
 static bool is_known_type(StringView string)
 {
-    static HashTable<DeprecatedString> types(array_size(s_known_types));
-    if (types.is_empty()) {
+    static HashTable<DeprecatedString> const types = [] {
+        HashTable<DeprecatedString> types(array_size(s_known_types));
         types.set_from(s_known_types);
-    }
+        return types;
+    }();
     return types.contains(string);
 }
 
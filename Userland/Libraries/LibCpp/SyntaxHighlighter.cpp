@@ -55,12 +55,9 @@ bool SyntaxHighlighter::is_navigatable(u64 token) const
     return cpp_token == Cpp::Token::Type::IncludePath;
 }
 
-void SyntaxHighlighter::rehighlight(Palette const& palette)
+void SyntaxHighlighter::lex(Palette const& palette, StringView text, size_t start_line, Function<void(GUI::TextDocumentSpan)> callback)
 {
-    auto text = m_client->get_text();
-    Cpp::Lexer lexer(text);
-
-    Vector<GUI::TextDocumentSpan> spans;
+    Cpp::Lexer lexer(text, start_line);
     lexer.lex_iterable([&](auto token) {
         // FIXME: The +1 for the token end column is a quick hack due to not wanting to modify the lexer (which is also used by the parser). Maybe there's a better way to do this.
         dbgln_if(SYNTAX_HIGHLIGHTING_DEBUG, "{} @ {}:{} - {}:{}", token.type_as_deprecated_string(), token.start().line, token.start().column, token.end().line, token.end().column + 1);
@@ -72,14 +69,8 @@ void SyntaxHighlighter::rehighlight(Palette const& palette)
         span.attributes.bold = style.bold;
         span.is_skippable = token.type() == Cpp::Token::Type::Whitespace;
         span.data = static_cast<u64>(token.type());
-        spans.append(span);
+        callback(move(span));
     });
-    m_client->do_set_spans(move(spans));
-
-    m_has_brace_buddies = false;
-    highlight_matching_token_pair();
-
-    m_client->do_update();
 }
 
 Vector<SyntaxHighlighter::MatchingTokenPair> SyntaxHighlighter::matching_token_pairs_impl() const
@@ -6,13 +6,13 @@
 
 #pragma once
 
-#include <LibSyntax/Highlighter.h>
+#include <LibSyntax/IncrementalHighlighter.h>
 
 namespace Cpp {
 
 class SemanticSyntaxHighlighter;
 
-class SyntaxHighlighter final : public Syntax::Highlighter {
+class SyntaxHighlighter final : public Syntax::IncrementalHighlighter {
     friend SemanticSyntaxHighlighter;
 
 public:
@@ -25,9 +25,9 @@ public:
     virtual Syntax::Language language() const override { return Syntax::Language::Cpp; }
     virtual Optional<StringView> comment_prefix() const override { return "//"sv; }
     virtual Optional<StringView> comment_suffix() const override { return {}; }
-    virtual void rehighlight(Palette const&) override;
 
 protected:
+    virtual void lex(Palette const&, StringView text, size_t start_line, Function<void(GUI::TextDocumentSpan)> callback) override;
     virtual Vector<MatchingTokenPair> matching_token_pairs_impl() const override;
     virtual bool token_types_equal(u64, u64) const override;
 };
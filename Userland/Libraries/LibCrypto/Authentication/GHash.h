@@ -57,8 +57,19 @@ public:
 
     TagType process(ReadonlyBytes aad, ReadonlyBytes cipher);
 
+    // The same as process(), but the ciphertext can be given a piece at a time, e.g. while it's being encrypted.
+    // All pieces but the last one have to be a multiple of 16 bytes long.
+    void begin(ReadonlyBytes aad);
+    void update(ReadonlyBytes cipher);
+    TagType finish();
+
 private:
+    void process_blocks(ReadonlyBytes);
+
     u32 m_key[4];
+    u32 m_tag[4] { 0, 0, 0, 0 };
+    u64 m_aad_size { 0 };
+    u64 m_cipher_size { 0 };
 };
 
 }
@@ -6,43 +6,135 @@
  */
 
 #include "UnsignedBigIntegerAlgorithms.h"
+#include <AK/BuiltinWrappers.h>
 
 namespace Crypto {
 
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
+ * Complexity: O(N*M) where N is the number of words in the numerator, and M the number of words in the denominator
  * Division method:
- * We loop over the bits of the divisor, attempting to subtract divisor<<i from the dividend.
- * If the result is non-negative, it means that divisor*2^i "fits" in the dividend,
- * so we set the ith bit in the quotient and reduce divisor<<i from the dividend.
- * When we're done, what's left from the dividend is the remainder.
+ * This is Knuth's "Algorithm D" (The Art of Computer Programming, Vol. 2, 4.3.1), as laid out in Hacker's Delight.
+ * Both numbers are shifted left until the top bit of the denominator is set. Then, for each word of the quotient,
+ * from the most significant one, we estimate it from the top two words of what's left of the numerator and the top
+ * word of the denominator. The estimate is at most two too big, which we fix up before subtracting
+ * quotient_word * denominator from the numerator. What's left of the numerator in the end is the remainder.
  */
 FLATTEN void UnsignedBigIntegerAlgorithms::divide_without_allocation(
     UnsignedBigInteger const& numerator,
     UnsignedBigInteger const& denominator,
-    UnsignedBigInteger& temp_shift_result,
-    UnsignedBigInteger& temp_shift_plus,
-    UnsignedBigInteger& temp_shift,
-    UnsignedBigInteger& temp_minus,
+    UnsignedBigInteger& temp_shifted_numerator,
+    UnsignedBigInteger& temp_shifted_denominator,
+    UnsignedBigInteger&,
+    UnsignedBigInteger&,
     UnsignedBigInteger& quotient,
     UnsignedBigInteger& remainder)
 {
+    using Word = UnsignedBigInteger::Word;
+    using DoubleWord = u64;
+    using SignedDoubleWord = i64;
+    constexpr auto bits_in_word = UnsignedBigInteger::BITS_IN_WORD;
+    constexpr DoubleWord word_base = DoubleWord(1) << bits_in_word;
+
+    auto numerator_length = numerator.trimmed_length();
+    auto denominator_length = denominator.trimmed_length();
+    VERIFY(denominator_length > 0);
+
+    if (numerator_length < denominator_length) {
+        quotient.set_to_0();
+        remainder.set_to(numerator);
+        return;
+    }
+
+    auto const* denominator_words = denominator.m_words.data();
+    if (denominator_length == 1) {
+        auto divisor = static_cast<DoubleWord>(denominator_words[0]);
+        // The quotient may be the numerator itself, so the numerator has to be read before writing to it.
+        temp_shifted_numerator.set_to(numerator);
+        auto const* numerator_words = temp_shifted_numerator.m_words.data();
+        quotient.set_to_0();
+        quotient.m_words.resize_and_keep_capacity(numerator_length);
+        DoubleWord remainder_word = 0;
+        for (size_t i = numerator_length; i-- > 0;) {
+            auto dividend = (remainder_word << bits_in_word) | numerator_words[i];
+            quotient.m_words[i] = static_cast<Word>(dividend / divisor);
+            remainder_word = dividend % divisor;
+        }
+        quotient.clamp_to_trimmed_length();
+        remainder.set_to(static_cast<Word>(remainder_word));
+        return;
+    }
+
+    // Normalize, so that the top bit of the denominator is set.
+    auto shift = count_leading_zeroes(denominator_words[denominator_length - 1]);
+    auto shift_left_words = [&](Word const* words, size_t length, Word* shifted) {
+        for (size_t i = length; i-- > 1;)
+            shifted[i] = static_cast<Word>((static_cast<DoubleWord>(words[i]) << shift) | (static_cast<DoubleWord>(words[i - 1]) >> (bits_in_word - shift)));
+        shifted[0] = words[0] << shift;
+    };
+
+    temp_shifted_denominator.set_to_0();
+    temp_shifted_denominator.m_words.resize_and_keep_capacity(denominator_length);
+    auto* d = temp_shifted_denominator.m_words.data();
+    shift_left_words(denominator_words, denominator_length, d);
+
+    temp_shifted_numerator.set_to_0();
+    temp_shifted_numerator.m_words.resize_and_keep_capacity(numerator_length + 1);
+    auto* n = temp_shifted_numerator.m_words.data();
+    auto const* numerator_words = numerator.m_words.data();
+    n[numerator_length] = static_cast<Word>(static_cast<DoubleWord>(numerator_words[numerator_length - 1]) >> (bits_in_word - shift));
+    shift_left_words(numerator_words, numerator_length, n);
+
+    auto quotient_length = numerator_length - denominator_length + 1;
     quotient.set_to_0();
-    remainder.set_to(numerator);
-
-    // iterate all bits
-    for (int word_index = numerator.trimmed_length() - 1; word_index >= 0; --word_index) {
-        for (int bit_index = UnsignedBigInteger::BITS_IN_WORD - 1; bit_index >= 0; --bit_index) {
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
-            shift_left_without_allocation(denominator, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-
-            subtract_without_allocation(remainder, temp_shift, temp_minus);
-            if (!temp_minus.is_invalid()) {
-                remainder.set_to(temp_minus);
-                quotient.set_bit_inplace(shift_amount);
+    quotient.m_words.resize_and_keep_capacity(quotient_length);
+    auto* q = quotient.m_words.data();
+
+    auto top_denominator_word = static_cast<DoubleWord>(d[denominator_length - 1]);
+    auto second_denominator_word = static_cast<DoubleWord>(d[denominator_length - 2]);
+    for (size_t j = quotient_length; j-- > 0;) {
+        auto dividend = (static_cast<DoubleWord>(n[j + denominator_length]) << bits_in_word) | n[j + denominator_length - 1];
+        auto estimate = dividend / top_denominator_word;
+        auto estimate_remainder = dividend % top_denominator_word;
+        while (estimate >= word_base || estimate * second_denominator_word > ((estimate_remainder << bits_in_word) | n[j + denominator_length - 2])) {
+            --estimate;
+            estimate_remainder += top_denominator_word;
+            if (estimate_remainder >= word_base)
+                break;
+        }
+
+        // n[j..j+denominator_length] -= estimate * d
+        SignedDoubleWord borrow = 0;
+        SignedDoubleWord difference = 0;
+        for (size_t i = 0; i < denominator_length; ++i) {
+            auto product = estimate * d[i];
+            difference = static_cast<SignedDoubleWord>(n[i + j]) - borrow - static_cast<SignedDoubleWord>(product & (word_base - 1));
+            n[i + j] = static_cast<Word>(difference);
+            borrow = static_cast<SignedDoubleWord>(product >> bits_in_word) - (difference >> bits_in_word);
+        }
+        difference = static_cast<SignedDoubleWord>(n[j + denominator_length]) - borrow;
+        n[j + denominator_length] = static_cast<Word>(difference);
+
+        if (difference < 0) {
+            // The estimate was still one too big, so add one denominator back.
+            --estimate;
+            DoubleWord carry = 0;
+            for (size_t i = 0; i < denominator_length; ++i) {
+                auto sum = static_cast<DoubleWord>(n[i + j]) + d[i] + carry;
+                n[i + j] = static_cast<Word>(sum);
+                carry = sum >> bits_in_word;
             }
+            n[j + denominator_length] += static_cast<Word>(carry);
         }
+        q[j] = static_cast<Word>(estimate);
     }
+    quotient.clamp_to_trimmed_length();
+
+    // Undo the normalization on what's left, to get the remainder.
+    remainder.set_to_0();
+    remainder.m_words.resize_and_keep_capacity(denominator_length);
+    for (size_t i = 0; i < denominator_length; ++i)
+        remainder.m_words[i] = static_cast<Word>((static_cast<DoubleWord>(n[i]) >> shift) | (static_cast<DoubleWord>(n[i + 1]) << (bits_in_word - shift)));
+    remainder.clamp_to_trimmed_length();
 }
 
 /**
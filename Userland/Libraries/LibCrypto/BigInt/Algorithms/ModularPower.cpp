@@ -49,138 +49,102 @@ void UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(
     }
 }
 
+// The montgomery multiplications work on 64-bit limbs, as that quarters the number of multiplications compared to 32-bit words.
+using Limb = u64;
+using DoubleLimb = unsigned __int128;
+static constexpr size_t bits_in_limb = 64;
+static_assert(sizeof(Limb) == 2 * sizeof(UnsignedBigInteger::Word));
+
 /**
- * Compute (1/value) % 2^32.
+ * Compute -(1/value) % 2^64.
  * This needs an odd input value
- * Algorithm from: Dumas, J.G. "On Newton–Raphson Iteration for Multiplicative Inverses Modulo Prime Powers".
+ * Every step of Newton's iteration doubles the number of correct low bits, and an odd value is its own inverse modulo 2^3.
  */
-ALWAYS_INLINE static u32 inverse_wrapped(u32 value)
+static Limb negative_inverse_wrapped(Limb value)
 {
     VERIFY(value & 1);
 
-    u64 b = static_cast<u64>(value);
-    u64 k0 = (2 - b);
-    u64 t = (b - 1);
-    size_t i = 1;
-    while (i < 32) {
-        t = t * t;
-        k0 = k0 * (t + 1);
-        i <<= 1;
-    }
-    return static_cast<u32>(-k0);
-}
-
-/**
- * Computes z = x * y + c. z_carry contains the top bits, z contains the bottom bits.
- */
-ALWAYS_INLINE static void linear_multiplication_with_carry(u32 x, u32 y, u32 c, u32& z_carry, u32& z)
-{
-    u64 result = static_cast<u64>(x) * static_cast<u64>(y) + static_cast<u64>(c);
-    z_carry = static_cast<u32>(result >> 32);
-    z = static_cast<u32>(result);
-}
-
-/**
- * Computes z = a + b. z_carry contains the top bit (1 or 0), z contains the bottom bits.
- */
-ALWAYS_INLINE static void addition_with_carry(u32 a, u32 b, u32& z_carry, u32& z)
-{
-    u64 result = static_cast<u64>(a) + static_cast<u64>(b);
-    z_carry = static_cast<u32>(result >> 32);
-    z = static_cast<u32>(result);
+    Limb inverse = value;
+    for (size_t correct_bits = 3; correct_bits < bits_in_limb; correct_bits *= 2)
+        inverse *= 2 - value * inverse;
+    return -inverse;
 }
 
-/**
- * Computes a montgomery "fragment" for y_i. This computes "z[i] += x[i] * y_i" for all words while rippling the carry, and returns the carry.
- * Algorithm from: Gueron, "Efficient Software Implementations of Modular Exponentiation". (https://eprint.iacr.org/2011/239.pdf)
- */
-UnsignedBigInteger::Word UnsignedBigIntegerAlgorithms::montgomery_fragment(UnsignedBigInteger& z, size_t offset_in_z, UnsignedBigInteger const& x, UnsignedBigInteger::Word y_digit, size_t num_words)
+static void words_to_limbs(UnsignedBigInteger const& number, Limb* limbs, size_t limb_count)
 {
-    UnsignedBigInteger::Word carry { 0 };
-    for (size_t i = 0; i < num_words; ++i) {
-        UnsignedBigInteger::Word a_carry;
-        UnsignedBigInteger::Word a;
-        linear_multiplication_with_carry(x.m_words[i], y_digit, z.m_words[offset_in_z + i], a_carry, a);
-        UnsignedBigInteger::Word b_carry;
-        UnsignedBigInteger::Word b;
-        addition_with_carry(a, carry, b_carry, b);
-        z.m_words[offset_in_z + i] = b;
-        carry = a_carry + b_carry;
+    auto const& words = number.words();
+    for (size_t i = 0; i < limb_count; ++i) {
+        Limb low = 2 * i < words.size() ? words[2 * i] : 0;
+        Limb high = 2 * i + 1 < words.size() ? words[2 * i + 1] : 0;
+        limbs[i] = low | (high << UnsignedBigInteger::BITS_IN_WORD);
     }
-    return carry;
 }
 
 /**
- * Computes the "almost montgomery" product : x * y * 2 ^ (-num_words * BITS_IN_WORD) % modulo
- * [Note : that means that the result z satisfies z * 2^(num_words * BITS_IN_WORD) % modulo = x * y % modulo]
+ * Computes the montgomery product: result = x * y * 2 ^ (-limb_count * bits_in_limb) % modulo
  * assuming :
- *  - x, y and modulo are all already padded to num_words
- *  - k = inverse_wrapped(modulo) (optimization to not recompute K each time)
- * Algorithm from: Gueron, "Efficient Software Implementations of Modular Exponentiation". (https://eprint.iacr.org/2011/239.pdf)
+ *  - x and y are less than modulo, and all of them have limb_count limbs
+ *  - k = negative_inverse_wrapped(modulo) (optimization to not recompute K each time)
+ *  - t has room for limb_count + 2 limbs
+ * Algorithm from: Koç, Acar, Kaliski, "Analyzing and Comparing Montgomery Multiplication Algorithms" (the CIOS method).
  */
-void UnsignedBigIntegerAlgorithms::almost_montgomery_multiplication_without_allocation(
-    UnsignedBigInteger const& x,
-    UnsignedBigInteger const& y,
-    UnsignedBigInteger const& modulo,
-    UnsignedBigInteger& z,
-    UnsignedBigInteger::Word k,
-    size_t num_words,
-    UnsignedBigInteger& result)
+static void montgomery_multiply(Limb const* x, Limb const* y, Limb const* modulo, Limb k, size_t limb_count, Limb* t, Limb* result)
 {
-    VERIFY(x.length() >= num_words);
-    VERIFY(y.length() >= num_words);
-    VERIFY(modulo.length() >= num_words);
-
-    z.set_to(0);
-    z.resize_with_leading_zeros(num_words * 2);
-
-    UnsignedBigInteger::Word previous_double_carry { 0 };
-    for (size_t i = 0; i < num_words; ++i) {
-        // z[i->num_words+i] += x * y_i
-        UnsignedBigInteger::Word carry_1 = montgomery_fragment(z, i, x, y.m_words[i], num_words);
-        // z[i->num_words+i] += modulo * (z_i * k)
-        UnsignedBigInteger::Word t = z.m_words[i] * k;
-        UnsignedBigInteger::Word carry_2 = montgomery_fragment(z, i, modulo, t, num_words);
-
-        // Compute the carry by combining all of the carries of the previous computations
-        // Put it "right after" the range that we computed above
-        UnsignedBigInteger::Word temp_carry = previous_double_carry + carry_1;
-        UnsignedBigInteger::Word overall_carry = temp_carry + carry_2;
-        z.m_words[num_words + i] = overall_carry;
-
-        // Detect if there was a "double carry" for this word by checking if our carry results are smaller than their components
-        previous_double_carry = (temp_carry < carry_1 || overall_carry < carry_2) ? 1 : 0;
+    __builtin_memset(t, 0, (limb_count + 2) * sizeof(Limb));
+
+    for (size_t i = 0; i < limb_count; ++i) {
+        // t += x * y_i
+        Limb carry = 0;
+        for (size_t j = 0; j < limb_count; ++j) {
+            DoubleLimb sum = static_cast<DoubleLimb>(x[j]) * y[i] + t[j] + carry;
+            t[j] = static_cast<Limb>(sum);
+            carry = static_cast<Limb>(sum >> bits_in_limb);
+        }
+        DoubleLimb top = static_cast<DoubleLimb>(t[limb_count]) + carry;
+        t[limb_count] = static_cast<Limb>(top);
+        t[limb_count + 1] = static_cast<Limb>(top >> bits_in_limb);
+
+        // t = (t + modulo * (t_0 * k)) / 2^bits_in_limb, which is exact, as that makes the lowest limb zero.
+        Limb m = t[0] * k;
+        DoubleLimb sum = static_cast<DoubleLimb>(m) * modulo[0] + t[0];
+        carry = static_cast<Limb>(sum >> bits_in_limb);
+        for (size_t j = 1; j < limb_count; ++j) {
+            sum = static_cast<DoubleLimb>(m) * modulo[j] + t[j] + carry;
+            t[j - 1] = static_cast<Limb>(sum);
+            carry = static_cast<Limb>(sum >> bits_in_limb);
+        }
+        top = static_cast<DoubleLimb>(t[limb_count]) + carry;
+        t[limb_count - 1] = static_cast<Limb>(top);
+        t[limb_count] = t[limb_count + 1] + static_cast<Limb>(top >> bits_in_limb);
     }
 
-    if (previous_double_carry == 0) {
-        // Return the top num_words bytes of Z, which contains our result.
-        shift_right_by_n_words(z, num_words, result);
-        result.resize_with_leading_zeros(num_words);
-        return;
+    // Now t < 2 * modulo, so subtracting it once, if needed, brings the result below modulo.
+    bool needs_subtraction = t[limb_count] != 0;
+    for (size_t i = limb_count; !needs_subtraction && i-- > 0;) {
+        if (t[i] != modulo[i]) {
+            needs_subtraction = t[i] > modulo[i];
+            break;
+        }
+        if (i == 0)
+            needs_subtraction = true;
     }
 
-    // We have a carry, so we're "one bigger" than we need to be.
-    // Subtract the modulo from the result (the top half of z), and write it to the bottom half of Z since we have space.
-    // (With carry, of course.)
-    UnsignedBigInteger::Word c { 0 };
-    for (size_t i = 0; i < num_words; ++i) {
-        UnsignedBigInteger::Word z_digit = z.m_words[num_words + i];
-        UnsignedBigInteger::Word modulo_digit = modulo.m_words[i];
-        UnsignedBigInteger::Word new_z_digit = z_digit - modulo_digit - c;
-        z.m_words[i] = new_z_digit;
-        // Detect if the subtraction underflowed - from "Hacker's Delight"
-        c = ((modulo_digit & ~z_digit) | ((modulo_digit | ~z_digit) & new_z_digit)) >> (UnsignedBigInteger::BITS_IN_WORD - 1);
+    if (!needs_subtraction) {
+        __builtin_memcpy(result, t, limb_count * sizeof(Limb));
+        return;
     }
 
-    // Return the bottom num_words bytes of Z (with the carry bit handled)
-    z.m_words.resize(num_words);
-    result.set_to(z);
-    result.resize_with_leading_zeros(num_words);
+    Limb borrow = 0;
+    for (size_t i = 0; i < limb_count; ++i) {
+        DoubleLimb difference = static_cast<DoubleLimb>(t[i]) - modulo[i] - borrow;
+        result[i] = static_cast<Limb>(difference);
+        borrow = static_cast<Limb>(difference >> bits_in_limb) & 1;
+    }
 }
 
 /**
  * Complexity: still O(N^3) with N the number of words in the largest word, but less complex than the classical mod power.
- * Note: the montgomery multiplications requires an inverse modulo over 2^32, which is only defined for odd numbers.
+ * Note: the montgomery multiplications requires an inverse modulo over 2^64, which is only defined for odd numbers.
  */
 void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocations(
     UnsignedBigInteger const& base,
@@ -202,35 +166,47 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
     constexpr size_t window_size = 4;
 
     size_t num_words = modulo.trimmed_length();
-    UnsignedBigInteger::Word k = inverse_wrapped(modulo.m_words[0]);
+    size_t limb_count = (num_words + 1) / 2;
 
     one.set_to(1);
 
-    // rr = ( 2 ^ (2 * modulo.length() * BITS_IN_WORD) ) % modulo
-    shift_left_by_n_words(one, 2 * num_words, x);
+    // rr = ( 2 ^ (2 * limb_count * bits_in_limb) ) % modulo
+    shift_left_by_n_words(one, 4 * limb_count, x);
     divide_without_allocation(x, modulo, temp_z, one, z, zz, temp_extra, rr);
-    rr.resize_with_leading_zeros(num_words);
 
-    // x = base [% modulo, if x doesn't already fit in modulo's words]
+    // x = base [% modulo, if x isn't already less than modulo]
     x.set_to(base);
-    if (x.trimmed_length() > num_words)
+    if (!(base < modulo))
         divide_without_allocation(base, modulo, temp_z, one, z, zz, temp_extra, x);
-    x.resize_with_leading_zeros(num_words);
 
-    one.set_to(1);
-    one.resize_with_leading_zeros(num_words);
+    // All the limbs we need live in a single buffer: modulo, rr, x, the working values z and zz,
+    // the scratch space of the multiplication, and the montgomery powers from 0 to 2^window_size.
+    Vector<Limb> buffer;
+    buffer.resize((6 + (1 << window_size)) * limb_count + 2);
+    auto* modulo_limbs = buffer.data();
+    auto* rr_limbs = modulo_limbs + limb_count;
+    auto* x_limbs = rr_limbs + limb_count;
+    auto* z_limbs = x_limbs + limb_count;
+    auto* zz_limbs = z_limbs + limb_count;
+    auto* powers = zz_limbs + limb_count;
+    auto* scratch = powers + (1 << window_size) * limb_count;
+    auto power = [&](size_t i) { return powers + i * limb_count; };
+
+    words_to_limbs(modulo, modulo_limbs, limb_count);
+    words_to_limbs(rr, rr_limbs, limb_count);
+    words_to_limbs(x, x_limbs, limb_count);
+    Limb k = negative_inverse_wrapped(modulo_limbs[0]);
 
     // Compute the montgomery powers from 0 to 2^window_size. powers[i] = x^i
-    UnsignedBigInteger powers[1 << window_size];
-    almost_montgomery_multiplication_without_allocation(one, rr, modulo, temp_z, k, num_words, powers[0]);
-    almost_montgomery_multiplication_without_allocation(x, rr, modulo, temp_z, k, num_words, powers[1]);
+    // The montgomery form of 1 is rr / 2^(limb_count * bits_in_limb), which is what multiplying rr by 1 gives us.
+    __builtin_memset(z_limbs, 0, limb_count * sizeof(Limb));
+    z_limbs[0] = 1;
+    montgomery_multiply(z_limbs, rr_limbs, modulo_limbs, k, limb_count, scratch, power(0));
+    montgomery_multiply(x_limbs, rr_limbs, modulo_limbs, k, limb_count, scratch, power(1));
     for (size_t i = 2; i < (1 << window_size); ++i)
-        almost_montgomery_multiplication_without_allocation(powers[i - 1], powers[1], modulo, temp_z, k, num_words, powers[i]);
+        montgomery_multiply(power(i - 1), power(1), modulo_limbs, k, limb_count, scratch, power(i));
 
-    z.set_to(powers[0]);
-    z.resize_with_leading_zeros(num_words);
-    zz.set_to(0);
-    zz.resize_with_leading_zeros(num_words);
+    __builtin_memcpy(z_limbs, power(0), limb_count * sizeof(Limb));
 
     ssize_t exponent_length = exponent.trimmed_length();
     for (ssize_t word_in_exponent = exponent_length - 1; word_in_exponent >= 0; --word_in_exponent) {
@@ -238,16 +214,15 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
         size_t bit_in_word = 0;
         while (bit_in_word < UnsignedBigInteger::BITS_IN_WORD) {
             if (word_in_exponent != exponent_length - 1 || bit_in_word != 0) {
-                almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
-                almost_montgomery_multiplication_without_allocation(zz, zz, modulo, temp_z, k, num_words, z);
-                almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
-                almost_montgomery_multiplication_without_allocation(zz, zz, modulo, temp_z, k, num_words, z);
+                montgomery_multiply(z_limbs, z_limbs, modulo_limbs, k, limb_count, scratch, zz_limbs);
+                montgomery_multiply(zz_limbs, zz_limbs, modulo_limbs, k, limb_count, scratch, z_limbs);
+                montgomery_multiply(z_limbs, z_limbs, modulo_limbs, k, limb_count, scratch, zz_limbs);
+                montgomery_multiply(zz_limbs, zz_limbs, modulo_limbs, k, limb_count, scratch, z_limbs);
             }
             auto power_index = exponent_word >> (UnsignedBigInteger::BITS_IN_WORD - window_size);
-            auto& power = powers[power_index];
-            almost_montgomery_multiplication_without_allocation(z, power, modulo, temp_z, k, num_words, zz);
+            montgomery_multiply(z_limbs, power(power_index), modulo_limbs, k, limb_count, scratch, zz_limbs);
 
-            swap(z, zz);
+            swap(z_limbs, zz_limbs);
 
             // Move to the next window
             exponent_word <<= window_size;
@@ -255,30 +230,18 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
         }
     }
 
-    almost_montgomery_multiplication_without_allocation(z, one, modulo, temp_z, k, num_words, zz);
+    // Multiplying by 1 takes z out of montgomery form.
+    __builtin_memset(x_limbs, 0, limb_count * sizeof(Limb));
+    x_limbs[0] = 1;
+    montgomery_multiply(z_limbs, x_limbs, modulo_limbs, k, limb_count, scratch, zz_limbs);
 
-    if (zz < modulo) {
-        result.set_to(zz);
-        result.clamp_to_trimmed_length();
-        return;
+    result.set_to_0();
+    result.m_words.resize_and_keep_capacity(2 * limb_count);
+    for (size_t i = 0; i < limb_count; ++i) {
+        result.m_words[2 * i] = static_cast<UnsignedBigInteger::Word>(zz_limbs[i]);
+        result.m_words[2 * i + 1] = static_cast<UnsignedBigInteger::Word>(zz_limbs[i] >> UnsignedBigInteger::BITS_IN_WORD);
     }
-
-    // Note : Since we were using "almost montgomery" multiplications, we aren't guaranteed to be under the modulo already.
-    // So, if we're here, we need to respect the modulo.
-    // We can, however, start by trying to subtract the modulo, just in case we're close.
-    subtract_without_allocation(zz, modulo, result);
-
-    if (modulo < zz) {
-        // Note: This branch shouldn't happen in theory (as noted in https://github.com/rust-num/num-bigint/blob/master/src/biguint/monty.rs#L210)
-        // Let's dbgln the values we used. That way, if we hit this branch, we can contribute these values for test cases.
-        dbgln("Encountered the modulo branch during a montgomery modular power. Params : {} - {} - {}", base, exponent, modulo);
-        // We just clobber all the other temporaries that we don't need for the division.
-        // This is wasteful, but we're on the edgiest of cases already.
-        divide_without_allocation(zz, modulo, temp_z, rr, z, x, temp_extra, result);
-    }
-
     result.clamp_to_trimmed_length();
-    return;
 }
 
 }
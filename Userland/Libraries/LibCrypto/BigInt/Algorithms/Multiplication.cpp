@@ -9,38 +9,183 @@
 
 namespace Crypto {
 
+using Word = UnsignedBigInteger::Word;
+using DoubleWord = u64;
+static_assert(sizeof(DoubleWord) == 2 * sizeof(Word));
+
+// Below this many words, Karatsuba's additions and subtractions cost more than the multiplications they save.
+static constexpr size_t karatsuba_threshold = 32;
+
+/**
+ * Computes out = a * b, where out has a_length + b_length words.
+ * Complexity: O(N*M) where N and M are the number of words in a and b
+ */
+static void schoolbook_multiply(Word* out, Word const* a, size_t a_length, Word const* b, size_t b_length)
+{
+    __builtin_memset(out, 0, (a_length + b_length) * sizeof(Word));
+    for (size_t i = 0; i < a_length; ++i) {
+        DoubleWord a_word = a[i];
+        DoubleWord carry = 0;
+        for (size_t j = 0; j < b_length; ++j) {
+            DoubleWord product = a_word * b[j] + out[i + j] + carry;
+            out[i + j] = static_cast<Word>(product);
+            carry = product >> UnsignedBigInteger::BITS_IN_WORD;
+        }
+        out[i + b_length] = static_cast<Word>(carry);
+    }
+}
+
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
+ * Adds source to destination, rippling the carry through all of destination's words. Returns the carry out of the last word.
+ */
+static Word add_words(Word* destination, size_t destination_length, Word const* source, size_t source_length)
+{
+    VERIFY(source_length <= destination_length);
+    Word carry = 0;
+    size_t i = 0;
+    for (; i < source_length; ++i) {
+        DoubleWord sum = static_cast<DoubleWord>(destination[i]) + source[i] + carry;
+        destination[i] = static_cast<Word>(sum);
+        carry = static_cast<Word>(sum >> UnsignedBigInteger::BITS_IN_WORD);
+    }
+    for (; carry && i < destination_length; ++i) {
+        destination[i] += carry;
+        carry = destination[i] == 0 ? 1 : 0;
+    }
+    return carry;
+}
+
+/**
+ * Subtracts source from destination, which mustn't be smaller.
+ */
+static void subtract_words(Word* destination, size_t destination_length, Word const* source, size_t source_length)
+{
+    VERIFY(source_length <= destination_length);
+    Word borrow = 0;
+    size_t i = 0;
+    for (; i < source_length; ++i) {
+        DoubleWord difference = static_cast<DoubleWord>(destination[i]) - source[i] - borrow;
+        destination[i] = static_cast<Word>(difference);
+        borrow = static_cast<Word>(difference >> UnsignedBigInteger::BITS_IN_WORD) & 1;
+    }
+    for (; borrow && i < destination_length; ++i) {
+        borrow = destination[i] == 0 ? 1 : 0;
+        --destination[i];
+    }
+    VERIFY(borrow == 0);
+}
+
+static size_t karatsuba_scratch_length(size_t length)
+{
+    if (length < karatsuba_threshold)
+        return 0;
+    auto high_length = length - length / 2;
+    return 4 * (high_length + 1) + karatsuba_scratch_length(high_length + 1);
+}
+
+/**
+ * Computes out = a * b, where a and b both have `length` words, and out has twice as many.
+ * With a = a1 * W^h + a0 and b = b1 * W^h + b0, we have
+ *     a * b = a1*b1 * W^2h + ((a0 + a1) * (b0 + b1) - a0*b0 - a1*b1) * W^h + a0*b0
+ * which takes three multiplications of half the size, instead of four.
+ * Complexity: O(N^log2(3)) where N is the number of words
+ */
+static void karatsuba_multiply(Word* out, Word const* a, Word const* b, size_t length, Word* scratch)
+{
+    if (length < karatsuba_threshold) {
+        schoolbook_multiply(out, a, length, b, length);
+        return;
+    }
+
+    auto low_length = length / 2;
+    auto high_length = length - low_length;
+    auto sum_length = high_length + 1;
+
+    // a0*b0 and a1*b1 go right where they belong in the result.
+    karatsuba_multiply(out, a, b, low_length, scratch);
+    karatsuba_multiply(out + 2 * low_length, a + low_length, b + low_length, high_length, scratch);
+
+    Word* a_sum = scratch;
+    Word* b_sum = a_sum + sum_length;
+    Word* middle = b_sum + sum_length;
+    Word* next_scratch = middle + 2 * sum_length;
+
+    __builtin_memcpy(a_sum, a + low_length, high_length * sizeof(Word));
+    a_sum[high_length] = add_words(a_sum, high_length, a, low_length);
+    __builtin_memcpy(b_sum, b + low_length, high_length * sizeof(Word));
+    b_sum[high_length] = add_words(b_sum, high_length, b, low_length);
+
+    karatsuba_multiply(middle, a_sum, b_sum, sum_length, next_scratch);
+    subtract_words(middle, 2 * sum_length, out, 2 * low_length);
+    subtract_words(middle, 2 * sum_length, out + 2 * low_length, 2 * high_length);
+
+    // The middle term is less than 2 * W^length, so its top words are zero past what fits into the result.
+    auto middle_length = min(2 * sum_length, 2 * length - low_length);
+    add_words(out + low_length, 2 * length - low_length, middle, middle_length);
+}
+
+/**
+ * Complexity: O(N^log2(3)) where N is the number of words in the larger number,
+ *             or O(N*M) if the smaller one, with M words, is too small for Karatsuba to help.
  * Multiplication method:
- * An integer is equal to the sum of the powers of two
- * according to the indices of its 'on' bits.
- * So to multiple x*y, we go over each '1' bit in x (say the i'th bit),
- * and add y<<i to the result.
+ * Small numbers are multiplied word by word, as in long multiplication. Larger ones are split in halves
+ * recursively, using Karatsuba's trick. If one number is a lot longer than the other, it is multiplied
+ * in pieces as long as the shorter one.
  */
 FLATTEN void UnsignedBigIntegerAlgorithms::multiply_without_allocation(
     UnsignedBigInteger const& left,
     UnsignedBigInteger const& right,
-    UnsignedBigInteger& temp_shift_result,
-    UnsignedBigInteger& temp_shift_plus,
-    UnsignedBigInteger& temp_shift,
+    UnsignedBigInteger& temp_piece,
+    UnsignedBigInteger& temp_product,
+    UnsignedBigInteger& temp_scratch,
     UnsignedBigInteger& output)
 {
+    auto const* longer = &left;
+    auto const* shorter = &right;
+    if (longer->trimmed_length() < shorter->trimmed_length())
+        swap(longer, shorter);
+    auto longer_length = longer->trimmed_length();
+    auto shorter_length = shorter->trimmed_length();
+
     output.set_to_0();
+    if (shorter_length == 0)
+        return;
+    output.m_words.resize_and_keep_capacity(longer_length + shorter_length);
+    auto* out = output.m_words.data();
 
-    // iterate all bits
-    for (size_t word_index = 0; word_index < left.length(); ++word_index) {
-        for (size_t bit_index = 0; bit_index < UnsignedBigInteger::BITS_IN_WORD; ++bit_index) {
-            // If the bit is off - skip over it
-            if (!(left.m_words[word_index] & (1 << bit_index)))
-                continue;
+    if (shorter_length < karatsuba_threshold) {
+        schoolbook_multiply(out, longer->m_words.data(), longer_length, shorter->m_words.data(), shorter_length);
+        output.clamp_to_trimmed_length();
+        return;
+    }
 
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
+    temp_scratch.set_to_0();
+    temp_scratch.m_words.resize_and_keep_capacity(karatsuba_scratch_length(shorter_length));
+    auto* scratch = temp_scratch.m_words.data();
 
-            // output += (right << shift_amount);
-            shift_left_without_allocation(right, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-            add_into_accumulator_without_allocation(output, temp_shift);
-        }
+    if (longer_length == shorter_length) {
+        karatsuba_multiply(out, longer->m_words.data(), shorter->m_words.data(), shorter_length, scratch);
+        output.clamp_to_trimmed_length();
+        return;
+    }
+
+    temp_piece.set_to_0();
+    temp_piece.resize_with_leading_zeros(shorter_length);
+    temp_product.set_to_0();
+    temp_product.m_words.resize_and_keep_capacity(2 * shorter_length);
+
+    __builtin_memset(out, 0, (longer_length + shorter_length) * sizeof(Word));
+    for (size_t offset = 0; offset < longer_length; offset += shorter_length) {
+        // The last piece may be shorter, so it's padded with zeros.
+        auto piece_length = min(shorter_length, longer_length - offset);
+        __builtin_memcpy(temp_piece.m_words.data(), longer->m_words.data() + offset, piece_length * sizeof(Word));
+        __builtin_memset(temp_piece.m_words.data() + piece_length, 0, (shorter_length - piece_length) * sizeof(Word));
+
+        karatsuba_multiply(temp_product.m_words.data(), temp_piece.m_words.data(), shorter->m_words.data(), shorter_length, scratch);
+        auto remaining_length = longer_length + shorter_length - offset;
+        add_words(out + offset, remaining_length, temp_product.m_words.data(), min(2 * shorter_length, remaining_length));
     }
+    output.clamp_to_trimmed_length();
 }
 
 }
@@ -4,17 +4,90 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Platform.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/Adler32.h>
 
+#if ARCH(X86_64)
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Checksum {
 
+static constexpr u32 adler32_modulus = 65521;
+
+// The most bytes that can be summed up before b overflows 32 bits, even if a and b start out just below the modulus.
+static constexpr size_t bytes_per_reduction = 5552;
+
+#if ARCH(X86_64)
+// Sums up 32 bytes at a time: a gains the sum of the bytes, and b gains 32 times the a from before the block, plus each byte
+// weighted by how many of the block's a's still include it (32 for the first one, down to 1 for the last one).
+[[gnu::target("ssse3")]] static void update_ssse3(u32& state_a, u32& state_b, ReadonlyBytes data)
+{
+    constexpr size_t block_size = 32;
+    VERIFY(data.size() % block_size == 0);
+
+    auto const first_weights = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+    auto const second_weights = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    auto const ones = _mm_set1_epi16(1);
+    auto const zero = _mm_setzero_si128();
+    auto sum_lanes = [](__m128i value) {
+        value = _mm_add_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)));
+        value = _mm_add_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2)));
+        return static_cast<u32>(_mm_cvtsi128_si32(value));
+    };
+
+    while (!data.is_empty()) {
+        auto chunk = data.trim(bytes_per_reduction / block_size * block_size);
+        auto block_count = chunk.size() / block_size;
+
+        // The a from before the chunk goes into b once for each of its bytes.
+        auto previous_a_sums = _mm_cvtsi32_si128(static_cast<int>(state_a * block_count));
+        auto a = zero;
+        auto b = _mm_cvtsi32_si128(static_cast<int>(state_b));
+        for (size_t i = 0; i < chunk.size(); i += block_size) {
+            auto first = _mm_loadu_si128(reinterpret_cast<__m128i const*>(chunk.offset(i)));
+            auto second = _mm_loadu_si128(reinterpret_cast<__m128i const*>(chunk.offset(i + 16)));
+            previous_a_sums = _mm_add_epi32(previous_a_sums, a);
+            a = _mm_add_epi32(a, _mm_add_epi32(_mm_sad_epu8(first, zero), _mm_sad_epu8(second, zero)));
+            b = _mm_add_epi32(b, _mm_madd_epi16(_mm_maddubs_epi16(first, first_weights), ones));
+            b = _mm_add_epi32(b, _mm_madd_epi16(_mm_maddubs_epi16(second, second_weights), ones));
+        }
+        b = _mm_add_epi32(b, _mm_slli_epi32(previous_a_sums, 5));
+
+        state_a = (state_a + sum_lanes(a)) % adler32_modulus;
+        state_b = sum_lanes(b) % adler32_modulus;
+        data = data.slice(chunk.size());
+    }
+}
+
+static bool cpu_supports_ssse3()
+{
+    static bool const supports_ssse3 = __builtin_cpu_supports("ssse3");
+    return supports_ssse3;
+}
+#endif
+
 void Adler32::update(ReadonlyBytes data)
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state_a = (m_state_a + data.at(i)) % 65521;
-        m_state_b = (m_state_b + m_state_a) % 65521;
+#if ARCH(X86_64)
+    if (data.size() >= 64 && cpu_supports_ssse3()) {
+        auto block_bytes = data.size() - data.size() % 32;
+        update_ssse3(m_state_a, m_state_b, data.trim(block_bytes));
+        data = data.slice(block_bytes);
+    }
+#endif
+
+    while (!data.is_empty()) {
+        auto chunk = data.trim(bytes_per_reduction);
+        for (auto byte : chunk) {
+            m_state_a += byte;
+            m_state_b += m_state_a;
+        }
+        m_state_a %= adler32_modulus;
+        m_state_b %= adler32_modulus;
+        data = data.slice(chunk.size());
     }
 };
 
@@ -23,4 +96,19 @@ u32 Adler32::digest()
     return (m_state_b << 16) | m_state_a;
 }
 
+u32 Adler32::combine(u32 first_checksum, u32 second_checksum, size_t second_length)
+{
+    // a counts every byte once, plus the initial 1. b adds up every a, so each of the second piece's b terms gains the
+    // first piece's a (minus its initial 1).
+    u64 first_a = first_checksum & 0xffff;
+    u64 first_b = first_checksum >> 16;
+    u64 second_a = second_checksum & 0xffff;
+    u64 second_b = second_checksum >> 16;
+    u64 length = second_length % adler32_modulus;
+
+    u64 a = (first_a + second_a + adler32_modulus - 1) % adler32_modulus;
+    u64 b = (first_b + second_b + length * (first_a + adler32_modulus - 1)) % adler32_modulus;
+    return static_cast<u32>((b << 16) | a);
+}
+
 }
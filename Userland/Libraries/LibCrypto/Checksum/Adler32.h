@@ -30,6 +30,9 @@ public:
     virtual void update(ReadonlyBytes data) override;
     virtual u32 digest() override;
 
+    // The checksum of two pieces of data one after the other, from the checksums of each of them.
+    static u32 combine(u32 first_checksum, u32 second_checksum, size_t second_length);
+
 private:
     u32 m_state_a { 1 };
     u32 m_state_b { 0 };
@@ -5,16 +5,24 @@
  */
 
 #include <AK/Array.h>
+#include <AK/ByteReader.h>
+#include <AK/Endian.h>
+#include <AK/Platform.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/CRC32.h>
 
+#if ARCH(X86_64)
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Checksum {
 
-static constexpr auto generate_table()
+// Table k holds the CRC of each byte followed by k zero bytes, which lets update() look up 8 bytes at once ("slice-by-8").
+static constexpr auto generate_tables()
 {
-    Array<u32, 256> data {};
-    for (auto i = 0u; i < data.size(); i++) {
+    Array<Array<u32, 256>, 8> data {};
+    for (auto i = 0u; i < 256; i++) {
         u32 value = i;
 
         for (auto j = 0; j < 8; j++) {
@@ -25,18 +33,93 @@ static constexpr auto generate_table()
             }
         }
 
-        data[i] = value;
+        data[0][i] = value;
+    }
+    for (auto k = 1u; k < data.size(); k++) {
+        for (auto i = 0u; i < 256; i++)
+            data[k][i] = (data[k - 1][i] >> 8) ^ data[0][data[k - 1][i] & 0xFF];
     }
     return data;
 }
 
-static constexpr auto table = generate_table();
+static constexpr auto tables = generate_tables();
+
+static u32 update_slice_by_8(u32 state, ReadonlyBytes data)
+{
+    auto const& table = tables[0];
+    size_t i = 0;
+    for (; i + 8 <= data.size(); i += 8) {
+        u32 low = state ^ AK::convert_between_host_and_little_endian(ByteReader::load32(data.offset(i)));
+        u32 high = AK::convert_between_host_and_little_endian(ByteReader::load32(data.offset(i + 4)));
+        state = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^ tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24]
+            ^ tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^ tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+    }
+    for (; i < data.size(); i++)
+        state = table[(state ^ data[i]) & 0xFF] ^ (state >> 8);
+    return state;
+}
+
+#if ARCH(X86_64)
+// Folding with carry-less multiplications from Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction",
+// using the constants for the bit-reflected polynomial. Each fold multiplies 128 bits of the data by x^n modulo the polynomial to
+// move them n bits further along, where the next block gets XORed in. The remaining 128 bits have the same CRC as everything
+// that was folded into them, so the tables do the final reduction.
+[[gnu::target("pclmul,sse2")]] static __m128i fold(__m128i value, __m128i constants, __m128i next)
+{
+    auto low = _mm_clmulepi64_si128(value, constants, 0x00);
+    auto high = _mm_clmulepi64_si128(value, constants, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(low, high), next);
+}
+
+[[gnu::target("pclmul,sse2")]] static u32 update_pclmul(u32 state, ReadonlyBytes data)
+{
+    VERIFY(data.size() >= 64 && data.size() % 16 == 0);
+
+    auto const fold_by_4 = _mm_set_epi64x(0x1c6e41596, 0x154442bd4);
+    auto const fold_by_1 = _mm_set_epi64x(0xccaa009e, 0x1751997d0);
+    auto load = [&](size_t offset) { return _mm_loadu_si128(reinterpret_cast<__m128i const*>(data.offset(offset))); };
+
+    auto x0 = _mm_xor_si128(load(0), _mm_cvtsi32_si128(static_cast<int>(state)));
+    auto x1 = load(16);
+    auto x2 = load(32);
+    auto x3 = load(48);
+    size_t offset = 64;
+    for (; offset + 64 <= data.size(); offset += 64) {
+        x0 = fold(x0, fold_by_4, load(offset));
+        x1 = fold(x1, fold_by_4, load(offset + 16));
+        x2 = fold(x2, fold_by_4, load(offset + 32));
+        x3 = fold(x3, fold_by_4, load(offset + 48));
+    }
+
+    x0 = fold(x0, fold_by_1, x1);
+    x0 = fold(x0, fold_by_1, x2);
+    x0 = fold(x0, fold_by_1, x3);
+    for (; offset < data.size(); offset += 16)
+        x0 = fold(x0, fold_by_1, load(offset));
+
+    u8 remainder[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(remainder), x0);
+    return update_slice_by_8(0, { remainder, sizeof(remainder) });
+}
+
+static bool cpu_supports_pclmul()
+{
+    static bool const supports_pclmul = __builtin_cpu_supports("pclmul");
+    return supports_pclmul;
+}
+#endif
 
 void CRC32::update(ReadonlyBytes data)
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state = table[(m_state ^ data.at(i)) & 0xFF] ^ (m_state >> 8);
+#if ARCH(X86_64)
+    if (data.size() >= 64 && cpu_supports_pclmul()) {
+        auto folded_size = data.size() - data.size() % 16;
+        m_state = update_pclmul(m_state, data.trim(folded_size));
+        data = data.slice(folded_size);
     }
+#endif
+
+    m_state = update_slice_by_8(m_state, data);
 };
 
 u32 CRC32::digest()
@@ -44,4 +127,43 @@ u32 CRC32::digest()
     return ~m_state;
 }
 
+// CRCs are remainders of polynomials over GF(2), which are stored with the coefficient of x^0 in the highest bit.
+static constexpr u32 multiply_modulo_polynomial(u32 a, u32 b)
+{
+    u32 product = 0;
+    for (u32 mask = 1u << 31; mask != 0; mask >>= 1) {
+        if (a & mask)
+            product ^= b;
+        b = (b & 1) ? (b >> 1) ^ 0xEDB88320 : b >> 1;
+    }
+    return product;
+}
+
+// x^(2^n) modulo the polynomial, for every n that a 32-bit exponent needs.
+static constexpr auto generate_powers_of_x_table()
+{
+    Array<u32, 32> data {};
+    u32 power = 1u << 30; // x^1
+    for (auto& entry : data) {
+        entry = power;
+        power = multiply_modulo_polynomial(power, power);
+    }
+    return data;
+}
+
+static constexpr auto powers_of_x_table = generate_powers_of_x_table();
+
+u32 CRC32::combine(u32 first_checksum, u32 second_checksum, size_t second_length)
+{
+    // Appending n bytes to the first piece multiplies its CRC by x^(8n), and the initial and final inversions of the
+    // two pieces cancel out, leaving only the CRC of the second piece to be added. This is what zlib's crc32_combine() does.
+    u32 shift = 1u << 31; // x^0
+    size_t n = 3;         // x^(8 * length) = x^(2^3 * length)
+    for (u64 length = second_length; length != 0; length >>= 1, ++n) {
+        if (length & 1)
+            shift = multiply_modulo_polynomial(powers_of_x_table[n % 32], shift);
+    }
+    return multiply_modulo_polynomial(shift, first_checksum) ^ second_checksum;
+}
+
 }
@@ -4,13 +4,81 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteReader.h>
+#include <AK/Endian.h>
+#include <AK/Platform.h>
 #include <AK/StringBuilder.h>
 #include <LibCrypto/Cipher/AES.h>
 #include <LibCrypto/Cipher/AESTables.h>
 
+// The kernel doesn't save the SSE registers for its own code, so it always uses the table-based implementation.
+#if ARCH(X86_64) && !defined(KERNEL)
+#    define AES_USE_AES_NI
+#    include <immintrin.h>
+#endif
+
 namespace Crypto {
 namespace Cipher {
 
+#ifdef AES_USE_AES_NI
+// These use the round keys as they are laid out by update_round_key_bytes(). The decryption keys are already
+// those of the "equivalent inverse cipher" that AESDEC expects, as that's what the table-based implementation uses too.
+[[gnu::target("aes,sse2")]] static void encrypt_block_aes_ni(u8 const* round_keys, size_t rounds, u8 const* in, u8* out)
+{
+    auto const* keys = reinterpret_cast<__m128i const*>(round_keys);
+    auto state = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in)), _mm_loadu_si128(&keys[0]));
+    for (size_t round = 1; round < rounds; ++round)
+        state = _mm_aesenc_si128(state, _mm_loadu_si128(&keys[round]));
+    state = _mm_aesenclast_si128(state, _mm_loadu_si128(&keys[rounds]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), state);
+}
+
+[[gnu::target("aes,sse2")]] static void decrypt_block_aes_ni(u8 const* round_keys, size_t rounds, u8 const* in, u8* out)
+{
+    auto const* keys = reinterpret_cast<__m128i const*>(round_keys);
+    auto state = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in)), _mm_loadu_si128(&keys[0]));
+    for (size_t round = 1; round < rounds; ++round)
+        state = _mm_aesdec_si128(state, _mm_loadu_si128(&keys[round]));
+    state = _mm_aesdeclast_si128(state, _mm_loadu_si128(&keys[rounds]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), state);
+}
+
+// Each AESENC takes several cycles until its result is there, but a new one can start every cycle,
+// so encrypting a few independent blocks side by side is several times faster than one after the other.
+[[gnu::target("aes,sse2")]] static void encrypt_blocks_aes_ni(u8 const* round_keys, size_t rounds, u8 const* in, u8* out, size_t block_count)
+{
+    static constexpr size_t blocks_at_once = 8;
+    auto const* keys = reinterpret_cast<__m128i const*>(round_keys);
+    auto const* input = reinterpret_cast<__m128i const*>(in);
+    auto* output = reinterpret_cast<__m128i*>(out);
+
+    size_t block = 0;
+    for (; block + blocks_at_once <= block_count; block += blocks_at_once) {
+        __m128i state[blocks_at_once];
+        auto key = _mm_loadu_si128(&keys[0]);
+        for (size_t i = 0; i < blocks_at_once; ++i)
+            state[i] = _mm_xor_si128(_mm_loadu_si128(&input[block + i]), key);
+        for (size_t round = 1; round < rounds; ++round) {
+            key = _mm_loadu_si128(&keys[round]);
+            for (size_t i = 0; i < blocks_at_once; ++i)
+                state[i] = _mm_aesenc_si128(state[i], key);
+        }
+        key = _mm_loadu_si128(&keys[rounds]);
+        for (size_t i = 0; i < blocks_at_once; ++i)
+            _mm_storeu_si128(&output[block + i], _mm_aesenclast_si128(state[i], key));
+    }
+
+    for (; block < block_count; ++block)
+        encrypt_block_aes_ni(round_keys, rounds, in + block * 16, out + block * 16);
+}
+
+static bool cpu_supports_aes_ni()
+{
+    static bool const supports_aes_ni = __builtin_cpu_supports("aes");
+    return supports_aes_ni;
+}
+#endif
+
 template<typename T>
 constexpr u32 get_key(T pt)
 {
@@ -197,8 +265,41 @@ void AESCipherKey::expand_decrypt_key(ReadonlyBytes user_key, size_t bits)
     }
 }
 
+void AESCipherKey::update_round_key_bytes()
+{
+    for (size_t i = 0; i < (rounds() + 1) * 4; ++i)
+        ByteReader::store(m_rd_key_bytes + i * 4, AK::convert_between_host_and_big_endian(m_rd_keys[i]));
+}
+
+void AESCipher::encrypt_blocks(ReadonlyBytes in, Bytes out)
+{
+    VERIFY(in.size() % 16 == 0);
+    VERIFY(out.size() >= in.size());
+
+#ifdef AES_USE_AES_NI
+    if (cpu_supports_aes_ni()) {
+        encrypt_blocks_aes_ni(key().round_key_bytes(), key().rounds(), in.data(), out.data(), in.size() / 16);
+        return;
+    }
+#endif
+
+    AESCipherBlock block;
+    for (size_t offset = 0; offset < in.size(); offset += 16) {
+        block.overwrite(in.slice(offset, 16));
+        encrypt_block(block, block);
+        block.bytes().copy_to(out.slice(offset));
+    }
+}
+
 void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#ifdef AES_USE_AES_NI
+    if (cpu_supports_aes_ni()) {
+        encrypt_block_aes_ni(key().round_key_bytes(), key().rounds(), in.bytes().data(), out.bytes().data());
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -288,6 +389,13 @@ void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 
 void AESCipher::decrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#ifdef AES_USE_AES_NI
+    if (cpu_supports_aes_ni()) {
+        decrypt_block_aes_ni(key().round_key_bytes(), key().rounds(), in.bytes().data(), out.bytes().data());
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -73,6 +73,9 @@ struct AESCipherKey : public CipherKey {
         return (u32 const*)m_rd_keys;
     }
 
+    // The same round keys, as the bytes the AES instructions take for them.
+    u8 const* round_key_bytes() const { return m_rd_key_bytes; }
+
     AESCipherKey(ReadonlyBytes user_key, size_t key_bits, Intent intent)
         : m_bits(key_bits)
     {
@@ -80,6 +83,7 @@ struct AESCipherKey : public CipherKey {
             expand_encrypt_key(user_key, key_bits);
         else
             expand_decrypt_key(user_key, key_bits);
+        update_round_key_bytes();
     }
 
     virtual ~AESCipherKey() override = default;
@@ -94,8 +98,11 @@ protected:
     }
 
 private:
+    void update_round_key_bytes();
+
     static constexpr size_t MAX_ROUND_COUNT = 14;
     u32 m_rd_keys[(MAX_ROUND_COUNT + 1) * 4] { 0 };
+    u8 m_rd_key_bytes[(MAX_ROUND_COUNT + 1) * 16] { 0 };
     size_t m_rounds;
     size_t m_bits;
 };
@@ -120,6 +127,10 @@ public:
     virtual void encrypt_block(BlockType const& in, BlockType& out) override;
     virtual void decrypt_block(BlockType const& in, BlockType& out) override;
 
+    // Encrypts every block of `in` on its own into `out`, several of them at once where the CPU can. This is what
+    // CTR mode uses to encrypt its counters.
+    void encrypt_blocks(ReadonlyBytes in, Bytes out);
+
 #ifndef KERNEL
     virtual DeprecatedString class_name() const override
     {
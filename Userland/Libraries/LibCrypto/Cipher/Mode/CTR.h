@@ -171,6 +171,33 @@ protected:
         size_t offset { 0 };
         auto block_size = cipher.block_size();
 
+        // Ciphers that can encrypt several blocks at once get a batch of consecutive counters at a time.
+        if constexpr (requires { cipher.encrypt_blocks(ReadonlyBytes {}, Bytes {}); }) {
+            constexpr size_t blocks_per_batch = 8;
+            u8 counters[blocks_per_batch * IVSizeInBits / 8];
+            u8 key_stream[blocks_per_batch * IVSizeInBits / 8];
+
+            while (length >= block_size && block_size == IV_length()) {
+                auto block_count = min(blocks_per_batch, length / block_size);
+                for (size_t i = 0; i < block_count; ++i) {
+                    __builtin_memcpy(counters + i * block_size, iv.data(), block_size);
+                    increment(iv);
+                }
+
+                auto batch_size = block_count * block_size;
+                cipher.encrypt_blocks({ counters, batch_size }, { key_stream, batch_size });
+                if (in) {
+                    for (size_t i = 0; i < batch_size; ++i)
+                        key_stream[i] ^= (*in)[offset + i];
+                }
+
+                VERIFY(offset + batch_size <= out.size());
+                __builtin_memcpy(out.offset(offset), key_stream, batch_size);
+                length -= batch_size;
+                offset += batch_size;
+            }
+        }
+
         while (length > 0) {
             m_cipher_block.overwrite(iv.slice(0, block_size));
 
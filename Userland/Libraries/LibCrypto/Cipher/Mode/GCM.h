@@ -93,12 +93,21 @@ public:
         // Skip past block 0
         CTR<T>::increment(iv);
 
-        if (in.is_empty())
+        m_ghash->begin(aad);
+        if (in.is_empty()) {
             CTR<T>::key_stream(out, iv);
-        else
-            CTR<T>::encrypt(in, out, iv);
+            m_ghash->update(out);
+        } else {
+            // Each chunk is hashed right after it was encrypted, while it's still in the cache.
+            for (size_t offset = 0; offset < in.size(); offset += fused_chunk_size) {
+                auto chunk_size = min(fused_chunk_size, in.size() - offset);
+                auto out_chunk = out.slice(offset, chunk_size);
+                CTR<T>::encrypt(in.slice(offset, chunk_size), out_chunk, iv, &iv);
+                m_ghash->update(out_chunk);
+            }
+        }
 
-        auto auth_tag = m_ghash->process(aad, out);
+        auto auth_tag = m_ghash->finish();
         block0.apply_initialization_vector({ auth_tag.data, array_size(auth_tag.data) });
         block0.bytes().copy_to(tag);
     }
@@ -121,27 +130,36 @@ public:
         // Skip past block 0
         CTR<T>::increment(iv);
 
-        auto auth_tag = m_ghash->process(aad, in);
-        block0.apply_initialization_vector({ auth_tag.data, array_size(auth_tag.data) });
-
         auto test_consistency = [&] {
+            auto auth_tag = m_ghash->finish();
+            block0.apply_initialization_vector({ auth_tag.data, array_size(auth_tag.data) });
+
             if (block0.block_size() != tag.size() || !timing_safe_compare(block0.bytes().data(), tag.data(), tag.size()))
                 return VerificationConsistency::Inconsistent;
 
             return VerificationConsistency::Consistent;
         };
 
+        m_ghash->begin(aad);
         if (in.is_empty()) {
             out = {};
             return test_consistency();
         }
 
-        CTR<T>::encrypt(in, out, iv);
+        // Each chunk is hashed right before it's decrypted, so it only has to be brought into the cache once.
+        for (size_t offset = 0; offset < in.size(); offset += fused_chunk_size) {
+            auto chunk_size = min(fused_chunk_size, in.size() - offset);
+            auto in_chunk = in.slice(offset, chunk_size);
+            auto out_chunk = out.slice(offset, chunk_size);
+            m_ghash->update(in_chunk);
+            CTR<T>::encrypt(in_chunk, out_chunk, iv, &iv);
+        }
         return test_consistency();
     }
 
 private:
     static constexpr auto block_size = T::BlockType::BlockSizeInBits / 8;
+    static constexpr size_t fused_chunk_size = 64 * block_size;
     u8 m_auth_key_storage[block_size];
     Bytes m_auth_key { m_auth_key_storage, block_size };
     Optional<Authentication::GHash> m_ghash;
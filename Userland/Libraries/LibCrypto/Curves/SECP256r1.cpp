@@ -16,7 +16,6 @@ namespace Crypto::Curves {
 
 static constexpr u256 REDUCE_PRIME { u128 { 0x0000000000000001ull, 0xffffffff00000000ull }, u128 { 0xffffffffffffffffull, 0x00000000fffffffe } };
 static constexpr u256 REDUCE_ORDER { u128 { 0x0c46353d039cdaafull, 0x4319055258e8617bull }, u128 { 0x0000000000000000ull, 0x00000000ffffffff } };
-static constexpr u256 PRIME_INVERSE_MOD_R { u128 { 0x0000000000000001ull, 0x0000000100000000ull }, u128 { 0x0000000000000000ull, 0xffffffff00000002ull } };
 static constexpr u256 PRIME { u128 { 0xffffffffffffffffull, 0x00000000ffffffffull }, u128 { 0x0000000000000000ull, 0xffffffff00000001ull } };
 static constexpr u256 R2_MOD_PRIME { u128 { 0x0000000000000003ull, 0xfffffffbffffffffull }, u128 { 0xfffffffffffffffeull, 0x00000004fffffffdull } };
 static constexpr u256 ONE { 1u };
@@ -55,12 +54,6 @@ static u256 select(u256 const& left, u256 const& right, bool condition)
     return (left & mask) | (right & ~mask);
 }
 
-static u512 multiply(u256 const& left, u256 const& right)
-{
-    auto result = left.wide_multiply(right);
-    return { result.low, result.high };
-}
-
 static u256 modular_reduce(u256 const& value)
 {
     // Add -prime % 2^256 = 2^224-2^192-2^96+1
@@ -119,22 +112,54 @@ static u256 modular_multiply(u256 const& left, u256 const& right)
 {
     // Modular multiplication using the Montgomery method: https://en.wikipedia.org/wiki/Montgomery_modular_multiplication
     // This requires that the inputs to this function are in Montgomery form.
+    //
+    // This interleaves the multiplication with the reduction one 64-bit limb at a time ("CIOS"), which keeps everything in registers.
+    // The lowest limb of the prime is 2^64 - 1, so -prime^-1 mod 2^64 is 1 and the multiple of the prime to add in each step is
+    // just the lowest limb. The third limb of the prime is zero, so that product is skipped.
+    using DoubleLimb = unsigned __int128;
+    constexpr u64 prime_1 = 0x00000000ffffffffull;
+    constexpr u64 prime_3 = 0xffffffff00000001ull;
+
+    u64 a[4] { left.low().low(), left.low().high(), left.high().low(), left.high().high() };
+    u64 b[4] { right.low().low(), right.low().high(), right.high().low(), right.high().high() };
+    u64 t[5] {};
+    u64 top = 0;
+
+    for (size_t i = 0; i < 4; ++i) {
+        // t += a * b[i]
+        DoubleLimb carry = 0;
+        for (size_t j = 0; j < 4; ++j) {
+            carry += (DoubleLimb)a[j] * b[i] + t[j];
+            t[j] = static_cast<u64>(carry);
+            carry >>= 64;
+        }
+        carry += t[4];
+        t[4] = static_cast<u64>(carry);
+        top = static_cast<u64>(carry >> 64);
+
+        // t = (t + m * prime) / 2^64, with m = t[0]
+        u64 m = t[0];
+        carry = (DoubleLimb)m * 0xffffffffffffffffull + t[0];
+        carry >>= 64;
+        carry += (DoubleLimb)m * prime_1 + t[1];
+        t[0] = static_cast<u64>(carry);
+        carry >>= 64;
+        carry += t[2];
+        t[1] = static_cast<u64>(carry);
+        carry >>= 64;
+        carry += (DoubleLimb)m * prime_3 + t[3];
+        t[2] = static_cast<u64>(carry);
+        carry >>= 64;
+        carry += t[4];
+        t[3] = static_cast<u64>(carry);
+        t[4] = top + static_cast<u64>(carry >> 64);
+    }
 
-    // T = left * right
-    u512 mult = multiply(left, right);
-
-    // m = ((T mod R) * curve_p')
-    u512 m = multiply(mult.low(), PRIME_INVERSE_MOD_R);
-
-    // mp = (m mod R) * curve_p
-    u512 mp = multiply(m.low(), PRIME);
-
-    // t = (T + mp)
-    bool carry = false;
-    mult.low().addc(mp.low(), carry);
-
-    // output = t / R
-    return modular_add(mult.high(), mp.high(), carry);
+    // The result is below 2^256 + prime, so subtracting the prime once brings it below 2^256.
+    u256 result { u128 { t[0], t[1] }, u128 { t[2], t[3] } };
+    bool borrow = false;
+    u256 reduced = result.subc(PRIME, borrow);
+    return select(result, reduced, t[4] >= static_cast<u64>(borrow));
 }
 
 static u256 modular_square(u256 const& value)
@@ -207,9 +232,7 @@ static void point_double(JacobianPoint& output_point, JacobianPoint const& point
 
     // if (Y == 0)
     //   return POINT_AT_INFINITY
-    if (point.y.is_zero_constant_time()) {
-        VERIFY_NOT_REACHED();
-    }
+    // No point on the curve has Y = 0, but the point at infinity (0, 0, 0) does, and the formulas below double it into itself.
 
     u256 temp;
 
@@ -324,15 +347,13 @@ static void point_add(JacobianPoint& output_point, JacobianPoint const& point_a,
 
 static void convert_jacobian_to_affine(JacobianPoint& point)
 {
+    u256 z_inverse = modular_inverse(point.z);
     u256 temp;
     // X' = X/Z^2
-    temp = modular_square(point.z);
-    temp = modular_inverse(temp);
+    temp = modular_square(z_inverse);
     point.x = modular_multiply(point.x, temp);
     // Y' = Y/Z^3
-    temp = modular_square(point.z);
-    temp = modular_multiply(temp, point.z);
-    temp = modular_inverse(temp);
+    temp = modular_multiply(temp, z_inverse);
     point.y = modular_multiply(point.y, temp);
 }
 
@@ -355,28 +376,32 @@ static bool is_point_on_curve(JacobianPoint const& point)
     return temp.is_zero_constant_time();
 }
 
-ErrorOr<ByteBuffer> SECP256r1::generate_private_key()
+// The scalar multiplications add one multiple of the point from a table for every 4 bits of the scalar.
+static constexpr size_t WINDOW_BITS = 4;
+static constexpr size_t WINDOW_ENTRIES = 1 << WINDOW_BITS;
+static constexpr size_t WINDOW_COUNT = 256 / WINDOW_BITS;
+
+static void point_select(JacobianPoint& output_point, JacobianPoint const& point, bool condition)
 {
-    auto buffer = TRY(ByteBuffer::create_uninitialized(32));
-    fill_with_random(buffer.data(), buffer.size());
-    return buffer;
+    output_point.x = select(output_point.x, point.x, condition);
+    output_point.y = select(output_point.y, point.y, condition);
+    output_point.z = select(output_point.z, point.z, condition);
 }
 
-ErrorOr<ByteBuffer> SECP256r1::generate_public_key(ReadonlyBytes a)
+static void point_add_from_table(JacobianPoint& point, JacobianPoint const* table, u8 index)
 {
-    // clang-format off
-    u8 generator_bytes[65] {
-        0x04,
-        0x6B, 0x17, 0xD1, 0xF2, 0xE1, 0x2C, 0x42, 0x47, 0xF8, 0xBC, 0xE6, 0xE5, 0x63, 0xA4, 0x40, 0xF2,
-        0x77, 0x03, 0x7D, 0x81, 0x2D, 0xEB, 0x33, 0xA0, 0xF4, 0xA1, 0x39, 0x45, 0xD8, 0x98, 0xC2, 0x96,
-        0x4F, 0xE3, 0x42, 0xE2, 0xFE, 0x1A, 0x7F, 0x9B, 0x8E, 0xE7, 0xEB, 0x4A, 0x7C, 0x0F, 0x9E, 0x16,
-        0x2B, 0xCE, 0x33, 0x57, 0x6B, 0x31, 0x5E, 0xCE, 0xCB, 0xB6, 0x40, 0x68, 0x37, 0xBF, 0x51, 0xF5,
-    };
-    // clang-format on
-    return compute_coordinate(a, { generator_bytes, 65 });
+    // Read every entry, so that the index doesn't show in which memory was touched.
+    JacobianPoint multiple;
+    for (size_t i = 0; i < WINDOW_ENTRIES; ++i)
+        point_select(multiple, table[i], i == index);
+
+    // The first entry is the point at infinity, which point_add() can't add, so the sum is thrown away instead.
+    JacobianPoint sum;
+    point_add(sum, point, multiple);
+    point_select(point, sum, index != 0);
 }
 
-ErrorOr<ByteBuffer> SECP256r1::compute_coordinate(ReadonlyBytes scalar_bytes, ReadonlyBytes point_bytes)
+static ErrorOr<u256> import_scalar(ReadonlyBytes scalar_bytes)
 {
     VERIFY(scalar_bytes.size() == 32);
 
@@ -385,7 +410,19 @@ ErrorOr<ByteBuffer> SECP256r1::compute_coordinate(ReadonlyBytes scalar_bytes, Re
     scalar = modular_reduce_order(scalar);
     if (scalar.is_zero_constant_time())
         return Error::from_string_literal("SECP256r1: scalar is zero");
+    return scalar;
+}
+
+static void scalar_to_windows(u256 scalar, u8 (&windows)[WINDOW_COUNT])
+{
+    for (auto& window : windows) {
+        window = static_cast<u8>(scalar.low().low() & (WINDOW_ENTRIES - 1));
+        scalar >>= WINDOW_BITS;
+    }
+}
 
+static ErrorOr<JacobianPoint> import_point(ReadonlyBytes point_bytes)
+{
     // Make sure the point is uncompressed
     if (point_bytes.size() != 65 || point_bytes[0] != 0x04)
         return Error::from_string_literal("SECP256r1: point is not uncompressed format");
@@ -404,44 +441,110 @@ ErrorOr<ByteBuffer> SECP256r1::compute_coordinate(ReadonlyBytes scalar_bytes, Re
     // Check that the point is on the curve
     if (!is_point_on_curve(point))
         return Error::from_string_literal("SECP256r1: point is not on the curve");
+    return point;
+}
 
-    JacobianPoint result;
-    JacobianPoint temp_result;
-
-    // Calculate the scalar times point multiplication in constant time
-    for (auto i = 0; i < 256; i++) {
-        point_add(temp_result, result, point);
-
-        auto condition = (scalar & 1u) == 1u;
-        result.x = select(result.x, temp_result.x, condition);
-        result.y = select(result.y, temp_result.y, condition);
-        result.z = select(result.z, temp_result.z, condition);
-
-        point_double(point, point);
-        scalar >>= 1u;
-    }
-
+static ErrorOr<ByteBuffer> export_point(JacobianPoint& point)
+{
     // Convert from Jacobian coordinates back to Affine coordinates
-    convert_jacobian_to_affine(result);
+    convert_jacobian_to_affine(point);
 
     // Make sure the resulting point is on the curve
-    VERIFY(is_point_on_curve(result));
+    VERIFY(is_point_on_curve(point));
 
     // Convert the result back from Montgomery form
-    result.x = from_montgomery(result.x);
-    result.y = from_montgomery(result.y);
+    point.x = from_montgomery(point.x);
+    point.y = from_montgomery(point.y);
     // Final modular reduction on the coordinates
-    result.x = modular_reduce(result.x);
-    result.y = modular_reduce(result.y);
+    point.x = modular_reduce(point.x);
+    point.y = modular_reduce(point.y);
 
     // Export the values into an output buffer
     auto buf = TRY(ByteBuffer::create_uninitialized(65));
     buf[0] = 0x04;
-    export_big_endian(result.x, buf.bytes().slice(1, 32));
-    export_big_endian(result.y, buf.bytes().slice(33, 32));
+    export_big_endian(point.x, buf.bytes().slice(1, 32));
+    export_big_endian(point.y, buf.bytes().slice(33, 32));
     return buf;
 }
 
+// clang-format off
+static constexpr u8 GENERATOR_BYTES[65] {
+    0x04,
+    0x6B, 0x17, 0xD1, 0xF2, 0xE1, 0x2C, 0x42, 0x47, 0xF8, 0xBC, 0xE6, 0xE5, 0x63, 0xA4, 0x40, 0xF2,
+    0x77, 0x03, 0x7D, 0x81, 0x2D, 0xEB, 0x33, 0xA0, 0xF4, 0xA1, 0x39, 0x45, 0xD8, 0x98, 0xC2, 0x96,
+    0x4F, 0xE3, 0x42, 0xE2, 0xFE, 0x1A, 0x7F, 0x9B, 0x8E, 0xE7, 0xEB, 0x4A, 0x7C, 0x0F, 0x9E, 0x16,
+    0x2B, 0xCE, 0x33, 0x57, 0x6B, 0x31, 0x5E, 0xCE, 0xCB, 0xB6, 0x40, 0x68, 0x37, 0xBF, 0x51, 0xF5,
+};
+// clang-format on
+
+struct GeneratorTable {
+    // Entry [i][j] is j * 16^i * G, so a multiple of the generator is one addition per window, without any doublings.
+    JacobianPoint multiples[WINDOW_COUNT][WINDOW_ENTRIES];
+};
+
+static GeneratorTable const& generator_table()
+{
+    static auto const* table = [] {
+        auto* table = new GeneratorTable;
+        auto point = MUST(import_point({ GENERATOR_BYTES, sizeof(GENERATOR_BYTES) }));
+        for (size_t i = 0; i < WINDOW_COUNT; ++i) {
+            auto* multiples = table->multiples[i];
+            multiples[1] = point;
+            for (size_t j = 2; j < WINDOW_ENTRIES; ++j)
+                point_add(multiples[j], multiples[j - 1], point);
+            // 16 * 16^i * G = 2 * 8 * 16^i * G
+            point_double(point, multiples[WINDOW_ENTRIES / 2]);
+        }
+        return table;
+    }();
+    return *table;
+}
+
+ErrorOr<ByteBuffer> SECP256r1::generate_private_key()
+{
+    auto buffer = TRY(ByteBuffer::create_uninitialized(32));
+    fill_with_random(buffer.data(), buffer.size());
+    return buffer;
+}
+
+ErrorOr<ByteBuffer> SECP256r1::generate_public_key(ReadonlyBytes a)
+{
+    u256 scalar = TRY(import_scalar(a));
+    u8 windows[WINDOW_COUNT];
+    scalar_to_windows(scalar, windows);
+
+    auto const& table = generator_table();
+    JacobianPoint result;
+    for (size_t i = 0; i < WINDOW_COUNT; ++i)
+        point_add_from_table(result, table.multiples[i], windows[i]);
+
+    return export_point(result);
+}
+
+ErrorOr<ByteBuffer> SECP256r1::compute_coordinate(ReadonlyBytes scalar_bytes, ReadonlyBytes point_bytes)
+{
+    u256 scalar = TRY(import_scalar(scalar_bytes));
+    auto point = TRY(import_point(point_bytes));
+
+    u8 windows[WINDOW_COUNT];
+    scalar_to_windows(scalar, windows);
+
+    JacobianPoint multiples[WINDOW_ENTRIES];
+    multiples[1] = point;
+    for (size_t j = 2; j < WINDOW_ENTRIES; ++j)
+        point_add(multiples[j], multiples[j - 1], point);
+
+    // Calculate the scalar times point multiplication in constant time, starting from the most significant window
+    JacobianPoint result;
+    for (size_t i = WINDOW_COUNT; i-- > 0;) {
+        for (size_t j = 0; j < WINDOW_BITS; ++j)
+            point_double(result, result);
+        point_add_from_table(result, multiples, windows[i]);
+    }
+
+    return export_point(result);
+}
+
 ErrorOr<ByteBuffer> SECP256r1::derive_premaster_key(ReadonlyBytes shared_point)
 {
     VERIFY(shared_point.size() == 65);
@@ -8,25 +8,326 @@
 #include <AK/Endian.h>
 #include <AK/Random.h>
 #include <LibCrypto/Curves/Curve25519.h>
+#include <LibCrypto/Curves/Ed25519.h>
 #include <LibCrypto/Curves/X25519.h>
 
 namespace Crypto::Curves {
 
 static constexpr u8 BITS = 255;
 static constexpr u8 BYTES = 32;
-static constexpr u8 WORDS = 8;
 static constexpr u32 A24 = 121666;
 
-static void conditional_swap(u32* first, u32* second, u32 condition)
+// Elements of GF(2^255 - 19) in radix 2^51: five 64-bit limbs, each holding 51 bits after a reduction.
+// Sums of a few reduced elements still fit into the limbs, so additions and subtractions don't carry, and the products of
+// the limbs are accumulated into 128-bit integers before being carried once.
+using DoubleLimb = unsigned __int128;
+
+struct FieldElement {
+    u64 limbs[5] {};
+};
+
+static constexpr u64 LIMB_MASK = (1ull << 51) - 1;
+
+static FieldElement field_from_bytes(u8 const* data)
+{
+    u64 words[4];
+    for (size_t i = 0; i < 4; ++i)
+        words[i] = AK::convert_between_host_and_little_endian(ByteReader::load64(data + i * sizeof(u64)));
+
+    // The most significant bit is ignored.
+    return { {
+        words[0] & LIMB_MASK,
+        ((words[0] >> 51) | (words[1] << 13)) & LIMB_MASK,
+        ((words[1] >> 38) | (words[2] << 26)) & LIMB_MASK,
+        ((words[2] >> 25) | (words[3] << 39)) & LIMB_MASK,
+        (words[3] >> 12) & LIMB_MASK,
+    } };
+}
+
+static FieldElement field_from_words(u32 const* words)
+{
+    u8 data[BYTES];
+    for (size_t i = 0; i < 8; ++i)
+        ByteReader::store(data + i * sizeof(u32), AK::convert_between_host_and_little_endian(words[i]));
+    return field_from_bytes(data);
+}
+
+static void field_carry(FieldElement& element)
+{
+    auto& l = element.limbs;
+    for (size_t i = 0; i < 4; ++i) {
+        l[i + 1] += l[i] >> 51;
+        l[i] &= LIMB_MASK;
+    }
+    l[0] += (l[4] >> 51) * 19;
+    l[4] &= LIMB_MASK;
+}
+
+static void field_to_bytes(FieldElement element, u8* data)
+{
+    auto& l = element.limbs;
+    field_carry(element);
+    field_carry(element);
+
+    // Now the value is below 2^255 + 19*2, and it's at least p if adding 19 carries into bit 255.
+    u64 carry = (l[0] + 19) >> 51;
+    for (size_t i = 1; i < 5; ++i)
+        carry = (l[i] + carry) >> 51;
+    l[0] += 19 * carry;
+    for (size_t i = 0; i < 4; ++i) {
+        l[i + 1] += l[i] >> 51;
+        l[i] &= LIMB_MASK;
+    }
+    l[4] &= LIMB_MASK;
+
+    u64 words[4] {
+        l[0] | (l[1] << 51),
+        (l[1] >> 13) | (l[2] << 38),
+        (l[2] >> 26) | (l[3] << 25),
+        (l[3] >> 39) | (l[4] << 12),
+    };
+    for (size_t i = 0; i < 4; ++i)
+        ByteReader::store(data + i * sizeof(u64), AK::convert_between_host_and_little_endian(words[i]));
+}
+
+static FieldElement field_add(FieldElement const& a, FieldElement const& b)
+{
+    FieldElement result;
+    for (size_t i = 0; i < 5; ++i)
+        result.limbs[i] = a.limbs[i] + b.limbs[i];
+    return result;
+}
+
+static FieldElement field_subtract(FieldElement const& a, FieldElement const& b)
+{
+    // Add 4*p first, so that no limb goes below zero as long as `b` is the sum of at most two reduced elements.
+    FieldElement result;
+    result.limbs[0] = a.limbs[0] + 0x1fffffffffffb4 - b.limbs[0];
+    for (size_t i = 1; i < 5; ++i)
+        result.limbs[i] = a.limbs[i] + 0x1ffffffffffffc - b.limbs[i];
+    return result;
+}
+
+static FieldElement field_negate(FieldElement const& a)
+{
+    return field_subtract({}, a);
+}
+
+static FieldElement field_reduce(DoubleLimb (&r)[5])
+{
+    FieldElement result;
+    for (size_t i = 0; i < 4; ++i) {
+        r[i + 1] += static_cast<u64>(r[i] >> 51);
+        result.limbs[i] = static_cast<u64>(r[i]) & LIMB_MASK;
+    }
+    result.limbs[4] = static_cast<u64>(r[4]) & LIMB_MASK;
+    result.limbs[0] += static_cast<u64>(r[4] >> 51) * 19;
+    result.limbs[1] += result.limbs[0] >> 51;
+    result.limbs[0] &= LIMB_MASK;
+    return result;
+}
+
+static FieldElement field_multiply(FieldElement const& a, FieldElement const& b)
+{
+    auto const* x = a.limbs;
+    auto const* y = b.limbs;
+    // 2^255 = 19 (mod p), so the parts of the product at the fifth limb and above wrap around multiplied by 19.
+    u64 y1_19 = y[1] * 19;
+    u64 y2_19 = y[2] * 19;
+    u64 y3_19 = y[3] * 19;
+    u64 y4_19 = y[4] * 19;
+
+    DoubleLimb r[5] {
+        (DoubleLimb)x[0] * y[0] + (DoubleLimb)x[1] * y4_19 + (DoubleLimb)x[2] * y3_19 + (DoubleLimb)x[3] * y2_19 + (DoubleLimb)x[4] * y1_19,
+        (DoubleLimb)x[0] * y[1] + (DoubleLimb)x[1] * y[0] + (DoubleLimb)x[2] * y4_19 + (DoubleLimb)x[3] * y3_19 + (DoubleLimb)x[4] * y2_19,
+        (DoubleLimb)x[0] * y[2] + (DoubleLimb)x[1] * y[1] + (DoubleLimb)x[2] * y[0] + (DoubleLimb)x[3] * y4_19 + (DoubleLimb)x[4] * y3_19,
+        (DoubleLimb)x[0] * y[3] + (DoubleLimb)x[1] * y[2] + (DoubleLimb)x[2] * y[1] + (DoubleLimb)x[3] * y[0] + (DoubleLimb)x[4] * y4_19,
+        (DoubleLimb)x[0] * y[4] + (DoubleLimb)x[1] * y[3] + (DoubleLimb)x[2] * y[2] + (DoubleLimb)x[3] * y[1] + (DoubleLimb)x[4] * y[0],
+    };
+    return field_reduce(r);
+}
+
+static FieldElement field_square(FieldElement const& a)
+{
+    auto const* x = a.limbs;
+    u64 x0_2 = x[0] * 2;
+    u64 x1_2 = x[1] * 2;
+    u64 x1_38 = x[1] * 38;
+    u64 x2_38 = x[2] * 38;
+    u64 x3_19 = x[3] * 19;
+    u64 x3_38 = x[3] * 38;
+    u64 x4_19 = x[4] * 19;
+
+    DoubleLimb r[5] {
+        (DoubleLimb)x[0] * x[0] + (DoubleLimb)x1_38 * x[4] + (DoubleLimb)x2_38 * x[3],
+        (DoubleLimb)x0_2 * x[1] + (DoubleLimb)x2_38 * x[4] + (DoubleLimb)x3_19 * x[3],
+        (DoubleLimb)x0_2 * x[2] + (DoubleLimb)x[1] * x[1] + (DoubleLimb)x3_38 * x[4],
+        (DoubleLimb)x0_2 * x[3] + (DoubleLimb)x1_2 * x[2] + (DoubleLimb)x4_19 * x[4],
+        (DoubleLimb)x0_2 * x[4] + (DoubleLimb)x1_2 * x[3] + (DoubleLimb)x[2] * x[2],
+    };
+    return field_reduce(r);
+}
+
+static FieldElement field_square_times(FieldElement element, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        element = field_square(element);
+    return element;
+}
+
+static FieldElement field_multiply_small(FieldElement const& a, u32 factor)
+{
+    DoubleLimb r[5];
+    for (size_t i = 0; i < 5; ++i)
+        r[i] = (DoubleLimb)a.limbs[i] * factor;
+    return field_reduce(r);
+}
+
+static FieldElement field_invert(FieldElement const& z)
+{
+    // z^(p-2) = z^(2^255 - 21), using the usual addition chain.
+    auto z2 = field_square(z);
+    auto z9 = field_multiply(field_square_times(z2, 2), z);
+    auto z11 = field_multiply(z9, z2);
+    auto z_5_0 = field_multiply(field_square(z11), z9);
+    auto z_10_0 = field_multiply(field_square_times(z_5_0, 5), z_5_0);
+    auto z_20_0 = field_multiply(field_square_times(z_10_0, 10), z_10_0);
+    auto z_40_0 = field_multiply(field_square_times(z_20_0, 20), z_20_0);
+    auto z_50_0 = field_multiply(field_square_times(z_40_0, 10), z_10_0);
+    auto z_100_0 = field_multiply(field_square_times(z_50_0, 50), z_50_0);
+    auto z_200_0 = field_multiply(field_square_times(z_100_0, 100), z_100_0);
+    auto z_250_0 = field_multiply(field_square_times(z_200_0, 50), z_50_0);
+    return field_multiply(field_square_times(z_250_0, 5), z11);
+}
+
+static void field_conditional_swap(FieldElement& first, FieldElement& second, u64 condition)
 {
-    u32 mask = ~condition + 1;
-    for (auto i = 0; i < WORDS; i++) {
-        u32 temp = mask & (first[i] ^ second[i]);
-        first[i] ^= temp;
-        second[i] ^= temp;
+    u64 mask = ~condition + 1;
+    for (size_t i = 0; i < 5; ++i) {
+        u64 temp = mask & (first.limbs[i] ^ second.limbs[i]);
+        first.limbs[i] ^= temp;
+        second.limbs[i] ^= temp;
     }
 }
 
+static void field_conditional_move(FieldElement& destination, FieldElement const& source, u64 condition)
+{
+    u64 mask = ~condition + 1;
+    for (size_t i = 0; i < 5; ++i)
+        destination.limbs[i] ^= mask & (destination.limbs[i] ^ source.limbs[i]);
+}
+
+// The base point 9 is the image of the Ed25519 base point under the birational map u = (1 + y) / (1 - y), so fixed-base
+// multiplications can use the complete addition on the Edwards curve with a table of multiples of its base point instead
+// of the ladder.
+struct EdwardsPoint {
+    FieldElement x;
+    FieldElement y;
+    FieldElement z;
+    FieldElement t;
+};
+
+// A point as (Y + X, Y - X, 2*d*T, 2*Z), which is what adding it to another point needs.
+struct CachedEdwardsPoint {
+    FieldElement y_plus_x;
+    FieldElement y_minus_x;
+    FieldElement t_2d;
+    FieldElement z_2;
+};
+
+static constexpr size_t BASE_TABLE_WINDOWS = 64;
+static constexpr size_t BASE_TABLE_ENTRIES = 8;
+
+static CachedEdwardsPoint to_cached(EdwardsPoint const& point, FieldElement const& d_2)
+{
+    return {
+        field_add(point.y, point.x),
+        field_subtract(point.y, point.x),
+        field_multiply(point.t, d_2),
+        field_add(point.z, point.z),
+    };
+}
+
+// "add-2008-hwcd-3" from https://hyperelliptic.org/EFD/g1p/auto-twisted-extended-1.html, which also works for doubling.
+static EdwardsPoint edwards_add(EdwardsPoint const& p, CachedEdwardsPoint const& q)
+{
+    auto a = field_multiply(field_subtract(p.y, p.x), q.y_minus_x);
+    auto b = field_multiply(field_add(p.y, p.x), q.y_plus_x);
+    auto c = field_multiply(p.t, q.t_2d);
+    auto d = field_multiply(p.z, q.z_2);
+    auto e = field_subtract(b, a);
+    auto f = field_subtract(d, c);
+    auto g = field_add(d, c);
+    auto h = field_add(b, a);
+    return { field_multiply(e, f), field_multiply(g, h), field_multiply(f, g), field_multiply(e, h) };
+}
+
+struct BaseTable {
+    // Entry [i][j] is (j + 1) * 16^i * B.
+    CachedEdwardsPoint entries[BASE_TABLE_WINDOWS][BASE_TABLE_ENTRIES];
+};
+
+static BaseTable const& base_table()
+{
+    static auto const* table = [] {
+        auto* table = new BaseTable;
+        auto d_2 = field_from_words(Curve25519::CURVE_D_2);
+        EdwardsPoint point {
+            field_from_words(Ed25519::BASE_POINT.x),
+            field_from_words(Ed25519::BASE_POINT.y),
+            field_from_words(Ed25519::BASE_POINT.z),
+            field_from_words(Ed25519::BASE_POINT.t),
+        };
+        for (size_t i = 0; i < BASE_TABLE_WINDOWS; ++i) {
+            auto multiple = point;
+            table->entries[i][0] = to_cached(point, d_2);
+            for (size_t j = 1; j < BASE_TABLE_ENTRIES; ++j) {
+                multiple = edwards_add(multiple, table->entries[i][0]);
+                table->entries[i][j] = to_cached(multiple, d_2);
+            }
+            // 16 * 16^i * B = 2 * 8 * 16^i * B
+            point = edwards_add(multiple, to_cached(multiple, d_2));
+        }
+        return table;
+    }();
+    return *table;
+}
+
+static CachedEdwardsPoint select_base_multiple(size_t window, i8 digit)
+{
+    i64 sign_mask = static_cast<i64>(digit) >> 63;
+    u64 is_negative = sign_mask & 1;
+    u64 absolute = (digit ^ sign_mask) - sign_mask;
+
+    // Read every entry, so that the digit doesn't show in which memory was touched.
+    CachedEdwardsPoint result { { { 1 } }, { { 1 } }, {}, { { 2 } } };
+    for (size_t j = 0; j < BASE_TABLE_ENTRIES; ++j) {
+        u64 is_match = ((absolute ^ (j + 1)) - 1) >> 63;
+        auto const& entry = base_table().entries[window][j];
+        field_conditional_move(result.y_plus_x, entry.y_plus_x, is_match);
+        field_conditional_move(result.y_minus_x, entry.y_minus_x, is_match);
+        field_conditional_move(result.t_2d, entry.t_2d, is_match);
+        field_conditional_move(result.z_2, entry.z_2, is_match);
+    }
+
+    // -(x, y) = (-x, y)
+    field_conditional_swap(result.y_plus_x, result.y_minus_x, is_negative);
+    field_conditional_move(result.t_2d, field_negate(result.t_2d), is_negative);
+    return result;
+}
+
+static void clamp_scalar(u8* scalar, ReadonlyBytes input)
+{
+    VERIFY(input.size() == BYTES);
+    input.copy_to({ scalar, BYTES });
+
+    // Set the three least significant bits of the first byte and the most significant bit of the last to zero,
+    // set the second most significant bit of the last byte to 1
+    scalar[0] &= 0xF8;
+    scalar[31] &= 0x7F;
+    scalar[31] |= 0x40;
+}
+
 ErrorOr<ByteBuffer> X25519::generate_private_key()
 {
     auto buffer = TRY(ByteBuffer::create_uninitialized(BYTES));
@@ -36,85 +337,92 @@ ErrorOr<ByteBuffer> X25519::generate_private_key()
 
 ErrorOr<ByteBuffer> X25519::generate_public_key(ReadonlyBytes a)
 {
-    u8 generator[BYTES] { 9 };
-    return compute_coordinate(a, { generator, BYTES });
+    u8 k[BYTES];
+    clamp_scalar(k, a);
+
+    // Write the scalar with signed digits between -8 and 8, so that the table only needs half of the multiples.
+    i8 digits[BASE_TABLE_WINDOWS];
+    for (size_t i = 0; i < BYTES; ++i) {
+        digits[2 * i] = k[i] & 15;
+        digits[2 * i + 1] = k[i] >> 4;
+    }
+    i8 carry = 0;
+    for (size_t i = 0; i < BASE_TABLE_WINDOWS - 1; ++i) {
+        digits[i] += carry;
+        carry = (digits[i] + 8) >> 4;
+        digits[i] -= carry << 4;
+    }
+    digits[BASE_TABLE_WINDOWS - 1] += carry;
+
+    EdwardsPoint result { {}, { { 1 } }, { { 1 } }, {} };
+    for (size_t i = 0; i < BASE_TABLE_WINDOWS; ++i)
+        result = edwards_add(result, select_base_multiple(i, digits[i]));
+
+    // u = (1 + y) / (1 - y) = (Z + Y) / (Z - Y)
+    auto u = field_multiply(field_add(result.z, result.y), field_invert(field_subtract(result.z, result.y)));
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(BYTES));
+    field_to_bytes(u, buffer.data());
+    return buffer;
 }
 
 // https://datatracker.ietf.org/doc/html/rfc7748#section-5
 ErrorOr<ByteBuffer> X25519::compute_coordinate(ReadonlyBytes input_k, ReadonlyBytes input_u)
 {
-    u32 k[WORDS] {};
-    u32 u[WORDS] {};
-    u32 x1[WORDS] {};
-    u32 x2[WORDS] {};
-    u32 z1[WORDS] {};
-    u32 z2[WORDS] {};
-    u32 t1[WORDS] {};
-    u32 t2[WORDS] {};
-
-    // Copy input to internal state
-    Curve25519::import_state(k, input_k.data());
-
-    // Set the three least significant bits of the first byte and the most significant bit of the last to zero,
-    // set the second most significant bit of the last byte to 1
-    k[0] &= 0xFFFFFFF8;
-    k[7] &= 0x7FFFFFFF;
-    k[7] |= 0x40000000;
+    VERIFY(input_u.size() == BYTES);
 
-    // Copy coordinate to internal state
-    Curve25519::import_state(u, input_u.data());
-    // mask the most significant bit in the final byte.
-    u[7] &= 0x7FFFFFFF;
+    u8 k[BYTES];
+    clamp_scalar(k, input_k);
 
     // Implementations MUST accept non-canonical values and process them as
     // if they had been reduced modulo the field prime.
-    Curve25519::modular_reduce(u, u);
+    // Masking the most significant bit and keeping the rest as-is does both, as none of the field operations need reduced inputs.
+    auto u = field_from_bytes(input_u.data());
 
-    Curve25519::set(x1, 1);
-    Curve25519::set(z1, 0);
-    Curve25519::copy(x2, u);
-    Curve25519::set(z2, 1);
+    FieldElement x1 { { 1 } };
+    FieldElement z1 {};
+    FieldElement x2 = u;
+    FieldElement z2 { { 1 } };
 
     // Montgomery ladder
-    u32 swap = 0;
+    u64 swap = 0;
     for (auto i = BITS - 1; i >= 0; i--) {
-        u32 b = (k[i / BYTES] >> (i % BYTES)) & 1;
+        u64 b = (k[i / 8] >> (i % 8)) & 1;
 
-        conditional_swap(x1, x2, swap ^ b);
-        conditional_swap(z1, z2, swap ^ b);
+        field_conditional_swap(x1, x2, swap ^ b);
+        field_conditional_swap(z1, z2, swap ^ b);
 
         swap = b;
 
-        Curve25519::modular_add(t1, x2, z2);
-        Curve25519::modular_subtract(x2, x2, z2);
-        Curve25519::modular_add(z2, x1, z1);
-        Curve25519::modular_subtract(x1, x1, z1);
-        Curve25519::modular_multiply(t1, t1, x1);
-        Curve25519::modular_multiply(x2, x2, z2);
-        Curve25519::modular_square(z2, z2);
-        Curve25519::modular_square(x1, x1);
-        Curve25519::modular_subtract(t2, z2, x1);
-        Curve25519::modular_multiply_single(z1, t2, A24);
-        Curve25519::modular_add(z1, z1, x1);
-        Curve25519::modular_multiply(z1, z1, t2);
-        Curve25519::modular_multiply(x1, x1, z2);
-        Curve25519::modular_subtract(z2, t1, x2);
-        Curve25519::modular_square(z2, z2);
-        Curve25519::modular_multiply(z2, z2, u);
-        Curve25519::modular_add(x2, x2, t1);
-        Curve25519::modular_square(x2, x2);
+        auto t1 = field_add(x2, z2);
+        x2 = field_subtract(x2, z2);
+        z2 = field_add(x1, z1);
+        x1 = field_subtract(x1, z1);
+        t1 = field_multiply(t1, x1);
+        x2 = field_multiply(x2, z2);
+        z2 = field_square(z2);
+        x1 = field_square(x1);
+        auto t2 = field_subtract(z2, x1);
+        z1 = field_multiply_small(t2, A24);
+        z1 = field_add(z1, x1);
+        z1 = field_multiply(z1, t2);
+        x1 = field_multiply(x1, z2);
+        z2 = field_subtract(t1, x2);
+        z2 = field_square(z2);
+        z2 = field_multiply(z2, u);
+        x2 = field_add(x2, t1);
+        x2 = field_square(x2);
     }
 
-    conditional_swap(x1, x2, swap);
-    conditional_swap(z1, z2, swap);
+    field_conditional_swap(x1, x2, swap);
+    field_conditional_swap(z1, z2, swap);
 
     // Retrieve affine representation
-    Curve25519::modular_multiply_inverse(u, z1);
-    Curve25519::modular_multiply(u, u, x1);
+    u = field_multiply(x1, field_invert(z1));
 
     // Encode state for export
     auto buffer = TRY(ByteBuffer::create_uninitialized(BYTES));
-    Curve25519::export_state(u, buffer.data());
+    field_to_bytes(u, buffer.data());
 
     return buffer;
 }
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
+#include <AK/Types.h>
+#include <LibCrypto/Authentication/HMAC.h>
+
+namespace Crypto::Hash {
+
+// RFC 5869: HMAC-based Extract-and-Expand Key Derivation Function (HKDF)
+// The arguments after the keying material are passed on to the hash function, e.g. the HashKind of a Hash::Manager.
+template<typename HashT>
+class HKDF {
+public:
+    using HashType = HashT;
+
+    // Section 2.2: PRK = HMAC-Hash(salt, IKM). A missing salt is the same as HashLen zeros.
+    template<typename... Args>
+    static ErrorOr<ByteBuffer> extract(ReadonlyBytes salt, ReadonlyBytes input_keying_material, Args... hash_args)
+    {
+        Authentication::HMAC<HashType> hmac(salt, hash_args...);
+        auto pseudorandom_key = hmac.process(input_keying_material);
+        return ByteBuffer::copy(pseudorandom_key.immutable_data(), hmac.digest_size());
+    }
+
+    // Section 2.3: T(i) = HMAC-Hash(PRK, T(i - 1) | info | i), and the output is the first `length` bytes of T(1) | T(2) | ...
+    template<typename... Args>
+    static ErrorOr<ByteBuffer> expand(ReadonlyBytes pseudorandom_key, ReadonlyBytes info, size_t length, Args... hash_args)
+    {
+        Authentication::HMAC<HashType> hmac(pseudorandom_key, hash_args...);
+        auto hash_length = hmac.digest_size();
+        if (length > 255 * hash_length)
+            return Error::from_string_literal("HKDF output is too long");
+
+        auto output = TRY(ByteBuffer::create_uninitialized(length));
+        ReadonlyBytes previous_block;
+        for (size_t offset = 0, counter = 1; offset < length; offset += hash_length, ++counter) {
+            hmac.update(previous_block);
+            hmac.update(info);
+            u8 counter_byte = counter;
+            hmac.update(&counter_byte, 1);
+            auto block = hmac.digest();
+
+            auto block_size = min(hash_length, length - offset);
+            output.overwrite(offset, block.immutable_data(), block_size);
+            previous_block = output.bytes().slice(offset, block_size);
+        }
+        return output;
+    }
+};
+
+}
@@ -6,9 +6,14 @@
 
 #include <AK/Endian.h>
 #include <AK/Memory.h>
+#include <AK/Platform.h>
 #include <AK/Types.h>
 #include <LibCrypto/Hash/SHA1.h>
 
+#if ARCH(X86_64)
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Hash {
 
 static constexpr auto ROTATE_LEFT(u32 value, size_t bits)
@@ -66,16 +71,110 @@ inline void SHA1::transform(u8 const* data)
     secure_zero(blocks, 16 * sizeof(u32));
 }
 
-void SHA1::update(u8 const* message, size_t length)
+#if ARCH(X86_64)
+// This follows the sample code in Intel's "Intel SHA Extensions" white paper. Each SHA1RNDS4 does four rounds, and
+// SHA1MSG1/SHA1MSG2 (with the XOR in between) compute the next four words of the message schedule, three steps ahead.
+[[gnu::target("sha,sse4.1,ssse3")]] static void transform_blocks_sha_ni(u32* state, u8 const* data, size_t count)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 512;
-            m_data_length = 0;
+    auto const byte_swap_mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    auto abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state)), 0x1b);
+    auto e = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+
+    for (; count > 0; --count, data += 64) {
+        auto abcd_save = abcd;
+        auto e_save = e;
+        __m128i previous_abcd;
+        __m128i words[4];
+
+        for (size_t group = 0; group < 20; ++group) {
+            auto& message = words[group % 4];
+            if (group < 4)
+                message = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + group * 16)), byte_swap_mask);
+
+            if (group == 0)
+                e = _mm_add_epi32(e, message);
+            else
+                e = _mm_sha1nexte_epu32(previous_abcd, message);
+            previous_abcd = abcd;
+
+            switch (group / 5) {
+            case 0:
+                abcd = _mm_sha1rnds4_epu32(abcd, e, 0);
+                break;
+            case 1:
+                abcd = _mm_sha1rnds4_epu32(abcd, e, 1);
+                break;
+            case 2:
+                abcd = _mm_sha1rnds4_epu32(abcd, e, 2);
+                break;
+            default:
+                abcd = _mm_sha1rnds4_epu32(abcd, e, 3);
+                break;
+            }
+
+            if (group >= 3 && group <= 18)
+                words[(group + 1) % 4] = _mm_sha1msg2_epu32(words[(group + 1) % 4], message);
+            if (group >= 2 && group <= 17)
+                words[(group + 2) % 4] = _mm_xor_si128(words[(group + 2) % 4], message);
+            if (group >= 1 && group <= 16)
+                words[(group + 3) % 4] = _mm_sha1msg1_epu32(words[(group + 3) % 4], message);
         }
-        m_data_buffer[m_data_length++] = message[i];
+
+        e = _mm_sha1nexte_epu32(previous_abcd, e_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = static_cast<u32>(_mm_extract_epi32(e, 3));
+}
+
+static bool cpu_supports_sha_ni()
+{
+    static bool const supports_sha_ni = __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1");
+    return supports_sha_ni;
+}
+#endif
+
+void SHA1::transform_blocks(u8 const* data, size_t count)
+{
+#if ARCH(X86_64)
+    if (cpu_supports_sha_ni()) {
+        transform_blocks_sha_ni(m_state, data, count);
+        return;
     }
+#endif
+
+    for (size_t i = 0; i < count; ++i)
+        transform(data + i * BlockSize);
+}
+
+void SHA1::update(u8 const* message, size_t length)
+{
+    if (m_data_length > 0) {
+        auto copied = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, copied);
+        m_data_length += copied;
+        message += copied;
+        length -= copied;
+        if (m_data_length < BlockSize)
+            return;
+        transform_blocks(m_data_buffer, 1);
+        m_bit_length += BlockSize * 8;
+        m_data_length = 0;
+    }
+
+    // Whole blocks are hashed right from the message, only what's left over is kept for later.
+    auto block_count = length / BlockSize;
+    if (block_count > 0) {
+        transform_blocks(message, block_count);
+        m_bit_length += block_count * BlockSize * 8;
+        message += block_count * BlockSize;
+        length -= block_count * BlockSize;
+    }
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA1::DigestType SHA1::digest()
@@ -93,11 +192,13 @@ SHA1::DigestType SHA1::peek()
     // make a local copy of the data as we modify it
     u8 data[BlockSize];
     u32 state[5];
+    auto data_length = m_data_length;
+    auto bit_length = m_bit_length;
     __builtin_memcpy(data, m_data_buffer, m_data_length);
     __builtin_memcpy(state, m_state, 20);
 
     if (BlockSize == m_data_length) {
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
         m_bit_length += BlockSize * 8;
         m_data_length = 0;
         i = 0;
@@ -113,7 +214,7 @@ SHA1::DigestType SHA1::peek()
         m_data_buffer[i++] = 0x80;
         while (i < BlockSize)
             m_data_buffer[i++] = 0x00;
-        transform(m_data_buffer);
+        transform_blocks(m_data_buffer, 1);
 
         // Then start another block with BlockSize - 8 bytes of zeros
         __builtin_memset(m_data_buffer, 0, FinalBlockDataSize);
@@ -130,7 +231,7 @@ SHA1::DigestType SHA1::peek()
     m_data_buffer[BlockSize - 7] = m_bit_length >> 48;
     m_data_buffer[BlockSize - 8] = m_bit_length >> 56;
 
-    transform(m_data_buffer);
+    transform_blocks(m_data_buffer, 1);
 
     for (size_t i = 0; i < 4; ++i) {
         digest.data[i + 0] = (m_state[0] >> (24 - i * 8)) & 0x000000ff;
@@ -140,8 +241,10 @@ SHA1::DigestType SHA1::peek()
         digest.data[i + 16] = (m_state[4] >> (24 - i * 8)) & 0x000000ff;
     }
     // restore the data
-    __builtin_memcpy(m_data_buffer, data, m_data_length);
+    __builtin_memcpy(m_data_buffer, data, data_length);
     __builtin_memcpy(m_state, state, 20);
+    m_data_length = data_length;
+    m_bit_length = bit_length;
     return digest;
 }
 
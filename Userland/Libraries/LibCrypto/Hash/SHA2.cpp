@@ -4,9 +4,17 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Endian.h>
+#include <AK/Platform.h>
 #include <AK/Types.h>
 #include <LibCrypto/Hash/SHA2.h>
 
+// The kernel doesn't save the SSE registers for its own code, so it always uses the plain implementation.
+#if ARCH(X86_64) && !defined(KERNEL)
+#    define SHA2_USE_SIMD
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Hash {
 constexpr static auto ROTRIGHT(u32 a, size_t b) { return (a >> b) | (a << (32 - b)); }
 constexpr static auto CH(u32 x, u32 y, u32 z) { return (x & y) ^ (z & ~x); }
@@ -24,7 +32,7 @@ constexpr static auto EP1(u64 x) { return ROTRIGHT(x, 14) ^ ROTRIGHT(x, 18) ^ RO
 constexpr static auto SIGN0(u64 x) { return ROTRIGHT(x, 1) ^ ROTRIGHT(x, 8) ^ (x >> 7); }
 constexpr static auto SIGN1(u64 x) { return ROTRIGHT(x, 19) ^ ROTRIGHT(x, 61) ^ (x >> 6); }
 
-inline void SHA256::transform(u8 const* data)
+static void transform_block(u32* state, u8 const* data)
 {
     u32 m[64];
 
@@ -33,16 +41,16 @@ inline void SHA256::transform(u8 const* data)
         m[i] = (data[j] << 24) | (data[j + 1] << 16) | (data[j + 2] << 8) | data[j + 3];
     }
 
-    for (; i < BlockSize; ++i) {
+    for (; i < 64; ++i) {
         m[i] = SIGN1(m[i - 2]) + m[i - 7] + SIGN0(m[i - 15]) + m[i - 16];
     }
 
-    auto a = m_state[0], b = m_state[1],
-         c = m_state[2], d = m_state[3],
-         e = m_state[4], f = m_state[5],
-         g = m_state[6], h = m_state[7];
+    auto a = state[0], b = state[1],
+         c = state[2], d = state[3],
+         e = state[4], f = state[5],
+         g = state[6], h = state[7];
 
-    for (size_t i = 0; i < Rounds; ++i) {
+    for (size_t i = 0; i < 64; ++i) {
         auto temp0 = h + EP1(e) + CH(e, f, g) + SHA256Constants::RoundConstants[i] + m[i];
         auto temp1 = EP0(a) + MAJ(a, b, c);
         h = g;
@@ -55,26 +63,184 @@ inline void SHA256::transform(u8 const* data)
         a = temp0 + temp1;
     }
 
-    m_state[0] += a;
-    m_state[1] += b;
-    m_state[2] += c;
-    m_state[3] += d;
-    m_state[4] += e;
-    m_state[5] += f;
-    m_state[6] += g;
-    m_state[7] += h;
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
 }
 
-void SHA256::update(u8 const* message, size_t length)
+#ifdef SHA2_USE_SIMD
+// This follows the sample code in Intel's "Intel SHA Extensions" white paper. The state is kept as ABEF and CDGH, which is
+// what SHA256RNDS2 wants, and each SHA256RNDS2 does two rounds. SHA256MSG1/SHA256MSG2 compute four words of the message schedule.
+[[gnu::target("sha,sse4.1,ssse3")]] static void transform_blocks_sha_ni(u32* state, u8 const* data, size_t count)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 512;
-            m_data_length = 0;
+    auto const byte_swap_mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    auto dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(&state[0])), 0xb1);
+    auto efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(&state[4])), 0x1b);
+    auto abef = _mm_alignr_epi8(dcba, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, dcba, 0xf0);
+
+    for (; count > 0; --count, data += 64) {
+        auto abef_save = abef;
+        auto cdgh_save = cdgh;
+        __m128i words[4];
+
+        for (size_t group = 0; group < 16; ++group) {
+            auto& message = words[group % 4];
+            if (group < 4) {
+                message = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + group * 16)), byte_swap_mask);
+            } else {
+                auto const& previous = words[(group + 3) % 4];
+                auto seven_back = _mm_alignr_epi8(previous, words[(group + 2) % 4], 4);
+                message = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(message, words[(group + 1) % 4]), seven_back), previous);
+            }
+
+            auto message_and_constants = _mm_add_epi32(message, _mm_loadu_si128(reinterpret_cast<__m128i const*>(&SHA256Constants::RoundConstants[group * 4])));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message_and_constants);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(message_and_constants, 0x0e));
         }
-        m_data_buffer[m_data_length++] = message[i];
+
+        abef = _mm_add_epi32(abef, abef_save);
+        cdgh = _mm_add_epi32(cdgh, cdgh_save);
     }
+
+    auto feba = _mm_shuffle_epi32(abef, 0x1b);
+    auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+static bool cpu_supports_sha_ni()
+{
+    static bool const supports_sha_ni = __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1");
+    return supports_sha_ni;
+}
+
+static bool cpu_supports_avx2()
+{
+    static bool const supports_avx2 = __builtin_cpu_supports("avx2");
+    return supports_avx2;
+}
+
+template<int bits>
+[[gnu::target("avx2")]] static ALWAYS_INLINE __m256i rotate_right_8_lanes(__m256i value)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(value, bits), _mm256_slli_epi32(value, 32 - bits));
+}
+
+// Hashes one block of each of eight independent messages, with each of the 32-bit lanes of a vector belonging to
+// another message. `state` holds the words of the states the same way, i.e. state[word][lane].
+[[gnu::target("avx2")]] static void transform_8_lanes(u32 (&state)[8][8], u8 const* const (&blocks)[8])
+{
+    auto const byte_swap_mask = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL, 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // Each block gives us eight words at a time for its lane, so those have to be transposed.
+    __m256i words[16];
+    for (size_t half = 0; half < 2; ++half) {
+        __m256i rows[8];
+        for (size_t lane = 0; lane < 8; ++lane)
+            rows[lane] = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(blocks[lane] + half * 32)), byte_swap_mask);
+
+        __m256i pairs[8];
+        for (size_t i = 0; i < 8; i += 2) {
+            pairs[i] = _mm256_unpacklo_epi32(rows[i], rows[i + 1]);
+            pairs[i + 1] = _mm256_unpackhi_epi32(rows[i], rows[i + 1]);
+        }
+        __m256i quads[8];
+        for (size_t i = 0; i < 8; i += 4) {
+            quads[i] = _mm256_unpacklo_epi64(pairs[i], pairs[i + 2]);
+            quads[i + 1] = _mm256_unpackhi_epi64(pairs[i], pairs[i + 2]);
+            quads[i + 2] = _mm256_unpacklo_epi64(pairs[i + 1], pairs[i + 3]);
+            quads[i + 3] = _mm256_unpackhi_epi64(pairs[i + 1], pairs[i + 3]);
+        }
+        for (size_t i = 0; i < 4; ++i) {
+            words[half * 8 + i] = _mm256_permute2x128_si256(quads[i], quads[i + 4], 0x20);
+            words[half * 8 + i + 4] = _mm256_permute2x128_si256(quads[i], quads[i + 4], 0x31);
+        }
+    }
+
+    __m256i vars[8];
+    for (size_t i = 0; i < 8; ++i)
+        vars[i] = _mm256_load_si256(reinterpret_cast<__m256i const*>(state[i]));
+    auto a = vars[0], b = vars[1], c = vars[2], d = vars[3], e = vars[4], f = vars[5], g = vars[6], h = vars[7];
+
+    for (size_t i = 0; i < 64; ++i) {
+        auto& word = words[i % 16];
+        if (i >= 16) {
+            auto const& w2 = words[(i - 2) % 16];
+            auto const& w15 = words[(i - 15) % 16];
+            auto sign1 = _mm256_xor_si256(_mm256_xor_si256(rotate_right_8_lanes<17>(w2), rotate_right_8_lanes<19>(w2)), _mm256_srli_epi32(w2, 10));
+            auto sign0 = _mm256_xor_si256(_mm256_xor_si256(rotate_right_8_lanes<7>(w15), rotate_right_8_lanes<18>(w15)), _mm256_srli_epi32(w15, 3));
+            word = _mm256_add_epi32(_mm256_add_epi32(word, sign1), _mm256_add_epi32(words[(i - 7) % 16], sign0));
+        }
+
+        auto ep1 = _mm256_xor_si256(_mm256_xor_si256(rotate_right_8_lanes<6>(e), rotate_right_8_lanes<11>(e)), rotate_right_8_lanes<25>(e));
+        auto ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        auto round_constant = _mm256_set1_epi32(static_cast<int>(SHA256Constants::RoundConstants[i]));
+        auto temp0 = _mm256_add_epi32(_mm256_add_epi32(h, ep1), _mm256_add_epi32(_mm256_add_epi32(ch, round_constant), word));
+        auto ep0 = _mm256_xor_si256(_mm256_xor_si256(rotate_right_8_lanes<2>(a), rotate_right_8_lanes<13>(a)), rotate_right_8_lanes<22>(a));
+        auto maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        auto temp1 = _mm256_add_epi32(ep0, maj);
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, temp0);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(temp0, temp1);
+    }
+
+    __m256i results[8] { a, b, c, d, e, f, g, h };
+    for (size_t i = 0; i < 8; ++i)
+        _mm256_store_si256(reinterpret_cast<__m256i*>(state[i]), _mm256_add_epi32(vars[i], results[i]));
+}
+#endif
+
+void SHA256::transform_blocks(u32* state, u8 const* data, size_t count)
+{
+#ifdef SHA2_USE_SIMD
+    if (cpu_supports_sha_ni()) {
+        transform_blocks_sha_ni(state, data, count);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < count; ++i)
+        transform_block(state, data + i * BlockSize);
+}
+
+void SHA256::update(u8 const* message, size_t length)
+{
+    if (m_data_length > 0) {
+        auto copied = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, copied);
+        m_data_length += copied;
+        message += copied;
+        length -= copied;
+        if (m_data_length < BlockSize)
+            return;
+        transform_blocks(m_state, m_data_buffer, 1);
+        m_bit_length += BlockSize * 8;
+        m_data_length = 0;
+    }
+
+    // Whole blocks are hashed right from the message, only what's left over is kept for later.
+    auto block_count = length / BlockSize;
+    if (block_count > 0) {
+        transform_blocks(m_state, message, block_count);
+        m_bit_length += block_count * BlockSize * 8;
+        message += block_count * BlockSize;
+        length -= block_count * BlockSize;
+    }
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA256::DigestType SHA256::digest()
@@ -89,8 +255,16 @@ SHA256::DigestType SHA256::peek()
     DigestType digest;
     size_t i = m_data_length;
 
+    // Finishing the hash changes the state, so keep what we need to put it back afterwards.
+    u8 data[BlockSize];
+    u32 state[8];
+    auto data_length = m_data_length;
+    auto bit_length = m_bit_length;
+    __builtin_memcpy(data, m_data_buffer, m_data_length);
+    __builtin_memcpy(state, m_state, sizeof(m_state));
+
     if (BlockSize == m_data_length) {
-        transform(m_data_buffer);
+        transform_blocks(m_state, m_data_buffer, 1);
         m_bit_length += BlockSize * 8;
         m_data_length = 0;
         i = 0;
@@ -106,7 +280,7 @@ SHA256::DigestType SHA256::peek()
         m_data_buffer[i++] = 0x80;
         while (i < BlockSize)
             m_data_buffer[i++] = 0x00;
-        transform(m_data_buffer);
+        transform_blocks(m_state, m_data_buffer, 1);
 
         // Then start another block with BlockSize - 8 bytes of zeros
         __builtin_memset(m_data_buffer, 0, FinalBlockDataSize);
@@ -123,7 +297,7 @@ SHA256::DigestType SHA256::peek()
     m_data_buffer[BlockSize - 7] = m_bit_length >> 48;
     m_data_buffer[BlockSize - 8] = m_bit_length >> 56;
 
-    transform(m_data_buffer);
+    transform_blocks(m_state, m_data_buffer, 1);
 
     // SHA uses big-endian and we assume little-endian
     // FIXME: looks like a thing for AK::NetworkOrdered,
@@ -138,9 +312,136 @@ SHA256::DigestType SHA256::peek()
         digest.data[i + 24] = (m_state[6] >> (24 - i * 8)) & 0x000000ff;
         digest.data[i + 28] = (m_state[7] >> (24 - i * 8)) & 0x000000ff;
     }
+
+    __builtin_memcpy(m_data_buffer, data, data_length);
+    __builtin_memcpy(m_state, state, sizeof(m_state));
+    m_data_length = data_length;
+    m_bit_length = bit_length;
     return digest;
 }
 
+void SHA256::hash_many(ReadonlySpan<ReadonlyBytes> inputs, Span<DigestType> digests)
+{
+    VERIFY(inputs.size() == digests.size());
+
+#ifdef SHA2_USE_SIMD
+    // The SHA instructions hash a single message faster than the eight lanes of AVX2 hash eight of them.
+    if (!cpu_supports_sha_ni() && cpu_supports_avx2()) {
+        // Every input is padded up front, so its blocks can be fed to a lane one after another without any further logic.
+        struct Lane {
+            size_t input_index { 0 };
+            u8 const* data { nullptr };
+            size_t whole_block_count { 0 };
+            size_t block_count { 0 };
+            size_t next_block { 0 };
+            u8 final_blocks[2 * BlockSize];
+
+            u8 const* block(size_t index) const
+            {
+                if (index < whole_block_count)
+                    return data + index * BlockSize;
+                return final_blocks + (index - whole_block_count) * BlockSize;
+            }
+        };
+
+        // With fewer messages than this left to hash, it's faster to finish them one at a time.
+        static constexpr size_t minimum_active_lane_count = 3;
+        static u8 const idle_block[BlockSize] {};
+
+        Lane lanes[8];
+        bool is_active[8] {};
+        alignas(32) u32 state[8][8];
+        size_t next_input = 0;
+
+        auto start_next_input = [&](size_t lane_index) {
+            if (next_input == inputs.size()) {
+                is_active[lane_index] = false;
+                return;
+            }
+            auto& lane = lanes[lane_index];
+            auto input = inputs[next_input];
+            lane.input_index = next_input++;
+            lane.data = input.data();
+            lane.whole_block_count = input.size() / BlockSize;
+            lane.next_block = 0;
+
+            auto rest = input.size() % BlockSize;
+            auto final_block_count = rest < FinalBlockDataSize ? 1 : 2;
+            lane.block_count = lane.whole_block_count + final_block_count;
+            __builtin_memset(lane.final_blocks, 0, sizeof(lane.final_blocks));
+            if (rest > 0)
+                __builtin_memcpy(lane.final_blocks, input.data() + lane.whole_block_count * BlockSize, rest);
+            lane.final_blocks[rest] = 0x80;
+            u64 bit_length = input.size() * 8;
+            auto* end = lane.final_blocks + final_block_count * BlockSize;
+            for (size_t i = 0; i < 8; ++i)
+                end[-1 - i] = bit_length >> (i * 8);
+
+            for (size_t word = 0; word < 8; ++word)
+                state[word][lane_index] = SHA256Constants::InitializationHashes[word];
+            is_active[lane_index] = true;
+        };
+
+        auto store_digest = [&](u32 const* lane_state, DigestType& digest) {
+            for (size_t word = 0; word < 8; ++word) {
+                auto value = AK::convert_between_host_and_network_endian(lane_state[word]);
+                __builtin_memcpy(digest.data + word * 4, &value, 4);
+            }
+        };
+
+        for (size_t lane_index = 0; lane_index < 8; ++lane_index)
+            start_next_input(lane_index);
+
+        for (;;) {
+            size_t active_lane_count = 0;
+            u8 const* blocks[8];
+            for (size_t lane_index = 0; lane_index < 8; ++lane_index) {
+                if (!is_active[lane_index]) {
+                    blocks[lane_index] = idle_block;
+                    continue;
+                }
+                blocks[lane_index] = lanes[lane_index].block(lanes[lane_index].next_block);
+                ++active_lane_count;
+            }
+            if (next_input == inputs.size() && active_lane_count < minimum_active_lane_count)
+                break;
+
+            transform_8_lanes(state, blocks);
+
+            for (size_t lane_index = 0; lane_index < 8; ++lane_index) {
+                auto& lane = lanes[lane_index];
+                if (!is_active[lane_index] || ++lane.next_block < lane.block_count)
+                    continue;
+                u32 lane_state[8];
+                for (size_t word = 0; word < 8; ++word)
+                    lane_state[word] = state[word][lane_index];
+                store_digest(lane_state, digests[lane.input_index]);
+                start_next_input(lane_index);
+            }
+        }
+
+        for (size_t lane_index = 0; lane_index < 8; ++lane_index) {
+            if (!is_active[lane_index])
+                continue;
+            auto& lane = lanes[lane_index];
+            u32 lane_state[8];
+            for (size_t word = 0; word < 8; ++word)
+                lane_state[word] = state[word][lane_index];
+            if (lane.next_block < lane.whole_block_count) {
+                transform_blocks(lane_state, lane.block(lane.next_block), lane.whole_block_count - lane.next_block);
+                lane.next_block = lane.whole_block_count;
+            }
+            transform_blocks(lane_state, lane.block(lane.next_block), lane.block_count - lane.next_block);
+            store_digest(lane_state, digests[lane.input_index]);
+        }
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < inputs.size(); ++i)
+        digests[i] = hash(inputs[i].data(), inputs[i].size());
+}
+
 inline void SHA384::transform(u8 const* data)
 {
     u64 m[80];
@@ -207,6 +508,14 @@ SHA384::DigestType SHA384::peek()
     DigestType digest;
     size_t i = m_data_length;
 
+    // Finishing the hash changes the state, so keep what we need to put it back afterwards.
+    u8 data[BlockSize];
+    u64 state[8];
+    auto data_length = m_data_length;
+    auto bit_length = m_bit_length;
+    __builtin_memcpy(data, m_data_buffer, m_data_length);
+    __builtin_memcpy(state, m_state, sizeof(m_state));
+
     if (BlockSize == m_data_length) {
         transform(m_data_buffer);
         m_bit_length += BlockSize * 8;
@@ -263,6 +572,11 @@ SHA384::DigestType SHA384::peek()
         digest.data[i + 32] = (m_state[4] >> (56 - i * 8)) & 0x000000ff;
         digest.data[i + 40] = (m_state[5] >> (56 - i * 8)) & 0x000000ff;
     }
+
+    __builtin_memcpy(m_data_buffer, data, data_length);
+    __builtin_memcpy(m_state, state, sizeof(m_state));
+    m_data_length = data_length;
+    m_bit_length = bit_length;
     return digest;
 }
 
@@ -331,6 +645,14 @@ SHA512::DigestType SHA512::peek()
     DigestType digest;
     size_t i = m_data_length;
 
+    // Finishing the hash changes the state, so keep what we need to put it back afterwards.
+    u8 data[BlockSize];
+    u64 state[8];
+    auto data_length = m_data_length;
+    auto bit_length = m_bit_length;
+    __builtin_memcpy(data, m_data_buffer, m_data_length);
+    __builtin_memcpy(state, m_state, sizeof(m_state));
+
     if (BlockSize == m_data_length) {
         transform(m_data_buffer);
         m_bit_length += BlockSize * 8;
@@ -389,6 +711,11 @@ SHA512::DigestType SHA512::peek()
         digest.data[i + 48] = (m_state[6] >> (56 - i * 8)) & 0x000000ff;
         digest.data[i + 56] = (m_state[7] >> (56 - i * 8)) & 0x000000ff;
     }
+
+    __builtin_memcpy(m_data_buffer, data, data_length);
+    __builtin_memcpy(m_state, state, sizeof(m_state));
+    m_data_length = data_length;
+    m_bit_length = bit_length;
     return digest;
 }
 }
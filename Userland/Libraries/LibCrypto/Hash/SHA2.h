@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Span.h>
 #include <AK/StringBuilder.h>
 #include <LibCrypto/Hash/HashFunction.h>
 
@@ -99,6 +100,10 @@ public:
     static DigestType hash(ByteBuffer const& buffer) { return hash(buffer.data(), buffer.size()); }
     static DigestType hash(StringView buffer) { return hash((u8 const*)buffer.characters_without_null_termination(), buffer.length()); }
 
+    // Hashes each of `inputs` on its own, and stores their digests in `digests`, which has to be just as long.
+    // Where the CPU allows for it, this hashes several of the inputs at once, which is a lot faster for many small inputs.
+    static void hash_many(ReadonlySpan<ReadonlyBytes> inputs, Span<DigestType> digests);
+
 #ifndef KERNEL
     virtual DeprecatedString class_name() const override
     {
@@ -115,7 +120,7 @@ public:
     }
 
 private:
-    inline void transform(u8 const*);
+    static void transform_blocks(u32* state, u8 const*, size_t count);
 
     u8 m_data_buffer[BlockSize] {};
     size_t m_data_length { 0 };
@@ -249,7 +249,7 @@ void RSA::sign(ReadonlyBytes in, Bytes& out)
     auto in_integer = UnsignedBigInteger::import_data(in.data(), in.size());
     auto exp = NumberTheory::ModularPower(in_integer, m_private_key.private_exponent(), m_private_key.modulus());
     auto size = exp.export_data(out);
-    out = out.slice(out.size() - size, size);
+    out = out.slice(0, size);
 }
 
 void RSA::verify(ReadonlyBytes in, Bytes& out)
@@ -257,7 +257,7 @@ void RSA::verify(ReadonlyBytes in, Bytes& out)
     auto in_integer = UnsignedBigInteger::import_data(in.data(), in.size());
     auto exp = NumberTheory::ModularPower(in_integer, m_public_key.public_exponent(), m_public_key.modulus());
     auto size = exp.export_data(out);
-    out = out.slice(out.size() - size, size);
+    out = out.slice(0, size);
 }
 
 void RSA::import_private_key(ReadonlyBytes bytes, bool pem)
@@ -61,7 +61,7 @@ ErrorOr<ByteBuffer> Packet::to_byte_buffer() const
         TRY(stream.write_value(htons((u16)answer.type())));
         TRY(stream.write_value(htons(answer.raw_class_code())));
         TRY(stream.write_value(htonl(answer.ttl())));
-        if (answer.type() == RecordType::PTR) {
+        if (answer.type() == RecordType::PTR || answer.type() == RecordType::CNAME) {
             Name name { answer.record_data() };
             TRY(stream.write_value(htons(name.serialized_size())));
             TRY(stream.write_value(name));
@@ -117,7 +117,7 @@ Optional<Packet> Packet::from_raw_packet(u8 const* raw_data, size_t raw_size)
     packet.m_code = header.response_code();
 
     // FIXME: Should we parse further in this case?
-    if (packet.code() != Code::NOERROR)
+    if (packet.code() != Code::NOERROR && packet.code() != Code::NXDOMAIN)
         return packet;
 
     size_t offset = sizeof(PacketHeader);
@@ -147,13 +147,13 @@ Optional<Packet> Packet::from_raw_packet(u8 const* raw_data, size_t raw_size)
         offset += sizeof(DNSRecordWithoutName);
 
         switch ((RecordType)record.type()) {
-        case RecordType::PTR: {
+        case RecordType::PTR:
+            // Fall through
+        case RecordType::CNAME: {
             size_t dummy_offset = offset;
             data = Name::parse(raw_data, dummy_offset, raw_size).as_string();
             break;
         }
-        case RecordType::CNAME:
-            // Fall through
         case RecordType::A:
             // Fall through
         case RecordType::TXT:
@@ -175,6 +175,27 @@ Optional<Packet> Packet::from_raw_packet(u8 const* raw_data, size_t raw_size)
         offset += record.data_length();
     }
 
+    for (u16 i = 0; i < header.authority_count(); ++i) {
+        (void)Name::parse(raw_data, offset, raw_size);
+        if (offset + sizeof(DNSRecordWithoutName) > raw_size)
+            break;
+
+        auto& record = *(DNSRecordWithoutName const*)(&raw_data[offset]);
+        offset += sizeof(DNSRecordWithoutName);
+
+        if ((RecordType)record.type() == RecordType::SOA) {
+            // The SOA's MNAME and RNAME are followed by SERIAL, REFRESH, RETRY, EXPIRE and MINIMUM, and it's the lesser of MINIMUM and the record's own TTL that counts.
+            size_t soa_offset = offset;
+            (void)Name::parse(raw_data, soa_offset, raw_size);
+            (void)Name::parse(raw_data, soa_offset, raw_size);
+            if (soa_offset + 5 * sizeof(u32) <= raw_size) {
+                u32 minimum = *(NetworkOrdered<u32> const*)(&raw_data[soa_offset + 4 * sizeof(u32)]);
+                packet.m_negative_caching_ttl = min(record.ttl(), minimum);
+            }
+        }
+        offset += record.data_length();
+    }
+
     return packet;
 }
 
@@ -75,6 +75,10 @@ public:
     Code code() const { return (Code)m_code; }
     void set_code(Code code) { m_code = (u8)code; }
 
+    // RFC 2308, section 5: How long a negative answer (NXDOMAIN, or no records of the type asked for) may be cached,
+    // going by the SOA record in the authority section. Negative answers without one shouldn't be cached at all.
+    Optional<u32> negative_caching_ttl() const { return m_negative_caching_ttl; }
+
 private:
     u16 m_id { 0 };
     u8 m_code { 0 };
@@ -84,6 +88,7 @@ private:
     bool m_recursion_available { true };
     Vector<Question> m_questions;
     Vector<Answer> m_answers;
+    Optional<u32> m_negative_caching_ttl;
 };
 
 }
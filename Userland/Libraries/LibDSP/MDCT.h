@@ -8,18 +8,20 @@
 
 #include <AK/Array.h>
 #include <AK/Math.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Span.h>
 
 namespace DSP {
 
 template<size_t N>
-requires(N % 2 == 0) class MDCT {
+requires(N % 4 == 0) class MDCT {
 public:
-    constexpr MDCT()
+    MDCT()
     {
         for (size_t n = 0; n < N; n++) {
             for (size_t k = 0; k < N / 2; k++) {
-                m_phi[n][k] = AK::cos<float>(AK::Pi<float> / (2 * N) * (2 * static_cast<float>(n) + 1 + N / 2.0f) * static_cast<float>(2 * k + 1));
+                m_phi[k][n / 4][n % 4] = AK::cos<float>(AK::Pi<float> / (2 * N) * (2 * static_cast<float>(n) + 1 + N / 2.0f) * static_cast<float>(2 * k + 1));
             }
         }
     }
@@ -28,16 +30,20 @@ public:
     {
         assert(N == 2 * data.size());
         assert(N == output.size());
-        for (size_t n = 0; n < N; n++) {
-            output[n] = 0;
-            for (size_t k = 0; k < N / 2; k++) {
-                output[n] += data[k] * m_phi[n][k];
-            }
+
+        // Every input value contributes to all outputs, so four outputs are accumulated at once.
+        Array<AK::SIMD::f32x4, N / 4> sums {};
+        for (size_t k = 0; k < N / 2; k++) {
+            auto value = AK::SIMD::expand4(data[k]);
+            for (size_t n = 0; n < N / 4; n++)
+                sums[n] += value * m_phi[k][n];
         }
+        __builtin_memcpy(output.data(), sums.data(), N * sizeof(float));
     }
 
 private:
-    Array<Array<float, N / 2>, N> m_phi;
+    // Stored by input index, so that the coefficients for consecutive outputs are next to each other.
+    Array<Array<AK::SIMD::f32x4, N / 4>, N / 2> m_phi;
 };
 
 }
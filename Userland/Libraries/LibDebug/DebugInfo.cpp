@@ -122,18 +122,19 @@ ErrorOr<void> DebugInfo::prepare_lines()
 
 Optional<DebugInfo::SourcePosition> DebugInfo::get_source_position(FlatPtr target_address) const
 {
-    if (m_sorted_lines.is_empty())
-        return {};
-    if (target_address < m_sorted_lines[0].address)
-        return {};
-
-    // TODO: We can do a binary search here
-    for (size_t i = 0; i < m_sorted_lines.size() - 1; ++i) {
-        if (m_sorted_lines[i + 1].address > target_address) {
-            return SourcePosition::from_line_info(m_sorted_lines[i]);
-        }
+    // Find the first line that starts after the target address. The target belongs to the line before it.
+    size_t low = 0;
+    size_t high = m_sorted_lines.size();
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        if (m_sorted_lines[middle].address > target_address)
+            high = middle;
+        else
+            low = middle + 1;
     }
-    return {};
+    if (low == 0 || low == m_sorted_lines.size())
+        return {};
+    return SourcePosition::from_line_info(m_sorted_lines[low - 1]);
 }
 
 Optional<DebugInfo::SourcePositionAndAddress> DebugInfo::get_address_from_source_position(DeprecatedString const& file, size_t line) const
@@ -442,6 +443,36 @@ ErrorOr<DebugInfo::SourcePositionWithInlines> DebugInfo::get_source_position_wit
     return SourcePositionWithInlines { inner_source_position, inline_chain };
 }
 
+ErrorOr<Vector<FlatPtr>> DebugInfo::source_position_boundaries() const
+{
+    Vector<FlatPtr> boundaries;
+    TRY(boundaries.try_ensure_capacity(m_sorted_lines.size()));
+    for (auto const& line : m_sorted_lines)
+        boundaries.unchecked_append(line.address);
+
+    // The inline chain can change at the start of a DIE's range, and right after its end, since get_die_at_address()
+    // counts the end address as part of the range. When several ranges start at the same address, looking up the start
+    // address itself can also find a different one of them than looking up the addresses after it.
+    TRY(m_dwarf_info.for_each_die_range([&](FlatPtr start, FlatPtr end) -> ErrorOr<void> {
+        TRY(boundaries.try_append(start));
+        if (start != NumericLimits<FlatPtr>::max())
+            TRY(boundaries.try_append(start + 1));
+        if (end != NumericLimits<FlatPtr>::max())
+            TRY(boundaries.try_append(end + 1));
+        return {};
+    }));
+
+    quick_sort(boundaries);
+
+    size_t unique_count = 0;
+    for (auto boundary : boundaries) {
+        if (unique_count == 0 || boundaries[unique_count - 1] != boundary)
+            boundaries[unique_count++] = boundary;
+    }
+    boundaries.shrink(unique_count);
+    return boundaries;
+}
+
 ErrorOr<Optional<Dwarf::LineProgram::DirectoryAndFile>> DebugInfo::get_source_path_of_inline(Dwarf::DIE const& die) const
 {
     auto caller_file = TRY(die.get_attribute(Dwarf::Attribute::CallFile));
@@ -100,6 +100,9 @@ public:
     };
     ErrorOr<SourcePositionWithInlines> get_source_position_with_inlines(FlatPtr address) const;
 
+    // The addresses at which the result of get_source_position_with_inlines() can change, in ascending order.
+    ErrorOr<Vector<FlatPtr>> source_position_boundaries() const;
+
     struct SourcePositionAndAddress {
         DeprecatedString file;
         size_t line;
@@ -360,6 +360,20 @@ ErrorOr<void> DwarfInfo::build_cached_dies() const
         return {};
     }));
 
+    Vector<size_t> ranges_ending_later;
+    for (auto& die_and_range : m_cached_dies_by_range) {
+        die_and_range.index = m_cached_dies_in_order.size();
+        while (!ranges_ending_later.is_empty() && m_cached_dies_in_order[ranges_ending_later.last()]->range.end_address <= die_and_range.range.end_address)
+            ranges_ending_later.take_last();
+
+        TRY(m_cached_dies_in_order.try_append(&die_and_range));
+        if (ranges_ending_later.is_empty())
+            TRY(m_previous_range_ending_later.try_append({}));
+        else
+            TRY(m_previous_range_ending_later.try_append(ranges_ending_later.last()));
+        TRY(ranges_ending_later.try_append(die_and_range.index));
+    }
+
     m_built_cached_dies = true;
     return {};
 }
@@ -370,18 +384,22 @@ ErrorOr<Optional<DIE>> DwarfInfo::get_die_at_address(FlatPtr address) const
         TRY(build_cached_dies());
 
     auto iter = m_cached_dies_by_range.find_largest_not_above_iterator(address);
-    while (!iter.is_end() && !iter.is_begin() && iter->range.end_address < address) {
-        --iter;
-    }
-
     if (iter.is_end())
         return Optional<DIE> {};
 
-    if (iter->range.start_address > address || iter->range.end_address < address) {
-        return Optional<DIE> {};
+    // The ranges that are skipped here all end before the range we skip them from, so they can't contain the address either.
+    auto const* die_and_range = m_cached_dies_in_order[iter->index];
+    while (die_and_range->range.end_address < address) {
+        auto previous_index = m_previous_range_ending_later[die_and_range->index];
+        if (!previous_index.has_value())
+            return Optional<DIE> {};
+        die_and_range = m_cached_dies_in_order[*previous_index];
     }
 
-    return iter->die;
+    if (die_and_range->range.start_address > address)
+        return Optional<DIE> {};
+
+    return die_and_range->die;
 }
 
 ErrorOr<Optional<DIE>> DwarfInfo::get_cached_die_at_offset(FlatPtr offset) const
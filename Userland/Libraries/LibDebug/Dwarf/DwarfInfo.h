@@ -46,6 +46,10 @@ public:
 
     ErrorOr<Optional<DIE>> get_die_at_address(FlatPtr) const;
 
+    // Calls the callback with the start and end address of every range that get_die_at_address() looks DIEs up in.
+    template<typename Callback>
+    ErrorOr<void> for_each_die_range(Callback) const;
+
     // Note that even if there is a DIE at the given offset,
     // but it does not exist in the DIE cache (because for example
     // it does not contain an address range), then this function will not return it.
@@ -80,11 +84,17 @@ private:
     struct DIEAndRange {
         DIE die;
         DIERange range;
+        // The position of this range in m_cached_dies_by_range.
+        size_t index { 0 };
     };
 
     using DIEStartAddress = FlatPtr;
 
     mutable RedBlackTree<DIEStartAddress, DIEAndRange> m_cached_dies_by_range;
+    // For each range, the closest range before it that ends after it does. Looking up an address walks back from the
+    // last range that starts at or before it, and this lets it skip over the ranges that end too early to contain it.
+    mutable Vector<DIEAndRange const*> m_cached_dies_in_order;
+    mutable Vector<Optional<size_t>> m_previous_range_ending_later;
     mutable RedBlackTree<FlatPtr, DIE> m_cached_dies_by_offset;
     mutable bool m_built_cached_dies { false };
 };
@@ -98,4 +108,15 @@ ErrorOr<void> DwarfInfo::for_each_compilation_unit(Callback callback) const
     return {};
 }
 
+template<typename Callback>
+ErrorOr<void> DwarfInfo::for_each_die_range(Callback callback) const
+{
+    if (!m_built_cached_dies)
+        TRY(build_cached_dies());
+
+    for (auto const& die_and_range : m_cached_dies_by_range)
+        TRY(callback(die_and_range.range.start_address, die_and_range.range.end_address));
+    return {};
+}
+
 }
@@ -28,11 +28,15 @@
 #include <LibELF/Hashes.h>
 #include <bits/dlfcn_integration.h>
 #include <dlfcn.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <pthread.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <syscall.h>
+#include <time.h>
 
 namespace ELF {
 
@@ -55,8 +59,20 @@ static LibCExitFunction s_libc_exit = nullptr;
 static __pthread_mutex_t s_loader_lock = __PTHREAD_MUTEX_INITIALIZER;
 static DeprecatedString s_cwd;
 
+// Relocations in different objects keep asking for the same symbols (malloc, free, the vtables of LibCore
+// and LibGUI, ...), so remember where each one was found instead of searching every object's hash table
+// again. The names point into the string tables of the objects needing them, which are never unmapped.
+// Any object becoming globally visible drops the cache, since it may define a symbol that wasn't found
+// before or override one that was only defined weakly.
+static HashMap<StringView, Optional<DynamicObject::SymbolLookupResult>> s_global_symbol_cache;
+static __pthread_mutex_t s_global_symbol_cache_lock = __PTHREAD_MUTEX_INITIALIZER;
+
 static bool s_allowed_to_check_environment_variables { false };
 static bool s_do_breakpoint_trap_before_entry { false };
+static Optional<int> s_entry_time_fd;
+static Optional<int> s_lazy_bindings_fd;
+static StringView s_hot_symbols_path;
+static HashTable<DeprecatedString> s_hot_symbols;
 static StringView s_ld_library_path;
 static StringView s_main_program_pledge_promises;
 static DeprecatedString s_loader_pledge_promises;
@@ -85,6 +101,72 @@ Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(
     return weak_result;
 }
 
+Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol_for_relocation(DynamicObject::Symbol const& symbol)
+{
+    pthread_mutex_lock(&s_global_symbol_cache_lock);
+    ScopeGuard unlock_guard = [] { pthread_mutex_unlock(&s_global_symbol_cache_lock); };
+
+    auto name = symbol.name();
+    if (auto cached_result = s_global_symbol_cache.get(name); cached_result.has_value())
+        return cached_result.release_value();
+
+    auto result = lookup_global_symbol(name);
+    // NOTE: If we can't remember this one, we'll just look it up again next time.
+    (void)s_global_symbol_cache.try_set(name, result);
+    return result;
+}
+
+bool DynamicLinker::should_bind_at_load_time(StringView symbol_name)
+{
+    return !s_hot_symbols.is_empty() && s_hot_symbols.contains(symbol_name);
+}
+
+void DynamicLinker::did_bind_lazily(StringView symbol_name)
+{
+    if (!s_lazy_bindings_fd.has_value())
+        return;
+    // NOTE: This may run on any thread at any time, so write the line in one go without allocating.
+    iovec line[] = {
+        { const_cast<char*>(symbol_name.characters_without_null_termination()), symbol_name.length() },
+        { const_cast<char*>("\n"), 1 },
+    };
+    (void)writev(s_lazy_bindings_fd.value(), line, 2);
+}
+
+static void load_hot_symbols()
+{
+    DeprecatedString path = s_hot_symbols_path;
+    int fd = open(path.characters(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        dbgln("Unable to open hot symbols list {}: {}", path, strerror(errno));
+        return;
+    }
+    ScopeGuard close_guard = [fd] { close(fd); };
+
+    struct stat stat;
+    if (fstat(fd, &stat) < 0 || stat.st_size == 0)
+        return;
+    auto* data = mmap(nullptr, stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+        return;
+
+    StringView { static_cast<char const*>(data), static_cast<size_t>(stat.st_size) }.for_each_split_view('\n', SplitBehavior::Nothing, [](StringView line) {
+        auto symbol_name = line.trim_whitespace();
+        if (!symbol_name.is_empty())
+            s_hot_symbols.set(symbol_name);
+    });
+    munmap(data, stat.st_size);
+}
+
+static void add_global_object(DeprecatedString const& filepath, NonnullRefPtr<DynamicObject> object)
+{
+    s_global_objects.set(filepath, move(object));
+
+    pthread_mutex_lock(&s_global_symbol_cache_lock);
+    s_global_symbol_cache.clear();
+    pthread_mutex_unlock(&s_global_symbol_cache_lock);
+}
+
 static Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> map_library(DeprecatedString const& filepath, int fd)
 {
     VERIFY(filepath.starts_with('/'));
@@ -100,7 +182,7 @@ static Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> map_library(Deprecat
 
     // This actually maps the library at the intended and final place.
     auto main_library_object = loader->map();
-    s_global_objects.set(filepath, *main_library_object);
+    add_global_object(filepath, *main_library_object);
 
     return loader;
 }
@@ -387,7 +469,7 @@ static Result<void, DlErrorMessage> link_main_library(DeprecatedString const& pa
     for (auto& loader : loaders) {
         auto dynamic_object = loader.map();
         if (dynamic_object)
-            s_global_objects.set(dynamic_object->filepath(), *dynamic_object);
+            add_global_object(dynamic_object->filepath(), *dynamic_object);
     }
 
     for (auto& loader : loaders) {
@@ -616,6 +698,21 @@ static void read_environment_variables()
         if (env_string.starts_with(loader_pledge_promises_key)) {
             s_loader_pledge_promises = env_string.substring_view(loader_pledge_promises_key.length());
         }
+
+        constexpr auto entry_time_fd_key = "_LOADER_ENTRY_TIME_FD="sv;
+        if (env_string.starts_with(entry_time_fd_key)) {
+            s_entry_time_fd = env_string.substring_view(entry_time_fd_key.length()).to_int();
+        }
+
+        constexpr auto hot_symbols_key = "_LOADER_HOT_SYMBOLS="sv;
+        if (env_string.starts_with(hot_symbols_key)) {
+            s_hot_symbols_path = env_string.substring_view(hot_symbols_key.length());
+        }
+
+        constexpr auto lazy_bindings_fd_key = "_LOADER_LAZY_BINDINGS_FD="sv;
+        if (env_string.starts_with(lazy_bindings_fd_key)) {
+            s_lazy_bindings_fd = env_string.substring_view(lazy_bindings_fd_key.length()).to_int();
+        }
     }
 }
 
@@ -633,6 +730,9 @@ void ELF::DynamicLinker::linker_main(DeprecatedString&& main_program_path, int m
     if (s_allowed_to_check_environment_variables)
         read_environment_variables();
 
+    if (!s_hot_symbols_path.is_empty())
+        load_hot_symbols();
+
     s_main_program_path = main_program_path;
 
     // NOTE: We always map the main library first, since it may require
@@ -691,6 +791,14 @@ void ELF::DynamicLinker::linker_main(DeprecatedString&& main_program_path, int m
 #endif
     }
 
+    if (s_entry_time_fd.has_value()) {
+        // Let whoever started us know how long it took to get here, see Tests/LibELF/BenchmarkExecToMain.cpp.
+        timespec now {};
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        (void)write(s_entry_time_fd.value(), &now, sizeof(now));
+        close(s_entry_time_fd.value());
+    }
+
     _invoke_entry(argc, argv, envp, entry_point_function);
     VERIFY_NOT_REACHED();
 }
@@ -15,6 +15,15 @@ namespace ELF {
 class DynamicLinker {
 public:
     static Optional<DynamicObject::SymbolLookupResult> lookup_global_symbol(StringView symbol);
+    // Like lookup_global_symbol(), but remembers the result. The symbol has to belong to a loaded object.
+    static Optional<DynamicObject::SymbolLookupResult> lookup_global_symbol_for_relocation(DynamicObject::Symbol const&);
+
+    // Jump slots for the symbols listed in the file named by _LOADER_HOT_SYMBOLS are bound while loading,
+    // the rest are bound lazily on their first call. Setting _LOADER_LAZY_BINDINGS_FD writes the name of
+    // every lazily bound symbol to that file descriptor, which is a good start for such a list.
+    static bool should_bind_at_load_time(StringView symbol_name);
+    static void did_bind_lazily(StringView symbol_name);
+
     [[noreturn]] static void linker_main(DeprecatedString&& main_program_path, int fd, bool is_secure, int argc, char** argv, char** envp);
 
     static Optional<DeprecatedString> resolve_library(DeprecatedString const& name, DynamicObject const& parent_object);
@@ -567,7 +567,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_relocation(const ELF::DynamicO
     }
     case R_X86_64_JUMP_SLOT: {
         // FIXME: Or BIND_NOW flag passed in?
-        if (m_dynamic_object->must_bind_now()) {
+        if (m_dynamic_object->must_bind_now() || DynamicLinker::should_bind_at_load_time(relocation.symbol().name())) {
             // Eagerly BIND_NOW the PLT entries, doing all the symbol looking goodness
             // The patch method returns the address for the LAZY fixup path, but we don't need it here
             m_dynamic_object->patch_plt_entry(relocation.offset_in_section());
@@ -652,7 +652,9 @@ void DynamicLoader::setup_plt_trampoline()
 extern "C" FlatPtr _fixup_plt_entry(DynamicObject* object, u32 relocation_offset);
 extern "C" FlatPtr _fixup_plt_entry(DynamicObject* object, u32 relocation_offset)
 {
-    return object->patch_plt_entry(relocation_offset).get();
+    auto symbol_location = object->patch_plt_entry(relocation_offset);
+    DynamicLinker::did_bind_lazily(object->plt_relocation_section().relocation_at_offset(relocation_offset).symbol().name());
+    return symbol_location.get();
 }
 
 void DynamicLoader::call_object_init_functions()
@@ -683,7 +685,7 @@ void DynamicLoader::call_object_init_functions()
 Optional<DynamicObject::SymbolLookupResult> DynamicLoader::lookup_symbol(const ELF::DynamicObject::Symbol& symbol)
 {
     if (symbol.is_undefined() || symbol.bind() == STB_WEAK)
-        return DynamicLinker::lookup_global_symbol(symbol.name());
+        return DynamicLinker::lookup_global_symbol_for_relocation(symbol);
 
     return DynamicObject::SymbolLookupResult { symbol.value(), symbol.size(), symbol.address(), symbol.bind(), symbol.type(), &symbol.object() };
 }
@@ -92,7 +92,7 @@ void AbstractTableView::update_column_sizes()
 
     auto& model = *this->model();
     int column_count = model.column_count();
-    int row_count = model.row_count();
+    int row_count = min(model.row_count(), max_rows_to_measure_for_column_sizes);
 
     for (int column = 0; column < column_count; ++column) {
         if (!column_header().is_section_visible(column))
@@ -123,14 +123,7 @@ void AbstractTableView::update_row_sizes()
     if (!model())
         return;
 
-    auto& model = *this->model();
-    int row_count = model.row_count();
-
-    for (int row = 0; row < row_count; ++row) {
-        if (!row_header().is_section_visible(row))
-            continue;
-        row_header().set_section_size(row, row_height());
-    }
+    row_header().set_all_section_sizes(row_height());
 }
 
 void AbstractTableView::update_content_size()
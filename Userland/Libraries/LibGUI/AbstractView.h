@@ -134,6 +134,9 @@ protected:
     AbstractView();
     virtual ~AbstractView() override;
 
+    // Measuring every row of a large model to size the columns takes far too long, so views only look at this many.
+    static constexpr int max_rows_to_measure_for_column_sizes = 1000;
+
     virtual void keydown_event(KeyEvent&) override;
     virtual void mousedown_event(MouseEvent&) override;
     virtual void mousemove_event(MouseEvent&) override;
@@ -17,6 +17,9 @@
 #include <LibGUI/Window.h>
 #include <LibGfx/Font/Font.h>
 #include <LibGfx/Palette.h>
+#ifdef AK_OS_SERENITY
+#    include <serenity.h>
+#endif
 
 namespace GUI {
 
@@ -73,6 +76,11 @@ Application::Application(int argc, char** argv, Core::EventLoop::MakeInspectable
 {
     VERIFY(!*s_the);
     *s_the = *this;
+    m_startup_timer.start();
+#ifdef AK_OS_SERENITY
+    auto startup_signpost_string = "GUI application started"sv;
+    perf_event(PERF_EVENT_SIGNPOST, perf_register_string(startup_signpost_string.characters_without_null_termination(), startup_signpost_string.length()), 0);
+#endif
     m_event_loop = make<Core::EventLoop>(make_inspectable);
     ConnectionToWindowServer::the();
     Clipboard::initialize({});
@@ -88,6 +96,9 @@ Application::Application(int argc, char** argv, Core::EventLoop::MakeInspectable
     if (getenv("GUI_DND_DEBUG"))
         m_dnd_debugging_enabled = true;
 
+    if (getenv("GUI_STARTUP_DEBUG"))
+        m_startup_debugging_enabled = true;
+
     for (int i = 1; i < argc; i++) {
         DeprecatedString arg(argv[i]);
         m_args.append(move(arg));
@@ -265,6 +276,22 @@ void Application::window_did_become_inactive(Badge<Window>, Window& window)
     m_active_window = nullptr;
 }
 
+void Application::window_did_finish_painting(Badge<Window>, Window& window)
+{
+    if (m_did_finish_first_paint)
+        return;
+    m_did_finish_first_paint = true;
+
+    // This is what the time to start up looks like to the user, since the window shows up in the next composition.
+    auto elapsed_milliseconds = m_startup_timer.elapsed();
+#ifdef AK_OS_SERENITY
+    auto first_paint_signpost_string = "First window painted"sv;
+    perf_event(PERF_EVENT_SIGNPOST, perf_register_string(first_paint_signpost_string.characters_without_null_termination(), first_paint_signpost_string.length()), elapsed_milliseconds);
+#endif
+    if (m_startup_debugging_enabled)
+        dbgln("{}: First window '{}' painted {}ms after start-up", m_invoked_as, window.title(), elapsed_milliseconds);
+}
+
 void Application::set_pending_drop_widget(Widget* widget)
 {
     if (m_pending_drop_widget == widget)
@@ -10,6 +10,7 @@
 #include <AK/HashMap.h>
 #include <AK/OwnPtr.h>
 #include <AK/WeakPtr.h>
+#include <LibCore/ElapsedTimer.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/Object.h>
 #include <LibGUI/Forward.h>
@@ -68,6 +69,7 @@ public:
 
     void window_did_become_active(Badge<Window>, Window&);
     void window_did_become_inactive(Badge<Window>, Window&);
+    void window_did_finish_painting(Badge<Window>, Window&);
 
     Widget* drag_hovered_widget() { return m_drag_hovered_widget.ptr(); }
     Widget const* drag_hovered_widget() const { return m_drag_hovered_widget.ptr(); }
@@ -116,6 +118,9 @@ private:
     bool m_focus_debugging_enabled { false };
     bool m_hover_debugging_enabled { false };
     bool m_dnd_debugging_enabled { false };
+    bool m_startup_debugging_enabled { false };
+    bool m_did_finish_first_paint { false };
+    Core::ElapsedTimer m_startup_timer;
     DeprecatedString m_invoked_as;
     Vector<DeprecatedString> m_args;
     WeakPtr<Widget> m_drag_hovered_widget;
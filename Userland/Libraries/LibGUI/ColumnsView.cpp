@@ -228,7 +228,7 @@ void ColumnsView::update_column_sizes()
             total_height = column_height;
 
         column.width = 10;
-        for (int row = 0; row < row_count; row++) {
+        for (int row = 0; row < min(row_count, max_rows_to_measure_for_column_sizes); row++) {
             ModelIndex index = model()->index(row, m_model_column, column.parent_index);
             VERIFY(index.is_valid());
             auto text = index.data().to_deprecated_string();
@@ -19,6 +19,7 @@
 #include <LibGUI/Painter.h>
 #include <LibGfx/Bitmap.h>
 #include <LibThreading/BackgroundAction.h>
+#include <LibThreading/ThreadPool.h>
 #include <grp.h>
 #include <pwd.h>
 #include <stdio.h>
@@ -110,11 +111,25 @@ void FileSystemModel::Node::traverse_if_needed()
     }
     quick_sort(child_names);
 
+    // Stat'ing every child adds up in large directories, so we spread that over the thread pool.
+    Vector<OwnPtr<Node>> children;
+    children.resize(child_names.size());
+    Threading::parallel_for(
+        child_names.size(), [&](size_t i) {
+            children[i] = create_child(full_path, child_names[i]);
+        },
+        64);
+
+    Vector<DeprecatedString> allowed_suffixes;
+    if (m_model.m_allowed_file_extensions.has_value()) {
+        for (auto& extension : *m_model.m_allowed_file_extensions)
+            allowed_suffixes.append(DeprecatedString::formatted(".{}", extension));
+    }
+
     NonnullOwnPtrVector<Node> directory_children;
     NonnullOwnPtrVector<Node> file_children;
 
-    for (auto& child_name : child_names) {
-        auto maybe_child = create_child(child_name);
+    for (auto& maybe_child : children) {
         if (!maybe_child)
             continue;
 
@@ -128,8 +143,8 @@ void FileSystemModel::Node::traverse_if_needed()
                 continue;
             }
 
-            for (auto& extension : *m_model.m_allowed_file_extensions) {
-                if (child_name.ends_with(DeprecatedString::formatted(".{}", extension))) {
+            for (auto& suffix : allowed_suffixes) {
+                if (child->name.ends_with(suffix)) {
                     file_children.append(move(child));
                     break;
                 }
@@ -158,7 +173,13 @@ void FileSystemModel::Node::traverse_if_needed()
 
 OwnPtr<FileSystemModel::Node> FileSystemModel::Node::create_child(DeprecatedString const& child_name)
 {
-    DeprecatedString child_path = LexicalPath::join(full_path(), child_name).string();
+    return create_child(full_path(), child_name);
+}
+
+// NOTE: traverse_if_needed() calls this from the thread pool, so it mustn't touch anything but the new child.
+OwnPtr<FileSystemModel::Node> FileSystemModel::Node::create_child(StringView full_path, DeprecatedString const& child_name)
+{
+    DeprecatedString child_path = LexicalPath::join(full_path, child_name).string();
     auto child = adopt_own(*new Node(m_model));
 
     bool ok = child->fetch_data(child_path, false);
@@ -649,9 +670,15 @@ static ErrorOr<NonnullRefPtr<Gfx::Bitmap>> render_thumbnail(StringView path)
 
     double scale = min(32 / (double)bitmap->width(), 32 / (double)bitmap->height());
     auto destination = Gfx::IntRect(0, 0, (int)(bitmap->width() * scale), (int)(bitmap->height() * scale)).centered_within(thumbnail->rect());
+    if (destination.is_empty())
+        return thumbnail;
+
+    // Since we're on a background thread anyway, we can afford to resample the image properly
+    // instead of letting the painter pick out individual pixels.
+    auto scaled_bitmap = TRY(bitmap->scaled_to(destination.size()));
 
     Painter painter(thumbnail);
-    painter.draw_scaled_bitmap(destination, *bitmap, bitmap->rect());
+    painter.blit(destination.location(), *scaled_bitmap, scaled_bitmap->rect());
     return thumbnail;
 }
 
@@ -676,7 +703,9 @@ bool FileSystemModel::fetch_thumbnail_for(Node const& node)
 
     auto weak_this = make_weak_ptr();
 
+    // Thumbnails are decoded on the thread pool, so that a directory full of images doesn't decode them one after the other.
     (void)Threading::BackgroundAction<ErrorOr<NonnullRefPtr<Gfx::Bitmap>>>::construct(
+        Threading::ThreadPool::the(),
         [path](auto&) {
             return render_thumbnail(path);
         },
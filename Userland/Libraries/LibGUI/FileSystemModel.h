@@ -97,6 +97,7 @@ public:
         bool fetch_data(DeprecatedString const& full_path, bool is_root);
 
         OwnPtr<Node> create_child(DeprecatedString const& child_name);
+        OwnPtr<Node> create_child(StringView full_path, DeprecatedString const& child_name);
     };
 
     static NonnullRefPtr<FileSystemModel> create(DeprecatedString root_path = "/", Mode mode = Mode::FilesAndDirectories)
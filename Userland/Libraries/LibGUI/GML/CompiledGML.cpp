@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/Object.h>
+#include <LibGUI/GML/CompiledGML.h>
+#include <LibGUI/Layout.h>
+#include <LibGUI/Widget.h>
+
+namespace GUI::GML {
+
+ErrorOr<NonnullRefPtr<Widget>> construct_registered_widget(StringView class_name)
+{
+    auto* registration = Core::ObjectClassRegistration::find(class_name);
+    if (!registration) {
+        dbgln("Class '{}' not registered", class_name);
+        return Error::from_string_literal("Class not registered");
+    }
+    if (!registration->is_derived_from(*Core::ObjectClassRegistration::find("GUI::Widget"sv))) {
+        dbgln("Invalid widget class: '{}'", class_name);
+        return Error::from_string_literal("Invalid widget class");
+    }
+    return static_ptr_cast<Widget>(TRY(registration->construct()));
+}
+
+ErrorOr<NonnullRefPtr<Layout>> construct_registered_layout(StringView class_name)
+{
+    auto* registration = Core::ObjectClassRegistration::find(class_name);
+    if (!registration) {
+        dbgln("Unknown layout class: '{}'", class_name);
+        return Error::from_string_literal("Unknown layout class");
+    }
+    if (!registration->is_derived_from(*Core::ObjectClassRegistration::find("GUI::Layout"sv))) {
+        dbgln("Invalid layout class: '{}'", class_name);
+        return Error::from_string_literal("Invalid layout class");
+    }
+    return static_ptr_cast<Layout>(TRY(registration->construct()));
+}
+
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonValue.h>
+#include <AK/StdLibExtras.h>
+#include <AK/StringView.h>
+#include <AK/Try.h>
+#include <LibGUI/Forward.h>
+
+// Support for the C++ that compile_gml_to_cpp() generates from GML files with the GMLCompiler.
+
+// Sets a property of a widget or layout to a value from a GML file. If the object has a setter of the same name
+// that takes the value as it is, it is called directly. Otherwise, we fall back to the registered property, which
+// also converts values like "CenterLeft" into the enum the setter takes.
+#define GML_SET_PROPERTY(object, property_name, value, json_value)                                 \
+    TRY([&](auto& object_) -> ErrorOr<void> {                                                      \
+        if constexpr (requires { object_.set_##property_name(value); }) {                          \
+            using ResultType = decltype(object_.set_##property_name(value));                       \
+            if constexpr (IsSpecializationOf<ResultType, ErrorOr>)                                 \
+                TRY(object_.set_##property_name(value));                                           \
+            else                                                                                   \
+                (void)object_.set_##property_name(value);                                          \
+        } else {                                                                                   \
+            object_.set_property(#property_name##sv, json_value);                                  \
+        }                                                                                          \
+        return {};                                                                                 \
+    }(object))
+
+namespace GUI::GML {
+
+// These construct the classes the GMLCompiler doesn't know the headers of, by looking up their registrations.
+ErrorOr<NonnullRefPtr<Widget>> construct_registered_widget(StringView class_name);
+ErrorOr<NonnullRefPtr<Layout>> construct_registered_layout(StringView class_name);
+
+}
@@ -42,6 +42,27 @@ void HeaderView::set_section_size(int section, int size)
     m_table_view.header_did_change_section_size({}, m_orientation, section, size);
 }
 
+void HeaderView::set_all_section_sizes(int size)
+{
+    int section_count = this->section_count();
+    if (section_count == 0)
+        return;
+    // This makes room for the data of every section.
+    section_data(section_count - 1);
+
+    bool did_change = false;
+    for (int section = 0; section < section_count; ++section) {
+        auto& data = m_section_data[section];
+        if (!data.visibility || data.size == size)
+            continue;
+        data.size = size;
+        data.has_initialized_size = true;
+        did_change = true;
+    }
+    if (did_change)
+        m_table_view.header_did_change_section_size({}, m_orientation, section_count - 1, size);
+}
+
 int HeaderView::section_size(int section) const
 {
     return section_data(section).size;
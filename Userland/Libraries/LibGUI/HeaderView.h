@@ -24,6 +24,8 @@ public:
     Model const* model() const;
 
     void set_section_size(int section, int size);
+    // Sets the size of every visible section, but only tells the view about it once.
+    void set_all_section_sizes(int size);
     int section_size(int section) const;
 
     void set_default_section_size(int section, int size);
@@ -37,30 +37,22 @@ bool IniSyntaxHighlighter::is_identifier(u64 token) const
     return ini_token == GUI::IniToken::Type::Name;
 }
 
-void IniSyntaxHighlighter::rehighlight(Palette const& palette)
+void IniSyntaxHighlighter::lex(Palette const& palette, StringView text, size_t start_line, Function<void(GUI::TextDocumentSpan)> callback)
 {
-    auto text = m_client->get_text();
     IniLexer lexer(text);
     auto tokens = lexer.lex();
 
-    Vector<GUI::TextDocumentSpan> spans;
     for (auto& token : tokens) {
         GUI::TextDocumentSpan span;
-        span.range.set_start({ token.m_start.line, token.m_start.column });
-        span.range.set_end({ token.m_end.line, token.m_end.column });
+        span.range.set_start({ start_line + token.m_start.line, token.m_start.column });
+        span.range.set_end({ start_line + token.m_end.line, token.m_end.column });
         auto style = style_for_token_type(palette, token.m_type);
         span.attributes.color = style.color;
         span.attributes.bold = style.bold;
         span.is_skippable = token.m_type == IniToken::Type::Whitespace;
         span.data = static_cast<u64>(token.m_type);
-        spans.append(span);
+        callback(move(span));
     }
-    m_client->do_set_spans(move(spans));
-
-    m_has_brace_buddies = false;
-    highlight_matching_token_pair();
-
-    m_client->do_update();
 }
 
 Vector<IniSyntaxHighlighter::MatchingTokenPair> IniSyntaxHighlighter::matching_token_pairs_impl() const
@@ -7,11 +7,11 @@
 
 #pragma once
 
-#include <LibSyntax/Highlighter.h>
+#include <LibSyntax/IncrementalHighlighter.h>
 
 namespace GUI {
 
-class IniSyntaxHighlighter final : public Syntax::Highlighter {
+class IniSyntaxHighlighter final : public Syntax::IncrementalHighlighter {
 public:
     IniSyntaxHighlighter() = default;
     virtual ~IniSyntaxHighlighter() override = default;
@@ -21,9 +21,9 @@ public:
     virtual Syntax::Language language() const override { return Syntax::Language::INI; }
     virtual Optional<StringView> comment_prefix() const override { return ";"sv; }
     virtual Optional<StringView> comment_suffix() const override { return {}; }
-    virtual void rehighlight(Palette const&) override;
 
 protected:
+    virtual void lex(Palette const&, StringView text, size_t start_line, Function<void(GUI::TextDocumentSpan)> callback) override;
     virtual Vector<MatchingTokenPair> matching_token_pairs_impl() const override;
     virtual bool token_types_equal(u64, u64) const override;
 };
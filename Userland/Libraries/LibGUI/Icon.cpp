@@ -6,8 +6,10 @@
  */
 
 #include <AK/DeprecatedString.h>
+#include <LibCore/System.h>
 #include <LibGUI/Icon.h>
 #include <LibGfx/Bitmap.h>
+#include <unistd.h>
 
 namespace GUI {
 
@@ -46,26 +48,56 @@ Icon::Icon(RefPtr<Gfx::Bitmap>&& bitmap1, RefPtr<Gfx::Bitmap>&& bitmap2)
     }
 }
 
-Gfx::Bitmap const* IconImpl::bitmap_for_size(int size) const
+Optional<int> IconImpl::best_size_for(int size) const
 {
-    auto it = m_bitmaps.find(size);
-    if (it != m_bitmaps.end())
-        return it->value.ptr();
+    if (m_bitmaps.contains(size) || m_unloaded_bitmap_paths.contains(size))
+        return size;
 
     int best_diff_so_far = INT32_MAX;
-    Gfx::Bitmap const* best_fit = nullptr;
-    for (auto& it : m_bitmaps) {
-        int abs_diff = abs(it.key - size);
+    Optional<int> best_fit;
+    auto consider = [&](int candidate) {
+        int abs_diff = abs(candidate - size);
         if (abs_diff < best_diff_so_far) {
             best_diff_so_far = abs_diff;
-            best_fit = it.value.ptr();
+            best_fit = candidate;
         }
-    }
+    };
+    for (auto& it : m_bitmaps)
+        consider(it.key);
+    for (auto& it : m_unloaded_bitmap_paths)
+        consider(it.key);
     return best_fit;
 }
 
+Gfx::Bitmap const* IconImpl::bitmap_for_size(int size) const
+{
+    for (;;) {
+        auto best_size = best_size_for(size);
+        if (!best_size.has_value())
+            return nullptr;
+        if (auto it = m_bitmaps.find(*best_size); it != m_bitmaps.end())
+            return it->value.ptr();
+
+        auto path = m_unloaded_bitmap_paths.take(*best_size).release_value();
+        auto bitmap_or_error = Gfx::Bitmap::load_from_file(path);
+        if (!bitmap_or_error.is_error()) {
+            m_bitmaps.set(*best_size, bitmap_or_error.release_value());
+            continue;
+        }
+        // Try the next best size instead.
+        dbgln("Unable to load icon bitmap {}: {}", path, bitmap_or_error.error());
+    }
+}
+
+void IconImpl::set_bitmap_path_for_size(int size, DeprecatedString path)
+{
+    m_bitmaps.remove(size);
+    m_unloaded_bitmap_paths.set(size, move(path));
+}
+
 void IconImpl::set_bitmap_for_size(int size, RefPtr<Gfx::Bitmap>&& bitmap)
 {
+    m_unloaded_bitmap_paths.remove(size);
     if (!bitmap) {
         m_bitmaps.remove(size);
         return;
@@ -80,19 +112,20 @@ Icon Icon::default_icon(StringView name)
 
 ErrorOr<Icon> Icon::try_create_default_icon(StringView name)
 {
-    RefPtr<Gfx::Bitmap> bitmap16;
-    RefPtr<Gfx::Bitmap> bitmap32;
-    if (auto bitmap_or_error = Gfx::Bitmap::load_from_file(DeprecatedString::formatted("/res/icons/16x16/{}.png", name)); !bitmap_or_error.is_error())
-        bitmap16 = bitmap_or_error.release_value();
-    if (auto bitmap_or_error = Gfx::Bitmap::load_from_file(DeprecatedString::formatted("/res/icons/32x32/{}.png", name)); !bitmap_or_error.is_error())
-        bitmap32 = bitmap_or_error.release_value();
-
-    if (!bitmap16 && !bitmap32) {
+    // Decoding the PNGs is what makes this expensive, and a lot of icons are never shown, so we only check that they exist.
+    auto impl = IconImpl::create();
+    for (int size : { 16, 32 }) {
+        auto path = DeprecatedString::formatted("/res/icons/{}x{}/{}.png", size, size, name);
+        if (!Core::System::access(path, R_OK).is_error())
+            impl->set_bitmap_path_for_size(size, move(path));
+    }
+
+    if (impl->sizes().is_empty()) {
         dbgln("Default icon not found: {}", name);
         return Error::from_string_literal("Default icon not found");
     }
 
-    return Icon(move(bitmap16), move(bitmap32));
+    return Icon(*impl);
 }
 
 }
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <AK/DeprecatedString.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/RefCounted.h>
@@ -23,17 +24,25 @@ public:
     Gfx::Bitmap const* bitmap_for_size(int) const;
     void set_bitmap_for_size(int, RefPtr<Gfx::Bitmap>&&);
 
+    // The bitmap is only loaded from `path` once something asks for it, which usually is the first paint that shows it.
+    void set_bitmap_path_for_size(int, DeprecatedString path);
+
     Vector<int> sizes() const
     {
         Vector<int> sizes;
         for (auto& it : m_bitmaps)
             sizes.append(it.key);
+        for (auto& it : m_unloaded_bitmap_paths)
+            sizes.append(it.key);
         return sizes;
     }
 
 private:
     IconImpl() = default;
-    HashMap<int, RefPtr<Gfx::Bitmap>> m_bitmaps;
+    Optional<int> best_size_for(int) const;
+
+    mutable HashMap<int, RefPtr<Gfx::Bitmap>> m_bitmaps;
+    mutable HashMap<int, DeprecatedString> m_unloaded_bitmap_paths;
 };
 
 class Icon {
@@ -76,9 +76,8 @@ void ImageWidget::load_from_file(StringView path)
     if (file_or_error.is_error())
         return;
 
-    auto& mapped_file = *file_or_error.value();
     auto mime_type = Core::guess_mime_type_based_on_filename(path);
-    m_image_decoder = Gfx::ImageDecoder::try_create_for_raw_bytes(mapped_file.bytes(), mime_type);
+    m_image_decoder = Gfx::ImageDecoder::try_create_for_mapped_file(file_or_error.release_value(), mime_type);
     VERIFY(m_image_decoder);
 
     auto frame = m_image_decoder->frame(0).release_value_but_fixme_should_propagate_errors();
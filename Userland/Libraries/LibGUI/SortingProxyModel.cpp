@@ -121,13 +121,17 @@ StringView SortingProxyModel::drag_data_type() const
     return source().drag_data_type();
 }
 
+Variant SortingProxyModel::sort_key(ModelIndex const& index) const
+{
+    auto data = index.data(m_sort_role);
+    if (data.is_string())
+        return data.as_string().to_lowercase();
+    return data;
+}
+
 bool SortingProxyModel::less_than(ModelIndex const& index1, ModelIndex const& index2) const
 {
-    auto data1 = index1.data(m_sort_role);
-    auto data2 = index2.data(m_sort_role);
-    if (data1.is_string() && data2.is_string())
-        return data1.as_string().to_lowercase() < data2.as_string().to_lowercase();
-    return data1 < data2;
+    return sort_key(index1) < sort_key(index2);
 }
 
 ModelIndex SortingProxyModel::index(int row, int column, ModelIndex const& parent) const
@@ -177,11 +181,16 @@ void SortingProxyModel::sort_mapping(Mapping& mapping, int column, SortOrder sor
         return;
     }
 
-    for (int i = 0; i < row_count; ++i)
+    // Getting the data from the source model is the expensive part, so we only do it once for every row, instead of in every comparison.
+    Vector<Variant> sort_keys;
+    sort_keys.ensure_capacity(row_count);
+    for (int i = 0; i < row_count; ++i) {
         mapping.source_rows[i] = i;
+        sort_keys.unchecked_append(sort_key(source().index(i, column, mapping.source_parent)));
+    }
 
     quick_sort(mapping.source_rows, [&](auto row1, auto row2) -> bool {
-        bool is_less_than = less_than(source().index(row1, column, mapping.source_parent), source().index(row2, column, mapping.source_parent));
+        bool is_less_than = sort_keys[row1] < sort_keys[row2];
         return sort_order == SortOrder::Ascending ? is_less_than : !is_less_than;
     });
 
@@ -206,17 +215,14 @@ void SortingProxyModel::sort_mapping(Mapping& mapping, int column, SortOrder sor
             }
 
             for (auto& index : selected_indices_in_source) {
-                for (size_t i = 0; i < mapping.source_rows.size(); ++i) {
-                    if (mapping.source_rows[i] == index.row()) {
-                        auto new_source_index = this->index(i, index.column(), mapping.source_parent);
-                        selection.add(new_source_index);
-                        // Update the view's cursor.
-                        auto cursor = view.cursor_index();
-                        if (cursor.is_valid() && cursor.parent() == mapping.source_parent)
-                            view.set_cursor(new_source_index, AbstractView::SelectionUpdate::None, false);
-                        break;
-                    }
-                }
+                if (!index.is_valid() || static_cast<size_t>(index.row()) >= mapping.proxy_rows.size())
+                    continue;
+                auto new_source_index = this->index(mapping.proxy_rows[index.row()], index.column(), mapping.source_parent);
+                selection.add(new_source_index);
+                // Update the view's cursor.
+                auto cursor = view.cursor_index();
+                if (cursor.is_valid() && cursor.parent() == mapping.source_parent)
+                    view.set_cursor(new_source_index, AbstractView::SelectionUpdate::None, false);
             }
         });
     });
@@ -38,7 +38,9 @@ public:
 
     virtual bool is_column_sortable(int column_index) const override;
 
-    virtual bool less_than(ModelIndex const&, ModelIndex const&) const;
+    // Indices are sorted by their sort keys, which is their data for the sort role, but with strings in lowercase.
+    Variant sort_key(ModelIndex const&) const;
+    bool less_than(ModelIndex const&, ModelIndex const&) const;
 
     ModelIndex map_to_source(ModelIndex const&) const;
     ModelIndex map_to_proxy(ModelIndex const&) const;
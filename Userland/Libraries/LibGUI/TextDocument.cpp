@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AllOf.h>
 #include <AK/Badge.h>
 #include <AK/CharacterTypes.h>
 #include <AK/QuickSort.h>
@@ -50,6 +51,8 @@ bool TextDocument::set_text(StringView text, AllowCallback allow_callback)
         set_text({});
     });
 
+    m_lines.ensure_capacity(text.count("\n"sv) + 1);
+
     size_t start_of_current_line = 0;
 
     auto add_line = [&](size_t current_position) -> bool {
@@ -166,16 +169,23 @@ TextDocumentLine::TextDocumentLine(TextDocument& document, StringView text)
     set_text(document, text);
 }
 
+void TextDocumentLine::did_change(TextDocument& document)
+{
+    static u64 s_last_version = 0;
+    m_version = ++s_last_version;
+    document.update_views({});
+}
+
 void TextDocumentLine::clear(TextDocument& document)
 {
     m_text.clear();
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocumentLine::set_text(TextDocument& document, Vector<u32> const text)
 {
     m_text = move(text);
-    document.update_views({});
+    did_change(document);
 }
 
 bool TextDocumentLine::set_text(TextDocument& document, StringView text)
@@ -189,9 +199,17 @@ bool TextDocumentLine::set_text(TextDocument& document, StringView text)
     if (!utf8_view.validate()) {
         return false;
     }
-    for (auto code_point : utf8_view)
-        m_text.append(code_point);
-    document.update_views({});
+    // Lines are allocated to fit exactly, as documents can have a lot of them.
+    if (all_of(text, is_ascii)) {
+        m_text.ensure_capacity(text.length());
+        for (auto byte : text)
+            m_text.unchecked_append(byte);
+    } else {
+        m_text.ensure_capacity(utf8_view.length());
+        for (auto code_point : utf8_view)
+            m_text.unchecked_append(code_point);
+    }
+    did_change(document);
     return true;
 }
 
@@ -200,7 +218,7 @@ void TextDocumentLine::append(TextDocument& document, u32 const* code_points, si
     if (length == 0)
         return;
     m_text.append(code_points, length);
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocumentLine::append(TextDocument& document, u32 code_point)
@@ -220,7 +238,7 @@ void TextDocumentLine::insert(TextDocument& document, size_t index, u32 code_poi
     } else {
         m_text.insert(index, code_point);
     }
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocumentLine::remove(TextDocument& document, size_t index)
@@ -230,7 +248,7 @@ void TextDocumentLine::remove(TextDocument& document, size_t index)
     } else {
         m_text.remove(index);
     }
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocumentLine::remove_range(TextDocument& document, size_t start, size_t length)
@@ -244,7 +262,7 @@ void TextDocumentLine::remove_range(TextDocument& document, size_t start, size_t
     for (size_t i = (start + length); i < m_text.size(); ++i)
         new_data.append(m_text[i]);
     m_text = move(new_data);
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocumentLine::keep_range(TextDocument& document, size_t start_index, size_t length)
@@ -257,13 +275,13 @@ void TextDocumentLine::keep_range(TextDocument& document, size_t start_index, si
         new_data.append(m_text[i]);
 
     m_text = move(new_data);
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocumentLine::truncate(TextDocument& document, size_t length)
 {
     m_text.resize(length);
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocument::append_line(NonnullOwnPtr<TextDocumentLine> line)
@@ -188,9 +188,16 @@ public:
     bool is_empty() const { return length() == 0; }
     size_t leading_spaces() const;
 
+    // Changes whenever the text of the line does, and is never the same for two lines, so that views can tell
+    // which lines they have to lay out again.
+    u64 version() const { return m_version; }
+
 private:
+    void did_change(TextDocument&);
+
     // NOTE: This vector is null terminated.
     Vector<u32> m_text;
+    u64 m_version { 0 };
 };
 
 class TextDocumentUndoCommand : public Command {
@@ -114,8 +114,7 @@ void TextEditor::set_text(StringView text, AllowCallback allow_callback)
 
     document().set_text(text, allow_callback);
 
-    update_content_size();
-    recompute_all_visual_lines();
+    update_visual_lines();
     if (is_single_line())
         set_cursor(0, line(0).length());
     else
@@ -1656,7 +1655,7 @@ void TextEditor::undefer_reflow()
     VERIFY(m_reflow_deferred);
     if (!--m_reflow_deferred) {
         if (m_reflow_requested) {
-            recompute_all_visual_lines();
+            update_visual_lines();
             scroll_cursor_into_view();
         }
     }
@@ -1717,8 +1716,7 @@ void TextEditor::leave_event(Core::Event&)
 
 void TextEditor::did_change(AllowCallback allow_callback)
 {
-    update_content_size();
-    recompute_all_visual_lines();
+    update_visual_lines();
     hide_autocomplete_if_needed();
     m_needs_rehighlight = true;
     if (on_change && allow_callback == AllowCallback::Yes)
@@ -1841,6 +1839,13 @@ void TextEditor::clear_selection()
 }
 
 void TextEditor::recompute_all_visual_lines()
+{
+    for (auto& visual_data : m_line_visual_data)
+        visual_data.line_version = 0;
+    update_visual_lines();
+}
+
+void TextEditor::update_visual_lines()
 {
     if (m_reflow_deferred) {
         m_reflow_requested = true;
@@ -1851,9 +1856,11 @@ void TextEditor::recompute_all_visual_lines()
 
     int y_offset = 0;
     for (size_t line_index = 0; line_index < line_count(); ++line_index) {
-        recompute_visual_lines(line_index);
-        m_line_visual_data[line_index].visual_rect.set_y(y_offset);
-        y_offset += m_line_visual_data[line_index].visual_rect.height();
+        auto& visual_data = m_line_visual_data[line_index];
+        if (visual_data.line_version != document().line(line_index).version())
+            recompute_visual_lines(line_index);
+        visual_data.visual_rect.set_y(y_offset);
+        y_offset += visual_data.visual_rect.height();
     }
 
     update_content_size();
@@ -1888,6 +1895,7 @@ void TextEditor::recompute_visual_lines(size_t line_index)
     auto& visual_data = m_line_visual_data[line_index];
 
     visual_data.visual_line_breaks.clear_with_capacity();
+    visual_data.line_version = line.version();
 
     int available_width = visible_text_rect_in_inner_coordinates().width();
 
@@ -1990,28 +1998,28 @@ void TextEditor::did_change_font()
 void TextEditor::document_did_append_line()
 {
     m_line_visual_data.append(make<LineVisualData>());
-    recompute_all_visual_lines();
+    update_visual_lines();
     update();
 }
 
 void TextEditor::document_did_remove_line(size_t line_index)
 {
     m_line_visual_data.remove(line_index);
-    recompute_all_visual_lines();
+    update_visual_lines();
     update();
 }
 
 void TextEditor::document_did_remove_all_lines()
 {
     m_line_visual_data.clear();
-    recompute_all_visual_lines();
+    update_visual_lines();
     update();
 }
 
 void TextEditor::document_did_insert_line(size_t line_index)
 {
     m_line_visual_data.insert(line_index, make<LineVisualData>());
-    recompute_all_visual_lines();
+    update_visual_lines();
     update();
 }
 
@@ -350,6 +350,8 @@ private:
     Gfx::IntRect gutter_rect_in_inner_coordinates() const;
     Gfx::IntRect visible_text_rect_in_inner_coordinates() const;
     void recompute_all_visual_lines();
+    // Only lays out the lines that changed since they were last laid out.
+    void update_visual_lines();
     void ensure_cursor_is_valid();
     void rehighlight_if_needed();
 
@@ -421,6 +423,8 @@ private:
     struct LineVisualData {
         Vector<size_t, 1> visual_line_breaks;
         Gfx::IntRect visual_rect;
+        // The TextDocumentLine::version() this was computed for, or 0 if it needs to be computed again.
+        u64 line_version { 0 };
     };
 
     NonnullOwnPtrVector<LineVisualData> m_line_visual_data;
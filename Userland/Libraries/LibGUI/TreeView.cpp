@@ -719,6 +719,7 @@ void TreeView::update_column_sizes()
         if (column == m_key_column && model.is_column_sortable(column))
             header_width += HeaderView::sorting_arrow_width + HeaderView::sorting_arrow_offset;
         int column_width = header_width;
+        int measured_row_count = 0;
         traverse_in_paint_order([&](ModelIndex const& index, Gfx::IntRect const&, Gfx::IntRect const&, int) {
             auto cell_data = model.index(index.row(), column, index.parent()).data();
             int cell_width = 0;
@@ -730,6 +731,8 @@ void TreeView::update_column_sizes()
                 cell_width = font().width(cell_data.to_deprecated_string());
             }
             column_width = max(column_width, cell_width);
+            if (++measured_row_count == max_rows_to_measure_for_column_sizes)
+                return IterationDecision::Break;
             return IterationDecision::Continue;
         });
 
@@ -740,6 +743,7 @@ void TreeView::update_column_sizes()
     if (tree_column == m_key_column && model.is_column_sortable(tree_column))
         tree_column_header_width += HeaderView::sorting_arrow_width + HeaderView::sorting_arrow_offset;
     int tree_column_width = tree_column_header_width;
+    int measured_row_count = 0;
     traverse_in_paint_order([&](ModelIndex const& index, Gfx::IntRect const&, Gfx::IntRect const&, int indent_level) {
         auto cell_data = model.index(index.row(), tree_column, index.parent()).data();
         int cell_width = 0;
@@ -748,6 +752,8 @@ void TreeView::update_column_sizes()
             cell_width += horizontal_padding() * 2 + indent_level * indent_width_in_pixels() + icon_size() / 2 + text_padding() * 2;
         }
         tree_column_width = max(tree_column_width, cell_width);
+        if (++measured_row_count == max_rows_to_measure_for_column_sizes)
+            return IterationDecision::Break;
         return IterationDecision::Continue;
     });
 
@@ -475,8 +475,11 @@ void Window::handle_multi_paint_event(MultiPaintEvent& event)
     else if (created_new_backing_store)
         set_current_backing_store(*m_back_store, true);
 
-    if (is_visible())
+    if (is_visible()) {
         ConnectionToWindowServer::the().async_did_finish_painting(m_window_id, rects);
+        if (auto* app = Application::the())
+            app->window_did_finish_painting({}, *this);
+    }
 }
 
 void Window::propagate_shortcuts_up_to_application(KeyEvent& event, Widget* widget)
@@ -1155,6 +1155,38 @@ static ErrorOr<void> uncompress_bmp_rle_data(BMPLoadingContext& context, ByteBuf
     VERIFY_NOT_REACHED();
 }
 
+static BitmapFormat bitmap_format_for(BMPLoadingContext const& context)
+{
+    // NOTE: If this is an BMP included in an ICO, the bitmap format will be converted to BGRA8888.
+    //       This is because images with less than 32 bits of color depth follow a particular format:
+    //       the image is encoded with a color mask (the "XOR mask") together with an opacity mask (the "AND mask") of 1 bit per pixel.
+    //       The height of the encoded image must be exactly twice the real height, before both masks are combined.
+    //       Bitmaps have no knowledge of this format as they do not store extra rows for the AND mask.
+    if (context.is_included_in_ico)
+        return BitmapFormat::BGRA8888;
+
+    switch (context.dib.core.bpp) {
+    case 1:
+        return BitmapFormat::Indexed1;
+    case 2:
+        return BitmapFormat::Indexed2;
+    case 4:
+        return BitmapFormat::Indexed4;
+    case 8:
+        return BitmapFormat::Indexed8;
+    case 16:
+        if (context.dib.info.masks.size() == 4)
+            return BitmapFormat::BGRA8888;
+        return BitmapFormat::BGRx8888;
+    case 24:
+        return BitmapFormat::BGRx8888;
+    case 32:
+        return BitmapFormat::BGRA8888;
+    default:
+        return BitmapFormat::Invalid;
+    }
+}
+
 static ErrorOr<void> decode_bmp_pixel_data(BMPLoadingContext& context)
 {
     if (context.state == BMPLoadingContext::State::Error)
@@ -1165,37 +1197,7 @@ static ErrorOr<void> decode_bmp_pixel_data(BMPLoadingContext& context)
 
     const u16 bits_per_pixel = context.dib.core.bpp;
 
-    BitmapFormat format = [&]() -> BitmapFormat {
-        // NOTE: If this is an BMP included in an ICO, the bitmap format will be converted to BGRA8888.
-        //       This is because images with less than 32 bits of color depth follow a particular format:
-        //       the image is encoded with a color mask (the "XOR mask") together with an opacity mask (the "AND mask") of 1 bit per pixel.
-        //       The height of the encoded image must be exactly twice the real height, before both masks are combined.
-        //       Bitmaps have no knowledge of this format as they do not store extra rows for the AND mask.
-        if (context.is_included_in_ico)
-            return BitmapFormat::BGRA8888;
-
-        switch (bits_per_pixel) {
-        case 1:
-            return BitmapFormat::Indexed1;
-        case 2:
-            return BitmapFormat::Indexed2;
-        case 4:
-            return BitmapFormat::Indexed4;
-        case 8:
-            return BitmapFormat::Indexed8;
-        case 16:
-            if (context.dib.info.masks.size() == 4)
-                return BitmapFormat::BGRA8888;
-            return BitmapFormat::BGRx8888;
-        case 24:
-            return BitmapFormat::BGRx8888;
-        case 32:
-            return BitmapFormat::BGRA8888;
-        default:
-            return BitmapFormat::Invalid;
-        }
-    }();
-
+    BitmapFormat format = bitmap_format_for(context);
     if (format == BitmapFormat::Invalid) {
         dbgln("BMP has invalid bpp of {}", bits_per_pixel);
         context.state = BMPLoadingContext::State::Error;
@@ -1203,7 +1205,7 @@ static ErrorOr<void> decode_bmp_pixel_data(BMPLoadingContext& context)
     }
 
     const u32 width = abs(context.dib.core.width);
-    const u32 height = !context.is_included_in_ico ? context.dib.core.height : (context.dib.core.height / 2);
+    const u32 height = !context.is_included_in_ico ? abs(context.dib.core.height) : (context.dib.core.height / 2);
 
     context.bitmap = TRY(Bitmap::create(format, { static_cast<int>(width), static_cast<int>(height) }));
 
@@ -1400,6 +1402,87 @@ static ErrorOr<void> decode_bmp_pixel_data(BMPLoadingContext& context)
     return {};
 }
 
+static bool can_decode_bmp_region(BMPLoadingContext const& context)
+{
+    // Only uncompressed rows all have the same size, which lets us seek straight to the ones we want.
+    if (context.is_included_in_ico)
+        return false;
+    auto compression = context.dib.info.compression;
+    return compression == Compression::RGB || compression == Compression::BITFIELDS || compression == Compression::ALPHABITFIELDS;
+}
+
+static ErrorOr<NonnullRefPtr<Bitmap>> decode_bmp_pixel_data_in_region(BMPLoadingContext& context, IntRect region)
+{
+    VERIFY(context.state >= BMPLoadingContext::State::ColorTableDecoded);
+    VERIFY(can_decode_bmp_region(context));
+
+    u16 const bits_per_pixel = context.dib.core.bpp;
+    BitmapFormat format = bitmap_format_for(context);
+    if (format == BitmapFormat::Invalid)
+        return Error::from_string_literal("BMP has invalid bpp");
+
+    u32 const width = abs(context.dib.core.width);
+    u32 const height = abs(context.dib.core.height);
+    bool const is_top_down = context.dib.core.height < 0;
+
+    region.intersect({ 0, 0, static_cast<int>(width), static_cast<int>(height) });
+    if (region.is_empty())
+        return Error::from_string_literal("BMP region lies outside of the image");
+
+    // Each row is padded to a multiple of 4 bytes.
+    size_t const row_size = ((static_cast<size_t>(width) * bits_per_pixel + 31) / 32) * 4;
+    if (context.data_offset + row_size * height > context.file_size)
+        return Error::from_string_literal("BMP pixel data is truncated");
+
+    auto bitmap = TRY(Bitmap::create(format, region.size()));
+
+    for (int y = region.top(); y <= region.bottom(); ++y) {
+        u32 stored_row = is_top_down ? y : height - 1 - y;
+        u8 const* row = context.file_bytes + context.data_offset + stored_row * row_size;
+        int destination_row = y - region.top();
+
+        for (int x = region.left(); x <= region.right(); ++x) {
+            int destination_column = x - region.left();
+            switch (bits_per_pixel) {
+            case 1:
+            case 2:
+            case 4: {
+                size_t bit = static_cast<size_t>(x) * bits_per_pixel;
+                u8 shift = 8 - bits_per_pixel - (bit % 8);
+                bitmap->scanline_u8(destination_row)[destination_column] = (row[bit / 8] >> shift) & ((1 << bits_per_pixel) - 1);
+                break;
+            }
+            case 8:
+                bitmap->scanline_u8(destination_row)[destination_column] = row[x];
+                break;
+            case 16: {
+                u8 const* pixel = row + x * 2;
+                bitmap->scanline(destination_row)[destination_column] = int_to_scaled_rgb(context, pixel[0] | (pixel[1] << 8));
+                break;
+            }
+            case 24: {
+                u8 const* pixel = row + x * 3;
+                bitmap->scanline(destination_row)[destination_column] = pixel[0] | (pixel[1] << 8) | (pixel[2] << 16);
+                break;
+            }
+            case 32: {
+                u8 const* pixel = row + x * 4;
+                u32 value = pixel[0] | (pixel[1] << 8) | (pixel[2] << 16) | (static_cast<u32>(pixel[3]) << 24);
+                bitmap->scanline(destination_row)[destination_column] = context.dib.info.masks.is_empty() ? value : int_to_scaled_rgb(context, value);
+                break;
+            }
+            default:
+                VERIFY_NOT_REACHED();
+            }
+        }
+    }
+
+    for (size_t i = 0; i < context.color_table.size(); ++i)
+        bitmap->set_palette_color(i, Color::from_rgb(context.color_table[i]));
+
+    return bitmap;
+}
+
 BMPImageDecoderPlugin::BMPImageDecoderPlugin(u8 const* data, size_t data_size, IncludedInICO is_included_in_ico)
 {
     m_context = make<BMPLoadingContext>();
@@ -1492,6 +1575,23 @@ ErrorOr<ImageFrameDescriptor> BMPImageDecoderPlugin::frame(size_t index)
     return ImageFrameDescriptor { m_context->bitmap, 0 };
 }
 
+ErrorOr<ImageFrameDescriptor> BMPImageDecoderPlugin::frame_region(size_t index, IntRect region)
+{
+    if (index > 0)
+        return Error::from_string_literal("BMPImageDecoderPlugin: Invalid frame index");
+
+    if (m_context->state == BMPLoadingContext::State::Error)
+        return Error::from_string_literal("BMPImageDecoderPlugin: Decoding failed");
+
+    if (m_context->state < BMPLoadingContext::State::ColorTableDecoded)
+        TRY(decode_bmp_color_table(*m_context));
+
+    if (m_context->state == BMPLoadingContext::State::PixelDataDecoded || !can_decode_bmp_region(*m_context))
+        return ImageDecoderPlugin::frame_region(index, region);
+
+    return ImageFrameDescriptor { TRY(decode_bmp_pixel_data_in_region(*m_context, region)), 0 };
+}
+
 ErrorOr<Optional<ReadonlyBytes>> BMPImageDecoderPlugin::icc_data()
 {
     return OptionalNone {};
@@ -36,6 +36,7 @@ public:
     virtual size_t loop_count() override;
     virtual size_t frame_count() override;
     virtual ErrorOr<ImageFrameDescriptor> frame(size_t index) override;
+    virtual ErrorOr<ImageFrameDescriptor> frame_region(size_t index, IntRect region) override;
     virtual ErrorOr<Optional<ReadonlyBytes>> icc_data() override;
 
 private:
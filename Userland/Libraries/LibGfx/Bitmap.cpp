@@ -145,7 +145,7 @@ ErrorOr<NonnullRefPtr<Bitmap>> Bitmap::load_from_fd_and_close(int fd, StringView
 {
     auto file = TRY(Core::MappedFile::map_from_fd_and_close(fd, path));
     auto mime_type = Core::guess_mime_type_based_on_filename(path);
-    if (auto decoder = ImageDecoder::try_create_for_raw_bytes(file->bytes(), mime_type)) {
+    if (auto decoder = ImageDecoder::try_create_for_mapped_file(move(file), mime_type)) {
         auto frame = TRY(decoder->frame(0));
         if (auto& bitmap = frame.image)
             return bitmap.release_nonnull();
@@ -91,6 +91,17 @@ enum RotationDirection {
     Clockwise
 };
 
+enum class ResamplingFilter {
+    // Averages the source pixels covered by each destination pixel. This is the cheapest filter that doesn't alias
+    // when downscaling, but it's equivalent to nearest neighbor when upscaling.
+    Box,
+    Bilinear,
+    // Catmull-Rom, which keeps edges sharper than bilinear, at twice the cost.
+    Bicubic,
+    // Box along axes that are downscaled to half their size or less, and bilinear along the others.
+    Automatic,
+};
+
 class Bitmap : public RefCounted<Bitmap> {
 public:
     [[nodiscard]] static ErrorOr<NonnullRefPtr<Bitmap>> create(BitmapFormat, IntSize, int intrinsic_scale = 1);
@@ -119,6 +130,9 @@ public:
     ErrorOr<NonnullRefPtr<Gfx::Bitmap>> flipped(Gfx::Orientation) const;
     ErrorOr<NonnullRefPtr<Gfx::Bitmap>> scaled(int sx, int sy) const;
     ErrorOr<NonnullRefPtr<Gfx::Bitmap>> scaled(float sx, float sy) const;
+    // Resamples the bitmap to the given size. The result is BGRA8888 if this bitmap has an alpha channel, or BGRx8888 otherwise.
+    // NOTE: This doesn't touch anything but the two bitmaps, so it's safe to call from a background thread.
+    ErrorOr<NonnullRefPtr<Gfx::Bitmap>> scaled_to(IntSize, ResamplingFilter = ResamplingFilter::Automatic) const;
     ErrorOr<NonnullRefPtr<Gfx::Bitmap>> cropped(Gfx::IntRect, Optional<BitmapFormat> new_bitmap_format = {}) const;
     ErrorOr<NonnullRefPtr<Gfx::Bitmap>> to_bitmap_backed_by_anonymous_buffer() const;
     [[nodiscard]] ErrorOr<ByteBuffer> serialize_to_byte_buffer() const;
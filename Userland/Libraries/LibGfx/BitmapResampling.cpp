@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Math.h>
+#include <AK/Vector.h>
+#include <LibGfx/Bitmap.h>
+
+// This is a separable convolution resampler: every row is first resampled horizontally, and then every column of that
+// vertically. When downscaling, the filters are stretched by the scale factor so that every source pixel contributes
+// to the result, which is what keeps large downscales from aliasing.
+
+namespace Gfx {
+
+namespace {
+
+// With 14 bits, the sums of weighted 16-bit channels can't overflow, even if a cubic filter's negative lobes make
+// the weights' magnitudes add up to more than 1.
+constexpr int weight_precision_bits = 14;
+constexpr i32 weight_rounding = 1 << (weight_precision_bits - 1);
+
+struct Filter {
+    float support;
+    float (*function)(float);
+};
+
+float box(float x)
+{
+    return x > -0.5f && x <= 0.5f ? 1.0f : 0.0f;
+}
+
+float triangle(float x)
+{
+    x = fabsf(x);
+    return x < 1.0f ? 1.0f - x : 0.0f;
+}
+
+// Catmull-Rom, i.e. the cubic convolution kernel with a = -0.5.
+float cubic(float x)
+{
+    constexpr float a = -0.5f;
+    x = fabsf(x);
+    if (x < 1.0f)
+        return ((a + 2.0f) * x - (a + 3.0f)) * x * x + 1.0f;
+    if (x < 2.0f)
+        return (((x - 5.0f) * x + 8.0f) * x - 4.0f) * a;
+    return 0.0f;
+}
+
+Filter filter_for(ResamplingFilter filter, int source_size, int destination_size)
+{
+    if (filter == ResamplingFilter::Automatic)
+        filter = source_size >= destination_size * 2 ? ResamplingFilter::Box : ResamplingFilter::Bilinear;
+
+    switch (filter) {
+    case ResamplingFilter::Box:
+        return { 0.5f, box };
+    case ResamplingFilter::Bilinear:
+        return { 1.0f, triangle };
+    case ResamplingFilter::Bicubic:
+        return { 2.0f, cubic };
+    case ResamplingFilter::Automatic:
+        break;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+// Which source pixels contribute to each destination pixel, and by how much.
+struct Contributions {
+    struct Span {
+        int first { 0 };
+        int count { 0 };
+        size_t weights_offset { 0 };
+    };
+    Vector<Span> spans;
+    Vector<i32> weights;
+};
+
+ErrorOr<Contributions> compute_contributions(int source_size, int destination_size, Filter filter)
+{
+    float scale = static_cast<float>(source_size) / static_cast<float>(destination_size);
+    float filter_scale = max(scale, 1.0f);
+    float support = filter.support * filter_scale;
+
+    Contributions contributions;
+    TRY(contributions.spans.try_ensure_capacity(destination_size));
+    Vector<float, 32> float_weights;
+
+    for (int i = 0; i < destination_size; ++i) {
+        float center = (static_cast<float>(i) + 0.5f) * scale;
+        int first = max(0, static_cast<int>(floorf(center - support)));
+        int last = min(source_size, static_cast<int>(ceilf(center + support)));
+
+        float_weights.clear_with_capacity();
+        float total = 0.0f;
+        for (int k = first; k < last; ++k) {
+            float weight = filter.function((static_cast<float>(k) - center + 0.5f) / filter_scale);
+            TRY(float_weights.try_append(weight));
+            total += weight;
+        }
+
+        // Skip the source pixels at either end that don't contribute anything.
+        size_t start = 0;
+        size_t end = float_weights.size();
+        while (start < end && float_weights[start] == 0.0f)
+            ++start;
+        while (end > start && float_weights[end - 1] == 0.0f)
+            --end;
+
+        // Only happens when the filter is narrower than a source pixel, in which case the nearest one is what we want.
+        if (start == end || total == 0.0f) {
+            int nearest = clamp(static_cast<int>(center), 0, source_size - 1);
+            contributions.spans.unchecked_append({ nearest, 1, contributions.weights.size() });
+            TRY(contributions.weights.try_append(1 << weight_precision_bits));
+            continue;
+        }
+
+        // Put whatever rounding the weights to fixed point lost onto the largest one, so they always add up to exactly 1,
+        // and an area of a single color stays that color.
+        size_t weights_offset = contributions.weights.size();
+        i32 fixed_point_total = 0;
+        size_t largest = weights_offset;
+        for (size_t k = start; k < end; ++k) {
+            auto weight = static_cast<i32>(roundf(float_weights[k] / total * (1 << weight_precision_bits)));
+            TRY(contributions.weights.try_append(weight));
+            fixed_point_total += weight;
+            if (weight > contributions.weights[largest])
+                largest = contributions.weights.size() - 1;
+        }
+        contributions.weights[largest] += (1 << weight_precision_bits) - fixed_point_total;
+
+        contributions.spans.unchecked_append({ first + static_cast<int>(start), static_cast<int>(end - start), weights_offset });
+    }
+
+    return contributions;
+}
+
+// A premultiplied pixel, with each channel scaled up to 0-65025 so that premultiplying loses no precision.
+// That keeps areas of a single translucent color the same color, which 8-bit premultiplied pixels wouldn't.
+using Pixel = Array<u16, 4>;
+
+ALWAYS_INLINE Pixel premultiply(ARGB32 argb)
+{
+    u16 alpha = argb >> 24;
+    return {
+        static_cast<u16>((argb & 0xff) * alpha),
+        static_cast<u16>(((argb >> 8) & 0xff) * alpha),
+        static_cast<u16>(((argb >> 16) & 0xff) * alpha),
+        static_cast<u16>(alpha * 255),
+    };
+}
+
+ALWAYS_INLINE Pixel pack(i32 const* sums)
+{
+    auto clamp_channel = [](i32 value) {
+        return static_cast<u16>(clamp(value >> weight_precision_bits, 0, 255 * 255));
+    };
+    // Filters with negative lobes can overshoot, but a premultiplied color channel can never exceed the alpha.
+    u16 alpha = clamp_channel(sums[3]);
+    return { min(clamp_channel(sums[0]), alpha), min(clamp_channel(sums[1]), alpha), min(clamp_channel(sums[2]), alpha), alpha };
+}
+
+ALWAYS_INLINE ARGB32 unpremultiply(Pixel pixel)
+{
+    u32 alpha = pixel[3];
+    if (alpha == 0)
+        return 0;
+    if (alpha == 255 * 255)
+        return 0xff000000 | ((pixel[0] + 127u) / 255) | (((pixel[1] + 127u) / 255) << 8) | (((pixel[2] + 127u) / 255) << 16);
+    auto channel = [&](size_t index) {
+        return (pixel[index] * 255u + alpha / 2) / alpha;
+    };
+    return channel(0) | (channel(1) << 8) | (channel(2) << 16) | (((alpha + 127) / 255) << 24);
+}
+
+}
+
+ErrorOr<NonnullRefPtr<Bitmap>> Bitmap::scaled_to(IntSize size, ResamplingFilter filter) const
+{
+    VERIFY(!size.is_empty());
+
+    bool has_alpha = has_alpha_channel() || is_indexed();
+    auto new_bitmap = TRY(Bitmap::create(has_alpha ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, size, scale()));
+
+    auto source_width = physical_width();
+    auto source_height = physical_height();
+    auto destination_width = new_bitmap->physical_width();
+    auto destination_height = new_bitmap->physical_height();
+
+    auto horizontal = TRY(compute_contributions(source_width, destination_width, filter_for(filter, source_width, destination_width)));
+    auto vertical = TRY(compute_contributions(source_height, destination_height, filter_for(filter, source_height, destination_height)));
+
+    // Only the source rows that some destination row samples from need to go through the horizontal pass.
+    int first_row = vertical.spans.first().first;
+    int last_row = vertical.spans.last().first + vertical.spans.last().count;
+
+    Vector<Pixel> source_row;
+    TRY(source_row.try_resize(source_width));
+    Vector<Pixel> intermediate;
+    TRY(intermediate.try_resize(static_cast<size_t>(destination_width) * (last_row - first_row)));
+
+    for (int y = first_row; y < last_row; ++y) {
+        if (format() == BitmapFormat::BGRA8888) {
+            auto const* scanline = this->scanline(y);
+            for (int x = 0; x < source_width; ++x)
+                source_row[x] = premultiply(scanline[x]);
+        } else if (format() == BitmapFormat::BGRx8888) {
+            auto const* scanline = this->scanline(y);
+            for (int x = 0; x < source_width; ++x)
+                source_row[x] = premultiply(scanline[x] | 0xff000000);
+        } else {
+            for (int x = 0; x < source_width; ++x)
+                source_row[x] = premultiply(get_pixel(x, y).value());
+        }
+
+        auto* intermediate_row = intermediate.data() + static_cast<size_t>(y - first_row) * destination_width;
+        for (int x = 0; x < destination_width; ++x) {
+            auto const& span = horizontal.spans[x];
+            auto const* weights = horizontal.weights.data() + span.weights_offset;
+            auto const* pixels = source_row.data() + span.first;
+            Array<i32, 4> sums { weight_rounding, weight_rounding, weight_rounding, weight_rounding };
+            for (int k = 0; k < span.count; ++k) {
+                for (size_t channel = 0; channel < 4; ++channel)
+                    sums[channel] += pixels[k][channel] * weights[k];
+            }
+            intermediate_row[x] = pack(sums.data());
+        }
+    }
+
+    // The vertical pass goes a whole row at a time, so that the innermost loop goes over consecutive pixels.
+    Vector<i32> sums;
+    TRY(sums.try_resize(static_cast<size_t>(destination_width) * 4));
+
+    for (int y = 0; y < destination_height; ++y) {
+        auto const& span = vertical.spans[y];
+        auto const* weights = vertical.weights.data() + span.weights_offset;
+
+        for (auto& sum : sums)
+            sum = weight_rounding;
+        for (int k = 0; k < span.count; ++k) {
+            auto const* row = intermediate.data() + static_cast<size_t>(span.first + k - first_row) * destination_width;
+            auto weight = weights[k];
+            for (int x = 0; x < destination_width; ++x) {
+                for (size_t channel = 0; channel < 4; ++channel)
+                    sums[x * 4 + channel] += row[x][channel] * weight;
+            }
+        }
+
+        auto* destination = new_bitmap->scanline(y);
+        for (int x = 0; x < destination_width; ++x)
+            destination[x] = unpremultiply(pack(sums.data() + x * 4));
+    }
+
+    return new_bitmap;
+}
+
+}
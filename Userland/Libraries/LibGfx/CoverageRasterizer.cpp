@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/InsertionSort.h>
+#include <AK/QuickSort.h>
+#include <LibGfx/CoverageRasterizer.h>
+
+namespace Gfx {
+
+CoverageRasterizer::CoverageRasterizer(IntRect bounds)
+    : m_bounds(bounds)
+{
+    m_rows.resize(max(bounds.height(), 0));
+}
+
+void CoverageRasterizer::add_cell(Vector<Cell>& cells, int x, float left, float right, float height)
+{
+    if (height == 0)
+        return;
+    // Edges at the right side of the bounds only affect pixels outside of them.
+    if (x >= m_bounds.x() + m_bounds.width())
+        return;
+    // left and right are where the edge enters and leaves the pixel, relative to its left side.
+    cells.append({ x, height, height * (left + right) * 0.5f });
+    m_cells_are_sorted = false;
+}
+
+void CoverageRasterizer::add_line_within_row(Vector<Cell>& cells, float x0, float x1, float height)
+{
+    if (x0 == x1) {
+        int x = static_cast<int>(floorf(x0));
+        add_cell(cells, x, x0 - x, x1 - x, height);
+        return;
+    }
+
+    // Split the edge where it crosses from one pixel into the next.
+    float height_per_x = height / (x1 - x0);
+    float x = x0;
+    if (x0 < x1) {
+        int cell = static_cast<int>(floorf(x0));
+        int last_cell = static_cast<int>(ceilf(x1)) - 1;
+        for (; cell < last_cell; ++cell) {
+            float next_x = cell + 1;
+            add_cell(cells, cell, x - cell, 1.0f, (next_x - x) * height_per_x);
+            x = next_x;
+        }
+        add_cell(cells, last_cell, x - last_cell, x1 - last_cell, (x1 - x) * height_per_x);
+    } else {
+        int cell = static_cast<int>(ceilf(x0)) - 1;
+        int last_cell = static_cast<int>(floorf(x1));
+        for (; cell > last_cell; --cell) {
+            float next_x = cell;
+            add_cell(cells, cell, x - cell, 0.0f, (next_x - x) * height_per_x);
+            x = next_x;
+        }
+        add_cell(cells, last_cell, x - last_cell, x1 - last_cell, (x1 - x) * height_per_x);
+    }
+}
+
+void CoverageRasterizer::add_line_within_bounds(FloatPoint from, FloatPoint to)
+{
+    float direction = 1.0f;
+    if (from.y() > to.y()) {
+        swap(from, to);
+        direction = -1.0f;
+    }
+
+    float left = m_bounds.x();
+    float right = m_bounds.x() + m_bounds.width();
+    float dx_per_y = (to.x() - from.x()) / (to.y() - from.y());
+    int first_row = max(static_cast<int>(floorf(from.y())), m_bounds.y());
+    int last_row = min(static_cast<int>(ceilf(to.y())) - 1, m_bounds.y() + m_bounds.height() - 1);
+
+    for (int y = first_row; y <= last_row; ++y) {
+        float y0 = max(from.y(), static_cast<float>(y));
+        float y1 = min(to.y(), static_cast<float>(y + 1));
+        if (y1 <= y0)
+            continue;
+        float x0 = clamp(from.x() + (y0 - from.y()) * dx_per_y, left, right);
+        float x1 = clamp(from.x() + (y1 - from.y()) * dx_per_y, left, right);
+        add_line_within_row(m_rows[y - m_bounds.y()], x0, x1, (y1 - y0) * direction);
+    }
+}
+
+void CoverageRasterizer::add_line(FloatPoint from, FloatPoint to)
+{
+    if (from.y() == to.y() || m_bounds.is_empty())
+        return;
+    if (!isfinite(from.x()) || !isfinite(from.y()) || !isfinite(to.x()) || !isfinite(to.y()))
+        return;
+
+    float left = m_bounds.x();
+    float right = m_bounds.x() + m_bounds.width();
+    float top = m_bounds.y();
+    float bottom = m_bounds.y() + m_bounds.height();
+
+    // Split the line where it crosses the sides of the bounds. The parts above, below or right of them don't affect any
+    // pixels inside of them, and the parts left of them affect those as if they were right on the left side.
+    Array<float, 6> splits { 0.0f, 1.0f };
+    size_t split_count = 2;
+    auto split_at = [&](float from_value, float to_value, float side) {
+        if ((from_value - side) * (to_value - side) < 0)
+            splits[split_count++] = (side - from_value) / (to_value - from_value);
+    };
+    split_at(from.x(), to.x(), left);
+    split_at(from.x(), to.x(), right);
+    split_at(from.y(), to.y(), top);
+    split_at(from.y(), to.y(), bottom);
+    insertion_sort(splits, 0, split_count - 1, [](auto a, auto b) { return a < b; });
+
+    auto point_at = [&](float t) {
+        return FloatPoint { from.x() + (to.x() - from.x()) * t, from.y() + (to.y() - from.y()) * t };
+    };
+
+    for (size_t i = 0; i + 1 < split_count; ++i) {
+        if (splits[i] == splits[i + 1])
+            continue;
+        auto middle = point_at((splits[i] + splits[i + 1]) * 0.5f);
+        if (middle.y() < top || middle.y() > bottom || middle.x() > right)
+            continue;
+        auto part_from = point_at(splits[i]);
+        auto part_to = point_at(splits[i + 1]);
+        if (middle.x() < left) {
+            part_from.set_x(left);
+            part_to.set_x(left);
+        }
+        add_line_within_bounds(part_from, part_to);
+    }
+}
+
+void CoverageRasterizer::add_path(Path const& path, FloatPoint offset)
+{
+    FloatPoint cursor;
+    Optional<FloatPoint> subpath_start;
+
+    auto add_line_from_cursor = [&](FloatPoint from, FloatPoint to) {
+        add_line(from + offset, to + offset);
+    };
+    auto close_subpath = [&] {
+        if (subpath_start.has_value() && cursor != *subpath_start)
+            add_line_from_cursor(cursor, *subpath_start);
+    };
+
+    for (auto const& segment : path.segments()) {
+        switch (segment.type()) {
+        case Segment::Type::MoveTo:
+            close_subpath();
+            subpath_start = segment.point();
+            cursor = segment.point();
+            continue;
+        case Segment::Type::LineTo:
+            add_line_from_cursor(cursor, segment.point());
+            break;
+        case Segment::Type::QuadraticBezierCurveTo: {
+            auto control = static_cast<QuadraticBezierCurveSegment const&>(segment).through();
+            Painter::for_each_line_segment_on_bezier_curve(control, cursor, segment.point(), [&](FloatPoint p0, FloatPoint p1) {
+                add_line_from_cursor(p0, p1);
+            });
+            break;
+        }
+        case Segment::Type::CubicBezierCurveTo: {
+            auto& curve = static_cast<CubicBezierCurveSegment const&>(segment);
+            Painter::for_each_line_segment_on_cubic_bezier_curve(curve.through_0(), curve.through_1(), cursor, segment.point(), [&](FloatPoint p0, FloatPoint p1) {
+                add_line_from_cursor(p0, p1);
+            });
+            break;
+        }
+        case Segment::Type::EllipticalArcTo: {
+            auto& arc = static_cast<EllipticalArcSegment const&>(segment);
+            Painter::for_each_line_segment_on_elliptical_arc(cursor, arc.point(), arc.center(), arc.radii(), arc.x_axis_rotation(), arc.theta_1(), arc.theta_delta(), [&](FloatPoint p0, FloatPoint p1) {
+                add_line_from_cursor(p0, p1);
+            });
+            break;
+        }
+        case Segment::Type::Invalid:
+            VERIFY_NOT_REACHED();
+        }
+
+        // A path that doesn't start with a move starts at the origin.
+        if (!subpath_start.has_value())
+            subpath_start = FloatPoint {};
+        cursor = segment.point();
+    }
+    close_subpath();
+}
+
+void CoverageRasterizer::sort_cells() const
+{
+    if (m_cells_are_sorted)
+        return;
+
+    for (auto& cells : m_rows) {
+        if (cells.size() < 2)
+            continue;
+        quick_sort(cells, [](auto const& a, auto const& b) { return a.x < b.x; });
+
+        // Merge the cells of the same pixel.
+        size_t merged_count = 0;
+        for (size_t i = 1; i < cells.size(); ++i) {
+            if (cells[i].x == cells[merged_count].x) {
+                cells[merged_count].cover += cells[i].cover;
+                cells[merged_count].area += cells[i].area;
+            } else {
+                cells[++merged_count] = cells[i];
+            }
+        }
+        cells.shrink(merged_count + 1);
+    }
+
+    m_cells_are_sorted = true;
+}
+
+}
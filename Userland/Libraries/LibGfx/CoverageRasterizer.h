@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Math.h>
+#include <AK/Vector.h>
+#include <LibGfx/Painter.h>
+#include <LibGfx/Path.h>
+#include <LibGfx/Point.h>
+#include <LibGfx/Rect.h>
+
+namespace Gfx {
+
+// Computes how much of each pixel a path covers, by accumulating the signed area that its edges enclose to their right,
+// like the rasterizers of FreeType and font-rs do. Only the pixels that edges pass through get a cell; the coverage of
+// those between cells follows from the cells to their left, so they're handed out as spans.
+class CoverageRasterizer {
+public:
+    // Only pixels within `bounds` get any coverage, but edges outside of them still count towards the pixels inside.
+    explicit CoverageRasterizer(IntRect bounds);
+
+    void add_line(FloatPoint from, FloatPoint to);
+
+    // Adds the edges of each subpath, and the edge that closes it if it's not closed already.
+    void add_path(Path const&, FloatPoint offset = {});
+
+    // Calls callback(IntPoint start, int width, float coverage) for each horizontal run of pixels with the same coverage,
+    // from top to bottom and left to right. Pixels that aren't covered at all are skipped.
+    template<typename Callback>
+    void for_each_span(Painter::WindingRule, Callback) const;
+
+private:
+    struct Cell {
+        int x { 0 };
+        // The signed height of the edges within this pixel. Everything to the right of them is covered by that much.
+        float cover { 0 };
+        // The part of `cover` that lies to the left of the edges within this pixel, which is not covered.
+        float area { 0 };
+    };
+
+    void add_line_within_bounds(FloatPoint from, FloatPoint to);
+    void add_line_within_row(Vector<Cell>&, float x0, float x1, float height);
+    void add_cell(Vector<Cell>&, int x, float left, float right, float height);
+    void sort_cells() const;
+
+    IntRect m_bounds;
+    mutable Vector<Vector<Cell>> m_rows;
+    mutable bool m_cells_are_sorted { true };
+};
+
+template<typename Callback>
+void CoverageRasterizer::for_each_span(Painter::WindingRule winding_rule, Callback callback) const
+{
+    // Anything less than this would round to zero coverage anyway, like the leftovers of floating point error.
+    static constexpr float minimum_coverage = 0.5f / 255;
+
+    auto coverage_for_winding = [winding_rule](float winding) {
+        winding = AK::fabs(winding);
+        if (winding_rule == Painter::WindingRule::Nonzero)
+            return min(winding, 1.0f);
+        winding = AK::fmod(winding, 2.0f);
+        return winding > 1.0f ? 2.0f - winding : winding;
+    };
+
+    sort_cells();
+
+    int right = m_bounds.x() + m_bounds.width();
+    for (size_t row = 0; row < m_rows.size(); ++row) {
+        auto const& cells = m_rows[row];
+        if (cells.is_empty())
+            continue;
+
+        int y = m_bounds.y() + static_cast<int>(row);
+        float winding = 0;
+        int x = m_bounds.x();
+        for (auto const& cell : cells) {
+            if (cell.x > x) {
+                if (auto coverage = coverage_for_winding(winding); coverage >= minimum_coverage)
+                    callback(IntPoint { x, y }, cell.x - x, coverage);
+            }
+            if (auto coverage = coverage_for_winding(winding + cell.cover - cell.area); coverage >= minimum_coverage)
+                callback(IntPoint { cell.x, y }, 1, coverage);
+            winding += cell.cover;
+            x = cell.x + 1;
+        }
+
+        // Edges that are right of the bounds were left out, so the last cells don't necessarily bring the winding back to zero.
+        if (x < right) {
+            if (auto coverage = coverage_for_winding(winding); coverage >= minimum_coverage)
+                callback(IntPoint { x, y }, right - x, coverage);
+        }
+    }
+}
+
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Vector.h>
+#include <LibGfx/Filters/ColorFilter.h>
+#include <LibGfx/Filters/FilterThreadPool.h>
+
+namespace Gfx {
+
+void ColorFilter::apply_to_row(Span<Color> row, Span<Color> scratch)
+{
+    if (m_amount >= 1.0f || amount_handled_in_filter()) {
+        convert_row(row);
+        return;
+    }
+
+    row.copy_to(scratch);
+    convert_row(row);
+    for (size_t i = 0; i < row.size(); ++i)
+        row[i] = scratch[i].mixed_with(row[i], m_amount);
+}
+
+void ColorFilter::apply_chain(ReadonlySpan<ColorFilter*> filters, Bitmap& target_bitmap, IntRect const& target_rect, Bitmap const& source_bitmap, IntRect const& source_rect)
+{
+    VERIFY(source_rect.size() == target_rect.size());
+    VERIFY(target_bitmap.rect().contains(target_rect));
+    VERIFY(source_bitmap.rect().contains(source_rect));
+
+    if (filters.is_empty() || source_rect.is_empty())
+        return;
+
+    auto width = static_cast<size_t>(source_rect.width());
+
+    auto apply_to_rows = [&](size_t first_row, size_t row_count) {
+        Vector<Color, 1024> row;
+        Vector<Color, 1024> scratch;
+        row.resize(width);
+        scratch.resize(width);
+
+        for (auto y = first_row; y < first_row + row_count; ++y) {
+            int source_y = y + source_rect.y();
+            int target_y = y + target_rect.y();
+
+            // Color has the same layout as the pixels of a BGRA8888 bitmap.
+            static_assert(sizeof(Color) == sizeof(ARGB32));
+            if (source_bitmap.format() == BitmapFormat::BGRA8888) {
+                __builtin_memcpy(static_cast<void*>(row.data()), source_bitmap.scanline(source_y) + source_rect.x(), width * sizeof(ARGB32));
+            } else {
+                for (size_t x = 0; x < width; ++x)
+                    row[x] = source_bitmap.get_pixel(x + source_rect.x(), source_y);
+            }
+
+            for (auto* filter : filters)
+                filter->apply_to_row(row.span(), scratch.span());
+
+            if (target_bitmap.format() == BitmapFormat::BGRA8888 || target_bitmap.format() == BitmapFormat::BGRx8888) {
+                __builtin_memcpy(target_bitmap.scanline(target_y) + target_rect.x(), row.data(), width * sizeof(ARGB32));
+            } else {
+                for (size_t x = 0; x < width; ++x)
+                    target_bitmap.set_pixel(x + target_rect.x(), target_y, row[x]);
+            }
+        }
+    };
+
+    // Rows that are read and written by different bands could race if the rectangles overlap in the same bitmap.
+    if (&target_bitmap == &source_bitmap && target_rect != source_rect && target_rect.intersects(source_rect)) {
+        apply_to_rows(0, source_rect.height());
+        return;
+    }
+    for_each_filter_band(source_rect.height(), move(apply_to_rows));
+}
+
+}
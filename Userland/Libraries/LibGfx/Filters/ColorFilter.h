@@ -7,6 +7,7 @@
 #pragma once
 
 #include "Filter.h"
+#include <AK/Span.h>
 
 namespace Gfx {
 
@@ -26,28 +27,27 @@ public:
 
     virtual void apply(Bitmap& target_bitmap, IntRect const& target_rect, Bitmap const& source_bitmap, IntRect const& source_rect) override
     {
-        VERIFY(source_rect.size() == target_rect.size());
-        VERIFY(target_bitmap.rect().contains(target_rect));
-        VERIFY(source_bitmap.rect().contains(source_rect));
-
-        for (auto y = 0; y < source_rect.height(); ++y) {
-            ssize_t source_y = y + source_rect.y();
-            ssize_t target_y = y + target_rect.y();
-            for (auto x = 0; x < source_rect.width(); ++x) {
-                ssize_t source_x = x + source_rect.x();
-                ssize_t target_x = x + target_rect.x();
-
-                auto source_pixel = source_bitmap.get_pixel(source_x, source_y);
-                auto target_color = convert_color(source_pixel);
-
-                target_bitmap.set_pixel(target_x, target_y, m_amount < 1.0f && !amount_handled_in_filter() ? source_pixel.mixed_with(target_color, m_amount) : target_color);
-            }
-        }
+        ColorFilter* filters[] = { this };
+        apply_chain(filters, target_bitmap, target_rect, source_bitmap, source_rect);
     }
 
+    // Applies the filters one after the other, but in a single pass over the bitmaps: each row goes through all of them while it's in the cache.
+    static void apply_chain(ReadonlySpan<ColorFilter*>, Bitmap& target_bitmap, IntRect const& target_rect, Bitmap const& source_bitmap, IntRect const& source_rect);
+
 protected:
     virtual Color convert_color(Color) = 0;
+
+    // Filters with a conversion that vectorizes can override this to convert a whole row at once.
+    virtual void convert_row(Span<Color> row)
+    {
+        for (auto& color : row)
+            color = convert_color(color);
+    }
+
     float m_amount { 1.0f };
+
+private:
+    void apply_to_row(Span<Color> row, Span<Color> scratch);
 };
 
 }
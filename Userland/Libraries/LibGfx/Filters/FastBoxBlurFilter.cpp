@@ -9,22 +9,24 @@
 #endif
 
 #include <AK/Function.h>
+#include <AK/SIMD.h>
 #include <AK/Vector.h>
 #include <LibGfx/Filters/FastBoxBlurFilter.h>
+#include <LibGfx/Filters/FilterThreadPool.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
 
 namespace Gfx {
 
-ALWAYS_INLINE static constexpr u8 red_value(Color color)
-{
-    return (color.alpha() == 0) ? 0xFF : color.red();
-}
-ALWAYS_INLINE static constexpr u8 green_value(Color color)
-{
-    return (color.alpha() == 0) ? 0xFF : color.green();
-}
-ALWAYS_INLINE static constexpr u8 blue_value(Color color)
+using AK::SIMD::u32x4;
+
+// Fully transparent pixels count as white.
+ALWAYS_INLINE static u32x4 to_vector(Color color)
 {
-    return (color.alpha() == 0) ? 0xFF : color.blue();
+    if (color.alpha() == 0)
+        return u32x4 { 0xff, 0xff, 0xff, 0 };
+    return u32x4 { color.red(), color.green(), color.blue(), color.alpha() };
 }
 
 FastBoxBlurFilter::FastBoxBlurFilter(Bitmap& bitmap)
@@ -37,99 +39,64 @@ void FastBoxBlurFilter::apply_single_pass(size_t radius)
     apply_single_pass(radius, radius);
 }
 
+// The red, green, blue and alpha sums are kept in the lanes of a vector, so that all four channels are summed at once.
+// Rows and then columns are independent of each other, so both passes split them across the filter thread pool.
 template<typename GetPixelFunction, typename SetPixelFunction>
 static void do_single_pass(int width, int height, size_t radius_x, size_t radius_y, GetPixelFunction get_pixel_function, SetPixelFunction set_pixel_function)
 {
-    int div_x = 2 * radius_x + 1;
-    int div_y = 2 * radius_y + 1;
+    u32 div_x = 2 * radius_x + 1;
+    u32 div_y = 2 * radius_y + 1;
 
     Vector<Color, 1024> intermediate;
     intermediate.resize(width * height);
 
     // First pass: vertical
-    for (int y = 0; y < height; ++y) {
-        size_t sum_red = 0;
-        size_t sum_green = 0;
-        size_t sum_blue = 0;
-        size_t sum_alpha = 0;
-
-        // Setup sliding window
-        for (int i = -(int)radius_x; i <= (int)radius_x; ++i) {
-            auto color_at_px = get_pixel_function(clamp(i, 0, width - 1), y);
-            sum_red += red_value(color_at_px);
-            sum_green += green_value(color_at_px);
-            sum_blue += blue_value(color_at_px);
-            sum_alpha += color_at_px.alpha();
-        }
-        // Slide horizontally
-        for (int x = 0; x < width; ++x) {
-            auto const index = y * width + x;
-            auto& current_intermediate = intermediate[index];
-            current_intermediate.set_red(sum_red / div_x);
-            current_intermediate.set_green(sum_green / div_x);
-            current_intermediate.set_blue(sum_blue / div_x);
-            current_intermediate.set_alpha(sum_alpha / div_x);
-
-            auto leftmost_x_coord = max(x - (int)radius_x, 0);
-            auto rightmost_x_coord = min(x + (int)radius_x + 1, width - 1);
-
-            auto leftmost_x_color = get_pixel_function(leftmost_x_coord, y);
-            auto rightmost_x_color = get_pixel_function(rightmost_x_coord, y);
-
-            sum_red -= red_value(leftmost_x_color);
-            sum_red += red_value(rightmost_x_color);
-            sum_green -= green_value(leftmost_x_color);
-            sum_green += green_value(rightmost_x_color);
-            sum_blue -= blue_value(leftmost_x_color);
-            sum_blue += blue_value(rightmost_x_color);
-            sum_alpha -= leftmost_x_color.alpha();
-            sum_alpha += rightmost_x_color.alpha();
-        }
-    }
+    for_each_filter_band(height, [&](size_t first_row, size_t row_count) {
+        for (int y = first_row; y < static_cast<int>(first_row + row_count); ++y) {
+            u32x4 sum {};
 
-    // Second pass: horizontal
-    for (int x = 0; x < width; ++x) {
-        size_t sum_red = 0;
-        size_t sum_green = 0;
-        size_t sum_blue = 0;
-        size_t sum_alpha = 0;
-
-        // Setup sliding window
-        for (int i = -(int)radius_y; i <= (int)radius_y; ++i) {
-            int offset = clamp(i, 0, height - 1) * width + x;
-            auto& current_intermediate = intermediate[offset];
-            sum_red += current_intermediate.red();
-            sum_green += current_intermediate.green();
-            sum_blue += current_intermediate.blue();
-            sum_alpha += current_intermediate.alpha();
+            // Setup sliding window
+            for (int i = -(int)radius_x; i <= (int)radius_x; ++i)
+                sum += to_vector(get_pixel_function(clamp(i, 0, width - 1), y));
+
+            // Slide horizontally
+            for (int x = 0; x < width; ++x) {
+                auto average = sum / div_x;
+                intermediate[y * width + x] = Color(average[0], average[1], average[2], average[3]);
+
+                auto leftmost_x_coord = max(x - (int)radius_x, 0);
+                auto rightmost_x_coord = min(x + (int)radius_x + 1, width - 1);
+
+                sum -= to_vector(get_pixel_function(leftmost_x_coord, y));
+                sum += to_vector(get_pixel_function(rightmost_x_coord, y));
+            }
         }
+    });
 
-        for (int y = 0; y < height; ++y) {
-            auto color = Color(
-                sum_red / div_y,
-                sum_green / div_y,
-                sum_blue / div_y,
-                sum_alpha / div_y);
-
-            set_pixel_function(x, y, color);
-
-            auto const bottommost_y_coord = min(y + (int)radius_y + 1, height - 1);
-            auto const bottom_index = x + bottommost_y_coord * width;
-            auto& bottom_intermediate = intermediate[bottom_index];
-            sum_red += bottom_intermediate.red();
-            sum_green += bottom_intermediate.green();
-            sum_blue += bottom_intermediate.blue();
-            sum_alpha += bottom_intermediate.alpha();
-
-            auto const topmost_y_coord = max(y - (int)radius_y, 0);
-            auto const top_index = x + topmost_y_coord * width;
-            auto& top_intermediate = intermediate[top_index];
-            sum_red -= top_intermediate.red();
-            sum_green -= top_intermediate.green();
-            sum_blue -= top_intermediate.blue();
-            sum_alpha -= top_intermediate.alpha();
+    // Second pass: horizontal
+    for_each_filter_band(width, [&](size_t first_column, size_t column_count) {
+        for (int x = first_column; x < static_cast<int>(first_column + column_count); ++x) {
+            // The intermediate pixels were already run through to_vector(), so their channels are used as they are.
+            auto channels = [&](int y) {
+                auto color = intermediate[y * width + x];
+                return u32x4 { color.red(), color.green(), color.blue(), color.alpha() };
+            };
+
+            u32x4 sum {};
+
+            // Setup sliding window
+            for (int i = -(int)radius_y; i <= (int)radius_y; ++i)
+                sum += channels(clamp(i, 0, height - 1));
+
+            for (int y = 0; y < height; ++y) {
+                auto average = sum / div_y;
+                set_pixel_function(x, y, Color(average[0], average[1], average[2], average[3]));
+
+                sum += channels(min(y + (int)radius_y + 1, height - 1));
+                sum -= channels(max(y - (int)radius_y, 0));
+            }
         }
-    }
+    });
 }
 
 // Based on the super fast blur algorithm by Quasimondo, explored here: https://stackoverflow.com/questions/21418892/understanding-super-fast-blur-algorithm
@@ -180,3 +147,5 @@ void FastBoxBlurFilter::apply_three_passes(size_t radius)
 }
 
 }
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGfx/Filters/FilterThreadPool.h>
+#include <LibThreading/ThreadPool.h>
+
+namespace Gfx {
+
+static Threading::ThreadPool* s_filter_thread_pool;
+
+void set_filter_thread_pool(Threading::ThreadPool* thread_pool)
+{
+    s_filter_thread_pool = thread_pool;
+}
+
+void for_each_filter_band(size_t total, Function<void(size_t first, size_t count)> const& callback, size_t minimum_band_size)
+{
+    if (total == 0)
+        return;
+
+    auto band_count = min(total / max<size_t>(minimum_band_size, 1), s_filter_thread_pool ? s_filter_thread_pool->worker_count() * 4 : 1);
+    if (band_count <= 1) {
+        callback(0, total);
+        return;
+    }
+
+    Threading::parallel_for(
+        band_count, [&](size_t band) {
+            auto first = band * total / band_count;
+            auto end = (band + 1) * total / band_count;
+            callback(first, end - first);
+        },
+        1, *s_filter_thread_pool);
+}
+
+}
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/Types.h>
+
+namespace Threading {
+class ThreadPool;
+}
+
+namespace Gfx {
+
+// Filters split their work into bands of rows or columns, which run on this pool if one has been set, and on the calling thread otherwise.
+void set_filter_thread_pool(Threading::ThreadPool*);
+
+// Calls callback(first, count) for consecutive bands that together cover [0, total), and returns once all of them are done.
+// Bands are at least minimum_band_size long, unless there's less than that in total.
+void for_each_filter_band(size_t total, Function<void(size_t first, size_t count)> const& callback, size_t minimum_band_size = 16);
+
+}
@@ -7,7 +7,11 @@
 #pragma once
 
 #include "Filter.h"
+#include <AK/Array.h>
+#include <AK/Optional.h>
 #include <AK/StringView.h>
+#include <AK/Vector.h>
+#include <LibGfx/Filters/FilterThreadPool.h>
 #include <LibGfx/Matrix.h>
 #include <LibGfx/Matrix4x4.h>
 
@@ -101,42 +105,102 @@ public:
 
         Bitmap* render_target_bitmap = (&target != &source) ? &target : apply_cache.m_target.ptr();
 
-        // FIXME: Help! I am naive!
         constexpr static ssize_t offset = N / 2;
-        for (auto i_ = 0; i_ < target_rect.width(); ++i_) {
-            ssize_t i = i_ + target_rect.x();
-            for (auto j_ = 0; j_ < target_rect.height(); ++j_) {
-                ssize_t j = j_ + target_rect.y();
-                FloatVector3 value(0, 0, 0);
-                for (auto k = 0l; k < (ssize_t)N; ++k) {
-                    auto ki = i + k - offset;
-                    if (ki < source_rect.x() || ki > source_rect.right()) {
-                        if (parameters.should_wrap())
-                            ki = (ki + source.size().width()) % source.size().width(); // TODO: fix up using source_rect
-                        else
-                            continue;
+
+        // Maps a coordinate of the kernel onto the source, or to -1 if it doesn't contribute.
+        auto source_x = [&](ssize_t ki) -> ssize_t {
+            if (ki < source_rect.x() || ki > source_rect.right()) {
+                if (!parameters.should_wrap())
+                    return -1;
+                ki = (ki + source.size().width()) % source.size().width(); // TODO: fix up using source_rect
+            }
+            return ki;
+        };
+        auto source_y = [&](ssize_t lj) -> ssize_t {
+            if (lj < source_rect.y() || lj > source_rect.bottom()) {
+                if (!parameters.should_wrap())
+                    return -1;
+                lj = (lj + source.size().height()) % source.size().height(); // TODO: fix up using source_rect
+            }
+            return lj;
+        };
+        auto pixel_value = [&](ssize_t x, ssize_t y) {
+            auto pixel = source.get_pixel(x, y);
+            return FloatVector3(pixel.red(), pixel.green(), pixel.blue());
+        };
+        auto set_result = [&](ssize_t i, ssize_t j, FloatVector3 value) {
+            value.clamp(0, 255);
+            render_target_bitmap->set_pixel(i, j, Color(value.x(), value.y(), value.z(), source.get_pixel(i + source_delta_x, j + source_delta_y).alpha()));
+        };
+
+        auto separated_kernel = separate_kernel(parameters.kernel());
+        size_t width = target_rect.width();
+
+        // Every row of the target only depends on the source, so the rows are split across the filter thread pool.
+        for_each_filter_band(target_rect.height(), [&](size_t first_row, size_t row_count) {
+            if (separated_kernel.has_value()) {
+                // Convolve every source row that this band reaches with the horizontal kernel, and then those results with the vertical one.
+                size_t horizontal_row_count = row_count + N - 1;
+                Vector<FloatVector3> horizontal_results;
+                horizontal_results.resize(horizontal_row_count * width);
+                Vector<bool> row_contributes;
+                row_contributes.resize(horizontal_row_count);
+
+                for (size_t row = 0; row < horizontal_row_count; ++row) {
+                    auto lj = source_y(static_cast<ssize_t>(first_row + row) + target_rect.y() - offset);
+                    row_contributes[row] = lj >= 0;
+                    if (lj < 0)
+                        continue;
+                    for (size_t i_ = 0; i_ < width; ++i_) {
+                        ssize_t i = i_ + target_rect.x();
+                        FloatVector3 value(0, 0, 0);
+                        for (auto k = 0l; k < (ssize_t)N; ++k) {
+                            auto ki = source_x(i + k - offset);
+                            if (ki >= 0)
+                                value = value + pixel_value(ki, lj) * separated_kernel->horizontal[k];
+                        }
+                        horizontal_results[row * width + i_] = value;
                     }
+                }
 
-                    for (auto l = 0l; l < (ssize_t)N; ++l) {
-                        auto lj = j + l - offset;
-                        if (lj < source_rect.y() || lj > source_rect.bottom()) {
-                            if (parameters.should_wrap())
-                                lj = (lj + source.size().height()) % source.size().height(); // TODO: fix up using source_rect
-                            else
-                                continue;
+                for (size_t j_ = first_row; j_ < first_row + row_count; ++j_) {
+                    ssize_t j = j_ + target_rect.y();
+                    for (size_t i_ = 0; i_ < width; ++i_) {
+                        FloatVector3 value(0, 0, 0);
+                        for (size_t l = 0; l < N; ++l) {
+                            auto row = j_ - first_row + l;
+                            if (row_contributes[row])
+                                value = value + horizontal_results[row * width + i_] * separated_kernel->vertical[l];
                         }
+                        set_result(i_ + target_rect.x(), j, value);
+                    }
+                }
+                return;
+            }
 
-                        auto pixel = source.get_pixel(ki, lj);
-                        FloatVector3 pixel_value(pixel.red(), pixel.green(), pixel.blue());
+            // FIXME: Help! I am naive!
+            for (size_t i_ = 0; i_ < width; ++i_) {
+                ssize_t i = i_ + target_rect.x();
+                for (auto j_ = first_row; j_ < first_row + row_count; ++j_) {
+                    ssize_t j = j_ + target_rect.y();
+                    FloatVector3 value(0, 0, 0);
+                    for (auto k = 0l; k < (ssize_t)N; ++k) {
+                        auto ki = source_x(i + k - offset);
+                        if (ki < 0)
+                            continue;
+
+                        for (auto l = 0l; l < (ssize_t)N; ++l) {
+                            auto lj = source_y(j + l - offset);
+                            if (lj < 0)
+                                continue;
 
-                        value = value + pixel_value * parameters.kernel().elements()[k][l];
+                            value = value + pixel_value(ki, lj) * parameters.kernel().elements()[k][l];
+                        }
                     }
+                    set_result(i, j, value);
                 }
-
-                value.clamp(0, 255);
-                render_target_bitmap->set_pixel(i, j, Color(value.x(), value.y(), value.z(), source.get_pixel(i + source_delta_x, j + source_delta_y).alpha()));
             }
-        }
+        });
 
         if (render_target_bitmap != &target) {
             // FIXME: Substitute for some sort of faster "blit" method.
@@ -149,6 +213,47 @@ public:
             }
         }
     }
+
+private:
+    struct SeparatedKernel {
+        Array<float, N> horizontal;
+        Array<float, N> vertical;
+    };
+
+    // A kernel that is the outer product of two vectors, like a Gaussian one, can be applied as a horizontal
+    // and then a vertical pass, which takes 2N instead of N*N multiplications per pixel.
+    static Optional<SeparatedKernel> separate_kernel(Gfx::Matrix<N, float> const& kernel)
+    {
+        auto const& elements = kernel.elements();
+
+        size_t pivot_k = 0;
+        size_t pivot_l = 0;
+        for (size_t k = 0; k < N; ++k) {
+            for (size_t l = 0; l < N; ++l) {
+                if (fabsf(elements[k][l]) > fabsf(elements[pivot_k][pivot_l])) {
+                    pivot_k = k;
+                    pivot_l = l;
+                }
+            }
+        }
+        auto pivot = elements[pivot_k][pivot_l];
+        if (pivot == 0.0f)
+            return {};
+
+        SeparatedKernel separated;
+        for (size_t i = 0; i < N; ++i) {
+            separated.horizontal[i] = elements[i][pivot_l];
+            separated.vertical[i] = elements[pivot_k][i] / pivot;
+        }
+
+        for (size_t k = 0; k < N; ++k) {
+            for (size_t l = 0; l < N; ++l) {
+                if (fabsf(elements[k][l] - separated.horizontal[k] * separated.vertical[l]) > fabsf(pivot) * 1e-5f)
+                    return {};
+            }
+        }
+        return separated;
+    }
 };
 
 }
@@ -12,12 +12,18 @@
 #include <AK/Array.h>
 #include <AK/IntegralMath.h>
 #include <AK/Math.h>
+#include <AK/SIMD.h>
 #include <AK/Vector.h>
+#include <LibGfx/Filters/FilterThreadPool.h>
 #include <LibGfx/Filters/StackBlurFilter.h>
 
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
 namespace Gfx {
 
 using uint = unsigned;
+using AK::SIMD::u32x4;
 
 constexpr size_t MAX_RADIUS = 256;
 
@@ -95,218 +101,107 @@ private:
     Vector<Color, 512> m_data;
 };
 
-// This is an implementation of StackBlur by Mario Klingemann (https://observablehq.com/@jobleonard/mario-klingemans-stackblur)
-// (Link is to a secondary source as the original site is now down)
-FLATTEN void StackBlurFilter::process_rgba(u8 radius, Color fill_color)
+ALWAYS_INLINE static u32x4 to_vector(Color color)
 {
-    // TODO: Implement a plain RGB version of this (if required)
-
-    if (radius == 0)
-        return;
-
-    fill_color = fill_color.with_alpha(0);
-
-    uint width = m_bitmap.width();
-    uint height = m_bitmap.height();
+    return u32x4 { color.red(), color.green(), color.blue(), color.alpha() };
+}
 
-    uint div = 2 * radius + 1;
+// Blurs `length` pixels that are `stride` apart, in place.
+// The red, green, blue and alpha sums are kept in the lanes of a vector, so that all four channels are summed at once.
+static void blur_line(ARGB32* pixels, size_t stride, uint length, uint radius, Color fill_color, BlurStack& blur_stack)
+{
     uint radius_plus_1 = radius + 1;
     uint sum_factor = radius_plus_1 * (radius_plus_1 + 1) / 2;
 
-    auto get_pixel = [&](int x, int y) {
-        auto color = m_bitmap.get_pixel<StorageFormat::BGRA8888>(x, y);
+    auto get_pixel = [&](uint i) {
+        auto color = Color::from_argb(pixels[i * stride]);
         if (color.alpha() == 0)
             return fill_color;
         return color;
     };
 
-    auto set_pixel = [&](int x, int y, Color color) {
-        return m_bitmap.set_pixel<StorageFormat::BGRA8888>(x, y, color);
-    };
-
-    BlurStack blur_stack { div };
     auto const stack_start = blur_stack.iterator_from_position(0);
     auto const stack_end = blur_stack.iterator_from_position(radius_plus_1);
     auto stack_iterator = stack_start;
 
-    auto const sum_mult = mult_table[radius - 1];
-    auto const sum_shift = shift_table[radius - 1];
-
-    for (uint y = 0; y < height; y++) {
-        stack_iterator = stack_start;
-
-        auto color = get_pixel(0, y);
-        for (uint i = 0; i < radius_plus_1; i++)
-            *(stack_iterator++) = color;
-
-        // All the sums here work to approximate a gaussian.
-        // Note: Only about 17 bits are actually used in each sum.
-        uint red_in_sum = 0;
-        uint green_in_sum = 0;
-        uint blue_in_sum = 0;
-        uint alpha_in_sum = 0;
-        uint red_out_sum = radius_plus_1 * color.red();
-        uint green_out_sum = radius_plus_1 * color.green();
-        uint blue_out_sum = radius_plus_1 * color.blue();
-        uint alpha_out_sum = radius_plus_1 * color.alpha();
-        uint red_sum = sum_factor * color.red();
-        uint green_sum = sum_factor * color.green();
-        uint blue_sum = sum_factor * color.blue();
-        uint alpha_sum = sum_factor * color.alpha();
-
-        for (uint i = 1; i <= radius; i++) {
-            auto color = get_pixel(min(i, width - 1), y);
-
-            auto bias = radius_plus_1 - i;
-            *stack_iterator = color;
-            red_sum += color.red() * bias;
-            green_sum += color.green() * bias;
-            blue_sum += color.blue() * bias;
-            alpha_sum += color.alpha() * bias;
-
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
-
-            ++stack_iterator;
-        }
+    uint const sum_mult = mult_table[radius - 1];
+    uint const sum_shift = shift_table[radius - 1];
+
+    auto color = get_pixel(0);
+    for (uint i = 0; i < radius_plus_1; i++)
+        *(stack_iterator++) = color;
+
+    // All the sums here work to approximate a gaussian.
+    // Note: Only about 17 bits are actually used in each sum.
+    u32x4 in_sum {};
+    u32x4 out_sum = radius_plus_1 * to_vector(color);
+    u32x4 sum = sum_factor * to_vector(color);
+
+    for (uint i = 1; i <= radius; i++) {
+        auto color = get_pixel(min(i, length - 1));
+        *stack_iterator = color;
+        sum += to_vector(color) * (radius_plus_1 - i);
+        in_sum += to_vector(color);
+        ++stack_iterator;
+    }
 
-        auto stack_in_iterator = stack_start;
-        auto stack_out_iterator = stack_end;
-
-        for (uint x = 0; x < width; x++) {
-            auto alpha = (alpha_sum * sum_mult) >> sum_shift;
-            if (alpha != 0)
-                set_pixel(x, y, Color((red_sum * sum_mult) >> sum_shift, (green_sum * sum_mult) >> sum_shift, (blue_sum * sum_mult) >> sum_shift, alpha));
-            else
-                set_pixel(x, y, fill_color);
-
-            red_sum -= red_out_sum;
-            green_sum -= green_out_sum;
-            blue_sum -= blue_out_sum;
-            alpha_sum -= alpha_out_sum;
-
-            red_out_sum -= stack_in_iterator->red();
-            green_out_sum -= stack_in_iterator->green();
-            blue_out_sum -= stack_in_iterator->blue();
-            alpha_out_sum -= stack_in_iterator->alpha();
-
-            auto color = get_pixel(min(x + radius_plus_1, width - 1), y);
-            *stack_in_iterator = color;
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
-
-            red_sum += red_in_sum;
-            green_sum += green_in_sum;
-            blue_sum += blue_in_sum;
-            alpha_sum += alpha_in_sum;
-
-            ++stack_in_iterator;
-
-            color = *stack_out_iterator;
-            red_out_sum += color.red();
-            green_out_sum += color.green();
-            blue_out_sum += color.blue();
-            alpha_out_sum += color.alpha();
-
-            red_in_sum -= color.red();
-            green_in_sum -= color.green();
-            blue_in_sum -= color.blue();
-            alpha_in_sum -= color.alpha();
-
-            ++stack_out_iterator;
-        }
+    auto stack_in_iterator = stack_start;
+    auto stack_out_iterator = stack_end;
+
+    for (uint i = 0; i < length; i++) {
+        u32x4 result = (sum * sum_mult) >> sum_shift;
+        if (result[3] != 0)
+            pixels[i * stride] = Color(result[0], result[1], result[2], result[3]).value();
+        else
+            pixels[i * stride] = fill_color.value();
+
+        sum -= out_sum;
+        out_sum -= to_vector(*stack_in_iterator);
+
+        auto color = get_pixel(min(i + radius_plus_1, length - 1));
+        *stack_in_iterator = color;
+        in_sum += to_vector(color);
+        sum += in_sum;
+        ++stack_in_iterator;
+
+        auto out_color = to_vector(*stack_out_iterator);
+        out_sum += out_color;
+        in_sum -= out_color;
+        ++stack_out_iterator;
     }
+}
 
-    for (uint x = 0; x < width; x++) {
-        stack_iterator = stack_start;
-
-        auto color = get_pixel(x, 0);
-        for (uint i = 0; i < radius_plus_1; i++)
-            *(stack_iterator++) = color;
-
-        uint red_in_sum = 0;
-        uint green_in_sum = 0;
-        uint blue_in_sum = 0;
-        uint alpha_in_sum = 0;
-        uint red_out_sum = radius_plus_1 * color.red();
-        uint green_out_sum = radius_plus_1 * color.green();
-        uint blue_out_sum = radius_plus_1 * color.blue();
-        uint alpha_out_sum = radius_plus_1 * color.alpha();
-        uint red_sum = sum_factor * color.red();
-        uint green_sum = sum_factor * color.green();
-        uint blue_sum = sum_factor * color.blue();
-        uint alpha_sum = sum_factor * color.alpha();
-
-        for (uint i = 1; i <= radius; i++) {
-            auto color = get_pixel(x, min(i, height - 1));
-
-            auto bias = radius_plus_1 - i;
-            *stack_iterator = color;
-            red_sum += color.red() * bias;
-            green_sum += color.green() * bias;
-            blue_sum += color.blue() * bias;
-            alpha_sum += color.alpha() * bias;
-
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
-
-            ++stack_iterator;
-        }
+// This is an implementation of StackBlur by Mario Klingemann (https://observablehq.com/@jobleonard/mario-klingemans-stackblur)
+// (Link is to a secondary source as the original site is now down)
+FLATTEN void StackBlurFilter::process_rgba(u8 radius, Color fill_color)
+{
+    // TODO: Implement a plain RGB version of this (if required)
 
-        auto stack_in_iterator = stack_start;
-        auto stack_out_iterator = stack_end;
-
-        for (uint y = 0; y < height; y++) {
-            auto alpha = (alpha_sum * sum_mult) >> sum_shift;
-            if (alpha != 0)
-                set_pixel(x, y, Color((red_sum * sum_mult) >> sum_shift, (green_sum * sum_mult) >> sum_shift, (blue_sum * sum_mult) >> sum_shift, alpha));
-            else
-                set_pixel(x, y, fill_color);
-
-            red_sum -= red_out_sum;
-            green_sum -= green_out_sum;
-            blue_sum -= blue_out_sum;
-            alpha_sum -= alpha_out_sum;
-
-            red_out_sum -= stack_in_iterator->red();
-            green_out_sum -= stack_in_iterator->green();
-            blue_out_sum -= stack_in_iterator->blue();
-            alpha_out_sum -= stack_in_iterator->alpha();
-
-            auto color = get_pixel(x, min(y + radius_plus_1, height - 1));
-            *stack_in_iterator = color;
-            red_in_sum += color.red();
-            green_in_sum += color.green();
-            blue_in_sum += color.blue();
-            alpha_in_sum += color.alpha();
-
-            red_sum += red_in_sum;
-            green_sum += green_in_sum;
-            blue_sum += blue_in_sum;
-            alpha_sum += alpha_in_sum;
-
-            ++stack_in_iterator;
-
-            color = *stack_out_iterator;
-            red_out_sum += color.red();
-            green_out_sum += color.green();
-            blue_out_sum += color.blue();
-            alpha_out_sum += color.alpha();
-
-            red_in_sum -= color.red();
-            green_in_sum -= color.green();
-            blue_in_sum -= color.blue();
-            alpha_in_sum -= color.alpha();
-
-            ++stack_out_iterator;
-        }
-    }
+    if (radius == 0)
+        return;
+
+    fill_color = fill_color.with_alpha(0);
+
+    uint width = m_bitmap.width();
+    uint height = m_bitmap.height();
+    uint div = 2 * radius + 1;
+    auto* pixels = m_bitmap.scanline(0);
+    size_t pitch = m_bitmap.pitch() / sizeof(ARGB32);
+
+    // Every row is blurred on its own, and then every column, so both passes split them across the filter thread pool.
+    for_each_filter_band(height, [&](size_t first_row, size_t row_count) {
+        BlurStack blur_stack { div };
+        for (size_t y = first_row; y < first_row + row_count; y++)
+            blur_line(pixels + y * pitch, 1, width, radius, fill_color, blur_stack);
+    });
+
+    for_each_filter_band(width, [&](size_t first_column, size_t column_count) {
+        BlurStack blur_stack { div };
+        for (size_t x = first_column; x < first_column + column_count; x++)
+            blur_line(pixels + x, pitch, height, radius, fill_color, blur_stack);
+    });
 }
 
 }
+
+#pragma GCC diagnostic pop
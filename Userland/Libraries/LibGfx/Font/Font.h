@@ -63,8 +63,10 @@ public:
     {
     }
 
-    Glyph(RefPtr<Bitmap> bitmap, float left_bearing, float advance, float ascent)
-        : m_bitmap(bitmap)
+    // The glyph is the part of `bitmap` within `bitmap_rect`, which lets many glyphs share one bitmap.
+    Glyph(RefPtr<Bitmap> bitmap, IntRect bitmap_rect, float left_bearing, float advance, float ascent)
+        : m_bitmap(move(bitmap))
+        , m_bitmap_rect(bitmap_rect)
         , m_left_bearing(left_bearing)
         , m_advance(advance)
         , m_ascent(ascent)
@@ -74,6 +76,7 @@ public:
     bool is_glyph_bitmap() const { return !m_bitmap; }
     GlyphBitmap glyph_bitmap() const { return m_glyph_bitmap; }
     RefPtr<Bitmap> bitmap() const { return m_bitmap; }
+    IntRect bitmap_rect() const { return m_bitmap_rect; }
     float left_bearing() const { return m_left_bearing; }
     float advance() const { return m_advance; }
     float ascent() const { return m_ascent; }
@@ -81,6 +84,7 @@ public:
 private:
     GlyphBitmap m_glyph_bitmap;
     RefPtr<Bitmap> m_bitmap;
+    IntRect m_bitmap_rect;
     float m_left_bearing;
     float m_advance;
     float m_ascent;
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGfx/Font/GlyphAtlas.h>
+
+namespace Gfx {
+
+GlyphAtlas::GlyphAtlas(int page_size, size_t memory_budget)
+    : m_page_size(page_size)
+    , m_memory_budget(memory_budget)
+{
+}
+
+Optional<IntRect> GlyphAtlas::Page::allocate(IntSize size)
+{
+    // Use the lowest shelf that is tall enough and has room left, unless it wastes too much of its height
+    // and we can still open a new shelf of just the right height.
+    Shelf* best_shelf = nullptr;
+    for (auto& shelf : shelves) {
+        if (shelf.height < size.height() || bitmap->width() - shelf.used_width < size.width())
+            continue;
+        if (!best_shelf || shelf.height < best_shelf->height)
+            best_shelf = &shelf;
+    }
+
+    bool best_shelf_wastes_space = best_shelf && best_shelf->height - size.height() > size.height() / 2;
+    bool can_open_shelf = bitmap->height() - used_height >= size.height() && bitmap->width() >= size.width();
+    if ((!best_shelf || best_shelf_wastes_space) && can_open_shelf) {
+        shelves.append({ .y = used_height, .height = size.height(), .used_width = 0 });
+        used_height += size.height();
+        best_shelf = &shelves.last();
+    }
+
+    if (!best_shelf)
+        return {};
+
+    IntRect rect { best_shelf->used_width, best_shelf->y, size.width(), size.height() };
+    best_shelf->used_width += size.width();
+    return rect;
+}
+
+GlyphAtlas::Page* GlyphAtlas::page_with_id(u32 id)
+{
+    for (auto& page : m_pages) {
+        if (page.id == id)
+            return &page;
+    }
+    return nullptr;
+}
+
+Optional<GlyphAtlas::Glyph> GlyphAtlas::find(GlyphIndexWithSubpixelOffset index)
+{
+    auto location = m_glyphs.get(index);
+    if (!location.has_value())
+        return {};
+    auto* page = page_with_id(location->page_id);
+    VERIFY(page);
+    page->last_used = ++m_use_counter;
+    return Glyph { page->bitmap, location->rect };
+}
+
+void GlyphAtlas::evict_least_recently_used_page()
+{
+    VERIFY(!m_pages.is_empty());
+    size_t least_recently_used = 0;
+    for (size_t i = 1; i < m_pages.size(); ++i) {
+        if (m_pages[i].last_used < m_pages[least_recently_used].last_used)
+            least_recently_used = i;
+    }
+
+    auto page_id = m_pages[least_recently_used].id;
+    m_glyphs.remove_all_matching([&](auto&, auto& location) { return location.page_id == page_id; });
+    m_size_in_bytes -= m_pages[least_recently_used].bitmap->size_in_bytes();
+    m_pages.remove(least_recently_used);
+}
+
+ErrorOr<GlyphAtlas::Page*> GlyphAtlas::add_page(IntSize glyph_size)
+{
+    IntSize page_size { max(m_page_size, glyph_size.width()), max(m_page_size, glyph_size.height()) };
+    auto bitmap = TRY(Bitmap::create(BitmapFormat::BGRA8888, page_size));
+
+    // Always keep the page we're adding, even if it's over the budget on its own.
+    while (!m_pages.is_empty() && m_size_in_bytes + bitmap->size_in_bytes() > m_memory_budget)
+        evict_least_recently_used_page();
+
+    m_size_in_bytes += bitmap->size_in_bytes();
+    TRY(m_pages.try_append(Page { .id = m_next_page_id++, .bitmap = move(bitmap), .shelves = {}, .used_height = 0, .last_used = 0 }));
+    return &m_pages.last();
+}
+
+ErrorOr<GlyphAtlas::Glyph> GlyphAtlas::add(GlyphIndexWithSubpixelOffset index, Bitmap const& glyph_bitmap)
+{
+    VERIFY(glyph_bitmap.format() == BitmapFormat::BGRA8888 || glyph_bitmap.format() == BitmapFormat::BGRx8888);
+    auto size = glyph_bitmap.size();
+
+    // The newest pages are the ones most likely to have room left.
+    Page* page = nullptr;
+    Optional<IntRect> rect;
+    for (size_t i = m_pages.size(); i > 0 && !rect.has_value(); --i) {
+        page = &m_pages[i - 1];
+        rect = page->allocate(size);
+    }
+    if (!rect.has_value()) {
+        page = TRY(add_page(size));
+        rect = page->allocate(size);
+        VERIFY(rect.has_value());
+    }
+
+    for (int y = 0; y < size.height(); ++y)
+        memcpy(page->bitmap->scanline(rect->y() + y) + rect->x(), glyph_bitmap.scanline(y), size.width() * sizeof(ARGB32));
+
+    page->last_used = ++m_use_counter;
+    TRY(m_glyphs.try_set(index, Location { page->id, *rect }));
+    return Glyph { page->bitmap, *rect };
+}
+
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Font/Font.h>
+#include <LibGfx/Rect.h>
+
+namespace Gfx {
+
+struct GlyphIndexWithSubpixelOffset {
+    u32 glyph_id;
+    GlyphSubpixelOffset subpixel_offset;
+
+    bool operator==(GlyphIndexWithSubpixelOffset const&) const = default;
+};
+
+}
+
+namespace AK {
+
+template<>
+struct Traits<Gfx::GlyphIndexWithSubpixelOffset> : public GenericTraits<Gfx::GlyphIndexWithSubpixelOffset> {
+    static unsigned hash(Gfx::GlyphIndexWithSubpixelOffset const& index)
+    {
+        return pair_int_hash(index.glyph_id, (index.subpixel_offset.x << 8) | index.subpixel_offset.y);
+    }
+};
+
+}
+
+namespace Gfx {
+
+// Packs the rasterized glyphs of one font at one size into a few shared bitmaps ("pages"), so text is drawn from a
+// handful of bitmaps instead of one per glyph. Glyphs are put on shelves, rows of glyphs of about the same height.
+// When adding a page would go over the memory budget, the page that was used the longest ago is dropped, along with
+// all the glyphs on it.
+// NOTE: Pages are never reused once they're dropped, so a glyph that is still being held on to stays valid.
+class GlyphAtlas {
+public:
+    static constexpr int default_page_size = 256;
+    static constexpr size_t default_memory_budget = 1 * MiB;
+
+    explicit GlyphAtlas(int page_size = default_page_size, size_t memory_budget = default_memory_budget);
+
+    struct Glyph {
+        NonnullRefPtr<Bitmap> page;
+        IntRect rect;
+    };
+
+    Optional<Glyph> find(GlyphIndexWithSubpixelOffset);
+
+    // Copies the glyph's bitmap into the atlas. Glyphs too large for a page get a page of their own.
+    ErrorOr<Glyph> add(GlyphIndexWithSubpixelOffset, Bitmap const&);
+
+    size_t page_count() const { return m_pages.size(); }
+    size_t glyph_count() const { return m_glyphs.size(); }
+    size_t size_in_bytes() const { return m_size_in_bytes; }
+
+private:
+    struct Shelf {
+        int y { 0 };
+        int height { 0 };
+        int used_width { 0 };
+    };
+
+    struct Page {
+        u32 id { 0 };
+        NonnullRefPtr<Bitmap> bitmap;
+        Vector<Shelf> shelves;
+        int used_height { 0 };
+        u64 last_used { 0 };
+
+        Optional<IntRect> allocate(IntSize);
+    };
+
+    struct Location {
+        u32 page_id { 0 };
+        IntRect rect;
+    };
+
+    Page* page_with_id(u32);
+    ErrorOr<Page*> add_page(IntSize);
+    void evict_least_recently_used_page();
+
+    int m_page_size { default_page_size };
+    size_t m_memory_budget { default_memory_budget };
+    size_t m_size_in_bytes { 0 };
+    u32 m_next_page_id { 0 };
+    u64 m_use_counter { 0 };
+    Vector<Page> m_pages;
+    HashMap<GlyphIndexWithSubpixelOffset, Location> m_glyphs;
+};
+
+}
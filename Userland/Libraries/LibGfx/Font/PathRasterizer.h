@@ -6,8 +6,8 @@
 
 #pragma once
 
-#include <AK/Vector.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/CoverageRasterizer.h>
 #include <LibGfx/Path.h>
 
 namespace Gfx {
@@ -19,10 +19,8 @@ public:
     RefPtr<Gfx::Bitmap> accumulate();
 
 private:
-    void draw_line(Gfx::FloatPoint, Gfx::FloatPoint);
-
     Gfx::IntSize m_size;
-    Vector<float> m_data;
+    CoverageRasterizer m_rasterizer;
 };
 
 }
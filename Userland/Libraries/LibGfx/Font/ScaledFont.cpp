@@ -32,8 +32,55 @@ ScaledFont::ScaledFont(NonnullRefPtr<VectorFont> font, float point_width, float
     };
 }
 
-float ScaledFont::width(StringView view) const { return unicode_view_width(Utf8View(view)); }
-float ScaledFont::width(Utf8View const& view) const { return unicode_view_width(view); }
+// Text that is measured over and over again is mostly made of words, which are only worth remembering if they're short.
+static constexpr size_t max_cached_text_length = 64;
+static constexpr size_t max_cached_text_width_count = 4096;
+
+u32 ScaledFont::glyph_id_for_code_point(u32 code_point) const
+{
+    // NOTE: Glyph id 0 is the missing glyph, so we use it to mark ASCII glyph ids we haven't looked up yet.
+    //       Looking up a missing ASCII glyph again is fine, as that's rare.
+    if (code_point < m_cached_ascii_glyph_ids.size()) {
+        auto& glyph_id = m_cached_ascii_glyph_ids[code_point];
+        if (glyph_id == 0)
+            glyph_id = m_font->glyph_id_for_code_point(code_point);
+        return glyph_id;
+    }
+
+    if (auto glyph_id = m_cached_glyph_ids.get(code_point); glyph_id.has_value())
+        return *glyph_id;
+    auto glyph_id = m_font->glyph_id_for_code_point(code_point);
+    m_cached_glyph_ids.set(code_point, glyph_id);
+    return glyph_id;
+}
+
+ScaledGlyphMetrics ScaledFont::glyph_metrics(u32 glyph_id) const
+{
+    if (auto metrics = m_cached_glyph_metrics.get(glyph_id); metrics.has_value())
+        return *metrics;
+    auto metrics = m_font->glyph_metrics(glyph_id, m_x_scale, m_y_scale);
+    m_cached_glyph_metrics.set(glyph_id, metrics);
+    return metrics;
+}
+
+float ScaledFont::cached_text_width(StringView text) const
+{
+    if (text.length() > max_cached_text_length)
+        return unicode_view_width(Utf8View(text));
+
+    auto hash = text.hash();
+    if (auto it = m_cached_text_widths.find(hash, [&](auto& entry) { return entry.key == text; }); it != m_cached_text_widths.end())
+        return it->value;
+
+    auto width = unicode_view_width(Utf8View(text));
+    if (m_cached_text_widths.size() >= max_cached_text_width_count)
+        m_cached_text_widths.clear();
+    m_cached_text_widths.set(text, width);
+    return width;
+}
+
+float ScaledFont::width(StringView view) const { return cached_text_width(view); }
+float ScaledFont::width(Utf8View const& view) const { return cached_text_width(view.as_string()); }
 float ScaledFont::width(Utf32View const& view) const { return unicode_view_width(view); }
 
 template<typename T>
@@ -60,16 +107,27 @@ ALWAYS_INLINE float ScaledFont::unicode_view_width(T const& view) const
     return longest_width;
 }
 
-RefPtr<Gfx::Bitmap> ScaledFont::rasterize_glyph(u32 glyph_id, GlyphSubpixelOffset subpixel_offset) const
+Optional<GlyphAtlas::Glyph> ScaledFont::rasterize_glyph(u32 glyph_id, GlyphSubpixelOffset subpixel_offset) const
 {
     GlyphIndexWithSubpixelOffset index { glyph_id, subpixel_offset };
-    auto glyph_iterator = m_cached_glyph_bitmaps.find(index);
-    if (glyph_iterator != m_cached_glyph_bitmaps.end())
-        return glyph_iterator->value;
+    if (auto glyph = m_glyph_atlas.find(index); glyph.has_value())
+        return glyph;
+    if (m_glyphs_without_bitmap.contains(index))
+        return {};
 
     auto glyph_bitmap = m_font->rasterize_glyph(glyph_id, m_x_scale, m_y_scale, subpixel_offset);
-    m_cached_glyph_bitmaps.set(index, glyph_bitmap);
-    return glyph_bitmap;
+    if (!glyph_bitmap) {
+        m_glyphs_without_bitmap.set(index);
+        return {};
+    }
+
+    auto glyph_or_error = m_glyph_atlas.add(index, *glyph_bitmap);
+    if (glyph_or_error.is_error()) {
+        // We're out of memory for the atlas, but we can still draw the glyph from the bitmap we just rasterized.
+        auto rect = glyph_bitmap->rect();
+        return GlyphAtlas::Glyph { glyph_bitmap.release_nonnull(), rect };
+    }
+    return glyph_or_error.release_value();
 }
 
 Gfx::Glyph ScaledFont::glyph(u32 code_point) const
@@ -80,9 +138,11 @@ Gfx::Glyph ScaledFont::glyph(u32 code_point) const
 Gfx::Glyph ScaledFont::glyph(u32 code_point, GlyphSubpixelOffset subpixel_offset) const
 {
     auto id = glyph_id_for_code_point(code_point);
-    auto bitmap = rasterize_glyph(id, subpixel_offset);
+    auto glyph = rasterize_glyph(id, subpixel_offset);
     auto metrics = glyph_metrics(id);
-    return Gfx::Glyph(bitmap, metrics.left_side_bearing, metrics.advance_width, metrics.ascender);
+    if (!glyph.has_value())
+        return Gfx::Glyph(RefPtr<Bitmap> {}, {}, metrics.left_side_bearing, metrics.advance_width, metrics.ascender);
+    return Gfx::Glyph(glyph->page, glyph->rect, metrics.left_side_bearing, metrics.advance_width, metrics.ascender);
 }
 
 float ScaledFont::glyph_left_bearing(u32 code_point) const
@@ -115,7 +175,12 @@ float ScaledFont::glyphs_horizontal_kerning(u32 left_code_point, u32 right_code_
     if (left_glyph_id == 0 || right_glyph_id == 0)
         return 0.f;
 
-    return m_font->glyphs_horizontal_kerning(left_glyph_id, right_glyph_id, m_x_scale);
+    auto glyph_pair = (static_cast<u64>(left_glyph_id) << 32) | right_glyph_id;
+    if (auto kerning = m_cached_kernings.get(glyph_pair); kerning.has_value())
+        return *kerning;
+    auto kerning = m_font->glyphs_horizontal_kerning(left_glyph_id, right_glyph_id, m_x_scale);
+    m_cached_kernings.set(glyph_pair, kerning);
+    return kerning;
 }
 
 u8 ScaledFont::glyph_fixed_width() const
@@ -6,9 +6,12 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/HashMap.h>
 #include <LibGfx/Bitmap.h>
+#include <AK/HashTable.h>
 #include <LibGfx/Font/Font.h>
+#include <LibGfx/Font/GlyphAtlas.h>
 #include <LibGfx/Font/VectorFont.h>
 
 #define POINTS_PER_INCH 72.0f
@@ -16,20 +19,13 @@
 
 namespace Gfx {
 
-struct GlyphIndexWithSubpixelOffset {
-    u32 glyph_id;
-    GlyphSubpixelOffset subpixel_offset;
-
-    bool operator==(GlyphIndexWithSubpixelOffset const&) const = default;
-};
-
 class ScaledFont final : public Gfx::Font {
 public:
     ScaledFont(NonnullRefPtr<VectorFont>, float point_width, float point_height, unsigned dpi_x = DEFAULT_DPI, unsigned dpi_y = DEFAULT_DPI);
-    u32 glyph_id_for_code_point(u32 code_point) const { return m_font->glyph_id_for_code_point(code_point); }
+    u32 glyph_id_for_code_point(u32 code_point) const;
     ScaledFontMetrics metrics() const { return m_font->metrics(m_x_scale, m_y_scale); }
-    ScaledGlyphMetrics glyph_metrics(u32 glyph_id) const { return m_font->glyph_metrics(glyph_id, m_x_scale, m_y_scale); }
-    RefPtr<Gfx::Bitmap> rasterize_glyph(u32 glyph_id, GlyphSubpixelOffset) const;
+    ScaledGlyphMetrics glyph_metrics(u32 glyph_id) const;
+    Optional<GlyphAtlas::Glyph> rasterize_glyph(u32 glyph_id, GlyphSubpixelOffset) const;
 
     // ^Gfx::Font
     virtual NonnullRefPtr<Font> clone() const override { return MUST(try_clone()); } // FIXME: clone() should not need to be implemented
@@ -43,7 +39,7 @@ public:
     virtual Gfx::Glyph glyph(u32 code_point) const override;
     virtual float glyph_left_bearing(u32 code_point) const override;
     virtual Glyph glyph(u32 code_point, GlyphSubpixelOffset) const override;
-    virtual bool contains_glyph(u32 code_point) const override { return m_font->glyph_id_for_code_point(code_point) > 0; }
+    virtual bool contains_glyph(u32 code_point) const override { return glyph_id_for_code_point(code_point) > 0; }
     virtual float glyph_width(u32 code_point) const override;
     virtual float glyph_or_emoji_width(u32 code_point) const override;
     virtual float glyphs_horizontal_kerning(u32 left_code_point, u32 right_code_point) const override;
@@ -75,23 +71,21 @@ private:
     float m_y_scale { 0.0f };
     float m_point_width { 0.0f };
     float m_point_height { 0.0f };
-    mutable HashMap<GlyphIndexWithSubpixelOffset, RefPtr<Gfx::Bitmap>> m_cached_glyph_bitmaps;
+    mutable GlyphAtlas m_glyph_atlas;
+    mutable HashTable<GlyphIndexWithSubpixelOffset> m_glyphs_without_bitmap;
+
+    // Looking glyphs up means digging through the font's tables, and layout and painting keep asking about the
+    // same characters and words, so we remember the answers.
+    mutable Array<u32, 128> m_cached_ascii_glyph_ids {};
+    mutable HashMap<u32, u32> m_cached_glyph_ids;
+    mutable HashMap<u32, ScaledGlyphMetrics> m_cached_glyph_metrics;
+    mutable HashMap<u64, float> m_cached_kernings;
+    mutable HashMap<DeprecatedString, float> m_cached_text_widths;
     Gfx::FontPixelMetrics m_pixel_metrics;
 
     template<typename T>
     float unicode_view_width(T const& view) const;
-};
-
-}
-
-namespace AK {
-
-template<>
-struct Traits<Gfx::GlyphIndexWithSubpixelOffset> : public GenericTraits<Gfx::GlyphIndexWithSubpixelOffset> {
-    static unsigned hash(Gfx::GlyphIndexWithSubpixelOffset const& index)
-    {
-        return pair_int_hash(index.glyph_id, (index.subpixel_offset.x << 8) | index.subpixel_offset.y);
-    }
+    float cached_text_width(StringView) const;
 };
 
 }
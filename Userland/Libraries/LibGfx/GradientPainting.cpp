@@ -8,6 +8,7 @@
 #include <LibGfx/Gradients.h>
 #include <LibGfx/PaintStyle.h>
 #include <LibGfx/Painter.h>
+#include <LibGfx/RowBlending.h>
 
 #if defined(AK_COMPILER_GCC)
 #    pragma GCC optimize("O3")
@@ -45,6 +46,15 @@ static float color_stop_step(ColorStop const& previous_stop, ColorStop const& ne
     return c;
 }
 
+static void write_gradient_row(Bitmap& target, IntPoint position, ReadonlySpan<ARGB32> pixels, bool requires_blending)
+{
+    auto* destination = target.scanline(position.y()) + position.x();
+    if (requires_blending)
+        blend_row(destination, pixels.data(), pixels.size(), { 256, true, target.has_alpha_channel() });
+    else
+        __builtin_memcpy(destination, pixels.data(), pixels.size() * sizeof(ARGB32));
+}
+
 enum class UsePremultipliedAlpha {
     Yes,
     No
@@ -77,6 +87,8 @@ public:
             if (gradient_color.alpha() < 255)
                 m_requires_blending = true;
         }
+
+        build_lookup_table();
     }
 
     Color color_blend(Color a, Color b, float amount) const
@@ -97,39 +109,107 @@ public:
         return m_gradient_line_colors[index];
     }
 
-    Color sample_color(float loc) const
+    // Note: The position is only used for dithering, so anything that stays the same for a pixel will do.
+    Color sample_color(float loc, IntPoint position) const
     {
         if (!isfinite(loc))
             return Color();
-        if (m_sample_scale != 1.0f)
-            loc *= m_sample_scale;
-        auto repeat_wrap_if_required = [&](i64 loc) {
-            if (m_repeating)
-                return (loc + m_start_offset) % static_cast<i64>(m_gradient_line_colors.size());
-            return loc;
-        };
-        auto int_loc = static_cast<i64>(floor(loc));
-        auto blend = loc - int_loc;
-        auto color = get_color(repeat_wrap_if_required(int_loc));
+        if (m_lookup_table.size() <= 1)
+            return loc < 0 ? m_color_stops.first().color : m_color_stops.last().color;
+
+        auto lookup_size = static_cast<i64>(m_lookup_table.size() - 1);
+        loc *= m_lookup_scale;
+        auto index = static_cast<i64>(floor(loc));
+        auto blend = loc - index;
+        if (m_repeating)
+            index = (index + m_start_offset * static_cast<i64>(m_lookup_steps)) % lookup_size;
+        if (index < 0)
+            return m_color_stops.first().color;
+        if (index >= lookup_size)
+            return m_color_stops.last().color;
+
+        auto const& entry = m_lookup_table[index];
+        auto const& next_entry = m_lookup_table[index + 1];
+        if (entry.dither_with_next)
+            return blend >= dither_threshold(position) ? next_entry.color : entry.color;
         // Blend between the two neighbouring colors (this fixes some nasty aliasing issues at small angles)
         if (blend >= 0.004f)
-            color = color_blend(color, get_color(repeat_wrap_if_required(int_loc + 1)), blend);
-        return color;
+            return color_blend(entry.color, next_entry.color, blend);
+        return entry.color;
+    }
+
+    bool requires_blending() const { return m_requires_blending; }
+
+    // Samples a row of pixels, starting at `start` relative to the gradient's rect.
+    void sample_row(Span<ARGB32> pixels, IntPoint start, auto location_transform) const
+    {
+        for (size_t i = 0; i < pixels.size(); ++i) {
+            auto position = start.translated(i, 0);
+            pixels[i] = sample_color(location_transform(position.x(), position.y()), position).value();
+        }
     }
 
     void paint_into_physical_rect(Painter& painter, IntRect rect, auto location_transform)
     {
         auto clipped_rect = rect.intersected(painter.clip_rect() * painter.scale());
         auto start_offset = clipped_rect.location() - rect.location();
+        Vector<ARGB32, 1024> row;
+        row.resize(clipped_rect.width());
         for (int y = 0; y < clipped_rect.height(); y++) {
-            for (int x = 0; x < clipped_rect.width(); x++) {
-                auto pixel = sample_color(location_transform(x + start_offset.x(), y + start_offset.y()));
-                painter.set_physical_pixel(clipped_rect.location().translated(x, y), pixel, m_requires_blending);
-            }
+            sample_row(row, start_offset.translated(0, y), location_transform);
+            write_gradient_row(*painter.target(), clipped_rect.location().translated(0, y), row, m_requires_blending);
         }
     }
 
 private:
+    // Short gradient lines get up to this many steps between each of their colors, which dithering between
+    // entries needs to be invisible. Long ones have few enough shades between their colors already.
+    static constexpr size_t max_lookup_table_size = 4096;
+    static constexpr size_t max_lookup_steps = 16;
+
+    // Each color of the gradient line is followed by the blends towards the next one, so that sampling only takes a lookup.
+    // The spots in between two entries are dithered, unless the entries are too far apart for that, like at a hard color stop.
+    void build_lookup_table()
+    {
+        auto color_count = m_gradient_line_colors.size();
+        if (color_count == 0)
+            return;
+        m_lookup_steps = clamp(max_lookup_table_size / color_count, 1, max_lookup_steps);
+        m_lookup_scale = m_sample_scale * m_lookup_steps;
+
+        auto lookup_size = color_count * m_lookup_steps;
+        m_lookup_table.resize(lookup_size + 1);
+        for (size_t i = 0; i < color_count; i++) {
+            auto color = m_gradient_line_colors[i];
+            auto next_color = m_repeating ? m_gradient_line_colors[(i + 1) % color_count] : get_color(i + 1);
+            for (size_t step = 0; step < m_lookup_steps; step++) {
+                auto blend = static_cast<float>(step) / m_lookup_steps;
+                m_lookup_table[i * m_lookup_steps + step].color = blend >= 0.004f ? color_blend(color, next_color, blend) : color;
+            }
+        }
+        m_lookup_table[lookup_size].color = m_repeating ? m_lookup_table[0].color : m_color_stops.last().color;
+
+        auto are_indistinguishable = [](Color a, Color b) {
+            auto channel_distance = [](u8 a, u8 b) { return a > b ? a - b : b - a; };
+            return channel_distance(a.red(), b.red()) <= 1 && channel_distance(a.green(), b.green()) <= 1
+                && channel_distance(a.blue(), b.blue()) <= 1 && channel_distance(a.alpha(), b.alpha()) <= 1;
+        };
+        for (size_t i = 0; i < lookup_size; i++)
+            m_lookup_table[i].dither_with_next = are_indistinguishable(m_lookup_table[i].color, m_lookup_table[i + 1].color);
+    }
+
+    // An ordered dither with a 4x4 Bayer matrix, which spreads out the thresholds of neighbouring pixels as evenly as possible.
+    static float dither_threshold(IntPoint position)
+    {
+        static constexpr u8 bayer_matrix[4][4] = {
+            { 0, 8, 2, 10 },
+            { 12, 4, 14, 6 },
+            { 3, 11, 1, 9 },
+            { 15, 7, 13, 5 },
+        };
+        return (bayer_matrix[position.y() & 3][position.x() & 3] + 0.5f) / 16.0f;
+    }
+
     bool m_repeating { false };
     int m_start_offset { 0 };
     float m_sample_scale { 1 };
@@ -138,6 +218,14 @@ private:
 
     Vector<Color, 1024> m_gradient_line_colors;
     bool m_requires_blending = false;
+
+    struct LookupEntry {
+        Color color;
+        bool dither_with_next { false };
+    };
+    Vector<LookupEntry> m_lookup_table;
+    size_t m_lookup_steps { 1 };
+    float m_lookup_scale { 1 };
 };
 
 template<typename TransformFunction>
@@ -153,10 +241,19 @@ struct Gradient {
         m_gradient_line.paint_into_physical_rect(painter, rect, m_transform_function);
     }
 
+    bool requires_blending() const { return m_gradient_line.requires_blending(); }
+
+    // Paints the whole gradient into a bitmap of the size of its rect.
+    void paint_into_bitmap(Bitmap& bitmap) const
+    {
+        for (int y = 0; y < bitmap.height(); y++)
+            m_gradient_line.sample_row({ bitmap.scanline(y), static_cast<size_t>(bitmap.width()) }, { 0, y }, m_transform_function);
+    }
+
     PaintStyle::SamplerFunction sample_function()
     {
         return [this](IntPoint point) {
-            return m_gradient_line.sample_color(m_transform_function(point.x(), point.y()));
+            return m_gradient_line.sample_color(m_transform_function(point.x(), point.y()), point);
         };
     }
 
@@ -232,13 +329,123 @@ static auto create_radial_gradient(IntRect const& physical_rect, ReadonlySpan<Co
     };
 }
 
+// Backgrounds are usually repainted without their gradients changing, so the larger ones are kept around as bitmaps.
+class GradientCache {
+public:
+    struct Key {
+        enum class Type {
+            Linear,
+            Conic,
+            Radial,
+        };
+        Type type;
+        IntSize size;
+        Vector<ColorStop, 8> color_stops;
+        float angle { 0 };
+        FloatPoint center;
+        IntSize radial_size;
+        Optional<float> repeat_length;
+
+        bool operator==(Key const&) const = default;
+    };
+
+    static GradientCache& the()
+    {
+        static GradientCache cache;
+        return cache;
+    }
+
+    // Painting the whole gradient only pays off if most of it is visible, and it's big enough to be slow to paint.
+    static bool should_cache(IntRect const& physical_rect, IntRect const& visible_rect)
+    {
+        auto area = static_cast<size_t>(physical_rect.width()) * physical_rect.height();
+        auto visible_area = static_cast<size_t>(visible_rect.width()) * visible_rect.height();
+        return area >= minimum_area && area * sizeof(ARGB32) <= max_size_in_bytes / 4 && visible_area * 2 >= area;
+    }
+
+    struct Entry {
+        Key key;
+        NonnullRefPtr<Bitmap> bitmap;
+        bool requires_blending { false };
+        u64 last_used { 0 };
+    };
+
+    Entry const* find(Key const& key)
+    {
+        for (auto& entry : m_entries) {
+            if (entry.key == key) {
+                entry.last_used = ++m_use_counter;
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    Entry const& add(Key key, NonnullRefPtr<Bitmap> bitmap, bool requires_blending)
+    {
+        m_size_in_bytes += bitmap->size_in_bytes();
+        while (m_size_in_bytes > max_size_in_bytes && !m_entries.is_empty()) {
+            size_t least_recently_used = 0;
+            for (size_t i = 1; i < m_entries.size(); i++) {
+                if (m_entries[i].last_used < m_entries[least_recently_used].last_used)
+                    least_recently_used = i;
+            }
+            m_size_in_bytes -= m_entries[least_recently_used].bitmap->size_in_bytes();
+            m_entries.remove(least_recently_used);
+        }
+        m_entries.append({ move(key), move(bitmap), requires_blending, ++m_use_counter });
+        return m_entries.last();
+    }
+
+private:
+    static constexpr size_t minimum_area = 128 * 128;
+    static constexpr size_t max_size_in_bytes = 32 * MiB;
+
+    Vector<Entry> m_entries;
+    size_t m_size_in_bytes { 0 };
+    u64 m_use_counter { 0 };
+};
+
+template<typename CreateGradient>
+static void paint_gradient(Painter& painter, IntRect const& physical_rect, GradientCache::Key key, CreateGradient create_gradient)
+{
+    auto visible_rect = physical_rect.intersected(painter.clip_rect() * painter.scale());
+    if (visible_rect.is_empty())
+        return;
+    if (!GradientCache::should_cache(physical_rect, visible_rect)) {
+        create_gradient().paint(painter, physical_rect);
+        return;
+    }
+
+    auto& cache = GradientCache::the();
+    auto const* entry = cache.find(key);
+    if (!entry) {
+        auto gradient = create_gradient();
+        auto bitmap_or_error = Bitmap::create(BitmapFormat::BGRA8888, physical_rect.size());
+        if (bitmap_or_error.is_error()) {
+            gradient.paint(painter, physical_rect);
+            return;
+        }
+        gradient.paint_into_bitmap(*bitmap_or_error.value());
+        entry = &cache.add(move(key), bitmap_or_error.release_value(), gradient.requires_blending());
+    }
+
+    auto& target = *painter.target();
+    auto offset = visible_rect.location() - physical_rect.location();
+    for (int y = 0; y < visible_rect.height(); y++) {
+        auto const* row = entry->bitmap->scanline(offset.y() + y) + offset.x();
+        write_gradient_row(target, visible_rect.location().translated(0, y), { row, static_cast<size_t>(visible_rect.width()) }, entry->requires_blending);
+    }
+}
+
 void Painter::fill_rect_with_linear_gradient(IntRect const& rect, ReadonlySpan<ColorStop> color_stops, float angle, Optional<float> repeat_length)
 {
     auto a_rect = to_physical(rect);
-    if (a_rect.intersected(clip_rect() * scale()).is_empty())
-        return;
-    auto linear_gradient = create_linear_gradient(a_rect, color_stops, angle, repeat_length);
-    linear_gradient.paint(*this, a_rect);
+    GradientCache::Key key { GradientCache::Key::Type::Linear, a_rect.size(), {}, angle, {}, {}, repeat_length };
+    key.color_stops.append(color_stops.data(), color_stops.size());
+    paint_gradient(*this, a_rect, move(key), [&] {
+        return create_linear_gradient(a_rect, color_stops, angle, repeat_length);
+    });
 }
 
 static FloatPoint pixel_center(IntPoint point)
@@ -249,21 +456,23 @@ static FloatPoint pixel_center(IntPoint point)
 void Painter::fill_rect_with_conic_gradient(IntRect const& rect, ReadonlySpan<ColorStop> color_stops, IntPoint center, float start_angle, Optional<float> repeat_length)
 {
     auto a_rect = to_physical(rect);
-    if (a_rect.intersected(clip_rect() * scale()).is_empty())
-        return;
     // Translate position/center to the center of the pixel (avoids some funky painting)
     auto center_point = pixel_center(center * scale());
-    auto conic_gradient = create_conic_gradient(color_stops, center_point, start_angle, repeat_length);
-    conic_gradient.paint(*this, a_rect);
+    GradientCache::Key key { GradientCache::Key::Type::Conic, a_rect.size(), {}, start_angle, center_point, {}, repeat_length };
+    key.color_stops.append(color_stops.data(), color_stops.size());
+    paint_gradient(*this, a_rect, move(key), [&] {
+        return create_conic_gradient(color_stops, center_point, start_angle, repeat_length);
+    });
 }
 
 void Painter::fill_rect_with_radial_gradient(IntRect const& rect, ReadonlySpan<ColorStop> color_stops, IntPoint center, IntSize size, Optional<float> repeat_length)
 {
     auto a_rect = to_physical(rect);
-    if (a_rect.intersected(clip_rect() * scale()).is_empty())
-        return;
-    auto radial_gradient = create_radial_gradient(a_rect, color_stops, center * scale(), size * scale(), repeat_length);
-    radial_gradient.paint(*this, a_rect);
+    GradientCache::Key key { GradientCache::Key::Type::Radial, a_rect.size(), {}, 0, (center * scale()).to_type<float>(), size * scale(), repeat_length };
+    key.color_stops.append(color_stops.data(), color_stops.size());
+    paint_gradient(*this, a_rect, move(key), [&] {
+        return create_radial_gradient(a_rect, color_stops, center * scale(), size * scale(), repeat_length);
+    });
 }
 
 // TODO: Figure out how to handle scale() here... Not important while not supported by fill_path()
@@ -16,6 +16,8 @@ struct ColorStop {
     Color color;
     float position = AK::NaN<float>;
     Optional<float> transition_hint = {};
+
+    bool operator==(ColorStop const&) const = default;
 };
 
 class GradientLine;
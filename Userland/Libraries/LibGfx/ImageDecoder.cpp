@@ -91,6 +91,28 @@ RefPtr<ImageDecoder> ImageDecoder::try_create_for_raw_bytes(ReadonlyBytes bytes,
     return adopt_ref_if_nonnull(new (nothrow) ImageDecoder(plugin.release_nonnull()));
 }
 
+RefPtr<ImageDecoder> ImageDecoder::try_create_for_mapped_file(NonnullRefPtr<Core::MappedFile> mapped_file, Optional<DeprecatedString> mime_type)
+{
+    auto decoder = try_create_for_raw_bytes(mapped_file->bytes(), move(mime_type));
+    if (decoder)
+        decoder->m_mapped_file = move(mapped_file);
+    return decoder;
+}
+
+ErrorOr<ImageFrameDescriptor> ImageDecoderPlugin::frame_region(size_t index, IntRect region)
+{
+    auto descriptor = TRY(frame(index));
+    VERIFY(descriptor.image);
+
+    region.intersect(descriptor.image->rect());
+    if (region.is_empty())
+        return Error::from_string_literal("Image region lies outside of the frame");
+    if (region == descriptor.image->rect())
+        return descriptor;
+
+    return ImageFrameDescriptor { TRY(descriptor.image->cropped(region)), descriptor.duration };
+}
+
 ImageDecoder::ImageDecoder(NonnullOwnPtr<ImageDecoderPlugin> plugin)
     : m_plugin(move(plugin))
 {
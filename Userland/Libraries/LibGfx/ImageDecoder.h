@@ -10,7 +10,9 @@
 #include <AK/OwnPtr.h>
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
+#include <LibCore/MappedFile.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/Rect.h>
 #include <LibGfx/Size.h>
 
 namespace Gfx {
@@ -40,6 +42,11 @@ public:
     virtual size_t loop_count() = 0;
     virtual size_t frame_count() = 0;
     virtual ErrorOr<ImageFrameDescriptor> frame(size_t index) = 0;
+
+    // Decodes the part of a frame that lies within `region`. By default, the whole frame is decoded and cropped,
+    // but formats that can seek to the pixels in a region should only decode those.
+    virtual ErrorOr<ImageFrameDescriptor> frame_region(size_t index, IntRect region);
+
     virtual ErrorOr<Optional<ReadonlyBytes>> icc_data() = 0;
 
 protected:
@@ -49,6 +56,10 @@ protected:
 class ImageDecoder : public RefCounted<ImageDecoder> {
 public:
     static RefPtr<ImageDecoder> try_create_for_raw_bytes(ReadonlyBytes, Optional<DeprecatedString> mime_type = {});
+
+    // Decodes straight out of the mapping, which is kept alive for as long as the decoder is.
+    // Nothing is decoded until a frame is asked for.
+    static RefPtr<ImageDecoder> try_create_for_mapped_file(NonnullRefPtr<Core::MappedFile>, Optional<DeprecatedString> mime_type = {});
     ~ImageDecoder() = default;
 
     IntSize size() const { return m_plugin->size(); }
@@ -60,12 +71,14 @@ public:
     size_t loop_count() const { return m_plugin->loop_count(); }
     size_t frame_count() const { return m_plugin->frame_count(); }
     ErrorOr<ImageFrameDescriptor> frame(size_t index) const { return m_plugin->frame(index); }
+    ErrorOr<ImageFrameDescriptor> frame(size_t index, IntRect region) const { return m_plugin->frame_region(index, region); }
     ErrorOr<Optional<ReadonlyBytes>> icc_data() const { return m_plugin->icc_data(); }
 
 private:
     explicit ImageDecoder(NonnullOwnPtr<ImageDecoderPlugin>);
 
     NonnullOwnPtr<ImageDecoderPlugin> mutable m_plugin;
+    RefPtr<Core::MappedFile> m_mapped_file;
 };
 
 }
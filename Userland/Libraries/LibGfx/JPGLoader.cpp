@@ -13,8 +13,10 @@
 #include <AK/MemoryStream.h>
 #include <AK/String.h>
 #include <AK/Try.h>
+#include <AK/SIMD.h>
 #include <AK/Vector.h>
 #include <LibGfx/JPGLoader.h>
+#include <LibThreading/ThreadPool.h>
 
 #define JPG_INVALID 0X0000
 
@@ -86,29 +88,23 @@ constexpr static u8 zigzag_map[64] {
 
 using Marker = u16;
 
+static Threading::ThreadPool* s_decoding_thread_pool;
+
+// Restart intervals are often as short as a single MCU, so they're handed to the thread pool in batches of at least this many MCUs.
+static constexpr u32 minimum_mcus_per_parallel_batch = 64;
+
 /**
  * MCU means group of data units that are coded together. A data unit is an 8x8
  * block of component data. In interleaved scans, number of non-interleaved data
  * units of a component C is Ch * Cv, where Ch and Cv represent the horizontal &
- * vertical subsampling factors of the component, respectively. A MacroBlock is
- * an 8x8 block of RGB values before encoding, and 8x8 block of YCbCr values when
- * we're done decoding the huffman stream.
+ * vertical subsampling factors of the component, respectively. A MacroBlock holds
+ * the DCT coefficients of an 8x8 block of YCbCr values, as we read them from the
+ * huffman stream.
  */
 struct Macroblock {
-    union {
-        i32 y[64] = { 0 };
-        i32 r[64];
-    };
-
-    union {
-        i32 cb[64] = { 0 };
-        i32 g[64];
-    };
-
-    union {
-        i32 cr[64] = { 0 };
-        i32 b[64];
-    };
+    i32 y[64] = { 0 };
+    i32 cb[64] = { 0 };
+    i32 cr[64] = { 0 };
 };
 
 struct MacroblockMeta {
@@ -163,11 +159,18 @@ struct HuffmanTableSpec {
 };
 
 struct HuffmanStreamState {
-    Vector<u8> stream;
+    ReadonlyBytes stream;
     u8 bit_offset { 0 };
     size_t byte_offset { 0 };
 };
 
+// Everything that decoding the MCUs of a scan keeps track of. This starts over at every restart marker,
+// which is what lets us decode the restart intervals independently of each other.
+struct ScanSegmentState {
+    HuffmanStreamState huffman_stream;
+    i32 previous_dc_values[3] = { 0 };
+};
+
 struct ICCMultiChunkState {
     u8 seen_number_of_icc_chunks { 0 };
     FixedArray<ByteBuffer> chunks;
@@ -187,6 +190,8 @@ struct JPGLoadingContext {
     size_t data_size { 0 };
     u32 luma_table[64] = { 0 };
     u32 chroma_table[64] = { 0 };
+    // The quantization tables with the scale factors of the IDCT folded in, indexed by table id.
+    float idct_tables[2][64] = { { 0 } };
     StartOfFrame frame;
     u8 hsample_factor { 0 };
     u8 vsample_factor { 0 };
@@ -196,8 +201,10 @@ struct JPGLoadingContext {
     u16 dc_reset_interval { 0 };
     HashMap<u8, HuffmanTableSpec> dc_tables;
     HashMap<u8, HuffmanTableSpec> ac_tables;
-    HuffmanStreamState huffman_stream;
-    i32 previous_dc_values[3] = { 0 };
+    // The entropy-coded segments of the scan, with any byte stuffing removed.
+    Vector<u8> entropy_coded_data;
+    // Where each segment after a restart marker starts in entropy_coded_data.
+    Vector<size_t> restart_offsets;
     MacroblockMeta mblock_meta;
     OwnPtr<FixedMemoryStream> stream;
 
@@ -270,21 +277,21 @@ static inline i32* get_component(Macroblock& block, unsigned component)
 }
 
 /**
- * Build the macroblocks possible by reading single (MCU) subsampled pair of CbCr.
+ * Build the macroblocks of a single MCU by reading its subsampled pair of CbCr.
  * Depending on the sampling factors, we may not see triples of y, cb, cr in that
  * order. If sample factors differ from one, we'll read more than one block of y-
  * coefficients before we get to read a cb-cr block.
 
- * In the function below, `hcursor` and `vcursor` denote the location of the block
- * we're building in the macroblock matrix. `vfactor_i` and `hfactor_i` are cursors
- * that iterate over the vertical and horizontal subsampling factors, respectively.
+ * In the function below, `macroblocks` are the luma blocks of the MCU in row order,
+ * and the chroma data goes into the first of them. `vfactor_i` and `hfactor_i` are
+ * cursors that iterate over the vertical and horizontal subsampling factors, respectively.
  * When we finish one iteration of the innermost loop, we'll have the coefficients
  * of one of the components of block at position `mb_index`. When the outermost loop
  * finishes first iteration, we'll have all the luminance coefficients for all the
  * macroblocks that share the chrominance data. Next two iterations (assuming that
  * we are dealing with three components) will fill up the blocks with chroma data.
  */
-static ErrorOr<void> build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& macroblocks, u32 hcursor, u32 vcursor)
+static ErrorOr<void> build_macroblocks(JPGLoadingContext const& context, ScanSegmentState& segment, Macroblock* macroblocks)
 {
     for (unsigned component_i = 0; component_i < context.component_count; component_i++) {
         auto& component = context.components[component_i];
@@ -296,28 +303,28 @@ static ErrorOr<void> build_macroblocks(JPGLoadingContext& context, Vector<Macrob
 
         for (u8 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
             for (u8 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
-                u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
+                u32 mb_index = vfactor_i * context.hsample_factor + hfactor_i;
                 Macroblock& block = macroblocks[mb_index];
 
                 auto& dc_table = context.dc_tables.find(component.dc_destination_id)->value;
                 auto& ac_table = context.ac_tables.find(component.ac_destination_id)->value;
 
                 // For DC coefficients, symbol encodes the length of the coefficient.
-                auto dc_length = TRY(get_next_symbol(context.huffman_stream, dc_table));
+                auto dc_length = TRY(get_next_symbol(segment.huffman_stream, dc_table));
                 if (dc_length > 11) {
                     dbgln_if(JPG_DEBUG, "DC coefficient too long: {}!", dc_length);
                     return Error::from_string_literal("DC coefficient too long");
                 }
 
                 // DC coefficients are encoded as the difference between previous and current DC values.
-                i32 dc_diff = TRY(read_huffman_bits(context.huffman_stream, dc_length));
+                i32 dc_diff = TRY(read_huffman_bits(segment.huffman_stream, dc_length));
 
                 // If MSB in diff is 0, the difference is -ve. Otherwise +ve.
                 if (dc_length != 0 && dc_diff < (1 << (dc_length - 1)))
                     dc_diff -= (1 << dc_length) - 1;
 
                 auto select_component = get_component(block, component_i);
-                auto& previous_dc = context.previous_dc_values[component_i];
+                auto& previous_dc = segment.previous_dc_values[component_i];
                 select_component[0] = previous_dc += dc_diff;
 
                 // Compute the AC coefficients.
@@ -325,7 +332,7 @@ static ErrorOr<void> build_macroblocks(JPGLoadingContext& context, Vector<Macrob
                     // AC symbols encode 2 pieces of information, the high 4 bits represent
                     // number of zeroes to be stuffed before reading the coefficient. Low 4
                     // bits represent the magnitude of the coefficient.
-                    auto ac_symbol = TRY(get_next_symbol(context.huffman_stream, ac_table));
+                    auto ac_symbol = TRY(get_next_symbol(segment.huffman_stream, ac_table));
                     if (ac_symbol == 0)
                         break;
 
@@ -345,7 +352,7 @@ static ErrorOr<void> build_macroblocks(JPGLoadingContext& context, Vector<Macrob
                     }
 
                     if (coeff_length != 0) {
-                        i32 ac_coefficient = TRY(read_huffman_bits(context.huffman_stream, coeff_length));
+                        i32 ac_coefficient = TRY(read_huffman_bits(segment.huffman_stream, coeff_length));
                         if (ac_coefficient < (1 << (coeff_length - 1)))
                             ac_coefficient -= (1 << coeff_length) - 1;
 
@@ -359,63 +366,6 @@ static ErrorOr<void> build_macroblocks(JPGLoadingContext& context, Vector<Macrob
     return {};
 }
 
-static ErrorOr<Vector<Macroblock>> decode_huffman_stream(JPGLoadingContext& context)
-{
-    Vector<Macroblock> macroblocks;
-    macroblocks.resize(context.mblock_meta.padded_total);
-
-    if constexpr (JPG_DEBUG) {
-        dbgln("Image width: {}", context.frame.width);
-        dbgln("Image height: {}", context.frame.height);
-        dbgln("Macroblocks in a row: {}", context.mblock_meta.hpadded_count);
-        dbgln("Macroblocks in a column: {}", context.mblock_meta.vpadded_count);
-        dbgln("Macroblock meta padded total: {}", context.mblock_meta.padded_total);
-    }
-
-    // Compute huffman codes for DC and AC tables.
-    for (auto it = context.dc_tables.begin(); it != context.dc_tables.end(); ++it)
-        generate_huffman_codes(it->value);
-
-    for (auto it = context.ac_tables.begin(); it != context.ac_tables.end(); ++it)
-        generate_huffman_codes(it->value);
-
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            u32 i = vcursor * context.mblock_meta.hpadded_count + hcursor;
-            if (context.dc_reset_interval > 0) {
-                if (i % context.dc_reset_interval == 0) {
-                    context.previous_dc_values[0] = 0;
-                    context.previous_dc_values[1] = 0;
-                    context.previous_dc_values[2] = 0;
-
-                    // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
-                    //  the 0th bit of the next byte.
-                    if (context.huffman_stream.byte_offset < context.huffman_stream.stream.size()) {
-                        if (context.huffman_stream.bit_offset > 0) {
-                            context.huffman_stream.bit_offset = 0;
-                            context.huffman_stream.byte_offset++;
-                        }
-
-                        // Skip the restart marker (RSTn).
-                        context.huffman_stream.byte_offset++;
-                    }
-                }
-            }
-
-            if (auto result = build_macroblocks(context, macroblocks, hcursor, vcursor); result.is_error()) {
-                if constexpr (JPG_DEBUG) {
-                    dbgln("Failed to build Macroblock {}", i);
-                    dbgln("Huffman stream byte offset {}", context.huffman_stream.byte_offset);
-                    dbgln("Huffman stream bit offset {}", context.huffman_stream.bit_offset);
-                }
-                return result.release_error();
-            }
-        }
-    }
-
-    return macroblocks;
-}
-
 static inline ErrorOr<void> ensure_bounds_okay(const size_t cursor, const size_t delta, const size_t bound)
 {
     if (Checked<size_t>::addition_would_overflow(delta, cursor))
@@ -846,245 +796,248 @@ static ErrorOr<void> skip_marker_with_length(Stream& stream)
     return {};
 }
 
-static void dequantize(JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+// The AAN IDCT leaves scaling its inputs to the caller, so we fold the scale factors into the quantization tables.
+static void compute_idct_tables(JPGLoadingContext& context)
 {
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            for (u32 i = 0; i < context.component_count; i++) {
-                auto& component = context.components[i];
-                u32 const* table = component.qtable_id == 0 ? context.luma_table : context.chroma_table;
-                for (u32 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
-                    for (u32 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
-                        u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                        Macroblock& block = macroblocks[mb_index];
-                        int* block_component = get_component(block, i);
-                        for (u32 k = 0; k < 64; k++)
-                            block_component[k] *= table[k];
-                    }
-                }
-            }
+    float scale_factors[8];
+    scale_factors[0] = AK::cos(0.0f / 16.0f * AK::Pi<float>) * AK::rsqrt(8.0f);
+    for (size_t i = 1; i < 8; ++i)
+        scale_factors[i] = AK::cos(static_cast<float>(i) / 16.0f * AK::Pi<float>) / 2.0f;
+
+    for (size_t table_id = 0; table_id < 2; ++table_id) {
+        u32 const* table = table_id == 0 ? context.luma_table : context.chroma_table;
+        for (size_t row = 0; row < 8; ++row) {
+            for (size_t column = 0; column < 8; ++column)
+                context.idct_tables[table_id][row * 8 + column] = static_cast<float>(table[row * 8 + column]) * scale_factors[row] * scale_factors[column];
         }
     }
 }
 
-static void inverse_dct(JPGLoadingContext const& context, Vector<Macroblock>& macroblocks)
+// One dimension of the AAN IDCT, applied to four columns of a block at once.
+ALWAYS_INLINE static void inverse_dct_columns(AK::SIMD::f32x4 (&v)[8])
 {
-    static float const m0 = 2.0f * AK::cos(1.0f / 16.0f * 2.0f * AK::Pi<float>);
-    static float const m1 = 2.0f * AK::cos(2.0f / 16.0f * 2.0f * AK::Pi<float>);
-    static float const m3 = 2.0f * AK::cos(2.0f / 16.0f * 2.0f * AK::Pi<float>);
-    static float const m5 = 2.0f * AK::cos(3.0f / 16.0f * 2.0f * AK::Pi<float>);
-    static float const m2 = m0 - m5;
-    static float const m4 = m0 + m5;
-    static float const s0 = AK::cos(0.0f / 16.0f * AK::Pi<float>) * AK::rsqrt(8.0f);
-    static float const s1 = AK::cos(1.0f / 16.0f * AK::Pi<float>) / 2.0f;
-    static float const s2 = AK::cos(2.0f / 16.0f * AK::Pi<float>) / 2.0f;
-    static float const s3 = AK::cos(3.0f / 16.0f * AK::Pi<float>) / 2.0f;
-    static float const s4 = AK::cos(4.0f / 16.0f * AK::Pi<float>) / 2.0f;
-    static float const s5 = AK::cos(5.0f / 16.0f * AK::Pi<float>) / 2.0f;
-    static float const s6 = AK::cos(6.0f / 16.0f * AK::Pi<float>) / 2.0f;
-    static float const s7 = AK::cos(7.0f / 16.0f * AK::Pi<float>) / 2.0f;
-
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            for (u32 component_i = 0; component_i < context.component_count; component_i++) {
-                auto& component = context.components[component_i];
-                for (u8 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
-                    for (u8 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
-                        u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                        Macroblock& block = macroblocks[mb_index];
-                        i32* block_component = get_component(block, component_i);
-                        for (u32 k = 0; k < 8; ++k) {
-                            float const g0 = block_component[0 * 8 + k] * s0;
-                            float const g1 = block_component[4 * 8 + k] * s4;
-                            float const g2 = block_component[2 * 8 + k] * s2;
-                            float const g3 = block_component[6 * 8 + k] * s6;
-                            float const g4 = block_component[5 * 8 + k] * s5;
-                            float const g5 = block_component[1 * 8 + k] * s1;
-                            float const g6 = block_component[7 * 8 + k] * s7;
-                            float const g7 = block_component[3 * 8 + k] * s3;
-
-                            float const f0 = g0;
-                            float const f1 = g1;
-                            float const f2 = g2;
-                            float const f3 = g3;
-                            float const f4 = g4 - g7;
-                            float const f5 = g5 + g6;
-                            float const f6 = g5 - g6;
-                            float const f7 = g4 + g7;
-
-                            float const e0 = f0;
-                            float const e1 = f1;
-                            float const e2 = f2 - f3;
-                            float const e3 = f2 + f3;
-                            float const e4 = f4;
-                            float const e5 = f5 - f7;
-                            float const e6 = f6;
-                            float const e7 = f5 + f7;
-                            float const e8 = f4 + f6;
-
-                            float const d0 = e0;
-                            float const d1 = e1;
-                            float const d2 = e2 * m1;
-                            float const d3 = e3;
-                            float const d4 = e4 * m2;
-                            float const d5 = e5 * m3;
-                            float const d6 = e6 * m4;
-                            float const d7 = e7;
-                            float const d8 = e8 * m5;
-
-                            float const c0 = d0 + d1;
-                            float const c1 = d0 - d1;
-                            float const c2 = d2 - d3;
-                            float const c3 = d3;
-                            float const c4 = d4 + d8;
-                            float const c5 = d5 + d7;
-                            float const c6 = d6 - d8;
-                            float const c7 = d7;
-                            float const c8 = c5 - c6;
-
-                            float const b0 = c0 + c3;
-                            float const b1 = c1 + c2;
-                            float const b2 = c1 - c2;
-                            float const b3 = c0 - c3;
-                            float const b4 = c4 - c8;
-                            float const b5 = c8;
-                            float const b6 = c6 - c7;
-                            float const b7 = c7;
-
-                            block_component[0 * 8 + k] = b0 + b7;
-                            block_component[1 * 8 + k] = b1 + b6;
-                            block_component[2 * 8 + k] = b2 + b5;
-                            block_component[3 * 8 + k] = b3 + b4;
-                            block_component[4 * 8 + k] = b3 - b4;
-                            block_component[5 * 8 + k] = b2 - b5;
-                            block_component[6 * 8 + k] = b1 - b6;
-                            block_component[7 * 8 + k] = b0 - b7;
-                        }
-                        for (u32 l = 0; l < 8; ++l) {
-                            float const g0 = block_component[l * 8 + 0] * s0;
-                            float const g1 = block_component[l * 8 + 4] * s4;
-                            float const g2 = block_component[l * 8 + 2] * s2;
-                            float const g3 = block_component[l * 8 + 6] * s6;
-                            float const g4 = block_component[l * 8 + 5] * s5;
-                            float const g5 = block_component[l * 8 + 1] * s1;
-                            float const g6 = block_component[l * 8 + 7] * s7;
-                            float const g7 = block_component[l * 8 + 3] * s3;
-
-                            float const f0 = g0;
-                            float const f1 = g1;
-                            float const f2 = g2;
-                            float const f3 = g3;
-                            float const f4 = g4 - g7;
-                            float const f5 = g5 + g6;
-                            float const f6 = g5 - g6;
-                            float const f7 = g4 + g7;
-
-                            float const e0 = f0;
-                            float const e1 = f1;
-                            float const e2 = f2 - f3;
-                            float const e3 = f2 + f3;
-                            float const e4 = f4;
-                            float const e5 = f5 - f7;
-                            float const e6 = f6;
-                            float const e7 = f5 + f7;
-                            float const e8 = f4 + f6;
-
-                            float const d0 = e0;
-                            float const d1 = e1;
-                            float const d2 = e2 * m1;
-                            float const d3 = e3;
-                            float const d4 = e4 * m2;
-                            float const d5 = e5 * m3;
-                            float const d6 = e6 * m4;
-                            float const d7 = e7;
-                            float const d8 = e8 * m5;
-
-                            float const c0 = d0 + d1;
-                            float const c1 = d0 - d1;
-                            float const c2 = d2 - d3;
-                            float const c3 = d3;
-                            float const c4 = d4 + d8;
-                            float const c5 = d5 + d7;
-                            float const c6 = d6 - d8;
-                            float const c7 = d7;
-                            float const c8 = c5 - c6;
-
-                            float const b0 = c0 + c3;
-                            float const b1 = c1 + c2;
-                            float const b2 = c1 - c2;
-                            float const b3 = c0 - c3;
-                            float const b4 = c4 - c8;
-                            float const b5 = c8;
-                            float const b6 = c6 - c7;
-                            float const b7 = c7;
-
-                            block_component[l * 8 + 0] = b0 + b7;
-                            block_component[l * 8 + 1] = b1 + b6;
-                            block_component[l * 8 + 2] = b2 + b5;
-                            block_component[l * 8 + 3] = b3 + b4;
-                            block_component[l * 8 + 4] = b3 - b4;
-                            block_component[l * 8 + 5] = b2 - b5;
-                            block_component[l * 8 + 6] = b1 - b6;
-                            block_component[l * 8 + 7] = b0 - b7;
-                        }
-                    }
-                }
+    constexpr float m0 = 1.847759065f; // 2 * cos(2 / 16 * pi)
+    constexpr float m1 = 1.414213562f; // 2 * cos(4 / 16 * pi)
+    constexpr float m3 = m1;
+    constexpr float m5 = 0.765366865f; // 2 * cos(6 / 16 * pi)
+    constexpr float m2 = m0 - m5;
+    constexpr float m4 = m0 + m5;
+
+    auto const g0 = v[0];
+    auto const g1 = v[4];
+    auto const g2 = v[2];
+    auto const g3 = v[6];
+    auto const g4 = v[5];
+    auto const g5 = v[1];
+    auto const g6 = v[7];
+    auto const g7 = v[3];
+
+    auto const f4 = g4 - g7;
+    auto const f5 = g5 + g6;
+    auto const f6 = g5 - g6;
+    auto const f7 = g4 + g7;
+
+    auto const e2 = g2 - g3;
+    auto const e3 = g2 + g3;
+    auto const e5 = f5 - f7;
+    auto const e7 = f5 + f7;
+    auto const e8 = f4 + f6;
+
+    auto const d2 = e2 * m1;
+    auto const d4 = f4 * m2;
+    auto const d5 = e5 * m3;
+    auto const d6 = f6 * m4;
+    auto const d8 = e8 * m5;
+
+    auto const c0 = g0 + g1;
+    auto const c1 = g0 - g1;
+    auto const c2 = d2 - e3;
+    auto const c4 = d4 + d8;
+    auto const c5 = d5 + e7;
+    auto const c6 = d6 - d8;
+    auto const c8 = c5 - c6;
+
+    auto const b0 = c0 + e3;
+    auto const b1 = c1 + c2;
+    auto const b2 = c1 - c2;
+    auto const b3 = c0 - e3;
+    auto const b4 = c4 - c8;
+    auto const b6 = c6 - e7;
+
+    v[0] = b0 + e7;
+    v[1] = b1 + b6;
+    v[2] = b2 + c8;
+    v[3] = b3 + b4;
+    v[4] = b3 - b4;
+    v[5] = b2 - c8;
+    v[6] = b1 - b6;
+    v[7] = b0 - e7;
+}
+
+static void inverse_dct(i32 const* coefficients, float const* idct_table, float* samples)
+{
+    for (size_t i = 0; i < 64; ++i)
+        samples[i] = static_cast<float>(coefficients[i]) * idct_table[i];
+
+    // Transforming the columns and then transposing twice transforms both columns and rows, and puts the block back the right way around.
+    for (size_t pass = 0; pass < 2; ++pass) {
+        for (size_t half = 0; half < 2; ++half) {
+            AK::SIMD::f32x4 columns[8];
+            for (size_t row = 0; row < 8; ++row)
+                __builtin_memcpy(&columns[row], samples + row * 8 + half * 4, sizeof(columns[row]));
+            inverse_dct_columns(columns);
+            for (size_t row = 0; row < 8; ++row)
+                __builtin_memcpy(samples + row * 8 + half * 4, &columns[row], sizeof(columns[row]));
+        }
+
+        for (size_t row = 0; row < 8; ++row) {
+            for (size_t column = row + 1; column < 8; ++column)
+                swap(samples[row * 8 + column], samples[column * 8 + row]);
+        }
+    }
+}
+
+ALWAYS_INLINE static u32 clamp_to_u8(float value)
+{
+    return static_cast<u32>(clamp(value, 0.0f, 255.0f));
+}
+
+// Converts the samples of an MCU to RGB, and writes them to their place in the bitmap.
+static void compose_mcu(JPGLoadingContext const& context, u32 mcu_x, u32 mcu_y, float const (*luma)[64], float const* cb, float const* cr)
+{
+    u32 mcu_width = 8 * context.hsample_factor;
+    u32 mcu_height = 8 * context.vsample_factor;
+    u32 x = mcu_x * mcu_width;
+    u32 y = mcu_y * mcu_height;
+    u32 width = min(mcu_width, context.frame.width - x);
+    u32 height = min(mcu_height, context.frame.height - y);
+
+    for (u32 pixel_y = 0; pixel_y < height; ++pixel_y) {
+        ARGB32* scanline = context.bitmap->scanline(y + pixel_y) + x;
+        for (u32 pixel_x = 0; pixel_x < width; ++pixel_x) {
+            // Rounding to the nearest integer, and undoing the level shift of the encoder.
+            float luminance = luma[(pixel_y / 8) * context.hsample_factor + pixel_x / 8][(pixel_y % 8) * 8 + pixel_x % 8] + 128.5f;
+            if (context.component_count == 1) {
+                u32 gray = clamp_to_u8(luminance);
+                scanline[pixel_x] = 0xff000000 | (gray << 16) | (gray << 8) | gray;
+                continue;
             }
+
+            u32 chroma_pixel = (pixel_y / context.vsample_factor) * 8 + pixel_x / context.hsample_factor;
+            u32 r = clamp_to_u8(luminance + 1.402f * cr[chroma_pixel]);
+            u32 g = clamp_to_u8(luminance - 0.344f * cb[chroma_pixel] - 0.714f * cr[chroma_pixel]);
+            u32 b = clamp_to_u8(luminance + 1.772f * cb[chroma_pixel]);
+            scanline[pixel_x] = 0xff000000 | (r << 16) | (g << 8) | b;
         }
     }
 }
 
-static void ycbcr_to_rgb(JPGLoadingContext const& context, Vector<Macroblock>& macroblocks)
+static ErrorOr<void> decode_mcu(JPGLoadingContext const& context, ScanSegmentState& segment, u32 mcu)
 {
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            const u32 chroma_block_index = vcursor * context.mblock_meta.hpadded_count + hcursor;
-            Macroblock const& chroma = macroblocks[chroma_block_index];
-            // Overflows are intentional.
-            for (u8 vfactor_i = context.vsample_factor - 1; vfactor_i < context.vsample_factor; --vfactor_i) {
-                for (u8 hfactor_i = context.hsample_factor - 1; hfactor_i < context.hsample_factor; --hfactor_i) {
-                    u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
-                    i32* y = macroblocks[mb_index].y;
-                    i32* cb = macroblocks[mb_index].cb;
-                    i32* cr = macroblocks[mb_index].cr;
-                    for (u8 i = 7; i < 8; --i) {
-                        for (u8 j = 7; j < 8; --j) {
-                            const u8 pixel = i * 8 + j;
-                            const u32 chroma_pxrow = (i / context.vsample_factor) + 4 * vfactor_i;
-                            const u32 chroma_pxcol = (j / context.hsample_factor) + 4 * hfactor_i;
-                            const u32 chroma_pixel = chroma_pxrow * 8 + chroma_pxcol;
-                            int r = y[pixel] + 1.402f * chroma.cr[chroma_pixel] + 128;
-                            int g = y[pixel] - 0.344f * chroma.cb[chroma_pixel] - 0.714f * chroma.cr[chroma_pixel] + 128;
-                            int b = y[pixel] + 1.772f * chroma.cb[chroma_pixel] + 128;
-                            y[pixel] = r < 0 ? 0 : (r > 255 ? 255 : r);
-                            cb[pixel] = g < 0 ? 0 : (g > 255 ? 255 : g);
-                            cr[pixel] = b < 0 ? 0 : (b > 255 ? 255 : b);
-                        }
-                    }
+    Macroblock macroblocks[4];
+    TRY(build_macroblocks(context, segment, macroblocks));
+
+    float luma[4][64];
+    float cb[64];
+    float cr[64];
+    for (u32 i = 0; i < static_cast<u32>(context.hsample_factor * context.vsample_factor); ++i)
+        inverse_dct(macroblocks[i].y, context.idct_tables[context.components[0].qtable_id], luma[i]);
+    if (context.component_count == 3) {
+        inverse_dct(macroblocks[0].cb, context.idct_tables[context.components[1].qtable_id], cb);
+        inverse_dct(macroblocks[0].cr, context.idct_tables[context.components[2].qtable_id], cr);
+    }
+
+    auto mcus_per_row = ceil_div(context.mblock_meta.hcount, static_cast<u32>(context.hsample_factor));
+    compose_mcu(context, mcu % mcus_per_row, mcu / mcus_per_row, luma, cb, cr);
+    return {};
+}
+
+static ErrorOr<void> decode_mcus(JPGLoadingContext const& context, ScanSegmentState& segment, u32 first_mcu, u32 mcu_count)
+{
+    for (u32 mcu = first_mcu; mcu < first_mcu + mcu_count; ++mcu) {
+        if (context.dc_reset_interval > 0 && mcu != first_mcu && mcu % context.dc_reset_interval == 0) {
+            segment.previous_dc_values[0] = 0;
+            segment.previous_dc_values[1] = 0;
+            segment.previous_dc_values[2] = 0;
+
+            // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
+            //  the 0th bit of the next byte.
+            auto& huffman_stream = segment.huffman_stream;
+            if (huffman_stream.byte_offset < huffman_stream.stream.size()) {
+                if (huffman_stream.bit_offset > 0) {
+                    huffman_stream.bit_offset = 0;
+                    huffman_stream.byte_offset++;
                 }
+
+                // Skip the restart marker (RSTn).
+                huffman_stream.byte_offset++;
+            }
+        }
+
+        if (auto result = decode_mcu(context, segment, mcu); result.is_error()) {
+            if constexpr (JPG_DEBUG) {
+                dbgln("Failed to decode MCU {}", mcu);
+                dbgln("Huffman stream byte offset {}", segment.huffman_stream.byte_offset);
+                dbgln("Huffman stream bit offset {}", segment.huffman_stream.bit_offset);
             }
+            return result.release_error();
         }
     }
+    return {};
 }
 
-static ErrorOr<void> compose_bitmap(JPGLoadingContext& context, Vector<Macroblock> const& macroblocks)
+// Decodes the MCUs one at a time, from the entropy-coded data straight into the bitmap.
+static ErrorOr<void> decode_entropy_coded_data(JPGLoadingContext& context)
 {
+    if constexpr (JPG_DEBUG) {
+        dbgln("Image width: {}", context.frame.width);
+        dbgln("Image height: {}", context.frame.height);
+        dbgln("Macroblocks in a row: {}", context.mblock_meta.hpadded_count);
+        dbgln("Macroblocks in a column: {}", context.mblock_meta.vpadded_count);
+        dbgln("Macroblock meta padded total: {}", context.mblock_meta.padded_total);
+    }
+
+    // Compute huffman codes for DC and AC tables.
+    for (auto it = context.dc_tables.begin(); it != context.dc_tables.end(); ++it)
+        generate_huffman_codes(it->value);
+
+    for (auto it = context.ac_tables.begin(); it != context.ac_tables.end(); ++it)
+        generate_huffman_codes(it->value);
+
+    compute_idct_tables(context);
+
     context.bitmap = TRY(Bitmap::create(BitmapFormat::BGRx8888, { context.frame.width, context.frame.height }));
 
-    for (u32 y = context.frame.height - 1; y < context.frame.height; y--) {
-        const u32 block_row = y / 8;
-        const u32 pixel_row = y % 8;
-        for (u32 x = 0; x < context.frame.width; x++) {
-            const u32 block_column = x / 8;
-            auto& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
-            const u32 pixel_column = x % 8;
-            const u32 pixel_index = pixel_row * 8 + pixel_column;
-            const Color color { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index] };
-            context.bitmap->set_pixel(x, y, color);
+    u32 mcu_count = ceil_div(context.mblock_meta.hcount, static_cast<u32>(context.hsample_factor)) * ceil_div(context.mblock_meta.vcount, static_cast<u32>(context.vsample_factor));
+    u32 restart_interval = context.dc_reset_interval;
+    u32 segment_count = restart_interval > 0 ? ceil_div(mcu_count, restart_interval) : 1;
+
+    // If we know where each restart interval begins, they can all be decoded at the same time.
+    if (s_decoding_thread_pool && segment_count > 1 && context.restart_offsets.size() >= segment_count - 1) {
+        Vector<Optional<Error>> errors;
+        TRY(errors.try_resize(segment_count));
+
+        Threading::parallel_for(
+            segment_count, [&](size_t i) {
+                ScanSegmentState segment;
+                segment.huffman_stream.stream = context.entropy_coded_data;
+                segment.huffman_stream.byte_offset = i == 0 ? 0 : context.restart_offsets[i - 1];
+                u32 first_mcu = i * restart_interval;
+                if (auto result = decode_mcus(context, segment, first_mcu, min(restart_interval, mcu_count - first_mcu)); result.is_error())
+                    errors[i] = result.release_error();
+            },
+            ceil_div(minimum_mcus_per_parallel_batch, restart_interval), *s_decoding_thread_pool);
+
+        for (auto& error : errors) {
+            if (error.has_value())
+                return error.release_value();
         }
+        return {};
     }
 
-    return {};
+    ScanSegmentState segment;
+    segment.huffman_stream.stream = context.entropy_coded_data;
+    return decode_mcus(context, segment, 0, mcu_count);
 }
 
 static ErrorOr<void> parse_header(AK::SeekableStream& stream, JPGLoadingContext& context)
@@ -1178,21 +1131,22 @@ static ErrorOr<void> scan_huffman_stream(AK::SeekableStream& stream, JPGLoadingC
                 continue;
             if (current_byte == 0x00) {
                 current_byte = TRY(stream.read_value<u8>());
-                context.huffman_stream.stream.append(last_byte);
+                context.entropy_coded_data.append(last_byte);
                 continue;
             }
             Marker marker = 0xFF00 | current_byte;
             if (marker == JPG_EOI)
                 return {};
             if (marker >= JPG_RST0 && marker <= JPG_RST7) {
-                context.huffman_stream.stream.append(marker);
+                context.entropy_coded_data.append(marker);
+                context.restart_offsets.append(context.entropy_coded_data.size());
                 current_byte = TRY(stream.read_value<u8>());
                 continue;
             }
             dbgln_if(JPG_DEBUG, "{}: Invalid marker: {:x}!", TRY(stream.tell()), marker);
             return Error::from_string_literal("Invalid marker");
         } else {
-            context.huffman_stream.stream.append(last_byte);
+            context.entropy_coded_data.append(last_byte);
         }
     }
 
@@ -1217,12 +1171,10 @@ static ErrorOr<void> decode_jpg(JPGLoadingContext& context)
 {
     TRY(decode_header(context));
     TRY(scan_huffman_stream(*context.stream, context));
-    auto macroblocks = TRY(decode_huffman_stream(context));
-    dequantize(context, macroblocks);
-    inverse_dct(context, macroblocks);
-    ycbcr_to_rgb(context, macroblocks);
-    TRY(compose_bitmap(context, macroblocks));
+    TRY(decode_entropy_coded_data(context));
     context.stream.clear();
+    context.entropy_coded_data.clear();
+    context.restart_offsets.clear();
     return {};
 }
 
@@ -1231,11 +1183,16 @@ JPGImageDecoderPlugin::JPGImageDecoderPlugin(u8 const* data, size_t size)
     m_context = make<JPGLoadingContext>();
     m_context->data = data;
     m_context->data_size = size;
-    m_context->huffman_stream.stream.ensure_capacity(50 * KiB);
+    m_context->entropy_coded_data.ensure_capacity(50 * KiB);
 }
 
 JPGImageDecoderPlugin::~JPGImageDecoderPlugin() = default;
 
+void JPGImageDecoderPlugin::set_decoding_thread_pool(Threading::ThreadPool* thread_pool)
+{
+    s_decoding_thread_pool = thread_pool;
+}
+
 IntSize JPGImageDecoderPlugin::size()
 {
     if (m_context->state == JPGLoadingContext::State::Error)
@@ -8,6 +8,10 @@
 
 #include <LibGfx/ImageDecoder.h>
 
+namespace Threading {
+class ThreadPool;
+}
+
 namespace Gfx {
 
 struct JPGLoadingContext;
@@ -17,6 +21,10 @@ public:
     static ErrorOr<bool> sniff(ReadonlyBytes);
     static ErrorOr<NonnullOwnPtr<ImageDecoderPlugin>> create(ReadonlyBytes);
 
+    // Images with restart markers have their restart intervals decoded in parallel on this pool, if there is one.
+    // NOTE: Using the pool needs the "thread" pledge, so it's up to each process to opt into this.
+    static void set_decoding_thread_pool(Threading::ThreadPool*);
+
     virtual ~JPGImageDecoderPlugin() override;
     virtual IntSize size() override;
     virtual void set_volatile() override;
@@ -7,12 +7,18 @@
 
 #include <AK/Debug.h>
 #include <AK/Endian.h>
+#include <AK/Function.h>
+#include <AK/MemoryStream.h>
+#include <AK/SIMD.h>
 #include <AK/Vector.h>
+#include <LibCompress/Deflate.h>
 #include <LibCompress/Zlib.h>
 #include <LibGfx/PNGLoader.h>
 #include <LibGfx/PNGShared.h>
 #include <string.h>
 
+#pragma GCC diagnostic ignored "-Wpsabi"
+
 namespace Gfx {
 
 struct PNG_IHDR {
@@ -52,11 +58,6 @@ struct EmbeddedICCProfile {
     ReadonlyBytes compressed_data;
 };
 
-struct Scanline {
-    PNG::FilterType filter;
-    ReadonlyBytes data {};
-};
-
 struct [[gnu::packed]] PaletteEntry {
     u8 r;
     u8 g;
@@ -121,10 +122,8 @@ struct PNGLoadingContext {
     u8 channels { 0 };
     bool has_seen_zlib_header { false };
     bool has_alpha() const { return to_underlying(color_type) & 4 || palette_transparency_data.size() > 0; }
-    Vector<Scanline> scanlines;
-    ByteBuffer unfiltered_data;
     RefPtr<Gfx::Bitmap> bitmap;
-    ByteBuffer* decompression_buffer { nullptr };
+    Function<void(Bitmap const&)> on_interlaced_pass;
     Vector<u8> compressed_data;
     Vector<PaletteEntry> palette_data;
     Vector<u8> palette_transparency_data;
@@ -199,200 +198,173 @@ private:
 
 static bool process_chunk(Streamer&, PNGLoadingContext& context);
 
-union [[gnu::packed]] Pixel {
-    ARGB32 rgba { 0 };
-    u8 v[4];
-    struct {
-        u8 r;
-        u8 g;
-        u8 b;
-        u8 a;
-    };
+// From section 6.3 of http://www.libpng.org/pub/png/spec/1.2/PNG-Filters.html
+// "bpp is defined as the number of bytes per complete pixel, rounding up to one.
+// For example, for color type 2 with a bit depth of 16, bpp is equal to 6
+// (three samples, two bytes per sample); for color type 0 with a bit depth of 2,
+// bpp is equal to 1 (rounding up); for color type 4 with a bit depth of 16, bpp
+// is equal to 4 (two-byte grayscale sample, plus two-byte alpha sample)."
+template<size_t bytes_per_complete_pixel>
+struct FilterVectors {
+    // Each lane holds one byte of a pixel, with room to spare for the sums the filters compute.
+    using Bytes = Conditional<(bytes_per_complete_pixel <= 4), AK::SIMD::u8x4, AK::SIMD::u8x8>;
+    using Words = Conditional<(bytes_per_complete_pixel <= 4), AK::SIMD::i16x4, AK::SIMD::i16x8>;
+
+    ALWAYS_INLINE static Words load(u8 const* data)
+    {
+        Bytes bytes {};
+        __builtin_memcpy(&bytes, data, bytes_per_complete_pixel);
+        return __builtin_convertvector(bytes, Words);
+    }
+
+    ALWAYS_INLINE static void store(u8* data, Words words)
+    {
+        auto bytes = __builtin_convertvector(words, Bytes);
+        __builtin_memcpy(data, &bytes, bytes_per_complete_pixel);
+    }
+
+    // Comparisons give a mask with all bits of the lanes where they're true set.
+    ALWAYS_INLINE static Words select(Words mask, Words if_true, Words if_false)
+    {
+        return (mask & if_true) | (~mask & if_false);
+    }
+
+    ALWAYS_INLINE static Words abs(Words words)
+    {
+        return select(words < 0, -words, words);
+    }
 };
-static_assert(AssertSize<Pixel, 4>());
+
+// The Sub, Average and Paeth filters depend on the pixel to the left, so we can't filter many pixels at once.
+// What we can do is filter all bytes of each pixel at once.
+template<size_t bytes_per_complete_pixel>
+static void unfilter_scanline_by_pixel(PNG::FilterType filter, Bytes scanline_data, ReadonlyBytes previous_scanlines_data)
+{
+    using Vectors = FilterVectors<bytes_per_complete_pixel>;
+    using Words = typename Vectors::Words;
+
+    u8* data = scanline_data.data();
+    u8 const* above_data = previous_scanlines_data.data();
+    size_t size = scanline_data.size();
+
+    Words left {};
+    Words upper_left {};
+    for (size_t i = 0; i + bytes_per_complete_pixel <= size; i += bytes_per_complete_pixel) {
+        auto pixel = Vectors::load(data + i);
+        auto above = Vectors::load(above_data + i);
+
+        switch (filter) {
+        case PNG::FilterType::Sub:
+            pixel += left;
+            break;
+        case PNG::FilterType::Average:
+            pixel += (left + above) >> 1;
+            break;
+        case PNG::FilterType::Paeth: {
+            // With p = left + above - upper_left, these are the distances of p to left, above and upper_left.
+            auto distance_to_left = Vectors::abs(above - upper_left);
+            auto distance_to_above = Vectors::abs(left - upper_left);
+            auto distance_to_upper_left = Vectors::abs(left + above - 2 * upper_left);
+            auto nearest = Vectors::select(distance_to_above <= distance_to_upper_left, above, upper_left);
+            nearest = Vectors::select((distance_to_left <= distance_to_above) & (distance_to_left <= distance_to_upper_left), left, nearest);
+            pixel += nearest;
+            break;
+        }
+        default:
+            VERIFY_NOT_REACHED();
+        }
+
+        // Only the low byte of each lane counts, just like the filters' arithmetic is modulo 256.
+        pixel &= 0xff;
+        Vectors::store(data + i, pixel);
+        left = pixel;
+        upper_left = above;
+    }
+}
 
 static void unfilter_scanline(PNG::FilterType filter, Bytes scanline_data, ReadonlyBytes previous_scanlines_data, u8 bytes_per_complete_pixel)
 {
     VERIFY(filter != PNG::FilterType::None);
 
-    switch (filter) {
-    case PNG::FilterType::Sub:
-        // This loop starts at bytes_per_complete_pixel because all bytes before that are
-        // guaranteed to have no valid byte at index (i - bytes_per_complete pixel).
-        // All such invalid byte indexes should be treated as 0, and adding 0 to the current
-        // byte would do nothing, so the first bytes_per_complete_pixel bytes can instead
-        // just be skipped.
-        for (size_t i = bytes_per_complete_pixel; i < scanline_data.size(); ++i) {
-            u8 left = scanline_data[i - bytes_per_complete_pixel];
-            scanline_data[i] += left;
-        }
-        break;
-    case PNG::FilterType::Up:
-        for (size_t i = 0; i < scanline_data.size(); ++i) {
-            u8 above = previous_scanlines_data[i];
-            scanline_data[i] += above;
-        }
-        break;
-    case PNG::FilterType::Average:
-        for (size_t i = 0; i < scanline_data.size(); ++i) {
-            u32 left = (i < bytes_per_complete_pixel) ? 0 : scanline_data[i - bytes_per_complete_pixel];
-            u32 above = previous_scanlines_data[i];
-            u8 average = (left + above) / 2;
-            scanline_data[i] += average;
-        }
-        break;
-    case PNG::FilterType::Paeth:
-        for (size_t i = 0; i < scanline_data.size(); ++i) {
-            u8 left = (i < bytes_per_complete_pixel) ? 0 : scanline_data[i - bytes_per_complete_pixel];
-            u8 above = previous_scanlines_data[i];
-            u8 upper_left = (i < bytes_per_complete_pixel) ? 0 : previous_scanlines_data[i - bytes_per_complete_pixel];
-            i32 predictor = left + above - upper_left;
-            u32 predictor_left = abs(predictor - left);
-            u32 predictor_above = abs(predictor - above);
-            u32 predictor_upper_left = abs(predictor - upper_left);
-            u8 nearest;
-            if (predictor_left <= predictor_above && predictor_left <= predictor_upper_left) {
-                nearest = left;
-            } else if (predictor_above <= predictor_upper_left) {
-                nearest = above;
-            } else {
-                nearest = upper_left;
-            }
-            scanline_data[i] += nearest;
-        }
-        break;
+    if (filter == PNG::FilterType::Up) {
+        for (size_t i = 0; i < scanline_data.size(); ++i)
+            scanline_data[i] += previous_scanlines_data[i];
+        return;
+    }
+
+    switch (bytes_per_complete_pixel) {
+    case 1:
+        return unfilter_scanline_by_pixel<1>(filter, scanline_data, previous_scanlines_data);
+    case 2:
+        return unfilter_scanline_by_pixel<2>(filter, scanline_data, previous_scanlines_data);
+    case 3:
+        return unfilter_scanline_by_pixel<3>(filter, scanline_data, previous_scanlines_data);
+    case 4:
+        return unfilter_scanline_by_pixel<4>(filter, scanline_data, previous_scanlines_data);
+    case 6:
+        return unfilter_scanline_by_pixel<6>(filter, scanline_data, previous_scanlines_data);
+    case 8:
+        return unfilter_scanline_by_pixel<8>(filter, scanline_data, previous_scanlines_data);
     default:
         VERIFY_NOT_REACHED();
     }
 }
 
-template<typename T>
-ALWAYS_INLINE static void unpack_grayscale_without_alpha(PNGLoadingContext& context)
+ALWAYS_INLINE static ARGB32 make_pixel(u8 r, u8 g, u8 b, u8 a)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* gray_values = reinterpret_cast<T const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = gray_values[i];
-            pixel.g = gray_values[i];
-            pixel.b = gray_values[i];
-            pixel.a = 0xff;
-        }
-    }
+    return (a << 24) | (r << 16) | (g << 8) | b;
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_grayscale_with_alpha(PNGLoadingContext& context)
+ALWAYS_INLINE static void unpack_grayscale_without_alpha(ReadonlyBytes row, ARGB32* pixels, int width)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* tuples = reinterpret_cast<Tuple<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = tuples[i].gray;
-            pixel.g = tuples[i].gray;
-            pixel.b = tuples[i].gray;
-            pixel.a = tuples[i].a;
-        }
-    }
+    auto* gray_values = reinterpret_cast<T const*>(row.data());
+    for (int i = 0; i < width; ++i)
+        pixels[i] = make_pixel(gray_values[i], gray_values[i], gray_values[i], 0xff);
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_triplets_without_alpha(PNGLoadingContext& context)
+ALWAYS_INLINE static void unpack_grayscale_with_alpha(ReadonlyBytes row, ARGB32* pixels, int width)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* triplets = reinterpret_cast<Triplet<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = triplets[i].r;
-            pixel.g = triplets[i].g;
-            pixel.b = triplets[i].b;
-            pixel.a = 0xff;
-        }
-    }
+    auto* tuples = reinterpret_cast<Tuple<T> const*>(row.data());
+    for (int i = 0; i < width; ++i)
+        pixels[i] = make_pixel(tuples[i].gray, tuples[i].gray, tuples[i].gray, tuples[i].a);
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_triplets_with_transparency_value(PNGLoadingContext& context, Triplet<T> transparency_value)
+ALWAYS_INLINE static void unpack_triplets_without_alpha(ReadonlyBytes row, ARGB32* pixels, int width)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* triplets = reinterpret_cast<Triplet<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = triplets[i].r;
-            pixel.g = triplets[i].g;
-            pixel.b = triplets[i].b;
-            if (triplets[i] == transparency_value)
-                pixel.a = 0x00;
-            else
-                pixel.a = 0xff;
-        }
-    }
+    auto* triplets = reinterpret_cast<Triplet<T> const*>(row.data());
+    for (int i = 0; i < width; ++i)
+        pixels[i] = make_pixel(triplets[i].r, triplets[i].g, triplets[i].b, 0xff);
 }
 
-NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
+template<typename T>
+ALWAYS_INLINE static void unpack_triplets_with_transparency_value(ReadonlyBytes row, ARGB32* pixels, int width, Triplet<T> transparency_value)
 {
-    // First unfilter the scanlines:
-
-    // FIXME: Instead of creating a separate buffer for the scanlines that need to be
-    //        mutated, the mutation could be done in place (if the data was non-const).
-    size_t bytes_per_scanline = context.scanlines[0].data.size();
-    size_t bytes_needed_for_all_unfiltered_scanlines = 0;
-    for (int y = 0; y < context.height; ++y) {
-        if (context.scanlines[y].filter != PNG::FilterType::None) {
-            bytes_needed_for_all_unfiltered_scanlines += bytes_per_scanline;
-        }
-    }
-    context.unfiltered_data = TRY(ByteBuffer::create_uninitialized(bytes_needed_for_all_unfiltered_scanlines));
-
-    // From section 6.3 of http://www.libpng.org/pub/png/spec/1.2/PNG-Filters.html
-    // "bpp is defined as the number of bytes per complete pixel, rounding up to one.
-    // For example, for color type 2 with a bit depth of 16, bpp is equal to 6
-    // (three samples, two bytes per sample); for color type 0 with a bit depth of 2,
-    // bpp is equal to 1 (rounding up); for color type 4 with a bit depth of 16, bpp
-    // is equal to 4 (two-byte grayscale sample, plus two-byte alpha sample)."
-    u8 bytes_per_complete_pixel = (context.bit_depth + 7) / 8 * context.channels;
-
-    u8 dummy_scanline_bytes[bytes_per_scanline];
-    memset(dummy_scanline_bytes, 0, sizeof(dummy_scanline_bytes));
-    auto previous_scanlines_data = ReadonlyBytes { dummy_scanline_bytes, sizeof(dummy_scanline_bytes) };
-
-    for (int y = 0, data_start = 0; y < context.height; ++y) {
-        if (context.scanlines[y].filter != PNG::FilterType::None) {
-            auto scanline_data_slice = context.unfiltered_data.bytes().slice(data_start, bytes_per_scanline);
-
-            // Copy the current values over and set the scanline's data to the to-be-mutated slice
-            context.scanlines[y].data.copy_to(scanline_data_slice);
-            context.scanlines[y].data = scanline_data_slice;
-
-            unfilter_scanline(context.scanlines[y].filter, scanline_data_slice, previous_scanlines_data, bytes_per_complete_pixel);
-
-            data_start += bytes_per_scanline;
-        }
-        previous_scanlines_data = context.scanlines[y].data;
-    }
+    auto* triplets = reinterpret_cast<Triplet<T> const*>(row.data());
+    for (int i = 0; i < width; ++i)
+        pixels[i] = make_pixel(triplets[i].r, triplets[i].g, triplets[i].b, triplets[i] == transparency_value ? 0x00 : 0xff);
+}
 
-    // Now unpack the scanlines to RGBA:
+// Converts a row of unfiltered image data into `width` pixels.
+NEVER_INLINE FLATTEN static ErrorOr<void> unpack_row(PNGLoadingContext const& context, ReadonlyBytes row, ARGB32* pixels, int width)
+{
     switch (context.color_type) {
     case PNG::ColorType::Greyscale:
         if (context.bit_depth == 8) {
-            unpack_grayscale_without_alpha<u8>(context);
+            unpack_grayscale_without_alpha<u8>(row, pixels, width);
         } else if (context.bit_depth == 16) {
-            unpack_grayscale_without_alpha<u16>(context);
+            unpack_grayscale_without_alpha<u16>(row, pixels, width);
         } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
             auto bit_depth_squared = context.bit_depth * context.bit_depth;
             auto pixels_per_byte = 8 / context.bit_depth;
             auto mask = (1 << context.bit_depth) - 1;
-            for (int y = 0; y < context.height; ++y) {
-                auto* gray_values = context.scanlines[y].data.data();
-                for (int x = 0; x < context.width; ++x) {
-                    auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (x % pixels_per_byte));
-                    auto value = (gray_values[x / pixels_per_byte] >> bit_offset) & mask;
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[x];
-                    pixel.r = value * (0xff / bit_depth_squared);
-                    pixel.g = value * (0xff / bit_depth_squared);
-                    pixel.b = value * (0xff / bit_depth_squared);
-                    pixel.a = 0xff;
-                }
+            for (int x = 0; x < width; ++x) {
+                auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (x % pixels_per_byte));
+                auto value = (row[x / pixels_per_byte] >> bit_offset) & mask;
+                u8 gray = value * (0xff / bit_depth_squared);
+                pixels[x] = make_pixel(gray, gray, gray, 0xff);
             }
         } else {
             VERIFY_NOT_REACHED();
@@ -400,9 +372,9 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
         break;
     case PNG::ColorType::GreyscaleWithAlpha:
         if (context.bit_depth == 8) {
-            unpack_grayscale_with_alpha<u8>(context);
+            unpack_grayscale_with_alpha<u8>(row, pixels, width);
         } else if (context.bit_depth == 16) {
-            unpack_grayscale_with_alpha<u16>(context);
+            unpack_grayscale_with_alpha<u16>(row, pixels, width);
         } else {
             VERIFY_NOT_REACHED();
         }
@@ -410,82 +382,66 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
     case PNG::ColorType::Truecolor:
         if (context.palette_transparency_data.size() == 6) {
             if (context.bit_depth == 8) {
-                unpack_triplets_with_transparency_value<u8>(context, Triplet<u8> { context.palette_transparency_data[0], context.palette_transparency_data[2], context.palette_transparency_data[4] });
+                unpack_triplets_with_transparency_value<u8>(row, pixels, width, Triplet<u8> { context.palette_transparency_data[0], context.palette_transparency_data[2], context.palette_transparency_data[4] });
             } else if (context.bit_depth == 16) {
                 u16 tr = context.palette_transparency_data[0] | context.palette_transparency_data[1] << 8;
                 u16 tg = context.palette_transparency_data[2] | context.palette_transparency_data[3] << 8;
                 u16 tb = context.palette_transparency_data[4] | context.palette_transparency_data[5] << 8;
-                unpack_triplets_with_transparency_value<u16>(context, Triplet<u16> { tr, tg, tb });
+                unpack_triplets_with_transparency_value<u16>(row, pixels, width, Triplet<u16> { tr, tg, tb });
             } else {
                 VERIFY_NOT_REACHED();
             }
         } else {
             if (context.bit_depth == 8)
-                unpack_triplets_without_alpha<u8>(context);
+                unpack_triplets_without_alpha<u8>(row, pixels, width);
             else if (context.bit_depth == 16)
-                unpack_triplets_without_alpha<u16>(context);
+                unpack_triplets_without_alpha<u16>(row, pixels, width);
             else
                 VERIFY_NOT_REACHED();
         }
         break;
     case PNG::ColorType::TruecolorWithAlpha:
         if (context.bit_depth == 8) {
-            for (int y = 0; y < context.height; ++y) {
-                memcpy(context.bitmap->scanline(y), context.scanlines[y].data.data(), context.scanlines[y].data.size());
+            // RGBA to BGRA only swaps the red and blue bytes.
+            for (int i = 0; i < width; ++i) {
+                u32 rgba;
+                __builtin_memcpy(&rgba, row.data() + i * 4, sizeof(rgba));
+                pixels[i] = (rgba & 0xff00ff00) | ((rgba >> 16) & 0xff) | ((rgba & 0xff) << 16);
             }
         } else if (context.bit_depth == 16) {
-            for (int y = 0; y < context.height; ++y) {
-                auto* quartets = reinterpret_cast<Quartet<u16> const*>(context.scanlines[y].data.data());
-                for (int i = 0; i < context.width; ++i) {
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    pixel.r = quartets[i].r & 0xFF;
-                    pixel.g = quartets[i].g & 0xFF;
-                    pixel.b = quartets[i].b & 0xFF;
-                    pixel.a = quartets[i].a & 0xFF;
-                }
-            }
+            auto* quartets = reinterpret_cast<Quartet<u16> const*>(row.data());
+            for (int i = 0; i < width; ++i)
+                pixels[i] = make_pixel(quartets[i].r & 0xFF, quartets[i].g & 0xFF, quartets[i].b & 0xFF, quartets[i].a & 0xFF);
         } else {
             VERIFY_NOT_REACHED();
         }
         break;
     case PNG::ColorType::IndexedColor:
         if (context.bit_depth == 8) {
-            for (int y = 0; y < context.height; ++y) {
-                auto* palette_index = context.scanlines[y].data.data();
-                for (int i = 0; i < context.width; ++i) {
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    if (palette_index[i] >= context.palette_data.size())
-                        return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
-                    auto& color = context.palette_data.at((int)palette_index[i]);
-                    auto transparency = context.palette_transparency_data.size() >= palette_index[i] + 1u
-                        ? context.palette_transparency_data.data()[palette_index[i]]
-                        : 0xff;
-                    pixel.r = color.r;
-                    pixel.g = color.g;
-                    pixel.b = color.b;
-                    pixel.a = transparency;
-                }
+            auto* palette_index = row.data();
+            for (int i = 0; i < width; ++i) {
+                if (palette_index[i] >= context.palette_data.size())
+                    return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
+                auto& color = context.palette_data.at((int)palette_index[i]);
+                auto transparency = context.palette_transparency_data.size() >= palette_index[i] + 1u
+                    ? context.palette_transparency_data.data()[palette_index[i]]
+                    : 0xff;
+                pixels[i] = make_pixel(color.r, color.g, color.b, transparency);
             }
         } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
             auto pixels_per_byte = 8 / context.bit_depth;
             auto mask = (1 << context.bit_depth) - 1;
-            for (int y = 0; y < context.height; ++y) {
-                auto* palette_indices = context.scanlines[y].data.data();
-                for (int i = 0; i < context.width; ++i) {
-                    auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (i % pixels_per_byte));
-                    auto palette_index = (palette_indices[i / pixels_per_byte] >> bit_offset) & mask;
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    if ((size_t)palette_index >= context.palette_data.size())
-                        return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
-                    auto& color = context.palette_data.at(palette_index);
-                    auto transparency = context.palette_transparency_data.size() >= palette_index + 1u
-                        ? context.palette_transparency_data.data()[palette_index]
-                        : 0xff;
-                    pixel.r = color.r;
-                    pixel.g = color.g;
-                    pixel.b = color.b;
-                    pixel.a = transparency;
-                }
+            auto* palette_indices = row.data();
+            for (int i = 0; i < width; ++i) {
+                auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (i % pixels_per_byte));
+                auto palette_index = (palette_indices[i / pixels_per_byte] >> bit_offset) & mask;
+                if ((size_t)palette_index >= context.palette_data.size())
+                    return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
+                auto& color = context.palette_data.at(palette_index);
+                auto transparency = context.palette_transparency_data.size() >= palette_index + 1u
+                    ? context.palette_transparency_data.data()[palette_index]
+                    : 0xff;
+                pixels[i] = make_pixel(color.r, color.g, color.b, transparency);
             }
         } else {
             VERIFY_NOT_REACHED();
@@ -496,13 +452,42 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
         break;
     }
 
-    // Swap r and b values:
-    for (int y = 0; y < context.height; ++y) {
-        auto* pixels = (Pixel*)context.bitmap->scanline(y);
-        for (int i = 0; i < context.bitmap->width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-        }
+    return {};
+}
+
+// Reads the rows of an image, or of one pass of an interlaced image, from the decompressor as they're inflated,
+// and calls on_row() with each of them once they're unfiltered. Only the row and the one above it are kept around.
+template<typename Callback>
+static ErrorOr<void> decode_rows(PNGLoadingContext& context, Stream& decompressor, int width, int height, Callback on_row)
+{
+    auto row_size = context.compute_row_size_for_width(width);
+    if (row_size.has_overflow())
+        return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow");
+
+    // The filters treat the row above the first one as all zeroes.
+    auto rows = TRY(ByteBuffer::create_zeroed(row_size.value() * 2));
+    auto previous_row = rows.bytes().slice(0, row_size.value());
+    auto row = rows.bytes().slice(row_size.value());
+
+    u8 bytes_per_complete_pixel = (context.bit_depth + 7) / 8 * context.channels;
+
+    for (int y = 0; y < height; ++y) {
+        auto filter_or_error = decompressor.read_value<u8>();
+        if (filter_or_error.is_error())
+            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
+
+        auto filter = static_cast<PNG::FilterType>(filter_or_error.value());
+        if (to_underlying(filter) > 4)
+            return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter");
+
+        if (decompressor.read_entire_buffer(row).is_error())
+            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
+
+        if (filter != PNG::FilterType::None)
+            unfilter_scanline(filter, row, previous_row, bytes_per_complete_pixel);
+
+        TRY(on_row(y, row));
+        swap(row, previous_row);
     }
 
     return {};
@@ -585,36 +570,12 @@ static bool decode_png_chunks(PNGLoadingContext& context)
     return true;
 }
 
-static ErrorOr<void> decode_png_bitmap_simple(PNGLoadingContext& context)
+static ErrorOr<void> decode_png_bitmap_simple(PNGLoadingContext& context, Stream& decompressor)
 {
-    Streamer streamer(context.decompression_buffer->data(), context.decompression_buffer->size());
-
-    for (int y = 0; y < context.height; ++y) {
-        PNG::FilterType filter;
-        if (!streamer.read(filter)) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
-
-        if (to_underlying(filter) > 4) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter");
-        }
-
-        context.scanlines.append({ filter });
-        auto& scanline_buffer = context.scanlines.last().data;
-        auto row_size = context.compute_row_size_for_width(context.width);
-        if (row_size.has_overflow())
-            return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow");
-
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
-    }
-
     context.bitmap = TRY(Bitmap::create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
-    return unfilter(context);
+    return decode_rows(context, decompressor, context.width, context.height, [&](int y, ReadonlyBytes row) {
+        return unpack_row(context, row, context.bitmap->scanline(y), context.width);
+    });
 }
 
 static int adam7_height(PNGLoadingContext& context, int pass)
@@ -667,65 +628,59 @@ static int adam7_startx[8] = { 0, 0, 4, 0, 2, 0, 1, 0 };
 static int adam7_stepy[8] = { 1, 8, 8, 8, 4, 4, 2, 2 };
 static int adam7_stepx[8] = { 1, 8, 8, 4, 4, 2, 2, 1 };
 
-static ErrorOr<void> decode_adam7_pass(PNGLoadingContext& context, Streamer& streamer, int pass)
+static ErrorOr<void> decode_adam7_pass(PNGLoadingContext& context, Stream& decompressor, int pass)
 {
-    PNGLoadingContext subimage_context;
-    subimage_context.width = adam7_width(context, pass);
-    subimage_context.height = adam7_height(context, pass);
-    subimage_context.channels = context.channels;
-    subimage_context.color_type = context.color_type;
-    subimage_context.palette_data = context.palette_data;
-    subimage_context.palette_transparency_data = context.palette_transparency_data;
-    subimage_context.bit_depth = context.bit_depth;
-    subimage_context.filter_method = context.filter_method;
+    auto width = adam7_width(context, pass);
+    auto height = adam7_height(context, pass);
 
     // For small images, some passes might be empty
-    if (!subimage_context.width || !subimage_context.height)
+    if (!width || !height)
         return {};
 
-    subimage_context.scanlines.clear_with_capacity();
-    for (int y = 0; y < subimage_context.height; ++y) {
-        PNG::FilterType filter;
-        if (!streamer.read(filter)) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
-
-        if (to_underlying(filter) > 4) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter");
-        }
-
-        subimage_context.scanlines.append({ filter });
-        auto& scanline_buffer = subimage_context.scanlines.last().data;
-
-        auto row_size = context.compute_row_size_for_width(subimage_context.width);
-        if (row_size.has_overflow())
-            return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow");
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
-    }
+    Vector<ARGB32> pixels;
+    TRY(pixels.try_resize(width));
 
-    subimage_context.bitmap = TRY(Bitmap::create(context.bitmap->format(), { subimage_context.width, subimage_context.height }));
-    TRY(unfilter(subimage_context));
+    // Scatter each row of the pass into the image according to the pass pattern
+    return decode_rows(context, decompressor, width, height, [&](int y, ReadonlyBytes row) -> ErrorOr<void> {
+        TRY(unpack_row(context, row, pixels.data(), width));
+        auto* scanline = context.bitmap->scanline(adam7_starty[pass] + y * adam7_stepy[pass]);
+        for (int x = 0, dx = adam7_startx[pass]; x < width && dx < context.width; ++x, dx += adam7_stepx[pass])
+            scanline[dx] = pixels[x];
+        return {};
+    });
+}
 
-    // Copy the subimage data into the main image according to the pass pattern
-    for (int y = 0, dy = adam7_starty[pass]; y < subimage_context.height && dy < context.height; ++y, dy += adam7_stepy[pass]) {
-        for (int x = 0, dx = adam7_startx[pass]; x < subimage_context.width && dy < context.width; ++x, dx += adam7_stepx[pass]) {
-            context.bitmap->set_pixel(dx, dy, subimage_context.bitmap->get_pixel(x, y));
+// After each pass, the pixels decoded so far are spaced out on a regular grid. Copying each of them over the pixels to its
+// right and below, up to the next decoded ones, gives a blocky preview of the whole image. Every pixel is decoded by exactly
+// one pass, so the following passes overwrite these copies.
+static void fill_in_pixels_after_adam7_pass(PNGLoadingContext& context, int pass)
+{
+    static constexpr int grid_step_x[8] = { 1, 8, 4, 4, 2, 2, 1, 1 };
+    static constexpr int grid_step_y[8] = { 1, 8, 8, 4, 4, 2, 2, 1 };
+    auto step_x = grid_step_x[pass];
+    auto step_y = grid_step_y[pass];
+
+    for (int y = 0; y < context.height; y += step_y) {
+        auto* scanline = context.bitmap->scanline(y);
+        for (int x = 0; x < context.width; x += step_x) {
+            for (int dx = 1; dx < step_x && x + dx < context.width; ++dx)
+                scanline[x + dx] = scanline[x];
         }
+        for (int dy = 1; dy < step_y && y + dy < context.height; ++dy)
+            memcpy(context.bitmap->scanline(y + dy), scanline, context.width * sizeof(ARGB32));
     }
-    return {};
 }
 
-static ErrorOr<void> decode_png_adam7(PNGLoadingContext& context)
+static ErrorOr<void> decode_png_adam7(PNGLoadingContext& context, Stream& decompressor)
 {
-    Streamer streamer(context.decompression_buffer->data(), context.decompression_buffer->size());
     context.bitmap = TRY(Bitmap::create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
-    for (int pass = 1; pass <= 7; ++pass)
-        TRY(decode_adam7_pass(context, streamer, pass));
+    for (int pass = 1; pass <= 7; ++pass) {
+        TRY(decode_adam7_pass(context, decompressor, pass));
+        if (pass < 7 && context.on_interlaced_pass) {
+            fill_in_pixels_after_adam7_pass(context, pass);
+            context.on_interlaced_pass(*context.bitmap);
+        }
+    }
     return {};
 }
 
@@ -745,29 +700,33 @@ static ErrorOr<void> decode_png_bitmap(PNGLoadingContext& context)
     if (context.color_type == PNG::ColorType::IndexedColor && context.palette_data.is_empty())
         return Error::from_string_literal("PNGImageDecoderPlugin: Didn't see a PLTE chunk for a palletized image, or it was empty.");
 
-    auto result = Compress::ZlibDecompressor::decompress_all(context.compressed_data.span());
-    if (!result.has_value()) {
+    // Rather than inflating all of the image data up front, the rows are inflated one at a time as they're decoded.
+    auto zlib = Compress::ZlibDecompressor::try_create(context.compressed_data.span());
+    if (!zlib.has_value()) {
         context.state = PNGLoadingContext::State::Error;
         return Error::from_string_literal("PNGImageDecoderPlugin: Decompression failed");
     }
-    context.decompression_buffer = &result.value();
-    context.compressed_data.clear();
-
-    context.scanlines.ensure_capacity(context.height);
-    switch (context.interlace_method) {
-    case PngInterlaceMethod::Null:
-        TRY(decode_png_bitmap_simple(context));
-        break;
-    case PngInterlaceMethod::Adam7:
-        TRY(decode_png_adam7(context));
-        break;
-    default:
+    // Skip the zlib header, and leave out the Adler-32 checksum at the end.
+    auto deflate_data = context.compressed_data.span().slice(2, context.compressed_data.size() - 6);
+    auto compressed_stream = TRY(try_make<FixedMemoryStream>(deflate_data));
+    auto decompressor = TRY(Compress::DeflateDecompressor::construct(move(compressed_stream)));
+
+    auto result = [&]() -> ErrorOr<void> {
+        switch (context.interlace_method) {
+        case PngInterlaceMethod::Null:
+            return decode_png_bitmap_simple(context, *decompressor);
+        case PngInterlaceMethod::Adam7:
+            return decode_png_adam7(context, *decompressor);
+        default:
+            return Error::from_string_literal("PNGImageDecoderPlugin: Invalid interlace method");
+        }
+    }();
+    if (result.is_error()) {
         context.state = PNGLoadingContext::State::Error;
-        return Error::from_string_literal("PNGImageDecoderPlugin: Invalid interlace method");
+        return result.release_error();
     }
 
-    context.decompression_buffer = nullptr;
-
+    context.compressed_data.clear();
     context.state = PNGLoadingContext::State::BitmapDecoded;
     return {};
 }
@@ -1108,4 +1067,9 @@ ErrorOr<Optional<ReadonlyBytes>> PNGImageDecoderPlugin::icc_data()
     return OptionalNone {};
 }
 
+void PNGImageDecoderPlugin::set_on_interlaced_pass(Function<void(Bitmap const&)> on_interlaced_pass)
+{
+    m_context->on_interlaced_pass = move(on_interlaced_pass);
+}
+
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <LibGfx/ImageDecoder.h>
 
 namespace Gfx {
@@ -29,6 +30,10 @@ public:
     virtual ErrorOr<ImageFrameDescriptor> frame(size_t index) override;
     virtual ErrorOr<Optional<ReadonlyBytes>> icc_data() override;
 
+    // Called with the partially decoded bitmap after each but the last pass of an interlaced image,
+    // with the pixels that haven't been decoded yet filled in from their neighbours.
+    void set_on_interlaced_pass(Function<void(Bitmap const&)>);
+
 private:
     PNGImageDecoderPlugin(u8 const*, size_t);
 
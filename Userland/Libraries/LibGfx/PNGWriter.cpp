@@ -9,11 +9,15 @@
 #include <AK/Concepts.h>
 #include <AK/DeprecatedString.h>
 #include <AK/FixedArray.h>
+#include <AK/MemoryStream.h>
 #include <AK/SIMDExtras.h>
+#include <LibCompress/Deflate.h>
 #include <LibCompress/Zlib.h>
+#include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Checksum/CRC32.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/PNGWriter.h>
+#include <LibThreading/ThreadPool.h>
 
 #pragma GCC diagnostic ignored "-Wpsabi"
 
@@ -167,56 +171,52 @@ union [[gnu::packed]] Pixel {
 };
 static_assert(AssertSize<Pixel, 4>());
 
-ErrorOr<void> PNGWriter::add_IDAT_chunk(Gfx::Bitmap const& bitmap)
-{
-    PNGChunk png_chunk { "IDAT" };
-    TRY(png_chunk.reserve(bitmap.size_in_bytes()));
-
-    ByteBuffer uncompressed_block_data;
-    TRY(uncompressed_block_data.try_ensure_capacity(bitmap.size_in_bytes() + bitmap.height()));
-
-    auto dummy_scanline = TRY(FixedArray<Pixel>::create(bitmap.width()));
-    auto const* scanline_minus_1 = dummy_scanline.data();
-
-    for (int y = 0; y < bitmap.height(); ++y) {
-        auto* scanline = reinterpret_cast<Pixel const*>(bitmap.scanline(y));
+static Threading::ThreadPool* s_encoding_thread_pool;
 
-        struct Filter {
-            PNG::FilterType type;
-            ByteBuffer buffer {};
-            int sum = 0;
+void PNGWriter::set_encoding_thread_pool(Threading::ThreadPool* thread_pool)
+{
+    s_encoding_thread_pool = thread_pool;
+}
 
-            ErrorOr<void> append(u8 byte)
-            {
-                TRY(buffer.try_append(byte));
-                sum += static_cast<i8>(byte);
-                return {};
-            }
+// Every chunk of rows is compressed without looking back into the chunks before it,
+// so chunks that are too small give up more compression than they save time.
+static constexpr size_t minimum_bytes_per_parallel_chunk = 256 * KiB;
 
-            ErrorOr<void> append(AK::SIMD::u8x4 simd)
-            {
-                TRY(append(simd[0]));
-                TRY(append(simd[1]));
-                TRY(append(simd[2]));
-                TRY(append(simd[3]));
-                return {};
+// Appends the rows [first_row, first_row + row_count) of the bitmap to `output`, each of them preceded by its filter type.
+static ErrorOr<void> append_filtered_rows(ByteBuffer& output, Gfx::Bitmap const& bitmap, int first_row, int row_count)
+{
+    size_t const row_size = bitmap.width() * sizeof(Pixel);
+
+    struct Filter {
+        PNG::FilterType type;
+        u8* data { nullptr };
+        int sum = 0;
+
+        ALWAYS_INLINE void store(int x, AK::SIMD::u8x4 simd)
+        {
+            for (size_t i = 0; i < 4; ++i) {
+                data[x * sizeof(Pixel) + i] = simd[i];
+                sum += static_cast<i8>(simd[i]);
             }
-        };
-
-        Filter none_filter { .type = PNG::FilterType::None };
-        TRY(none_filter.buffer.try_ensure_capacity(sizeof(Pixel) * bitmap.height()));
+        }
+    };
 
-        Filter sub_filter { .type = PNG::FilterType::Sub };
-        TRY(sub_filter.buffer.try_ensure_capacity(sizeof(Pixel) * bitmap.height()));
+    // The five filtered versions of the current row, which are reused for every row.
+    auto filtered_rows = TRY(FixedArray<u8>::create(row_size * 5));
+    Filter none_filter { .type = PNG::FilterType::None, .data = filtered_rows.data() };
+    Filter sub_filter { .type = PNG::FilterType::Sub, .data = filtered_rows.data() + row_size };
+    Filter up_filter { .type = PNG::FilterType::Up, .data = filtered_rows.data() + row_size * 2 };
+    Filter average_filter { .type = PNG::FilterType::Average, .data = filtered_rows.data() + row_size * 3 };
+    Filter paeth_filter { .type = PNG::FilterType::Paeth, .data = filtered_rows.data() + row_size * 4 };
 
-        Filter up_filter { .type = PNG::FilterType::Up };
-        TRY(up_filter.buffer.try_ensure_capacity(sizeof(Pixel) * bitmap.height()));
+    auto dummy_scanline = TRY(FixedArray<Pixel>::create(bitmap.width()));
+    auto const* scanline_minus_1 = first_row == 0 ? dummy_scanline.data() : reinterpret_cast<Pixel const*>(bitmap.scanline(first_row - 1));
 
-        Filter average_filter { .type = PNG::FilterType::Average };
-        TRY(average_filter.buffer.try_ensure_capacity(sizeof(ARGB32) * bitmap.height()));
+    for (int y = first_row; y < first_row + row_count; ++y) {
+        auto* scanline = reinterpret_cast<Pixel const*>(bitmap.scanline(y));
 
-        Filter paeth_filter { .type = PNG::FilterType::Paeth };
-        TRY(paeth_filter.buffer.try_ensure_capacity(sizeof(ARGB32) * bitmap.height()));
+        for (auto* filter : { &none_filter, &sub_filter, &up_filter, &average_filter, &paeth_filter })
+            filter->sum = 0;
 
         auto pixel_x_minus_1 = Pixel::gfx_to_png(dummy_scanline[0]);
         auto pixel_xy_minus_1 = Pixel::gfx_to_png(dummy_scanline[0]);
@@ -225,18 +225,18 @@ ErrorOr<void> PNGWriter::add_IDAT_chunk(Gfx::Bitmap const& bitmap)
             auto pixel = Pixel::gfx_to_png(scanline[x]);
             auto pixel_y_minus_1 = Pixel::gfx_to_png(scanline_minus_1[x]);
 
-            TRY(none_filter.append(pixel));
+            none_filter.store(x, pixel);
 
-            TRY(sub_filter.append(pixel - pixel_x_minus_1));
+            sub_filter.store(x, pixel - pixel_x_minus_1);
 
-            TRY(up_filter.append(pixel - pixel_y_minus_1));
+            up_filter.store(x, pixel - pixel_y_minus_1);
 
             // The sum Orig(a) + Orig(b) shall be performed without overflow (using at least nine-bit arithmetic).
             auto sum = AK::SIMD::to_u16x4(pixel_x_minus_1) + AK::SIMD::to_u16x4(pixel_y_minus_1);
             auto average = AK::SIMD::to_u8x4(sum / 2);
-            TRY(average_filter.append(pixel - average));
+            average_filter.store(x, pixel - average);
 
-            TRY(paeth_filter.append(pixel - PNG::paeth_predictor(pixel_x_minus_1, pixel_y_minus_1, pixel_xy_minus_1)));
+            paeth_filter.store(x, pixel - PNG::paeth_predictor(pixel_x_minus_1, pixel_y_minus_1, pixel_xy_minus_1));
 
             pixel_x_minus_1 = pixel;
             pixel_xy_minus_1 = pixel_y_minus_1;
@@ -250,33 +250,97 @@ ErrorOr<void> PNGWriter::add_IDAT_chunk(Gfx::Bitmap const& bitmap)
         // The following simple heuristic has performed well in early tests:
         // compute the output scanline using all five filters, and select the filter that gives the smallest sum of absolute values of outputs.
         // (Consider the output bytes as signed differences for this test.)
-        Filter& best_filter = none_filter;
-        if (abs(best_filter.sum) > abs(sub_filter.sum))
-            best_filter = sub_filter;
-        if (abs(best_filter.sum) > abs(up_filter.sum))
-            best_filter = up_filter;
-        if (abs(best_filter.sum) > abs(average_filter.sum))
-            best_filter = average_filter;
-        if (abs(best_filter.sum) > abs(paeth_filter.sum))
-            best_filter = paeth_filter;
-
-        TRY(uncompressed_block_data.try_append(to_underlying(best_filter.type)));
-        TRY(uncompressed_block_data.try_append(best_filter.buffer));
+        Filter* best_filter = &none_filter;
+        for (auto* filter : { &sub_filter, &up_filter, &average_filter, &paeth_filter }) {
+            if (abs(best_filter->sum) > abs(filter->sum))
+                best_filter = filter;
+        }
+
+        TRY(output.try_append(to_underlying(best_filter->type)));
+        TRY(output.try_append(best_filter->data, row_size));
     }
 
-    auto zlib_buffer = TRY(Compress::ZlibCompressor::compress_all(uncompressed_block_data, Compress::ZlibCompressionLevel::Best));
+    return {};
+}
+
+struct CompressedRows {
+    ByteBuffer data;
+    u32 adler32 { 1 };
+    size_t uncompressed_size { 0 };
+    Optional<Error> error;
+};
+
+// Filters and deflates a chunk of rows. Every chunk but the last one ends with a sync flush, so that all of them can be put together into one stream.
+static ErrorOr<void> compress_rows(CompressedRows& compressed_rows, Gfx::Bitmap const& bitmap, int first_row, int row_count, Compress::ZlibCompressionLevel compression_level, bool is_last_chunk)
+{
+    ByteBuffer uncompressed_block_data;
+    TRY(uncompressed_block_data.try_ensure_capacity(row_count * (1 + bitmap.width() * sizeof(Pixel))));
+    TRY(append_filtered_rows(uncompressed_block_data, bitmap, first_row, row_count));
+
+    compressed_rows.adler32 = Crypto::Checksum::Adler32(uncompressed_block_data).digest();
+    compressed_rows.uncompressed_size = uncompressed_block_data.size();
+
+    AllocatingMemoryStream output_stream;
+    auto deflate_stream = TRY(Compress::DeflateCompressor::construct(MaybeOwned<Stream>(output_stream), Compress::ZlibCompressor::deflate_compression_level(compression_level)));
+    TRY(deflate_stream->write_entire_buffer(uncompressed_block_data));
+    if (is_last_chunk)
+        TRY(deflate_stream->final_flush());
+    else
+        TRY(deflate_stream->sync_flush_and_finish());
+
+    compressed_rows.data = TRY(ByteBuffer::create_uninitialized(output_stream.used_buffer_size()));
+    TRY(output_stream.read_entire_buffer(compressed_rows.data));
+    return {};
+}
+
+ErrorOr<void> PNGWriter::add_IDAT_chunk(Gfx::Bitmap const& bitmap, Compress::ZlibCompressionLevel compression_level)
+{
+    size_t const height = bitmap.height();
+    size_t const filtered_row_size = 1 + bitmap.width() * sizeof(Pixel);
+
+    size_t chunk_count = 1;
+    if (s_encoding_thread_pool)
+        chunk_count = clamp(filtered_row_size * height / minimum_bytes_per_parallel_chunk, 1, s_encoding_thread_pool->worker_count() * 2);
+
+    Vector<CompressedRows> chunks;
+    TRY(chunks.try_resize(chunk_count));
+
+    auto compress_chunk = [&](size_t chunk) {
+        auto first_row = chunk * height / chunk_count;
+        auto end_row = (chunk + 1) * height / chunk_count;
+        if (auto result = compress_rows(chunks[chunk], bitmap, first_row, end_row - first_row, compression_level, chunk == chunk_count - 1); result.is_error())
+            chunks[chunk].error = result.release_error();
+    };
+    if (chunk_count == 1)
+        compress_chunk(0);
+    else
+        Threading::parallel_for(chunk_count, compress_chunk, 1, *s_encoding_thread_pool);
+
+    PNGChunk png_chunk { "IDAT" };
+
+    auto zlib_header = Compress::ZlibCompressor::header_for(Compress::ZlibCompressionMethod::Deflate, compression_level);
+    auto zlib_header_bytes = zlib_header.as_u16.bytes();
+    TRY(png_chunk.add(zlib_header_bytes.data(), zlib_header_bytes.size()));
+
+    u32 adler32 = 1;
+    for (auto& chunk : chunks) {
+        if (chunk.error.has_value())
+            return chunk.error.release_value();
+        TRY(png_chunk.add(chunk.data.data(), chunk.data.size()));
+        adler32 = Crypto::Checksum::Adler32::combine(adler32, chunk.adler32, chunk.uncompressed_size);
+    }
+    TRY(png_chunk.add_as_big_endian(adler32));
 
-    TRY(png_chunk.add(zlib_buffer.data(), zlib_buffer.size()));
     TRY(add_chunk(png_chunk));
     return {};
 }
 
-ErrorOr<ByteBuffer> PNGWriter::encode(Gfx::Bitmap const& bitmap)
+ErrorOr<ByteBuffer> PNGWriter::encode(Gfx::Bitmap const& bitmap, PNGWriterOptions options)
 {
     PNGWriter writer;
     TRY(writer.add_png_header());
     TRY(writer.add_IHDR_chunk(bitmap.width(), bitmap.height(), 8, PNG::ColorType::TruecolorWithAlpha, 0, 0, 0));
-    TRY(writer.add_IDAT_chunk(bitmap));
+    TRY(writer.add_IDAT_chunk(bitmap, options.compression_level));
     TRY(writer.add_IEND_chunk());
     return ByteBuffer::copy(writer.m_data);
 }
@@ -8,16 +8,30 @@
 #pragma once
 
 #include <AK/Vector.h>
+#include <LibCompress/Zlib.h>
 #include <LibGfx/Forward.h>
 #include <LibGfx/PNGShared.h>
 
+namespace Threading {
+class ThreadPool;
+}
+
 namespace Gfx {
 
 class PNGChunk;
 
+struct PNGWriterOptions {
+    // Screenshots and other images that are written while somebody waits can trade some of their size for a lot less time spent compressing.
+    Compress::ZlibCompressionLevel compression_level { Compress::ZlibCompressionLevel::Best };
+};
+
 class PNGWriter {
 public:
-    static ErrorOr<ByteBuffer> encode(Gfx::Bitmap const&);
+    static ErrorOr<ByteBuffer> encode(Gfx::Bitmap const&, PNGWriterOptions = {});
+
+    // Large images are split into chunks of rows that are filtered and compressed in parallel on this pool, if there is one.
+    // NOTE: Using the pool needs the "thread" pledge, so it's up to each process to opt into this.
+    static void set_encoding_thread_pool(Threading::ThreadPool*);
 
 private:
     PNGWriter() = default;
@@ -26,7 +40,7 @@ private:
     ErrorOr<void> add_chunk(PNGChunk&);
     ErrorOr<void> add_png_header();
     ErrorOr<void> add_IHDR_chunk(u32 width, u32 height, u8 bit_depth, PNG::ColorType color_type, u8 compression_method, u8 filter_method, u8 interlace_method);
-    ErrorOr<void> add_IDAT_chunk(Gfx::Bitmap const&);
+    ErrorOr<void> add_IDAT_chunk(Gfx::Bitmap const&, Compress::ZlibCompressionLevel);
     ErrorOr<void> add_IEND_chunk();
 };
 
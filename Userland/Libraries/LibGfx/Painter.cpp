@@ -31,6 +31,7 @@
 #include <LibGfx/Palette.h>
 #include <LibGfx/Path.h>
 #include <LibGfx/Quad.h>
+#include <LibGfx/RowBlending.h>
 #include <LibGfx/TextDirection.h>
 #include <LibGfx/TextLayout.h>
 #include <stdio.h>
@@ -121,8 +122,7 @@ void Painter::fill_physical_rect(IntRect const& physical_rect, Color color)
     size_t const dst_skip = m_target->pitch() / sizeof(ARGB32);
 
     for (int i = physical_rect.height() - 1; i >= 0; --i) {
-        for (int j = 0; j < physical_rect.width(); ++j)
-            dst[j] = Color::from_argb(dst[j]).blend(color).value();
+        blend_color_onto_row(dst, color, physical_rect.width());
         dst += dst_skip;
     }
 }
@@ -816,56 +816,35 @@ void Painter::draw_triangle(IntPoint a, IntPoint b, IntPoint c, Color color)
 }
 
 struct BlitState {
-    enum AlphaState {
-        NoAlpha = 0,
-        SrcAlpha = 1,
-        DstAlpha = 2,
-        BothAlpha = SrcAlpha | DstAlpha
-    };
-
     ARGB32 const* src;
     ARGB32* dst;
     size_t src_pitch;
     size_t dst_pitch;
     int row_count;
     int column_count;
-    float opacity;
     BitmapFormat src_format;
 };
 
-// FIXME: This is a hack to support blit_with_opacity() with RGBA8888 source.
-//        Ideally we'd have a more generic solution that allows any source format.
-static void swap_red_and_blue_channels(Color& color)
+static void do_blit_with_opacity(BlitState& state, RowBlendingOptions options)
 {
-    u32 rgba = color.value();
-    u32 bgra = (rgba & 0xff00ff00)
-        | ((rgba & 0x000000ff) << 16)
-        | ((rgba & 0x00ff0000) >> 16);
-    color = Color::from_argb(bgra);
-}
+    // FIXME: This is a hack to support blit_with_opacity() with RGBA8888 source.
+    //        Ideally we'd have a more generic solution that allows any source format.
+    Vector<ARGB32> swapped_row;
+    if (state.src_format == BitmapFormat::RGBA8888)
+        swapped_row.resize(state.column_count);
 
-// FIXME: This function is very unoptimized.
-template<BlitState::AlphaState has_alpha>
-static void do_blit_with_opacity(BlitState& state)
-{
     for (int row = 0; row < state.row_count; ++row) {
-        for (int x = 0; x < state.column_count; ++x) {
-            Color dest_color = (has_alpha & BlitState::DstAlpha) ? Color::from_argb(state.dst[x]) : Color::from_rgb(state.dst[x]);
-            if constexpr (has_alpha & BlitState::SrcAlpha) {
-                Color src_color_with_alpha = Color::from_argb(state.src[x]);
-                if (state.src_format == BitmapFormat::RGBA8888)
-                    swap_red_and_blue_channels(src_color_with_alpha);
-                float pixel_opacity = src_color_with_alpha.alpha() / 255.0;
-                src_color_with_alpha.set_alpha(255 * (state.opacity * pixel_opacity));
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
-            } else {
-                Color src_color_with_alpha = Color::from_rgb(state.src[x]);
-                if (state.src_format == BitmapFormat::RGBA8888)
-                    swap_red_and_blue_channels(src_color_with_alpha);
-                src_color_with_alpha.set_alpha(state.opacity * 255);
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
+        auto const* src = state.src;
+        if (state.src_format == BitmapFormat::RGBA8888) {
+            for (int x = 0; x < state.column_count; ++x) {
+                u32 rgba = state.src[x];
+                swapped_row[x] = (rgba & 0xff00ff00)
+                    | ((rgba & 0x000000ff) << 16)
+                    | ((rgba & 0x00ff0000) >> 16);
             }
+            src = swapped_row.data();
         }
+        blend_row(state.dst, src, state.column_count, options);
         state.dst += state.dst_pitch;
         state.src += state.src_pitch;
     }
@@ -904,24 +883,24 @@ void Painter::blit_with_opacity(IntPoint position, Gfx::Bitmap const& source, In
         .dst_pitch = m_target->pitch() / sizeof(ARGB32),
         .row_count = last_row - first_row + 1,
         .column_count = last_column - first_column + 1,
-        .opacity = opacity,
         .src_format = source.format(),
     };
 
-    if (source.has_alpha_channel() && apply_alpha) {
-        if (m_target->has_alpha_channel())
-            do_blit_with_opacity<BlitState::BothAlpha>(blit_state);
-        else
-            do_blit_with_opacity<BlitState::SrcAlpha>(blit_state);
-    } else {
-        if (m_target->has_alpha_channel())
-            do_blit_with_opacity<BlitState::DstAlpha>(blit_state);
-        else
-            do_blit_with_opacity<BlitState::NoAlpha>(blit_state);
-    }
+    do_blit_with_opacity(blit_state,
+        {
+            .opacity = row_blending_opacity(opacity),
+            .source_has_alpha = source.has_alpha_channel() && apply_alpha,
+            .destination_has_alpha = m_target->has_alpha_channel(),
+        });
 }
 
 void Painter::blit_filtered(IntPoint position, Gfx::Bitmap const& source, IntRect const& src_rect, Function<Color(Color)> filter)
+{
+    do_blit_filtered(position, source, src_rect, filter);
+}
+
+template<typename Filter>
+ALWAYS_INLINE void Painter::do_blit_filtered(IntPoint position, Gfx::Bitmap const& source, IntRect const& src_rect, Filter const& filter)
 {
     VERIFY((source.scale() == 1 || source.scale() == scale()) && "blit_filtered only supports integer upsampling");
 
@@ -1140,22 +1119,28 @@ ALWAYS_INLINE static void do_draw_integer_scaled_bitmap(Gfx::Bitmap& target, Int
     int x_limit = min(target.physical_width() - 1, dst_rect.right());
     int y_limit = min(target.physical_height() - 1, dst_rect.bottom());
     bool has_opacity = opacity != 1.0f;
+    if (x_limit < dst_rect.x())
+        return;
+
+    // NOTE: Each source row becomes a row of scaled pixels first, which then gets blended onto vfactor rows of the target at once.
+    Vector<ARGB32> scaled_row;
+    scaled_row.resize(min(x_limit - dst_rect.x() + 1, src_rect.width() * hfactor));
     for (int y = 0; y < src_rect.height(); ++y) {
         int dst_y = dst_rect.y() + y * vfactor;
         for (int x = 0; x < src_rect.width(); ++x) {
             auto src_pixel = get_pixel(source, x + src_rect.left(), y + src_rect.top());
-            if (has_opacity)
+            if (has_opacity && !has_alpha_channel)
                 src_pixel.set_alpha(src_pixel.alpha() * opacity);
-            for (int yo = 0; yo < vfactor && dst_y + yo <= y_limit; ++yo) {
-                auto* scanline = (Color*)target.scanline(dst_y + yo);
-                int dst_x = dst_rect.x() + x * hfactor;
-                for (int xo = 0; xo < hfactor && dst_x + xo <= x_limit; ++xo) {
-                    if constexpr (has_alpha_channel)
-                        scanline[dst_x + xo] = scanline[dst_x + xo].blend(src_pixel);
-                    else
-                        scanline[dst_x + xo] = src_pixel;
-                }
-            }
+            int scaled_x = x * hfactor;
+            for (int xo = 0; xo < hfactor && scaled_x + xo < static_cast<int>(scaled_row.size()); ++xo)
+                scaled_row[scaled_x + xo] = src_pixel.value();
+        }
+        for (int yo = 0; yo < vfactor && dst_y + yo <= y_limit; ++yo) {
+            auto* scanline = target.scanline(dst_y + yo) + dst_rect.x();
+            if constexpr (has_alpha_channel)
+                blend_row(scanline, scaled_row.data(), scaled_row.size(), { .opacity = row_blending_opacity(opacity) });
+            else
+                memcpy(scanline, scaled_row.data(), scaled_row.size() * sizeof(ARGB32));
         }
     }
 }
@@ -1200,16 +1185,31 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
     i64 clipped_src_bottom_shifted = (clipped_src_rect.y() + clipped_src_rect.height()) * shift;
     i64 clipped_src_right_shifted = (clipped_src_rect.x() + clipped_src_rect.width()) * shift;
 
+    // NOTE: With an alpha channel, we collect runs of sampled pixels and blend each run onto the target at once.
+    Vector<ARGB32> run;
+    int run_start = 0;
+    RowBlendingOptions blending_options { .opacity = row_blending_opacity(opacity) };
+
     for (int y = clipped_rect.top(); y <= clipped_rect.bottom(); ++y) {
         auto* scanline = (Color*)target.scanline(y);
         auto desired_y = ((y - dst_rect.y()) * vscale + src_top);
         if (desired_y < clipped_src_rect.top() || desired_y > clipped_src_bottom_shifted)
             continue;
 
+        auto blend_run = [&] {
+            if (run.is_empty())
+                return;
+            blend_row(target.scanline(y) + run_start, run.data(), run.size(), blending_options);
+            run.clear_with_capacity();
+        };
+
         for (int x = clipped_rect.left(); x <= clipped_rect.right(); ++x) {
             auto desired_x = ((x - dst_rect.x()) * hscale + src_left);
-            if (desired_x < clipped_src_rect.left() || desired_x > clipped_src_right_shifted)
+            if (desired_x < clipped_src_rect.left() || desired_x > clipped_src_right_shifted) {
+                if constexpr (has_alpha_channel)
+                    blend_run();
                 continue;
+            }
 
             Color src_pixel;
             if constexpr (scaling_mode == Painter::ScalingMode::BilinearBlend) {
@@ -1260,14 +1260,19 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
                 src_pixel = get_pixel(source, scaled_x, scaled_y);
             }
 
-            if (has_opacity)
-                src_pixel.set_alpha(src_pixel.alpha() * opacity);
             if constexpr (has_alpha_channel) {
-                scanline[x] = scanline[x].blend(src_pixel);
+                if (run.is_empty())
+                    run_start = x;
+                run.append(src_pixel.value());
             } else {
+                if (has_opacity)
+                    src_pixel.set_alpha(src_pixel.alpha() * opacity);
                 scanline[x] = src_pixel;
             }
         }
+
+        if constexpr (has_alpha_channel)
+            blend_run();
     }
 }
 
@@ -1368,12 +1373,18 @@ FLATTEN void Painter::draw_glyph(FloatPoint point, u32 code_point, Font const& f
     if (glyph.is_glyph_bitmap()) {
         draw_bitmap(top_left.to_type<int>(), glyph.glyph_bitmap(), color);
     } else {
-        blit_filtered(glyph_position.blit_position, *glyph.bitmap(), glyph.bitmap()->rect(), [color](Color pixel) -> Color {
+        do_blit_filtered(glyph_position.blit_position, *glyph.bitmap(), glyph.bitmap_rect(), [color](Color pixel) -> Color {
             return pixel.multiply(color);
         });
     }
 }
 
+FLATTEN void Painter::draw_glyph_run(ReadonlySpan<DrawGlyph> glyphs, Font const& font, Color color)
+{
+    for (auto const& glyph : glyphs)
+        draw_glyph(glyph.position, glyph.code_point, font, color);
+}
+
 void Painter::draw_emoji(IntPoint point, Gfx::Bitmap const& emoji, Font const& font)
 {
     IntRect dst_rect {
@@ -1393,14 +1404,26 @@ void Painter::draw_glyph_or_emoji(FloatPoint point, u32 code_point, Font const&
     return draw_glyph_or_emoji(point, it, font, color);
 }
 
-void Painter::draw_glyph_or_emoji(FloatPoint point, Utf8CodePointIterator& it, Font const& font, Color color)
+// FIXME: These should live somewhere else.
+static constexpr u32 text_variation_selector = 0xFE0E;
+static constexpr u32 emoji_variation_selector = 0xFE0F;
+static constexpr u32 regional_indicator_symbol_a = 0x1F1E6;
+static constexpr u32 regional_indicator_symbol_z = 0x1F1FF;
+
+// Whether draw_glyph_or_emoji() would draw just the font's glyph for the code point, without consuming any more code points.
+static bool is_plain_text_glyph(Utf8CodePointIterator const& it, Font const& font)
 {
-    // FIXME: These should live somewhere else.
-    constexpr u32 text_variation_selector = 0xFE0E;
-    constexpr u32 emoji_variation_selector = 0xFE0F;
-    constexpr u32 regional_indicator_symbol_a = 0x1F1E6;
-    constexpr u32 regional_indicator_symbol_z = 0x1F1FF;
+    auto code_point = *it;
+    if (code_point >= regional_indicator_symbol_a && code_point <= regional_indicator_symbol_z)
+        return false;
+    auto next_code_point = it.peek(1);
+    if (next_code_point == text_variation_selector || next_code_point == emoji_variation_selector)
+        return false;
+    return font.contains_glyph(code_point);
+}
 
+void Painter::draw_glyph_or_emoji(FloatPoint point, Utf8CodePointIterator& it, Font const& font, Color color)
+{
     auto initial_it = it;
     u32 code_point = *it;
     auto next_code_point = it.peek(1);
@@ -2503,6 +2526,13 @@ void Painter::draw_text_run(FloatPoint baseline_start, Utf8View const& string, F
 
     u32 last_code_point = 0;
 
+    // Plain text glyphs are collected into runs, and only emojis and the like go through draw_glyph_or_emoji().
+    Vector<DrawGlyph, 64> glyph_run;
+    auto flush_glyph_run = [&] {
+        draw_glyph_run(glyph_run, font, color);
+        glyph_run.clear_with_capacity();
+    };
+
     for (auto code_point_iterator = string.begin(); code_point_iterator != string.end(); ++code_point_iterator) {
         auto code_point = *code_point_iterator;
         if (should_paint_as_space(code_point)) {
@@ -2513,10 +2543,16 @@ void Painter::draw_text_run(FloatPoint baseline_start, Utf8View const& string, F
 
         // FIXME: this is probably not the real space taken for complex emojis
         x += font.glyphs_horizontal_kerning(last_code_point, code_point);
-        draw_glyph_or_emoji(FloatPoint { x, y }, code_point_iterator, font, color);
+        if (is_plain_text_glyph(code_point_iterator, font)) {
+            glyph_run.append({ FloatPoint { x, y }, code_point });
+        } else {
+            flush_glyph_run();
+            draw_glyph_or_emoji(FloatPoint { x, y }, code_point_iterator, font, color);
+        }
         x += font.glyph_or_emoji_width(code_point) + font.glyph_spacing();
         last_code_point = code_point;
     }
+    flush_glyph_run();
 }
 
 void Painter::draw_scaled_bitmap_with_transform(IntRect const& dst_rect, Bitmap const& bitmap, FloatRect const& src_rect, AffineTransform const& transform, float opacity, Painter::ScalingMode scaling_mode)
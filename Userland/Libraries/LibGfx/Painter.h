@@ -25,6 +25,11 @@
 
 namespace Gfx {
 
+struct DrawGlyph {
+    FloatPoint position;
+    u32 code_point { 0 };
+};
+
 class Painter {
 public:
     static constexpr int LINE_SPACING = 4;
@@ -111,6 +116,8 @@ public:
     void draw_glyph(FloatPoint, u32, Font const&, Color);
     void draw_glyph_or_emoji(FloatPoint, u32, Font const&, Color);
     void draw_glyph_or_emoji(FloatPoint, Utf8CodePointIterator&, Font const&, Color);
+    // Draws the font's glyphs for the code points, without looking for emojis.
+    void draw_glyph_run(ReadonlySpan<DrawGlyph>, Font const&, Color);
     void draw_circle_arc_intersecting(IntRect const&, IntPoint, int radius, Color, int thickness);
 
     // Streamlined text drawing routine that does no wrapping/elision/alignment.
@@ -213,6 +220,8 @@ protected:
 private:
     Vector<DirectionalRun> split_text_into_directional_runs(Utf8View const&, TextDirection initial_direction);
     bool text_contains_bidirectional_text(Utf8View const&, TextDirection);
+    template<typename Filter>
+    void do_blit_filtered(IntPoint, Gfx::Bitmap const&, IntRect const& src_rect, Filter const&);
     template<typename DrawGlyphFunction>
     void do_draw_text(FloatRect const&, Utf8View const& text, Font const&, TextAlignment, TextElision, TextWrapping, DrawGlyphFunction);
 };
@@ -118,7 +118,9 @@ static ErrorOr<void> decode_qoi_end_marker(Stream& stream)
     return {};
 }
 
-static ErrorOr<NonnullRefPtr<Bitmap>> decode_qoi_image(Stream& stream, u32 width, u32 height)
+// Decodes the pixels of the image that lie within `region` (all of them by default) into a bitmap of its size.
+// QOI can only be decoded from the start, but we can stop as soon as the region's last row is done.
+static ErrorOr<NonnullRefPtr<Bitmap>> decode_qoi_image(Stream& stream, u32 width, u32 height, Optional<IntRect> requested_region = {})
 {
     // FIXME: Why is Gfx::Bitmap's size signed? Makes no sense whatsoever.
     if (width > NumericLimits<int>::max())
@@ -126,13 +128,18 @@ static ErrorOr<NonnullRefPtr<Bitmap>> decode_qoi_image(Stream& stream, u32 width
     if (height > NumericLimits<int>::max())
         return Error::from_string_literal("Cannot create bitmap for QOI image of valid size, height exceeds maximum Gfx::Bitmap height");
 
-    auto bitmap = TRY(Bitmap::create(BitmapFormat::BGRA8888, { width, height }));
+    IntRect image_rect { 0, 0, static_cast<int>(width), static_cast<int>(height) };
+    auto region = requested_region.value_or(image_rect).intersected(image_rect);
+    if (region.is_empty())
+        return Error::from_string_literal("Cannot decode a region of a QOI image that lies outside of it");
+
+    auto bitmap = TRY(Bitmap::create(BitmapFormat::BGRA8888, region.size()));
 
     u8 run = 0;
     Color pixel = { 0, 0, 0, 255 };
     Color previous_pixels[64] {};
 
-    for (u32 y = 0; y < height; ++y) {
+    for (u32 y = 0; y <= static_cast<u32>(region.bottom()); ++y) {
         for (u32 x = 0; x < width; ++x) {
             if (run > 0)
                 --run;
@@ -155,17 +162,20 @@ static ErrorOr<NonnullRefPtr<Bitmap>> decode_qoi_image(Stream& stream, u32 width
             }
             auto index_position = (pixel.red() * 3 + pixel.green() * 5 + pixel.blue() * 7 + pixel.alpha() * 11) % 64;
             previous_pixels[index_position] = pixel;
-            bitmap->set_pixel(x, y, pixel);
+            if (region.contains(x, y))
+                bitmap->set_pixel(x - region.left(), y - region.top(), pixel);
         }
     }
-    TRY(decode_qoi_end_marker(stream));
+    if (static_cast<u32>(region.bottom()) == height - 1)
+        TRY(decode_qoi_end_marker(stream));
     return { move(bitmap) };
 }
 
-QOIImageDecoderPlugin::QOIImageDecoderPlugin(NonnullOwnPtr<Stream> stream)
+QOIImageDecoderPlugin::QOIImageDecoderPlugin(NonnullOwnPtr<Stream> stream, ReadonlyBytes data)
 {
     m_context = make<QOILoadingContext>();
     m_context->stream = move(stream);
+    m_context->data = data;
 }
 
 IntSize QOIImageDecoderPlugin::size()
@@ -209,7 +219,7 @@ ErrorOr<bool> QOIImageDecoderPlugin::sniff(ReadonlyBytes data)
 ErrorOr<NonnullOwnPtr<ImageDecoderPlugin>> QOIImageDecoderPlugin::create(ReadonlyBytes data)
 {
     auto stream = TRY(try_make<FixedMemoryStream>(data));
-    return adopt_nonnull_own_or_enomem(new (nothrow) QOIImageDecoderPlugin(move(stream)));
+    return adopt_nonnull_own_or_enomem(new (nothrow) QOIImageDecoderPlugin(move(stream), data));
 }
 
 ErrorOr<ImageFrameDescriptor> QOIImageDecoderPlugin::frame(size_t index)
@@ -232,6 +242,22 @@ ErrorOr<ImageFrameDescriptor> QOIImageDecoderPlugin::frame(size_t index)
     return ImageFrameDescriptor { m_context->bitmap, 0 };
 }
 
+ErrorOr<ImageFrameDescriptor> QOIImageDecoderPlugin::frame_region(size_t index, IntRect region)
+{
+    if (index > 0)
+        return Error::from_string_literal("Invalid frame index");
+
+    VERIFY(m_context->state != QOILoadingContext::State::Error);
+
+    if (m_context->state == QOILoadingContext::State::ImageDecoded)
+        return ImageDecoderPlugin::frame_region(index, region);
+
+    // Decode from a stream of our own, so that the one frame() uses is left where it was.
+    FixedMemoryStream stream { m_context->data };
+    auto header = TRY(decode_qoi_header(stream));
+    return ImageFrameDescriptor { TRY(decode_qoi_image(stream, header.width, header.height, region)), 0 };
+}
+
 ErrorOr<void> QOIImageDecoderPlugin::decode_header_and_update_context(Stream& stream)
 {
     VERIFY(m_context->state < QOILoadingContext::State::HeaderDecoded);
@@ -32,6 +32,7 @@ struct QOILoadingContext {
     };
     State state { State::NotDecoded };
     OwnPtr<Stream> stream {};
+    ReadonlyBytes data {};
     QOIHeader header {};
     RefPtr<Bitmap> bitmap;
 };
@@ -51,13 +52,14 @@ public:
     virtual size_t loop_count() override { return 0; }
     virtual size_t frame_count() override { return 1; }
     virtual ErrorOr<ImageFrameDescriptor> frame(size_t index) override;
+    virtual ErrorOr<ImageFrameDescriptor> frame_region(size_t index, IntRect region) override;
     virtual ErrorOr<Optional<ReadonlyBytes>> icc_data() override;
 
 private:
     ErrorOr<void> decode_header_and_update_context(Stream&);
     ErrorOr<void> decode_image_and_update_context(Stream&);
 
-    QOIImageDecoderPlugin(NonnullOwnPtr<Stream>);
+    QOIImageDecoderPlugin(NonnullOwnPtr<Stream>, ReadonlyBytes);
 
     OwnPtr<QOILoadingContext> m_context;
 };
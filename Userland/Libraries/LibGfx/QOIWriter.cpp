@@ -10,9 +10,17 @@
 
 namespace Gfx {
 
-ByteBuffer QOIWriter::encode(Bitmap const& bitmap)
+// Every pixel takes at most an RGBA chunk.
+static constexpr size_t maximum_chunk_size = 5;
+static constexpr size_t header_size = 14;
+
+ErrorOr<ByteBuffer> QOIWriter::encode(Bitmap const& bitmap)
 {
     QOIWriter writer;
+    auto maximum_size = header_size + static_cast<size_t>(bitmap.width()) * bitmap.height() * maximum_chunk_size + sizeof(qoi_end_marker);
+    writer.m_data = TRY(ByteBuffer::create_uninitialized(maximum_size));
+    writer.m_cursor = writer.m_data.data();
+
     writer.add_header(bitmap.width(), bitmap.height(), Channels::RGBA, Colorspace::sRGB);
 
     Color previous_pixel = { 0, 0, 0, 255 };
@@ -97,7 +105,8 @@ ByteBuffer QOIWriter::encode(Bitmap const& bitmap)
 
     writer.add_end_marker();
 
-    return ByteBuffer::copy(writer.m_data).release_value_but_fixme_should_propagate_errors();
+    writer.m_data.resize(writer.m_cursor - writer.m_data.data());
+    return move(writer.m_data);
 }
 
 void QOIWriter::add_header(u32 width, u32 height, Channels channels = Channels::RGBA, Colorspace color_space = Colorspace::sRGB)
@@ -106,40 +115,43 @@ void QOIWriter::add_header(u32 width, u32 height, Channels channels = Channels::
     if (channels == Channels::RGB || color_space == Colorspace::Linear)
         TODO();
 
-    m_data.append(qoi_magic_bytes.data(), sizeof(qoi_magic_bytes));
+    for (auto byte : qoi_magic_bytes)
+        append(byte);
 
     auto big_endian_width = AK::convert_between_host_and_big_endian(width);
-    m_data.append(bit_cast<u8*>(&big_endian_width), sizeof(width));
+    __builtin_memcpy(m_cursor, &big_endian_width, sizeof(width));
+    m_cursor += sizeof(width);
 
     auto big_endian_height = AK::convert_between_host_and_big_endian(height);
-    m_data.append(bit_cast<u8*>(&big_endian_height), sizeof(height));
+    __builtin_memcpy(m_cursor, &big_endian_height, sizeof(height));
+    m_cursor += sizeof(height);
 
     // Number of channels: 3 = RGB, 4 = RGBA.
-    m_data.append(4);
+    append(4);
 
     // Colorspace: 0 = sRGB, 1 = all linear channels.
-    m_data.append(color_space == Colorspace::sRGB ? 0 : 1);
+    append(color_space == Colorspace::sRGB ? 0 : 1);
 }
 
 void QOIWriter::add_rgb_chunk(u8 r, u8 g, u8 b)
 {
     constexpr static u8 rgb_tag = 0b1111'1110;
 
-    m_data.append(rgb_tag);
-    m_data.append(r);
-    m_data.append(g);
-    m_data.append(b);
+    append(rgb_tag);
+    append(r);
+    append(g);
+    append(b);
 }
 
 void QOIWriter::add_rgba_chunk(u8 r, u8 g, u8 b, u8 a)
 {
     constexpr static u8 rgba_tag = 0b1111'1111;
 
-    m_data.append(rgba_tag);
-    m_data.append(r);
-    m_data.append(g);
-    m_data.append(b);
-    m_data.append(a);
+    append(rgba_tag);
+    append(r);
+    append(g);
+    append(b);
+    append(a);
 }
 
 void QOIWriter::add_index_chunk(unsigned int index)
@@ -147,7 +159,7 @@ void QOIWriter::add_index_chunk(unsigned int index)
     constexpr static u8 index_tag = 0b0000'0000;
 
     u8 chunk = index_tag | index;
-    m_data.append(chunk);
+    append(chunk);
 }
 
 void QOIWriter::add_diff_chunk(i8 red_difference, i8 green_difference, i8 blue_difference)
@@ -160,7 +172,7 @@ void QOIWriter::add_diff_chunk(i8 red_difference, i8 green_difference, i8 blue_d
     u8 blue = blue_difference + bias;
 
     u8 chunk = diff_tag | (red << 4) | (green << 2) | blue;
-    m_data.append(chunk);
+    append(chunk);
 }
 
 void QOIWriter::add_luma_chunk(i8 relative_red_difference, i8 green_difference, i8 relative_blue_difference)
@@ -171,8 +183,8 @@ void QOIWriter::add_luma_chunk(i8 relative_red_difference, i8 green_difference,
 
     u8 chunk1 = luma_tag | (green_difference + green_bias);
     u8 chunk2 = ((relative_red_difference + red_blue_bias) << 4) | (relative_blue_difference + red_blue_bias);
-    m_data.append(chunk1);
-    m_data.append(chunk2);
+    append(chunk1);
+    append(chunk2);
 }
 
 void QOIWriter::add_run_chunk(unsigned run_length)
@@ -181,12 +193,13 @@ void QOIWriter::add_run_chunk(unsigned run_length)
     int bias = -1;
 
     u8 chunk = run_tag | (run_length + bias);
-    m_data.append(chunk);
+    append(chunk);
 }
 
 void QOIWriter::add_end_marker()
 {
-    m_data.append(qoi_end_marker.data(), sizeof(qoi_end_marker));
+    for (auto byte : qoi_end_marker)
+        append(byte);
 }
 
 u32 QOIWriter::pixel_hash_function(Color pixel)
@@ -26,12 +26,16 @@ enum class Channels {
 
 class QOIWriter {
 public:
-    static ByteBuffer encode(Gfx::Bitmap const&);
+    static ErrorOr<ByteBuffer> encode(Gfx::Bitmap const&);
 
 private:
     QOIWriter() = default;
 
-    Vector<u8> m_data;
+    // The output is allocated up front for the largest image it could be, and then written to directly.
+    ByteBuffer m_data;
+    u8* m_cursor { nullptr };
+    ALWAYS_INLINE void append(u8 byte) { *m_cursor++ = byte; }
+
     void add_header(u32 width, u32 height, Channels, Colorspace);
     void add_rgb_chunk(u8, u8, u8);
     void add_rgba_chunk(u8, u8, u8, u8);
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Platform.h>
+#include <AK/SIMD.h>
+#include <LibGfx/RowBlending.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace Gfx {
+
+ALWAYS_INLINE static ARGB32 blend_pixel(ARGB32 destination, ARGB32 source, RowBlendingOptions options)
+{
+    u32 alpha = options.source_has_alpha ? source >> 24 : 255;
+    alpha = (alpha * options.opacity) >> 8;
+    auto source_color = Color::from_argb((source & 0x00ffffff) | (alpha << 24));
+    auto destination_color = options.destination_has_alpha ? Color::from_argb(destination) : Color::from_rgb(destination);
+    return destination_color.blend(source_color).value();
+}
+
+// Blends each lane of `source` onto the opaque pixel in the same lane of `destination`.
+// With both pixels' red and blue channels side by side in 16-bit halves of a lane, the products can't overflow into each
+// other: c * (255 - a) + s * a is at most 255 * 255. That also keeps (x + 1 + (x >> 8)) >> 8, which is exactly x / 255
+// for those values, from carrying over into the other half.
+template<typename U32Vector>
+ALWAYS_INLINE static U32Vector blend_onto_opaque(U32Vector destination, U32Vector source, U32Vector alpha)
+{
+    U32Vector inverse_alpha = 255u - alpha;
+
+    U32Vector red_and_blue = (destination & 0x00ff00ffu) * inverse_alpha + (source & 0x00ff00ffu) * alpha;
+    U32Vector green = ((destination >> 8) & 0xffu) * inverse_alpha + ((source >> 8) & 0xffu) * alpha;
+
+    red_and_blue = ((red_and_blue + 0x00010001u + ((red_and_blue >> 8) & 0x00ff00ffu)) >> 8) & 0x00ff00ffu;
+    green = ((green + 1u + (green >> 8)) >> 8) & 0xffu;
+
+    return 0xff000000u | red_and_blue | (green << 8);
+}
+
+template<typename U32Vector, bool source_is_solid>
+ALWAYS_INLINE static void blend_row_impl(ARGB32* destination, ARGB32 const* source, ARGB32 solid_source, size_t count, RowBlendingOptions options)
+{
+    constexpr size_t lanes = sizeof(U32Vector) / sizeof(u32);
+
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        U32Vector destination_pixels;
+        __builtin_memcpy(&destination_pixels, destination + i, sizeof(destination_pixels));
+
+        if (options.destination_has_alpha) {
+            u32 all_pixels = 0xffffffff;
+            for (size_t lane = 0; lane < lanes; ++lane)
+                all_pixels &= destination_pixels[lane];
+            if ((all_pixels >> 24) != 0xff) {
+                for (size_t lane = 0; lane < lanes; ++lane)
+                    destination[i + lane] = blend_pixel(destination[i + lane], source_is_solid ? solid_source : source[i + lane], options);
+                continue;
+            }
+        }
+
+        U32Vector source_pixels;
+        if constexpr (source_is_solid)
+            source_pixels = U32Vector {} + solid_source;
+        else
+            __builtin_memcpy(&source_pixels, source + i, sizeof(source_pixels));
+
+        U32Vector alpha = options.source_has_alpha ? source_pixels >> 24 : U32Vector {} + 255u;
+        alpha = (alpha * static_cast<u32>(options.opacity)) >> 8;
+
+        auto result = blend_onto_opaque(destination_pixels, source_pixels, alpha);
+        __builtin_memcpy(destination + i, &result, sizeof(result));
+    }
+
+    for (; i < count; ++i)
+        destination[i] = blend_pixel(destination[i], source_is_solid ? solid_source : source[i], options);
+}
+
+using BlendRowFunction = void (*)(ARGB32*, ARGB32 const*, ARGB32, size_t, RowBlendingOptions);
+
+template<bool source_is_solid>
+static void blend_row_generic(ARGB32* destination, ARGB32 const* source, ARGB32 solid_source, size_t count, RowBlendingOptions options)
+{
+    blend_row_impl<AK::SIMD::u32x4, source_is_solid>(destination, source, solid_source, count, options);
+}
+
+#if ARCH(X86_64)
+template<bool source_is_solid>
+[[gnu::target("avx2")]] static void blend_row_avx2(ARGB32* destination, ARGB32 const* source, ARGB32 solid_source, size_t count, RowBlendingOptions options)
+{
+    blend_row_impl<AK::SIMD::u32x8, source_is_solid>(destination, source, solid_source, count, options);
+}
+#endif
+
+template<bool source_is_solid>
+static BlendRowFunction resolve_blend_row()
+{
+#if ARCH(X86_64)
+    if (__builtin_cpu_supports("avx2"))
+        return blend_row_avx2<source_is_solid>;
+#endif
+    return blend_row_generic<source_is_solid>;
+}
+
+void blend_row(ARGB32* destination, ARGB32 const* source, size_t count, RowBlendingOptions options)
+{
+    static BlendRowFunction const implementation = resolve_blend_row<false>();
+    implementation(destination, source, 0, count, options);
+}
+
+void blend_color_onto_row(ARGB32* destination, Color color, size_t count, RowBlendingOptions options)
+{
+    static BlendRowFunction const implementation = resolve_blend_row<true>();
+    implementation(destination, nullptr, color.value(), count, options);
+}
+
+}
+
+#pragma GCC diagnostic pop
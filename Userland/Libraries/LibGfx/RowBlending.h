@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <LibGfx/Color.h>
+
+namespace Gfx {
+
+// Kernels for the painter's inner loops, which blend whole rows of BGRA8888 pixels at once. Each one has a
+// vectorized implementation, and the widest one the CPU supports is picked the first time it's called.
+// NOTE: Blending onto an opaque pixel gives exactly what Color::blend() would, and every other pixel goes through it.
+
+struct RowBlendingOptions {
+    // How much of the source to blend in, from 0 (none of it) to 256 (all of it).
+    u16 opacity { 256 };
+    // Without an alpha channel, every source pixel is considered opaque.
+    bool source_has_alpha { true };
+    // Without an alpha channel, every destination pixel is considered opaque, and the result is always opaque.
+    bool destination_has_alpha { true };
+};
+
+constexpr u16 row_blending_opacity(float opacity)
+{
+    if (opacity <= 0.0f)
+        return 0;
+    if (opacity >= 1.0f)
+        return 256;
+    return static_cast<u16>(opacity * 256.0f + 0.5f);
+}
+
+// Blends `count` pixels of `source` onto `destination`.
+void blend_row(ARGB32* destination, ARGB32 const* source, size_t count, RowBlendingOptions = {});
+
+// Blends `color` onto `count` pixels of `destination`.
+void blend_color_onto_row(ARGB32* destination, Color color, size_t count, RowBlendingOptions = {});
+
+}
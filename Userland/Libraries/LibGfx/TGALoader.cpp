@@ -360,6 +360,44 @@ ErrorOr<ImageFrameDescriptor> TGAImageDecoderPlugin::frame(size_t index)
     return ImageFrameDescriptor { m_context->bitmap, 0 };
 }
 
+ErrorOr<ImageFrameDescriptor> TGAImageDecoderPlugin::frame_region(size_t index, IntRect region)
+{
+    auto const& header = m_context->header;
+    auto bits_per_pixel = header.bits_per_pixel;
+    int width = header.width;
+    int height = header.height;
+    int y_origin = header.y_origin < 0 ? height : header.y_origin;
+
+    // NOTE: Only uncompressed pixels can be found without decoding all of those before them. Everything else,
+    //       including the images that frame() refuses to decode, goes through the whole frame.
+    bool can_decode_region = !m_context->bitmap
+        && index == 0
+        && header.color_map_type <= 1
+        && header.data_type_code == TGADataType::UncompressedRGB
+        && (bits_per_pixel == 24 || bits_per_pixel == 32)
+        && (y_origin == 0 || y_origin == height)
+        && (header.x_origin == 0 || header.x_origin == width);
+    if (!can_decode_region)
+        return ImageDecoderPlugin::frame_region(index, region);
+
+    region.intersect({ 0, 0, width, height });
+    if (region.is_empty())
+        return Error::from_string_literal("TGAImageDecoderPlugin: Region lies outside of the image");
+
+    auto bitmap = TRY(Bitmap::create(bits_per_pixel == 24 ? BitmapFormat::BGRx8888 : BitmapFormat::BGRA8888, region.size()));
+    size_t bytes_per_pixel = bits_per_pixel / 8;
+
+    for (int row = region.top(); row <= region.bottom(); ++row) {
+        auto stored_row = y_origin < height ? height - 1 - row : row;
+        TGAReader reader { m_context->reader->data(), sizeof(TGAHeader) + (static_cast<size_t>(stored_row) * width + region.left()) * bytes_per_pixel };
+        auto* scanline = bitmap->scanline(row - region.top());
+        for (int col = 0; col < region.width(); ++col)
+            scanline[col] = reader.read_pixel(bits_per_pixel).data;
+    }
+
+    return ImageFrameDescriptor { bitmap, 0 };
+}
+
 ErrorOr<Optional<ReadonlyBytes>> TGAImageDecoderPlugin::icc_data()
 {
     return OptionalNone {};
@@ -8,6 +8,7 @@
 
 namespace HTTP {
 
+class HeaderParser;
 class HttpRequest;
 class HttpResponse;
 class HttpsJob;
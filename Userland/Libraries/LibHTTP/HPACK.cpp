@@ -0,0 +1,489 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/StringView.h>
+#include <LibHTTP/HPACK.h>
+
+namespace HTTP::HPACK {
+
+struct StaticEntry {
+    StringView name;
+    StringView value;
+};
+
+// Appendix A: Static Table Definition
+static constexpr Array<StaticEntry, 61> static_table { {
+    { ":authority"sv, ""sv },
+    { ":method"sv, "GET"sv },
+    { ":method"sv, "POST"sv },
+    { ":path"sv, "/"sv },
+    { ":path"sv, "/index.html"sv },
+    { ":scheme"sv, "http"sv },
+    { ":scheme"sv, "https"sv },
+    { ":status"sv, "200"sv },
+    { ":status"sv, "204"sv },
+    { ":status"sv, "206"sv },
+    { ":status"sv, "304"sv },
+    { ":status"sv, "400"sv },
+    { ":status"sv, "404"sv },
+    { ":status"sv, "500"sv },
+    { "accept-charset"sv, ""sv },
+    { "accept-encoding"sv, "gzip, deflate"sv },
+    { "accept-language"sv, ""sv },
+    { "accept-ranges"sv, ""sv },
+    { "accept"sv, ""sv },
+    { "access-control-allow-origin"sv, ""sv },
+    { "age"sv, ""sv },
+    { "allow"sv, ""sv },
+    { "authorization"sv, ""sv },
+    { "cache-control"sv, ""sv },
+    { "content-disposition"sv, ""sv },
+    { "content-encoding"sv, ""sv },
+    { "content-language"sv, ""sv },
+    { "content-length"sv, ""sv },
+    { "content-location"sv, ""sv },
+    { "content-range"sv, ""sv },
+    { "content-type"sv, ""sv },
+    { "cookie"sv, ""sv },
+    { "date"sv, ""sv },
+    { "etag"sv, ""sv },
+    { "expect"sv, ""sv },
+    { "expires"sv, ""sv },
+    { "from"sv, ""sv },
+    { "host"sv, ""sv },
+    { "if-match"sv, ""sv },
+    { "if-modified-since"sv, ""sv },
+    { "if-none-match"sv, ""sv },
+    { "if-range"sv, ""sv },
+    { "if-unmodified-since"sv, ""sv },
+    { "last-modified"sv, ""sv },
+    { "link"sv, ""sv },
+    { "location"sv, ""sv },
+    { "max-forwards"sv, ""sv },
+    { "proxy-authenticate"sv, ""sv },
+    { "proxy-authorization"sv, ""sv },
+    { "range"sv, ""sv },
+    { "referer"sv, ""sv },
+    { "refresh"sv, ""sv },
+    { "retry-after"sv, ""sv },
+    { "server"sv, ""sv },
+    { "set-cookie"sv, ""sv },
+    { "strict-transport-security"sv, ""sv },
+    { "transfer-encoding"sv, ""sv },
+    { "user-agent"sv, ""sv },
+    { "vary"sv, ""sv },
+    { "via"sv, ""sv },
+    { "www-authenticate"sv, ""sv },
+} };
+
+struct HuffmanCode {
+    u32 code;
+    u8 length;
+};
+
+// Appendix B: Huffman Code, indexed by symbol. The last one is EOS, which never shows up in a valid string.
+static constexpr Array<HuffmanCode, 257> huffman_codes { {
+    { 0x1ff8, 13 }, { 0x7fffd8, 23 }, { 0xfffffe2, 28 }, { 0xfffffe3, 28 },
+    { 0xfffffe4, 28 }, { 0xfffffe5, 28 }, { 0xfffffe6, 28 }, { 0xfffffe7, 28 },
+    { 0xfffffe8, 28 }, { 0xffffea, 24 }, { 0x3ffffffc, 30 }, { 0xfffffe9, 28 },
+    { 0xfffffea, 28 }, { 0x3ffffffd, 30 }, { 0xfffffeb, 28 }, { 0xfffffec, 28 },
+    { 0xfffffed, 28 }, { 0xfffffee, 28 }, { 0xfffffef, 28 }, { 0xffffff0, 28 },
+    { 0xffffff1, 28 }, { 0xffffff2, 28 }, { 0x3ffffffe, 30 }, { 0xffffff3, 28 },
+    { 0xffffff4, 28 }, { 0xffffff5, 28 }, { 0xffffff6, 28 }, { 0xffffff7, 28 },
+    { 0xffffff8, 28 }, { 0xffffff9, 28 }, { 0xffffffa, 28 }, { 0xffffffb, 28 },
+    { 0x14, 6 }, { 0x3f8, 10 }, { 0x3f9, 10 }, { 0xffa, 12 },
+    { 0x1ff9, 13 }, { 0x15, 6 }, { 0xf8, 8 }, { 0x7fa, 11 },
+    { 0x3fa, 10 }, { 0x3fb, 10 }, { 0xf9, 8 }, { 0x7fb, 11 },
+    { 0xfa, 8 }, { 0x16, 6 }, { 0x17, 6 }, { 0x18, 6 },
+    { 0x0, 5 }, { 0x1, 5 }, { 0x2, 5 }, { 0x19, 6 },
+    { 0x1a, 6 }, { 0x1b, 6 }, { 0x1c, 6 }, { 0x1d, 6 },
+    { 0x1e, 6 }, { 0x1f, 6 }, { 0x5c, 7 }, { 0xfb, 8 },
+    { 0x7ffc, 15 }, { 0x20, 6 }, { 0xffb, 12 }, { 0x3fc, 10 },
+    { 0x1ffa, 13 }, { 0x21, 6 }, { 0x5d, 7 }, { 0x5e, 7 },
+    { 0x5f, 7 }, { 0x60, 7 }, { 0x61, 7 }, { 0x62, 7 },
+    { 0x63, 7 }, { 0x64, 7 }, { 0x65, 7 }, { 0x66, 7 },
+    { 0x67, 7 }, { 0x68, 7 }, { 0x69, 7 }, { 0x6a, 7 },
+    { 0x6b, 7 }, { 0x6c, 7 }, { 0x6d, 7 }, { 0x6e, 7 },
+    { 0x6f, 7 }, { 0x70, 7 }, { 0x71, 7 }, { 0x72, 7 },
+    { 0xfc, 8 }, { 0x73, 7 }, { 0xfd, 8 }, { 0x1ffb, 13 },
+    { 0x7fff0, 19 }, { 0x1ffc, 13 }, { 0x3ffc, 14 }, { 0x22, 6 },
+    { 0x7ffd, 15 }, { 0x3, 5 }, { 0x23, 6 }, { 0x4, 5 },
+    { 0x24, 6 }, { 0x5, 5 }, { 0x25, 6 }, { 0x26, 6 },
+    { 0x27, 6 }, { 0x6, 5 }, { 0x74, 7 }, { 0x75, 7 },
+    { 0x28, 6 }, { 0x29, 6 }, { 0x2a, 6 }, { 0x7, 5 },
+    { 0x2b, 6 }, { 0x76, 7 }, { 0x2c, 6 }, { 0x8, 5 },
+    { 0x9, 5 }, { 0x2d, 6 }, { 0x77, 7 }, { 0x78, 7 },
+    { 0x79, 7 }, { 0x7a, 7 }, { 0x7b, 7 }, { 0x7ffe, 15 },
+    { 0x7fc, 11 }, { 0x3ffd, 14 }, { 0x1ffd, 13 }, { 0xffffffc, 28 },
+    { 0xfffe6, 20 }, { 0x3fffd2, 22 }, { 0xfffe7, 20 }, { 0xfffe8, 20 },
+    { 0x3fffd3, 22 }, { 0x3fffd4, 22 }, { 0x3fffd5, 22 }, { 0x7fffd9, 23 },
+    { 0x3fffd6, 22 }, { 0x7fffda, 23 }, { 0x7fffdb, 23 }, { 0x7fffdc, 23 },
+    { 0x7fffdd, 23 }, { 0x7fffde, 23 }, { 0xffffeb, 24 }, { 0x7fffdf, 23 },
+    { 0xffffec, 24 }, { 0xffffed, 24 }, { 0x3fffd7, 22 }, { 0x7fffe0, 23 },
+    { 0xffffee, 24 }, { 0x7fffe1, 23 }, { 0x7fffe2, 23 }, { 0x7fffe3, 23 },
+    { 0x7fffe4, 23 }, { 0x1fffdc, 21 }, { 0x3fffd8, 22 }, { 0x7fffe5, 23 },
+    { 0x3fffd9, 22 }, { 0x7fffe6, 23 }, { 0x7fffe7, 23 }, { 0xffffef, 24 },
+    { 0x3fffda, 22 }, { 0x1fffdd, 21 }, { 0xfffe9, 20 }, { 0x3fffdb, 22 },
+    { 0x3fffdc, 22 }, { 0x7fffe8, 23 }, { 0x7fffe9, 23 }, { 0x1fffde, 21 },
+    { 0x7fffea, 23 }, { 0x3fffdd, 22 }, { 0x3fffde, 22 }, { 0xfffff0, 24 },
+    { 0x1fffdf, 21 }, { 0x3fffdf, 22 }, { 0x7fffeb, 23 }, { 0x7fffec, 23 },
+    { 0x1fffe0, 21 }, { 0x1fffe1, 21 }, { 0x3fffe0, 22 }, { 0x1fffe2, 21 },
+    { 0x7fffed, 23 }, { 0x3fffe1, 22 }, { 0x7fffee, 23 }, { 0x7fffef, 23 },
+    { 0xfffea, 20 }, { 0x3fffe2, 22 }, { 0x3fffe3, 22 }, { 0x3fffe4, 22 },
+    { 0x7ffff0, 23 }, { 0x3fffe5, 22 }, { 0x3fffe6, 22 }, { 0x7ffff1, 23 },
+    { 0x3ffffe0, 26 }, { 0x3ffffe1, 26 }, { 0xfffeb, 20 }, { 0x7fff1, 19 },
+    { 0x3fffe7, 22 }, { 0x7ffff2, 23 }, { 0x3fffe8, 22 }, { 0x1ffffec, 25 },
+    { 0x3ffffe2, 26 }, { 0x3ffffe3, 26 }, { 0x3ffffe4, 26 }, { 0x7ffffde, 27 },
+    { 0x7ffffdf, 27 }, { 0x3ffffe5, 26 }, { 0xfffff1, 24 }, { 0x1ffffed, 25 },
+    { 0x7fff2, 19 }, { 0x1fffe3, 21 }, { 0x3ffffe6, 26 }, { 0x7ffffe0, 27 },
+    { 0x7ffffe1, 27 }, { 0x3ffffe7, 26 }, { 0x7ffffe2, 27 }, { 0xfffff2, 24 },
+    { 0x1fffe4, 21 }, { 0x1fffe5, 21 }, { 0x3ffffe8, 26 }, { 0x3ffffe9, 26 },
+    { 0xffffffd, 28 }, { 0x7ffffe3, 27 }, { 0x7ffffe4, 27 }, { 0x7ffffe5, 27 },
+    { 0xfffec, 20 }, { 0xfffff3, 24 }, { 0xfffed, 20 }, { 0x1fffe6, 21 },
+    { 0x3fffe9, 22 }, { 0x1fffe7, 21 }, { 0x1fffe8, 21 }, { 0x7ffff3, 23 },
+    { 0x3fffea, 22 }, { 0x3fffeb, 22 }, { 0x1ffffee, 25 }, { 0x1ffffef, 25 },
+    { 0xfffff4, 24 }, { 0xfffff5, 24 }, { 0x3ffffea, 26 }, { 0x7ffff4, 23 },
+    { 0x3ffffeb, 26 }, { 0x7ffffe6, 27 }, { 0x3ffffec, 26 }, { 0x3ffffed, 26 },
+    { 0x7ffffe7, 27 }, { 0x7ffffe8, 27 }, { 0x7ffffe9, 27 }, { 0x7ffffea, 27 },
+    { 0x7ffffeb, 27 }, { 0xffffffe, 28 }, { 0x7ffffec, 27 }, { 0x7ffffed, 27 },
+    { 0x7ffffee, 27 }, { 0x7ffffef, 27 }, { 0x7fffff0, 27 }, { 0x3ffffee, 26 },
+    { 0x3fffffff, 30 },
+} };
+static constexpr u16 huffman_eos = 256;
+
+// Header lists larger than this are not something we're willing to keep in memory.
+static constexpr size_t max_header_list_size = 256 * KiB;
+
+void DynamicTable::insert(Header header)
+{
+    auto entry_size = header.name.length() + header.value.length() + entry_overhead;
+    // Section 4.4: An entry that doesn't fit empties the table, and is not added.
+    evict_until_it_fits(entry_size);
+    if (entry_size > m_max_size)
+        return;
+    m_entries.append(move(header));
+    m_size += entry_size;
+}
+
+void DynamicTable::set_max_size(size_t max_size)
+{
+    m_max_size = max_size;
+    evict_until_it_fits(0);
+}
+
+void DynamicTable::evict_until_it_fits(size_t entry_size)
+{
+    size_t evicted_count = 0;
+    while (evicted_count < m_entries.size() && m_size + entry_size > m_max_size) {
+        auto& entry = m_entries[evicted_count++];
+        m_size -= entry.name.length() + entry.value.length() + entry_overhead;
+    }
+    if (evicted_count == m_entries.size())
+        m_size = 0;
+    m_entries.remove(0, evicted_count);
+}
+
+// Section 5.1: An integer fills up the low bits of the first byte, and continues in groups of seven bits when it doesn't fit.
+ErrorOr<u64> decode_integer(ReadonlyBytes& input, u8 prefix_bits)
+{
+    if (input.is_empty())
+        return Error::from_string_literal("HPACK integer is truncated");
+
+    u64 prefix_max = (1u << prefix_bits) - 1;
+    u64 value = input[0] & prefix_max;
+    input = input.slice(1);
+    if (value < prefix_max)
+        return value;
+
+    for (size_t shift = 0;; shift += 7) {
+        // Nothing we decode comes close to this, so anything longer is an attempt to overflow.
+        if (input.is_empty() || shift > 28)
+            return Error::from_string_literal("HPACK integer is truncated or too large");
+        u8 byte = input[0];
+        input = input.slice(1);
+        value += (u64)(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+}
+
+ErrorOr<void> encode_integer(ByteBuffer& output, u64 value, u8 prefix_bits, u8 first_byte_flags)
+{
+    u64 prefix_max = (1u << prefix_bits) - 1;
+    if (value < prefix_max)
+        return output.try_append(first_byte_flags | (u8)value);
+
+    TRY(output.try_append(first_byte_flags | (u8)prefix_max));
+    value -= prefix_max;
+    while (value >= 0x80) {
+        TRY(output.try_append((u8)(0x80 | (value & 0x7f))));
+        value >>= 7;
+    }
+    return output.try_append((u8)value);
+}
+
+namespace {
+
+// A binary trie of all the codes, built on first use. Each child is either the index of another node,
+// or a symbol (stored as the negated symbol minus one). Zero means there is no code down that way,
+// which is fine since the root is never anybody's child.
+struct HuffmanDecodeTree {
+    Vector<Array<i16, 2>> nodes;
+
+    HuffmanDecodeTree()
+    {
+        nodes.append({ 0, 0 });
+        for (u16 symbol = 0; symbol < huffman_codes.size(); ++symbol) {
+            auto [code, length] = huffman_codes[symbol];
+            size_t node = 0;
+            for (u8 bit_index = length; bit_index > 0; --bit_index) {
+                auto bit = (code >> (bit_index - 1)) & 1;
+                if (bit_index == 1) {
+                    nodes[node][bit] = -(i16)symbol - 1;
+                    break;
+                }
+                if (nodes[node][bit] == 0) {
+                    nodes[node][bit] = nodes.size();
+                    nodes.append({ 0, 0 });
+                }
+                node = nodes[node][bit];
+            }
+        }
+    }
+};
+
+}
+
+static HuffmanDecodeTree const& huffman_decode_tree()
+{
+    static HuffmanDecodeTree tree;
+    return tree;
+}
+
+ErrorOr<ByteBuffer> huffman_decode(ReadonlyBytes input)
+{
+    auto& nodes = huffman_decode_tree().nodes;
+
+    ByteBuffer output;
+    // Every symbol takes at least five bits.
+    TRY(output.try_ensure_capacity(input.size() * 8 / 5));
+
+    size_t node = 0;
+    size_t bits_since_last_symbol = 0;
+    bool has_only_seen_ones = true;
+    for (auto byte : input) {
+        for (int bit_index = 7; bit_index >= 0; --bit_index) {
+            auto bit = (byte >> bit_index) & 1;
+            auto child = nodes[node][bit];
+            ++bits_since_last_symbol;
+            has_only_seen_ones = has_only_seen_ones && bit;
+            if (child == 0)
+                return Error::from_string_literal("HPACK string contains an invalid Huffman code");
+            if (child > 0) {
+                node = child;
+                continue;
+            }
+            auto symbol = -child - 1;
+            if (symbol == huffman_eos)
+                return Error::from_string_literal("HPACK string contains EOS");
+            TRY(output.try_append((u8)symbol));
+            node = 0;
+            bits_since_last_symbol = 0;
+            has_only_seen_ones = true;
+        }
+    }
+
+    // Section 5.2: The string is padded with the most significant bits of EOS (so all ones), and with less than a byte of it.
+    if (bits_since_last_symbol > 7 || !has_only_seen_ones)
+        return Error::from_string_literal("HPACK string has invalid padding");
+    return output;
+}
+
+size_t huffman_encoded_length(ReadonlyBytes input)
+{
+    size_t bits = 0;
+    for (auto byte : input)
+        bits += huffman_codes[byte].length;
+    return (bits + 7) / 8;
+}
+
+ErrorOr<void> huffman_encode(ByteBuffer& output, ReadonlyBytes input)
+{
+    u64 pending_bits = 0;
+    size_t pending_bit_count = 0;
+    for (auto byte : input) {
+        auto [code, length] = huffman_codes[byte];
+        pending_bits = (pending_bits << length) | code;
+        pending_bit_count += length;
+        while (pending_bit_count >= 8) {
+            pending_bit_count -= 8;
+            TRY(output.try_append((u8)(pending_bits >> pending_bit_count)));
+        }
+        pending_bits &= (1u << pending_bit_count) - 1;
+    }
+    if (pending_bit_count > 0) {
+        auto padding = 8 - pending_bit_count;
+        TRY(output.try_append((u8)((pending_bits << padding) | ((1u << padding) - 1))));
+    }
+    return {};
+}
+
+// Section 5.2: String Literal Representation
+static ErrorOr<DeprecatedString> decode_string(ReadonlyBytes& input)
+{
+    if (input.is_empty())
+        return Error::from_string_literal("HPACK string is truncated");
+    bool is_huffman_encoded = input[0] & 0x80;
+    auto length = TRY(decode_integer(input, 7));
+    if (length > input.size())
+        return Error::from_string_literal("HPACK string is truncated");
+
+    auto data = input.slice(0, length);
+    input = input.slice(length);
+    if (!is_huffman_encoded)
+        return DeprecatedString { data };
+    auto decoded = TRY(huffman_decode(data));
+    return DeprecatedString { decoded.bytes() };
+}
+
+static ErrorOr<void> encode_string(ByteBuffer& output, StringView string)
+{
+    // Huffman coding only pays off for the usual, mostly alphanumeric, strings.
+    auto huffman_length = huffman_encoded_length(string.bytes());
+    if (huffman_length < string.length()) {
+        TRY(encode_integer(output, huffman_length, 7, 0x80));
+        return huffman_encode(output, string.bytes());
+    }
+    TRY(encode_integer(output, string.length(), 7));
+    return output.try_append(string.bytes());
+}
+
+ErrorOr<Header> Decoder::header_at(u64 index) const
+{
+    if (index == 0)
+        return Error::from_string_literal("HPACK index 0 is not valid");
+    if (index <= static_table.size()) {
+        auto& entry = static_table[index - 1];
+        return Header { entry.name, entry.value };
+    }
+    index -= static_table.size() + 1;
+    if (index >= m_table.entry_count())
+        return Error::from_string_literal("HPACK index is out of range");
+    return m_table.at(index);
+}
+
+// Section 6: Binary Format
+ErrorOr<Vector<Header>> Decoder::decode(ReadonlyBytes input)
+{
+    Vector<Header> headers;
+    size_t header_list_size = 0;
+    bool may_update_table_size = true;
+
+    while (!input.is_empty()) {
+        u8 first_byte = input[0];
+
+        // Section 6.3: A dynamic table size update may only come before the first header in a block.
+        if ((first_byte & 0xe0) == 0x20) {
+            auto new_size = TRY(decode_integer(input, 5));
+            if (!may_update_table_size || new_size > m_max_table_size_limit)
+                return Error::from_string_literal("HPACK dynamic table size update is not allowed");
+            m_table.set_max_size(new_size);
+            continue;
+        }
+        may_update_table_size = false;
+
+        Header header;
+        if (first_byte & 0x80) {
+            // Section 6.1: Indexed Header Field Representation
+            header = TRY(header_at(TRY(decode_integer(input, 7))));
+        } else {
+            // Section 6.2: Literal Header Field Representation. With incremental indexing (01), the header is added
+            // to the table; otherwise it is without indexing (0000) or never indexed (0001), which is all the same to us.
+            bool is_indexed = first_byte & 0x40;
+            auto name_index = TRY(decode_integer(input, is_indexed ? 6 : 4));
+            header.name = name_index ? TRY(header_at(name_index)).name : TRY(decode_string(input));
+            header.value = TRY(decode_string(input));
+            if (is_indexed)
+                m_table.insert(header);
+        }
+
+        header_list_size += header.name.length() + header.value.length() + entry_overhead;
+        if (header_list_size > max_header_list_size)
+            return Error::from_string_literal("HPACK header list is too large");
+        TRY(headers.try_append(move(header)));
+    }
+
+    return headers;
+}
+
+void Encoder::set_max_table_size(size_t max_size)
+{
+    // We never need more than the default, even if the peer would let us.
+    max_size = min(max_size, default_max_table_size);
+    if (max_size == m_table.max_size())
+        return;
+    m_table.set_max_size(max_size);
+    m_pending_table_size_update = max_size;
+}
+
+Encoder::Match Encoder::find(Header const& header) const
+{
+    Match match;
+    for (size_t i = 0; i < static_table.size(); ++i) {
+        if (static_table[i].name != header.name)
+            continue;
+        if (static_table[i].value == header.value)
+            return { i + 1, true };
+        if (!match.index)
+            match.index = i + 1;
+    }
+    for (size_t i = 0; i < m_table.entry_count(); ++i) {
+        auto& entry = m_table.at(i);
+        if (entry.name != header.name)
+            continue;
+        if (entry.value == header.value)
+            return { static_table.size() + 1 + i, true };
+        if (!match.index)
+            match.index = static_table.size() + 1 + i;
+    }
+    return match;
+}
+
+ErrorOr<ByteBuffer> Encoder::encode(Vector<Header> const& headers)
+{
+    ByteBuffer output;
+    if (m_pending_table_size_update.has_value())
+        TRY(encode_integer(output, m_pending_table_size_update.release_value(), 5, 0x20));
+
+    for (auto& header : headers) {
+        auto match = find(header);
+        if (match.includes_value) {
+            TRY(encode_integer(output, match.index, 7, 0x80));
+            continue;
+        }
+
+        // Section 7.1.3: Credentials must not end up in a table where guessing at them is cheap.
+        // Values that change with every request would only push the useful entries out of the table.
+        bool is_sensitive = header.name.is_one_of("authorization"sv, "proxy-authorization"sv);
+        bool should_index = !is_sensitive && !header.name.is_one_of(":path"sv, "content-length"sv, "if-modified-since"sv, "if-none-match"sv);
+
+        if (should_index)
+            TRY(encode_integer(output, match.index, 6, 0x40));
+        else
+            TRY(encode_integer(output, match.index, 4, is_sensitive ? 0x10 : 0x00));
+        if (!match.index)
+            TRY(encode_string(output, header.name));
+        TRY(encode_string(output, header.value));
+
+        if (should_index)
+            m_table.insert(header);
+    }
+
+    return output;
+}
+
+}
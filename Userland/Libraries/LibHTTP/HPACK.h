@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/DeprecatedString.h>
+#include <AK/Error.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+
+// RFC 7541: HPACK: Header Compression for HTTP/2
+namespace HTTP::HPACK {
+
+struct Header {
+    DeprecatedString name;
+    DeprecatedString value;
+
+    bool operator==(Header const&) const = default;
+};
+
+// Section 4.1: Each entry costs the length of its name and value, plus 32 bytes of (estimated) overhead.
+constexpr size_t entry_overhead = 32;
+constexpr size_t default_max_table_size = 4096;
+
+// Section 2.3.2: The dynamic table is a FIFO, where index 1 is the most recently inserted entry.
+class DynamicTable {
+public:
+    explicit DynamicTable(size_t max_size = default_max_table_size)
+        : m_max_size(max_size)
+    {
+    }
+
+    size_t size() const { return m_size; }
+    size_t max_size() const { return m_max_size; }
+    size_t entry_count() const { return m_entries.size(); }
+
+    Header const& at(size_t index) const { return m_entries[m_entries.size() - 1 - index]; }
+
+    void insert(Header);
+    void set_max_size(size_t);
+
+private:
+    void evict_until_it_fits(size_t);
+
+    // Oldest entry first, so that insertions and evictions happen at the cheap ends of the vector.
+    Vector<Header> m_entries;
+    size_t m_size { 0 };
+    size_t m_max_size { 0 };
+};
+
+class Decoder {
+public:
+    // The table size limit is what we promised the peer with SETTINGS_HEADER_TABLE_SIZE.
+    explicit Decoder(size_t max_table_size_limit = default_max_table_size)
+        : m_table(max_table_size_limit)
+        , m_max_table_size_limit(max_table_size_limit)
+    {
+    }
+
+    ErrorOr<Vector<Header>> decode(ReadonlyBytes header_block);
+
+    DynamicTable const& table() const { return m_table; }
+
+private:
+    ErrorOr<Header> header_at(u64 index) const;
+
+    DynamicTable m_table;
+    size_t m_max_table_size_limit { 0 };
+};
+
+class Encoder {
+public:
+    ErrorOr<ByteBuffer> encode(Vector<Header> const&);
+
+    // The peer tells us how large our table may get with SETTINGS_HEADER_TABLE_SIZE, and we have to tell it when we use less (section 4.2).
+    void set_max_table_size(size_t);
+
+    DynamicTable const& table() const { return m_table; }
+
+private:
+    struct Match {
+        // Zero if neither the name nor the whole header is in a table.
+        u64 index { 0 };
+        bool includes_value { false };
+    };
+    Match find(Header const&) const;
+
+    DynamicTable m_table;
+    Optional<size_t> m_pending_table_size_update;
+};
+
+// Section 5.1 and 5.2, exposed for the tests.
+ErrorOr<u64> decode_integer(ReadonlyBytes& input, u8 prefix_bits);
+ErrorOr<void> encode_integer(ByteBuffer&, u64 value, u8 prefix_bits, u8 first_byte_flags = 0);
+ErrorOr<ByteBuffer> huffman_decode(ReadonlyBytes);
+ErrorOr<void> huffman_encode(ByteBuffer&, ReadonlyBytes);
+size_t huffman_encoded_length(ReadonlyBytes);
+
+}
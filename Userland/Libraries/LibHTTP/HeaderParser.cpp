@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/CharacterTypes.h>
+#include <LibHTTP/HeaderParser.h>
+#include <string.h>
+
+namespace HTTP {
+
+// RFC 9110: HTTP Semantics, Section 5.6.2: Tokens
+static constexpr bool is_token_character(u8 ch)
+{
+    if (is_ascii_alphanumeric(ch))
+        return true;
+    switch (ch) {
+    case '!':
+    case '#':
+    case '$':
+    case '%':
+    case '&':
+    case '\'':
+    case '*':
+    case '+':
+    case '-':
+    case '.':
+    case '^':
+    case '_':
+    case '`':
+    case '|':
+    case '~':
+        return true;
+    default:
+        return false;
+    }
+}
+
+// RFC 9110: HTTP Semantics, Section 5.6.3: Whitespace
+static constexpr bool is_optional_whitespace(u8 ch)
+{
+    return ch == ' ' || ch == '\t';
+}
+
+HeaderParser::HeaderParser(Kind kind, size_t max_size)
+    : m_max_size(max_size)
+{
+    reset(kind);
+}
+
+void HeaderParser::reset(Kind kind)
+{
+    m_kind = kind;
+    m_state = kind == Kind::Trailers ? State::InFields : State::InStartLine;
+    m_failure_reason = {};
+    m_buffer.clear_with_capacity();
+    m_line_start = 0;
+    m_method = {};
+    m_request_target = {};
+    m_reason_phrase = {};
+    m_status_code = 0;
+    m_major_version = 0;
+    m_minor_version = 0;
+    m_fields.clear_with_capacity();
+}
+
+void HeaderParser::fail(StringView reason)
+{
+    m_state = State::Failed;
+    m_failure_reason = reason;
+}
+
+size_t HeaderParser::parse(ReadonlyBytes input)
+{
+    size_t consumed = 0;
+    while (consumed < input.size() && m_state != State::Done && m_state != State::Failed) {
+        auto remaining = input.slice(consumed);
+        auto const* newline = static_cast<u8 const*>(memchr(remaining.data(), '\n', remaining.size()));
+        auto length = newline ? static_cast<size_t>(newline - remaining.data()) + 1 : remaining.size();
+
+        if (m_buffer.size() + length > m_max_size) {
+            fail("Header section is too large"sv);
+            return consumed;
+        }
+        m_buffer.append(remaining.data(), length);
+        consumed += length;
+
+        if (!newline)
+            break;
+
+        // Section 2.2: A recipient MAY recognize a single LF as a line terminator and ignore any preceding CR.
+        auto line_end = m_buffer.size() - 1;
+        if (line_end > m_line_start && m_buffer[line_end - 1] == '\r')
+            --line_end;
+        parse_line(m_line_start, line_end);
+        m_line_start = m_buffer.size();
+    }
+    return consumed;
+}
+
+void HeaderParser::parse_line(size_t start, size_t end)
+{
+    if (m_state == State::InStartLine) {
+        // Section 2.2: A server that is expecting to receive and parse a request-line SHOULD ignore at least one
+        //              empty line (CRLF) received prior to the request-line.
+        //              We do the same for responses, as some servers send a stray CRLF after the previous body.
+        if (start == end)
+            return;
+        if (m_kind == Kind::Request)
+            parse_request_line(start, end);
+        else
+            parse_status_line(start, end);
+        return;
+    }
+
+    VERIFY(m_state == State::InFields);
+    if (start == end) {
+        m_state = State::Done;
+        return;
+    }
+    parse_field_line(start, end);
+}
+
+bool HeaderParser::parse_version(size_t start, size_t end)
+{
+    // Section 2.3: HTTP-version = HTTP-name "/" DIGIT "." DIGIT
+    if (end - start != 8)
+        return false;
+    auto version = StringView { m_buffer.data() + start, 8 };
+    if (!version.starts_with("HTTP/"sv) || !is_ascii_digit(version[5]) || version[6] != '.' || !is_ascii_digit(version[7]))
+        return false;
+    m_major_version = parse_ascii_digit(version[5]);
+    m_minor_version = parse_ascii_digit(version[7]);
+    return true;
+}
+
+void HeaderParser::parse_request_line(size_t start, size_t end)
+{
+    // Section 3: request-line = method SP request-target SP HTTP-version
+    auto method_end = start;
+    while (method_end < end && is_token_character(m_buffer[method_end]))
+        ++method_end;
+    if (method_end == start || method_end == end || m_buffer[method_end] != ' ')
+        return fail("Invalid method in request line"sv);
+
+    auto target_start = method_end + 1;
+    auto target_end = target_start;
+    while (target_end < end && m_buffer[target_end] > ' ' && m_buffer[target_end] != 0x7f)
+        ++target_end;
+    if (target_end == target_start || target_end == end || m_buffer[target_end] != ' ')
+        return fail("Invalid request target in request line"sv);
+
+    if (!parse_version(target_end + 1, end))
+        return fail("Invalid HTTP version in request line"sv);
+
+    m_method = { static_cast<u32>(start), static_cast<u32>(method_end - start) };
+    m_request_target = { static_cast<u32>(target_start), static_cast<u32>(target_end - target_start) };
+    m_state = State::InFields;
+}
+
+void HeaderParser::parse_status_line(size_t start, size_t end)
+{
+    // Section 4: status-line = HTTP-version SP status-code SP [ reason-phrase ]
+    if (end - start < 12 || !parse_version(start, start + 8) || m_buffer[start + 8] != ' ')
+        return fail("Invalid HTTP version in status line"sv);
+
+    auto code_start = start + 9;
+    u32 code = 0;
+    for (size_t i = code_start; i < code_start + 3; ++i) {
+        if (!is_ascii_digit(m_buffer[i]))
+            return fail("Invalid status code in status line"sv);
+        code = code * 10 + parse_ascii_digit(m_buffer[i]);
+    }
+
+    // The SP before the (empty) reason phrase is required, but plenty of servers leave it out.
+    auto reason_start = code_start + 3;
+    if (reason_start < end) {
+        if (m_buffer[reason_start] != ' ')
+            return fail("Invalid status code in status line"sv);
+        ++reason_start;
+    }
+
+    m_status_code = code;
+    m_reason_phrase = { static_cast<u32>(reason_start), static_cast<u32>(end - reason_start) };
+    m_state = State::InFields;
+}
+
+void HeaderParser::parse_field_line(size_t start, size_t end)
+{
+    // Section 5.2: A user agent that receives an obs-fold in a response message [...] MUST replace each received
+    //              obs-fold with one or more SP octets prior to interpreting the field value.
+    //              We do the same for requests, rather than rejecting them.
+    if (is_optional_whitespace(m_buffer[start])) {
+        if (m_fields.is_empty())
+            return fail("Line folding without a preceding field"sv);
+        auto& value = m_fields.last().value;
+
+        auto continuation_start = start;
+        while (continuation_start < end && is_optional_whitespace(m_buffer[continuation_start]))
+            ++continuation_start;
+        auto continuation_end = end;
+        while (continuation_end > continuation_start && is_optional_whitespace(m_buffer[continuation_end - 1]))
+            --continuation_end;
+        for (auto i = continuation_start; i < continuation_end; ++i) {
+            if (m_buffer[i] == '\0' || m_buffer[i] == '\r')
+                return fail("Invalid character in field value"sv);
+        }
+        if (continuation_start == continuation_end)
+            return;
+
+        if (value.length == 0) {
+            value.offset = continuation_start;
+        } else {
+            // The previous value and the continuation are next to each other in the buffer, so everything in between
+            // (the line terminator and the whitespace around it) can simply be turned into spaces.
+            auto fold_start = value.offset + value.length;
+            memset(m_buffer.data() + fold_start, ' ', continuation_start - fold_start);
+        }
+        value.length = continuation_end - value.offset;
+        return;
+    }
+
+    // Section 5: field-line = field-name ":" OWS field-value OWS
+    auto name_end = start;
+    while (name_end < end && is_token_character(m_buffer[name_end]))
+        ++name_end;
+    // Section 5.1: No whitespace is allowed between the field name and colon.
+    if (name_end == start || name_end == end || m_buffer[name_end] != ':')
+        return fail("Invalid field name"sv);
+
+    auto value_start = name_end + 1;
+    while (value_start < end && is_optional_whitespace(m_buffer[value_start]))
+        ++value_start;
+    auto value_end = end;
+    while (value_end > value_start && is_optional_whitespace(m_buffer[value_end - 1]))
+        --value_end;
+
+    // Section 5.5: A recipient of CR, LF, or NUL within a field value MUST either reject the message or replace each
+    //              of those characters with SP before further processing or forwarding of that message.
+    for (auto i = value_start; i < value_end; ++i) {
+        if (m_buffer[i] == '\0' || m_buffer[i] == '\r')
+            return fail("Invalid character in field value"sv);
+    }
+
+    m_fields.append({
+        { static_cast<u32>(start), static_cast<u32>(name_end - start) },
+        { static_cast<u32>(value_start), static_cast<u32>(value_end - value_start) },
+    });
+}
+
+Optional<StringView> HeaderParser::find(StringView name) const
+{
+    for (auto& field : m_fields) {
+        auto field_name = view(field.name);
+        if (field_name.equals_ignoring_case(name))
+            return view(field.value);
+    }
+    return {};
+}
+
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+
+namespace HTTP {
+
+// RFC 9112: HTTP/1.1, Section 2.1: Message Format
+//
+// Parses the start line and header fields of a message (or the trailer section after a chunked body) as the bytes
+// come in, in however many pieces they arrive. The bytes are kept in one buffer, and the fields only remember where
+// in it their name and value are, so there's nothing to allocate per field unless the caller wants owned strings.
+class HeaderParser {
+public:
+    enum class Kind {
+        Request,
+        Response,
+        Trailers,
+    };
+
+    enum class State {
+        InStartLine,
+        InFields,
+        Done,
+        Failed,
+    };
+
+    struct Field {
+        StringView name;
+        StringView value;
+    };
+
+    // There's no limit on the size of the header section in the spec, but for our sanity, let's limit it to 64K.
+    static constexpr size_t default_max_size = 64 * KiB;
+
+    explicit HeaderParser(Kind, size_t max_size = default_max_size);
+
+    // Consumes the input up to the empty line that ends the header section, and returns how many bytes that was.
+    // Anything after that (the body, or the next pipelined message) is left for the caller.
+    size_t parse(ReadonlyBytes);
+    void reset(Kind);
+
+    Kind kind() const { return m_kind; }
+    State state() const { return m_state; }
+    bool is_done() const { return m_state == State::Done; }
+    bool has_failed() const { return m_state == State::Failed; }
+    StringView failure_reason() const { return m_failure_reason; }
+
+    // The start line is available as soon as the state has moved past InStartLine.
+    bool has_start_line() const { return m_kind != Kind::Trailers && m_state != State::InStartLine; }
+    StringView method() const { return view(m_method); }
+    StringView request_target() const { return view(m_request_target); }
+    u32 status_code() const { return m_status_code; }
+    StringView reason_phrase() const { return view(m_reason_phrase); }
+    u8 major_version() const { return m_major_version; }
+    u8 minor_version() const { return m_minor_version; }
+
+    size_t field_count() const { return m_fields.size(); }
+    Field field(size_t index) const { return { view(m_fields[index].name), view(m_fields[index].value) }; }
+    // Field names are case-insensitive, and this returns the value of the first field with the given name.
+    Optional<StringView> find(StringView name) const;
+
+    template<typename Callback>
+    void for_each_field(Callback callback) const
+    {
+        for (size_t i = 0; i < m_fields.size(); ++i)
+            callback(field(i));
+    }
+
+private:
+    struct Slice {
+        u32 offset { 0 };
+        u32 length { 0 };
+    };
+
+    struct FieldSlices {
+        Slice name;
+        Slice value;
+    };
+
+    StringView view(Slice slice) const { return { m_buffer.data() + slice.offset, slice.length }; }
+
+    void parse_line(size_t start, size_t end);
+    void parse_request_line(size_t start, size_t end);
+    void parse_status_line(size_t start, size_t end);
+    void parse_field_line(size_t start, size_t end);
+    bool parse_version(size_t start, size_t end);
+    void fail(StringView reason);
+
+    Kind m_kind { Kind::Request };
+    State m_state { State::InStartLine };
+    StringView m_failure_reason;
+    size_t m_max_size { 0 };
+
+    Vector<u8, 1024> m_buffer;
+    // Where the line that hasn't been seen in full yet starts in the buffer.
+    size_t m_line_start { 0 };
+
+    Slice m_method;
+    Slice m_request_target;
+    Slice m_reason_phrase;
+    u32 m_status_code { 0 };
+    u8 m_major_version { 0 };
+    u8 m_minor_version { 0 };
+
+    Vector<FieldSlices, 32> m_fields;
+};
+
+}
@@ -0,0 +1,857 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/QuickSort.h>
+#include <LibCore/EventLoop.h>
+#include <LibHTTP/Http2Connection.h>
+
+namespace HTTP {
+
+using namespace Http2;
+
+// How much the server may send us before it has to wait for us to read it; For each stream, and for all of them together.
+static constexpr size_t stream_window_size = 1 * MiB;
+static constexpr size_t connection_window_size = 16 * MiB;
+
+static constexpr size_t max_header_block_size = 256 * KiB;
+static constexpr u32 max_stream_id = 0x7fffffff;
+static constexpr u8 default_urgency = 3;
+
+static u32 read_u32(ReadonlyBytes bytes)
+{
+    return (static_cast<u32>(bytes[0]) << 24) | (static_cast<u32>(bytes[1]) << 16) | (static_cast<u32>(bytes[2]) << 8) | bytes[3];
+}
+
+static void write_u32(Bytes bytes, u32 value)
+{
+    bytes[0] = value >> 24;
+    bytes[1] = value >> 16;
+    bytes[2] = value >> 8;
+    bytes[3] = value;
+}
+
+// Section 8.3.1: Request Pseudo-Header Fields, followed by the request's own headers, minus the ones that only mean something to HTTP/1.1 (section 8.2.2).
+static Vector<HPACK::Header> request_headers_for(HttpRequest const& request)
+{
+    Vector<HPACK::Header> headers;
+    auto const& url = request.url();
+    auto authority = url.port().has_value() ? DeprecatedString::formatted("{}:{}", url.host(), *url.port()) : url.host();
+
+    headers.append({ ":method", request.method_name() });
+    if (request.method() == HttpRequest::Method::CONNECT) {
+        headers.append({ ":authority", move(authority) });
+    } else {
+        headers.append({ ":scheme", url.scheme() });
+        headers.append({ ":authority", move(authority) });
+        headers.append({ ":path", request.request_target() });
+    }
+
+    for (auto& header : request.headers()) {
+        auto name = header.name.to_lowercase();
+        if (name.is_one_of("connection", "host", "keep-alive", "proxy-connection", "transfer-encoding", "upgrade"))
+            continue;
+        if (name == "te" && !header.value.equals_ignoring_case("trailers"sv))
+            continue;
+        headers.append({ move(name), header.value });
+    }
+
+    if (auto encoding = request.streamed_body_encoding(); encoding.has_value()) {
+        if (auto name = content_encoding_name(*encoding); name.has_value())
+            headers.append({ "content-encoding", *name });
+    } else if (!request.body().is_empty() || request.method() == HttpRequest::Method::POST) {
+        headers.append({ "content-length", DeprecatedString::number(request.body().size()) });
+    }
+    return headers;
+}
+
+// RFC 9218 section 4: The Priority header is a dictionary, of which we only care about "u", the urgency.
+static u8 urgency_for(HttpRequest const& request)
+{
+    for (auto& header : request.headers()) {
+        if (!header.name.equals_ignoring_case("priority"sv))
+            continue;
+        for (auto parameter : header.value.split_view(',')) {
+            parameter = parameter.trim_whitespace();
+            if (parameter.length() == 3 && parameter.starts_with("u="sv) && parameter[2] >= '0' && parameter[2] <= '7')
+                return parameter[2] - '0';
+        }
+    }
+    return default_urgency;
+}
+
+Http2Stream::Http2Stream(Http2Connection& connection, Vector<HPACK::Header> request_headers, ByteBuffer request_body, bool request_body_is_streamed, u8 urgency)
+    : m_connection(connection)
+    , m_urgency(urgency)
+    , m_request_headers(move(request_headers))
+    , m_request_body(move(request_body))
+    , m_request_body_is_streamed(request_body_is_streamed)
+    , m_request_body_is_complete(!request_body_is_streamed)
+{
+}
+
+ErrorOr<void> Http2Stream::send_request_body_data(ReadonlyBytes data)
+{
+    VERIFY(m_request_body_is_streamed && !m_request_body_is_complete);
+    TRY(m_request_body.try_append(data));
+    if (auto connection = m_connection.strong_ref(); connection && m_state == State::Open)
+        connection->send_pending_request_bodies();
+    return {};
+}
+
+void Http2Stream::finish_request_body()
+{
+    VERIFY(m_request_body_is_streamed);
+    m_request_body_is_complete = true;
+    if (auto connection = m_connection.strong_ref(); connection && m_state == State::Open)
+        connection->send_pending_request_bodies();
+}
+
+void Http2Stream::did_consume_data(size_t size)
+{
+    auto connection = m_connection.strong_ref();
+    if (!connection || m_state == State::Closed)
+        return;
+
+    // Giving credit back a little at a time would cost a frame for every frame received.
+    m_unacknowledged_received_size += size;
+    if (m_unacknowledged_received_size < stream_window_size / 2)
+        return;
+    connection->send_window_update(m_id, m_unacknowledged_received_size);
+    m_receive_window += exchange(m_unacknowledged_received_size, 0);
+}
+
+void Http2Stream::cancel()
+{
+    on_headers = nullptr;
+    on_data = nullptr;
+    on_finish = nullptr;
+    on_error = nullptr;
+    on_request_body_sent = nullptr;
+
+    auto connection = m_connection.strong_ref();
+    if (!connection)
+        return;
+
+    switch (m_state) {
+    case State::Idle:
+        connection->m_pending_streams.remove_first_matching([&](auto& stream) { return stream.ptr() == this; });
+        m_state = State::Closed;
+        break;
+    case State::Open:
+    case State::HalfClosedLocal:
+        connection->send_rst_stream(m_id, ErrorCode::Cancel);
+        connection->remove_stream(*this);
+        connection->start_pending_streams();
+        break;
+    case State::Closed:
+        break;
+    }
+}
+
+ErrorOr<NonnullRefPtr<Http2Connection>> Http2Connection::create(Core::BufferedSocketBase& socket)
+{
+    auto connection = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Http2Connection(socket)));
+
+    // Section 3.4: The client connection preface is this magic string, followed by our SETTINGS.
+    TRY(socket.write_entire_buffer("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"sv.bytes()));
+    connection->send_settings();
+    connection->send_window_update(0, connection_window_size - default_window_size);
+    connection->m_receive_window = connection_window_size;
+
+    auto weak_connection = connection->make_weak_ptr<Http2Connection>();
+    socket.on_ready_to_read = [weak_connection] {
+        if (auto connection = weak_connection.strong_ref())
+            connection->read_from_socket();
+    };
+    socket.set_notifications_enabled(true);
+
+    // The server's preface may have come in together with the end of the TLS handshake, in which case the socket has it buffered already.
+    Core::deferred_invoke([weak_connection] {
+        if (auto connection = weak_connection.strong_ref())
+            connection->read_from_socket();
+    });
+    return connection;
+}
+
+Http2Connection::Http2Connection(Core::BufferedSocketBase& socket)
+    : m_socket(socket)
+{
+}
+
+Http2Connection::~Http2Connection()
+{
+    m_socket.on_ready_to_read = nullptr;
+    if (m_has_failed)
+        return;
+
+    u8 payload[8] {};
+    write_u32({ payload + 4, 4 }, to_underlying(ErrorCode::NoError));
+    send_frame(FrameType::GoAway, 0, 0, { payload, sizeof(payload) });
+}
+
+bool Http2Connection::can_open_stream() const
+{
+    return !m_has_failed && !m_has_received_goaway && m_next_stream_id + 2 * m_pending_streams.size() < max_stream_id;
+}
+
+ErrorOr<NonnullRefPtr<Http2Stream>> Http2Connection::open_stream(HttpRequest const& request)
+{
+    if (!can_open_stream())
+        return Error::from_string_literal("HTTP/2 connection can't open any more streams");
+
+    auto body = TRY(ByteBuffer::copy(request.body()));
+    auto stream = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Http2Stream(*this, request_headers_for(request), move(body), request.has_streamed_body(), urgency_for(request))));
+
+    size_t index = 0;
+    while (index < m_pending_streams.size() && m_pending_streams[index]->urgency() <= stream->urgency())
+        ++index;
+    m_pending_streams.insert(index, stream);
+    start_pending_streams();
+    return stream;
+}
+
+void Http2Connection::send_frame(FrameType type, u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (m_has_failed)
+        return;
+
+    VERIFY(payload.size() <= m_peer_max_frame_size);
+    u8 header[frame_header_size];
+    header[0] = payload.size() >> 16;
+    header[1] = payload.size() >> 8;
+    header[2] = payload.size();
+    header[3] = to_underlying(type);
+    header[4] = flags;
+    write_u32({ header + 5, 4 }, stream_id);
+
+    // The TLS socket coalesces these writes into as few records as it can, so there's no need to assemble the frame first.
+    auto result = m_socket.write_entire_buffer({ header, sizeof(header) });
+    if (!result.is_error())
+        result = m_socket.write_entire_buffer(payload);
+    if (result.is_error()) {
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Failed to send a frame: {}", result.error());
+        m_has_failed = true;
+        fail_streams({}, ErrorCode::InternalError);
+    }
+}
+
+void Http2Connection::send_settings()
+{
+    u8 payload[18];
+    auto set = [&](size_t index, SettingsParameter parameter, u32 value) {
+        payload[index * 6] = to_underlying(parameter) >> 8;
+        payload[index * 6 + 1] = to_underlying(parameter);
+        write_u32({ payload + index * 6 + 2, 4 }, value);
+    };
+    set(0, SettingsParameter::EnablePush, 0);
+    set(1, SettingsParameter::InitialWindowSize, stream_window_size);
+    set(2, SettingsParameter::MaxHeaderListSize, max_header_block_size);
+    send_frame(FrameType::Settings, 0, 0, { payload, sizeof(payload) });
+}
+
+void Http2Connection::send_window_update(u32 stream_id, size_t increment)
+{
+    u8 payload[4];
+    write_u32({ payload, 4 }, increment);
+    send_frame(FrameType::WindowUpdate, 0, stream_id, { payload, sizeof(payload) });
+}
+
+void Http2Connection::send_rst_stream(u32 stream_id, ErrorCode error)
+{
+    u8 payload[4];
+    write_u32({ payload, 4 }, to_underlying(error));
+    send_frame(FrameType::RstStream, 0, stream_id, { payload, sizeof(payload) });
+}
+
+void Http2Connection::read_from_socket()
+{
+    NonnullRefPtr protect = *this;
+
+    u8 buffer[16 * KiB];
+    while (!m_has_failed) {
+        auto can_read_without_blocking = m_socket.can_read_without_blocking();
+        if (can_read_without_blocking.is_error())
+            return did_fail(ErrorCode::InternalError);
+        if (!can_read_without_blocking.value())
+            break;
+
+        auto result = m_socket.read({ buffer, sizeof(buffer) });
+        if (result.is_error()) {
+            if (result.error().is_errno() && result.error().code() == EINTR)
+                continue;
+            dbgln_if(HTTP2_DEBUG, "Http2Connection: Failed to read from the socket: {}", result.error());
+            return did_fail(ErrorCode::InternalError);
+        }
+        if (result.value().is_empty())
+            break;
+        if (m_receive_buffer.try_append(result.value()).is_error())
+            return did_fail(ErrorCode::InternalError);
+    }
+
+    size_t offset = 0;
+    while (!m_has_failed) {
+        auto available = m_receive_buffer.bytes().slice(offset);
+        if (available.size() < frame_header_size)
+            break;
+
+        // We never raise SETTINGS_MAX_FRAME_SIZE, so anything larger than the default is an error.
+        size_t length = (available[0] << 16) | (available[1] << 8) | available[2];
+        if (length > default_max_frame_size)
+            return did_fail(ErrorCode::FrameSizeError);
+        if (available.size() < frame_header_size + length)
+            break;
+
+        auto type = static_cast<FrameType>(available[3]);
+        auto flags = available[4];
+        auto stream_id = read_u32(available.slice(5, 4)) & max_stream_id;
+        offset += frame_header_size + length;
+
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Received frame of type {} with flags {:#x} for stream {}, {} bytes", to_underlying(type), flags, stream_id, length);
+        if (auto error = handle_frame(type, flags, stream_id, available.slice(frame_header_size, length)); error != ErrorCode::NoError)
+            return did_fail(error);
+    }
+
+    if (m_has_failed)
+        return;
+
+    if (offset == m_receive_buffer.size()) {
+        m_receive_buffer.clear();
+    } else if (offset != 0) {
+        auto remaining = m_receive_buffer.size() - offset;
+        memmove(m_receive_buffer.data(), m_receive_buffer.data() + offset, remaining);
+        m_receive_buffer.resize(remaining);
+    }
+
+    if (m_socket.is_eof() || !m_socket.is_open()) {
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: The server closed the connection");
+        m_has_failed = true;
+        fail_streams({}, m_has_received_goaway ? ErrorCode::RefusedStream : ErrorCode::ConnectError);
+    }
+}
+
+ErrorCode Http2Connection::handle_frame(FrameType type, u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    // Section 3.4: The server connection preface has to start with SETTINGS.
+    if (!m_has_received_settings && (type != FrameType::Settings || (flags & FrameFlags::Ack)))
+        return ErrorCode::ProtocolError;
+
+    // Section 6.10: Nothing else may come in between the frames of a header block.
+    if (m_header_block_stream_id != 0 && type != FrameType::Continuation)
+        return ErrorCode::ProtocolError;
+
+    switch (type) {
+    case FrameType::Data:
+        return handle_data_frame(flags, stream_id, payload);
+    case FrameType::Headers:
+        return handle_headers_frame(flags, stream_id, payload);
+    case FrameType::Priority:
+        // Section 5.3.2: The priority signals of RFC 7540 are deprecated, and a client wouldn't receive any anyway.
+        if (stream_id == 0)
+            return ErrorCode::ProtocolError;
+        return ErrorCode::NoError;
+    case FrameType::RstStream:
+        return handle_rst_stream_frame(stream_id, payload);
+    case FrameType::Settings:
+        return handle_settings_frame(flags, stream_id, payload);
+    case FrameType::PushPromise:
+        // We disabled server push with our SETTINGS.
+        return ErrorCode::ProtocolError;
+    case FrameType::Ping:
+        return handle_ping_frame(flags, stream_id, payload);
+    case FrameType::GoAway:
+        return handle_goaway_frame(stream_id, payload);
+    case FrameType::WindowUpdate:
+        return handle_window_update_frame(stream_id, payload);
+    case FrameType::Continuation:
+        return handle_continuation_frame(flags, stream_id, payload);
+    }
+
+    // Section 4.1: Frames of unknown types have to be ignored.
+    return ErrorCode::NoError;
+}
+
+ErrorCode Http2Connection::handle_data_frame(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id == 0)
+        return ErrorCode::ProtocolError;
+
+    // Section 6.9.1: The whole frame counts against the flow control windows, padding included.
+    if (static_cast<i64>(payload.size()) > m_receive_window)
+        return ErrorCode::FlowControlError;
+    m_receive_window -= payload.size();
+
+    // The stream windows are what keeps a single slow reader from getting sent too much, so the connection gets its credit back right away.
+    m_unacknowledged_received_size += payload.size();
+    if (m_unacknowledged_received_size >= connection_window_size / 2) {
+        send_window_update(0, m_unacknowledged_received_size);
+        m_receive_window += exchange(m_unacknowledged_received_size, 0);
+    }
+
+    auto data = payload;
+    if (flags & FrameFlags::Padded) {
+        if (payload.is_empty() || payload[0] >= payload.size())
+            return ErrorCode::ProtocolError;
+        data = payload.slice(1, payload.size() - 1 - payload[0]);
+    }
+
+    auto it = m_streams.find(stream_id);
+    if (it == m_streams.end()) {
+        // This is most likely for a stream we reset, before the server found out about it.
+        return stream_id >= m_next_stream_id ? ErrorCode::ProtocolError : ErrorCode::NoError;
+    }
+    NonnullRefPtr stream = it->value;
+
+    if (!stream->m_has_received_headers) {
+        reset_stream(*stream, ErrorCode::ProtocolError);
+        return ErrorCode::NoError;
+    }
+    if (static_cast<i64>(payload.size()) > stream->m_receive_window) {
+        reset_stream(*stream, ErrorCode::FlowControlError);
+        return ErrorCode::NoError;
+    }
+    stream->m_receive_window -= payload.size();
+    stream->m_unacknowledged_received_size += payload.size() - data.size();
+
+    if (!data.is_empty() && stream->on_data)
+        stream->on_data(data);
+    if (flags & FrameFlags::EndStream)
+        stream_did_end(*stream);
+    return ErrorCode::NoError;
+}
+
+ErrorCode Http2Connection::handle_headers_frame(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id == 0)
+        return ErrorCode::ProtocolError;
+
+    size_t offset = 0;
+    size_t padding = 0;
+    if (flags & FrameFlags::Padded) {
+        if (payload.is_empty())
+            return ErrorCode::ProtocolError;
+        padding = payload[0];
+        offset = 1;
+    }
+    // Section 6.2: We ignore the deprecated priority signal.
+    if (flags & FrameFlags::Priority)
+        offset += 5;
+    if (offset + padding > payload.size())
+        return ErrorCode::ProtocolError;
+    if (payload.size() - offset - padding > max_header_block_size)
+        return ErrorCode::EnhanceYourCalm;
+
+    if (m_header_block.try_append(payload.slice(offset, payload.size() - offset - padding)).is_error())
+        return ErrorCode::InternalError;
+    m_header_block_stream_id = stream_id;
+    m_header_block_ends_stream = flags & FrameFlags::EndStream;
+
+    if (flags & FrameFlags::EndHeaders)
+        return finish_header_block();
+    return ErrorCode::NoError;
+}
+
+ErrorCode Http2Connection::handle_continuation_frame(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (m_header_block_stream_id == 0 || stream_id != m_header_block_stream_id)
+        return ErrorCode::ProtocolError;
+    if (m_header_block.size() + payload.size() > max_header_block_size)
+        return ErrorCode::EnhanceYourCalm;
+    if (m_header_block.try_append(payload).is_error())
+        return ErrorCode::InternalError;
+
+    if (flags & FrameFlags::EndHeaders)
+        return finish_header_block();
+    return ErrorCode::NoError;
+}
+
+ErrorCode Http2Connection::finish_header_block()
+{
+    auto stream_id = exchange(m_header_block_stream_id, 0);
+    auto header_block = move(m_header_block);
+    auto ends_stream = m_header_block_ends_stream;
+
+    // Section 4.3: Every header block has to be decoded, even if its stream is gone, or the compression contexts go out of sync.
+    auto headers_or_error = m_decoder.decode(header_block);
+    if (headers_or_error.is_error()) {
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Failed to decode a header block: {}", headers_or_error.error());
+        return ErrorCode::CompressionError;
+    }
+
+    auto it = m_streams.find(stream_id);
+    if (it == m_streams.end())
+        return stream_id >= m_next_stream_id ? ErrorCode::ProtocolError : ErrorCode::NoError;
+    NonnullRefPtr stream = it->value;
+
+    // A second header block is trailers, which we don't have any use for, but which do have to end the stream.
+    if (stream->m_has_received_headers) {
+        if (!ends_stream)
+            reset_stream(*stream, ErrorCode::ProtocolError);
+        else
+            stream_did_end(*stream);
+        return ErrorCode::NoError;
+    }
+
+    // Section 8.3.2: Responses have the :status pseudo-header, and nothing but.
+    Optional<u32> status;
+    Vector<HPACK::Header> headers;
+    for (auto& header : headers_or_error.value()) {
+        if (header.name == ":status"sv) {
+            status = header.value.to_uint();
+            if (!status.has_value())
+                break;
+        } else if (header.name.starts_with(':')) {
+            status = {};
+            break;
+        } else {
+            headers.append(move(header));
+        }
+    }
+    if (!status.has_value()) {
+        reset_stream(*stream, ErrorCode::ProtocolError);
+        return ErrorCode::NoError;
+    }
+
+    // Section 8.1: Any number of informational responses may come before the final one.
+    if (*status >= 100 && *status < 200) {
+        if (ends_stream)
+            reset_stream(*stream, ErrorCode::ProtocolError);
+        return ErrorCode::NoError;
+    }
+
+    stream->m_has_received_headers = true;
+    if (stream->on_headers)
+        stream->on_headers(*status, headers);
+    if (ends_stream)
+        stream_did_end(*stream);
+    return ErrorCode::NoError;
+}
+
+ErrorCode Http2Connection::handle_rst_stream_frame(u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id == 0)
+        return ErrorCode::ProtocolError;
+    if (payload.size() != 4)
+        return ErrorCode::FrameSizeError;
+
+    auto it = m_streams.find(stream_id);
+    if (it == m_streams.end())
+        return stream_id >= m_next_stream_id ? ErrorCode::ProtocolError : ErrorCode::NoError;
+    NonnullRefPtr stream = it->value;
+
+    auto error = static_cast<ErrorCode>(read_u32(payload));
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Server reset stream {} with error {}", stream_id, to_underlying(error));
+    remove_stream(*stream);
+
+    // Section 8.7: A refused stream wasn't processed at all, which happens when we open more streams than the server allows
+    // before its SETTINGS arrive. It's safe to try again once we know the limit.
+    if (error == ErrorCode::RefusedStream && !stream->m_has_received_headers && !stream->m_was_refused && !stream->m_has_discarded_request_body) {
+        stream->m_was_refused = true;
+        stream->m_state = Http2Stream::State::Idle;
+        stream->m_request_body_offset = 0;
+        size_t index = 0;
+        while (index < m_pending_streams.size() && m_pending_streams[index]->urgency() < stream->urgency())
+            ++index;
+        m_pending_streams.insert(index, stream);
+        start_pending_streams();
+        return ErrorCode::NoError;
+    }
+
+    start_pending_streams();
+    if (stream->on_error)
+        stream->on_error(error);
+    return ErrorCode::NoError;
+}
+
+ErrorCode Http2Connection::handle_settings_frame(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id != 0)
+        return ErrorCode::ProtocolError;
+    if (flags & FrameFlags::Ack)
+        return payload.is_empty() ? ErrorCode::NoError : ErrorCode::FrameSizeError;
+    if (payload.size() % 6 != 0)
+        return ErrorCode::FrameSizeError;
+
+    for (size_t offset = 0; offset < payload.size(); offset += 6) {
+        auto parameter = static_cast<SettingsParameter>((payload[offset] << 8) | payload[offset + 1]);
+        auto value = read_u32(payload.slice(offset + 2, 4));
+
+        switch (parameter) {
+        case SettingsParameter::HeaderTableSize:
+            m_encoder.set_max_table_size(value);
+            break;
+        case SettingsParameter::EnablePush:
+            if (value > 1)
+                return ErrorCode::ProtocolError;
+            break;
+        case SettingsParameter::MaxConcurrentStreams:
+            m_peer_max_concurrent_streams = value;
+            break;
+        case SettingsParameter::InitialWindowSize: {
+            if (value > max_window_size)
+                return ErrorCode::FlowControlError;
+            // Section 6.9.2: This changes the windows of the streams that are already open too.
+            auto delta = static_cast<i64>(value) - static_cast<i64>(m_peer_initial_window_size);
+            for (auto& it : m_streams) {
+                it.value->m_send_window += delta;
+                if (it.value->m_send_window > static_cast<i64>(max_window_size))
+                    return ErrorCode::FlowControlError;
+            }
+            m_peer_initial_window_size = value;
+            break;
+        }
+        case SettingsParameter::MaxFrameSize:
+            if (value < default_max_frame_size || value > 0xffffff)
+                return ErrorCode::ProtocolError;
+            m_peer_max_frame_size = value;
+            break;
+        case SettingsParameter::MaxHeaderListSize:
+            // This is only advisory, and our requests are nowhere near any sensible limit.
+            break;
+        default:
+            // Section 6.5.2: Unknown settings have to be ignored.
+            break;
+        }
+    }
+
+    m_has_received_settings = true;
+    send_frame(FrameType::Settings, FrameFlags::Ack, 0, {});
+
+    start_pending_streams();
+    send_pending_request_bodies();
+    return ErrorCode::NoError;
+}
+
+ErrorCode Http2Connection::handle_ping_frame(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id != 0)
+        return ErrorCode::ProtocolError;
+    if (payload.size() != 8)
+        return ErrorCode::FrameSizeError;
+    if (!(flags & FrameFlags::Ack))
+        send_frame(FrameType::Ping, FrameFlags::Ack, 0, payload);
+    return ErrorCode::NoError;
+}
+
+ErrorCode Http2Connection::handle_goaway_frame(u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id != 0)
+        return ErrorCode::ProtocolError;
+    if (payload.size() < 8)
+        return ErrorCode::FrameSizeError;
+
+    auto last_stream_id = read_u32(payload) & max_stream_id;
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Server is going away after stream {} with error {}", last_stream_id, read_u32(payload.slice(4)));
+    m_has_received_goaway = true;
+
+    // Section 6.8: The server didn't and won't process any of the streams after the last one, which can safely be retried elsewhere.
+    Vector<NonnullRefPtr<Http2Stream>> refused_streams;
+    for (auto& it : m_streams) {
+        if (it.key > last_stream_id)
+            refused_streams.append(it.value);
+    }
+    for (auto& stream : refused_streams)
+        m_streams.remove(stream->id());
+    refused_streams.extend(move(m_pending_streams));
+    fail_streams(move(refused_streams), ErrorCode::RefusedStream);
+    return ErrorCode::NoError;
+}
+
+ErrorCode Http2Connection::handle_window_update_frame(u32 stream_id, ReadonlyBytes payload)
+{
+    if (payload.size() != 4)
+        return ErrorCode::FrameSizeError;
+    auto increment = read_u32(payload) & max_stream_id;
+
+    if (stream_id == 0) {
+        if (increment == 0)
+            return ErrorCode::ProtocolError;
+        m_send_window += increment;
+        if (m_send_window > static_cast<i64>(max_window_size))
+            return ErrorCode::FlowControlError;
+    } else {
+        auto it = m_streams.find(stream_id);
+        if (it == m_streams.end())
+            return ErrorCode::NoError;
+        NonnullRefPtr stream = it->value;
+        if (increment == 0) {
+            reset_stream(*stream, ErrorCode::ProtocolError);
+            return ErrorCode::NoError;
+        }
+        stream->m_send_window += increment;
+        if (stream->m_send_window > static_cast<i64>(max_window_size)) {
+            reset_stream(*stream, ErrorCode::FlowControlError);
+            return ErrorCode::NoError;
+        }
+    }
+
+    send_pending_request_bodies();
+    return ErrorCode::NoError;
+}
+
+void Http2Connection::start_pending_streams()
+{
+    while (!m_pending_streams.is_empty() && m_streams.size() < m_peer_max_concurrent_streams && can_open_stream()) {
+        auto stream = m_pending_streams.take_first();
+        auto header_block_or_error = m_encoder.encode(stream->m_request_headers);
+        if (header_block_or_error.is_error()) {
+            stream->m_state = Http2Stream::State::Closed;
+            if (stream->on_error)
+                stream->on_error(ErrorCode::InternalError);
+            continue;
+        }
+
+        stream->m_id = m_next_stream_id;
+        m_next_stream_id += 2;
+        stream->m_send_window = m_peer_initial_window_size;
+        stream->m_receive_window = stream_window_size;
+        bool ends_stream = stream->m_request_body.is_empty() && stream->m_request_body_is_complete;
+        stream->m_state = ends_stream ? Http2Stream::State::HalfClosedLocal : Http2Stream::State::Open;
+        m_streams.set(stream->m_id, stream);
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Opening stream {} with urgency {}", stream->m_id, stream->m_urgency);
+
+        // The urgency goes into the weight as well, for the servers that still go by the deprecated priority signal of RFC 7540.
+        auto header_block = header_block_or_error.value().bytes();
+        auto fragment = header_block.trim(m_peer_max_frame_size - 5);
+        u8 priority[5] = { 0, 0, 0, 0, static_cast<u8>((256 >> stream->m_urgency) - 1) };
+        ByteBuffer payload;
+        if (payload.try_append(priority, sizeof(priority)).is_error() || payload.try_append(fragment).is_error())
+            return did_fail(ErrorCode::InternalError);
+
+        u8 flags = FrameFlags::Priority;
+        if (ends_stream)
+            flags |= FrameFlags::EndStream;
+        if (fragment.size() == header_block.size())
+            flags |= FrameFlags::EndHeaders;
+        send_frame(FrameType::Headers, flags, stream->m_id, payload);
+
+        header_block = header_block.slice(fragment.size());
+        while (!header_block.is_empty()) {
+            fragment = header_block.trim(m_peer_max_frame_size);
+            header_block = header_block.slice(fragment.size());
+            send_frame(FrameType::Continuation, header_block.is_empty() ? FrameFlags::EndHeaders : 0, stream->m_id, fragment);
+        }
+    }
+
+    send_pending_request_bodies();
+}
+
+void Http2Connection::send_pending_request_bodies()
+{
+    Vector<NonnullRefPtr<Http2Stream>> sending_streams;
+    for (auto& it : m_streams) {
+        if (it.value->has_request_body_to_send())
+            sending_streams.append(it.value);
+    }
+
+    // The more urgent streams get to use up the connection's window first, and otherwise the oldest ones do.
+    quick_sort(sending_streams, [](auto& a, auto& b) {
+        if (a->m_urgency != b->m_urgency)
+            return a->m_urgency < b->m_urgency;
+        return a->m_id < b->m_id;
+    });
+
+    Vector<NonnullRefPtr<Http2Stream>> drained_streams;
+    for (auto& stream : sending_streams) {
+        while (!m_has_failed && stream->has_request_body_to_send() && m_send_window > 0 && stream->m_send_window > 0) {
+            auto remaining = stream->m_request_body.bytes().slice(stream->m_request_body_offset);
+            auto size = min(remaining.size(), min(m_peer_max_frame_size, static_cast<size_t>(min(m_send_window, stream->m_send_window))));
+            bool is_last = size == remaining.size() && stream->m_request_body_is_complete;
+
+            send_frame(FrameType::Data, is_last ? FrameFlags::EndStream : 0, stream->m_id, remaining.trim(size));
+            stream->m_request_body_offset += size;
+            stream->m_send_window -= size;
+            m_send_window -= size;
+            if (is_last)
+                stream->m_state = Http2Stream::State::HalfClosedLocal;
+        }
+
+        if (stream->m_request_body_is_streamed && stream->unsent_request_body_size() == 0) {
+            if (!stream->m_request_body.is_empty()) {
+                stream->m_request_body.clear();
+                stream->m_request_body_offset = 0;
+                stream->m_has_discarded_request_body = true;
+            }
+            if (!stream->m_request_body_is_complete)
+                drained_streams.append(stream);
+        }
+        if (m_send_window <= 0)
+            break;
+    }
+
+    for (auto& stream : drained_streams) {
+        if (stream->on_request_body_sent)
+            stream->on_request_body_sent();
+    }
+}
+
+void Http2Connection::stream_did_end(Http2Stream& stream)
+{
+    if (stream.m_state == Http2Stream::State::Closed)
+        return;
+
+    // Section 8.1: The server may respond before it got all of the request, in which case we stop sending the rest of it.
+    if (stream.m_state == Http2Stream::State::Open)
+        send_rst_stream(stream.m_id, ErrorCode::NoError);
+
+    NonnullRefPtr protect = stream;
+    remove_stream(stream);
+    start_pending_streams();
+    if (stream.on_finish)
+        stream.on_finish();
+}
+
+void Http2Connection::reset_stream(Http2Stream& stream, ErrorCode error)
+{
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Resetting stream {} with error {}", stream.m_id, to_underlying(error));
+    send_rst_stream(stream.m_id, error);
+
+    NonnullRefPtr protect = stream;
+    remove_stream(stream);
+    start_pending_streams();
+    if (stream.on_error)
+        stream.on_error(error);
+}
+
+void Http2Connection::remove_stream(Http2Stream& stream)
+{
+    stream.m_state = Http2Stream::State::Closed;
+    m_streams.remove(stream.m_id);
+}
+
+void Http2Connection::did_fail(ErrorCode error)
+{
+    if (m_has_failed)
+        return;
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Connection error {}", to_underlying(error));
+
+    // Section 5.4.1: A connection error is answered with GOAWAY, after which the connection is done for.
+    u8 payload[8] {};
+    write_u32({ payload + 4, 4 }, to_underlying(error));
+    send_frame(FrameType::GoAway, 0, 0, { payload, sizeof(payload) });
+    m_has_failed = true;
+    m_socket.close();
+    fail_streams({}, error);
+}
+
+void Http2Connection::fail_streams(Vector<NonnullRefPtr<Http2Stream>> streams, ErrorCode error)
+{
+    // Once the connection has failed, that's everything that's left on it.
+    if (m_has_failed) {
+        streams.extend(move(m_pending_streams));
+        for (auto& it : m_streams)
+            streams.append(it.value);
+        m_streams.clear();
+    }
+
+    for (auto& stream : streams) {
+        stream->m_state = Http2Stream::State::Closed;
+        if (stream->on_error)
+            stream->on_error(error);
+    }
+}
+
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/Vector.h>
+#include <AK/WeakPtr.h>
+#include <AK/Weakable.h>
+#include <LibCore/Socket.h>
+#include <LibHTTP/HPACK.h>
+#include <LibHTTP/HttpRequest.h>
+
+namespace HTTP {
+
+// RFC 9113: HTTP/2
+namespace Http2 {
+
+// Section 4.1: Frame Format
+constexpr size_t frame_header_size = 9;
+
+// Section 6: Frame Definitions
+enum class FrameType : u8 {
+    Data = 0x0,
+    Headers = 0x1,
+    Priority = 0x2,
+    RstStream = 0x3,
+    Settings = 0x4,
+    PushPromise = 0x5,
+    Ping = 0x6,
+    GoAway = 0x7,
+    WindowUpdate = 0x8,
+    Continuation = 0x9,
+};
+
+enum FrameFlags : u8 {
+    EndStream = 0x1,
+    Ack = 0x1,
+    EndHeaders = 0x4,
+    Padded = 0x8,
+    Priority = 0x20,
+};
+
+// Section 6.5.2: Defined Settings
+enum class SettingsParameter : u16 {
+    HeaderTableSize = 0x1,
+    EnablePush = 0x2,
+    MaxConcurrentStreams = 0x3,
+    InitialWindowSize = 0x4,
+    MaxFrameSize = 0x5,
+    MaxHeaderListSize = 0x6,
+};
+
+// Section 7: Error Codes
+enum class ErrorCode : u32 {
+    NoError = 0x0,
+    ProtocolError = 0x1,
+    InternalError = 0x2,
+    FlowControlError = 0x3,
+    SettingsTimeout = 0x4,
+    StreamClosed = 0x5,
+    FrameSizeError = 0x6,
+    RefusedStream = 0x7,
+    Cancel = 0x8,
+    CompressionError = 0x9,
+    ConnectError = 0xa,
+    EnhanceYourCalm = 0xb,
+    InadequateSecurity = 0xc,
+    Http11Required = 0xd,
+};
+
+constexpr size_t default_window_size = 65535;
+constexpr size_t default_max_frame_size = 16384;
+constexpr size_t max_window_size = 0x7fffffff;
+
+}
+
+class Http2Connection;
+
+class Http2Stream : public RefCounted<Http2Stream> {
+    friend class Http2Connection;
+
+public:
+    u32 id() const { return m_id; }
+    u8 urgency() const { return m_urgency; }
+
+    // The status is taken out of the headers, and informational (1xx) responses are skipped.
+    Function<void(u32 status, Vector<HPACK::Header> const&)> on_headers;
+    Function<void(ReadonlyBytes)> on_data;
+    Function<void()> on_finish;
+    Function<void(Http2::ErrorCode)> on_error;
+
+    // The server can only send as much as it was given credit for, so whoever reads the data has to say when it's been dealt with.
+    void did_consume_data(size_t);
+
+    // A streamed request body is handed over as it comes, and it's up to the caller not to get too far ahead of what
+    // could be sent: on_request_body_sent is called whenever everything handed over so far has gone out.
+    ErrorOr<void> send_request_body_data(ReadonlyBytes);
+    void finish_request_body();
+    size_t unsent_request_body_size() const { return m_request_body.size() - m_request_body_offset; }
+    Function<void()> on_request_body_sent;
+
+    // Resets the stream if it's still open, and makes sure none of the callbacks get called anymore.
+    void cancel();
+
+private:
+    enum class State {
+        Idle,
+        Open,
+        HalfClosedLocal,
+        Closed,
+    };
+
+    Http2Stream(Http2Connection&, Vector<HPACK::Header> request_headers, ByteBuffer request_body, bool request_body_is_streamed, u8 urgency);
+
+    bool has_request_body_to_send() const { return m_state == State::Open && (m_request_body_offset < m_request_body.size() || m_request_body_is_complete); }
+
+    WeakPtr<Http2Connection> m_connection;
+    u32 m_id { 0 };
+    State m_state { State::Idle };
+
+    // RFC 9218: Extensible Prioritization Scheme for HTTP, from 0 (most urgent) to 7.
+    u8 m_urgency { 3 };
+
+    // Kept until the stream is done, in case the server refuses it and it has to be sent again.
+    Vector<HPACK::Header> m_request_headers;
+    ByteBuffer m_request_body;
+    size_t m_request_body_offset { 0 };
+    // What has been sent of a streamed body is let go of, after which the stream can't be sent again.
+    bool m_request_body_is_streamed { false };
+    bool m_request_body_is_complete { true };
+    bool m_has_discarded_request_body { false };
+
+    i64 m_send_window { 0 };
+    i64 m_receive_window { 0 };
+    size_t m_unacknowledged_received_size { 0 };
+    bool m_has_received_headers { false };
+    bool m_was_refused { false };
+};
+
+// Runs any number of requests at once over one connection to an origin, each as its own stream.
+class Http2Connection
+    : public RefCounted<Http2Connection>
+    , public Weakable<Http2Connection> {
+    friend class Http2Stream;
+
+public:
+    // The socket has to have negotiated "h2" with ALPN already, and must outlive the connection.
+    static ErrorOr<NonnullRefPtr<Http2Connection>> create(Core::BufferedSocketBase&);
+    ~Http2Connection();
+
+    ErrorOr<NonnullRefPtr<Http2Stream>> open_stream(HttpRequest const&);
+
+    // False once the connection failed or the server sent GOAWAY, after which requests have to go over a new connection.
+    bool can_open_stream() const;
+    size_t stream_count() const { return m_streams.size() + m_pending_streams.size(); }
+
+private:
+    explicit Http2Connection(Core::BufferedSocketBase&);
+
+    void send_frame(Http2::FrameType, u8 flags, u32 stream_id, ReadonlyBytes payload);
+    void send_settings();
+    void send_window_update(u32 stream_id, size_t increment);
+    void send_rst_stream(u32 stream_id, Http2::ErrorCode);
+
+    void read_from_socket();
+    Http2::ErrorCode handle_frame(Http2::FrameType, u8 flags, u32 stream_id, ReadonlyBytes payload);
+    Http2::ErrorCode handle_data_frame(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    Http2::ErrorCode handle_headers_frame(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    Http2::ErrorCode handle_continuation_frame(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    Http2::ErrorCode handle_rst_stream_frame(u32 stream_id, ReadonlyBytes payload);
+    Http2::ErrorCode handle_settings_frame(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    Http2::ErrorCode handle_ping_frame(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    Http2::ErrorCode handle_goaway_frame(u32 stream_id, ReadonlyBytes payload);
+    Http2::ErrorCode handle_window_update_frame(u32 stream_id, ReadonlyBytes payload);
+    Http2::ErrorCode finish_header_block();
+
+    void start_pending_streams();
+    void send_pending_request_bodies();
+    void stream_did_end(Http2Stream&);
+    void reset_stream(Http2Stream&, Http2::ErrorCode);
+    void remove_stream(Http2Stream&);
+
+    void did_fail(Http2::ErrorCode);
+    void fail_streams(Vector<NonnullRefPtr<Http2Stream>>, Http2::ErrorCode);
+
+    Core::BufferedSocketBase& m_socket;
+    ByteBuffer m_receive_buffer;
+
+    HPACK::Encoder m_encoder;
+    HPACK::Decoder m_decoder;
+
+    HashMap<u32, NonnullRefPtr<Http2Stream>> m_streams;
+    // Streams that have to wait until the server allows more concurrent streams, most urgent first.
+    Vector<NonnullRefPtr<Http2Stream>> m_pending_streams;
+    u32 m_next_stream_id { 1 };
+
+    // A header block can be split across HEADERS and CONTINUATION frames, which nothing else may come in between of.
+    ByteBuffer m_header_block;
+    u32 m_header_block_stream_id { 0 };
+    bool m_header_block_ends_stream { false };
+
+    // What the server told us in its SETTINGS.
+    size_t m_peer_max_concurrent_streams { 100 };
+    size_t m_peer_initial_window_size { Http2::default_window_size };
+    size_t m_peer_max_frame_size { Http2::default_max_frame_size };
+
+    i64 m_send_window { Http2::default_window_size };
+    i64 m_receive_window { Http2::default_window_size };
+    size_t m_unacknowledged_received_size { 0 };
+
+    bool m_has_received_settings { false };
+    bool m_has_received_goaway { false };
+    bool m_has_failed { false };
+};
+
+}
@@ -7,6 +7,7 @@
 
 #include <AK/Base64.h>
 #include <AK/StringBuilder.h>
+#include <LibHTTP/HeaderParser.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/Job.h>
 
@@ -38,16 +39,27 @@ DeprecatedString to_deprecated_string(HttpRequest::Method method)
     }
 }
 
+Optional<StringView> content_encoding_name(HttpRequest::BodyEncoding encoding)
+{
+    switch (encoding) {
+    case HttpRequest::BodyEncoding::Identity:
+        return {};
+    case HttpRequest::BodyEncoding::Gzip:
+        return "gzip"sv;
+    case HttpRequest::BodyEncoding::Deflate:
+        return "deflate"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
 DeprecatedString HttpRequest::method_name() const
 {
     return to_deprecated_string(m_method);
 }
 
-ByteBuffer HttpRequest::to_raw_request() const
+DeprecatedString HttpRequest::request_target() const
 {
     StringBuilder builder;
-    builder.append(method_name());
-    builder.append(' ');
     // NOTE: The percent_encode is so that e.g. spaces are properly encoded.
     auto path = m_url.path();
     VERIFY(!path.is_empty());
@@ -56,6 +68,15 @@ ByteBuffer HttpRequest::to_raw_request() const
         builder.append('?');
         builder.append(m_url.query());
     }
+    return builder.to_deprecated_string();
+}
+
+ByteBuffer HttpRequest::to_raw_request() const
+{
+    StringBuilder builder;
+    builder.append(method_name());
+    builder.append(' ');
+    builder.append(request_target());
     builder.append(" HTTP/1.1\r\nHost: "sv);
     builder.append(m_url.host());
     if (m_url.port().has_value())
@@ -67,6 +88,12 @@ ByteBuffer HttpRequest::to_raw_request() const
         builder.append(header.value);
         builder.append("\r\n"sv);
     }
+    if (auto encoding = m_streamed_body_encoding; encoding.has_value()) {
+        if (auto name = content_encoding_name(*encoding); name.has_value())
+            builder.appendff("Content-Encoding: {}\r\n", *name);
+        builder.append("Transfer-Encoding: chunked\r\n\r\n"sv);
+        return builder.to_byte_buffer();
+    }
     if (!m_body.is_empty() || method() == Method::POST) {
         builder.appendff("Content-Length: {}\r\n\r\n", m_body.size());
         builder.append((char const*)m_body.data(), m_body.size());
@@ -77,116 +104,31 @@ ByteBuffer HttpRequest::to_raw_request() const
 
 Optional<HttpRequest> HttpRequest::from_raw_request(ReadonlyBytes raw_request)
 {
-    enum class State {
-        InMethod,
-        InResource,
-        InProtocol,
-        InHeaderName,
-        InHeaderValue,
-        InBody,
-    };
-
-    State state { State::InMethod };
-    size_t index = 0;
-
-    auto peek = [&](int offset = 0) -> u8 {
-        if (index + offset >= raw_request.size())
-            return 0;
-        return raw_request[index + offset];
-    };
+    HeaderParser parser { HeaderParser::Kind::Request };
+    auto header_size = parser.parse(raw_request);
+    if (!parser.is_done())
+        return {};
+    return from_parsed_headers(parser, raw_request.slice(header_size));
+}
 
-    auto consume = [&]() -> u8 {
-        VERIFY(index < raw_request.size());
-        return raw_request[index++];
-    };
+Optional<HttpRequest> HttpRequest::from_parsed_headers(HeaderParser const& parser, ReadonlyBytes raw_body)
+{
+    VERIFY(parser.is_done() && parser.kind() == HeaderParser::Kind::Request);
 
-    Vector<u8, 256> buffer;
+    auto method = parser.method();
+    auto resource = parser.request_target();
 
-    DeprecatedString method;
-    DeprecatedString resource;
-    DeprecatedString protocol;
     Vector<Header> headers;
-    Header current_header;
-    ByteBuffer body;
-
-    auto commit_and_advance_to = [&](auto& output, State new_state) {
-        output = DeprecatedString::copy(buffer);
-        buffer.clear();
-        state = new_state;
-    };
-
-    while (index < raw_request.size()) {
-        // FIXME: Figure out what the appropriate limitations should be.
-        if (buffer.size() > 65536)
-            return {};
-        switch (state) {
-        case State::InMethod:
-            if (peek() == ' ') {
-                consume();
-                commit_and_advance_to(method, State::InResource);
-                break;
-            }
-            buffer.append(consume());
-            break;
-        case State::InResource:
-            if (peek() == ' ') {
-                consume();
-                commit_and_advance_to(resource, State::InProtocol);
-                break;
-            }
-            buffer.append(consume());
-            break;
-        case State::InProtocol:
-            if (peek(0) == '\r' && peek(1) == '\n') {
-                consume();
-                consume();
-                commit_and_advance_to(protocol, State::InHeaderName);
-                break;
-            }
-            buffer.append(consume());
-            break;
-        case State::InHeaderName:
-            if (peek(0) == ':' && peek(1) == ' ') {
-                consume();
-                consume();
-                commit_and_advance_to(current_header.name, State::InHeaderValue);
-                break;
-            }
-            buffer.append(consume());
-            break;
-        case State::InHeaderValue:
-            if (peek(0) == '\r' && peek(1) == '\n') {
-                consume();
-                consume();
-
-                // Detect end of headers
-                auto next_state = State::InHeaderName;
-                if (peek(0) == '\r' && peek(1) == '\n') {
-                    consume();
-                    consume();
-                    next_state = State::InBody;
-                }
-
-                commit_and_advance_to(current_header.value, next_state);
-                headers.append(move(current_header));
-                break;
-            }
-            buffer.append(consume());
-            break;
-        case State::InBody:
-            buffer.append(consume());
-            if (index == raw_request.size()) {
-                // End of data, so store the body
-                auto maybe_body = ByteBuffer::copy(buffer);
-                // FIXME: Propagate this error somehow.
-                if (maybe_body.is_error())
-                    return {};
-                body = maybe_body.release_value();
-                buffer.clear();
-            }
-            break;
-        }
-    }
+    headers.ensure_capacity(parser.field_count());
+    parser.for_each_field([&](auto const& field) {
+        headers.unchecked_append({ field.name, field.value });
+    });
+
+    auto maybe_body = ByteBuffer::copy(raw_body);
+    // FIXME: Propagate this error somehow.
+    if (maybe_body.is_error())
+        return {};
+    auto body = maybe_body.release_value();
 
     HttpRequest request;
     if (method == "GET")
@@ -211,13 +153,13 @@ Optional<HttpRequest> HttpRequest::from_raw_request(ReadonlyBytes raw_request)
         return {};
 
     request.m_headers = move(headers);
-    auto url_parts = resource.split_limit('?', 2, SplitBehavior::KeepEmpty);
 
     request.m_url.set_cannot_be_a_base_url(true);
-    if (url_parts.size() == 2) {
-        request.m_resource = url_parts[0];
-        request.m_url.set_paths({ url_parts[0] });
-        request.m_url.set_query(url_parts[1]);
+    if (auto query_start = resource.find('?'); query_start.has_value()) {
+        auto path = resource.substring_view(0, *query_start);
+        request.m_resource = path;
+        request.m_url.set_paths({ path });
+        request.m_url.set_query(resource.substring_view(*query_start + 1));
     } else {
         request.m_resource = resource;
         request.m_url.set_paths({ resource });
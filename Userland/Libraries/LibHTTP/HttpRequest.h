@@ -13,6 +13,7 @@
 #include <AK/URL.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
+#include <LibHTTP/Forward.h>
 
 namespace HTTP {
 
@@ -36,6 +37,13 @@ public:
         DeprecatedString value;
     };
 
+    // How a streamed body is compressed on its way out, which the request announces with Content-Encoding.
+    enum class BodyEncoding : u8 {
+        Identity,
+        Gzip,
+        Deflate,
+    };
+
     struct BasicAuthenticationCredentials {
         DeprecatedString username;
         DeprecatedString password;
@@ -56,12 +64,22 @@ public:
     ByteBuffer const& body() const { return m_body; }
     void set_body(ByteBuffer&& body) { m_body = move(body); }
 
+    // A streamed body isn't known up front, but sent (with chunked transfer encoding over HTTP/1.1) as it's being read
+    // from elsewhere, so the request has neither body() nor a Content-Length.
+    bool has_streamed_body() const { return m_streamed_body_encoding.has_value(); }
+    Optional<BodyEncoding> streamed_body_encoding() const { return m_streamed_body_encoding; }
+    void set_streamed_body(BodyEncoding encoding) { m_streamed_body_encoding = encoding; }
+
     DeprecatedString method_name() const;
+    // The path and query, as it goes into the request line (or the :path pseudo-header of HTTP/2).
+    DeprecatedString request_target() const;
     ByteBuffer to_raw_request() const;
 
     void set_headers(HashMap<DeprecatedString, DeprecatedString> const&);
 
     static Optional<HttpRequest> from_raw_request(ReadonlyBytes);
+    // The parser has to be done with the request's header section.
+    static Optional<HttpRequest> from_parsed_headers(HeaderParser const&, ReadonlyBytes body = {});
     static Optional<Header> get_http_basic_authentication_header(URL const&);
     static Optional<BasicAuthenticationCredentials> parse_http_basic_authentication_header(DeprecatedString const&);
 
@@ -71,8 +89,11 @@ private:
     Method m_method { GET };
     Vector<Header> m_headers;
     ByteBuffer m_body;
+    Optional<BodyEncoding> m_streamed_body_encoding;
 };
 
 DeprecatedString to_deprecated_string(HttpRequest::Method);
+// The Content-Encoding to announce for a streamed body, if it's compressed.
+Optional<StringView> content_encoding_name(HttpRequest::BodyEncoding);
 
 }
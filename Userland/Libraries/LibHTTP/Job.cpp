@@ -26,9 +26,7 @@ static ErrorOr<ByteBuffer> handle_content_encoding(ByteBuffer const& buf, Deprec
     dbgln_if(JOB_DEBUG, "Job::handle_content_encoding: buf has content_encoding={}", content_encoding);
 
     // FIXME: Actually do the decompression of the data using streams, instead of all at once when everything has been
-    //        received. This will require that some of the decompression algorithms are implemented in a streaming way.
-    //        Gzip and Deflate are implemented using Stream, while Brotli uses the newer Core::Stream. The Gzip and
-    //        Deflate implementations will likely need to be changed to LibCore::Stream for this to work easily.
+    //        received, like we already do for Brotli (see Job::receive_brotli_data()).
 
     if (content_encoding == "gzip") {
         if (!Compress::GzipDecompressor::is_likely_compressed(buf)) {
@@ -92,6 +90,17 @@ Job::Job(HttpRequest&& request, Stream& output_stream)
 {
 }
 
+Job::~Job()
+{
+    stop_sending_request_body();
+}
+
+void Job::set_request_body_stream(NonnullOwnPtr<Core::File> stream)
+{
+    VERIFY(m_request.has_streamed_body());
+    m_request_body_stream = move(stream);
+}
+
 void Job::start(Core::Socket& socket)
 {
     VERIFY(!m_socket);
@@ -103,10 +112,67 @@ void Job::start(Core::Socket& socket)
     });
 }
 
+void Job::start_on_http2_connection(Core::Socket& socket, Http2Connection& connection)
+{
+    VERIFY(!m_socket);
+    m_socket = static_cast<Core::BufferedSocketBase*>(&socket);
+    dbgln_if(HTTPJOB_DEBUG, "Starting a new HTTP/2 stream for {}", url());
+
+    auto stream_or_error = connection.open_stream(m_request);
+    if (stream_or_error.is_error()) {
+        dbgln_if(JOB_DEBUG, "Job: Could not open an HTTP/2 stream: {}", stream_or_error.error());
+        return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::ConnectionFailed); });
+    }
+    m_http2_stream = stream_or_error.release_value();
+
+    m_http2_stream->on_request_body_sent = [this] {
+        if (m_request_body_notifier)
+            m_request_body_notifier->set_enabled(true);
+    };
+    if (auto result = start_sending_request_body(); result.is_error()) {
+        dbgln_if(JOB_DEBUG, "Job: Could not start sending the request body: {}", result.error());
+        return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+    }
+
+    m_http2_stream->on_headers = [this](u32 status, Vector<HPACK::Header> const& headers) {
+        m_code = status;
+        for (auto& header : headers)
+            handle_header(header.name, header.value);
+        finish_headers();
+    };
+    m_http2_stream->on_data = [this](ReadonlyBytes data) {
+        if (is_cancelled() || m_state != State::InBody)
+            return;
+        if (auto result = handle_body_data(data); result.is_error()) {
+            dbgln_if(JOB_DEBUG, "Job: Could not handle the payload: {}", result.error());
+            return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+        }
+        m_http2_withheld_credit += data.size();
+        give_http2_flow_control_credit();
+    };
+    m_http2_stream->on_finish = [this] {
+        if (is_cancelled() || m_state != State::InBody)
+            return;
+        finish_up();
+    };
+    m_http2_stream->on_error = [this](Http2::ErrorCode error) {
+        dbgln_if(JOB_DEBUG, "Job: HTTP/2 stream for {} failed with error {}", m_request.url(), to_underlying(error));
+        deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+    };
+}
+
 void Job::shutdown(ShutdownMode mode)
 {
     if (!m_socket)
         return;
+    stop_sending_request_body();
+    if (m_http2_stream) {
+        // The socket is shared by every stream on the connection, so only ours goes away, whatever the mode.
+        m_http2_stream->cancel();
+        m_http2_stream = nullptr;
+        m_socket = nullptr;
+        return;
+    }
     if (mode == ShutdownMode::CloseSocket) {
         m_socket->close();
         m_socket->on_ready_to_read = nullptr;
@@ -150,6 +216,80 @@ void Job::flush_received_buffers()
     dbgln_if(JOB_DEBUG, "Job: Flushing received buffers done: have {} bytes in {} buffers for {}", m_buffered_size, m_received_buffers.size(), m_request.url());
 }
 
+void Job::handle_header(StringView name, DeprecatedString value)
+{
+    if (name.equals_ignoring_case("Set-Cookie"sv)) {
+        dbgln_if(JOB_DEBUG, "Job: Received Set-Cookie header: '{}'", value);
+        m_set_cookie_headers.append(move(value));
+        return;
+    }
+
+    if (auto existing_value = m_headers.get(name); existing_value.has_value()) {
+        StringBuilder builder;
+        builder.append(existing_value.value());
+        builder.append(',');
+        builder.append(value);
+        m_headers.set(name, builder.to_deprecated_string());
+    } else {
+        m_headers.set(name, value);
+    }
+    if (name.equals_ignoring_case("Content-Encoding"sv)) {
+        if (m_headers.get(name)->equals_ignoring_case("br"sv)) {
+            dbgln_if(JOB_DEBUG, "Content-Encoding {} detected, decompressing output as it's received", value);
+            m_brotli_input = make<AllocatingMemoryStream>();
+            m_brotli_stream = make<Compress::BrotliDecompressionStream>(*m_brotli_input);
+        } else {
+            // Assume that any other content-encoding means that we can't decode it as a stream :(
+            dbgln_if(JOB_DEBUG, "Content-Encoding {} detected, cannot stream output :(", value);
+            m_brotli_stream = nullptr;
+            m_brotli_input = nullptr;
+            m_can_stream_response = false;
+        }
+    } else if (name.equals_ignoring_case("Content-Length"sv)) {
+        auto length = value.to_uint();
+        if (length.has_value())
+            m_content_length = length.value();
+    }
+    dbgln_if(JOB_DEBUG, "Job: [{}] = '{}'", name, value);
+}
+
+void Job::finish_headers()
+{
+    if (on_headers_received) {
+        if (!m_set_cookie_headers.is_empty())
+            m_headers.set("Set-Cookie", JsonArray { m_set_cookie_headers }.to_deprecated_string());
+        on_headers_received(m_headers, m_code > 0 ? m_code : Optional<u32> {});
+    }
+    m_state = State::InBody;
+}
+
+ErrorOr<void> Job::handle_body_data(ReadonlyBytes payload)
+{
+    if (m_brotli_stream) {
+        TRY(receive_brotli_data(payload));
+    } else {
+        m_received_buffers.append(make<ReceivedBuffer>(TRY(ByteBuffer::copy(payload))));
+        m_buffered_size += payload.size();
+    }
+    m_received_size += payload.size();
+    flush_received_buffers();
+
+    deferred_invoke([this] { did_progress(m_content_length, m_received_size); });
+    return {};
+}
+
+void Job::give_http2_flow_control_credit()
+{
+    if (m_buffered_size > http2_max_buffered_size) {
+        dbgln_if(JOB_DEBUG, "Job: Holding back HTTP/2 flow control credit, have {} bytes buffered for {}", m_buffered_size, m_request.url());
+        if (!has_timer())
+            start_timer(50);
+        return;
+    }
+    if (m_http2_withheld_credit != 0)
+        m_http2_stream->did_consume_data(exchange(m_http2_withheld_credit, 0));
+}
+
 void Job::register_on_ready_to_read(Function<void()> callback)
 {
     m_socket->on_ready_to_read = [this, callback = move(callback)] {
@@ -206,6 +346,11 @@ void Job::on_socket_connected()
     if (!success)
         deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
 
+    if (auto result = start_sending_request_body(); success && result.is_error()) {
+        dbgln_if(JOB_DEBUG, "Job: Could not start sending the request body: {}", result.error());
+        deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+    }
+
     register_on_ready_to_read([&] {
         dbgln_if(JOB_DEBUG, "Ready to read for {}, state = {}, cancelled = {}", m_request.url(), to_underlying(m_state), is_cancelled());
         if (is_cancelled())
@@ -223,7 +368,7 @@ void Job::on_socket_connected()
             return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
         }
 
-        while (m_state == State::InStatus) {
+        while (m_state == State::InStatus || m_state == State::InHeaders || m_state == State::Trailers) {
             auto can_read_line = m_socket->can_read_line();
             if (can_read_line.is_error()) {
                 dbgln_if(JOB_DEBUG, "Job {} could not figure out whether we could read a line", m_request.url());
@@ -231,160 +376,63 @@ void Job::on_socket_connected()
             }
 
             if (!can_read_line.value()) {
-                dbgln_if(JOB_DEBUG, "Job {} cannot read a full line", m_request.url());
-                // TODO: Should we retry here instead of failing instantly?
-                return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+                dbgln_if(JOB_DEBUG, "Job {} cannot read a full line, waiting for more data", m_request.url());
+                return;
             }
 
-            auto maybe_line = read_line(PAGE_SIZE);
+            auto maybe_line = read_line_bytes();
             if (maybe_line.is_error()) {
                 dbgln_if(JOB_DEBUG, "Job {} could not read line: {}", m_request.url(), maybe_line.error());
                 return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
             }
 
-            auto line = maybe_line.release_value();
+            // We only ever take whole lines from the socket, so that none of the body is read along with the headers.
+            m_header_parser.parse(maybe_line.value());
+            m_header_parser.parse("\n"sv.bytes());
 
-            dbgln_if(JOB_DEBUG, "Job {} read line of length {}", m_request.url(), line.length());
-            if (line.is_null()) {
-                dbgln("Job: Expected HTTP status");
-                return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
-            }
-            auto parts = line.split_view(' ');
-            if (parts.size() < 2) {
-                dbgln("Job: Expected 2-part or 3-part HTTP status line, got '{}'", line);
-                return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-            }
-
-            if (!parts[0].matches("HTTP/?.?"sv, CaseSensitivity::CaseSensitive) || !is_ascii_digit(parts[0][5]) || !is_ascii_digit(parts[0][7])) {
-                dbgln("Job: Expected HTTP-Version to be of the form 'HTTP/X.Y', got '{}'", parts[0]);
-                return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-            }
-            auto http_major_version = parse_ascii_digit(parts[0][5]);
-            auto http_minor_version = parse_ascii_digit(parts[0][7]);
-            m_legacy_connection = http_major_version < 1 || (http_major_version == 1 && http_minor_version == 0);
-
-            auto code = parts[1].to_uint();
-            if (!code.has_value()) {
-                dbgln("Job: Expected numeric HTTP status");
-                return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-            }
-            m_code = code.value();
-            m_state = State::InHeaders;
-
-            auto can_read_without_blocking = m_socket->can_read_without_blocking();
-            if (can_read_without_blocking.is_error())
-                return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
-
-            if (!can_read_without_blocking.value())
-                return;
-        }
-        while (m_state == State::InHeaders || m_state == State::Trailers) {
-            auto can_read_line = m_socket->can_read_line();
-            if (can_read_line.is_error()) {
-                dbgln_if(JOB_DEBUG, "Job {} could not figure out whether we could read a line", m_request.url());
-                return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
-            }
-
-            if (!can_read_line.value()) {
-                dbgln_if(JOB_DEBUG, "Can't read lines anymore :(");
-                return;
-            }
-
-            // There's no max limit defined on headers, but for our sanity, let's limit it to 32K.
-            auto maybe_line = read_line(32 * KiB);
-            if (maybe_line.is_error()) {
-                dbgln_if(JOB_DEBUG, "Job {} could not read a header line: {}", m_request.url(), maybe_line.error());
-                return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
-            }
-            auto line = maybe_line.release_value();
-
-            if (line.is_null()) {
+            if (m_header_parser.has_failed()) {
                 if (m_state == State::Trailers) {
                     // Some servers like to send two ending chunks
                     // use this fact as an excuse to ignore anything after the last chunk
                     // that is not a valid trailing header.
                     return finish_up();
                 }
-                dbgln("Job: Expected HTTP header");
-                return did_fail(Core::NetworkJob::Error::ProtocolFailed);
+                dbgln("Job: Malformed HTTP response: {}", m_header_parser.failure_reason());
+                return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
             }
-            if (line.is_empty()) {
-                if (m_state == State::Trailers) {
+
+            if (m_state == State::InStatus && m_header_parser.has_start_line()) {
+                m_code = m_header_parser.status_code();
+                auto major_version = m_header_parser.major_version();
+                m_legacy_connection = major_version < 1 || (major_version == 1 && m_header_parser.minor_version() == 0);
+                m_state = State::InHeaders;
+            }
+
+            if (m_header_parser.is_done()) {
+                m_header_parser.for_each_field([&](auto const& field) {
+                    handle_header(field.name, field.value);
+                });
+                if (m_state == State::Trailers)
                     return finish_up();
-                }
-                if (on_headers_received) {
-                    if (!m_set_cookie_headers.is_empty())
-                        m_headers.set("Set-Cookie", JsonArray { m_set_cookie_headers }.to_deprecated_string());
-                    on_headers_received(m_headers, m_code > 0 ? m_code : Optional<u32> {});
-                }
-                m_state = State::InBody;
+
+                finish_headers();
 
                 // We've reached the end of the headers, there's a possibility that the server
                 // responds with nothing (content-length = 0 with normal encoding); if that's the case,
                 // quit early as we won't be reading anything anyway.
-                if (auto result = m_headers.get("Content-Length"sv).value_or(""sv).to_uint(); result.has_value()) {
-                    if (result.value() == 0 && !m_headers.get("Transfer-Encoding"sv).value_or(""sv).view().trim_whitespace().equals_ignoring_case("chunked"sv))
+                if (auto result = m_header_parser.find("Content-Length"sv).value_or(""sv).to_uint(); result.has_value()) {
+                    if (result.value() == 0 && !m_header_parser.find("Transfer-Encoding"sv).value_or(""sv).equals_ignoring_case("chunked"sv))
                         return finish_up();
                 }
                 // There's also the possibility that the server responds with 204 (No Content),
                 // and manages to set a Content-Length anyway, in such cases ignore Content-Length and quit early;
                 // As the HTTP spec explicitly prohibits presence of Content-Length when the response code is 204.
-                if (m_code == 204)
+                // Likewise, a 304 (Not Modified) response never has a body, whatever its Content-Length says.
+                if (m_code == 204 || m_code == 304)
                     return finish_up();
 
                 break;
             }
-            auto parts = line.split_view(':');
-            if (parts.is_empty()) {
-                if (m_state == State::Trailers) {
-                    // Some servers like to send two ending chunks
-                    // use this fact as an excuse to ignore anything after the last chunk
-                    // that is not a valid trailing header.
-                    return finish_up();
-                }
-                dbgln("Job: Expected HTTP header with key/value");
-                return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-            }
-            auto name = parts[0];
-            if (line.length() < name.length() + 2) {
-                if (m_state == State::Trailers) {
-                    // Some servers like to send two ending chunks
-                    // use this fact as an excuse to ignore anything after the last chunk
-                    // that is not a valid trailing header.
-                    return finish_up();
-                }
-                dbgln("Job: Malformed HTTP header: '{}' ({})", line, line.length());
-                return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-            }
-            auto value = line.substring(name.length() + 2, line.length() - name.length() - 2);
-            if (name.equals_ignoring_case("Set-Cookie"sv)) {
-                dbgln_if(JOB_DEBUG, "Job: Received Set-Cookie header: '{}'", value);
-                m_set_cookie_headers.append(move(value));
-
-                auto can_read_without_blocking = m_socket->can_read_without_blocking();
-                if (can_read_without_blocking.is_error())
-                    return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
-                if (!can_read_without_blocking.value())
-                    return;
-            } else if (auto existing_value = m_headers.get(name); existing_value.has_value()) {
-                StringBuilder builder;
-                builder.append(existing_value.value());
-                builder.append(',');
-                builder.append(value);
-                m_headers.set(name, builder.to_deprecated_string());
-            } else {
-                m_headers.set(name, value);
-            }
-            if (name.equals_ignoring_case("Content-Encoding"sv)) {
-                // Assume that any content-encoding means that we can't decode it as a stream :(
-                dbgln_if(JOB_DEBUG, "Content-Encoding {} detected, cannot stream output :(", value);
-                m_can_stream_response = false;
-            } else if (name.equals_ignoring_case("Content-Length"sv)) {
-                auto length = value.to_uint();
-                if (length.has_value())
-                    m_content_length = length.value();
-            }
-            dbgln_if(JOB_DEBUG, "Job: [{}] = '{}'", name, value);
 
             auto can_read_without_blocking = m_socket->can_read_without_blocking();
             if (can_read_without_blocking.is_error())
@@ -510,12 +558,10 @@ void Job::on_socket_connected()
                 }
             }
 
-            m_received_buffers.append(make<ReceivedBuffer>(payload));
-            m_buffered_size += payload.size();
-            m_received_size += payload.size();
-            flush_received_buffers();
-
-            deferred_invoke([this] { did_progress(m_content_length, m_received_size); });
+            if (auto result = handle_body_data(payload); result.is_error()) {
+                dbgln_if(JOB_DEBUG, "Job: Could not handle the payload: {}", result.error());
+                return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+            }
 
             if (read_everything) {
                 VERIFY(m_received_size <= m_content_length.value());
@@ -540,6 +586,7 @@ void Job::on_socket_connected()
 
                     if (m_current_chunk_total_size.value() == 0) {
                         m_state = State::Trailers;
+                        m_header_parser.reset(HeaderParser::Kind::Trailers);
                         break;
                     }
 
@@ -574,15 +621,248 @@ void Job::on_socket_connected()
 void Job::timer_event(Core::TimerEvent& event)
 {
     event.accept();
+    if (m_http2_stream && m_state != State::Finished) {
+        flush_received_buffers();
+        give_http2_flow_control_credit();
+        if (m_http2_withheld_credit == 0)
+            stop_timer();
+        return;
+    }
     finish_up();
     if (m_buffered_size == 0)
         stop_timer();
 }
 
+ErrorOr<void> Job::start_sending_request_body()
+{
+    if (!m_request_body_stream)
+        return {};
+
+    m_request_body_buffer = TRY(ByteBuffer::create_uninitialized(request_body_chunk_size));
+
+    switch (m_request.streamed_body_encoding().value()) {
+    case HttpRequest::BodyEncoding::Identity:
+        break;
+    case HttpRequest::BodyEncoding::Gzip: {
+        // RFC 1952 section 2.3: A member is a header, the deflated data, and the CRC-32 and size of the original data.
+        //                       We don't know the latter until the end, and neither the name nor the time of the input.
+        static constexpr u8 header[] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 4, 3 };
+        m_compressed_request_body = make<AllocatingMemoryStream>();
+        TRY(m_compressed_request_body->write_entire_buffer({ header, sizeof(header) }));
+        m_request_body_deflate_compressor = TRY(Compress::DeflateCompressor::construct(MaybeOwned<Stream>(*m_compressed_request_body), Compress::DeflateCompressor::CompressionLevel::FASTEST));
+        break;
+    }
+    case HttpRequest::BodyEncoding::Deflate:
+        // RFC 9110 section 8.4.1.2: "deflate" is the zlib format, rather than raw deflate data.
+        m_compressed_request_body = make<AllocatingMemoryStream>();
+        m_request_body_zlib_compressor = TRY(Compress::ZlibCompressor::construct(MaybeOwned<Stream>(*m_compressed_request_body), Compress::ZlibCompressionLevel::Fastest));
+        break;
+    }
+
+    m_request_body_notifier = Core::Notifier::construct(m_request_body_stream->fd(), Core::Notifier::Read);
+    m_request_body_notifier->on_ready_to_read = [this] { send_more_request_body(); };
+    return {};
+}
+
+void Job::send_more_request_body()
+{
+    if (is_cancelled() || !m_request_body_stream)
+        return;
+
+    // Over HTTP/2, the flow control windows say how fast the body can go, so we wait until the stream caught up.
+    if (m_http2_stream && m_http2_stream->unsent_request_body_size() >= http2_max_unsent_request_body_size) {
+        m_request_body_notifier->set_enabled(false);
+        return;
+    }
+
+    auto data_or_error = m_request_body_stream->read(m_request_body_buffer);
+    if (data_or_error.is_error() && data_or_error.error().is_errno() && (data_or_error.error().code() == EAGAIN || data_or_error.error().code() == EINTR))
+        return;
+
+    ErrorOr<void> result = {};
+    if (data_or_error.is_error())
+        result = data_or_error.release_error();
+    else if (data_or_error.value().is_empty())
+        result = finish_request_body();
+    else
+        result = send_request_body_data(data_or_error.value());
+
+    if (result.is_error()) {
+        dbgln_if(JOB_DEBUG, "Job: Could not send the request body: {}", result.error());
+        stop_sending_request_body();
+        deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+    }
+}
+
+ErrorOr<void> Job::send_request_body_data(ReadonlyBytes data)
+{
+    if (m_request_body_deflate_compressor) {
+        m_request_body_crc32.update(data);
+        m_request_body_size += data.size();
+        TRY(m_request_body_deflate_compressor->write_entire_buffer(data));
+        return send_compressed_request_body_data();
+    }
+    if (m_request_body_zlib_compressor) {
+        TRY(m_request_body_zlib_compressor->write_entire_buffer(data));
+        return send_compressed_request_body_data();
+    }
+    return write_request_body_chunk(data);
+}
+
+ErrorOr<void> Job::send_compressed_request_body_data()
+{
+    // The input has been taken in by the compressor by now, so its buffer is free to take the output.
+    while (m_compressed_request_body->used_buffer_size() > 0) {
+        auto compressed_data = TRY(m_compressed_request_body->read(m_request_body_buffer));
+        TRY(write_request_body_chunk(compressed_data));
+    }
+    return {};
+}
+
+ErrorOr<void> Job::write_request_body_chunk(ReadonlyBytes data)
+{
+    // An empty chunk would end the body.
+    if (data.is_empty())
+        return {};
+
+    if (m_http2_stream)
+        return m_http2_stream->send_request_body_data(data);
+
+    // RFC 9112 section 7.1: chunk = chunk-size [ chunk-ext ] CRLF chunk-data CRLF
+    auto chunk_size = DeprecatedString::formatted("{:x}\r\n", data.size());
+    TRY(m_socket->write_entire_buffer(chunk_size.bytes()));
+    TRY(m_socket->write_entire_buffer(data));
+    TRY(m_socket->write_entire_buffer("\r\n"sv.bytes()));
+    return {};
+}
+
+ErrorOr<void> Job::finish_request_body()
+{
+    if (m_request_body_deflate_compressor) {
+        TRY(m_request_body_deflate_compressor->final_flush());
+        m_request_body_deflate_compressor = nullptr;
+        LittleEndian<u32> digest = m_request_body_crc32.digest();
+        LittleEndian<u32> size = m_request_body_size;
+        TRY(m_compressed_request_body->write_entire_buffer(digest.bytes()));
+        TRY(m_compressed_request_body->write_entire_buffer(size.bytes()));
+        TRY(send_compressed_request_body_data());
+    } else if (m_request_body_zlib_compressor) {
+        TRY(m_request_body_zlib_compressor->finish());
+        m_request_body_zlib_compressor = nullptr;
+        TRY(send_compressed_request_body_data());
+    }
+
+    stop_sending_request_body();
+    if (m_http2_stream) {
+        m_http2_stream->finish_request_body();
+        return {};
+    }
+    // RFC 9112 section 7.1: last-chunk = 1*("0") [ chunk-ext ] CRLF, followed by the (empty) trailer section and CRLF.
+    TRY(m_socket->write_entire_buffer("0\r\n\r\n"sv.bytes()));
+    return {};
+}
+
+void Job::stop_sending_request_body()
+{
+    if (m_request_body_notifier) {
+        m_request_body_notifier->set_enabled(false);
+        m_request_body_notifier = nullptr;
+    }
+    m_request_body_stream = nullptr;
+
+    // The compressors insist on being finished, even if nobody will get to see the result anymore.
+    if (m_request_body_deflate_compressor)
+        (void)m_request_body_deflate_compressor->final_flush();
+    if (m_request_body_zlib_compressor)
+        (void)m_request_body_zlib_compressor->finish();
+    m_request_body_deflate_compressor = nullptr;
+    m_request_body_zlib_compressor = nullptr;
+    m_compressed_request_body = nullptr;
+}
+
+ErrorOr<void> Job::receive_brotli_data(ReadonlyBytes payload)
+{
+    TRY(m_brotli_compressed_body.try_append(payload));
+    if (m_brotli_stream_failed)
+        return {};
+
+    TRY(m_brotli_input->write_entire_buffer(payload));
+    while (m_brotli_input->used_buffer_size() > brotli_input_reserve) {
+        if (TRY(decompress_brotli_data()) == 0)
+            break;
+    }
+    return {};
+}
+
+ErrorOr<size_t> Job::decompress_brotli_data()
+{
+    auto buffer = TRY(ByteBuffer::create_uninitialized(brotli_output_chunk_size));
+    auto result = m_brotli_stream->read(buffer);
+    if (result.is_error()) {
+        dbgln_if(JOB_DEBUG, "Job: Brotli decompressor ran out of input ({}), will decompress again when finished", result.error());
+        m_brotli_stream_failed = true;
+        return 0;
+    }
+
+    auto decompressed_size = result.value().size();
+    if (decompressed_size == 0)
+        return 0;
+
+    TRY(buffer.try_resize(decompressed_size));
+    m_received_buffers.append(make<ReceivedBuffer>(move(buffer)));
+    m_buffered_size += decompressed_size;
+    m_brotli_decompressed_size += decompressed_size;
+    return decompressed_size;
+}
+
+ErrorOr<void> Job::finish_brotli_data()
+{
+    while (!m_brotli_stream_failed && !m_brotli_stream->is_eof()) {
+        if (TRY(decompress_brotli_data()) == 0)
+            break;
+    }
+
+    if (m_brotli_stream_failed || !m_brotli_stream->is_eof()) {
+        FixedMemoryStream compressed_body { m_brotli_compressed_body.bytes() };
+        auto brotli_stream = Compress::BrotliDecompressionStream { compressed_body };
+        auto body = TRY(brotli_stream.read_until_eof());
+        if (body.size() < m_brotli_decompressed_size)
+            return AK::Error::from_string_literal("Decompressed body is shorter than what was already decompressed");
+
+        auto remaining_body = TRY(ByteBuffer::copy(body.bytes().slice(m_brotli_decompressed_size)));
+        m_buffered_size += remaining_body.size();
+        m_brotli_decompressed_size = body.size();
+        m_received_buffers.append(make<ReceivedBuffer>(move(remaining_body)));
+    }
+
+    if constexpr (JOB_DEBUG) {
+        dbgln("Job::finish_brotli_data: Brotli decompression successful.");
+        dbgln("  Input size: {}", m_brotli_compressed_body.size());
+        dbgln("  Output size: {}", m_brotli_decompressed_size);
+    }
+
+    m_brotli_stream = nullptr;
+    m_brotli_input = nullptr;
+    m_brotli_compressed_body.clear();
+    return {};
+}
+
 void Job::finish_up()
 {
     VERIFY(!m_has_scheduled_finish);
     m_state = State::Finished;
+    // The server may well respond before it got the whole body, and then it doesn't want the rest anymore.
+    // Without the last chunk the connection is stuck in the middle of a message though, so it can't be used again.
+    if (m_request_body_stream && !m_http2_stream)
+        m_request_body_was_cut_short = true;
+    stop_sending_request_body();
+    if (m_brotli_stream) {
+        if (auto result = finish_brotli_data(); result.is_error()) {
+            dbgln_if(JOB_DEBUG, "Job: Could not decompress the body: {}", result.error());
+            return did_fail(Core::NetworkJob::Error::TransmissionFailed);
+        }
+    }
+
     if (!m_can_stream_response) {
         auto maybe_flattened_buffer = ByteBuffer::create_uninitialized(m_buffered_size);
         if (maybe_flattened_buffer.is_error())
@@ -596,7 +876,7 @@ void Job::finish_up()
         }
         m_received_buffers.clear();
 
-        // For the time being, we cannot stream stuff with content-encoding set to _anything_.
+        // For the time being, we cannot stream stuff with content-encoding set to anything but "br".
         // FIXME: LibCompress exposes a streaming interface, so this can be resolved
         auto content_encoding = m_headers.get("Content-Encoding");
         if (content_encoding.has_value()) {
@@ -629,7 +909,7 @@ void Job::finish_up()
         // If the server responded with "Connection: close", close the connection
         // as the server may or may not want to close the socket. Also, if this is
         // a legacy HTTP server (1.0 or older), assume close is the default value.
-        if (auto result = response->headers().get("Connection"sv); result.has_value() ? result->equals_ignoring_case("close"sv) : m_legacy_connection)
+        if (auto result = response->headers().get("Connection"sv); m_request_body_was_cut_short || (result.has_value() ? result->equals_ignoring_case("close"sv) : m_legacy_connection))
             shutdown(ShutdownMode::CloseSocket);
         did_finish(response);
     });
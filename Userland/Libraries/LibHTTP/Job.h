@@ -7,10 +7,19 @@
 #pragma once
 
 #include <AK/HashMap.h>
+#include <AK/MemoryStream.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/Optional.h>
+#include <LibCompress/Brotli.h>
+#include <LibCompress/Deflate.h>
+#include <LibCompress/Zlib.h>
+#include <LibCore/File.h>
 #include <LibCore/NetworkJob.h>
+#include <LibCore/Notifier.h>
 #include <LibCore/Socket.h>
+#include <LibCrypto/Checksum/CRC32.h>
+#include <LibHTTP/HeaderParser.h>
+#include <LibHTTP/Http2Connection.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/HttpResponse.h>
 
@@ -21,11 +30,18 @@ class Job : public Core::NetworkJob {
 
 public:
     explicit Job(HttpRequest&&, Stream&);
-    virtual ~Job() override = default;
+    virtual ~Job() override;
 
     virtual void start(Core::Socket&) override;
     virtual void shutdown(ShutdownMode) override;
 
+    // Runs the request as one of the streams on an HTTP/2 connection, instead of having the socket to itself.
+    void start_on_http2_connection(Core::Socket&, Http2Connection&);
+
+    // For a request with a streamed body, which is whatever can be read from the file until it ends. That's usually
+    // a non-blocking pipe that's still being written to, and it's read as the request is being sent.
+    void set_request_body_stream(NonnullOwnPtr<Core::File>);
+
     Core::Socket const* socket() const { return m_socket; }
     URL url() const { return m_request.url(); }
 
@@ -36,11 +52,29 @@ protected:
     void finish_up();
     void on_socket_connected();
     void flush_received_buffers();
+    void handle_header(StringView name, DeprecatedString value);
+    void finish_headers();
+    ErrorOr<void> handle_body_data(ReadonlyBytes);
+    void give_http2_flow_control_credit();
     void register_on_ready_to_read(Function<void()>);
     ErrorOr<DeprecatedString> read_line(size_t);
+    // Reads a header line into a buffer that's kept around for the whole response, without the LF (but with any CR).
+    ErrorOr<ReadonlyBytes> read_line_bytes();
     ErrorOr<ByteBuffer> receive(size_t);
     void timer_event(Core::TimerEvent&) override;
 
+    ErrorOr<void> start_sending_request_body();
+    void send_more_request_body();
+    ErrorOr<void> send_request_body_data(ReadonlyBytes);
+    ErrorOr<void> send_compressed_request_body_data();
+    ErrorOr<void> write_request_body_chunk(ReadonlyBytes);
+    ErrorOr<void> finish_request_body();
+    void stop_sending_request_body();
+
+    ErrorOr<void> receive_brotli_data(ReadonlyBytes);
+    ErrorOr<size_t> decompress_brotli_data();
+    ErrorOr<void> finish_brotli_data();
+
     enum class State {
         InStatus,
         InHeaders,
@@ -55,6 +89,8 @@ protected:
     bool m_legacy_connection { false };
     int m_code { -1 };
     HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> m_headers;
+    HeaderParser m_header_parser { HeaderParser::Kind::Response };
+    ByteBuffer m_line_buffer;
     Vector<DeprecatedString> m_set_cookie_headers;
 
     struct ReceivedBuffer {
@@ -73,6 +109,17 @@ protected:
 
     NonnullOwnPtrVector<ReceivedBuffer> m_received_buffers;
 
+    // A body with "Content-Encoding: br" is decompressed while it's being received, so that it can still be streamed.
+    // The decompressor can't wait for more input in the middle of what it's reading, so if it ran out of input anyway,
+    // the whole body is decompressed again once it's all there, and only the part we didn't have yet is kept.
+    static constexpr size_t brotli_input_reserve = 64 * KiB;
+    static constexpr size_t brotli_output_chunk_size = 16 * KiB;
+    OwnPtr<AllocatingMemoryStream> m_brotli_input;
+    OwnPtr<Compress::BrotliDecompressionStream> m_brotli_stream;
+    ByteBuffer m_brotli_compressed_body;
+    size_t m_brotli_decompressed_size { 0 };
+    bool m_brotli_stream_failed { false };
+
     size_t m_buffered_size { 0 };
     size_t m_received_size { 0 };
     Optional<u32> m_content_length;
@@ -81,6 +128,28 @@ protected:
     bool m_can_stream_response { true };
     bool m_should_read_chunk_ending_line { false };
     bool m_has_scheduled_finish { false };
+
+    // The server only gets to send as much as we've read and handed to the client, plus the stream's window,
+    // so we hold back its credit while the client isn't keeping up.
+    static constexpr size_t http2_max_buffered_size = 1 * MiB;
+    RefPtr<Http2Stream> m_http2_stream;
+    size_t m_http2_withheld_credit { 0 };
+
+    // Only as much of a streamed body is read as can be sent right away (or, over HTTP/2, soon), so that it doesn't
+    // matter how large it is.
+    static constexpr size_t request_body_chunk_size = 64 * KiB;
+    static constexpr size_t http2_max_unsent_request_body_size = 256 * KiB;
+    OwnPtr<Core::File> m_request_body_stream;
+    RefPtr<Core::Notifier> m_request_body_notifier;
+    ByteBuffer m_request_body_buffer;
+
+    // A body that's compressed on the way goes through one of the compressors and is sent from this buffer.
+    OwnPtr<AllocatingMemoryStream> m_compressed_request_body;
+    OwnPtr<Compress::DeflateCompressor> m_request_body_deflate_compressor;
+    OwnPtr<Compress::ZlibCompressor> m_request_body_zlib_compressor;
+    Crypto::Checksum::CRC32 m_request_body_crc32;
+    u32 m_request_body_size { 0 };
+    bool m_request_body_was_cut_short { false };
 };
 
 }
@@ -7,11 +7,16 @@
 
 #include <LibCore/System.h>
 #include <LibIPC/Connection.h>
+#include <LibIPC/RingTransport.h>
 #include <LibIPC/Stub.h>
 #include <sys/select.h>
 
 namespace IPC {
 
+// Transport frames start with this where messages start with their endpoint magic, which is a hash of the endpoint name.
+static constexpr u32 transport_frame_magic = 0x474e4952;
+static constexpr size_t transport_frame_size = 2 * sizeof(u32);
+
 struct CoreEventLoopDeferredInvoker final : public DeferredInvoker {
     virtual ~CoreEventLoopDeferredInvoker() = default;
 
@@ -30,6 +35,37 @@ ConnectionBase::ConnectionBase(IPC::Stub& local_stub, NonnullOwnPtr<Core::LocalS
     m_responsiveness_timer = Core::Timer::create_single_shot(3000, [this] { may_have_become_unresponsive(); }).release_value_but_fixme_should_propagate_errors();
 }
 
+ConnectionBase::~ConnectionBase()
+{
+    if constexpr (IPC_LATENCY_DEBUG)
+        dump_latency_histograms();
+}
+
+void ConnectionBase::LatencyHistogram::record(Time latency)
+{
+    auto microseconds = static_cast<u64>(max<i64>(latency.to_microseconds(), 0));
+    ++count;
+    total_microseconds += microseconds;
+    max_microseconds = max(max_microseconds, microseconds);
+
+    size_t bucket = 0;
+    while (bucket < buckets.size() - 1 && (1ull << bucket) <= microseconds)
+        ++bucket;
+    ++buckets[bucket];
+}
+
+void ConnectionBase::dump_latency_histograms() const
+{
+    for (auto const& it : m_latency_histograms) {
+        auto const& histogram = it.value;
+        dbgln("{}: {} responses, average {}us, max {}us", it.key, histogram.count, histogram.total_microseconds / histogram.count, histogram.max_microseconds);
+        for (size_t i = 0; i < histogram.buckets.size(); ++i) {
+            if (histogram.buckets[i] != 0)
+                dbgln("    < {}us: {}", 1ull << i, histogram.buckets[i]);
+        }
+    }
+}
+
 void ConnectionBase::set_deferred_invoker(NonnullOwnPtr<DeferredInvoker> deferred_invoker)
 {
     m_deferred_invoker = move(deferred_invoker);
@@ -59,6 +95,29 @@ ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer)
     if (!m_socket->is_open())
         return Error::from_string_literal("Trying to post_message during IPC shutdown");
 
+    if (m_sends_through_ring) {
+        // Messages that can't go through the ring leave a marker in it, so that the peer can put them back in order.
+        bool goes_through_ring = RingTransport::can_carry(buffer);
+        auto queue_was_empty = goes_through_ring ? m_ring_transport->enqueue_message(buffer.data) : m_ring_transport->enqueue_socket_marker();
+        if (queue_was_empty.is_error()) {
+            shutdown_with_error(queue_was_empty.error());
+            return queue_was_empty.release_error();
+        }
+
+        if (goes_through_ring) {
+            if (queue_was_empty.value())
+                return post_transport_frame(TransportFrame::WakeUp);
+            if (Core::EventLoop::has_been_instantiated())
+                m_responsiveness_timer->start();
+            return {};
+        }
+    }
+
+    return post_message_through_socket(move(buffer));
+}
+
+ErrorOr<void> ConnectionBase::post_message_through_socket(MessageBuffer buffer)
+{
     // Prepend the message size.
     uint32_t message_size = buffer.data.size();
     TRY(buffer.data.try_prepend(reinterpret_cast<u8 const*>(&message_size), sizeof(message_size)));
@@ -112,6 +171,81 @@ ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer)
     return {};
 }
 
+ErrorOr<void> ConnectionBase::request_shared_ring_transport()
+{
+    VERIFY(!m_ring_transport);
+    if (!m_socket->is_open())
+        return Error::from_string_literal("Trying to request a shared ring transport during IPC shutdown");
+
+    m_ring_transport = TRY(RingTransport::create());
+    if (auto result = post_transport_frame(TransportFrame::Offer, { m_ring_transport->send_queue_fd(), m_ring_transport->receive_queue_fd() }); result.is_error()) {
+        m_ring_transport = nullptr;
+        return result;
+    }
+    return {};
+}
+
+ErrorOr<void> ConnectionBase::post_transport_frame(TransportFrame frame, Vector<int, 2> const& fds)
+{
+    MessageBuffer buffer;
+    u32 header[] = { transport_frame_magic, to_underlying(frame) };
+    TRY(buffer.data.try_append(reinterpret_cast<u8 const*>(header), sizeof(header)));
+    for (auto fd : fds) {
+        // The file descriptors stay ours, the peer gets its own copies of them.
+        auto auto_fd = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) AutoCloseFileDescriptor(TRY(Core::System::dup(fd)))));
+        TRY(buffer.fds.try_append(move(auto_fd)));
+    }
+    return post_message_through_socket(move(buffer));
+}
+
+ErrorOr<void> ConnectionBase::handle_transport_frame(TransportFrame frame)
+{
+    switch (frame) {
+    case TransportFrame::Offer: {
+        // The file descriptors have to be taken off the socket even if we turn the offer down, or they'd end up with the next message.
+        auto peer_send_queue_fd = TRY(fd_passing_socket().receive_fd(O_CLOEXEC));
+        auto peer_receive_queue_fd = TRY(fd_passing_socket().receive_fd(O_CLOEXEC));
+
+        if (!m_accepts_shared_ring_transport || m_ring_transport) {
+            TRY(Core::System::close(peer_send_queue_fd));
+            TRY(Core::System::close(peer_receive_queue_fd));
+            return post_transport_frame(TransportFrame::Decline);
+        }
+
+        auto ring_transport = RingTransport::create_from_peer(peer_send_queue_fd, peer_receive_queue_fd);
+        if (ring_transport.is_error()) {
+            dbgln("IPC::ConnectionBase: Couldn't map the queues of the shared ring transport: {}", ring_transport.error());
+            return post_transport_frame(TransportFrame::Decline);
+        }
+
+        // Everything we send after the acceptance goes through the ring, which is what the peer expects once it reads it.
+        m_ring_transport = ring_transport.release_value();
+        TRY(post_transport_frame(TransportFrame::Accept));
+        m_sends_through_ring = true;
+        return {};
+    }
+    case TransportFrame::Accept:
+        if (!m_ring_transport)
+            return Error::from_string_literal("IPC::ConnectionBase: Peer accepted a shared ring transport that wasn't offered");
+        m_peer_sends_through_ring = true;
+        TRY(post_transport_frame(TransportFrame::SwitchedToRing));
+        m_sends_through_ring = true;
+        return {};
+    case TransportFrame::Decline:
+        m_ring_transport = nullptr;
+        return {};
+    case TransportFrame::SwitchedToRing:
+        if (!m_ring_transport)
+            return Error::from_string_literal("IPC::ConnectionBase: Peer switched to a shared ring transport that wasn't set up");
+        m_peer_sends_through_ring = true;
+        return {};
+    case TransportFrame::WakeUp:
+        // This only exists to make the socket readable, the messages are picked up from the ring after parsing.
+        return {};
+    }
+    return Error::from_string_literal("IPC::ConnectionBase: Unknown transport frame");
+}
+
 void ConnectionBase::shutdown()
 {
     m_socket->close();
@@ -214,16 +348,20 @@ ErrorOr<Vector<u8>> ConnectionBase::read_as_much_as_possible_from_socket_without
 
 ErrorOr<void> ConnectionBase::drain_messages_from_peer()
 {
-    auto bytes = TRY(read_as_much_as_possible_from_socket_without_blocking());
+    auto buffer = TRY(ReceivedBuffer::create(TRY(read_as_much_as_possible_from_socket_without_blocking())));
+    auto bytes = buffer->bytes();
 
     size_t index = 0;
-    try_parse_messages(bytes, index);
+    try_parse_messages(*buffer, index);
+    if (m_peer_sends_through_ring)
+        TRY(drain_messages_from_ring());
+    claim_pending_responses();
 
     if (index < bytes.size()) {
         // Sometimes we might receive a partial message. That's okay, just stash away
         // the unprocessed bytes and we'll prepend them to the next incoming message
         // in the next run of this function.
-        auto remaining_bytes = TRY(ByteBuffer::copy(bytes.span().slice(index)));
+        auto remaining_bytes = TRY(ByteBuffer::copy(bytes.slice(index)));
         if (!m_unprocessed_bytes.is_empty()) {
             shutdown();
             return Error::from_string_literal("drain_messages_from_peer: Already have unprocessed bytes");
@@ -239,6 +377,126 @@ ErrorOr<void> ConnectionBase::drain_messages_from_peer()
     return {};
 }
 
+void ConnectionBase::try_parse_messages(ReceivedBuffer& buffer, size_t& index)
+{
+    auto bytes = buffer.bytes();
+    u32 message_size = 0;
+    for (; index + sizeof(message_size) < bytes.size(); index += message_size) {
+        memcpy(&message_size, bytes.data() + index, sizeof(message_size));
+        if (message_size == 0 || bytes.size() - index - sizeof(uint32_t) < message_size)
+            break;
+        index += sizeof(message_size);
+        auto remaining_bytes = ReadonlyBytes { bytes.data() + index, message_size };
+
+        u32 transport_header[2] = {};
+        if (message_size == transport_frame_size)
+            memcpy(transport_header, remaining_bytes.data(), transport_frame_size);
+        if (transport_header[0] == transport_frame_magic) {
+            if (auto result = handle_transport_frame(static_cast<TransportFrame>(transport_header[1])); result.is_error()) {
+                shutdown_with_error(result.error());
+                break;
+            }
+            continue;
+        }
+
+        auto message = try_decode_message(remaining_bytes, buffer);
+        if (!message)
+            break;
+
+        if (m_peer_sends_through_ring)
+            m_messages_waiting_for_ring_marker.append(message.release_nonnull());
+        else
+            m_unprocessed_messages.append(message.release_nonnull());
+    }
+}
+
+ErrorOr<void> ConnectionBase::drain_messages_from_ring()
+{
+    bool received_anything = false;
+    for (;;) {
+        if (m_ring_markers_waiting_for_socket > 0) {
+            // Nothing after a marker can be handled before the message that it stands for.
+            if (m_messages_waiting_for_ring_marker.is_empty())
+                break;
+            m_unprocessed_messages.append(m_messages_waiting_for_ring_marker.take_first());
+            --m_ring_markers_waiting_for_socket;
+            continue;
+        }
+
+        auto slot = m_ring_transport->dequeue();
+        if (!slot.has_value())
+            break;
+        received_anything = true;
+
+        if (slot->size == 0) {
+            ++m_ring_markers_waiting_for_socket;
+            continue;
+        }
+        if (slot->size > RingTransport::slot_payload_size) {
+            shutdown();
+            return Error::from_string_literal("drain_messages_from_ring: Message is larger than a slot");
+        }
+
+        Vector<u8> bytes;
+        TRY(bytes.try_append(slot->data.data(), slot->size));
+        auto buffer = TRY(ReceivedBuffer::create(move(bytes)));
+        auto message = try_decode_message(buffer->bytes(), *buffer);
+        if (!message) {
+            shutdown();
+            return Error::from_string_literal("drain_messages_from_ring: Failed to parse a message");
+        }
+        m_unprocessed_messages.append(message.release_nonnull());
+    }
+
+    if (received_anything) {
+        m_responsiveness_timer->stop();
+        did_become_responsive();
+    }
+    return {};
+}
+
+void ConnectionBase::claim_pending_responses()
+{
+    // Going through the pending responses in the order their messages were sent makes sure that
+    // each one gets the right response, even if there are several for the same kind of message.
+    for (size_t i = 0; i < m_pending_responses.size();) {
+        auto& pending = m_pending_responses[i];
+        Optional<size_t> message_index;
+        for (size_t j = 0; j < m_unprocessed_messages.size(); ++j) {
+            auto& message = m_unprocessed_messages[j];
+            if (message.endpoint_magic() == pending->endpoint_magic && message.message_id() == pending->message_id) {
+                message_index = j;
+                break;
+            }
+        }
+        if (!message_index.has_value()) {
+            ++i;
+            continue;
+        }
+
+        pending->response = m_unprocessed_messages.take(*message_index);
+        if constexpr (IPC_LATENCY_DEBUG) {
+            auto latency = Time::now_monotonic() - pending->sent_at;
+            auto const* message_name = pending->response->message_name();
+            m_latency_histograms.ensure(StringView { message_name, strlen(message_name) }).record(latency);
+        }
+        m_pending_responses.remove(i);
+    }
+}
+
+OwnPtr<IPC::Message> ConnectionBase::wait_for_pending_response(PendingResponseState& pending)
+{
+    while (!pending.response) {
+        if (pending.failed_to_send || !m_socket->is_open())
+            return {};
+
+        wait_for_socket_to_become_readable();
+        if (drain_messages_from_peer().is_error())
+            return {};
+    }
+    return move(pending.response);
+}
+
 OwnPtr<IPC::Message> ConnectionBase::wait_for_specific_endpoint_message_impl(u32 endpoint_magic, int message_id)
 {
     for (;;) {
@@ -7,8 +7,12 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/ByteBuffer.h>
+#include <AK/Debug.h>
+#include <AK/HashMap.h>
 #include <AK/NonnullOwnPtrVector.h>
+#include <AK/Time.h>
 #include <AK/Try.h>
 #include <LibCore/Event.h>
 #include <LibCore/EventLoop.h>
@@ -33,11 +37,14 @@ struct DeferredInvoker {
     virtual void schedule(Function<void()>) = 0;
 };
 
+template<typename ResponseType>
+class PendingResponse;
+
 class ConnectionBase : public Core::Object {
     C_OBJECT_ABSTRACT(ConnectionBase);
 
 public:
-    virtual ~ConnectionBase() override = default;
+    virtual ~ConnectionBase() override;
 
     void set_fd_passing_socket(NonnullOwnPtr<Core::LocalSocket>);
     void set_deferred_invoker(NonnullOwnPtr<DeferredInvoker>);
@@ -52,20 +59,72 @@ public:
     Core::LocalSocket& socket() { return *m_socket; }
     Core::LocalSocket& fd_passing_socket();
 
+    void dump_latency_histograms() const;
+
+    // Asks the peer to pass messages through queues in shared memory instead of the socket, which saves a write and a wakeup
+    // for most of them. Everything keeps going through the socket until the peer agrees, and for good if it doesn't.
+    ErrorOr<void> request_shared_ring_transport();
+    void set_accepts_shared_ring_transport(bool accepts) { m_accepts_shared_ring_transport = accepts; }
+    bool sends_through_shared_ring() const { return m_sends_through_ring; }
+
 protected:
+    template<typename ResponseType>
+    friend class PendingResponse;
+
+    struct PendingResponseState : public RefCounted<PendingResponseState> {
+        PendingResponseState(u32 endpoint_magic, int message_id)
+            : endpoint_magic(endpoint_magic)
+            , message_id(message_id)
+        {
+        }
+
+        u32 endpoint_magic { 0 };
+        int message_id { 0 };
+        bool failed_to_send { false };
+        Time sent_at;
+        OwnPtr<Message> response;
+    };
+
+    // Latencies of synchronous messages, counted in buckets of powers of two microseconds.
+    struct LatencyHistogram {
+        void record(Time latency);
+
+        u64 count { 0 };
+        u64 total_microseconds { 0 };
+        u64 max_microseconds { 0 };
+        Array<u64, 24> buckets {};
+    };
+
     explicit ConnectionBase(IPC::Stub&, NonnullOwnPtr<Core::LocalSocket>, u32 local_endpoint_magic);
 
     virtual void may_have_become_unresponsive() { }
     virtual void did_become_responsive() { }
-    virtual void try_parse_messages(Vector<u8> const& bytes, size_t& index) = 0;
+    virtual OwnPtr<Message> try_decode_message(ReadonlyBytes, ReceivedBuffer&) = 0;
     virtual void shutdown_with_error(Error const&);
 
+    void try_parse_messages(ReceivedBuffer& buffer, size_t& index);
+
     OwnPtr<IPC::Message> wait_for_specific_endpoint_message_impl(u32 endpoint_magic, int message_id);
+    OwnPtr<IPC::Message> wait_for_pending_response(PendingResponseState&);
+    void claim_pending_responses();
     void wait_for_socket_to_become_readable();
     ErrorOr<Vector<u8>> read_as_much_as_possible_from_socket_without_blocking();
     ErrorOr<void> drain_messages_from_peer();
+    ErrorOr<void> drain_messages_from_ring();
 
     ErrorOr<void> post_message(MessageBuffer);
+    ErrorOr<void> post_message_through_socket(MessageBuffer);
+
+    // Frames that set up the shared ring transport, which are always sent through the socket and never reach the endpoints.
+    enum class TransportFrame : u32 {
+        Offer,
+        Accept,
+        Decline,
+        SwitchedToRing,
+        WakeUp,
+    };
+    ErrorOr<void> post_transport_frame(TransportFrame, Vector<int, 2> const& fds = {});
+    ErrorOr<void> handle_transport_frame(TransportFrame);
     void handle_messages();
 
     IPC::Stub& m_local_stub;
@@ -78,6 +137,18 @@ protected:
     NonnullOwnPtrVector<Message> m_unprocessed_messages;
     ByteBuffer m_unprocessed_bytes;
 
+    // Synchronous messages whose responses haven't arrived yet, in the order they were sent.
+    Vector<NonnullRefPtr<PendingResponseState>> m_pending_responses;
+    HashMap<StringView, LatencyHistogram> m_latency_histograms;
+
+    OwnPtr<RingTransport> m_ring_transport;
+    bool m_accepts_shared_ring_transport { false };
+    bool m_sends_through_ring { false };
+    bool m_peer_sends_through_ring { false };
+    // Once the peer sends through the ring, messages that come through the socket have to wait for their marker in it.
+    NonnullOwnPtrVector<Message> m_messages_waiting_for_ring_marker;
+    size_t m_ring_markers_waiting_for_socket { 0 };
+
     u32 m_local_endpoint_magic { 0 };
 
     NonnullOwnPtr<DeferredInvoker> m_deferred_invoker;
@@ -106,8 +177,7 @@ public:
     template<typename RequestType, typename... Args>
     NonnullOwnPtr<typename RequestType::ResponseType> send_sync(Args&&... args)
     {
-        MUST(post_message(RequestType(forward<Args>(args)...)));
-        auto response = wait_for_specific_endpoint_message<typename RequestType::ResponseType, PeerEndpoint>();
+        auto response = send_pipelined<RequestType>(forward<Args>(args)...).await();
         VERIFY(response);
         return response.release_nonnull();
     }
@@ -115,9 +185,24 @@ public:
     template<typename RequestType, typename... Args>
     OwnPtr<typename RequestType::ResponseType> send_sync_but_allow_failure(Args&&... args)
     {
+        return send_pipelined<RequestType>(forward<Args>(args)...).await();
+    }
+
+    // Sends a synchronous message without waiting for its response, so that several of them can be sent before waiting for any.
+    // The peer handles messages in order, so the responses come back in the order that the messages were sent in.
+    template<typename RequestType, typename... Args>
+    PendingResponse<typename RequestType::ResponseType> send_pipelined(Args&&... args)
+    {
+        using ResponseType = typename RequestType::ResponseType;
+        auto state = make_ref_counted<PendingResponseState>(PeerEndpoint::static_magic(), ResponseType::static_message_id());
+        if constexpr (IPC_LATENCY_DEBUG)
+            state->sent_at = Time::now_monotonic();
+
         if (post_message(RequestType(forward<Args>(args)...)).is_error())
-            return nullptr;
-        return wait_for_specific_endpoint_message<typename RequestType::ResponseType, PeerEndpoint>();
+            state->failed_to_send = true;
+        else
+            m_pending_responses.append(state);
+        return PendingResponse<ResponseType> { *this, move(state) };
     }
 
 protected:
@@ -129,38 +214,55 @@ protected:
         return {};
     }
 
-    virtual void try_parse_messages(Vector<u8> const& bytes, size_t& index) override
+    virtual OwnPtr<Message> try_decode_message(ReadonlyBytes bytes, ReceivedBuffer& buffer) override
     {
-        u32 message_size = 0;
-        for (; index + sizeof(message_size) < bytes.size(); index += message_size) {
-            memcpy(&message_size, bytes.data() + index, sizeof(message_size));
-            if (message_size == 0 || bytes.size() - index - sizeof(uint32_t) < message_size)
-                break;
-            index += sizeof(message_size);
-            auto remaining_bytes = ReadonlyBytes { bytes.data() + index, message_size };
-
-            auto local_message = LocalEndpoint::decode_message(remaining_bytes, fd_passing_socket());
-            if (!local_message.is_error()) {
-                m_unprocessed_messages.append(local_message.release_value());
-                continue;
-            }
-
-            auto peer_message = PeerEndpoint::decode_message(remaining_bytes, fd_passing_socket());
-            if (!peer_message.is_error()) {
-                m_unprocessed_messages.append(peer_message.release_value());
-                continue;
-            }
-
-            dbgln("Failed to parse a message");
-            dbgln("Local endpoint error: {}", local_message.error());
-            dbgln("Peer endpoint error: {}", peer_message.error());
-            break;
-        }
+        auto local_message = LocalEndpoint::decode_message(bytes, fd_passing_socket(), buffer);
+        if (!local_message.is_error())
+            return local_message.release_value();
+
+        auto peer_message = PeerEndpoint::decode_message(bytes, fd_passing_socket(), buffer);
+        if (!peer_message.is_error())
+            return peer_message.release_value();
+
+        dbgln("Failed to parse a message");
+        dbgln("Local endpoint error: {}", local_message.error());
+        dbgln("Peer endpoint error: {}", peer_message.error());
+        return {};
     }
 };
 
 }
 
+namespace IPC {
+
+// The response to a message sent with Connection::send_pipelined(), which is waited for when it's needed.
+template<typename ResponseType>
+class PendingResponse {
+public:
+    PendingResponse(ConnectionBase& connection, NonnullRefPtr<ConnectionBase::PendingResponseState> state)
+        : m_connection(connection)
+        , m_state(move(state))
+    {
+    }
+
+    bool has_arrived() const { return m_state->response.ptr() != nullptr; }
+
+    // Returns nullptr if the message couldn't be sent, or the connection was closed before the response arrived.
+    OwnPtr<ResponseType> await()
+    {
+        auto response = m_connection->wait_for_pending_response(*m_state);
+        if (!response)
+            return nullptr;
+        return response.template release_nonnull<ResponseType>();
+    }
+
+private:
+    NonnullRefPtr<ConnectionBase> m_connection;
+    NonnullRefPtr<ConnectionBase::PendingResponseState> m_state;
+};
+
+}
+
 template<typename LocalEndpoint, typename PeerEndpoint>
 struct AK::Formatter<IPC::Connection<LocalEndpoint, PeerEndpoint>> : Formatter<Core::Object> {
 };
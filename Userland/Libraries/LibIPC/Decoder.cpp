@@ -23,6 +23,28 @@ ErrorOr<size_t> Decoder::decode_size()
     return static_cast<size_t>(TRY(decode<u32>()));
 }
 
+ErrorOr<ReadonlyBytes> Decoder::decode_view(size_t size)
+{
+    if (size > m_stream.remaining())
+        return Error::from_string_literal("IPC::Decoder: View exceeds the end of the message");
+
+    auto offset = m_stream.offset();
+    TRY(m_stream.discard(size));
+    return static_cast<FixedMemoryStream const&>(m_stream).bytes().slice(offset, size);
+}
+
+template<>
+ErrorOr<StringView> decode(Decoder& decoder)
+{
+    auto length = TRY(decoder.decode_size());
+    if (length == NumericLimits<u32>::max())
+        return StringView {};
+    if (length == 0)
+        return ""sv;
+
+    return StringView { TRY(decoder.decode_view(length)) };
+}
+
 template<>
 ErrorOr<DeprecatedString> decode(Decoder& decoder)
 {
@@ -41,6 +63,13 @@ ErrorOr<DeprecatedString> decode(Decoder& decoder)
     return DeprecatedString { *text_impl };
 }
 
+template<>
+ErrorOr<ReadonlyBytes> decode(Decoder& decoder)
+{
+    auto length = TRY(decoder.decode_size());
+    return decoder.decode_view(length);
+}
+
 template<>
 ErrorOr<ByteBuffer> decode(Decoder& decoder)
 {
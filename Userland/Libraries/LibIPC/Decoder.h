@@ -9,6 +9,7 @@
 #include <AK/Concepts.h>
 #include <AK/DeprecatedString.h>
 #include <AK/Forward.h>
+#include <AK/MemoryStream.h>
 #include <AK/NumericLimits.h>
 #include <AK/StdLibExtras.h>
 #include <AK/Try.h>
@@ -32,7 +33,7 @@ inline ErrorOr<T> decode(Decoder&)
 
 class Decoder {
 public:
-    Decoder(Stream& stream, Core::LocalSocket& socket)
+    Decoder(FixedMemoryStream& stream, Core::LocalSocket& socket)
         : m_stream(stream)
         , m_socket(socket)
     {
@@ -56,10 +57,14 @@ public:
 
     ErrorOr<size_t> decode_size();
 
+    // Returns the next bytes of the message without copying them out of it.
+    // NOTE: The view is only valid for as long as the buffer that the message was received in.
+    ErrorOr<ReadonlyBytes> decode_view(size_t size);
+
     Core::LocalSocket& socket() { return m_socket; }
 
 private:
-    Stream& m_stream;
+    FixedMemoryStream& m_stream;
     Core::LocalSocket& m_socket;
 };
 
@@ -78,9 +83,15 @@ ErrorOr<T> decode(Decoder& decoder)
     return static_cast<T>(value);
 }
 
+template<>
+ErrorOr<StringView> decode(Decoder&);
+
 template<>
 ErrorOr<DeprecatedString> decode(Decoder&);
 
+template<>
+ErrorOr<ReadonlyBytes> decode(Decoder&);
+
 template<>
 ErrorOr<ByteBuffer> decode(Decoder&);
 
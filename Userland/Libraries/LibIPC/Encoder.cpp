@@ -60,13 +60,19 @@ ErrorOr<void> encode(Encoder& encoder, DeprecatedString const& value)
 }
 
 template<>
-ErrorOr<void> encode(Encoder& encoder, ByteBuffer const& value)
+ErrorOr<void> encode(Encoder& encoder, ReadonlyBytes const& value)
 {
     TRY(encoder.encode_size(value.size()));
     TRY(encoder.append(value.data(), value.size()));
     return {};
 }
 
+template<>
+ErrorOr<void> encode(Encoder& encoder, ByteBuffer const& value)
+{
+    return encoder.encode(value.bytes());
+}
+
 template<>
 ErrorOr<void> encode(Encoder& encoder, JsonValue const& value)
 {
@@ -112,6 +112,9 @@ ErrorOr<void> encode(Encoder&, StringView const&);
 template<>
 ErrorOr<void> encode(Encoder&, DeprecatedString const&);
 
+template<>
+ErrorOr<void> encode(Encoder&, ReadonlyBytes const&);
+
 template<>
 ErrorOr<void> encode(Encoder&, ByteBuffer const&);
 
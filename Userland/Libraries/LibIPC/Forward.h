@@ -14,6 +14,8 @@ class Decoder;
 class Dictionary;
 class Encoder;
 class Message;
+class ReceivedBuffer;
+class RingTransport;
 class File;
 class Stub;
 
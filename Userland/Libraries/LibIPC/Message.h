@@ -39,6 +39,26 @@ struct MessageBuffer {
     NonnullRefPtrVector<AutoCloseFileDescriptor, 1> fds;
 };
 
+// The bytes that a batch of messages was received in. Messages with StringView or ReadonlyBytes
+// parameters point into these instead of copying them, and keep them alive until they're handled.
+class ReceivedBuffer : public RefCounted<ReceivedBuffer> {
+public:
+    static ErrorOr<NonnullRefPtr<ReceivedBuffer>> create(Vector<u8> bytes)
+    {
+        return adopt_nonnull_ref_or_enomem(new (nothrow) ReceivedBuffer(move(bytes)));
+    }
+
+    ReadonlyBytes bytes() const { return m_bytes.span(); }
+
+private:
+    explicit ReceivedBuffer(Vector<u8> bytes)
+        : m_bytes(move(bytes))
+    {
+    }
+
+    Vector<u8> m_bytes;
+};
+
 enum class ErrorCode : u32 {
     PeerDisconnected
 };
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Time.h>
+#include <LibIPC/RingTransport.h>
+#include <sched.h>
+
+namespace IPC {
+
+// How long we wait for a peer that isn't emptying its queue before giving up on it, the same as the responsiveness timeout.
+static constexpr i64 full_queue_timeout_ms = 3000;
+
+ErrorOr<NonnullOwnPtr<RingTransport>> RingTransport::create()
+{
+    auto send_queue = TRY(Queue::create());
+    auto receive_queue = TRY(Queue::create());
+    return adopt_nonnull_own_or_enomem(new (nothrow) RingTransport(move(send_queue), move(receive_queue)));
+}
+
+ErrorOr<NonnullOwnPtr<RingTransport>> RingTransport::create_from_peer(int peer_send_queue_fd, int peer_receive_queue_fd)
+{
+    auto send_queue = TRY(Queue::create(peer_receive_queue_fd));
+    auto receive_queue = TRY(Queue::create(peer_send_queue_fd));
+    return adopt_nonnull_own_or_enomem(new (nothrow) RingTransport(move(send_queue), move(receive_queue)));
+}
+
+ErrorOr<bool> RingTransport::enqueue_message(ReadonlyBytes message)
+{
+    VERIFY(!message.is_empty() && message.size() <= slot_payload_size);
+    Slot slot;
+    slot.size = message.size();
+    message.copy_to(slot.data.span());
+    return enqueue(slot);
+}
+
+ErrorOr<bool> RingTransport::enqueue_socket_marker()
+{
+    return enqueue(Slot {});
+}
+
+ErrorOr<bool> RingTransport::enqueue(Slot const& slot)
+{
+    Optional<Time> deadline;
+    while (m_send_queue.enqueue(slot).is_error()) {
+        // The peer was woken up when the queue stopped being empty, so all we can do is wait for it to catch up.
+        auto now = Time::now_monotonic_coarse();
+        if (!deadline.has_value())
+            deadline = now + Time::from_milliseconds(full_queue_timeout_ms);
+        else if (now > *deadline)
+            return Error::from_string_literal("IPC::RingTransport: Peer queue overflowed");
+        sched_yield();
+    }
+
+    // We're the only producer, so the tail can't move under us. If the head is right behind it, our slot is the only
+    // one in the queue, and the peer may already have gone to sleep after emptying it.
+    return m_send_queue.weak_tail() - m_send_queue.head() == 1;
+}
+
+Optional<RingTransport::Slot> RingTransport::dequeue()
+{
+    auto result = m_receive_queue.dequeue();
+    if (result.is_error())
+        return {};
+    return result.release_value();
+}
+
+}
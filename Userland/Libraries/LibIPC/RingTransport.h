@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Error.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Types.h>
+#include <LibCore/SharedCircularQueue.h>
+#include <LibIPC/Message.h>
+
+namespace IPC {
+
+// A pair of queues in shared memory that a connection can pass its messages through instead of writing them to the socket.
+// The socket stays around for messages that don't fit into the queues, for passing file descriptors, and for waking up a peer
+// that has emptied its queue and gone back to waiting on the socket.
+class RingTransport {
+    AK_MAKE_NONCOPYABLE(RingTransport);
+    AK_MAKE_NONMOVABLE(RingTransport);
+
+public:
+    static constexpr size_t slot_payload_size = 1020;
+    static constexpr size_t slot_count = 128;
+
+    struct Slot {
+        // Zero means that the next message was too large or came with file descriptors, and was written to the socket instead.
+        u32 size { 0 };
+        Array<u8, slot_payload_size> data;
+    };
+
+    using Queue = Core::SharedSingleProducerCircularQueue<Slot, slot_count>;
+
+    // Sets up new queues, which are handed to the peer with send_queue_fd() and receive_queue_fd().
+    static ErrorOr<NonnullOwnPtr<RingTransport>> create();
+
+    // Maps the queues that the peer set up. What the peer sends on is what we receive on, and the other way around.
+    static ErrorOr<NonnullOwnPtr<RingTransport>> create_from_peer(int peer_send_queue_fd, int peer_receive_queue_fd);
+
+    int send_queue_fd() const { return m_send_queue.fd(); }
+    int receive_queue_fd() const { return m_receive_queue.fd(); }
+
+    static bool can_carry(MessageBuffer const& buffer)
+    {
+        return buffer.fds.is_empty() && buffer.data.size() <= slot_payload_size;
+    }
+
+    // These return true if the queue was empty, in which case the peer may be asleep and has to be woken up.
+    ErrorOr<bool> enqueue_message(ReadonlyBytes);
+    ErrorOr<bool> enqueue_socket_marker();
+
+    Optional<Slot> dequeue();
+
+private:
+    RingTransport(Queue send_queue, Queue receive_queue)
+        : m_send_queue(move(send_queue))
+        , m_receive_queue(move(receive_queue))
+    {
+    }
+
+    ErrorOr<bool> enqueue(Slot const&);
+
+    Queue m_send_queue;
+    Queue m_receive_queue;
+};
+
+}
@@ -5,6 +5,7 @@
  */
 
 #include <LibCore/AnonymousBuffer.h>
+#include <LibCore/EventLoop.h>
 #include <LibImageDecoderClient/Client.h>
 
 namespace ImageDecoderClient {
@@ -16,24 +17,53 @@ Client::Client(NonnullOwnPtr<Core::LocalSocket> socket)
 
 void Client::die()
 {
+    auto pending_decodes = move(m_pending_decodes);
+    for (auto& it : pending_decodes)
+        it.value({});
+
     if (on_death)
         on_death();
 }
 
-Optional<DecodedImage> Client::decode_image(ReadonlyBytes encoded_data, Optional<DeprecatedString> mime_type)
+static Optional<Core::AnonymousBuffer> copy_into_anonymous_buffer(ReadonlyBytes encoded_data)
 {
-    if (encoded_data.is_empty())
-        return {};
-
     auto encoded_buffer_or_error = Core::AnonymousBuffer::create_with_size(encoded_data.size());
     if (encoded_buffer_or_error.is_error()) {
         dbgln("Could not allocate encoded buffer");
         return {};
     }
     auto encoded_buffer = encoded_buffer_or_error.release_value();
-
     memcpy(encoded_buffer.data<void>(), encoded_data.data(), encoded_data.size());
-    auto response_or_error = try_decode_image(move(encoded_buffer), mime_type);
+    return encoded_buffer;
+}
+
+static Optional<DecodedImage> make_decoded_image(bool is_animated, u32 loop_count, Vector<Gfx::ShareableBitmap> const& bitmaps, Vector<u32> const& durations)
+{
+    if (bitmaps.is_empty())
+        return {};
+
+    DecodedImage image;
+    image.is_animated = is_animated;
+    image.loop_count = loop_count;
+    image.frames.resize(bitmaps.size());
+    for (size_t i = 0; i < image.frames.size(); ++i) {
+        auto& frame = image.frames[i];
+        frame.bitmap = bitmaps[i].bitmap();
+        frame.duration = durations[i];
+    }
+    return image;
+}
+
+Optional<DecodedImage> Client::decode_image(ReadonlyBytes encoded_data, Optional<DeprecatedString> mime_type)
+{
+    if (encoded_data.is_empty())
+        return {};
+
+    auto encoded_buffer = copy_into_anonymous_buffer(encoded_data);
+    if (!encoded_buffer.has_value())
+        return {};
+
+    auto response_or_error = try_decode_image(encoded_buffer.release_value(), mime_type);
 
     if (response_or_error.is_error()) {
         dbgln("ImageDecoder died heroically");
@@ -41,20 +71,30 @@ Optional<DecodedImage> Client::decode_image(ReadonlyBytes encoded_data, Optional
     }
 
     auto& response = response_or_error.value();
+    return make_decoded_image(response.is_animated(), response.loop_count(), response.bitmaps(), response.durations());
+}
 
-    if (response.bitmaps().is_empty())
-        return {};
-
-    DecodedImage image;
-    image.is_animated = response.is_animated();
-    image.loop_count = response.loop_count();
-    image.frames.resize(response.bitmaps().size());
-    for (size_t i = 0; i < image.frames.size(); ++i) {
-        auto& frame = image.frames[i];
-        frame.bitmap = response.bitmaps()[i].bitmap();
-        frame.duration = response.durations()[i];
+void Client::decode_image_async(ReadonlyBytes encoded_data, Function<void(Optional<DecodedImage>)> on_decoded, Optional<DeprecatedString> mime_type, ImageDecoder::DecodePriority priority)
+{
+    auto encoded_buffer = encoded_data.is_empty() ? Optional<Core::AnonymousBuffer> {} : copy_into_anonymous_buffer(encoded_data);
+    if (!encoded_buffer.has_value()) {
+        Core::deferred_invoke([on_decoded = move(on_decoded)] {
+            on_decoded({});
+        });
+        return;
     }
-    return image;
+
+    auto request_id = m_next_request_id++;
+    m_pending_decodes.set(request_id, move(on_decoded));
+    async_start_decoding_image(request_id, encoded_buffer.release_value(), mime_type, priority);
+}
+
+void Client::did_decode_image(i32 request_id, bool is_animated, u32 loop_count, Vector<Gfx::ShareableBitmap> const& bitmaps, Vector<u32> const& durations)
+{
+    auto on_decoded = m_pending_decodes.take(request_id);
+    if (!on_decoded.has_value())
+        return;
+    (*on_decoded)(make_decoded_image(is_animated, loop_count, bitmaps, durations));
 }
 
 }
@@ -32,12 +32,23 @@ class Client final
 public:
     Optional<DecodedImage> decode_image(ReadonlyBytes, Optional<DeprecatedString> mime_type = {});
 
+    // Decodes the image without blocking, and calls the callback from the event loop once that's done.
+    // Images that aren't visible at the moment should be decoded with DecodePriority::Offscreen, so that they don't
+    // hold up the ones that are.
+    // NOTE: If ImageDecoder dies before that, the callback is called with an empty result.
+    void decode_image_async(ReadonlyBytes, Function<void(Optional<DecodedImage>)> on_decoded, Optional<DeprecatedString> mime_type = {}, ImageDecoder::DecodePriority = ImageDecoder::DecodePriority::Visible);
+
     Function<void()> on_death;
 
 private:
     Client(NonnullOwnPtr<Core::LocalSocket>);
 
     virtual void die() override;
+
+    virtual void did_decode_image(i32 request_id, bool is_animated, u32 loop_count, Vector<Gfx::ShareableBitmap> const& bitmaps, Vector<u32> const& durations) override;
+
+    i32 m_next_request_id { 0 };
+    HashMap<i32, Function<void(Optional<DecodedImage>)>> m_pending_decodes;
 };
 
 }
@@ -11,6 +11,7 @@
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/IdentifierTable.h>
 #include <LibJS/Bytecode/StringTable.h>
+#include <LibJS/JIT/NativeExecutable.h>
 
 namespace JS::Bytecode {
 
@@ -22,6 +23,11 @@ struct Executable {
     size_t number_of_registers { 0 };
     bool is_strict_mode { false };
 
+    // Counts the basic blocks the interpreter entered, until the executable is hot enough to be compiled to machine code.
+    mutable size_t jit_hotness { 0 };
+    mutable bool did_try_jit_compiling { false };
+    mutable OwnPtr<JIT::NativeExecutable> native_executable;
+
     DeprecatedString const& get_string(StringTableIndex index) const { return string_table->get(index); }
     DeprecatedFlyString const& get_identifier(IdentifierTableIndex index) const { return identifier_table->get(index); }
 
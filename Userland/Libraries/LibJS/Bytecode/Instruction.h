@@ -113,6 +113,12 @@ public:
     ThrowCompletionOr<void> execute(Bytecode::Interpreter&) const;
     void replace_references(BasicBlock const&, BasicBlock const&);
     void replace_references(Register, Register);
+
+    // Calls the callback with a reference to every register operand, which doesn't include the implicit accumulator.
+    // NOTE: NewArray only passes the first and last register of its element range.
+    template<typename Callback>
+    void visit_registers(Callback);
+
     static void destroy(Instruction&);
 
 protected:
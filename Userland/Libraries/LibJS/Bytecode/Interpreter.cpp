@@ -11,14 +11,20 @@
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Bytecode/Op.h>
 #include <LibJS/Interpreter.h>
+#include <LibJS/JIT/Compiler.h>
 #include <LibJS/Runtime/GlobalEnvironment.h>
 #include <LibJS/Runtime/GlobalObject.h>
 #include <LibJS/Runtime/Realm.h>
+#include <LibJS/SamplingProfiler.h>
 
 namespace JS::Bytecode {
 
 static Interpreter* s_current;
 bool g_dump_bytecode = false;
+bool g_jit_enabled = false;
+
+// How many basic blocks the interpreter enters in an executable before compiling it to machine code.
+static constexpr size_t jit_hotness_threshold = 100;
 
 Interpreter* Interpreter::current()
 {
@@ -74,6 +80,22 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
         Bytecode::InstructionStreamIterator pc(m_current_block->instruction_stream());
         TemporaryChange temp_change { m_pc, &pc };
 
+        if (auto* profiler = vm().sampling_profiler())
+            profiler->did_reach_safepoint();
+
+        if (g_jit_enabled && !executable.did_try_jit_compiling && ++executable.jit_hotness >= jit_hotness_threshold) {
+            executable.did_try_jit_compiling = true;
+            executable.native_executable = JIT::Compiler::compile(executable);
+        }
+
+        // Compiled code picks up at the start of the current block and runs until the executable returns or throws.
+        if (executable.native_executable) {
+            auto result = executable.native_executable->run(*this, registers(), *m_current_block);
+            if (result.is_error())
+                m_saved_exception = make_handle(*result.throw_completion().value());
+            break;
+        }
+
         bool will_jump = false;
         bool will_return = false;
         while (!pc.at_end()) {
@@ -254,7 +276,11 @@ Bytecode::PassManager& Interpreter::optimization_pipeline(Interpreter::Optimizat
         pm->add<Passes::MergeBlocks>();
         pm->add<Passes::GenerateCFG>();
         pm->add<Passes::PlaceBlocks>();
-        pm->add<Passes::EliminateLoads>();
+        // NOTE: EliminateLoads isn't part of the pipeline, as it reuses the result of a GetVariable across instructions
+        //       that may run arbitrary code (getters on the global object, valueOf() in arithmetic, ...) and change it.
+        pm->add<Passes::FoldConstants>();
+        pm->add<Passes::EliminateDeadStores>();
+        pm->add<Passes::AllocateRegisters>();
     } else {
         VERIFY_NOT_REACHED();
     }
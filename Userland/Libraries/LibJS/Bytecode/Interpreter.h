@@ -77,7 +77,7 @@ public:
         None,
         Optimize,
         __Count,
-        Default = None,
+        Default = Optimize,
     };
     static Bytecode::PassManager& optimization_pipeline(OptimizationLevel = OptimizationLevel::Default);
 
@@ -112,5 +112,6 @@ private:
 };
 
 extern bool g_dump_bytecode;
+extern bool g_jit_enabled;
 
 }
@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Checked.h>
 #include <AK/HashTable.h>
 #include <LibJS/AST.h>
 #include <LibJS/Bytecode/Interpreter.h>
@@ -48,7 +49,77 @@ DeprecatedString Instruction::to_deprecated_string(Bytecode::Executable const& e
 
 namespace JS::Bytecode::Op {
 
-static ThrowCompletionOr<void> put_by_property_key(Object* object, Value value, PropertyKey name, Bytecode::Interpreter& interpreter, PropertyKind kind)
+Optional<Value> PropertyLookupCache::get(VM& vm, Object const& object) const
+{
+    for (auto const& entry : entries) {
+        if (entry.shape.ptr() != &object.shape())
+            continue;
+
+        Value value;
+        if (entry.prototype) {
+            if (entry.prototype_chain_generation != vm.prototype_chain_generation())
+                return {};
+            value = entry.prototype->get_direct(entry.property_offset);
+        } else {
+            value = object.get_direct(entry.property_offset);
+        }
+
+        // The property may have been redefined as an accessor without changing its attributes, or be an intrinsic that
+        // hasn't been created yet. Both need the full lookup.
+        if (value.is_empty() || value.is_accessor())
+            return {};
+        return value;
+    }
+    return {};
+}
+
+bool PropertyLookupCache::put(Object& object, Value value) const
+{
+    for (auto const& entry : entries) {
+        if (entry.shape.ptr() != &object.shape() || entry.prototype)
+            continue;
+
+        auto current_value = object.get_direct(entry.property_offset);
+        if (current_value.is_empty() || current_value.is_accessor())
+            return false;
+        object.put_direct(entry.property_offset, value);
+        return true;
+    }
+    return false;
+}
+
+void PropertyLookupCache::update(VM& vm, Object const& object, Shape& shape_before_lookup, CacheablePropertyMetadata const& metadata)
+{
+    // Unique shapes change in place, so they don't tell us where properties are.
+    if (!metadata.holder || &object.shape() != &shape_before_lookup || shape_before_lookup.is_unique())
+        return;
+
+    Entry new_entry { .shape = shape_before_lookup.make_weak_ptr(), .property_offset = metadata.property_offset };
+    if (metadata.holder != &object) {
+        // Remember every object the lookup went through, so that changing any of them invalidates the entry.
+        auto* prototype = shape_before_lookup.prototype();
+        while (prototype && prototype != metadata.holder) {
+            prototype->set_is_cached_prototype();
+            prototype = prototype->shape().prototype();
+        }
+        if (!prototype)
+            return;
+        prototype->set_is_cached_prototype();
+        new_entry.prototype = prototype;
+        new_entry.prototype_chain_generation = vm.prototype_chain_generation();
+    }
+
+    for (auto& entry : entries) {
+        if (entry.shape.ptr() == &shape_before_lookup) {
+            entry = move(new_entry);
+            return;
+        }
+    }
+    entries[next_entry_to_replace] = move(new_entry);
+    next_entry_to_replace = (next_entry_to_replace + 1) % max_entry_count;
+}
+
+static ThrowCompletionOr<void> put_by_property_key(Object* object, Value value, PropertyKey name, Bytecode::Interpreter& interpreter, PropertyKind kind, PropertyLookupCache* cache = nullptr)
 {
     auto& vm = interpreter.vm();
 
@@ -72,7 +143,13 @@ static ThrowCompletionOr<void> put_by_property_key(Object* object, Value value,
         break;
     }
     case PropertyKind::KeyValue: {
-        bool succeeded = TRY(object->internal_set(name, interpreter.accumulator(), object));
+        if (cache && cache->put(*object, interpreter.accumulator()))
+            break;
+        auto& shape = object->shape();
+        CacheablePropertyMetadata cacheable_metadata;
+        bool succeeded = TRY(object->internal_set(name, interpreter.accumulator(), object, cache ? &cacheable_metadata : nullptr));
+        if (cache)
+            cache->update(vm, *object, shape, cacheable_metadata);
         if (!succeeded && vm.in_strict_mode())
             return vm.throw_completion<TypeError>(ErrorType::ReferenceNullishSetProperty, name, interpreter.accumulator().to_string_without_side_effects());
         break;
@@ -127,6 +204,122 @@ static ThrowCompletionOr<Value> typed_equals(VM&, Value src1, Value src2)
     return Value(is_strictly_equal(src1, src2));
 }
 
+// The fast paths return the result of the operation if they can compute it from the operands alone, which is the
+// case for (most) int32 and double operands.
+static ALWAYS_INLINE Optional<Value> add_fast_path(Value lhs, Value rhs)
+{
+    if (lhs.is_int32() && rhs.is_int32() && !Checked<i32>::addition_would_overflow(lhs.as_i32(), rhs.as_i32()))
+        return Value(lhs.as_i32() + rhs.as_i32());
+    if (lhs.is_number() && rhs.is_number())
+        return Value(lhs.as_double() + rhs.as_double());
+    return {};
+}
+
+static ALWAYS_INLINE Optional<Value> sub_fast_path(Value lhs, Value rhs)
+{
+    if (lhs.is_int32() && rhs.is_int32()) {
+        Checked<i32> result = lhs.as_i32();
+        result -= rhs.as_i32();
+        if (!result.has_overflow())
+            return Value(result.value());
+    }
+    if (lhs.is_number() && rhs.is_number())
+        return Value(lhs.as_double() - rhs.as_double());
+    return {};
+}
+
+static ALWAYS_INLINE Optional<Value> mul_fast_path(Value lhs, Value rhs)
+{
+    // NOTE: A zero result with a negative operand is -0, which isn't an int32, so the double path handles it.
+    if (lhs.is_int32() && rhs.is_int32() && !Checked<i32>::multiplication_would_overflow(lhs.as_i32(), rhs.as_i32())) {
+        auto result = lhs.as_i32() * rhs.as_i32();
+        if (result != 0 || (lhs.as_i32() >= 0 && rhs.as_i32() >= 0))
+            return Value(result);
+    }
+    if (lhs.is_number() && rhs.is_number())
+        return Value(lhs.as_double() * rhs.as_double());
+    return {};
+}
+
+static ALWAYS_INLINE Optional<Value> div_fast_path(Value lhs, Value rhs)
+{
+    if (lhs.is_number() && rhs.is_number())
+        return Value(lhs.as_double() / rhs.as_double());
+    return {};
+}
+
+#define JS_DEFINE_RELATIONAL_FAST_PATH(op_snake_case, op)                                \
+    static ALWAYS_INLINE Optional<Value> op_snake_case##_fast_path(Value lhs, Value rhs) \
+    {                                                                                    \
+        if (lhs.is_int32() && rhs.is_int32())                                            \
+            return Value(lhs.as_i32() op rhs.as_i32());                                  \
+        if (lhs.is_number() && rhs.is_number())                                          \
+            return Value(lhs.as_double() op rhs.as_double());                            \
+        return {};                                                                       \
+    }
+
+JS_DEFINE_RELATIONAL_FAST_PATH(greater_than, >)
+JS_DEFINE_RELATIONAL_FAST_PATH(greater_than_equals, >=)
+JS_DEFINE_RELATIONAL_FAST_PATH(less_than, <)
+JS_DEFINE_RELATIONAL_FAST_PATH(less_than_equals, <=)
+
+#undef JS_DEFINE_RELATIONAL_FAST_PATH
+
+// NOTE: The bitwise operations only have a fast path for int32 operands, as anything else needs ToInt32().
+#define JS_DEFINE_BITWISE_FAST_PATH(op_snake_case, op)                                   \
+    static ALWAYS_INLINE Optional<Value> op_snake_case##_fast_path(Value lhs, Value rhs) \
+    {                                                                                    \
+        if (lhs.is_int32() && rhs.is_int32())                                            \
+            return Value(lhs.as_i32() op rhs.as_i32());                                  \
+        return {};                                                                       \
+    }
+
+JS_DEFINE_BITWISE_FAST_PATH(bitwise_and, &)
+JS_DEFINE_BITWISE_FAST_PATH(bitwise_or, |)
+JS_DEFINE_BITWISE_FAST_PATH(bitwise_xor, ^)
+
+#undef JS_DEFINE_BITWISE_FAST_PATH
+
+static ALWAYS_INLINE Optional<Value> left_shift_fast_path(Value lhs, Value rhs)
+{
+    if (lhs.is_int32() && rhs.is_int32())
+        return Value(static_cast<i32>(static_cast<u32>(lhs.as_i32()) << (static_cast<u32>(rhs.as_i32()) % 32)));
+    return {};
+}
+
+static ALWAYS_INLINE Optional<Value> right_shift_fast_path(Value lhs, Value rhs)
+{
+    if (lhs.is_int32() && rhs.is_int32())
+        return Value(lhs.as_i32() >> (static_cast<u32>(rhs.as_i32()) % 32));
+    return {};
+}
+
+static ALWAYS_INLINE Optional<Value> unsigned_right_shift_fast_path(Value lhs, Value rhs)
+{
+    if (lhs.is_int32() && rhs.is_int32())
+        return Value(static_cast<double>(static_cast<u32>(lhs.as_i32()) >> (static_cast<u32>(rhs.as_i32()) % 32)));
+    return {};
+}
+
+#define JS_DEFINE_COMMON_BINARY_OP_WITH_FAST_PATH(OpTitleCase, op_snake_case)                   \
+    ThrowCompletionOr<void> OpTitleCase::execute_impl(Bytecode::Interpreter& interpreter) const \
+    {                                                                                           \
+        auto lhs = interpreter.reg(m_lhs_reg);                                                  \
+        auto rhs = interpreter.accumulator();                                                   \
+        if (auto result = op_snake_case##_fast_path(lhs, rhs); result.has_value()) {            \
+            interpreter.accumulator() = *result;                                                \
+            return {};                                                                          \
+        }                                                                                       \
+        interpreter.accumulator() = TRY(op_snake_case(interpreter.vm(), lhs, rhs));             \
+        return {};                                                                              \
+    }                                                                                           \
+    DeprecatedString OpTitleCase::to_deprecated_string_impl(Bytecode::Executable const&) const  \
+    {                                                                                           \
+        return DeprecatedString::formatted(#OpTitleCase " {}", m_lhs_reg);                      \
+    }
+
+JS_ENUMERATE_COMMON_BINARY_OPS_WITH_FAST_PATH(JS_DEFINE_COMMON_BINARY_OP_WITH_FAST_PATH)
+
 #define JS_DEFINE_COMMON_BINARY_OP(OpTitleCase, op_snake_case)                                  \
     ThrowCompletionOr<void> OpTitleCase::execute_impl(Bytecode::Interpreter& interpreter) const \
     {                                                                                           \
@@ -141,7 +334,7 @@ static ThrowCompletionOr<Value> typed_equals(VM&, Value src1, Value src2)
         return DeprecatedString::formatted(#OpTitleCase " {}", m_lhs_reg);                      \
     }
 
-JS_ENUMERATE_COMMON_BINARY_OPS(JS_DEFINE_COMMON_BINARY_OP)
+JS_ENUMERATE_COMMON_BINARY_OPS_WITHOUT_FAST_PATH(JS_DEFINE_COMMON_BINARY_OP)
 
 static ThrowCompletionOr<Value> not_(VM&, Value value)
 {
@@ -493,7 +686,16 @@ ThrowCompletionOr<void> GetById::execute_impl(Bytecode::Interpreter& interpreter
 {
     auto& vm = interpreter.vm();
     auto* object = TRY(interpreter.accumulator().to_object(vm));
-    interpreter.accumulator() = TRY(object->get(interpreter.current_executable().get_identifier(m_property)));
+
+    if (auto cached_value = m_cache.get(vm, *object); cached_value.has_value()) {
+        interpreter.accumulator() = *cached_value;
+        return {};
+    }
+
+    auto& shape = object->shape();
+    CacheablePropertyMetadata cacheable_metadata;
+    interpreter.accumulator() = TRY(object->internal_get(interpreter.current_executable().get_identifier(m_property), object, &cacheable_metadata));
+    m_cache.update(vm, *object, shape, cacheable_metadata);
     return {};
 }
 
@@ -503,7 +705,7 @@ ThrowCompletionOr<void> PutById::execute_impl(Bytecode::Interpreter& interpreter
     auto* object = TRY(interpreter.reg(m_base).to_object(vm));
     PropertyKey name = interpreter.current_executable().get_identifier(m_property);
     auto value = interpreter.accumulator();
-    return put_by_property_key(object, value, name, interpreter, m_kind);
+    return put_by_property_key(object, value, name, interpreter, m_kind, &m_cache);
 }
 
 ThrowCompletionOr<void> DeleteById::execute_impl(Bytecode::Interpreter& interpreter) const
@@ -8,7 +8,9 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/StdLibExtras.h>
+#include <AK/WeakPtr.h>
 #include <LibCrypto/BigInt/SignedBigInteger.h>
 #include <LibJS/Bytecode/IdentifierTable.h>
 #include <LibJS/Bytecode/Instruction.h>
@@ -18,6 +20,7 @@
 #include <LibJS/Heap/Cell.h>
 #include <LibJS/Runtime/Environment.h>
 #include <LibJS/Runtime/EnvironmentCoordinate.h>
+#include <LibJS/Runtime/Shape.h>
 #include <LibJS/Runtime/Value.h>
 #include <LibJS/Runtime/ValueTraits.h>
 
@@ -39,6 +42,10 @@ public:
         if (m_src == from)
             m_src = to;
     }
+    template<typename Callback>
+    void visit_registers_impl(Callback callback) { callback(m_src); }
+
+    Register src() const { return m_src; }
 
 private:
     Register m_src;
@@ -57,6 +64,8 @@ public:
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
     void replace_references_impl(Register, Register) { }
 
+    Value value() const { return m_value; }
+
 private:
     Value m_value;
 };
@@ -73,6 +82,8 @@ public:
     DeprecatedString to_deprecated_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
     void replace_references_impl(Register, Register) { }
+    template<typename Callback>
+    void visit_registers_impl(Callback callback) { callback(m_dst); }
 
     Register dst() const { return m_dst; }
 
@@ -80,30 +91,38 @@ private:
     Register m_dst;
 };
 
-#define JS_ENUMERATE_COMMON_BINARY_OPS(O)     \
-    O(Add, add)                               \
-    O(Sub, sub)                               \
-    O(Mul, mul)                               \
-    O(Div, div)                               \
-    O(Exp, exp)                               \
-    O(Mod, mod)                               \
-    O(In, in)                                 \
-    O(InstanceOf, instance_of)                \
-    O(GreaterThan, greater_than)              \
-    O(GreaterThanEquals, greater_than_equals) \
-    O(LessThan, less_than)                    \
-    O(LessThanEquals, less_than_equals)       \
-    O(LooselyInequals, abstract_inequals)     \
-    O(LooselyEquals, abstract_equals)         \
-    O(StrictlyInequals, typed_inequals)       \
-    O(StrictlyEquals, typed_equals)           \
-    O(BitwiseAnd, bitwise_and)                \
-    O(BitwiseOr, bitwise_or)                  \
-    O(BitwiseXor, bitwise_xor)                \
-    O(LeftShift, left_shift)                  \
-    O(RightShift, right_shift)                \
+// NOTE: The operations with a fast path handle int32 and double operands inline, and only call into the generic
+//       implementation from AbstractOperations for anything else.
+#define JS_ENUMERATE_COMMON_BINARY_OPS_WITH_FAST_PATH(O) \
+    O(Add, add)                                          \
+    O(Sub, sub)                                          \
+    O(Mul, mul)                                          \
+    O(Div, div)                                          \
+    O(GreaterThan, greater_than)                         \
+    O(GreaterThanEquals, greater_than_equals)            \
+    O(LessThan, less_than)                               \
+    O(LessThanEquals, less_than_equals)                  \
+    O(BitwiseAnd, bitwise_and)                           \
+    O(BitwiseOr, bitwise_or)                             \
+    O(BitwiseXor, bitwise_xor)                           \
+    O(LeftShift, left_shift)                             \
+    O(RightShift, right_shift)                           \
     O(UnsignedRightShift, unsigned_right_shift)
 
+#define JS_ENUMERATE_COMMON_BINARY_OPS_WITHOUT_FAST_PATH(O) \
+    O(Exp, exp)                                             \
+    O(Mod, mod)                                             \
+    O(In, in)                                               \
+    O(InstanceOf, instance_of)                              \
+    O(LooselyInequals, abstract_inequals)                   \
+    O(LooselyEquals, abstract_equals)                       \
+    O(StrictlyInequals, typed_inequals)                     \
+    O(StrictlyEquals, typed_equals)
+
+#define JS_ENUMERATE_COMMON_BINARY_OPS(O)            \
+    JS_ENUMERATE_COMMON_BINARY_OPS_WITH_FAST_PATH(O) \
+    JS_ENUMERATE_COMMON_BINARY_OPS_WITHOUT_FAST_PATH(O)
+
 #define JS_DECLARE_COMMON_BINARY_OP(OpTitleCase, op_snake_case)                        \
     class OpTitleCase final : public Instruction {                                     \
     public:                                                                            \
@@ -123,6 +142,10 @@ private:
             if (m_lhs_reg == from)                                                     \
                 m_lhs_reg = to;                                                        \
         }                                                                              \
+        template<typename Callback>                                                    \
+        void visit_registers_impl(Callback callback) { callback(m_lhs_reg); }          \
+                                                                                       \
+        Register lhs() const { return m_lhs_reg; }                                     \
                                                                                        \
     private:                                                                           \
         Register m_lhs_reg;                                                            \
@@ -252,6 +275,13 @@ public:
     DeprecatedString to_deprecated_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
     void replace_references_impl(Register from, Register to);
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        callback(m_from_object);
+        for (size_t i = 0; i < m_excluded_names_count; i++)
+            callback(m_excluded_names[i]);
+    }
 
     size_t length_impl() const { return sizeof(*this) + sizeof(Register) * m_excluded_names_count; }
 
@@ -301,6 +331,14 @@ public:
     // Note: The underlying element range shall never be changed item, by item
     //       shifting it may be done in the future
     void replace_references_impl(Register from, Register) { VERIFY(!m_element_count || from.index() < start().index() || from.index() > end().index()); }
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        if (!m_element_count)
+            return;
+        callback(m_elements[0]);
+        callback(m_elements[1]);
+    }
 
     size_t length_impl() const
     {
@@ -341,6 +379,8 @@ public:
 
     // Note: This should never do anything, the lhs should always be an array, that is currently being constructed
     void replace_references_impl(Register from, Register) { VERIFY(from != m_lhs); }
+    template<typename Callback>
+    void visit_registers_impl(Callback callback) { callback(m_lhs); }
 
 private:
     Register m_lhs;
@@ -373,6 +413,8 @@ public:
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
     // Note: lhs should always be a string in construction, so this should never do anything
     void replace_references_impl(Register from, Register) { VERIFY(from != m_lhs); }
+    template<typename Callback>
+    void visit_registers_impl(Callback callback) { callback(m_lhs); }
 
 private:
     Register m_lhs;
@@ -504,6 +546,27 @@ private:
     IdentifierTableIndex m_identifier;
 };
 
+// Remembers where GetById and PutById found their property in objects of the last few shapes they saw, so that they can
+// skip the lookup for the next object of the same shape.
+struct PropertyLookupCache {
+    struct Entry {
+        WeakPtr<Shape> shape;
+        u32 property_offset { 0 };
+        // Set if the property was found on the prototype chain. It can't go away while the shape is alive and the
+        // prototype chain generation stays the same, as nothing on the chain has changed since.
+        Object* prototype { nullptr };
+        u64 prototype_chain_generation { 0 };
+    };
+
+    Optional<Value> get(VM&, Object const&) const;
+    bool put(Object&, Value) const;
+    void update(VM&, Object const&, Shape& shape_before_lookup, CacheablePropertyMetadata const&);
+
+    static constexpr size_t max_entry_count = 4;
+    AK::Array<Entry, max_entry_count> entries;
+    size_t next_entry_to_replace { 0 };
+};
+
 class GetById final : public Instruction {
 public:
     explicit GetById(IdentifierTableIndex property)
@@ -519,6 +582,8 @@ public:
 
 private:
     IdentifierTableIndex m_property;
+
+    PropertyLookupCache mutable m_cache;
 };
 
 enum class PropertyKind {
@@ -547,11 +612,15 @@ public:
         if (m_base == from)
             m_base = to;
     }
+    template<typename Callback>
+    void visit_registers_impl(Callback callback) { callback(m_base); }
 
 private:
     Register m_base;
     IdentifierTableIndex m_property;
     PropertyKind m_kind;
+
+    PropertyLookupCache mutable m_cache;
 };
 
 class DeleteById final : public Instruction {
@@ -587,6 +656,8 @@ public:
         if (m_base == from)
             m_base = to;
     }
+    template<typename Callback>
+    void visit_registers_impl(Callback callback) { callback(m_base); }
 
 private:
     Register m_base;
@@ -610,6 +681,12 @@ public:
         if (m_base == from)
             m_base = to;
     }
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        callback(m_base);
+        callback(m_property);
+    }
 
 private:
     Register m_base;
@@ -633,6 +710,8 @@ public:
         if (m_base == from)
             m_base = to;
     }
+    template<typename Callback>
+    void visit_registers_impl(Callback callback) { callback(m_base); }
 
 private:
     Register m_base;
@@ -729,6 +808,12 @@ public:
     DeprecatedString to_deprecated_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
     void replace_references_impl(Register, Register);
+    template<typename Callback>
+    void visit_registers_impl(Callback callback)
+    {
+        callback(m_callee);
+        callback(m_this_value);
+    }
 
     Completion throw_type_error_for_callee(Bytecode::Interpreter&, StringView callee_type) const;
 
@@ -1174,6 +1259,30 @@ ALWAYS_INLINE void Instruction::replace_references(Register from, Register to)
 #undef __BYTECODE_OP
 }
 
+// NOTE: Instructions without register operands don't define visit_registers_impl().
+template<typename OpType, typename Callback>
+ALWAYS_INLINE void visit_registers_of(OpType& instruction, Callback& callback)
+{
+    if constexpr (requires { instruction.visit_registers_impl(callback); })
+        instruction.visit_registers_impl(callback);
+}
+
+template<typename Callback>
+ALWAYS_INLINE void Instruction::visit_registers(Callback callback)
+{
+#define __BYTECODE_OP(op)       \
+    case Instruction::Type::op: \
+        return visit_registers_of(static_cast<Bytecode::Op::op&>(*this), callback);
+
+    switch (type()) {
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+#undef __BYTECODE_OP
+}
+
 ALWAYS_INLINE size_t Instruction::length() const
 {
     if (type() == Type::NewArray)
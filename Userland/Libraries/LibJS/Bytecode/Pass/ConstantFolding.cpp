@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashMap.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+#include <math.h>
+
+namespace JS::Bytecode::Passes {
+
+// Evaluates a binary operation on two numbers, if doing so can't observe anything but the operands.
+static Optional<Value> fold_binary_operation(Instruction::Type type, Value lhs, Value rhs)
+{
+    if (!lhs.is_number() || !rhs.is_number())
+        return {};
+
+    auto lhs_double = lhs.as_double();
+    auto rhs_double = rhs.as_double();
+
+    using enum Instruction::Type;
+    switch (type) {
+    case Add:
+        return Value(lhs_double + rhs_double);
+    case Sub:
+        return Value(lhs_double - rhs_double);
+    case Mul:
+        return Value(lhs_double * rhs_double);
+    case Div:
+        return Value(lhs_double / rhs_double);
+    case Mod:
+        // NOTE: fmod() has the same sign and edge case behavior as the JS remainder operator.
+        return Value(fmod(lhs_double, rhs_double));
+    case GreaterThan:
+        return Value(lhs_double > rhs_double);
+    case GreaterThanEquals:
+        return Value(lhs_double >= rhs_double);
+    case LessThan:
+        return Value(lhs_double < rhs_double);
+    case LessThanEquals:
+        return Value(lhs_double <= rhs_double);
+    case StrictlyEquals:
+        return Value(lhs_double == rhs_double);
+    case StrictlyInequals:
+        return Value(lhs_double != rhs_double);
+    default:
+        break;
+    }
+
+    // The bitwise operations are only folded for int32 operands, which don't need ToInt32().
+    if (!lhs.is_int32() || !rhs.is_int32())
+        return {};
+
+    auto lhs_i32 = lhs.as_i32();
+    auto rhs_i32 = rhs.as_i32();
+    auto shift_count = static_cast<u32>(rhs_i32) % 32;
+
+    switch (type) {
+    case BitwiseAnd:
+        return Value(lhs_i32 & rhs_i32);
+    case BitwiseOr:
+        return Value(lhs_i32 | rhs_i32);
+    case BitwiseXor:
+        return Value(lhs_i32 ^ rhs_i32);
+    case LeftShift:
+        return Value(static_cast<i32>(static_cast<u32>(lhs_i32) << shift_count));
+    case RightShift:
+        return Value(lhs_i32 >> shift_count);
+    case UnsignedRightShift:
+        return Value(static_cast<u32>(lhs_i32) >> shift_count);
+    default:
+        return {};
+    }
+}
+
+static void replace_block(PassPipelineExecutable& executable, size_t index, NonnullOwnPtr<BasicBlock> new_block)
+{
+    auto old_block = move(executable.executable.basic_blocks.ptr_at(index));
+    executable.executable.basic_blocks.ptr_at(index) = move(new_block);
+
+    for (auto& block : executable.executable.basic_blocks) {
+        for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it)
+            const_cast<Instruction&>(*it).replace_references(*old_block, executable.executable.basic_blocks[index]);
+    }
+}
+
+static Optional<Register> lhs_of_binary_operation(Instruction const& instruction)
+{
+    switch (instruction.type()) {
+#define __BYTECODE_OP(OpTitleCase, op_snake_case) \
+    case Instruction::Type::OpTitleCase:          \
+        return static_cast<Op::OpTitleCase const&>(instruction).lhs();
+        JS_ENUMERATE_COMMON_BINARY_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    default:
+        return {};
+    }
+}
+
+static OwnPtr<BasicBlock> fold_constants(BasicBlock const& block)
+{
+    // The values we know the accumulator and the other registers to hold at this point in the block.
+    // NOTE: Only Store and ConcatString write to registers other than the accumulator.
+    Optional<Value> accumulator;
+    HashMap<u32, Value> registers;
+
+    // Find out which instructions can be folded before building a new block, as most blocks don't have any.
+    Vector<Value> folded_values;
+    Vector<Instruction const*> folded_instructions;
+    for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it) {
+        auto const& instruction = *it;
+        switch (instruction.type()) {
+        case Instruction::Type::LoadImmediate:
+            accumulator = static_cast<Op::LoadImmediate const&>(instruction).value();
+            continue;
+        case Instruction::Type::Load:
+            accumulator = registers.get(static_cast<Op::Load const&>(instruction).src().index());
+            continue;
+        case Instruction::Type::Store: {
+            auto dst = static_cast<Op::Store const&>(instruction).dst().index();
+            if (accumulator.has_value())
+                registers.set(dst, *accumulator);
+            else
+                registers.remove(dst);
+            continue;
+        }
+        case Instruction::Type::ConcatString:
+            const_cast<Instruction&>(instruction).visit_registers([&](Register& lhs) { registers.remove(lhs.index()); });
+            break;
+        default:
+            break;
+        }
+
+        auto lhs = lhs_of_binary_operation(instruction);
+        if (lhs.has_value() && accumulator.has_value()) {
+            if (auto lhs_value = registers.get(lhs->index()); lhs_value.has_value()) {
+                if (auto result = fold_binary_operation(instruction.type(), *lhs_value, *accumulator); result.has_value()) {
+                    folded_instructions.append(&instruction);
+                    folded_values.append(*result);
+                    accumulator = *result;
+                    continue;
+                }
+            }
+        }
+
+        accumulator = {};
+    }
+
+    if (folded_instructions.is_empty())
+        return nullptr;
+
+    // NOTE: A LoadImmediate is larger than the binary operation it replaces.
+    auto new_block = BasicBlock::create(block.name(), block.size() + folded_instructions.size() * sizeof(Op::LoadImmediate));
+    size_t next_folded_instruction = 0;
+    for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it) {
+        auto const& instruction = *it;
+        if (next_folded_instruction < folded_instructions.size() && folded_instructions[next_folded_instruction] == &instruction) {
+            new (new_block->next_slot()) Op::LoadImmediate(folded_values[next_folded_instruction++]);
+            new_block->grow(sizeof(Op::LoadImmediate));
+        } else if (instruction.type() == Instruction::Type::NewBigInt) {
+            new (new_block->next_slot()) Op::NewBigInt(static_cast<Op::NewBigInt const&>(instruction));
+            new_block->grow(sizeof(Op::NewBigInt));
+        } else {
+            memcpy(new_block->next_slot(), &instruction, instruction.length());
+            new_block->grow(instruction.length());
+        }
+    }
+    return new_block;
+}
+
+void FoldConstants::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    auto& basic_blocks = executable.executable.basic_blocks;
+    for (size_t i = 0; i < basic_blocks.size(); ++i) {
+        auto new_block = fold_constants(basic_blocks[i]);
+        if (!new_block)
+            continue;
+
+        replace_block(executable, i, new_block.release_nonnull());
+    }
+
+    finished();
+}
+
+}
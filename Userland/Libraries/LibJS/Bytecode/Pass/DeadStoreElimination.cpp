@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Bitmap.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+static bool is_dead_store(Instruction const& instruction, Bitmap const& read_registers)
+{
+    if (instruction.type() != Instruction::Type::Store)
+        return false;
+    return !read_registers.get(static_cast<Op::Store const&>(instruction).dst().index());
+}
+
+void EliminateDeadStores::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    auto& basic_blocks = executable.executable.basic_blocks;
+
+    // Registers are only ever written by Store and ConcatString, so a Store to a register nothing reads is dead.
+    // NOTE: Register 0 is the accumulator, which the instructions and our callers read implicitly.
+    auto read_registers = Bitmap::create(executable.executable.number_of_registers, false).release_value_but_fixme_should_propagate_errors();
+    read_registers.set(Register::accumulator_index, true);
+    for (auto& block : basic_blocks) {
+        for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            if (instruction.type() == Instruction::Type::Store)
+                continue;
+            if (instruction.type() == Instruction::Type::NewArray) {
+                auto const& new_array = static_cast<Op::NewArray const&>(instruction);
+                if (new_array.element_count())
+                    read_registers.set_range<true, false>(new_array.start().index(), new_array.element_count());
+                continue;
+            }
+            instruction.visit_registers([&](Register& reg) { read_registers.set(reg.index(), true); });
+        }
+    }
+
+    for (size_t i = 0; i < basic_blocks.size(); ++i) {
+        auto const& old_block = basic_blocks[i];
+
+        bool has_dead_stores = false;
+        for (InstructionStreamIterator it { old_block.instruction_stream() }; !it.at_end() && !has_dead_stores; ++it)
+            has_dead_stores = is_dead_store(*it, read_registers);
+        if (!has_dead_stores)
+            continue;
+
+        auto new_block = BasicBlock::create(old_block.name(), old_block.size());
+        for (InstructionStreamIterator it { old_block.instruction_stream() }; !it.at_end(); ++it) {
+            auto const& instruction = *it;
+            if (is_dead_store(instruction, read_registers))
+                continue;
+            // FIXME: Op::NewBigInt is not trivially copyable, so we cant use
+            //        a simple memcpy to transfer them.
+            if (instruction.type() == Instruction::Type::NewBigInt) {
+                new (new_block->next_slot()) Op::NewBigInt(static_cast<Op::NewBigInt const&>(instruction));
+                new_block->grow(sizeof(Op::NewBigInt));
+            } else {
+                memcpy(new_block->next_slot(), &instruction, instruction.length());
+                new_block->grow(instruction.length());
+            }
+        }
+
+        // We will replace the old block, with a new one, so we need to replace all references,
+        // to the old one with the new one, including the ones the new block got from the old one.
+        auto& block_to_replace = *new_block;
+        for (auto& block : basic_blocks) {
+            for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it)
+                const_cast<Instruction&>(*it).replace_references(old_block, block_to_replace);
+        }
+        for (InstructionStreamIterator it { block_to_replace.instruction_stream() }; !it.at_end(); ++it)
+            const_cast<Instruction&>(*it).replace_references(old_block, block_to_replace);
+
+        basic_blocks.ptr_at(i) = move(new_block);
+    }
+
+    finished();
+}
+
+}
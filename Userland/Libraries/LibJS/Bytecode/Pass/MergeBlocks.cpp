@@ -8,6 +8,18 @@
 
 namespace JS::Bytecode::Passes {
 
+// NOTE: Only blocks created by the generator know their terminator, blocks created by earlier passes have to be searched.
+static Instruction const* find_terminator(BasicBlock const& block)
+{
+    if (block.is_terminated())
+        return block.terminator();
+    for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it) {
+        if ((*it).is_terminator())
+            return &*it;
+    }
+    return nullptr;
+}
+
 void MergeBlocks::perform(PassPipelineExecutable& executable)
 {
     started();
@@ -30,13 +42,18 @@ void MergeBlocks::perform(PassPipelineExecutable& executable)
         if (executable.exported_blocks->contains(*entry.value.begin()))
             continue;
 
-        if (entry.key->terminator()->type() != Instruction::Type::Jump)
+        if (*entry.value.begin() == &executable.executable.basic_blocks.first())
+            continue;
+
+        auto const* terminator = find_terminator(*entry.key);
+        if (!terminator || terminator->type() != Instruction::Type::Jump)
             continue;
 
         {
             InstructionStreamIterator it { entry.key->instruction_stream() };
             auto& first_instruction = *it;
-            if (first_instruction.type() == Instruction::Type::Jump) {
+            // NOTE: The entry block has to stay where it is, as execution always starts at the first block.
+            if (first_instruction.type() == Instruction::Type::Jump && entry.key != &executable.executable.basic_blocks.first()) {
                 auto const* replacing_block = &static_cast<Op::Jump const&>(first_instruction).true_target()->block();
                 if (replacing_block != entry.key) {
                     blocks_to_replace.set(entry.key, replacing_block);
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashMap.h>
+#include <AK/QuickSort.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+namespace {
+
+// The instructions between the first and last reference to a register, numbered in block order.
+struct LiveInterval {
+    size_t start { 0 };
+    size_t end { 0 };
+    size_t block_index { 0 };
+    bool is_local_to_block { true };
+    bool starts_with_store { false };
+
+    bool overlaps(LiveInterval const& other) const { return start <= other.end && end >= other.start; }
+};
+
+// A range of registers that has to stay contiguous, because a NewArray refers to it as a whole.
+// Every other register is in a group of its own.
+struct RegisterGroup {
+    u32 first_register { 0 };
+    u32 register_count { 1 };
+    LiveInterval interval;
+};
+
+}
+
+template<typename Callback>
+static void for_each_referenced_register(Instruction& instruction, Callback callback)
+{
+    if (instruction.type() == Instruction::Type::NewArray) {
+        auto const& new_array = static_cast<Op::NewArray const&>(instruction);
+        for (size_t i = 0; i < new_array.element_count(); ++i)
+            callback(new_array.start().index() + i);
+        return;
+    }
+    instruction.visit_registers([&](Register& reg) { callback(reg.index()); });
+}
+
+static Vector<BasicBlock const*, 2> successors_of(Instruction const& terminator)
+{
+    Vector<BasicBlock const*, 2> successors;
+    switch (terminator.type()) {
+    case Instruction::Type::Jump:
+    case Instruction::Type::JumpConditional:
+    case Instruction::Type::JumpNullish:
+    case Instruction::Type::JumpUndefined: {
+        auto const& jump = static_cast<Op::Jump const&>(terminator);
+        if (jump.true_target().has_value())
+            successors.append(&jump.true_target()->block());
+        if (jump.false_target().has_value())
+            successors.append(&jump.false_target()->block());
+        break;
+    }
+    case Instruction::Type::Yield: {
+        auto const& continuation = static_cast<Op::Yield const&>(terminator).continuation();
+        if (continuation.has_value())
+            successors.append(&continuation->block());
+        break;
+    }
+    default:
+        break;
+    }
+    return successors;
+}
+
+void AllocateRegisters::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    auto& basic_blocks = executable.executable.basic_blocks;
+    auto register_count = executable.executable.number_of_registers;
+
+    // Number all instructions in block order, and find the interval in which each register is referenced.
+    Vector<Optional<LiveInterval>> intervals;
+    intervals.resize(register_count);
+    Vector<AK::Array<u32, 2>> array_ranges;
+    HashMap<BasicBlock const*, size_t> block_starts;
+    Vector<size_t> block_ends;
+    Vector<Vector<BasicBlock const*, 2>> block_successors;
+
+    size_t position = 0;
+    for (size_t block_index = 0; block_index < basic_blocks.size(); ++block_index) {
+        auto& block = basic_blocks[block_index];
+        block_starts.set(&block, position);
+        block_successors.empend();
+
+        for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it, ++position) {
+            auto& instruction = const_cast<Instruction&>(*it);
+
+            // FIXME: Registers are live across any instruction in a try block that may throw to its handler or
+            //        finalizer, which isn't a control flow edge we know about here. Until it is, leave such
+            //        executables alone.
+            if (instruction.type() == Instruction::Type::EnterUnwindContext || instruction.type() == Instruction::Type::ContinuePendingUnwind) {
+                finished();
+                return;
+            }
+
+            if (instruction.type() == Instruction::Type::NewArray) {
+                auto const& new_array = static_cast<Op::NewArray const&>(instruction);
+                if (new_array.element_count())
+                    array_ranges.append({ new_array.start().index(), new_array.end().index() });
+            }
+
+            for_each_referenced_register(instruction, [&](u32 reg) {
+                auto& interval = intervals[reg];
+                if (!interval.has_value()) {
+                    interval = LiveInterval { position, position, block_index, true, instruction.type() == Instruction::Type::Store };
+                    return;
+                }
+                interval->end = position;
+                if (interval->block_index != block_index)
+                    interval->is_local_to_block = false;
+            });
+
+            if (instruction.is_terminator())
+                block_successors.last() = successors_of(instruction);
+        }
+        block_ends.append(position);
+    }
+
+    // A register that is referenced both inside and outside of a loop (or isn't written first thing in the block that
+    // references it) may carry its value around the back edge, so it has to stay live for the whole loop.
+    // NOTE: This is conservative, but cheap: a proper liveness analysis would let us reuse more registers in loops.
+    Vector<LiveInterval> loops;
+    for (size_t block_index = 0; block_index < basic_blocks.size(); ++block_index) {
+        for (auto const* successor : block_successors[block_index]) {
+            auto successor_start = block_starts.get(successor);
+            if (successor_start.has_value() && *successor_start <= block_starts.get(&basic_blocks[block_index]).value())
+                loops.append({ *successor_start, block_ends[block_index] - 1 });
+        }
+    }
+
+    auto extend_over_loops = [&](LiveInterval& interval) {
+        if (interval.is_local_to_block && interval.starts_with_store)
+            return;
+        bool did_extend = true;
+        while (did_extend) {
+            did_extend = false;
+            for (auto const& loop : loops) {
+                if (!interval.overlaps(loop) || (interval.start <= loop.start && interval.end >= loop.end))
+                    continue;
+                interval.start = min(interval.start, loop.start);
+                interval.end = max(interval.end, loop.end);
+                did_extend = true;
+            }
+        }
+    };
+
+    // Group the registers NewArray refers to, merging overlapping ranges.
+    quick_sort(array_ranges, [](auto const& a, auto const& b) { return a[0] < b[0]; });
+    Vector<RegisterGroup> groups;
+    Vector<Optional<size_t>> group_of_register;
+    group_of_register.resize(register_count);
+    for (auto const& range : array_ranges) {
+        if (!groups.is_empty() && range[0] < groups.last().first_register + groups.last().register_count) {
+            auto& group = groups.last();
+            group.register_count = max(group.register_count, range[1] - group.first_register + 1);
+            continue;
+        }
+        groups.append({ range[0], range[1] - range[0] + 1, {} });
+    }
+    for (size_t group_index = 0; group_index < groups.size(); ++group_index) {
+        auto& group = groups[group_index];
+        bool has_interval = false;
+        for (u32 reg = group.first_register; reg < group.first_register + group.register_count; ++reg) {
+            group_of_register[reg] = group_index;
+            if (!intervals[reg].has_value())
+                continue;
+            if (!has_interval) {
+                group.interval = *intervals[reg];
+                has_interval = true;
+                continue;
+            }
+            group.interval.start = min(group.interval.start, intervals[reg]->start);
+            group.interval.end = max(group.interval.end, intervals[reg]->end);
+            group.interval.is_local_to_block &= intervals[reg]->is_local_to_block && intervals[reg]->block_index == group.interval.block_index;
+            group.interval.starts_with_store &= intervals[reg]->starts_with_store;
+        }
+    }
+    for (u32 reg = Register::accumulator_index + 1; reg < register_count; ++reg) {
+        if (intervals[reg].has_value() && !group_of_register[reg].has_value())
+            groups.append({ reg, 1, *intervals[reg] });
+    }
+    for (auto& group : groups)
+        extend_over_loops(group.interval);
+
+    // Linear scan: hand out registers in the order their intervals start, reusing the ones whose intervals ended.
+    // NOTE: Ranges have to stay contiguous, so they always get fresh registers.
+    quick_sort(groups, [](auto const& a, auto const& b) { return a.interval.start < b.interval.start; });
+    Vector<u32> new_register_indices;
+    new_register_indices.resize(register_count);
+    Vector<u32> free_registers;
+    Vector<RegisterGroup const*> active_groups;
+    u32 next_register = Register::accumulator_index + 1;
+
+    for (auto const& group : groups) {
+        active_groups.remove_all_matching([&](auto const* active_group) {
+            if (active_group->interval.end >= group.interval.start)
+                return false;
+            if (active_group->register_count == 1)
+                free_registers.append(new_register_indices[active_group->first_register]);
+            return true;
+        });
+
+        u32 new_first_register;
+        if (group.register_count == 1 && !free_registers.is_empty()) {
+            new_first_register = free_registers.take_last();
+        } else {
+            new_first_register = next_register;
+            next_register += group.register_count;
+        }
+
+        for (u32 i = 0; i < group.register_count; ++i)
+            new_register_indices[group.first_register + i] = new_first_register + i;
+        active_groups.append(&group);
+    }
+
+    for (auto& block : basic_blocks) {
+        for (InstructionStreamIterator it { block.instruction_stream() }; !it.at_end(); ++it) {
+            const_cast<Instruction&>(*it).visit_registers([&](Register& reg) {
+                if (reg.index() != Register::accumulator_index)
+                    reg = Register { new_register_indices[reg.index()] };
+            });
+        }
+    }
+
+    executable.executable.number_of_registers = next_register;
+
+    finished();
+}
+
+}
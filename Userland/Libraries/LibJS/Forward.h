@@ -154,6 +154,7 @@ class Accessor;
 struct AsyncGeneratorRequest;
 class BigInt;
 class BoundFunction;
+struct CacheablePropertyMetadata;
 class Cell;
 class CellAllocator;
 class ClassExpression;
@@ -199,6 +200,7 @@ class PropertyDescriptor;
 class PropertyKey;
 class Realm;
 class Reference;
+class SamplingProfiler;
 class ScopeNode;
 class Script;
 class Shape;
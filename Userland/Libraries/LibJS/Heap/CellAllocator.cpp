@@ -21,6 +21,7 @@ Cell* CellAllocator::allocate_cell(Heap& heap)
 {
     if (m_usable_blocks.is_empty()) {
         auto block = HeapBlock::create_with_cell_size(heap, m_cell_size);
+        heap.did_create_heap_block({}, *block);
         m_usable_blocks.append(*block.leak_ptr());
     }
 
@@ -36,6 +37,7 @@ void CellAllocator::block_did_become_empty(Badge<Heap>, HeapBlock& block)
 {
     auto& heap = block.heap();
     block.m_list_node.remove();
+    heap.did_destroy_heap_block({}, block);
     // NOTE: HeapBlocks are managed by the BlockAllocator, so we don't want to `delete` the block here.
     block.~HeapBlock();
     heap.block_allocator().deallocate_block(&block);
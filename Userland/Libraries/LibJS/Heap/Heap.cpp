@@ -77,7 +77,6 @@ Cell* Heap::allocate_cell(size_t size)
     if (should_collect_on_every_allocation()) {
         collect_garbage();
     } else if (m_allocations_since_last_gc > m_max_allocations_between_gc) {
-        m_allocations_since_last_gc = 0;
         collect_garbage();
     } else {
         ++m_allocations_since_last_gc;
@@ -98,20 +97,52 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
 #endif
 
     Core::ElapsedTimer collection_measurement_timer;
-    if (print_report)
+    Core::ElapsedTimer phase_measurement_timer;
+    PhaseTimes phase_times;
+    if (print_report) {
         collection_measurement_timer.start();
+        phase_measurement_timer.start();
+    }
+    auto end_phase = [&](Time& phase_time) {
+        if (!print_report)
+            return;
+        phase_time = phase_measurement_timer.elapsed_time();
+        phase_measurement_timer.start();
+    };
 
     if (collection_type == CollectionType::CollectGarbage) {
         if (m_gc_deferrals) {
             m_should_gc_when_deferral_ends = true;
             return;
         }
-        HashTable<Cell*> roots;
-        gather_roots(roots);
-        mark_live_cells(roots);
+        m_allocations_since_last_gc = 0;
+        m_roots.clear_with_capacity();
+        gather_roots(m_roots);
+        end_phase(phase_times.gather_roots);
+        mark_live_cells(m_roots);
+        m_roots.clear_with_capacity();
+        end_phase(phase_times.mark);
     }
     finalize_unmarked_cells();
-    sweep_dead_cells(print_report, collection_measurement_timer);
+    end_phase(phase_times.finalize);
+    sweep_dead_cells();
+    end_phase(phase_times.sweep);
+
+    if (print_report)
+        print_collection_report(collection_measurement_timer.elapsed_time(), phase_times);
+
+    m_dead_cells.clear_with_capacity();
+    m_empty_blocks.clear_with_capacity();
+    m_full_blocks_that_became_usable.clear_with_capacity();
+}
+
+void Heap::did_become_idle()
+{
+    if (m_collecting_garbage || m_gc_deferrals)
+        return;
+    if (m_allocations_since_last_gc < m_max_allocations_between_gc / idle_collection_allocation_divisor)
+        return;
+    collect_garbage();
 }
 
 void Heap::gather_roots(HashTable<Cell*>& roots)
@@ -132,6 +163,24 @@ void Heap::gather_roots(HashTable<Cell*>& roots)
     }
 }
 
+void Heap::add_possible_conservative_root(HashTable<Cell*>& roots, FlatPtr possible_pointer)
+{
+    if (!possible_pointer)
+        return;
+    dbgln_if(HEAP_DEBUG, "  ? {}", (void const*)possible_pointer);
+    auto* possible_heap_block = HeapBlock::from_cell(reinterpret_cast<Cell const*>(possible_pointer));
+    if (!m_live_heap_blocks.contains(possible_heap_block))
+        return;
+    if (auto* cell = possible_heap_block->cell_from_possible_pointer(possible_pointer)) {
+        if (cell->state() == Cell::State::Live) {
+            dbgln_if(HEAP_DEBUG, "  ?-> {}", (void const*)cell);
+            roots.set(cell);
+        } else {
+            dbgln_if(HEAP_DEBUG, "  #-> {}", (void const*)cell);
+        }
+    }
+}
+
 __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(HashTable<Cell*>& roots)
 {
     FlatPtr dummy;
@@ -141,24 +190,24 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
     jmp_buf buf;
     setjmp(buf);
 
-    HashTable<FlatPtr> possible_pointers;
-
     auto* raw_jmp_buf = reinterpret_cast<FlatPtr const*>(buf);
 
+    // NOTE: Candidates are looked up right away instead of being collected into a set first;
+    //       the same cell showing up more than once only costs another lookup in `roots`.
     auto add_possible_value = [&](FlatPtr data) {
         if constexpr (sizeof(FlatPtr*) == sizeof(Value)) {
             // Because Value stores pointers in non-canonical form we have to check if the top bytes
             // match any pointer-backed tag, in that case we have to extract the pointer to its
             // canonical form and add that as a possible pointer.
             if ((data & SHIFTED_IS_CELL_PATTERN) == SHIFTED_IS_CELL_PATTERN)
-                possible_pointers.set(Value::extract_pointer_bits(data));
+                add_possible_conservative_root(roots, Value::extract_pointer_bits(data));
             else
-                possible_pointers.set(data);
+                add_possible_conservative_root(roots, data);
         } else {
             static_assert((sizeof(Value) % sizeof(FlatPtr*)) == 0);
             // In the 32-bit case we will look at the top and bottom part of Value separately we just
             // add both the upper and lower bytes as possible pointers.
-            possible_pointers.set(data);
+            add_possible_conservative_root(roots, data);
         }
     };
 
@@ -182,29 +231,6 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
             }
         }
     }
-
-    HashTable<HeapBlock*> all_live_heap_blocks;
-    for_each_block([&](auto& block) {
-        all_live_heap_blocks.set(&block);
-        return IterationDecision::Continue;
-    });
-
-    for (auto possible_pointer : possible_pointers) {
-        if (!possible_pointer)
-            continue;
-        dbgln_if(HEAP_DEBUG, "  ? {}", (void const*)possible_pointer);
-        auto* possible_heap_block = HeapBlock::from_cell(reinterpret_cast<Cell const*>(possible_pointer));
-        if (all_live_heap_blocks.contains(possible_heap_block)) {
-            if (auto* cell = possible_heap_block->cell_from_possible_pointer(possible_pointer)) {
-                if (cell->state() == Cell::State::Live) {
-                    dbgln_if(HEAP_DEBUG, "  ?-> {}", (void const*)cell);
-                    roots.set(cell);
-                } else {
-                    dbgln_if(HEAP_DEBUG, "  #-> {}", (void const*)cell);
-                }
-            }
-        }
-    }
 }
 
 class MarkingVisitor final : public Cell::Visitor {
@@ -259,58 +285,54 @@ bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
 
 void Heap::finalize_unmarked_cells()
 {
-    for_each_block([&](auto& block) {
-        block.template for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
-            if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell))
-                cell->finalize();
-        });
-        return IterationDecision::Continue;
-    });
-}
-
-void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measurement_timer)
-{
-    dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
-    Vector<HeapBlock*, 32> empty_blocks;
-    Vector<HeapBlock*, 32> full_blocks_that_became_usable;
-
-    size_t collected_cells = 0;
-    size_t live_cells = 0;
-    size_t collected_cell_bytes = 0;
-    size_t live_cell_bytes = 0;
-
+    // NOTE: This is the only pass over every cell in the heap. Live cells are unmarked for the next collection right
+    //       away, and dead cells are remembered so sweep_dead_cells() only has to look at those.
+    m_live_cell_count = 0;
+    m_live_cell_bytes = 0;
     for_each_block([&](auto& block) {
         bool block_has_live_cells = false;
-        bool block_was_full = block.is_full();
+        bool block_has_dead_cells = false;
         block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
             if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell)) {
-                dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
-                block.deallocate(cell);
-                ++collected_cells;
-                collected_cell_bytes += block.cell_size();
+                cell->finalize();
+                m_dead_cells.append(cell);
+                block_has_dead_cells = true;
             } else {
                 cell->set_marked(false);
                 block_has_live_cells = true;
-                ++live_cells;
-                live_cell_bytes += block.cell_size();
+                ++m_live_cell_count;
+                m_live_cell_bytes += block.cell_size();
             }
         });
         if (!block_has_live_cells)
-            empty_blocks.append(&block);
-        else if (block_was_full != block.is_full())
-            full_blocks_that_became_usable.append(&block);
+            m_empty_blocks.append(&block);
+        else if (block_has_dead_cells && block.is_full())
+            m_full_blocks_that_became_usable.append(&block);
         return IterationDecision::Continue;
     });
+}
+
+void Heap::sweep_dead_cells()
+{
+    dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
+
+    m_collected_cell_bytes = 0;
+    for (auto* cell : m_dead_cells) {
+        dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
+        auto* block = HeapBlock::from_cell(cell);
+        m_collected_cell_bytes += block->cell_size();
+        block->deallocate(cell);
+    }
 
     for (auto& weak_container : m_weak_containers)
         weak_container.remove_dead_cells({});
 
-    for (auto* block : empty_blocks) {
+    for (auto* block : m_empty_blocks) {
         dbgln_if(HEAP_DEBUG, " - HeapBlock empty @ {}: cell_size={}", block, block->cell_size());
         allocator_for_size(block->cell_size()).block_did_become_empty({}, *block);
     }
 
-    for (auto* block : full_blocks_that_became_usable) {
+    for (auto* block : m_full_blocks_that_became_usable) {
         dbgln_if(HEAP_DEBUG, " - HeapBlock usable again @ {}: cell_size={}", block, block->cell_size());
         allocator_for_size(block->cell_size()).block_did_become_usable({}, *block);
     }
@@ -321,24 +343,38 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
             return IterationDecision::Continue;
         });
     }
+}
 
-    if (print_report) {
-        Time const time_spent = measurement_timer.elapsed_time();
-        size_t live_block_count = 0;
-        for_each_block([&](auto&) {
-            ++live_block_count;
-            return IterationDecision::Continue;
-        });
+void Heap::print_collection_report(Time time_spent, PhaseTimes const& phase_times)
+{
+    size_t live_block_count = 0;
+    for_each_block([&](auto&) {
+        ++live_block_count;
+        return IterationDecision::Continue;
+    });
 
-        dbgln("Garbage collection report");
-        dbgln("=============================================");
-        dbgln("     Time spent: {} ms", time_spent.to_milliseconds());
-        dbgln("     Live cells: {} ({} bytes)", live_cells, live_cell_bytes);
-        dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
-        dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
-        dbgln("   Freed blocks: {} ({} bytes)", empty_blocks.size(), empty_blocks.size() * HeapBlock::block_size);
-        dbgln("=============================================");
-    }
+    dbgln("Garbage collection report");
+    dbgln("=============================================");
+    dbgln("     Time spent: {} ms", time_spent.to_milliseconds());
+    dbgln("   Gather roots: {} us", phase_times.gather_roots.to_microseconds());
+    dbgln("           Mark: {} us", phase_times.mark.to_microseconds());
+    dbgln("       Finalize: {} us", phase_times.finalize.to_microseconds());
+    dbgln("          Sweep: {} us", phase_times.sweep.to_microseconds());
+    dbgln("     Live cells: {} ({} bytes)", m_live_cell_count, m_live_cell_bytes);
+    dbgln("Collected cells: {} ({} bytes)", m_dead_cells.size(), m_collected_cell_bytes);
+    dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
+    dbgln("   Freed blocks: {} ({} bytes)", m_empty_blocks.size(), m_empty_blocks.size() * HeapBlock::block_size);
+    dbgln("=============================================");
+}
+
+void Heap::did_create_heap_block(Badge<CellAllocator>, HeapBlock& block)
+{
+    m_live_heap_blocks.set(&block);
+}
+
+void Heap::did_destroy_heap_block(Badge<CellAllocator>, HeapBlock& block)
+{
+    m_live_heap_blocks.remove(&block);
 }
 
 void Heap::did_create_handle(Badge<HandleImpl>, HandleImpl& impl)
@@ -11,6 +11,7 @@
 #include <AK/IntrusiveList.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/Time.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
@@ -57,6 +58,10 @@ public:
 
     void collect_garbage(CollectionType = CollectionType::CollectGarbage, bool print_report = false);
 
+    // Called by the embedder when it has nothing else to do. Collects early if enough has been allocated since
+    // the last collection, so the pause falls between tasks instead of in the middle of running script.
+    void did_become_idle();
+
     VM& vm() { return m_vm; }
 
     bool should_collect_on_every_allocation() const { return m_should_collect_on_every_allocation; }
@@ -76,8 +81,20 @@ public:
 
     BlockAllocator& block_allocator() { return m_block_allocator; }
 
+    void did_create_heap_block(Badge<CellAllocator>, HeapBlock&);
+    void did_destroy_heap_block(Badge<CellAllocator>, HeapBlock&);
+
     void uproot_cell(Cell* cell);
 
+    template<typename Callback>
+    void for_each_live_cell(Callback callback)
+    {
+        for_each_block([&](auto& block) {
+            block.template for_each_cell_in_state<Cell::State::Live>(callback);
+            return IterationDecision::Continue;
+        });
+    }
+
 private:
     static bool cell_must_survive_garbage_collection(Cell const&);
 
@@ -85,9 +102,18 @@ private:
 
     void gather_roots(HashTable<Cell*>&);
     void gather_conservative_roots(HashTable<Cell*>&);
+    void add_possible_conservative_root(HashTable<Cell*>&, FlatPtr);
     void mark_live_cells(HashTable<Cell*> const& live_cells);
     void finalize_unmarked_cells();
-    void sweep_dead_cells(bool print_report, Core::ElapsedTimer const&);
+    void sweep_dead_cells();
+
+    struct PhaseTimes {
+        Time gather_roots;
+        Time mark;
+        Time finalize;
+        Time sweep;
+    };
+    void print_collection_report(Time time_spent, PhaseTimes const&);
 
     CellAllocator& allocator_for_size(size_t);
 
@@ -103,12 +129,28 @@ private:
     size_t m_max_allocations_between_gc { 100000 };
     size_t m_allocations_since_last_gc { 0 };
 
+    // Only collect while idle once this much of the regular allocation budget has been used up.
+    static constexpr size_t idle_collection_allocation_divisor = 4;
+
     bool m_should_collect_on_every_allocation { false };
 
     VM& m_vm;
 
     Vector<NonnullOwnPtr<CellAllocator>> m_allocators;
 
+    // Kept up to date as blocks come and go, so the conservative scan doesn't have to rebuild it for every collection.
+    HashTable<HeapBlock*> m_live_heap_blocks;
+
+    // Reused across collections to keep their capacity.
+    HashTable<Cell*> m_roots;
+    Vector<Cell*> m_dead_cells;
+    Vector<HeapBlock*> m_empty_blocks;
+    Vector<HeapBlock*> m_full_blocks_that_became_usable;
+
+    size_t m_live_cell_count { 0 };
+    size_t m_live_cell_bytes { 0 };
+    size_t m_collected_cell_bytes { 0 };
+
     HandleImpl::List m_handles;
     MarkedVectorBase::List m_marked_vectors;
     WeakContainer::List m_weak_containers;
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Vector.h>
+
+namespace JS::JIT {
+
+// Just enough of an x86_64 assembler for the baseline JIT compiler.
+struct Assembler {
+    explicit Assembler(Vector<u8>& output)
+        : m_output(output)
+    {
+    }
+
+    Vector<u8>& m_output;
+
+    enum class Reg {
+        RAX = 0,
+        RCX = 1,
+        RDX = 2,
+        RBX = 3,
+        RSP = 4,
+        RBP = 5,
+        RSI = 6,
+        RDI = 7,
+        R8 = 8,
+        R9 = 9,
+        R10 = 10,
+        R11 = 11,
+        R12 = 12,
+        R13 = 13,
+        R14 = 14,
+        R15 = 15,
+    };
+
+    // The condition codes of Jcc and SETcc.
+    enum class Condition {
+        Overflow = 0x0,
+        EqualTo = 0x4,
+        NotEqualTo = 0x5,
+        SignedLessThan = 0xC,
+        SignedGreaterThanOrEqualTo = 0xD,
+        SignedLessThanOrEqualTo = 0xE,
+        SignedGreaterThan = 0xF,
+    };
+
+    // A position in the code that jumps can be emitted to before it is known.
+    struct Label {
+        Optional<size_t> offset_of_label_in_instruction_stream;
+        Vector<size_t> jump_displacement_offsets;
+
+        void add_jump(Assembler& assembler, size_t displacement_offset)
+        {
+            jump_displacement_offsets.append(displacement_offset);
+            if (offset_of_label_in_instruction_stream.has_value())
+                link_jump(assembler, displacement_offset);
+        }
+
+        void link(Assembler& assembler)
+        {
+            VERIFY(!offset_of_label_in_instruction_stream.has_value());
+            offset_of_label_in_instruction_stream = assembler.m_output.size();
+            for (auto displacement_offset : jump_displacement_offsets)
+                link_jump(assembler, displacement_offset);
+        }
+
+    private:
+        void link_jump(Assembler& assembler, size_t displacement_offset)
+        {
+            // Displacements are relative to the end of the jump, which is where the 32-bit displacement ends.
+            auto displacement = static_cast<i32>(*offset_of_label_in_instruction_stream - (displacement_offset + 4));
+            for (size_t i = 0; i < 4; ++i)
+                assembler.m_output[displacement_offset + i] = (displacement >> (i * 8)) & 0xff;
+        }
+    };
+
+    static constexpr u8 encode_reg(Reg reg) { return to_underlying(reg) & 7; }
+    static constexpr bool is_extended(Reg reg) { return to_underlying(reg) >= 8; }
+
+    void emit8(u8 value) { m_output.append(value); }
+
+    void emit32(u32 value)
+    {
+        for (size_t i = 0; i < 4; ++i)
+            emit8((value >> (i * 8)) & 0xff);
+    }
+
+    void emit64(u64 value)
+    {
+        for (size_t i = 0; i < 8; ++i)
+            emit8((value >> (i * 8)) & 0xff);
+    }
+
+    void emit_rex(bool is_64_bit, Reg reg, Reg rm)
+    {
+        u8 rex = 0x40 | (is_64_bit ? 0x08 : 0) | (is_extended(reg) ? 0x04 : 0) | (is_extended(rm) ? 0x01 : 0);
+        if (rex != 0x40)
+            emit8(rex);
+    }
+
+    // ModR/M for a register operand and either a register, or memory at a base register plus a 32-bit displacement.
+    void emit_modrm_reg(Reg reg, Reg rm) { emit8(0xc0 | (encode_reg(reg) << 3) | encode_reg(rm)); }
+
+    void emit_modrm_mem(Reg reg, Reg base, i32 displacement)
+    {
+        emit8(0x80 | (encode_reg(reg) << 3) | encode_reg(base));
+        // RSP and R12 can only be used as a base through a SIB byte.
+        if (encode_reg(base) == encode_reg(Reg::RSP))
+            emit8(0x24);
+        emit32(displacement);
+    }
+
+    // mov dst, src
+    void mov(Reg dst, Reg src)
+    {
+        emit_rex(true, src, dst);
+        emit8(0x89);
+        emit_modrm_reg(src, dst);
+    }
+
+    // mov dst, imm64
+    void mov(Reg dst, u64 immediate)
+    {
+        emit_rex(true, Reg::RAX, dst);
+        emit8(0xb8 | encode_reg(dst));
+        emit64(immediate);
+    }
+
+    // mov dst, [base + displacement]
+    void load(Reg dst, Reg base, i32 displacement)
+    {
+        emit_rex(true, dst, base);
+        emit8(0x8b);
+        emit_modrm_mem(dst, base, displacement);
+    }
+
+    // mov [base + displacement], src
+    void store(Reg base, i32 displacement, Reg src)
+    {
+        emit_rex(true, src, base);
+        emit8(0x89);
+        emit_modrm_mem(src, base, displacement);
+    }
+
+    // shr reg, amount
+    void shift_right(Reg reg, u8 amount)
+    {
+        emit_rex(true, Reg::RAX, reg);
+        emit8(0xc1);
+        emit_modrm_reg(static_cast<Reg>(5), reg);
+        emit8(amount);
+    }
+
+    // cmp lhs32, imm32
+    void compare32(Reg lhs, u32 immediate)
+    {
+        emit_rex(false, Reg::RAX, lhs);
+        emit8(0x81);
+        emit_modrm_reg(static_cast<Reg>(7), lhs);
+        emit32(immediate);
+    }
+
+    // cmp lhs32, rhs32
+    void compare32(Reg lhs, Reg rhs)
+    {
+        emit_rex(false, rhs, lhs);
+        emit8(0x39);
+        emit_modrm_reg(rhs, lhs);
+    }
+
+    // test lhs, rhs
+    void test(Reg lhs, Reg rhs)
+    {
+        emit_rex(true, rhs, lhs);
+        emit8(0x85);
+        emit_modrm_reg(rhs, lhs);
+    }
+
+    // test lhs32, rhs32
+    void test32(Reg lhs, Reg rhs)
+    {
+        emit_rex(false, rhs, lhs);
+        emit8(0x85);
+        emit_modrm_reg(rhs, lhs);
+    }
+
+    // Two-operand 32-bit arithmetic, dst = dst op src. These zero the upper half of dst.
+    void add32(Reg dst, Reg src) { emit_arithmetic32(0x01, dst, src); }
+    void sub32(Reg dst, Reg src) { emit_arithmetic32(0x29, dst, src); }
+    void and32(Reg dst, Reg src) { emit_arithmetic32(0x21, dst, src); }
+    void or32(Reg dst, Reg src) { emit_arithmetic32(0x09, dst, src); }
+    void xor32(Reg dst, Reg src) { emit_arithmetic32(0x31, dst, src); }
+
+    void imul32(Reg dst, Reg src)
+    {
+        emit_rex(false, dst, src);
+        emit8(0x0f);
+        emit8(0xaf);
+        emit_modrm_reg(dst, src);
+    }
+
+    // add dst32, imm8
+    void add32(Reg dst, i8 immediate)
+    {
+        emit_rex(false, Reg::RAX, dst);
+        emit8(0x83);
+        emit_modrm_reg(Reg::RAX, dst);
+        emit8(static_cast<u8>(immediate));
+    }
+
+    // or dst, src
+    void or64(Reg dst, Reg src)
+    {
+        emit_rex(true, src, dst);
+        emit8(0x09);
+        emit_modrm_reg(src, dst);
+    }
+
+    // setcc dst8; movzx dst32, dst8
+    void set_if(Condition condition, Reg dst)
+    {
+        // A REX prefix makes the low byte of RSI, RDI, RSP and RBP addressable instead of AH etc.
+        emit8(0x40 | (is_extended(dst) ? 0x01 : 0));
+        emit8(0x0f);
+        emit8(0x90 | to_underlying(condition));
+        emit_modrm_reg(Reg::RAX, dst);
+
+        emit8(0x40 | (is_extended(dst) ? 0x05 : 0));
+        emit8(0x0f);
+        emit8(0xb6);
+        emit_modrm_reg(dst, dst);
+    }
+
+    void jump(Label& label)
+    {
+        emit8(0xe9);
+        emit32(0);
+        label.add_jump(*this, m_output.size() - 4);
+    }
+
+    void jump_if(Condition condition, Label& label)
+    {
+        emit8(0x0f);
+        emit8(0x80 | to_underlying(condition));
+        emit32(0);
+        label.add_jump(*this, m_output.size() - 4);
+    }
+
+    // jmp reg
+    void jump(Reg target)
+    {
+        emit_rex(false, Reg::RAX, target);
+        emit8(0xff);
+        emit_modrm_reg(static_cast<Reg>(4), target);
+    }
+
+    // Calls the function through RAX, which the callee may clobber anyway.
+    void native_call(void* callee)
+    {
+        mov(Reg::RAX, reinterpret_cast<FlatPtr>(callee));
+        emit8(0xff);
+        emit_modrm_reg(static_cast<Reg>(2), Reg::RAX);
+    }
+
+    void push(Reg reg)
+    {
+        emit_rex(false, Reg::RAX, reg);
+        emit8(0x50 | encode_reg(reg));
+    }
+
+    void pop(Reg reg)
+    {
+        emit_rex(false, Reg::RAX, reg);
+        emit8(0x58 | encode_reg(reg));
+    }
+
+    void ret() { emit8(0xc3); }
+
+private:
+    void emit_arithmetic32(u8 opcode, Reg dst, Reg src)
+    {
+        emit_rex(false, src, dst);
+        emit8(opcode);
+        emit_modrm_reg(src, dst);
+    }
+};
+
+}
@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/JIT/Compiler.h>
+#include <LibJS/Runtime/Value.h>
+
+namespace JS::JIT {
+
+Compiler::Compiler(Bytecode::Executable const& bytecode_executable)
+    : m_bytecode_executable(bytecode_executable)
+{
+}
+
+bool Compiler::can_compile(Bytecode::Executable const& bytecode_executable)
+{
+    for (auto& block : bytecode_executable.basic_blocks) {
+        for (Bytecode::InstructionStreamIterator it(block.instruction_stream()); !it.at_end(); ++it) {
+            switch ((*it).type()) {
+            // These jump to handlers, finalizers or continuations through the interpreter's own state.
+            case Bytecode::Instruction::Type::EnterUnwindContext:
+            case Bytecode::Instruction::Type::LeaveUnwindContext:
+            case Bytecode::Instruction::Type::ContinuePendingUnwind:
+            case Bytecode::Instruction::Type::Yield:
+                return false;
+            default:
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+#if ARCH(X86_64)
+
+using Reg = Assembler::Reg;
+
+// The registers the compiled code keeps its state in. They're callee-saved, so calls into C++ leave them alone.
+static constexpr auto REGISTER_FILE_BASE = Reg::RBX;
+static constexpr auto INTERPRETER = Reg::R12;
+static constexpr auto EXCEPTION_SLOT = Reg::R13;
+
+static_assert(sizeof(Value) == sizeof(u64));
+
+static u64 cxx_execute_instruction(Bytecode::Interpreter* interpreter, Bytecode::Instruction const* instruction, Value* exception)
+{
+    auto result = instruction->execute(*interpreter);
+    if (!result.is_error())
+        return 0;
+    *exception = *result.throw_completion().value();
+    return 1;
+}
+
+static u64 cxx_to_boolean(Value const* value)
+{
+    return value->to_boolean();
+}
+
+void Compiler::load_register(Reg dst, Bytecode::Register src)
+{
+    m_assembler.load(dst, REGISTER_FILE_BASE, src.index() * sizeof(Value));
+}
+
+void Compiler::store_register(Bytecode::Register dst, Reg src)
+{
+    m_assembler.store(REGISTER_FILE_BASE, dst.index() * sizeof(Value), src);
+}
+
+void Compiler::branch_if_not_int32(Reg reg, Assembler::Label& label)
+{
+    m_assembler.mov(Reg::RDX, reg);
+    m_assembler.shift_right(Reg::RDX, TAG_SHIFT);
+    m_assembler.compare32(Reg::RDX, INT32_TAG);
+    m_assembler.jump_if(Assembler::Condition::NotEqualTo, label);
+}
+
+Assembler::Label& Compiler::label_for(Bytecode::Label const& label)
+{
+    return m_block_labels[*m_block_indices.get(&label.block())];
+}
+
+void Compiler::compile_prologue()
+{
+    // The stack is 16-byte aligned again after pushing RBP and an even number of registers, as calls expect it to be.
+    m_assembler.push(Reg::RBP);
+    m_assembler.mov(Reg::RBP, Reg::RSP);
+    m_assembler.push(REGISTER_FILE_BASE);
+    m_assembler.push(INTERPRETER);
+    m_assembler.push(EXCEPTION_SLOT);
+    m_assembler.push(Reg::R14);
+
+    m_assembler.mov(INTERPRETER, Reg::RDI);
+    m_assembler.mov(REGISTER_FILE_BASE, Reg::RSI);
+    m_assembler.mov(EXCEPTION_SLOT, Reg::RDX);
+    m_assembler.jump(Reg::RCX);
+}
+
+void Compiler::compile_epilogue()
+{
+    Assembler::Label return_status;
+
+    m_exit.link(m_assembler);
+    m_assembler.mov(Reg::RAX, static_cast<u64>(0));
+    m_assembler.jump(return_status);
+
+    m_exit_with_exception.link(m_assembler);
+    m_assembler.mov(Reg::RAX, static_cast<u64>(1));
+
+    return_status.link(m_assembler);
+    m_assembler.pop(Reg::R14);
+    m_assembler.pop(EXCEPTION_SLOT);
+    m_assembler.pop(INTERPRETER);
+    m_assembler.pop(REGISTER_FILE_BASE);
+    m_assembler.pop(Reg::RBP);
+    m_assembler.ret();
+}
+
+void Compiler::compile_call_to_interpreter(Bytecode::Instruction const& instruction)
+{
+    m_assembler.mov(Reg::RDI, INTERPRETER);
+    m_assembler.mov(Reg::RSI, reinterpret_cast<FlatPtr>(&instruction));
+    m_assembler.mov(Reg::RDX, EXCEPTION_SLOT);
+    m_assembler.native_call(reinterpret_cast<void*>(cxx_execute_instruction));
+    m_assembler.test(Reg::RAX, Reg::RAX);
+    m_assembler.jump_if(Assembler::Condition::NotEqualTo, m_exit_with_exception);
+}
+
+void Compiler::compile_int32_arithmetic(Bytecode::Instruction const& instruction, Bytecode::Register lhs, Int32Operation operation)
+{
+    Assembler::Label slow_case;
+    Assembler::Label done;
+
+    load_register(Reg::RAX, lhs);
+    load_register(Reg::RCX, Bytecode::Register::accumulator());
+    branch_if_not_int32(Reg::RAX, slow_case);
+    branch_if_not_int32(Reg::RCX, slow_case);
+
+    switch (operation) {
+    case Int32Operation::Add:
+        m_assembler.add32(Reg::RAX, Reg::RCX);
+        m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+        break;
+    case Int32Operation::Sub:
+        m_assembler.sub32(Reg::RAX, Reg::RCX);
+        m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+        break;
+    case Int32Operation::Mul:
+        m_assembler.imul32(Reg::RAX, Reg::RCX);
+        m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+        // A zero may have to be -0, which isn't an int32.
+        m_assembler.test32(Reg::RAX, Reg::RAX);
+        m_assembler.jump_if(Assembler::Condition::EqualTo, slow_case);
+        break;
+    case Int32Operation::BitwiseAnd:
+        m_assembler.and32(Reg::RAX, Reg::RCX);
+        break;
+    case Int32Operation::BitwiseOr:
+        m_assembler.or32(Reg::RAX, Reg::RCX);
+        break;
+    case Int32Operation::BitwiseXor:
+        m_assembler.xor32(Reg::RAX, Reg::RCX);
+        break;
+    }
+
+    // The 32-bit operations cleared the upper half, which is where the tag goes.
+    m_assembler.mov(Reg::RDX, SHIFTED_INT32_TAG);
+    m_assembler.or64(Reg::RAX, Reg::RDX);
+    store_register(Bytecode::Register::accumulator(), Reg::RAX);
+    m_assembler.jump(done);
+
+    slow_case.link(m_assembler);
+    compile_call_to_interpreter(instruction);
+
+    done.link(m_assembler);
+}
+
+void Compiler::compile_int32_comparison(Bytecode::Instruction const& instruction, Bytecode::Register lhs, Assembler::Condition condition)
+{
+    Assembler::Label slow_case;
+    Assembler::Label done;
+
+    load_register(Reg::RAX, lhs);
+    load_register(Reg::RCX, Bytecode::Register::accumulator());
+    branch_if_not_int32(Reg::RAX, slow_case);
+    branch_if_not_int32(Reg::RCX, slow_case);
+
+    m_assembler.compare32(Reg::RAX, Reg::RCX);
+    m_assembler.set_if(condition, Reg::RAX);
+    m_assembler.mov(Reg::RDX, BOOLEAN_TAG << TAG_SHIFT);
+    m_assembler.or64(Reg::RAX, Reg::RDX);
+    store_register(Bytecode::Register::accumulator(), Reg::RAX);
+    m_assembler.jump(done);
+
+    slow_case.link(m_assembler);
+    compile_call_to_interpreter(instruction);
+
+    done.link(m_assembler);
+}
+
+void Compiler::compile_int32_increment(Bytecode::Instruction const& instruction, i8 delta)
+{
+    Assembler::Label slow_case;
+    Assembler::Label done;
+
+    load_register(Reg::RAX, Bytecode::Register::accumulator());
+    branch_if_not_int32(Reg::RAX, slow_case);
+    m_assembler.add32(Reg::RAX, delta);
+    m_assembler.jump_if(Assembler::Condition::Overflow, slow_case);
+    m_assembler.mov(Reg::RDX, SHIFTED_INT32_TAG);
+    m_assembler.or64(Reg::RAX, Reg::RDX);
+    store_register(Bytecode::Register::accumulator(), Reg::RAX);
+    m_assembler.jump(done);
+
+    slow_case.link(m_assembler);
+    compile_call_to_interpreter(instruction);
+
+    done.link(m_assembler);
+}
+
+void Compiler::compile_jump_conditional(Bytecode::Op::JumpConditional const& instruction)
+{
+    Assembler::Label test_result;
+
+    load_register(Reg::RAX, Bytecode::Register::accumulator());
+    m_assembler.mov(Reg::RDX, Reg::RAX);
+    m_assembler.shift_right(Reg::RDX, TAG_SHIFT);
+
+    // Both booleans and int32s are truthy if their lower half isn't zero.
+    m_assembler.compare32(Reg::RDX, BOOLEAN_TAG);
+    m_assembler.jump_if(Assembler::Condition::EqualTo, test_result);
+    m_assembler.compare32(Reg::RDX, INT32_TAG);
+    m_assembler.jump_if(Assembler::Condition::EqualTo, test_result);
+
+    m_assembler.mov(Reg::RDI, REGISTER_FILE_BASE);
+    m_assembler.native_call(reinterpret_cast<void*>(cxx_to_boolean));
+
+    test_result.link(m_assembler);
+    m_assembler.test32(Reg::RAX, Reg::RAX);
+    m_assembler.jump_if(Assembler::Condition::NotEqualTo, label_for(*instruction.true_target()));
+    m_assembler.jump(label_for(*instruction.false_target()));
+}
+
+void Compiler::compile_jump_if_tag(Bytecode::Op::Jump const& instruction, u32 tag_mask, u32 tag)
+{
+    load_register(Reg::RAX, Bytecode::Register::accumulator());
+    m_assembler.shift_right(Reg::RAX, TAG_SHIFT);
+    m_assembler.mov(Reg::RCX, static_cast<u64>(tag_mask));
+    m_assembler.and32(Reg::RAX, Reg::RCX);
+    m_assembler.compare32(Reg::RAX, tag);
+    m_assembler.jump_if(Assembler::Condition::EqualTo, label_for(*instruction.true_target()));
+    m_assembler.jump(label_for(*instruction.false_target()));
+}
+
+void Compiler::compile_instruction(Bytecode::Instruction const& instruction)
+{
+    using Type = Bytecode::Instruction::Type;
+
+    switch (instruction.type()) {
+    case Type::Load:
+        load_register(Reg::RAX, static_cast<Bytecode::Op::Load const&>(instruction).src());
+        store_register(Bytecode::Register::accumulator(), Reg::RAX);
+        return;
+    case Type::LoadImmediate:
+        m_assembler.mov(Reg::RAX, static_cast<Bytecode::Op::LoadImmediate const&>(instruction).value().encoded());
+        store_register(Bytecode::Register::accumulator(), Reg::RAX);
+        return;
+    case Type::Store:
+        load_register(Reg::RAX, Bytecode::Register::accumulator());
+        store_register(static_cast<Bytecode::Op::Store const&>(instruction).dst(), Reg::RAX);
+        return;
+
+#define COMPILE_INT32_ARITHMETIC(OpTitleCase, operation)                                                                         \
+    case Type::OpTitleCase:                                                                                                      \
+        compile_int32_arithmetic(instruction, static_cast<Bytecode::Op::OpTitleCase const&>(instruction).lhs(), Int32Operation::operation); \
+        return;
+        COMPILE_INT32_ARITHMETIC(Add, Add)
+        COMPILE_INT32_ARITHMETIC(Sub, Sub)
+        COMPILE_INT32_ARITHMETIC(Mul, Mul)
+        COMPILE_INT32_ARITHMETIC(BitwiseAnd, BitwiseAnd)
+        COMPILE_INT32_ARITHMETIC(BitwiseOr, BitwiseOr)
+        COMPILE_INT32_ARITHMETIC(BitwiseXor, BitwiseXor)
+#undef COMPILE_INT32_ARITHMETIC
+
+#define COMPILE_INT32_COMPARISON(OpTitleCase, condition)                                                                          \
+    case Type::OpTitleCase:                                                                                                       \
+        compile_int32_comparison(instruction, static_cast<Bytecode::Op::OpTitleCase const&>(instruction).lhs(), Assembler::Condition::condition); \
+        return;
+        COMPILE_INT32_COMPARISON(LessThan, SignedLessThan)
+        COMPILE_INT32_COMPARISON(LessThanEquals, SignedLessThanOrEqualTo)
+        COMPILE_INT32_COMPARISON(GreaterThan, SignedGreaterThan)
+        COMPILE_INT32_COMPARISON(GreaterThanEquals, SignedGreaterThanOrEqualTo)
+        COMPILE_INT32_COMPARISON(StrictlyEquals, EqualTo)
+        COMPILE_INT32_COMPARISON(StrictlyInequals, NotEqualTo)
+        COMPILE_INT32_COMPARISON(LooselyEquals, EqualTo)
+        COMPILE_INT32_COMPARISON(LooselyInequals, NotEqualTo)
+#undef COMPILE_INT32_COMPARISON
+
+    case Type::Increment:
+        compile_int32_increment(instruction, 1);
+        return;
+    case Type::Decrement:
+        compile_int32_increment(instruction, -1);
+        return;
+
+    case Type::Jump:
+        m_assembler.jump(label_for(*static_cast<Bytecode::Op::Jump const&>(instruction).true_target()));
+        return;
+    case Type::JumpConditional:
+        compile_jump_conditional(static_cast<Bytecode::Op::JumpConditional const&>(instruction));
+        return;
+    case Type::JumpNullish:
+        compile_jump_if_tag(static_cast<Bytecode::Op::Jump const&>(instruction), IS_NULLISH_EXTRACT_PATTERN, IS_NULLISH_PATTERN);
+        return;
+    case Type::JumpUndefined:
+        compile_jump_if_tag(static_cast<Bytecode::Op::Jump const&>(instruction), 0xffff, UNDEFINED_TAG);
+        return;
+
+    case Type::Return:
+        compile_call_to_interpreter(instruction);
+        m_assembler.jump(m_exit);
+        return;
+
+    default:
+        compile_call_to_interpreter(instruction);
+        return;
+    }
+}
+
+void Compiler::compile_block(Bytecode::BasicBlock const& block)
+{
+    m_block_labels[*m_block_indices.get(&block)].link(m_assembler);
+    m_block_entry_offsets.set(&block, m_output.size());
+
+    for (Bytecode::InstructionStreamIterator it(block.instruction_stream()); !it.at_end(); ++it)
+        compile_instruction(*it);
+
+    // Like in the interpreter, running off the end of a block ends the executable.
+    m_assembler.jump(m_exit);
+}
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable const& bytecode_executable)
+{
+    if (!can_compile(bytecode_executable)) {
+        dbgln_if(JS_JIT_DEBUG, "JIT: Can't compile {}", bytecode_executable.name);
+        return nullptr;
+    }
+
+    Compiler compiler { bytecode_executable };
+    for (size_t i = 0; i < bytecode_executable.basic_blocks.size(); ++i)
+        compiler.m_block_indices.set(&bytecode_executable.basic_blocks[i], i);
+    compiler.m_block_labels.resize(bytecode_executable.basic_blocks.size());
+
+    compiler.compile_prologue();
+    for (auto& block : bytecode_executable.basic_blocks)
+        compiler.compile_block(block);
+    compiler.compile_epilogue();
+
+    dbgln_if(JS_JIT_DEBUG, "JIT: Compiled {} into {} bytes of code", bytecode_executable.name, compiler.m_output.size());
+    return NativeExecutable::create(compiler.m_output, move(compiler.m_block_entry_offsets));
+}
+
+#else
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable const&)
+{
+    return nullptr;
+}
+
+#endif
+
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/OwnPtr.h>
+#include <AK/Vector.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/JIT/Assembler.h>
+#include <LibJS/JIT/NativeExecutable.h>
+
+namespace JS::JIT {
+
+// A baseline compiler: every bytecode instruction turns into a fixed sequence of machine code. Instructions with a fast
+// path handle int32 operands inline and call into the interpreter's implementation for everything else, and all other
+// instructions always do. Control flow between basic blocks becomes native jumps.
+class Compiler {
+public:
+    // Returns null for executables the compiler can't handle, such as generators or anything with unwind contexts,
+    // which then keep running in the interpreter.
+    static OwnPtr<NativeExecutable> compile(Bytecode::Executable const&);
+
+private:
+    explicit Compiler(Bytecode::Executable const&);
+
+    static bool can_compile(Bytecode::Executable const&);
+
+#if ARCH(X86_64)
+    void compile_prologue();
+    void compile_epilogue();
+    void compile_block(Bytecode::BasicBlock const&);
+    void compile_instruction(Bytecode::Instruction const&);
+
+    // Runs the instruction through the interpreter, and leaves the native code if it threw.
+    void compile_call_to_interpreter(Bytecode::Instruction const&);
+
+    enum class Int32Operation {
+        Add,
+        Sub,
+        Mul,
+        BitwiseAnd,
+        BitwiseOr,
+        BitwiseXor,
+    };
+    void compile_int32_arithmetic(Bytecode::Instruction const&, Bytecode::Register lhs, Int32Operation);
+    void compile_int32_comparison(Bytecode::Instruction const&, Bytecode::Register lhs, Assembler::Condition);
+    void compile_int32_increment(Bytecode::Instruction const&, i8 delta);
+
+    void compile_jump_conditional(Bytecode::Op::JumpConditional const&);
+    void compile_jump_if_tag(Bytecode::Op::Jump const&, u32 tag_mask, u32 tag);
+
+    void load_register(Assembler::Reg, Bytecode::Register);
+    void store_register(Bytecode::Register, Assembler::Reg);
+    void branch_if_not_int32(Assembler::Reg, Assembler::Label&);
+    Assembler::Label& label_for(Bytecode::Label const&);
+#endif
+
+    Bytecode::Executable const& m_bytecode_executable;
+    Vector<u8> m_output;
+    Assembler m_assembler { m_output };
+
+    HashMap<Bytecode::BasicBlock const*, size_t> m_block_indices;
+    HashMap<Bytecode::BasicBlock const*, size_t> m_block_entry_offsets;
+    Vector<Assembler::Label> m_block_labels;
+    Assembler::Label m_exit;
+    Assembler::Label m_exit_with_exception;
+};
+
+}
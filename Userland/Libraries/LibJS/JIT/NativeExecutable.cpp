@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibJS/JIT/NativeExecutable.h>
+#include <LibJS/Runtime/Value.h>
+#include <string.h>
+#include <sys/mman.h>
+
+namespace JS::JIT {
+
+// The compiled code takes the interpreter, the register file, a slot for a thrown exception and the address to start at.
+// It returns zero, or non-zero if it stored an exception in the slot.
+using NativeFunction = u64 (*)(Bytecode::Interpreter*, Value* registers, Value* exception, void const* entry_point);
+
+OwnPtr<NativeExecutable> NativeExecutable::create(ReadonlyBytes code, HashMap<Bytecode::BasicBlock const*, size_t> block_entry_offsets)
+{
+    // Map the code writable first, and only make it executable once it's there.
+    auto* memory = mmap(nullptr, code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        dbgln_if(JS_JIT_DEBUG, "JIT: Failed to map {} bytes of code: {}", code.size(), strerror(errno));
+        return nullptr;
+    }
+
+    memcpy(memory, code.data(), code.size());
+    if (mprotect(memory, code.size(), PROT_READ | PROT_EXEC) < 0) {
+        dbgln_if(JS_JIT_DEBUG, "JIT: Failed to make code executable: {}", strerror(errno));
+        munmap(memory, code.size());
+        return nullptr;
+    }
+
+    return adopt_own_if_nonnull(new (nothrow) NativeExecutable(memory, code.size(), move(block_entry_offsets)));
+}
+
+NativeExecutable::NativeExecutable(void* code, size_t size, HashMap<Bytecode::BasicBlock const*, size_t> block_entry_offsets)
+    : m_code(code)
+    , m_size(size)
+    , m_block_entry_offsets(move(block_entry_offsets))
+{
+}
+
+NativeExecutable::~NativeExecutable()
+{
+    munmap(m_code, m_size);
+}
+
+ThrowCompletionOr<void> NativeExecutable::run(Bytecode::Interpreter& interpreter, Span<Value> registers, Bytecode::BasicBlock const& entry_block) const
+{
+    auto entry_offset = m_block_entry_offsets.get(&entry_block);
+    VERIFY(entry_offset.has_value());
+
+    // NOTE: The exception lives on the stack until we return it, where the garbage collector finds it conservatively.
+    Value exception;
+    auto function = reinterpret_cast<NativeFunction>(m_code);
+    if (function(&interpreter, registers.data(), &exception, static_cast<u8 const*>(m_code) + *entry_offset) != 0)
+        return throw_completion(exception);
+    return {};
+}
+
+}
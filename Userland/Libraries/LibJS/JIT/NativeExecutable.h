@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/OwnPtr.h>
+#include <AK/Span.h>
+#include <LibJS/Forward.h>
+#include <LibJS/Runtime/Completion.h>
+
+namespace JS::JIT {
+
+// Machine code for a bytecode executable, which can be entered at the start of any of its basic blocks.
+class NativeExecutable {
+    AK_MAKE_NONCOPYABLE(NativeExecutable);
+    AK_MAKE_NONMOVABLE(NativeExecutable);
+
+public:
+    // Returns null if the system doesn't let us map the code executable.
+    static OwnPtr<NativeExecutable> create(ReadonlyBytes code, HashMap<Bytecode::BasicBlock const*, size_t> block_entry_offsets);
+    ~NativeExecutable();
+
+    // Runs until the code returns, throws, or reaches the end of a block without a terminator, like the interpreter would.
+    ThrowCompletionOr<void> run(Bytecode::Interpreter&, Span<Value> registers, Bytecode::BasicBlock const& entry_block) const;
+
+private:
+    NativeExecutable(void* code, size_t size, HashMap<Bytecode::BasicBlock const*, size_t> block_entry_offsets);
+
+    void* m_code { nullptr };
+    size_t m_size { 0 };
+    HashMap<Bytecode::BasicBlock const*, size_t> m_block_entry_offsets;
+};
+
+}
@@ -38,6 +38,11 @@ private:
     ScopePusher(Parser& parser, ScopeNode* node, ScopeLevel scope_level)
         : m_parser(parser)
         , m_scope_level(scope_level)
+        , m_lexical_names(parser.m_scope_arena)
+        , m_var_names(parser.m_scope_arena)
+        , m_function_names(parser.m_scope_arena)
+        , m_forbidden_lexical_names(parser.m_scope_arena)
+        , m_forbidden_var_names(parser.m_scope_arena)
     {
         m_parent_scope = exchange(m_parser.m_state.current_scope_pusher, this);
         VERIFY(node || (m_parent_scope && scope_level == ScopeLevel::NotTopLevel));
@@ -271,12 +276,12 @@ private:
     ScopePusher* m_parent_scope { nullptr };
     ScopePusher* m_top_level_scope { nullptr };
 
-    HashTable<DeprecatedFlyString> m_lexical_names;
-    HashTable<DeprecatedFlyString> m_var_names;
-    HashTable<DeprecatedFlyString> m_function_names;
+    ArenaHashTable<DeprecatedFlyString> m_lexical_names;
+    ArenaHashTable<DeprecatedFlyString> m_var_names;
+    ArenaHashTable<DeprecatedFlyString> m_function_names;
 
-    HashTable<DeprecatedFlyString> m_forbidden_lexical_names;
-    HashTable<DeprecatedFlyString> m_forbidden_var_names;
+    ArenaHashTable<DeprecatedFlyString> m_forbidden_lexical_names;
+    ArenaHashTable<DeprecatedFlyString> m_forbidden_var_names;
     NonnullRefPtrVector<FunctionDeclaration> m_functions_to_hoist;
 
     Optional<Vector<FunctionParameter>> m_function_parameters;
@@ -866,7 +871,7 @@ RefPtr<FunctionExpression> Parser::try_parse_arrow_function_expression(bool expe
 
     auto function_start_offset = rule_start.position().offset;
     auto function_end_offset = position().offset - m_state.current_token.trivia().length();
-    auto source_text = DeprecatedString { m_state.lexer.source().substring_view(function_start_offset, function_end_offset - function_start_offset) };
+    auto source_text = SourceText { m_source_code, static_cast<u32>(function_start_offset), static_cast<u32>(function_end_offset) };
     return create_ast_node<FunctionExpression>(
         { m_source_code, rule_start.position(), position() }, "", move(source_text),
         move(body), move(parameters), function_length, function_kind, body->in_strict_mode(),
@@ -1355,12 +1360,12 @@ NonnullRefPtr<ClassExpression> Parser::parse_class_expression(bool expect_class_
             constructor_body->append(create_ast_node<ReturnStatement>({ m_source_code, rule_start.position(), position() }, move(super_call)));
 
             constructor = create_ast_node<FunctionExpression>(
-                { m_source_code, rule_start.position(), position() }, class_name, "",
+                { m_source_code, rule_start.position(), position() }, class_name, SourceText {},
                 move(constructor_body), Vector { FunctionParameter { move(argument_name), nullptr, true } }, 0, FunctionKind::Normal,
                 /* is_strict_mode */ true, /* might_need_arguments_object */ false, /* contains_direct_call_to_eval */ false);
         } else {
             constructor = create_ast_node<FunctionExpression>(
-                { m_source_code, rule_start.position(), position() }, class_name, "",
+                { m_source_code, rule_start.position(), position() }, class_name, SourceText {},
                 move(constructor_body), Vector<FunctionParameter> {}, 0, FunctionKind::Normal,
                 /* is_strict_mode */ true, /* might_need_arguments_object */ false, /* contains_direct_call_to_eval */ false);
         }
@@ -1378,7 +1383,7 @@ NonnullRefPtr<ClassExpression> Parser::parse_class_expression(bool expect_class_
 
     auto function_start_offset = rule_start.position().offset;
     auto function_end_offset = position().offset - m_state.current_token.trivia().length();
-    auto source_text = DeprecatedString { m_state.lexer.source().substring_view(function_start_offset, function_end_offset - function_start_offset) };
+    auto source_text = SourceText { m_source_code, static_cast<u32>(function_start_offset), static_cast<u32>(function_end_offset) };
 
     return create_ast_node<ClassExpression>({ m_source_code, rule_start.position(), position() }, move(class_name), move(source_text), move(constructor), move(super_class), move(elements));
 }
@@ -2652,7 +2657,7 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u16 parse_options, O
 
     auto function_start_offset = rule_start.position().offset;
     auto function_end_offset = position().offset - m_state.current_token.trivia().length();
-    auto source_text = DeprecatedString { m_state.lexer.source().substring_view(function_start_offset, function_end_offset - function_start_offset) };
+    auto source_text = SourceText { m_source_code, static_cast<u32>(function_start_offset), static_cast<u32>(function_end_offset) };
     return create_ast_node<FunctionNodeType>(
         { m_source_code, rule_start.position(), position() },
         name, move(source_text), move(body), move(parameters), function_length,
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Arena.h>
 #include <AK/Assertions.h>
 #include <AK/HashTable.h>
 #include <AK/NonnullRefPtr.h>
@@ -333,6 +334,9 @@ private:
         }
     };
 
+    // The names declared in each scope are only needed while parsing, so they're allocated from here and freed along with the parser.
+    Arena m_scope_arena { 16 * KiB };
+
     NonnullRefPtr<SourceCode> m_source_code;
     Vector<Position> m_rule_starts;
     ParserState m_state;
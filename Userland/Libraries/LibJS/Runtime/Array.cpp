@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/Function.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Array.h>
@@ -156,6 +157,21 @@ ThrowCompletionOr<bool> Array::set_length(PropertyDescriptor const& property_des
     return true;
 }
 
+// Writes the decimal representation of the value to the end of the buffer, and returns where it starts.
+static StringView int32_to_decimal(i32 value, AK::Array<char, 11>& buffer)
+{
+    // NOTE: The magnitude of the most negative int32 doesn't fit into an i32, so work with u32.
+    u32 magnitude = value < 0 ? -static_cast<u32>(value) : static_cast<u32>(value);
+    size_t start = buffer.size();
+    do {
+        buffer[--start] = '0' + (magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0)
+        buffer[--start] = '-';
+    return StringView { buffer.data() + start, buffer.size() - start };
+}
+
 // 1.1.1.2 CompareArrayElements ( x, y, comparefn ), https://tc39.es/proposal-change-array-by-copy/#sec-comparearrayelements
 ThrowCompletionOr<double> compare_array_elements(VM& vm, Value x, Value y, FunctionObject* comparefn)
 {
@@ -185,6 +201,20 @@ ThrowCompletionOr<double> compare_array_elements(VM& vm, Value x, Value y, Funct
         return value_number.as_double();
     }
 
+    // OPTIMIZATION: Int32s are ASCII digits when converted to strings, so comparing the code units is comparing the
+    //               bytes, and that can be done without creating any strings.
+    if (x.is_int32() && y.is_int32()) {
+        AK::Array<char, 11> x_buffer;
+        AK::Array<char, 11> y_buffer;
+        auto x_digits = int32_to_decimal(x.as_i32(), x_buffer);
+        auto y_digits = int32_to_decimal(y.as_i32(), y_buffer);
+        if (x_digits < y_digits)
+            return -1;
+        if (y_digits < x_digits)
+            return 1;
+        return 0;
+    }
+
     // 5. Let xString be ? ToString(x).
     auto x_string = PrimitiveString::create(vm, TRY(x.to_deprecated_string(vm)));
 
@@ -215,9 +245,20 @@ ThrowCompletionOr<MarkedVector<Value>> sort_indexed_properties(VM& vm, Object co
     // 1. Let items be a new empty List.
     auto items = MarkedVector<Value> { vm.heap() };
 
+    // OPTIMIZATION: Every packed element of an Array is present, and reading it can't run any code.
+    size_t k = 0;
+    if (is<Array>(object) && is_packed(object.indexed_properties().element_kind())) {
+        auto elements = object.indexed_properties().packed_elements();
+        if (elements.size() >= length) {
+            items.ensure_capacity(length);
+            for (; k < length; ++k)
+                items.append(elements[k]);
+        }
+    }
+
     // 2. Let k be 0.
     // 3. Repeat, while k < len,
-    for (size_t k = 0; k < length; ++k) {
+    for (; k < length; ++k) {
         // a. Let Pk be ! ToString(𝔽(k)).
         auto property_key = PropertyKey { k };
 
@@ -150,6 +150,38 @@ static ThrowCompletionOr<Object*> array_species_create(VM& vm, Object& original_
     return TRY(construct(vm, constructor.as_function(), Value(length))).ptr();
 }
 
+// OPTIMIZATION: Returns the element if the object is an Array with packed elements. It is then an own data property,
+//               so HasProperty() is true and Get() returns it without running any code.
+static Optional<Value> packed_array_element(Object const& object, size_t index)
+{
+    if (!is<Array>(object) || !is_packed(object.indexed_properties().element_kind()))
+        return {};
+    auto elements = object.indexed_properties().packed_elements();
+    if (index >= elements.size())
+        return {};
+    return elements[index];
+}
+
+// OPTIMIZATION: Whether Set() on indices past the end of the object would only append to its packed elements. That
+//               requires an extensible Array with a writable length whose prototypes are the unmodified intrinsic
+//               Array.prototype and Object.prototype, so there is nothing that could intercept the store.
+static bool can_append_to_packed_elements(VM& vm, Object& object)
+{
+    if (!is<Array>(object))
+        return false;
+    auto& array = static_cast<Array&>(object);
+    if (!is_packed(array.indexed_properties().element_kind()) || !array.length_is_writable() || !MUST(array.is_extensible()))
+        return false;
+
+    auto& intrinsics = vm.current_realm()->intrinsics();
+    auto* array_prototype = intrinsics.array_prototype();
+    auto* object_prototype = intrinsics.object_prototype();
+    return array.shape().prototype() == array_prototype
+        && array_prototype->shape().prototype() == object_prototype
+        && array_prototype->indexed_properties().is_empty()
+        && object_prototype->indexed_properties().is_empty();
+}
+
 // 23.1.3.1 Array.prototype.at ( index ), https://tc39.es/ecma262/#sec-array.prototype.at
 JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::at)
 {
@@ -957,6 +989,24 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::index_of)
         k = max(length + n, 0);
     }
 
+    // OPTIMIZATION: Comparing packed elements can't run any code, so we can look at them directly.
+    //               Whatever came after them, if the Array was shrunk, is handled by the loop below.
+    if (is<Array>(*object) && is_packed(object->indexed_properties().element_kind())) {
+        auto elements = object->indexed_properties().packed_elements();
+        auto end = min(length, elements.size());
+        if (search_element.is_int32() && object->indexed_properties().element_kind() == ElementKind::PackedInt32) {
+            for (; k < end; ++k) {
+                if (elements[k].encoded() == search_element.encoded())
+                    return Value(k);
+            }
+        } else {
+            for (; k < end; ++k) {
+                if (is_strictly_equal(search_element, elements[k]))
+                    return Value(k);
+            }
+        }
+    }
+
     // 10. Repeat, while k < len,
     for (; k < length; ++k) {
         auto property_key = PropertyKey { k };
@@ -1120,13 +1170,16 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::map)
         // a. Let Pk be ! ToString(𝔽(k)).
         auto property_key = PropertyKey { k };
 
+        // OPTIMIZATION: The callback may change the array, so this has to be checked again for every element.
+        auto packed_element = packed_array_element(*object, k);
+
         // b. Let kPresent be ? HasProperty(O, Pk).
-        auto k_present = TRY(object->has_property(property_key));
+        auto k_present = packed_element.has_value() || TRY(object->has_property(property_key));
 
         // c. If kPresent is true, then
         if (k_present) {
             // i. Let kValue be ? Get(O, Pk).
-            auto k_value = TRY(object->get(property_key));
+            auto k_value = packed_element.has_value() ? *packed_element : TRY(object->get(property_key));
 
             // ii. Let mappedValue be ? Call(callbackfn, thisArg, « kValue, 𝔽(k), O »).
             auto mapped_value = TRY(call(vm, callback_function.as_function(), this_arg, k_value, Value(k), object));
@@ -1167,6 +1220,17 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::push)
     auto new_length = length + argument_count;
     if (new_length > MAX_ARRAY_LIKE_INDEX)
         return vm.throw_completion<TypeError>(ErrorType::ArrayMaxSize);
+
+    // OPTIMIZATION: Every Set() would append to the packed elements, and setting the length to the new size of the Array
+    //               afterwards would do nothing.
+    if (can_append_to_packed_elements(vm, *this_object)) {
+        auto& indexed_properties = this_object->indexed_properties();
+        VERIFY(indexed_properties.array_like_size() == length);
+        for (size_t i = 0; i < argument_count; ++i)
+            indexed_properties.append(vm.argument(i));
+        return Value(new_length);
+    }
+
     for (size_t i = 0; i < argument_count; ++i)
         TRY(this_object->set(length + i, vm.argument(i), Object::ShouldThrowExceptions::Yes));
     auto new_length_value = Value(new_length);
@@ -1587,6 +1651,12 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
     // 8. Let j be 0.
     size_t j = 0;
 
+    // OPTIMIZATION: If the comparator left the Array packed, every Set() just replaces an own writable data property.
+    if (is<Array>(*object) && is_packed(object->indexed_properties().element_kind()) && object->indexed_properties().array_like_size() >= item_count) {
+        for (; j < item_count; ++j)
+            object->indexed_properties().put(j, sorted_list[j]);
+    }
+
     // 9. Repeat, while j < itemCount,
     for (; j < item_count; ++j) {
         // a. Perform ? Set(obj, ! ToString(𝔽(j)), sortedList[j], true).
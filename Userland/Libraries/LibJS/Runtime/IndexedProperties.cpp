@@ -17,6 +17,26 @@ SimpleIndexedPropertyStorage::SimpleIndexedPropertyStorage(Vector<Value>&& initi
     : m_array_size(initial_values.size())
     , m_packed_elements(move(initial_values))
 {
+    for (auto value : m_packed_elements)
+        generalize_element_kind_for(value);
+}
+
+void SimpleIndexedPropertyStorage::generalize_element_kind(ElementKind kind)
+{
+    if (kind > m_element_kind)
+        m_element_kind = kind;
+}
+
+void SimpleIndexedPropertyStorage::generalize_element_kind_for(Value value)
+{
+    if (value.is_int32())
+        return;
+    if (value.is_number())
+        generalize_element_kind(ElementKind::PackedNumber);
+    else if (value.is_empty())
+        generalize_element_kind(ElementKind::Holey);
+    else
+        generalize_element_kind(ElementKind::Packed);
 }
 
 bool SimpleIndexedPropertyStorage::has_index(u32 index) const
@@ -49,16 +69,20 @@ void SimpleIndexedPropertyStorage::put(u32 index, Value value, PropertyAttribute
     VERIFY(attributes == default_attributes);
 
     if (index >= m_array_size) {
+        if (index > m_array_size)
+            generalize_element_kind(ElementKind::Holey);
         m_array_size = index + 1;
         grow_storage_if_needed();
     }
     m_packed_elements[index] = value;
+    generalize_element_kind_for(value);
 }
 
 void SimpleIndexedPropertyStorage::remove(u32 index)
 {
     VERIFY(index < m_array_size);
     m_packed_elements[index] = {};
+    generalize_element_kind(ElementKind::Holey);
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_first()
@@ -77,6 +101,8 @@ ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 
 bool SimpleIndexedPropertyStorage::set_array_like_size(size_t new_size)
 {
+    if (new_size > m_array_size)
+        generalize_element_kind(ElementKind::Holey);
     m_array_size = new_size;
     m_packed_elements.resize_and_keep_capacity(new_size);
     return true;
@@ -276,6 +302,23 @@ size_t IndexedProperties::real_size() const
     return static_cast<GenericIndexedPropertyStorage const&>(*m_storage).size();
 }
 
+ElementKind IndexedProperties::element_kind() const
+{
+    if (!m_storage)
+        return ElementKind::PackedInt32;
+    if (m_storage->is_simple_storage())
+        return static_cast<SimpleIndexedPropertyStorage const&>(*m_storage).element_kind();
+    return ElementKind::Dictionary;
+}
+
+ReadonlySpan<Value> IndexedProperties::packed_elements() const
+{
+    VERIFY(is_packed(element_kind()));
+    if (!m_storage)
+        return {};
+    return static_cast<SimpleIndexedPropertyStorage const&>(*m_storage).elements().span().trim(array_like_size());
+}
+
 Vector<u32> IndexedProperties::indices() const
 {
     if (!m_storage)
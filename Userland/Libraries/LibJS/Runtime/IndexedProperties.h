@@ -15,12 +15,29 @@ namespace JS {
 struct ValueAndAttributes {
     Value value;
     PropertyAttributes attributes { default_attributes };
+    // Where the value lives in the object's storage, for named properties.
+    Optional<u32> property_offset {};
 };
 
 class IndexedProperties;
 class IndexedPropertyIterator;
 class GenericIndexedPropertyStorage;
 
+// What is known about the elements, from most to least specific. "Packed" means there are no holes below the
+// array-like size. Storage only ever moves towards the less specific kinds, even when holes are filled again.
+enum class ElementKind : u8 {
+    PackedInt32,
+    PackedNumber,
+    Packed,
+    Holey,
+    Dictionary,
+};
+
+constexpr bool is_packed(ElementKind kind)
+{
+    return kind <= ElementKind::Packed;
+}
+
 class IndexedPropertyStorage {
 public:
     virtual ~IndexedPropertyStorage() = default;
@@ -60,13 +77,18 @@ public:
     virtual bool is_simple_storage() const override { return true; }
     Vector<Value> const& elements() const { return m_packed_elements; }
 
+    ElementKind element_kind() const { return m_element_kind; }
+
 private:
     friend GenericIndexedPropertyStorage;
 
     void grow_storage_if_needed();
+    void generalize_element_kind(ElementKind);
+    void generalize_element_kind_for(Value);
 
     size_t m_array_size { 0 };
     Vector<Value> m_packed_elements;
+    ElementKind m_element_kind { ElementKind::PackedInt32 };
 };
 
 class GenericIndexedPropertyStorage final : public IndexedPropertyStorage {
@@ -138,6 +160,11 @@ public:
 
     size_t real_size() const;
 
+    ElementKind element_kind() const;
+
+    // All elements from 0 up to the array-like size, which must only be used when the element kind is packed.
+    ReadonlySpan<Value> packed_elements() const;
+
     Vector<u32> indices() const;
 
     template<typename Callback>
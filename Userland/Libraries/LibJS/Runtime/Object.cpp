@@ -711,7 +711,7 @@ ThrowCompletionOr<Optional<PropertyDescriptor>> Object::internal_get_own_propert
     PropertyDescriptor descriptor;
 
     // 3. Let X be O's own property whose key is P.
-    auto [value, attributes] = *maybe_storage_entry;
+    auto [value, attributes, property_offset] = *maybe_storage_entry;
 
     // 4. If X is a data property, then
     if (!value.is_accessor()) {
@@ -738,6 +738,8 @@ ThrowCompletionOr<Optional<PropertyDescriptor>> Object::internal_get_own_propert
     // 7. Set D.[[Configurable]] to the value of X's [[Configurable]] attribute.
     descriptor.configurable = attributes.is_configurable();
 
+    descriptor.property_offset = property_offset;
+
     // 8. Return D.
     return descriptor;
 }
@@ -783,7 +785,7 @@ ThrowCompletionOr<bool> Object::internal_has_property(PropertyKey const& propert
 }
 
 // 10.1.8 [[Get]] ( P, Receiver ), https://tc39.es/ecma262/#sec-ordinary-object-internal-methods-and-internal-slots-get-p-receiver
-ThrowCompletionOr<Value> Object::internal_get(PropertyKey const& property_key, Value receiver) const
+ThrowCompletionOr<Value> Object::internal_get(PropertyKey const& property_key, Value receiver, CacheablePropertyMetadata* cacheable_metadata) const
 {
     VERIFY(!receiver.is_empty());
     VERIFY(property_key.is_valid());
@@ -803,12 +805,15 @@ ThrowCompletionOr<Value> Object::internal_get(PropertyKey const& property_key, V
             return js_undefined();
 
         // c. Return ? parent.[[Get]](P, Receiver).
-        return parent->internal_get(property_key, receiver);
+        return parent->internal_get(property_key, receiver, cacheable_metadata);
     }
 
     // 3. If IsDataDescriptor(desc) is true, return desc.[[Value]].
-    if (descriptor->is_data_descriptor())
+    if (descriptor->is_data_descriptor()) {
+        if (cacheable_metadata && descriptor->property_offset.has_value())
+            *cacheable_metadata = { .holder = this, .property_offset = *descriptor->property_offset };
         return *descriptor->value;
+    }
 
     // 4. Assert: IsAccessorDescriptor(desc) is true.
     VERIFY(descriptor->is_accessor_descriptor());
@@ -825,7 +830,7 @@ ThrowCompletionOr<Value> Object::internal_get(PropertyKey const& property_key, V
 }
 
 // 10.1.9 [[Set]] ( P, V, Receiver ), https://tc39.es/ecma262/#sec-ordinary-object-internal-methods-and-internal-slots-set-p-v-receiver
-ThrowCompletionOr<bool> Object::internal_set(PropertyKey const& property_key, Value value, Value receiver)
+ThrowCompletionOr<bool> Object::internal_set(PropertyKey const& property_key, Value value, Value receiver, CacheablePropertyMetadata* cacheable_metadata)
 {
     VERIFY(property_key.is_valid());
     VERIFY(!value.is_empty());
@@ -834,8 +839,16 @@ ThrowCompletionOr<bool> Object::internal_set(PropertyKey const& property_key, Va
     // 2. Let ownDesc be ? O.[[GetOwnProperty]](P).
     auto own_descriptor = TRY(internal_get_own_property(property_key));
 
+    // NOTE: Setting a writable data property of the receiver itself only ever replaces the value in its storage.
+    bool is_cacheable = cacheable_metadata && own_descriptor.has_value() && own_descriptor->property_offset.has_value()
+        && own_descriptor->is_data_descriptor() && *own_descriptor->writable
+        && receiver.is_object() && &receiver.as_object() == this;
+
     // 3. Return ? OrdinarySetWithOwnDescriptor(O, P, V, Receiver, ownDesc).
-    return ordinary_set_with_own_descriptor(property_key, value, receiver, own_descriptor);
+    auto succeeded = TRY(ordinary_set_with_own_descriptor(property_key, value, receiver, own_descriptor));
+    if (succeeded && is_cacheable)
+        *cacheable_metadata = { .holder = this, .property_offset = *own_descriptor->property_offset };
+    return succeeded;
 }
 
 // 10.1.9.2 OrdinarySetWithOwnDescriptor ( O, P, V, Receiver, ownDesc ), https://tc39.es/ecma262/#sec-ordinarysetwithowndescriptor
@@ -1021,6 +1034,7 @@ Optional<ValueAndAttributes> Object::storage_get(PropertyKey const& property_key
 
     Value value;
     PropertyAttributes attributes;
+    Optional<u32> property_offset;
 
     if (property_key.is_number()) {
         auto value_and_attributes = m_indexed_properties.get(property_key.as_number());
@@ -1038,9 +1052,10 @@ Optional<ValueAndAttributes> Object::storage_get(PropertyKey const& property_key
 
         value = m_storage[metadata->offset];
         attributes = metadata->attributes;
+        property_offset = metadata->offset;
     }
 
-    return ValueAndAttributes { .value = value, .attributes = attributes };
+    return ValueAndAttributes { .value = value, .attributes = attributes, .property_offset = property_offset };
 }
 
 bool Object::storage_has(PropertyKey const& property_key) const
@@ -1055,7 +1070,8 @@ void Object::storage_set(PropertyKey const& property_key, ValueAndAttributes con
 {
     VERIFY(property_key.is_valid());
 
-    auto [value, attributes] = value_and_attributes;
+    auto value = value_and_attributes.value;
+    auto attributes = value_and_attributes.attributes;
 
     if (property_key.is_number()) {
         auto index = property_key.as_number();
@@ -1071,10 +1087,13 @@ void Object::storage_set(PropertyKey const& property_key, ValueAndAttributes con
     auto property_key_string_or_symbol = property_key.to_string_or_symbol();
     auto metadata = shape().lookup(property_key_string_or_symbol);
 
+    if (!metadata.has_value() || attributes != metadata->attributes)
+        invalidate_cached_prototype_chains_if_needed();
+
     if (!metadata.has_value()) {
-        if (!m_shape->is_unique() && shape().property_count() > 100) {
-            // If you add more than 100 properties to an object, let's stop doing
-            // transitions to avoid filling up the heap with shapes.
+        if (!m_shape->is_unique() && m_shape->should_become_unique_before_adding(property_key_string_or_symbol, attributes)) {
+            // Objects with lots of properties, or adding a property to a shape that already fans out into lots of
+            // transitions, stop doing transitions to avoid filling up the heap with shapes.
             ensure_shape_is_unique();
         }
 
@@ -1113,6 +1132,7 @@ void Object::storage_delete(PropertyKey const& property_key)
     auto metadata = shape().lookup(property_key.to_string_or_symbol());
     VERIFY(metadata.has_value());
 
+    invalidate_cached_prototype_chains_if_needed();
     ensure_shape_is_unique();
 
     shape().remove_property_from_unique_shape(property_key.to_string_or_symbol(), metadata->offset);
@@ -1123,6 +1143,7 @@ void Object::set_prototype(Object* new_prototype)
 {
     if (prototype() == new_prototype)
         return;
+    invalidate_cached_prototype_chains_if_needed();
     auto& shape = this->shape();
     if (shape.is_unique())
         shape.set_prototype_without_transition(new_prototype);
@@ -1168,6 +1189,14 @@ void Object::define_intrinsic_accessor(PropertyKey const& property_key, Property
     intrinsics.set(property_key.as_string(), move(accessor));
 }
 
+void Object::invalidate_cached_prototype_chains_if_needed()
+{
+    // Adding, removing or reconfiguring a property, or changing the prototype, may change what a lookup that passes through
+    // this object finds. Value changes don't matter, as the caches read the current value from the object holding it.
+    if (m_is_cached_prototype)
+        vm().invalidate_cached_prototype_chains();
+}
+
 void Object::ensure_shape_is_unique()
 {
     if (shape().is_unique())
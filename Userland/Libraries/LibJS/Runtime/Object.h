@@ -40,6 +40,13 @@ struct PrivateElement {
     Value value;
 };
 
+// Filled in by the ordinary [[Get]] and [[Set]] when they found the property in an object's storage, so that inline caches
+// can access it there directly the next time.
+struct CacheablePropertyMetadata {
+    Object const* holder { nullptr };
+    u32 property_offset { 0 };
+};
+
 class Object : public Cell {
     JS_CELL(Object, Cell);
 
@@ -119,8 +126,8 @@ public:
     virtual ThrowCompletionOr<Optional<PropertyDescriptor>> internal_get_own_property(PropertyKey const&) const;
     virtual ThrowCompletionOr<bool> internal_define_own_property(PropertyKey const&, PropertyDescriptor const&);
     virtual ThrowCompletionOr<bool> internal_has_property(PropertyKey const&) const;
-    virtual ThrowCompletionOr<Value> internal_get(PropertyKey const&, Value receiver) const;
-    virtual ThrowCompletionOr<bool> internal_set(PropertyKey const&, Value value, Value receiver);
+    virtual ThrowCompletionOr<Value> internal_get(PropertyKey const&, Value receiver, CacheablePropertyMetadata* = nullptr) const;
+    virtual ThrowCompletionOr<bool> internal_set(PropertyKey const&, Value value, Value receiver, CacheablePropertyMetadata* = nullptr);
     virtual ThrowCompletionOr<bool> internal_delete(PropertyKey const&);
     virtual ThrowCompletionOr<MarkedVector<Value>> internal_own_property_keys() const;
 
@@ -175,6 +182,7 @@ public:
     virtual void visit_edges(Cell::Visitor&) override;
 
     Value get_direct(size_t index) const { return m_storage[index]; }
+    void put_direct(size_t index, Value value) { m_storage[index] = value; }
 
     IndexedProperties const& indexed_properties() const { return m_indexed_properties; }
     IndexedProperties& indexed_properties() { return m_indexed_properties; }
@@ -185,6 +193,10 @@ public:
 
     void ensure_shape_is_unique();
 
+    // Set on objects that an inline cache looked through to find a property on the prototype chain.
+    bool is_cached_prototype() const { return m_is_cached_prototype; }
+    void set_is_cached_prototype() { m_is_cached_prototype = true; }
+
     template<typename T>
     bool fast_is() const = delete;
 
@@ -210,9 +222,13 @@ protected:
 private:
     void set_shape(Shape& shape) { m_shape = &shape; }
 
+    void invalidate_cached_prototype_chains_if_needed();
+
     Object* prototype() { return shape().prototype(); }
     Object const* prototype() const { return shape().prototype(); }
 
+    bool m_is_cached_prototype { false };
+
     Shape* m_shape { nullptr };
     Vector<Value> m_storage;
     IndexedProperties m_indexed_properties;
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AllOf.h>
 #include <AK/CharacterTypes.h>
 #include <AK/Utf16View.h>
 #include <AK/Utf8View.h>
@@ -18,6 +19,10 @@
 
 namespace JS {
 
+// Concatenations shorter than this are flattened right away, as building and later resolving a rope costs more
+// than copying a handful of characters, and flattening lets the garbage collector have the pieces.
+static constexpr size_t minimum_rope_length = 13;
+
 PrimitiveString::PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs)
     : m_is_rope(true)
     , m_lhs(&lhs)
@@ -42,10 +47,18 @@ PrimitiveString::PrimitiveString(Utf16String string)
 
 PrimitiveString::~PrimitiveString()
 {
-    if (has_utf8_string())
-        vm().string_cache().remove(*m_utf8_string);
-    if (has_deprecated_string())
-        vm().deprecated_string_cache().remove(*m_deprecated_string);
+    // NOTE: Strings that got their representation from resolving a rope or converting another one aren't in the caches,
+    //       but a different string with the same contents may be.
+    if (has_utf8_string()) {
+        auto& string_cache = vm().string_cache();
+        if (auto it = string_cache.find(*m_utf8_string); it != string_cache.end() && it->value == this)
+            string_cache.remove(it);
+    }
+    if (has_deprecated_string()) {
+        auto& string_cache = vm().deprecated_string_cache();
+        if (auto it = string_cache.find(*m_deprecated_string); it != string_cache.end() && it->value == this)
+            string_cache.remove(it);
+    }
 }
 
 void PrimitiveString::visit_edges(Cell::Visitor& visitor)
@@ -236,7 +249,30 @@ NonnullGCPtr<PrimitiveString> PrimitiveString::create(VM& vm, PrimitiveString& l
     if (rhs_empty)
         return lhs;
 
-    return vm.heap().allocate_without_realm<PrimitiveString>(lhs, rhs);
+    auto string = vm.heap().allocate_without_realm<PrimitiveString>(lhs, rhs);
+
+    auto lhs_length = lhs.length_if_flat();
+    auto rhs_length = rhs.length_if_flat();
+    if (lhs_length.has_value() && rhs_length.has_value() && *lhs_length + *rhs_length < minimum_rope_length) {
+        // NOTE: If this fails, the string simply stays a rope, and resolving it will throw later on.
+        (void)string->resolve_rope_if_needed();
+    }
+
+    return string;
+}
+
+// Returns the length of a string that isn't a rope, in whichever unit its existing representation uses.
+Optional<size_t> PrimitiveString::length_if_flat() const
+{
+    if (m_is_rope)
+        return {};
+    if (has_utf8_string())
+        return m_utf8_string->bytes().size();
+    if (has_deprecated_string())
+        return m_deprecated_string->length();
+    if (has_utf16_string())
+        return m_utf16_string->length_in_code_units();
+    VERIFY_NOT_REACHED();
 }
 
 ThrowCompletionOr<void> PrimitiveString::resolve_rope_if_needed() const
@@ -246,24 +282,6 @@ ThrowCompletionOr<void> PrimitiveString::resolve_rope_if_needed() const
 
     auto& vm = this->vm();
 
-    // NOTE: Special case for two concatenated UTF-16 strings.
-    //       This is here as an optimization, although I'm unsure how valuable it is.
-    if (m_lhs->has_utf16_string() && m_rhs->has_utf16_string()) {
-        auto const& lhs_string = m_lhs->m_utf16_string.value();
-        auto const& rhs_string = m_rhs->m_utf16_string.value();
-
-        Utf16Data combined;
-        TRY_OR_THROW_OOM(vm, combined.try_ensure_capacity(lhs_string.length_in_code_units() + rhs_string.length_in_code_units()));
-        combined.extend(lhs_string.string());
-        combined.extend(rhs_string.string());
-
-        m_utf16_string = TRY(Utf16String::create(vm, move(combined)));
-        m_is_rope = false;
-        m_lhs = nullptr;
-        m_rhs = nullptr;
-        return {};
-    }
-
     // This vector will hold all the pieces of the rope that need to be assembled
     // into the resolved string.
     Vector<PrimitiveString const*> pieces;
@@ -283,6 +301,25 @@ ThrowCompletionOr<void> PrimitiveString::resolve_rope_if_needed() const
         TRY_OR_THROW_OOM(vm, pieces.try_append(current));
     }
 
+    // NOTE: If all the pieces are UTF-16 already, join them as UTF-16. That needs no conversion to UTF-8 and back,
+    //       and surrogate pairs split across two pieces come back together by themselves.
+    if (all_of(pieces, [](auto const* piece) { return piece->has_utf16_string(); })) {
+        size_t length_in_code_units = 0;
+        for (auto const* piece : pieces)
+            length_in_code_units += piece->m_utf16_string->length_in_code_units();
+
+        Utf16Data combined;
+        TRY_OR_THROW_OOM(vm, combined.try_ensure_capacity(length_in_code_units));
+        for (auto const* piece : pieces)
+            combined.extend(piece->m_utf16_string->string());
+
+        m_utf16_string = TRY(Utf16String::create(vm, move(combined)));
+        m_is_rope = false;
+        m_lhs = nullptr;
+        m_rhs = nullptr;
+        return {};
+    }
+
     // Now that we have all the pieces, we can concatenate them using a StringBuilder.
     ThrowableStringBuilder builder(vm);
 
@@ -59,6 +59,7 @@ private:
     virtual void visit_edges(Cell::Visitor&) override;
 
     ThrowCompletionOr<void> resolve_rope_if_needed() const;
+    Optional<size_t> length_if_flat() const;
 
     mutable bool m_is_rope { false };
 
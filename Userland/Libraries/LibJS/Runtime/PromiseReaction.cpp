@@ -26,6 +26,7 @@ void PromiseReaction::visit_edges(Cell::Visitor& visitor)
 {
     Cell::visit_edges(visitor);
     visitor.visit(m_capability);
+    visitor.visit(m_job_argument);
 }
 
 }
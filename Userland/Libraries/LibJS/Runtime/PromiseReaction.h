@@ -10,6 +10,7 @@
 #include <LibJS/Forward.h>
 #include <LibJS/Heap/Cell.h>
 #include <LibJS/Runtime/JobCallback.h>
+#include <LibJS/Runtime/Value.h>
 
 namespace JS {
 
@@ -33,6 +34,10 @@ public:
     Optional<JobCallback>& handler() { return m_handler; }
     Optional<JobCallback> const& handler() const { return m_handler; }
 
+    // NOTE: A reaction is only ever triggered once, so its job keeps the argument here instead of in a Handle of its own.
+    Value job_argument() const { return m_job_argument; }
+    void set_job_argument(Value argument) { m_job_argument = argument; }
+
 private:
     PromiseReaction(Type type, GCPtr<PromiseCapability> capability, Optional<JobCallback> handler);
 
@@ -41,6 +46,7 @@ private:
     Type m_type;
     GCPtr<PromiseCapability> m_capability;
     Optional<JobCallback> m_handler;
+    Value m_job_argument;
 };
 
 }
@@ -39,6 +39,9 @@ public:
     Optional<bool> writable {};
     Optional<bool> enumerable {};
     Optional<bool> configurable {};
+
+    // Not part of the spec: set when the descriptor describes a property in an ordinary object's storage.
+    Optional<u32> property_offset {};
 };
 
 }
@@ -22,6 +22,38 @@ Shape* Shape::create_unique_clone() const
     return new_shape;
 }
 
+bool Shape::should_become_unique_before_adding(StringOrSymbol const& property_key, PropertyAttributes attributes)
+{
+    VERIFY(!is_unique());
+    if (m_property_count > max_property_count_for_transitions)
+        return true;
+    if (!m_forward_transitions || m_forward_transitions->size() < max_forward_transitions_per_shape)
+        return false;
+    return !get_or_prune_cached_forward_transition({ property_key, attributes });
+}
+
+ShapeStatistics Shape::statistics(Heap& heap)
+{
+    ShapeStatistics statistics;
+    heap.for_each_live_cell([&](Cell* cell) {
+        auto const* shape = dynamic_cast<Shape const*>(cell);
+        if (!shape)
+            return;
+        ++statistics.shape_count;
+        if (shape->m_unique)
+            ++statistics.unique_shape_count;
+        if (shape->m_property_table) {
+            ++statistics.shapes_with_property_table;
+            statistics.property_table_entry_count += shape->m_property_table->size();
+        }
+        if (shape->m_forward_transitions)
+            statistics.forward_transition_count += shape->m_forward_transitions->size();
+        if (shape->m_prototype_transitions)
+            statistics.prototype_transition_count += shape->m_prototype_transitions->size();
+    });
+    return statistics;
+}
+
 Shape* Shape::get_or_prune_cached_forward_transition(TransitionKey const& key)
 {
     if (!m_forward_transitions)
@@ -34,6 +34,15 @@ struct TransitionKey {
     }
 };
 
+struct ShapeStatistics {
+    size_t shape_count { 0 };
+    size_t unique_shape_count { 0 };
+    size_t shapes_with_property_table { 0 };
+    size_t property_table_entry_count { 0 };
+    size_t forward_transition_count { 0 };
+    size_t prototype_transition_count { 0 };
+};
+
 class Shape final
     : public Cell
     , public Weakable<Shape> {
@@ -42,6 +51,14 @@ class Shape final
 public:
     virtual ~Shape() override = default;
 
+    // Adding more properties than this to an object makes it stop doing transitions.
+    static constexpr u32 max_property_count_for_transitions = 100;
+    // Once this many different properties have been added to objects of the same shape (as happens when objects
+    // are used as hash maps), objects adding yet another one stop doing transitions.
+    static constexpr size_t max_forward_transitions_per_shape = 256;
+
+    static ShapeStatistics statistics(Heap&);
+
     enum class TransitionType {
         Invalid,
         Put,
@@ -58,6 +75,7 @@ public:
 
     bool is_unique() const { return m_unique; }
     Shape* create_unique_clone() const;
+    bool should_become_unique_before_adding(StringOrSymbol const&, PropertyAttributes);
 
     Realm& realm() const { return m_realm; }
 
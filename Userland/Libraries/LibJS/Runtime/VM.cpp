@@ -652,7 +652,7 @@ void VM::run_queued_promise_jobs()
     dbgln_if(PROMISE_DEBUG, "Running queued promise jobs");
 
     while (!m_promise_jobs.is_empty()) {
-        auto job = m_promise_jobs.take_first();
+        auto job = m_promise_jobs.dequeue();
         dbgln_if(PROMISE_DEBUG, "Calling promise job function");
 
         [[maybe_unused]] auto result = job();
@@ -667,7 +667,7 @@ void VM::enqueue_promise_job(Function<ThrowCompletionOr<Value>()> job, Realm*)
     // - FIXME: Let scriptOrModule be GetActiveScriptOrModule() at the time HostEnqueuePromiseJob is invoked. If realm is not null, each time job is invoked the implementation must perform implementation-defined steps
     //          such that scriptOrModule is the active script or module at the time of job's invocation.
     // - Jobs must run in the same order as the HostEnqueuePromiseJob invocations that scheduled them.
-    m_promise_jobs.append(move(job));
+    m_promise_jobs.enqueue(move(job));
 }
 
 void VM::run_queued_finalization_registry_cleanup_jobs()
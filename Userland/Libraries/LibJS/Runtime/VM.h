@@ -11,6 +11,7 @@
 #include <AK/DeprecatedFlyString.h>
 #include <AK/Function.h>
 #include <AK/HashMap.h>
+#include <AK/Queue.h>
 #include <AK/RefCounted.h>
 #include <AK/StackInfo.h>
 #include <AK/Variant.h>
@@ -182,6 +183,10 @@ public:
     u32 execution_generation() const { return m_execution_generation; }
     void finish_execution_generation() { ++m_execution_generation; }
 
+    // Inline caches that found a property on the prototype chain stay valid as long as this doesn't change.
+    u64 prototype_chain_generation() const { return m_prototype_chain_generation; }
+    void invalidate_cached_prototype_chains() { ++m_prototype_chain_generation; }
+
     ThrowCompletionOr<Reference> resolve_binding(DeprecatedFlyString const&, Environment* = nullptr);
     ThrowCompletionOr<Reference> get_identifier_reference(Environment*, DeprecatedFlyString, bool strict, size_t hops = 0);
 
@@ -219,6 +224,9 @@ public:
 
     CustomData* custom_data() { return m_custom_data; }
 
+    SamplingProfiler* sampling_profiler() { return m_sampling_profiler; }
+    void set_sampling_profiler(SamplingProfiler* profiler) { m_sampling_profiler = profiler; }
+
     ThrowCompletionOr<void> destructuring_assignment_evaluation(NonnullRefPtr<BindingPattern> const& target, Value value);
     ThrowCompletionOr<void> binding_initialization(DeprecatedFlyString const& target, Value value, Environment* environment);
     ThrowCompletionOr<void> binding_initialization(NonnullRefPtr<BindingPattern> const& target, Value value, Environment* environment);
@@ -279,7 +287,7 @@ private:
     // GlobalSymbolRegistry, https://tc39.es/ecma262/#table-globalsymbolregistry-record-fields
     HashMap<String, NonnullGCPtr<Symbol>> m_global_symbol_registry;
 
-    Vector<Function<ThrowCompletionOr<Value>()>> m_promise_jobs;
+    Queue<Function<ThrowCompletionOr<Value>()>, 64> m_promise_jobs;
 
     Vector<FinalizationRegistry*> m_finalization_registry_cleanup_jobs;
 
@@ -304,8 +312,11 @@ private:
 #undef __JS_ENUMERATE
 
     u32 m_execution_generation { 0 };
+    u64 m_prototype_chain_generation { 0 };
 
     OwnPtr<CustomData> m_custom_data;
+
+    SamplingProfiler* m_sampling_profiler { nullptr };
 };
 
 ALWAYS_INLINE Heap& Cell::heap() const
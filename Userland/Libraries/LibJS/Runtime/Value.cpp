@@ -440,6 +440,11 @@ ThrowCompletionOr<String> Value::to_string(VM& vm) const
 // 7.1.17 ToString ( argument ), https://tc39.es/ecma262/#sec-tostring
 ThrowCompletionOr<DeprecatedString> Value::to_deprecated_string(VM& vm) const
 {
+    // NOTE: Strings keep the DeprecatedString they were converted to around, so passing the same one to a function
+    //       that takes a DeprecatedString over and over (as do most bindings of web APIs) doesn't copy it every time.
+    if (is_string())
+        return as_string().deprecated_string();
+
     return TRY(to_string(vm)).to_deprecated_string();
 }
 
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/TypeCasts.h>
+#include <LibJS/AST.h>
+#include <LibJS/Runtime/ECMAScriptFunctionObject.h>
+#include <LibJS/Runtime/ExecutionContext.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/SamplingProfiler.h>
+
+namespace JS {
+
+SamplingProfiler::SamplingProfiler(VM& vm, size_t safepoints_per_sample)
+    : m_vm(vm)
+    , m_safepoints_per_sample(max<size_t>(safepoints_per_sample, 1))
+    , m_safepoints_until_next_sample(m_safepoints_per_sample)
+    , m_start_time(Time::now_monotonic())
+    , m_last_sample_time(m_start_time)
+{
+    VERIFY(!m_vm.sampling_profiler());
+    m_vm.set_sampling_profiler(this);
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+    m_vm.set_sampling_profiler(nullptr);
+}
+
+static DeprecatedString stack_frame_name(ExecutionContext const& context)
+{
+    StringView name = context.function_name;
+    if (name.is_empty())
+        name = "(anonymous)"sv;
+
+    auto const* function = dynamic_cast<ECMAScriptFunctionObject const*>(context.function);
+    if (!function)
+        return name;
+
+    auto source_range = function->ecmascript_code().source_range();
+    return DeprecatedString::formatted("{} ({}:{}:{})", name, source_range.filename(), source_range.start.line, source_range.start.column);
+}
+
+size_t SamplingProfiler::intern_stack_frame(DeprecatedString name, Optional<size_t> parent)
+{
+    StackFrameKey key { move(name), parent };
+    if (auto index = m_stack_frame_indices.get(key); index.has_value())
+        return *index;
+
+    auto index = m_stack_frames.size();
+    m_stack_frames.append({ key.name, parent });
+    m_stack_frame_indices.set(move(key), index);
+    return index;
+}
+
+void SamplingProfiler::take_sample()
+{
+    m_safepoints_until_next_sample = m_safepoints_per_sample;
+
+    auto const& stack = m_vm.execution_context_stack();
+    if (stack.is_empty())
+        return;
+
+    Optional<size_t> stack_frame;
+    for (auto const* context : stack)
+        stack_frame = intern_stack_frame(stack_frame_name(*context), stack_frame);
+
+    auto now = Time::now_monotonic();
+    m_samples.append({ *stack_frame, now - m_start_time, now - m_last_sample_time });
+    m_last_sample_time = now;
+}
+
+DeprecatedString SamplingProfiler::to_chrome_trace() const
+{
+    JsonObject stack_frames;
+    for (size_t i = 0; i < m_stack_frames.size(); ++i) {
+        auto const& stack_frame = m_stack_frames[i];
+        JsonObject object;
+        object.set("name", stack_frame.name);
+        if (stack_frame.parent.has_value())
+            object.set("parent", DeprecatedString::number(*stack_frame.parent));
+        stack_frames.set(DeprecatedString::number(i), move(object));
+    }
+
+    JsonArray samples;
+    for (auto const& sample : m_samples) {
+        JsonObject object;
+        object.set("cpu", 0);
+        object.set("tid", 1);
+        object.set("name", "js");
+        object.set("ts", sample.timestamp.to_microseconds());
+        object.set("weight", sample.weight.to_microseconds());
+        object.set("sf", DeprecatedString::number(sample.stack_frame));
+        samples.append(move(object));
+    }
+
+    JsonObject trace;
+    trace.set("traceEvents", JsonArray {});
+    trace.set("stackFrames", move(stack_frames));
+    trace.set("samples", move(samples));
+    return trace.to_deprecated_string();
+}
+
+}
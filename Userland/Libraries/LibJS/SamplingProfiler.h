@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/DeprecatedString.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/Time.h>
+#include <AK/Vector.h>
+#include <LibJS/Forward.h>
+
+namespace JS {
+
+// Records the JS call stack every so many safepoints, which the bytecode interpreter reaches whenever it enters a basic
+// block. Time passes between samples, so every sample is weighted by how long it has been since the previous one.
+class SamplingProfiler {
+    AK_MAKE_NONCOPYABLE(SamplingProfiler);
+    AK_MAKE_NONMOVABLE(SamplingProfiler);
+
+public:
+    static constexpr size_t default_safepoints_per_sample = 1000;
+
+    explicit SamplingProfiler(VM&, size_t safepoints_per_sample = default_safepoints_per_sample);
+    ~SamplingProfiler();
+
+    ALWAYS_INLINE void did_reach_safepoint()
+    {
+        if (--m_safepoints_until_next_sample == 0)
+            take_sample();
+    }
+
+    size_t sample_count() const { return m_samples.size(); }
+
+    // Writes the samples in the Trace Event Format that chrome://tracing and Perfetto understand.
+    DeprecatedString to_chrome_trace() const;
+
+private:
+    struct StackFrame {
+        DeprecatedString name;
+        Optional<size_t> parent;
+    };
+
+    struct StackFrameKey {
+        DeprecatedString name;
+        Optional<size_t> parent;
+
+        bool operator==(StackFrameKey const&) const = default;
+    };
+
+    struct StackFrameKeyTraits : public GenericTraits<StackFrameKey> {
+        static unsigned hash(StackFrameKey const& key) { return pair_int_hash(key.name.hash(), key.parent.value_or(NumericLimits<size_t>::max())); }
+    };
+
+    struct Sample {
+        size_t stack_frame { 0 };
+        Time timestamp;
+        Time weight;
+    };
+
+    void take_sample();
+    size_t intern_stack_frame(DeprecatedString name, Optional<size_t> parent);
+
+    VM& m_vm;
+    size_t m_safepoints_per_sample { default_safepoints_per_sample };
+    size_t m_safepoints_until_next_sample { default_safepoints_per_sample };
+    Time m_start_time;
+    Time m_last_sample_time;
+
+    Vector<StackFrame> m_stack_frames;
+    HashMap<StackFrameKey, size_t, StackFrameKeyTraits> m_stack_frame_indices;
+    Vector<Sample> m_samples;
+};
+
+}
@@ -27,6 +27,11 @@ Result<NonnullGCPtr<Script>, Vector<ParserError>> Script::parse(StringView sourc
     return realm.heap().allocate_without_realm<Script>(realm, filename, move(script), host_defined);
 }
 
+NonnullGCPtr<Script> Script::create(Realm& realm, StringView filename, NonnullRefPtr<Program> parse_node, HostDefined* host_defined)
+{
+    return realm.heap().allocate_without_realm<Script>(realm, filename, move(parse_node), host_defined);
+}
+
 Script::Script(Realm& realm, StringView filename, NonnullRefPtr<Program> parse_node, HostDefined* host_defined)
     : m_realm(realm)
     , m_parse_node(move(parse_node))
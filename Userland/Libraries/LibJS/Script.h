@@ -28,6 +28,9 @@ public:
     virtual ~Script() override;
     static Result<NonnullGCPtr<Script>, Vector<ParserError>> parse(StringView source_text, Realm&, StringView filename = {}, HostDefined* = nullptr, size_t line_number_offset = 1);
 
+    // Creates a script record for a program that has been parsed before, e.g. by an earlier parse() of the same source text.
+    static NonnullGCPtr<Script> create(Realm&, StringView filename, NonnullRefPtr<Program>, HostDefined* = nullptr);
+
     Realm& realm() { return *m_realm; }
     Program const& parse_node() const { return *m_parse_node; }
 
@@ -33,6 +33,15 @@ String const& SourceCode::code() const
     return m_code;
 }
 
+DeprecatedString const& SourceText::text() const
+{
+    if (m_source_code) {
+        m_text = m_source_code->code().bytes_as_string_view().substring_view(m_start_offset, m_end_offset - m_start_offset);
+        m_source_code = nullptr;
+    }
+    return m_text;
+}
+
 void SourceCode::compute_line_break_offsets() const
 {
     m_line_break_offsets = Vector<size_t> {};
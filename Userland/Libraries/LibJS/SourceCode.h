@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/DeprecatedString.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
 #include <LibJS/Forward.h>
@@ -32,4 +33,32 @@ private:
     Optional<Vector<size_t>> mutable m_line_break_offsets;
 };
 
+// The [[SourceText]] of a function or class, which is only copied out of the source code once something asks for it.
+// NOTE: Most functions are never stringified, and eagerly copying the text of every nested function takes time and
+//       memory proportional to how deeply they're nested.
+class SourceText {
+public:
+    SourceText() = default;
+
+    SourceText(DeprecatedString text)
+        : m_text(move(text))
+    {
+    }
+
+    SourceText(NonnullRefPtr<SourceCode const> source_code, u32 start_offset, u32 end_offset)
+        : m_source_code(move(source_code))
+        , m_start_offset(start_offset)
+        , m_end_offset(end_offset)
+    {
+    }
+
+    DeprecatedString const& text() const;
+
+private:
+    mutable RefPtr<SourceCode const> m_source_code;
+    u32 m_start_offset { 0 };
+    u32 m_end_offset { 0 };
+    mutable DeprecatedString m_text { DeprecatedString::empty() };
+};
+
 }
@@ -0,0 +1,95 @@
+describe("push", () => {
+    test("appending to packed arrays", () => {
+        const array = [1, 2];
+        expect(array.push(3.5, "four", undefined)).toBe(5);
+        expect(array).toEqual([1, 2, 3.5, "four", undefined]);
+    });
+
+    test("setters on Array.prototype are still called", () => {
+        const values = [];
+        Object.defineProperty(Array.prototype, 2, {
+            set(value) {
+                values.push(value);
+            },
+            configurable: true,
+        });
+        const array = [1, 2];
+        array.push(3);
+        delete Array.prototype[2];
+        expect(values).toEqual([3]);
+        expect(array).toHaveLength(3);
+        expect(array.hasOwnProperty(2)).toBeFalse();
+    });
+
+    test("non-writable length", () => {
+        const array = [1, 2];
+        Object.defineProperty(array, "length", { writable: false });
+        expect(() => array.push(3)).toThrow(TypeError);
+        expect(array).toEqual([1, 2]);
+    });
+
+    test("non-extensible arrays", () => {
+        const array = [1, 2];
+        Object.preventExtensions(array);
+        expect(() => array.push(3)).toThrow(TypeError);
+        expect(array).toEqual([1, 2]);
+    });
+});
+
+describe("indexOf", () => {
+    test("int32, double and other elements", () => {
+        expect([1, 2, 3].indexOf(3)).toBe(2);
+        expect([1, 2, 3].indexOf(3.5)).toBe(-1);
+        expect([1.5, 2.5, 3].indexOf(3)).toBe(2);
+        expect([1, "2", 3].indexOf("2")).toBe(1);
+        expect([0].indexOf(-0)).toBe(0);
+        expect([NaN].indexOf(NaN)).toBe(-1);
+    });
+
+    test("array shrunk while converting fromIndex", () => {
+        const array = [1, 2, 3, 4];
+        Array.prototype[3] = 4;
+        const fromIndex = {
+            valueOf() {
+                array.length = 1;
+                return 0;
+            },
+        };
+        const result = array.indexOf(4, fromIndex);
+        delete Array.prototype[3];
+        expect(result).toBe(3);
+    });
+});
+
+describe("map", () => {
+    test("callback deleting elements", () => {
+        const array = [1, 2, 3, 4];
+        const result = array.map((value, index) => {
+            if (index === 0) array.pop();
+            return value * 2;
+        });
+        expect(result).toHaveLength(4);
+        expect(result[0]).toBe(2);
+        expect(result[2]).toBe(6);
+        expect(result.hasOwnProperty(3)).toBeFalse();
+    });
+});
+
+describe("sort", () => {
+    test("int32 elements are compared as strings", () => {
+        expect([10, 9, 1, -1, -10, 2147483647, -2147483648].sort()).toEqual([
+            -1, -10, -2147483648, 1, 10, 2147483647, 9,
+        ]);
+    });
+
+    test("array frozen by the comparator", () => {
+        const array = [3, 2, 1];
+        expect(() =>
+            array.sort((a, b) => {
+                Object.freeze(array);
+                return a - b;
+            })
+        ).toThrow(TypeError);
+        expect(array).toEqual([3, 2, 1]);
+    });
+});
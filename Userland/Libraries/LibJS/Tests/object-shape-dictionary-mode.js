@@ -0,0 +1,43 @@
+// Objects stop sharing shapes once they get lots of properties, or when lots of objects add different properties to
+// the same shape. These make sure the properties behave the same either way.
+
+test("objects with lots of properties", () => {
+    const object = {};
+    for (let i = 0; i < 300; ++i) object[`key${i}`] = i;
+    expect(Object.keys(object)).toHaveLength(300);
+    expect(Object.keys(object)[150]).toBe("key150");
+    expect(object.key299).toBe(299);
+
+    delete object.key0;
+    object.key0 = "again";
+    expect(Object.keys(object)[299]).toBe("key0");
+});
+
+test("objects used as hash maps with different keys", () => {
+    const objects = [];
+    for (let i = 0; i < 1000; ++i) {
+        const object = {};
+        object[`first${i}`] = i;
+        object.second = i * 2;
+        objects.push(object);
+    }
+    for (let i = 0; i < 1000; ++i) {
+        expect(Object.keys(objects[i])).toEqual([`first${i}`, "second"]);
+        expect(objects[i][`first${i}`]).toBe(i);
+        expect(objects[i].second).toBe(i * 2);
+    }
+});
+
+test("shared shapes keep working after the transitions fan out", () => {
+    for (let i = 0; i < 1000; ++i) ({})[`unrelated${i}`] = i;
+    const a = { x: 1, y: 2 };
+    const b = { x: 3, y: 4 };
+    const getY = object => object.y;
+    for (let i = 0; i < 3; ++i) {
+        expect(getY(a)).toBe(2);
+        expect(getY(b)).toBe(4);
+    }
+    Object.defineProperty(b, "y", { value: 5, writable: false });
+    expect(getY(b)).toBe(5);
+    expect(getY(a)).toBe(2);
+});
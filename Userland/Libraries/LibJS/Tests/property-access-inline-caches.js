@@ -0,0 +1,84 @@
+// Every access below runs through the same GetById/PutById instruction, so these make sure a cached lookup notices when
+// the objects involved change underneath it.
+
+const getFoo = object => object.foo;
+const setFoo = (object, value) => {
+    object.foo = value;
+};
+
+test("own properties of objects with different shapes", () => {
+    const objects = [{ foo: 1 }, { bar: 0, foo: 2 }, { baz: 0, bar: 0, foo: 3 }, { foo: 4, bar: 0 }, { qux: 0, foo: 5 }];
+    for (let i = 0; i < 3; ++i) {
+        objects.forEach((object, index) => {
+            expect(getFoo(object)).toBe(index + 1);
+        });
+    }
+});
+
+test("property on the prototype chain", () => {
+    const base = { foo: "base" };
+    const middle = Object.create(base);
+    const object = Object.create(middle);
+    for (let i = 0; i < 3; ++i) expect(getFoo(object)).toBe("base");
+
+    base.foo = "changed";
+    expect(getFoo(object)).toBe("changed");
+
+    middle.foo = "middle";
+    expect(getFoo(object)).toBe("middle");
+
+    delete middle.foo;
+    expect(getFoo(object)).toBe("changed");
+
+    Object.setPrototypeOf(middle, { foo: "other base" });
+    expect(getFoo(object)).toBe("other base");
+
+    Object.setPrototypeOf(middle, null);
+    expect(getFoo(object)).toBeUndefined();
+});
+
+test("property redefined as an accessor", () => {
+    const object = { foo: 1 };
+    for (let i = 0; i < 3; ++i) expect(getFoo(object)).toBe(1);
+
+    Object.defineProperty(object, "foo", { get: () => "getter", configurable: true, enumerable: true });
+    expect(getFoo(object)).toBe("getter");
+
+    const derived = Object.create({ foo: 1 });
+    for (let i = 0; i < 3; ++i) expect(getFoo(derived)).toBe(1);
+    Object.defineProperty(Object.getPrototypeOf(derived), "foo", { get: () => "prototype getter" });
+    expect(getFoo(derived)).toBe("prototype getter");
+});
+
+test("setting own properties", () => {
+    const first = { foo: 0 };
+    const second = { foo: 0 };
+    for (let i = 0; i < 3; ++i) {
+        setFoo(first, i);
+        setFoo(second, i * 2);
+    }
+    expect(first.foo).toBe(2);
+    expect(second.foo).toBe(4);
+
+    Object.freeze(first);
+    setFoo(first, 10);
+    expect(first.foo).toBe(2);
+
+    let setterValue;
+    Object.defineProperty(second, "foo", {
+        set: value => {
+            setterValue = value;
+        },
+    });
+    setFoo(second, 20);
+    expect(setterValue).toBe(20);
+});
+
+test("setting a property that only exists on the prototype", () => {
+    const base = { foo: "base" };
+    const object = Object.create(base);
+    for (let i = 0; i < 3; ++i) setFoo(object, i);
+    expect(object.foo).toBe(2);
+    expect(base.foo).toBe("base");
+    expect(Object.getOwnPropertyNames(object)).toEqual(["foo"]);
+});
@@ -28,3 +28,25 @@ test("adding strings with dangling surrogates", () => {
     expect("\ud834a" + "\udf06").toBe("\ud834a\udf06");
     expect("\ud834" + "a\udf06").toBe("\ud834a\udf06");
 });
+
+test("adding long and short strings in a loop", () => {
+    let short = "";
+    let long = "";
+    for (let i = 0; i < 100; ++i) {
+        short = "ab" + (i % 10);
+        long += short;
+        expect(short).toHaveLength(3);
+    }
+    expect(long).toHaveLength(300);
+    expect(long.slice(0, 9)).toBe("ab0ab1ab2");
+    expect(long.slice(-6)).toBe("ab8ab9");
+});
+
+test("adding strings that are UTF-16 already", () => {
+    const high = "𝌆".charAt(0);
+    const low = "𝌆".charAt(1);
+    const joined = high + low + high + low;
+    expect(joined).toBe("𝌆𝌆");
+    expect(joined.length).toBe(4);
+    expect(joined.codePointAt(2)).toBe(0x1d306);
+});
@@ -76,6 +76,7 @@ PDFErrorOr<void> Document::initialize()
 
 PDFErrorOr<Value> Document::get_or_load_value(u32 index)
 {
+    Threading::MutexLocker locker(m_lock);
     auto value = get_value(index);
     if (!value.has<Empty>()) // FIXME: Use Optional instead?
         return value;
@@ -101,6 +102,7 @@ PDFErrorOr<Page> Document::get_page(u32 index)
 {
     VERIFY(index < m_page_object_indices.size());
 
+    Threading::MutexLocker locker(m_lock);
     auto cached_page = m_pages.get(index);
     if (cached_page.has_value())
         return cached_page.value();
@@ -6,15 +6,16 @@
 
 #pragma once
 
+#include <AK/AtomicRefCounted.h>
 #include <AK/Format.h>
 #include <AK/HashMap.h>
-#include <AK/RefCounted.h>
 #include <AK/Weakable.h>
 #include <LibGfx/Color.h>
 #include <LibPDF/DocumentParser.h>
 #include <LibPDF/Encryption.h>
 #include <LibPDF/Error.h>
 #include <LibPDF/ObjectDerivatives.h>
+#include <LibThreading/Mutex.h>
 
 namespace PDF {
 
@@ -76,8 +77,11 @@ struct OutlineDict final : public RefCounted<OutlineDict> {
     OutlineDict() = default;
 };
 
+// Parsing objects and caching them is done under a lock, so a document can be rendered on another thread than the one
+// that opened it. The objects themselves aren't ref-counted atomically, though, so they mustn't be used by several
+// threads at the same time; only the document is.
 class Document final
-    : public RefCounted<Document>
+    : public AtomicRefCounted<Document>
     , public Weakable<Document> {
 public:
     static PDFErrorOr<NonnullRefPtr<Document>> create(ReadonlyBytes bytes);
@@ -103,6 +107,7 @@ public:
 
     ALWAYS_INLINE Value get_value(u32 index) const
     {
+        Threading::MutexLocker locker(m_lock);
         return m_values.get(index).value_or({});
     }
 
@@ -157,6 +162,9 @@ private:
     HashMap<u32, Value> m_values;
     RefPtr<OutlineDict> m_outline;
     RefPtr<SecurityHandler> m_security_handler;
+
+    // Guards the parser (which has a single read position) and the caches above.
+    mutable Threading::Mutex m_lock;
 };
 
 }
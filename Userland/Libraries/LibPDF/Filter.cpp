@@ -5,6 +5,7 @@
  */
 
 #include <AK/Hex.h>
+#include <AK/MemoryStream.h>
 #include <LibCompress/Deflate.h>
 #include <LibGfx/JPGLoader.h>
 #include <LibPDF/CommonNames.h>
@@ -136,69 +137,56 @@ ErrorOr<ByteBuffer> Filter::decode_ascii85(ReadonlyBytes bytes)
     return ByteBuffer::copy(buff.span());
 };
 
-ErrorOr<ByteBuffer> Filter::decode_png_prediction(Bytes bytes, int bytes_per_row)
+ErrorOr<void> Filter::decode_png_prediction_row(Bytes row, ReadonlyBytes previous_row)
 {
-    int number_of_rows = bytes.size() / bytes_per_row;
-
-    ByteBuffer decoded;
-    decoded.ensure_capacity(bytes.size() - number_of_rows);
-
-    auto empty_row = TRY(ByteBuffer::create_zeroed(bytes_per_row));
-    auto previous_row = empty_row.data();
-
-    for (int row_index = 0; row_index < number_of_rows; ++row_index) {
-        auto row = bytes.data() + row_index * bytes_per_row;
-
-        u8 algorithm_tag = row[0];
-        switch (algorithm_tag) {
-        case 0:
-            break;
-        case 1:
-            for (int i = 2; i < bytes_per_row; ++i)
-                row[i] += row[i - 1];
-            break;
-        case 2:
-            for (int i = 1; i < bytes_per_row; ++i)
-                row[i] += previous_row[i];
-            break;
-        case 3:
-            for (int i = 1; i < bytes_per_row; ++i) {
-                u8 left = 0;
-                if (i > 1)
-                    left = row[i - 1];
-                u8 above = previous_row[i];
-                row[i] += (left + above) / 2;
+    int bytes_per_row = row.size();
+
+    u8 algorithm_tag = row[0];
+    switch (algorithm_tag) {
+    case 0:
+        break;
+    case 1:
+        for (int i = 2; i < bytes_per_row; ++i)
+            row[i] += row[i - 1];
+        break;
+    case 2:
+        for (int i = 1; i < bytes_per_row; ++i)
+            row[i] += previous_row[i];
+        break;
+    case 3:
+        for (int i = 1; i < bytes_per_row; ++i) {
+            u8 left = 0;
+            if (i > 1)
+                left = row[i - 1];
+            u8 above = previous_row[i];
+            row[i] += (left + above) / 2;
+        }
+        break;
+    case 4:
+        for (int i = 1; i < bytes_per_row; ++i) {
+            u8 left = 0;
+            u8 upper_left = 0;
+            if (i > 1) {
+                left = row[i - 1];
+                upper_left = previous_row[i - 1];
             }
-            break;
-        case 4:
-            for (int i = 1; i < bytes_per_row; ++i) {
-                u8 left = 0;
-                u8 upper_left = 0;
-                if (i > 1) {
-                    left = row[i - 1];
-                    upper_left = previous_row[i - 1];
-                }
-                u8 above = previous_row[i];
-                u8 p = left + above - upper_left;
+            u8 above = previous_row[i];
+            u8 p = left + above - upper_left;
 
-                int left_distance = abs(p - left);
-                int above_distance = abs(p - above);
-                int upper_left_distance = abs(p - upper_left);
+            int left_distance = abs(p - left);
+            int above_distance = abs(p - above);
+            int upper_left_distance = abs(p - upper_left);
 
-                u8 paeth = min(left_distance, min(above_distance, upper_left_distance));
+            u8 paeth = min(left_distance, min(above_distance, upper_left_distance));
 
-                row[i] += paeth;
-            }
-            break;
-        default:
-            return AK::Error::from_string_literal("Unknown PNG algorithm tag");
+            row[i] += paeth;
         }
-
-        previous_row = row;
-        decoded.append(row + 1, bytes_per_row - 1);
+        break;
+    default:
+        return AK::Error::from_string_literal("Unknown PNG algorithm tag");
     }
 
-    return decoded;
+    return {};
 }
 
 ErrorOr<ByteBuffer> Filter::decode_lzw(ReadonlyBytes)
@@ -209,22 +197,49 @@ ErrorOr<ByteBuffer> Filter::decode_lzw(ReadonlyBytes)
 
 ErrorOr<ByteBuffer> Filter::decode_flate(ReadonlyBytes bytes, int predictor, int columns, int colors, int bits_per_component)
 {
-    auto buff = Compress::DeflateDecompressor::decompress_all(bytes.slice(2)).value();
-    if (predictor == 1)
-        return buff;
-
     // Check if we are dealing with a PNG prediction
     if (predictor == 2)
         return AK::Error::from_string_literal("The TIFF predictor is not supported");
-    if (predictor < 10 || predictor > 15)
+    if (predictor != 1 && (predictor < 10 || predictor > 15))
         return AK::Error::from_string_literal("Invalid predictor value");
 
-    // Rows are always a whole number of bytes long, starting with an algorithm tag
+    // The data is decompressed a piece at a time, straight into the output, so that there's never a second copy of
+    // all of it around (streams of scanned pages can easily be tens of megabytes once decompressed).
+    auto memory_stream = TRY(try_make<FixedMemoryStream>(bytes.slice(2)));
+    auto deflate_stream = TRY(Compress::DeflateDecompressor::construct(move(memory_stream)));
+
+    ByteBuffer decoded;
+    if (predictor == 1) {
+        Array<u8, 4096> buffer;
+        while (!deflate_stream->is_eof()) {
+            auto slice = TRY(deflate_stream->read(buffer));
+            TRY(decoded.try_append(slice));
+        }
+        return decoded;
+    }
+
+    // Rows are always a whole number of bytes long, starting with an algorithm tag, and only depend on the row before
+    // them, so they're undone as soon as they've been read.
     int bytes_per_row = AK::ceil_div(columns * colors * bits_per_component, 8) + 1;
-    if (buff.size() % bytes_per_row)
-        return AK::Error::from_string_literal("Flate input data is not divisible into columns");
+    auto row = TRY(ByteBuffer::create_zeroed(bytes_per_row));
+    auto previous_row = TRY(ByteBuffer::create_zeroed(bytes_per_row));
+
+    while (true) {
+        size_t row_size = 0;
+        while (row_size < row.size() && !deflate_stream->is_eof())
+            row_size += TRY(deflate_stream->read(row.bytes().slice(row_size))).size();
 
-    return decode_png_prediction(buff, bytes_per_row);
+        if (row_size == 0)
+            break;
+        if (row_size != row.size())
+            return AK::Error::from_string_literal("Flate input data is not divisible into columns");
+
+        TRY(decode_png_prediction_row(row, previous_row));
+        TRY(decoded.try_append(row.bytes().slice(1)));
+        swap(row, previous_row);
+    }
+
+    return decoded;
 };
 
 ErrorOr<ByteBuffer> Filter::decode_run_length(ReadonlyBytes bytes)
@@ -269,14 +284,11 @@ ErrorOr<ByteBuffer> Filter::decode_jbig2(ReadonlyBytes)
 
 ErrorOr<ByteBuffer> Filter::decode_dct(ReadonlyBytes bytes)
 {
-    if (Gfx::JPGImageDecoderPlugin::sniff({ bytes.data(), bytes.size() }).release_value_but_fixme_should_propagate_errors()) {
-        auto decoder = Gfx::JPGImageDecoderPlugin::create({ bytes.data(), bytes.size() }).release_value_but_fixme_should_propagate_errors();
-        if (decoder->initialize()) {
-            auto frame = TRY(decoder->frame(0));
-            return frame.image->serialize_to_byte_buffer();
-        }
-    }
-    return AK::Error::from_string_literal("Not a JPG image!");
+    // The image is only decoded once it's drawn, when the size it's drawn at is known. Keeping the decoded pixels
+    // around instead would take up many times the space of the compressed data for as long as the stream is cached.
+    if (!TRY(Gfx::JPGImageDecoderPlugin::sniff(bytes)))
+        return AK::Error::from_string_literal("Not a JPG image!");
+    return ByteBuffer::copy(bytes);
 };
 
 ErrorOr<ByteBuffer> Filter::decode_jpx(ReadonlyBytes)
@@ -20,7 +20,7 @@ public:
 private:
     static ErrorOr<ByteBuffer> decode_ascii_hex(ReadonlyBytes bytes);
     static ErrorOr<ByteBuffer> decode_ascii85(ReadonlyBytes bytes);
-    static ErrorOr<ByteBuffer> decode_png_prediction(Bytes bytes, int bytes_per_row);
+    static ErrorOr<void> decode_png_prediction_row(Bytes row, ReadonlyBytes previous_row);
     static ErrorOr<ByteBuffer> decode_lzw(ReadonlyBytes bytes);
     static ErrorOr<ByteBuffer> decode_flate(ReadonlyBytes bytes, int predictor, int columns, int colors, int bits_per_component);
     static ErrorOr<ByteBuffer> decode_run_length(ReadonlyBytes bytes);
@@ -14,13 +14,6 @@
 
 namespace PDF {
 
-PDFErrorOr<Vector<Operator>> Parser::parse_operators(Document* document, ReadonlyBytes bytes)
-{
-    Parser parser(document, bytes);
-    parser.m_disable_encryption = true;
-    return parser.parse_operators();
-}
-
 Parser::Parser(Document* document, ReadonlyBytes bytes)
     : m_reader(bytes)
     , m_document(document)
@@ -520,11 +513,8 @@ PDFErrorOr<NonnullRefPtr<StreamObject>> Parser::parse_stream(NonnullRefPtr<DictO
     return stream_object;
 }
 
-PDFErrorOr<Vector<Operator>> Parser::parse_operators()
+PDFErrorOr<Optional<Operator>> Parser::parse_next_operator(Vector<Value>& operator_args)
 {
-    Vector<Operator> operators;
-    Vector<Value> operator_args;
-
     constexpr static auto is_operator_char = [](char ch) {
         return isalpha(ch) || ch == '*' || ch == '\'';
     };
@@ -544,11 +534,11 @@ PDFErrorOr<Vector<Operator>> Parser::parse_operators()
 
             auto operator_string = StringView(m_reader.bytes().slice(operator_start, m_reader.offset() - operator_start));
             auto operator_type = Operator::operator_type_from_symbol(operator_string);
-            operators.append(Operator(operator_type, move(operator_args)));
+            auto op = Operator(operator_type, move(operator_args));
             operator_args = Vector<Value>();
             m_reader.consume_whitespace();
 
-            continue;
+            return op;
         }
 
         // Note: We disallow parsing indirect values here, since
@@ -557,7 +547,7 @@ PDFErrorOr<Vector<Operator>> Parser::parse_operators()
         operator_args.append(v);
     }
 
-    return operators;
+    return Optional<Operator> {};
 }
 
 Error Parser::error(
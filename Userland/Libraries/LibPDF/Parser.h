@@ -27,12 +27,11 @@ class Document;
 
 class Parser {
 public:
-    static PDFErrorOr<Vector<Operator>> parse_operators(Document*, ReadonlyBytes);
-
     Parser(ReadonlyBytes);
     Parser(Document*, ReadonlyBytes);
 
     void set_document(WeakPtr<Document> const&);
+    void disable_encryption() { m_disable_encryption = true; }
 
     DeprecatedString parse_comment();
 
@@ -56,7 +55,11 @@ public:
     PDFErrorOr<NonnullRefPtr<ArrayObject>> parse_array();
     PDFErrorOr<NonnullRefPtr<DictObject>> parse_dict();
     PDFErrorOr<NonnullRefPtr<StreamObject>> parse_stream(NonnullRefPtr<DictObject> dict);
-    PDFErrorOr<Vector<Operator>> parse_operators();
+
+    // Content streams are parsed one operator at a time, so that each operator can be handled before the next one is
+    // looked at. An operator's operands can be split over several streams, which is why they're collected in a vector
+    // that the caller keeps around. Returns nothing once the end of the stream has been reached.
+    PDFErrorOr<Optional<Operator>> parse_next_operator(Vector<Value>& operator_args);
 
 protected:
     void push_reference(Reference const& ref) { m_current_reference_stack.append(ref); }
@@ -5,6 +5,7 @@
  */
 
 #include <AK/Utf8View.h>
+#include <LibGfx/JPGLoader.h>
 #include <LibPDF/CommonNames.h>
 #include <LibPDF/Fonts/PDFFont.h>
 #include <LibPDF/Interpolation.h>
@@ -21,9 +22,11 @@
 
 namespace PDF {
 
-PDFErrorsOr<void> Renderer::render(Document& document, Page const& page, RefPtr<Gfx::Bitmap> bitmap, RenderingPreferences rendering_preferences)
+PDFErrorsOr<void> Renderer::render(Document& document, Page const& page, RefPtr<Gfx::Bitmap> bitmap, RenderingPreferences rendering_preferences, Function<bool()> is_cancelled)
 {
-    return Renderer(document, page, bitmap, rendering_preferences).render();
+    Renderer renderer(document, page, bitmap, rendering_preferences);
+    renderer.m_is_cancelled = move(is_cancelled);
+    return renderer.render();
 }
 
 static void rect_path(Gfx::Path& path, float x, float y, float width, float height)
@@ -85,31 +88,37 @@ Renderer::Renderer(RefPtr<Document> document, Page const& page, RefPtr<Gfx::Bitm
 
 PDFErrorsOr<void> Renderer::render()
 {
-    // Use our own vector, as the /Content can be an array with multiple
-    // streams which gets concatenated
+    // The /Content can be an array with multiple streams, which are treated
+    // as if they were concatenated. Each operator is handled as soon as it
+    // has been parsed, so the operators of a page are never all kept around.
     // FIXME: Text operators are supposed to only have effects on the current
     // stream object. Do the text operators treat this concatenated stream
     // as one stream or multiple?
-    ByteBuffer byte_buffer;
+    Vector<NonnullRefPtr<StreamObject>> content_streams;
 
     if (m_page.contents->is<ArrayObject>()) {
         auto contents = m_page.contents->cast<ArrayObject>();
-        for (auto& ref : *contents) {
-            auto bytes = TRY(m_document->resolve_to<StreamObject>(ref))->bytes();
-            byte_buffer.append(bytes.data(), bytes.size());
-        }
+        for (auto& ref : *contents)
+            content_streams.append(TRY(m_document->resolve_to<StreamObject>(ref)));
     } else {
-        auto bytes = m_page.contents->cast<StreamObject>()->bytes();
-        byte_buffer.append(bytes.data(), bytes.size());
+        content_streams.append(m_page.contents->cast<StreamObject>());
     }
 
-    auto operators = TRY(Parser::parse_operators(m_document, byte_buffer));
-
     Errors errors;
-    for (auto& op : operators) {
-        auto maybe_error = handle_operator(op);
-        if (maybe_error.is_error()) {
-            errors.add_error(maybe_error.release_error());
+    Vector<Value> operator_args;
+    for (auto& content_stream : content_streams) {
+        Parser parser(m_document, content_stream->bytes());
+        parser.disable_encryption();
+
+        while (!(m_is_cancelled && m_is_cancelled())) {
+            auto op = TRY(parser.parse_next_operator(operator_args));
+            if (!op.has_value())
+                break;
+
+            auto maybe_error = handle_operator(op.value());
+            if (maybe_error.is_error()) {
+                errors.add_error(maybe_error.release_error());
+            }
         }
     }
     if (!errors.errors().is_empty())
@@ -641,9 +650,15 @@ RENDERER_HANDLER(paint_xobject)
         matrix = Vector { Value { 1 }, Value { 0 }, Value { 0 }, Value { 1 }, Value { 0 }, Value { 0 } };
     }
     MUST(handle_concatenate_matrix(matrix));
-    auto operators = TRY(Parser::parse_operators(m_document, xobject->bytes()));
-    for (auto& op : operators)
-        TRY(handle_operator(op, xobject_resources));
+    Parser parser(m_document, xobject->bytes());
+    parser.disable_encryption();
+    Vector<Value> operator_args;
+    while (true) {
+        auto op = TRY(parser.parse_next_operator(operator_args));
+        if (!op.has_value())
+            break;
+        TRY(handle_operator(op.value(), xobject_resources));
+    }
     MUST(handle_restore_state({}));
     return {};
 }
@@ -750,7 +765,7 @@ void Renderer::show_text(DeprecatedString const& string)
     m_text_matrix.translate(delta_x / text_rendering_matrix.x_scale(), 0.0f);
 }
 
-PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> Renderer::load_image(NonnullRefPtr<StreamObject> image)
+PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> Renderer::load_image(NonnullRefPtr<StreamObject> image, Gfx::IntSize target_size)
 {
     auto image_dict = image->dict();
     auto filter_object = TRY(image_dict->get_object(m_document, CommonNames::Filter));
@@ -795,34 +810,74 @@ PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> Renderer::load_image(NonnullRefPtr<Stream
     }
 
     if (is_filter(CommonNames::DCTDecode)) {
-        // TODO: stream objects could store Variant<bytes/Bitmap> to avoid seialisation/deserialisation here
-        return TRY(Gfx::Bitmap::create_from_serialized_bytes(image->bytes()));
+        // The DCTDecode filter leaves the JPG data as it is, so that it's only decoded for as long as it's needed.
+        auto decoder = TRY(Gfx::JPGImageDecoderPlugin::create(image->bytes()));
+        if (!decoder->initialize())
+            return Error { Error::Type::MalformedPDF, "Invalid JPG image" };
+        auto frame = TRY(decoder->frame(0));
+        if (frame.image->size() == target_size)
+            return frame.image.release_nonnull();
+        return TRY(frame.image->scaled_to(target_size));
     }
 
-    auto bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { width, height }));
-    int x = 0;
-    int y = 0;
+    // The samples are averaged into a bitmap of the target size right away, one row of it at a time, so that a large
+    // image never has a bitmap of its full size.
+    auto bitmap = TRY(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, target_size));
+    int const target_width = target_size.width();
+    int const target_height = target_size.height();
+
+    struct PixelSum {
+        u64 red { 0 };
+        u64 green { 0 };
+        u64 blue { 0 };
+        u64 alpha { 0 };
+        u64 count { 0 };
+    };
+    Vector<PixelSum> row_sums;
+    TRY(row_sums.try_resize(target_width));
+
+    int target_y = 0;
+    auto flush_row_sums = [&] {
+        for (int target_x = 0; target_x < target_width; ++target_x) {
+            auto& sum = row_sums[target_x];
+            if (sum.count == 0)
+                continue;
+            bitmap->set_pixel(target_x, target_y, Color(sum.red / sum.count, sum.green / sum.count, sum.blue / sum.count, sum.alpha / sum.count));
+            sum = {};
+        }
+    };
+
     int const n_components = color_space->number_of_components();
     auto const bytes_per_component = bits_per_component / 8;
+    auto const bytes_per_sample = bytes_per_component * n_components;
     Vector<Value> component_values;
     component_values.resize(n_components);
     auto content = image->bytes();
-    while (!content.is_empty() && y < height) {
-        auto sample = content.slice(0, bytes_per_component * n_components);
-        content = content.slice(bytes_per_component * n_components);
-        for (int i = 0; i < n_components; ++i) {
-            auto component = sample.slice(0, bytes_per_component);
-            sample = sample.slice(bytes_per_component);
-            component_values[i] = Value { component_value_decoders[i].interpolate(component[0]) };
+    for (int y = 0; y < height && !content.is_empty(); ++y) {
+        auto row_target_y = static_cast<int>(static_cast<i64>(y) * target_height / height);
+        if (row_target_y != target_y) {
+            flush_row_sums();
+            target_y = row_target_y;
         }
-        auto color = color_space->color(component_values);
-        bitmap->set_pixel(x, y, color);
-        ++x;
-        if (x == width) {
-            x = 0;
-            ++y;
+
+        for (int x = 0; x < width && !content.is_empty(); ++x) {
+            auto sample = content.slice(0, min(content.size(), static_cast<size_t>(bytes_per_sample)));
+            content = content.slice(sample.size());
+            for (int i = 0; i < n_components; ++i) {
+                auto component = i * bytes_per_component < static_cast<int>(sample.size()) ? sample[i * bytes_per_component] : 0;
+                component_values[i] = Value { component_value_decoders[i].interpolate(component) };
+            }
+            auto color = color_space->color(component_values);
+
+            auto& sum = row_sums[static_cast<i64>(x) * target_width / width];
+            sum.red += color.red();
+            sum.green += color.green();
+            sum.blue += color.blue();
+            sum.alpha += color.alpha();
+            ++sum.count;
         }
     }
+    flush_row_sums();
     return bitmap;
 }
 
@@ -857,9 +912,21 @@ PDFErrorOr<void> Renderer::show_image(NonnullRefPtr<StreamObject> image)
         show_empty_image(width, height);
         return {};
     }
-    auto image_bitmap = TRY(load_image(image));
+
+    // Images are decoded at the size they're drawn at, unless that's larger than the image itself. For scanned pages,
+    // that's often only a small part of the image's full size.
+    auto image_space = calculate_image_space_transformation(width, height);
+    auto origin = image_space.map(Gfx::FloatPoint { 0, 0 });
+    auto drawn_width = image_space.map(Gfx::FloatPoint { width, 0 }).distance_from(origin);
+    auto drawn_height = image_space.map(Gfx::FloatPoint { 0, height }).distance_from(origin);
+    Gfx::IntSize target_size {
+        clamp(static_cast<int>(ceilf(drawn_width)), 1, max(width, 1)),
+        clamp(static_cast<int>(ceilf(drawn_height)), 1, max(height, 1)),
+    };
+
+    auto image_bitmap = TRY(load_image(image, target_size));
     if (image_dict->contains(CommonNames::SMask)) {
-        auto smask_bitmap = TRY(load_image(TRY(image_dict->get_stream(m_document, CommonNames::SMask))));
+        auto smask_bitmap = TRY(load_image(TRY(image_dict->get_stream(m_document, CommonNames::SMask)), target_size));
         VERIFY(smask_bitmap->rect() == image_bitmap->rect());
         for (int j = 0; j < image_bitmap->height(); ++j) {
             for (int i = 0; i < image_bitmap->width(); ++i) {
@@ -871,9 +938,9 @@ PDFErrorOr<void> Renderer::show_image(NonnullRefPtr<StreamObject> image)
         }
     }
 
-    auto image_space = calculate_image_space_transformation(width, height);
-    auto image_rect = Gfx::FloatRect { 0, 0, width, height };
-    m_painter.draw_scaled_bitmap_with_transform(image_bitmap->rect(), image_bitmap, image_rect, image_space);
+    // The bitmap may be smaller than the image, so it's stretched over the image's own coordinate space.
+    auto image_rect = Gfx::IntRect { 0, 0, width, height };
+    m_painter.draw_scaled_bitmap_with_transform(image_rect, image_bitmap, image_bitmap->rect().to_type<float>(), image_space);
     return {};
 }
 
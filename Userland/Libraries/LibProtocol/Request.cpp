@@ -21,11 +21,29 @@ bool Request::stop()
 }
 
 void Request::stream_into(Stream& stream)
+{
+    set_up_internal_stream_data([&stream](auto read_bytes) {
+        // FIXME: What do we do if this fails?
+        stream.write_entire_buffer(read_bytes).release_value_but_fixme_should_propagate_errors();
+    });
+}
+
+void Request::set_unbuffered_request_callbacks(HeadersReceived on_headers_received, DataReceived on_data_received, RequestFinished on_finish)
+{
+    VERIFY(!m_internal_buffered_data);
+
+    this->on_headers_received = move(on_headers_received);
+    this->on_finish = move(on_finish);
+    set_up_internal_stream_data(move(on_data_received));
+}
+
+void Request::set_up_internal_stream_data(DataReceived on_data_available)
 {
     VERIFY(!m_internal_stream_data);
 
     m_internal_stream_data = make<InternalStreamData>(MUST(Core::File::adopt_fd(fd(), Core::File::OpenMode::Read)));
     m_internal_stream_data->read_notifier = Core::Notifier::construct(fd(), Core::Notifier::Read);
+    m_internal_stream_data->on_data_available = move(on_data_available);
 
     auto user_on_finish = move(on_finish);
     on_finish = [this](auto success, auto total_size) {
@@ -41,7 +59,7 @@ void Request::stream_into(Stream& stream)
             user_on_finish(m_internal_stream_data->success, m_internal_stream_data->total_size);
         }
     };
-    m_internal_stream_data->read_notifier->on_ready_to_read = [this, &stream] {
+    m_internal_stream_data->read_notifier->on_ready_to_read = [this] {
         constexpr size_t buffer_size = 256 * KiB;
         static char buf[buffer_size];
         do {
@@ -53,8 +71,7 @@ void Request::stream_into(Stream& stream)
             auto read_bytes = result.release_value();
             if (read_bytes.is_empty())
                 break;
-            // FIXME: What do we do if this fails?
-            stream.write_entire_buffer(read_bytes).release_value_but_fixme_should_propagate_errors();
+            m_internal_stream_data->on_data_available(read_bytes);
             break;
         } while (true);
 
@@ -42,6 +42,14 @@ public:
     /// Note: Will override `on_finish', and `on_headers_received', and expects `on_buffered_request_finish' to be set!
     void set_should_buffer_all_input(bool);
 
+    using HeadersReceived = Function<void(HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& response_headers, Optional<u32> response_code)>;
+    using DataReceived = Function<void(ReadonlyBytes data)>;
+    using RequestFinished = Function<void(bool success, u32 total_size)>;
+
+    /// Hands over the body piece by piece as it arrives, so that nothing has to keep all of it around.
+    /// Note: Will override `on_finish', and `on_headers_received', and can't be combined with buffering all input or `stream_into'.
+    void set_unbuffered_request_callbacks(HeadersReceived, DataReceived, RequestFinished);
+
     /// Note: Must be set before `set_should_buffer_all_input(true)`.
     Function<void(bool success, u32 total_size, HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& response_headers, Optional<u32> response_code, ReadonlyBytes payload)> on_buffered_request_finish;
     Function<void(bool success, u32 total_size)> on_finish;
@@ -60,6 +68,8 @@ public:
 private:
     explicit Request(RequestClient&, i32 request_id);
 
+    void set_up_internal_stream_data(DataReceived on_data_available);
+
     WeakPtr<RequestClient> m_client;
     int m_request_id { -1 };
     RefPtr<Core::Notifier> m_write_notifier;
@@ -80,6 +90,7 @@ private:
 
         NonnullOwnPtr<Stream> read_stream;
         RefPtr<Core::Notifier> read_notifier;
+        DataReceived on_data_available {};
         bool success;
         u32 total_size { 0 };
         bool request_done { false };
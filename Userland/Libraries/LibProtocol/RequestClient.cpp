@@ -31,12 +31,26 @@ RefPtr<Request> RequestClient::start_request(DeprecatedString const& method, URL
         return nullptr;
 
     auto response = IPCProxy::start_request(method, url, header_dictionary, body_result.release_value(), proxy_data);
-    auto request_id = response.request_id();
-    if (request_id < 0 || !response.response_fd().has_value())
+    return create_request(response.request_id(), response.response_fd());
+}
+
+template<typename RequestHashMapTraits>
+RefPtr<Request> RequestClient::start_request_with_body_stream(DeprecatedString const& method, URL const& url, HashMap<DeprecatedString, DeprecatedString, RequestHashMapTraits> const& request_headers, int request_body_fd, HTTP::HttpRequest::BodyEncoding request_body_encoding, Core::ProxyData const& proxy_data)
+{
+    IPC::Dictionary header_dictionary;
+    for (auto& it : request_headers)
+        header_dictionary.add(it.key, it.value);
+
+    auto response = IPCProxy::start_request_with_body_stream(method, url, header_dictionary, IPC::File(request_body_fd, IPC::File::CloseAfterSending), request_body_encoding, proxy_data);
+    return create_request(response.request_id(), response.response_fd());
+}
+
+RefPtr<Request> RequestClient::create_request(i32 request_id, Optional<IPC::File> const& response_fd)
+{
+    if (request_id < 0 || !response_fd.has_value())
         return nullptr;
-    auto response_fd = response.response_fd().value().take_fd();
     auto request = Request::create_from_id({}, *this, request_id);
-    request->set_request_fd({}, response_fd);
+    request->set_request_fd({}, response_fd->take_fd());
     m_requests.set(request_id, request);
     return request;
 }
@@ -91,3 +105,5 @@ void RequestClient::certificate_requested(i32 request_id)
 
 template RefPtr<Protocol::Request> Protocol::RequestClient::start_request(DeprecatedString const& method, URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const&);
 template RefPtr<Protocol::Request> Protocol::RequestClient::start_request(DeprecatedString const& method, URL const&, HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const&);
+template RefPtr<Protocol::Request> Protocol::RequestClient::start_request_with_body_stream(DeprecatedString const& method, URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers, int request_body_fd, HTTP::HttpRequest::BodyEncoding, Core::ProxyData const&);
+template RefPtr<Protocol::Request> Protocol::RequestClient::start_request_with_body_stream(DeprecatedString const& method, URL const&, HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& request_headers, int request_body_fd, HTTP::HttpRequest::BodyEncoding, Core::ProxyData const&);
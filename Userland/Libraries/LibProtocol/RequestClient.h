@@ -24,6 +24,11 @@ public:
     template<typename RequestHashMapTraits = Traits<DeprecatedString>>
     RefPtr<Request> start_request(DeprecatedString const& method, URL const&, HashMap<DeprecatedString, DeprecatedString, RequestHashMapTraits> const& request_headers = {}, ReadonlyBytes request_body = {}, Core::ProxyData const& = {});
 
+    // The body is whatever RequestServer can read from the file until it ends, which it sends while it's being
+    // written (to a pipe, say), so that it never has to be in memory all at once. Takes ownership of the fd.
+    template<typename RequestHashMapTraits = Traits<DeprecatedString>>
+    RefPtr<Request> start_request_with_body_stream(DeprecatedString const& method, URL const&, HashMap<DeprecatedString, DeprecatedString, RequestHashMapTraits> const& request_headers, int request_body_fd, HTTP::HttpRequest::BodyEncoding = HTTP::HttpRequest::BodyEncoding::Identity, Core::ProxyData const& = {});
+
     void ensure_connection(URL const&, ::RequestServer::CacheLevel);
 
     bool stop_request(Badge<Request>, Request&);
@@ -37,6 +42,8 @@ private:
     virtual void certificate_requested(i32) override;
     virtual void headers_became_available(i32, IPC::Dictionary const&, Optional<u32> const&) override;
 
+    RefPtr<Request> create_request(i32 request_id, Optional<IPC::File> const& response_fd);
+
     HashMap<i32, RefPtr<Request>> m_requests;
 };
 
@@ -9,6 +9,7 @@
 #include "Forward.h"
 #include "RegexOptions.h"
 
+#include <AK/Bitmap.h>
 #include <AK/DeprecatedFlyString.h>
 #include <AK/DeprecatedString.h>
 #include <AK/HashMap.h>
@@ -509,6 +510,31 @@ public:
             [](auto&) -> bool { TODO(); });
     }
 
+    // Returns the first position at or after `start` where the ASCII string `needle` may start, or nothing if it doesn't
+    // occur. Views that aren't indexed by code unit aren't searched, so `start` itself is returned for them.
+    Optional<size_t> find_first_candidate_for(StringView needle, size_t start) const
+    {
+        if (unicode())
+            return start;
+
+        return m_view.visit(
+            [&](StringView view) { return view.find(needle, start); },
+            [&](Utf16View const& view) -> Optional<size_t> {
+                auto length = view.length_in_code_units();
+                if (needle.length() > length)
+                    return {};
+                for (size_t i = start; i <= length - needle.length(); ++i) {
+                    size_t j = 0;
+                    while (j < needle.length() && view.code_unit_at(i + j) == static_cast<u8>(needle[j]))
+                        ++j;
+                    if (j == needle.length())
+                        return i;
+                }
+                return {};
+            },
+            [&](auto const&) -> Optional<size_t> { return start; });
+    }
+
     bool starts_with(StringView str) const
     {
         return m_view.visit(
@@ -630,6 +656,7 @@ struct MatchInput {
     mutable Vector<size_t> saved_forks_since_last_save;
     mutable HashMap<u64, u64> checkpoints;
     mutable Optional<size_t> fork_to_replace;
+    mutable Optional<Bitmap> visited_forks; // Indexed by string position * fork memoization slot count + slot.
 };
 
 struct MatchState {
@@ -5,8 +5,10 @@
  */
 
 #include <AK/BumpAllocator.h>
+#include <AK/Checked.h>
 #include <AK/Debug.h>
 #include <AK/DeprecatedString.h>
+#include <AK/HashMap.h>
 #include <AK/StringBuilder.h>
 #include <LibRegex/RegexMatcher.h>
 #include <LibRegex/RegexParser.h>
@@ -30,20 +32,100 @@ regex::Parser::Result Regex<Parser>::parse_pattern(StringView pattern, typename
     return parser.parse();
 }
 
+namespace {
+
+struct CompiledPatternKey {
+    DeprecatedString pattern;
+    u64 options { 0 };
+
+    bool operator==(CompiledPatternKey const&) const = default;
+};
+
+struct CompiledPattern {
+    regex::Parser::Result parser_result;
+    Optional<Detail::ForkMemoization> fork_memoization;
+    DeprecatedString literal_prefix;
+    u64 last_use { 0 };
+};
+
+struct CompiledPatternCache {
+    HashMap<CompiledPatternKey, CompiledPattern> patterns;
+    u64 uses { 0 };
+    CompiledPatternCacheStatistics statistics;
+};
+
+}
+
+}
+
+template<>
+struct AK::Traits<regex::CompiledPatternKey> : public GenericTraits<regex::CompiledPatternKey> {
+    static unsigned hash(regex::CompiledPatternKey const& key) { return pair_int_hash(key.pattern.hash(), u64_hash(key.options)); }
+};
+
+namespace regex {
+
+// NOTE: Each parser has its own cache, as the same pattern means different things to each of them.
+template<class Parser>
+static CompiledPatternCache& compiled_pattern_cache()
+{
+    static CompiledPatternCache cache;
+    return cache;
+}
+
 template<class Parser>
 Regex<Parser>::Regex(DeprecatedString pattern, typename ParserTraits<Parser>::OptionsType regex_options)
     : pattern_value(move(pattern))
 {
-    regex::Lexer lexer(pattern_value);
+    auto& cache = compiled_pattern_cache<Parser>();
+    CompiledPatternKey key { pattern_value, static_cast<u64>(regex_options.value()) };
+
+    if (auto compiled_pattern = cache.patterns.find(key); compiled_pattern != cache.patterns.end()) {
+        ++cache.statistics.hits;
+        compiled_pattern->value.last_use = ++cache.uses;
+        parser_result = regex::Parser::Result { compiled_pattern->value.parser_result };
+        fork_memoization = compiled_pattern->value.fork_memoization;
+        literal_prefix = compiled_pattern->value.literal_prefix;
+    } else {
+        ++cache.statistics.misses;
 
-    Parser parser(lexer, regex_options);
-    parser_result = parser.parse();
+        regex::Lexer lexer(pattern_value);
+
+        Parser parser(lexer, regex_options);
+        parser_result = parser.parse();
+
+        run_optimization_passes();
+
+        if (parser_result.error == regex::Error::NoError) {
+            if (cache.patterns.size() >= c_max_compiled_pattern_cache_size) {
+                auto least_recently_used = cache.patterns.begin();
+                for (auto it = cache.patterns.begin(); it != cache.patterns.end(); ++it) {
+                    if (it->value.last_use < least_recently_used->value.last_use)
+                        least_recently_used = it;
+                }
+                cache.patterns.remove(least_recently_used);
+            }
+
+            // NOTE: The error token refers to the pattern string of this Regex, which the cache doesn't keep alive.
+            CompiledPattern compiled_pattern { parser_result, fork_memoization, literal_prefix, ++cache.uses };
+            compiled_pattern.parser_result.error_token = {};
+            cache.patterns.set(move(key), move(compiled_pattern));
+        }
+    }
 
-    run_optimization_passes();
     if (parser_result.error == regex::Error::NoError)
         matcher = make<Matcher<Parser>>(this, static_cast<decltype(regex_options.value())>(parser_result.options.value()));
 }
 
+template<class Parser>
+CompiledPatternCacheStatistics Regex<Parser>::compiled_pattern_cache_statistics()
+{
+    auto& cache = compiled_pattern_cache<Parser>();
+    auto statistics = cache.statistics;
+    statistics.size = cache.patterns.size();
+    return statistics;
+}
+
 template<class Parser>
 Regex<Parser>::Regex(regex::Parser::Result parse_result, DeprecatedString pattern, typename ParserTraits<Parser>::OptionsType regex_options)
     : pattern_value(move(pattern))
@@ -60,6 +142,8 @@ Regex<Parser>::Regex(Regex&& regex)
     , parser_result(move(regex.parser_result))
     , matcher(move(regex.matcher))
     , start_offset(regex.start_offset)
+    , fork_memoization(move(regex.fork_memoization))
+    , literal_prefix(move(regex.literal_prefix))
 {
     if (matcher)
         matcher->reset_pattern({}, this);
@@ -74,6 +158,8 @@ Regex<Parser>& Regex<Parser>::operator=(Regex&& regex)
     if (matcher)
         matcher->reset_pattern({}, this);
     start_offset = regex.start_offset;
+    fork_memoization = move(regex.fork_memoization);
+    literal_prefix = move(regex.literal_prefix);
     return *this;
 }
 
@@ -195,6 +281,7 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
         dbgln_if(REGEX_DEBUG, "[match] Starting match with view ({}): _{}_", view.length(), view);
 
         auto view_length = view.length();
+        prepare_fork_memoization(input, view_length);
         size_t view_index = m_pattern->start_offset;
         state.string_position = view_index;
         state.string_position_in_code_units = view_index;
@@ -231,7 +318,18 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             }
         }
 
+        auto const& literal_prefix = m_pattern->literal_prefix;
+        bool can_skip_to_literal_prefix = continue_search && !literal_prefix.is_empty() && !input.regex_options.has_flag_set(AllFlags::Insensitive);
+
         for (; view_index <= view_length; ++view_index) {
+            if (can_skip_to_literal_prefix) {
+                // A match can only start where its literal prefix occurs.
+                auto candidate = view.find_first_candidate_for(literal_prefix, view_index);
+                if (!candidate.has_value())
+                    break;
+                view_index = *candidate;
+            }
+
             if (view_index == view_length && input.regex_options.has_flag_set(AllFlags::Multiline))
                 break;
 
@@ -335,6 +433,28 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
     return result;
 }
 
+template<class Parser>
+void Matcher<Parser>::prepare_fork_memoization(MatchInput& input, size_t view_length) const
+{
+    input.visited_forks.clear();
+
+    auto const& memoization = m_pattern->fork_memoization;
+    if (!memoization.has_value())
+        return;
+
+    // NOTE: Forks are memoized for the whole view, as a fork that fails when matching from one start position would
+    //       fail for any other. Very long strings aren't, to bound the memory used.
+    Checked<size_t> bit_count = view_length;
+    bit_count += 1;
+    bit_count *= memoization->slot_count;
+    if (bit_count.has_overflow() || bit_count.value() > c_max_fork_memoization_bits)
+        return;
+
+    auto visited_forks = Bitmap::create(bit_count.value(), false);
+    if (!visited_forks.is_error())
+        input.visited_forks = visited_forks.release_value();
+}
+
 template<typename T>
 class BumpAllocatedLinkedList {
 public:
@@ -426,6 +546,9 @@ bool Matcher<Parser>::execute(MatchInput const& input, MatchState& state, size_t
 
     auto& bytecode = m_pattern->parser_result.bytecode;
 
+    auto start_position = state.string_position;
+    auto end_of_visited_forks = start_position;
+
     for (;;) {
         auto& opcode = bytecode.get_opcode(state);
         ++operations;
@@ -446,6 +569,19 @@ bool Matcher<Parser>::execute(MatchInput const& input, MatchState& state, size_t
         s_regex_dbg.print_result(opcode, bytecode, input, state, result);
 #endif
 
+        if ((result == ExecutionResult::Fork_PrioLow || result == ExecutionResult::Fork_PrioHigh) && input.visited_forks.has_value() && state.string_position <= input.view.length()) {
+            // If we've been here before, trying again won't match either (see Regex::find_memoizable_forks()).
+            auto const& memoization = *m_pattern->fork_memoization;
+            auto index = state.string_position * memoization.slot_count + memoization.slots[state.instruction_position];
+            if (input.visited_forks->get(index)) {
+                input.fork_to_replace.clear();
+                result = ExecutionResult::Failed;
+            } else {
+                input.visited_forks->set(index, true);
+                end_of_visited_forks = max(end_of_visited_forks, state.string_position + 1);
+            }
+        }
+
         state.instruction_position += opcode.size();
 
         switch (result) {
@@ -496,6 +632,11 @@ bool Matcher<Parser>::execute(MatchInput const& input, MatchState& state, size_t
         case ExecutionResult::Continue:
             continue;
         case ExecutionResult::Succeeded:
+            // The forks on the way to this match haven't failed, so a later match may go past them again.
+            if (input.visited_forks.has_value() && end_of_visited_forks > start_position) {
+                auto slot_count = m_pattern->fork_memoization->slot_count;
+                input.visited_forks->set_range<false>(start_position * slot_count, (end_of_visited_forks - start_position) * slot_count);
+            }
             return true;
         case ExecutionResult::Failed:
             if (!states_to_try_next.is_empty()) {
@@ -31,10 +31,18 @@ struct Block {
     size_t end;
 };
 
+// The memoization slot of every fork in the bytecode, indexed by instruction position.
+struct ForkMemoization {
+    Vector<size_t> slots;
+    size_t slot_count { 0 };
+};
+
 }
 
 static constexpr const size_t c_max_recursion = 5000;
+static constexpr const size_t c_max_compiled_pattern_cache_size = 64;
 static constexpr const size_t c_match_preallocation_count = 0;
+static constexpr const size_t c_max_fork_memoization_bits = 32 * MiB;
 
 struct RegexResult final {
     bool success { false };
@@ -46,6 +54,12 @@ struct RegexResult final {
     size_t n_named_capture_groups { 0 };
 };
 
+struct CompiledPatternCacheStatistics {
+    size_t hits { 0 };
+    size_t misses { 0 };
+    size_t size { 0 };
+};
+
 template<class Parser>
 class Regex;
 
@@ -75,6 +89,7 @@ public:
 
 private:
     bool execute(MatchInput const& input, MatchState& state, size_t& operations) const;
+    void prepare_fork_memoization(MatchInput& input, size_t view_length) const;
 
     Regex<Parser> const* m_pattern;
     typename ParserTraits<Parser>::OptionsType const m_regex_options;
@@ -88,6 +103,12 @@ public:
     OwnPtr<Matcher<Parser>> matcher { nullptr };
     mutable size_t start_offset { 0 };
 
+    // Only set if a fork will always fail when reached again at the same string position, see find_memoizable_forks().
+    Optional<Detail::ForkMemoization> fork_memoization;
+
+    // The ASCII characters any match has to start with, see find_literal_prefix().
+    DeprecatedString literal_prefix;
+
     static regex::Parser::Result parse_pattern(StringView pattern, typename ParserTraits<Parser>::OptionsType regex_options = {});
 
     explicit Regex(DeprecatedString pattern, typename ParserTraits<Parser>::OptionsType regex_options = {});
@@ -99,6 +120,9 @@ public:
     typename ParserTraits<Parser>::OptionsType options() const;
     DeprecatedString error_string(Optional<DeprecatedString> message = {}) const;
 
+    // Patterns constructed from a string are compiled once, and then copied out of a cache of recently used patterns.
+    static CompiledPatternCacheStatistics compiled_pattern_cache_statistics();
+
     RegexResult match(RegexStringView view, Optional<typename ParserTraits<Parser>::OptionsType> regex_options = {}) const
     {
         if (!matcher || parser_result.error != Error::NoError)
@@ -232,6 +256,8 @@ public:
 private:
     void run_optimization_passes();
     void attempt_rewrite_loops_as_atomic_groups(BasicBlockList const&);
+    void find_memoizable_forks();
+    void find_literal_prefix();
 };
 
 // free standing functions for match, search and has_match
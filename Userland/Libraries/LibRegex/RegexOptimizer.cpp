@@ -29,6 +29,113 @@ void Regex<Parser>::run_optimization_passes()
     attempt_rewrite_loops_as_atomic_groups(split_basic_blocks(parser_result.bytecode));
 
     parser_result.bytecode.flatten();
+
+    find_memoizable_forks();
+    find_literal_prefix();
+}
+
+template<typename Parser>
+void Regex<Parser>::find_literal_prefix()
+{
+    // Collect the characters every match has to start with, so the matcher can skip ahead to where they occur.
+    // NOTE: Only ASCII characters are collected, as the matcher compares them with the code units of the input.
+    auto const& bytecode = parser_result.bytecode;
+    StringBuilder builder;
+    auto append_if_ascii = [&](ByteCodeValueType value) {
+        if (!is_ascii(value))
+            return false;
+        builder.append(static_cast<char>(value));
+        return true;
+    };
+
+    MatchState state;
+    for (state.instruction_position = 0; state.instruction_position < bytecode.size();) {
+        auto& opcode = bytecode.get_opcode(state);
+        bool can_continue = false;
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare: {
+            auto const& compare = static_cast<OpCode_Compare const&>(opcode);
+            if (compare.arguments_count() != 1)
+                break;
+
+            auto offset = state.instruction_position + 3;
+            auto compare_type = static_cast<CharacterCompareType>(bytecode.at(offset++));
+            if (compare_type == CharacterCompareType::Char) {
+                can_continue = append_if_ascii(bytecode.at(offset));
+            } else if (compare_type == CharacterCompareType::String) {
+                auto length = bytecode.at(offset++);
+                can_continue = true;
+                for (size_t i = 0; i < length && can_continue; ++i)
+                    can_continue = append_if_ascii(bytecode.at(offset + i));
+            }
+            break;
+        }
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+            can_continue = true;
+            break;
+        default:
+            break;
+        }
+        if (!can_continue)
+            break;
+        state.instruction_position += opcode.size();
+    }
+
+    literal_prefix = builder.to_deprecated_string();
+}
+
+template<typename Parser>
+void Regex<Parser>::find_memoizable_forks()
+{
+    // If the only state that decides whether the bytecode matches from some point on is the instruction and string
+    // position, a fork that failed once will fail again when reached at the same string position. Remembering which
+    // forks failed (see Matcher::execute()) then limits the matcher to visiting each fork once for each position in
+    // the string, which makes matching linear in the length of the string instead of exponential.
+    // That's not the case for backreferences, lookaround (which saves, restores and moves the string position),
+    // atomic groups (which fail forks they didn't create), and bounded repetitions (which count their iterations).
+    // NOTE: Checkpoints only decide whether a loop iteration matched the empty string, and skipping forks after an
+    //       empty iteration doesn't change the result.
+    fork_memoization.clear();
+
+    auto const& bytecode = parser_result.bytecode;
+    Detail::ForkMemoization memoization;
+    memoization.slots.resize(bytecode.size());
+
+    MatchState state;
+    for (state.instruction_position = 0; state.instruction_position < bytecode.size();) {
+        auto& opcode = bytecode.get_opcode(state);
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare: {
+            auto compares = static_cast<OpCode_Compare const&>(opcode).flat_compares();
+            if (any_of(compares, [](auto& compare) { return compare.type == CharacterCompareType::Reference; }))
+                return;
+            break;
+        }
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkReplaceJump:
+        case OpCodeId::ForkReplaceStay:
+        case OpCodeId::JumpNonEmpty:
+            memoization.slots[state.instruction_position] = memoization.slot_count++;
+            break;
+        case OpCodeId::FailForks:
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+        case OpCodeId::Repeat:
+        case OpCodeId::ResetRepeat:
+            return;
+        default:
+            break;
+        }
+        state.instruction_position += opcode.size();
+    }
+
+    if (memoization.slot_count != 0)
+        fork_memoization = move(memoization);
 }
 
 template<typename Parser>
@@ -278,6 +278,22 @@ private:
     Nulls m_nulls;
 };
 
+class IndexedColumn : public ASTNode {
+public:
+    IndexedColumn(DeprecatedString column_name, Order order)
+        : m_column_name(move(column_name))
+        , m_order(order)
+    {
+    }
+
+    DeprecatedString const& column_name() const { return m_column_name; }
+    Order order() const { return m_order; }
+
+private:
+    DeprecatedString m_column_name;
+    Order m_order;
+};
+
 class LimitClause : public ASTNode {
 public:
     LimitClause(NonnullRefPtr<Expression> limit_expression, RefPtr<Expression> offset_expression)
@@ -832,6 +848,36 @@ private:
     bool m_is_error_if_table_exists;
 };
 
+class CreateIndex : public Statement {
+public:
+    CreateIndex(DeprecatedString schema_name, DeprecatedString index_name, DeprecatedString table_name, NonnullRefPtrVector<IndexedColumn> indexed_columns, bool is_unique, bool is_error_if_index_exists)
+        : m_schema_name(move(schema_name))
+        , m_index_name(move(index_name))
+        , m_table_name(move(table_name))
+        , m_indexed_columns(move(indexed_columns))
+        , m_is_unique(is_unique)
+        , m_is_error_if_index_exists(is_error_if_index_exists)
+    {
+    }
+
+    DeprecatedString const& schema_name() const { return m_schema_name; }
+    DeprecatedString const& index_name() const { return m_index_name; }
+    DeprecatedString const& table_name() const { return m_table_name; }
+    NonnullRefPtrVector<IndexedColumn> const& indexed_columns() const { return m_indexed_columns; }
+    bool is_unique() const { return m_is_unique; }
+    bool is_error_if_index_exists() const { return m_is_error_if_index_exists; }
+
+    ResultOr<ResultSet> execute(ExecutionContext&) const override;
+
+private:
+    DeprecatedString m_schema_name;
+    DeprecatedString m_index_name;
+    DeprecatedString m_table_name;
+    NonnullRefPtrVector<IndexedColumn> m_indexed_columns;
+    bool m_is_unique;
+    bool m_is_error_if_index_exists;
+};
+
 class AlterTable : public Statement {
 public:
     DeprecatedString const& schema_name() const { return m_schema_name; }
@@ -1094,6 +1140,20 @@ private:
     RefPtr<LimitClause> m_limit_clause;
 };
 
+class Explain : public Statement {
+public:
+    explicit Explain(NonnullRefPtr<Statement> statement)
+        : m_statement(move(statement))
+    {
+    }
+
+    NonnullRefPtr<Statement> const& statement() const { return m_statement; }
+    ResultOr<ResultSet> execute(ExecutionContext&) const override;
+
+private:
+    NonnullRefPtr<Statement> m_statement;
+};
+
 class DescribeTable : public Statement {
 public:
     DescribeTable(NonnullRefPtr<QualifiedTableName> qualified_table_name)
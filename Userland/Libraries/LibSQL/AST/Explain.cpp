@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/AST/AST.h>
+#include <LibSQL/AST/QueryPlan.h>
+#include <LibSQL/ResultSet.h>
+
+namespace SQL::AST {
+
+ResultOr<ResultSet> Explain::execute(ExecutionContext& context) const
+{
+    if (!is<Select>(*m_statement))
+        return Result { SQLCommand::Unknown, SQLErrorCode::NotYetImplemented, "Only SELECT statements can be explained"sv };
+
+    auto plan = TRY(QueryPlan::create(context, static_cast<Select const&>(*m_statement)));
+
+    ResultSet result { SQLCommand::Select, { "Plan" } };
+    for (auto const& line : plan.describe()) {
+        Tuple tuple;
+        tuple.append(Value { line });
+        result.insert_row(tuple, Tuple {});
+    }
+
+    return result;
+}
+
+}
@@ -22,8 +22,9 @@ ResultOr<ResultSet> Insert::execute(ExecutionContext& context) const
             return Result { SQLCommand::Insert, SQLErrorCode::ColumnDoesNotExist, column };
     }
 
-    ResultSet result { SQLCommand::Insert };
-    TRY(result.try_ensure_capacity(m_chained_expressions.size()));
+    // All rows are evaluated before any of them is inserted, so that the indexes are only updated once.
+    Vector<Row> rows;
+    TRY(rows.try_ensure_capacity(m_chained_expressions.size()));
 
     for (auto& row_expr : m_chained_expressions) {
         for (auto& column_def : table_def->columns()) {
@@ -51,10 +52,16 @@ ResultOr<ResultSet> Insert::execute(ExecutionContext& context) const
             row[element_index] = move(values[ix]);
         }
 
-        TRY(context.database->insert(row));
-        result.insert_row(row, {});
+        rows.unchecked_append(row);
     }
 
+    TRY(context.database->insert(rows.span()));
+
+    ResultSet result { SQLCommand::Insert };
+    TRY(result.try_ensure_capacity(rows.size()));
+    for (auto const& row : rows)
+        result.insert_row(row, {});
+
     return result;
 }
 
@@ -41,6 +41,8 @@ NonnullRefPtr<Statement> Parser::parse_statement()
         consume();
         if (match(TokenType::Schema))
             return parse_create_schema_statement();
+        else if (match(TokenType::Unique) || match(TokenType::Index))
+            return parse_create_index_statement();
         else
             return parse_create_table_statement();
     case TokenType::Alter:
@@ -49,6 +51,8 @@ NonnullRefPtr<Statement> Parser::parse_statement()
         return parse_drop_table_statement();
     case TokenType::Describe:
         return parse_describe_table_statement();
+    case TokenType::Explain:
+        return parse_explain_statement();
     case TokenType::Insert:
         return parse_insert_statement({});
     case TokenType::Update:
@@ -58,7 +62,7 @@ NonnullRefPtr<Statement> Parser::parse_statement()
     case TokenType::Select:
         return parse_select_statement({});
     default:
-        expected("CREATE, ALTER, DROP, DESCRIBE, INSERT, UPDATE, DELETE, or SELECT"sv);
+        expected("CREATE, ALTER, DROP, DESCRIBE, EXPLAIN, INSERT, UPDATE, DELETE, or SELECT"sv);
         return create_ast_node<ErrorStatement>();
     }
 }
@@ -129,6 +133,35 @@ NonnullRefPtr<CreateTable> Parser::parse_create_table_statement()
     return create_ast_node<CreateTable>(move(schema_name), move(table_name), move(column_definitions), is_temporary, is_error_if_table_exists);
 }
 
+NonnullRefPtr<CreateIndex> Parser::parse_create_index_statement()
+{
+    // https://sqlite.org/lang_createindex.html
+    bool is_unique = consume_if(TokenType::Unique);
+    consume(TokenType::Index);
+
+    bool is_error_if_index_exists = true;
+    if (consume_if(TokenType::If)) {
+        consume(TokenType::Not);
+        consume(TokenType::Exists);
+        is_error_if_index_exists = false;
+    }
+
+    // The schema goes with the name of the index, and the table has to be in that same schema.
+    DeprecatedString schema_name;
+    DeprecatedString index_name;
+    parse_schema_and_table_name(schema_name, index_name);
+
+    consume(TokenType::On);
+    DeprecatedString table_name = consume(TokenType::Identifier).value();
+
+    NonnullRefPtrVector<IndexedColumn> indexed_columns;
+    parse_comma_separated_list(true, [&]() { indexed_columns.append(parse_indexed_column()); });
+
+    // FIXME: Parse the "WHERE" clause of partial indexes.
+
+    return create_ast_node<CreateIndex>(move(schema_name), move(index_name), move(table_name), move(indexed_columns), is_unique, is_error_if_index_exists);
+}
+
 NonnullRefPtr<AlterTable> Parser::parse_alter_table_statement()
 {
     // https://sqlite.org/lang_altertable.html
@@ -194,6 +227,18 @@ NonnullRefPtr<DescribeTable> Parser::parse_describe_table_statement()
     return create_ast_node<DescribeTable>(move(table_name));
 }
 
+NonnullRefPtr<Explain> Parser::parse_explain_statement()
+{
+    // https://sqlite.org/lang_explain.html
+    consume(TokenType::Explain);
+
+    // We only ever explain the query plan, so "QUERY PLAN" is optional.
+    if (consume_if(TokenType::Query))
+        consume(TokenType::Plan);
+
+    return create_ast_node<Explain>(parse_statement());
+}
+
 NonnullRefPtr<Insert> Parser::parse_insert_statement(RefPtr<CommonTableExpressionList> common_table_expression_list)
 {
     // https://sqlite.org/lang_insert.html
@@ -603,61 +648,109 @@ RefPtr<Expression> Parser::parse_unary_operator_expression()
     return {};
 }
 
+// https://sqlite.org/lang_expr.html#operators_and_parse_affecting_attributes
+static int binary_operator_precedence(BinaryOperator op)
+{
+    switch (op) {
+    case BinaryOperator::Concatenate:
+        return 8;
+    case BinaryOperator::Multiplication:
+    case BinaryOperator::Division:
+    case BinaryOperator::Modulo:
+        return 7;
+    case BinaryOperator::Plus:
+    case BinaryOperator::Minus:
+        return 6;
+    case BinaryOperator::ShiftLeft:
+    case BinaryOperator::ShiftRight:
+    case BinaryOperator::BitwiseAnd:
+    case BinaryOperator::BitwiseOr:
+        return 5;
+    case BinaryOperator::LessThan:
+    case BinaryOperator::LessThanEquals:
+    case BinaryOperator::GreaterThan:
+    case BinaryOperator::GreaterThanEquals:
+        return 4;
+    case BinaryOperator::Equals:
+    case BinaryOperator::NotEquals:
+        return 3;
+    case BinaryOperator::And:
+        return 2;
+    case BinaryOperator::Or:
+        return 1;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+// The right-hand side is parsed as a whole expression, so if it's an operator that binds less tightly (or just as
+// tightly, as all operators are left-associative), the tree has to be rotated to make the left-hand side its operand.
+static NonnullRefPtr<Expression> create_binary_operator_expression(BinaryOperator op, NonnullRefPtr<Expression> lhs, NonnullRefPtr<Expression> rhs)
+{
+    if (is<BinaryOperatorExpression>(*rhs)) {
+        auto const& rhs_binary = static_cast<BinaryOperatorExpression const&>(*rhs);
+        if (binary_operator_precedence(op) >= binary_operator_precedence(rhs_binary.type())) {
+            auto new_lhs = create_binary_operator_expression(op, move(lhs), rhs_binary.lhs());
+            return create_binary_operator_expression(rhs_binary.type(), move(new_lhs), rhs_binary.rhs());
+        }
+    }
+    return create_ast_node<BinaryOperatorExpression>(op, move(lhs), move(rhs));
+}
+
 RefPtr<Expression> Parser::parse_binary_operator_expression(NonnullRefPtr<Expression> lhs)
 {
     if (consume_if(TokenType::DoublePipe))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Concatenate, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::Concatenate, move(lhs), parse_expression());
 
     if (consume_if(TokenType::Asterisk))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Multiplication, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::Multiplication, move(lhs), parse_expression());
 
     if (consume_if(TokenType::Divide))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Division, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::Division, move(lhs), parse_expression());
 
     if (consume_if(TokenType::Modulus))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Modulo, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::Modulo, move(lhs), parse_expression());
 
     if (consume_if(TokenType::Plus))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Plus, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::Plus, move(lhs), parse_expression());
 
     if (consume_if(TokenType::Minus))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Minus, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::Minus, move(lhs), parse_expression());
 
     if (consume_if(TokenType::ShiftLeft))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::ShiftLeft, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::ShiftLeft, move(lhs), parse_expression());
 
     if (consume_if(TokenType::ShiftRight))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::ShiftRight, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::ShiftRight, move(lhs), parse_expression());
 
     if (consume_if(TokenType::Ampersand))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::BitwiseAnd, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::BitwiseAnd, move(lhs), parse_expression());
 
     if (consume_if(TokenType::Pipe))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::BitwiseOr, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::BitwiseOr, move(lhs), parse_expression());
 
     if (consume_if(TokenType::LessThan))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::LessThan, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::LessThan, move(lhs), parse_expression());
 
     if (consume_if(TokenType::LessThanEquals))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::LessThanEquals, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::LessThanEquals, move(lhs), parse_expression());
 
     if (consume_if(TokenType::GreaterThan))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::GreaterThan, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::GreaterThan, move(lhs), parse_expression());
 
     if (consume_if(TokenType::GreaterThanEquals))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::GreaterThanEquals, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::GreaterThanEquals, move(lhs), parse_expression());
 
     if (consume_if(TokenType::Equals) || consume_if(TokenType::EqualsEquals))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Equals, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::Equals, move(lhs), parse_expression());
 
     if (consume_if(TokenType::NotEquals1) || consume_if(TokenType::NotEquals2))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::NotEquals, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::NotEquals, move(lhs), parse_expression());
 
     if (consume_if(TokenType::And))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::And, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::And, move(lhs), parse_expression());
 
     if (consume_if(TokenType::Or))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Or, move(lhs), parse_expression());
+        return create_binary_operator_expression(BinaryOperator::Or, move(lhs), parse_expression());
 
     return {};
 }
@@ -1074,6 +1167,18 @@ NonnullRefPtr<OrderingTerm> Parser::parse_ordering_term()
     return create_ast_node<OrderingTerm>(move(expression), move(collation_name), order, nulls);
 }
 
+NonnullRefPtr<IndexedColumn> Parser::parse_indexed_column()
+{
+    // https://sqlite.org/syntax/indexed-column.html
+    // FIXME: Parse expressions and collations.
+    DeprecatedString column_name = consume(TokenType::Identifier).value();
+
+    Order order = consume_if(TokenType::Desc) ? Order::Descending : Order::Ascending;
+    consume_if(TokenType::Asc); // ASC is the default, so ignore it if specified.
+
+    return create_ast_node<IndexedColumn>(move(column_name), order);
+}
+
 void Parser::parse_schema_and_table_name(DeprecatedString& schema_name, DeprecatedString& table_name)
 {
     DeprecatedString schema_or_table_name = consume(TokenType::Identifier).value();
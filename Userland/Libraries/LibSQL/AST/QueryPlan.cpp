@@ -0,0 +1,692 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/HashFunctions.h>
+#include <AK/IntegralMath.h>
+#include <AK/StringBuilder.h>
+#include <LibSQL/AST/QueryPlan.h>
+#include <LibSQL/BTree.h>
+#include <LibSQL/Database.h>
+#include <LibSQL/Key.h>
+#include <math.h>
+
+namespace SQL::AST {
+
+// Which tables an expression refers to is kept as a bit per table, like SQLite does, which limits joins to 64 tables.
+static constexpr size_t max_joined_tables = 64;
+
+struct ResolvedColumn {
+    size_t table_index { 0 };
+    size_t column_index { 0 };
+};
+
+// Finds the column the same way ColumnNameExpression::evaluate() will, or nothing if it's missing or ambiguous.
+static Optional<ResolvedColumn> resolve_column(ColumnNameExpression const& column, Vector<NonnullRefPtr<TableDef>> const& tables)
+{
+    Optional<ResolvedColumn> resolved;
+    for (size_t table_index = 0; table_index < tables.size(); ++table_index) {
+        auto const& table = tables[table_index];
+        if (!column.table_name().is_empty() && table->name() != column.table_name())
+            continue;
+
+        for (size_t column_index = 0; column_index < table->columns().size(); ++column_index) {
+            if (table->columns()[column_index].name() != column.column_name())
+                continue;
+            if (resolved.has_value())
+                return {};
+            resolved = ResolvedColumn { table_index, column_index };
+        }
+    }
+    return resolved;
+}
+
+// Returns false for anything that isn't known to only depend on the columns it refers to, like sub-selects.
+static bool collect_referenced_tables(Expression const& expression, Vector<NonnullRefPtr<TableDef>> const& tables, u64& referenced_tables)
+{
+    if (is<ColumnNameExpression>(expression)) {
+        auto column = resolve_column(static_cast<ColumnNameExpression const&>(expression), tables);
+        if (!column.has_value())
+            return false;
+        referenced_tables |= 1ull << column->table_index;
+        return true;
+    }
+
+    if (is<NumericLiteral>(expression) || is<StringLiteral>(expression) || is<BlobLiteral>(expression) || is<BooleanLiteral>(expression) || is<NullLiteral>(expression) || is<Placeholder>(expression))
+        return true;
+
+    if (is<ChainedExpression>(expression)) {
+        for (auto const& element : static_cast<ChainedExpression const&>(expression).expressions()) {
+            if (!collect_referenced_tables(element, tables, referenced_tables))
+                return false;
+        }
+        return true;
+    }
+
+    if (is<InSelectionExpression>(expression) || is<InTableExpression>(expression))
+        return false;
+
+    if (is<InChainedExpression>(expression)) {
+        auto const& in_chained = static_cast<InChainedExpression const&>(expression);
+        return collect_referenced_tables(in_chained.expression(), tables, referenced_tables)
+            && collect_referenced_tables(in_chained.expression_chain(), tables, referenced_tables);
+    }
+
+    if (is<BetweenExpression>(expression)) {
+        auto const& between = static_cast<BetweenExpression const&>(expression);
+        return collect_referenced_tables(between.expression(), tables, referenced_tables)
+            && collect_referenced_tables(between.lhs(), tables, referenced_tables)
+            && collect_referenced_tables(between.rhs(), tables, referenced_tables);
+    }
+
+    if (is<MatchExpression>(expression)) {
+        auto const& match = static_cast<MatchExpression const&>(expression);
+        if (match.escape() && !collect_referenced_tables(*match.escape(), tables, referenced_tables))
+            return false;
+    }
+
+    if (is<NestedDoubleExpression>(expression)) {
+        auto const& nested = static_cast<NestedDoubleExpression const&>(expression);
+        return collect_referenced_tables(nested.lhs(), tables, referenced_tables)
+            && collect_referenced_tables(nested.rhs(), tables, referenced_tables);
+    }
+
+    if (is<NestedExpression>(expression))
+        return collect_referenced_tables(static_cast<NestedExpression const&>(expression).expression(), tables, referenced_tables);
+
+    return false;
+}
+
+// Parentheses around an expression result in a chain of one.
+static NonnullRefPtr<Expression> without_parentheses(NonnullRefPtr<Expression> const& expression)
+{
+    if (is<ChainedExpression>(*expression)) {
+        auto const& chained = static_cast<ChainedExpression const&>(*expression);
+        if (chained.expressions().size() == 1)
+            return without_parentheses(chained.expressions().first());
+    }
+    return expression;
+}
+
+static void split_conjunction(NonnullRefPtr<Expression> const& expression, Vector<NonnullRefPtr<Expression>>& terms)
+{
+    if (auto unwrapped = without_parentheses(expression); unwrapped.ptr() != expression.ptr())
+        return split_conjunction(unwrapped, terms);
+
+    if (is<BinaryOperatorExpression>(*expression)) {
+        auto const& binary = static_cast<BinaryOperatorExpression const&>(*expression);
+        if (binary.type() == BinaryOperator::And) {
+            split_conjunction(binary.lhs(), terms);
+            split_conjunction(binary.rhs(), terms);
+            return;
+        }
+    }
+    terms.append(expression);
+}
+
+static Optional<BinaryOperator> flip_comparison(BinaryOperator op)
+{
+    switch (op) {
+    case BinaryOperator::Equals:
+        return BinaryOperator::Equals;
+    case BinaryOperator::LessThan:
+        return BinaryOperator::GreaterThan;
+    case BinaryOperator::LessThanEquals:
+        return BinaryOperator::GreaterThanEquals;
+    case BinaryOperator::GreaterThan:
+        return BinaryOperator::LessThan;
+    case BinaryOperator::GreaterThanEquals:
+        return BinaryOperator::LessThanEquals;
+    default:
+        return {};
+    }
+}
+
+// The values of other types don't have an order that's consistent with how they compare in expressions.
+static bool is_searchable_type(SQLType type)
+{
+    return type == SQLType::Integer || type == SQLType::Float || type == SQLType::Text;
+}
+
+static ResultOr<bool> matches_filters(ExecutionContext& context, Tuple& row, Vector<NonnullRefPtr<Expression>> const& filters)
+{
+    context.current_row = &row;
+    for (auto const& filter : filters) {
+        auto result = TRY(filter->evaluate(context)).to_bool();
+        if (!result.has_value() || !result.value())
+            return false;
+    }
+    return true;
+}
+
+struct IndexProbe {
+    Value value;
+    // How far off a value in the index may be from one that compares as equal to the looked up value.
+    double slack { 0 };
+};
+
+// Turns a value from the WHERE clause into what it's looked up as in an index on a column of the given type, or
+// nothing if a comparison between the two isn't ordered the same way as the index is.
+static Optional<IndexProbe> index_probe(SQLType column_type, Value const& value, bool column_is_lhs)
+{
+    if (value.is_null())
+        return {};
+
+    if (column_type == SQLType::Text) {
+        // A value on the left-hand side decides how the two are compared.
+        if (!column_is_lhs && value.type() != SQLType::Text)
+            return {};
+        return IndexProbe { Value { value.to_deprecated_string() } };
+    }
+
+    VERIFY(column_type == SQLType::Integer || column_type == SQLType::Float);
+    if (value.type() != SQLType::Integer && value.type() != SQLType::Float)
+        return {};
+
+    auto as_double = value.to_double();
+    if (!as_double.has_value())
+        return {};
+
+    // An Integer is compared to anything else by rounding the other value, so the values that compare as equal to a
+    // Float that isn't a whole number, or to an Integer on the left-hand side, are up to half a unit away from it.
+    auto is_whole_number = as_double.value() == trunc(as_double.value());
+    auto is_exact = is_whole_number && (column_is_lhs || value.type() == SQLType::Float);
+    return IndexProbe { Value { as_double.value() }, is_exact ? 0.0 : 0.5 };
+}
+
+// Rows are put in buckets by the value of the joined column, in such a way that all rows with a value that compares
+// as equal to a given one are in the buckets index_probe() says should be looked at for it.
+static Optional<u32> hash_bucket(SQLType column_type, Value const& value)
+{
+    VERIFY(!value.is_null());
+    if (column_type == SQLType::Text)
+        return value.to_deprecated_string().hash();
+
+    auto as_double = value.to_double();
+    if (!as_double.has_value())
+        return {};
+    auto bucket = floor(as_double.value());
+    if (!AK::is_within_range<i64>(bucket))
+        return {};
+    return u64_hash(static_cast<u64>(static_cast<i64>(bucket)));
+}
+
+ResultOr<QueryPlan> QueryPlan::create(ExecutionContext& context, Select const& select)
+{
+    QueryPlan plan;
+    plan.m_has_ordering = !select.ordering_term_list().is_empty();
+
+    Vector<NonnullRefPtr<TableDef>> tables;
+    for (auto const& table_descriptor : select.table_or_subquery_list()) {
+        if (!table_descriptor.is_table())
+            return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
+
+        auto table_def = TRY(context.database->get_table(table_descriptor.schema_name(), table_descriptor.table_name()));
+        if (table_def->num_columns() == 0)
+            continue;
+        TRY(tables.try_append(move(table_def)));
+    }
+
+    if (tables.size() > max_joined_tables)
+        return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, DeprecatedString::formatted("Joining more than {} tables is not yet implemented", max_joined_tables) };
+
+    auto descriptor = adopt_ref(*new TupleDescriptor);
+    for (auto const& table : tables) {
+        auto level_descriptor = adopt_ref(*new TupleDescriptor);
+        level_descriptor->extend(*descriptor);
+        level_descriptor->extend(*table->to_tuple_descriptor());
+        descriptor = level_descriptor;
+
+        TRY(plan.m_tables.try_empend(table, move(level_descriptor)));
+    }
+
+    Vector<NonnullRefPtr<Expression>> terms;
+    if (auto const& where_clause = select.where_clause())
+        split_conjunction(*where_clause, terms);
+
+    Vector<Vector<Condition>> conditions;
+    TRY(conditions.try_resize(tables.size()));
+
+    for (auto const& term : terms) {
+        u64 referenced_tables = 0;
+        auto is_known = collect_referenced_tables(*term, tables, referenced_tables);
+
+        if (tables.is_empty() || (is_known && referenced_tables == 0)) {
+            TRY(plan.m_constant_filters.try_append(term));
+            continue;
+        }
+
+        // Anything we don't understand is left until all tables have been joined.
+        if (!is_known) {
+            TRY(plan.m_tables.last().join_filters.try_append(term));
+            continue;
+        }
+
+        auto level = static_cast<size_t>(63 - count_leading_zeroes(referenced_tables));
+        auto& access = plan.m_tables[level];
+        if (referenced_tables == (1ull << level))
+            TRY(access.table_filters.try_append(term));
+        else
+            TRY(access.join_filters.try_append(term));
+
+        auto unwrapped_term = without_parentheses(term);
+        if (!is<BinaryOperatorExpression>(*unwrapped_term))
+            continue;
+        auto const& comparison = static_cast<BinaryOperatorExpression const&>(*unwrapped_term);
+        auto flipped_op = flip_comparison(comparison.type());
+        if (!flipped_op.has_value())
+            continue;
+
+        // Only the column can be in parentheses: a value in them is a tuple, which compares differently.
+        auto as_condition = [&](NonnullRefPtr<Expression> const& column_expression, NonnullRefPtr<Expression> const& value_side, bool column_is_lhs) -> Optional<Condition> {
+            auto column_side = without_parentheses(column_expression);
+            if (!is<ColumnNameExpression>(*column_side))
+                return {};
+            auto column = resolve_column(static_cast<ColumnNameExpression const&>(*column_side), tables);
+            if (!column.has_value() || column->table_index != level)
+                return {};
+
+            u64 value_tables = 0;
+            if (!collect_referenced_tables(*value_side, tables, value_tables) || (value_tables & ~((1ull << level) - 1)) != 0)
+                return {};
+
+            return Condition {
+                .column_index = column->column_index,
+                .op = column_is_lhs ? comparison.type() : flipped_op.value(),
+                .value = value_side,
+                .column_is_lhs = column_is_lhs,
+                .refers_to_other_tables = value_tables != 0,
+            };
+        };
+
+        if (auto condition = as_condition(comparison.lhs(), comparison.rhs(), true); condition.has_value())
+            TRY(conditions[level].try_append(condition.release_value()));
+        else if (auto condition = as_condition(comparison.rhs(), comparison.lhs(), false); condition.has_value())
+            TRY(conditions[level].try_append(condition.release_value()));
+    }
+
+    for (size_t level = 0; level < plan.m_tables.size(); ++level)
+        choose_access_method(plan.m_tables[level], conditions[level]);
+
+    return plan;
+}
+
+void QueryPlan::choose_access_method(TableAccess& access, Vector<Condition> const& conditions)
+{
+    auto const& columns = access.table->columns();
+
+    // The more columns of an index are compared for equality the better, and it's better still if that means at most
+    // one row is found. A range on the next column narrows things down a bit further.
+    size_t best_score = 0;
+    for (auto const& index : access.table->indexes()) {
+        Vector<Condition> equalities;
+        Optional<Condition> lower_bound;
+        Optional<Condition> upper_bound;
+
+        for (auto const& key_part : index.key_definition()) {
+            Optional<size_t> column_index;
+            for (size_t ix = 0; ix < columns.size(); ++ix) {
+                if (columns[ix].name() == key_part.name())
+                    column_index = ix;
+            }
+            if (!column_index.has_value() || !is_searchable_type(columns[*column_index].type()))
+                break;
+
+            auto equality = conditions.first_matching([&](auto const& condition) {
+                return condition.column_index == *column_index && condition.op == BinaryOperator::Equals;
+            });
+            if (equality.has_value()) {
+                equalities.append(*equality);
+                continue;
+            }
+
+            for (auto const& condition : conditions) {
+                if (condition.column_index != *column_index)
+                    continue;
+                if (!lower_bound.has_value() && (condition.op == BinaryOperator::GreaterThan || condition.op == BinaryOperator::GreaterThanEquals))
+                    lower_bound = condition;
+                if (!upper_bound.has_value() && (condition.op == BinaryOperator::LessThan || condition.op == BinaryOperator::LessThanEquals))
+                    upper_bound = condition;
+            }
+            break;
+        }
+
+        auto score = equalities.size() * 4 + (lower_bound.has_value() ? 1 : 0) + (upper_bound.has_value() ? 1 : 0);
+        if (index.unique() && equalities.size() == index.size())
+            score += 2;
+        if (score <= best_score)
+            continue;
+
+        best_score = score;
+        access.method = AccessMethod::IndexSearch;
+        access.index = index;
+        access.index_equalities = move(equalities);
+        access.index_lower_bound = move(lower_bound);
+        access.index_upper_bound = move(upper_bound);
+    }
+
+    if (access.method == AccessMethod::IndexSearch)
+        return;
+
+    for (auto const& condition : conditions) {
+        if (condition.op == BinaryOperator::Equals && condition.refers_to_other_tables && is_searchable_type(columns[condition.column_index].type())) {
+            access.method = AccessMethod::HashJoin;
+            access.hash_condition = condition;
+            return;
+        }
+    }
+}
+
+ResultOr<bool> QueryPlan::next_row(ExecutionContext& context)
+{
+    if (m_is_exhausted)
+        return false;
+
+    if (!m_has_started) {
+        m_has_started = true;
+
+        auto matches = TRY(matches_filters(context, m_empty_row, m_constant_filters));
+        if (!matches || m_tables.is_empty()) {
+            // Without any tables, there's the one empty row, if it matches.
+            m_is_exhausted = true;
+            return matches;
+        }
+
+        TRY(open_table(context, 0));
+        m_open_levels = 1;
+    }
+
+    while (m_open_levels > 0) {
+        auto level = m_open_levels - 1;
+        auto& access = m_tables[level];
+
+        auto const* row = TRY(next_candidate(context, level));
+        if (!row) {
+            --m_open_levels;
+            continue;
+        }
+
+        auto outer_size = access.joined_row.size() - row->size();
+        for (size_t ix = 0; ix < row->size(); ++ix)
+            access.joined_row[outer_size + ix] = (*row)[ix];
+
+        if (!TRY(matches_filters(context, access.joined_row, access.join_filters)))
+            continue;
+        if (level + 1 == m_tables.size())
+            return true;
+
+        TRY(open_table(context, level + 1));
+        ++m_open_levels;
+    }
+
+    m_is_exhausted = true;
+    return false;
+}
+
+ResultOr<void> QueryPlan::open_table(ExecutionContext& context, size_t level)
+{
+    auto& access = m_tables[level];
+    auto& outer_row = (level == 0) ? m_empty_row : m_tables[level - 1].joined_row;
+
+    for (size_t ix = 0; ix < outer_row.size(); ++ix)
+        access.joined_row[ix] = outer_row[ix];
+    access.position = 0;
+
+    switch (access.method) {
+    case AccessMethod::IndexSearch:
+        if (auto pointers = TRY(search_index(context, access, outer_row)); pointers.has_value()) {
+            access.pointers = pointers.release_value();
+            access.source = RowSource::IndexPointers;
+            return {};
+        }
+        break;
+    case AccessMethod::HashJoin:
+        if (auto candidates = TRY(probe_hash_table(context, access, outer_row)); candidates.has_value()) {
+            access.candidates = candidates.release_value();
+            access.source = RowSource::HashCandidates;
+            return {};
+        }
+        break;
+    case AccessMethod::TableScan:
+        break;
+    }
+
+    // The first table is only gone through once, so there's no point in keeping its rows around.
+    if (level == 0) {
+        access.next_pointer = access.table->pointer();
+        access.source = RowSource::TableChain;
+        return {};
+    }
+
+    TRY(scanned_rows(context, access));
+    access.source = RowSource::CachedRows;
+    return {};
+}
+
+ResultOr<Row const*> QueryPlan::next_candidate(ExecutionContext& context, size_t level)
+{
+    auto& access = m_tables[level];
+
+    switch (access.source) {
+    case RowSource::IndexPointers:
+        while (access.position < access.pointers.size()) {
+            access.read_row = TRY(context.database->get_row(*access.table, access.pointers[access.position++]));
+            if (TRY(matches_table_filters(context, access, *access.read_row)))
+                return &access.read_row.value();
+        }
+        return nullptr;
+    case RowSource::TableChain:
+        while (access.next_pointer != 0) {
+            access.read_row = TRY(context.database->get_row(*access.table, access.next_pointer));
+            access.next_pointer = access.read_row->next_pointer();
+            if (TRY(matches_table_filters(context, access, *access.read_row)))
+                return &access.read_row.value();
+        }
+        return nullptr;
+    case RowSource::HashCandidates:
+        if (access.position < access.candidates.size())
+            return &(*access.rows)[access.candidates[access.position++]];
+        return nullptr;
+    case RowSource::CachedRows:
+        if (access.position < access.rows->size())
+            return &(*access.rows)[access.position++];
+        return nullptr;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+ResultOr<bool> QueryPlan::matches_table_filters(ExecutionContext& context, TableAccess const& access, Row& row)
+{
+    if (access.table_filters.is_empty())
+        return true;
+    return matches_filters(context, row, access.table_filters);
+}
+
+ResultOr<Vector<Row> const*> QueryPlan::scanned_rows(ExecutionContext& context, TableAccess& access)
+{
+    if (!access.rows.has_value()) {
+        Vector<Row> rows;
+        for (auto& row : TRY(context.database->select_all(*access.table))) {
+            if (TRY(matches_table_filters(context, access, row)))
+                TRY(rows.try_append(row));
+        }
+        access.rows = move(rows);
+    }
+    return &access.rows.value();
+}
+
+ResultOr<Optional<Vector<u32>>> QueryPlan::search_index(ExecutionContext& context, TableAccess& access, Tuple& outer_row)
+{
+    auto const& columns = access.table->columns();
+    auto probe_for = [&](Condition const& condition) -> ResultOr<Optional<IndexProbe>> {
+        context.current_row = &outer_row;
+        auto value = TRY(condition.value->evaluate(context));
+        return index_probe(columns[condition.column_index].type(), value, condition.column_is_lhs);
+    };
+
+    // Anything that can't be looked up is left out, which finds more rows than needed, but the filters take care of that.
+    Key start_key;
+    size_t equal_value_count = 0;
+    Optional<Value> upper_bound;
+    auto has_range = false;
+
+    for (auto const& equality : access.index_equalities) {
+        auto probe = TRY(probe_for(equality));
+        if (!probe.has_value())
+            break;
+
+        if (probe->slack == 0) {
+            start_key.append(probe->value);
+            ++equal_value_count;
+            continue;
+        }
+
+        start_key.append(Value { probe->value.to_double().value() - probe->slack });
+        upper_bound = Value { probe->value.to_double().value() + probe->slack };
+        has_range = true;
+        break;
+    }
+
+    if (!has_range && equal_value_count == access.index_equalities.size()) {
+        if (access.index_lower_bound.has_value()) {
+            if (auto probe = TRY(probe_for(*access.index_lower_bound)); probe.has_value()) {
+                auto value = probe->slack == 0 ? probe->value : Value { probe->value.to_double().value() - probe->slack };
+                start_key.append(move(value));
+                has_range = true;
+            }
+        }
+        if (access.index_upper_bound.has_value()) {
+            if (auto probe = TRY(probe_for(*access.index_upper_bound)); probe.has_value()) {
+                upper_bound = probe->slack == 0 ? probe->value : Value { probe->value.to_double().value() + probe->slack };
+                has_range = true;
+            }
+        }
+    }
+
+    if (equal_value_count == 0 && !has_range)
+        return Optional<Vector<u32>> {};
+
+    // Bounds are always treated as inclusive; the filters sort out whether a value that's equal to one should be there.
+    auto tree = context.database->get_index(*access.index);
+    auto it = start_key.size() == 0 ? tree->begin() : tree->find_smallest_not_below(start_key);
+
+    Vector<u32> pointers;
+    for (; !it.is_end(); ++it) {
+        auto const& key = *it;
+
+        auto has_equal_values = true;
+        for (size_t ix = 0; ix < equal_value_count; ++ix) {
+            if (key[ix].compare(start_key[ix]) != 0) {
+                has_equal_values = false;
+                break;
+            }
+        }
+        if (!has_equal_values)
+            break;
+
+        if (upper_bound.has_value()) {
+            auto const& value = key[equal_value_count];
+            if (!value.is_null() && value.compare(*upper_bound) > 0)
+                break;
+        }
+
+        // Keys with a null pointer are what is left of removed rows.
+        if (key.pointer() != 0)
+            TRY(pointers.try_append(key.pointer()));
+    }
+    return pointers;
+}
+
+ResultOr<Optional<Vector<size_t>>> QueryPlan::probe_hash_table(ExecutionContext& context, TableAccess& access, Tuple& outer_row)
+{
+    auto const& condition = *access.hash_condition;
+    auto column_type = access.table->columns()[condition.column_index].type();
+
+    if (!access.has_hash_table) {
+        auto const& rows = *TRY(scanned_rows(context, access));
+        for (size_t ix = 0; ix < rows.size(); ++ix) {
+            auto const& value = rows[ix][condition.column_index];
+            // A NULL never compares as equal to anything.
+            if (value.is_null())
+                continue;
+
+            auto bucket = hash_bucket(column_type, value);
+            if (!bucket.has_value()) {
+                access.hash_table_is_incomplete = true;
+                break;
+            }
+            TRY(access.hash_table.ensure(*bucket).try_append(ix));
+        }
+        access.has_hash_table = true;
+    }
+
+    if (access.hash_table_is_incomplete)
+        return Optional<Vector<size_t>> {};
+
+    context.current_row = &outer_row;
+    auto value = TRY(condition.value->evaluate(context));
+    if (value.is_null())
+        return Vector<size_t> {};
+
+    auto probe = index_probe(column_type, value, condition.column_is_lhs);
+    if (!probe.has_value())
+        return Optional<Vector<size_t>> {};
+
+    if (column_type == SQLType::Text)
+        return access.hash_table.get(*hash_bucket(column_type, probe->value)).value_or({});
+
+    // The values that compare as equal are at most half a unit away, which is at most two buckets.
+    auto as_double = probe->value.to_double().value();
+    auto first_bucket = hash_bucket(column_type, Value { as_double - 0.5 });
+    auto last_bucket = hash_bucket(column_type, Value { as_double + 0.5 });
+    if (!first_bucket.has_value() || !last_bucket.has_value())
+        return Optional<Vector<size_t>> {};
+
+    auto candidates = access.hash_table.get(*first_bucket).value_or({});
+    if (*last_bucket != *first_bucket) {
+        if (auto more_candidates = access.hash_table.get(*last_bucket); more_candidates.has_value())
+            TRY(candidates.try_extend(*more_candidates));
+    }
+    return candidates;
+}
+
+Vector<DeprecatedString> QueryPlan::describe() const
+{
+    Vector<DeprecatedString> lines;
+    for (auto const& access : m_tables) {
+        auto table_name = DeprecatedString::formatted("{}.{}", access.table->parent()->name(), access.table->name());
+        auto column_name = [&](Condition const& condition) -> DeprecatedString const& {
+            return access.table->columns()[condition.column_index].name();
+        };
+
+        switch (access.method) {
+        case AccessMethod::TableScan:
+            lines.append(DeprecatedString::formatted("SCAN {}", table_name));
+            break;
+        case AccessMethod::IndexSearch: {
+            Vector<DeprecatedString> conditions;
+            for (auto const& equality : access.index_equalities)
+                conditions.append(DeprecatedString::formatted("{}=?", column_name(equality)));
+            if (access.index_lower_bound.has_value())
+                conditions.append(DeprecatedString::formatted("{}>?", column_name(*access.index_lower_bound)));
+            if (access.index_upper_bound.has_value())
+                conditions.append(DeprecatedString::formatted("{}<?", column_name(*access.index_upper_bound)));
+
+            lines.append(DeprecatedString::formatted("SEARCH {} USING INDEX {} ({})", table_name, access.index->name(), DeprecatedString::join(" AND "sv, conditions)));
+            break;
+        }
+        case AccessMethod::HashJoin:
+            lines.append(DeprecatedString::formatted("HASH JOIN {} ({}=?)", table_name, column_name(*access.hash_condition)));
+            break;
+        }
+    }
+
+    if (m_has_ordering)
+        lines.append("SORT RESULTS FOR ORDER BY");
+    return lines;
+}
+
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/DeprecatedString.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/RefPtr.h>
+#include <AK/Vector.h>
+#include <LibSQL/AST/AST.h>
+#include <LibSQL/Forward.h>
+#include <LibSQL/Meta.h>
+#include <LibSQL/Result.h>
+#include <LibSQL/Row.h>
+
+namespace SQL::AST {
+
+// Decides how the rows of a SELECT are found: the tables are joined in the order they're listed in, and every term of
+// the WHERE clause is checked as soon as the tables it refers to have been joined. For each table, a condition on the
+// columns of an index (compared to something that's known by the time the table is reached) is looked up in that
+// index, and a join on an equality without an index is done with a hash table.
+//
+// The access paths only narrow down which rows are looked at; all terms of the WHERE clause are still evaluated for
+// the rows that are found, so that comparing values of different types works the same as it does without indexes.
+class QueryPlan {
+public:
+    static ResultOr<QueryPlan> create(ExecutionContext&, Select const&);
+
+    // Moves on to the next combination of rows that matches the WHERE clause, and returns false once there are none
+    // left. Only as much is read from the tables as is needed to find that row.
+    ResultOr<bool> next_row(ExecutionContext&);
+
+    // The row found by next_row(), which has the columns of all tables, and is only valid until it's called again.
+    Tuple& current_row() { return m_tables.is_empty() ? m_empty_row : m_tables.last().joined_row; }
+
+    // One line per step, in the spirit of SQLite's EXPLAIN QUERY PLAN.
+    Vector<DeprecatedString> describe() const;
+
+private:
+    enum class AccessMethod {
+        TableScan,
+        IndexSearch,
+        HashJoin,
+    };
+
+    // Where the rows of a table are taken from while going through them for one row of the tables before it.
+    enum class RowSource {
+        IndexPointers,
+        HashCandidates,
+        CachedRows,
+        TableChain,
+    };
+
+    // A comparison of a column to something that only refers to the tables before the column's table.
+    struct Condition {
+        size_t column_index { 0 };
+        BinaryOperator op { BinaryOperator::Equals };
+        NonnullRefPtr<Expression> value;
+        // Whether the column was on the left-hand side in the WHERE clause, which decides how the values are compared.
+        bool column_is_lhs { true };
+        bool refers_to_other_tables { false };
+    };
+
+    struct TableAccess {
+        TableAccess(NonnullRefPtr<TableDef> table, NonnullRefPtr<TupleDescriptor> descriptor)
+            : table(move(table))
+            , descriptor(move(descriptor))
+            , joined_row(this->descriptor)
+        {
+        }
+
+        NonnullRefPtr<TableDef> table;
+        // The columns of this table and all tables before it.
+        NonnullRefPtr<TupleDescriptor> descriptor;
+
+        AccessMethod method { AccessMethod::TableScan };
+        RefPtr<IndexDef const> index;
+        Vector<Condition> index_equalities;
+        Optional<Condition> index_lower_bound;
+        Optional<Condition> index_upper_bound;
+        Optional<Condition> hash_condition;
+
+        // Only refer to this table, and are evaluated on its rows before they're joined.
+        Vector<NonnullRefPtr<Expression>> table_filters;
+        // Refer to this table and ones before it, and are evaluated on the joined row.
+        Vector<NonnullRefPtr<Expression>> join_filters;
+
+        // The rows that pass the table filters, read once when the table is scanned or hashed.
+        Optional<Vector<Row>> rows;
+        HashMap<u32, Vector<size_t>> hash_table;
+        bool has_hash_table { false };
+        // Set if some value couldn't be put in a bucket, in which case all rows have to be looked at after all.
+        bool hash_table_is_incomplete { false };
+
+        // The current row of the tables before this one, followed by the current row of this table.
+        Tuple joined_row;
+        RowSource source { RowSource::CachedRows };
+        Vector<u32> pointers;
+        Vector<size_t> candidates;
+        size_t position { 0 };
+        // The first table is read one row at a time, by following the rows from one to the next.
+        u32 next_pointer { 0 };
+        Optional<Row> read_row;
+    };
+
+    QueryPlan() = default;
+
+    static void choose_access_method(TableAccess&, Vector<Condition> const&);
+
+    ResultOr<void> open_table(ExecutionContext&, size_t level);
+    ResultOr<Row const*> next_candidate(ExecutionContext&, size_t level);
+    static ResultOr<bool> matches_table_filters(ExecutionContext&, TableAccess const&, Row&);
+    static ResultOr<Vector<Row> const*> scanned_rows(ExecutionContext&, TableAccess&);
+
+    // These return nothing if the values at hand can't be looked up, and the rows have to be scanned instead.
+    static ResultOr<Optional<Vector<u32>>> search_index(ExecutionContext&, TableAccess&, Tuple& outer_row);
+    static ResultOr<Optional<Vector<size_t>>> probe_hash_table(ExecutionContext&, TableAccess&, Tuple& outer_row);
+
+    Vector<TableAccess> m_tables;
+    Vector<NonnullRefPtr<Expression>> m_constant_filters;
+    bool m_has_ordering { false };
+
+    Tuple m_empty_row;
+    // How many tables are being gone through at the moment, starting at the first one.
+    size_t m_open_levels { 0 };
+    bool m_has_started { false };
+    bool m_is_exhausted { false };
+};
+
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2021, Jan de Visser <jan@de-visser.net>
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/AST/SelectCursor.h>
+#include <LibSQL/Database.h>
+#include <LibSQL/Meta.h>
+
+namespace SQL::AST {
+
+static DeprecatedString result_column_name(ResultColumn const& column, size_t column_index)
+{
+    auto fallback_column_name = [column_index]() {
+        return DeprecatedString::formatted("Column{}", column_index);
+    };
+
+    if (auto const& alias = column.column_alias(); !alias.is_empty())
+        return alias;
+
+    if (column.select_from_expression()) {
+        if (is<ColumnNameExpression>(*column.expression())) {
+            auto const& column_name_expression = verify_cast<ColumnNameExpression>(*column.expression());
+            return column_name_expression.column_name();
+        }
+
+        // FIXME: Generate column names from other result column expressions.
+        return fallback_column_name();
+    }
+
+    VERIFY(column.select_from_table());
+
+    // FIXME: Generate column names from select-from-table result columns.
+    return fallback_column_name();
+}
+
+ResultOr<NonnullOwnPtr<SelectCursor>> SelectCursor::create(NonnullRefPtr<Database> database, Select const& select, ReadonlySpan<Value> placeholder_values)
+{
+    Vector<Value> placeholders;
+    TRY(placeholders.try_ensure_capacity(placeholder_values.size()));
+    for (auto const& value : placeholder_values)
+        placeholders.unchecked_append(value);
+
+    auto cursor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) SelectCursor(move(database), select, move(placeholders))));
+    TRY(cursor->resolve_result_columns());
+    cursor->m_plan = TRY(QueryPlan::create(cursor->m_context, select));
+    TRY(cursor->evaluate_limit_clause());
+    return cursor;
+}
+
+SelectCursor::SelectCursor(NonnullRefPtr<Database> database, Select const& select, Vector<Value> placeholder_values)
+    : m_select(select)
+    , m_placeholder_values(move(placeholder_values))
+    , m_context { move(database), m_select.ptr(), m_placeholder_values.span(), nullptr }
+{
+}
+
+ResultOr<void> SelectCursor::resolve_result_columns()
+{
+    auto const& result_column_list = m_select->result_column_list();
+    VERIFY(!result_column_list.is_empty());
+
+    for (auto& table_descriptor : m_select->table_or_subquery_list()) {
+        if (!table_descriptor.is_table())
+            return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
+
+        auto table_def = TRY(m_context.database->get_table(table_descriptor.schema_name(), table_descriptor.table_name()));
+
+        if (result_column_list.size() == 1 && result_column_list[0].type() == ResultType::All) {
+            TRY(m_columns.try_ensure_capacity(m_columns.size() + table_def->columns().size()));
+            TRY(m_column_names.try_ensure_capacity(m_column_names.size() + table_def->columns().size()));
+
+            for (auto& col : table_def->columns()) {
+                m_columns.unchecked_append(
+                    create_ast_node<ResultColumn>(
+                        create_ast_node<ColumnNameExpression>(table_def->parent()->name(), table_def->name(), col.name()),
+                        ""));
+
+                m_column_names.unchecked_append(col.name());
+            }
+        }
+    }
+
+    if (result_column_list.size() != 1 || result_column_list[0].type() != ResultType::All) {
+        TRY(m_columns.try_ensure_capacity(result_column_list.size()));
+        TRY(m_column_names.try_ensure_capacity(result_column_list.size()));
+
+        for (size_t i = 0; i < result_column_list.size(); ++i) {
+            auto const& col = result_column_list[i];
+
+            if (col.type() == ResultType::All) {
+                // FIXME can have '*' for example in conjunction with computed columns
+                return Result { SQLCommand::Select, SQLErrorCode::SyntaxError, "*"sv };
+            }
+
+            m_columns.unchecked_append(col);
+            m_column_names.unchecked_append(result_column_name(col, i));
+        }
+    }
+
+    return {};
+}
+
+ResultOr<void> SelectCursor::evaluate_limit_clause()
+{
+    auto const& limit_clause = m_select->limit_clause();
+    if (limit_clause == nullptr)
+        return {};
+
+    auto limit = TRY(limit_clause->limit_expression()->evaluate(m_context));
+    if (!limit.is_null()) {
+        auto limit_value_maybe = limit.to_int<size_t>();
+        if (!limit_value_maybe.has_value())
+            return Result { SQLCommand::Select, SQLErrorCode::SyntaxError, "LIMIT clause must evaluate to an integer value"sv };
+
+        m_limit = limit_value_maybe.value();
+    }
+
+    if (limit_clause->offset_expression() != nullptr) {
+        auto offset = TRY(limit_clause->offset_expression()->evaluate(m_context));
+        if (!offset.is_null()) {
+            auto offset_value_maybe = offset.to_int<size_t>();
+            if (!offset_value_maybe.has_value())
+                return Result { SQLCommand::Select, SQLErrorCode::SyntaxError, "OFFSET clause must evaluate to an integer value"sv };
+
+            m_offset = offset_value_maybe.value();
+        }
+    }
+
+    return {};
+}
+
+ResultOr<Optional<Tuple>> SelectCursor::next()
+{
+    if (m_returned_rows >= m_limit)
+        return Optional<Tuple> {};
+
+    if (!m_select->ordering_term_list().is_empty()) {
+        if (!m_sorted_rows.has_value())
+            TRY(sort_rows());
+        if (m_sorted_position >= m_sorted_rows->size())
+            return Optional<Tuple> {};
+
+        ++m_returned_rows;
+        return move(m_sorted_rows->at(m_sorted_position++).row);
+    }
+
+    // The rows before the OFFSET are never looked at, so they don't have to be projected either.
+    for (; m_skipped_rows < m_offset; ++m_skipped_rows) {
+        if (!TRY(m_plan->next_row(m_context)))
+            return Optional<Tuple> {};
+    }
+
+    if (!TRY(m_plan->next_row(m_context)))
+        return Optional<Tuple> {};
+
+    ++m_returned_rows;
+    return TRY(project_current_row());
+}
+
+ResultOr<void> SelectCursor::sort_rows()
+{
+    // Only the rows that end up before the limit have to be kept, and since rows with an equal sort key stay in the
+    // order they were found in, a row that falls off the end would never have made it back in.
+    auto kept_rows = (m_limit > NumericLimits<size_t>::max() - m_offset) ? NumericLimits<size_t>::max() : m_offset + m_limit;
+
+    auto sort_descriptor = adopt_ref(*new TupleDescriptor);
+    for (auto& term : m_select->ordering_term_list())
+        sort_descriptor->append(TupleElementDescriptor { .order = term.order() });
+
+    ResultSet sorted_rows { SQLCommand::Select };
+    while (TRY(m_plan->next_row(m_context))) {
+        auto row = TRY(project_current_row());
+        auto sort_key = TRY(evaluate_sort_key(sort_descriptor));
+
+        sorted_rows.insert_row(row, sort_key);
+        if (sorted_rows.size() > kept_rows)
+            sorted_rows.take_last();
+    }
+
+    m_sorted_position = min(m_offset, sorted_rows.size());
+    m_sorted_rows = move(sorted_rows);
+    return {};
+}
+
+ResultOr<Tuple> SelectCursor::project_current_row()
+{
+    m_context.current_row = &m_plan->current_row();
+
+    // The descriptor is made from the values of the first row, and then shared by all rows.
+    m_projected_row.clear();
+    for (auto& col : m_columns) {
+        auto value = TRY(col.expression()->evaluate(m_context));
+        m_projected_row.append(value);
+    }
+    return m_projected_row;
+}
+
+ResultOr<Tuple> SelectCursor::evaluate_sort_key(NonnullRefPtr<TupleDescriptor> const& sort_descriptor)
+{
+    m_context.current_row = &m_plan->current_row();
+
+    Tuple sort_key(sort_descriptor);
+    sort_key.clear();
+    for (auto& term : m_select->ordering_term_list()) {
+        auto value = TRY(term.expression()->evaluate(m_context));
+        sort_key.append(value);
+    }
+    return sort_key;
+}
+
+}
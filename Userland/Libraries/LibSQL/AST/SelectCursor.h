@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/DeprecatedString.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/NumericLimits.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibSQL/AST/AST.h>
+#include <LibSQL/AST/QueryPlan.h>
+#include <LibSQL/Forward.h>
+#include <LibSQL/Result.h>
+#include <LibSQL/ResultSet.h>
+#include <LibSQL/Tuple.h>
+#include <LibSQL/TupleDescriptor.h>
+#include <LibSQL/Value.h>
+
+namespace SQL::AST {
+
+// Produces the rows of a SELECT one at a time, as they're asked for. The rows come from the query plan, and are then
+// projected onto the result columns, sorted and limited:
+//
+// - Without an ORDER BY, nothing is read from the tables before the first row is asked for, and nothing is read past
+//   the last row that's within the LIMIT.
+// - With one, all rows have to be looked at before the first one can be returned, but only the ones that can still
+//   end up within the LIMIT are kept while doing so.
+class SelectCursor {
+    AK_MAKE_NONCOPYABLE(SelectCursor);
+    AK_MAKE_NONMOVABLE(SelectCursor);
+
+public:
+    static ResultOr<NonnullOwnPtr<SelectCursor>> create(NonnullRefPtr<Database>, Select const&, ReadonlySpan<Value> placeholder_values = {});
+
+    Vector<DeprecatedString> const& column_names() const { return m_column_names; }
+
+    // Returns nothing once all rows have been produced.
+    ResultOr<Optional<Tuple>> next();
+
+private:
+    SelectCursor(NonnullRefPtr<Database>, Select const&, Vector<Value> placeholder_values);
+
+    ResultOr<void> resolve_result_columns();
+    ResultOr<void> evaluate_limit_clause();
+    ResultOr<void> sort_rows();
+
+    ResultOr<Tuple> project_current_row();
+    ResultOr<Tuple> evaluate_sort_key(NonnullRefPtr<TupleDescriptor> const&);
+
+    NonnullRefPtr<Select const> m_select;
+    Vector<Value> m_placeholder_values;
+    ExecutionContext m_context;
+    Optional<QueryPlan> m_plan;
+
+    NonnullRefPtrVector<ResultColumn> m_columns;
+    Vector<DeprecatedString> m_column_names;
+    Tuple m_projected_row;
+
+    size_t m_offset { 0 };
+    size_t m_limit { NumericLimits<size_t>::max() };
+    size_t m_skipped_rows { 0 };
+    size_t m_returned_rows { 0 };
+
+    Optional<ResultSet> m_sorted_rows;
+    size_t m_sorted_position { 0 };
+};
+
+}
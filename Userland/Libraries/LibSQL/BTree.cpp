@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/QuickSort.h>
 #include <LibSQL/BTree.h>
 #include <LibSQL/Meta.h>
 
@@ -45,6 +46,8 @@ void BTree::initialize_root()
     } else {
         set_pointer(new_record_pointer());
         m_root = make<TreeNode>(*this, nullptr, pointer());
+        // The block has to be written even if nothing is ever inserted, since the heap can't have holes in it.
+        serializer().serialize_and_write(*m_root.ptr());
         if (on_new_root)
             on_new_root();
     }
@@ -61,12 +64,150 @@ TreeNode* BTree::new_root()
     return m_root;
 }
 
+// The key that's looked for is compared to a lot of keys on the way down, so it's encoded up front, with the types of
+// the tree's keys so that the encodings can be compared to each other.
+Key BTree::search_key(Key const& key) const
+{
+    if (key.size() > descriptor()->size())
+        return key;
+
+    Key search_key { descriptor() };
+    search_key.clear();
+    for (size_t ix = 0; ix < key.size(); ++ix)
+        search_key.append(key[ix]);
+    search_key.set_pointer(key.pointer());
+    search_key.cache_sort_key();
+    return search_key;
+}
+
 bool BTree::insert(Key const& key)
 {
     if (!m_root)
         initialize_root();
     VERIFY(m_root);
-    return m_root->insert(key);
+    return m_root->insert(search_key(key));
+}
+
+bool BTree::bulk_insert(Vector<Key> const& keys)
+{
+    if (!m_root)
+        initialize_root();
+    VERIFY(m_root);
+
+    Vector<Key> search_keys;
+    search_keys.ensure_capacity(keys.size());
+    for (auto const& key : keys)
+        search_keys.unchecked_append(search_key(key));
+
+    // Sorting the positions of the keys is a lot cheaper than moving the keys themselves around.
+    Vector<size_t> order;
+    order.ensure_capacity(search_keys.size());
+    for (size_t ix = 0; ix < search_keys.size(); ++ix)
+        order.unchecked_append(ix);
+    quick_sort(order, [&](size_t a, size_t b) {
+        auto result = search_keys[a].compare(search_keys[b]);
+        return result < 0 || (result == 0 && a < b);
+    });
+
+    // A node can only be packed with keys if several of them fit in a block.
+    auto can_build_tree = m_root->is_leaf() && m_root->size() == 0;
+    for (auto const& key : search_keys) {
+        if (key.length() > BLOCKSIZE / 4)
+            can_build_tree = false;
+    }
+
+    if (!can_build_tree) {
+        auto all_inserted = true;
+        for (auto ix : order) {
+            if (!m_root->insert(search_keys[ix]))
+                all_inserted = false;
+        }
+        return all_inserted;
+    }
+
+    Vector<Key> sorted_keys;
+    sorted_keys.ensure_capacity(search_keys.size());
+    auto all_inserted = true;
+    for (auto ix : order) {
+        if (!duplicates_allowed() && !sorted_keys.is_empty() && sorted_keys.last().compare(search_keys[ix]) == 0) {
+            all_inserted = false;
+            continue;
+        }
+        sorted_keys.unchecked_append(move(search_keys[ix]));
+    }
+
+    build_from_sorted_keys(move(sorted_keys));
+    return all_inserted;
+}
+
+// Every level of the tree is made by putting as many keys in a node as fit, then moving the key after it up to the
+// next level, to separate that node from the next one. Those keys then make up the level above, until they all fit in
+// the root. Only the nodes that are being filled are kept in memory; the others are loaded again when they're needed.
+void BTree::build_from_sorted_keys(Vector<Key> keys)
+{
+    if (keys.is_empty())
+        return;
+
+    // The pointers to the nodes of the level below, one more than there are keys on this level.
+    Vector<u32> children;
+    while (true) {
+        Vector<size_t> node_ends;
+        size_t node_start = 0;
+        // A node holds the number of keys and the rightmost pointer, and a pointer to the left of every key.
+        size_t node_length = 2 * sizeof(u32);
+        for (size_t ix = 0; ix < keys.size(); ++ix) {
+            auto key_length = sizeof(u32) + keys[ix].length();
+            if (ix > node_start && node_length + key_length > BLOCKSIZE) {
+                node_ends.append(ix);
+                node_start = ix + 1;
+                node_length = 2 * sizeof(u32);
+                continue;
+            }
+            node_length += key_length;
+        }
+
+        // If the last key moved up, there's nothing left to its right, so it takes the place of the one before it.
+        if (node_start == keys.size()) {
+            auto previous_begin = (node_ends.size() == 1) ? 0 : node_ends[node_ends.size() - 2] + 1;
+            VERIFY(node_ends.last() - 1 > previous_begin);
+            --node_ends.last();
+        }
+
+        auto fill_node = [&](TreeNode& node, size_t begin, size_t end) {
+            node.m_is_leaf = children.is_empty();
+            for (auto ix = begin; ix < end; ++ix) {
+                node.m_entries.append(move(keys[ix]));
+                node.m_down.empend(&node, children.is_empty() ? 0u : children[ix]);
+            }
+            node.m_down.empend(&node, children.is_empty() ? 0u : children[end]);
+        };
+
+        if (node_ends.is_empty()) {
+            m_root = make<TreeNode>(*this, pointer());
+            fill_node(*m_root, 0, keys.size());
+            serializer().serialize_and_write(*m_root.ptr());
+            return;
+        }
+
+        Vector<Key> separators;
+        Vector<u32> nodes;
+        separators.ensure_capacity(node_ends.size());
+        nodes.ensure_capacity(node_ends.size() + 1);
+        for (size_t node_index = 0; node_index <= node_ends.size(); ++node_index) {
+            auto begin = (node_index == 0) ? 0 : node_ends[node_index - 1] + 1;
+            auto end = (node_index < node_ends.size()) ? node_ends[node_index] : keys.size();
+
+            TreeNode node(*this, new_record_pointer());
+            fill_node(node, begin, end);
+            serializer().serialize_and_write(node);
+            nodes.unchecked_append(node.pointer());
+            if (node_index < node_ends.size())
+                separators.unchecked_append(move(keys[end]));
+        }
+
+        keys = move(separators);
+        children = move(nodes);
+    }
 }
 
 bool BTree::update_key_pointer(Key const& key)
@@ -74,7 +215,7 @@ bool BTree::update_key_pointer(Key const& key)
     if (!m_root)
         initialize_root();
     VERIFY(m_root);
-    return m_root->update_key_pointer(key);
+    return m_root->update_key_pointer(search_key(key));
 }
 
 Optional<u32> BTree::get(Key& key)
@@ -82,7 +223,10 @@ Optional<u32> BTree::get(Key& key)
     if (!m_root)
         initialize_root();
     VERIFY(m_root);
-    return m_root->get(key);
+    auto lookup_key = search_key(key);
+    auto pointer = m_root->get(lookup_key);
+    key.set_pointer(lookup_key.pointer());
+    return pointer;
 }
 
 BTreeIterator BTree::find(Key const& key)
@@ -90,7 +234,7 @@ BTreeIterator BTree::find(Key const& key)
     if (!m_root)
         initialize_root();
     VERIFY(m_root);
-    for (auto node = m_root->node_for(key); node; node = node->up()) {
+    for (auto node = m_root->node_for(search_key(key)); node; node = node->up()) {
         for (auto ix = 0u; ix < node->size(); ix++) {
             auto match = (*node)[ix].match(key);
             if (match == 0)
@@ -102,6 +246,29 @@ BTreeIterator BTree::find(Key const& key)
     return end();
 }
 
+BTreeIterator BTree::find_smallest_not_below(Key const& key)
+{
+    if (!m_root)
+        initialize_root();
+    VERIFY(m_root);
+    auto lookup_key = search_key(key);
+
+    // Non-leaf nodes hold keys too, so the key we're looking for is either in the leaf we end up in, or it's the
+    // last one we stepped over on the way down.
+    auto result = end();
+    for (auto* node = m_root.ptr(); node;) {
+        size_t ix = 0;
+        while (ix < node->size() && (*node)[ix].compare(lookup_key) < 0)
+            ++ix;
+        if (ix < node->size())
+            result = BTreeIterator(node, (int)ix);
+        if (node->is_leaf())
+            break;
+        node = node->down_node(ix);
+    }
+    return result;
+}
+
 void BTree::list_tree()
 {
     if (!m_root)
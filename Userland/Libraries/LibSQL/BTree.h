@@ -100,9 +100,14 @@ public:
 
     u32 root() const { return (m_root) ? m_root->pointer() : 0; }
     bool insert(Key const&);
+    // Inserts a batch of keys in sorted order. An empty tree is built from the leaves up instead, with every node as
+    // full as it can be. Returns false if any of the keys was already there, in which case it's left out.
+    bool bulk_insert(Vector<Key> const&);
     bool update_key_pointer(Key const&);
     Optional<u32> get(Key&);
     BTreeIterator find(Key const& key);
+    // Unlike find(), this also works when there's no exact match, and the key can be a prefix of the tree's keys.
+    BTreeIterator find_smallest_not_below(Key const& key);
     BTreeIterator begin();
     static BTreeIterator end();
     void list_tree();
@@ -114,6 +119,8 @@ private:
     BTree(Serializer&, NonnullRefPtr<TupleDescriptor> const&, u32 pointer);
     void initialize_root();
     TreeNode* new_root();
+    Key search_key(Key const&) const;
+    void build_from_sorted_keys(Vector<Key>);
     OwnPtr<TreeNode> m_root { nullptr };
 
     friend BTreeIterator;
@@ -6,6 +6,7 @@
  */
 
 #include <AK/DeprecatedString.h>
+#include <AK/QuickSort.h>
 #include <AK/RefPtr.h>
 
 #include <LibSQL/BTree.h>
@@ -42,6 +43,11 @@ ResultOr<void> Database::open()
         m_heap->set_table_columns_root(m_table_columns->root());
     };
 
+    m_table_indexes = BTree::construct(m_serializer, IndexDef::index_def()->to_tuple_descriptor(), m_heap->table_indexes_root());
+    m_table_indexes->on_new_root = [&]() {
+        m_heap->set_table_indexes_root(m_table_indexes->root());
+    };
+
     m_open = true;
 
     auto ensure_schema_exists = [&](auto schema_name) -> ResultOr<NonnullRefPtr<SchemaDef>> {
@@ -167,9 +173,147 @@ ResultOr<NonnullRefPtr<TableDef>> Database::get_table(DeprecatedString const& sc
     for (auto it = m_table_columns->find(column_key); !it.is_end() && ((*it)["table_hash"].to_int<u32>() == table_hash); ++it)
         table_def->append_column(*it);
 
+    auto index_key = IndexDef::make_key(*table_def);
+    for (auto it = m_table_indexes->find(index_key); !it.is_end() && ((*it)["table_hash"].to_int<u32>() == table_hash); ++it) {
+        auto index_def = IndexDef::construct(table_def.ptr(), (*it)["index_name"].to_deprecated_string(), (*it)["unique"].to_int<i32>() == 1, (*it).pointer());
+
+        // The key parts of an index are stored like the columns of a table, with the index as their parent.
+        auto index_hash = index_def->hash();
+        auto key_part_key = ColumnDef::make_key(*index_def);
+        for (auto part_it = m_table_columns->find(key_part_key); !part_it.is_end() && ((*part_it)["table_hash"].to_int<u32>() == index_hash); ++part_it)
+            index_def->append_column(*part_it);
+
+        table_def->append_index(index_def);
+    }
+
     return table_def;
 }
 
+static NonnullRefPtr<TupleDescriptor> index_key_descriptor(IndexDef const& index)
+{
+    // The numbers in the keys are all Floats (see index_value() below), and the descriptor says so too, so that the keys
+    // can be compared as bytes.
+    auto descriptor = index.to_tuple_descriptor();
+    for (auto& element : *descriptor) {
+        if (element.type == SQLType::Integer)
+            element.type = SQLType::Float;
+    }
+    descriptor->append({ "", "", "$row", SQLType::Integer, Order::Ascending });
+    return descriptor;
+}
+
+Value Database::index_value(SQLType type, Value const& value)
+{
+    // Numbers are stored as whatever they were written as, but an Integer and a Float that compare as equal have to
+    // end up next to each other in the index.
+    if ((type == SQLType::Integer || type == SQLType::Float) && !value.is_null()) {
+        if (auto as_double = value.to_double(); as_double.has_value())
+            return Value { as_double.value() };
+    }
+    return value;
+}
+
+Key Database::make_index_key(IndexDef const& index, Row const& row)
+{
+    Key key(index_key_descriptor(index));
+    for (size_t ix = 0; ix < index.size(); ++ix) {
+        auto const& key_part = index.key_definition()[ix];
+        key[ix] = index_value(key_part.type(), row[key_part.name()]);
+    }
+    key[index.size()] = row.pointer();
+    key.set_pointer(row.pointer());
+    return key;
+}
+
+static bool have_same_non_null_values(Key const& a, Key const& b, size_t count)
+{
+    for (size_t ix = 0; ix < count; ++ix) {
+        if (a[ix].is_null() || b[ix].is_null() || a[ix].compare(b[ix]) != 0)
+            return false;
+    }
+    return true;
+}
+
+ResultOr<void> Database::add_index(TableDef& table, IndexDef& index)
+{
+    VERIFY(is_open());
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
+
+    for (auto& existing_index : table.indexes()) {
+        if (existing_index.name() == index.name())
+            return Result { SQLCommand::Create, SQLErrorCode::IndexExists, index.name() };
+    }
+
+    // The existing rows are checked against a unique index before anything is written, so that a violated constraint
+    // doesn't leave half an index behind.
+    auto rows = TRY(select_all(table));
+    Vector<Key> keys;
+    TRY(keys.try_ensure_capacity(rows.size()));
+    for (auto const& row : rows)
+        keys.unchecked_append(make_index_key(index, row));
+    quick_sort(keys);
+
+    if (index.unique()) {
+        for (size_t ix = 1; ix < keys.size(); ++ix) {
+            if (have_same_non_null_values(keys[ix - 1], keys[ix], index.size()))
+                return Result { SQLCommand::Create, SQLErrorCode::UniqueConstraintViolated, index.name() };
+        }
+    }
+
+    if (!m_table_indexes->insert(index.key()))
+        return Result { SQLCommand::Create, SQLErrorCode::IndexExists, index.name() };
+
+    for (auto& key_part : index.key_definition()) {
+        if (!m_table_columns->insert(key_part.key()))
+            VERIFY_NOT_REACHED();
+    }
+
+    table.append_index(index);
+
+    if (!get_index(index)->bulk_insert(keys))
+        VERIFY_NOT_REACHED();
+
+    return {};
+}
+
+NonnullRefPtr<BTree> Database::get_index(IndexDef const& index)
+{
+    auto index_key = index.key();
+    if (auto it = m_index_cache.find(index_key.hash()); it != m_index_cache.end())
+        return it->value;
+
+    auto tree = BTree::construct(m_serializer, index_key_descriptor(index), true, index.pointer());
+    tree->on_new_root = [this, tree = tree.ptr(), index_key]() mutable {
+        index_key.set_pointer(tree->root());
+        m_table_indexes->update_key_pointer(index_key);
+    };
+    m_index_cache.set(index_key.hash(), tree);
+    return tree;
+}
+
+ResultOr<void> Database::check_unique_constraint(IndexDef const& index, Row const& row, u32 row_pointer)
+{
+    if (!index.unique())
+        return {};
+
+    auto key = make_index_key(index, row);
+    Key values;
+    for (size_t ix = 0; ix < index.size(); ++ix) {
+        // As in other databases, NULLs never violate a unique constraint.
+        if (key[ix].is_null())
+            return {};
+        values.append(key[ix]);
+    }
+
+    auto tree = get_index(index);
+    for (auto it = tree->find_smallest_not_below(values); !it.is_end() && (*it).compare(values) == 0; ++it) {
+        // Keys with a null pointer are what is left of removed rows.
+        if ((*it).pointer() != 0 && (*it).pointer() != row_pointer)
+            return Result { SQLCommand::Unknown, SQLErrorCode::UniqueConstraintViolated, index.name() };
+    }
+    return {};
+}
+
 ErrorOr<Vector<Row>> Database::select_all(TableDef const& table)
 {
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
@@ -180,6 +324,13 @@ ErrorOr<Vector<Row>> Database::select_all(TableDef const& table)
     return ret;
 }
 
+ErrorOr<Row> Database::get_row(TableDef& table, u32 pointer)
+{
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
+    VERIFY(pointer != 0);
+    return m_serializer.deserialize_block<Row>(pointer, table, pointer);
+}
+
 ErrorOr<Vector<Row>> Database::match(TableDef const& table, Key const& key)
 {
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
@@ -196,21 +347,65 @@ ErrorOr<Vector<Row>> Database::match(TableDef const& table, Key const& key)
     return ret;
 }
 
-ErrorOr<void> Database::insert(Row& row)
+ResultOr<void> Database::insert(Row& row)
+{
+    return insert(Span<Row> { &row, 1 });
+}
+
+ResultOr<void> Database::insert(Span<Row> rows)
 {
-    VERIFY(m_table_cache.get(row.table().key().hash()).has_value());
+    if (rows.is_empty())
+        return {};
+
+    auto& table = rows[0].table();
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
     // TODO Check constraints
 
-    row.set_pointer(m_heap->new_record_pointer());
-    row.set_next_pointer(row.table().pointer());
-    TRY(update(row));
+    // Nothing is written before all rows are known to fit the unique constraints, both with the rows that are already
+    // there and with each other. The row objects may have been used to insert a row before, but they're new rows now.
+    for (auto const& index : table.indexes()) {
+        if (!index.unique())
+            continue;
+
+        for (auto const& row : rows)
+            TRY(check_unique_constraint(index, row, 0));
+
+        if (rows.size() > 1) {
+            Vector<Key> keys;
+            TRY(keys.try_ensure_capacity(rows.size()));
+            for (auto const& row : rows)
+                keys.unchecked_append(make_index_key(index, row));
+            quick_sort(keys);
+
+            for (size_t ix = 1; ix < keys.size(); ++ix) {
+                if (have_same_non_null_values(keys[ix - 1], keys[ix], index.size()))
+                    return Result { SQLCommand::Unknown, SQLErrorCode::UniqueConstraintViolated, index.name() };
+            }
+        }
+    }
+
+    // Rows are added to the front of the table's list of rows, so each one points to the one inserted before it.
+    for (auto& row : rows) {
+        VERIFY(&row.table() == &table);
+        row.set_pointer(m_heap->new_record_pointer());
+        row.set_next_pointer(table.pointer());
+        write_row(row);
+        table.set_pointer(row.pointer());
+    }
+
+    for (auto const& index : table.indexes()) {
+        Vector<Key> keys;
+        TRY(keys.try_ensure_capacity(rows.size()));
+        for (auto const& row : rows)
+            keys.unchecked_append(make_index_key(index, row));
 
-    // TODO update indexes defined on table.
+        if (!get_index(index)->bulk_insert(keys))
+            VERIFY_NOT_REACHED();
+    }
 
-    auto table_key = row.table().key();
-    table_key.set_pointer(row.pointer());
+    auto table_key = table.key();
+    table_key.set_pointer(table.pointer());
     VERIFY(m_tables->update_key_pointer(table_key));
-    row.table().set_pointer(row.pointer());
     return {};
 }
 
@@ -219,6 +414,13 @@ ErrorOr<void> Database::remove(Row& row)
     auto& table = row.table();
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
 
+    // FIXME: BTree can't remove keys yet, so the keys of the row are left in its indexes, pointing nowhere.
+    for (auto const& index : table.indexes()) {
+        auto key = make_index_key(index, row);
+        key.set_pointer(0);
+        get_index(index)->update_key_pointer(key);
+    }
+
     if (table.pointer() == row.pointer()) {
         auto table_key = table.key();
         table_key.set_pointer(row.next_pointer());
@@ -233,7 +435,7 @@ ErrorOr<void> Database::remove(Row& row)
 
         if (current.next_pointer() == row.pointer()) {
             current.set_next_pointer(row.next_pointer());
-            TRY(update(current));
+            write_row(current);
             break;
         }
 
@@ -243,15 +445,45 @@ ErrorOr<void> Database::remove(Row& row)
     return {};
 }
 
-ErrorOr<void> Database::update(Row& tuple)
+ResultOr<void> Database::update(Row& row)
 {
-    VERIFY(m_table_cache.get(tuple.table().key().hash()).has_value());
+    auto& table = row.table();
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
     // TODO Check constraints
-    m_serializer.reset();
-    m_serializer.serialize_and_write<Tuple>(tuple);
 
-    // TODO update indexes defined on table.
+    if (table.num_indexes() == 0) {
+        write_row(row);
+        return {};
+    }
+
+    for (auto const& index : table.indexes())
+        TRY(check_unique_constraint(index, row, row.pointer()));
+
+    auto old_row = TRY(get_row(table, row.pointer()));
+    write_row(row);
+
+    for (auto const& index : table.indexes()) {
+        auto old_key = make_index_key(index, old_row);
+        auto new_key = make_index_key(index, row);
+        if (old_key == new_key)
+            continue;
+
+        auto tree = get_index(index);
+        old_key.set_pointer(0);
+        tree->update_key_pointer(old_key);
+
+        // If the row had these values before, their key is still there and only has to point to the row again.
+        if (!tree->update_key_pointer(new_key) && !tree->insert(new_key))
+            VERIFY_NOT_REACHED();
+    }
+
     return {};
 }
 
+void Database::write_row(Row& row)
+{
+    m_serializer.reset();
+    m_serializer.serialize_and_write<Tuple>(row);
+}
+
 }
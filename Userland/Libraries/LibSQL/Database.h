@@ -41,24 +41,40 @@ public:
     static Key get_table_key(DeprecatedString const&, DeprecatedString const&);
     ResultOr<NonnullRefPtr<TableDef>> get_table(DeprecatedString const&, DeprecatedString const&);
 
+    ResultOr<void> add_index(TableDef&, IndexDef&);
+    NonnullRefPtr<BTree> get_index(IndexDef const&);
+
     ErrorOr<Vector<Row>> select_all(TableDef const&);
     ErrorOr<Vector<Row>> match(TableDef const&, Key const&);
-    ErrorOr<void> insert(Row&);
+    ErrorOr<Row> get_row(TableDef&, u32 pointer);
+    ResultOr<void> insert(Row&);
+    // Inserts rows that all belong to the same table, updating each index once for all of them.
+    ResultOr<void> insert(Span<Row>);
     ErrorOr<void> remove(Row&);
-    ErrorOr<void> update(Row&);
+    ResultOr<void> update(Row&);
+
+    // The keys of an index hold the values of the indexed columns, followed by the pointer to the row, so that rows
+    // with the same values (or a prefix of them) can be found next to each other.
+    static Key make_index_key(IndexDef const&, Row const&);
+    static Value index_value(SQLType, Value const&);
 
 private:
     explicit Database(DeprecatedString);
 
+    ResultOr<void> check_unique_constraint(IndexDef const&, Row const&, u32 row_pointer);
+    void write_row(Row&);
+
     bool m_open { false };
     NonnullRefPtr<Heap> m_heap;
     Serializer m_serializer;
     RefPtr<BTree> m_schemas;
     RefPtr<BTree> m_tables;
     RefPtr<BTree> m_table_columns;
+    RefPtr<BTree> m_table_indexes;
 
     HashMap<u32, NonnullRefPtr<SchemaDef>> m_schema_cache;
     HashMap<u32, NonnullRefPtr<TableDef>> m_table_cache;
+    HashMap<u32, NonnullRefPtr<BTree>> m_index_cache;
 };
 
 }
@@ -50,6 +50,7 @@ class ColumnDefinition;
 class ColumnNameExpression;
 class CommonTableExpression;
 class CommonTableExpressionList;
+class CreateIndex;
 class CreateTable;
 class Delete;
 class DropColumn;
@@ -57,9 +58,11 @@ class DropTable;
 class ErrorExpression;
 class ErrorStatement;
 class ExistsExpression;
+class Explain;
 class Expression;
 class GroupByClause;
 class InChainedExpression;
+class IndexedColumn;
 class InSelectionExpression;
 class Insert;
 class InTableExpression;
@@ -82,6 +85,7 @@ class RenameTable;
 class ResultColumn;
 class ReturningClause;
 class Select;
+class SelectCursor;
 class SignedNumber;
 class Statement;
 class StringLiteral;
@@ -7,6 +7,7 @@
 #include <AK/DeprecatedString.h>
 #include <AK/Format.h>
 #include <AK/QuickSort.h>
+#include <AK/StringHash.h>
 #include <LibCore/IODevice.h>
 #include <LibCore/System.h>
 #include <LibSQL/Heap.h>
@@ -23,14 +24,24 @@ Heap::Heap(DeprecatedString file_name)
 
 Heap::~Heap()
 {
-    if (m_file && !m_write_ahead_log.is_empty()) {
-        if (auto maybe_error = flush(); maybe_error.is_error())
+    if (!m_file)
+        return;
+
+    if (auto maybe_error = flush(); maybe_error.is_error()) {
+        warnln("~Heap({}): {}", name(), maybe_error.error());
+        return;
+    }
+
+    if (m_logged_block_count > 0) {
+        if (auto maybe_error = checkpoint(); maybe_error.is_error())
             warnln("~Heap({}): {}", name(), maybe_error.error());
     }
 }
 
 ErrorOr<void> Heap::open()
 {
+    clear_cache();
+
     size_t file_size = 0;
     struct stat stat_buffer;
     if (stat(name().characters(), &stat_buffer) != 0) {
@@ -47,12 +58,30 @@ ErrorOr<void> Heap::open()
     if (file_size > 0)
         m_next_block = m_end_of_file = file_size / BLOCKSIZE;
 
-    auto file = TRY(Core::File::open(name(), Core::File::OpenMode::ReadWrite));
-    m_file = TRY(Core::BufferedFile::create(move(file)));
+    m_file = TRY(Core::File::open(name(), Core::File::OpenMode::ReadWrite));
+
+    // Whatever was flushed before the heap was last closed may not have made it to the heap file, so it's written
+    // again from the log before anything is read. The log itself is only created once something is flushed, so that
+    // opening a file that turns out not to be a heap file doesn't leave one behind.
+    if (auto error_maybe = recover_from_write_ahead_log(); error_maybe.is_error()) {
+        m_file = nullptr;
+        m_write_ahead_log = nullptr;
+        return error_maybe.release_error();
+    }
+
+    auto stat_or_error = Core::System::fstat(m_file->fd());
+    if (stat_or_error.is_error()) {
+        m_file = nullptr;
+        m_write_ahead_log = nullptr;
+        return stat_or_error.release_error();
+    }
+    file_size = stat_or_error.value().st_size;
 
     if (file_size > 0) {
+        m_next_block = m_end_of_file = file_size / BLOCKSIZE;
         if (auto error_maybe = read_zero_block(); error_maybe.is_error()) {
             m_file = nullptr;
+            m_write_ahead_log = nullptr;
             return error_maybe.release_error();
         }
     } else {
@@ -63,8 +92,12 @@ ErrorOr<void> Heap::open()
     if (m_version != current_version) {
         dbgln_if(SQL_DEBUG, "Heap file {} opened has incompatible version {}. Deleting for version {}.", name(), m_version, current_version);
         m_file = nullptr;
+        m_write_ahead_log = nullptr;
+        m_pending_blocks.clear();
 
         TRY(Core::System::unlink(name()));
+        if (auto result = Core::System::unlink(write_ahead_log_name()); result.is_error() && result.error().code() != ENOENT)
+            return result.release_error();
         return open();
     }
 
@@ -79,7 +112,7 @@ ErrorOr<ByteBuffer> Heap::read_block(u32 block)
         return Error::from_string_literal("Heap()::read_block(): Heap file not opened");
     }
 
-    if (auto buffer = m_write_ahead_log.get(block); buffer.has_value())
+    if (auto buffer = m_pending_blocks.get(block); buffer.has_value())
         return TRY(ByteBuffer::copy(*buffer));
 
     if (block >= m_next_block) {
@@ -87,6 +120,12 @@ ErrorOr<ByteBuffer> Heap::read_block(u32 block)
         return Error::from_string_literal("Heap()::read_block(): block # out of range");
     }
 
+    if (auto cached_block = m_cached_blocks.get(block); cached_block.has_value()) {
+        m_lru_blocks.remove(**cached_block);
+        m_lru_blocks.prepend(**cached_block);
+        return TRY(ByteBuffer::copy((*cached_block)->data));
+    }
+
     dbgln_if(SQL_DEBUG, "Read heap block {}", block);
     TRY(seek_block(block));
 
@@ -96,6 +135,7 @@ ErrorOr<ByteBuffer> Heap::read_block(u32 block)
     dbgln_if(SQL_DEBUG, "{:hex-dump}", bytes.trim(8));
     TRY(buffer.try_resize(bytes.size()));
 
+    TRY(cache_block(block, TRY(ByteBuffer::copy(buffer))));
     return buffer;
 }
 
@@ -169,19 +209,201 @@ u32 Heap::new_record_pointer()
 ErrorOr<void> Heap::flush()
 {
     VERIFY(m_file);
+    if (m_pending_blocks.is_empty())
+        return {};
+
     Vector<u32> blocks;
-    for (auto& wal_entry : m_write_ahead_log) {
-        blocks.append(wal_entry.key);
-    }
+    TRY(blocks.try_ensure_capacity(m_pending_blocks.size()));
+    for (auto& pending_block : m_pending_blocks)
+        blocks.unchecked_append(pending_block.key);
     quick_sort(blocks);
+
+    // Once this returns, the changes are durable, no matter what happens to the heap file from here on.
+    TRY(append_to_write_ahead_log(blocks));
+
     for (auto& block : blocks) {
-        auto buffer_it = m_write_ahead_log.find(block);
-        VERIFY(buffer_it != m_write_ahead_log.end());
+        auto buffer_it = m_pending_blocks.find(block);
+        VERIFY(buffer_it != m_pending_blocks.end());
         dbgln_if(SQL_DEBUG, "Flushing block {} to {}", block, name());
         TRY(write_block(block, buffer_it->value));
+        TRY(cache_block(block, move(buffer_it->value)));
     }
-    m_write_ahead_log.clear();
+    m_pending_blocks.clear();
     dbgln_if(SQL_DEBUG, "WAL flushed. Heap size = {}", size());
+
+    m_logged_block_count += blocks.size();
+    if (m_logged_block_count >= CHECKPOINT_INTERVAL)
+        TRY(checkpoint());
+    return {};
+}
+
+ErrorOr<void> Heap::cache_block(u32 block, ByteBuffer data)
+{
+    if (auto cached_block = m_cached_blocks.get(block); cached_block.has_value()) {
+        (*cached_block)->data = move(data);
+        m_lru_blocks.remove(**cached_block);
+        m_lru_blocks.prepend(**cached_block);
+        return {};
+    }
+
+    if (m_cached_blocks.size() >= BUFFER_POOL_SIZE) {
+        auto* evicted_block = m_lru_blocks.take_last();
+        m_cached_blocks.remove(evicted_block->block);
+    }
+
+    auto cached_block = TRY(adopt_nonnull_own_or_enomem(new (nothrow) CachedBlock(block, move(data))));
+    m_lru_blocks.prepend(*cached_block);
+    TRY(m_cached_blocks.try_set(block, move(cached_block)));
+    return {};
+}
+
+void Heap::clear_cache()
+{
+    m_lru_blocks.clear();
+    m_cached_blocks.clear();
+}
+
+// The write-ahead log is a sequence of records, each of which starts with a header of three u32s: the kind of record,
+// a value that depends on the kind, and a checksum of the record. A block record has the block number as its value,
+// and is followed by the contents of the block. A commit record comes after the block records of one flush, and has
+// the number of them as its value. Anything after the last valid commit record was never flushed completely.
+enum class LogRecordKind : u32 {
+    Block = 0x4b4c4253,  // "SBLK"
+    Commit = 0x544d4353, // "SCMT"
+};
+
+struct LogRecordHeader {
+    LogRecordKind kind;
+    u32 value;
+    u32 checksum;
+};
+
+static_assert(sizeof(LogRecordHeader) == 3 * sizeof(u32));
+
+static u32 log_record_checksum(LogRecordKind kind, u32 value, ReadonlyBytes data = {})
+{
+    auto checksum = string_hash(reinterpret_cast<char const*>(data.data()), data.size(), to_underlying(kind));
+    return string_hash(reinterpret_cast<char const*>(&value), sizeof(value), checksum);
+}
+
+ErrorOr<void> Heap::append_to_write_ahead_log(Vector<u32> const& blocks)
+{
+    if (!m_write_ahead_log)
+        m_write_ahead_log = TRY(Core::File::open(write_ahead_log_name(), Core::File::OpenMode::ReadWrite));
+
+    auto log = TRY(ByteBuffer::create_zeroed(blocks.size() * (sizeof(LogRecordHeader) + BLOCKSIZE) + sizeof(LogRecordHeader)));
+    size_t offset = 0;
+
+    auto append_record = [&](LogRecordKind kind, u32 value, ReadonlyBytes data) {
+        LogRecordHeader header { kind, value, log_record_checksum(kind, value, data) };
+        log.overwrite(offset, &header, sizeof(header));
+        offset += sizeof(header);
+        if (!data.is_empty()) {
+            log.overwrite(offset, data.data(), data.size());
+            offset += data.size();
+        }
+    };
+
+    for (auto block : blocks) {
+        auto const& buffer = m_pending_blocks.get(block).value();
+        if (buffer.size() > BLOCKSIZE) {
+            warnln("Heap({})::append_to_write_ahead_log({}): Oversized block ({} > {})"sv, name(), block, buffer.size(), BLOCKSIZE);
+            return Error::from_string_literal("Heap()::append_to_write_ahead_log(): Oversized block");
+        }
+
+        // The block is logged the way it will be written, padded with zeroes.
+        u8 padded_block[BLOCKSIZE] {};
+        memcpy(padded_block, buffer.data(), buffer.size());
+        append_record(LogRecordKind::Block, block, { padded_block, BLOCKSIZE });
+    }
+    append_record(LogRecordKind::Commit, blocks.size(), {});
+    VERIFY(offset == log.size());
+
+    TRY(m_write_ahead_log->seek(0, SeekMode::FromEndPosition));
+    TRY(m_write_ahead_log->write_entire_buffer(log));
+    TRY(Core::System::fsync(m_write_ahead_log->fd()));
+
+    dbgln_if(SQL_DEBUG, "Appended {} blocks to {}", blocks.size(), write_ahead_log_name());
+    return {};
+}
+
+ErrorOr<void> Heap::recover_from_write_ahead_log()
+{
+    m_write_ahead_log = nullptr;
+
+    if (auto result = Core::System::stat(write_ahead_log_name()); result.is_error()) {
+        if (result.error().code() == ENOENT)
+            return {};
+        return result.release_error();
+    }
+
+    m_write_ahead_log = TRY(Core::File::open(write_ahead_log_name(), Core::File::OpenMode::ReadWrite));
+    auto log = TRY(m_write_ahead_log->read_until_eof());
+    if (log.is_empty())
+        return {};
+
+    Vector<size_t> block_record_offsets;
+    size_t recovered_block_count = 0;
+
+    for (size_t offset = 0; offset + sizeof(LogRecordHeader) <= log.size();) {
+        LogRecordHeader header;
+        memcpy(&header, log.offset_pointer(offset), sizeof(header));
+
+        if (header.kind == LogRecordKind::Block) {
+            if (offset + sizeof(header) + BLOCKSIZE > log.size())
+                break;
+            auto data = log.bytes().slice(offset + sizeof(header), BLOCKSIZE);
+            if (header.checksum != log_record_checksum(header.kind, header.value, data))
+                break;
+
+            TRY(block_record_offsets.try_append(offset));
+            offset += sizeof(header) + BLOCKSIZE;
+            continue;
+        }
+
+        if (header.kind != LogRecordKind::Commit || header.value != block_record_offsets.size() || header.checksum != log_record_checksum(header.kind, header.value))
+            break;
+
+        for (auto block_record_offset : block_record_offsets) {
+            u32 block;
+            memcpy(&block, log.offset_pointer(block_record_offset + offsetof(LogRecordHeader, value)), sizeof(block));
+
+            // The blocks of each flush were written in order, and never past the end of the file, so writing them
+            // again in the same order can't go past the end either.
+            if (block > m_end_of_file) {
+                warnln("Heap({})::recover_from_write_ahead_log(): block {} is past the end of the file at block {}"sv, name(), block, m_end_of_file);
+                return Error::from_string_literal("Heap()::recover_from_write_ahead_log(): Write-ahead log doesn't match heap file");
+            }
+
+            auto buffer = TRY(ByteBuffer::copy(log.bytes().slice(block_record_offset + sizeof(header), BLOCKSIZE)));
+            m_next_block = max(m_next_block, block);
+            TRY(write_block(block, buffer));
+            m_next_block = max(m_next_block, block + 1);
+        }
+
+        recovered_block_count += block_record_offsets.size();
+        block_record_offsets.clear_with_capacity();
+        offset += sizeof(header);
+    }
+
+    dbgln_if(SQL_DEBUG, "Recovered {} blocks from {}", recovered_block_count, write_ahead_log_name());
+    m_logged_block_count = recovered_block_count;
+    return checkpoint();
+}
+
+ErrorOr<void> Heap::checkpoint()
+{
+    VERIFY(m_file);
+    VERIFY(m_write_ahead_log);
+
+    // The heap file has to be on disk before the log can be emptied, since the log is all there would be to recover
+    // the blocks from otherwise.
+    TRY(Core::System::fsync(m_file->fd()));
+    TRY(Core::System::ftruncate(m_write_ahead_log->fd(), 0));
+    TRY(Core::System::fsync(m_write_ahead_log->fd()));
+
+    dbgln_if(SQL_DEBUG, "Checkpoint of {}: {} blocks", name(), m_logged_block_count);
+    m_logged_block_count = 0;
     return {};
 }
 
@@ -192,6 +414,9 @@ constexpr static auto TABLES_ROOT_OFFSET = SCHEMAS_ROOT_OFFSET + sizeof(u32);
 constexpr static auto TABLE_COLUMNS_ROOT_OFFSET = TABLES_ROOT_OFFSET + sizeof(u32);
 constexpr static auto FREE_LIST_OFFSET = TABLE_COLUMNS_ROOT_OFFSET + sizeof(u32);
 constexpr static auto USER_VALUES_OFFSET = FREE_LIST_OFFSET + sizeof(u32);
+// This comes after the user values so that heaps written before there were indexes can still be read: they
+// simply have a zero there, which means there are no indexes yet.
+constexpr static auto TABLE_INDEXES_ROOT_OFFSET = USER_VALUES_OFFSET + 16 * sizeof(u32);
 
 ErrorOr<void> Heap::read_zero_block()
 {
@@ -217,6 +442,9 @@ ErrorOr<void> Heap::read_zero_block()
     memcpy(&m_table_columns_root, buffer.offset_pointer(TABLE_COLUMNS_ROOT_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Table columns root node: {}", m_table_columns_root);
 
+    memcpy(&m_table_indexes_root, buffer.offset_pointer(TABLE_INDEXES_ROOT_OFFSET), sizeof(u32));
+    dbgln_if(SQL_DEBUG, "Table indexes root node: {}", m_table_indexes_root);
+
     memcpy(&m_free_list, buffer.offset_pointer(FREE_LIST_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Free list: {}", m_free_list);
 
@@ -236,6 +464,7 @@ void Heap::update_zero_block()
     dbgln_if(SQL_DEBUG, "Schemas root node: {}", m_schemas_root);
     dbgln_if(SQL_DEBUG, "Tables root node: {}", m_tables_root);
     dbgln_if(SQL_DEBUG, "Table Columns root node: {}", m_table_columns_root);
+    dbgln_if(SQL_DEBUG, "Table Indexes root node: {}", m_table_indexes_root);
     dbgln_if(SQL_DEBUG, "Free list: {}", m_free_list);
     for (auto ix = 0u; ix < m_user_values.size(); ix++) {
         if (m_user_values[ix]) {
@@ -252,6 +481,7 @@ void Heap::update_zero_block()
     buffer.overwrite(TABLE_COLUMNS_ROOT_OFFSET, &m_table_columns_root, sizeof(u32));
     buffer.overwrite(FREE_LIST_OFFSET, &m_free_list, sizeof(u32));
     buffer.overwrite(USER_VALUES_OFFSET, m_user_values.data(), m_user_values.size() * sizeof(u32));
+    buffer.overwrite(TABLE_INDEXES_ROOT_OFFSET, &m_table_indexes_root, sizeof(u32));
 
     add_to_wal(0, buffer);
 }
@@ -262,6 +492,7 @@ void Heap::initialize_zero_block()
     m_schemas_root = 0;
     m_tables_root = 0;
     m_table_columns_root = 0;
+    m_table_indexes_root = 0;
     m_next_block = 1;
     m_free_list = 0;
     for (auto& user : m_user_values) {
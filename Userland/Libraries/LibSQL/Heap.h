@@ -10,6 +10,8 @@
 #include <AK/Debug.h>
 #include <AK/DeprecatedString.h>
 #include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
 #include <AK/Vector.h>
 #include <LibCore/File.h>
 #include <LibCore/Object.h>
@@ -18,6 +20,12 @@ namespace SQL {
 
 constexpr static u32 BLOCKSIZE = 1024;
 
+// How many blocks are kept in memory after they've been read or written.
+constexpr static size_t BUFFER_POOL_SIZE = 256;
+
+// How many blocks the write-ahead log may hold before they're synced to the heap file, after which the log is emptied.
+constexpr static size_t CHECKPOINT_INTERVAL = 1024;
+
 /**
  * A Heap is a logical container for database (SQL) data. Conceptually a
  * Heap can be a database file, or a memory block, or another storage medium.
@@ -28,12 +36,19 @@ constexpr static u32 BLOCKSIZE = 1024;
  * assumed that a single SQL database is backed by a single Heap.
  *
  * Currently only B-Trees and tuple stores are implemented.
+ *
+ * Changed blocks are kept in memory until they're flushed, which first
+ * appends them to a write-ahead log next to the heap file, and only then
+ * writes them to the heap file itself. The log is synced to disk once per
+ * flush, while the heap file only is when the log is emptied at a
+ * checkpoint. If the heap file is opened after a crash, everything in the
+ * log that was flushed completely is written to the heap file again.
  */
 class Heap : public Core::Object {
     C_OBJECT(Heap);
 
 public:
-    static constexpr inline u32 current_version = 3;
+    static constexpr inline u32 current_version = 4;
 
     virtual ~Heap() override;
 
@@ -66,6 +81,14 @@ public:
         m_table_columns_root = root;
         update_zero_block();
     }
+
+    u32 table_indexes_root() const { return m_table_indexes_root; }
+
+    void set_table_indexes_root(u32 root)
+    {
+        m_table_indexes_root = root;
+        update_zero_block();
+    }
     u32 version() const { return m_version; }
 
     u32 user_value(size_t index) const
@@ -85,12 +108,28 @@ public:
     {
         dbgln_if(SQL_DEBUG, "Adding to WAL: block #{}, size {}", block, buffer.size());
         dbgln_if(SQL_DEBUG, "{:hex-dump}", buffer.bytes().trim(8));
-        m_write_ahead_log.set(block, buffer);
+        m_pending_blocks.set(block, buffer);
     }
 
     ErrorOr<void> flush();
 
+    DeprecatedString write_ahead_log_name() const { return DeprecatedString::formatted("{}-wal", name()); }
+
 private:
+    // The contents of a block are handed out as copies, so nothing ever holds on to a cached block, which means any
+    // block can be evicted at any time.
+    struct CachedBlock {
+        CachedBlock(u32 block, ByteBuffer data)
+            : block(block)
+            , data(move(data))
+        {
+        }
+
+        u32 block { 0 };
+        ByteBuffer data;
+        IntrusiveListNode<CachedBlock> lru_node;
+    };
+
     explicit Heap(DeprecatedString);
 
     ErrorOr<void> write_block(u32, ByteBuffer&);
@@ -99,16 +138,34 @@ private:
     void initialize_zero_block();
     void update_zero_block();
 
-    OwnPtr<Core::BufferedFile> m_file;
+    ErrorOr<void> cache_block(u32, ByteBuffer);
+    void clear_cache();
+
+    ErrorOr<void> append_to_write_ahead_log(Vector<u32> const& blocks);
+    ErrorOr<void> recover_from_write_ahead_log();
+    ErrorOr<void> checkpoint();
+
+    OwnPtr<Core::File> m_file;
+    OwnPtr<Core::File> m_write_ahead_log;
+    // How many blocks were appended to the log since it was last emptied.
+    size_t m_logged_block_count { 0 };
+
     u32 m_free_list { 0 };
     u32 m_next_block { 1 };
     u32 m_end_of_file { 1 };
     u32 m_schemas_root { 0 };
     u32 m_tables_root { 0 };
     u32 m_table_columns_root { 0 };
+    u32 m_table_indexes_root { 0 };
     u32 m_version { current_version };
     Array<u32, 16> m_user_values { 0 };
-    HashMap<u32, ByteBuffer> m_write_ahead_log;
+
+    // The blocks that were changed since the last flush.
+    HashMap<u32, ByteBuffer> m_pending_blocks;
+
+    HashMap<u32, NonnullOwnPtr<CachedBlock>> m_cached_blocks;
+    // The cached blocks, the one that was used most recently first.
+    IntrusiveList<&CachedBlock::lru_node> m_lru_blocks;
 };
 
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Endian.h>
 #include <LibSQL/Key.h>
 #include <LibSQL/Meta.h>
 
@@ -31,4 +32,111 @@ Key::Key(RefPtr<IndexDef> index, Serializer& serializer)
     Tuple::deserialize(serializer);
 }
 
+Key::Key(Key const& other)
+    : Tuple(other)
+    , m_index(other.m_index)
+{
+}
+
+Key& Key::operator=(Key const& other)
+{
+    if (this != &other) {
+        Tuple::operator=(other);
+        m_index = other.m_index;
+        m_sort_key.clear();
+    }
+    return *this;
+}
+
+// Every value starts with a byte that puts NULLs before everything else, and ends where the next one starts, so a
+// key compares the same way as the longest key it's a prefix of, just like Tuple::compare() does.
+static ErrorOr<bool> encode_sort_key_element(ByteBuffer& buffer, Value const& value, SQLType type)
+{
+    if (value.is_null()) {
+        TRY(buffer.try_append(0));
+        return true;
+    }
+    // A Float that's a whole number becomes an Integer, so those are encoded as Floats in Float columns.
+    if (value.type() != type && !(type == SQLType::Float && value.type() == SQLType::Integer))
+        return false;
+
+    auto append_big_endian = [&](u64 bits) -> ErrorOr<void> {
+        BigEndian<u64> big_endian_bits { bits };
+        return buffer.try_append(&big_endian_bits, sizeof(big_endian_bits));
+    };
+
+    switch (type) {
+    case SQLType::Integer: {
+        // Values that don't fit in an i64 are compared differently, depending on which side they're on.
+        auto integer = value.to_int<i64>();
+        if (!integer.has_value())
+            return false;
+        TRY(buffer.try_append(1));
+        TRY(append_big_endian(static_cast<u64>(integer.value()) ^ (1ull << 63)));
+        return true;
+    }
+    case SQLType::Float: {
+        auto number = value.to_double();
+        if (!number.has_value())
+            return false;
+        // -0.0 compares as equal to 0.0, so it has to be encoded the same way.
+        auto bits = bit_cast<u64>(number.value() == 0.0 ? 0.0 : number.value());
+        // Flipping all bits of negative numbers and only the sign of the others puts them in numerical order.
+        bits = (bits & (1ull << 63)) ? ~bits : (bits | (1ull << 63));
+        TRY(buffer.try_append(1));
+        TRY(append_big_endian(bits));
+        return true;
+    }
+    case SQLType::Text: {
+        // The text ends with two zero bytes, and the zero bytes in it are followed by 0xff, so that a text that's a
+        // prefix of another one comes first.
+        TRY(buffer.try_append(1));
+        auto text = value.to_deprecated_string();
+        for (auto byte : text.bytes()) {
+            TRY(buffer.try_append(byte));
+            if (byte == 0)
+                TRY(buffer.try_append(0xff));
+        }
+        TRY(buffer.try_append(0));
+        TRY(buffer.try_append(0));
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+void Key::cache_sort_key()
+{
+    m_sort_key.clear();
+    if (size() > descriptor()->size())
+        return;
+
+    ByteBuffer buffer;
+    for (size_t ix = 0; ix < size(); ++ix) {
+        auto const& element = (*descriptor())[ix];
+        auto start = buffer.size();
+
+        auto result = encode_sort_key_element(buffer, (*this)[ix], element.type);
+        if (result.is_error() || !result.value())
+            return;
+
+        if (element.order == Order::Descending) {
+            for (auto offset = start; offset < buffer.size(); ++offset)
+                buffer[offset] = ~buffer[offset];
+        }
+    }
+    m_sort_key = move(buffer);
+}
+
+int Key::compare(Key const& other) const
+{
+    if (!m_sort_key.has_value() || !other.m_sort_key.has_value())
+        return Tuple::compare(other);
+
+    auto length = min(m_sort_key->size(), other.m_sort_key->size());
+    auto result = __builtin_memcmp(m_sort_key->data(), other.m_sort_key->data(), length);
+    return (result > 0) - (result < 0);
+}
+
 }
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
+#include <AK/Optional.h>
 #include <AK/RefPtr.h>
 #include <LibSQL/Forward.h>
 #include <LibSQL/Meta.h>
@@ -20,10 +22,26 @@ public:
     explicit Key(NonnullRefPtr<IndexDef>);
     Key(NonnullRefPtr<TupleDescriptor> const&, Serializer&);
     Key(RefPtr<IndexDef>, Serializer&);
+    Key(Key const&);
+    Key(Key&&) = default;
+    Key& operator=(Key const&);
+    Key& operator=(Key&&) = default;
     RefPtr<IndexDef> index() const { return m_index; }
 
+    // Encodes the values into bytes that compare with memcmp() the same way the key compares to other keys, so that
+    // going through a tree doesn't have to look at the values themselves. That's only possible if every value is NULL
+    // or has the type its descriptor says it has (or is an Integer where a Float is expected), and that type is an
+    // Integer, a Float or Text. The encoding isn't copied along with the key, since the values of the copy may change.
+    void cache_sort_key();
+    [[nodiscard]] bool has_sort_key() const { return m_sort_key.has_value(); }
+
+    // Two keys that both have an encoding are compared by it, which assumes that their descriptors have the same types.
+    using Tuple::compare;
+    [[nodiscard]] int compare(Key const&) const;
+
 private:
     RefPtr<IndexDef> m_index { nullptr };
+    Optional<ByteBuffer> m_sort_key;
 };
 
 }
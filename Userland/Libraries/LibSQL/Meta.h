@@ -80,7 +80,7 @@ public:
     Value const& default_value() const { return m_default; }
 
     static NonnullRefPtr<IndexDef> index_def();
-    static Key make_key(TableDef const&);
+    static Key make_key(Relation const&);
 
 protected:
     ColumnDef(Relation*, size_t, DeprecatedString, SQLType);
@@ -114,6 +114,7 @@ public:
     bool unique() const { return m_unique; }
     [[nodiscard]] size_t size() const { return m_key_definition.size(); }
     void append_column(DeprecatedString, SQLType, Order = Order::Ascending);
+    void append_column(Key const&);
     Key key() const override;
     [[nodiscard]] NonnullRefPtr<TupleDescriptor> to_tuple_descriptor() const;
     static NonnullRefPtr<IndexDef> index_def();
@@ -140,6 +141,7 @@ public:
     size_t num_indexes() { return m_indexes.size(); }
     NonnullRefPtrVector<ColumnDef> const& columns() const { return m_columns; }
     NonnullRefPtrVector<IndexDef> const& indexes() const { return m_indexes; }
+    void append_index(NonnullRefPtr<IndexDef> index) { m_indexes.append(move(index)); }
     [[nodiscard]] NonnullRefPtr<TupleDescriptor> to_tuple_descriptor() const;
 
     static NonnullRefPtr<IndexDef> index_def();
@@ -115,6 +115,7 @@ void TreeNode::deserialize(Serializer& serializer)
             else
                 m_is_leaf = (left == 0);
             m_entries.append(serializer.deserialize<Key>(m_tree.descriptor()));
+            m_entries.last().cache_sort_key();
             m_down.empend(this, left);
         }
         auto right = serializer.deserialize<u32>();
@@ -162,11 +163,12 @@ bool TreeNode::insert(Key const& key)
 bool TreeNode::update_key_pointer(Key const& key)
 {
     dbgln_if(SQL_DEBUG, "[#{}] UPDATE({}, {})", pointer(), key.to_deprecated_string(), key.pointer());
-    if (!is_leaf())
-        return node_for(key)->update_key_pointer(key);
 
+    // The median key moves up when a node is split, so the key we're looking for can be in a non-leaf node too.
     for (auto ix = 0u; ix < size(); ix++) {
-        if (key == m_entries[ix]) {
+        if (!is_leaf() && key.compare(m_entries[ix]) < 0)
+            return down_node(ix)->update_key_pointer(key);
+        if (key.compare(m_entries[ix]) == 0) {
             dbgln_if(SQL_DEBUG, "[#{}] {} == {}",
                 pointer(), key.to_deprecated_string(), m_entries[ix].to_deprecated_string());
             if (m_entries[ix].pointer() != key.pointer()) {
@@ -177,6 +179,8 @@ bool TreeNode::update_key_pointer(Key const& key)
             return true;
         }
     }
+    if (!is_leaf())
+        return down_node(size())->update_key_pointer(key);
     return false;
 }
 
@@ -185,7 +189,7 @@ bool TreeNode::insert_in_leaf(Key const& key)
     VERIFY(is_leaf());
     if (!m_tree.duplicates_allowed()) {
         for (auto& entry : m_entries) {
-            if (key == entry) {
+            if (key.compare(entry) == 0) {
                 dbgln_if(SQL_DEBUG, "[#{}] duplicate key {}", pointer(), key.to_deprecated_string());
                 return false;
             }
@@ -213,7 +217,7 @@ TreeNode* TreeNode::node_for(Key const& key)
     if (is_leaf())
         return this;
     for (size_t ix = 0; ix < size(); ix++) {
-        if (key < m_entries[ix]) {
+        if (key.compare(m_entries[ix]) < 0) {
             dbgln_if(SQL_DEBUG, "[{}] {} < {} v{}",
                 pointer(), (DeprecatedString)key, (DeprecatedString)m_entries[ix], m_down[ix].pointer());
             return down_node(ix)->node_for(key);
@@ -228,7 +232,7 @@ Optional<u32> TreeNode::get(Key& key)
 {
     dump_if(SQL_DEBUG, DeprecatedString::formatted("get({})", key.to_deprecated_string()));
     for (auto ix = 0u; ix < size(); ix++) {
-        if (key < m_entries[ix]) {
+        if (key.compare(m_entries[ix]) < 0) {
             if (is_leaf()) {
                 dbgln_if(SQL_DEBUG, "[#{}] {} < {} -> 0",
                     pointer(), key.to_deprecated_string(), (DeprecatedString)m_entries[ix]);
@@ -240,7 +244,7 @@ Optional<u32> TreeNode::get(Key& key)
                 return down_node(ix)->get(key);
             }
         }
-        if (key == m_entries[ix]) {
+        if (key.compare(m_entries[ix]) == 0) {
             dbgln_if(SQL_DEBUG, "[#{}] {} == {} -> {}",
                 pointer(), key.to_deprecated_string(), (DeprecatedString)m_entries[ix],
                 m_entries[ix].pointer());
@@ -269,8 +273,9 @@ void TreeNode::just_insert(Key const& key, TreeNode* right)
         pointer(), (DeprecatedString)key, (right) ? right->pointer() : 0);
     dump_if(SQL_DEBUG, "Before");
     for (auto ix = 0u; ix < size(); ix++) {
-        if (key < m_entries[ix]) {
+        if (key.compare(m_entries[ix]) < 0) {
             m_entries.insert(ix, key);
+            m_entries[ix].cache_sort_key();
             VERIFY(is_leaf() == (right == nullptr));
             m_down.insert(ix + 1, DownPointer(this, right));
             if (length() > BLOCKSIZE) {
@@ -283,6 +288,7 @@ void TreeNode::just_insert(Key const& key, TreeNode* right)
         }
     }
     m_entries.append(key);
+    m_entries.last().cache_sort_key();
     m_down.empend(this, right);
 
     if (length() > BLOCKSIZE) {
@@ -318,7 +324,7 @@ void TreeNode::split()
         if (down.m_node != nullptr) {
             down.m_node->m_up = new_node;
         }
-        new_node->m_entries.append(entry);
+        new_node->m_entries.append(move(entry));
         new_node->m_down.append(move(down));
     }
 
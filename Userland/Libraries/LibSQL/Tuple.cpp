@@ -43,24 +43,47 @@ void Tuple::deserialize(Serializer& serializer)
     serializer.deserialize_to<u32>(m_pointer);
     dbgln_if(SQL_DEBUG, "pointer: {}", m_pointer);
     auto sz = serializer.deserialize<u32>();
+
+    Vector<u8, 8> null_bitmap;
+    null_bitmap.resize(null_bitmap_size(sz));
+    for (auto& byte : null_bitmap)
+        byte = serializer.deserialize<u8>();
+
     m_data.clear();
-    m_descriptor->clear();
+    m_data.ensure_capacity(sz);
     for (auto ix = 0u; ix < sz; ++ix) {
-        m_descriptor->append(serializer.deserialize<TupleElementDescriptor>());
-        m_data.append(serializer.deserialize<Value>());
+        auto type = (ix < m_descriptor->size()) ? (*m_descriptor)[ix].type : SQLType::Null;
+        if (null_bitmap[ix / 8] & (1 << (ix % 8)))
+            m_data.unchecked_append(Value { type });
+        else
+            m_data.unchecked_append(serializer.deserialize<Value>());
+
+        if (ix >= m_descriptor->size())
+            m_descriptor->append(m_data.last().descriptor());
     }
 }
 
+// The descriptor isn't stored along with the values, since whoever reads them back already knows what they are. The
+// values are preceded by a bitmap with a bit set for each one that's NULL, and the NULLs themselves are left out.
 void Tuple::serialize(Serializer& serializer) const
 {
     VERIFY(m_descriptor->size() == m_data.size());
     dbgln_if(SQL_DEBUG, "Serializing tuple pointer {}", pointer());
     serializer.serialize<u32>(pointer());
-    serializer.serialize<u32>((u32)m_descriptor->size());
-    for (auto ix = 0u; ix < m_descriptor->size(); ix++) {
-        auto& key_part = m_data[ix];
-        serializer.serialize<TupleElementDescriptor>((*m_descriptor)[ix]);
-        serializer.serialize<Value>(key_part);
+    serializer.serialize<u32>((u32)m_data.size());
+
+    for (size_t byte_index = 0; byte_index < null_bitmap_size(m_data.size()); ++byte_index) {
+        u8 byte = 0;
+        for (size_t bit = 0; bit < 8 && byte_index * 8 + bit < m_data.size(); ++bit) {
+            if (m_data[byte_index * 8 + bit].is_null())
+                byte |= 1 << bit;
+        }
+        serializer.serialize<u8>(byte);
+    }
+
+    for (auto const& value : m_data) {
+        if (!value.is_null())
+            serializer.serialize<Value>(value);
     }
 }
 
@@ -151,12 +174,10 @@ bool Tuple::is_compatible(Tuple const& other) const
 
 size_t Tuple::length() const
 {
-    size_t len = 2 * sizeof(u32);
-    for (auto ix = 0u; ix < m_descriptor->size(); ix++) {
-        auto& descriptor = (*m_descriptor)[ix];
-        auto& value = m_data[ix];
-        len += descriptor.length();
-        len += value.length();
+    size_t len = 2 * sizeof(u32) + null_bitmap_size(m_data.size());
+    for (auto const& value : m_data) {
+        if (!value.is_null())
+            len += sizeof(u8) + value.length();
     }
     return len;
 }
@@ -196,6 +217,9 @@ int Tuple::compare(Tuple const& other) const
     auto num_values = min(m_data.size(), other.m_data.size());
     VERIFY(num_values > 0);
     for (auto ix = 0u; ix < num_values; ix++) {
+        // A NULL compares as less than anything, even another NULL, but tuples are used as keys, which need an order.
+        if (m_data[ix].is_null() && other.m_data[ix].is_null())
+            continue;
         auto ret = m_data[ix].compare(other.m_data[ix]);
         if (ret != 0) {
             if ((ix < m_descriptor->size()) && (*m_descriptor)[ix].order == Order::Descending)
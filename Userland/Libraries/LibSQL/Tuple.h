@@ -72,6 +72,7 @@ public:
 protected:
     [[nodiscard]] Optional<size_t> index_of(StringView) const;
     void copy_from(Tuple const&);
+    static constexpr size_t null_bitmap_size(size_t value_count) { return (value_count + 7) / 8; }
     virtual void serialize(Serializer&) const;
     virtual void deserialize(Serializer&);
 
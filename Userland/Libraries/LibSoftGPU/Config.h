@@ -24,6 +24,13 @@ static constexpr int MAX_TEXTURE_SIZE = 2048;
 static constexpr float MAX_TEXTURE_LOD_BIAS = 2.f;
 static constexpr int SUBPIXEL_BITS = 4;
 
+// Triangles are sorted into square tiles of the framebuffer, which are rasterized in parallel.
+// The size has to be even so that no pixel quad is split between two tiles.
+static constexpr int RASTERIZER_TILE_SIZE = 64;
+static_assert(RASTERIZER_TILE_SIZE % 2 == 0);
+// Below this many covered pixels, a draw is rasterized on the calling thread, since handing it out costs more.
+static constexpr int MIN_PARALLEL_RASTERIZATION_AREA = 4 * RASTERIZER_TILE_SIZE * RASTERIZER_TILE_SIZE;
+
 static constexpr int NUM_SHADER_INPUTS = 64;
 
 // Verify that we have enough inputs to hold vertex color and texture coordinates for all fixed function texture units
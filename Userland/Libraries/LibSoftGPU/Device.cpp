@@ -7,6 +7,7 @@
  */
 
 #include <AK/AnyOf.h>
+#include <AK/Atomic.h>
 #include <AK/Error.h>
 #include <AK/Math.h>
 #include <AK/NumericLimits.h>
@@ -25,17 +26,19 @@
 #include <LibSoftGPU/SIMD.h>
 #include <LibSoftGPU/Shader.h>
 #include <LibSoftGPU/ShaderCompiler.h>
+#include <LibThreading/ThreadPool.h>
 #include <math.h>
 
 namespace SoftGPU {
 
-static i64 g_num_rasterized_triangles;
-static i64 g_num_pixels;
-static i64 g_num_pixels_shaded;
-static i64 g_num_pixels_blended;
-static i64 g_num_sampler_calls;
-static i64 g_num_stencil_writes;
-static i64 g_num_quads;
+// Tiles are rasterized on several threads at once, so all of them count into the same atomics.
+static Atomic<i64, AK::MemoryOrder::memory_order_relaxed> g_num_rasterized_triangles;
+static Atomic<i64, AK::MemoryOrder::memory_order_relaxed> g_num_pixels;
+static Atomic<i64, AK::MemoryOrder::memory_order_relaxed> g_num_pixels_shaded;
+static Atomic<i64, AK::MemoryOrder::memory_order_relaxed> g_num_pixels_blended;
+static Atomic<i64, AK::MemoryOrder::memory_order_relaxed> g_num_sampler_calls;
+static Atomic<i64, AK::MemoryOrder::memory_order_relaxed> g_num_stencil_writes;
+static Atomic<i64, AK::MemoryOrder::memory_order_relaxed> g_num_quads;
 
 using AK::abs;
 using AK::SIMD::any;
@@ -173,11 +176,58 @@ ALWAYS_INLINE static Vector4<f32x4> get_blend_factor(GPU::BlendFactor blend_fact
     }
 }
 
-template<typename CB1, typename CB2, typename CB3>
-ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, CB1 set_coverage_mask, CB2 set_quad_depth, CB3 set_quad_attributes)
+// Which of the per-fragment operations are done is decided by a pipeline state. This one checks the rasterizer
+// options for every quad, which is fine for lines and points.
+struct DynamicPipelineState {
+    GPU::RasterizerOptions const& options;
+
+    bool stencil_test() const { return options.enable_stencil_test; }
+    bool depth_test() const { return options.enable_depth_test; }
+    bool alpha_test() const { return options.enable_alpha_test; }
+    bool blending() const { return options.enable_blending; }
+};
+
+// This one has the operations built in, so that the rasterizer is compiled without the branches for those that are
+// turned off. Triangles use one of these, as chosen by with_static_pipeline_state() below.
+template<bool StencilTest, bool DepthTest, bool AlphaTest, bool Blending>
+struct StaticPipelineState {
+    static constexpr bool stencil_test() { return StencilTest; }
+    static constexpr bool depth_test() { return DepthTest; }
+    static constexpr bool alpha_test() { return AlphaTest; }
+    static constexpr bool blending() { return Blending; }
+};
+
+template<bool... Flags, typename Callback, typename... Rest>
+ALWAYS_INLINE static void with_constant_flags(Callback&& callback, bool flag, Rest... rest)
+{
+    if constexpr (sizeof...(Rest) == 0) {
+        if (flag)
+            callback.template operator()<Flags..., true>();
+        else
+            callback.template operator()<Flags..., false>();
+    } else {
+        if (flag)
+            with_constant_flags<Flags..., true>(callback, rest...);
+        else
+            with_constant_flags<Flags..., false>(callback, rest...);
+    }
+}
+
+template<typename Callback>
+ALWAYS_INLINE static void with_static_pipeline_state(GPU::RasterizerOptions const& options, Callback&& callback)
+{
+    with_constant_flags(
+        [&]<bool StencilTest, bool DepthTest, bool AlphaTest, bool Blending>() {
+            callback(StaticPipelineState<StencilTest, DepthTest, AlphaTest, Blending> {});
+        },
+        options.enable_stencil_test, options.enable_depth_test, options.enable_alpha_test, options.enable_blending);
+}
+
+template<typename PipelineState, typename CB1, typename CB2, typename CB3>
+ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, ShaderProcessor& shader_processor, PipelineState pipeline_state, CB1 set_coverage_mask, CB2 set_quad_depth, CB3 set_quad_attributes)
 {
     // Return if alpha testing is a no-op
-    if (m_options.enable_alpha_test && m_options.alpha_test_func == GPU::AlphaTestFunction::Never)
+    if (pipeline_state.alpha_test() && m_options.alpha_test_func == GPU::AlphaTestFunction::Never)
         return;
     auto const alpha_test_ref_value = expand4(m_options.alpha_test_ref_value);
 
@@ -244,7 +294,7 @@ ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, CB1 set_covera
     Vector4<f32x4> dst_factor;
     auto const src_factor_is_constant = is_blend_factor_constant(m_options.blend_source_factor);
     auto const dst_factor_is_constant = is_blend_factor_constant(m_options.blend_destination_factor);
-    if (m_options.enable_blending) {
+    if (pipeline_state.blending()) {
         if (src_factor_is_constant)
             src_factor = get_blend_factor(m_options.blend_source_factor, {}, {});
         if (dst_factor_is_constant)
@@ -252,7 +302,6 @@ ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, CB1 set_covera
     }
 
     // Rasterize all quads
-    // FIXME: this could be embarrassingly parallel
     for (int qy = qy0; qy <= qy1; qy += 2) {
         for (int qx = qx0; qx <= qx1; qx += 2) {
             PixelQuad quad;
@@ -277,7 +326,7 @@ ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, CB1 set_covera
             // Stencil testing
             GPU::StencilType* stencil_ptrs[4];
             i32x4 stencil_value;
-            if (m_options.enable_stencil_test) {
+            if (pipeline_state.stencil_test()) {
                 stencil_ptrs[0] = coverage_bits & 1 ? &stencil_buffer->scanline(qy)[qx] : nullptr;
                 stencil_ptrs[1] = coverage_bits & 2 ? &stencil_buffer->scanline(qy)[qx + 1] : nullptr;
                 stencil_ptrs[2] = coverage_bits & 4 ? &stencil_buffer->scanline(qy + 1)[qx] : nullptr;
@@ -339,7 +388,7 @@ ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, CB1 set_covera
                 coverage_bits & 4 ? &depth_buffer->scanline(qy + 1)[qx] : nullptr,
                 coverage_bits & 8 ? &depth_buffer->scanline(qy + 1)[qx + 1] : nullptr,
             };
-            if (m_options.enable_depth_test) {
+            if (pipeline_state.depth_test()) {
                 set_quad_depth(quad);
 
                 auto depth = load4_masked(depth_ptrs[0], depth_ptrs[1], depth_ptrs[2], depth_ptrs[3], quad.mask);
@@ -374,7 +423,7 @@ ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, CB1 set_covera
                 }
 
                 // Update stencil buffer for pixels that failed the depth test
-                if (m_options.enable_stencil_test) {
+                if (pipeline_state.stencil_test()) {
                     write_to_stencil(
                         stencil_ptrs,
                         stencil_value,
@@ -392,7 +441,7 @@ ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, CB1 set_covera
             }
 
             // Update stencil buffer for passed pixels
-            if (m_options.enable_stencil_test) {
+            if (pipeline_state.stencil_test()) {
                 write_to_stencil(
                     stencil_ptrs,
                     stencil_value,
@@ -405,10 +454,10 @@ ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, CB1 set_covera
             INCREASE_STATISTICS_COUNTER(g_num_pixels_shaded, maskcount(quad.mask));
 
             set_quad_attributes(quad);
-            shade_fragments(quad);
+            shade_fragments(quad, shader_processor);
 
             // Alpha testing
-            if (m_options.enable_alpha_test) {
+            if (pipeline_state.alpha_test()) {
                 test_alpha(quad, m_options.alpha_test_func, alpha_test_ref_value);
                 coverage_bits = maskbits(quad.mask);
                 if (coverage_bits == 0)
@@ -416,7 +465,7 @@ ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, CB1 set_covera
             }
 
             // Write to depth buffer
-            if (m_options.enable_depth_test && m_options.enable_depth_write)
+            if (pipeline_state.depth_test() && m_options.enable_depth_write)
                 store4_masked(quad.depth, depth_ptrs[0], depth_ptrs[1], depth_ptrs[2], depth_ptrs[3], quad.mask);
 
             // We will not update the color buffer at all
@@ -431,12 +480,12 @@ ALWAYS_INLINE void Device::rasterize(Gfx::IntRect& render_bounds, CB1 set_covera
             };
 
             u32x4 dst_u32;
-            if (m_options.enable_blending || m_options.color_mask != 0xffffffff)
+            if (pipeline_state.blending() || m_options.color_mask != 0xffffffff)
                 dst_u32 = load4_masked(color_ptrs[0], color_ptrs[1], color_ptrs[2], color_ptrs[3], quad.mask);
 
             auto out_color = quad.get_output_vector4(SHADER_OUTPUT_FIRST_COLOR);
 
-            if (m_options.enable_blending) {
+            if (pipeline_state.blending()) {
                 INCREASE_STATISTICS_COUNTER(g_num_pixels_blended, maskcount(quad.mask));
 
                 // Blend color values from pixel_staging into color_buffer
@@ -497,6 +546,8 @@ void Device::rasterize_line_antialiased(GPU::Vertex& from, GPU::Vertex& to)
     f32x4 distance_along_line;
     rasterize(
         render_bounds,
+        m_shader_processor,
+        DynamicPipelineState { m_options },
         [&from_coords4, &distance_along_line, &line_vector4, &line_dot4, &line_radius](auto& quad) {
             auto const screen_coordinates4 = to_vec2_f32x4(quad.screen_coordinates);
             auto const pixel_vector = screen_coordinates4 - from_coords4;
@@ -553,6 +604,8 @@ void Device::rasterize_point_aliased(GPU::Vertex& point)
     // Rasterize the point as a rect
     rasterize(
         point_rect,
+        m_shader_processor,
+        DynamicPipelineState { m_options },
         [](auto& quad) {
             // We already passed in point_rect, so this doesn't matter
             quad.mask = expand4(~0);
@@ -585,6 +638,8 @@ void Device::rasterize_point_antialiased(GPU::Vertex& point)
     // Rasterize using a 2D signed distance field for a circle
     rasterize(
         render_bounds,
+        m_shader_processor,
+        DynamicPipelineState { m_options },
         [&center4, &radius](auto& quad) {
             auto screen_coords = to_vec2_f32x4(quad.screen_coordinates);
             auto distance_to_point = length(center4 - screen_coords) - radius;
@@ -613,35 +668,49 @@ void Device::rasterize_point(GPU::Vertex& point)
         rasterize_point_aliased(point);
 }
 
-void Device::rasterize_triangle(Triangle& triangle)
+bool Device::set_up_triangle(Triangle& triangle)
 {
-    INCREASE_STATISTICS_COUNTER(g_num_rasterized_triangles, 1);
-
     auto v0 = (triangle.vertices[0].window_coordinates.xy() * subpixel_factor).to_rounded<int>();
     auto v1 = (triangle.vertices[1].window_coordinates.xy() * subpixel_factor).to_rounded<int>();
     auto v2 = (triangle.vertices[2].window_coordinates.xy() * subpixel_factor).to_rounded<int>();
 
     auto triangle_area = edge_function(v0, v1, v2);
     if (triangle_area == 0)
-        return;
+        return false;
 
     // Perform face culling
     if (m_options.enable_culling) {
         bool is_front = (m_options.front_face == GPU::WindingOrder::CounterClockwise ? triangle_area > 0 : triangle_area < 0);
 
         if (!is_front && m_options.cull_back)
-            return;
+            return false;
 
         if (is_front && m_options.cull_front)
-            return;
+            return false;
     }
 
     // Force counter-clockwise ordering of vertices
-    if (triangle_area < 0) {
+    if (triangle_area < 0)
         swap(triangle.vertices[0], triangle.vertices[1]);
-        swap(v0, v1);
-        triangle_area *= -1;
-    }
+
+    // Calculate render bounds based on the triangle's vertices
+    triangle.render_bounds = {};
+    triangle.render_bounds.set_left(min(min(v0.x(), v1.x()), v2.x()) / subpixel_factor);
+    triangle.render_bounds.set_right(max(max(v0.x(), v1.x()), v2.x()) / subpixel_factor);
+    triangle.render_bounds.set_top(min(min(v0.y(), v1.y()), v2.y()) / subpixel_factor);
+    triangle.render_bounds.set_bottom(max(max(v0.y(), v1.y()), v2.y()) / subpixel_factor);
+
+    INCREASE_STATISTICS_COUNTER(g_num_rasterized_triangles, 1);
+    return true;
+}
+
+void Device::rasterize_triangle(Triangle const& triangle, Gfx::IntRect const& tile_rect, ShaderProcessor& shader_processor)
+{
+    auto v0 = (triangle.vertices[0].window_coordinates.xy() * subpixel_factor).to_rounded<int>();
+    auto v1 = (triangle.vertices[1].window_coordinates.xy() * subpixel_factor).to_rounded<int>();
+    auto v2 = (triangle.vertices[2].window_coordinates.xy() * subpixel_factor).to_rounded<int>();
+    auto triangle_area = edge_function(v0, v1, v2);
+    VERIFY(triangle_area > 0);
 
     auto const& vertex0 = triangle.vertices[0];
     auto const& vertex1 = triangle.vertices[1];
@@ -675,12 +744,7 @@ void Device::rasterize_triangle(Triangle& triangle)
             && edges.z() >= zero.z();
     };
 
-    // Calculate render bounds based on the triangle's vertices
-    Gfx::IntRect render_bounds;
-    render_bounds.set_left(min(min(v0.x(), v1.x()), v2.x()) / subpixel_factor);
-    render_bounds.set_right(max(max(v0.x(), v1.x()), v2.x()) / subpixel_factor);
-    render_bounds.set_top(min(min(v0.y(), v1.y()), v2.y()) / subpixel_factor);
-    render_bounds.set_bottom(max(max(v0.y(), v1.y()), v2.y()) / subpixel_factor);
+    auto const& render_bounds = triangle.render_bounds;
 
     // Calculate depth of fragment for fog;
     // OpenGL 1.5 chapter 3.10: "An implementation may choose to approximate the
@@ -723,41 +787,48 @@ void Device::rasterize_triangle(Triangle& triangle)
         expand4(vertex2.window_coordinates.z() + depth_offset),
     };
 
-    rasterize(
-        render_bounds,
-        [&](auto& quad) {
-            auto edge_values = calculate_edge_values4(quad.screen_coordinates * subpixel_factor + half_pixel_offset);
-            quad.mask = test_point4(edge_values);
-
-            quad.barycentrics = {
-                to_f32x4(edge_values.x()),
-                to_f32x4(edge_values.y()),
-                to_f32x4(edge_values.z()),
-            };
-        },
-        [&](auto& quad) {
-            // Determine each edge's ratio to the total area
-            quad.barycentrics = quad.barycentrics * one_over_area;
+    // The depth offset above depends on the whole triangle, but only the part of it within the tile is drawn.
+    auto tile_bounds = render_bounds.intersected(tile_rect);
+    if (tile_bounds.is_empty())
+        return;
 
-            // Because the Z coordinates were divided by W, we can interpolate between them
-            quad.depth = AK::SIMD::clamp(window_z_coordinates.dot(quad.barycentrics), 0.f, 1.f);
-        },
-        [&](auto& quad) {
-            auto const interpolated_reciprocal_w = window_w_coordinates.dot(quad.barycentrics);
-            quad.barycentrics = quad.barycentrics * window_w_coordinates / interpolated_reciprocal_w;
+    auto set_coverage_mask = [&](auto& quad) {
+        auto edge_values = calculate_edge_values4(quad.screen_coordinates * subpixel_factor + half_pixel_offset);
+        quad.mask = test_point4(edge_values);
 
-            // FIXME: make this more generic. We want to interpolate more than just color and uv
-            if (m_options.shade_smooth)
-                quad.set_input(SHADER_INPUT_VERTEX_COLOR, interpolate(expand4(vertex0.color), expand4(vertex1.color), expand4(vertex2.color), quad.barycentrics));
-            else
-                quad.set_input(SHADER_INPUT_VERTEX_COLOR, expand4(vertex0.color));
+        quad.barycentrics = {
+            to_f32x4(edge_values.x()),
+            to_f32x4(edge_values.y()),
+            to_f32x4(edge_values.z()),
+        };
+    };
+    auto set_quad_depth = [&](auto& quad) {
+        // Determine each edge's ratio to the total area
+        quad.barycentrics = quad.barycentrics * one_over_area;
 
-            for (GPU::TextureUnitIndex i = 0; i < GPU::NUM_TEXTURE_UNITS; ++i)
-                quad.set_input(SHADER_INPUT_FIRST_TEXCOORD + i * 4, interpolate(expand4(vertex0.tex_coords[i]), expand4(vertex1.tex_coords[i]), expand4(vertex2.tex_coords[i]), quad.barycentrics));
+        // Because the Z coordinates were divided by W, we can interpolate between them
+        quad.depth = AK::SIMD::clamp(window_z_coordinates.dot(quad.barycentrics), 0.f, 1.f);
+    };
+    auto set_quad_attributes = [&](auto& quad) {
+        auto const interpolated_reciprocal_w = window_w_coordinates.dot(quad.barycentrics);
+        quad.barycentrics = quad.barycentrics * window_w_coordinates / interpolated_reciprocal_w;
 
-            if (m_options.fog_enabled)
-                quad.fog_depth = fog_depth.dot(quad.barycentrics);
-        });
+        // FIXME: make this more generic. We want to interpolate more than just color and uv
+        if (m_options.shade_smooth)
+            quad.set_input(SHADER_INPUT_VERTEX_COLOR, interpolate(expand4(vertex0.color), expand4(vertex1.color), expand4(vertex2.color), quad.barycentrics));
+        else
+            quad.set_input(SHADER_INPUT_VERTEX_COLOR, expand4(vertex0.color));
+
+        for (GPU::TextureUnitIndex i = 0; i < GPU::NUM_TEXTURE_UNITS; ++i)
+            quad.set_input(SHADER_INPUT_FIRST_TEXCOORD + i * 4, interpolate(expand4(vertex0.tex_coords[i]), expand4(vertex1.tex_coords[i]), expand4(vertex2.tex_coords[i]), quad.barycentrics));
+
+        if (m_options.fog_enabled)
+            quad.fog_depth = fog_depth.dot(quad.barycentrics);
+    };
+
+    with_static_pipeline_state(m_options, [&](auto pipeline_state) {
+        rasterize(tile_bounds, shader_processor, pipeline_state, set_coverage_mask, set_quad_depth, set_quad_attributes);
+    });
 }
 
 Device::Device(Gfx::IntSize size)
@@ -1139,14 +1210,67 @@ void Device::draw_primitives(GPU::PrimitiveType primitive_type, FloatMatrix4x4 c
         }
     }
 
-    for (auto& triangle : m_processed_triangles)
-        rasterize_triangle(triangle);
+    rasterize_triangles(m_processed_triangles);
+}
+
+void Device::rasterize_triangles(Vector<Triangle>& triangles)
+{
+    size_t triangle_count = 0;
+    size_t covered_area = 0;
+    for (auto& triangle : triangles) {
+        if (!set_up_triangle(triangle))
+            continue;
+        covered_area += triangle.render_bounds.intersected(m_frame_buffer->rect()).size().area();
+        triangles[triangle_count++] = triangle;
+    }
+    triangles.shrink(triangle_count);
+
+    if (covered_area < MIN_PARALLEL_RASTERIZATION_AREA || Threading::ThreadPool::the().worker_count() == 1) {
+        for (auto const& triangle : triangles)
+            rasterize_triangle(triangle, m_frame_buffer->rect(), m_shader_processor);
+        return;
+    }
+
+    // Every tile draws its triangles in order, and no two tiles share a pixel, so the result is the same as drawing
+    // the triangles one after another.
+    auto tile_columns = ceil_div(m_frame_buffer->rect().width(), RASTERIZER_TILE_SIZE);
+    auto tile_rows = ceil_div(m_frame_buffer->rect().height(), RASTERIZER_TILE_SIZE);
+    m_tile_bins.resize(tile_columns * tile_rows);
+    for (auto& bin : m_tile_bins)
+        bin.clear_with_capacity();
+
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        auto bounds = triangles[i].render_bounds.intersected(m_frame_buffer->rect());
+        if (bounds.is_empty())
+            continue;
+        for (int row = bounds.top() / RASTERIZER_TILE_SIZE; row <= bounds.bottom() / RASTERIZER_TILE_SIZE; ++row) {
+            for (int column = bounds.left() / RASTERIZER_TILE_SIZE; column <= bounds.right() / RASTERIZER_TILE_SIZE; ++column)
+                m_tile_bins[row * tile_columns + column].append(i);
+        }
+    }
+
+    Threading::parallel_for(m_tile_bins.size(), [&](size_t tile) {
+        auto const& bin = m_tile_bins[tile];
+        if (bin.is_empty())
+            return;
+
+        // The shader processor keeps the values of its registers while it runs, so every tile needs its own.
+        ShaderProcessor shader_processor { m_samplers };
+        Gfx::IntRect tile_rect {
+            static_cast<int>(tile % tile_columns) * RASTERIZER_TILE_SIZE,
+            static_cast<int>(tile / tile_columns) * RASTERIZER_TILE_SIZE,
+            RASTERIZER_TILE_SIZE,
+            RASTERIZER_TILE_SIZE,
+        };
+        for (auto index : bin)
+            rasterize_triangle(triangles[index], tile_rect, shader_processor);
+    });
 }
 
-ALWAYS_INLINE void Device::shade_fragments(PixelQuad& quad)
+ALWAYS_INLINE void Device::shade_fragments(PixelQuad& quad, ShaderProcessor& shader_processor)
 {
     if (m_current_fragment_shader) {
-        m_shader_processor.execute(quad, *m_current_fragment_shader);
+        shader_processor.execute(quad, *m_current_fragment_shader);
         return;
     }
 
@@ -1519,15 +1643,15 @@ void Device::draw_statistics_overlay(Gfx::Bitmap& target)
         builder.appendff("Timings      : {:.1}ms {:.1}FPS\n",
             static_cast<double>(milliseconds) / frame_counter,
             (milliseconds > 0) ? 1000.0 * frame_counter / milliseconds : 9999.0);
-        builder.appendff("Triangles    : {}\n", g_num_rasterized_triangles);
+        builder.appendff("Triangles    : {}\n", g_num_rasterized_triangles.load());
         builder.appendff("SIMD usage   : {}%\n", g_num_quads > 0 ? g_num_pixels_shaded * 25 / g_num_quads : 0);
         builder.appendff("Pixels       : {}, Stencil: {}%, Shaded: {}%, Blended: {}%, Overdraw: {}%\n",
-            g_num_pixels,
+            g_num_pixels.load(),
             g_num_pixels > 0 ? g_num_stencil_writes * 100 / g_num_pixels : 0,
             g_num_pixels > 0 ? g_num_pixels_shaded * 100 / g_num_pixels : 0,
             g_num_pixels_shaded > 0 ? g_num_pixels_blended * 100 / g_num_pixels_shaded : 0,
             num_rendertarget_pixels > 0 ? g_num_pixels_shaded * 100 / num_rendertarget_pixels - 100 : 0);
-        builder.appendff("Sampler calls: {}\n", g_num_sampler_calls);
+        builder.appendff("Sampler calls: {}\n", g_num_sampler_calls.load());
 
         debug_string = builder.to_string().release_value_but_fixme_should_propagate_errors();
 
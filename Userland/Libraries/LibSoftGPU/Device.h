@@ -89,8 +89,8 @@ private:
     GPU::ImageDataLayout color_buffer_data_layout(Vector2<u32> size, Vector2<i32> offset);
     GPU::ImageDataLayout depth_buffer_data_layout(Vector2<u32> size, Vector2<i32> offset);
 
-    template<typename CB1, typename CB2, typename CB3>
-    void rasterize(Gfx::IntRect& render_bounds, CB1 set_coverage_mask, CB2 set_quad_depth, CB3 set_quad_attributes);
+    template<typename PipelineState, typename CB1, typename CB2, typename CB3>
+    void rasterize(Gfx::IntRect& render_bounds, ShaderProcessor&, PipelineState, CB1 set_coverage_mask, CB2 set_quad_depth, CB3 set_quad_attributes);
 
     void rasterize_line_aliased(GPU::Vertex&, GPU::Vertex&);
     void rasterize_line_antialiased(GPU::Vertex&, GPU::Vertex&);
@@ -100,8 +100,11 @@ private:
     void rasterize_point_antialiased(GPU::Vertex&);
     void rasterize_point(GPU::Vertex&);
 
-    void rasterize_triangle(Triangle&);
-    void shade_fragments(PixelQuad&);
+    // Culls the triangle, or orders its vertices counter-clockwise and finds its bounds. Returns whether it's drawn.
+    bool set_up_triangle(Triangle&);
+    void rasterize_triangle(Triangle const&, Gfx::IntRect const& tile_rect, ShaderProcessor&);
+    void rasterize_triangles(Vector<Triangle>&);
+    void shade_fragments(PixelQuad&, ShaderProcessor&);
 
     RefPtr<FrameBuffer<GPU::ColorType, GPU::DepthType, GPU::StencilType>> m_frame_buffer {};
     GPU::RasterizerOptions m_options;
@@ -109,6 +112,8 @@ private:
     Clipper m_clipper;
     Vector<Triangle> m_triangle_list;
     Vector<Triangle> m_processed_triangles;
+    // The indices of the triangles that touch each tile, in the order they were drawn in.
+    Vector<Vector<u32>> m_tile_bins;
     Vector<GPU::Vertex> m_clipped_vertices;
     Array<Sampler, GPU::NUM_TEXTURE_UNITS> m_samplers;
     bool m_samplers_need_texture_staging { false };
@@ -5,9 +5,6 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <LibGfx/Bitmap.h>
-#include <LibGfx/Painter.h>
-#include <LibGfx/Size.h>
 #include <LibSoftGPU/Image.h>
 #include <LibSoftGPU/PixelConverter.h>
 
@@ -121,79 +118,36 @@ void Image::copy_texels(GPU::Image const& source, u32 source_level, Vector3<u32>
     }
 }
 
-static GPU::ImageDataLayout image_data_layout_for_bitmap(Gfx::Bitmap& bitmap)
-{
-    VERIFY(bitmap.format() == Gfx::BitmapFormat::BGRA8888);
-    return GPU::ImageDataLayout {
-        .pixel_type = {
-            .format = GPU::PixelFormat::BGRA,
-            .bits = GPU::PixelComponentBits::B8_8_8_8,
-            .data_type = GPU::PixelDataType::UnsignedInt,
-            .components_order = GPU::ComponentsOrder::Reversed,
-        },
-        .dimensions = {
-            .width = static_cast<u32>(bitmap.width()),
-            .height = static_cast<u32>(bitmap.height()),
-            .depth = 1,
-        },
-        .selection = {
-            .width = static_cast<u32>(bitmap.width()),
-            .height = static_cast<u32>(bitmap.height()),
-            .depth = 1,
-        },
-    };
-}
-
 void Image::regenerate_mipmaps()
 {
     // FIXME: currently this only works for 2D Images
     VERIFY(depth_at_level(0) == 1);
 
-    auto empty_bitmap_for_level = [&](u32 level) -> NonnullRefPtr<Gfx::Bitmap> {
-        Gfx::IntSize size = { width_at_level(level), height_at_level(level) };
-        return MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, size));
-    };
-    auto copy_image_into_bitmap = [&](u32 level) -> NonnullRefPtr<Gfx::Bitmap> {
-        auto bitmap = empty_bitmap_for_level(level);
-
-        auto input_layout = image_data_layout(level, { 0, 0, 0 });
-        auto const* input_data = texel_pointer(level, 0, 0, 0);
-
-        auto output_layout = image_data_layout_for_bitmap(bitmap);
-        auto* output_data = bitmap->scanline(0);
-
-        PixelConverter converter { input_layout, output_layout };
-        MUST(converter.convert(input_data, output_data, {}));
-        return bitmap;
-    };
-    auto copy_bitmap_into_level = [&](NonnullRefPtr<Gfx::Bitmap> bitmap, u32 level) {
-        VERIFY(level >= 1);
-
-        auto input_layout = image_data_layout_for_bitmap(bitmap);
-        auto const* input_data = bitmap->scanline(0);
-
-        auto output_layout = image_data_layout(level, { 0, 0, 0 });
-        auto* output_data = texel_pointer(level, 0, 0, 0);
+    // Nothing was written since the mipmaps were last generated, so they would come out the same.
+    if (m_mipmaps_are_up_to_date)
+        return;
 
-        PixelConverter converter { input_layout, output_layout };
-        MUST(converter.convert(input_data, output_data, {}));
-    };
-
-    // For levels 1..number_of_levels-1, we generate downscaled versions of the level above
+    // For levels 1..number_of_levels-1, we average each 2x2 block of texels of the level above. If a dimension of
+    // the level above is odd, its last row or column is left out; if it is 1, that row or column is used twice.
     for (u32 level = 1; level < number_of_levels(); ++level) {
-        auto higher_level_bitmap = copy_image_into_bitmap(level - 1);
-        auto current_level_bitmap = empty_bitmap_for_level(level);
-
-        Gfx::Painter current_level_painter { current_level_bitmap };
-        current_level_painter.draw_scaled_bitmap(
-            current_level_bitmap->rect(),
-            higher_level_bitmap,
-            higher_level_bitmap->rect(),
-            1.f,
-            Gfx::Painter::ScalingMode::BilinearBlend);
-
-        copy_bitmap_into_level(current_level_bitmap, level);
+        auto const higher_level_width = width_at_level(level - 1);
+        auto const higher_level_height = height_at_level(level - 1);
+        auto const* higher_level_texels = m_mipmap_buffers[level - 1]->buffer_pointer(0, 0, 0);
+        auto* texels = m_mipmap_buffers[level]->buffer_pointer(0, 0, 0);
+
+        for (u32 y = 0; y < height_at_level(level); ++y) {
+            auto const* row0 = higher_level_texels + min(y * 2, higher_level_height - 1) * higher_level_width;
+            auto const* row1 = higher_level_texels + min(y * 2 + 1, higher_level_height - 1) * higher_level_width;
+
+            for (u32 x = 0; x < width_at_level(level); ++x) {
+                auto const x0 = min(x * 2, higher_level_width - 1);
+                auto const x1 = min(x * 2 + 1, higher_level_width - 1);
+                *texels++ = (row0[x0] + row0[x1] + row1[x0] + row1[x1]) * .25f;
+            }
+        }
     }
+
+    m_mipmaps_are_up_to_date = true;
 }
 
 }
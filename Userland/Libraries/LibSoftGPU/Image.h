@@ -50,11 +50,14 @@ public:
 
     FloatVector4* texel_pointer(u32 level, int x, int y, int z)
     {
+        // Anything written could change what the mipmaps should look like.
+        m_mipmaps_are_up_to_date = false;
         return m_mipmap_buffers[level]->buffer_pointer(x, y, z);
     }
 
 private:
     FixedArray<RefPtr<Typed3DBuffer<FloatVector4>>> m_mipmap_buffers;
+    bool m_mipmaps_are_up_to_date { false };
 
     bool m_width_is_power_of_two { false };
     bool m_height_is_power_of_two { false };
@@ -71,21 +71,39 @@ static f32x4 wrap(f32x4 value, GPU::TextureWrapMode mode, f32x4 num_texels)
     }
 }
 
-ALWAYS_INLINE static Vector4<f32x4> texel4(Image const& image, u32x4 level, u32x4 x, u32x4 y)
+static_assert(sizeof(FloatVector4) == sizeof(f32x4));
+
+// Loads each texel as a whole vector, and then transposes them so that each vector holds one component of all four.
+ALWAYS_INLINE static Vector4<f32x4> transpose_texels(FloatVector4 const& t0, FloatVector4 const& t1, FloatVector4 const& t2, FloatVector4 const& t3)
 {
-    auto const& t0 = image.texel(level[0], x[0], y[0], 0);
-    auto const& t1 = image.texel(level[1], x[1], y[1], 0);
-    auto const& t2 = image.texel(level[2], x[2], y[2], 0);
-    auto const& t3 = image.texel(level[3], x[3], y[3], 0);
+    f32x4 a, b, c, d;
+    __builtin_memcpy(&a, &t0, sizeof(a));
+    __builtin_memcpy(&b, &t1, sizeof(b));
+    __builtin_memcpy(&c, &t2, sizeof(c));
+    __builtin_memcpy(&d, &t3, sizeof(d));
+
+    auto const ab_low = __builtin_shufflevector(a, b, 0, 4, 1, 5);
+    auto const ab_high = __builtin_shufflevector(a, b, 2, 6, 3, 7);
+    auto const cd_low = __builtin_shufflevector(c, d, 0, 4, 1, 5);
+    auto const cd_high = __builtin_shufflevector(c, d, 2, 6, 3, 7);
 
     return Vector4<f32x4> {
-        f32x4 { t0.x(), t1.x(), t2.x(), t3.x() },
-        f32x4 { t0.y(), t1.y(), t2.y(), t3.y() },
-        f32x4 { t0.z(), t1.z(), t2.z(), t3.z() },
-        f32x4 { t0.w(), t1.w(), t2.w(), t3.w() },
+        __builtin_shufflevector(ab_low, cd_low, 0, 1, 4, 5),
+        __builtin_shufflevector(ab_low, cd_low, 2, 3, 6, 7),
+        __builtin_shufflevector(ab_high, cd_high, 0, 1, 4, 5),
+        __builtin_shufflevector(ab_high, cd_high, 2, 3, 6, 7),
     };
 }
 
+ALWAYS_INLINE static Vector4<f32x4> texel4(Image const& image, u32x4 level, u32x4 x, u32x4 y)
+{
+    return transpose_texels(
+        image.texel(level[0], x[0], y[0], 0),
+        image.texel(level[1], x[1], y[1], 0),
+        image.texel(level[2], x[2], y[2], 0),
+        image.texel(level[3], x[3], y[3], 0));
+}
+
 ALWAYS_INLINE static Vector4<f32x4> texel4border(Image const& image, u32x4 level, u32x4 x, u32x4 y, FloatVector4 const& border, u32x4 w, u32x4 h)
 {
     auto border_mask = maskbits(x < 0 || x >= w || y < 0 || y >= h);
@@ -95,12 +113,7 @@ ALWAYS_INLINE static Vector4<f32x4> texel4border(Image const& image, u32x4 level
     auto const& t2 = (border_mask & 4) > 0 ? border : image.texel(level[2], x[2], y[2], 0);
     auto const& t3 = (border_mask & 8) > 0 ? border : image.texel(level[3], x[3], y[3], 0);
 
-    return Vector4<f32x4> {
-        f32x4 { t0.x(), t1.x(), t2.x(), t3.x() },
-        f32x4 { t0.y(), t1.y(), t2.y(), t3.y() },
-        f32x4 { t0.z(), t1.z(), t2.z(), t3.z() },
-        f32x4 { t0.w(), t1.w(), t2.w(), t3.w() },
-    };
+    return transpose_texels(t0, t1, t2, t3);
 }
 
 Vector4<AK::SIMD::f32x4> Sampler::sample_2d(Vector2<AK::SIMD::f32x4> const& uv) const
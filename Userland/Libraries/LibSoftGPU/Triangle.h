@@ -9,12 +9,15 @@
 #pragma once
 
 #include <LibGPU/Vertex.h>
+#include <LibGfx/Rect.h>
 #include <LibGfx/Vector2.h>
 
 namespace SoftGPU {
 
 struct Triangle {
     GPU::Vertex vertices[3];
+    // The pixels that the triangle may cover, which is known once it has been set up.
+    Gfx::IntRect render_bounds;
 };
 
 }
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BinarySearch.h>
+#include <AK/Checked.h>
+#include <AK/Demangle.h>
+#include <AK/HashMap.h>
+#include <AK/LexicalPath.h>
+#include <AK/QuickSort.h>
+#include <LibCore/Directory.h>
+#include <LibCore/File.h>
+#include <LibCore/StandardPaths.h>
+#include <LibCore/System.h>
+#include <LibSymbolication/SymbolIndex.h>
+#include <unistd.h>
+
+namespace Symbolication {
+
+// "SYMI", followed by the version. Bump the version whenever the format changes.
+static constexpr u32 SYMBOL_INDEX_MAGIC = 0x494d5953;
+static constexpr u32 SYMBOL_INDEX_VERSION = 1;
+
+DeprecatedString SymbolIndex::cache_directory()
+{
+    return DeprecatedString::formatted("{}/.cache/Symbolication", Core::StandardPaths::home_directory());
+}
+
+// There are no build IDs in our binaries, so indices are found by the path of their object, and checked against its size
+// and modification time.
+static DeprecatedString cache_path_for(DeprecatedString const& path)
+{
+    return DeprecatedString::formatted("{}/{}-{:08x}.index", SymbolIndex::cache_directory(), LexicalPath::basename(path), path.hash());
+}
+
+static i64 modification_time_of(struct stat const& st)
+{
+    return static_cast<i64>(st.st_mtim.tv_sec) * 1'000'000'000 + st.st_mtim.tv_nsec;
+}
+
+static ErrorOr<void> save_to_file(DeprecatedString const& path, ReadonlyBytes bytes)
+{
+    LexicalPath lexical_path { path };
+    (void)TRY(Core::Directory::create(lexical_path.parent(), Core::Directory::CreateDirectories::Yes));
+
+    // Other processes may be mapping the index at the same time, so it's only renamed into place once it's complete.
+    auto temporary_path = DeprecatedString::formatted("{}.{}", path, getpid());
+    {
+        auto file = TRY(Core::File::open(temporary_path, Core::File::OpenMode::Write | Core::File::OpenMode::Truncate));
+        TRY(file->write_entire_buffer(bytes));
+    }
+    if (auto result = Core::System::rename(temporary_path, path); result.is_error()) {
+        (void)Core::System::unlink(temporary_path);
+        return result.release_error();
+    }
+    return {};
+}
+
+ErrorOr<NonnullRefPtr<SymbolIndex>> SymbolIndex::load_or_create(DeprecatedString const& path)
+{
+    auto st = TRY(Core::System::stat(path));
+    auto object_size = static_cast<u64>(st.st_size);
+    auto object_modification_time = modification_time_of(st);
+
+    auto cache_path = cache_path_for(path);
+    if (auto cached_file = Core::MappedFile::map(cache_path); !cached_file.is_error()) {
+        auto index = try_create(cached_file.release_value(), {});
+        if (!index.is_error() && index.value()->m_header.object_size == object_size && index.value()->m_header.object_modification_time == object_modification_time)
+            return index.release_value();
+    }
+
+    auto object_file = TRY(Core::MappedFile::map(path));
+    ELF::Image image { object_file->bytes() };
+    if (!image.is_valid())
+        return Error::from_string_literal("ELF not valid");
+
+    Debug::DebugInfo debug_info { image };
+    auto bytes = TRY(build(image, debug_info, object_size, object_modification_time));
+
+    if (auto result = save_to_file(cache_path, bytes); result.is_error())
+        dbgln("Failed to save symbol index of {} to {}: {}", path, cache_path, result.error());
+
+    return try_create({}, move(bytes));
+}
+
+ErrorOr<Vector<Debug::DebugInfo::SourcePosition>> SymbolIndex::source_positions(Debug::DebugInfo const& debug_info, FlatPtr address)
+{
+    auto source_position_with_inlines = TRY(debug_info.get_source_position_with_inlines(address));
+
+    Vector<Debug::DebugInfo::SourcePosition> positions;
+    for (auto& position : source_position_with_inlines.inline_chain) {
+        if (!positions.contains_slow(position))
+            positions.append(position);
+    }
+
+    if (source_position_with_inlines.source_position.has_value() && !positions.contains_slow(source_position_with_inlines.source_position.value())) {
+        positions.insert(0, source_position_with_inlines.source_position.value());
+    }
+    return positions;
+}
+
+ErrorOr<ByteBuffer> SymbolIndex::build(ELF::Image const& image, Debug::DebugInfo const& debug_info, u64 object_size, i64 object_modification_time)
+{
+    ByteBuffer strings;
+    HashMap<DeprecatedString, u32> string_offsets;
+    auto add_string = [&](DeprecatedString const& string) -> ErrorOr<u32> {
+        if (auto offset = string_offsets.get(string); offset.has_value())
+            return *offset;
+        if (strings.size() + string.length() > NumericLimits<u32>::max())
+            return Error::from_string_literal("Too many strings for a symbol index");
+        auto offset = static_cast<u32>(strings.size());
+        TRY(strings.try_append(string.bytes()));
+        TRY(string_offsets.try_set(string, offset));
+        return offset;
+    };
+
+    // The symbols are sorted the same way as by ELF::Image, so that looking them up gives the same results.
+    struct UnsortedSymbol {
+        FlatPtr address;
+        StringView name;
+    };
+    Vector<UnsortedSymbol> unsorted_symbols;
+    TRY(unsorted_symbols.try_ensure_capacity(image.symbol_count()));
+    image.for_each_symbol([&](auto const& symbol) {
+        unsorted_symbols.append({ symbol.value(), symbol.name() });
+    });
+    quick_sort(unsorted_symbols, [](auto& a, auto& b) {
+        return a.address < b.address;
+    });
+
+    Vector<SymbolEntry> symbols;
+    TRY(symbols.try_ensure_capacity(unsorted_symbols.size()));
+    for (auto const& symbol : unsorted_symbols) {
+        auto name = demangle(symbol.name);
+        symbols.unchecked_append({ symbol.address, TRY(add_string(name)), static_cast<u32>(name.length()) });
+    }
+
+    // The source positions are the same between two boundaries, so only the ranges where they change are stored.
+    Vector<RangeEntry> ranges;
+    Vector<PositionEntry> positions;
+    Vector<Debug::DebugInfo::SourcePosition> previous_positions;
+    for (auto boundary : TRY(debug_info.source_position_boundaries())) {
+        auto boundary_positions = TRY(source_positions(debug_info, boundary));
+        if (boundary_positions == previous_positions)
+            continue;
+
+        TRY(ranges.try_append({ boundary, static_cast<u32>(positions.size()), static_cast<u32>(boundary_positions.size()) }));
+        for (auto const& position : boundary_positions)
+            TRY(positions.try_append({ TRY(add_string(position.file_path)), static_cast<u32>(position.file_path.length()), static_cast<u32>(position.line_number) }));
+        previous_positions = move(boundary_positions);
+    }
+
+    if (symbols.size() > NumericLimits<u32>::max() || ranges.size() > NumericLimits<u32>::max() || positions.size() > NumericLimits<u32>::max())
+        return Error::from_string_literal("Too many entries for a symbol index");
+
+    Header header {
+        .magic = SYMBOL_INDEX_MAGIC,
+        .version = SYMBOL_INDEX_VERSION,
+        .object_size = object_size,
+        .object_modification_time = object_modification_time,
+        .symbol_count = static_cast<u32>(symbols.size()),
+        .range_count = static_cast<u32>(ranges.size()),
+        .position_count = static_cast<u32>(positions.size()),
+        .strings_size = static_cast<u32>(strings.size()),
+    };
+
+    ByteBuffer bytes;
+    TRY(bytes.try_ensure_capacity(sizeof(header) + symbols.size() * sizeof(SymbolEntry) + ranges.size() * sizeof(RangeEntry) + positions.size() * sizeof(PositionEntry) + strings.size()));
+    TRY(bytes.try_append(&header, sizeof(header)));
+    TRY(bytes.try_append(symbols.data(), symbols.size() * sizeof(SymbolEntry)));
+    TRY(bytes.try_append(ranges.data(), ranges.size() * sizeof(RangeEntry)));
+    TRY(bytes.try_append(positions.data(), positions.size() * sizeof(PositionEntry)));
+    TRY(bytes.try_append(strings));
+    return bytes;
+}
+
+ErrorOr<NonnullRefPtr<SymbolIndex>> SymbolIndex::try_create(RefPtr<Core::MappedFile> file, ByteBuffer buffer)
+{
+    auto index = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) SymbolIndex(move(file), move(buffer))));
+    TRY(index->validate());
+    return index;
+}
+
+SymbolIndex::SymbolIndex(RefPtr<Core::MappedFile> file, ByteBuffer buffer)
+    : m_file(move(file))
+    , m_buffer(move(buffer))
+{
+    m_bytes = m_file ? m_file->bytes() : m_buffer.bytes();
+}
+
+ErrorOr<void> SymbolIndex::validate()
+{
+    // The tables are aligned to their entries as long as the data is, since each table ends on the next one's alignment.
+    static_assert(sizeof(Header) % alignof(SymbolEntry) == 0);
+    static_assert(sizeof(SymbolEntry) % alignof(RangeEntry) == 0);
+    static_assert(sizeof(RangeEntry) % alignof(PositionEntry) == 0);
+    if (reinterpret_cast<FlatPtr>(m_bytes.data()) % alignof(SymbolEntry) != 0)
+        return Error::from_string_literal("Symbol index is not aligned");
+
+    if (m_bytes.size() < sizeof(Header))
+        return Error::from_string_literal("Symbol index is too small");
+    __builtin_memcpy(&m_header, m_bytes.data(), sizeof(Header));
+    if (m_header.magic != SYMBOL_INDEX_MAGIC || m_header.version != SYMBOL_INDEX_VERSION)
+        return Error::from_string_literal("Symbol index has an unsupported version");
+
+    Checked<size_t> size = sizeof(Header);
+    size += Checked<size_t>(m_header.symbol_count) * Checked<size_t>(sizeof(SymbolEntry));
+    size += Checked<size_t>(m_header.range_count) * Checked<size_t>(sizeof(RangeEntry));
+    size += Checked<size_t>(m_header.position_count) * Checked<size_t>(sizeof(PositionEntry));
+    size += m_header.strings_size;
+    if (size.has_overflow() || size.value() != m_bytes.size())
+        return Error::from_string_literal("Symbol index has an invalid size");
+
+    auto const* data = m_bytes.data() + sizeof(Header);
+    m_symbols = { reinterpret_cast<SymbolEntry const*>(data), m_header.symbol_count };
+    data += m_header.symbol_count * sizeof(SymbolEntry);
+    m_ranges = { reinterpret_cast<RangeEntry const*>(data), m_header.range_count };
+    data += m_header.range_count * sizeof(RangeEntry);
+    m_positions = { reinterpret_cast<PositionEntry const*>(data), m_header.position_count };
+    data += m_header.position_count * sizeof(PositionEntry);
+    m_strings = { data, m_header.strings_size };
+    return {};
+}
+
+Optional<StringView> SymbolIndex::string_at(u32 offset, u32 length) const
+{
+    if (static_cast<size_t>(offset) + length > m_strings.size())
+        return {};
+    return StringView { m_strings.slice(offset, length) };
+}
+
+DeprecatedString SymbolIndex::symbolicate(FlatPtr address, u32* out_offset) const
+{
+    if (out_offset)
+        *out_offset = 0;
+
+    // Like ELF::Image::find_sorted_symbol(), this uses the nearby index of the search, which is never the first symbol.
+    size_t index = 0;
+    binary_search(m_symbols, nullptr, &index, [&address](auto, auto& candidate) {
+        if (address < candidate.address)
+            return -1;
+        else if (address > candidate.address)
+            return 1;
+        else
+            return 0;
+    });
+    if (index == 0)
+        return "??";
+
+    auto const& symbol = m_symbols[index];
+    auto name = string_at(symbol.name_offset, symbol.name_length);
+    if (!name.has_value())
+        return "??";
+
+    if (out_offset) {
+        *out_offset = address - symbol.address;
+        return *name;
+    }
+    return DeprecatedString::formatted("{} +{:#x}", *name, address - symbol.address);
+}
+
+Vector<Debug::DebugInfo::SourcePosition> SymbolIndex::source_positions(FlatPtr address) const
+{
+    // Find the last range that starts at or before the address.
+    size_t low = 0;
+    size_t high = m_ranges.size();
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        if (m_ranges[middle].address > address)
+            high = middle;
+        else
+            low = middle + 1;
+    }
+    if (low == 0)
+        return {};
+
+    auto const& range = m_ranges[low - 1];
+    if (static_cast<size_t>(range.first_position) + range.position_count > m_positions.size())
+        return {};
+
+    Vector<Debug::DebugInfo::SourcePosition> positions;
+    positions.ensure_capacity(range.position_count);
+    for (auto const& position : m_positions.slice(range.first_position, range.position_count)) {
+        auto file_path = string_at(position.file_offset, position.file_length);
+        if (!file_path.has_value())
+            return {};
+        positions.unchecked_append({ *file_path, position.line });
+    }
+    return positions;
+}
+
+}
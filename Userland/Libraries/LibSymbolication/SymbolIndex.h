@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/DeprecatedString.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
+#include <AK/Span.h>
+#include <LibCore/MappedFile.h>
+#include <LibDebug/DebugInfo.h>
+#include <LibELF/Image.h>
+
+namespace Symbolication {
+
+// The symbols and source positions of an ELF object, in sorted tables that can be looked up without parsing anything.
+// An index is built once per object and kept in the user's cache directory, where every later lookup maps it from.
+class SymbolIndex : public RefCounted<SymbolIndex> {
+public:
+    // Maps the cached index of the object at the given path, and builds it first if it's missing or outdated.
+    static ErrorOr<NonnullRefPtr<SymbolIndex>> load_or_create(DeprecatedString const& path);
+
+    // Where the indices are kept, which sandboxed consumers need to unveil.
+    static DeprecatedString cache_directory();
+
+    // Behaves like ELF::Image::symbolicate().
+    DeprecatedString symbolicate(FlatPtr address, u32* offset = nullptr) const;
+
+    // The source position of the address, followed by the positions of the calls it was inlined into.
+    Vector<Debug::DebugInfo::SourcePosition> source_positions(FlatPtr address) const;
+
+    static ErrorOr<Vector<Debug::DebugInfo::SourcePosition>> source_positions(Debug::DebugInfo const&, FlatPtr address);
+
+private:
+    struct Header {
+        u32 magic;
+        u32 version;
+        // The index is rebuilt once the object it was built from changes.
+        u64 object_size;
+        i64 object_modification_time;
+        u32 symbol_count;
+        u32 range_count;
+        u32 position_count;
+        u32 strings_size;
+    };
+
+    struct SymbolEntry {
+        u64 address;
+        u32 name_offset;
+        u32 name_length;
+    };
+
+    // The addresses from this one up to the address of the next range have the same source positions.
+    struct RangeEntry {
+        u64 address;
+        u32 first_position;
+        u32 position_count;
+    };
+
+    struct PositionEntry {
+        u32 file_offset;
+        u32 file_length;
+        u32 line;
+    };
+
+    static ErrorOr<ByteBuffer> build(ELF::Image const&, Debug::DebugInfo const&, u64 object_size, i64 object_modification_time);
+    static ErrorOr<NonnullRefPtr<SymbolIndex>> try_create(RefPtr<Core::MappedFile>, ByteBuffer);
+
+    SymbolIndex(RefPtr<Core::MappedFile>, ByteBuffer);
+    ErrorOr<void> validate();
+
+    Optional<StringView> string_at(u32 offset, u32 length) const;
+
+    RefPtr<Core::MappedFile> m_file;
+    ByteBuffer m_buffer;
+
+    ReadonlyBytes m_bytes;
+    Header m_header {};
+    ReadonlySpan<SymbolEntry> m_symbols;
+    ReadonlySpan<RangeEntry> m_ranges;
+    ReadonlySpan<PositionEntry> m_positions;
+    ReadonlyBytes m_strings;
+};
+
+}
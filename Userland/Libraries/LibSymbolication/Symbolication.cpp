@@ -11,19 +11,12 @@
 #include <AK/JsonValue.h>
 #include <AK/LexicalPath.h>
 #include <LibCore/DeprecatedFile.h>
-#include <LibCore/MappedFile.h>
-#include <LibDebug/DebugInfo.h>
+#include <LibSymbolication/SymbolIndex.h>
 #include <LibSymbolication/Symbolication.h>
 
 namespace Symbolication {
 
-struct CachedELF {
-    NonnullRefPtr<Core::MappedFile> mapped_file;
-    NonnullOwnPtr<Debug::DebugInfo> debug_info;
-    NonnullOwnPtr<ELF::Image> image;
-};
-
-static HashMap<DeprecatedString, OwnPtr<CachedELF>> s_cache;
+static HashMap<DeprecatedString, RefPtr<SymbolIndex>> s_cache;
 
 enum class KernelBaseState {
     Uninitialized,
@@ -77,45 +70,28 @@ Optional<Symbol> symbolicate(DeprecatedString const& path, FlatPtr address, Incl
         }
     }
     if (!s_cache.contains(full_path)) {
-        auto mapped_file = Core::MappedFile::map(full_path);
-        if (mapped_file.is_error()) {
-            dbgln("Failed to map {}: {}", full_path, mapped_file.error());
-            s_cache.set(full_path, {});
-            return {};
-        }
-        auto elf = make<ELF::Image>(mapped_file.value()->bytes());
-        if (!elf->is_valid()) {
-            dbgln("ELF not valid: {}", full_path);
+        auto symbol_index = SymbolIndex::load_or_create(full_path);
+        if (symbol_index.is_error()) {
+            dbgln("Failed to load symbols of {}: {}", full_path, symbol_index.error());
             s_cache.set(full_path, {});
             return {};
         }
-        auto cached_elf = make<CachedELF>(mapped_file.release_value(), make<Debug::DebugInfo>(*elf), move(elf));
-        s_cache.set(full_path, move(cached_elf));
+        s_cache.set(full_path, symbol_index.release_value());
     }
 
     auto it = s_cache.find(full_path);
     VERIFY(it != s_cache.end());
-    auto& cached_elf = it->value;
+    auto& symbol_index = it->value;
 
-    if (!cached_elf)
+    if (!symbol_index)
         return {};
 
     u32 offset = 0;
-    auto symbol = cached_elf->debug_info->elf().symbolicate(address, &offset);
+    auto symbol = symbol_index->symbolicate(address, &offset);
 
     Vector<Debug::DebugInfo::SourcePosition> positions;
-    if (include_source_positions == IncludeSourcePosition::Yes) {
-        auto source_position_with_inlines = cached_elf->debug_info->get_source_position_with_inlines(address).release_value_but_fixme_should_propagate_errors();
-
-        for (auto& position : source_position_with_inlines.inline_chain) {
-            if (!positions.contains_slow(position))
-                positions.append(position);
-        }
-
-        if (source_position_with_inlines.source_position.has_value() && !positions.contains_slow(source_position_with_inlines.source_position.value())) {
-            positions.insert(0, source_position_with_inlines.source_position.value());
-        }
-    }
+    if (include_source_positions == IncludeSourcePosition::Yes)
+        positions = symbol_index->source_positions(address);
 
     return Symbol {
         .address = address,
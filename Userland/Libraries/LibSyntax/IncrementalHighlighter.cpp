@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashMap.h>
+#include <AK/StringBuilder.h>
+#include <LibGUI/TextDocument.h>
+#include <LibSyntax/IncrementalHighlighter.h>
+
+namespace Syntax {
+
+void IncrementalHighlighter::rehighlight(Palette const& palette)
+{
+    // The colors of the spans come from the palette, so none of them are of any use after it changed.
+    if (!m_palette.has_value() || &m_palette->impl() != &palette.impl())
+        m_lines.clear();
+    m_palette = palette;
+
+    match_lines_with_document();
+    bool is_done = lex_lines_needing_it(palette);
+
+    Vector<GUI::TextDocumentSpan> spans;
+    for (size_t line_index = 0; line_index < m_lines.size(); ++line_index) {
+        for (auto span : m_lines[line_index].spans) {
+            span.range.start().set_line(line_index);
+            span.range.end().set_line(line_index);
+            spans.append(move(span));
+        }
+    }
+    m_client->do_set_spans(move(spans));
+
+    m_has_brace_buddies = false;
+    highlight_matching_token_pair();
+
+    m_client->do_update();
+
+    if (!is_done)
+        schedule_next_batch();
+}
+
+void IncrementalHighlighter::match_lines_with_document()
+{
+    auto& document = m_client->get_document();
+
+    // No two lines ever have the same version, so it tells us which lines we've lexed before, and where they were.
+    HashMap<u64, size_t> old_line_indices;
+    for (size_t i = 0; i < m_lines.size(); ++i)
+        old_line_indices.set(m_lines[i].version, i);
+
+    Vector<Line> lines;
+    lines.ensure_capacity(document.line_count());
+    Optional<size_t> previous_old_index;
+    for (size_t i = 0; i < document.line_count(); ++i) {
+        auto version = document.line(i).version();
+        auto old_index = old_line_indices.get(version);
+        if (!old_index.has_value()) {
+            Line line;
+            line.version = version;
+            lines.unchecked_append(move(line));
+            previous_old_index = {};
+            continue;
+        }
+
+        auto line = move(m_lines[*old_index]);
+        // Whether a token spans into a line depends on the lines before it, so we don't know anymore if it follows another line now.
+        bool follows_the_same_line = i == 0 ? *old_index == 0 : previous_old_index.has_value() && *previous_old_index + 1 == *old_index;
+        if (!follows_the_same_line)
+            line.needs_lexing = true;
+        lines.unchecked_append(move(line));
+        previous_old_index = old_index;
+    }
+    m_lines = move(lines);
+}
+
+bool IncrementalHighlighter::lex_lines_needing_it(Palette const& palette)
+{
+    auto& document = m_client->get_document();
+    size_t lexed_line_count = 0;
+
+    size_t line_index = 0;
+    while (line_index < m_lines.size()) {
+        if (!m_lines[line_index].needs_lexing) {
+            ++line_index;
+            continue;
+        }
+        if (lexed_line_count >= lines_per_batch)
+            return false;
+
+        // We can only start lexing at the beginning of a token, and we don't know yet whether this line begins with one.
+        size_t start_line = line_index;
+        while (start_line > 0) {
+            --start_line;
+            if (m_lines[start_line].is_token_boundary)
+                break;
+        }
+
+        // Lines after this one still have the spans from before the edit, so if lexing begins a line no token spans into,
+        // and also didn't before, everything after it will come out the same again.
+        size_t first_unlexed_line = line_index + 1;
+        size_t lines_per_chunk = initial_lines_per_chunk;
+
+        for (;;) {
+            size_t end_line = min(start_line + lines_per_chunk, m_lines.size());
+            bool reaches_end_of_document = end_line == m_lines.size();
+
+            StringBuilder builder;
+            for (size_t i = start_line; i < end_line; ++i) {
+                builder.append(document.line(i).view());
+                if (i + 1 < m_lines.size())
+                    builder.append('\n');
+            }
+
+            Vector<Line> lexed_lines;
+            lexed_lines.resize(end_line - start_line);
+            for (auto& lexed_line : lexed_lines)
+                lexed_line.is_token_boundary = true;
+
+            size_t last_span_start_line = start_line;
+            lex(palette, builder.string_view(), start_line, [&](GUI::TextDocumentSpan span) {
+                auto first_line = span.range.start().line();
+                auto last_line = span.range.end().line();
+                if (first_line < start_line || first_line >= end_line)
+                    return;
+                last_span_start_line = first_line;
+
+                for (size_t i = first_line; i <= min(last_line, end_line - 1); ++i) {
+                    auto& lexed_line = lexed_lines[i - start_line];
+                    size_t start_column = i == first_line ? span.range.start().column() : 0;
+                    size_t end_column = i == last_line ? span.range.end().column() : document.line(i).length();
+
+                    // Lexing whitespace can't go wrong, no matter where we start.
+                    if (i > first_line && (i < last_line || end_column > 0) && !span.is_skippable)
+                        lexed_line.is_token_boundary = false;
+
+                    if (start_column >= end_column)
+                        continue;
+                    auto piece = span;
+                    piece.range.set_start({ 0, start_column });
+                    piece.range.set_end({ 0, end_column });
+                    lexed_line.spans.append(move(piece));
+                }
+            });
+
+            // The last token might go on past the end of the chunk, so we can't trust the lines it's on yet.
+            size_t trusted_end_line = reaches_end_of_document ? end_line : last_span_start_line;
+
+            Optional<size_t> converged_line;
+            size_t next_start_line = start_line;
+            for (size_t i = start_line; i < trusted_end_line; ++i) {
+                auto& line = m_lines[i];
+                auto& lexed_line = lexed_lines[i - start_line];
+                if (i >= first_unlexed_line && !line.needs_lexing && line.is_token_boundary && lexed_line.is_token_boundary) {
+                    converged_line = i;
+                    break;
+                }
+
+                line.spans = move(lexed_line.spans);
+                line.is_token_boundary = lexed_line.is_token_boundary;
+                line.needs_lexing = false;
+                ++lexed_line_count;
+                if (i > start_line && line.is_token_boundary)
+                    next_start_line = i;
+            }
+
+            if (converged_line.has_value()) {
+                line_index = *converged_line;
+                break;
+            }
+            if (reaches_end_of_document) {
+                line_index = m_lines.size();
+                break;
+            }
+
+            first_unlexed_line = max(first_unlexed_line, trusted_end_line);
+            if (trusted_end_line > start_line && lexed_line_count >= lines_per_batch) {
+                m_lines[trusted_end_line].needs_lexing = true;
+                return false;
+            }
+
+            // If no token boundary was in the chunk, it wasn't big enough.
+            if (next_start_line == start_line)
+                lines_per_chunk *= 2;
+            else
+                start_line = next_start_line;
+        }
+    }
+
+    return true;
+}
+
+void IncrementalHighlighter::schedule_next_batch()
+{
+    if (!m_next_batch_timer) {
+        m_next_batch_timer = Core::Timer::create_single_shot(0, [this] {
+            if (!m_client || !m_palette.has_value())
+                return;
+            auto palette = *m_palette;
+            rehighlight(palette);
+        }).release_value_but_fixme_should_propagate_errors();
+    }
+    m_next_batch_timer->restart();
+}
+
+}
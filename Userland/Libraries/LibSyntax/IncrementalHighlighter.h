@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibCore/Timer.h>
+#include <LibGfx/Palette.h>
+#include <LibSyntax/Highlighter.h>
+
+namespace Syntax {
+
+// A highlighter for languages whose lexer starts every line in the same state, unless a token spans into it from the line before.
+// It remembers the spans on each line of the document, and whether a token spans into it. After an edit, it lexes again from the
+// last line before the first changed one that no token spans into, until it reaches an unchanged line that no token spans into,
+// neither before nor now. From there on, the remembered spans are still right.
+// NOTE: Highlighting a lot of lines, like those of a document that was just opened, is split up into batches which run when the
+//       event loop gets to it, so that we keep up with input and painting.
+class IncrementalHighlighter : public Highlighter {
+public:
+    virtual ~IncrementalHighlighter() override = default;
+
+    virtual void rehighlight(Palette const&) override final;
+
+protected:
+    IncrementalHighlighter() = default;
+
+    // Lexes `text`, which begins at the start of the document's line `start_line`, and calls `callback` with each token's span in order.
+    // Spans may end on a later line than they start on.
+    virtual void lex(Palette const&, StringView text, size_t start_line, Function<void(GUI::TextDocumentSpan)> callback) = 0;
+
+private:
+    static constexpr size_t lines_per_batch = 10000;
+    static constexpr size_t initial_lines_per_chunk = 256;
+
+    struct Line {
+        u64 version { 0 };
+        bool needs_lexing { true };
+        bool is_token_boundary { false };
+        // The spans of the tokens on this line, cut off at its start and end. Their line is 0.
+        Vector<GUI::TextDocumentSpan> spans;
+    };
+
+    void match_lines_with_document();
+    bool lex_lines_needing_it(Palette const&);
+    void schedule_next_batch();
+
+    Vector<Line> m_lines;
+    Optional<Gfx::Palette> m_palette;
+    RefPtr<Core::Timer> m_next_batch_timer;
+};
+
+}
@@ -103,6 +103,8 @@ enum class HashAlgorithm : u8 {
     SHA256 = 4,
     SHA384 = 5,
     SHA512 = 6,
+    // Defined in RFC 8446 section 4.2.3, for signature schemes that name their own hash function.
+    INTRINSIC = 8,
 };
 
 // Defined in RFC 5246 section 7.4.1.4.1
@@ -111,6 +113,10 @@ enum class SignatureAlgorithm : u8 {
     RSA = 1,
     DSA = 2,
     ECDSA = 3,
+    // Defined in RFC 8446 section 4.2.3, together with HashAlgorithm::INTRINSIC
+    RSA_PSS_RSAE_SHA256 = 4,
+    RSA_PSS_RSAE_SHA384 = 5,
+    RSA_PSS_RSAE_SHA512 = 6,
 };
 
 // Defined in RFC 5246 section 7.4.1.4.1
@@ -136,6 +142,8 @@ enum class KeyExchangeAlgorithm {
     ECDH_RSA,
     ECDHE_ECDSA,
     ECDH_anon,
+    // Defined in RFC 8446 section 4.2.8: TLS 1.3 cipher suites leave the key exchange to the key_share extension.
+    KeyShare,
 };
 
 // Defined in RFC 5246 section 7.4.1.4.1
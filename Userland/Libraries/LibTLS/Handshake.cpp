@@ -18,7 +18,10 @@ namespace TLS {
 
 ByteBuffer TLSv12::build_hello()
 {
-    fill_with_random(&m_context.local_random, 32);
+    // RFC 8446 section 4.1.2: The ClientHello that answers a HelloRetryRequest is the same as the first one, except for what the server asked for.
+    bool is_second_client_hello = m_context.tls13.has_received_hello_retry_request;
+    if (!is_second_client_hello)
+        fill_with_random(&m_context.local_random, 32);
 
     auto packet_version = (u16)m_context.options.version;
     auto version = (u16)m_context.options.version;
@@ -35,6 +38,36 @@ ByteBuffer TLSv12::build_hello()
     builder.append(version);
     builder.append(m_context.local_random, sizeof(m_context.local_random));
 
+    // Offer to resume the last session with this host, if we still remember it.
+    // A TLS 1.3 session is offered with the pre_shared_key extension instead.
+    bool offers_tls13 = this->offers_tls13();
+    if (!is_second_client_hello)
+        m_context.offered_session.clear();
+    if (!is_second_client_hello && m_context.options.session_cache && !m_context.extensions.SNI.is_null()) {
+        auto session = m_context.options.session_cache->get(m_context.extensions.SNI);
+        if (session.has_value() && session->version == Version::V13 && !offers_tls13)
+            session.clear();
+        if (session.has_value() && m_context.options.usable_cipher_suites.contains_slow(session->cipher)) {
+            if (session->version == Version::V13) {
+                // Nothing to do here.
+            } else if (!session->ticket.is_empty()) {
+                // RFC 5077 section 3.4: The server echoes the session ID that comes with a ticket if it accepts the ticket.
+                fill_with_random(m_context.session_id, sizeof(m_context.session_id));
+                m_context.session_id_size = sizeof(m_context.session_id);
+            } else {
+                session->session_id.bytes().copy_to({ m_context.session_id, sizeof(m_context.session_id) });
+                m_context.session_id_size = session->session_id.size();
+            }
+            m_context.offered_session = session.release_value();
+        }
+    }
+
+    // RFC 8446 appendix D.4: Middleboxes are happier with a TLS 1.3 handshake when it looks like a resumed 1.2 one.
+    if (offers_tls13 && !is_second_client_hello && m_context.session_id_size == 0) {
+        fill_with_random(m_context.session_id, sizeof(m_context.session_id));
+        m_context.session_id_size = sizeof(m_context.session_id);
+    }
+
     builder.append(m_context.session_id_size);
     if (m_context.session_id_size)
         builder.append(m_context.session_id, m_context.session_id_size);
@@ -58,8 +91,13 @@ ByteBuffer TLSv12::build_hello()
     }
 
     // Ciphers
-    builder.append((u16)(m_context.options.usable_cipher_suites.size() * sizeof(u16)));
-    for (auto suite : m_context.options.usable_cipher_suites)
+    Vector<CipherSuite> cipher_suites;
+    for (auto suite : m_context.options.usable_cipher_suites) {
+        if (offers_tls13 || get_key_exchange_algorithm(suite) != KeyExchangeAlgorithm::KeyShare)
+            cipher_suites.append(suite);
+    }
+    builder.append((u16)(cipher_suites.size() * sizeof(u16)));
+    for (auto suite : cipher_suites)
         builder.append((u16)suite);
 
     // we don't like compression
@@ -86,6 +124,22 @@ ByteBuffer TLSv12::build_hello()
     if (supports_elliptic_curves)
         extension_length += 6 + elliptic_curves_length + 5 + supported_ec_point_formats_length;
 
+    // session_ticket: empty to ask for a ticket, or with the one we got last time
+    bool wants_session_ticket = m_context.options.session_cache;
+    ReadonlyBytes session_ticket;
+    if (m_context.offered_session.has_value() && m_context.offered_session->version == Version::V12)
+        session_ticket = m_context.offered_session->ticket;
+    if (wants_session_ticket)
+        extension_length += 4 + session_ticket.size();
+
+    auto tls13_extensions_or_error = build_tls13_hello_extensions();
+    if (tls13_extensions_or_error.is_error()) {
+        dbgln("Failed to build the TLS 1.3 extensions: {}", tls13_extensions_or_error.error());
+        return {};
+    }
+    auto tls13_extensions = tls13_extensions_or_error.release_value();
+    extension_length += tls13_extensions.size();
+
     builder.append((u16)extension_length);
 
     if (sni_length) {
@@ -130,11 +184,33 @@ ByteBuffer TLSv12::build_hello()
             builder.append((u8)format);
     }
 
+    if (wants_session_ticket) {
+        // session_ticket extension
+        builder.append((u16)HandshakeExtension::SessionTicket);
+        builder.append((u16)session_ticket.size());
+        builder.append(session_ticket);
+    }
+
     if (alpn_length) {
-        // TODO
-        VERIFY_NOT_REACHED();
+        // application_layer_protocol_negotiation extension
+        builder.append((u16)HandshakeExtension::ApplicationLayerProtocolNegotiation);
+        builder.append((u16)(alpn_length + 2));
+        builder.append((u16)alpn_length);
+        auto append_protocol = [&](StringView protocol) {
+            builder.append((u8)protocol.length());
+            builder.append(protocol.bytes());
+        };
+        if (!m_context.negotiated_alpn.is_null()) {
+            append_protocol(m_context.negotiated_alpn);
+        } else {
+            for (auto& protocol : m_context.alpn)
+                append_protocol(protocol);
+        }
     }
 
+    // These have to come last, because of the pre_shared_key extension.
+    builder.append(tls13_extensions);
+
     // set the "length" field of the packet
     size_t remaining = builder.length() - start_length;
     size_t payload_position = 6;
@@ -145,6 +221,10 @@ ByteBuffer TLSv12::build_hello()
     builder.set(payload_position + 2, remaining);
 
     auto packet = builder.build();
+    if (auto result = fill_tls13_binder(packet); result.is_error()) {
+        dbgln("Failed to compute the pre-shared key binder: {}", result.error());
+        return {};
+    }
     update_packet(packet);
 
     return packet;
@@ -156,7 +236,9 @@ ByteBuffer TLSv12::build_change_cipher_spec()
     builder.append((u8)1);
     auto packet = builder.build();
     update_packet(packet);
-    m_context.local_sequence_number = 0;
+    // In TLS 1.3, this is only here to appease middleboxes, and doesn't have anything to do with the keys.
+    if (!is_tls13())
+        m_context.local_sequence_number = 0;
     return packet;
 }
 
@@ -218,6 +300,19 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
 
     // TODO: Compare Hashes
     dbgln_if(TLS_DEBUG, "FIXME: handle_handshake_finished :: Check message validity");
+
+    // In an abbreviated handshake, the server finishes first, and we still have to send our own finished message.
+    if (m_context.is_resuming_session) {
+        write_packets = WritePacketStage::Finished;
+        return index + size;
+    }
+
+    did_establish_connection();
+    return index + size;
+}
+
+void TLSv12::did_establish_connection()
+{
     m_context.connection_status = ConnectionStatus::Established;
 
     if (m_handshake_timeout_timer) {
@@ -227,15 +322,49 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
         m_handshake_timeout_timer = nullptr;
     }
 
+    remember_session();
+
+    // The server didn't read the early data, so it gets it again now.
+    if (m_context.tls13.early_data_status == EarlyDataStatus::Rejected) {
+        dbgln_if(TLS_DEBUG, "Resending {} bytes of rejected early data", m_context.options.early_data.size());
+        MUST(write(m_context.options.early_data));
+    }
+
     if (on_connected)
         on_connected();
+}
 
-    return index + size;
+ssize_t TLSv12::handle_new_session_ticket(ReadonlyBytes buffer)
+{
+    // RFC 5077 section 3.3: struct { uint32 ticket_lifetime_hint; opaque ticket<0..2^16-1>; } NewSessionTicket;
+    if (buffer.size() < 9)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+    u32 lifetime_hint = AK::convert_between_host_and_network_endian(ByteReader::load32(buffer.offset_pointer(3)));
+    u16 ticket_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(7)));
+    if (size != 6u + ticket_length || buffer.size() < 9u + ticket_length)
+        return (i8)Error::BrokenPacket;
+
+    auto ticket_or_error = ByteBuffer::copy(buffer.slice(9, ticket_length));
+    if (ticket_or_error.is_error())
+        return (i8)Error::OutOfMemory;
+    m_context.session_ticket = ticket_or_error.release_value();
+
+    // A hint of zero means that the lifetime is unspecified.
+    auto lifetime = Time::from_seconds(lifetime_hint);
+    if (lifetime_hint == 0 || lifetime > SessionCache::maximum_lifetime)
+        lifetime = SessionCache::maximum_lifetime;
+    m_context.session_ticket_lifetime = lifetime;
+
+    dbgln_if(TLS_DEBUG, "New session ticket of {} bytes, lifetime hint {}s", ticket_length, lifetime_hint);
+    return 3 + size;
 }
 
 ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
 {
-    if (m_context.connection_status == ConnectionStatus::Established) {
+    // TLS 1.3 has no renegotiation, but it does have handshake messages after the handshake.
+    if (m_context.connection_status == ConnectionStatus::Established && !is_tls13()) {
         dbgln_if(TLS_DEBUG, "Renegotiation attempt ignored");
         // FIXME: We should properly say "NoRenegotiation", but that causes a handshake failure
         //        so we just roll with it and pretend that we _did_ renegotiate
@@ -299,6 +428,26 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             dbgln("unsupported: DTLS");
             payload_res = (i8)Error::UnexpectedMessage;
             break;
+        case NewSessionTicket:
+            if (is_tls13()) {
+                // There may be any number of these, and they aren't part of the transcript.
+                dbgln_if(TLS_DEBUG, "new session ticket");
+                payload_res = handle_tls13_new_session_ticket(buffer.slice(1, payload_size));
+                break;
+            }
+            if (m_context.handshake_messages[11] >= 1) {
+                dbgln("unexpected new session ticket message");
+                payload_res = (i8)Error::UnexpectedMessage;
+                break;
+            }
+            ++m_context.handshake_messages[11];
+            dbgln_if(TLS_DEBUG, "new session ticket");
+            if (m_context.connection_status == ConnectionStatus::KeyExchange && !m_context.is_server) {
+                payload_res = handle_new_session_ticket(buffer.slice(1, payload_size));
+            } else {
+                payload_res = (i8)Error::UnexpectedMessage;
+            }
+            break;
         case CertificateMessage:
             if (m_context.handshake_messages[4] >= 1) {
                 dbgln("unexpected certificate message");
@@ -307,7 +456,9 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             }
             ++m_context.handshake_messages[4];
             dbgln_if(TLS_DEBUG, "certificate");
-            if (m_context.connection_status == ConnectionStatus::Negotiating) {
+            if (is_tls13()) {
+                payload_res = handle_tls13_certificate(buffer.slice(1, payload_size));
+            } else if (m_context.connection_status == ConnectionStatus::Negotiating) {
                 if (m_context.is_server) {
                     dbgln("unsupported: server mode");
                     VERIFY_NOT_REACHED();
@@ -325,7 +476,9 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             }
             ++m_context.handshake_messages[5];
             dbgln_if(TLS_DEBUG, "server key exchange");
-            if (m_context.is_server) {
+            if (is_tls13()) {
+                payload_res = (i8)Error::UnexpectedMessage;
+            } else if (m_context.is_server) {
                 dbgln("unsupported: server mode");
                 VERIFY_NOT_REACHED();
             } else {
@@ -343,6 +496,8 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 dbgln("invalid request");
                 dbgln("unsupported: server mode");
                 VERIFY_NOT_REACHED();
+            } else if (is_tls13()) {
+                payload_res = handle_tls13_certificate_request(buffer.slice(1, payload_size));
             } else {
                 // we do not support "certificate request"
                 dbgln("certificate request");
@@ -359,7 +514,9 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             }
             ++m_context.handshake_messages[7];
             dbgln_if(TLS_DEBUG, "server hello done");
-            if (m_context.is_server) {
+            if (is_tls13()) {
+                payload_res = (i8)Error::UnexpectedMessage;
+            } else if (m_context.is_server) {
                 dbgln("unsupported: server mode");
                 VERIFY_NOT_REACHED();
             } else {
@@ -376,7 +533,9 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             }
             ++m_context.handshake_messages[8];
             dbgln_if(TLS_DEBUG, "certificate verify");
-            if (m_context.connection_status == ConnectionStatus::KeyExchange) {
+            if (is_tls13()) {
+                payload_res = handle_tls13_certificate_verify(buffer.slice(1, payload_size));
+            } else if (m_context.connection_status == ConnectionStatus::KeyExchange) {
                 payload_res = handle_certificate_verify(buffer.slice(1, payload_size));
             } else {
                 payload_res = (i8)Error::UnexpectedMessage;
@@ -406,17 +565,41 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             }
             ++m_context.handshake_messages[10];
             dbgln_if(TLS_DEBUG, "finished");
-            payload_res = handle_handshake_finished(buffer.slice(1, payload_size), write_packets);
+            if (is_tls13())
+                payload_res = handle_tls13_finished(buffer.slice(1, payload_size), write_packets);
+            else
+                payload_res = handle_handshake_finished(buffer.slice(1, payload_size), write_packets);
             if (payload_res > 0) {
                 memset(m_context.handshake_messages, 0, sizeof(m_context.handshake_messages));
             }
             break;
+        case EncryptedExtensions:
+            if (!is_tls13() || m_context.handshake_messages[12] >= 1) {
+                dbgln("unexpected encrypted extensions message");
+                payload_res = (i8)Error::UnexpectedMessage;
+                break;
+            }
+            ++m_context.handshake_messages[12];
+            dbgln_if(TLS_DEBUG, "encrypted extensions");
+            if (m_context.connection_status == ConnectionStatus::Negotiating)
+                payload_res = handle_encrypted_extensions(buffer.slice(1, payload_size));
+            else
+                payload_res = (i8)Error::UnexpectedMessage;
+            break;
+        case KeyUpdate:
+            dbgln_if(TLS_DEBUG, "key update");
+            if (is_tls13())
+                payload_res = handle_key_update(buffer.slice(1, payload_size));
+            else
+                payload_res = (i8)Error::UnexpectedMessage;
+            break;
         default:
             dbgln("message type not understood: {}", type);
             return (i8)Error::NotUnderstood;
         }
 
-        if (type != HelloRequest) {
+        bool is_post_handshake_message = is_tls13() && (type == NewSessionTicket || type == KeyUpdate);
+        if (type != HelloRequest && !is_post_handshake_message) {
             update_hash(buffer.slice(0, payload_size + 1), 0);
         }
 
@@ -479,6 +662,11 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 write_packet(packet);
                 break;
             }
+            case Error::IllegalParameter: {
+                auto packet = build_alert(true, (u8)AlertDescription::IllegalParameter);
+                write_packet(packet);
+                break;
+            }
             case Error::NeedMoreData:
                 // Ignore this, as it's not an "error"
                 dbgln_if(TLS_DEBUG, "More data needed");
@@ -526,19 +714,55 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             dbgln("UNSUPPORTED: Server mode");
             VERIFY_NOT_REACHED();
             break;
+        case WritePacketStage::SecondClientHello: {
+            // The HelloRetryRequest is part of the transcript that the binder of the second ClientHello covers as well.
+            if (m_context.tls13.hello_retry_transcript.try_append(buffer.slice(0, payload_size + 1)).is_error()) {
+                auto packet = build_alert(true, (u8)AlertDescription::InternalError);
+                write_packet(packet);
+                return (i8)Error::OutOfMemory;
+            }
+            if (!m_context.tls13.has_sent_change_cipher_spec) {
+                dbgln_if(TLS_DEBUG, "> change cipher spec");
+                auto packet = build_change_cipher_spec();
+                write_packet(packet);
+                m_context.tls13.has_sent_change_cipher_spec = true;
+            }
+            dbgln_if(TLS_DEBUG, "> second client hello");
+            auto packet = build_hello();
+            write_packet(packet);
+            // We're still disconnected as far as write_packet() is concerned, so nothing else sends these out.
+            write_into_socket();
+            break;
+        }
+        case WritePacketStage::HandshakeKeys:
+            if (install_tls13_handshake_keys().is_error()) {
+                auto packet = build_alert(true, (u8)AlertDescription::InternalError);
+                write_packet(packet);
+                return (i8)Error::OutOfMemory;
+            }
+            break;
         case WritePacketStage::Finished:
+            if (is_tls13()) {
+                if (finish_tls13_handshake().is_error()) {
+                    auto packet = build_alert(true, (u8)AlertDescription::InternalError);
+                    write_packet(packet);
+                    return (i8)Error::OutOfMemory;
+                }
+                break;
+            }
             // finished
             {
                 dbgln_if(TLS_DEBUG, "> change cipher spec");
                 auto packet = build_change_cipher_spec();
                 write_packet(packet);
             }
+            m_context.local_sequence_number = 0;
             {
                 dbgln_if(TLS_DEBUG, "> client finished");
                 auto packet = build_handshake_finished();
                 write_packet(packet);
             }
-            m_context.connection_status = ConnectionStatus::Established;
+            did_establish_connection();
             break;
         }
         payload_size++;
@@ -152,6 +152,56 @@ bool TLSv12::compute_master_secret_from_pre_master_secret(size_t length)
     return true;
 }
 
+bool TLSv12::resume_offered_session()
+{
+    // The abbreviated handshake derives new keys from the master secret we already agreed on, and goes straight to the
+    // change cipher spec messages: no certificates, and no key exchange.
+    auto master_key_or_error = ByteBuffer::copy(m_context.offered_session->master_key);
+    if (master_key_or_error.is_error())
+        return false;
+    m_context.master_key = master_key_or_error.release_value();
+
+    dbgln_if(TLS_DEBUG, "Resuming session");
+    if (!expand_key())
+        return false;
+
+    m_context.connection_status = ConnectionStatus::KeyExchange;
+    return true;
+}
+
+void TLSv12::remember_session()
+{
+    auto& session_cache = m_context.options.session_cache;
+    if (!session_cache || m_context.extensions.SNI.is_null() || m_context.master_key.is_empty())
+        return;
+
+    CachedSession session;
+    session.cipher = m_context.cipher;
+    session.expiry = Time::now_monotonic_coarse() + SessionCache::maximum_lifetime;
+    if (!m_context.session_ticket.is_empty()) {
+        session.ticket = move(m_context.session_ticket);
+        session.expiry = Time::now_monotonic_coarse() + m_context.session_ticket_lifetime;
+    } else if (m_context.is_resuming_session) {
+        // A resumed session keeps its master secret, so it can be resumed again just like before.
+        session.ticket = m_context.offered_session->ticket;
+        session.expiry = m_context.offered_session->expiry;
+    }
+
+    auto session_id_or_error = ByteBuffer::copy(m_context.session_id, m_context.session_id_size);
+    auto master_key_or_error = ByteBuffer::copy(m_context.master_key);
+    if (session_id_or_error.is_error() || master_key_or_error.is_error())
+        return;
+    session.session_id = session_id_or_error.release_value();
+    session.master_key = master_key_or_error.release_value();
+
+    if (session.session_id.is_empty() && session.ticket.is_empty()) {
+        // The server doesn't do resumption, at least not anymore.
+        session_cache->remove(m_context.extensions.SNI);
+        return;
+    }
+    session_cache->set(m_context.extensions.SNI, move(session));
+}
+
 void TLSv12::build_rsa_pre_master_secret(PacketBuilder& builder)
 {
     u8 random_bytes[48];
@@ -21,6 +21,28 @@
 
 namespace TLS {
 
+// RFC 7301 section 3.1: The server answers with exactly one of the protocols that we offered.
+ssize_t TLSv12::handle_alpn_extension(ReadonlyBytes extension)
+{
+    if (extension.size() < 3)
+        return (i8)Error::BrokenPacket;
+    auto list_length = AK::convert_between_host_and_network_endian(ByteReader::load16(extension.data()));
+    size_t name_length = extension[2];
+    if (list_length != extension.size() - 2 || name_length == 0 || name_length != list_length - 1u)
+        return (i8)Error::BrokenPacket;
+
+    StringView name { extension.offset(3), name_length };
+    auto it = m_context.alpn.find_if([&](auto& protocol) { return protocol == name; });
+    if (it.is_end()) {
+        dbgln("Server picked an application protocol that we didn't offer: {}", name);
+        return (i8)Error::IllegalParameter;
+    }
+    // This points into our own list of protocols, which outlives the connection state.
+    m_context.negotiated_alpn = *it;
+    dbgln_if(TLS_DEBUG, "negotiated alpn: {}", name);
+    return 0;
+}
+
 ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& write_packets)
 {
     write_packets = WritePacketStage::Initial;
@@ -49,7 +71,8 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
     auto version = static_cast<Version>(AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res))));
 
     res += 2;
-    if (!supports_version(version))
+    // RFC 8446 section 4.1.3: TLS 1.3 keeps saying 1.2 here, and puts the real version in the supported_versions extension.
+    if (version != Version::V12)
         return (i8)Error::NotSafe;
 
     memcpy(m_context.remote_random, buffer.offset_pointer(res), sizeof(m_context.remote_random));
@@ -61,16 +84,8 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         return (i8)Error::NeedMoreData;
     }
 
-    if (session_length && session_length <= 32) {
-        memcpy(m_context.session_id, buffer.offset_pointer(res), session_length);
-        m_context.session_id_size = session_length;
-        if constexpr (TLS_DEBUG) {
-            dbgln("Remote session ID:");
-            print_buffer(ReadonlyBytes { m_context.session_id, session_length });
-        }
-    } else {
-        m_context.session_id_size = 0;
-    }
+    auto session_id = buffer.slice(res, session_length);
+    bool echoes_session_id = session_length == m_context.session_id_size && memcmp(m_context.session_id, session_id.data(), session_length) == 0;
     res += session_length;
 
     if (buffer.size() - res < 2) {
@@ -84,12 +99,8 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         dbgln("No supported cipher could be agreed upon");
         return (i8)Error::NoCommonCipher;
     }
-    m_context.cipher = cipher;
     dbgln_if(TLS_DEBUG, "Cipher: {}", (u16)cipher);
 
-    // Simplification: We only support handshake hash functions via HMAC
-    m_context.handshake_hash.initialize(hmac_hash());
-
     // Compression method
     if (buffer.size() - res < 1)
         return (i8)Error::NeedMoreData;
@@ -97,19 +108,22 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
     if (compression != 0)
         return (i8)Error::CompressionNotSupported;
 
-    if (m_context.connection_status != ConnectionStatus::Renegotiating)
-        m_context.connection_status = ConnectionStatus::Negotiating;
     if (m_context.is_server) {
         dbgln("unsupported: server mode");
         write_packets = WritePacketStage::ServerHandshake;
     }
 
     // Presence of extensions is determined by availability of bytes after compression_method
+    ReadonlyBytes extensions;
     if (buffer.size() - res >= 2) {
-        auto extensions_bytes_total = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res += 2)));
+        auto extensions_bytes_total = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
+        res += 2;
         dbgln_if(TLS_DEBUG, "Extensions bytes total: {}", extensions_bytes_total);
+        extensions = buffer.slice(res, min<size_t>(extensions_bytes_total, buffer.size() - res));
     }
 
+    auto selected_version = Version::V12;
+
     while (buffer.size() - res >= 4) {
         auto extension_type = (HandshakeExtension)AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
         res += 2;
@@ -150,33 +164,24 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
                 dbgln("SNI host_name: {}", m_context.extensions.SNI);
             }
         } else if (extension_type == HandshakeExtension::ApplicationLayerProtocolNegotiation && m_context.alpn.size()) {
-            if (buffer.size() - res > 2) {
-                auto alpn_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
-                if (alpn_length && alpn_length <= extension_length - 2) {
-                    u8 const* alpn = buffer.offset_pointer(res + 2);
-                    size_t alpn_position = 0;
-                    while (alpn_position < alpn_length) {
-                        u8 alpn_size = alpn[alpn_position++];
-                        if (alpn_size + alpn_position >= extension_length)
-                            break;
-                        DeprecatedString alpn_str { (char const*)alpn + alpn_position, alpn_length };
-                        if (alpn_size && m_context.alpn.contains_slow(alpn_str)) {
-                            m_context.negotiated_alpn = alpn_str;
-                            dbgln("negotiated alpn: {}", alpn_str);
-                            break;
-                        }
-                        alpn_position += alpn_length;
-                        if (!m_context.is_server) // server hello must contain one ALPN
-                            break;
-                    }
-                }
-            }
+            if (auto result = handle_alpn_extension(buffer.slice(res, extension_length)); result < 0)
+                return result;
             res += extension_length;
         } else if (extension_type == HandshakeExtension::SignatureAlgorithms) {
             dbgln("supported signatures: ");
             print_buffer(buffer.slice(res, extension_length));
             res += extension_length;
             // FIXME: what are we supposed to do here?
+        } else if (extension_type == HandshakeExtension::SupportedVersions) {
+            if (extension_length != 2)
+                return (i8)Error::BrokenPacket;
+            selected_version = static_cast<Version>(AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res))));
+            if (!supports_version(selected_version) || !offers_tls13())
+                return (i8)Error::IllegalParameter;
+            res += extension_length;
+        } else if (extension_type == HandshakeExtension::KeyShare || extension_type == HandshakeExtension::PreSharedKey || extension_type == HandshakeExtension::Cookie) {
+            // These only exist in TLS 1.3, which handles them once it knows that this is what we're doing.
+            res += extension_length;
         } else if (extension_type == HandshakeExtension::ECPointFormats) {
             // RFC8422 section 5.2: A server that selects an ECC cipher suite in response to a ClientHello message
             // including a Supported Point Formats Extension appends this extension (along with others) to its
@@ -193,6 +198,61 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         }
     }
 
+    if (selected_version == Version::V13) {
+        if (get_key_exchange_algorithm(cipher) != KeyExchangeAlgorithm::KeyShare)
+            return (i8)Error::IllegalParameter;
+        m_context.negotiated_version = Version::V13;
+
+        // RFC 8446 section 4.1.3: The legacy session ID is only ever echoed back.
+        if (!echoes_session_id)
+            return (i8)Error::IllegalParameter;
+
+        auto result = handle_tls13_server_hello(cipher, extensions, write_packets);
+        return result < 0 ? result : res;
+    }
+
+    if (get_key_exchange_algorithm(cipher) == KeyExchangeAlgorithm::KeyShare)
+        return (i8)Error::IllegalParameter;
+
+    // RFC 8446 section 4.1.3: A TLS 1.3 server that was made to pick TLS 1.2 says so in the last bytes of its random.
+    constexpr u8 downgrade_sentinel[8] { 'D', 'O', 'W', 'N', 'G', 'R', 'D', 1 };
+    if (offers_tls13() && memcmp(m_context.remote_random + 24, downgrade_sentinel, sizeof(downgrade_sentinel)) == 0) {
+        dbgln("Server hello claims that we got downgraded from TLS 1.3");
+        return (i8)Error::IllegalParameter;
+    }
+
+    // The server agrees to resume the session we offered by echoing its session ID.
+    m_context.is_resuming_session = m_context.offered_session.has_value()
+        && m_context.offered_session->version == Version::V12
+        && session_length != 0
+        && echoes_session_id;
+
+    if (session_length && session_length <= 32) {
+        memcpy(m_context.session_id, session_id.data(), session_length);
+        m_context.session_id_size = session_length;
+        if constexpr (TLS_DEBUG) {
+            dbgln("Remote session ID:");
+            print_buffer(ReadonlyBytes { m_context.session_id, session_length });
+        }
+    } else {
+        m_context.session_id_size = 0;
+    }
+
+    if (m_context.is_resuming_session && cipher != m_context.offered_session->cipher) {
+        dbgln("Server resumed a session with a different cipher suite");
+        return (i8)Error::NotSafe;
+    }
+    m_context.cipher = cipher;
+
+    // Simplification: We only support handshake hash functions via HMAC
+    m_context.handshake_hash.initialize(hmac_hash());
+
+    if (m_context.connection_status != ConnectionStatus::Renegotiating)
+        m_context.connection_status = ConnectionStatus::Negotiating;
+
+    if (m_context.is_resuming_session && !resume_offered_session())
+        return (i8)Error::OutOfMemory;
+
     return res;
 }
 
@@ -345,18 +405,39 @@ ssize_t TLSv12::handle_ecdhe_rsa_server_key_exchange(ReadonlyBytes buffer)
 
 ssize_t TLSv12::verify_rsa_server_key_exchange(ReadonlyBytes server_key_info_buffer, ReadonlyBytes signature_buffer)
 {
-    auto signature_hash = signature_buffer[0];
-    auto signature_algorithm = signature_buffer[1];
-    if (signature_algorithm != (u8)SignatureAlgorithm::RSA) {
-        dbgln("verify_rsa_server_key_exchange failed: Signature algorithm is not RSA, instead {}", signature_algorithm);
-        return (i8)Error::NotUnderstood;
-    }
-
+    if (signature_buffer.size() < 4)
+        return (i8)Error::NeedMoreData;
+    SignatureAndHashAlgorithm algorithm { (HashAlgorithm)signature_buffer[0], (SignatureAlgorithm)signature_buffer[1] };
     auto signature_length = AK::convert_between_host_and_network_endian(ByteReader::load16(signature_buffer.offset_pointer(2)));
+    if (signature_buffer.size() - 4 < signature_length)
+        return (i8)Error::NeedMoreData;
     auto signature = signature_buffer.slice(4, signature_length);
 
+    auto message_result = ByteBuffer::create_uninitialized(64 + server_key_info_buffer.size());
+    if (message_result.is_error()) {
+        dbgln("verify_rsa_server_key_exchange failed: Not enough memory");
+        return (i8)Error::OutOfMemory;
+    }
+    auto message = message_result.release_value();
+    message.overwrite(0, m_context.local_random, 32);
+    message.overwrite(32, m_context.remote_random, 32);
+    message.overwrite(64, server_key_info_buffer.data(), server_key_info_buffer.size());
+
+    return verify_rsa_signature(algorithm, message, signature);
+}
+
+template<typename HashFunction>
+static Crypto::VerificationConsistency verify_pss(ReadonlyBytes message, ReadonlyBytes encoded_message, size_t em_bits)
+{
+    // RFC 8446 section 4.2.3: The salt is as long as the digest.
+    Crypto::PK::EMSA_PSS<HashFunction, HashFunction::DigestSize> pss;
+    return pss.verify(message, encoded_message, em_bits);
+}
+
+ssize_t TLSv12::verify_rsa_signature(SignatureAndHashAlgorithm algorithm, ReadonlyBytes message, ReadonlyBytes signature)
+{
     if (m_context.certificates.is_empty()) {
-        dbgln("verify_rsa_server_key_exchange failed: Attempting to verify signature without certificates");
+        dbgln("verify_rsa_signature failed: Attempting to verify signature without certificates");
         return (i8)Error::NotSafe;
     }
     // RFC5246 section 7.4.2: The sender's certificate MUST come first in the list.
@@ -364,49 +445,62 @@ ssize_t TLSv12::verify_rsa_server_key_exchange(ReadonlyBytes server_key_info_buf
     Crypto::PK::RSAPrivateKey dummy_private_key;
     auto rsa = Crypto::PK::RSA(certificate_public_key, dummy_private_key);
 
-    auto signature_verify_buffer_result = ByteBuffer::create_uninitialized(signature_length);
+    auto signature_verify_buffer_result = ByteBuffer::create_uninitialized(signature.size());
     if (signature_verify_buffer_result.is_error()) {
-        dbgln("verify_rsa_server_key_exchange failed: Not enough memory");
+        dbgln("verify_rsa_signature failed: Not enough memory");
         return (i8)Error::OutOfMemory;
     }
     auto signature_verify_buffer = signature_verify_buffer_result.release_value();
     auto signature_verify_bytes = signature_verify_buffer.bytes();
     rsa.verify(signature, signature_verify_bytes);
 
-    auto message_result = ByteBuffer::create_uninitialized(64 + server_key_info_buffer.size());
-    if (message_result.is_error()) {
-        dbgln("verify_rsa_server_key_exchange failed: Not enough memory");
-        return (i8)Error::OutOfMemory;
-    }
-    auto message = message_result.release_value();
-    message.overwrite(0, m_context.local_random, 32);
-    message.overwrite(32, m_context.remote_random, 32);
-    message.overwrite(64, server_key_info_buffer.data(), server_key_info_buffer.size());
+    Crypto::VerificationConsistency verification;
+    if (algorithm.signature == SignatureAlgorithm::RSA) {
+        Crypto::Hash::HashKind hash_kind;
+        switch (algorithm.hash) {
+        case HashAlgorithm::SHA1:
+            hash_kind = Crypto::Hash::HashKind::SHA1;
+            break;
+        case HashAlgorithm::SHA256:
+            hash_kind = Crypto::Hash::HashKind::SHA256;
+            break;
+        case HashAlgorithm::SHA384:
+            hash_kind = Crypto::Hash::HashKind::SHA384;
+            break;
+        case HashAlgorithm::SHA512:
+            hash_kind = Crypto::Hash::HashKind::SHA512;
+            break;
+        default:
+            dbgln("verify_rsa_signature failed: Hash algorithm is not SHA1/256/384/512, instead {}", (u8)algorithm.hash);
+            return (i8)Error::NotUnderstood;
+        }
 
-    Crypto::Hash::HashKind hash_kind;
-    switch ((HashAlgorithm)signature_hash) {
-    case HashAlgorithm::SHA1:
-        hash_kind = Crypto::Hash::HashKind::SHA1;
-        break;
-    case HashAlgorithm::SHA256:
-        hash_kind = Crypto::Hash::HashKind::SHA256;
-        break;
-    case HashAlgorithm::SHA384:
-        hash_kind = Crypto::Hash::HashKind::SHA384;
-        break;
-    case HashAlgorithm::SHA512:
-        hash_kind = Crypto::Hash::HashKind::SHA512;
-        break;
-    default:
-        dbgln("verify_rsa_server_key_exchange failed: Hash algorithm is not SHA1/256/384/512, instead {}", signature_hash);
+        auto pkcs1 = Crypto::PK::EMSA_PKCS1_V1_5<Crypto::Hash::Manager>(hash_kind);
+        verification = pkcs1.verify(message, signature_verify_bytes, signature.size() * 8);
+    } else if (algorithm.hash == HashAlgorithm::INTRINSIC) {
+        // RFC 8017 section 8.1.2: The encoded message is one bit shorter than the modulus.
+        auto em_bits = certificate_public_key.modulus().one_based_index_of_highest_set_bit() - 1;
+        switch (algorithm.signature) {
+        case SignatureAlgorithm::RSA_PSS_RSAE_SHA256:
+            verification = verify_pss<Crypto::Hash::SHA256>(message, signature_verify_bytes, em_bits);
+            break;
+        case SignatureAlgorithm::RSA_PSS_RSAE_SHA384:
+            verification = verify_pss<Crypto::Hash::SHA384>(message, signature_verify_bytes, em_bits);
+            break;
+        case SignatureAlgorithm::RSA_PSS_RSAE_SHA512:
+            verification = verify_pss<Crypto::Hash::SHA512>(message, signature_verify_bytes, em_bits);
+            break;
+        default:
+            dbgln("verify_rsa_signature failed: Signature scheme is not RSA-PSS, instead {}", (u8)algorithm.signature);
+            return (i8)Error::NotUnderstood;
+        }
+    } else {
+        dbgln("verify_rsa_signature failed: Signature algorithm is not RSA, instead {}", (u8)algorithm.signature);
         return (i8)Error::NotUnderstood;
     }
 
-    auto pkcs1 = Crypto::PK::EMSA_PKCS1_V1_5<Crypto::Hash::Manager>(hash_kind);
-    auto verification = pkcs1.verify(message, signature_verify_bytes, signature_length * 8);
-
     if (verification == Crypto::VerificationConsistency::Inconsistent) {
-        dbgln("verify_rsa_server_key_exchange failed: Verification of signature inconsistent");
+        dbgln("verify_rsa_signature failed: Verification of signature inconsistent");
         return (i8)Error::NotSafe;
     }
 
@@ -0,0 +1,923 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Endian.h>
+#include <AK/Memory.h>
+#include <LibCrypto/Curves/SECP256r1.h>
+#include <LibCrypto/Curves/X25519.h>
+#include <LibCrypto/Curves/X448.h>
+#include <LibCrypto/Hash/HKDF.h>
+#include <LibTLS/TLSv12.h>
+
+namespace TLS {
+
+// RFC 8446 section 4.1.3: A HelloRetryRequest is a ServerHello with this random, SHA-256("HelloRetryRequest").
+static constexpr u8 hello_retry_request_random[32] {
+    0xcf, 0x21, 0xad, 0x74, 0xe5, 0x9a, 0x61, 0x11, 0xbe, 0x1d, 0x8c, 0x02, 0x1e, 0x65, 0xb8, 0x91,
+    0xc2, 0xa2, 0x11, 0x16, 0x7a, 0xbb, 0x8c, 0x5e, 0x07, 0x9e, 0x09, 0xe2, 0xc8, 0xa8, 0x33, 0x9c
+};
+
+// RFC 8446 section 4.2.9
+static constexpr u8 psk_dhe_ke = 1;
+
+static Crypto::Hash::HashKind hash_kind_for_cipher(CipherSuite suite)
+{
+    switch (suite) {
+    case CipherSuite::AES_256_GCM_SHA384:
+        return Crypto::Hash::HashKind::SHA384;
+    case CipherSuite::AES_128_GCM_SHA256:
+    default:
+        return Crypto::Hash::HashKind::SHA256;
+    }
+}
+
+static size_t hash_length(Crypto::Hash::HashKind kind)
+{
+    return Crypto::Hash::Manager { kind }.digest_size();
+}
+
+static ErrorOr<ByteBuffer> hash_of(Crypto::Hash::HashKind kind, ReadonlyBytes prefix, ReadonlyBytes message)
+{
+    Crypto::Hash::Manager hash { kind };
+    hash.update(prefix);
+    hash.update(message);
+    auto digest = hash.digest();
+    return ByteBuffer::copy(digest.immutable_data(), digest.data_length());
+}
+
+// RFC 8446 section 7.1: HKDF-Expand-Label(Secret, Label, Context, Length)
+static ErrorOr<ByteBuffer> hkdf_expand_label(Crypto::Hash::HashKind kind, ReadonlyBytes secret, StringView label, ReadonlyBytes context, size_t length)
+{
+    constexpr auto label_prefix = "tls13 "sv;
+    ByteBuffer hkdf_label;
+    TRY(hkdf_label.try_append((u8)(length >> 8)));
+    TRY(hkdf_label.try_append((u8)length));
+    TRY(hkdf_label.try_append((u8)(label_prefix.length() + label.length())));
+    TRY(hkdf_label.try_append(label_prefix.bytes()));
+    TRY(hkdf_label.try_append(label.bytes()));
+    TRY(hkdf_label.try_append((u8)context.size()));
+    TRY(hkdf_label.try_append(context));
+    return Crypto::Hash::HKDF<Crypto::Hash::Manager>::expand(secret, hkdf_label, length, kind);
+}
+
+// RFC 8446 section 7.1: Derive-Secret(Secret, Label, Messages), with the transcript hash of the messages already taken.
+static ErrorOr<ByteBuffer> derive_secret(Crypto::Hash::HashKind kind, ReadonlyBytes secret, StringView label, ReadonlyBytes transcript_hash)
+{
+    return hkdf_expand_label(kind, secret, label, transcript_hash, hash_length(kind));
+}
+
+static ErrorOr<ByteBuffer> derive_secret_without_messages(Crypto::Hash::HashKind kind, ReadonlyBytes secret, StringView label)
+{
+    auto empty_hash = TRY(hash_of(kind, {}, {}));
+    return derive_secret(kind, secret, label, empty_hash);
+}
+
+static ErrorOr<ByteBuffer> zeros(size_t length)
+{
+    return ByteBuffer::create_zeroed(length);
+}
+
+static OwnPtr<Crypto::Curves::EllipticCurve> make_curve(NamedCurve group)
+{
+    switch (group) {
+    case NamedCurve::x25519:
+        return make<Crypto::Curves::X25519>();
+    case NamedCurve::x448:
+        return make<Crypto::Curves::X448>();
+    case NamedCurve::secp256r1:
+        return make<Crypto::Curves::SECP256r1>();
+    default:
+        return nullptr;
+    }
+}
+
+// Calls the callback with the type and data of each extension in a list laid out like in RFC 8446 section 4.2.
+template<typename Callback>
+static ssize_t for_each_extension(ReadonlyBytes extensions, Callback callback)
+{
+    while (!extensions.is_empty()) {
+        if (extensions.size() < 4)
+            return (i8)Error::BrokenPacket;
+        auto type = (HandshakeExtension)AK::convert_between_host_and_network_endian(ByteReader::load16(extensions.data()));
+        u16 length = AK::convert_between_host_and_network_endian(ByteReader::load16(extensions.offset_pointer(2)));
+        if (extensions.size() - 4 < length)
+            return (i8)Error::BrokenPacket;
+
+        dbgln_if(TLS_DEBUG, "Extension {} with length {}", (u16)type, length);
+        ssize_t result = callback(type, extensions.slice(4, length));
+        if (result < 0)
+            return result;
+        extensions = extensions.slice(4 + length);
+    }
+    return 0;
+}
+
+// Reads the u24 length in front of a handshake message body, and returns the body.
+static Optional<ReadonlyBytes> handshake_message_body(ReadonlyBytes buffer)
+{
+    if (buffer.size() < 3)
+        return {};
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+    if (buffer.size() - 3 < size)
+        return {};
+    return buffer.slice(3, size);
+}
+
+static void append_u16(ByteBuffer& buffer, u16 value)
+{
+    buffer.append((u8)(value >> 8));
+    buffer.append((u8)value);
+}
+
+bool TLSv12::offers_tls13() const
+{
+    if (m_context.options.max_version < Version::V13 || m_context.options.elliptic_curves.is_empty())
+        return false;
+    return any_of(m_context.options.usable_cipher_suites, [](auto suite) { return get_key_exchange_algorithm(suite) == KeyExchangeAlgorithm::KeyShare; });
+}
+
+ErrorOr<ByteBuffer> TLSv12::build_tls13_hello_extensions()
+{
+    ByteBuffer extensions;
+    if (!offers_tls13())
+        return extensions;
+
+    bool is_second_client_hello = m_context.tls13.has_received_hello_retry_request;
+
+    // supported_versions
+    append_u16(extensions, (u16)HandshakeExtension::SupportedVersions);
+    append_u16(extensions, 5);
+    extensions.append((u8)4);
+    append_u16(extensions, (u16)Version::V13);
+    append_u16(extensions, (u16)Version::V12);
+
+    // key_share: We only send one, and the server asks for another with a HelloRetryRequest if it doesn't like it.
+    if (!is_second_client_hello)
+        m_context.tls13.key_share_group = m_context.options.elliptic_curves.first();
+    m_context.server_key_exchange_curve = make_curve(m_context.tls13.key_share_group);
+    if (!m_context.server_key_exchange_curve)
+        return AK::Error::from_string_literal("Unsupported key share group");
+    m_context.tls13.key_share_private_key = TRY(m_context.server_key_exchange_curve->generate_private_key());
+    auto public_key = TRY(m_context.server_key_exchange_curve->generate_public_key(m_context.tls13.key_share_private_key));
+    append_u16(extensions, (u16)HandshakeExtension::KeyShare);
+    append_u16(extensions, 2 + 4 + public_key.size());
+    append_u16(extensions, 4 + public_key.size());
+    append_u16(extensions, (u16)m_context.tls13.key_share_group);
+    append_u16(extensions, public_key.size());
+    TRY(extensions.try_append(public_key));
+
+    if (!m_context.tls13.cookie.is_empty()) {
+        append_u16(extensions, (u16)HandshakeExtension::Cookie);
+        append_u16(extensions, 2 + m_context.tls13.cookie.size());
+        append_u16(extensions, m_context.tls13.cookie.size());
+        TRY(extensions.try_append(m_context.tls13.cookie));
+    }
+
+    if (!m_context.options.session_cache)
+        return extensions;
+
+    // psk_key_exchange_modes: Without it, the server can't hand out tickets to resume the session with.
+    append_u16(extensions, (u16)HandshakeExtension::PSKKeyExchangeModes);
+    append_u16(extensions, 2);
+    extensions.append((u8)1);
+    extensions.append(psk_dhe_ke);
+
+    auto& session = m_context.offered_session;
+    if (!session.has_value() || session->version != Version::V13)
+        return extensions;
+
+    // RFC 8446 section 4.1.4: After a HelloRetryRequest, we can only keep offering the session if it uses the hash of the cipher suite the server picked.
+    if (is_second_client_hello && hash_kind_for_cipher(session->cipher) != hash_kind_for_cipher(m_context.cipher)) {
+        session.clear();
+        return extensions;
+    }
+
+    // We don't offer early data again after a HelloRetryRequest, and we don't split it between early data and the rest.
+    auto& early_data = m_context.options.early_data;
+    if (!is_second_client_hello && !early_data.is_empty() && early_data.size() <= session->max_early_data_size) {
+        append_u16(extensions, (u16)HandshakeExtension::EarlyData);
+        append_u16(extensions, 0);
+        m_context.tls13.early_data_status = EarlyDataStatus::Offered;
+    }
+
+    // pre_shared_key has to be the last extension, as the binder covers everything in front of it (RFC 8446 section 4.2.11).
+    auto binder_length = hash_length(hash_kind_for_cipher(session->cipher));
+    u32 ticket_age = (Time::now_monotonic_coarse() - session->issue_time).to_milliseconds();
+    u32 obfuscated_ticket_age = ticket_age + session->ticket_age_add;
+    size_t identities_length = 2 + session->ticket.size() + 4;
+    size_t binders_length = 1 + binder_length;
+
+    append_u16(extensions, (u16)HandshakeExtension::PreSharedKey);
+    append_u16(extensions, 2 + identities_length + 2 + binders_length);
+    append_u16(extensions, identities_length);
+    append_u16(extensions, session->ticket.size());
+    TRY(extensions.try_append(session->ticket));
+    append_u16(extensions, obfuscated_ticket_age >> 16);
+    append_u16(extensions, obfuscated_ticket_age);
+    append_u16(extensions, binders_length);
+    extensions.append((u8)binder_length);
+    TRY(extensions.try_append(TRY(zeros(binder_length))));
+
+    return extensions;
+}
+
+ErrorOr<void> TLSv12::fill_tls13_binder(ByteBuffer& packet)
+{
+    auto& session = m_context.offered_session;
+    if (!session.has_value() || session->version != Version::V13)
+        return {};
+
+    // RFC 8446 section 4.2.11.2: The binder is an HMAC over the transcript up to, but not including, the binders.
+    auto kind = hash_kind_for_cipher(session->cipher);
+    auto binder_length = hash_length(kind);
+    size_t header_size = 5;
+    size_t binders_size = 2 + 1 + binder_length;
+    auto truncated_hello = packet.bytes().slice(header_size, packet.size() - header_size - binders_size);
+    auto transcript_hash = TRY(hash_of(kind, m_context.tls13.hello_retry_transcript, truncated_hello));
+
+    m_context.tls13.early_secret = TRY(Crypto::Hash::HKDF<Crypto::Hash::Manager>::extract({}, session->master_key, kind));
+    auto binder_key = TRY(derive_secret_without_messages(kind, m_context.tls13.early_secret, "res binder"sv));
+    auto finished_key = TRY(hkdf_expand_label(kind, binder_key, "finished"sv, {}, binder_length));
+
+    Crypto::Authentication::HMAC<Crypto::Hash::Manager> hmac(finished_key.bytes(), kind);
+    auto binder = hmac.process(transcript_hash.bytes());
+    packet.overwrite(packet.size() - binder_length, binder.immutable_data(), binder_length);
+
+    if (m_context.tls13.early_data_status == EarlyDataStatus::Offered)
+        m_context.tls13.client_hello = TRY(ByteBuffer::copy(packet.bytes().slice(header_size)));
+    return {};
+}
+
+ErrorOr<void> TLSv12::send_early_data()
+{
+    if (m_context.tls13.early_data_status != EarlyDataStatus::Offered)
+        return {};
+
+    // RFC 8446 section 7.1: client_early_traffic_secret = Derive-Secret(Early Secret, "c e traffic", ClientHello)
+    auto kind = hash_kind_for_cipher(m_context.offered_session->cipher);
+    auto client_hello_hash = TRY(hash_of(kind, {}, m_context.tls13.client_hello));
+    auto client_early_traffic_secret = TRY(derive_secret(kind, m_context.tls13.early_secret, "c e traffic"sv, client_hello_hash));
+    m_context.tls13.client_hello.clear();
+
+    m_context.cipher = m_context.offered_session->cipher;
+    TRY(install_tls13_traffic_keys(client_early_traffic_secret, true));
+
+    auto data = m_context.options.early_data.bytes();
+    for (size_t offset = 0; offset < data.size(); offset += 16 * KiB) {
+        auto chunk = data.slice(offset, min(data.size() - offset, 16 * KiB));
+        PacketBuilder builder { MessageType::ApplicationData, m_context.options.version, chunk.size() };
+        builder.append(chunk);
+        auto packet = builder.build();
+        update_packet(packet);
+        write_packet(packet);
+    }
+    dbgln_if(TLS_DEBUG, "Sent {} bytes of early data", data.size());
+    return {};
+}
+
+ErrorOr<void> TLSv12::install_tls13_traffic_keys(ReadonlyBytes secret, bool local)
+{
+    // RFC 8446 section 7.3
+    auto kind = hash_kind_for_cipher(m_context.cipher);
+    auto key = TRY(hkdf_expand_label(kind, secret, "key"sv, {}, key_length()));
+    auto iv = TRY(hkdf_expand_label(kind, secret, "iv"sv, {}, iv_length()));
+
+    auto intent = local ? Crypto::Cipher::Intent::Encryption : Crypto::Cipher::Intent::Decryption;
+    Crypto::Cipher::AESCipher::GCMMode cipher(key, key.size() * 8, intent, Crypto::Cipher::PaddingMode::RFC5246);
+    if (local) {
+        m_cipher_local = move(cipher);
+        memcpy(m_context.crypto.local_iv, iv.data(), iv.size());
+        m_context.local_sequence_number = 0;
+        m_context.crypto.has_local_tls13_keys = true;
+    } else {
+        m_cipher_remote = move(cipher);
+        memcpy(m_context.crypto.remote_iv, iv.data(), iv.size());
+        m_context.remote_sequence_number = 0;
+        m_context.crypto.has_remote_tls13_keys = true;
+    }
+    return {};
+}
+
+// RFC 8446 section 5.3: The nonce is the IV, with the sequence number XORed into its last eight bytes.
+static void make_tls13_nonce(u8 const* iv, u64 sequence_number, Bytes nonce)
+{
+    memcpy(nonce.data(), iv, 12);
+    for (size_t i = 0; i < 8; ++i)
+        nonce[4 + i] ^= (u8)(sequence_number >> (56 - 8 * i));
+    // Our GCM implementation wants to be given the counter as well.
+    memset(nonce.offset(12), 0, 4);
+}
+
+void TLSv12::protect_tls13_record(ByteBuffer& packet)
+{
+    // RFC 8446 section 5.2: The real content type follows the content, and the record pretends to be application data.
+    constexpr size_t header_size = 5;
+    constexpr size_t tag_size = 16;
+    size_t inner_length = packet.size() - header_size + 1;
+    auto content_type = packet[0];
+
+    // The record is encrypted in place, so it only has to grow by the content type and the tag.
+    if (packet.try_resize(header_size + inner_length + tag_size).is_error()) {
+        dbgln("LibTLS: Failed to allocate enough memory for the ciphertext");
+        VERIFY_NOT_REACHED();
+    }
+    packet[header_size + inner_length - 1] = content_type;
+
+    packet[0] = (u8)MessageType::ApplicationData;
+    ByteReader::store(packet.offset_pointer(1), AK::convert_between_host_and_network_endian((u16)Version::V12));
+    ByteReader::store(packet.offset_pointer(3), AK::convert_between_host_and_network_endian((u16)(inner_length + tag_size)));
+
+    u8 nonce[16];
+    make_tls13_nonce(m_context.crypto.local_iv, m_context.local_sequence_number, { nonce, sizeof(nonce) });
+
+    auto inner = packet.bytes().slice(header_size, inner_length);
+    m_cipher_local.get<Crypto::Cipher::AESCipher::GCMMode>().encrypt(
+        inner,
+        inner,
+        { nonce, sizeof(nonce) },
+        packet.bytes().slice(0, header_size),
+        packet.bytes().slice(header_size + inner_length, tag_size));
+
+    ++m_context.local_sequence_number;
+}
+
+Error TLSv12::unprotect_tls13_record(Bytes record, ReadonlyBytes& plaintext, MessageType& type)
+{
+    constexpr size_t header_size = 5;
+    constexpr size_t tag_size = 16;
+
+    auto fail = [&](AlertDescription alert, Error error) {
+        auto packet = build_alert(true, (u8)alert);
+        write_packet(packet);
+        return error;
+    };
+
+    if (type != MessageType::ApplicationData) {
+        dbgln("TLS 1.3 record of type {} where a protected one was expected", (u8)type);
+        return fail(AlertDescription::UnexpectedMessage, Error::UnexpectedMessage);
+    }
+    if (record.size() < header_size + 1 + tag_size) {
+        dbgln("Invalid packet length");
+        return fail(AlertDescription::DecodeError, Error::BrokenPacket);
+    }
+
+    // The record is decrypted in place, and the plaintext is handed out as a view into it.
+    auto ciphertext = record.slice(header_size, record.size() - header_size - tag_size);
+    auto tag = record.slice(record.size() - tag_size);
+
+    u8 nonce[16];
+    make_tls13_nonce(m_context.crypto.remote_iv, m_context.remote_sequence_number, { nonce, sizeof(nonce) });
+
+    auto consistency = m_cipher_remote.get<Crypto::Cipher::AESCipher::GCMMode>().decrypt(
+        ciphertext,
+        ciphertext,
+        { nonce, sizeof(nonce) },
+        record.slice(0, header_size),
+        tag);
+    if (consistency != Crypto::VerificationConsistency::Consistent) {
+        dbgln("integrity check failed (tag length {})", tag.size());
+        return fail(AlertDescription::BadRecordMAC, Error::IntegrityCheckFailed);
+    }
+    ++m_context.remote_sequence_number;
+
+    // The content type is the last non-zero byte, and everything behind it is padding.
+    size_t length = ciphertext.size();
+    while (length > 0 && ciphertext[length - 1] == 0)
+        --length;
+    if (length == 0) {
+        dbgln("TLS 1.3 record without a content type");
+        return fail(AlertDescription::UnexpectedMessage, Error::UnexpectedMessage);
+    }
+    type = (MessageType)ciphertext[length - 1];
+    plaintext = ciphertext.slice(0, length - 1);
+    return Error::NoError;
+}
+
+ssize_t TLSv12::handle_hello_retry_request(CipherSuite cipher, ReadonlyBytes extensions)
+{
+    if (m_context.tls13.has_received_hello_retry_request) {
+        dbgln("unexpected second hello retry request");
+        return (i8)Error::UnexpectedMessage;
+    }
+    m_context.tls13.has_received_hello_retry_request = true;
+
+    if (!m_context.options.usable_cipher_suites.contains_slow(cipher))
+        return (i8)Error::IllegalParameter;
+    m_context.cipher = cipher;
+
+    bool changes_client_hello = false;
+    auto result = for_each_extension(extensions, [&](HandshakeExtension type, ReadonlyBytes data) -> ssize_t {
+        if (type == HandshakeExtension::KeyShare) {
+            if (data.size() != 2)
+                return (i8)Error::BrokenPacket;
+            auto group = (NamedCurve)AK::convert_between_host_and_network_endian(ByteReader::load16(data.data()));
+            if (group == m_context.tls13.key_share_group || !m_context.options.elliptic_curves.contains_slow(group) || !make_curve(group))
+                return (i8)Error::IllegalParameter;
+            m_context.tls13.key_share_group = group;
+            changes_client_hello = true;
+        } else if (type == HandshakeExtension::Cookie) {
+            if (data.size() < 3)
+                return (i8)Error::BrokenPacket;
+            auto cookie_or_error = ByteBuffer::copy(data.slice(2));
+            if (cookie_or_error.is_error())
+                return (i8)Error::OutOfMemory;
+            m_context.tls13.cookie = cookie_or_error.release_value();
+            changes_client_hello = true;
+        }
+        return 0;
+    });
+    if (result < 0)
+        return result;
+    if (!changes_client_hello)
+        return (i8)Error::IllegalParameter;
+
+    // RFC 8446 section 4.4.1: The first ClientHello is replaced in the transcript by a message_hash message with its hash.
+    m_context.handshake_hash.initialize(hmac_hash());
+    m_context.handshake_hash.update(ReadonlyBytes {});
+    auto client_hello_hash = m_context.handshake_hash.digest();
+    auto digest_size = m_context.handshake_hash.digest_size();
+    u8 message_hash_header[4] { HandshakeType::MessageHash, 0, 0, (u8)digest_size };
+    if (m_context.tls13.hello_retry_transcript.try_append(message_hash_header, sizeof(message_hash_header)).is_error()
+        || m_context.tls13.hello_retry_transcript.try_append(client_hello_hash.immutable_data(), digest_size).is_error())
+        return (i8)Error::OutOfMemory;
+    m_context.handshake_hash.update(m_context.tls13.hello_retry_transcript);
+
+    // The early data went to a server that won't read it.
+    if (m_context.tls13.early_data_status == EarlyDataStatus::Offered) {
+        m_context.tls13.early_data_status = EarlyDataStatus::Rejected;
+        m_cipher_local = Empty {};
+        m_context.crypto.has_local_tls13_keys = false;
+    }
+
+    // The real ServerHello is yet to come.
+    m_context.handshake_messages[2] = 0;
+    return 0;
+}
+
+ssize_t TLSv12::handle_tls13_server_hello(CipherSuite cipher, ReadonlyBytes extensions, WritePacketStage& write_packets)
+{
+    if (memcmp(m_context.remote_random, hello_retry_request_random, sizeof(hello_retry_request_random)) == 0) {
+        dbgln_if(TLS_DEBUG, "hello retry request");
+        auto result = handle_hello_retry_request(cipher, extensions);
+        if (result >= 0)
+            write_packets = WritePacketStage::SecondClientHello;
+        return result;
+    }
+
+    if (!m_context.options.usable_cipher_suites.contains_slow(cipher))
+        return (i8)Error::IllegalParameter;
+    if (m_context.tls13.has_received_hello_retry_request) {
+        // RFC 8446 section 4.1.4: The server can't change its mind about the cipher suite.
+        if (cipher != m_context.cipher)
+            return (i8)Error::IllegalParameter;
+    } else {
+        m_context.cipher = cipher;
+        m_context.handshake_hash.initialize(hmac_hash());
+    }
+
+    bool has_key_share = false;
+    auto result = for_each_extension(extensions, [&](HandshakeExtension type, ReadonlyBytes data) -> ssize_t {
+        if (type == HandshakeExtension::KeyShare) {
+            if (data.size() < 4)
+                return (i8)Error::BrokenPacket;
+            auto group = (NamedCurve)AK::convert_between_host_and_network_endian(ByteReader::load16(data.data()));
+            u16 key_length = AK::convert_between_host_and_network_endian(ByteReader::load16(data.offset_pointer(2)));
+            if (group != m_context.tls13.key_share_group || key_length != data.size() - 4 || key_length != m_context.server_key_exchange_curve->key_size())
+                return (i8)Error::IllegalParameter;
+
+            auto& curve = *m_context.server_key_exchange_curve;
+            auto shared_point = curve.compute_coordinate(m_context.tls13.key_share_private_key, data.slice(4));
+            if (shared_point.is_error())
+                return (i8)Error::IllegalParameter;
+            auto shared_secret = curve.derive_premaster_key(shared_point.release_value());
+            if (shared_secret.is_error())
+                return (i8)Error::IllegalParameter;
+            m_context.premaster_key = shared_secret.release_value();
+            m_context.tls13.key_share_private_key.clear();
+            has_key_share = true;
+        } else if (type == HandshakeExtension::PreSharedKey) {
+            if (data.size() != 2)
+                return (i8)Error::BrokenPacket;
+            // We only ever offer one identity.
+            auto selected_identity = AK::convert_between_host_and_network_endian(ByteReader::load16(data.data()));
+            auto& session = m_context.offered_session;
+            if (selected_identity != 0 || !session.has_value() || session->version != Version::V13 || hash_kind_for_cipher(session->cipher) != hmac_hash())
+                return (i8)Error::IllegalParameter;
+            m_context.is_resuming_session = true;
+        }
+        return 0;
+    });
+    if (result < 0)
+        return result;
+
+    // We only do (EC)DHE, with or without a pre-shared key.
+    if (!has_key_share)
+        return (i8)Error::IllegalParameter;
+
+    if (!m_context.is_resuming_session)
+        m_context.tls13.early_secret.clear();
+    if (m_context.tls13.early_data_status == EarlyDataStatus::Offered && (!m_context.is_resuming_session || m_context.cipher != m_context.offered_session->cipher))
+        m_context.tls13.early_data_status = EarlyDataStatus::Rejected;
+
+    dbgln_if(TLS_DEBUG, "TLS 1.3 server hello, cipher {}, {}", (u16)m_context.cipher, m_context.is_resuming_session ? "resuming" : "full handshake");
+    m_context.connection_status = ConnectionStatus::Negotiating;
+    write_packets = WritePacketStage::HandshakeKeys;
+    return 0;
+}
+
+ErrorOr<void> TLSv12::install_tls13_handshake_keys()
+{
+    // RFC 8446 section 7.1, up to the master secret. The transcript now ends with the ServerHello.
+    auto kind = hmac_hash();
+    auto length = hash_length(kind);
+    auto& state = m_context.tls13;
+
+    if (state.early_secret.is_empty())
+        state.early_secret = TRY(Crypto::Hash::HKDF<Crypto::Hash::Manager>::extract({}, TRY(zeros(length)), kind));
+    auto derived_secret = TRY(derive_secret_without_messages(kind, state.early_secret, "derived"sv));
+    state.handshake_secret = TRY(Crypto::Hash::HKDF<Crypto::Hash::Manager>::extract(derived_secret, m_context.premaster_key, kind));
+    m_context.premaster_key.clear();
+    state.early_secret.clear();
+
+    auto transcript_hash = m_context.handshake_hash.peek();
+    ReadonlyBytes transcript_hash_bytes { transcript_hash.immutable_data(), transcript_hash.data_length() };
+    state.client_handshake_traffic_secret = TRY(derive_secret(kind, state.handshake_secret, "c hs traffic"sv, transcript_hash_bytes));
+    state.server_handshake_traffic_secret = TRY(derive_secret(kind, state.handshake_secret, "s hs traffic"sv, transcript_hash_bytes));
+
+    derived_secret = TRY(derive_secret_without_messages(kind, state.handshake_secret, "derived"sv));
+    state.master_secret = TRY(Crypto::Hash::HKDF<Crypto::Hash::Manager>::extract(derived_secret, TRY(zeros(length)), kind));
+    state.handshake_secret.clear();
+
+    TRY(install_tls13_traffic_keys(state.server_handshake_traffic_secret, false));
+    m_context.cipher_spec_set = 1;
+    // Early data keeps its keys until the server told us whether it takes it.
+    if (state.early_data_status != EarlyDataStatus::Offered)
+        TRY(install_tls13_traffic_keys(state.client_handshake_traffic_secret, true));
+    return {};
+}
+
+ssize_t TLSv12::handle_encrypted_extensions(ReadonlyBytes buffer)
+{
+    auto body = handshake_message_body(buffer);
+    if (!body.has_value() || body->size() < 2)
+        return (i8)Error::BrokenPacket;
+    u16 extensions_length = AK::convert_between_host_and_network_endian(ByteReader::load16(body->data()));
+    if (extensions_length != body->size() - 2)
+        return (i8)Error::BrokenPacket;
+
+    bool accepts_early_data = false;
+    auto result = for_each_extension(body->slice(2), [&](HandshakeExtension type, ReadonlyBytes data) -> ssize_t {
+        if (type == HandshakeExtension::EarlyData)
+            accepts_early_data = true;
+        else if (type == HandshakeExtension::ApplicationLayerProtocolNegotiation && !m_context.alpn.is_empty())
+            return handle_alpn_extension(data);
+        return 0;
+    });
+    if (result < 0)
+        return result;
+
+    auto& status = m_context.tls13.early_data_status;
+    if (accepts_early_data && status != EarlyDataStatus::Offered)
+        return (i8)Error::IllegalParameter;
+    if (status == EarlyDataStatus::Offered && !accepts_early_data) {
+        status = EarlyDataStatus::Rejected;
+        if (install_tls13_traffic_keys(m_context.tls13.client_handshake_traffic_secret, true).is_error())
+            return (i8)Error::OutOfMemory;
+    } else if (accepts_early_data) {
+        status = EarlyDataStatus::Accepted;
+    }
+    dbgln_if(TLS_DEBUG, "encrypted extensions, early data {}", accepts_early_data ? "accepted" : "not accepted");
+    return 3 + body->size();
+}
+
+ssize_t TLSv12::handle_tls13_certificate(ReadonlyBytes buffer)
+{
+    if (m_context.is_resuming_session || m_context.handshake_messages[12] == 0) {
+        dbgln("unexpected certificate message");
+        return (i8)Error::UnexpectedMessage;
+    }
+
+    // RFC 8446 section 4.4.2: A request context, then the certificates, each with its own extensions.
+    auto body = handshake_message_body(buffer);
+    if (!body.has_value() || body->size() < 4 || (*body)[0] != 0)
+        return (i8)Error::BrokenPacket;
+    size_t list_length = (*body)[1] * 0x10000 + (*body)[2] * 0x100 + (*body)[3];
+    auto list = body->slice(4);
+    if (list.size() != list_length)
+        return (i8)Error::BrokenPacket;
+
+    while (!list.is_empty()) {
+        if (list.size() < 3)
+            return (i8)Error::BrokenPacket;
+        size_t certificate_size = list[0] * 0x10000 + list[1] * 0x100 + list[2];
+        if (list.size() - 3 < certificate_size + 2)
+            return (i8)Error::BrokenPacket;
+        auto certificate_data = list.slice(3, certificate_size);
+        u16 extensions_length = AK::convert_between_host_and_network_endian(ByteReader::load16(list.offset_pointer(3 + certificate_size)));
+        if (list.size() - 3 - certificate_size - 2 < extensions_length)
+            return (i8)Error::BrokenPacket;
+        list = list.slice(3 + certificate_size + 2 + extensions_length);
+
+        auto certificate = Certificate::parse_asn1(certificate_data, false);
+        if (!certificate.has_value()) {
+            // Without the server's own certificate, the rest of the chain is of no use.
+            if (m_context.certificates.is_empty())
+                return (i8)Error::UnsupportedCertificate;
+            dbgln("Skipping a certificate in the chain that we can't parse");
+            continue;
+        }
+        m_context.certificates.append(certificate.release_value());
+    }
+
+    if (m_context.certificates.is_empty())
+        return (i8)Error::UnsupportedCertificate;
+    if (!m_context.verify_chain(m_context.extensions.SNI)) {
+        dbgln("certificate verification failed :(");
+        return (i8)Error::BadCertificate;
+    }
+    return 3 + body->size();
+}
+
+ssize_t TLSv12::handle_tls13_certificate_request(ReadonlyBytes buffer)
+{
+    auto body = handshake_message_body(buffer);
+    if (!body.has_value() || body->is_empty() || body->size() < 1u + (*body)[0])
+        return (i8)Error::BrokenPacket;
+    auto context_or_error = ByteBuffer::copy(body->slice(1, (*body)[0]));
+    if (context_or_error.is_error())
+        return (i8)Error::OutOfMemory;
+    m_context.tls13.certificate_request_context = context_or_error.release_value();
+
+    dbgln("certificate request");
+    if (on_tls_certificate_request)
+        on_tls_certificate_request(*this);
+    m_context.client_verified = VerificationNeeded;
+    return 3 + body->size();
+}
+
+ssize_t TLSv12::handle_tls13_certificate_verify(ReadonlyBytes buffer)
+{
+    if (m_context.connection_status != ConnectionStatus::Negotiating || m_context.handshake_messages[4] == 0) {
+        dbgln("unexpected certificate verify message");
+        return (i8)Error::UnexpectedMessage;
+    }
+
+    auto body = handshake_message_body(buffer);
+    if (!body.has_value() || body->size() < 4)
+        return (i8)Error::BrokenPacket;
+    SignatureAndHashAlgorithm algorithm { (HashAlgorithm)(*body)[0], (SignatureAlgorithm)(*body)[1] };
+    u16 signature_length = AK::convert_between_host_and_network_endian(ByteReader::load16(body->offset_pointer(2)));
+    if (signature_length != body->size() - 4)
+        return (i8)Error::BrokenPacket;
+
+    // TLS 1.3 doesn't allow PKCS #1 v1.5 signatures here, and we only have RSA certificates.
+    bool is_offered = any_of(m_context.options.supported_signature_algorithms, [&](auto& offered) {
+        return offered.hash == algorithm.hash && offered.signature == algorithm.signature;
+    });
+    if (!is_offered || algorithm.hash != HashAlgorithm::INTRINSIC) {
+        dbgln("certificate verify with a signature scheme we didn't offer: {:02x}{:02x}", (u8)algorithm.hash, (u8)algorithm.signature);
+        return (i8)Error::IllegalParameter;
+    }
+
+    // RFC 8446 section 4.4.3: 64 spaces, the context string, a zero, and the transcript hash up to the certificate.
+    constexpr auto context_string = "TLS 1.3, server CertificateVerify"sv;
+    auto transcript_hash = m_context.handshake_hash.peek();
+    ByteBuffer content;
+    for (size_t i = 0; i < 64; ++i)
+        content.append(' ');
+    content.append(context_string.bytes());
+    content.append((u8)0);
+    content.append(transcript_hash.immutable_data(), transcript_hash.data_length());
+
+    auto result = verify_rsa_signature(algorithm, content, body->slice(4));
+    if (result < 0)
+        return result;
+    return 3 + body->size();
+}
+
+ErrorOr<ByteBuffer> TLSv12::tls13_finished_verify_data(ReadonlyBytes traffic_secret)
+{
+    // RFC 8446 section 4.4.4
+    auto kind = hmac_hash();
+    auto finished_key = TRY(hkdf_expand_label(kind, traffic_secret, "finished"sv, {}, hash_length(kind)));
+    auto transcript_hash = m_context.handshake_hash.peek();
+    Crypto::Authentication::HMAC<Crypto::Hash::Manager> hmac(finished_key.bytes(), kind);
+    auto verify_data = hmac.process(transcript_hash.immutable_data(), transcript_hash.data_length());
+    return ByteBuffer::copy(verify_data.immutable_data(), verify_data.data_length());
+}
+
+ssize_t TLSv12::handle_tls13_finished(ReadonlyBytes buffer, WritePacketStage& write_packets)
+{
+    write_packets = WritePacketStage::Initial;
+
+    // Unless the pre-shared key tells us who the server is, it has to prove it with its certificate.
+    if (m_context.connection_status != ConnectionStatus::Negotiating || m_context.handshake_messages[12] == 0
+        || (!m_context.is_resuming_session && m_context.handshake_messages[8] == 0)) {
+        dbgln("unexpected finished message");
+        return (i8)Error::UnexpectedMessage;
+    }
+
+    auto body = handshake_message_body(buffer);
+    if (!body.has_value())
+        return (i8)Error::BrokenPacket;
+    auto expected_verify_data = tls13_finished_verify_data(m_context.tls13.server_handshake_traffic_secret);
+    if (expected_verify_data.is_error())
+        return (i8)Error::OutOfMemory;
+    if (body->size() != expected_verify_data.value().size() || !timing_safe_compare(body->data(), expected_verify_data.value().data(), body->size())) {
+        dbgln("server finished message doesn't match the handshake");
+        return (i8)Error::NotSafe;
+    }
+
+    write_packets = WritePacketStage::Finished;
+    return 3 + body->size();
+}
+
+ByteBuffer TLSv12::build_tls13_handshake_message(HandshakeType type, ReadonlyBytes body)
+{
+    PacketBuilder builder { MessageType::Handshake, m_context.options.version, body.size() + 4 };
+    builder.append((u8)type);
+    builder.append_u24(body.size());
+    builder.append(body);
+    auto packet = builder.build();
+    update_packet(packet);
+    return packet;
+}
+
+ByteBuffer TLSv12::build_tls13_certificate()
+{
+    // We don't have a certificate to give, which the server may or may not be fine with (RFC 8446 section 4.4.2.4).
+    auto& context = m_context.tls13.certificate_request_context;
+    PacketBuilder builder { MessageType::Handshake, m_context.options.version };
+    builder.append((u8)HandshakeType::CertificateMessage);
+    builder.append_u24(1 + context.size() + 3);
+    builder.append((u8)context.size());
+    builder.append(context);
+    builder.append_u24(0);
+    auto packet = builder.build();
+    update_packet(packet);
+    return packet;
+}
+
+ErrorOr<void> TLSv12::finish_tls13_handshake()
+{
+    // The transcript now ends with the server's Finished message, which is what the application secrets derive from.
+    auto kind = hmac_hash();
+    auto& state = m_context.tls13;
+    auto transcript_hash = m_context.handshake_hash.peek();
+    ReadonlyBytes transcript_hash_bytes { transcript_hash.immutable_data(), transcript_hash.data_length() };
+    state.client_application_traffic_secret = TRY(derive_secret(kind, state.master_secret, "c ap traffic"sv, transcript_hash_bytes));
+    state.server_application_traffic_secret = TRY(derive_secret(kind, state.master_secret, "s ap traffic"sv, transcript_hash_bytes));
+    TRY(install_tls13_traffic_keys(state.server_application_traffic_secret, false));
+
+    if (state.early_data_status == EarlyDataStatus::Accepted) {
+        dbgln_if(TLS_DEBUG, "> end of early data");
+        auto packet = build_tls13_handshake_message(HandshakeType::EndOfEarlyData, {});
+        write_packet(packet);
+    }
+
+    // RFC 8446 appendix D.4: Middleboxes like to see a change_cipher_spec before the encrypted messages.
+    if (!state.has_sent_change_cipher_spec) {
+        auto packet = build_change_cipher_spec();
+        write_packet(packet);
+        state.has_sent_change_cipher_spec = true;
+    }
+
+    if (state.early_data_status == EarlyDataStatus::Accepted)
+        TRY(install_tls13_traffic_keys(state.client_handshake_traffic_secret, true));
+
+    if (m_context.client_verified == VerificationNeeded) {
+        dbgln_if(TLS_DEBUG, "> Client Certificate");
+        auto packet = build_tls13_certificate();
+        write_packet(packet);
+        m_context.client_verified = Verified;
+    }
+
+    {
+        dbgln_if(TLS_DEBUG, "> client finished");
+        auto verify_data = TRY(tls13_finished_verify_data(state.client_handshake_traffic_secret));
+        auto packet = build_tls13_handshake_message(HandshakeType::Finished, verify_data);
+        write_packet(packet);
+    }
+    TRY(install_tls13_traffic_keys(state.client_application_traffic_secret, true));
+
+    transcript_hash = m_context.handshake_hash.peek();
+    state.resumption_master_secret = TRY(derive_secret(kind, state.master_secret, "res master"sv, { transcript_hash.immutable_data(), transcript_hash.data_length() }));
+
+    state.master_secret.clear();
+    state.client_handshake_traffic_secret.clear();
+    state.server_handshake_traffic_secret.clear();
+    state.hello_retry_transcript.clear();
+    state.cookie.clear();
+
+    did_establish_connection();
+    return {};
+}
+
+ssize_t TLSv12::handle_tls13_new_session_ticket(ReadonlyBytes buffer)
+{
+    if (m_context.connection_status != ConnectionStatus::Established) {
+        dbgln("unexpected new session ticket message");
+        return (i8)Error::UnexpectedMessage;
+    }
+
+    // RFC 8446 section 4.6.1
+    auto body = handshake_message_body(buffer);
+    if (!body.has_value() || body->size() < 9)
+        return (i8)Error::BrokenPacket;
+    u32 lifetime = AK::convert_between_host_and_network_endian(ByteReader::load32(body->data()));
+    u32 ticket_age_add = AK::convert_between_host_and_network_endian(ByteReader::load32(body->offset_pointer(4)));
+    u8 nonce_length = (*body)[8];
+    if (body->size() < 9u + nonce_length + 2)
+        return (i8)Error::BrokenPacket;
+    auto nonce = body->slice(9, nonce_length);
+    size_t offset = 9 + nonce_length;
+    u16 ticket_length = AK::convert_between_host_and_network_endian(ByteReader::load16(body->offset_pointer(offset)));
+    offset += 2;
+    if (ticket_length == 0 || body->size() - offset < ticket_length + 2u)
+        return (i8)Error::BrokenPacket;
+    auto ticket = body->slice(offset, ticket_length);
+    offset += ticket_length;
+    u16 extensions_length = AK::convert_between_host_and_network_endian(ByteReader::load16(body->offset_pointer(offset)));
+    offset += 2;
+    if (body->size() - offset != extensions_length)
+        return (i8)Error::BrokenPacket;
+
+    u32 max_early_data_size = 0;
+    auto result = for_each_extension(body->slice(offset), [&](HandshakeExtension type, ReadonlyBytes data) -> ssize_t {
+        if (type == HandshakeExtension::EarlyData) {
+            if (data.size() != 4)
+                return (i8)Error::BrokenPacket;
+            max_early_data_size = AK::convert_between_host_and_network_endian(ByteReader::load32(data.data()));
+        }
+        return 0;
+    });
+    if (result < 0)
+        return result;
+
+    dbgln_if(TLS_DEBUG, "New session ticket of {} bytes, lifetime {}s, early data up to {} bytes", ticket_length, lifetime, max_early_data_size);
+
+    // A lifetime of zero means that the ticket is no good already.
+    auto& session_cache = m_context.options.session_cache;
+    if (!session_cache || m_context.extensions.SNI.is_null() || lifetime == 0)
+        return 3 + body->size();
+
+    auto kind = hmac_hash();
+    auto pre_shared_key = hkdf_expand_label(kind, m_context.tls13.resumption_master_secret, "resumption"sv, nonce, hash_length(kind));
+    auto ticket_or_error = ByteBuffer::copy(ticket);
+    if (pre_shared_key.is_error() || ticket_or_error.is_error())
+        return (i8)Error::OutOfMemory;
+
+    CachedSession session;
+    session.version = Version::V13;
+    session.ticket = ticket_or_error.release_value();
+    session.cipher = m_context.cipher;
+    session.master_key = pre_shared_key.release_value();
+    session.issue_time = Time::now_monotonic_coarse();
+    session.expiry = session.issue_time + min(Time::from_seconds(lifetime), SessionCache::maximum_lifetime);
+    session.ticket_age_add = ticket_age_add;
+    session.max_early_data_size = max_early_data_size;
+    session_cache->set(m_context.extensions.SNI, move(session));
+
+    return 3 + body->size();
+}
+
+ssize_t TLSv12::handle_key_update(ReadonlyBytes buffer)
+{
+    if (m_context.connection_status != ConnectionStatus::Established) {
+        dbgln("unexpected key update message");
+        return (i8)Error::UnexpectedMessage;
+    }
+
+    // RFC 8446 section 4.6.3
+    auto body = handshake_message_body(buffer);
+    if (!body.has_value() || body->size() != 1)
+        return (i8)Error::BrokenPacket;
+    auto request_update = (*body)[0];
+    if (request_update > 1)
+        return (i8)Error::IllegalParameter;
+
+    auto kind = hmac_hash();
+    auto update_secret = [&](ByteBuffer& secret, bool local) -> ErrorOr<void> {
+        secret = TRY(hkdf_expand_label(kind, secret, "traffic upd"sv, {}, hash_length(kind)));
+        return install_tls13_traffic_keys(secret, local);
+    };
+
+    if (update_secret(m_context.tls13.server_application_traffic_secret, false).is_error())
+        return (i8)Error::OutOfMemory;
+
+    if (request_update == 1) {
+        dbgln_if(TLS_DEBUG, "> key update");
+        u8 update_not_requested = 0;
+        auto packet = build_tls13_handshake_message(HandshakeType::KeyUpdate, { &update_not_requested, 1 });
+        write_packet(packet);
+        if (update_secret(m_context.tls13.client_application_traffic_secret, true).is_error())
+            return (i8)Error::OutOfMemory;
+    }
+    return 3 + body->size();
+}
+
+}
@@ -64,11 +64,30 @@ void TLSv12::write_packet(ByteBuffer& packet)
     schedule_or_perform_flush(false);
 }
 
+void TLSv12::seal_pending_application_data()
+{
+    if (m_context.pending_application_data.is_empty())
+        return;
+
+    auto packet = move(m_context.pending_application_data);
+    update_packet(packet);
+    // This only happens right before another record is queued or the queue is flushed, so there is nothing to schedule.
+    if (m_context.tls_buffer.try_append(packet.data(), packet.size()).is_error())
+        dbgln("LibTLS: Failed to queue {} bytes of application data", packet.size());
+}
+
 void TLSv12::update_packet(ByteBuffer& packet)
 {
+    // Any application data that write() is still collecting was written before this record, so it has to go out first.
+    seal_pending_application_data();
+
     u32 header_size = 5;
     ByteReader::store(packet.offset_pointer(3), AK::convert_between_host_and_network_endian((u16)(packet.size() - header_size)));
 
+    // RFC 8446 section 5: A change_cipher_spec record is never protected, and doesn't count towards the sequence number.
+    if (packet[0] == (u8)MessageType::ChangeCipher && m_context.crypto.has_local_tls13_keys)
+        return;
+
     if (packet[0] != (u8)MessageType::ChangeCipher) {
         if (packet[0] == (u8)MessageType::Handshake && packet.size() > header_size) {
             u8 handshake_type = packet[header_size];
@@ -76,6 +95,10 @@ void TLSv12::update_packet(ByteBuffer& packet)
                 update_hash(packet.bytes(), header_size);
             }
         }
+        if (m_context.crypto.has_local_tls13_keys) {
+            protect_tls13_record(packet);
+            return;
+        }
         if (m_context.cipher_spec_set && m_context.crypto.created) {
             size_t length = packet.size() - header_size;
             size_t block_size = 0;
@@ -103,20 +126,8 @@ void TLSv12::update_packet(ByteBuffer& packet)
                 });
 
             if (m_context.crypto.created == 1) {
-                // `buffer' will continue to be encrypted
-                auto buffer_result = ByteBuffer::create_uninitialized(length);
-                if (buffer_result.is_error()) {
-                    dbgln("LibTLS: Failed to allocate enough memory");
-                    VERIFY_NOT_REACHED();
-                }
-                auto buffer = buffer_result.release_value();
-                size_t buffer_position = 0;
                 auto iv_size = iv_length();
 
-                // copy the packet, sans the header
-                buffer.overwrite(buffer_position, packet.offset_pointer(header_size), packet.size() - header_size);
-                buffer_position += packet.size() - header_size;
-
                 ByteBuffer ct;
 
                 m_cipher_local.visit(
@@ -188,6 +199,19 @@ void TLSv12::update_packet(ByteBuffer& packet)
                         // copy the header over
                         ct.overwrite(0, packet.data(), header_size - 2);
 
+                        // `buffer' will continue to be encrypted (GCM encrypts straight out of the packet instead)
+                        auto buffer_result = ByteBuffer::create_uninitialized(length);
+                        if (buffer_result.is_error()) {
+                            dbgln("LibTLS: Failed to allocate enough memory");
+                            VERIFY_NOT_REACHED();
+                        }
+                        auto buffer = buffer_result.release_value();
+                        size_t buffer_position = 0;
+
+                        // copy the packet, sans the header
+                        buffer.overwrite(buffer_position, packet.offset_pointer(header_size), packet.size() - header_size);
+                        buffer_position += packet.size() - header_size;
+
                         // get the appropriate HMAC value for the entire packet
                         auto mac = hmac_message(packet, {}, mac_size, true);
 
@@ -226,7 +250,7 @@ void TLSv12::update_packet(ByteBuffer& packet)
                 ByteReader::store(ct.offset_pointer(header_size - 2), AK::convert_between_host_and_network_endian(ct_length));
 
                 // replace the packet with the ciphertext
-                packet = ct;
+                packet = move(ct);
             }
         }
     }
@@ -307,7 +331,7 @@ ByteBuffer TLSv12::hmac_message(ReadonlyBytes buf, Optional<ReadonlyBytes> const
     return mac_result.release_value();
 }
 
-ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
+ssize_t TLSv12::handle_message(Bytes buffer)
 {
     auto res { 5ll };
     size_t header_size = res;
@@ -342,11 +366,16 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
     }
 
     dbgln_if(TLS_DEBUG, "message type: {}, length: {}", (u8)type, length);
-    auto plain = buffer.slice(buffer_position, buffer.size() - buffer_position);
+    // AEAD records are decrypted in place, so that `plain' ends up being a view into `buffer'.
+    ReadonlyBytes plain = buffer.slice(buffer_position, buffer.size() - buffer_position);
 
     ByteBuffer decrypted;
 
-    if (m_context.cipher_spec_set && type != MessageType::ChangeCipher) {
+    if (m_context.crypto.has_remote_tls13_keys && type != MessageType::ChangeCipher) {
+        auto return_value = unprotect_tls13_record(buffer.slice(0, header_size + length), plain, type);
+        if (return_value != Error::NoError)
+            return (i8)return_value;
+    } else if (m_context.cipher_spec_set && type != MessageType::ChangeCipher) {
         if constexpr (TLS_DEBUG) {
             dbgln("Encrypted: ");
             print_buffer(buffer.slice(header_size, length));
@@ -366,14 +395,7 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
                 }
 
                 auto packet_length = length - iv_length() - 16;
-                auto payload = plain;
-                auto decrypted_result = ByteBuffer::create_uninitialized(packet_length);
-                if (decrypted_result.is_error()) {
-                    dbgln("Failed to allocate memory for the packet");
-                    return_value = Error::DecryptionFailed;
-                    return;
-                }
-                decrypted = decrypted_result.release_value();
+                auto payload = buffer.slice(buffer_position, length);
 
                 // AEAD AAD (13)
                 // Seq. no (8)
@@ -411,7 +433,7 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
 
                 auto consistency = gcm.decrypt(
                     ciphertext,
-                    decrypted,
+                    ciphertext,
                     iv_bytes,
                     aad_bytes,
                     tag);
@@ -425,7 +447,7 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
                     return;
                 }
 
-                plain = decrypted;
+                plain = ciphertext;
             },
             [&](Crypto::Cipher::AESCipher::CBCMode& cbc) {
                 VERIFY(!is_aead());
@@ -486,7 +508,8 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
             return (i8)return_value;
         }
     }
-    m_context.remote_sequence_number++;
+    if (!m_context.crypto.has_remote_tls13_keys)
+        m_context.remote_sequence_number++;
 
     switch (type) {
     case MessageType::ApplicationData:
@@ -498,7 +521,14 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
         } else {
             dbgln_if(TLS_DEBUG, "application data message of size {}", plain.size());
 
-            if (m_context.application_buffer.try_append(plain.data(), plain.size()).is_error()) {
+            // Drop what has been read already before the buffer grows any further.
+            auto& application_buffer = m_context.application_buffer;
+            if (auto offset = exchange(m_context.application_buffer_offset, 0); offset > 0) {
+                memmove(application_buffer.data(), application_buffer.offset_pointer(offset), application_buffer.size() - offset);
+                application_buffer.resize(application_buffer.size() - offset);
+            }
+
+            if (application_buffer.try_append(plain.data(), plain.size()).is_error()) {
                 payload_res = (i8)Error::DecryptionFailed;
                 auto packet = build_alert(true, (u8)AlertDescription::DecryptionFailed);
                 write_packet(packet);
@@ -510,7 +540,10 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
         payload_res = handle_handshake_payload(plain);
         break;
     case MessageType::ChangeCipher:
-        if (m_context.connection_status != ConnectionStatus::KeyExchange) {
+        if (is_tls13() && m_context.connection_status != ConnectionStatus::Established) {
+            // RFC 8446 section 5: This is only here for middleboxes, and we just drop it.
+            dbgln_if(TLS_DEBUG, "ignoring TLS 1.3 change cipher spec message");
+        } else if (m_context.connection_status != ConnectionStatus::KeyExchange) {
             dbgln("unexpected change cipher message");
             auto packet = build_alert(true, (u8)AlertDescription::UnexpectedMessage);
             write_packet(packet);
@@ -540,7 +573,7 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
 
             if (code == (u8)AlertDescription::CloseNotify) {
                 res += 2;
-                alert(AlertLevel::Critical, AlertDescription::CloseNotify);
+                alert(AlertLevel::Warning, AlertDescription::CloseNotify);
                 if (!m_context.cipher_spec_set) {
                     // AWS CloudFront hits this.
                     dbgln("Server sent a close notify and we haven't agreed on a cipher suite. Treating it as a handshake failure.");
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTLS/SessionCache.h>
+
+namespace TLS {
+
+Optional<CachedSession> SessionCache::get(DeprecatedString const& host)
+{
+    auto it = m_sessions.find(host);
+    if (it == m_sessions.end())
+        return {};
+
+    if (it->value.expiry <= Time::now_monotonic_coarse()) {
+        m_sessions.remove(it);
+        return {};
+    }
+    return it->value;
+}
+
+void SessionCache::set(DeprecatedString const& host, CachedSession session)
+{
+    if (m_sessions.size() >= maximum_session_count && !m_sessions.contains(host)) {
+        // Make room by dropping the session that would have expired first.
+        auto oldest = m_sessions.begin();
+        for (auto it = m_sessions.begin(); it != m_sessions.end(); ++it) {
+            if (it->value.expiry < oldest->value.expiry)
+                oldest = it;
+        }
+        m_sessions.remove(oldest);
+    }
+    m_sessions.set(host, move(session));
+}
+
+void SessionCache::remove(DeprecatedString const& host)
+{
+    m_sessions.remove(host);
+}
+
+}
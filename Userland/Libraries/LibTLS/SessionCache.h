@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/DeprecatedString.h>
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <AK/RefCounted.h>
+#include <AK/Time.h>
+#include <LibTLS/CipherSuite.h>
+#include <LibTLS/TLSPacketBuilder.h>
+
+namespace TLS {
+
+// What a client needs to resume a session with a server in an abbreviated handshake: the session ID or the ticket
+// (RFC 5077) that the server handed out, and the cipher suite and master secret that the full handshake agreed on.
+// A TLS 1.3 session is always resumed with a ticket, and its master_key is the pre-shared key (RFC 8446 section 4.6.1).
+struct CachedSession {
+    Version version { Version::V12 };
+    ByteBuffer session_id;
+    ByteBuffer ticket;
+    CipherSuite cipher { CipherSuite::Invalid };
+    ByteBuffer master_key;
+    Time expiry;
+
+    // Only for TLS 1.3, to tell the server how old the ticket is, and how much early data it takes.
+    Time issue_time;
+    u32 ticket_age_add { 0 };
+    u32 max_early_data_size { 0 };
+};
+
+// Remembers one session per host, so that the next connection to it can skip the certificate chain and the key exchange.
+// Connections share a cache by being given the same one in their Options.
+class SessionCache : public RefCounted<SessionCache> {
+public:
+    static NonnullRefPtr<SessionCache> create() { return adopt_ref(*new SessionCache); }
+
+    Optional<CachedSession> get(DeprecatedString const& host);
+    void set(DeprecatedString const& host, CachedSession);
+    void remove(DeprecatedString const& host);
+
+    // RFC 5246 section F.1.4: "An upper limit of 24 hours is suggested for session ID lifetimes".
+    static constexpr Time maximum_lifetime = Time::from_seconds(24 * 60 * 60);
+
+private:
+    SessionCache() = default;
+
+    static constexpr size_t maximum_session_count = 256;
+
+    HashMap<DeprecatedString, CachedSession> m_sessions;
+};
+
+}
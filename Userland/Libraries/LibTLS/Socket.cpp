@@ -21,24 +21,36 @@ namespace TLS {
 ErrorOr<Bytes> TLSv12::read(Bytes bytes)
 {
     m_eof = false;
-    auto size_to_read = min(bytes.size(), m_context.application_buffer.size());
+    auto data = buffered_application_data();
+    auto size_to_read = min(bytes.size(), data.size());
     if (size_to_read == 0) {
         m_eof = true;
         return Bytes {};
     }
 
-    TRY(m_context.application_buffer.slice(0, size_to_read)).span().copy_to(bytes);
-    m_context.application_buffer = TRY(m_context.application_buffer.slice(size_to_read, m_context.application_buffer.size() - size_to_read));
+    data.trim(size_to_read).copy_to(bytes);
+    discard_application_data(size_to_read);
     return Bytes { bytes.data(), size_to_read };
 }
 
+void TLSv12::discard_application_data(size_t size)
+{
+    VERIFY(size <= buffered_application_data().size());
+    m_context.application_buffer_offset += size;
+    if (m_context.application_buffer_offset == m_context.application_buffer.size()) {
+        m_context.application_buffer.clear();
+        m_context.application_buffer_offset = 0;
+    }
+}
+
 DeprecatedString TLSv12::read_line(size_t max_size)
 {
     if (!can_read_line())
         return {};
 
-    auto* start = m_context.application_buffer.data();
-    auto* newline = (u8*)memchr(m_context.application_buffer.data(), '\n', m_context.application_buffer.size());
+    auto data = buffered_application_data();
+    auto* start = data.data();
+    auto* newline = (u8 const*)memchr(data.data(), '\n', data.size());
     VERIFY(newline);
 
     size_t offset = newline - start;
@@ -47,8 +59,7 @@ DeprecatedString TLSv12::read_line(size_t max_size)
         return {};
 
     DeprecatedString line { bit_cast<char const*>(start), offset, Chomp };
-    // FIXME: Propagate errors.
-    m_context.application_buffer = MUST(m_context.application_buffer.slice(offset + 1, m_context.application_buffer.size() - offset - 1));
+    discard_application_data(offset + 1);
 
     return line;
 }
@@ -60,13 +71,33 @@ ErrorOr<size_t> TLSv12::write(ReadonlyBytes bytes)
         return AK::Error::from_string_literal("TLS write request while not connected");
     }
 
-    for (size_t offset = 0; offset < bytes.size(); offset += MaximumApplicationDataChunkSize) {
-        PacketBuilder builder { MessageType::ApplicationData, m_context.options.version, bytes.size() - offset };
-        builder.append(bytes.slice(offset, min(bytes.size() - offset, MaximumApplicationDataChunkSize)));
-        auto packet = builder.build();
+    // Small writes are collected into one record instead of each paying for a record header, a MAC and a round through the cipher.
+    // Full records go out right away, and whatever is left over is sealed by the next flush (or by the next record that is sent).
+    constexpr size_t header_size = 5;
+    auto& pending = m_context.pending_application_data;
+    for (size_t offset = 0; offset < bytes.size();) {
+        if (pending.is_empty()) {
+            // Leave some room for what the cipher adds as well, so that protecting the record in place doesn't have to reallocate.
+            TRY(pending.try_ensure_capacity(header_size + MaximumApplicationDataChunkSize + 64));
+            TRY(pending.try_resize(header_size));
+            pending[0] = (u8)MessageType::ApplicationData;
+            ByteReader::store(pending.offset_pointer(1), AK::convert_between_host_and_network_endian((u16)m_context.options.version));
+        }
 
-        update_packet(packet);
-        write_packet(packet);
+        auto chunk = bytes.slice(offset, min(bytes.size() - offset, header_size + MaximumApplicationDataChunkSize - pending.size()));
+        TRY(pending.try_append(chunk));
+        offset += chunk.size();
+
+        if (pending.size() == header_size + MaximumApplicationDataChunkSize) {
+            auto packet = move(pending);
+            update_packet(packet);
+            write_packet(packet);
+        }
+    }
+
+    if (!pending.is_empty() && !m_has_scheduled_write_flush) {
+        Core::deferred_invoke([this] { write_into_socket(); });
+        m_has_scheduled_write_flush = true;
     }
 
     return bytes.size();
@@ -147,6 +178,8 @@ void TLSv12::setup_connection()
             }).release_value_but_fixme_should_propagate_errors();
         auto packet = build_hello();
         write_packet(packet);
+        if (auto result = send_early_data(); result.is_error())
+            dbgln("Failed to send early data: {}", result.error());
         write_into_socket();
         m_handshake_timeout_timer->start();
         m_context.handshake_initiation_timestamp = Core::DateTime::now().timestamp();
@@ -156,7 +189,7 @@ void TLSv12::setup_connection()
 
 void TLSv12::notify_client_for_app_data()
 {
-    if (m_context.application_buffer.size() > 0) {
+    if (!buffered_application_data().is_empty()) {
         if (on_ready_to_read)
             on_ready_to_read();
     } else {
@@ -237,7 +270,7 @@ bool TLSv12::check_connection_state(bool read)
     }
 
     if (read && stream.is_eof()) {
-        if (m_context.application_buffer.size() == 0 && m_context.connection_status != ConnectionStatus::Disconnected) {
+        if (buffered_application_data().is_empty() && m_context.connection_status != ConnectionStatus::Disconnected) {
             m_context.has_invoked_finish_or_error_callback = true;
             if (on_tls_finished)
                 on_tls_finished();
@@ -248,6 +281,10 @@ bool TLSv12::check_connection_state(bool read)
     if (m_context.critical_error) {
         dbgln_if(TLS_DEBUG, "CRITICAL ERROR {} :(", m_context.critical_error);
 
+        // Don't offer a session that didn't work out again.
+        if (m_context.offered_session.has_value() && m_context.options.session_cache && m_context.connection_status != ConnectionStatus::Established)
+            m_context.options.session_cache->remove(m_context.extensions.SNI);
+
         m_context.has_invoked_finish_or_error_callback = true;
         if (on_tls_error)
             on_tls_error((AlertDescription)m_context.critical_error);
@@ -257,8 +294,8 @@ bool TLSv12::check_connection_state(bool read)
         return false;
     }
 
-    if (((read && m_context.application_buffer.size() == 0) || !read) && m_context.connection_finished) {
-        if (m_context.application_buffer.size() == 0 && m_context.connection_status != ConnectionStatus::Disconnected) {
+    if (((read && buffered_application_data().is_empty()) || !read) && m_context.connection_finished) {
+        if (buffered_application_data().is_empty() && m_context.connection_status != ConnectionStatus::Disconnected) {
             m_context.has_invoked_finish_or_error_callback = true;
             if (on_tls_finished)
                 on_tls_finished();
@@ -266,9 +303,9 @@ bool TLSv12::check_connection_state(bool read)
         if (m_context.tls_buffer.size()) {
             dbgln_if(TLS_DEBUG, "connection closed without finishing data transfer, {} bytes still in buffer and {} bytes in application buffer",
                 m_context.tls_buffer.size(),
-                m_context.application_buffer.size());
+                buffered_application_data().size());
         }
-        if (!m_context.application_buffer.size()) {
+        if (buffered_application_data().is_empty()) {
             return false;
         }
     }
@@ -277,6 +314,8 @@ bool TLSv12::check_connection_state(bool read)
 
 ErrorOr<bool> TLSv12::flush()
 {
+    seal_pending_application_data();
+
     auto out_bytes = m_context.tls_buffer.bytes();
 
     if (out_bytes.is_empty())
@@ -317,7 +356,7 @@ ErrorOr<bool> TLSv12::flush()
 
 void TLSv12::close()
 {
-    alert(AlertLevel::Critical, AlertDescription::CloseNotify);
+    alert(AlertLevel::Warning, AlertDescription::CloseNotify);
     // bye bye.
     m_context.connection_status = ConnectionStatus::Disconnected;
 }
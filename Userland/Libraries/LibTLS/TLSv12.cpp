@@ -23,7 +23,7 @@
 
 namespace TLS {
 
-void TLSv12::consume(ReadonlyBytes record)
+void TLSv12::consume(Bytes record)
 {
     if (m_context.critical_error) {
         dbgln("There has been a critical error ({}), refusing to continue", (i8)m_context.critical_error);
@@ -36,13 +36,20 @@ void TLSv12::consume(ReadonlyBytes record)
 
     dbgln_if(TLS_DEBUG, "Consuming {} bytes", record.size());
 
-    if (m_context.message_buffer.try_append(record).is_error()) {
-        dbgln("Not enough space in message buffer, dropping the record");
-        return;
+    // Records that arrived in one piece are handled (and decrypted in place) right where they were read into,
+    // only a partial record has to be kept around in the message buffer until the rest of it shows up.
+    Bytes input = record;
+    bool is_using_message_buffer = !m_context.message_buffer.is_empty();
+    if (is_using_message_buffer) {
+        if (m_context.message_buffer.try_append(record).is_error()) {
+            dbgln("Not enough space in message buffer, dropping the record");
+            return;
+        }
+        input = m_context.message_buffer.bytes();
     }
 
     size_t index { 0 };
-    size_t buffer_length = m_context.message_buffer.size();
+    size_t buffer_length = input.size();
 
     size_t size_offset { 3 }; // read the common record header
     size_t header_size { 5 };
@@ -50,12 +57,12 @@ void TLSv12::consume(ReadonlyBytes record)
     dbgln_if(TLS_DEBUG, "message buffer length {}", buffer_length);
 
     while (buffer_length >= 5) {
-        auto length = AK::convert_between_host_and_network_endian(ByteReader::load16(m_context.message_buffer.offset_pointer(index + size_offset))) + header_size;
+        auto length = AK::convert_between_host_and_network_endian(ByteReader::load16(input.offset_pointer(index + size_offset))) + header_size;
         if (length > buffer_length) {
             dbgln_if(TLS_DEBUG, "Need more data: {} > {}", length, buffer_length);
             break;
         }
-        auto consumed = handle_message(m_context.message_buffer.bytes().slice(index, length));
+        auto consumed = handle_message(input.slice(index, length));
 
         if constexpr (TLS_DEBUG) {
             if (consumed > 0)
@@ -90,9 +97,13 @@ void TLSv12::consume(ReadonlyBytes record)
         return;
     }
 
-    if (index) {
-        // FIXME: Propagate errors.
-        m_context.message_buffer = MUST(m_context.message_buffer.slice(index, m_context.message_buffer.size() - index));
+    if (!is_using_message_buffer) {
+        if (index < input.size() && m_context.message_buffer.try_append(input.slice(index)).is_error())
+            dbgln("Not enough space in message buffer, dropping the record");
+    } else if (index) {
+        auto& buffer = m_context.message_buffer;
+        memmove(buffer.data(), buffer.offset_pointer(index), buffer.size() - index);
+        buffer.resize(buffer.size() - index);
     }
 }
 
@@ -431,6 +442,7 @@ TLSv12::TLSv12(StreamVariantType stream, Options options)
 {
     m_context.options = move(options);
     m_context.is_server = false;
+    m_context.alpn = m_context.options.alpn_protocols;
     m_context.tls_buffer = {};
 
     set_root_certificates(m_context.options.root_certificates.has_value()
@@ -19,6 +19,7 @@
 #include <LibCrypto/Hash/HashManager.h>
 #include <LibCrypto/PK/RSA.h>
 #include <LibTLS/CipherSuite.h>
+#include <LibTLS/SessionCache.h>
 #include <LibTLS/TLSPacketBuilder.h>
 
 namespace TLS {
@@ -111,6 +112,7 @@ enum class Error : i8 {
     NeedMoreData = -21,
     TimedOut = -22,
     OutOfMemory = -23,
+    IllegalParameter = -24,
 };
 
 enum class AlertLevel : u8 {
@@ -123,13 +125,18 @@ enum HandshakeType {
     ClientHello = 0x01,
     ServerHello = 0x02,
     HelloVerifyRequest = 0x03,
+    NewSessionTicket = 0x04,
+    EndOfEarlyData = 0x05,
+    EncryptedExtensions = 0x08,
     CertificateMessage = 0x0b,
     ServerKeyExchange = 0x0c,
     CertificateRequest = 0x0d,
     ServerHelloDone = 0x0e,
     CertificateVerify = 0x0f,
     ClientKeyExchange = 0x10,
-    Finished = 0x14
+    Finished = 0x14,
+    KeyUpdate = 0x18,
+    MessageHash = 0xfe,
 };
 
 enum class HandshakeExtension : u16 {
@@ -138,6 +145,13 @@ enum class HandshakeExtension : u16 {
     ECPointFormats = 0x0b,
     SignatureAlgorithms = 0x0d,
     ApplicationLayerProtocolNegotiation = 0x10,
+    SessionTicket = 0x23,
+    PreSharedKey = 0x29,
+    EarlyData = 0x2a,
+    SupportedVersions = 0x2b,
+    Cookie = 0x2c,
+    PSKKeyExchangeModes = 0x2d,
+    KeyShare = 0x33,
 };
 
 enum class NameType : u8 {
@@ -149,6 +163,9 @@ enum class WritePacketStage {
     ClientHandshake = 1,
     ServerHandshake = 2,
     Finished = 3,
+    // TLS 1.3 changes keys after some of the messages, which has to wait until they are part of the transcript.
+    SecondClientHello = 4,
+    HandshakeKeys = 5,
 };
 
 enum class ConnectionStatus {
@@ -159,6 +176,14 @@ enum class ConnectionStatus {
     Established,
 };
 
+// RFC 8446 section 4.2.10
+enum class EarlyDataStatus {
+    NotOffered,
+    Offered,
+    Accepted,
+    Rejected,
+};
+
 enum ClientVerificationStaus {
     Verified,
     VerificationNeeded,
@@ -172,7 +197,10 @@ enum class ECCurveType : u8 {
 // 4 bytes of fixed IV, 8 random (nonce) bytes, 4 bytes for counter
 // GCM specifically asks us to transmit only the nonce, the counter is zero
 // and the fixed IV is derived from the premaster key.
+// TLS 1.3 uses the whole 12 bytes of IV it derives as the nonce, after XORing the sequence number into it.
 #define ENUMERATE_CIPHERS(C)                                                                                                                              \
+    C(true, CipherSuite::AES_128_GCM_SHA256, KeyExchangeAlgorithm::KeyShare, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 12, true)                \
+    C(true, CipherSuite::AES_256_GCM_SHA384, KeyExchangeAlgorithm::KeyShare, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 12, true)                \
     C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA1, 16, false)                \
     C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA1, 16, false)                \
     C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA256, 16, false)           \
@@ -240,8 +268,13 @@ struct Options {
         return move(*this);                  \
     }
 
+    // The version in the record headers. TLS 1.3 keeps that at 1.2 (RFC 8446 section 5.1), and is negotiated with an extension instead.
     OPTION_WITH_DEFAULTS(Version, version, Version::V12)
+    OPTION_WITH_DEFAULTS(Version, max_version, Version::V13)
     OPTION_WITH_DEFAULTS(Vector<SignatureAndHashAlgorithm>, supported_signature_algorithms,
+        { HashAlgorithm::INTRINSIC, SignatureAlgorithm::RSA_PSS_RSAE_SHA512 },
+        { HashAlgorithm::INTRINSIC, SignatureAlgorithm::RSA_PSS_RSAE_SHA384 },
+        { HashAlgorithm::INTRINSIC, SignatureAlgorithm::RSA_PSS_RSAE_SHA256 },
         { HashAlgorithm::SHA512, SignatureAlgorithm::RSA },
         { HashAlgorithm::SHA384, SignatureAlgorithm::RSA },
         { HashAlgorithm::SHA256, SignatureAlgorithm::RSA },
@@ -260,6 +293,14 @@ struct Options {
     OPTION_WITH_DEFAULTS(Function<void(AlertDescription)>, alert_handler, [](auto) {})
     OPTION_WITH_DEFAULTS(Function<void()>, finish_callback, [] {})
     OPTION_WITH_DEFAULTS(Function<Vector<Certificate>()>, certificate_provider, [] { return Vector<Certificate> {}; })
+    // Where to look for a session to resume, and to remember the new one in. Without it, every handshake is a full one.
+    OPTION_WITH_DEFAULTS(RefPtr<SessionCache>, session_cache, )
+    // Application data to send right behind the ClientHello, when resuming a TLS 1.3 session that allows it (RFC 8446 section 4.2.10).
+    // An attacker can replay early data, so it must only be something that is safe to receive twice. If the server doesn't accept it,
+    // it is sent again as soon as the connection is established.
+    OPTION_WITH_DEFAULTS(ByteBuffer, early_data, )
+    // The application protocols to offer with ALPN (RFC 7301), most preferred first. alpn() tells which one the server picked, if any.
+    OPTION_WITH_DEFAULTS(Vector<DeprecatedString>, alpn_protocols, )
 
 #undef OPTION_WITH_DEFAULTS
 };
@@ -274,6 +315,12 @@ struct Context {
     u8 local_random[32];
     u8 session_id[32];
     u8 session_id_size { 0 };
+    // The session that the client hello offered to resume, and whether the server agreed to.
+    Optional<CachedSession> offered_session;
+    bool is_resuming_session { false };
+    Version negotiated_version { Version::V12 };
+    ByteBuffer session_ticket;
+    Time session_ticket_lifetime;
     CipherSuite cipher;
     bool is_server { false };
     Vector<Certificate> certificates;
@@ -290,6 +337,9 @@ struct Context {
         u8 remote_iv[16];
         u8 local_aead_iv[4];
         u8 remote_aead_iv[4];
+        // TLS 1.3 installs the keys for each direction on its own, so it doesn't use cipher_spec_set.
+        bool has_local_tls13_keys { false };
+        bool has_remote_tls13_keys { false };
     } crypto;
 
     Crypto::Hash::Manager handshake_hash;
@@ -303,8 +353,12 @@ struct Context {
     Error error_code { Error::NoError };
 
     ByteBuffer tls_buffer;
+    // Application data collected by write(), laid out as a record that is sealed once it is full or gets flushed.
+    ByteBuffer pending_application_data;
 
     ByteBuffer application_buffer;
+    // How much of application_buffer has already been read; it is only compacted when more data arrives.
+    size_t application_buffer_offset { 0 };
 
     bool is_child { false };
 
@@ -324,7 +378,7 @@ struct Context {
     bool has_invoked_finish_or_error_callback { false };
 
     // message flags
-    u8 handshake_messages[11] { 0 };
+    u8 handshake_messages[13] { 0 };
     ByteBuffer user_data;
     HashMap<DeprecatedString, Certificate> root_certificates;
 
@@ -342,6 +396,28 @@ struct Context {
     } server_diffie_hellman_params;
 
     OwnPtr<Crypto::Curves::EllipticCurve> server_key_exchange_curve;
+
+    // The state of a TLS 1.3 handshake. The secrets are the ones of the key schedule in RFC 8446 section 7.1.
+    struct {
+        NamedCurve key_share_group { NamedCurve::x25519 };
+        ByteBuffer key_share_private_key;
+        ByteBuffer client_hello;
+        ByteBuffer hello_retry_transcript;
+        ByteBuffer cookie;
+        bool has_received_hello_retry_request { false };
+        bool has_sent_change_cipher_spec { false };
+        ByteBuffer certificate_request_context;
+        EarlyDataStatus early_data_status { EarlyDataStatus::NotOffered };
+
+        ByteBuffer early_secret;
+        ByteBuffer handshake_secret;
+        ByteBuffer master_secret;
+        ByteBuffer client_handshake_traffic_secret;
+        ByteBuffer server_handshake_traffic_secret;
+        ByteBuffer client_application_traffic_secret;
+        ByteBuffer server_application_traffic_secret;
+        ByteBuffer resumption_master_secret;
+    } tls13;
 };
 
 class TLSv12 final : public Core::Socket {
@@ -367,13 +443,13 @@ public:
     /// bytes written into the stream, or an errno in the case of failure.
     virtual ErrorOr<size_t> write(ReadonlyBytes) override;
 
-    virtual bool is_eof() const override { return m_context.application_buffer.is_empty() && (m_context.connection_finished || underlying_stream().is_eof()); }
+    virtual bool is_eof() const override { return buffered_application_data().is_empty() && (m_context.connection_finished || underlying_stream().is_eof()); }
 
     virtual bool is_open() const override { return is_established(); }
     virtual void close() override;
 
-    virtual ErrorOr<size_t> pending_bytes() const override { return m_context.application_buffer.size(); }
-    virtual ErrorOr<bool> can_read_without_blocking(int = 0) const override { return !m_context.application_buffer.is_empty(); }
+    virtual ErrorOr<size_t> pending_bytes() const override { return buffered_application_data().size(); }
+    virtual ErrorOr<bool> can_read_without_blocking(int = 0) const override { return !buffered_application_data().is_empty(); }
     virtual ErrorOr<void> set_blocking(bool block) override
     {
         VERIFY(!block);
@@ -421,15 +497,26 @@ public:
 
     bool supports_version(Version v) const
     {
-        return v == Version::V12;
+        return v == Version::V12 || (v == Version::V13 && m_context.options.max_version >= Version::V13);
     }
 
+    EarlyDataStatus early_data_status() const { return m_context.tls13.early_data_status; }
+
     void alert(AlertLevel, AlertDescription);
 
-    bool can_read_line() const { return m_context.application_buffer.size() && memchr(m_context.application_buffer.data(), '\n', m_context.application_buffer.size()); }
-    bool can_read() const { return m_context.application_buffer.size() > 0; }
+    bool can_read_line() const
+    {
+        auto data = buffered_application_data();
+        return !data.is_empty() && memchr(data.data(), '\n', data.size());
+    }
+    bool can_read() const { return !buffered_application_data().is_empty(); }
     DeprecatedString read_line(size_t max_size);
 
+    // The decrypted application data that hasn't been read yet, without copying it out like read() does.
+    // The view is only valid until the next call into the socket; mark what was used with discard_application_data().
+    ReadonlyBytes buffered_application_data() const { return m_context.application_buffer.bytes().slice(m_context.application_buffer_offset); }
+    void discard_application_data(size_t);
+
     Function<void(AlertDescription)> on_tls_error;
     Function<void()> on_tls_finished;
     Function<void(TLSv12&)> on_tls_certificate_request;
@@ -438,7 +525,7 @@ public:
 private:
     void setup_connection();
 
-    void consume(ReadonlyBytes record);
+    void consume(Bytes record);
 
     ByteBuffer hmac_message(ReadonlyBytes buf, Optional<ReadonlyBytes> const buf2, size_t mac_length, bool local = false);
     void ensure_hmac(size_t digest_size, bool local);
@@ -447,6 +534,7 @@ private:
     void update_hash(ReadonlyBytes in, size_t header_size);
 
     void write_packet(ByteBuffer& packet);
+    void seal_pending_application_data();
 
     ByteBuffer build_client_key_exchange();
     ByteBuffer build_server_key_exchange();
@@ -468,7 +556,9 @@ private:
     void notify_client_for_app_data();
 
     ssize_t handle_server_hello(ReadonlyBytes, WritePacketStage&);
+    ssize_t handle_alpn_extension(ReadonlyBytes);
     ssize_t handle_handshake_finished(ReadonlyBytes, WritePacketStage&);
+    ssize_t handle_new_session_ticket(ReadonlyBytes);
     ssize_t handle_certificate(ReadonlyBytes);
     ssize_t handle_server_key_exchange(ReadonlyBytes);
     ssize_t handle_dhe_rsa_server_key_exchange(ReadonlyBytes);
@@ -476,11 +566,36 @@ private:
     ssize_t handle_server_hello_done(ReadonlyBytes);
     ssize_t handle_certificate_verify(ReadonlyBytes);
     ssize_t handle_handshake_payload(ReadonlyBytes);
-    ssize_t handle_message(ReadonlyBytes);
+    ssize_t handle_message(Bytes);
 
     void pseudorandom_function(Bytes output, ReadonlyBytes secret, u8 const* label, size_t label_length, ReadonlyBytes seed, ReadonlyBytes seed_b);
 
     ssize_t verify_rsa_server_key_exchange(ReadonlyBytes server_key_info_buffer, ReadonlyBytes signature_buffer);
+    ssize_t verify_rsa_signature(SignatureAndHashAlgorithm, ReadonlyBytes message, ReadonlyBytes signature);
+
+    bool is_tls13() const { return m_context.negotiated_version == Version::V13; }
+    bool offers_tls13() const;
+
+    ErrorOr<ByteBuffer> build_tls13_hello_extensions();
+    ErrorOr<void> fill_tls13_binder(ByteBuffer& client_hello_packet);
+    ErrorOr<void> send_early_data();
+    ssize_t handle_tls13_server_hello(CipherSuite, ReadonlyBytes extensions, WritePacketStage&);
+    ssize_t handle_hello_retry_request(CipherSuite, ReadonlyBytes extensions);
+    ssize_t handle_encrypted_extensions(ReadonlyBytes);
+    ssize_t handle_tls13_certificate(ReadonlyBytes);
+    ssize_t handle_tls13_certificate_request(ReadonlyBytes);
+    ssize_t handle_tls13_certificate_verify(ReadonlyBytes);
+    ssize_t handle_tls13_finished(ReadonlyBytes, WritePacketStage&);
+    ssize_t handle_tls13_new_session_ticket(ReadonlyBytes);
+    ssize_t handle_key_update(ReadonlyBytes);
+    ErrorOr<void> install_tls13_handshake_keys();
+    ErrorOr<void> finish_tls13_handshake();
+    ErrorOr<void> install_tls13_traffic_keys(ReadonlyBytes secret, bool local);
+    ErrorOr<ByteBuffer> tls13_finished_verify_data(ReadonlyBytes traffic_secret);
+    ByteBuffer build_tls13_certificate();
+    ByteBuffer build_tls13_handshake_message(HandshakeType, ReadonlyBytes body);
+    void protect_tls13_record(ByteBuffer& packet);
+    Error unprotect_tls13_record(Bytes record, ReadonlyBytes& plaintext, MessageType& type);
 
     size_t key_length() const
     {
@@ -550,6 +665,10 @@ private:
 
     bool expand_key();
 
+    bool resume_offered_session();
+    void remember_session();
+    void did_establish_connection();
+
     bool compute_master_secret_from_pre_master_secret(size_t length);
 
     void try_disambiguate_error() const;
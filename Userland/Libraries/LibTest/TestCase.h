@@ -40,6 +40,25 @@ private:
 // Helper to hide implementation of TestSuite from users
 void add_test_case_to_suite(NonnullRefPtr<TestCase> const& test_case);
 void set_suite_setup_function(Function<void()> setup);
+
+// Keeps the compiler from optimizing away a value that a benchmark computes, but doesn't otherwise use.
+template<typename T>
+ALWAYS_INLINE void do_not_optimize(T const& value)
+{
+    asm volatile(""
+                 :
+                 : "r,m"(value)
+                 : "memory");
+}
+
+// Makes the compiler assume that all memory may be read and written here, so that stores aren't optimized away.
+ALWAYS_INLINE void clobber_memory()
+{
+    asm volatile(""
+                 :
+                 :
+                 : "memory");
+}
 }
 
 #define TEST_SETUP                                   \
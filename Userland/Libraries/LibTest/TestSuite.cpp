@@ -8,10 +8,16 @@
 #include <LibTest/Macros.h> // intentionally first -- we redefine VERIFY and friends in here
 
 #include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/QuickSort.h>
 #include <LibCore/ArgsParser.h>
+#include <LibCore/File.h>
 #include <LibTest/TestSuite.h>
 #include <stdlib.h>
 #include <sys/time.h>
+#include <time.h>
 
 namespace Test {
 
@@ -38,6 +44,25 @@ private:
     struct timeval m_started = {};
 };
 
+// Benchmarks can also be a lot shorter than a millisecond, so they're timed separately.
+static u64 monotonic_nanoseconds()
+{
+    struct timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<u64>(now.tv_sec) * 1'000'000'000 + static_cast<u64>(now.tv_nsec);
+}
+
+static DeprecatedString format_nanoseconds(u64 nanoseconds)
+{
+    if (nanoseconds >= 1'000'000'000)
+        return DeprecatedString::formatted("{:.3}s", static_cast<double>(nanoseconds) / 1'000'000'000);
+    if (nanoseconds >= 1'000'000)
+        return DeprecatedString::formatted("{:.3}ms", static_cast<double>(nanoseconds) / 1'000'000);
+    if (nanoseconds >= 1'000)
+        return DeprecatedString::formatted("{:.3}us", static_cast<double>(nanoseconds) / 1'000);
+    return DeprecatedString::formatted("{}ns", nanoseconds);
+}
+
 // Declared in Macros.h
 void current_test_case_did_fail()
 {
@@ -70,6 +95,12 @@ int TestSuite::main(DeprecatedString const& suite_name, int argc, char** argv)
     args_parser.add_option(do_tests_only, "Only run tests.", "tests", 0);
     args_parser.add_option(do_benchmarks_only, "Only run benchmarks.", "bench", 0);
     args_parser.add_option(do_list_cases, "List available test cases.", "list", 0);
+    args_parser.add_option(m_benchmark_warmup_runs, "Run each benchmark this many times before measuring it.", "bench-warmup-runs", 0, "count");
+    args_parser.add_option(m_benchmark_min_runs, "Measure each benchmark at least this many times.", "bench-min-runs", 0, "count");
+    args_parser.add_option(m_benchmark_min_time_ms, "Keep measuring each benchmark until it has run for this long.", "bench-min-time", 0, "ms");
+    args_parser.add_option(m_benchmark_json_path, "Write the benchmark results to a JSON file.", "bench-json", 0, "path");
+    args_parser.add_option(m_benchmark_baseline_path, "Compare the benchmark results with a JSON file written by --bench-json.", "bench-baseline", 0, "path");
+    args_parser.add_option(m_benchmark_regression_threshold, "How many percent slower than the baseline a benchmark may get before it fails.", "bench-threshold", 0, "percent");
     args_parser.add_positional_argument(search_string, "Only run matching cases.", "pattern", Core::ArgsParser::Required::No);
     args_parser.parse(argc, argv);
 
@@ -125,7 +156,10 @@ int TestSuite::run(NonnullRefPtrVector<TestCase> const& tests)
         m_current_test_case_passed = true;
 
         TestElapsedTimer timer;
-        t.func()();
+        if (t.is_benchmark())
+            run_benchmark(t);
+        else
+            t.func()();
         auto const time = timer.elapsed_milliseconds();
 
         dbgln("{} {} '{}' in {}ms", m_current_test_case_passed ? "Completed" : "Failed", test_type, t.name(), time);
@@ -152,7 +186,126 @@ int TestSuite::run(NonnullRefPtrVector<TestCase> const& tests)
         global_timer.elapsed_milliseconds() - (m_testtime + m_benchtime));
     dbgln("Out of {} tests, {} passed and {} failed.", test_count, test_count - test_failed_count, test_failed_count);
 
+    if (!m_benchmark_json_path.is_empty()) {
+        if (auto result = write_benchmark_results(m_benchmark_json_path); result.is_error()) {
+            warnln("Failed to write the benchmark results to {}: {}", m_benchmark_json_path, result.error());
+            test_failed_count++;
+        }
+    }
+
+    if (!m_benchmark_baseline_path.is_empty()) {
+        auto regressions_or_error = compare_benchmarks_with_baseline(m_benchmark_baseline_path);
+        if (regressions_or_error.is_error()) {
+            warnln("Failed to compare with the benchmark baseline {}: {}", m_benchmark_baseline_path, regressions_or_error.error());
+            test_failed_count++;
+        } else {
+            test_failed_count += regressions_or_error.value();
+        }
+    }
+
     return (int)test_failed_count;
 }
 
+void TestSuite::run_benchmark(TestCase const& benchmark)
+{
+    // Nobody would wait for that many runs, but very short benchmarks could otherwise take forever to reach the minimum time.
+    static constexpr size_t max_runs = 1'000'000;
+
+    for (size_t i = 0; i < m_benchmark_warmup_runs && m_current_test_case_passed; ++i)
+        benchmark.func()();
+
+    Vector<u64> durations;
+    u64 total_ns = 0;
+    auto const min_time_ns = m_benchmark_min_time_ms * 1'000'000;
+    while (m_current_test_case_passed && durations.size() < max_runs && (durations.is_empty() || durations.size() < m_benchmark_min_runs || total_ns < min_time_ns)) {
+        auto start = monotonic_nanoseconds();
+        benchmark.func()();
+        auto duration = monotonic_nanoseconds() - start;
+        durations.append(duration);
+        total_ns += duration;
+    }
+    if (durations.is_empty())
+        return;
+
+    quick_sort(durations);
+    auto const middle = durations.size() / 2;
+    BenchmarkResult result {
+        .name = benchmark.name(),
+        .runs = durations.size(),
+        .min_ns = durations.first(),
+        .median_ns = durations.size() % 2 ? durations[middle] : (durations[middle - 1] + durations[middle]) / 2,
+        .p99_ns = durations[(durations.size() * 99 + 99) / 100 - 1],
+        .mean_ns = total_ns / durations.size(),
+    };
+
+    if (result.runs > 1) {
+        dbgln("Benchmark '{}' ran {} times: min {}, median {}, p99 {}, mean {}", result.name, result.runs,
+            format_nanoseconds(result.min_ns), format_nanoseconds(result.median_ns), format_nanoseconds(result.p99_ns), format_nanoseconds(result.mean_ns));
+    }
+    m_benchmark_results.append(move(result));
+}
+
+ErrorOr<void> TestSuite::write_benchmark_results(StringView path) const
+{
+    JsonArray benchmarks;
+    for (auto const& result : m_benchmark_results) {
+        JsonObject object;
+        object.set("name", result.name);
+        object.set("runs", result.runs);
+        object.set("min_ns", result.min_ns);
+        object.set("median_ns", result.median_ns);
+        object.set("p99_ns", result.p99_ns);
+        object.set("mean_ns", result.mean_ns);
+        benchmarks.append(move(object));
+    }
+
+    JsonObject root;
+    root.set("suite", m_suite_name);
+    root.set("benchmarks", move(benchmarks));
+
+    auto file = TRY(Core::File::open(path, Core::File::OpenMode::Write | Core::File::OpenMode::Truncate));
+    TRY(file->write_entire_buffer(root.to_deprecated_string().bytes()));
+    return {};
+}
+
+ErrorOr<size_t> TestSuite::compare_benchmarks_with_baseline(StringView path) const
+{
+    auto file = TRY(Core::File::open(path, Core::File::OpenMode::Read));
+    auto contents = TRY(file->read_until_eof());
+    auto json = TRY(JsonValue::from_string(contents));
+    if (!json.is_object())
+        return Error::from_string_literal("Baseline is not a JSON object");
+    auto benchmarks = json.as_object().get_array("benchmarks"sv);
+    if (!benchmarks.has_value())
+        return Error::from_string_literal("Baseline has no benchmarks");
+
+    // The medians are compared, since they aren't thrown off by the odd run that got interrupted.
+    HashMap<DeprecatedString, u64> baseline_medians;
+    benchmarks->for_each([&](JsonValue const& value) {
+        if (!value.is_object())
+            return;
+        auto name = value.as_object().get_deprecated_string("name"sv);
+        auto median_ns = value.as_object().get_u64("median_ns"sv);
+        if (name.has_value() && median_ns.has_value())
+            baseline_medians.set(name.release_value(), median_ns.value());
+    });
+
+    size_t regressions = 0;
+    for (auto const& result : m_benchmark_results) {
+        auto baseline_median_ns = baseline_medians.get(result.name);
+        if (!baseline_median_ns.has_value() || baseline_median_ns.value() == 0) {
+            dbgln("Benchmark '{}' is not in the baseline", result.name);
+            continue;
+        }
+
+        auto change = (static_cast<double>(result.median_ns) - static_cast<double>(baseline_median_ns.value())) * 100 / static_cast<double>(baseline_median_ns.value());
+        bool regressed = change > m_benchmark_regression_threshold;
+        dbgln("{} benchmark '{}': median {} -> {} ({:+.1}%)", regressed ? "Regressed" : "Compared", result.name,
+            format_nanoseconds(baseline_median_ns.value()), format_nanoseconds(result.median_ns), change);
+        if (regressed)
+            regressions++;
+    }
+    return regressions;
+}
+
 }
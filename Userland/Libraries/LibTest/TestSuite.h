@@ -10,8 +10,10 @@
 #include <LibTest/Macros.h> // intentionally first -- we redefine VERIFY and friends in here
 
 #include <AK/DeprecatedString.h>
+#include <AK/Error.h>
 #include <AK/Function.h>
 #include <AK/NonnullRefPtrVector.h>
+#include <AK/Vector.h>
 #include <LibTest/TestCase.h>
 
 namespace Test {
@@ -45,6 +47,19 @@ public:
     void set_suite_setup(Function<void()> setup) { m_setup = move(setup); }
 
 private:
+    struct BenchmarkResult {
+        DeprecatedString name;
+        size_t runs { 0 };
+        u64 min_ns { 0 };
+        u64 median_ns { 0 };
+        u64 p99_ns { 0 };
+        u64 mean_ns { 0 };
+    };
+
+    void run_benchmark(TestCase const&);
+    ErrorOr<void> write_benchmark_results(StringView path) const;
+    ErrorOr<size_t> compare_benchmarks_with_baseline(StringView path) const;
+
     static TestSuite* s_global;
     NonnullRefPtrVector<TestCase> m_cases;
     u64 m_testtime = 0;
@@ -52,6 +67,15 @@ private:
     DeprecatedString m_suite_name;
     bool m_current_test_case_passed = true;
     Function<void()> m_setup;
+
+    // By default, every benchmark is run once, like a test. Repeating them is opt-in, since some take seconds.
+    size_t m_benchmark_warmup_runs = 0;
+    size_t m_benchmark_min_runs = 1;
+    u64 m_benchmark_min_time_ms = 0;
+    StringView m_benchmark_json_path;
+    StringView m_benchmark_baseline_path;
+    double m_benchmark_regression_threshold = 10;
+    Vector<BenchmarkResult> m_benchmark_results;
 };
 
 }
@@ -16,6 +16,7 @@
 #include <LibCore/EventLoop.h>
 #include <LibCore/Object.h>
 #include <LibThreading/Thread.h>
+#include <LibThreading/ThreadPool.h>
 
 namespace Threading {
 
@@ -53,6 +54,17 @@ public:
 
 private:
     BackgroundAction(Function<Result(BackgroundAction&)> action, Function<ErrorOr<void>(Result)> on_complete, Optional<Function<void(Error)>> on_error = {})
+        : BackgroundAction(nullptr, move(action), move(on_complete), move(on_error))
+    {
+    }
+
+    // Actions that run on a thread pool can run alongside each other, instead of waiting for the single background thread.
+    BackgroundAction(ThreadPool& pool, Function<Result(BackgroundAction&)> action, Function<ErrorOr<void>(Result)> on_complete, Optional<Function<void(Error)>> on_error = {})
+        : BackgroundAction(&pool, move(action), move(on_complete), move(on_error))
+    {
+    }
+
+    BackgroundAction(ThreadPool* pool, Function<Result(BackgroundAction&)> action, Function<ErrorOr<void>(Result)> on_complete, Optional<Function<void(Error)>> on_error)
         : Core::Object(&background_thread())
         , m_action(move(action))
         , m_on_complete(move(on_complete))
@@ -60,7 +72,7 @@ private:
         if (on_error.has_value())
             m_on_error = on_error.release_value();
 
-        enqueue_work([this, origin_event_loop = &Core::EventLoop::current()] {
+        auto work = [this, pool, origin_event_loop = &Core::EventLoop::current()] {
             m_result = m_action(*this);
             if (m_on_complete) {
                 origin_event_loop->deferred_invoke([this] {
@@ -70,10 +82,19 @@ private:
                     remove_from_parent();
                 });
                 origin_event_loop->wake();
+            } else if (pool) {
+                // Several workers may be done at the same time, so only the origin thread is allowed to touch the list of children.
+                origin_event_loop->deferred_invoke([this] { remove_from_parent(); });
+                origin_event_loop->wake();
             } else {
                 this->remove_from_parent();
             }
-        });
+        };
+
+        if (pool)
+            pool->submit(move(work));
+        else
+            enqueue_work(move(work));
     }
 
     bool m_cancelled { false };
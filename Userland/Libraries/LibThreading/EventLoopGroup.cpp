@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/DeprecatedString.h>
+#include <LibCore/EventLoop.h>
+#include <LibThreading/EventLoopGroup.h>
+#include <pthread.h>
+#include <unistd.h>
+
+namespace Threading {
+
+ErrorOr<NonnullOwnPtr<EventLoopGroup>> EventLoopGroup::create(size_t thread_count, Setup setup)
+{
+    VERIFY(thread_count > 0);
+    auto group = TRY(adopt_nonnull_own_or_enomem(new (nothrow) EventLoopGroup(move(setup))));
+    TRY(group->m_threads.try_resize(thread_count));
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        group->m_threads[i].thread = TRY(Thread::try_create([group = group.ptr(), i] { return group->run_thread(i); }, DeprecatedString::formatted("EventLoop {}", i)));
+        group->m_threads[i].thread->start();
+    }
+
+    {
+        MutexLocker locker(group->m_mutex);
+        while (group->m_started_thread_count < thread_count)
+            group->m_thread_did_start.wait();
+        if (group->m_setup_error.has_value())
+            return group->m_setup_error.release_value();
+    }
+    return group;
+}
+
+EventLoopGroup::EventLoopGroup(Setup setup)
+    : m_setup(move(setup))
+{
+}
+
+EventLoopGroup::~EventLoopGroup()
+{
+    {
+        MutexLocker locker(m_mutex);
+        for (auto& loop_thread : m_threads) {
+            if (!loop_thread.event_loop)
+                continue;
+            loop_thread.event_loop->deferred_invoke([] { Core::EventLoop::current().quit(0); });
+            loop_thread.event_loop->wake();
+        }
+    }
+    for (auto& loop_thread : m_threads) {
+        if (loop_thread.thread && loop_thread.thread->needs_to_be_joined())
+            (void)loop_thread.thread->join();
+    }
+}
+
+void EventLoopGroup::deferred_invoke(size_t thread_index, Function<void()> function)
+{
+    MutexLocker locker(m_mutex);
+    auto* event_loop = m_threads[thread_index].event_loop;
+    VERIFY(event_loop);
+    event_loop->deferred_invoke(move(function));
+    event_loop->wake();
+}
+
+intptr_t EventLoopGroup::run_thread(size_t thread_index)
+{
+#ifdef AK_OS_LINUX
+    // Keeping each loop on its own processor keeps its clients' state in that processor's caches.
+    if (auto processor_count = sysconf(_SC_NPROCESSORS_ONLN); processor_count > 0) {
+        cpu_set_t processors;
+        CPU_ZERO(&processors);
+        CPU_SET(thread_index % processor_count, &processors);
+        (void)pthread_setaffinity_np(pthread_self(), sizeof(processors), &processors);
+    }
+#endif
+
+    Core::EventLoop event_loop;
+    {
+        MutexLocker locker(m_mutex);
+        auto result = m_setup(thread_index);
+        if (result.is_error() && !m_setup_error.has_value())
+            m_setup_error = result.release_error();
+        else if (!result.is_error())
+            m_threads[thread_index].event_loop = &event_loop;
+        ++m_started_thread_count;
+        m_thread_did_start.signal();
+        if (result.is_error())
+            return 1;
+    }
+
+    auto exit_code = event_loop.exec();
+
+    MutexLocker locker(m_mutex);
+    m_threads[thread_index].event_loop = nullptr;
+    return exit_code;
+}
+
+}
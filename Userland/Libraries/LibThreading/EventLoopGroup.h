@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibCore/Forward.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/Thread.h>
+
+namespace Threading {
+
+// Runs an event loop on each of a number of threads, so that a server can spread its clients over all processors.
+// Every thread sets itself up before its loop starts, for example by creating a Core::TCPServer::try_create_sharing() of
+// the server's listening socket. The threads are pinned to a processor each on systems that allow it.
+class EventLoopGroup {
+    AK_MAKE_NONCOPYABLE(EventLoopGroup);
+    AK_MAKE_NONMOVABLE(EventLoopGroup);
+
+public:
+    // Called on each thread, with its event loop already current. The threads take turns running it.
+    using Setup = Function<ErrorOr<void>(size_t thread_index)>;
+
+    // Returns once all threads have been set up, or with the first error a setup returned.
+    static ErrorOr<NonnullOwnPtr<EventLoopGroup>> create(size_t thread_count, Setup);
+    // Quits all event loops and waits for their threads to exit.
+    ~EventLoopGroup();
+
+    size_t thread_count() const { return m_threads.size(); }
+
+    // Runs the function on the event loop of the given thread.
+    void deferred_invoke(size_t thread_index, Function<void()>);
+
+private:
+    struct LoopThread {
+        RefPtr<Thread> thread;
+        Core::EventLoop* event_loop { nullptr };
+    };
+
+    explicit EventLoopGroup(Setup);
+
+    intptr_t run_thread(size_t thread_index);
+
+    Setup m_setup;
+    Vector<LoopThread> m_threads;
+
+    Mutex m_mutex;
+    ConditionVariable m_thread_did_start { m_mutex };
+    size_t m_started_thread_count { 0 };
+    Optional<Error> m_setup_error;
+};
+
+}
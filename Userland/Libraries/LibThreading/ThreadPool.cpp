@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/DeprecatedString.h>
+#include <LibThreading/Thread.h>
+#include <LibThreading/ThreadPool.h>
+#include <unistd.h>
+
+namespace Threading {
+
+// A worker pushes and pops its own jobs at the back, so that it keeps working on what it submitted last while that's still in the cache.
+// Other workers steal from the front, where the oldest and often largest jobs are.
+class JobDeque {
+public:
+    bool is_empty() const { return m_size == 0; }
+
+    void push_back(ThreadPool::Job job)
+    {
+        if (m_size == m_slots.size())
+            grow();
+        m_slots[(m_head + m_size) % m_slots.size()] = move(job);
+        ++m_size;
+    }
+
+    ThreadPool::Job pop_back()
+    {
+        VERIFY(!is_empty());
+        --m_size;
+        return move(m_slots[(m_head + m_size) % m_slots.size()]);
+    }
+
+    ThreadPool::Job pop_front()
+    {
+        VERIFY(!is_empty());
+        auto job = move(m_slots[m_head]);
+        m_head = (m_head + 1) % m_slots.size();
+        --m_size;
+        return job;
+    }
+
+private:
+    void grow()
+    {
+        Vector<ThreadPool::Job> slots;
+        slots.resize(max<size_t>(16, m_slots.size() * 2));
+        for (size_t i = 0; i < m_size; ++i)
+            slots[i] = move(m_slots[(m_head + i) % m_slots.size()]);
+        m_slots = move(slots);
+        m_head = 0;
+    }
+
+    Vector<ThreadPool::Job> m_slots;
+    size_t m_head { 0 };
+    size_t m_size { 0 };
+};
+
+struct ThreadPool::Worker {
+    Mutex mutex;
+    JobDeque jobs;
+    RefPtr<Thread> thread;
+};
+
+static thread_local ThreadPool* s_current_pool;
+static thread_local size_t s_current_worker_index;
+
+ThreadPool& ThreadPool::the()
+{
+    static ThreadPool* s_the = new ThreadPool;
+    return *s_the;
+}
+
+size_t ThreadPool::default_worker_count()
+{
+    return max(1l, sysconf(_SC_NPROCESSORS_ONLN));
+}
+
+ThreadPool::ThreadPool(size_t worker_count)
+{
+    VERIFY(worker_count > 0);
+    for (size_t i = 0; i < worker_count; ++i)
+        m_workers.append(make<Worker>());
+
+    // The workers look at each other's queues, so they can only start once all of them exist.
+    for (size_t i = 0; i < worker_count; ++i) {
+        m_workers[i].thread = Thread::construct([this, i] {
+            worker_loop(i);
+            return 0;
+        },
+            DeprecatedString::formatted("Pool Worker {}", i));
+        m_workers[i].thread->start();
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        MutexLocker locker(m_sleep_mutex);
+        m_stopping = true;
+        m_wake_condition.broadcast();
+    }
+    for (auto& worker : m_workers)
+        (void)worker.thread->join();
+}
+
+void ThreadPool::submit(Job job)
+{
+    // Jobs submitted by a worker stay with it, all others are handed out in turn.
+    auto index = s_current_pool == this ? s_current_worker_index : m_next_worker.fetch_add(1, AK::MemoryOrder::memory_order_relaxed) % m_workers.size();
+
+    // Counting the job before it's queued means that a worker may briefly look for a job that isn't there yet, but never sleeps through one.
+    m_queued_job_count.fetch_add(1);
+    {
+        MutexLocker locker(m_workers[index].mutex);
+        m_workers[index].jobs.push_back(move(job));
+    }
+
+    if (m_sleeping_worker_count.load() > 0) {
+        MutexLocker locker(m_sleep_mutex);
+        m_wake_condition.signal();
+    }
+}
+
+bool ThreadPool::try_run_one_job()
+{
+    auto job = take_job(s_current_pool == this ? s_current_worker_index : Optional<size_t> {});
+    if (!job.has_value())
+        return false;
+    (*job)();
+    return true;
+}
+
+Optional<ThreadPool::Job> ThreadPool::take_job(Optional<size_t> worker_index)
+{
+    if (worker_index.has_value()) {
+        auto& worker = m_workers[*worker_index];
+        MutexLocker locker(worker.mutex);
+        if (!worker.jobs.is_empty()) {
+            m_queued_job_count.fetch_sub(1);
+            return worker.jobs.pop_back();
+        }
+    }
+
+    // Thieves start looking at different workers, so that they don't all line up on the same one.
+    auto start = m_next_worker.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        auto victim_index = (start + i) % m_workers.size();
+        if (victim_index == worker_index)
+            continue;
+        auto& victim = m_workers[victim_index];
+        MutexLocker locker(victim.mutex);
+        if (!victim.jobs.is_empty()) {
+            m_queued_job_count.fetch_sub(1);
+            return victim.jobs.pop_front();
+        }
+    }
+    return {};
+}
+
+void ThreadPool::worker_loop(size_t worker_index)
+{
+    s_current_pool = this;
+    s_current_worker_index = worker_index;
+
+    for (;;) {
+        if (auto job = take_job(worker_index); job.has_value()) {
+            (*job)();
+            continue;
+        }
+
+        MutexLocker locker(m_sleep_mutex);
+        m_sleeping_worker_count.fetch_add(1);
+        while (m_queued_job_count.load() == 0 && !m_stopping)
+            m_wake_condition.wait();
+        m_sleeping_worker_count.fetch_sub(1);
+        if (m_stopping && m_queued_job_count.load() == 0)
+            return;
+    }
+}
+
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/Optional.h>
+#include <AK/QuickSort.h>
+#include <AK/Span.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Vector.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <sched.h>
+
+namespace Threading {
+
+// A fixed set of worker threads that run jobs as they're submitted.
+// Every worker has its own queue of jobs, and workers that run out of jobs steal them from the others,
+// so jobs that submit more jobs keep their worker busy without everybody fighting over a single queue.
+class ThreadPool {
+    AK_MAKE_NONCOPYABLE(ThreadPool);
+    AK_MAKE_NONMOVABLE(ThreadPool);
+
+public:
+    using Job = Function<void()>;
+
+    // The pool shared by the whole process, with one worker per processor. It's created on first use and never destroyed.
+    static ThreadPool& the();
+
+    static size_t default_worker_count();
+
+    explicit ThreadPool(size_t worker_count = default_worker_count());
+    // Runs all jobs that were submitted before the workers are stopped.
+    ~ThreadPool();
+
+    size_t worker_count() const { return m_workers.size(); }
+
+    void submit(Job);
+
+    // Runs one queued job on the calling thread, if there is one. This lets threads that wait on jobs help instead of blocking.
+    bool try_run_one_job();
+
+private:
+    struct Worker;
+
+    Optional<Job> take_job(Optional<size_t> worker_index);
+    void worker_loop(size_t worker_index);
+
+    NonnullOwnPtrVector<Worker> m_workers;
+    Atomic<size_t> m_next_worker { 0 };
+
+    // The number of jobs that have been submitted but not yet taken by anyone.
+    Atomic<size_t> m_queued_job_count { 0 };
+    Atomic<size_t> m_sleeping_worker_count { 0 };
+    Mutex m_sleep_mutex;
+    ConditionVariable m_wake_condition { m_sleep_mutex };
+    bool m_stopping { false };
+};
+
+// Calls callback(i) for every i in [0, count), spread over the pool in batches of at least grain_size.
+// Returns once all of them are done, and runs some of them on the calling thread while it waits.
+template<typename Callback>
+void parallel_for(size_t count, Callback callback, size_t grain_size = 1, ThreadPool& pool = ThreadPool::the())
+{
+    if (count == 0)
+        return;
+
+    // A few batches per worker leaves room for stealing when some of them take longer than others.
+    auto batch_size = max(grain_size, ceil_div(count, pool.worker_count() * 4));
+    auto batch_count = ceil_div(count, batch_size);
+    if (batch_count == 1) {
+        for (size_t i = 0; i < count; ++i)
+            callback(i);
+        return;
+    }
+
+    Atomic<size_t> remaining_batches { batch_count };
+    for (size_t batch = 1; batch < batch_count; ++batch) {
+        pool.submit([&, batch] {
+            auto end = min(count, (batch + 1) * batch_size);
+            for (size_t i = batch * batch_size; i < end; ++i)
+                callback(i);
+            remaining_batches.fetch_sub(1, AK::MemoryOrder::memory_order_acq_rel);
+        });
+    }
+
+    for (size_t i = 0; i < batch_size; ++i)
+        callback(i);
+    remaining_batches.fetch_sub(1, AK::MemoryOrder::memory_order_acq_rel);
+
+    while (remaining_batches.load(AK::MemoryOrder::memory_order_acquire) != 0) {
+        if (!pool.try_run_one_job())
+            sched_yield();
+    }
+}
+
+// Sorts the chunks of the collection in parallel, and then merges them pairwise, also in parallel.
+template<typename T, typename LessThan>
+ErrorOr<void> parallel_sort(Span<T> collection, LessThan less_than, ThreadPool& pool = ThreadPool::the())
+{
+    // Below this, the overhead of the merges is larger than what's gained from sorting in parallel.
+    static constexpr size_t minimum_chunk_size = 4096;
+
+    auto chunk_count = min(pool.worker_count(), collection.size() / minimum_chunk_size);
+    if (chunk_count <= 1) {
+        quick_sort(collection, less_than);
+        return {};
+    }
+    auto chunk_size = ceil_div(collection.size(), chunk_count);
+
+    Vector<T> scratch;
+    TRY(scratch.try_resize(collection.size()));
+
+    parallel_for(
+        chunk_count, [&](size_t chunk) {
+            auto start = chunk * chunk_size;
+            auto slice = collection.slice(start, min(chunk_size, collection.size() - start));
+            quick_sort(slice, less_than);
+        },
+        1, pool);
+
+    // Each pass merges neighbouring runs from one buffer into the other, doubling the run size.
+    Span<T> from = collection;
+    Span<T> to = scratch.span();
+    for (size_t run_size = chunk_size; run_size < collection.size(); run_size *= 2) {
+        auto merge_count = ceil_div(collection.size(), 2 * run_size);
+        parallel_for(
+            merge_count, [&](size_t merge) {
+                auto start = merge * 2 * run_size;
+                auto middle = min(start + run_size, from.size());
+                auto end = min(start + 2 * run_size, from.size());
+                size_t left = start;
+                size_t right = middle;
+                for (size_t i = start; i < end; ++i) {
+                    if (left < middle && (right == end || !less_than(from[right], from[left])))
+                        to[i] = move(from[left++]);
+                    else
+                        to[i] = move(from[right++]);
+                }
+            },
+            1, pool);
+        swap(from, to);
+    }
+
+    if (from.data() != collection.data()) {
+        for (size_t i = 0; i < collection.size(); ++i)
+            collection[i] = move(from[i]);
+    }
+    return {};
+}
+
+template<typename T>
+ErrorOr<void> parallel_sort(Span<T> collection, ThreadPool& pool = ThreadPool::the())
+{
+    return parallel_sort(collection, [](auto& a, auto& b) { return a < b; }, pool);
+}
+
+}
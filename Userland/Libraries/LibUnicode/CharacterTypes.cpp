@@ -178,6 +178,15 @@ Vector<size_t> find_grapheme_segmentation_boundaries([[maybe_unused]] Utf16View
         for (++it; it != view.end(); ++it, code_point = next_code_point) {
             next_code_point = *it;
 
+            // Printable ASCII characters have no grapheme break property and aren't pictographic, so there's always a
+            // boundary between two of them, by GB999.
+            if (is_ascii_printable(code_point) && is_ascii_printable(next_code_point)) {
+                in_emoji_sequence = false;
+                current_ri_chain = 0;
+                boundaries.append(view.code_unit_offset_of(it));
+                continue;
+            }
+
             auto code_point_is_cr = has_any_gbp(code_point, GBP::CR);
             auto next_code_point_is_lf = has_any_gbp(next_code_point, GBP::LF);
 
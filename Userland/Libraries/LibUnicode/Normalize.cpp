@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/CharacterTypes.h>
 #include <AK/Find.h>
 #include <AK/QuickSort.h>
 #include <AK/Utf8View.h>
@@ -234,7 +235,7 @@ static void canonical_composition_algorithm(Vector<u32>& code_points)
             //     and there exists a Primary Composite P which is canonically equivalent to <L, C>,
             //     then replace L by P in the sequence and delete C from the sequence.
             if (is_blocked(code_points.span(), j, i))
-                continue;
+                break;
 
             auto composite = combine_hangul_code_points(code_points[j], current_character);
 
@@ -245,71 +246,119 @@ static void canonical_composition_algorithm(Vector<u32>& code_points)
                 code_points[j] = composite;
                 code_points.remove(i);
                 --i;
-                break;
             }
+
+            // Only the last starter can be composed with C, so don't look any further back.
+            break;
         }
     }
 }
 
-static ErrorOr<Vector<u32>> normalize_nfd(Utf8View string)
+// https://www.unicode.org/reports/tr15/#Detecting_Normalization_Forms
+static bool passes_quick_check([[maybe_unused]] u32 code_point, [[maybe_unused]] NormalizationForm form)
 {
-    Vector<u32> result;
-    for (auto const code_point : string)
-        TRY(decompose_code_point(code_point, result, UseCompatibility::No));
-
-    canonical_ordering_algorithm(result);
-    return result;
+#if ENABLE_UNICODE_DATA
+    // The NF*_QC properties are set for both the "No" and the "Maybe" values, so the code points they don't have are
+    // the ones that are known to be unchanged by the normalization.
+    switch (form) {
+    case NormalizationForm::NFD:
+        return !code_point_has_property(code_point, Property::NFD_QC);
+    case NormalizationForm::NFC:
+        return !code_point_has_property(code_point, Property::NFC_QC);
+    case NormalizationForm::NFKD:
+        return !code_point_has_property(code_point, Property::NFKD_QC);
+    case NormalizationForm::NFKC:
+        return !code_point_has_property(code_point, Property::NFKC_QC);
+    }
+    VERIFY_NOT_REACHED();
+#else
+    return true;
+#endif
 }
 
-static ErrorOr<Vector<u32>> normalize_nfc(Utf8View string)
+// A starter that passes the quick check can neither be reordered with nor composed with anything before it, so the
+// text before it and the text from it onwards can be normalized separately.
+static bool is_normalization_boundary(u32 code_point, NormalizationForm form)
 {
-    auto result = TRY(normalize_nfd(string));
-    canonical_composition_algorithm(result);
-
-    return result;
+    if (is_ascii(code_point))
+        return true;
+    return is_starter(code_point) && passes_quick_check(code_point, form);
 }
 
-static ErrorOr<Vector<u32>> normalize_nfkd(Utf8View string)
+static ErrorOr<void> normalize_code_points(Utf8View string, NormalizationForm form, Vector<u32>& code_points)
 {
-    Vector<u32> result;
+    auto use_compatibility = (form == NormalizationForm::NFKD || form == NormalizationForm::NFKC) ? UseCompatibility::Yes : UseCompatibility::No;
+
+    code_points.clear_with_capacity();
     for (auto const code_point : string)
-        TRY(decompose_code_point(code_point, result, UseCompatibility::Yes));
+        TRY(decompose_code_point(code_point, code_points, use_compatibility));
 
-    canonical_ordering_algorithm(result);
-    return result;
-}
+    canonical_ordering_algorithm(code_points);
 
-static ErrorOr<Vector<u32>> normalize_nfkc(Utf8View string)
-{
-    auto result = TRY(normalize_nfkd(string));
-    canonical_composition_algorithm(result);
+    if (form == NormalizationForm::NFC || form == NormalizationForm::NFKC)
+        canonical_composition_algorithm(code_points);
 
-    return result;
-}
-
-static ErrorOr<Vector<u32>> normalize_implementation(Utf8View string, NormalizationForm form)
-{
-    switch (form) {
-    case NormalizationForm::NFD:
-        return normalize_nfd(string);
-    case NormalizationForm::NFC:
-        return normalize_nfc(string);
-    case NormalizationForm::NFKD:
-        return normalize_nfkd(string);
-    case NormalizationForm::NFKC:
-        return normalize_nfkc(string);
-    }
-    VERIFY_NOT_REACHED();
+    return {};
 }
 
 ErrorOr<String> normalize(StringView string, NormalizationForm form)
 {
-    auto const code_points = TRY(normalize_implementation(Utf8View { string }, form));
+    Utf8View view { string };
 
     StringBuilder builder;
-    for (auto code_point : code_points)
-        TRY(builder.try_append_code_point(code_point));
+    Vector<u32> code_points;
+
+    auto append_normalized = [&](Utf8View span) -> ErrorOr<void> {
+        TRY(normalize_code_points(span, form, code_points));
+        for (auto code_point : code_points)
+            TRY(builder.try_append_code_point(code_point));
+        return {};
+    };
+
+    // Invalid sequences are replaced while decoding, so invalid input can't be copied to the output as it is.
+    if (!view.validate()) {
+        TRY(append_normalized(view));
+        return builder.to_string();
+    }
+
+    // Text that passes the quick check is already normalized, and is copied to the output as it is. Only the spans
+    // that don't are normalized, each from the boundary before the first code point that fails the check up to the
+    // boundary after it.
+    size_t copied_up_to = 0;
+    size_t last_boundary = 0;
+    u8 last_combining_class = 0;
+
+    for (auto it = view.begin(); it != view.end();) {
+        auto code_point = *it;
+
+        if (is_normalization_boundary(code_point, form)) {
+            last_boundary = view.byte_offset_of(it);
+            last_combining_class = 0;
+            ++it;
+            continue;
+        }
+
+        auto combining_class = Unicode::canonical_combining_class(code_point);
+        if (passes_quick_check(code_point, form) && last_combining_class <= combining_class) {
+            last_combining_class = combining_class;
+            ++it;
+            continue;
+        }
+
+        ++it;
+        while (it != view.end() && !is_normalization_boundary(*it, form))
+            ++it;
+        auto span_end = view.byte_offset_of(it);
+
+        TRY(builder.try_append(string.substring_view(copied_up_to, last_boundary - copied_up_to)));
+        TRY(append_normalized(Utf8View { string.substring_view(last_boundary, span_end - last_boundary) }));
+        copied_up_to = span_end;
+    }
+
+    if (copied_up_to == 0)
+        return String::from_utf8(string);
 
+    TRY(builder.try_append(string.substring_view(copied_up_to)));
     return builder.to_string();
 }
 
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AllOf.h>
 #include <LibVT/Line.h>
 
 namespace VT {
@@ -20,6 +21,10 @@ void Line::rewrap(size_t new_length, Line* next_line, CursorPosition* cursor, bo
     if (old_length == new_length)
         return;
 
+    unpack_if_needed();
+    if (next_line)
+        next_line->unpack_if_needed();
+
     // Drop the empty cells
     if (m_terminated_at.has_value() && m_cells.size() > m_terminated_at.value())
         m_cells.remove(m_terminated_at.value(), m_cells.size() - m_terminated_at.value());
@@ -35,6 +40,9 @@ void Line::rewrap(size_t new_length, Line* next_line, CursorPosition* cursor, bo
 
 void Line::set_length(size_t new_length)
 {
+    if (new_length == length())
+        return;
+    unpack_if_needed();
     m_cells.resize(new_length);
     if (m_terminated_at.has_value())
         m_terminated_at = min(*m_terminated_at, new_length);
@@ -119,6 +127,7 @@ void Line::take_cells_from_next_line(size_t new_length, Line* next_line, bool cu
 
 void Line::clear_range(size_t first_column, size_t last_column, Attribute const& attribute)
 {
+    unpack_if_needed();
     VERIFY(first_column <= last_column);
     VERIFY(last_column < m_cells.size());
     for (size_t i = first_column; i <= last_column; ++i) {
@@ -133,6 +142,16 @@ bool Line::has_only_one_background_color() const
 {
     if (!length())
         return true;
+#ifndef KERNEL
+    if (m_packed) {
+        auto color = attribute_at(0).effective_background_color();
+        if (m_packed->attribute_runs.is_empty() || m_packed->attribute_runs.last().end < m_packed->length) {
+            if (Attribute().effective_background_color() != color)
+                return false;
+        }
+        return all_of(m_packed->attribute_runs, [&](auto& run) { return run.attribute.effective_background_color() == color; });
+    }
+#endif
     // FIXME: Cache this result?
     auto color = attribute_at(0).effective_background_color();
     for (size_t i = 1; i < length(); ++i) {
@@ -142,4 +161,82 @@ bool Line::has_only_one_background_color() const
     return true;
 }
 
+#ifndef KERNEL
+// Attribute's operator== doesn't look at the hyperlink, but we mustn't lose it.
+static bool is_same_attribute(Attribute const& a, Attribute const& b)
+{
+    return a == b && a.href == b.href && a.href_id == b.href_id;
+}
+
+void Line::pack()
+{
+    if (m_packed)
+        return;
+
+    auto packed = make<PackedCells>();
+    packed->length = m_cells.size();
+
+    size_t stored_cell_count = m_cells.size();
+    Cell const blank_cell;
+    while (stored_cell_count > 0) {
+        auto const& cell = m_cells[stored_cell_count - 1];
+        if (cell.code_point != blank_cell.code_point || !is_same_attribute(cell.attribute, blank_cell.attribute))
+            break;
+        --stored_cell_count;
+    }
+    auto stored_cells = m_cells.span().trim(stored_cell_count);
+
+    if (all_of(stored_cells, [](auto& cell) { return cell.code_point < 0x80; })) {
+        packed->ascii_code_points.ensure_capacity(stored_cell_count);
+        for (auto& cell : stored_cells)
+            packed->ascii_code_points.unchecked_append(cell.code_point);
+    } else {
+        packed->code_points.ensure_capacity(stored_cell_count);
+        for (auto& cell : stored_cells)
+            packed->code_points.unchecked_append(cell.code_point);
+    }
+
+    for (size_t i = 0; i < stored_cell_count; ++i) {
+        auto& attribute = stored_cells[i].attribute;
+        if (packed->attribute_runs.is_empty() || !is_same_attribute(packed->attribute_runs.last().attribute, attribute))
+            packed->attribute_runs.append({ i + 1, attribute });
+        else
+            packed->attribute_runs.last().end = i + 1;
+    }
+    packed->attribute_runs.shrink_to_fit();
+
+    m_cells.clear();
+    m_packed = move(packed);
+}
+
+void Line::unpack()
+{
+    VERIFY(m_packed);
+    auto packed = m_packed.release_nonnull();
+
+    m_cells.ensure_capacity(packed->length);
+    for (size_t i = 0; i < packed->length; ++i)
+        m_cells.unchecked_append({ packed->code_point(i), packed->attribute_at(i) });
+}
+
+u32 Line::PackedCells::code_point(size_t index) const
+{
+    if (index < ascii_code_points.size())
+        return ascii_code_points[index];
+    if (index < code_points.size())
+        return code_points[index];
+    return ' ';
+}
+
+Attribute const& Line::PackedCells::attribute_at(size_t index) const
+{
+    static Attribute const blank_attribute;
+    for (auto& run : attribute_runs) {
+        if (index < run.end)
+            return run.attribute;
+    }
+    return blank_attribute;
+}
+#endif
+
 }
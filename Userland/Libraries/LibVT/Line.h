@@ -9,6 +9,7 @@
 
 #include <AK/AnyOf.h>
 #include <AK/Noncopyable.h>
+#include <AK/OwnPtr.h>
 #include <AK/Vector.h>
 #include <LibVT/Attribute.h>
 #include <LibVT/Position.h>
@@ -31,14 +32,29 @@ public:
         bool operator!=(Cell const& other) const { return code_point != other.code_point || attribute != other.attribute; }
     };
 
-    Attribute const& attribute_at(size_t index) const { return m_cells[index].attribute; }
-    Attribute& attribute_at(size_t index) { return m_cells[index].attribute; }
+    Attribute const& attribute_at(size_t index) const
+    {
+#ifndef KERNEL
+        if (m_packed)
+            return m_packed->attribute_at(index);
+#endif
+        return m_cells[index].attribute;
+    }
+    Attribute& attribute_at(size_t index)
+    {
+        unpack_if_needed();
+        return m_cells[index].attribute;
+    }
 
-    Cell& cell_at(size_t index) { return m_cells[index]; }
-    Cell const& cell_at(size_t index) const { return m_cells[index]; }
+    Cell& cell_at(size_t index)
+    {
+        unpack_if_needed();
+        return m_cells[index];
+    }
 
     void clear(Attribute const& attribute = Attribute())
     {
+        unpack_if_needed();
         m_terminated_at.clear();
         clear_range(0, m_cells.size() - 1, attribute);
     }
@@ -47,11 +63,19 @@ public:
 
     bool is_empty() const
     {
+#ifndef KERNEL
+        if (m_packed)
+            return m_packed->attribute_runs.is_empty();
+#endif
         return !any_of(m_cells, [](auto& cell) { return cell != Cell(); });
     }
 
     size_t length() const
     {
+#ifndef KERNEL
+        if (m_packed)
+            return m_packed->length;
+#endif
         return m_cells.size();
     }
     void set_length(size_t);
@@ -59,11 +83,16 @@ public:
 
     u32 code_point(size_t index) const
     {
+#ifndef KERNEL
+        if (m_packed)
+            return m_packed->code_point(index);
+#endif
         return m_cells[index].code_point;
     }
 
     void set_code_point(size_t index, u32 code_point)
     {
+        unpack_if_needed();
         if (m_terminated_at.has_value()) {
             if (index > *m_terminated_at) {
                 m_terminated_at = index + 1;
@@ -79,11 +108,50 @@ public:
     Optional<u16> termination_column() const { return m_terminated_at; }
     void set_terminated(u16 column) { m_terminated_at = column; }
 
+#ifndef KERNEL
+    // Lines in the scrollback are hardly ever changed again, and there can be a lot of them, so they're packed there.
+    // Anything that changes a packed line unpacks it first, which is why readers should only use const Lines.
+    void pack();
+    bool is_packed() const { return m_packed; }
+#endif
+
 private:
+    void unpack_if_needed()
+    {
+#ifndef KERNEL
+        if (m_packed)
+            unpack();
+#endif
+    }
+
+#ifndef KERNEL
+    void unpack();
+
+    // The cells after the last one that isn't blank are dropped. Then the code points are stored as bytes if they're all ASCII,
+    // and the attributes as runs of identical ones.
+    struct PackedCells {
+        struct AttributeRun {
+            size_t end { 0 };
+            Attribute attribute;
+        };
+
+        u32 code_point(size_t index) const;
+        Attribute const& attribute_at(size_t index) const;
+
+        size_t length { 0 };
+        Vector<u8> ascii_code_points;
+        Vector<u32> code_points;
+        Vector<AttributeRun> attribute_runs;
+    };
+#endif
+
     void take_cells_from_next_line(size_t new_length, Line* next_line, bool cursor_is_on_next_line, CursorPosition* cursor);
     void push_cells_into_next_line(size_t new_length, Line* next_line, bool cursor_is_on_next_line, CursorPosition* cursor);
 
     Vector<Cell> m_cells;
+#ifndef KERNEL
+    OwnPtr<PackedCells> m_packed;
+#endif
     bool m_dirty { false };
     // Note: The alignment is 8, so this member lives in the padding (that already existed before it was introduced)
     [[no_unique_address]] Optional<u16> m_terminated_at;
@@ -1586,6 +1586,10 @@ void Terminal::set_size(u16 columns, u16 rows)
 
     cursor_tracker.row -= m_history.size();
 
+    // Rewrapping unpacked the lines in the scrollback.
+    for (auto& line : m_history)
+        line.pack();
+
     if (m_history.size() != old_history_size) {
         m_client.terminal_history_changed(-old_history_size);
         m_client.terminal_history_changed(m_history.size());
@@ -387,6 +387,8 @@ protected:
         if (max_history_size() == 0)
             return;
 
+        line->pack();
+
         // If m_history can expand, add the new line to the end of the list.
         // If there is an overflow wrap, the end is at the index before the start.
         if (m_history.size() < max_history_size()) {
@@ -49,8 +49,9 @@ void TerminalWidget::set_pty_master_fd(int fd)
     }
     m_notifier = Core::Notifier::construct(m_ptm_fd, Core::Notifier::Read);
     m_notifier->on_ready_to_read = [this] {
-        u8 buffer[BUFSIZ];
-        ssize_t nread = read(m_ptm_fd, buffer, sizeof(buffer));
+        // Reading a lot at once means we only paint once for all of it when a program writes faster than we can keep up.
+        Array<u8, 64 * KiB> buffer;
+        ssize_t nread = read(m_ptm_fd, buffer.data(), buffer.size());
         if (nread < 0) {
             dbgln("Terminal read error: {}", strerror(errno));
             perror("read(ptm)");
@@ -293,7 +294,7 @@ void TerminalWidget::paint_event(GUI::PaintEvent& event)
     Vector<Gfx::IntRect> hovered_href_rects;
     if (!m_hovered_href_id.is_null()) {
         for (u16 visual_row = 0; visual_row < m_terminal.rows(); ++visual_row) {
-            auto& line = m_terminal.line(first_row_from_history + visual_row);
+            auto const& line = m_terminal.line(first_row_from_history + visual_row);
             for (size_t column = 0; column < line.length(); ++column) {
                 if (m_hovered_href_id == line.attribute_at(column).href_id) {
                     bool merged_with_existing_rect = false;
@@ -317,27 +318,55 @@ void TerminalWidget::paint_event(GUI::PaintEvent& event)
         auto row_rect = this->row_rect(visual_row);
         if (!event.rect().contains(row_rect))
             continue;
-        auto& line = m_terminal.line(first_row_from_history + visual_row);
+        auto const& line = m_terminal.line(first_row_from_history + visual_row);
         bool has_only_one_background_color = line.has_only_one_background_color();
         if (visual_beep_active)
             painter.clear_rect(row_rect, terminal_color_to_rgb(VT::Color::named(VT::Color::ANSIColor::Red)));
         else if (has_only_one_background_color)
             painter.clear_rect(row_rect, terminal_color_to_rgb(line.attribute_at(0).effective_background_color()).with_alpha(m_opacity));
 
-        for (size_t column = 0; column < line.length(); ++column) {
-            bool should_reverse_fill_for_cursor_or_selection = m_cursor_blink_state
+        auto should_reverse_fill_for_cursor_or_selection = [&](size_t column) {
+            bool is_block_cursor = m_cursor_blink_state
                 && m_cursor_shape == VT::CursorShape::Block
                 && m_has_logical_focus
                 && visual_row == row_with_cursor
                 && column == m_terminal.cursor_column();
-            should_reverse_fill_for_cursor_or_selection |= selection_contains({ first_row_from_history + visual_row, (int)column });
-            auto attribute = line.attribute_at(column);
+            return is_block_cursor || selection_contains({ first_row_from_history + visual_row, (int)column });
+        };
+
+        // Cells next to each other usually have the same background, so we fill all of them at once.
+        Optional<Gfx::Color> pending_fill_color;
+        Gfx::IntRect pending_fill_rect;
+        auto flush_pending_fill = [&] {
+            if (pending_fill_color.has_value())
+                painter.clear_rect(pending_fill_rect, *pending_fill_color);
+            pending_fill_color = {};
+        };
+        for (size_t column = 0; column < line.length(); ++column) {
+            bool should_reverse_fill = should_reverse_fill_for_cursor_or_selection(column);
+            Optional<Gfx::Color> fill_color;
+            if ((!visual_beep_active && !has_only_one_background_color) || should_reverse_fill) {
+                auto const& attribute = line.attribute_at(column);
+                fill_color = terminal_color_to_rgb(should_reverse_fill ? attribute.effective_foreground_color() : attribute.effective_background_color());
+            }
+            auto cell_rect = glyph_rect(visual_row, column).inflated(0, m_line_spacing);
+            if (fill_color.has_value() && fill_color == pending_fill_color) {
+                pending_fill_rect = pending_fill_rect.united(cell_rect);
+                continue;
+            }
+            flush_pending_fill();
+            pending_fill_color = fill_color;
+            pending_fill_rect = cell_rect;
+        }
+        flush_pending_fill();
+
+        for (size_t column = 0; column < line.length(); ++column) {
+            bool should_reverse_fill = should_reverse_fill_for_cursor_or_selection(column);
+            auto const& attribute = line.attribute_at(column);
             auto character_rect = glyph_rect(visual_row, column);
             auto cell_rect = character_rect.inflated(0, m_line_spacing);
-            auto text_color_before_bold_change = should_reverse_fill_for_cursor_or_selection ? attribute.effective_background_color() : attribute.effective_foreground_color();
+            auto text_color_before_bold_change = should_reverse_fill ? attribute.effective_background_color() : attribute.effective_foreground_color();
             auto text_color = terminal_color_to_rgb(m_show_bold_text_as_bright ? text_color_before_bold_change.to_bright() : text_color_before_bold_change);
-            if ((!visual_beep_active && !has_only_one_background_color) || should_reverse_fill_for_cursor_or_selection)
-                painter.clear_rect(cell_rect, terminal_color_to_rgb(should_reverse_fill_for_cursor_or_selection ? attribute.effective_foreground_color() : attribute.effective_background_color()));
 
             if constexpr (TERMINAL_DEBUG) {
                 if (line.termination_column() == column)
@@ -396,9 +425,9 @@ void TerminalWidget::paint_event(GUI::PaintEvent& event)
         auto row_rect = this->row_rect(visual_row);
         if (!event.rect().contains(row_rect))
             continue;
-        auto& line = m_terminal.line(first_row_from_history + visual_row);
+        auto const& line = m_terminal.line(first_row_from_history + visual_row);
         for (size_t column = 0; column < line.length(); ++column) {
-            auto attribute = line.attribute_at(column);
+            auto const& attribute = line.attribute_at(column);
             bool should_reverse_fill_for_cursor_or_selection = m_cursor_blink_state
                 && m_cursor_shape == VT::CursorShape::Block
                 && m_has_logical_focus
@@ -428,7 +457,7 @@ void TerminalWidget::paint_event(GUI::PaintEvent& event)
 
     // Draw cursor.
     if (m_cursor_blink_state && row_with_cursor < m_terminal.rows()) {
-        auto& cursor_line = m_terminal.line(first_row_from_history + row_with_cursor);
+        auto const& cursor_line = m_terminal.line(first_row_from_history + row_with_cursor);
         if (m_terminal.cursor_row() >= (m_terminal.rows() - rows_from_history))
             return;
 
@@ -761,7 +790,7 @@ void TerminalWidget::doubleclick_event(GUI::MouseEvent& event)
         m_triple_click_timer.start();
 
         auto position = buffer_position_at(event.position());
-        auto& line = m_terminal.line(position.row());
+        auto const& line = m_terminal.line(position.row());
         bool want_whitespace = line.code_point(position.column()) == ' ';
 
         int start_column = 0;
@@ -992,7 +1021,7 @@ DeprecatedString TerminalWidget::selected_text() const
         int first_column = first_selection_column_on_row(row);
         int last_column = last_selection_column_on_row(row);
         for (int column = first_column; column <= last_column; ++column) {
-            auto& line = m_terminal.line(row);
+            auto const& line = m_terminal.line(row);
             if (line.attribute_at(column).is_untouched()) {
                 builder.append('\n');
                 break;
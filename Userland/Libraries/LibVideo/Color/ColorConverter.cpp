@@ -5,6 +5,8 @@
  */
 
 #include <AK/Math.h>
+#include <AK/SIMDExtras.h>
+#include <AK/SIMDMath.h>
 #include <AK/StdLibExtras.h>
 #include <LibGfx/Matrix4x4.h>
 #include <LibVideo/Color/ColorPrimaries.h>
@@ -244,4 +246,38 @@ Gfx::Color ColorConverter::convert_yuv_to_full_range_rgb(u16 y, u16 u, u16 v)
     return Gfx::Color(r, g, b);
 }
 
+void ColorConverter::convert_yuv_to_full_range_rgb(ReadonlySpan<u16> y_row, ReadonlySpan<u16> u_row, ReadonlySpan<u16> v_row, Span<Gfx::ARGB32> rgb_row)
+{
+    using AK::SIMD::f32x4;
+    using AK::SIMD::u32x4;
+
+    auto width = rgb_row.size();
+    VERIFY(y_row.size() >= width && u_row.size() >= width && v_row.size() >= width);
+
+    size_t column = 0;
+    if (m_should_skip_color_remapping) {
+        // This adds up the products in the same order as the matrix multiplication in the scalar conversion, so that
+        // both give the same colors.
+        auto const& elements = m_input_conversion_matrix.elements();
+        auto load_samples = [&](ReadonlySpan<u16> samples) {
+            return AK::SIMD::to_f32x4(u32x4 { samples[column], samples[column + 1], samples[column + 2], samples[column + 3] });
+        };
+        auto convert_channel = [&](size_t channel, f32x4 y, f32x4 u, f32x4 v) {
+            auto value = y * elements[channel][0] + u * elements[channel][1] + v * elements[channel][2] + elements[channel][3];
+            return AK::SIMD::to_u32x4(AK::SIMD::clamp(value, 0.0f, 1.0f) * 255.0f);
+        };
+
+        for (; column + 4 <= width; column += 4) {
+            auto y = load_samples(y_row);
+            auto u = load_samples(u_row);
+            auto v = load_samples(v_row);
+            u32x4 pixels = 0xff000000u | (convert_channel(0, y, u, v) << 16) | (convert_channel(1, y, u, v) << 8) | convert_channel(2, y, u, v);
+            __builtin_memcpy(&rgb_row[column], &pixels, sizeof(pixels));
+        }
+    }
+
+    for (; column < width; column++)
+        rgb_row[column] = convert_yuv_to_full_range_rgb(y_row[column], u_row[column], v_row[column]).value();
+}
+
 }
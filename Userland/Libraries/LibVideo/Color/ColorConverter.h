@@ -8,6 +8,7 @@
 
 #include <AK/Array.h>
 #include <AK/Function.h>
+#include <AK/Span.h>
 #include <LibGfx/Color.h>
 #include <LibGfx/Matrix4x4.h>
 #include <LibVideo/Color/CodingIndependentCodePoints.h>
@@ -64,6 +65,9 @@ public:
     static DecoderErrorOr<ColorConverter> create(u8 bit_depth, CodingIndependentCodePoints cicp);
 
     Gfx::Color convert_yuv_to_full_range_rgb(u16 y, u16 u, u16 v);
+    // Converts a row of pixels that each have all three samples. When no color remapping is needed, four of them are
+    // converted at once.
+    void convert_yuv_to_full_range_rgb(ReadonlySpan<u16> y_row, ReadonlySpan<u16> u_row, ReadonlySpan<u16> v_row, Span<Gfx::ARGB32> rgb_row);
 
 private:
     static constexpr size_t to_linear_size = 64;
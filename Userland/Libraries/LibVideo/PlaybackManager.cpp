@@ -223,7 +223,8 @@ bool PlaybackManager::decode_and_queue_one_sample()
         break;
     }
 
-    auto bitmap = TRY_OR_ENQUEUE_ERROR(decoded_frame->to_bitmap(), frame_sample->timestamp());
+    auto bitmap = TRY_OR_ENQUEUE_ERROR(take_frame_bitmap(decoded_frame->size()), frame_sample->timestamp());
+    TRY_OR_ENQUEUE_ERROR(decoded_frame->output_to_bitmap(bitmap), frame_sample->timestamp());
     m_frame_queue->enqueue(FrameQueueItem::frame(bitmap, frame_sample->timestamp()));
 
 #if PLAYBACK_MANAGER_DEBUG
@@ -234,6 +235,22 @@ bool PlaybackManager::decode_and_queue_one_sample()
     return true;
 }
 
+DecoderErrorOr<NonnullRefPtr<Gfx::Bitmap>> PlaybackManager::take_frame_bitmap(Gfx::IntSize size)
+{
+    // Bitmaps of another size are left for whoever still holds them.
+    m_frame_bitmaps.remove_all_matching([&](auto& bitmap) { return bitmap->size() != size; });
+
+    // A bitmap that only the list refers to isn't queued or shown anymore.
+    for (auto& bitmap : m_frame_bitmaps) {
+        if (bitmap->ref_count() == 1)
+            return bitmap;
+    }
+
+    auto bitmap = DECODER_TRY_ALLOC(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, size));
+    DECODER_TRY_ALLOC(m_frame_bitmaps.try_append(bitmap));
+    return bitmap;
+}
+
 void PlaybackManager::on_decode_timer()
 {
     if (!decode_and_queue_one_sample()) {
@@ -128,6 +128,7 @@ private:
     Optional<Time> seek_demuxer_to_most_recent_keyframe(Time timestamp, Optional<Time> earliest_available_sample = OptionalNone());
 
     bool decode_and_queue_one_sample();
+    DecoderErrorOr<NonnullRefPtr<Gfx::Bitmap>> take_frame_bitmap(Gfx::IntSize);
     void on_decode_timer();
 
     void dispatch_decoder_error(DecoderError error);
@@ -147,6 +148,9 @@ private:
     NonnullOwnPtr<VideoDecoder> m_decoder;
 
     NonnullOwnPtr<VideoFrameQueue> m_frame_queue;
+    // The bitmaps that frames are converted into. Once the queue and the client are done with one, it's reused for a
+    // later frame, so that a new bitmap doesn't have to be allocated for every frame.
+    Vector<NonnullRefPtr<Gfx::Bitmap>> m_frame_bitmaps;
 
     RefPtr<Core::Timer> m_present_timer;
     unsigned m_decoding_buffer_time_ms = 16;
@@ -1172,15 +1172,24 @@ inline i32 Decoder::rounded_right_shift(T value, u8 bits)
     return static_cast<i32>(value);
 }
 
+inline AK::SIMD::i32x4 Decoder::rounded_right_shift(AK::SIMD::i32x4 value, u8 bits)
+{
+    return (value + static_cast<i32>(1u << (bits - 1u))) >> static_cast<i32>(bits);
+}
+
 // (8.7.1.1) The function B( a, b, angle, 0 ) performs a butterfly rotation.
-inline void Decoder::butterfly_rotation_in_place(Span<Intermediate> data, size_t index_a, size_t index_b, u8 angle, bool flip)
+template<typename T>
+inline void Decoder::butterfly_rotation_in_place(Span<T> data, size_t index_a, size_t index_b, u8 angle, bool flip)
 {
+    // The products are rounded in 64 bits for single values, and in the 32 bits of each lane for vectors.
+    using Product = Conditional<IsSame<T, Intermediate>, i64, T>;
+
     auto cos = cos64(angle);
     auto sin = sin64(angle);
     // 1. The variable x is set equal to T[ a ] * cos64( angle ) - T[ b ] * sin64( angle ).
-    i64 rotated_a = data[index_a] * cos - data[index_b] * sin;
+    Product rotated_a = data[index_a] * cos - data[index_b] * sin;
     // 2. The variable y is set equal to T[ a ] * sin64( angle ) + T[ b ] * cos64( angle ).
-    i64 rotated_b = data[index_a] * sin + data[index_b] * cos;
+    Product rotated_b = data[index_a] * sin + data[index_b] * cos;
     // 3. T[ a ] is set equal to Round2( x, 14 ).
     data[index_a] = rounded_right_shift(rotated_a, 14);
     // 4. T[ b ] is set equal to Round2( y, 14 ).
@@ -1199,7 +1208,8 @@ inline void Decoder::butterfly_rotation_in_place(Span<Intermediate> data, size_t
 }
 
 // (8.7.1.1) The function H( a, b, 0 ) performs a Hadamard rotation.
-inline void Decoder::hadamard_rotation_in_place(Span<Intermediate> data, size_t index_a, size_t index_b, bool flip)
+template<typename T>
+inline void Decoder::hadamard_rotation_in_place(Span<T> data, size_t index_a, size_t index_b, bool flip)
 {
     // The function H( a, b, 1 ) performs a Hadamard rotation with flipped indices and is specified as follows:
     // 1. The function H( b, a, 0 ) is invoked.
@@ -1223,7 +1233,8 @@ inline void Decoder::hadamard_rotation_in_place(Span<Intermediate> data, size_t
     // to allow these bounds to be violated. Therefore, we can avoid the performance cost here.
 }
 
-inline DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform_array_permutation(Span<Intermediate> data, u8 log2_of_block_size)
+template<typename T>
+inline DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform_array_permutation(Span<T> data, u8 log2_of_block_size)
 {
     u8 block_size = 1 << log2_of_block_size;
 
@@ -1233,8 +1244,9 @@ inline DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform_array_per
         return DecoderError::corrupted("Block size was out of range"sv);
 
     // 1.1. A temporary array named copyT is set equal to T.
-    Array<Intermediate, maximum_transform_size> data_copy;
-    AK::TypedTransfer<Intermediate>::copy(data_copy.data(), data.data(), block_size);
+    Array<T, maximum_transform_dimensions> data_copy;
+    for (auto i = 0u; i < block_size; i++)
+        data_copy[i] = data[i];
 
     // 1.2. T[ i ] is set equal to copyT[ brev( n, i ) ] for i = 0..((1<<n) - 1).
     for (auto i = 0u; i < block_size; i++)
@@ -1243,7 +1255,8 @@ inline DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform_array_per
     return {};
 }
 
-inline DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform(Span<Intermediate> data, u8 log2_of_block_size)
+template<typename T>
+inline DecoderErrorOr<void> Decoder::inverse_discrete_cosine_transform(Span<T> data, u8 log2_of_block_size)
 {
     // 2.1. The variable n0 is set equal to 1<<n.
     u8 block_size = 1 << log2_of_block_size;
@@ -1642,8 +1655,15 @@ DecoderErrorOr<void> Decoder::inverse_transform_2d(BlockContext const& block_con
     // 2. The row transforms with i = 0..(n0-1) are applied as follows:
     for (auto i = 0u; i < block_size; i++) {
         // 1. Set T[ j ] equal to Dequant[ i ][ j ] for j = 0..(n0-1).
-        for (auto j = 0u; j < block_size; j++)
+        bool row_is_zero = true;
+        for (auto j = 0u; j < block_size; j++) {
             row[j] = dequantized[index_from_row_and_column(i, j, block_size)];
+            row_is_zero = row_is_zero && row[j] == 0;
+        }
+
+        // Most coefficients of a block are usually zero, and all transforms turn a row of zeroes into zeroes.
+        if (row_is_zero)
+            continue;
 
         // 2. If Lossless is equal to 1, invoke the Inverse WHT process as specified in section 8.7.1.10 with shift equal
         //    to 2.
@@ -1674,6 +1694,26 @@ DecoderErrorOr<void> Decoder::inverse_transform_2d(BlockContext const& block_con
             dequantized[index_from_row_and_column(i, j, block_size)] = row[j];
     }
 
+    // With 8-bit samples, the values of the column transforms fit into 32 bits, so the DCT is done on four
+    // neighbouring columns at once, with one of them in each lane of a vector.
+    if (transform_set.first_transform == TransformType::DCT && !block_context.frame_context.is_lossless() && block_context.frame_context.color_config.bit_depth == 8) {
+        Array<AK::SIMD::i32x4, maximum_transform_dimensions> columns_array;
+        auto columns = columns_array.span().trim(block_size);
+        for (auto j = 0u; j < block_size; j += 4) {
+            for (auto i = 0u; i < block_size; i++)
+                __builtin_memcpy(&columns[i], &dequantized[index_from_row_and_column(i, j, block_size)], sizeof(columns[i]));
+
+            TRY(inverse_discrete_cosine_transform_array_permutation(columns, log2_of_block_size));
+            TRY(inverse_discrete_cosine_transform(columns, log2_of_block_size));
+
+            for (auto i = 0u; i < block_size; i++) {
+                auto rounded = rounded_right_shift(columns[i], min(6, log2_of_block_size + 2));
+                __builtin_memcpy(&dequantized[index_from_row_and_column(i, j, block_size)], &rounded, sizeof(rounded));
+            }
+        }
+        return {};
+    }
+
     Array<Intermediate, maximum_transform_size> column_array;
     auto column = column_array.span().trim(block_size);
 
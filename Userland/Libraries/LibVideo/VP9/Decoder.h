@@ -11,6 +11,7 @@
 #include <AK/Error.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Queue.h>
+#include <AK/SIMD.h>
 #include <AK/Span.h>
 #include <LibVideo/Color/CodingIndependentCodePoints.h>
 #include <LibVideo/DecoderError.h>
@@ -39,7 +40,8 @@ private:
     static constexpr size_t maximum_block_dimensions = 64ULL;
     static constexpr size_t maximum_block_size = maximum_block_dimensions * maximum_block_dimensions;
     // Based on the maximum for TXSize.
-    static constexpr size_t maximum_transform_size = 32ULL * 32ULL;
+    static constexpr size_t maximum_transform_dimensions = 32ULL;
+    static constexpr size_t maximum_transform_size = maximum_transform_dimensions * maximum_transform_dimensions;
 
     DecoderErrorOr<void> decode_frame(ReadonlyBytes);
     DecoderErrorOr<void> create_video_frame(FrameContext const&);
@@ -89,9 +91,12 @@ private:
     inline i32 cos64(u8 angle);
     inline i32 sin64(u8 angle);
     // The function B( a, b, angle, 0 ) performs a butterfly rotation.
-    inline void butterfly_rotation_in_place(Span<Intermediate> data, size_t index_a, size_t index_b, u8 angle, bool flip);
+    // The in-place functions also work on vectors, which transform a column in each lane.
+    template<typename T>
+    inline void butterfly_rotation_in_place(Span<T> data, size_t index_a, size_t index_b, u8 angle, bool flip);
     // The function H( a, b, 0 ) performs a Hadamard rotation.
-    inline void hadamard_rotation_in_place(Span<Intermediate> data, size_t index_a, size_t index_b, bool flip);
+    template<typename T>
+    inline void hadamard_rotation_in_place(Span<T> data, size_t index_a, size_t index_b, bool flip);
     // The function SB( a, b, angle, 0 ) performs a butterfly rotation.
     // Spec defines the source as array T, and the destination array as S.
     template<typename S, typename D>
@@ -103,14 +108,17 @@ private:
 
     template<typename T>
     inline i32 rounded_right_shift(T value, u8 bits);
+    inline AK::SIMD::i32x4 rounded_right_shift(AK::SIMD::i32x4 value, u8 bits);
 
     // (8.7.1.10) This process does an in-place Walsh-Hadamard transform of the array T (of length 4).
     inline DecoderErrorOr<void> inverse_walsh_hadamard_transform(Span<Intermediate> data, u8 log2_of_block_size, u8 shift);
 
     // (8.7.1.2) Inverse DCT array permutation process
-    inline DecoderErrorOr<void> inverse_discrete_cosine_transform_array_permutation(Span<Intermediate> data, u8 log2_of_block_size);
+    template<typename T>
+    inline DecoderErrorOr<void> inverse_discrete_cosine_transform_array_permutation(Span<T> data, u8 log2_of_block_size);
     // (8.7.1.3) Inverse DCT process
-    inline DecoderErrorOr<void> inverse_discrete_cosine_transform(Span<Intermediate> data, u8 log2_of_block_size);
+    template<typename T>
+    inline DecoderErrorOr<void> inverse_discrete_cosine_transform(Span<T> data, u8 log2_of_block_size);
 
     // (8.7.1.4) This process performs the in-place permutation of the array T of length 2 n which is required as the first step of
     // the inverse ADST.
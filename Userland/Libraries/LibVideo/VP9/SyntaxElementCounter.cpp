@@ -8,6 +8,15 @@
 
 namespace Video::VP9 {
 
+template<typename T>
+static void add_counts(T& destination, T const& source)
+{
+    auto* destination_counts = reinterpret_cast<u32*>(&destination);
+    auto const* source_counts = reinterpret_cast<u32 const*>(&source);
+    for (size_t i = 0; i < sizeof(T) / sizeof(u32); i++)
+        destination_counts[i] += source_counts[i];
+}
+
 void SyntaxElementCounter::clear_counts()
 {
     __builtin_memset(m_counts_intra_mode, 0, sizeof(m_counts_intra_mode));
@@ -34,4 +43,31 @@ void SyntaxElementCounter::clear_counts()
     __builtin_memset(m_counts_more_coefs, 0, sizeof(m_counts_more_coefs));
 }
 
+SyntaxElementCounter& SyntaxElementCounter::operator+=(SyntaxElementCounter const& other)
+{
+    add_counts(m_counts_intra_mode, other.m_counts_intra_mode);
+    add_counts(m_counts_uv_mode, other.m_counts_uv_mode);
+    add_counts(m_counts_partition, other.m_counts_partition);
+    add_counts(m_counts_interp_filter, other.m_counts_interp_filter);
+    add_counts(m_counts_inter_mode, other.m_counts_inter_mode);
+    add_counts(m_counts_tx_size, other.m_counts_tx_size);
+    add_counts(m_counts_is_inter, other.m_counts_is_inter);
+    add_counts(m_counts_comp_mode, other.m_counts_comp_mode);
+    add_counts(m_counts_single_ref, other.m_counts_single_ref);
+    add_counts(m_counts_comp_ref, other.m_counts_comp_ref);
+    add_counts(m_counts_skip, other.m_counts_skip);
+    add_counts(m_counts_mv_joint, other.m_counts_mv_joint);
+    add_counts(m_counts_mv_sign, other.m_counts_mv_sign);
+    add_counts(m_counts_mv_class, other.m_counts_mv_class);
+    add_counts(m_counts_mv_class0_bit, other.m_counts_mv_class0_bit);
+    add_counts(m_counts_mv_class0_fr, other.m_counts_mv_class0_fr);
+    add_counts(m_counts_mv_class0_hp, other.m_counts_mv_class0_hp);
+    add_counts(m_counts_mv_bits, other.m_counts_mv_bits);
+    add_counts(m_counts_mv_fr, other.m_counts_mv_fr);
+    add_counts(m_counts_mv_hp, other.m_counts_mv_hp);
+    add_counts(m_counts_token, other.m_counts_token);
+    add_counts(m_counts_more_coefs, other.m_counts_more_coefs);
+    return *this;
+}
+
 }
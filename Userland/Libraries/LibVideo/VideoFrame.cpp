@@ -28,6 +28,9 @@ DecoderErrorOr<void> SubsampledYUVFrame::output_to_bitmap(Gfx::Bitmap& bitmap)
 {
     size_t width = this->width();
     size_t height = this->height();
+    if (bitmap.size() != size() || (bitmap.format() != Gfx::BitmapFormat::BGRx8888 && bitmap.format() != Gfx::BitmapFormat::BGRA8888))
+        return DecoderError::with_description(DecoderErrorCategory::Invalid, "Bitmap does not match the frame"sv);
+
     auto u_sample_row = DECODER_TRY_ALLOC(FixedArray<u16>::create(width));
     auto v_sample_row = DECODER_TRY_ALLOC(FixedArray<u16>::create(width));
     size_t uv_width = width >> m_subsampling_horizontal;
@@ -71,21 +74,8 @@ DecoderErrorOr<void> SubsampledYUVFrame::output_to_bitmap(Gfx::Bitmap& bitmap)
             }
         }
 
-        for (size_t column = 0; column < width; column++) {
-            auto y_sample = m_plane_y[row * width + column];
-            auto u_sample = u_sample_row[column];
-            auto v_sample = v_sample_row[column];
-
-            bitmap.set_pixel(Gfx::IntPoint(column, row), converter.convert_yuv_to_full_range_rgb(y_sample, u_sample, v_sample));
-
-            /*auto r_float = clamp(y_sample + (v_sample - 128) * 219.0f / 224.0f * 1.5748f, 0, 255);
-            auto g_float = clamp(y_sample + (u_sample - 128) * 219.0f / 224.0f * -0.0722f * 1.8556f / 0.7152f + (v_sample - 128) * 219.0f / 224.0f * -0.2126f * 1.5748f / 0.7152f, 0, 255);
-            auto b_float = clamp(y_sample + (u_sample - 128) * 219.0f / 224.0f * 1.8556f, 0, 255);
-            auto r = static_cast<u8>(r_float);
-            auto g = static_cast<u8>(g_float);
-            auto b = static_cast<u8>(b_float);
-            bitmap.set_pixel(Gfx::IntPoint(column, row), Color(r, g, b));*/
-        }
+        // The pixels are written straight into the scanline, which is as wide as the frame.
+        converter.convert_yuv_to_full_range_rgb(m_plane_y.span().slice(row * width, width), u_sample_row.span(), v_sample_row.span(), { bitmap.scanline(row), width });
     }
 
     return {};
@@ -120,15 +120,33 @@ void CommandBufferBuilder::append_transfer3d(Protocol::ResourceID resource, size
     builder.appendu32(direction); // direction
 }
 
+void CommandBufferBuilder::append_transfer3d(Protocol::ResourceID resource, Gfx::IntRect box, u32 stride, size_t direction)
+{
+    CommandBuilder builder(m_buffer, Protocol::VirGLCommand::TRANSFER3D, Protocol::ObjectType::NONE);
+    builder.appendu32(resource.value()); // res_handle
+    builder.appendu32(0);                // level
+    builder.appendu32(242);              // usage
+    builder.appendu32(stride);           // stride
+    builder.appendu32(0);                // layer_stride
+    builder.appendu32(box.x());          // x
+    builder.appendu32(box.y());          // y
+    builder.appendu32(0);                // z
+    builder.appendu32(box.width());      // width
+    builder.appendu32(box.height());     // height
+    builder.appendu32(1);                // depth
+    builder.appendu32(0);                // data_offset
+    builder.appendu32(direction);        // direction
+}
+
 void CommandBufferBuilder::append_end_transfers_3d()
 {
     CommandBuilder builder(m_buffer, Protocol::VirGLCommand::END_TRANSFERS, Protocol::ObjectType::NONE);
 }
 
-void CommandBufferBuilder::append_draw_vbo(Protocol::PipePrimitiveTypes primitive_type, u32 count)
+void CommandBufferBuilder::append_draw_vbo(Protocol::PipePrimitiveTypes primitive_type, u32 count, u32 start)
 {
     CommandBuilder builder(m_buffer, Protocol::VirGLCommand::DRAW_VBO, Protocol::ObjectType::NONE);
-    builder.appendu32(0);                             // start
+    builder.appendu32(start);                         // start
     builder.appendu32(count);                         // count
     builder.appendu32(to_underlying(primitive_type)); // mode
     builder.appendu32(0);                             // indexed
@@ -179,15 +197,20 @@ void CommandBufferBuilder::append_set_vertex_buffers(u32 stride, u32 offset, Pro
 }
 
 void CommandBufferBuilder::append_create_blend(Protocol::ObjectHandle handle)
+{
+    CreateBlendCommand::S2Flags s2 {};
+    s2.colormask = 0xf;
+    append_create_blend(handle, s2);
+}
+
+void CommandBufferBuilder::append_create_blend(Protocol::ObjectHandle handle, CreateBlendCommand::S2Flags s2)
 {
     CommandBuilder builder(m_buffer, Protocol::VirGLCommand::CREATE_OBJECT, Protocol::ObjectType::BLEND);
 
     CreateBlendCommand::S0Flags s0 {};
     CreateBlendCommand::S1Flags s1 {};
-    CreateBlendCommand::S2Flags s2 {};
 
     s0.dither = 1;
-    s2.colormask = 0xf;
 
     builder.appendu32(handle.value());
     builder.appendu32(s0.u32_value);
@@ -244,12 +267,12 @@ void CommandBufferBuilder::append_viewport(Gfx::IntSize size)
 {
     CommandBuilder builder(m_buffer, Protocol::VirGLCommand::SET_VIEWPORT_STATE, Protocol::ObjectType::NONE);
     builder.appendu32(0);
-    builder.appendf32(size.width() / 2);  // scale_x
-    builder.appendf32(size.height() / 2); // scale_y (flipped, due to VirGL being different from our coordinate space)
-    builder.appendf32(0.5f);              // scale_z
-    builder.appendf32(size.width() / 2);  // translate_x
-    builder.appendf32(size.height() / 2); // translate_y
-    builder.appendf32(0.5f);              // translate_z
+    builder.appendf32(size.width() / 2.0f);  // scale_x
+    builder.appendf32(size.height() / 2.0f); // scale_y (flipped, due to VirGL being different from our coordinate space)
+    builder.appendf32(0.5f);                 // scale_z
+    builder.appendf32(size.width() / 2.0f);  // translate_x
+    builder.appendf32(size.height() / 2.0f); // translate_y
+    builder.appendf32(0.5f);                 // translate_z
 }
 
 void CommandBufferBuilder::append_set_framebuffer_state_no_attach(Gfx::IntSize size)
@@ -298,14 +321,18 @@ void CommandBufferBuilder::append_bind_shader(Protocol::ObjectHandle handle, Gal
 }
 
 void CommandBufferBuilder::append_create_rasterizer(Protocol::ObjectHandle handle)
+{
+    CreateRasterizerCommand::S0Flags s0 {};
+    s0.depth_clip = 1;
+    append_create_rasterizer(handle, s0);
+}
+
+void CommandBufferBuilder::append_create_rasterizer(Protocol::ObjectHandle handle, CreateRasterizerCommand::S0Flags s0)
 {
     CommandBuilder builder(m_buffer, Protocol::VirGLCommand::CREATE_OBJECT, Protocol::ObjectType::RASTERIZER);
 
-    CreateRasterizerCommand::S0Flags s0 {};
     CreateRasterizerCommand::S3Flags s3 {};
 
-    s0.depth_clip = 1;
-
     builder.appendu32(handle.value()); // Handle
     builder.appendu32(s0.u32_value);   // S0 (bitfield of state bits)
     builder.appendf32(1.0);            // Point size
@@ -325,14 +352,18 @@ void CommandBufferBuilder::append_bind_rasterizer(Protocol::ObjectHandle handle)
 
 void CommandBufferBuilder::append_create_dsa(Protocol::ObjectHandle handle)
 {
-    CommandBuilder builder(m_buffer, Protocol::VirGLCommand::CREATE_OBJECT, Protocol::ObjectType::DSA);
-
     CreateDSACommand::S0Flags s0 {};
-    CreateDSACommand::S1Flags s1[2] {};
-
     s0.depth_enabled = 1;
     s0.depth_writemask = 1;
     s0.depth_func = 1;
+    append_create_dsa(handle, s0);
+}
+
+void CommandBufferBuilder::append_create_dsa(Protocol::ObjectHandle handle, CreateDSACommand::S0Flags s0)
+{
+    CommandBuilder builder(m_buffer, Protocol::VirGLCommand::CREATE_OBJECT, Protocol::ObjectType::DSA);
+
+    CreateDSACommand::S1Flags s1[2] {};
 
     builder.appendu32(handle.value());  // Handle
     builder.appendu32(s0.u32_value);    // S0 (bitset for depth buffer)
@@ -347,4 +378,45 @@ void CommandBufferBuilder::append_bind_dsa(Protocol::ObjectHandle handle)
     builder.appendu32(handle.value()); // VIRGL_OBJ_BIND_HANDLE
 }
 
+void CommandBufferBuilder::append_create_sampler_view(Protocol::ObjectHandle handle, Protocol::ResourceID resource, Protocol::TextureFormat format, CreateSamplerViewCommand::Swizzle swizzle)
+{
+    CommandBuilder builder(m_buffer, Protocol::VirGLCommand::CREATE_OBJECT, Protocol::ObjectType::SAMPLER_VIEW);
+    builder.appendu32(handle.value());    // Handle
+    builder.appendu32(resource.value());  // Resource handle
+    builder.appendu32(to_underlying(format));
+    builder.appendu32(0);                 // First layer / Last layer
+    builder.appendu32(0);                 // First level / Last level
+    builder.appendu32(swizzle.u32_value); // Swizzle
+}
+
+void CommandBufferBuilder::append_set_sampler_views(Gallium::ShaderType shader_type, ReadonlySpan<Protocol::ObjectHandle> handles)
+{
+    CommandBuilder builder(m_buffer, Protocol::VirGLCommand::SET_SAMPLER_VIEWS, Protocol::ObjectType::NONE);
+    builder.appendu32(to_underlying(shader_type));
+    builder.appendu32(0); // Start slot
+    for (auto handle : handles)
+        builder.appendu32(handle.value());
+}
+
+void CommandBufferBuilder::append_create_sampler_state(Protocol::ObjectHandle handle, CreateSamplerStateCommand::S0Flags s0)
+{
+    CommandBuilder builder(m_buffer, Protocol::VirGLCommand::CREATE_OBJECT, Protocol::ObjectType::SAMPLER_STATE);
+    builder.appendu32(handle.value()); // Handle
+    builder.appendu32(s0.u32_value);   // S0 (bitfield of state bits)
+    builder.appendf32(0.0f);           // LOD bias
+    builder.appendf32(0.0f);           // Min LOD
+    builder.appendf32(0.0f);           // Max LOD
+    for (size_t i = 0; i < 4; ++i)
+        builder.appendu32(0); // Border color
+}
+
+void CommandBufferBuilder::append_bind_sampler_states(Gallium::ShaderType shader_type, ReadonlySpan<Protocol::ObjectHandle> handles)
+{
+    CommandBuilder builder(m_buffer, Protocol::VirGLCommand::BIND_SAMPLER_STATES, Protocol::ObjectType::NONE);
+    builder.appendu32(to_underlying(shader_type));
+    builder.appendu32(0); // Start slot
+    for (auto handle : handles)
+        builder.appendu32(handle.value());
+}
+
 }
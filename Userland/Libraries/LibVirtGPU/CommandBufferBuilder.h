@@ -8,8 +8,10 @@
 
 #pragma once
 
+#include <AK/Span.h>
 #include <AK/StringView.h>
 #include <AK/Vector.h>
+#include <LibGfx/Rect.h>
 #include <LibGfx/Size.h>
 #include <LibVirtGPU/Commands.h>
 #include <LibVirtGPU/VirGLProtocol.h>
@@ -21,12 +23,14 @@ class CommandBufferBuilder {
 public:
     void append_set_tweaks(u32 id, u32 value);
     void append_transfer3d(Protocol::ResourceID resource, size_t width, size_t height = 1, size_t depth = 1, size_t direction = VIRGL_DATA_DIR_GUEST_TO_HOST);
+    void append_transfer3d(Protocol::ResourceID resource, Gfx::IntRect box, u32 stride, size_t direction);
     void append_end_transfers_3d();
-    void append_draw_vbo(Protocol::PipePrimitiveTypes, u32 count);
+    void append_draw_vbo(Protocol::PipePrimitiveTypes, u32 count, u32 start = 0);
     void append_clear(float r, float g, float b, float a);
     void append_clear(double depth);
     void append_set_vertex_buffers(u32 stride, u32 offset, Protocol::ResourceID resource);
     void append_create_blend(Protocol::ObjectHandle handle);
+    void append_create_blend(Protocol::ObjectHandle handle, CreateBlendCommand::S2Flags);
     void append_bind_blend(Protocol::ObjectHandle handle);
     void append_create_surface(Protocol::ResourceID drawtarget_resource, Protocol::ObjectHandle drawtarget_handle, Protocol::TextureFormat format);
     void append_set_framebuffer_state(Protocol::ObjectHandle drawtarget, Protocol::ObjectHandle depthbuffer = 0);
@@ -38,11 +42,21 @@ public:
     void append_create_shader(Protocol::ObjectHandle handle, Gallium::ShaderType shader_type, StringView shader_data);
     void append_bind_shader(Protocol::ObjectHandle handle, Gallium::ShaderType shader_type);
     void append_create_rasterizer(Protocol::ObjectHandle handle);
+    void append_create_rasterizer(Protocol::ObjectHandle handle, CreateRasterizerCommand::S0Flags);
     void append_bind_rasterizer(Protocol::ObjectHandle handle);
     void append_create_dsa(Protocol::ObjectHandle handle);
+    void append_create_dsa(Protocol::ObjectHandle handle, CreateDSACommand::S0Flags);
     void append_bind_dsa(Protocol::ObjectHandle handle);
+    void append_create_sampler_view(Protocol::ObjectHandle handle, Protocol::ResourceID resource, Protocol::TextureFormat format, CreateSamplerViewCommand::Swizzle);
+    void append_set_sampler_views(Gallium::ShaderType shader_type, ReadonlySpan<Protocol::ObjectHandle> handles);
+    void append_create_sampler_state(Protocol::ObjectHandle handle, CreateSamplerStateCommand::S0Flags);
+    void append_bind_sampler_states(Gallium::ShaderType shader_type, ReadonlySpan<Protocol::ObjectHandle> handles);
     Vector<u32> const& build() { return m_buffer; }
 
+    bool is_empty() const { return m_buffer.is_empty(); }
+    size_t size_in_words() const { return m_buffer.size(); }
+    void clear() { m_buffer.clear_with_capacity(); }
+
 private:
     Vector<u32> m_buffer;
 };
@@ -48,6 +48,37 @@ struct CreateBlendCommand {
     };
 };
 
+struct CreateSamplerViewCommand {
+    union Swizzle {
+        struct {
+            u32 r : 3;
+            u32 g : 3;
+            u32 b : 3;
+            u32 a : 3;
+            u32 unused : 20;
+        };
+        u32 u32_value;
+    };
+};
+
+struct CreateSamplerStateCommand {
+    union S0Flags {
+        struct {
+            u32 wrap_s : 3;
+            u32 wrap_t : 3;
+            u32 wrap_r : 3;
+            u32 min_img_filter : 2;
+            u32 min_mip_filter : 2;
+            u32 mag_img_filter : 2;
+            u32 compare_mode : 1;
+            u32 compare_func : 3;
+            u32 seamless_cube_map : 1;
+            u32 unused : 12;
+        };
+        u32 u32_value;
+    };
+};
+
 struct CreateVertexElementsCommand {
     struct ElementBinding {
         u32 offset;
@@ -0,0 +1,401 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <Kernel/API/VirGL.h>
+#include <LibCore/System.h>
+#include <LibVirtGPU/Commands.h>
+#include <LibVirtGPU/QuadRenderer.h>
+
+namespace VirtGPU {
+
+static constexpr auto vertex_shader = "VERT\n"
+                                      "DCL IN[0]\n"
+                                      "DCL IN[1]\n"
+                                      "DCL IN[2]\n"
+                                      "DCL OUT[0], POSITION\n"
+                                      "DCL OUT[1], GENERIC[0]\n"
+                                      "DCL OUT[2], COLOR\n"
+                                      "IMM[0] FLT32 { 0.0000, 1.0000, 0.0000, 0.0000 }\n"
+                                      "  0: MOV OUT[0].xy, IN[0].xyxx\n"
+                                      "  1: MOV OUT[0].zw, IMM[0].xxxy\n"
+                                      "  2: MOV OUT[1], IN[1]\n"
+                                      "  3: MOV OUT[2], IN[2]\n"
+                                      "  4: END\n"sv;
+
+static constexpr auto fragment_shader = "FRAG\n"
+                                        "PROPERTY FS_COLOR0_WRITES_ALL_CBUFS 1\n"
+                                        "DCL IN[0], GENERIC[0], PERSPECTIVE\n"
+                                        "DCL IN[1], COLOR, COLOR\n"
+                                        "DCL OUT[0], COLOR\n"
+                                        "DCL SAMP[0]\n"
+                                        "DCL SVIEW[0], RECT, FLOAT\n"
+                                        "DCL TEMP[0]\n"
+                                        "  0: TEX TEMP[0], IN[0], SAMP[0], RECT\n"
+                                        "  1: MUL OUT[0], TEMP[0], IN[1]\n"
+                                        "  2: END\n"sv;
+
+// The weights of Color::luminosity(), times the 0.75 of Color::darkened() that unresponsive windows get.
+static constexpr auto darkened_grayscale_fragment_shader = "FRAG\n"
+                                                           "PROPERTY FS_COLOR0_WRITES_ALL_CBUFS 1\n"
+                                                           "DCL IN[0], GENERIC[0], PERSPECTIVE\n"
+                                                           "DCL IN[1], COLOR, COLOR\n"
+                                                           "DCL OUT[0], COLOR\n"
+                                                           "DCL SAMP[0]\n"
+                                                           "DCL SVIEW[0], RECT, FLOAT\n"
+                                                           "DCL TEMP[0]\n"
+                                                           "IMM[0] FLT32 { 0.1595, 0.5364, 0.0542, 0.0000 }\n"
+                                                           "  0: TEX TEMP[0], IN[0], SAMP[0], RECT\n"
+                                                           "  1: DP3 TEMP[0].xyz, TEMP[0], IMM[0]\n"
+                                                           "  2: MUL OUT[0], TEMP[0], IN[1]\n"
+                                                           "  3: END\n"sv;
+
+static constexpr size_t transfer_region_size = VIRGL_TRANSFER_REGION_PAGES * PAGE_SIZE;
+static constexpr size_t vertex_buffer_size = PAGE_SIZE * 256;
+
+// The kernel copies a command buffer into a scratch space of 32 pages, so we stay well below that.
+static constexpr size_t max_command_buffer_words = 8 * PAGE_SIZE / sizeof(u32);
+
+ErrorOr<NonnullOwnPtr<QuadRenderer>> QuadRenderer::create()
+{
+    auto file = TRY(Core::File::open("/dev/gpu/render0"sv, Core::File::OpenMode::ReadWrite));
+    auto renderer = TRY(adopt_nonnull_own_or_enomem(new (nothrow) QuadRenderer(move(file))));
+    TRY(renderer->initialize());
+    return renderer;
+}
+
+QuadRenderer::QuadRenderer(NonnullOwnPtr<Core::File> gpu_file)
+    : m_gpu_file(move(gpu_file))
+{
+}
+
+ErrorOr<void> QuadRenderer::initialize()
+{
+    TRY(Core::System::ioctl(m_gpu_file->fd(), VIRGL_IOCTL_CREATE_CONTEXT));
+
+    VirGL3DResourceSpec vbo_spec {
+        .target = to_underlying(Gallium::PipeTextureTarget::BUFFER),
+        .format = 0,
+        .bind = to_underlying(Protocol::BindTarget::VIRGL_BIND_VERTEX_BUFFER),
+        .width = static_cast<u32>(vertex_buffer_size),
+        .height = 1,
+        .depth = 1,
+        .array_size = 1,
+        .last_level = 0,
+        .nr_samples = 0,
+        .flags = 0,
+        .created_resource_id = 0,
+    };
+    m_vbo_resource_id = TRY(create_virgl_resource(vbo_spec));
+
+    CommandBufferBuilder builder;
+
+    // Blend everything over what's already there, like Color::blend() does.
+    CreateBlendCommand::S2Flags blend {};
+    blend.blend_enable = 1;
+    blend.rgb_func = to_underlying(Gallium::PipeBlendFunction::ADD);
+    blend.rgb_src_factor = to_underlying(Gallium::PipeBlendFactor::SRC_ALPHA);
+    blend.rgb_dst_factor = to_underlying(Gallium::PipeBlendFactor::INV_SRC_ALPHA);
+    blend.alpha_func = to_underlying(Gallium::PipeBlendFunction::ADD);
+    blend.alpha_src_factor = to_underlying(Gallium::PipeBlendFactor::ONE);
+    blend.alpha_dst_factor = to_underlying(Gallium::PipeBlendFactor::INV_SRC_ALPHA);
+    blend.colormask = 0xf;
+    auto blend_handle = allocate_handle();
+    builder.append_create_blend(blend_handle, blend);
+    builder.append_bind_blend(blend_handle);
+
+    // There is no depth buffer to test against.
+    auto dsa_handle = allocate_handle();
+    builder.append_create_dsa(dsa_handle, {});
+    builder.append_bind_dsa(dsa_handle);
+
+    CreateRasterizerCommand::S0Flags rasterizer {};
+    rasterizer.depth_clip = 1;
+    rasterizer.half_pixel_center = 1;
+    auto rasterizer_handle = allocate_handle();
+    builder.append_create_rasterizer(rasterizer_handle, rasterizer);
+    builder.append_bind_rasterizer(rasterizer_handle);
+
+    CreateSamplerStateCommand::S0Flags sampler {};
+    sampler.wrap_s = to_underlying(Gallium::PipeTextureWrap::CLAMP_TO_EDGE);
+    sampler.wrap_t = to_underlying(Gallium::PipeTextureWrap::CLAMP_TO_EDGE);
+    sampler.wrap_r = to_underlying(Gallium::PipeTextureWrap::CLAMP_TO_EDGE);
+    sampler.min_img_filter = to_underlying(Gallium::PipeTextureFilter::NEAREST);
+    sampler.min_mip_filter = to_underlying(Gallium::PipeTextureMipFilter::NONE);
+    sampler.mag_img_filter = to_underlying(Gallium::PipeTextureFilter::NEAREST);
+    Array<Protocol::ObjectHandle, 1> sampler_handles { allocate_handle() };
+    builder.append_create_sampler_state(sampler_handles[0], sampler);
+    builder.append_bind_sampler_states(Gallium::ShaderType::SHADER_FRAGMENT, sampler_handles);
+
+    auto vertex_shader_handle = allocate_handle();
+    builder.append_create_shader(vertex_shader_handle, Gallium::ShaderType::SHADER_VERTEX, vertex_shader);
+    builder.append_bind_shader(vertex_shader_handle, Gallium::ShaderType::SHADER_VERTEX);
+
+    m_fragment_shader = allocate_handle();
+    builder.append_create_shader(m_fragment_shader, Gallium::ShaderType::SHADER_FRAGMENT, fragment_shader);
+    m_darkened_grayscale_fragment_shader = allocate_handle();
+    builder.append_create_shader(m_darkened_grayscale_fragment_shader, Gallium::ShaderType::SHADER_FRAGMENT, darkened_grayscale_fragment_shader);
+
+    auto vertex_elements_handle = allocate_handle();
+    Vector<CreateVertexElementsCommand::ElementBinding> element_bindings {
+        { .offset = offsetof(Vertex, x), .divisor = 0, .vertex_buffer_index = 0, .format = Gallium::PipeFormat::R32G32_FLOAT },
+        { .offset = offsetof(Vertex, u), .divisor = 0, .vertex_buffer_index = 0, .format = Gallium::PipeFormat::R32G32_FLOAT },
+        { .offset = offsetof(Vertex, r), .divisor = 0, .vertex_buffer_index = 0, .format = Gallium::PipeFormat::R32G32B32A32_FLOAT },
+    };
+    builder.append_create_vertex_elements(vertex_elements_handle, element_bindings);
+    builder.append_bind_vertex_elements(vertex_elements_handle);
+    builder.append_set_vertex_buffers(sizeof(Vertex), 0, m_vbo_resource_id);
+
+    TRY(submit(builder));
+
+    // Fills are draws of a single white texel, multiplied by their color.
+    auto white_texture = TRY(create_texture({ 1, 1 }));
+    auto white_bitmap = TRY(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 1, 1 }));
+    white_bitmap->set_pixel(0, 0, Color::White);
+    TRY(upload(white_texture, {}, *white_bitmap, white_bitmap->rect()));
+    m_white_texture = white_texture;
+
+    return {};
+}
+
+ErrorOr<QuadRenderer::Texture> QuadRenderer::create_texture(Gfx::IntSize size)
+{
+    VERIFY(!size.is_empty());
+
+    VirGL3DResourceSpec spec {
+        .target = to_underlying(Gallium::PipeTextureTarget::TEXTURE_RECT),
+        .format = to_underlying(Protocol::TextureFormat::VIRTIO_GPU_FORMAT_B8G8R8A8_UNORM),
+        .bind = to_underlying(Protocol::BindTarget::VIRGL_BIND_SAMPLER_VIEW) | to_underlying(Protocol::BindTarget::VIRGL_BIND_RENDER_TARGET),
+        .width = static_cast<u32>(size.width()),
+        .height = static_cast<u32>(size.height()),
+        .depth = 1,
+        .array_size = 1,
+        .last_level = 0,
+        .nr_samples = 0,
+        .flags = 0,
+        .created_resource_id = 0,
+    };
+
+    Texture texture;
+    texture.resource = TRY(create_virgl_resource(spec));
+    texture.size = size;
+
+    CommandBufferBuilder builder;
+
+    CreateSamplerViewCommand::Swizzle swizzle {};
+    swizzle.r = to_underlying(Gallium::PipeSwizzle::X);
+    swizzle.g = to_underlying(Gallium::PipeSwizzle::Y);
+    swizzle.b = to_underlying(Gallium::PipeSwizzle::Z);
+    swizzle.a = to_underlying(Gallium::PipeSwizzle::W);
+    texture.sampler_view = allocate_handle();
+    builder.append_create_sampler_view(texture.sampler_view, texture.resource, Protocol::TextureFormat::VIRTIO_GPU_FORMAT_B8G8R8A8_UNORM, swizzle);
+
+    swizzle.a = to_underlying(Gallium::PipeSwizzle::ONE);
+    texture.opaque_sampler_view = allocate_handle();
+    builder.append_create_sampler_view(texture.opaque_sampler_view, texture.resource, Protocol::TextureFormat::VIRTIO_GPU_FORMAT_B8G8R8A8_UNORM, swizzle);
+
+    texture.surface = allocate_handle();
+    builder.append_create_surface(texture.resource, texture.surface, Protocol::TextureFormat::VIRTIO_GPU_FORMAT_B8G8R8A8_UNORM);
+
+    TRY(submit(builder));
+    return texture;
+}
+
+ErrorOr<void> QuadRenderer::upload(Texture const& texture, Gfx::IntPoint destination, Gfx::Bitmap const& bitmap, Gfx::IntRect const& source_rect)
+{
+    VERIFY(bitmap.bpp() == 32);
+    VERIFY(bitmap.physical_rect().contains(source_rect));
+    VERIFY(Gfx::IntRect({}, texture.size).contains({ destination, source_rect.size() }));
+
+    if (source_rect.is_empty())
+        return {};
+    TRY(flush());
+
+    // The rows go into the transfer region as they are in the bitmap, so we don't have to repack them.
+    auto pitch = bitmap.pitch();
+    auto row_size = source_rect.width() * sizeof(Gfx::ARGB32);
+    if (pitch > transfer_region_size)
+        return Error::from_errno(EOVERFLOW);
+    int rows_per_transfer = transfer_region_size / pitch;
+
+    CommandBufferBuilder builder;
+    for (int y = 0; y < source_rect.height(); y += rows_per_transfer) {
+        int rows = min(rows_per_transfer, source_rect.height() - y);
+        auto const* data = bitmap.scanline_u8(source_rect.y() + y) + source_rect.x() * sizeof(Gfx::ARGB32);
+        TRY(transfer_data(data, (rows - 1) * pitch + row_size, VIRGL_DATA_DIR_GUEST_TO_HOST));
+
+        builder.append_transfer3d(texture.resource, { destination.x(), destination.y() + y, source_rect.width(), rows }, pitch, VIRGL_DATA_DIR_GUEST_TO_HOST);
+        builder.append_end_transfers_3d();
+        TRY(submit(builder));
+    }
+    return {};
+}
+
+ErrorOr<void> QuadRenderer::read_back(Texture const& texture, Gfx::IntRect const& source_rect, Gfx::Bitmap& bitmap, Gfx::IntPoint destination)
+{
+    VERIFY(bitmap.bpp() == 32);
+    VERIFY(Gfx::IntRect({}, texture.size).contains(source_rect));
+    VERIFY(bitmap.physical_rect().contains({ destination, source_rect.size() }));
+
+    if (source_rect.is_empty())
+        return {};
+    TRY(flush());
+
+    // Unlike for uploads, the transfer would overwrite whatever lies between the rows, so they come back packed.
+    auto row_size = source_rect.width() * sizeof(Gfx::ARGB32);
+    int rows_per_transfer = transfer_region_size / row_size;
+    TRY(m_read_back_buffer.try_resize(min<size_t>(source_rect.height(), rows_per_transfer) * row_size));
+
+    CommandBufferBuilder builder;
+    for (int y = 0; y < source_rect.height(); y += rows_per_transfer) {
+        int rows = min(rows_per_transfer, source_rect.height() - y);
+        builder.append_transfer3d(texture.resource, { source_rect.x(), source_rect.y() + y, source_rect.width(), rows }, row_size, VIRGL_DATA_DIR_HOST_TO_GUEST);
+        builder.append_end_transfers_3d();
+        TRY(submit(builder));
+
+        TRY(transfer_data(m_read_back_buffer.data(), rows * row_size, VIRGL_DATA_DIR_HOST_TO_GUEST));
+        for (int row = 0; row < rows; ++row) {
+            auto* destination_row = bitmap.scanline_u8(destination.y() + y + row) + destination.x() * sizeof(Gfx::ARGB32);
+            memcpy(destination_row, m_read_back_buffer.data() + row * row_size, row_size);
+        }
+    }
+    return {};
+}
+
+ErrorOr<void> QuadRenderer::set_target(Texture const& texture)
+{
+    TRY(flush());
+
+    CommandBufferBuilder builder;
+    builder.append_set_framebuffer_state(texture.surface);
+    builder.append_viewport(texture.size);
+    TRY(submit(builder));
+
+    m_target_size = texture.size;
+    m_has_target = true;
+    return {};
+}
+
+ErrorOr<void> QuadRenderer::draw(Texture const& texture, Gfx::IntRect const& source_rect, Gfx::IntRect const& destination_rect, Color color, QuadDrawOptions options)
+{
+    VERIFY(m_has_target);
+    if (source_rect.is_empty() || destination_rect.is_empty() || color.alpha() == 0)
+        return {};
+
+    if ((m_vertices.size() + 6) * sizeof(Vertex) > vertex_buffer_size)
+        TRY(flush());
+
+    auto sampler_view = options.source_is_opaque ? texture.opaque_sampler_view : texture.sampler_view;
+    auto shader = options.darkened_grayscale ? m_darkened_grayscale_fragment_shader : m_fragment_shader;
+    if (m_runs.is_empty() || m_runs.last().sampler_view != sampler_view || m_runs.last().fragment_shader != shader)
+        TRY(m_runs.try_append({ sampler_view, shader, static_cast<u32>(m_vertices.size()), 0 }));
+
+    // The viewport puts -1 at the top of the target, which is also where its first row of memory is.
+    auto to_clip_x = [&](int x) { return 2.0f * x / m_target_size.width() - 1.0f; };
+    auto to_clip_y = [&](int y) { return 2.0f * y / m_target_size.height() - 1.0f; };
+
+    float left = to_clip_x(destination_rect.left());
+    float right = to_clip_x(destination_rect.left() + destination_rect.width());
+    float top = to_clip_y(destination_rect.top());
+    float bottom = to_clip_y(destination_rect.top() + destination_rect.height());
+
+    float u0 = source_rect.left();
+    float u1 = source_rect.left() + source_rect.width();
+    float v0 = source_rect.top();
+    float v1 = source_rect.top() + source_rect.height();
+
+    float r = color.red() / 255.0f;
+    float g = color.green() / 255.0f;
+    float b = color.blue() / 255.0f;
+    float a = color.alpha() / 255.0f;
+
+    Vertex top_left { left, top, u0, v0, r, g, b, a };
+    Vertex top_right { right, top, u1, v0, r, g, b, a };
+    Vertex bottom_left { left, bottom, u0, v1, r, g, b, a };
+    Vertex bottom_right { right, bottom, u1, v1, r, g, b, a };
+
+    TRY(m_vertices.try_append(top_left));
+    TRY(m_vertices.try_append(bottom_left));
+    TRY(m_vertices.try_append(top_right));
+    TRY(m_vertices.try_append(top_right));
+    TRY(m_vertices.try_append(bottom_left));
+    TRY(m_vertices.try_append(bottom_right));
+    m_runs.last().vertex_count += 6;
+    return {};
+}
+
+ErrorOr<void> QuadRenderer::fill(Gfx::IntRect const& rect, Color color)
+{
+    return draw(*m_white_texture, { 0, 0, 1, 1 }, rect, color);
+}
+
+ErrorOr<void> QuadRenderer::flush()
+{
+    if (m_vertices.is_empty())
+        return {};
+
+    auto vertex_data_size = m_vertices.size() * sizeof(Vertex);
+    TRY(transfer_data(m_vertices.data(), vertex_data_size, VIRGL_DATA_DIR_GUEST_TO_HOST));
+
+    CommandBufferBuilder builder;
+    builder.append_transfer3d(m_vbo_resource_id, vertex_data_size, 1, 1, VIRGL_DATA_DIR_GUEST_TO_HOST);
+    builder.append_end_transfers_3d();
+
+    for (auto& run : m_runs) {
+        if (builder.size_in_words() > max_command_buffer_words)
+            TRY(submit(builder));
+        Array<Protocol::ObjectHandle, 1> sampler_views { run.sampler_view };
+        builder.append_set_sampler_views(Gallium::ShaderType::SHADER_FRAGMENT, sampler_views);
+        builder.append_bind_shader(run.fragment_shader, Gallium::ShaderType::SHADER_FRAGMENT);
+        builder.append_draw_vbo(Protocol::PipePrimitiveTypes::TRIANGLES, run.vertex_count, run.first_vertex);
+    }
+
+    m_vertices.clear_with_capacity();
+    m_runs.clear_with_capacity();
+    return submit(builder);
+}
+
+Protocol::ObjectHandle QuadRenderer::allocate_handle()
+{
+    return { ++m_last_allocated_handle };
+}
+
+ErrorOr<Protocol::ResourceID> QuadRenderer::create_virgl_resource(VirGL3DResourceSpec& spec)
+{
+    TRY(Core::System::ioctl(m_gpu_file->fd(), VIRGL_IOCTL_CREATE_RESOURCE, &spec));
+    return Protocol::ResourceID { spec.created_resource_id };
+}
+
+ErrorOr<void> QuadRenderer::transfer_data(void const* data, size_t size, int direction)
+{
+    VERIFY(size <= transfer_region_size);
+    VirGLTransferDescriptor descriptor {
+        .data = const_cast<void*>(data),
+        .offset_in_region = 0,
+        .num_bytes = size,
+        .direction = direction,
+    };
+    TRY(Core::System::ioctl(m_gpu_file->fd(), VIRGL_IOCTL_TRANSFER_DATA, &descriptor));
+    return {};
+}
+
+ErrorOr<void> QuadRenderer::submit(CommandBufferBuilder& builder)
+{
+    if (builder.is_empty())
+        return {};
+
+    auto& command_buffer = builder.build();
+    VERIFY(command_buffer.size() <= NumericLimits<u32>::max());
+    VirGLCommandBuffer command_buffer_descriptor {
+        .data = command_buffer.data(),
+        .num_elems = static_cast<u32>(command_buffer.size()),
+    };
+    TRY(Core::System::ioctl(m_gpu_file->fd(), VIRGL_IOCTL_SUBMIT_CMD, &command_buffer_descriptor));
+    builder.clear();
+    return {};
+}
+
+}
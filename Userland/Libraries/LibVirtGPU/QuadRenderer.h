@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <Kernel/API/VirGL.h>
+#include <LibCore/File.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Color.h>
+#include <LibGfx/Rect.h>
+#include <LibVirtGPU/CommandBufferBuilder.h>
+#include <LibVirtGPU/VirGLProtocol.h>
+
+namespace VirtGPU {
+
+struct QuadDrawOptions {
+    bool source_is_opaque { false };
+    // Draws the luminosity of each texel, darkened like we do for the windows of unresponsive clients.
+    bool darkened_grayscale { false };
+};
+
+// Blends rectangles of textures onto other textures with the host's GPU, which is what a 2D compositor needs.
+// Unlike Device, this isn't a GPU::Device for LibGL: all coordinates are in pixels, with the origin at the top left,
+// just like in a Gfx::Bitmap, and everything is drawn with nearest-neighbor sampling.
+// NOTE: The kernel can't destroy resources yet, so textures live as long as the renderer. Callers should reuse them.
+class QuadRenderer {
+public:
+    struct Texture {
+        Protocol::ResourceID resource { 0 };
+        Protocol::ObjectHandle sampler_view { 0 };
+        // Samples the same texels, but as if every one of them was opaque.
+        Protocol::ObjectHandle opaque_sampler_view { 0 };
+        Protocol::ObjectHandle surface { 0 };
+        Gfx::IntSize size;
+    };
+
+    static ErrorOr<NonnullOwnPtr<QuadRenderer>> create();
+
+    explicit QuadRenderer(NonnullOwnPtr<Core::File>);
+
+    ErrorOr<Texture> create_texture(Gfx::IntSize);
+
+    // Copies `source_rect` of `bitmap` into `texture`, with its top left corner at `destination`.
+    // This happens after everything that was drawn before, so it doesn't change what they sampled.
+    ErrorOr<void> upload(Texture const&, Gfx::IntPoint destination, Gfx::Bitmap const&, Gfx::IntRect const& source_rect);
+
+    // Copies `source_rect` of `texture` into `bitmap`, with its top left corner at `destination`.
+    ErrorOr<void> read_back(Texture const&, Gfx::IntRect const& source_rect, Gfx::Bitmap&, Gfx::IntPoint destination);
+
+    ErrorOr<void> set_target(Texture const&);
+
+    // Blends `source_rect` of `texture`, stretched over `destination_rect`, onto the target, multiplying each texel by `color`.
+    ErrorOr<void> draw(Texture const&, Gfx::IntRect const& source_rect, Gfx::IntRect const& destination_rect, Color color = Color::White, QuadDrawOptions = {});
+    ErrorOr<void> fill(Gfx::IntRect const&, Color);
+
+    // Submits everything that was drawn since the last flush.
+    ErrorOr<void> flush();
+
+private:
+    struct Vertex {
+        float x;
+        float y;
+        float u;
+        float v;
+        float r;
+        float g;
+        float b;
+        float a;
+    };
+
+    struct Run {
+        Protocol::ObjectHandle sampler_view;
+        Protocol::ObjectHandle fragment_shader;
+        u32 first_vertex { 0 };
+        u32 vertex_count { 0 };
+    };
+
+    ErrorOr<void> initialize();
+    Protocol::ObjectHandle allocate_handle();
+    ErrorOr<Protocol::ResourceID> create_virgl_resource(VirGL3DResourceSpec&);
+    ErrorOr<void> transfer_data(void const* data, size_t size, int direction);
+    ErrorOr<void> submit(CommandBufferBuilder&);
+
+    NonnullOwnPtr<Core::File> m_gpu_file;
+    u32 m_last_allocated_handle { 0 };
+
+    Protocol::ResourceID m_vbo_resource_id { 0 };
+    Protocol::ObjectHandle m_fragment_shader { 0 };
+    Protocol::ObjectHandle m_darkened_grayscale_fragment_shader { 0 };
+    Optional<Texture> m_white_texture;
+
+    Gfx::IntSize m_target_size;
+    bool m_has_target { false };
+
+    Vector<Vertex> m_vertices;
+    Vector<Run> m_runs;
+    ByteBuffer m_read_back_buffer;
+};
+
+}
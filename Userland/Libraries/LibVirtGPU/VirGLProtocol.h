@@ -213,7 +213,46 @@ enum class ShaderType : u32 {
 };
 
 enum class PipeFormat : u32 {
-    R32G32B32_FLOAT = 30
+    R32G32_FLOAT = 29,
+    R32G32B32_FLOAT = 30,
+    R32G32B32A32_FLOAT = 31,
+};
+
+enum class PipeBlendFunction : u32 {
+    ADD = 0,
+};
+
+enum class PipeBlendFactor : u32 {
+    ONE = 0x01,
+    SRC_ALPHA = 0x03,
+    ZERO = 0x11,
+    INV_SRC_ALPHA = 0x13,
+};
+
+enum class PipeTextureWrap : u32 {
+    REPEAT = 0,
+    CLAMP = 1,
+    CLAMP_TO_EDGE = 2,
+};
+
+enum class PipeTextureFilter : u32 {
+    NEAREST = 0,
+    LINEAR = 1,
+};
+
+enum class PipeTextureMipFilter : u32 {
+    NEAREST = 0,
+    LINEAR = 1,
+    NONE = 2,
+};
+
+enum class PipeSwizzle : u32 {
+    X = 0,
+    Y = 1,
+    Z = 2,
+    W = 3,
+    ZERO = 4,
+    ONE = 5,
 };
 
 }
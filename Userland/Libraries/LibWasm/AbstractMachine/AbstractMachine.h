@@ -359,6 +359,14 @@ public:
                 return false;
         }
         auto previous_size = m_size;
+        // Reserve room for the declared maximum up front (within reason), so that growing doesn't have to
+        // reallocate and copy the whole memory each time, and the data pointer stays put.
+        if (new_size > m_data.capacity()) {
+            auto capacity_to_reserve = max(new_size, m_type.limits().max().value_or(0) * Constants::page_size);
+            capacity_to_reserve = min(capacity_to_reserve, max<u64>(new_size, Constants::max_reserved_memory_size));
+            if (m_data.try_ensure_capacity(capacity_to_reserve).is_error() && m_data.try_ensure_capacity(new_size).is_error())
+                return false;
+        }
         if (m_data.try_resize(new_size).is_error())
             return false;
         m_size = new_size;
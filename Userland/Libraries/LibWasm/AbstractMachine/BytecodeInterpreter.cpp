@@ -7,7 +7,6 @@
 
 #include <AK/Debug.h>
 #include <AK/Endian.h>
-#include <AK/MemoryStream.h>
 #include <LibWasm/AbstractMachine/AbstractMachine.h>
 #include <LibWasm/AbstractMachine/BytecodeInterpreter.h>
 #include <LibWasm/AbstractMachine/Configuration.h>
@@ -61,24 +60,22 @@ void BytecodeInterpreter::interpret(Configuration& configuration)
 void BytecodeInterpreter::branch_to_label(Configuration& configuration, LabelIndex index)
 {
     dbgln_if(WASM_TRACE_DEBUG, "Branch to label with index {}...", index.value());
-    auto label = configuration.nth_label(index.value());
-    dbgln_if(WASM_TRACE_DEBUG, "...which is actually IP {}, and has {} result(s)", label->continuation().value(), label->arity());
-    auto results = pop_values(configuration, label->arity());
-
-    size_t drop_count = index.value() + 1;
-    for (; !configuration.stack().is_empty();) {
-        auto& entry = configuration.stack().peek();
-        if (entry.has<Label>()) {
-            if (--drop_count == 0)
-                break;
-        }
-        configuration.stack().pop();
-    }
-
-    for (auto& result : results)
-        configuration.stack().push(move(result));
-
-    configuration.ip() = label->continuation();
+    auto label_index = configuration.nth_label_index(index.value());
+    TRAP_IF_NOT(label_index.has_value());
+    auto& entries = configuration.stack().entries();
+    auto label = entries[*label_index].get<Label>();
+    dbgln_if(WASM_TRACE_DEBUG, "...which is actually IP {}, and has {} result(s)", label.continuation().value(), label.arity());
+
+    // Drop everything between the label and its results, which moves the results right above the label.
+    auto first_entry_to_drop = *label_index + 1;
+    TRAP_IF_NOT(entries.size() - first_entry_to_drop >= label.arity());
+    auto first_result = entries.size() - label.arity();
+    for (size_t i = first_result; i < entries.size(); ++i)
+        TRAP_IF_NOT(entries[i].has<Value>());
+    if (first_result != first_entry_to_drop)
+        entries.remove(first_entry_to_drop, first_result - first_entry_to_drop);
+
+    configuration.ip() = label.continuation();
 }
 
 template<typename ReadType, typename PushType>
@@ -118,8 +115,12 @@ void BytecodeInterpreter::call_address(Configuration& configuration, FunctionAdd
     FunctionType const* type { nullptr };
     instance->visit([&](auto const& function) { type = &function.type(); });
     TRAP_IF_NOT(configuration.stack().entries().size() > type->parameters().size());
+    // NOTE: The arguments become the first locals of a wasm function, so leave room for the rest of them too.
+    auto argument_capacity = type->parameters().size();
+    if (auto* wasm_function = instance->get_pointer<WasmFunction>())
+        argument_capacity += wasm_function->code().locals().size();
     Vector<Value> args;
-    args.ensure_capacity(type->parameters().size());
+    args.ensure_capacity(argument_capacity);
     auto span = configuration.stack().entries().span().slice_from_end(type->parameters().size());
     for (auto& entry : span) {
         auto* call_argument = entry.get_pointer<Value>();
@@ -202,11 +203,7 @@ template<>
 struct ConvertToRaw<float> {
     u32 operator()(float value)
     {
-        LittleEndian<u32> res;
-        ReadonlyBytes bytes { &value, sizeof(float) };
-        FixedMemoryStream stream { bytes };
-        stream.read_entire_buffer(res.bytes()).release_value_but_fixme_should_propagate_errors();
-        return static_cast<u32>(res);
+        return LittleEndian<u32>(bit_cast<u32>(value));
     }
 };
 
@@ -214,11 +211,7 @@ template<>
 struct ConvertToRaw<double> {
     u64 operator()(double value)
     {
-        LittleEndian<u64> res;
-        ReadonlyBytes bytes { &value, sizeof(double) };
-        FixedMemoryStream stream { bytes };
-        stream.read_entire_buffer(res.bytes()).release_value_but_fixme_should_propagate_errors();
-        return static_cast<u64>(res);
+        return LittleEndian<u64>(bit_cast<u64>(value));
     }
 };
 
@@ -253,36 +246,22 @@ void BytecodeInterpreter::store_to_memory(Configuration& configuration, Instruct
 template<typename T>
 T BytecodeInterpreter::read_value(ReadonlyBytes data)
 {
+    VERIFY(data.size() >= sizeof(T));
     LittleEndian<T> value;
-    FixedMemoryStream stream { data };
-    auto maybe_error = stream.read_entire_buffer(value.bytes());
-    if (maybe_error.is_error()) {
-        dbgln("Read from {} failed", data.data());
-        m_trap = Trap { "Read from memory failed" };
-    }
+    __builtin_memcpy(&value, data.data(), sizeof(T));
     return value;
 }
 
 template<>
 float BytecodeInterpreter::read_value<float>(ReadonlyBytes data)
 {
-    LittleEndian<u32> raw_value;
-    FixedMemoryStream stream { data };
-    auto maybe_error = stream.read_entire_buffer(raw_value.bytes());
-    if (maybe_error.is_error())
-        m_trap = Trap { "Read from memory failed" };
-    return bit_cast<float>(static_cast<u32>(raw_value));
+    return bit_cast<float>(read_value<u32>(data));
 }
 
 template<>
 double BytecodeInterpreter::read_value<double>(ReadonlyBytes data)
 {
-    LittleEndian<u64> raw_value;
-    FixedMemoryStream stream { data };
-    auto maybe_error = stream.read_entire_buffer(raw_value.bytes());
-    if (maybe_error.is_error())
-        m_trap = Trap { "Read from memory failed" };
-    return bit_cast<double>(static_cast<u64>(raw_value));
+    return bit_cast<double>(read_value<u64>(data));
 }
 
 template<typename V, typename T>
@@ -330,21 +309,6 @@ MakeUnsigned<T> BytecodeInterpreter::checked_unsigned_truncate(V value)
     return true;
 }
 
-Vector<Value> BytecodeInterpreter::pop_values(Configuration& configuration, size_t count)
-{
-    Vector<Value> results;
-    results.resize(count);
-
-    for (size_t i = 0; i < count; ++i) {
-        auto top_of_stack = configuration.stack().pop();
-        if (auto value = top_of_stack.get_pointer<Value>())
-            results[i] = move(*value);
-        else
-            TRAP_IF_NOT_NORETURN(value);
-    }
-    return results;
-}
-
 void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPointer& ip, Instruction const& instruction)
 {
     dbgln_if(WASM_TRACE_DEBUG, "Executing instruction {} at ip {}", instruction_name(instruction.opcode()), ip.value());
@@ -41,6 +41,8 @@ static constexpr auto page_size = 64 * KiB;
 static constexpr auto minimum_stack_space_to_keep_free = 256 * KiB; // Note: Value is arbitrary and chosen by testing with ASAN
 static constexpr auto max_allowed_executed_instructions_per_call = 256 * 1024 * 1024;
 static constexpr auto max_allowed_vector_size = 500 * MiB;
+static constexpr size_t max_preallocated_vector_entries = 16 * KiB; // Note: Vectors with more entries than this grow as they are parsed.
+static constexpr auto max_reserved_memory_size = sizeof(FlatPtr) == 8 ? 1 * GiB : 64 * MiB; // Note: Upper bound on the address space a memory reserves for growing in place.
 static constexpr auto max_allowed_function_locals_per_type = 42069; // Note: VERY arbitrary.
 
 }
@@ -33,6 +33,9 @@ static auto parse_vector(Stream& stream)
         size_t count = count_or_error.release_value();
 
         Vector<ResultT> entries;
+        // NOTE: The count comes straight from the module, so only trust it up to a point.
+        if (entries.try_ensure_capacity(min(count, Constants::max_preallocated_vector_entries)).is_error())
+            return ParseResult<Vector<ResultT>> { ParseError::OutOfMemory };
         for (size_t i = 0; i < count; ++i) {
             auto result = T::parse(stream);
             if (result.is_error())
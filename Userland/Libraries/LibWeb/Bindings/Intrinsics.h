@@ -25,8 +25,10 @@ public:
     {
     }
 
+    // NOTE: These are called for every platform object that gets created, so they look up the class name as a
+    //       StringView rather than making a DeprecatedString of it every time.
     template<typename PrototypeType>
-    JS::Object& ensure_web_prototype(DeprecatedString const& class_name)
+    JS::Object& ensure_web_prototype(StringView class_name)
     {
         if (auto it = m_prototypes.find(class_name); it != m_prototypes.end())
             return *it->value;
@@ -36,7 +38,7 @@ public:
     }
 
     template<typename PrototypeType>
-    JS::NativeFunction& ensure_web_constructor(DeprecatedString const& class_name)
+    JS::NativeFunction& ensure_web_constructor(StringView class_name)
     {
         if (auto it = m_constructors.find(class_name); it != m_constructors.end())
             return *it->value;
@@ -62,13 +64,13 @@ private:
 }
 
 template<typename T>
-[[nodiscard]] JS::Object& ensure_web_prototype(JS::Realm& realm, DeprecatedString const& class_name)
+[[nodiscard]] JS::Object& ensure_web_prototype(JS::Realm& realm, StringView class_name)
 {
     return host_defined_intrinsics(realm).ensure_web_prototype<T>(class_name);
 }
 
 template<typename T>
-[[nodiscard]] JS::NativeFunction& ensure_web_constructor(JS::Realm& realm, DeprecatedString const& class_name)
+[[nodiscard]] JS::NativeFunction& ensure_web_constructor(JS::Realm& realm, StringView class_name)
 {
     return host_defined_intrinsics(realm).ensure_web_constructor<T>(class_name);
 }
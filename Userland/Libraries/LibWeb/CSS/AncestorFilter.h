@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/HashFunctions.h>
+#include <AK/NumericLimits.h>
+#include <AK/StringHash.h>
+#include <AK/StringView.h>
+
+namespace Web::CSS {
+
+// A counting Bloom filter of the tag names, ids and classes of the ancestors of the elements being restyled.
+// If a selector needs an ancestor with some tag name, id or class the filter doesn't contain, it can't match.
+// NOTE: Everything is hashed case-insensitively, so the filter is correct for every document mode.
+class AncestorFilter {
+public:
+    static u32 hash_for_tag_name(StringView name) { return hash(name, 1); }
+    static u32 hash_for_id(StringView id) { return hash(id, 2); }
+    static u32 hash_for_class(StringView class_name) { return hash(class_name, 3); }
+
+    bool may_contain(u32 hash) const
+    {
+        return m_counters[hash & key_mask] != 0 && m_counters[(hash >> key_bits) & key_mask] != 0;
+    }
+
+    void add(u32 hash)
+    {
+        increment(m_counters[hash & key_mask]);
+        increment(m_counters[(hash >> key_bits) & key_mask]);
+    }
+
+    void remove(u32 hash)
+    {
+        decrement(m_counters[hash & key_mask]);
+        decrement(m_counters[(hash >> key_bits) & key_mask]);
+    }
+
+private:
+    static constexpr u32 key_bits = 12;
+    static constexpr u32 key_mask = (1 << key_bits) - 1;
+
+    static u32 hash(StringView string, u32 kind)
+    {
+        return pair_int_hash(case_insensitive_string_hash(string.characters_without_null_termination(), string.length()), kind);
+    }
+
+    // NOTE: A counter that has overflowed stays saturated, as we can't know how many entries it still counts.
+    static void increment(u8& counter)
+    {
+        if (counter != NumericLimits<u8>::max())
+            ++counter;
+    }
+    static void decrement(u8& counter)
+    {
+        if (counter != NumericLimits<u8>::max())
+            --counter;
+    }
+
+    Array<u8, 1 << key_bits> m_counters {};
+};
+
+}
@@ -316,6 +316,43 @@ U32Triplet Tokenizer::peek_triplet() const
     return values;
 }
 
+// Consumes code points all at once, for as long as the predicate accepts their bytes, and returns them.
+// NOTE: The predicate has to accept every non-ASCII byte, so we don't stop in the middle of a code point.
+template<typename Predicate>
+StringView Tokenizer::consume_code_points_while(Predicate predicate)
+{
+    auto input = m_decoded_input.view();
+    auto start = m_utf8_view.byte_offset_of(m_utf8_iterator);
+    auto position = m_position;
+    auto prev_position = m_prev_position;
+    auto start_of_last_code_point = start;
+
+    auto end = start;
+    for (; end < input.length(); ++end) {
+        auto byte = static_cast<u8>(input[end]);
+        if (!predicate(byte))
+            break;
+        if ((byte & 0xc0) == 0x80)
+            continue;
+        start_of_last_code_point = end;
+        prev_position = position;
+        if (is_newline(byte)) {
+            position.line++;
+            position.column = 0;
+        } else {
+            position.column++;
+        }
+    }
+    if (end == start)
+        return {};
+
+    m_prev_utf8_iterator = m_utf8_view.iterator_at_byte_offset(start_of_last_code_point);
+    m_utf8_iterator = m_utf8_view.iterator_at_byte_offset(end);
+    m_prev_position = prev_position;
+    m_position = position;
+    return input.substring_view(start, end - start);
+}
+
 U32Twin Tokenizer::start_of_input_stream_twin()
 {
     U32Twin twin;
@@ -589,6 +626,11 @@ DeprecatedString Tokenizer::consume_an_ident_sequence()
 
     // Repeatedly consume the next input code point from the stream:
     for (;;) {
+        // NOTE: Most of the time, an ident sequence is just name code points, so we consume those in bulk.
+        result.append(consume_code_points_while([](u8 byte) {
+            return !is_ascii(byte) || is_ascii_alphanumeric(byte) || is_low_line(byte) || is_hyphen_minus(byte);
+        }));
+
         auto input = next_code_point();
 
         if (is_eof(input))
@@ -934,6 +976,11 @@ Token Tokenizer::consume_string_token(u32 ending_code_point)
 
     // Repeatedly consume the next input code point from the stream:
     for (;;) {
+        // NOTE: Consume the code points that are just appended to the string in bulk.
+        builder.append(consume_code_points_while([ending_code_point](u8 byte) {
+            return byte != ending_code_point && !is_newline(byte) && !is_reverse_solidus(byte);
+        }));
+
         auto input = next_code_point();
 
         // ending code point
@@ -1003,6 +1050,9 @@ start:
     (void)next_code_point();
 
     for (;;) {
+        // NOTE: Skip ahead to the next asterisk, as only that may end the comment.
+        (void)consume_code_points_while([](u8 byte) { return !is_asterisk(byte); });
+
         auto twin_inner = peek_twin();
         if (is_eof(twin_inner.first) || is_eof(twin_inner.second)) {
             log_parse_error();
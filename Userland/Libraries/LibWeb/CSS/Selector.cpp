@@ -6,6 +6,7 @@
  */
 
 #include "Selector.h"
+#include <LibWeb/CSS/AncestorFilter.h>
 #include <LibWeb/CSS/Serialize.h>
 
 namespace Web::CSS {
@@ -23,6 +24,38 @@ Selector::Selector(Vector<CompoundSelector>&& compound_selectors)
             }
         }
     }
+
+    collect_ancestor_hashes();
+}
+
+void Selector::collect_ancestor_hashes()
+{
+    // NOTE: A handful of hashes rejects most candidates already, and each one we keep costs a lookup for every match.
+    static constexpr size_t max_ancestor_hashes = 8;
+
+    // Only the compound selectors reached from the subject through child and descendant combinators alone are ancestors.
+    for (size_t i = m_compound_selectors.size(); i > 1; --i) {
+        auto combinator = m_compound_selectors[i - 1].combinator;
+        if (combinator != Combinator::Descendant && combinator != Combinator::ImmediateChild)
+            break;
+        for (auto const& simple_selector : m_compound_selectors[i - 2].simple_selectors) {
+            if (m_ancestor_hashes.size() == max_ancestor_hashes)
+                return;
+            switch (simple_selector.type) {
+            case SimpleSelector::Type::TagName:
+                m_ancestor_hashes.append(AncestorFilter::hash_for_tag_name(simple_selector.name()));
+                break;
+            case SimpleSelector::Type::Id:
+                m_ancestor_hashes.append(AncestorFilter::hash_for_id(simple_selector.name()));
+                break;
+            case SimpleSelector::Type::Class:
+                m_ancestor_hashes.append(AncestorFilter::hash_for_class(simple_selector.name()));
+                break;
+            default:
+                break;
+            }
+        }
+    }
 }
 
 // https://www.w3.org/TR/selectors-4/#specificity-rules
@@ -202,10 +202,16 @@ public:
     u32 specificity() const;
     DeprecatedString serialize() const;
 
+    // AncestorFilter hashes of tag names, ids and classes that some ancestor of a matching element must have.
+    Vector<u32> const& ancestor_hashes() const { return m_ancestor_hashes; }
+
 private:
     explicit Selector(Vector<CompoundSelector>&&);
 
+    void collect_ancestor_hashes();
+
     Vector<CompoundSelector> m_compound_selectors;
+    Vector<u32> m_ancestor_hashes;
     mutable Optional<u32> m_specificity;
     Optional<Selector::PseudoElement> m_pseudo_element;
 };
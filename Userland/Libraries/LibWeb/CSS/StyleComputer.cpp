@@ -169,16 +169,20 @@ Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& e
             rules_to_run.extend(m_rule_cache->other_rules);
         }
 
+        bool use_ancestor_filter = can_use_ancestor_filter_for(element);
         Vector<MatchingRule> matching_rules;
         matching_rules.ensure_capacity(rules_to_run.size());
         for (auto const& rule_to_run : rules_to_run) {
             auto const& selector = rule_to_run.rule->selectors()[rule_to_run.selector_index];
+            if (use_ancestor_filter && should_reject_with_ancestor_filter(selector))
+                continue;
             if (SelectorEngine::matches(selector, element, pseudo_element))
                 matching_rules.append(rule_to_run);
         }
         return matching_rules;
     }
 
+    bool use_ancestor_filter = can_use_ancestor_filter_for(element);
     Vector<MatchingRule> matching_rules;
     size_t style_sheet_index = 0;
     for_each_stylesheet(cascade_origin, [&](auto& sheet) {
@@ -186,6 +190,10 @@ Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& e
         sheet.for_each_effective_style_rule([&](auto const& rule) {
             size_t selector_index = 0;
             for (auto& selector : rule.selectors()) {
+                if (use_ancestor_filter && should_reject_with_ancestor_filter(selector)) {
+                    ++selector_index;
+                    continue;
+                }
                 if (SelectorEngine::matches(selector, element, pseudo_element)) {
                     matching_rules.append({ &rule, style_sheet_index, rule_index, selector_index, selector.specificity() });
                     break;
@@ -921,12 +929,12 @@ void StyleComputer::compute_defaulted_property_value(StyleProperties& style, DOM
 {
     // FIXME: If we don't know the correct initial value for a property, we fall back to InitialStyleValue.
 
-    auto& value_slot = style.m_property_values[to_underlying(property_id)];
+    auto& value_slot = style.mutable_value_slot(property_id);
     if (!value_slot) {
         if (is_inherited_property(property_id))
-            style.m_property_values[to_underlying(property_id)] = get_inherit_value(property_id, element, pseudo_element);
+            value_slot = get_inherit_value(property_id, element, pseudo_element);
         else
-            style.m_property_values[to_underlying(property_id)] = property_initial_value(property_id);
+            value_slot = property_initial_value(property_id);
         return;
     }
 
@@ -1286,11 +1294,14 @@ void StyleComputer::absolutize_values(StyleProperties& style, DOM::Element const
     auto root_font_size = root_element_font_size();
     auto font_size = style.property(CSS::PropertyID::FontSize)->to_length().to_px(viewport_rect(), font_metrics, root_font_size, root_font_size);
 
-    for (size_t i = 0; i < style.m_property_values.size(); ++i) {
-        auto& value_slot = style.m_property_values[i];
-        if (!value_slot)
+    for (auto i = to_underlying(CSS::first_property_id); i <= to_underlying(CSS::last_property_id); ++i) {
+        auto property_id = static_cast<CSS::PropertyID>(i);
+        auto const& value = style.value_slot(property_id);
+        if (!value)
             continue;
-        value_slot = value_slot->absolutized(viewport_rect(), font_metrics, font_size.value(), root_font_size.value());
+        auto absolutized_value = value->absolutized(viewport_rect(), font_metrics, font_size.value(), root_font_size.value());
+        if (absolutized_value.ptr() != value.ptr())
+            style.mutable_value_slot(property_id) = move(absolutized_value);
     }
 }
 
@@ -1396,6 +1407,10 @@ ErrorOr<NonnullRefPtr<StyleProperties>> StyleComputer::compute_style(DOM::Elemen
     // 5. Run automatic box type transformations
     transform_box_type_if_needed(style, element, pseudo_element);
 
+    // NOTE: Most elements don't change any inherited property, so they can use their parent's storage for them.
+    if (auto const* parent_element = element_to_inherit_style_from(&element, pseudo_element); parent_element && parent_element->computed_css_values())
+        style->share_inherited_values_with(*parent_element->computed_css_values());
+
     return style;
 }
 
@@ -1497,6 +1512,18 @@ void StyleComputer::build_rule_cache()
         ++style_sheet_index;
     });
 
+    // Unlike the buckets above, the selector dependencies have to cover the UA style sheets as well.
+    auto collect_dependencies_of_sheet = [&](auto& sheet) {
+        sheet.for_each_effective_style_rule([&](auto const& rule) {
+            for (CSS::Selector const& selector : rule.selectors()) {
+                collect_selector_dependencies(selector, false);
+                collect_style_sharing_blockers(selector);
+            }
+        });
+    };
+    for_each_stylesheet(CascadeOrigin::UserAgent, collect_dependencies_of_sheet);
+    for_each_stylesheet(CascadeOrigin::Author, collect_dependencies_of_sheet);
+
     if constexpr (LIBWEB_CSS_DEBUG) {
         dbgln("Built rule cache!");
         dbgln("           ID: {}", num_id_rules);
@@ -1508,6 +1535,265 @@ void StyleComputer::build_rule_cache()
     }
 }
 
+void StyleComputer::collect_selector_dependencies(Selector const& selector, bool is_left_of_sibling_combinator)
+{
+    auto add_dependency = [](HashMap<DeprecatedFlyString, bool>& dependencies, DeprecatedFlyString const& name, bool is_left_of_sibling_combinator) {
+        auto& dependency = dependencies.ensure(name, [] { return false; });
+        dependency |= is_left_of_sibling_combinator;
+    };
+
+    auto const& compound_selectors = selector.compound_selectors();
+    for (size_t i = 0; i < compound_selectors.size(); ++i) {
+        // A compound selector is only ever matched against the previous siblings of whatever matched the one after it.
+        bool compound_is_left_of_sibling_combinator = is_left_of_sibling_combinator;
+        if (i + 1 < compound_selectors.size()) {
+            auto combinator = compound_selectors[i + 1].combinator;
+            if (combinator == Selector::Combinator::NextSibling || combinator == Selector::Combinator::SubsequentSibling)
+                compound_is_left_of_sibling_combinator = true;
+        }
+
+        for (auto const& simple_selector : compound_selectors[i].simple_selectors) {
+            switch (simple_selector.type) {
+            case Selector::SimpleSelector::Type::Class:
+                add_dependency(m_rule_cache->class_dependencies, simple_selector.lowercase_name(), compound_is_left_of_sibling_combinator);
+                break;
+            case Selector::SimpleSelector::Type::Id:
+                add_dependency(m_rule_cache->id_dependencies, simple_selector.lowercase_name(), compound_is_left_of_sibling_combinator);
+                break;
+            case Selector::SimpleSelector::Type::Attribute:
+                add_dependency(m_rule_cache->attribute_dependencies, simple_selector.attribute().name.to_lowercase(), compound_is_left_of_sibling_combinator);
+                break;
+            case Selector::SimpleSelector::Type::PseudoClass:
+                for (auto const& argument_selector : simple_selector.pseudo_class().argument_selector_list)
+                    collect_selector_dependencies(argument_selector, compound_is_left_of_sibling_combinator);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+// Whether a simple selector gives the same answer for any two siblings with the same tag name and attributes.
+static bool matches_alike_for_siblings_with_same_attributes(Selector::SimpleSelector const& simple_selector)
+{
+    if (simple_selector.type != Selector::SimpleSelector::Type::PseudoClass)
+        return true;
+
+    auto const& pseudo_class = simple_selector.pseudo_class();
+    switch (pseudo_class.type) {
+    case Selector::SimpleSelector::PseudoClass::Type::Link:
+    case Selector::SimpleSelector::PseudoClass::Type::Visited:
+    case Selector::SimpleSelector::PseudoClass::Type::Lang:
+        return true;
+    case Selector::SimpleSelector::PseudoClass::Type::Is:
+    case Selector::SimpleSelector::PseudoClass::Type::Not:
+    case Selector::SimpleSelector::PseudoClass::Type::Where:
+        for (auto const& argument_selector : pseudo_class.argument_selector_list) {
+            auto const& compound_selectors = argument_selector.compound_selectors();
+            if (compound_selectors.size() != 1)
+                return false;
+            for (auto const& argument_simple_selector : compound_selectors.first().simple_selectors) {
+                if (!matches_alike_for_siblings_with_same_attributes(argument_simple_selector))
+                    return false;
+            }
+        }
+        return true;
+    default:
+        // Structural pseudo-classes look at the siblings, the rest at state that isn't reflected in the attributes.
+        return false;
+    }
+}
+
+void StyleComputer::collect_style_sharing_blockers(Selector const& selector)
+{
+    // NOTE: Pseudo-element styles are never shared, so their selectors don't matter here.
+    if (selector.pseudo_element().has_value())
+        return;
+
+    // Everything to the left of a child or descendant combinator is matched against the ancestors, which siblings share.
+    auto const& compound_selectors = selector.compound_selectors();
+    bool blocks_sharing = false;
+    for (size_t i = compound_selectors.size(); i > 0 && !blocks_sharing; --i) {
+        auto const& compound_selector = compound_selectors[i - 1];
+        for (auto const& simple_selector : compound_selector.simple_selectors) {
+            if (!matches_alike_for_siblings_with_same_attributes(simple_selector)) {
+                blocks_sharing = true;
+                break;
+            }
+        }
+        if (compound_selector.combinator == Selector::Combinator::NextSibling || compound_selector.combinator == Selector::Combinator::SubsequentSibling)
+            blocks_sharing = true;
+        else
+            break;
+    }
+    if (!blocks_sharing)
+        return;
+
+    // Only elements that match the rest of the subject compound selector can be affected.
+    auto const& subject = compound_selectors.last().simple_selectors;
+    for (auto const& simple_selector : subject) {
+        if (simple_selector.type != Selector::SimpleSelector::Type::PseudoClass)
+            continue;
+        // NOTE: :visited never matches, and :link only matches elements with an href attribute.
+        if (simple_selector.pseudo_class().type == Selector::SimpleSelector::PseudoClass::Type::Visited)
+            return;
+        if (simple_selector.pseudo_class().type == Selector::SimpleSelector::PseudoClass::Type::Link) {
+            m_rule_cache->style_sharing_blocking_attributes.set(HTML::AttributeNames::href);
+            return;
+        }
+    }
+    for (auto type : { Selector::SimpleSelector::Type::Id, Selector::SimpleSelector::Type::Class, Selector::SimpleSelector::Type::Attribute, Selector::SimpleSelector::Type::TagName }) {
+        for (auto const& simple_selector : subject) {
+            if (simple_selector.type != type)
+                continue;
+            switch (type) {
+            case Selector::SimpleSelector::Type::Id:
+                m_rule_cache->style_sharing_blocking_ids.set(simple_selector.lowercase_name());
+                return;
+            case Selector::SimpleSelector::Type::Class:
+                m_rule_cache->style_sharing_blocking_classes.set(simple_selector.lowercase_name());
+                return;
+            case Selector::SimpleSelector::Type::Attribute:
+                m_rule_cache->style_sharing_blocking_attributes.set(simple_selector.attribute().name.to_lowercase());
+                return;
+            case Selector::SimpleSelector::Type::TagName:
+                m_rule_cache->style_sharing_blocking_tag_names.set(simple_selector.lowercase_name());
+                return;
+            default:
+                VERIFY_NOT_REACHED();
+            }
+        }
+    }
+    m_rule_cache->style_sharing_blocked_for_all_elements = true;
+}
+
+static StyleComputer::InvalidationScope invalidation_scope_for_dependency(HashMap<DeprecatedFlyString, bool> const& dependencies, StringView name)
+{
+    auto dependency = dependencies.get(DeprecatedFlyString { name.to_lowercase_string() });
+    if (!dependency.has_value())
+        return StyleComputer::InvalidationScope::None;
+    return *dependency ? StyleComputer::InvalidationScope::SubtreeAndFollowingSiblings : StyleComputer::InvalidationScope::Subtree;
+}
+
+StyleComputer::InvalidationScope StyleComputer::invalidation_scope_for_class_change(StringView class_name) const
+{
+    build_rule_cache_if_needed();
+    return invalidation_scope_for_dependency(m_rule_cache->class_dependencies, class_name);
+}
+
+StyleComputer::InvalidationScope StyleComputer::invalidation_scope_for_id_change(StringView id) const
+{
+    build_rule_cache_if_needed();
+    return invalidation_scope_for_dependency(m_rule_cache->id_dependencies, id);
+}
+
+StyleComputer::InvalidationScope StyleComputer::invalidation_scope_for_attribute_change(StringView attribute_name) const
+{
+    build_rule_cache_if_needed();
+    return invalidation_scope_for_dependency(m_rule_cache->attribute_dependencies, attribute_name);
+}
+
+// NOTE: The filter only holds all of an element's ancestors while we are restyling that element's parent's children.
+bool StyleComputer::can_use_ancestor_filter_for(DOM::Element const& element) const
+{
+    return !m_ancestor_filter_entries.is_empty() && m_ancestor_filter_entries.last().element == element.parent();
+}
+
+bool StyleComputer::should_reject_with_ancestor_filter(Selector const& selector) const
+{
+    for (auto hash : selector.ancestor_hashes()) {
+        if (!m_ancestor_filter.may_contain(hash))
+            return true;
+    }
+    return false;
+}
+
+void StyleComputer::push_ancestor(DOM::Element const& element)
+{
+    auto hashes_before = m_ancestor_filter_hashes.size();
+    m_ancestor_filter_hashes.append(AncestorFilter::hash_for_tag_name(element.local_name()));
+    if (auto id = element.get_attribute(HTML::AttributeNames::id); !id.is_null())
+        m_ancestor_filter_hashes.append(AncestorFilter::hash_for_id(id));
+    for (auto const& class_name : element.class_names())
+        m_ancestor_filter_hashes.append(AncestorFilter::hash_for_class(class_name));
+
+    for (size_t i = hashes_before; i < m_ancestor_filter_hashes.size(); ++i)
+        m_ancestor_filter.add(m_ancestor_filter_hashes[i]);
+    m_ancestor_filter_entries.append({ &element, m_ancestor_filter_hashes.size() - hashes_before });
+}
+
+void StyleComputer::pop_ancestor(DOM::Element const& element)
+{
+    VERIFY(!m_ancestor_filter_entries.is_empty() && m_ancestor_filter_entries.last().element == &element);
+    auto entry = m_ancestor_filter_entries.take_last();
+    for (size_t i = 0; i < entry.hash_count; ++i)
+        m_ancestor_filter.remove(m_ancestor_filter_hashes.take_last());
+}
+
+bool StyleComputer::is_style_sharing_blocked_for(DOM::Element const& element) const
+{
+    auto is_blocked = [](HashTable<DeprecatedFlyString> const& blocking_names, StringView name) {
+        return !blocking_names.is_empty() && blocking_names.contains(name.to_lowercase_string());
+    };
+
+    if (m_rule_cache->style_sharing_blocked_for_all_elements)
+        return true;
+    if (is_blocked(m_rule_cache->style_sharing_blocking_tag_names, element.local_name()))
+        return true;
+    for (auto const& class_name : element.class_names()) {
+        if (is_blocked(m_rule_cache->style_sharing_blocking_classes, class_name))
+            return true;
+    }
+    bool blocked_by_attribute = false;
+    element.for_each_attribute([&](auto const& name, auto const& value) {
+        if (name == HTML::AttributeNames::id && is_blocked(m_rule_cache->style_sharing_blocking_ids, value))
+            blocked_by_attribute = true;
+        if (is_blocked(m_rule_cache->style_sharing_blocking_attributes, name))
+            blocked_by_attribute = true;
+    });
+    return blocked_by_attribute;
+}
+
+static bool have_same_attributes(DOM::Element const& a, DOM::Element const& b)
+{
+    if (a.attribute_list_size() != b.attribute_list_size())
+        return false;
+    bool same_attributes = true;
+    a.for_each_attribute([&](auto const& name, auto const& value) {
+        if (same_attributes && b.get_attribute(name) != value)
+            same_attributes = false;
+    });
+    return same_attributes;
+}
+
+DOM::Element const* StyleComputer::find_style_sharing_candidate(DOM::Element const& element) const
+{
+    // NOTE: A handful of siblings is enough to catch runs of list items and table cells, without scanning long lists.
+    static constexpr size_t max_candidates = 8;
+
+    // Inline style can be changed without touching the attribute, and shadow roots bring their own style sheets.
+    if (element.inline_style() || element.shadow_root_internal())
+        return nullptr;
+
+    build_rule_cache_if_needed();
+    if (is_style_sharing_blocked_for(element))
+        return nullptr;
+
+    size_t candidates_left = max_candidates;
+    for (auto const* candidate = element.previous_element_sibling(); candidate && candidates_left; candidate = candidate->previous_element_sibling(), --candidates_left) {
+        if (!candidate->computed_css_values() || candidate->needs_style_update())
+            continue;
+        if (candidate->local_name() != element.local_name() || candidate->namespace_() != element.namespace_())
+            continue;
+        if (candidate->inline_style() || candidate->shadow_root_internal())
+            continue;
+        if (have_same_attributes(element, *candidate))
+            return candidate;
+    }
+    return nullptr;
+}
+
 void StyleComputer::invalidate_rule_cache()
 {
     m_rule_cache = nullptr;
@@ -8,9 +8,11 @@
 #pragma once
 
 #include <AK/HashMap.h>
+#include <AK/HashTable.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/Optional.h>
 #include <AK/OwnPtr.h>
+#include <LibWeb/CSS/AncestorFilter.h>
 #include <LibWeb/CSS/CSSFontFaceRule.h>
 #include <LibWeb/CSS/CSSStyleDeclaration.h>
 #include <LibWeb/CSS/Parser/ComponentValue.h>
@@ -71,6 +73,24 @@ public:
 
     void invalidate_rule_cache();
 
+    // How much of the tree has to be restyled when one of an element's classes, its id or another attribute changes.
+    // NOTE: Anything but None restyles at least the element's subtree, as its descendants may inherit from it.
+    enum class InvalidationScope {
+        None,
+        Subtree,
+        SubtreeAndFollowingSiblings,
+    };
+    InvalidationScope invalidation_scope_for_class_change(StringView class_name) const;
+    InvalidationScope invalidation_scope_for_id_change(StringView id) const;
+    InvalidationScope invalidation_scope_for_attribute_change(StringView attribute_name) const;
+
+    // Called around restyling an element's children, so their rules can be checked against the ancestor filter.
+    void push_ancestor(DOM::Element const&);
+    void pop_ancestor(DOM::Element const&);
+
+    // Returns a previous sibling whose computed style (and custom properties) the element would end up with as well.
+    DOM::Element const* find_style_sharing_candidate(DOM::Element const&) const;
+
     Gfx::Font const& initial_font() const;
 
     void did_load_font(DeprecatedFlyString const& family_name);
@@ -105,6 +125,11 @@ private:
 
     void build_rule_cache();
     void build_rule_cache_if_needed() const;
+    void collect_selector_dependencies(Selector const&, bool is_left_of_sibling_combinator);
+    void collect_style_sharing_blockers(Selector const&);
+    bool is_style_sharing_blocked_for(DOM::Element const&) const;
+    bool can_use_ancestor_filter_for(DOM::Element const&) const;
+    bool should_reject_with_ancestor_filter(Selector const&) const;
 
     DOM::Document& m_document;
 
@@ -114,9 +139,32 @@ private:
         HashMap<DeprecatedFlyString, Vector<MatchingRule>> rules_by_tag_name;
         HashMap<Selector::PseudoElement, Vector<MatchingRule>> rules_by_pseudo_element;
         Vector<MatchingRule> other_rules;
+
+        // The (lowercased) classes, ids and attribute names the selectors of every style sheet look at, mapped to
+        // whether any of them looks at it to the left of a sibling combinator.
+        HashMap<DeprecatedFlyString, bool> class_dependencies;
+        HashMap<DeprecatedFlyString, bool> id_dependencies;
+        HashMap<DeprecatedFlyString, bool> attribute_dependencies;
+
+        // Selectors that may match one of two siblings with the same attributes but not the other, keyed by the
+        // (lowercased) id, class, attribute or tag name an element needs to match them, like the buckets above.
+        HashTable<DeprecatedFlyString> style_sharing_blocking_ids;
+        HashTable<DeprecatedFlyString> style_sharing_blocking_classes;
+        HashTable<DeprecatedFlyString> style_sharing_blocking_attributes;
+        HashTable<DeprecatedFlyString> style_sharing_blocking_tag_names;
+        bool style_sharing_blocked_for_all_elements { false };
     };
     OwnPtr<RuleCache> m_rule_cache;
 
+    // NOTE: We remember what we added for each ancestor, in case its classes change before it is popped again.
+    struct AncestorFilterEntry {
+        DOM::Element const* element { nullptr };
+        size_t hash_count { 0 };
+    };
+    AncestorFilter m_ancestor_filter;
+    Vector<AncestorFilterEntry> m_ancestor_filter_entries;
+    Vector<u32> m_ancestor_filter_hashes;
+
     class FontLoader;
     HashMap<DeprecatedString, NonnullOwnPtr<FontLoader>> m_loaded_fonts;
 };
@@ -16,8 +16,64 @@
 
 namespace Web::CSS {
 
+namespace {
+
+struct PropertyGroupLayout {
+    Array<bool, to_underlying(CSS::last_property_id) + 1> is_inherited {};
+    Array<u16, to_underlying(CSS::last_property_id) + 1> index_in_group {};
+    size_t inherited_count { 0 };
+    size_t non_inherited_count { 0 };
+};
+
+}
+
+static PropertyGroupLayout const& property_group_layout()
+{
+    static PropertyGroupLayout const layout = [] {
+        PropertyGroupLayout layout;
+        for (auto i = to_underlying(CSS::first_property_id); i <= to_underlying(CSS::last_property_id); ++i) {
+            layout.is_inherited[i] = is_inherited_property(static_cast<CSS::PropertyID>(i));
+            layout.index_in_group[i] = layout.is_inherited[i] ? layout.inherited_count++ : layout.non_inherited_count++;
+        }
+        return layout;
+    }();
+    return layout;
+}
+
+static size_t s_total_property_storage_size = 0;
+
+StyleProperties::PropertyGroup::PropertyGroup(Vector<RefPtr<StyleValue>> values)
+    : values(move(values))
+{
+    s_total_property_storage_size += sizeof(PropertyGroup) + this->values.capacity() * sizeof(RefPtr<StyleValue>);
+}
+
+StyleProperties::PropertyGroup::~PropertyGroup()
+{
+    s_total_property_storage_size -= sizeof(PropertyGroup) + values.capacity() * sizeof(RefPtr<StyleValue>);
+}
+
+size_t StyleProperties::total_property_storage_size()
+{
+    return s_total_property_storage_size;
+}
+
+static Vector<RefPtr<StyleValue>> make_empty_values(size_t count)
+{
+    Vector<RefPtr<StyleValue>> values;
+    values.resize(count);
+    return values;
+}
+
+StyleProperties::StyleProperties()
+    : m_inherited_values(adopt_ref(*new PropertyGroup(make_empty_values(property_group_layout().inherited_count))))
+    , m_non_inherited_values(adopt_ref(*new PropertyGroup(make_empty_values(property_group_layout().non_inherited_count))))
+{
+}
+
 StyleProperties::StyleProperties(StyleProperties const& other)
-    : m_property_values(other.m_property_values)
+    : m_inherited_values(other.m_inherited_values)
+    , m_non_inherited_values(other.m_non_inherited_values)
 {
     if (other.m_font) {
         m_font = other.m_font->clone();
@@ -31,14 +87,46 @@ NonnullRefPtr<StyleProperties> StyleProperties::clone() const
     return adopt_ref(*new StyleProperties(*this));
 }
 
+RefPtr<StyleValue> const& StyleProperties::value_slot(CSS::PropertyID property_id) const
+{
+    auto const& layout = property_group_layout();
+    auto const& group = layout.is_inherited[to_underlying(property_id)] ? m_inherited_values : m_non_inherited_values;
+    return group->values[layout.index_in_group[to_underlying(property_id)]];
+}
+
+RefPtr<StyleValue>& StyleProperties::mutable_value_slot(CSS::PropertyID property_id)
+{
+    auto const& layout = property_group_layout();
+    auto& group = layout.is_inherited[to_underlying(property_id)] ? m_inherited_values : m_non_inherited_values;
+    if (group->ref_count() > 1)
+        group = adopt_ref(*new PropertyGroup(group->values));
+    return group->values[layout.index_in_group[to_underlying(property_id)]];
+}
+
+void StyleProperties::share_inherited_values_with(StyleProperties const& parent)
+{
+    if (m_inherited_values.ptr() == parent.m_inherited_values.ptr())
+        return;
+
+    auto const& values = m_inherited_values->values;
+    auto const& parent_values = parent.m_inherited_values->values;
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (values[i] == parent_values[i])
+            continue;
+        if (!values[i] || !parent_values[i] || *values[i] != *parent_values[i])
+            return;
+    }
+    m_inherited_values = parent.m_inherited_values;
+}
+
 void StyleProperties::set_property(CSS::PropertyID id, NonnullRefPtr<StyleValue> value)
 {
-    m_property_values[to_underlying(id)] = move(value);
+    mutable_value_slot(id) = move(value);
 }
 
 NonnullRefPtr<StyleValue> StyleProperties::property(CSS::PropertyID property_id) const
 {
-    auto value = m_property_values[to_underlying(property_id)];
+    auto value = value_slot(property_id);
     // By the time we call this method, all properties have values assigned.
     VERIFY(!value.is_null());
     return value.release_nonnull();
@@ -46,7 +134,7 @@ NonnullRefPtr<StyleValue> StyleProperties::property(CSS::PropertyID property_id)
 
 RefPtr<StyleValue> StyleProperties::maybe_null_property(CSS::PropertyID property_id) const
 {
-    return m_property_values[to_underlying(property_id)];
+    return value_slot(property_id);
 }
 
 CSS::Size StyleProperties::size_value(CSS::PropertyID id) const
@@ -408,12 +496,9 @@ Optional<CSS::Position> StyleProperties::position() const
 
 bool StyleProperties::operator==(StyleProperties const& other) const
 {
-    if (m_property_values.size() != other.m_property_values.size())
-        return false;
-
-    for (size_t i = 0; i < m_property_values.size(); ++i) {
-        auto const& my_ptr = m_property_values[i];
-        auto const& other_ptr = other.m_property_values[i];
+    for (auto i = to_underlying(CSS::first_property_id); i <= to_underlying(CSS::last_property_id); ++i) {
+        auto const& my_ptr = value_slot(static_cast<CSS::PropertyID>(i));
+        auto const& other_ptr = other.value_slot(static_cast<CSS::PropertyID>(i));
         if (!my_ptr) {
             if (other_ptr)
                 return false;
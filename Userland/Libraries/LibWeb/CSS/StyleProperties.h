@@ -18,7 +18,7 @@ namespace Web::CSS {
 
 class StyleProperties : public RefCounted<StyleProperties> {
 public:
-    StyleProperties() = default;
+    StyleProperties();
 
     explicit StyleProperties(StyleProperties const&);
 
@@ -29,15 +29,12 @@ public:
     template<typename Callback>
     inline void for_each_property(Callback callback) const
     {
-        for (size_t i = 0; i < m_property_values.size(); ++i) {
-            if (m_property_values[i])
-                callback((CSS::PropertyID)i, *m_property_values[i]);
+        for (auto i = to_underlying(CSS::first_property_id); i <= to_underlying(CSS::last_property_id); ++i) {
+            if (auto const& value = value_slot((CSS::PropertyID)i))
+                callback((CSS::PropertyID)i, *value);
         }
     }
 
-    auto& properties() { return m_property_values; }
-    auto const& properties() const { return m_property_values; }
-
     void set_property(CSS::PropertyID, NonnullRefPtr<StyleValue> value);
     NonnullRefPtr<StyleValue> property(CSS::PropertyID) const;
     RefPtr<StyleValue> maybe_null_property(CSS::PropertyID) const;
@@ -117,10 +114,30 @@ public:
 
     static NonnullRefPtr<Gfx::Font> font_fallback(bool monospace, bool bold);
 
+    // Takes over the parent's inherited values if they are all the same as ours, so the two share their storage.
+    void share_inherited_values_with(StyleProperties const& parent);
+
+    // How many bytes the property values of all StyleProperties that are still alive take up, not counting the values.
+    static size_t total_property_storage_size();
+
 private:
     friend class StyleComputer;
 
-    Array<RefPtr<StyleValue>, to_underlying(CSS::last_property_id) + 1> m_property_values;
+    // NOTE: The values are split into the inherited and non-inherited properties, each in one of these. They are
+    //       copied on write, so copies of a StyleProperties (and elements whose inherited values are the same as their
+    //       parent's) use the same storage.
+    struct PropertyGroup : public RefCounted<PropertyGroup> {
+        explicit PropertyGroup(Vector<RefPtr<StyleValue>> values);
+        ~PropertyGroup();
+
+        Vector<RefPtr<StyleValue>> values;
+    };
+
+    RefPtr<StyleValue> const& value_slot(CSS::PropertyID) const;
+    RefPtr<StyleValue>& mutable_value_slot(CSS::PropertyID);
+
+    NonnullRefPtr<PropertyGroup> m_inherited_values;
+    NonnullRefPtr<PropertyGroup> m_non_inherited_values;
     Optional<CSS::Overflow> overflow(CSS::PropertyID) const;
     Vector<CSS::ShadowData> shadow(CSS::PropertyID) const;
 
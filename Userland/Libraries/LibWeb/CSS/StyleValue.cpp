@@ -1731,6 +1731,17 @@ void ImageStyleValue::load_any_resources(DOM::Document& document)
 }
 
 void ImageStyleValue::resource_did_load()
+{
+    if (!m_document)
+        return;
+    if (!resource()->has_attempted_decode()) {
+        resource()->start_decoding_if_needed();
+        return;
+    }
+    resource_did_decode();
+}
+
+void ImageStyleValue::resource_did_decode()
 {
     if (!m_document)
         return;
@@ -1738,7 +1749,7 @@ void ImageStyleValue::resource_did_load()
     if (m_document && m_document->browsing_context())
         m_document->browsing_context()->set_needs_display();
 
-    if (resource()->is_animated() && resource()->frame_count() > 1) {
+    if (!m_timer && resource()->is_animated() && resource()->frame_count() > 1) {
         m_timer = Platform::Timer::create();
         m_timer->set_interval(resource()->frame_duration(0));
         m_timer->on_timeout = [this] { animate(); };
@@ -1785,15 +1796,19 @@ bool ImageStyleValue::equals(StyleValue const& other) const
 
 Optional<CSSPixels> ImageStyleValue::natural_width() const
 {
-    if (auto* b = bitmap(0); b != nullptr)
-        return b->width();
+    if (!resource())
+        return {};
+    if (auto size = resource()->natural_size(); size.has_value())
+        return size->width();
     return {};
 }
 
 Optional<CSSPixels> ImageStyleValue::natural_height() const
 {
-    if (auto* b = bitmap(0); b != nullptr)
-        return b->height();
+    if (!resource())
+        return {};
+    if (auto size = resource()->natural_size(); size.has_value())
+        return size->height();
     return {};
 }
 
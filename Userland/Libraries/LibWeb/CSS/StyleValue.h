@@ -1257,6 +1257,9 @@ private:
     // ^ResourceClient
     virtual void resource_did_load() override;
 
+    // ^ImageResourceClient
+    virtual void resource_did_decode() override;
+
     void animate();
     Gfx::Bitmap const* bitmap(size_t index) const;
 
@@ -68,7 +68,6 @@
 #include <LibWeb/Layout/TreeBuilder.h>
 #include <LibWeb/Namespace.h>
 #include <LibWeb/Page/Page.h>
-#include <LibWeb/Platform/Timer.h>
 #include <LibWeb/SVG/TagNames.h>
 #include <LibWeb/Selection/Selection.h>
 #include <LibWeb/UIEvents/EventNames.h>
@@ -299,14 +298,6 @@ Document::Document(JS::Realm& realm, const AK::URL& url)
     , m_url(url)
 {
     HTML::main_thread_event_loop().register_document({}, *this);
-
-    m_style_update_timer = Platform::Timer::create_single_shot(0, [this] {
-        update_style();
-    });
-
-    m_layout_update_timer = Platform::Timer::create_single_shot(0, [this] {
-        force_layout();
-    });
 }
 
 Document::~Document()
@@ -556,18 +547,34 @@ void Document::set_origin(HTML::Origin const& origin)
     m_origin = origin;
 }
 
+// NOTE: Style and layout are brought up to date by the event loop's next rendering update, so however many times
+//       they're invalidated before the next frame, the work happens only once.
 void Document::schedule_style_update()
 {
-    if (m_style_update_timer->is_active())
-        return;
-    m_style_update_timer->start();
+    HTML::main_thread_event_loop().schedule_rendering_update();
 }
 
 void Document::schedule_layout_update()
 {
-    if (m_layout_update_timer->is_active())
-        return;
-    m_layout_update_timer->start();
+    HTML::main_thread_event_loop().schedule_rendering_update();
+}
+
+void Document::update_the_rendering()
+{
+    auto style_start_time = HighResolutionTime::unsafe_shared_current_time();
+    update_style();
+    auto layout_start_time = HighResolutionTime::unsafe_shared_current_time();
+    update_layout();
+    auto end_time = HighResolutionTime::unsafe_shared_current_time();
+
+    m_last_rendering_timings.style = layout_start_time - style_start_time;
+    m_last_rendering_timings.layout = end_time - layout_start_time;
+
+    // NOTE: Painting happens later, when the page client gets around to it, so it doesn't count against the budget here.
+    static constexpr double frame_budget_in_milliseconds = 1000.0 / 60.0;
+    ++m_rendering_update_count;
+    if (m_last_rendering_timings.total() - m_last_rendering_timings.paint > frame_budget_in_milliseconds)
+        ++m_rendering_updates_over_budget;
 }
 
 bool Document::is_child_allowed(Node const& node) const
@@ -846,6 +853,9 @@ void Document::update_layout()
         m_next_layout_node_serial_id = 0;
         Layout::TreeBuilder tree_builder;
         m_layout_root = verify_cast<Layout::InitialContainingBlock>(*tree_builder.build(*this));
+    } else {
+        // NOTE: The initial containing block's style is made from the viewport size, which may have changed since.
+        m_layout_root->apply_style(*style_computer().create_document_style());
     }
 
     Layout::LayoutState layout_state;
@@ -879,9 +889,11 @@ void Document::update_layout()
     m_layout_root->recompute_selection_states();
 
     m_needs_layout = false;
-    m_layout_update_timer->stop();
 }
 
+// FIXME: Once an element's own style is computed, its children's subtrees could be restyled in parallel, each with
+//        its own ancestor filter. That needs compute_style() to stop touching the GC heap and the non-atomic refcounts
+//        of StyleValue and DeprecatedFlyString first, which it currently does for every element.
 [[nodiscard]] static bool update_style_recursively(DOM::Node& node)
 {
     bool const needs_full_style_update = node.document().needs_full_style_update();
@@ -893,17 +905,21 @@ void Document::update_layout()
     node.set_needs_style_update(false);
 
     if (needs_full_style_update || node.child_needs_style_update()) {
+        auto& style_computer = node.document().style_computer();
         if (node.is_element()) {
             if (auto* shadow_root = static_cast<DOM::Element&>(node).shadow_root_internal()) {
                 if (needs_full_style_update || shadow_root->needs_style_update() || shadow_root->child_needs_style_update())
                     needs_relayout |= update_style_recursively(*shadow_root);
             }
+            style_computer.push_ancestor(static_cast<DOM::Element&>(node));
         }
         node.for_each_child([&](auto& child) {
             if (needs_full_style_update || child.needs_style_update() || child.child_needs_style_update())
                 needs_relayout |= update_style_recursively(child);
             return IterationDecision::Continue;
         });
+        if (node.is_element())
+            style_computer.pop_ancestor(static_cast<DOM::Element&>(node));
     }
 
     node.set_child_needs_style_update(false);
@@ -925,7 +941,6 @@ void Document::update_style()
     if (update_style_recursively(*this))
         invalidate_layout();
     m_needs_full_style_update = false;
-    m_style_update_timer->stop();
 }
 
 void Document::set_link_color(Color color)
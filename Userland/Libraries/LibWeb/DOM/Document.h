@@ -189,6 +189,24 @@ public:
     void update_style();
     void update_layout();
 
+    // The document's part of the event loop's "update the rendering" steps, run at most once per frame.
+    void update_the_rendering();
+
+    // How long each phase of the last rendering update took, in milliseconds.
+    struct RenderingTimings {
+        double animation_frame_callbacks { 0 };
+        double style { 0 };
+        double layout { 0 };
+        double paint { 0 };
+
+        double total() const { return animation_frame_callbacks + style + layout + paint; }
+    };
+    RenderingTimings& last_rendering_timings() { return m_last_rendering_timings; }
+    RenderingTimings const& last_rendering_timings() const { return m_last_rendering_timings; }
+
+    size_t rendering_update_count() const { return m_rendering_update_count; }
+    size_t rendering_updates_over_budget() const { return m_rendering_updates_over_budget; }
+
     void set_needs_layout();
 
     void invalidate_layout();
@@ -483,8 +501,9 @@ private:
     Optional<Color> m_active_link_color;
     Optional<Color> m_visited_link_color;
 
-    RefPtr<Platform::Timer> m_style_update_timer;
-    RefPtr<Platform::Timer> m_layout_update_timer;
+    RenderingTimings m_last_rendering_timings;
+    size_t m_rendering_update_count { 0 };
+    size_t m_rendering_updates_over_budget { 0 };
 
     JS::GCPtr<HTML::HTMLParser> m_parser;
     bool m_active_parser_was_aborted { false };
@@ -118,6 +118,8 @@ WebIDL::ExceptionOr<void> Element::set_attribute(DeprecatedFlyString const& name
     // 3. Let attribute be the first attribute in this’s attribute list whose qualified name is qualifiedName, and null otherwise.
     auto* attribute = m_attributes->get_attribute(name);
 
+    Optional<DeprecatedString> old_value;
+
     // 4. If attribute is null, create an attribute whose local name is qualifiedName, value is value, and node document is this’s node document, then append this attribute to this, and then return.
     if (!attribute) {
         auto new_attribute = Attr::create(document(), insert_as_lowercase ? name.to_lowercase() : name, value);
@@ -128,12 +130,13 @@ WebIDL::ExceptionOr<void> Element::set_attribute(DeprecatedFlyString const& name
 
     // 5. Change attribute to value.
     else {
+        old_value = attribute->value();
         attribute->set_value(value);
     }
 
     parse_attribute(attribute->local_name(), value);
 
-    invalidate_style_after_attribute_change(name);
+    invalidate_style_after_attribute_change(name, old_value, value);
 
     return {};
 }
@@ -196,11 +199,15 @@ WebIDL::ExceptionOr<void> Element::set_attribute_ns(DeprecatedFlyString const& n
 // https://dom.spec.whatwg.org/#dom-element-removeattribute
 void Element::remove_attribute(DeprecatedFlyString const& name)
 {
+    Optional<DeprecatedString> old_value;
+    if (auto const* attribute = m_attributes->get_attribute(name))
+        old_value = attribute->value();
+
     m_attributes->remove_attribute(name);
 
     did_remove_attribute(name);
 
-    invalidate_style_after_attribute_change(name);
+    invalidate_style_after_attribute_change(name, old_value, {});
 }
 
 // https://dom.spec.whatwg.org/#dom-element-hasattribute
@@ -233,7 +240,7 @@ WebIDL::ExceptionOr<bool> Element::toggle_attribute(DeprecatedFlyString const& n
 
             parse_attribute(new_attribute->local_name(), "");
 
-            invalidate_style_after_attribute_change(name);
+            invalidate_style_after_attribute_change(name, {}, DeprecatedString::empty());
 
             return true;
         }
@@ -244,11 +251,12 @@ WebIDL::ExceptionOr<bool> Element::toggle_attribute(DeprecatedFlyString const& n
 
     // 5. Otherwise, if force is not given or is false, remove an attribute given qualifiedName and this, and then return false.
     if (!force.has_value() || !force.value()) {
+        auto old_value = attribute->value();
         m_attributes->remove_attribute(name);
 
         did_remove_attribute(name);
 
-        invalidate_style_after_attribute_change(name);
+        invalidate_style_after_attribute_change(name, old_value, {});
     }
 
     // 6. Return true.
@@ -370,31 +378,69 @@ enum class RequiredInvalidation {
     None,
     RepaintOnly,
     RebuildStackingContextTree,
+    RelayoutExistingTree,
     Relayout,
 };
 
+// Whether the layout tree built for the old value stays correct for the new one, so it only has to be laid out again.
+// NOTE: This is limited to the geometry of the box itself. None of these are inherited, so the anonymous boxes and text
+//       nodes the tree builder made with a copy of the element's inherited values don't go stale either.
+static bool can_relayout_existing_tree_for_change_of(CSS::PropertyID property_id)
+{
+    switch (property_id) {
+    case CSS::PropertyID::Width:
+    case CSS::PropertyID::Height:
+    case CSS::PropertyID::MinWidth:
+    case CSS::PropertyID::MinHeight:
+    case CSS::PropertyID::MaxWidth:
+    case CSS::PropertyID::MaxHeight:
+    case CSS::PropertyID::MarginTop:
+    case CSS::PropertyID::MarginRight:
+    case CSS::PropertyID::MarginBottom:
+    case CSS::PropertyID::MarginLeft:
+    case CSS::PropertyID::PaddingTop:
+    case CSS::PropertyID::PaddingRight:
+    case CSS::PropertyID::PaddingBottom:
+    case CSS::PropertyID::PaddingLeft:
+    case CSS::PropertyID::Top:
+    case CSS::PropertyID::Right:
+    case CSS::PropertyID::Bottom:
+    case CSS::PropertyID::Left:
+    case CSS::PropertyID::BoxSizing:
+        return true;
+    default:
+        return false;
+    }
+}
+
 static RequiredInvalidation compute_required_invalidation(CSS::StyleProperties const& old_style, CSS::StyleProperties const& new_style)
 {
     if (&old_style.computed_font() != &new_style.computed_font())
         return RequiredInvalidation::Relayout;
     bool requires_repaint = false;
     bool requires_stacking_context_tree_rebuild = false;
+    bool requires_relayout = false;
     for (auto i = to_underlying(CSS::first_property_id); i <= to_underlying(CSS::last_property_id); ++i) {
         auto property_id = static_cast<CSS::PropertyID>(i);
-        auto const& old_value = old_style.properties()[i];
-        auto const& new_value = new_style.properties()[i];
+        auto old_value = old_style.maybe_null_property(property_id);
+        auto new_value = new_style.maybe_null_property(property_id);
         if (!old_value && !new_value)
             continue;
         if (!old_value || !new_value)
             return RequiredInvalidation::Relayout;
         if (*old_value == *new_value)
             continue;
-        if (CSS::property_affects_layout(property_id))
-            return RequiredInvalidation::Relayout;
+        if (CSS::property_affects_layout(property_id)) {
+            if (!can_relayout_existing_tree_for_change_of(property_id))
+                return RequiredInvalidation::Relayout;
+            requires_relayout = true;
+        }
         if (CSS::property_affects_stacking_context(property_id))
             requires_stacking_context_tree_rebuild = true;
         requires_repaint = true;
     }
+    if (requires_relayout)
+        return RequiredInvalidation::RelayoutExistingTree;
     if (requires_stacking_context_tree_rebuild)
         return RequiredInvalidation::RebuildStackingContextTree;
     if (requires_repaint)
@@ -407,8 +453,14 @@ Element::NeedsRelayout Element::recompute_style()
     set_needs_style_update(false);
     VERIFY(parent());
 
-    // FIXME propagate errors
-    auto new_computed_css_values = MUST(document().style_computer().compute_style(*this));
+    RefPtr<CSS::StyleProperties> new_computed_css_values;
+    if (auto const* sibling = document().style_computer().find_style_sharing_candidate(*this)) {
+        new_computed_css_values = sibling->m_computed_css_values;
+        m_custom_properties = sibling->m_custom_properties;
+    } else {
+        // FIXME propagate errors
+        new_computed_css_values = MUST(document().style_computer().compute_style(*this));
+    }
 
     auto required_invalidation = RequiredInvalidation::Relayout;
 
@@ -433,6 +485,13 @@ Element::NeedsRelayout Element::recompute_style()
         return NeedsRelayout::No;
     }
 
+    if (required_invalidation == RequiredInvalidation::RelayoutExistingTree && layout_node()) {
+        layout_node()->apply_style(*m_computed_css_values);
+        document().invalidate_stacking_context_tree();
+        document().set_needs_layout();
+        return NeedsRelayout::No;
+    }
+
     return NeedsRelayout::Yes;
 }
 
@@ -1323,13 +1382,48 @@ ErrorOr<void> Element::scroll_into_view(Optional<Variant<bool, ScrollIntoViewOpt
     // FIXME: 8. Optionally perform some other action that brings the element to the user’s attention.
 }
 
-void Element::invalidate_style_after_attribute_change(DeprecatedFlyString const& attribute_name)
+void Element::invalidate_style_after_attribute_change(DeprecatedFlyString const& attribute_name, Optional<DeprecatedString> const& old_value, Optional<DeprecatedString> const& new_value)
 {
-    // FIXME: Only invalidate if the attribute can actually affect style.
-    (void)attribute_name;
-
     // FIXME: This will need to become smarter when we implement the :has() selector.
+    using InvalidationScope = CSS::StyleComputer::InvalidationScope;
+    auto& style_computer = document().style_computer();
+    auto scope = style_computer.invalidation_scope_for_attribute_change(attribute_name);
+
+    if (attribute_name == HTML::AttributeNames::class_ || attribute_name == HTML::AttributeNames::id) {
+        // Only the classes (or ids) that were added or removed can change which selectors match.
+        bool is_class = attribute_name == HTML::AttributeNames::class_;
+        auto names_in = [&](Optional<DeprecatedString> const& value) -> Vector<StringView> {
+            if (!value.has_value() || value->is_empty())
+                return {};
+            if (!is_class)
+                return { value->view() };
+            return value->split_view(Infra::is_ascii_whitespace);
+        };
+        auto old_names = names_in(old_value);
+        auto new_names = names_in(new_value);
+        auto add_changed_names = [&](Vector<StringView> const& names, Vector<StringView> const& other_names) {
+            for (auto name : names) {
+                if (other_names.contains_slow(name))
+                    continue;
+                scope = max(scope, is_class ? style_computer.invalidation_scope_for_class_change(name) : style_computer.invalidation_scope_for_id_change(name));
+            }
+        };
+        add_changed_names(old_names, new_names);
+        add_changed_names(new_names, old_names);
+    } else {
+        // NOTE: Other attributes can change style through presentational hints, so they always restyle the subtree.
+        scope = max(scope, InvalidationScope::Subtree);
+    }
+
+    if (scope == InvalidationScope::None)
+        return;
+
     invalidate_style();
+
+    if (scope == InvalidationScope::SubtreeAndFollowingSiblings) {
+        for (auto* sibling = next_sibling(); sibling; sibling = sibling->next_sibling())
+            sibling->invalidate_style();
+    }
 }
 
 // https://www.w3.org/TR/wai-aria-1.2/#tree_exclusion
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/HashTable.h>
 #include <AK/QuickSort.h>
 #include <AK/StringBuilder.h>
 #include <AK/Utf8View.h>
@@ -16,6 +17,7 @@
 #include <LibWeb/CSS/CSSStyleSheet.h>
 #include <LibWeb/CSS/CSSSupportsRule.h>
 #include <LibWeb/CSS/PropertyID.h>
+#include <LibWeb/CSS/StyleProperties.h>
 #include <LibWeb/DOM/Comment.h>
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
@@ -680,4 +682,26 @@ ErrorOr<void> dump_sheet(StringBuilder& builder, CSS::StyleSheet const& sheet)
     return {};
 }
 
+void dump_style_memory(DOM::Document const& document)
+{
+    size_t element_count = 0;
+    HashTable<CSS::StyleProperties const*> distinct_styles;
+    document.for_each_in_inclusive_subtree_of_type<DOM::Element>([&](auto const& element) {
+        ++element_count;
+        if (auto const* style = element.computed_css_values())
+            distinct_styles.set(style);
+        return IterationDecision::Continue;
+    });
+    dbgln("{} elements use {} distinct computed styles", element_count, distinct_styles.size());
+    dbgln("Property storage of all live computed styles: {} bytes", CSS::StyleProperties::total_property_storage_size());
+}
+
+void dump_rendering_timings(DOM::Document const& document)
+{
+    auto const& timings = document.last_rendering_timings();
+    dbgln("Last rendering update: {:.3} ms (animation frame callbacks: {:.3} ms, style: {:.3} ms, layout: {:.3} ms, paint: {:.3} ms)",
+        timings.total(), timings.animation_frame_callbacks, timings.style, timings.layout, timings.paint);
+    dbgln("{} of {} rendering updates went over the frame budget", document.rendering_updates_over_budget(), document.rendering_update_count());
+}
+
 }
@@ -27,5 +27,7 @@ ErrorOr<void> dump_style_rule(StringBuilder&, CSS::CSSStyleRule const&, int inde
 ErrorOr<void> dump_supports_rule(StringBuilder&, CSS::CSSSupportsRule const&, int indent_levels = 0);
 void dump_selector(StringBuilder&, CSS::Selector const&);
 void dump_selector(CSS::Selector const&);
+void dump_style_memory(DOM::Document const&);
+void dump_rendering_timings(DOM::Document const&);
 
 }
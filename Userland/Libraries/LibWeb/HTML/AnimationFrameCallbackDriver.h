@@ -9,26 +9,17 @@
 #include <AK/Function.h>
 #include <AK/IDAllocator.h>
 #include <LibWeb/HTML/EventLoop/EventLoop.h>
-#include <LibWeb/Platform/Timer.h>
 
 namespace Web::HTML {
 
 struct AnimationFrameCallbackDriver {
     using Callback = Function<void(i32)>;
 
-    AnimationFrameCallbackDriver()
-    {
-        m_timer = Platform::Timer::create_single_shot(16, [] {
-            HTML::main_thread_event_loop().schedule();
-        });
-    }
-
     i32 add(Callback handler)
     {
         auto id = m_id_allocator.allocate();
         m_callbacks.set(id, move(handler));
-        if (!m_timer->is_active())
-            m_timer->start();
+        HTML::main_thread_event_loop().schedule_rendering_update();
         return id;
     }
 
@@ -57,7 +48,6 @@ struct AnimationFrameCallbackDriver {
 private:
     HashMap<i32, Callback> m_callbacks;
     IDAllocator m_id_allocator;
-    RefPtr<Platform::Timer> m_timer;
 };
 
 }
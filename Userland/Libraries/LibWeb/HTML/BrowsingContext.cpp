@@ -325,8 +325,10 @@ void BrowsingContext::set_viewport_rect(CSSPixelRect const& rect)
         m_size = rect.size();
         if (auto* document = active_document()) {
             // NOTE: Resizing the viewport changes the reference value for viewport-relative CSS lengths.
+            //       The layout tree itself only goes stale if that changes the style in some way that needs it rebuilt,
+            //       which the style update takes care of.
             document->invalidate_style();
-            document->invalidate_layout();
+            document->set_needs_layout();
         }
         did_change = true;
     }
@@ -354,7 +356,7 @@ void BrowsingContext::set_size(CSSPixelSize size)
 
     if (auto* document = active_document()) {
         document->invalidate_style();
-        document->invalidate_layout();
+        document->set_needs_layout();
     }
 
     for (auto* client : m_viewport_clients)
@@ -823,6 +825,9 @@ void BrowsingContext::scroll_offset_did_change()
 
     // 3. Append doc to doc’s pending scroll event targets.
     doc->pending_scroll_event_targets().append(*doc);
+
+    // NOTE: Scroll events are fired by the scroll steps of the next rendering update.
+    HTML::main_thread_event_loop().schedule_rendering_update();
 }
 
 BrowsingContextGroup* BrowsingContext::group()
@@ -39,6 +39,23 @@ void EventLoop::schedule()
         m_system_event_loop_timer->restart();
 }
 
+void EventLoop::schedule_rendering_update()
+{
+    if (!m_rendering_update_timer) {
+        m_rendering_update_timer = Platform::Timer::create_single_shot(0, [this] {
+            m_rendering_update_is_due = true;
+            schedule();
+        });
+    }
+
+    if (m_rendering_update_is_due || m_rendering_update_timer->is_active())
+        return;
+
+    static constexpr double frame_interval_in_milliseconds = 1000.0 / 60.0;
+    auto time_until_next_frame = m_last_render_opportunity_time + frame_interval_in_milliseconds - HighResolutionTime::unsafe_shared_current_time();
+    m_rendering_update_timer->start(clamp(static_cast<int>(time_until_next_frame), 0, static_cast<int>(frame_interval_in_milliseconds)));
+}
+
 void EventLoop::set_vm(JS::VM& vm)
 {
     VERIFY(!m_vm);
@@ -81,56 +98,10 @@ void EventLoop::spin_until(Function<bool()> goal_condition)
     // NOTE: This is achieved by returning from the function.
 }
 
-// https://html.spec.whatwg.org/multipage/webappapis.html#event-loop-processing-model
-void EventLoop::process()
+// https://html.spec.whatwg.org/multipage/webappapis.html#event-loop-processing-model (step 12, "Update the rendering")
+bool EventLoop::update_the_rendering(double task_start_time)
 {
-    // An event loop must continually run through the following steps for as long as it exists:
-
-    // 1. Let oldestTask be null.
-    OwnPtr<Task> oldest_task;
-
-    // 2. Let taskStartTime be the current high resolution time.
-    // FIXME: 'current high resolution time' in hr-time-3 takes a global object,
-    //        the HTML spec has not been updated to reflect this, let's use the shared timer.
-    //        - https://github.com/whatwg/html/issues/7776
-    double task_start_time = HighResolutionTime::unsafe_shared_current_time();
-
-    // 3. Let taskQueue be one of the event loop's task queues, chosen in an implementation-defined manner,
-    //    with the constraint that the chosen task queue must contain at least one runnable task.
-    //    If there is no such task queue, then jump to the microtasks step below.
-    auto& task_queue = m_task_queue;
-
-    // 4. Set oldestTask to the first runnable task in taskQueue, and remove it from taskQueue.
-    oldest_task = task_queue.take_first_runnable();
-
-    if (oldest_task) {
-        // 5. Set the event loop's currently running task to oldestTask.
-        m_currently_running_task = oldest_task.ptr();
-
-        // 6. Perform oldestTask's steps.
-        oldest_task->execute();
-
-        // 7. Set the event loop's currently running task back to null.
-        m_currently_running_task = nullptr;
-    }
-
-    // 8. Microtasks: Perform a microtask checkpoint.
-    perform_a_microtask_checkpoint();
-
-    // 9. Let hasARenderingOpportunity be false.
-    [[maybe_unused]] bool has_a_rendering_opportunity = false;
-
-    // FIXME: 10. Let now be the current high resolution time. [HRT]
-
-    // FIXME: 11. If oldestTask is not null, then:
-
-    // FIXME:     1. Let top-level browsing contexts be an empty set.
-
-    // FIXME:     2. For each environment settings object settings of oldestTask's script evaluation environment settings object set, append setting's top-level browsing context to top-level browsing contexts.
-
-    // FIXME:     3. Report long tasks, passing in taskStartTime, now (the end time of the task), top-level browsing contexts, and oldestTask.
-
-    // FIXME: 12. Update the rendering: if this is a window event loop, then:
+    bool has_a_rendering_opportunity = false;
 
     // FIXME:     1. Let docs be all Document objects whose relevant agent's event loop is this event loop, sorted arbitrarily except that the following conditions must be met:
     //               - Any Document B whose browsing context's container document is A must be listed after A in the list.
@@ -186,23 +157,88 @@ void EventLoop::process()
 
     // FIXME:     12. For each fully active Document in docs, if the user agent detects that the backing storage associated with a CanvasRenderingContext2D or an OffscreenCanvasRenderingContext2D, context, has been lost, then it must run the context lost steps for each such context:
 
-    // FIXME:     13. For each fully active Document in docs, run the animation frame callbacks for that Document, passing in now as the timestamp.
+    // 13. For each fully active Document in docs, run the animation frame callbacks for that Document, passing in now as the timestamp.
     for_each_fully_active_document_in_docs([&](DOM::Document& document) {
+        auto start_time = HighResolutionTime::unsafe_shared_current_time();
         run_animation_frame_callbacks(document, document.window().performance().now());
+        document.last_rendering_timings().animation_frame_callbacks = HighResolutionTime::unsafe_shared_current_time() - start_time;
     });
 
     // FIXME:     14. For each fully active Document in docs, run the update intersection observations steps for that Document, passing in now as the timestamp. [INTERSECTIONOBSERVER]
 
     // FIXME:     15. Invoke the mark paint timing algorithm for each Document object in docs.
 
-    // FIXME:     16. For each fully active Document in docs, update the rendering or user interface of that Document and its browsing context to reflect the current state.
+    // 16. For each fully active Document in docs, update the rendering or user interface of that Document and its browsing context to reflect the current state.
+    for_each_fully_active_document_in_docs([&](DOM::Document& document) {
+        document.update_the_rendering();
+    });
+
+    return has_a_rendering_opportunity;
+}
+
+// https://html.spec.whatwg.org/multipage/webappapis.html#event-loop-processing-model
+void EventLoop::process()
+{
+    // An event loop must continually run through the following steps for as long as it exists:
+
+    // 1. Let oldestTask be null.
+    OwnPtr<Task> oldest_task;
+
+    // 2. Let taskStartTime be the current high resolution time.
+    // FIXME: 'current high resolution time' in hr-time-3 takes a global object,
+    //        the HTML spec has not been updated to reflect this, let's use the shared timer.
+    //        - https://github.com/whatwg/html/issues/7776
+    double task_start_time = HighResolutionTime::unsafe_shared_current_time();
+
+    // 3. Let taskQueue be one of the event loop's task queues, chosen in an implementation-defined manner,
+    //    with the constraint that the chosen task queue must contain at least one runnable task.
+    //    If there is no such task queue, then jump to the microtasks step below.
+    auto& task_queue = m_task_queue;
+
+    // 4. Set oldestTask to the first runnable task in taskQueue, and remove it from taskQueue.
+    oldest_task = task_queue.take_first_runnable();
+
+    if (oldest_task) {
+        // 5. Set the event loop's currently running task to oldestTask.
+        m_currently_running_task = oldest_task.ptr();
+
+        // 6. Perform oldestTask's steps.
+        oldest_task->execute();
+
+        // 7. Set the event loop's currently running task back to null.
+        m_currently_running_task = nullptr;
+    }
+
+    // 8. Microtasks: Perform a microtask checkpoint.
+    perform_a_microtask_checkpoint();
+
+    // 9. Let hasARenderingOpportunity be false.
+    [[maybe_unused]] bool has_a_rendering_opportunity = false;
+
+    // FIXME: 10. Let now be the current high resolution time. [HRT]
+
+    // FIXME: 11. If oldestTask is not null, then:
+
+    // FIXME:     1. Let top-level browsing contexts be an empty set.
+
+    // FIXME:     2. For each environment settings object settings of oldestTask's script evaluation environment settings object set, append setting's top-level browsing context to top-level browsing contexts.
+
+    // FIXME:     3. Report long tasks, passing in taskStartTime, now (the end time of the task), top-level browsing contexts, and oldestTask.
+
+    // 12. Update the rendering: if this is a window event loop, then:
+    if (m_type == Type::Window && m_rendering_update_is_due) {
+        m_rendering_update_is_due = false;
+        has_a_rendering_opportunity = update_the_rendering(task_start_time);
+    }
 
     // 13. If all of the following are true
     // - this is a window event loop
     // - there is no task in this event loop's task queues whose document is fully active
     // - this event loop's microtask queue is empty
     // - hasARenderingOpportunity is false
-    // FIXME: has_a_rendering_opportunity is always true
+    // FIXME: Take hasARenderingOpportunity into account. We update the rendering only when asked to and idle periods are how
+    //        we collect garbage, so skipping them for rendering opportunities would starve the collector during animations.
+
     if (m_type == Type::Window && !task_queue.has_runnable_tasks() && m_microtask_queue.is_empty() /*&& !has_a_rendering_opportunity*/) {
         // 1. Set this event loop's last idle period start time to the current high resolution time.
         m_last_idle_period_start_time = HighResolutionTime::unsafe_shared_current_time();
@@ -214,6 +250,9 @@ void EventLoop::process()
         //    perform the start an idle period algorithm for win with computeDeadline. [REQUESTIDLECALLBACK]
         for (auto& win : same_loop_windows())
             win->start_an_idle_period();
+
+        // NOTE: Nothing is waiting to run, so this is a good time to collect garbage if enough has piled up.
+        vm().heap().did_become_idle();
     }
 
     // FIXME: 14. If this is a worker event loop, then:
@@ -54,6 +54,9 @@ public:
 
     void schedule();
 
+    // Asks for the rendering of this event loop's documents to be updated at its next rendering opportunity.
+    void schedule_rendering_update();
+
     void perform_a_microtask_checkpoint();
 
     void register_document(Badge<DOM::Document>, DOM::Document&);
@@ -78,6 +81,8 @@ public:
     bool execution_paused() const { return m_execution_paused; }
 
 private:
+    bool update_the_rendering(double task_start_time);
+
     Type m_type { Type::Window };
 
     TaskQueue m_task_queue;
@@ -95,6 +100,11 @@ private:
 
     RefPtr<Platform::Timer> m_system_event_loop_timer;
 
+    // NOTE: We don't know when the display refreshes, so we give ourselves a rendering opportunity every 1/60th of a second,
+    //       and only when something has asked for one.
+    RefPtr<Platform::Timer> m_rendering_update_timer;
+    bool m_rendering_update_is_due { false };
+
     // https://html.spec.whatwg.org/#performing-a-microtask-checkpoint
     bool m_performing_a_microtask_checkpoint { false };
 
@@ -19,5 +19,8 @@ struct EntityMatch {
 
 Optional<EntityMatch> code_points_from_entity(StringView);
 
+// The length of the longest entity name, "CounterClockwiseContourIntegral;".
+constexpr size_t longest_entity_name_length = 32;
+
 }
 }
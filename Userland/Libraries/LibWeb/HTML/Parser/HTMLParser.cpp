@@ -30,6 +30,7 @@
 #include <LibWeb/HTML/Window.h>
 #include <LibWeb/HighResolutionTime/TimeOrigin.h>
 #include <LibWeb/Infra/CharacterTypes.h>
+#include <LibWeb/Loader/ResourceLoader.h>
 #include <LibWeb/Namespace.h>
 #include <LibWeb/SVG/TagNames.h>
 
@@ -214,6 +215,35 @@ void HTMLParser::run(const AK::URL& url)
     m_document->detach_parser({});
 }
 
+void HTMLParser::append_input(ReadonlyBytes input)
+{
+    m_tokenizer.append_input(input);
+    run_on_available_input();
+}
+
+void HTMLParser::finish_input()
+{
+    m_tokenizer.finish_input();
+    run_on_available_input();
+}
+
+void HTMLParser::run_on_available_input()
+{
+    // NOTE: If the tokenizer is blocked, a parser-blocking script is spinning the event loop further up the stack.
+    //       The run() that's waiting for it gets to the new input (and finishes parsing) once it's done.
+    if (m_tokenizer.is_blocked())
+        return;
+
+    run();
+
+    if (!m_tokenizer.is_input_complete())
+        return;
+
+    m_document->set_source(m_tokenizer.source());
+    the_end();
+    m_document->detach_parser({});
+}
+
 // https://html.spec.whatwg.org/multipage/parsing.html#the-end
 void HTMLParser::the_end()
 {
@@ -324,6 +354,103 @@ void HTMLParser::the_end()
     m_document->set_ready_for_post_load_tasks(true);
 }
 
+// https://html.spec.whatwg.org/multipage/parsing.html#start-the-speculative-html-parser
+void HTMLParser::start_the_speculative_html_parser()
+{
+    // NOTE: We don't build a speculative mock tree, but only tokenize the input after the insertion point and start
+    //       fetching the scripts, style sheets and images it refers to, the same way their elements would. That way,
+    //       they're (hopefully) in the resource cache by the time the parser gets to them.
+    // FIXME: Track the insertion mode, so we don't fetch things inside <template> or foreign content.
+    VERIFY(m_speculative_fetches.is_empty());
+
+    auto source = m_tokenizer.source();
+    HTMLTokenizer tokenizer(source.substring_view(m_tokenizer.current_offset()), "utf-8");
+
+    // NOTE: The first <base> element's href applies to the URLs after it, unless the document already has one.
+    Optional<AK::URL> base_url;
+    if (m_document->first_base_element_with_href_in_tree_order())
+        base_url = m_document->base_url();
+
+    auto parse_url = [&](StringView url) {
+        if (base_url.has_value())
+            return base_url->complete_url(url);
+        return m_document->parse_url(url);
+    };
+
+    auto fetch = [&](Resource::Type type, LoadRequest request) {
+        if (auto resource = ResourceLoader::the().load_resource(type, request))
+            m_speculative_fetches.append(resource.release_nonnull());
+    };
+
+    for (;;) {
+        auto token = tokenizer.next_token();
+        if (!token.has_value() || token->is_end_of_file())
+            break;
+        if (!token->is_start_tag())
+            continue;
+
+        auto const& tag_name = token->tag_name();
+
+        if (tag_name == HTML::TagNames::base) {
+            auto href = token->attribute(HTML::AttributeNames::href);
+            if (!href.is_null() && !base_url.has_value())
+                base_url = m_document->fallback_base_url().complete_url(href);
+        } else if (tag_name == HTML::TagNames::script) {
+            auto src = token->attribute(HTML::AttributeNames::src);
+            // FIXME: Fetch module scripts as well, once their fetches go through the resource cache.
+            if (!src.is_null() && m_scripting_enabled && !token->attribute(HTML::AttributeNames::type).equals_ignoring_ascii_case("module"sv))
+                fetch(Resource::Type::Generic, LoadRequest::create_for_url_on_page(parse_url(src), m_document->page()));
+        } else if (tag_name == HTML::TagNames::link) {
+            auto href = token->attribute(HTML::AttributeNames::href);
+            if (!href.is_null() && !token->has_attribute(HTML::AttributeNames::disabled)) {
+                bool is_stylesheet = false;
+                bool is_alternate = false;
+                bool is_preload = false;
+                for (auto part : token->attribute(HTML::AttributeNames::rel).split_view_if(Infra::is_ascii_whitespace)) {
+                    if (part.equals_ignoring_ascii_case("stylesheet"sv))
+                        is_stylesheet = true;
+                    else if (part.equals_ignoring_ascii_case("alternate"sv))
+                        is_alternate = true;
+                    else if (part.equals_ignoring_ascii_case("preload"sv))
+                        is_preload = true;
+                }
+
+                // NOTE: These have to match the requests HTMLLinkElement makes, or we won't get a cache hit.
+                if (is_stylesheet && !is_alternate)
+                    fetch(Resource::Type::Generic, LoadRequest::create_for_url_on_page(parse_url(href), m_document->page()));
+                if (is_preload) {
+                    LoadRequest request;
+                    request.set_url(parse_url(href));
+                    fetch(Resource::Type::Generic, move(request));
+                }
+            }
+        } else if (tag_name == HTML::TagNames::img) {
+            auto src = token->attribute(HTML::AttributeNames::src);
+            if (!src.is_null())
+                fetch(Resource::Type::Image, LoadRequest::create_for_url_on_page(parse_url(src), m_document->page()));
+        }
+
+        // Switch the tokenizer to the state the tree builder would put it in, so we don't mistake text for tags.
+        if (tag_name == HTML::TagNames::script)
+            tokenizer.switch_to(HTMLTokenizer::State::ScriptData);
+        else if (tag_name.is_one_of(HTML::TagNames::style, HTML::TagNames::xmp, HTML::TagNames::iframe, HTML::TagNames::noembed, HTML::TagNames::noframes))
+            tokenizer.switch_to(HTMLTokenizer::State::RAWTEXT);
+        else if (tag_name == HTML::TagNames::noscript && m_scripting_enabled)
+            tokenizer.switch_to(HTMLTokenizer::State::RAWTEXT);
+        else if (tag_name.is_one_of(HTML::TagNames::textarea, HTML::TagNames::title))
+            tokenizer.switch_to(HTMLTokenizer::State::RCDATA);
+        else if (tag_name == HTML::TagNames::plaintext)
+            break;
+    }
+}
+
+// https://html.spec.whatwg.org/multipage/parsing.html#stop-the-speculative-html-parser
+void HTMLParser::stop_the_speculative_html_parser()
+{
+    // NOTE: The resource cache holds on to what we fetched, and the elements will pick it up from there.
+    m_speculative_fetches.clear();
+}
+
 void HTMLParser::process_using_the_rules_for(InsertionMode mode, HTMLToken& token)
 {
     switch (mode) {
@@ -2321,7 +2448,8 @@ void HTMLParser::handle_text(HTMLToken& token)
                     // 2. Set the pending parsing-blocking script to null.
                     auto the_script = document().take_pending_parsing_blocking_script({});
 
-                    // FIXME: 3. Start the speculative HTML parser for this instance of the HTML parser.
+                    // 3. Start the speculative HTML parser for this instance of the HTML parser.
+                    start_the_speculative_html_parser();
 
                     // 4. Block the tokenizer for this instance of the HTML parser, such that the event loop will not run tasks that invoke the tokenizer.
                     m_tokenizer.set_blocked(true);
@@ -2337,10 +2465,13 @@ void HTMLParser::handle_text(HTMLToken& token)
                     }
 
                     // 6. If this parser has been aborted in the meantime, return.
-                    if (m_aborted)
+                    if (m_aborted) {
+                        stop_the_speculative_html_parser();
                         return;
+                    }
 
-                    // FIXME: 7. Stop the speculative HTML parser for this instance of the HTML parser.
+                    // 7. Stop the speculative HTML parser for this instance of the HTML parser.
+                    stop_the_speculative_html_parser();
 
                     // 8. Unblock the tokenizer for this instance of the HTML parser, such that tasks that invoke the tokenizer can again be run.
                     m_tokenizer.set_blocked(false);
@@ -3557,6 +3688,15 @@ JS::NonnullGCPtr<HTMLParser> HTMLParser::create(DOM::Document& document, StringV
     return document.heap().allocate_without_realm<HTMLParser>(document, input, encoding);
 }
 
+JS::NonnullGCPtr<HTMLParser> HTMLParser::create_for_incremental_input(DOM::Document& document, ByteBuffer const& first_chunk)
+{
+    auto encoding = document.has_encoding() ? document.encoding().value() : run_encoding_sniffing_algorithm(document, first_chunk);
+    auto parser = document.heap().allocate_without_realm<HTMLParser>(document, ""sv, encoding);
+    parser->m_tokenizer.expect_more_input();
+    parser->m_tokenizer.append_input(first_chunk);
+    return parser;
+}
+
 // https://html.spec.whatwg.org/multipage/parsing.html#html-fragment-serialisation-algorithm
 DeprecatedString HTMLParser::serialize_html_fragment(DOM::Node const& node)
 {
@@ -51,9 +51,17 @@ public:
     static JS::NonnullGCPtr<HTMLParser> create_with_uncertain_encoding(DOM::Document&, ByteBuffer const& input);
     static JS::NonnullGCPtr<HTMLParser> create(DOM::Document&, StringView input, DeprecatedString const& encoding);
 
+    // Creates a parser that's fed the rest of its input with append_input() as it arrives.
+    // NOTE: The encoding is sniffed from the first chunk, so it should be at least 1024 bytes if possible.
+    static JS::NonnullGCPtr<HTMLParser> create_for_incremental_input(DOM::Document&, ByteBuffer const& first_chunk);
+
     void run();
     void run(const AK::URL&);
 
+    // These parse as much of the input as there is so far, and finish parsing the document once it's complete.
+    void append_input(ReadonlyBytes);
+    void finish_input();
+
     DOM::Document& document();
 
     static Vector<JS::Handle<DOM::Node>> parse_html_fragment(DOM::Element& context_element, StringView);
@@ -115,6 +123,11 @@ private:
 
     void the_end();
 
+    void run_on_available_input();
+
+    void start_the_speculative_html_parser();
+    void stop_the_speculative_html_parser();
+
     void stop_parsing() { m_stop_parsing = true; }
 
     void generate_implied_end_tags(DeprecatedFlyString const& exception = {});
@@ -194,6 +207,9 @@ private:
 
     Vector<HTMLToken> m_pending_table_character_tokens;
 
+    // The resources fetched by the speculative HTML parser, kept alive until it's stopped.
+    Vector<NonnullRefPtr<Resource>> m_speculative_fetches;
+
     JS::GCPtr<DOM::Text> m_character_insertion_node;
     StringBuilder m_character_insertion_builder;
 };
@@ -185,8 +185,11 @@ static inline void log_parse_error(SourceLocation const& location = SourceLocati
 
 Optional<u32> HTMLTokenizer::next_code_point()
 {
-    if (m_utf8_iterator == m_utf8_view.end())
+    if (m_utf8_iterator == m_utf8_view.end()) {
+        if (!m_input_is_complete)
+            m_ran_out_of_input = true;
         return {};
+    }
 
     u32 code_point;
     // https://html.spec.whatwg.org/multipage/parsing.html#preprocessing-the-input-stream:tokenization
@@ -232,8 +235,11 @@ Optional<u32> HTMLTokenizer::peek_code_point(size_t offset) const
     auto it = m_utf8_iterator;
     for (size_t i = 0; i < offset && it != m_utf8_view.end(); ++i)
         ++it;
-    if (it == m_utf8_view.end())
+    if (it == m_utf8_view.end()) {
+        if (!m_input_is_complete)
+            m_ran_out_of_input = true;
         return {};
+    }
     return *it;
 }
 
@@ -247,6 +253,56 @@ HTMLToken::Position HTMLTokenizer::nth_last_position(size_t n)
 }
 
 Optional<HTMLToken> HTMLTokenizer::next_token()
+{
+    if (m_input_is_complete || !m_queued_tokens.is_empty())
+        return consume_next_token();
+
+    // NOTE: Until we have all of the input, the end of what we have isn't the end of the file. So if we run into it, we
+    //       throw away everything we did for this token and try again once there's more input.
+    auto saved_state = save_state();
+    m_ran_out_of_input = false;
+    auto token = consume_next_token();
+    if (!m_ran_out_of_input)
+        return token;
+
+    restore_state(move(saved_state));
+    return {};
+}
+
+HTMLTokenizer::SavedState HTMLTokenizer::save_state() const
+{
+    return {
+        .state = m_state,
+        .return_state = m_return_state,
+        .temporary_buffer = m_temporary_buffer,
+        .current_builder = m_current_builder.to_deprecated_string(),
+        .last_emitted_start_tag_name = m_last_emitted_start_tag_name,
+        .has_emitted_eof = m_has_emitted_eof,
+        .character_reference_code = m_character_reference_code,
+        .utf8_iterator = m_utf8_iterator,
+        .prev_utf8_iterator = m_prev_utf8_iterator,
+        .source_positions = m_source_positions,
+    };
+}
+
+void HTMLTokenizer::restore_state(SavedState state)
+{
+    // NOTE: Tokens are only ever emitted once they're complete, so there's no current token to restore.
+    m_state = state.state;
+    m_return_state = state.return_state;
+    m_temporary_buffer = move(state.temporary_buffer);
+    m_current_builder.clear();
+    m_current_builder.append(state.current_builder);
+    m_last_emitted_start_tag_name = move(state.last_emitted_start_tag_name);
+    m_has_emitted_eof = state.has_emitted_eof;
+    m_character_reference_code = state.character_reference_code;
+    m_utf8_iterator = state.utf8_iterator;
+    m_prev_utf8_iterator = state.prev_utf8_iterator;
+    m_source_positions = move(state.source_positions);
+    m_queued_tokens.clear();
+}
+
+Optional<HTMLToken> HTMLTokenizer::consume_next_token()
 {
     if (!m_source_positions.is_empty()) {
         auto last_position = m_source_positions.last();
@@ -1258,6 +1314,7 @@ _StartOfFunction:
                 ANYTHING_ELSE
                 {
                     m_current_builder.append_code_point(current_input_character.value());
+                    consume_code_points_into_current_builder_until_any_of("\"&"sv);
                     continue;
                 }
             }
@@ -1290,6 +1347,7 @@ _StartOfFunction:
                 ANYTHING_ELSE
                 {
                     m_current_builder.append_code_point(current_input_character.value());
+                    consume_code_points_into_current_builder_until_any_of("'&"sv);
                     continue;
                 }
             }
@@ -1460,6 +1518,7 @@ _StartOfFunction:
                 ANYTHING_ELSE
                 {
                     m_current_builder.append_code_point(current_input_character.value());
+                    consume_code_points_into_current_builder_until_any_of("<-"sv);
                     continue;
                 }
             }
@@ -1640,7 +1699,11 @@ _StartOfFunction:
             {
                 size_t byte_offset = m_utf8_view.byte_offset_of(m_prev_utf8_iterator);
 
-                auto match = HTML::code_points_from_entity(m_decoded_input.substring_view(byte_offset, m_decoded_input.length() - byte_offset));
+                // NOTE: A longer entity name might start with the one we'd match, so we need to see as much input as the longest one.
+                if (!m_input_is_complete && m_decoded_input.length() - byte_offset < longest_entity_name_length)
+                    m_ran_out_of_input = true;
+
+                auto match = HTML::code_points_from_entity(m_decoded_input.string_view().substring_view(byte_offset));
 
                 if (match.has_value()) {
                     skip(match->entity.length() - 1);
@@ -2769,6 +2832,41 @@ bool HTMLTokenizer::consume_next_if_match(StringView string, CaseSensitivity cas
     return true;
 }
 
+// NOTE: This consumes a run of code points that the current state would append to the current builder one by one
+//       all at once. It stops before NUL and CR, as those need to be replaced, and before the given ASCII characters.
+void HTMLTokenizer::consume_code_points_into_current_builder_until_any_of(StringView characters)
+{
+    auto input = m_decoded_input.string_view();
+    auto start = m_utf8_view.byte_offset_of(m_utf8_iterator);
+    auto position = m_source_positions.is_empty() ? HTMLToken::Position {} : m_source_positions.last();
+
+    auto end = start;
+    for (; end < input.length(); ++end) {
+        auto byte = static_cast<u8>(input[end]);
+        if (byte == '\0' || byte == '\r' || characters.contains(static_cast<char>(byte)))
+            break;
+        if (byte == '\n') {
+            ++position.line;
+            position.column = 0;
+        } else if ((byte & 0xc0) != 0x80) {
+            ++position.column;
+        }
+    }
+    if (end == start)
+        return;
+
+    m_current_builder.append(input.substring_view(start, end - start));
+
+    auto start_of_last_code_point = end - 1;
+    while (start_of_last_code_point > start && (static_cast<u8>(input[start_of_last_code_point]) & 0xc0) == 0x80)
+        --start_of_last_code_point;
+    m_prev_utf8_iterator = m_utf8_view.iterator_at_byte_offset(start_of_last_code_point);
+    m_utf8_iterator = m_utf8_view.iterator_at_byte_offset(end);
+
+    if (!m_source_positions.is_empty())
+        m_source_positions.append(position);
+}
+
 void HTMLTokenizer::create_new_token(HTMLToken::Type type)
 {
     m_current_token = { type };
@@ -2789,8 +2887,7 @@ void HTMLTokenizer::create_new_token(HTMLToken::Type type)
 
 HTMLTokenizer::HTMLTokenizer()
 {
-    m_decoded_input = "";
-    m_utf8_view = Utf8View(m_decoded_input);
+    m_utf8_view = Utf8View(m_decoded_input.string_view());
     m_utf8_iterator = m_utf8_view.begin();
     m_prev_utf8_iterator = m_utf8_view.begin();
     m_source_positions.empend(0u, 0u);
@@ -2798,27 +2895,92 @@ HTMLTokenizer::HTMLTokenizer()
 
 HTMLTokenizer::HTMLTokenizer(StringView input, DeprecatedString const& encoding)
 {
-    auto* decoder = TextCodec::decoder_for(encoding);
-    VERIFY(decoder);
-    m_decoded_input = decoder->to_utf8(input);
-    m_utf8_view = Utf8View(m_decoded_input);
+    m_decoder = TextCodec::decoder_for(encoding);
+    VERIFY(m_decoder);
+    m_decoded_input.append(m_decoder->to_utf8(input));
+    m_utf8_view = Utf8View(m_decoded_input.string_view());
     m_utf8_iterator = m_utf8_view.begin();
     m_prev_utf8_iterator = m_utf8_view.begin();
     m_source_positions.empend(0u, 0u);
 }
 
+// Returns how many bytes at the end of the input belong to a UTF-8 sequence that isn't complete yet.
+static size_t length_of_incomplete_utf8_sequence_at_end(ReadonlyBytes input)
+{
+    for (size_t length = 1; length <= min<size_t>(input.size(), 3); ++length) {
+        auto byte = input[input.size() - length];
+        if ((byte & 0xc0) == 0x80)
+            continue;
+        size_t sequence_length = 1;
+        if ((byte & 0xe0) == 0xc0)
+            sequence_length = 2;
+        else if ((byte & 0xf0) == 0xe0)
+            sequence_length = 3;
+        else if ((byte & 0xf8) == 0xf0)
+            sequence_length = 4;
+        return sequence_length > length ? length : 0;
+    }
+    return 0;
+}
+
+void HTMLTokenizer::append_input(StringView input)
+{
+    VERIFY(!m_input_is_complete);
+    VERIFY(m_decoder);
+
+    ByteBuffer combined_input;
+    if (!m_undecoded_input.is_empty()) {
+        combined_input = MUST(ByteBuffer::copy(m_undecoded_input));
+        combined_input.append(input.bytes());
+        input = combined_input;
+        m_undecoded_input.clear();
+    }
+
+    // FIXME: Keep code points that are split across chunks together for other multi-byte encodings as well.
+    size_t length_to_hold_back = 0;
+    if (m_decoder == TextCodec::decoder_for("utf-8"))
+        length_to_hold_back = length_of_incomplete_utf8_sequence_at_end(input.bytes());
+
+    auto length_to_decode = input.length() - length_to_hold_back;
+    append_decoded_input(m_decoder->to_utf8(input.substring_view(0, length_to_decode)));
+    m_undecoded_input.append(input.substring_view(length_to_decode).bytes());
+}
+
+void HTMLTokenizer::finish_input()
+{
+    VERIFY(!m_input_is_complete);
+    if (!m_undecoded_input.is_empty()) {
+        append_decoded_input(m_decoder->to_utf8(m_undecoded_input));
+        m_undecoded_input.clear();
+    }
+    m_input_is_complete = true;
+}
+
+void HTMLTokenizer::append_decoded_input(StringView input)
+{
+    auto utf8_iterator_byte_offset = m_utf8_view.byte_offset_of(m_utf8_iterator);
+    auto prev_utf8_iterator_byte_offset = m_utf8_view.byte_offset_of(m_prev_utf8_iterator);
+
+    m_decoded_input.append(input);
+
+    m_utf8_view = Utf8View(m_decoded_input.string_view());
+    m_utf8_iterator = m_utf8_view.iterator_at_byte_offset(utf8_iterator_byte_offset);
+    m_prev_utf8_iterator = m_utf8_view.iterator_at_byte_offset(prev_utf8_iterator_byte_offset);
+}
+
 void HTMLTokenizer::insert_input_at_insertion_point(DeprecatedString const& input)
 {
     auto utf8_iterator_byte_offset = m_utf8_view.byte_offset_of(m_utf8_iterator);
 
     // FIXME: Implement a InputStream to handle insertion_point and iterators.
+    auto decoded_input = m_decoded_input.string_view();
     StringBuilder builder {};
-    builder.append(m_decoded_input.substring(0, m_insertion_point.position));
+    builder.append(decoded_input.substring_view(0, m_insertion_point.position));
     builder.append(input);
-    builder.append(m_decoded_input.substring(m_insertion_point.position));
-    m_decoded_input = builder.to_deprecated_string();
+    builder.append(decoded_input.substring_view(m_insertion_point.position));
+    m_decoded_input = move(builder);
 
-    m_utf8_view = Utf8View(m_decoded_input);
+    m_utf8_view = Utf8View(m_decoded_input.string_view());
     m_utf8_iterator = m_utf8_view.iterator_at_byte_offset(utf8_iterator_byte_offset);
 
     m_insertion_point.position += input.length();
@@ -15,6 +15,10 @@
 #include <LibWeb/Forward.h>
 #include <LibWeb/HTML/Parser/HTMLToken.h>
 
+namespace TextCodec {
+class Decoder;
+}
+
 namespace Web::HTML {
 
 #define ENUMERATE_TOKENIZER_STATES                                        \
@@ -123,7 +127,18 @@ public:
     void set_blocked(bool b) { m_blocked = b; }
     bool is_blocked() const { return m_blocked; }
 
-    DeprecatedString source() const { return m_decoded_input; }
+    StringView source() const { return m_decoded_input.string_view(); }
+
+    // The byte offset of the next input character in source().
+    size_t current_offset() const { return m_utf8_view.iterator_offset(m_utf8_iterator); }
+
+    // NOTE: The input doesn't have to be there all at once. After expect_more_input(), next_token() returns nothing
+    //       when it runs out of input in the middle of a token, and starts over from that token once more input has
+    //       been appended. This goes on until finish_input() is called.
+    void expect_more_input() { m_input_is_complete = false; }
+    void append_input(StringView input);
+    void finish_input();
+    bool is_input_complete() const { return m_input_is_complete; }
 
     void insert_input_at_insertion_point(DeprecatedString const& input);
     void insert_eof();
@@ -147,10 +162,30 @@ public:
     void abort() { m_aborted = true; }
 
 private:
+    Optional<HTMLToken> consume_next_token();
+
+    struct SavedState {
+        State state;
+        State return_state;
+        Vector<u32> temporary_buffer;
+        DeprecatedString current_builder;
+        Optional<DeprecatedString> last_emitted_start_tag_name;
+        bool has_emitted_eof;
+        u32 character_reference_code;
+        Utf8CodePointIterator utf8_iterator;
+        Utf8CodePointIterator prev_utf8_iterator;
+        Vector<HTMLToken::Position> source_positions;
+    };
+    SavedState save_state() const;
+    void restore_state(SavedState);
+
+    void append_decoded_input(StringView);
+
     void skip(size_t count);
     Optional<u32> next_code_point();
     Optional<u32> peek_code_point(size_t offset) const;
     bool consume_next_if_match(StringView, CaseSensitivity = CaseSensitivity::CaseSensitive);
+    void consume_code_points_into_current_builder_until_any_of(StringView characters);
     void create_new_token(HTMLToken::Type);
     bool current_end_tag_token_is_appropriate() const;
     DeprecatedString consume_current_builder();
@@ -183,7 +218,15 @@ private:
 
     Vector<u32> m_temporary_buffer;
 
-    DeprecatedString m_decoded_input;
+    StringBuilder m_decoded_input;
+
+    TextCodec::Decoder* m_decoder { nullptr };
+
+    // The end of the input we've received so far, if it may be part of a code point that continues in the next chunk.
+    ByteBuffer m_undecoded_input;
+
+    bool m_input_is_complete { true };
+    mutable bool m_ran_out_of_input { false };
 
     struct InsertionPoint {
         size_t position { 0 };
@@ -5,7 +5,10 @@
  */
 
 #include <AK/Debug.h>
+#include <AK/HashMap.h>
+#include <AK/StringHash.h>
 #include <LibCore/ElapsedTimer.h>
+#include <LibJS/AST.h>
 #include <LibJS/Interpreter.h>
 #include <LibWeb/Bindings/ExceptionOrUtils.h>
 #include <LibWeb/HTML/Scripting/ClassicScript.h>
@@ -15,6 +18,45 @@
 
 namespace Web::HTML {
 
+// Reloading a page, or navigating between pages of the same site, runs the same scripts over and over again.
+// Their parsed programs don't depend on the realm they run in, so we keep the recently parsed ones around and
+// skip the parser if a script with the same URL and source text comes along again.
+// NOTE: Nested functions are only compiled to bytecode the first time they're called, so this only keeps the AST.
+struct CachedProgram {
+    u32 source_hash { 0 };
+    size_t source_line_number { 0 };
+    NonnullRefPtr<JS::Program> program;
+};
+
+static constexpr size_t parsed_program_cache_max_size = 64;
+
+static HashMap<DeprecatedString, CachedProgram>& parsed_program_cache()
+{
+    static HashMap<DeprecatedString, CachedProgram> cache;
+    return cache;
+}
+
+static RefPtr<JS::Program> find_cached_program(DeprecatedString const& filename, StringView source, size_t source_line_number)
+{
+    auto entry = parsed_program_cache().get(filename);
+    if (!entry.has_value())
+        return nullptr;
+    if (entry->source_line_number != source_line_number || entry->source_hash != string_hash(source.characters_without_null_termination(), source.length()))
+        return nullptr;
+    // NOTE: The hash only tells us that the source text is likely the same, so compare it with what was parsed.
+    if (entry->program->source_code().code().bytes_as_string_view() != source)
+        return nullptr;
+    return entry->program;
+}
+
+static void cache_program(DeprecatedString const& filename, StringView source, size_t source_line_number, NonnullRefPtr<JS::Program> program)
+{
+    auto& cache = parsed_program_cache();
+    if (cache.size() >= parsed_program_cache_max_size && !cache.contains(filename))
+        cache.remove(cache.begin());
+    cache.set(filename, { string_hash(source.characters_without_null_termination(), source.length()), source_line_number, move(program) });
+}
+
 // https://html.spec.whatwg.org/multipage/webappapis.html#creating-a-classic-script
 JS::NonnullGCPtr<ClassicScript> ClassicScript::create(DeprecatedString filename, StringView source, EnvironmentSettingsObject& environment_settings_object, AK::URL base_url, size_t source_line_number, MutedErrors muted_errors)
 {
@@ -46,6 +88,14 @@ JS::NonnullGCPtr<ClassicScript> ClassicScript::create(DeprecatedString filename,
     // NOTE: Error to rethrow was set to null in the construction of ClassicScript. We do not have parse error as it would currently go unused.
 
     // 10. Let result be ParseScript(source, settings's Realm, script).
+    if (!source.is_empty() && !script->filename().is_empty()) {
+        if (auto program = find_cached_program(script->filename(), source, source_line_number)) {
+            dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Using the cached parse of {}", script->filename());
+            script->m_script_record = JS::Script::create(environment_settings_object.realm(), script->filename(), program.release_nonnull(), script);
+            return script;
+        }
+    }
+
     auto parse_timer = Core::ElapsedTimer::start_new();
     auto result = JS::Script::parse(source, environment_settings_object.realm(), script->filename(), script, source_line_number);
     dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Parsed {} in {}ms", script->filename(), parse_timer.elapsed());
@@ -65,6 +115,8 @@ JS::NonnullGCPtr<ClassicScript> ClassicScript::create(DeprecatedString filename,
 
     // 12. Set script's record to result.
     script->m_script_record = *result.release_value();
+    if (!source.is_empty() && !script->filename().is_empty())
+        cache_program(script->filename(), source, source_line_number, script->m_script_record->parse_node());
 
     // 13. Return script.
     return script;
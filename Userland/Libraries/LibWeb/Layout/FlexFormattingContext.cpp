@@ -1101,6 +1101,15 @@ void FlexFormattingContext::determine_hypothetical_cross_size_of_item(FlexItem&
     }
 
     // For indefinite cross sizes, we perform a throwaway layout and then measure it.
+    HashMap<CSSPixels, CSSPixels>* cache = nullptr;
+    if (is_row_layout()) {
+        cache = &m_state.m_root.intrinsic_sizes.ensure(&item.box, [] { return adopt_own(*new LayoutState::IntrinsicSizes); })->automatic_content_height_with_definite_content_width;
+        if (auto cached_height = cache->get(item.main_size.value()); cached_height.has_value()) {
+            item.hypothetical_cross_size = css_clamp(*cached_height, clamp_min, clamp_max);
+            return;
+        }
+    }
+
     LayoutState throwaway_state(&m_state);
 
     auto& box_state = throwaway_state.get_mutable(item.box);
@@ -1122,6 +1131,8 @@ void FlexFormattingContext::determine_hypothetical_cross_size_of_item(FlexItem&
 
     auto automatic_cross_size = is_row_layout() ? independent_formatting_context->automatic_content_height()
                                                 : independent_formatting_context->automatic_content_width();
+    if (cache)
+        cache->set(item.main_size.value(), automatic_cross_size);
 
     item.hypothetical_cross_size = css_clamp(automatic_cross_size, clamp_min, clamp_max);
 }
@@ -169,6 +169,10 @@ struct LayoutState {
         Optional<CSSPixels> max_content_height_with_min_content_available_width;
         Optional<CSSPixels> min_content_height_with_max_content_available_width;
         Optional<CSSPixels> max_content_height_with_max_content_available_width;
+
+        // The height a flex item in a row ends up with when laid out with a definite main size (its content width),
+        // keyed by that width. Nested flex containers would otherwise lay out their items again for every ancestor.
+        HashMap<CSSPixels, CSSPixels> automatic_content_height_with_definite_content_width;
     };
 
     HashMap<NodeWithStyleAndBoxModelMetrics const*, NonnullOwnPtr<IntrinsicSizes>> mutable intrinsic_sizes;
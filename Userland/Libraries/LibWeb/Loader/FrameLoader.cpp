@@ -182,6 +182,8 @@ bool FrameLoader::parse_document(DOM::Document& document, ByteBuffer const& data
 {
     auto& mime_type = document.content_type();
     if (mime_type == "text/html" || mime_type == "image/svg+xml") {
+        // FIXME: Feed the parser the response body as it arrives with HTMLParser::create_for_incremental_input(),
+        //        once ResourceLoader can hand it to us in chunks instead of buffering all of it.
         auto parser = HTML::HTMLParser::create_with_uncertain_encoding(document, data);
         parser->run(document.url());
         return true;
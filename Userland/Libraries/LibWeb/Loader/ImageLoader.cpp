@@ -8,6 +8,7 @@
 #include <LibGfx/Bitmap.h>
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
+#include <LibWeb/Layout/Node.h>
 #include <LibWeb/Loader/ImageLoader.h>
 #include <LibWeb/Loader/ResourceLoader.h>
 #include <LibWeb/Platform/Timer.h>
@@ -35,6 +36,7 @@ void ImageLoader::load(const AK::URL& url)
 void ImageLoader::load_without_resetting_redirect_counter(AK::URL const& url)
 {
     m_loading_state = LoadingState::Loading;
+    m_waiting_for_decode = false;
 
     auto request = LoadRequest::create_for_url_on_page(url, m_owner_element.document().page());
     set_resource(ResourceLoader::the().load_resource(Resource::Type::Image, request));
@@ -83,8 +85,6 @@ void ImageLoader::resource_did_load()
         return;
     }
 
-    m_loading_state = LoadingState::Loaded;
-
     if constexpr (IMAGE_LOADER_DEBUG) {
         if (!resource()->has_encoded_data()) {
             dbgln("ImageLoader: Resource did load, no encoded data. URL: {}", resource()->url());
@@ -93,6 +93,35 @@ void ImageLoader::resource_did_load()
         }
     }
 
+    // NOTE: We stay in the loading state until the image has been decoded, so we don't render as alt text in the meantime.
+    if (resource()->has_encoded_data() && !resource()->has_attempted_decode()) {
+        m_waiting_for_decode = true;
+        resource()->start_decoding_if_needed();
+        return;
+    }
+
+    did_finish_loading();
+}
+
+void ImageLoader::resource_did_decode()
+{
+    if (m_waiting_for_decode) {
+        m_waiting_for_decode = false;
+        did_finish_loading();
+        return;
+    }
+    if (m_loading_state != LoadingState::Loaded)
+        return;
+
+    // The image had to be decoded again, so paint it now that its bitmaps are back.
+    if (auto* layout_node = m_owner_element.layout_node())
+        layout_node->set_needs_display();
+}
+
+void ImageLoader::did_finish_loading()
+{
+    m_loading_state = LoadingState::Loaded;
+
     if (resource()->is_animated() && resource()->frame_count() > 1) {
         m_timer->set_interval(resource()->frame_duration(0));
         m_timer->on_timeout = [this] { animate(); };
@@ -138,21 +167,25 @@ bool ImageLoader::has_image() const
 {
     if (!resource())
         return false;
-    return bitmap(0);
+    return resource()->natural_size().has_value();
 }
 
 unsigned ImageLoader::width() const
 {
     if (!resource())
         return 0;
-    return bitmap(0) ? bitmap(0)->width() : 0;
+    if (auto size = resource()->natural_size(); size.has_value())
+        return size->width();
+    return 0;
 }
 
 unsigned ImageLoader::height() const
 {
     if (!resource())
         return 0;
-    return bitmap(0) ? bitmap(0)->height() : 0;
+    if (auto size = resource()->natural_size(); size.has_value())
+        return size->height();
+    return 0;
 }
 
 Gfx::Bitmap const* ImageLoader::bitmap(size_t frame_index) const
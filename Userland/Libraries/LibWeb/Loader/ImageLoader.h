@@ -42,8 +42,10 @@ private:
     // ^ImageResourceClient
     virtual void resource_did_load() override;
     virtual void resource_did_fail() override;
+    virtual void resource_did_decode() override;
     virtual bool is_visible_in_viewport() const override { return m_visible_in_viewport; }
 
+    void did_finish_loading();
     void animate();
 
     enum class LoadingState {
@@ -60,6 +62,7 @@ private:
     size_t m_current_frame_index { 0 };
     size_t m_loops_completed { 0 };
     LoadingState m_loading_state { LoadingState::Loading };
+    bool m_waiting_for_decode { false };
     NonnullRefPtr<Platform::Timer> m_timer;
     size_t m_redirects_count { 0 };
 };
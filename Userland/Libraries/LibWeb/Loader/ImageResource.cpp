@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Debug.h>
 #include <AK/Function.h>
 #include <LibGfx/Bitmap.h>
 #include <LibWeb/Loader/ImageResource.h>
@@ -11,6 +12,19 @@
 
 namespace Web {
 
+// We try to keep the decoded bitmaps of all images below this size, by discarding those of images that aren't visible.
+// They are decoded again from the encoded data when they're needed.
+static constexpr size_t decoded_bitmaps_memory_budget = 256 * MiB;
+
+static size_t s_decoded_bitmaps_size_in_bytes = 0;
+
+// The image resources that have decoded bitmaps, from the least to the most recently used one.
+static ImageResource::DecodedBitmapsList& resources_with_decoded_bitmaps()
+{
+    static ImageResource::DecodedBitmapsList list;
+    return list;
+}
+
 NonnullRefPtr<ImageResource> ImageResource::convert_from_resource(Resource& resource)
 {
     return adopt_ref(*new ImageResource(resource));
@@ -26,62 +40,128 @@ ImageResource::ImageResource(Resource& resource)
 {
 }
 
-ImageResource::~ImageResource() = default;
+ImageResource::~ImageResource()
+{
+    discard_decoded_bitmaps();
+}
 
 int ImageResource::frame_duration(size_t frame_index) const
 {
-    decode_if_needed();
     if (frame_index >= m_decoded_frames.size())
         return 0;
     return m_decoded_frames[frame_index].duration;
 }
 
-void ImageResource::decode_if_needed() const
+void ImageResource::start_decoding_if_needed() const
 {
-    if (!has_encoded_data())
+    if (!has_encoded_data() || m_is_decoding)
         return;
 
-    if (m_has_attempted_decode)
+    if (m_has_attempted_decode && !m_has_discarded_decoded_bitmaps)
         return;
 
-    if (!m_decoded_frames.is_empty())
-        return;
+    m_is_decoding = true;
+    // NOTE: We keep ourselves alive until the image is decoded, even if all our clients go away in the meantime.
+    Platform::ImageCodecPlugin::the().decode_image_async(encoded_data(), [self = NonnullRefPtr { *this }](auto image) {
+        self->did_decode(move(image));
+    });
+}
 
-    auto image = Platform::ImageCodecPlugin::the().decode_image(encoded_data());
+void ImageResource::did_decode(Optional<Platform::DecodedImage> image) const
+{
+    m_is_decoding = false;
     m_has_attempted_decode = true;
+    m_has_discarded_decoded_bitmaps = false;
+
+    if (image.has_value()) {
+        m_loop_count = image.value().loop_count;
+        m_animated = image.value().is_animated;
+        m_decoded_frames.resize(image.value().frames.size());
+        for (size_t i = 0; i < m_decoded_frames.size(); ++i) {
+            auto& frame = m_decoded_frames[i];
+            frame.bitmap = image.value().frames[i].bitmap;
+            frame.duration = image.value().frames[i].duration;
+            if (frame.bitmap)
+                m_decoded_bitmaps_size_in_bytes += frame.bitmap->size_in_bytes();
+        }
 
-    if (!image.has_value()) {
+        if (!m_decoded_frames.is_empty() && m_decoded_frames.first().bitmap)
+            m_natural_size = m_decoded_frames.first().bitmap->size();
+
+        s_decoded_bitmaps_size_in_bytes += m_decoded_bitmaps_size_in_bytes;
+        did_use_decoded_bitmaps();
+        discard_decoded_bitmaps_over_budget(*this);
+    } else {
         dbgln("Could not decode image resource {}", url());
-        return;
+        m_decoded_frames.clear();
+        m_natural_size = {};
     }
 
-    m_loop_count = image.value().loop_count;
-    m_animated = image.value().is_animated;
-    m_decoded_frames.resize(image.value().frames.size());
-    for (size_t i = 0; i < m_decoded_frames.size(); ++i) {
-        auto& frame = m_decoded_frames[i];
-        frame.bitmap = image.value().frames[i].bitmap;
-        frame.duration = image.value().frames[i].duration;
+    const_cast<ImageResource&>(*this).for_each_client([](auto& client) {
+        static_cast<ImageResourceClient&>(client).resource_did_decode();
+    });
+}
+
+void ImageResource::did_use_decoded_bitmaps() const
+{
+    auto& list = resources_with_decoded_bitmaps();
+    auto& resource = const_cast<ImageResource&>(*this);
+    if (m_decoded_bitmaps_list_node.is_in_list())
+        list.remove(resource);
+    list.append(resource);
+}
+
+void ImageResource::discard_decoded_bitmaps() const
+{
+    if (!m_decoded_bitmaps_list_node.is_in_list())
+        return;
+    resources_with_decoded_bitmaps().remove(const_cast<ImageResource&>(*this));
+
+    s_decoded_bitmaps_size_in_bytes -= m_decoded_bitmaps_size_in_bytes;
+    m_decoded_bitmaps_size_in_bytes = 0;
+
+    // NOTE: We keep the frames themselves around, so we still know how many there are and how long they last.
+    for (auto& frame : m_decoded_frames)
+        frame.bitmap = nullptr;
+    m_has_discarded_decoded_bitmaps = true;
+}
+
+void ImageResource::discard_decoded_bitmaps_over_budget(ImageResource const& resource_to_keep)
+{
+    auto& list = resources_with_decoded_bitmaps();
+    for (auto it = list.begin(); it != list.end() && s_decoded_bitmaps_size_in_bytes > decoded_bitmaps_memory_budget;) {
+        auto& resource = *it;
+        ++it;
+        if (&resource == &resource_to_keep || resource.is_visible_in_viewport())
+            continue;
+        dbgln_if(IMAGE_LOADER_DEBUG, "ImageResource: Discarding {} bytes of decoded bitmaps for {}", resource.m_decoded_bitmaps_size_in_bytes, resource.url());
+        resource.discard_decoded_bitmaps();
     }
 }
 
 Gfx::Bitmap const* ImageResource::bitmap(size_t frame_index) const
 {
-    decode_if_needed();
-    if (frame_index >= m_decoded_frames.size())
+    start_decoding_if_needed();
+    if (m_is_decoding || frame_index >= m_decoded_frames.size())
         return nullptr;
+    if (m_decoded_bitmaps_list_node.is_in_list())
+        did_use_decoded_bitmaps();
     return m_decoded_frames[frame_index].bitmap;
 }
 
-void ImageResource::update_volatility()
+bool ImageResource::is_visible_in_viewport() const
 {
     bool visible_in_viewport = false;
-    for_each_client([&](auto& client) {
+    const_cast<ImageResource&>(*this).for_each_client([&](auto& client) {
         if (static_cast<const ImageResourceClient&>(client).is_visible_in_viewport())
             visible_in_viewport = true;
     });
+    return visible_in_viewport;
+}
 
-    if (!visible_in_viewport) {
+void ImageResource::update_volatility()
+{
+    if (!is_visible_in_viewport()) {
         for (auto& frame : m_decoded_frames) {
             if (frame.bitmap)
                 frame.bitmap->set_volatile();
@@ -103,8 +183,7 @@ void ImageResource::update_volatility()
     if (still_has_decoded_image)
         return;
 
-    m_decoded_frames.clear();
-    m_has_attempted_decode = false;
+    discard_decoded_bitmaps();
 }
 
 ImageResourceClient::~ImageResourceClient() = default;
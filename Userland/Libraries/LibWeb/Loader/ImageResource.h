@@ -6,7 +6,10 @@
 
 #pragma once
 
+#include <AK/IntrusiveList.h>
+#include <LibGfx/Size.h>
 #include <LibWeb/Loader/Resource.h>
+#include <LibWeb/Platform/ImageCodecPlugin.h>
 
 namespace Web {
 
@@ -23,23 +26,19 @@ public:
         size_t duration { 0 };
     };
 
+    // NOTE: This is null while the image is being decoded, after which the clients get a resource_did_decode() call.
     Gfx::Bitmap const* bitmap(size_t frame_index = 0) const;
+
+    // Images are decoded in the background. Until that's done for the first time, the image has no frames or natural size.
+    bool has_attempted_decode() const { return m_has_attempted_decode; }
+    void start_decoding_if_needed() const;
+
+    // The size of the first frame, which (like the frame count and durations) stays around when the decoded bitmaps are discarded.
+    Optional<Gfx::IntSize> natural_size() const { return m_natural_size; }
     int frame_duration(size_t frame_index) const;
-    size_t frame_count() const
-    {
-        decode_if_needed();
-        return m_decoded_frames.size();
-    }
-    bool is_animated() const
-    {
-        decode_if_needed();
-        return m_animated;
-    }
-    size_t loop_count() const
-    {
-        decode_if_needed();
-        return m_loop_count;
-    }
+    size_t frame_count() const { return m_decoded_frames.size(); }
+    bool is_animated() const { return m_animated; }
+    size_t loop_count() const { return m_loop_count; }
 
     void update_volatility();
 
@@ -47,12 +46,26 @@ private:
     explicit ImageResource(LoadRequest const&);
     explicit ImageResource(Resource&);
 
-    void decode_if_needed() const;
+    void did_decode(Optional<Platform::DecodedImage>) const;
+    void did_use_decoded_bitmaps() const;
+    void discard_decoded_bitmaps() const;
+    bool is_visible_in_viewport() const;
+
+    static void discard_decoded_bitmaps_over_budget(ImageResource const& resource_to_keep);
 
     mutable bool m_animated { false };
     mutable int m_loop_count { 0 };
     mutable Vector<Frame> m_decoded_frames;
     mutable bool m_has_attempted_decode { false };
+    mutable bool m_is_decoding { false };
+    mutable bool m_has_discarded_decoded_bitmaps { false };
+    mutable Optional<Gfx::IntSize> m_natural_size;
+
+    mutable size_t m_decoded_bitmaps_size_in_bytes { 0 };
+    mutable IntrusiveListNode<ImageResource> m_decoded_bitmaps_list_node;
+
+public:
+    using DecodedBitmapsList = IntrusiveList<&ImageResource::m_decoded_bitmaps_list_node>;
 };
 
 class ImageResourceClient : public ResourceClient {
@@ -61,6 +74,9 @@ public:
 
     virtual bool is_visible_in_viewport() const { return false; }
 
+    // Called whenever the resource finished decoding the image, including when it had to decode it again.
+    virtual void resource_did_decode() { }
+
 protected:
     ImageResource* resource() { return static_cast<ImageResource*>(ResourceClient::resource()); }
     ImageResource const* resource() const { return static_cast<ImageResource const*>(ResourceClient::resource()); }
@@ -29,6 +29,17 @@ ResourceLoaderConnectorRequest::ResourceLoaderConnectorRequest() = default;
 
 ResourceLoaderConnectorRequest::~ResourceLoaderConnectorRequest() = default;
 
+void ResourceLoaderConnectorRequest::set_unbuffered_request_callbacks(HeadersReceived on_headers_received, DataReceived on_data_received, RequestFinished on_finish)
+{
+    on_buffered_request_finish = [on_headers_received = move(on_headers_received), on_data_received = move(on_data_received), on_finish = move(on_finish)](bool success, u32 total_size, auto const& response_headers, auto response_code, ReadonlyBytes payload) {
+        on_headers_received(response_headers, response_code);
+        if (!payload.is_empty())
+            on_data_received(payload);
+        on_finish(success, total_size);
+    };
+    set_should_buffer_all_input(true);
+}
+
 ResourceLoaderConnector::ResourceLoaderConnector() = default;
 
 ResourceLoaderConnector::~ResourceLoaderConnector() = default;
@@ -281,17 +292,7 @@ void ResourceLoader::load(LoadRequest& request, Function<void(ReadonlyBytes, Has
     }
 
     if (url.scheme() == "http" || url.scheme() == "https" || url.scheme() == "gemini") {
-        auto proxy = ProxyMappings::the().proxy_for_url(url);
-
-        HashMap<DeprecatedString, DeprecatedString> headers;
-        headers.set("User-Agent", m_user_agent);
-        headers.set("Accept-Encoding", "gzip, deflate, br");
-
-        for (auto& it : request.headers()) {
-            headers.set(it.key, it.value);
-        }
-
-        auto protocol_request = m_connector->start_request(request.method(), url, headers, request.body(), proxy);
+        auto protocol_request = start_network_request(request);
         if (!protocol_request) {
             auto start_request_failure_msg = "Failed to initiate load"sv;
             log_failure(request, start_request_failure_msg);
@@ -355,6 +356,81 @@ void ResourceLoader::load(LoadRequest& request, Function<void(ReadonlyBytes, Has
         error_callback(not_implemented_error, {});
 }
 
+void ResourceLoader::load_unbuffered(LoadRequest& request, OnHeadersReceived on_headers_received, OnDataReceived on_data_received, OnComplete on_complete)
+{
+    auto& url = request.url();
+    request.start_timer();
+
+    auto url_for_logging = sanitized_url_for_logging(url);
+    dbgln("ResourceLoader: Starting unbuffered load of: \"{}\"", url_for_logging);
+
+    auto const fail = [&](StringView error_message) {
+        dbgln("ResourceLoader: Failed load of: \"{}\", \033[31;1mError: {}\033[0m", url_for_logging, error_message);
+        on_complete(false, error_message);
+    };
+
+    if (is_port_blocked(url.port_or_default()))
+        return fail("The port is blocked"sv);
+    if (ContentFilter::the().is_filtered(url))
+        return fail("URL was filtered"sv);
+    if (!url.scheme().is_one_of("http"sv, "https"sv, "gemini"sv))
+        return fail("Only network loads can be unbuffered"sv);
+
+    auto protocol_request = start_network_request(request);
+    if (!protocol_request)
+        return fail("Failed to initiate load"sv);
+    m_active_requests.set(*protocol_request);
+
+    auto protocol_headers_received = [request, on_headers_received = move(on_headers_received)](auto const& response_headers, auto status_code) mutable {
+        if (request.page().has_value()) {
+            if (auto set_cookie = response_headers.get("Set-Cookie"); set_cookie.has_value())
+                store_response_cookies(request.page().value(), request.url(), *set_cookie);
+        }
+        on_headers_received(response_headers, status_code);
+    };
+
+    auto protocol_finished = [this, request, url_for_logging, on_complete = move(on_complete), &protocol_request = *protocol_request](bool success, u32) {
+        --m_pending_loads;
+        if (on_load_counter_change)
+            on_load_counter_change();
+
+        auto load_time_ms = request.load_time().to_milliseconds();
+        if (success) {
+            dbgln("ResourceLoader: Finished load of: \"{}\", Duration: {}ms", url_for_logging, load_time_ms);
+            on_complete(true, {});
+        } else {
+            dbgln("ResourceLoader: Failed load of: \"{}\", \033[31;1mError: Load failed\033[0m, Duration: {}ms", url_for_logging, load_time_ms);
+            on_complete(false, "Load failed"sv);
+        }
+        Platform::EventLoopPlugin::the().deferred_invoke([this, &protocol_request] {
+            m_active_requests.remove(protocol_request);
+        });
+    };
+
+    protocol_request->set_unbuffered_request_callbacks(move(protocol_headers_received), move(on_data_received), move(protocol_finished));
+    protocol_request->on_certificate_requested = []() -> ResourceLoaderConnectorRequest::CertificateAndKey {
+        return {};
+    };
+    ++m_pending_loads;
+    if (on_load_counter_change)
+        on_load_counter_change();
+}
+
+RefPtr<ResourceLoaderConnectorRequest> ResourceLoader::start_network_request(LoadRequest const& request)
+{
+    auto proxy = ProxyMappings::the().proxy_for_url(request.url());
+
+    HashMap<DeprecatedString, DeprecatedString> headers;
+    headers.set("User-Agent", m_user_agent);
+    headers.set("Accept-Encoding", "gzip, deflate, br");
+
+    for (auto& it : request.headers()) {
+        headers.set(it.key, it.value);
+    }
+
+    return m_connector->start_request(request.method(), request.url(), headers, request.body(), proxy);
+}
+
 void ResourceLoader::load(const AK::URL& url, Function<void(ReadonlyBytes, HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& response_headers, Optional<u32> status_code)> success_callback, Function<void(DeprecatedString const&, Optional<u32> status_code)> error_callback, Optional<u32> timeout, Function<void()> timeout_callback)
 {
     LoadRequest request;
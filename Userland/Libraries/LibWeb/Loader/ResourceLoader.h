@@ -63,6 +63,13 @@ public:
 
     virtual void stream_into(Stream&) = 0;
 
+    using HeadersReceived = Function<void(HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& response_headers, Optional<u32> response_code)>;
+    using DataReceived = Function<void(ReadonlyBytes data)>;
+    using RequestFinished = Function<void(bool success, u32 total_size)>;
+
+    // Hands over the body piece by piece as it arrives. Connectors that can't do that hand over all of it at the end, as one piece.
+    virtual void set_unbuffered_request_callbacks(HeadersReceived, DataReceived, RequestFinished);
+
     Function<void(bool success, u32 total_size, HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& response_headers, Optional<u32> response_code, ReadonlyBytes payload)> on_buffered_request_finish;
     Function<void(bool success, u32 total_size)> on_finish;
     Function<void(Optional<u32> total_size, u32 downloaded_size)> on_progress;
@@ -96,6 +103,14 @@ public:
     void load(LoadRequest&, Function<void(ReadonlyBytes, HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& response_headers, Optional<u32> status_code)> success_callback, Function<void(DeprecatedString const&, Optional<u32> status_code)> error_callback = nullptr, Optional<u32> timeout = {}, Function<void()> timeout_callback = nullptr);
     void load(const AK::URL&, Function<void(ReadonlyBytes, HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& response_headers, Optional<u32> status_code)> success_callback, Function<void(DeprecatedString const&, Optional<u32> status_code)> error_callback = nullptr, Optional<u32> timeout = {}, Function<void()> timeout_callback = nullptr);
 
+    using OnHeadersReceived = Function<void(HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const& response_headers, Optional<u32> status_code)>;
+    using OnDataReceived = Function<void(ReadonlyBytes data)>;
+    using OnComplete = Function<void(bool success, Optional<StringView> error_message)>;
+
+    // Like load(), but the body is handed over as it arrives, so that it never has to be in memory all at once.
+    // Only for network loads; Everything else is local, and just as well loaded with load().
+    void load_unbuffered(LoadRequest&, OnHeadersReceived, OnDataReceived, OnComplete);
+
     ResourceLoaderConnector& connector() { return *m_connector; }
 
     void prefetch_dns(AK::URL const&);
@@ -117,6 +132,8 @@ private:
 
     static bool is_port_blocked(int port);
 
+    RefPtr<ResourceLoaderConnectorRequest> start_network_request(LoadRequest const&);
+
     int m_pending_loads { 0 };
 
     HashTable<NonnullRefPtr<ResourceLoaderConnectorRequest>> m_active_requests;
@@ -129,6 +129,7 @@ void paint_background(PaintContext& context, Layout::NodeWithStyleAndBoxModelMet
         switch (layer.attachment) {
         case CSS::BackgroundAttachment::Fixed:
             background_positioning_area = layout_node.root().browsing_context().viewport_rect();
+            context.set_did_paint_viewport_relative_content();
             break;
         case CSS::BackgroundAttachment::Local:
         case CSS::BackgroundAttachment::Scroll:
@@ -38,6 +38,15 @@ public:
     bool has_focus() const { return m_focus; }
     void set_has_focus(bool focus) { m_focus = focus; }
 
+    // Whether anything was painted in a place that depends on the scroll position, so it doesn't move along on scroll.
+    bool did_paint_viewport_relative_content() const { return m_did_paint_viewport_relative_content; }
+    void set_did_paint_viewport_relative_content()
+    {
+        m_did_paint_viewport_relative_content = true;
+        if (m_original_context_flag)
+            *m_original_context_flag = true;
+    }
+
     DevicePixels enclosing_device_pixels(CSSPixels css_pixels) const;
     DevicePixels floored_device_pixels(CSSPixels css_pixels) const;
     DevicePixels rounded_device_pixels(CSSPixels css_pixels) const;
@@ -56,6 +65,7 @@ public:
         clone.m_should_show_line_box_borders = m_should_show_line_box_borders;
         clone.m_focus = m_focus;
         clone.m_svg_context = m_svg_context;
+        clone.m_original_context_flag = m_original_context_flag ? m_original_context_flag : &m_did_paint_viewport_relative_content;
         return clone;
     }
 
@@ -67,6 +77,8 @@ private:
     DevicePixelRect m_device_viewport_rect;
     bool m_should_show_line_box_borders { false };
     bool m_focus { false };
+    mutable bool m_did_paint_viewport_relative_content { false };
+    bool* m_original_context_flag { nullptr };
 };
 
 }
@@ -159,12 +159,15 @@ void PaintableBox::paint(PaintContext& context, PaintPhase phase) const
             auto border_box = absolute_border_box_rect();
             context.painter().add_clip_rect(context.rounded_device_rect(clip_rect.to_rect().resolved(Paintable::layout_node(), border_box.to_type<float>()).to_type<CSSPixels>()).to_type<int>());
         }
-        paint_backdrop_filter(context);
-        paint_background(context);
-        paint_box_shadow(context);
+        // NOTE: Most of a long document is outside of what we're repainting, so don't bother rasterizing it.
+        if (!is_out_of_view(context)) {
+            paint_backdrop_filter(context);
+            paint_background(context);
+            paint_box_shadow(context);
+        }
     }
 
-    if (phase == PaintPhase::Border) {
+    if (phase == PaintPhase::Border && !is_out_of_view(context)) {
         paint_border(context);
     }
 
@@ -504,6 +507,11 @@ static void paint_text_fragment(PaintContext& context, Layout::TextNode const& t
         auto fragment_absolute_rect = fragment.absolute_rect();
         auto fragment_absolute_device_rect = context.enclosing_device_rect(fragment_absolute_rect);
 
+        // NOTE: Glyphs (and the text decoration) may stick out of the fragment a bit, so leave some room for that.
+        auto overhang = fragment_absolute_device_rect.height().value();
+        if (!fragment_absolute_device_rect.to_type<int>().inflated(overhang * 2, overhang * 2).translated(painter.translation()).intersects(painter.clip_rect()))
+            return;
+
         if (text_node.document().inspected_node() == &text_node.dom_node())
             context.painter().draw_rect(fragment_absolute_device_rect.to_type<int>(), Color::Magenta);
 
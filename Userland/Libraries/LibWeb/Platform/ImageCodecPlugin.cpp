@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibGfx/Bitmap.h>
 #include <LibWeb/Platform/ImageCodecPlugin.h>
 
 namespace Web::Platform {
@@ -25,4 +26,10 @@ void ImageCodecPlugin::install(ImageCodecPlugin& plugin)
     s_the = &plugin;
 }
 
+void ImageCodecPlugin::decode_image_async(ReadonlyBytes bytes, Function<void(Optional<DecodedImage>)> on_decoded)
+{
+    // NOTE: Platforms that can't decode in the background just decode the image right away.
+    on_decoded(decode_image(bytes));
+}
+
 }
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <AK/RefPtr.h>
 #include <AK/Vector.h>
 #include <LibGfx/Forward.h>
@@ -32,6 +33,10 @@ public:
     virtual ~ImageCodecPlugin();
 
     virtual Optional<DecodedImage> decode_image(ReadonlyBytes) = 0;
+
+    // Decodes the image without blocking the event loop where the platform can, and calls the callback once that's done.
+    // NOTE: The data only has to stay alive until this returns.
+    virtual void decode_image_async(ReadonlyBytes, Function<void(Optional<DecodedImage>)> on_decoded);
 };
 
 }
@@ -68,6 +68,8 @@ void OutOfProcessWebView::create_client()
             handle_web_content_process_crash();
         });
     };
+    // If the server doesn't want it, messages keep going through the socket.
+    (void)client().request_shared_ring_transport();
 
     client().async_update_system_theme(Gfx::current_system_theme_buffer());
     client().async_update_system_fonts(Gfx::FontDatabase::default_font_query(), Gfx::FontDatabase::fixed_width_font_query(), Gfx::FontDatabase::window_title_font_query());
@@ -4,12 +4,71 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibCore/Notifier.h>
+#include <LibCore/System.h>
 #include <LibProtocol/Request.h>
 #include <LibProtocol/RequestClient.h>
 #include <LibWebView/RequestServerAdapter.h>
+#include <sys/socket.h>
 
 namespace WebView {
 
+// Larger bodies (file uploads, mostly) are handed to RequestServer a piece at a time through a socket, so that it can
+// start sending them right away, rather than only once it got all of it in one huge message.
+static constexpr size_t streamed_request_body_threshold = 64 * KiB;
+
+class RequestBodyWriter : public RefCounted<RequestBodyWriter> {
+public:
+    static ErrorOr<NonnullRefPtr<RequestBodyWriter>> create(int fd, ReadonlyBytes body)
+    {
+        auto writer = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) RequestBodyWriter(fd, TRY(ByteBuffer::copy(body)))));
+        writer->m_notifier = Core::Notifier::construct(fd, Core::Notifier::Write);
+        writer->m_notifier->on_ready_to_write = [writer = writer.ptr()] { writer->write_more(); };
+        return writer;
+    }
+
+    ~RequestBodyWriter() { close(); }
+
+private:
+    RequestBodyWriter(int fd, ByteBuffer body)
+        : m_fd(fd)
+        , m_body(move(body))
+    {
+    }
+
+    void write_more()
+    {
+        auto remaining = m_body.bytes().slice(m_offset);
+        // RequestServer may have stopped reading because the server responded early, which mustn't take us down with SIGPIPE.
+        auto result = Core::System::send(m_fd, remaining.data(), remaining.size(), MSG_NOSIGNAL);
+        if (result.is_error()) {
+            if (result.error().code() == EAGAIN || result.error().code() == EINTR)
+                return;
+            dbgln("RequestBodyWriter: Could not write the request body: {}", result.error());
+            return close();
+        }
+        m_offset += result.value();
+        if (m_offset == m_body.size())
+            close();
+    }
+
+    void close()
+    {
+        if (m_notifier) {
+            m_notifier->set_enabled(false);
+            m_notifier = nullptr;
+        }
+        if (m_fd >= 0)
+            (void)Core::System::close(exchange(m_fd, -1));
+        m_body.clear();
+    }
+
+    int m_fd { -1 };
+    ByteBuffer m_body;
+    size_t m_offset { 0 };
+    RefPtr<Core::Notifier> m_notifier;
+};
+
 ErrorOr<NonnullRefPtr<RequestServerRequestAdapter>> RequestServerRequestAdapter::try_create(NonnullRefPtr<Protocol::Request> request)
 {
     return adopt_nonnull_ref_or_enomem(new (nothrow) RequestServerRequestAdapter(move(request)));
@@ -68,6 +127,11 @@ void RequestServerRequestAdapter::stream_into(Stream& stream)
     m_request->stream_into(stream);
 }
 
+void RequestServerRequestAdapter::set_unbuffered_request_callbacks(HeadersReceived on_headers_received, DataReceived on_data_received, RequestFinished on_finish)
+{
+    m_request->set_unbuffered_request_callbacks(move(on_headers_received), move(on_data_received), move(on_finish));
+}
+
 ErrorOr<NonnullRefPtr<RequestServerAdapter>> RequestServerAdapter::try_create()
 {
     auto protocol_client = TRY(Protocol::RequestClient::try_create());
@@ -83,12 +147,48 @@ RequestServerAdapter::~RequestServerAdapter() = default;
 
 RefPtr<Web::ResourceLoaderConnectorRequest> RequestServerAdapter::start_request(DeprecatedString const& method, URL const& url, HashMap<DeprecatedString, DeprecatedString> const& headers, ReadonlyBytes body, Core::ProxyData const& proxy)
 {
+    if (body.size() > streamed_request_body_threshold) {
+        auto adapter_or_error = start_request_with_body_stream(method, url, headers, body, proxy);
+        if (!adapter_or_error.is_error())
+            return adapter_or_error.release_value();
+        dbgln("RequestServerAdapter: Could not stream the request body, sending it all at once: {}", adapter_or_error.error());
+    }
+
     auto protocol_request = m_protocol_client->start_request(method, url, headers, body, proxy);
     if (!protocol_request)
         return {};
     return RequestServerRequestAdapter::try_create(protocol_request.release_nonnull()).release_value_but_fixme_should_propagate_errors();
 }
 
+ErrorOr<RefPtr<Web::ResourceLoaderConnectorRequest>> RequestServerAdapter::start_request_with_body_stream(DeprecatedString const& method, URL const& url, HashMap<DeprecatedString, DeprecatedString> const& headers, ReadonlyBytes body, Core::ProxyData const& proxy)
+{
+    int fds[2];
+    TRY(Core::System::socketpair(AF_LOCAL, SOCK_STREAM | SOCK_CLOEXEC, 0, fds));
+    auto flags_or_error = Core::System::fcntl(fds[1], F_GETFL);
+    if (!flags_or_error.is_error())
+        flags_or_error = Core::System::fcntl(fds[1], F_SETFL, flags_or_error.value() | O_NONBLOCK);
+    if (flags_or_error.is_error()) {
+        (void)Core::System::close(fds[0]);
+        (void)Core::System::close(fds[1]);
+        return flags_or_error.release_error();
+    }
+
+    auto writer_or_error = RequestBodyWriter::create(fds[1], body);
+    if (writer_or_error.is_error()) {
+        (void)Core::System::close(fds[0]);
+        (void)Core::System::close(fds[1]);
+        return writer_or_error.release_error();
+    }
+
+    // The request takes the other end along, and the writer closes its own when it's done, which is where the body ends.
+    auto protocol_request = m_protocol_client->start_request_with_body_stream(method, url, headers, fds[0], HTTP::HttpRequest::BodyEncoding::Identity, proxy);
+    if (!protocol_request)
+        return nullptr;
+    auto adapter = TRY(RequestServerRequestAdapter::try_create(protocol_request.release_nonnull()));
+    adapter->set_request_body_writer(writer_or_error.release_value());
+    return adapter;
+}
+
 void RequestServerAdapter::prefetch_dns(AK::URL const& url)
 {
     m_protocol_client->ensure_connection(url, RequestServer::CacheLevel::ResolveOnly);
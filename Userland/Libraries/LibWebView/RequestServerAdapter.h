@@ -17,6 +17,8 @@ class RequestClient;
 
 namespace WebView {
 
+class RequestBodyWriter;
+
 class RequestServerRequestAdapter
     : public Web::ResourceLoaderConnectorRequest
     , public Weakable<RequestServerRequestAdapter> {
@@ -28,10 +30,14 @@ public:
     virtual bool stop() override;
 
     virtual void stream_into(Stream&) override;
+    virtual void set_unbuffered_request_callbacks(HeadersReceived, DataReceived, RequestFinished) override;
+
+    void set_request_body_writer(NonnullRefPtr<RequestBodyWriter> writer) { m_request_body_writer = move(writer); }
 
 private:
     RequestServerRequestAdapter(NonnullRefPtr<Protocol::Request>);
     NonnullRefPtr<Protocol::Request> m_request;
+    RefPtr<RequestBodyWriter> m_request_body_writer;
 };
 
 class RequestServerAdapter : public Web::ResourceLoaderConnector {
@@ -47,6 +53,8 @@ public:
 private:
     RequestServerAdapter(NonnullRefPtr<Protocol::RequestClient> protocol_client);
 
+    ErrorOr<RefPtr<Web::ResourceLoaderConnectorRequest>> start_request_with_body_stream(DeprecatedString const& method, URL const&, HashMap<DeprecatedString, DeprecatedString> const& request_headers, ReadonlyBytes request_body, Core::ProxyData const&);
+
     RefPtr<Protocol::RequestClient> m_protocol_client;
 };
 
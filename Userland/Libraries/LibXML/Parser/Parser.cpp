@@ -80,6 +80,10 @@ void Parser::append_node(NonnullOwnPtr<Node> node)
 
 void Parser::append_text(StringView text)
 {
+    // The content of an element is parsed as character data between everything else, which is usually nothing at all.
+    if (text.is_empty())
+        return;
+
     if (m_listener) {
         m_listener->text(text);
         return;
@@ -152,7 +156,12 @@ void Parser::leave_node()
         m_listener->element_end(element.name);
     }
 
-    m_entered_node = m_entered_node->parent;
+    auto* parent = m_entered_node->parent;
+    // The listener builds its own tree, so an element isn't needed anymore once it's been left, and only the elements
+    // that are still open are kept. Since text and comments are passed on right away, it's always the last child.
+    if (m_listener && parent)
+        (void)parent->content.get<Node::Element>().children.take_last();
+    m_entered_node = parent;
 }
 
 ErrorOr<Document, ParseError> Parser::parse()
@@ -542,12 +551,18 @@ ErrorOr<Name, ParseError> Parser::parse_name()
     auto accept = accept_rule();
 
     auto rest = m_lexer.consume_while(s_name_characters);
-    StringBuilder builder;
-    builder.append(start);
-    builder.append(rest);
+    StringView name { start.characters_without_null_termination(), start.length() + rest.length() };
 
     rollback.disarm();
-    return builder.to_deprecated_string();
+
+    // Documents use the same few names over and over, so each one is only allocated once and then shared.
+    auto it = m_interned_names.find(name.hash(), [&](auto& interned_name) { return interned_name == name; });
+    if (it != m_interned_names.end())
+        return *it;
+
+    Name interned_name = name;
+    m_interned_names.set(interned_name);
+    return interned_name;
 }
 
 // 2.8.28. doctypedecl, https://www.w3.org/TR/2006/REC-xml11-20060816/#NT-doctypedecl
@@ -611,7 +626,10 @@ ErrorOr<void, ParseError> Parser::parse_element()
     // element ::= EmptyElemTag
     //           | STag content ETag
     if (auto result = parse_empty_element_tag(); !result.is_error()) {
+        auto& node = *result.value();
         append_node(result.release_value());
+        enter_node(node);
+        leave_node();
         rollback.disarm();
         return {};
     }
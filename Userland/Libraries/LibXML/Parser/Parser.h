@@ -11,6 +11,7 @@
 #include <AK/Function.h>
 #include <AK/GenericLexer.h>
 #include <AK/HashMap.h>
+#include <AK/HashTable.h>
 #include <AK/OwnPtr.h>
 #include <AK/SourceLocation.h>
 #include <AK/TemporaryChange.h>
@@ -203,6 +204,7 @@ private:
     DeprecatedString m_encoding;
     bool m_standalone { false };
     HashMap<Name, DeprecatedString> m_processing_instructions;
+    HashTable<Name> m_interned_names;
     struct AcceptedRule {
         Optional<DeprecatedString> rule {};
         bool accept { false };
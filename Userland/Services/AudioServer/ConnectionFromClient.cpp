@@ -27,6 +27,8 @@ ConnectionFromClient::ConnectionFromClient(NonnullOwnPtr<Core::LocalSocket> clie
     , m_mixer(mixer)
 {
     s_connections.set(client_id, *this);
+    // Clients that stream audio send playback control messages with every buffer they enqueue.
+    set_accepts_shared_ring_transport(true);
 }
 
 void ConnectionFromClient::die()
@@ -40,8 +42,10 @@ void ConnectionFromClient::set_buffer(Audio::AudioQueue const& buffer)
         did_misbehave("Received an invalid buffer");
         return;
     }
-    if (!m_queue)
+    if (!m_queue) {
         m_queue = m_mixer.create_queue(*this);
+        m_queue->set_requested_buffer_size(m_requested_buffer_size);
+    }
 
     // This is ugly but we know nobody uses the buffer afterwards anyways.
     m_queue->set_buffer(make<Audio::AudioQueue>(move(const_cast<Audio::AudioQueue&>(buffer))));
@@ -82,6 +86,19 @@ void ConnectionFromClient::set_sample_rate(u32 sample_rate)
     m_mixer.audiodevice_set_sample_rate(sample_rate);
 }
 
+Messages::AudioServer::RequestBufferSizeResponse ConnectionFromClient::request_buffer_size(u32 buffer_size)
+{
+    m_requested_buffer_size = Mixer::clamp_buffer_size(buffer_size);
+    if (m_queue)
+        m_queue->set_requested_buffer_size(m_requested_buffer_size);
+    return m_requested_buffer_size;
+}
+
+Messages::AudioServer::GetBufferSizeResponse ConnectionFromClient::get_buffer_size()
+{
+    return m_mixer.buffer_size();
+}
+
 Messages::AudioServer::GetSelfVolumeResponse ConnectionFromClient::get_self_volume()
 {
     return m_queue->volume().target();
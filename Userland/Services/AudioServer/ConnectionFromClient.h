@@ -48,9 +48,13 @@ private:
     virtual void set_self_muted(bool) override;
     virtual void set_sample_rate(u32 sample_rate) override;
     virtual Messages::AudioServer::GetSampleRateResponse get_sample_rate() override;
+    virtual Messages::AudioServer::RequestBufferSizeResponse request_buffer_size(u32 buffer_size) override;
+    virtual Messages::AudioServer::GetBufferSizeResponse get_buffer_size() override;
 
     Mixer& m_mixer;
     RefPtr<ClientAudioStream> m_queue;
+    // Kept until the client sends its first buffer, as that's when the queue is created.
+    u32 m_requested_buffer_size { 0 };
 };
 
 }
@@ -8,18 +8,88 @@
 #include "Mixer.h"
 #include <AK/Array.h>
 #include <AK/Format.h>
-#include <AK/MemoryStream.h>
 #include <AK/NumericLimits.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
+#include <AK/SIMDMath.h>
 #include <AudioServer/ConnectionFromClient.h>
 #include <AudioServer/Mixer.h>
 #include <LibCore/ConfigFile.h>
 #include <LibCore/DeprecatedFile.h>
 #include <LibCore/Timer.h>
 #include <pthread.h>
+#include <sched.h>
 #include <sys/ioctl.h>
 
 namespace AudioServer {
 
+using AK::SIMD::f32x4;
+using AK::SIMD::i32x4;
+
+// Samples are two floats, so that two stereo samples fit into one vector.
+static_assert(sizeof(Audio::Sample) == 2 * sizeof(float));
+
+static ALWAYS_INLINE f32x4 load_two_samples(Audio::Sample const* samples)
+{
+    f32x4 vector;
+    __builtin_memcpy(&vector, samples, sizeof(vector));
+    return vector;
+}
+
+static ALWAYS_INLINE void store_two_samples(Audio::Sample* samples, f32x4 vector)
+{
+    __builtin_memcpy(static_cast<void*>(samples), &vector, sizeof(vector));
+}
+
+// The factor that Sample::log_multiply() scales by.
+static float log_gain(double volume)
+{
+    return Audio::Sample {}.linear_to_log(static_cast<float>(volume));
+}
+
+// Adds the samples to the mix, with a gain that goes from start_gain at the first sample towards end_gain at the last.
+// Ramping the gain over the whole buffer, instead of changing it from one buffer to the next, avoids audible steps.
+static void mix_with_gain_ramp(Span<Audio::Sample> mix, ReadonlySpan<Audio::Sample> samples, float start_gain, float end_gain)
+{
+    VERIFY(mix.size() >= samples.size());
+    if (samples.is_empty())
+        return;
+
+    auto gain_step = (end_gain - start_gain) / static_cast<float>(samples.size());
+    f32x4 gain { start_gain, start_gain, start_gain + gain_step, start_gain + gain_step };
+    auto const gain_increment = AK::SIMD::expand4(2 * gain_step);
+
+    size_t i = 0;
+    for (; i + 2 <= samples.size(); i += 2) {
+        store_two_samples(&mix[i], load_two_samples(&mix[i]) + load_two_samples(&samples[i]) * gain);
+        gain += gain_increment;
+    }
+    if (i < samples.size())
+        mix[i] += samples[i] * gain[0];
+}
+
+// Applies the main volume in the same way, clips, and writes the samples as the 16-bit stereo PCM that the device takes.
+static void write_pcm_with_gain_ramp(ReadonlySpan<Audio::Sample> mix, Bytes output, float start_gain, float end_gain)
+{
+    static_assert(HARDWARE_BUFFER_SIZE % 2 == 0 && MIN_HARDWARE_BUFFER_SIZE % 2 == 0);
+    VERIFY(mix.size() % 2 == 0);
+    VERIFY(output.size() == mix.size() * 2 * sizeof(i16));
+
+    auto gain_step = (end_gain - start_gain) / static_cast<float>(mix.size());
+    f32x4 gain { start_gain, start_gain, start_gain + gain_step, start_gain + gain_step };
+    auto const gain_increment = AK::SIMD::expand4(2 * gain_step);
+    auto const scale = AK::SIMD::expand4(static_cast<float>(NumericLimits<i16>::max()));
+
+    auto* out = reinterpret_cast<LittleEndian<i16>*>(output.data());
+    for (size_t i = 0; i < mix.size(); i += 2) {
+        auto clipped = AK::SIMD::clamp(load_two_samples(&mix[i]) * gain, -1.0f, 1.0f);
+        auto pcm = __builtin_convertvector(clipped * scale, i32x4);
+        for (size_t j = 0; j < 4; ++j)
+            *out++ = static_cast<i16>(pcm[j]);
+        gain += gain_increment;
+    }
+}
+
 Mixer::Mixer(NonnullRefPtr<Core::ConfigFile> config)
     // FIXME: Allow AudioServer to use other audio channels as well
     : m_device(Core::DeprecatedFile::construct("/dev/audio/0", this))
@@ -40,6 +110,16 @@ Mixer::Mixer(NonnullRefPtr<Core::ConfigFile> config)
     m_main_volume = static_cast<double>(m_config->read_num_entry("Master", "Volume", 100)) / 100.0;
 
     m_sound_thread->start();
+    // The mixer has to write the next buffer before the device runs out of the ones it has, which with small buffers
+    // is only a few milliseconds away, so it must not wait for other threads' time slices to end.
+    if (auto result = m_sound_thread->set_priority(THREAD_PRIORITY_REALTIME); result.is_error())
+        dbgln("Can't make the mixer thread realtime: {}", result.error());
+}
+
+u32 Mixer::clamp_buffer_size(u32 buffer_size)
+{
+    // Multiples of 16 samples keep the device writes aligned to cache lines.
+    return align_up_to(clamp<u32>(buffer_size, MIN_HARDWARE_BUFFER_SIZE, HARDWARE_BUFFER_SIZE), 16);
 }
 
 NonnullRefPtr<ClientAudioStream> Mixer::create_queue(ConnectionFromClient& client)
@@ -72,7 +152,19 @@ void Mixer::mix()
 
         active_mix_queues.remove_all_matching([&](auto& entry) { return !entry->is_connected(); });
 
-        Array<Audio::Sample, HARDWARE_BUFFER_SIZE> mixed_buffer;
+        // The client that needs the lowest latency decides for everyone.
+        u32 buffer_size = HARDWARE_BUFFER_SIZE;
+        for (auto& queue : active_mix_queues) {
+            if (auto requested_buffer_size = queue->requested_buffer_size(); requested_buffer_size != 0)
+                buffer_size = min(buffer_size, clamp_buffer_size(requested_buffer_size));
+        }
+        m_buffer_size.store(buffer_size, AK::MemoryOrder::memory_order_relaxed);
+
+        Array<Audio::Sample, HARDWARE_BUFFER_SIZE> mixed_buffer_storage;
+        Array<Audio::Sample, HARDWARE_BUFFER_SIZE> stream_buffer_storage;
+        auto mixed_buffer = mixed_buffer_storage.span().trim(buffer_size);
+        auto stream_buffer = stream_buffer_storage.span().trim(buffer_size);
+        auto output_buffer = m_stream_buffer.span().trim(buffer_size * 2 * sizeof(i16));
 
         m_main_volume.advance_time();
 
@@ -84,39 +176,27 @@ void Mixer::mix()
             }
             queue->volume().advance_time();
 
-            for (auto& mixed_sample : mixed_buffer) {
-                Audio::Sample sample;
-                if (!queue->get_next_sample(sample))
-                    break;
-                if (queue->is_muted())
-                    continue;
-                sample.log_multiply(SAMPLE_HEADROOM);
-                sample.log_multiply(static_cast<float>(queue->volume()));
-                mixed_sample += sample;
-            }
+            auto sample_count = queue->get_next_samples(stream_buffer);
+
+            // Muting fades the stream out over one buffer instead of cutting it off.
+            auto gain = queue->is_muted() ? 0.0f : log_gain(SAMPLE_HEADROOM) * log_gain(queue->volume());
+            auto previous_gain = queue->mixing_gain().value_or(gain);
+            queue->set_mixing_gain(gain);
+            if (gain == 0 && previous_gain == 0)
+                continue;
+
+            mix_with_gain_ramp(mixed_buffer, stream_buffer.trim(sample_count), previous_gain, gain);
         }
 
         // Even though it's not realistic, the user expects no sound at 0%.
         if (m_muted || m_main_volume < 0.01) {
-            m_device->write(m_zero_filled_buffer.data(), static_cast<int>(m_zero_filled_buffer.size()));
+            m_device->write(m_zero_filled_buffer.data(), static_cast<int>(output_buffer.size()));
+            m_main_gain = 0;
         } else {
-            FixedMemoryStream stream { m_stream_buffer.span() };
-
-            for (auto& mixed_sample : mixed_buffer) {
-                mixed_sample.log_multiply(static_cast<float>(m_main_volume));
-                mixed_sample.clip();
-
-                LittleEndian<i16> out_sample;
-                out_sample = static_cast<i16>(mixed_sample.left * NumericLimits<i16>::max());
-                MUST(stream.write_value(out_sample));
-
-                out_sample = static_cast<i16>(mixed_sample.right * NumericLimits<i16>::max());
-                MUST(stream.write_value(out_sample));
-            }
-
-            auto buffered_bytes = MUST(stream.tell());
-            VERIFY(buffered_bytes == m_stream_buffer.size());
-            m_device->write(m_stream_buffer.data(), static_cast<int>(buffered_bytes));
+            auto main_gain = log_gain(m_main_volume);
+            write_pcm_with_gain_ramp(mixed_buffer, output_buffer, m_main_gain, main_gain);
+            m_main_gain = main_gain;
+            m_device->write(output_buffer.data(), static_cast<int>(output_buffer.size()));
         }
     }
 }
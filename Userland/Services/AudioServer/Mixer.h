@@ -29,7 +29,10 @@ namespace AudioServer {
 // This is to prevent clipping when two streams with low headroom (e.g. normalized & compressed) are playing.
 constexpr double SAMPLE_HEADROOM = 0.95;
 // The size of the buffer in samples that the hardware receives through write() calls to the audio device.
+// This is also the largest buffer size that clients can ask for, and what's used if none of them asks for anything.
 constexpr size_t HARDWARE_BUFFER_SIZE = 512;
+// The smallest buffer size that clients can ask for; anything smaller makes the mixer wake up too often to keep up.
+constexpr size_t MIN_HARDWARE_BUFFER_SIZE = 64;
 // The hardware buffer size in bytes; there's two channels of 16-bit samples.
 constexpr size_t HARDWARE_BUFFER_SIZE_BYTES = HARDWARE_BUFFER_SIZE * 2 * sizeof(i16);
 
@@ -40,32 +43,20 @@ public:
     explicit ClientAudioStream(ConnectionFromClient&);
     ~ClientAudioStream() = default;
 
-    bool get_next_sample(Audio::Sample& sample)
+    // Fills the start of the buffer with as many samples as there are, and returns how many that were.
+    size_t get_next_samples(Span<Audio::Sample> samples)
     {
-        if (m_paused)
-            return false;
-
-        if (m_in_chunk_location >= m_current_audio_chunk.size()) {
-            auto result = m_buffer->dequeue();
-            if (result.is_error()) {
-                if (result.error() == Audio::AudioQueue::QueueStatus::Empty) {
-                    dbgln("Audio client {} can't keep up!", m_client->client_id());
-                    // Note: Even though we only check client state here, we will probably close the client much earlier.
-                    if (!m_client->is_open()) {
-                        dbgln("Client socket {} has closed, closing audio server connection.", m_client->client_id());
-                        m_client->shutdown();
-                    }
-                }
-
-                return false;
-            }
-            m_current_audio_chunk = result.release_value();
-            m_in_chunk_location = 0;
+        size_t sample_count = 0;
+        while (sample_count < samples.size()) {
+            if (!ensure_current_chunk())
+                break;
+
+            auto chunk_samples = min(m_current_audio_chunk.size() - m_in_chunk_location, samples.size() - sample_count);
+            m_current_audio_chunk.span().slice(m_in_chunk_location, chunk_samples).copy_to(samples.slice(sample_count));
+            m_in_chunk_location += chunk_samples;
+            sample_count += chunk_samples;
         }
-
-        sample = m_current_audio_chunk[m_in_chunk_location++];
-
-        return true;
+        return sample_count;
     }
 
     bool is_connected() const { return m_client && m_client->is_open(); }
@@ -90,16 +81,53 @@ public:
     bool is_muted() const { return m_muted; }
     void set_muted(bool muted) { m_muted = muted; }
 
+    // The gain that the last buffer was mixed with at its end, which the next buffer's gain ramp starts at.
+    Optional<float> mixing_gain() const { return m_mixing_gain; }
+    void set_mixing_gain(float gain) { m_mixing_gain = gain; }
+
+    // The hardware buffer size in samples that the client would like to have at most, or 0 if it doesn't care.
+    u32 requested_buffer_size() const { return m_requested_buffer_size.load(AK::MemoryOrder::memory_order_relaxed); }
+    void set_requested_buffer_size(u32 buffer_size) { m_requested_buffer_size.store(buffer_size, AK::MemoryOrder::memory_order_relaxed); }
+
 private:
+    bool ensure_current_chunk()
+    {
+        if (m_paused)
+            return false;
+
+        if (m_in_chunk_location >= m_current_audio_chunk.size()) {
+            auto result = m_buffer->dequeue();
+            if (result.is_error()) {
+                if (result.error() == Audio::AudioQueue::QueueStatus::Empty) {
+                    dbgln("Audio client {} can't keep up!", m_client->client_id());
+                    // Note: Even though we only check client state here, we will probably close the client much earlier.
+                    if (!m_client->is_open()) {
+                        dbgln("Client socket {} has closed, closing audio server connection.", m_client->client_id());
+                        m_client->shutdown();
+                    }
+                }
+
+                return false;
+            }
+            m_current_audio_chunk = result.release_value();
+            m_in_chunk_location = 0;
+        }
+
+        return true;
+    }
+
     OwnPtr<Audio::AudioQueue> m_buffer;
     Array<Audio::Sample, Audio::AUDIO_BUFFER_SIZE> m_current_audio_chunk;
-    size_t m_in_chunk_location;
+    // Starts out past the end, so that the first chunk is dequeued right away.
+    size_t m_in_chunk_location { Audio::AUDIO_BUFFER_SIZE };
 
     bool m_paused { true };
     bool m_muted { false };
 
     WeakPtr<ConnectionFromClient> m_client;
     FadingProperty<double> m_volume { 1 };
+    Optional<float> m_mixing_gain;
+    Atomic<u32> m_requested_buffer_size { 0 };
 };
 
 class Mixer : public Core::Object {
@@ -119,6 +147,12 @@ public:
     int audiodevice_set_sample_rate(u32 sample_rate);
     u32 audiodevice_get_sample_rate() const;
 
+    // Rounds a buffer size that a client asked for to one that the mixer can use.
+    static u32 clamp_buffer_size(u32 buffer_size);
+    // The number of samples that the mixer currently writes to the device at once. As the device only has a few
+    // buffers in flight, this is what the output latency is proportional to.
+    u32 buffer_size() const { return m_buffer_size.load(AK::MemoryOrder::memory_order_relaxed); }
+
 private:
     Mixer(NonnullRefPtr<Core::ConfigFile> config);
 
@@ -134,6 +168,10 @@ private:
 
     bool m_muted { false };
     FadingProperty<double> m_main_volume { 1 };
+    // The gain that the main volume was applied with at the end of the last buffer.
+    float m_main_gain { 0 };
+    // The smallest buffer size that an active client asked for.
+    Atomic<u32> m_buffer_size { HARDWARE_BUFFER_SIZE };
 
     NonnullRefPtr<Core::ConfigFile> m_config;
     RefPtr<Core::Timer> m_config_write_timer;
@@ -5,31 +5,112 @@
  */
 
 #include <AK/LexicalPath.h>
+#include <AK/ScopeGuard.h>
 #include <Kernel/API/InodeWatcherEvent.h>
+#include <LibCompress/Gzip.h>
+#include <LibCore/File.h>
 #include <LibCore/FileWatcher.h>
-#include <LibCore/MappedFile.h>
 #include <LibCore/Process.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <LibThreading/Thread.h>
 #include <serenity.h>
 #include <spawn.h>
 #include <sys/stat.h>
 #include <time.h>
 #include <unistd.h>
 
-static void wait_until_coredump_is_ready(DeprecatedString const& coredump_path)
+// Coredumps are compressed in chunks of this size, each into a gzip member of its own, so that several threads can work
+// on them at once. Gzip files consisting of multiple members decompress to the concatenation of all of them.
+static constexpr size_t compression_chunk_size = 4 * MiB;
+
+static bool coredump_is_ready(DeprecatedString const& coredump_path)
 {
-    while (true) {
-        struct stat statbuf;
-        if (stat(coredump_path.characters(), &statbuf) < 0) {
-            perror("stat");
-            VERIFY_NOT_REACHED();
+    struct stat statbuf;
+    if (stat(coredump_path.characters(), &statbuf) < 0) {
+        perror("stat");
+        VERIFY_NOT_REACHED();
+    }
+    // The kernel makes the coredump readable once it's done writing it.
+    return statbuf.st_mode & 0400;
+}
+
+struct CompressionJob {
+    explicit CompressionJob(ByteBuffer input)
+        : input(move(input))
+    {
+    }
+
+    ByteBuffer input;
+    Optional<ErrorOr<ByteBuffer>> output;
+    RefPtr<Threading::Thread> thread;
+};
+
+// Compresses the coredump while the kernel is still writing it, instead of waiting for it to finish first.
+static ErrorOr<void> compress_coredump(DeprecatedString const& coredump_path, DeprecatedString const& output_path)
+{
+    auto input_file = TRY(Core::File::open(coredump_path, Core::File::OpenMode::Read));
+    auto output_file = TRY(Core::File::open(output_path, Core::File::OpenMode::Write, 0600));
+
+    size_t max_running_jobs = max(1l, sysconf(_SC_NPROCESSORS_ONLN));
+    Vector<NonnullOwnPtr<CompressionJob>> jobs;
+    ScopeGuard join_running_jobs = [&] {
+        for (auto& job : jobs)
+            (void)job->thread->join();
+    };
+
+    // The jobs are started and finished in order, so the members end up in the output in the right order as well.
+    auto finish_oldest_job = [&]() -> ErrorOr<void> {
+        auto job = jobs.take_first();
+        (void)job->thread->join();
+        auto compressed_chunk = TRY(job->output.release_value());
+        TRY(output_file->write_entire_buffer(compressed_chunk));
+        return {};
+    };
+
+    auto start_job = [&](ByteBuffer chunk) -> ErrorOr<void> {
+        if (jobs.size() >= max_running_jobs)
+            TRY(finish_oldest_job());
+        // Make sure the job can't get lost once its thread is running.
+        TRY(jobs.try_ensure_capacity(jobs.size() + 1));
+        auto job = TRY(try_make<CompressionJob>(move(chunk)));
+        job->thread = TRY(Threading::Thread::try_create([&job = *job] {
+            job.output = Compress::GzipCompressor::compress_all(job.input);
+            return 0;
+        },
+            "Coredump Compression"sv));
+        job->thread->start();
+        jobs.unchecked_append(move(job));
+        return {};
+    };
+
+    auto chunk = TRY(ByteBuffer::create_uninitialized(compression_chunk_size));
+    size_t chunk_size = 0;
+    for (;;) {
+        // Check this before reading, so that once it's ready the read that comes up empty really is at the end.
+        bool is_ready = coredump_is_ready(coredump_path);
+        auto bytes_read = TRY(input_file->read(chunk.bytes().slice(chunk_size))).size();
+        chunk_size += bytes_read;
+        if (chunk_size == chunk.size()) {
+            TRY(start_job(move(chunk)));
+            chunk = TRY(ByteBuffer::create_uninitialized(compression_chunk_size));
+            chunk_size = 0;
+            continue;
+        }
+        if (bytes_read == 0) {
+            if (is_ready)
+                break;
+            usleep(10000); // sleep for 10ms
         }
-        if (statbuf.st_mode & 0400) // Check if readable
-            break;
+    }
 
-        usleep(10000); // sleep for 10ms
+    if (chunk_size > 0) {
+        chunk.resize(chunk_size);
+        TRY(start_job(move(chunk)));
     }
+    while (!jobs.is_empty())
+        TRY(finish_oldest_job());
+    return {};
 }
 
 static void launch_crash_reporter(DeprecatedString const& coredump_path, bool unlink_on_exit)
@@ -44,7 +125,7 @@ static void launch_crash_reporter(DeprecatedString const& coredump_path, bool un
 
 ErrorOr<int> serenity_main(Main::Arguments)
 {
-    TRY(Core::System::pledge("stdio rpath wpath cpath proc exec"));
+    TRY(Core::System::pledge("stdio rpath wpath cpath proc exec thread"));
 
     Core::BlockingFileWatcher watcher;
     TRY(watcher.add_watch("/tmp/coredump", Core::FileWatcherEvent::Type::ChildCreated));
@@ -55,15 +136,22 @@ ErrorOr<int> serenity_main(Main::Arguments)
         if (event.value().type != Core::FileWatcherEvent::Type::ChildCreated)
             continue;
         auto& coredump_path = event.value().event_path;
+        // Don't pick up our own compressed coredumps.
+        if (coredump_path.ends_with(".gz"sv))
+            continue;
         dbgln("New coredump file: {}", coredump_path);
-        wait_until_coredump_is_ready(coredump_path);
 
-        auto file_or_error = Core::MappedFile::map(coredump_path);
-        if (file_or_error.is_error()) {
-            dbgln("Unable to map coredump {}: {}", coredump_path, file_or_error.error());
+        auto compressed_coredump_path = DeprecatedString::formatted("{}.gz", coredump_path);
+        if (auto result = compress_coredump(coredump_path, compressed_coredump_path); result.is_error()) {
+            dbgln("Unable to compress coredump {}: {}", coredump_path, result.error());
+            (void)Core::System::unlink(compressed_coredump_path);
+            while (!coredump_is_ready(coredump_path))
+                usleep(10000); // sleep for 10ms
+            launch_crash_reporter(coredump_path, true);
             continue;
         }
 
-        launch_crash_reporter(coredump_path, true);
+        (void)Core::System::unlink(coredump_path);
+        launch_crash_reporter(compressed_coredump_path, true);
     }
 }
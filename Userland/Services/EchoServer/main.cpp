@@ -5,6 +5,7 @@
  */
 
 #include "Client.h"
+#include <AK/Atomic.h>
 #include <AK/HashMap.h>
 #include <AK/IPv4Address.h>
 #include <LibCore/ArgsParser.h>
@@ -12,51 +13,77 @@
 #include <LibCore/System.h>
 #include <LibCore/TCPServer.h>
 #include <LibMain/Main.h>
+#include <LibThreading/EventLoopGroup.h>
+
+static Atomic<int> s_next_client_id;
+
+// Every thread serves the clients it accepted itself.
+static thread_local HashMap<int, NonnullRefPtr<Client>> s_clients;
+static thread_local RefPtr<Core::TCPServer> s_shared_server;
+
+static void accept_clients(Core::TCPServer& server)
+{
+    server.on_ready_to_accept = [&server] {
+        auto maybe_client_socket = server.accept();
+        if (maybe_client_socket.is_error()) {
+            // Another thread got to the client first.
+            if (maybe_client_socket.error().code() == EAGAIN)
+                return;
+            warnln("accept: {}", maybe_client_socket.error());
+            return;
+        }
+
+        int id = s_next_client_id.fetch_add(1);
+        outln("Client {} connected", id);
+
+        auto client = Client::create(id, maybe_client_socket.release_value());
+        client->on_exit = [id] {
+            Core::deferred_invoke([id] {
+                s_clients.remove(id);
+                outln("Client {} disconnected", id);
+            });
+        };
+        s_clients.set(id, client);
+    };
+}
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
-    TRY(Core::System::pledge("stdio unix inet id accept"));
+    TRY(Core::System::pledge("stdio unix inet id accept thread"));
     TRY(Core::System::unveil(nullptr, nullptr));
 
     int port = 7;
+    size_t thread_count = 1;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(port, "Port to listen on", "port", 'p', "port");
+    args_parser.add_option(thread_count, "Number of threads that serve clients", "threads", 't', "count");
     args_parser.parse(arguments);
 
     if ((u16)port != port) {
         warnln("Invalid port number: {}", port);
         exit(1);
     }
+    if (thread_count == 0) {
+        warnln("At least one thread has to serve clients");
+        exit(1);
+    }
 
     Core::EventLoop event_loop;
 
     auto server = TRY(Core::TCPServer::try_create());
     TRY(server->listen({}, port));
+    accept_clients(*server);
 
-    HashMap<int, NonnullRefPtr<Client>> clients;
-    int next_id = 0;
-
-    server->on_ready_to_accept = [&next_id, &clients, &server] {
-        int id = next_id++;
-
-        auto maybe_client_socket = server->accept();
-        if (maybe_client_socket.is_error()) {
-            warnln("accept: {}", maybe_client_socket.error());
-            return;
-        }
-
-        outln("Client {} connected", id);
-
-        auto client = Client::create(id, maybe_client_socket.release_value());
-        client->on_exit = [&clients, id] {
-            Core::deferred_invoke([&clients, id] {
-                clients.remove(id);
-                outln("Client {} disconnected", id);
-            });
-        };
-        clients.set(id, client);
-    };
+    // The main thread serves clients as well, so it only needs help from the others.
+    OwnPtr<Threading::EventLoopGroup> helper_threads;
+    if (thread_count > 1) {
+        helper_threads = TRY(Threading::EventLoopGroup::create(thread_count - 1, [&server](size_t) -> ErrorOr<void> {
+            s_shared_server = TRY(Core::TCPServer::try_create_sharing(*server));
+            accept_clients(*s_shared_server);
+            return {};
+        }));
+    }
 
     outln("Listening on 0.0.0.0:{}", port);
 
@@ -6,9 +6,12 @@
 
 #include <AK/Debug.h>
 #include <ImageDecoder/ConnectionFromClient.h>
+#include <ImageDecoder/DecodedImageCache.h>
 #include <ImageDecoder/ImageDecoderClientEndpoint.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/ImageDecoder.h>
+#include <LibThreading/BackgroundAction.h>
+#include <LibThreading/ThreadPool.h>
 
 namespace ImageDecoder {
 
@@ -22,39 +25,62 @@ void ConnectionFromClient::die()
     Core::EventLoop::current().quit(0);
 }
 
-static void decode_image_to_bitmaps_and_durations_with_decoder(Gfx::ImageDecoder const& decoder, Vector<Gfx::ShareableBitmap>& bitmaps, Vector<u32>& durations)
+// This is called on the decoding threads, so it must not touch anything but the encoded data.
+static DecodedImage decode_image_from_buffer(Core::AnonymousBuffer const& encoded_buffer, Optional<DeprecatedString> const& known_mime_type)
 {
-    for (size_t i = 0; i < decoder.frame_count(); ++i) {
-        auto frame_or_error = decoder.frame(i);
+    DecodedImage image;
+
+    auto decoder = Gfx::ImageDecoder::try_create_for_raw_bytes(ReadonlyBytes { encoded_buffer.data<u8>(), encoded_buffer.size() }, known_mime_type);
+    if (!decoder) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "Could not find suitable image decoder plugin for data");
+        return image;
+    }
+
+    if (!decoder->frame_count()) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "Could not decode image from encoded data");
+        return image;
+    }
+    image.is_animated = decoder->is_animated();
+    image.loop_count = decoder->loop_count();
+    for (size_t i = 0; i < decoder->frame_count(); ++i) {
+        auto frame_or_error = decoder->frame(i);
         if (frame_or_error.is_error()) {
-            bitmaps.append(Gfx::ShareableBitmap {});
-            durations.append(0);
+            image.frames.append(nullptr);
+            image.durations.append(0);
         } else {
             auto frame = frame_or_error.release_value();
-            bitmaps.append(frame.image->to_shareable_bitmap());
-            durations.append(frame.duration);
+            image.frames.append(move(frame.image));
+            image.durations.append(frame.duration);
         }
     }
+    return image;
 }
 
-static void decode_image_to_details(Core::AnonymousBuffer const& encoded_buffer, Optional<DeprecatedString> const& known_mime_type, bool& is_animated, u32& loop_count, Vector<Gfx::ShareableBitmap>& bitmaps, Vector<u32>& durations)
+static Vector<Gfx::ShareableBitmap> to_shareable_bitmaps(DecodedImage const& image)
 {
-    VERIFY(bitmaps.size() == 0);
-    VERIFY(durations.size() == 0);
-
-    auto decoder = Gfx::ImageDecoder::try_create_for_raw_bytes(ReadonlyBytes { encoded_buffer.data<u8>(), encoded_buffer.size() }, known_mime_type);
-    if (!decoder) {
-        dbgln_if(IMAGE_DECODER_DEBUG, "Could not find suitable image decoder plugin for data");
-        return;
+    Vector<Gfx::ShareableBitmap> bitmaps;
+    for (auto const& frame : image.frames) {
+        if (!frame) {
+            bitmaps.append(Gfx::ShareableBitmap {});
+        } else if (frame->anonymous_buffer().is_valid()) {
+            // Such a bitmap would be shared as it is, and then the client could draw into the cached frame.
+            auto clone_or_error = frame->clone();
+            bitmaps.append(clone_or_error.is_error() ? Gfx::ShareableBitmap {} : clone_or_error.value()->to_shareable_bitmap());
+        } else {
+            bitmaps.append(frame->to_shareable_bitmap());
+        }
     }
+    return bitmaps;
+}
 
-    if (!decoder->frame_count()) {
-        dbgln_if(IMAGE_DECODER_DEBUG, "Could not decode image from encoded data");
-        return;
-    }
-    is_animated = decoder->is_animated();
-    loop_count = decoder->loop_count();
-    decode_image_to_bitmaps_and_durations_with_decoder(*decoder, bitmaps, durations);
+static DecodedImage decode_image_with_cache(Core::AnonymousBuffer const& encoded_buffer, Optional<DeprecatedString> const& mime_type)
+{
+    if (auto const* cached_image = DecodedImageCache::the().get({ encoded_buffer.data<u8>(), encoded_buffer.size() }, mime_type))
+        return *cached_image;
+
+    auto image = decode_image_from_buffer(encoded_buffer, mime_type);
+    DecodedImageCache::the().set(encoded_buffer, mime_type, image);
+    return image;
 }
 
 Messages::ImageDecoderServer::DecodeImageResponse ConnectionFromClient::decode_image(Core::AnonymousBuffer const& encoded_buffer, Optional<DeprecatedString> const& mime_type)
@@ -64,12 +90,59 @@ Messages::ImageDecoderServer::DecodeImageResponse ConnectionFromClient::decode_i
         return nullptr;
     }
 
-    bool is_animated = false;
-    u32 loop_count = 0;
-    Vector<Gfx::ShareableBitmap> bitmaps;
-    Vector<u32> durations;
-    decode_image_to_details(encoded_buffer, mime_type, is_animated, loop_count, bitmaps, durations);
-    return { is_animated, loop_count, bitmaps, durations };
+    auto image = decode_image_with_cache(encoded_buffer, mime_type);
+    return { image.is_animated, image.loop_count, to_shareable_bitmaps(image), image.durations };
+}
+
+void ConnectionFromClient::start_decoding_image(i32 request_id, Core::AnonymousBuffer const& encoded_buffer, Optional<DeprecatedString> const& mime_type, DecodePriority priority)
+{
+    if (!encoded_buffer.is_valid()) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "Encoded data is invalid");
+        async_did_decode_image(request_id, false, 0, {}, {});
+        return;
+    }
+
+    if (auto const* cached_image = DecodedImageCache::the().get({ encoded_buffer.data<u8>(), encoded_buffer.size() }, mime_type)) {
+        async_did_decode_image(request_id, cached_image->is_animated, cached_image->loop_count, to_shareable_bitmaps(*cached_image), cached_image->durations);
+        return;
+    }
+
+    PendingDecode pending_decode { request_id, encoded_buffer, mime_type };
+    if (priority == DecodePriority::Visible)
+        m_pending_visible_decodes.enqueue(move(pending_decode));
+    else
+        m_pending_offscreen_decodes.enqueue(move(pending_decode));
+    start_pending_decodes();
+}
+
+void ConnectionFromClient::start_pending_decodes()
+{
+    // Only as many images are decoded at once as there are threads, so that a visible image that comes in later
+    // doesn't have to wait behind all offscreen ones that came before it.
+    auto& thread_pool = Threading::ThreadPool::the();
+    while (m_decodes_in_progress < thread_pool.worker_count()) {
+        Optional<PendingDecode> pending_decode;
+        if (!m_pending_visible_decodes.is_empty())
+            pending_decode = m_pending_visible_decodes.dequeue();
+        else if (!m_pending_offscreen_decodes.is_empty())
+            pending_decode = m_pending_offscreen_decodes.dequeue();
+        else
+            break;
+
+        ++m_decodes_in_progress;
+        (void)Threading::BackgroundAction<DecodedImage>::construct(
+            thread_pool,
+            [encoded_buffer = pending_decode->encoded_buffer, mime_type = pending_decode->mime_type](auto&) {
+                return decode_image_from_buffer(encoded_buffer, mime_type);
+            },
+            [this, protector = NonnullRefPtr { *this }, pending_decode = pending_decode.release_value()](DecodedImage image) -> ErrorOr<void> {
+                --m_decodes_in_progress;
+                DecodedImageCache::the().set(pending_decode.encoded_buffer, pending_decode.mime_type, image);
+                async_did_decode_image(pending_decode.request_id, image.is_animated, image.loop_count, to_shareable_bitmaps(image), image.durations);
+                start_pending_decodes();
+                return {};
+            });
+    }
 }
 
 }
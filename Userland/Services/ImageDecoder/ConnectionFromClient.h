@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/HashMap.h>
+#include <AK/Queue.h>
 #include <ImageDecoder/Forward.h>
 #include <ImageDecoder/ImageDecoderClientEndpoint.h>
 #include <ImageDecoder/ImageDecoderServerEndpoint.h>
@@ -27,6 +28,20 @@ private:
     explicit ConnectionFromClient(NonnullOwnPtr<Core::LocalSocket>);
 
     virtual Messages::ImageDecoderServer::DecodeImageResponse decode_image(Core::AnonymousBuffer const&, Optional<DeprecatedString> const& mime_type) override;
+    virtual void start_decoding_image(i32 request_id, Core::AnonymousBuffer const&, Optional<DeprecatedString> const& mime_type, DecodePriority priority) override;
+
+    struct PendingDecode {
+        i32 request_id { 0 };
+        Core::AnonymousBuffer encoded_buffer;
+        Optional<DeprecatedString> mime_type;
+    };
+
+    void start_pending_decodes();
+
+    // Images that are waiting for a thread to be decoded on, with the visible ones always going first.
+    Queue<PendingDecode> m_pending_visible_decodes;
+    Queue<PendingDecode> m_pending_offscreen_decodes;
+    size_t m_decodes_in_progress { 0 };
 };
 
 }
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+namespace ImageDecoder {
+
+// A hint for which images to decode first, when more of them are waiting than there are threads to decode them on.
+enum class DecodePriority : u8 {
+    Visible,
+    Offscreen,
+};
+
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringHash.h>
+#include <ImageDecoder/DecodedImageCache.h>
+
+namespace ImageDecoder {
+
+DecodedImageCache& DecodedImageCache::the()
+{
+    static DecodedImageCache s_the;
+    return s_the;
+}
+
+static u32 hash_encoded_data(ReadonlyBytes encoded_data)
+{
+    return string_hash(reinterpret_cast<char const*>(encoded_data.data()), encoded_data.size());
+}
+
+DecodedImage const* DecodedImageCache::get(ReadonlyBytes encoded_data, Optional<DeprecatedString> const& mime_type)
+{
+    auto hash = hash_encoded_data(encoded_data);
+    for (auto& entry : m_entries) {
+        if (entry.hash != hash || entry.mime_type != mime_type || entry.encoded_buffer.size() != encoded_data.size())
+            continue;
+        // Two different images can have the same hash, so the data has to be compared as well.
+        if (__builtin_memcmp(entry.encoded_buffer.data<u8>(), encoded_data.data(), encoded_data.size()) != 0)
+            continue;
+        entry.last_use = ++m_use_counter;
+        return &entry.image;
+    }
+    return nullptr;
+}
+
+void DecodedImageCache::set(Core::AnonymousBuffer const& encoded_buffer, Optional<DeprecatedString> const& mime_type, DecodedImage const& image)
+{
+    size_t size_in_bytes = encoded_buffer.size();
+    for (auto const& frame : image.frames) {
+        if (frame)
+            size_in_bytes += frame->size_in_bytes();
+    }
+    // A single huge image would push everything else out, and is unlikely to be shown more than once anyway.
+    if (image.frames.is_empty() || size_in_bytes > max_size_in_bytes / 4)
+        return;
+
+    ReadonlyBytes encoded_data { encoded_buffer.data<u8>(), encoded_buffer.size() };
+    if (get(encoded_data, mime_type))
+        return;
+
+    evict_until_size_is_at_most(max_size_in_bytes - size_in_bytes);
+    m_entries.append({
+        .hash = hash_encoded_data(encoded_data),
+        .encoded_buffer = encoded_buffer,
+        .mime_type = mime_type,
+        .image = image,
+        .size_in_bytes = size_in_bytes,
+        .last_use = ++m_use_counter,
+    });
+    m_size_in_bytes += size_in_bytes;
+}
+
+void DecodedImageCache::evict_until_size_is_at_most(size_t size_in_bytes)
+{
+    while (m_size_in_bytes > size_in_bytes && !m_entries.is_empty()) {
+        size_t least_recently_used = 0;
+        for (size_t i = 1; i < m_entries.size(); ++i) {
+            if (m_entries[i].last_use < m_entries[least_recently_used].last_use)
+                least_recently_used = i;
+        }
+        m_size_in_bytes -= m_entries[least_recently_used].size_in_bytes;
+        m_entries.remove(least_recently_used);
+    }
+}
+
+}
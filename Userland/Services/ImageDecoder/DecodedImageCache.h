@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/DeprecatedString.h>
+#include <AK/Optional.h>
+#include <AK/RefPtr.h>
+#include <AK/Vector.h>
+#include <LibCore/AnonymousBuffer.h>
+#include <LibGfx/Bitmap.h>
+
+namespace ImageDecoder {
+
+struct DecodedImage {
+    bool is_animated { false };
+    u32 loop_count { 0 };
+    // Frames that couldn't be decoded are null.
+    Vector<RefPtr<Gfx::Bitmap>> frames;
+    Vector<u32> durations;
+};
+
+// Remembers the most recently decoded images by their encoded data, so that the same image sent again
+// (like an icon that is shown in many places) is only decoded once.
+//
+// The cached bitmaps are never handed out directly, since clients may draw into the bitmaps they receive.
+class DecodedImageCache {
+public:
+    static DecodedImageCache& the();
+
+    DecodedImage const* get(ReadonlyBytes encoded_data, Optional<DeprecatedString> const& mime_type);
+    void set(Core::AnonymousBuffer const& encoded_buffer, Optional<DeprecatedString> const& mime_type, DecodedImage const&);
+
+private:
+    // How many bytes the decoded frames of all cached images may take up together.
+    static constexpr size_t max_size_in_bytes = 32 * MiB;
+
+    struct Entry {
+        u32 hash { 0 };
+        Core::AnonymousBuffer encoded_buffer;
+        Optional<DeprecatedString> mime_type;
+        DecodedImage image;
+        size_t size_in_bytes { 0 };
+        u64 last_use { 0 };
+    };
+
+    void evict_until_size_is_at_most(size_t);
+
+    Vector<Entry> m_entries;
+    size_t m_size_in_bytes { 0 };
+    u64 m_use_counter { 0 };
+};
+
+}
@@ -64,4 +64,11 @@ Messages::LookupServer::LookupAddressResponse ConnectionFromClient::lookup_addre
         return { 1, DeprecatedString() };
     return { 0, answers[0].record_data() };
 }
+
+Messages::LookupServer::CacheStatisticsResponse ConnectionFromClient::cache_statistics()
+{
+    auto& lookup_server = LookupServer::the();
+    auto& statistics = lookup_server.cache_statistics();
+    return { static_cast<u32>(lookup_server.cache_size()), statistics.hits, statistics.negative_hits, statistics.misses, statistics.stale_answers };
+}
 }
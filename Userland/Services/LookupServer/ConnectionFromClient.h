@@ -27,6 +27,7 @@ private:
 
     virtual Messages::LookupServer::LookupNameResponse lookup_name(DeprecatedString const&) override;
     virtual Messages::LookupServer::LookupAddressResponse lookup_address(DeprecatedString const&) override;
+    virtual Messages::LookupServer::CacheStatisticsResponse cache_statistics() override;
 };
 
 }
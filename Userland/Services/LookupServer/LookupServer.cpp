@@ -26,6 +26,16 @@ static LookupServer* s_the;
 // NOTE: This is the TTL we return for the hostname or answers from /etc/hosts.
 static constexpr u32 s_static_ttl = 86400;
 
+static constexpr size_t s_max_cache_size = 256;
+// RFC 2308, section 5: Negative answers shouldn't be cached for more than a few hours, whatever the SOA says.
+static constexpr u32 s_max_negative_ttl = 3 * 3600;
+// RFC 8767, section 5: How long expired answers are kept around, in case the nameservers become unreachable,
+// and the TTL they're handed out with in that case.
+static constexpr time_t s_max_stale_time = 86400;
+static constexpr u32 s_stale_answer_ttl = 30;
+// Keeps a CNAME loop in the cache from keeping us busy forever.
+static constexpr size_t s_max_cname_chain_length = 8;
+
 LookupServer& LookupServer::the()
 {
     VERIFY(s_the);
@@ -169,17 +179,16 @@ ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, RecordType record
     }
 
     // Third, try our cache.
-    if (auto cached_answers = m_lookup_cache.find(name); cached_answers != m_lookup_cache.end()) {
-        for (auto& answer : cached_answers->value) {
-            // TODO: Actually remove expired answers from the cache.
-            if (answer.type() == record_type && !answer.has_expired()) {
-                dbgln_if(LOOKUPSERVER_DEBUG, "Cache hit: {} -> {}", name.as_string(), answer.record_data());
-                add_answer(answer);
-            }
-        }
-        if (!answers.is_empty())
-            return answers;
+    if (auto cached_answers = lookup_in_cache(name, record_type); cached_answers.has_value()) {
+        if (cached_answers->is_empty())
+            ++m_cache_statistics.negative_hits;
+        else
+            ++m_cache_statistics.hits;
+        for (auto& answer : *cached_answers)
+            add_answer(answer);
+        return answers;
     }
+    ++m_cache_statistics.misses;
 
     // Fourth, look up .local names using mDNS instead of DNS nameservers.
     if (name.as_string().ends_with(".local"sv)) {
@@ -190,6 +199,7 @@ ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, RecordType record
     }
 
     // Fifth, ask the upstream nameservers.
+    bool did_get_any_response = false;
     for (auto& nameserver : m_nameservers) {
         dbgln_if(LOOKUPSERVER_DEBUG, "Doing lookup using nameserver '{}'", nameserver);
         bool did_get_response = false;
@@ -203,10 +213,14 @@ ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, RecordType record
             if (did_get_response)
                 break;
         } while (--retries);
+        did_get_any_response |= did_get_response;
         if (!upstream_answers.is_empty()) {
             for (auto& answer : upstream_answers)
                 add_answer(answer);
             break;
+        } else if (did_get_response && lookup_in_cache(name, record_type).has_value()) {
+            // The nameserver told us that there's nothing to find, and there's no reason to think that the next one knows better.
+            break;
         } else {
             if (!did_get_response)
                 dbgln("Never got a response from '{}', trying next nameserver", nameserver);
@@ -215,7 +229,18 @@ ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, RecordType record
         }
     }
 
-    // Sixth, fail.
+    // Sixth, make do with what we knew before it expired if the nameservers can't be reached.
+    if (answers.is_empty() && !did_get_any_response) {
+        for (auto& answer : lookup_stale_in_cache(name, record_type))
+            add_answer(answer);
+        if (!answers.is_empty()) {
+            dbgln("Couldn't reach any nameserver, answering with stale records for '{}'", name.as_string());
+            ++m_cache_statistics.stale_answers;
+            return answers;
+        }
+    }
+
+    // Seventh, fail.
     if (answers.is_empty()) {
         dbgln("Tried all nameservers but never got a response :(");
         return Vector<Answer> {};
@@ -287,8 +312,15 @@ ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, DeprecatedString
         }
     }
 
+    if (response.code() == Packet::Code::NXDOMAIN) {
+        dbgln_if(LOOKUPSERVER_DEBUG, "LookupServer: '{}' doesn't exist", name.as_string());
+        put_negative_answer_in_cache(name, {}, response.negative_caching_ttl());
+        return Vector<Answer> {};
+    }
+
     if (response.answer_count() < 1) {
         dbgln("LookupServer: No answers :(");
+        put_negative_answer_in_cache(name, record_type, response.negative_caching_ttl());
         return Vector<Answer> {};
     }
 
@@ -303,35 +335,156 @@ ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, DeprecatedString
     return answers;
 }
 
+bool LookupServer::CacheEntry::is_worth_keeping(time_t now) const
+{
+    if (does_not_exist_until > now)
+        return true;
+    for (auto& it : has_no_records_until) {
+        if (it.value > now)
+            return true;
+    }
+    return any_of(answers, [&](Answer const& answer) { return answer.received_time() + answer.ttl() + s_max_stale_time > now; });
+}
+
+LookupServer::CacheEntry& LookupServer::ensure_cache_entry(Name const& name)
+{
+    auto now = time(nullptr);
+    if (auto it = m_lookup_cache.find(name); it != m_lookup_cache.end()) {
+        it->value.last_used = now;
+        return it->value;
+    }
+
+    // Prevent the cache from growing too big.
+    if (m_lookup_cache.size() >= s_max_cache_size)
+        evict_from_cache();
+
+    auto& entry = m_lookup_cache.ensure(name);
+    entry.last_used = now;
+    return entry;
+}
+
+void LookupServer::evict_from_cache()
+{
+    // First forget about everything that's too old to even be served stale, and then about whatever name was looked up the longest time ago.
+    auto now = time(nullptr);
+    m_lookup_cache.remove_all_matching([&](auto&, CacheEntry const& entry) { return !entry.is_worth_keeping(now); });
+    if (m_lookup_cache.size() < s_max_cache_size)
+        return;
+
+    auto least_recently_used = m_lookup_cache.begin();
+    for (auto it = m_lookup_cache.begin(); it != m_lookup_cache.end(); ++it) {
+        if (it->value.last_used < least_recently_used->value.last_used)
+            least_recently_used = it;
+    }
+    dbgln_if(LOOKUPSERVER_DEBUG, "Evicting cache entry: {}", least_recently_used->key.as_string());
+    m_lookup_cache.remove(least_recently_used);
+}
+
+Optional<Vector<Answer>> LookupServer::lookup_in_cache(Name const& name, RecordType record_type)
+{
+    auto now = time(nullptr);
+
+    // The records we're after may be stored under the canonical name, so follow the CNAMEs until we find them.
+    Name current_name = name;
+    for (size_t i = 0; i < s_max_cname_chain_length; ++i) {
+        auto it = m_lookup_cache.find(current_name);
+        if (it == m_lookup_cache.end())
+            break;
+        auto& entry = it->value;
+        entry.last_used = now;
+
+        if (entry.does_not_exist_until > now) {
+            dbgln_if(LOOKUPSERVER_DEBUG, "Negative cache hit: {} doesn't exist", current_name.as_string());
+            return Vector<Answer> {};
+        }
+
+        Vector<Answer> answers;
+        Optional<Name> canonical_name;
+        for (auto& answer : entry.answers) {
+            if (answer.has_expired())
+                continue;
+            if (answer.type() == record_type) {
+                dbgln_if(LOOKUPSERVER_DEBUG, "Cache hit: {} -> {}", current_name.as_string(), answer.record_data());
+                answers.append(answer);
+            } else if (answer.type() == RecordType::CNAME && !canonical_name.has_value()) {
+                canonical_name = Name { answer.record_data() };
+            }
+        }
+        if (!answers.is_empty())
+            return answers;
+
+        if (auto no_records_until = entry.has_no_records_until.get(record_type); no_records_until.has_value() && *no_records_until > now) {
+            dbgln_if(LOOKUPSERVER_DEBUG, "Negative cache hit: {} has no {} records", current_name.as_string(), record_type);
+            return Vector<Answer> {};
+        }
+
+        if (!canonical_name.has_value())
+            break;
+        current_name = canonical_name.release_value();
+    }
+
+    return {};
+}
+
+Vector<Answer> LookupServer::lookup_stale_in_cache(Name const& name, RecordType record_type) const
+{
+    auto now = time(nullptr);
+    Vector<Answer> answers;
+    auto it = m_lookup_cache.find(name);
+    if (it == m_lookup_cache.end())
+        return answers;
+
+    for (auto& answer : it->value.answers) {
+        if (answer.type() != record_type || answer.received_time() + answer.ttl() + s_max_stale_time <= now)
+            continue;
+        answers.empend(answer.name(), answer.type(), answer.class_code(), s_stale_answer_ttl, answer.record_data(), false);
+    }
+    return answers;
+}
+
 void LookupServer::put_in_cache(Answer const& answer)
 {
     if (answer.has_expired())
         return;
 
-    // Prevent the cache from growing too big.
-    // TODO: Evict least used entries.
-    if (m_lookup_cache.size() >= 256)
-        m_lookup_cache.remove(m_lookup_cache.begin());
+    auto& entry = ensure_cache_entry(answer.name());
+    if (answer.mdns_cache_flush()) {
+        auto now = time(nullptr);
 
-    auto it = m_lookup_cache.find(answer.name());
-    if (it == m_lookup_cache.end())
-        m_lookup_cache.set(answer.name(), { answer });
-    else {
-        if (answer.mdns_cache_flush()) {
-            auto now = time(nullptr);
+        entry.answers.remove_all_matching([&](Answer const& other_answer) {
+            if (other_answer.type() != answer.type() || other_answer.class_code() != answer.class_code())
+                return false;
 
-            it->value.remove_all_matching([&](Answer const& other_answer) {
-                if (other_answer.type() != answer.type() || other_answer.class_code() != answer.class_code())
-                    return false;
+            if (other_answer.received_time() >= now - 1)
+                return false;
 
-                if (other_answer.received_time() >= now - 1)
-                    return false;
+            dbgln_if(LOOKUPSERVER_DEBUG, "Removing cache entry: {}", other_answer.name());
+            return true;
+        });
+    }
 
-                dbgln_if(LOOKUPSERVER_DEBUG, "Removing cache entry: {}", other_answer.name());
-                return true;
-            });
-        }
-        it->value.append(answer);
+    // A fresh copy of a record replaces the one we had, instead of piling up next to it.
+    entry.answers.remove_all_matching([&](Answer const& other_answer) {
+        return other_answer.type() == answer.type() && other_answer.class_code() == answer.class_code() && other_answer.record_data() == answer.record_data();
+    });
+    entry.answers.append(answer);
+
+    entry.does_not_exist_until = 0;
+    entry.has_no_records_until.remove(answer.type());
+}
+
+void LookupServer::put_negative_answer_in_cache(Name const& name, Optional<RecordType> record_type, Optional<u32> ttl)
+{
+    if (!ttl.has_value())
+        return;
+
+    auto until = time(nullptr) + min(*ttl, s_max_negative_ttl);
+    auto& entry = ensure_cache_entry(name);
+    if (record_type.has_value()) {
+        entry.has_no_records_until.set(*record_type, until);
+    } else {
+        entry.does_not_exist_until = until;
+        entry.answers.clear();
     }
 }
 
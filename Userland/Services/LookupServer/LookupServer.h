@@ -26,11 +26,36 @@ public:
     static LookupServer& the();
     ErrorOr<Vector<Answer>> lookup(Name const& name, RecordType record_type);
 
+    struct CacheStatistics {
+        u32 hits { 0 };
+        u32 negative_hits { 0 };
+        u32 misses { 0 };
+        u32 stale_answers { 0 };
+    };
+    CacheStatistics const& cache_statistics() const { return m_cache_statistics; }
+    size_t cache_size() const { return m_lookup_cache.size(); }
+
 private:
     LookupServer();
 
+    struct CacheEntry {
+        Vector<Answer> answers;
+        // RFC 2308: Until when we know that the name doesn't exist at all (NXDOMAIN), or has no records of a type (NODATA).
+        time_t does_not_exist_until { 0 };
+        HashMap<RecordType, time_t> has_no_records_until;
+        time_t last_used { 0 };
+
+        bool is_worth_keeping(time_t now) const;
+    };
+
     void load_etc_hosts();
     void put_in_cache(Answer const&);
+    void put_negative_answer_in_cache(Name const&, Optional<RecordType>, Optional<u32> ttl);
+    CacheEntry& ensure_cache_entry(Name const&);
+    void evict_from_cache();
+    // An empty vector means that we know there are no such records, and no value that we don't know.
+    Optional<Vector<Answer>> lookup_in_cache(Name const&, RecordType);
+    Vector<Answer> lookup_stale_in_cache(Name const&, RecordType) const;
 
     ErrorOr<Vector<Answer>> lookup(Name const& hostname, DeprecatedString const& nameserver, bool& did_get_response, RecordType record_type, ShouldRandomizeCase = ShouldRandomizeCase::Yes);
 
@@ -40,7 +65,8 @@ private:
     Vector<DeprecatedString> m_nameservers;
     RefPtr<Core::FileWatcher> m_file_watcher;
     HashMap<Name, Vector<Answer>, Name::Traits> m_etc_hosts;
-    HashMap<Name, Vector<Answer>, Name::Traits> m_lookup_cache;
+    HashMap<Name, CacheEntry, Name::Traits> m_lookup_cache;
+    CacheStatistics m_cache_statistics;
 };
 
 }
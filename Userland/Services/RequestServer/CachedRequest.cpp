@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/EventLoop.h>
+#include <RequestServer/CachedRequest.h>
+
+namespace RequestServer {
+
+CachedRequest::CachedRequest(ConnectionFromClient& client, HttpCache::Entry entry, NonnullOwnPtr<Core::File>&& output_stream)
+    : Request(client, move(output_stream))
+    , m_entry(move(entry))
+{
+    // NOTE: The client has to know about the request before we can tell it anything about it.
+    Core::deferred_invoke([weak_this = make_weak_ptr()] {
+        if (weak_this)
+            weak_this->start();
+    });
+}
+
+void CachedRequest::start()
+{
+    set_status_code(m_entry.status_code);
+    set_response_headers(m_entry.response_headers);
+    send_cached_body(m_entry.body);
+}
+
+NonnullOwnPtr<CachedRequest> CachedRequest::create(ConnectionFromClient& client, HttpCache::Entry entry, NonnullOwnPtr<Core::File>&& output_stream)
+{
+    return adopt_own(*new CachedRequest(client, move(entry), move(output_stream)));
+}
+
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Weakable.h>
+#include <RequestServer/HttpCache.h>
+#include <RequestServer/Request.h>
+
+namespace RequestServer {
+
+// A request that is answered with a fresh response from the HttpCache, without going to the network.
+class CachedRequest final
+    : public Request
+    , public Weakable<CachedRequest> {
+public:
+    virtual ~CachedRequest() override = default;
+    static NonnullOwnPtr<CachedRequest> create(ConnectionFromClient&, HttpCache::Entry, NonnullOwnPtr<Core::File>&&);
+
+    virtual URL url() const override { return m_entry.url; }
+
+private:
+    explicit CachedRequest(ConnectionFromClient&, HttpCache::Entry, NonnullOwnPtr<Core::File>&&);
+
+    void start();
+
+    HttpCache::Entry m_entry;
+};
+
+}
@@ -13,6 +13,34 @@ namespace RequestServer::ConnectionCache {
 
 HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<Core::TCPSocket, Core::Socket>>>> g_tcp_connection_cache {};
 HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<TLS::TLSv12>>>> g_tls_connection_cache {};
+NonnullRefPtr<TLS::SessionCache> g_tls_session_cache = TLS::SessionCache::create();
+
+// How long idle connections to a host are kept around, for the hosts that told us.
+static HashMap<ConnectionKey, size_t> s_keep_alive_times;
+
+static size_t keep_alive_time_for(ConnectionKey const& key)
+{
+    return s_keep_alive_times.get({ key.hostname, key.port }).value_or(ConnectionKeepAliveTimeMilliseconds);
+}
+
+void did_receive_keep_alive_header(URL const& url, StringView header_value)
+{
+    for (auto parameter : header_value.split_view(',')) {
+        parameter = parameter.trim_whitespace();
+        if (!parameter.starts_with("timeout="sv, CaseSensitivity::CaseInsensitive))
+            continue;
+        auto seconds = parameter.substring_view("timeout="sv.length()).to_uint<size_t>();
+        if (!seconds.has_value())
+            return;
+
+        // Let go of the connection a little before the server does, so that a request doesn't race with it being closed.
+        auto milliseconds = min(*seconds * 1000, MaxConnectionKeepAliveTimeMilliseconds);
+        milliseconds = milliseconds > ConnectionKeepAliveMarginMilliseconds ? milliseconds - ConnectionKeepAliveMarginMilliseconds : 0;
+        dbgln_if(REQUESTSERVER_DEBUG, "Keeping idle connections to {}:{} around for {}ms", url.host(), url.port_or_default(), milliseconds);
+        s_keep_alive_times.set({ url.host(), url.port_or_default() }, milliseconds);
+        return;
+    }
+}
 
 void request_did_finish(URL const& url, Core::Socket const* socket)
 {
@@ -37,22 +65,36 @@ void request_did_finish(URL const& url, Core::Socket const* socket)
         }
 
         auto& connection = *connection_it;
-        if (connection->request_queue.is_empty()) {
-            Core::deferred_invoke([&connection, &cache_entry = *it->value, key = it->key, &cache] {
+        auto start_removal_timer = [&connection, &cache_entry = *it->value, key = it->key, &cache]() mutable {
+            connection->removal_timer->set_interval(static_cast<int>(keep_alive_time_for(key)));
+            connection->removal_timer->on_timeout = [ptr = connection.ptr(), &cache_entry, key = move(key), &cache]() mutable {
+                Core::deferred_invoke([&, key = move(key), ptr] {
+                    dbgln_if(REQUESTSERVER_DEBUG, "Removing no-longer-used connection {} (socket {})", ptr, ptr->socket);
+                    auto did_remove = cache_entry.remove_first_matching([&](auto& entry) { return entry == ptr; });
+                    VERIFY(did_remove);
+                    if (cache_entry.is_empty())
+                        cache.remove(key);
+                });
+            };
+            connection->removal_timer->start();
+        };
+
+        if (connection->http2) {
+            // The other requests on the connection are still going, and it has to keep listening for the server in any case.
+            Core::deferred_invoke([&connection, start_removal_timer = move(start_removal_timer)]() mutable {
+                if (connection->http2->stream_count() != 0)
+                    return;
+                connection->has_started = false;
+                connection->current_url = {};
+                start_removal_timer();
+            });
+        } else if (connection->request_queue.is_empty()) {
+            Core::deferred_invoke([&connection, start_removal_timer = move(start_removal_timer)]() mutable {
                 connection->socket->set_notifications_enabled(false);
                 connection->has_started = false;
                 connection->current_url = {};
                 connection->job_data = {};
-                connection->removal_timer->on_timeout = [ptr = connection.ptr(), &cache_entry, key = move(key), &cache]() mutable {
-                    Core::deferred_invoke([&, key = move(key), ptr] {
-                        dbgln_if(REQUESTSERVER_DEBUG, "Removing no-longer-used connection {} (socket {})", ptr, ptr->socket);
-                        auto did_remove = cache_entry.remove_first_matching([&](auto& entry) { return entry == ptr; });
-                        VERIFY(did_remove);
-                        if (cache_entry.is_empty())
-                            cache.remove(key);
-                    });
-                };
-                connection->removal_timer->start();
+                start_removal_timer();
             });
         } else {
             if (auto result = recreate_socket_if_needed(*connection, url); result.is_error()) {
@@ -87,6 +129,8 @@ void dump_jobs()
         for (auto& entry : *connection.value) {
             dbgln("  - Connection {} (started={}) (socket={})", &entry, entry.has_started, entry.socket);
             dbgln("    Currently loading {} ({} elapsed)", entry.current_url, entry.timer.is_valid() ? entry.timer.elapsed() : 0);
+            if (entry.http2)
+                dbgln("    HTTP/2 with {} streams", entry.http2->stream_count());
             dbgln("    Request Queue:");
             for (auto& job : entry.request_queue)
                 dbgln("    - {}", &job);
@@ -17,6 +17,7 @@
 #include <LibCore/NetworkJob.h>
 #include <LibCore/SOCKSProxyClient.h>
 #include <LibCore/Timer.h>
+#include <LibHTTP/Http2Connection.h>
 #include <LibTLS/TLSv12.h>
 
 namespace RequestServer {
@@ -99,6 +100,9 @@ struct Connection {
     Core::ElapsedTimer timer {};
     JobData job_data {};
     Proxy proxy {};
+    // Set if the server agreed to speak HTTP/2, in which case every request to it runs on this connection at once,
+    // and the request queue is never used.
+    RefPtr<HTTP::Http2Connection> http2 {};
 };
 
 struct ConnectionKey {
@@ -123,12 +127,19 @@ namespace RequestServer::ConnectionCache {
 
 extern HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<Core::TCPSocket, Core::Socket>>>> g_tcp_connection_cache;
 extern HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<TLS::TLSv12>>>> g_tls_connection_cache;
+extern NonnullRefPtr<TLS::SessionCache> g_tls_session_cache;
 
 void request_did_finish(URL const&, Core::Socket const*);
 void dump_jobs();
 
+// Servers say how long they keep idle connections open with "Keep-Alive: timeout=<seconds>", and there's no point in
+// keeping ours open for longer than that; We'd only end up sending requests into sockets that are about to be closed.
+void did_receive_keep_alive_header(URL const&, StringView header_value);
+
 constexpr static size_t MaxConcurrentConnectionsPerURL = 4;
 constexpr static size_t ConnectionKeepAliveTimeMilliseconds = 10'000;
+constexpr static size_t MaxConnectionKeepAliveTimeMilliseconds = 60'000;
+constexpr static size_t ConnectionKeepAliveMarginMilliseconds = 500;
 
 template<typename T>
 ErrorOr<void> recreate_socket_if_needed(T& connection, URL const& url)
@@ -145,6 +156,7 @@ ErrorOr<void> recreate_socket_if_needed(T& connection, URL const& url)
 
         if constexpr (IsSame<TLS::TLSv12, SocketType>) {
             TLS::Options options;
+            options.set_session_cache(g_tls_session_cache);
             options.set_alert_handler([&connection](TLS::AlertDescription alert) {
                 Core::NetworkJob::Error reason;
                 if (alert == TLS::AlertDescription::HandshakeFailure)
@@ -171,6 +183,21 @@ ErrorOr<void> recreate_socket_if_needed(T& connection, URL const& url)
     return {};
 }
 
+template<typename T>
+void start_job_on_http2_connection(T& connection, URL const& url, auto& job)
+{
+    dbgln_if(REQUESTSERVER_DEBUG, "Start request for url {} as a new HTTP/2 stream in {} - {}", url, &connection, connection.socket);
+    connection.removal_timer->stop();
+    if (!connection.has_started)
+        connection.timer.start();
+    connection.has_started = true;
+    connection.current_url = url;
+    if constexpr (requires { job.start_on_http2_connection(*connection.socket, *connection.http2); })
+        job.start_on_http2_connection(*connection.socket, *connection.http2);
+    else
+        job.start(*connection.socket);
+}
+
 decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job, Core::ProxyData proxy_data = {})
 {
     using CacheEntryType = RemoveCVReference<decltype(*cache.begin()->value)>;
@@ -179,12 +206,33 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
     Proxy proxy { proxy_data };
 
     using ReturnType = decltype(&sockets_for_url[0]);
-    auto it = sockets_for_url.find_if([](auto& connection) { return connection->request_queue.is_empty(); });
+    using ConnectionType = RemoveCVReference<decltype(cache.begin()->value->at(0))>;
+    constexpr bool is_tls = IsSame<TLS::TLSv12, typename ConnectionType::SocketType>;
+    bool can_use_http2 = is_tls && url.scheme() == "https"sv;
+
+    if (can_use_http2) {
+        for (auto& connection : sockets_for_url) {
+            if (connection.http2 && connection.http2->can_open_stream()) {
+                start_job_on_http2_connection(connection, url, job);
+                return &connection;
+            }
+        }
+    }
+
+    auto it = sockets_for_url.find_if([](auto& connection) { return connection->request_queue.is_empty() && !connection->http2; });
     auto did_add_new_connection = false;
     auto failed_to_find_a_socket = it.is_end();
     if (failed_to_find_a_socket && sockets_for_url.size() < ConnectionCache::MaxConcurrentConnectionsPerURL) {
-        using ConnectionType = RemoveCVReference<decltype(cache.begin()->value->at(0))>;
-        auto connection_result = proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url);
+        auto connection_result = [&] {
+            if constexpr (is_tls) {
+                auto options = TLS::Options {}.set_session_cache(g_tls_session_cache);
+                if (can_use_http2)
+                    options.set_alpn_protocols({ "h2", "http/1.1" });
+                return proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url, move(options));
+            } else {
+                return proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url);
+            }
+        }();
         if (connection_result.is_error()) {
             dbgln("ConnectionCache: Connection to {} failed: {}", url, connection_result.error());
             Core::deferred_invoke([&job] {
@@ -192,6 +240,9 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
             });
             return ReturnType { nullptr };
         }
+        bool negotiated_http2 = false;
+        if constexpr (is_tls)
+            negotiated_http2 = connection_result.value()->alpn() == "h2"sv;
         auto socket_result = Core::BufferedSocket<typename ConnectionType::StorageType>::create(connection_result.release_value());
         if (socket_result.is_error()) {
             dbgln("ConnectionCache: Failed to make a buffered socket for {}: {}", url, socket_result.error());
@@ -205,17 +256,37 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
             typename ConnectionType::QueueType {},
             Core::Timer::create_single_shot(ConnectionKeepAliveTimeMilliseconds, nullptr).release_value_but_fixme_should_propagate_errors()));
         sockets_for_url.last().proxy = move(proxy);
+        // Nobody minds an idle connection living a little longer, so let its removal share a wakeup with other timers.
+        sockets_for_url.last().removal_timer->set_precision(Core::TimerPrecision::Coarse);
         did_add_new_connection = true;
+
+        if (negotiated_http2) {
+            auto& connection = sockets_for_url.last();
+            auto http2_result = HTTP::Http2Connection::create(*connection.socket);
+            if (http2_result.is_error()) {
+                dbgln("ConnectionCache: Failed to start HTTP/2 with {}: {}", url, http2_result.error());
+                (void)sockets_for_url.take_last();
+                Core::deferred_invoke([&job] {
+                    job.fail(Core::NetworkJob::Error::ConnectionFailed);
+                });
+                return ReturnType { nullptr };
+            }
+            connection.http2 = http2_result.release_value();
+            start_job_on_http2_connection(connection, url, job);
+            return &connection;
+        }
     }
-    size_t index;
+    Optional<size_t> index;
     if (failed_to_find_a_socket) {
         if (did_add_new_connection) {
             index = sockets_for_url.size() - 1;
         } else {
             // Find the least backed-up connection (based on how many entries are in their request queue).
-            index = 0;
             auto min_queue_size = (size_t)-1;
             for (auto it = sockets_for_url.begin(); it != sockets_for_url.end(); ++it) {
+                // An HTTP/2 connection that can't take any more streams can't take queued requests either.
+                if (it->http2)
+                    continue;
                 if (auto queue_size = it->request_queue.size(); min_queue_size > queue_size) {
                     index = it.index();
                     min_queue_size = queue_size;
@@ -225,14 +296,14 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
     } else {
         index = it.index();
     }
-    if (sockets_for_url.is_empty()) {
+    if (!index.has_value()) {
         Core::deferred_invoke([&job] {
             job.fail(Core::NetworkJob::Error::ConnectionFailed);
         });
         return ReturnType { nullptr };
     }
 
-    auto& connection = sockets_for_url[index];
+    auto& connection = sockets_for_url[*index];
     if (!connection.has_started) {
         if (auto result = recreate_socket_if_needed(connection, url); result.is_error()) {
             dbgln("ConnectionCache: request failed to start, failed to make a socket: {}", result.error());
@@ -7,6 +7,7 @@
 #include <AK/Badge.h>
 #include <AK/NonnullOwnPtr.h>
 #include <LibCore/Proxy.h>
+#include <LibCore/System.h>
 #include <RequestServer/ConnectionFromClient.h>
 #include <RequestServer/Protocol.h>
 #include <RequestServer/Request.h>
@@ -37,6 +38,31 @@ Messages::RequestServer::IsSupportedProtocolResponse ConnectionFromClient::is_su
 }
 
 Messages::RequestServer::StartRequestResponse ConnectionFromClient::start_request(DeprecatedString const& method, URL const& url, IPC::Dictionary const& request_headers, ByteBuffer const& request_body, Core::ProxyData const& proxy_data)
+{
+    auto [id, fd] = start_request_with_body(method, url, request_headers, request_body.bytes(), proxy_data);
+    return { id, move(fd) };
+}
+
+Messages::RequestServer::StartRequestWithBodyStreamResponse ConnectionFromClient::start_request_with_body_stream(DeprecatedString const& method, URL const& url, IPC::Dictionary const& request_headers, IPC::File const& request_body, HTTP::HttpRequest::BodyEncoding const& request_body_encoding, Core::ProxyData const& proxy_data)
+{
+    // The body is read whenever there's more of it, so waiting for the client to write it must not hold up everything else.
+    auto body_fd = request_body.take_fd();
+    auto stream_or_error = [&]() -> ErrorOr<NonnullOwnPtr<Core::File>> {
+        auto flags = TRY(Core::System::fcntl(body_fd, F_GETFL));
+        TRY(Core::System::fcntl(body_fd, F_SETFL, flags | O_NONBLOCK));
+        return Core::File::adopt_fd(body_fd, Core::File::OpenMode::Read);
+    }();
+    if (stream_or_error.is_error()) {
+        dbgln("StartRequest: Could not use the request body stream: {}", stream_or_error.error());
+        (void)Core::System::close(body_fd);
+        return { -1, Optional<IPC::File> {} };
+    }
+
+    auto [id, fd] = start_request_with_body(method, url, request_headers, StreamedRequestBody { stream_or_error.release_value(), request_body_encoding }, proxy_data);
+    return { id, move(fd) };
+}
+
+ConnectionFromClient::StartedRequest ConnectionFromClient::start_request_with_body(DeprecatedString const& method, URL const& url, IPC::Dictionary const& request_headers, RequestBody body, Core::ProxyData const& proxy_data)
 {
     if (!url.is_valid()) {
         dbgln("StartRequest: Invalid URL requested: '{}'", url);
@@ -47,7 +73,7 @@ Messages::RequestServer::StartRequestResponse ConnectionFromClient::start_reques
         dbgln("StartRequest: No protocol handler for URL: '{}'", url);
         return { -1, Optional<IPC::File> {} };
     }
-    auto request = protocol->start_request(*this, method, url, request_headers.entries(), request_body, proxy_data);
+    auto request = protocol->start_request(*this, method, url, request_headers.entries(), move(body), proxy_data);
     if (!request) {
         dbgln("StartRequest: Protocol handler failed to start request: '{}'", url);
         return { -1, Optional<IPC::File> {} };
@@ -149,19 +175,26 @@ void ConnectionFromClient::ensure_connection(URL const& url, ::RequestServer::Ca
         return;
     }
 
+    auto has_connection = [&](auto& cache) {
+        auto it = cache.find({ url.host(), url.port_or_default() });
+        return it != cache.end() && !it->value->is_empty();
+    };
+
     if (cache_level == CacheLevel::ResolveOnly) {
+        // Whatever we're connected to has been resolved already.
+        if (has_connection(ConnectionCache::g_tcp_connection_cache) || has_connection(ConnectionCache::g_tls_connection_cache))
+            return;
         return Core::deferred_invoke([host = url.host()] {
             dbgln("EnsureConnection: DNS-preload for {}", host);
             (void)gethostbyname(host.characters());
         });
     }
 
-    auto& job = Job::ensure(url);
-    dbgln("EnsureConnection: Pre-connect to {}", url);
     auto do_preconnect = [&](auto& cache) {
-        auto it = cache.find({ url.host(), url.port_or_default() });
-        if (it == cache.end() || it->value->is_empty())
-            ConnectionCache::get_or_create_connection(cache, url, job);
+        if (has_connection(cache))
+            return;
+        dbgln("EnsureConnection: Pre-connect to {}", url);
+        ConnectionCache::get_or_create_connection(cache, url, Job::ensure(url));
     };
 
     if (url.scheme() == "http"sv)
@@ -9,6 +9,7 @@
 #include <AK/HashMap.h>
 #include <LibIPC/ConnectionFromClient.h>
 #include <RequestServer/Forward.h>
+#include <RequestServer/Protocol.h>
 #include <RequestServer/RequestClientEndpoint.h>
 #include <RequestServer/RequestServerEndpoint.h>
 
@@ -33,6 +34,13 @@ private:
 
     virtual Messages::RequestServer::IsSupportedProtocolResponse is_supported_protocol(DeprecatedString const&) override;
     virtual Messages::RequestServer::StartRequestResponse start_request(DeprecatedString const&, URL const&, IPC::Dictionary const&, ByteBuffer const&, Core::ProxyData const&) override;
+    virtual Messages::RequestServer::StartRequestWithBodyStreamResponse start_request_with_body_stream(DeprecatedString const&, URL const&, IPC::Dictionary const&, IPC::File const&, HTTP::HttpRequest::BodyEncoding const&, Core::ProxyData const&) override;
+
+    struct StartedRequest {
+        i32 id { -1 };
+        Optional<IPC::File> response_fd;
+    };
+    StartedRequest start_request_with_body(DeprecatedString const& method, URL const&, IPC::Dictionary const& request_headers, RequestBody, Core::ProxyData const&);
     virtual Messages::RequestServer::StopRequestResponse stop_request(i32) override;
     virtual Messages::RequestServer::SetCertificateResponse set_certificate(i32, DeprecatedString const&, DeprecatedString const&) override;
     virtual void ensure_connection(URL const& url, ::RequestServer::CacheLevel const& cache_level) override;
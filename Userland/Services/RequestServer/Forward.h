@@ -8,6 +8,7 @@
 
 namespace RequestServer {
 
+class CachedRequest;
 class ConnectionFromClient;
 class Request;
 class GeminiProtocol;
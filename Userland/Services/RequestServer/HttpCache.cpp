@@ -0,0 +1,514 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/CharacterTypes.h>
+#include <AK/Debug.h>
+#include <AK/Find.h>
+#include <AK/GenericLexer.h>
+#include <AK/JsonObject.h>
+#include <AK/QuickSort.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/StandardPaths.h>
+#include <LibCore/System.h>
+#include <RequestServer/HttpCache.h>
+#include <unistd.h>
+
+namespace RequestServer {
+
+// The bodies of all entries are kept below this size, by evicting the least recently used ones.
+static constexpr size_t cache_size_budget = 256 * MiB;
+
+// Responses with bigger bodies aren't worth pushing everything else out of the cache for.
+static constexpr size_t maximum_entry_size = cache_size_budget / 8;
+
+static OwnPtr<HttpCache> s_the;
+
+DeprecatedString HttpCache::default_directory()
+{
+    return DeprecatedString::formatted("{}/.cache/RequestServer", Core::StandardPaths::home_directory());
+}
+
+void HttpCache::initialize(DeprecatedString directory)
+{
+    VERIFY(!s_the);
+    s_the = adopt_own(*new HttpCache(move(directory)));
+}
+
+HttpCache* HttpCache::the()
+{
+    return s_the.ptr();
+}
+
+static Optional<DeprecatedString> find_header(RequestHeaders const& headers, StringView name)
+{
+    for (auto& it : headers) {
+        if (it.key.equals_ignoring_case(name))
+            return it.value;
+    }
+    return {};
+}
+
+// Returns the value of a Cache-Control directive (or an empty string if it has none), if the headers contain it.
+static Optional<DeprecatedString> cache_control_directive(HeaderMap const& headers, StringView name)
+{
+    auto cache_control = headers.get("Cache-Control"sv);
+    if (!cache_control.has_value())
+        return {};
+
+    for (auto directive : cache_control->split_view(',')) {
+        directive = directive.trim_whitespace();
+        auto name_end = directive.find('=');
+        if (!directive.substring_view(0, name_end.value_or(directive.length())).trim_whitespace().equals_ignoring_case(name))
+            continue;
+        if (!name_end.has_value())
+            return DeprecatedString::empty();
+        return directive.substring_view(*name_end + 1).trim_whitespace().trim("\""sv);
+    }
+    return {};
+}
+
+// https://httpwg.org/specs/rfc9110.html#http.date
+// NOTE: We only understand IMF-fixdate (e.g. "Sun, 06 Nov 1994 08:49:37 GMT"), which every sender has to use nowadays.
+static Optional<Time> parse_http_date(StringView date)
+{
+    static constexpr Array month_names { "Jan"sv, "Feb"sv, "Mar"sv, "Apr"sv, "May"sv, "Jun"sv, "Jul"sv, "Aug"sv, "Sep"sv, "Oct"sv, "Nov"sv, "Dec"sv };
+
+    GenericLexer lexer(date.trim_whitespace());
+    lexer.ignore_until(',');
+    if (!lexer.consume_specific(' '))
+        return {};
+
+    auto consume_number = [&](char delimiter) -> Optional<u32> {
+        auto number = lexer.consume_while(is_ascii_digit).to_uint();
+        if (!lexer.consume_specific(delimiter))
+            return {};
+        return number;
+    };
+
+    auto day = consume_number(' ');
+    auto month_name = lexer.consume(3);
+    if (!lexer.consume_specific(' '))
+        return {};
+    auto year = consume_number(' ');
+    auto hour = consume_number(':');
+    auto minute = consume_number(':');
+    auto second = consume_number(' ');
+    if (!lexer.consume_specific("GMT"sv) || !lexer.is_eof())
+        return {};
+
+    auto month = find_index(month_names.begin(), month_names.end(), month_name) + 1;
+    if (!day.has_value() || !year.has_value() || !hour.has_value() || !minute.has_value() || !second.has_value())
+        return {};
+    if (*day < 1 || *day > 31 || month > 12 || *hour > 23 || *minute > 59 || *second > 60)
+        return {};
+
+    return Time::from_timestamp(*year, month, *day, *hour, *minute, *second, 0);
+}
+
+static Optional<Time> header_date(HeaderMap const& headers, StringView name)
+{
+    auto value = headers.get(name);
+    if (!value.has_value())
+        return {};
+    return parse_http_date(*value);
+}
+
+// https://httpwg.org/specs/rfc9111.html#calculating.freshness.lifetime
+static Time freshness_lifetime(HeaderMap const& headers)
+{
+    if (auto max_age = cache_control_directive(headers, "max-age"sv); max_age.has_value())
+        return Time::from_seconds(max_age->to_uint().value_or(0));
+
+    auto date = header_date(headers, "Date"sv);
+    if (headers.contains("Expires"sv)) {
+        // NOTE: Invalid dates, like "0", mean that the response has already expired.
+        auto expires = header_date(headers, "Expires"sv);
+        if (!expires.has_value() || !date.has_value())
+            return {};
+        return *expires - *date;
+    }
+
+    // https://httpwg.org/specs/rfc9111.html#heuristic.freshness
+    // We use a tenth of the time since the resource was last modified, but at most a day.
+    if (auto last_modified = header_date(headers, "Last-Modified"sv); last_modified.has_value() && date.has_value())
+        return Time::from_seconds(min((*date - *last_modified).to_seconds() / 10, 24 * 60 * 60));
+
+    return {};
+}
+
+bool HttpCache::Entry::is_fresh() const
+{
+    if (cache_control_directive(response_headers, "no-cache"sv).has_value())
+        return false;
+
+    // https://httpwg.org/specs/rfc9111.html#age.calculations
+    auto age = Time::now_realtime() - response_time;
+    if (auto age_header = response_headers.get("Age"sv); age_header.has_value())
+        age += Time::from_seconds(age_header->to_uint().value_or(0));
+
+    return age < freshness_lifetime(response_headers);
+}
+
+bool HttpCache::Entry::can_be_revalidated() const
+{
+    return response_headers.contains("ETag"sv) || response_headers.contains("Last-Modified"sv);
+}
+
+void HttpCache::Entry::add_revalidation_headers(RequestHeaders& headers) const
+{
+    if (auto etag = response_headers.get("ETag"sv); etag.has_value())
+        headers.set("If-None-Match", *etag);
+    if (auto last_modified = response_headers.get("Last-Modified"sv); last_modified.has_value())
+        headers.set("If-Modified-Since", *last_modified);
+}
+
+bool HttpCache::can_use_cache_for(StringView method, URL const& url, RequestHeaders const& headers)
+{
+    if (!method.equals_ignoring_case("GET"sv) || (url.scheme() != "http"sv && url.scheme() != "https"sv))
+        return false;
+
+    // Responses to authorized requests may not be for everyone's eyes, and conditional or partial requests are
+    // the client's own business.
+    for (auto header : { "Authorization"sv, "If-None-Match"sv, "If-Modified-Since"sv, "If-Match"sv, "If-Unmodified-Since"sv, "If-Range"sv, "Range"sv }) {
+        if (find_header(headers, header).has_value())
+            return false;
+    }
+
+    auto cache_control = find_header(headers, "Cache-Control"sv);
+    return !cache_control.has_value() || !cache_control->contains("no-store"sv, CaseSensitivity::CaseInsensitive);
+}
+
+static Vector<DeprecatedString> vary_header_names(HeaderMap const& response_headers)
+{
+    Vector<DeprecatedString> names;
+    auto vary = response_headers.get("Vary"sv);
+    if (!vary.has_value())
+        return names;
+    for (auto name : vary->split_view(','))
+        names.append(name.trim_whitespace());
+    return names;
+}
+
+static JsonObject headers_to_json(HeaderMap const& headers)
+{
+    JsonObject object;
+    for (auto& it : headers)
+        object.set(it.key, it.value);
+    return object;
+}
+
+static HeaderMap headers_from_json(JsonObject const& object)
+{
+    HeaderMap headers;
+    object.for_each_member([&](auto& name, auto& value) {
+        if (value.is_string())
+            headers.set(name, value.as_string());
+    });
+    return headers;
+}
+
+static ErrorOr<void> write_metadata(DeprecatedString const& path, URL const& url, u32 status_code, HeaderMap const& response_headers, HeaderMap const& vary_request_headers, Time request_time, Time response_time, size_t body_size)
+{
+    JsonObject metadata;
+    metadata.set("url", url.serialize(URL::ExcludeFragment::Yes));
+    metadata.set("status_code", status_code);
+    metadata.set("response_headers", headers_to_json(response_headers));
+    metadata.set("vary_request_headers", headers_to_json(vary_request_headers));
+    metadata.set("request_time", request_time.to_milliseconds());
+    metadata.set("response_time", response_time.to_milliseconds());
+    metadata.set("body_size", static_cast<u64>(body_size));
+
+    // NOTE: We write a file of our own and move it over the old one, so other RequestServers never see half of it.
+    auto temporary_path = DeprecatedString::formatted("{}.{}.tmp", path, getpid());
+    {
+        auto file = TRY(Core::File::open(temporary_path, Core::File::OpenMode::Write | Core::File::OpenMode::Truncate, 0600));
+        TRY(file->write_entire_buffer(metadata.to_deprecated_string().bytes()));
+    }
+    TRY(Core::System::rename(temporary_path, path));
+    return {};
+}
+
+HttpCache::HttpCache(DeprecatedString directory)
+    : m_directory(move(directory))
+{
+    Core::DirIterator iterator(m_directory, Core::DirIterator::SkipDots);
+    while (iterator.has_next()) {
+        auto path = iterator.next_full_path();
+        if (!path.ends_with(".body"sv))
+            continue;
+        auto stat_or_error = Core::System::stat(path);
+        if (stat_or_error.is_error())
+            continue;
+        m_stored_bodies.set(path, { static_cast<size_t>(stat_or_error.value().st_size), stat_or_error.value().st_mtime });
+        m_total_size += stat_or_error.value().st_size;
+    }
+    dbgln_if(CACHE_DEBUG, "HttpCache: {} entries with {} bytes in {}", m_stored_bodies.size(), m_total_size, m_directory);
+    evict_until_under_budget();
+}
+
+DeprecatedString HttpCache::path_for(URL const& url, StringView extension) const
+{
+    return DeprecatedString::formatted("{}/{:08x}.{}", m_directory, url.serialize(URL::ExcludeFragment::Yes).hash(), extension);
+}
+
+Optional<HttpCache::Entry> HttpCache::find(URL const& url, RequestHeaders const& request_headers)
+{
+    auto metadata_file = Core::File::open(path_for(url, "meta"sv), Core::File::OpenMode::Read);
+    if (metadata_file.is_error())
+        return {};
+    auto contents = metadata_file.value()->read_until_eof();
+    if (contents.is_error())
+        return {};
+    auto json = JsonValue::from_string(contents.value());
+    if (json.is_error() || !json.value().is_object())
+        return {};
+    auto const& metadata = json.value().as_object();
+
+    // NOTE: Different URLs may end up in the same file, so this might not be the entry we're looking for.
+    if (metadata.get_deprecated_string("url"sv) != url.serialize(URL::ExcludeFragment::Yes))
+        return {};
+
+    auto response_headers = metadata.get_object("response_headers"sv);
+    auto vary_request_headers = metadata.get_object("vary_request_headers"sv);
+    if (!response_headers.has_value() || !vary_request_headers.has_value())
+        return {};
+
+    auto stored_response_headers = headers_from_json(*response_headers);
+    auto stored_vary_request_headers = headers_from_json(*vary_request_headers);
+    for (auto const& name : vary_header_names(stored_response_headers)) {
+        auto request_value = find_header(request_headers, name);
+        auto stored_value = stored_vary_request_headers.get(name);
+        if (request_value.has_value() != stored_value.has_value() || (request_value.has_value() && *request_value != *stored_value)) {
+            dbgln_if(CACHE_DEBUG, "HttpCache: Entry for {} varies on {}, which doesn't match", url, name);
+            return {};
+        }
+    }
+
+    // NOTE: Another RequestServer may be replacing the body right now, in which case it won't be the size we expect.
+    auto body_path = path_for(url, "body"sv);
+    auto body = Core::MappedFile::map(body_path);
+    if (body.is_error() || body.value()->size() != metadata.get_u64("body_size"sv).value_or(0))
+        return {};
+
+    did_use(body_path, body.value()->size());
+    return Entry {
+        .url = url,
+        .status_code = metadata.get_u32("status_code"sv).value_or(0),
+        .response_headers = move(stored_response_headers),
+        .vary_request_headers = move(stored_vary_request_headers),
+        .request_time = Time::from_milliseconds(metadata.get_i64("request_time"sv).value_or(0)),
+        .response_time = Time::from_milliseconds(metadata.get_i64("response_time"sv).value_or(0)),
+        .body = body.release_value(),
+    };
+}
+
+void HttpCache::did_revalidate(Entry& entry, HeaderMap const& headers, Time request_time)
+{
+    // https://httpwg.org/specs/rfc9111.html#freshening.responses
+    for (auto& it : headers) {
+        if (it.key.equals_ignoring_case("Content-Length"sv) || it.key.equals_ignoring_case("Transfer-Encoding"sv) || it.key.equals_ignoring_case("Set-Cookie"sv))
+            continue;
+        entry.response_headers.set(it.key, it.value);
+    }
+    entry.request_time = request_time;
+    entry.response_time = Time::now_realtime();
+
+    if (auto result = write_metadata(path_for(entry.url, "meta"sv), entry.url, entry.status_code, entry.response_headers, entry.vary_request_headers, entry.request_time, entry.response_time, entry.body->size()); result.is_error())
+        dbgln("HttpCache: Failed to update entry for {}: {}", entry.url, result.error());
+}
+
+void HttpCache::store(EntryWriter const& writer)
+{
+    auto body_path = path_for(writer.m_url, "body"sv);
+    auto metadata_path = path_for(writer.m_url, "meta"sv);
+
+    HeaderMap vary_request_headers;
+    for (auto const& name : vary_header_names(writer.m_response_headers)) {
+        if (auto value = writer.m_request_headers.get(name); value.has_value())
+            vary_request_headers.set(name, *value);
+    }
+
+    auto result = [&]() -> ErrorOr<void> {
+        TRY(Core::System::rename(writer.m_temporary_body_path, body_path));
+        TRY(write_metadata(metadata_path, writer.m_url, writer.m_status_code, writer.m_response_headers, vary_request_headers, writer.m_request_time, writer.m_response_time, writer.m_body_size));
+        return {};
+    }();
+    if (result.is_error()) {
+        dbgln("HttpCache: Failed to store entry for {}: {}", writer.m_url, result.error());
+        (void)Core::System::unlink(writer.m_temporary_body_path);
+        return;
+    }
+
+    dbgln_if(CACHE_DEBUG, "HttpCache: Stored {} bytes for {}", writer.m_body_size, writer.m_url);
+    did_use(body_path, writer.m_body_size);
+    evict_until_under_budget();
+}
+
+void HttpCache::did_use(DeprecatedString const& body_path, size_t size)
+{
+    // NOTE: The modification time of a body is when it was last used, so other RequestServers know as well.
+    (void)Core::System::utime(body_path, {});
+
+    auto& stored_body = m_stored_bodies.ensure(body_path);
+    m_total_size -= stored_body.size;
+    m_total_size += size;
+    stored_body = { size, time(nullptr) };
+}
+
+void HttpCache::evict_until_under_budget()
+{
+    if (m_total_size <= cache_size_budget)
+        return;
+
+    Vector<DeprecatedString> body_paths;
+    for (auto& it : m_stored_bodies)
+        body_paths.append(it.key);
+    quick_sort(body_paths, [&](auto& a, auto& b) {
+        return m_stored_bodies.get(a)->last_used < m_stored_bodies.get(b)->last_used;
+    });
+
+    for (auto& body_path : body_paths) {
+        if (m_total_size <= cache_size_budget)
+            break;
+        dbgln_if(CACHE_DEBUG, "HttpCache: Evicting {}", body_path);
+        auto metadata_path = DeprecatedString::formatted("{}.meta", body_path.substring_view(0, body_path.length() - ".body"sv.length()));
+        (void)Core::System::unlink(metadata_path);
+        (void)Core::System::unlink(body_path);
+        m_total_size -= m_stored_bodies.take(body_path)->size;
+    }
+}
+
+HttpCache::EntryWriter::EntryWriter(Stream& destination, URL url, RequestHeaders const& request_headers)
+    : m_destination(destination)
+    , m_url(move(url))
+    , m_request_time(Time::now_realtime())
+{
+    for (auto& it : request_headers)
+        m_request_headers.set(it.key, it.value);
+}
+
+HttpCache::EntryWriter::~EntryWriter()
+{
+    abort();
+}
+
+void HttpCache::EntryWriter::did_receive_headers(u32 status_code, HeaderMap const& headers)
+{
+    abort();
+
+    // NOTE: We only store complete responses, which rules out 206 (Partial Content) and friends.
+    if (status_code != 200)
+        return;
+    if (cache_control_directive(headers, "no-store"sv).has_value())
+        return;
+    if (auto vary = headers.get("Vary"sv); vary.has_value() && vary->contains('*'))
+        return;
+    if (auto content_length = headers.get("Content-Length"sv); content_length.has_value() && content_length->to_uint<u64>().value_or(0) > maximum_entry_size)
+        return;
+
+    // There's no point in storing a response we can neither reuse nor revalidate.
+    bool has_freshness = headers.contains("Expires"sv) || cache_control_directive(headers, "max-age"sv).has_value();
+    if (!has_freshness && !headers.contains("ETag"sv) && !headers.contains("Last-Modified"sv))
+        return;
+
+    auto* cache = HttpCache::the();
+    if (!cache)
+        return;
+
+    m_temporary_body_path = DeprecatedString::formatted("{}.{}.tmp", cache->path_for(m_url, "body"sv), getpid());
+    auto body_file = Core::File::open(m_temporary_body_path, Core::File::OpenMode::Write | Core::File::OpenMode::Truncate, 0600);
+    if (body_file.is_error()) {
+        dbgln("HttpCache: Failed to open {}: {}", m_temporary_body_path, body_file.error());
+        m_temporary_body_path = {};
+        return;
+    }
+    m_body_file = body_file.release_value();
+    m_body_size = 0;
+    m_status_code = status_code;
+    m_response_time = Time::now_realtime();
+
+    // NOTE: Cookies are for the client that received the response, so we never hand them out again.
+    m_response_headers = headers;
+    m_response_headers.remove("Set-Cookie"sv);
+}
+
+ErrorOr<size_t> HttpCache::EntryWriter::write(ReadonlyBytes bytes)
+{
+    auto written = TRY(m_destination.write(bytes));
+    if (m_body_file) {
+        m_body_size += written;
+        if (m_body_size > maximum_entry_size || m_body_file->write_entire_buffer(bytes.trim(written)).is_error())
+            abort();
+    }
+    return written;
+}
+
+void HttpCache::EntryWriter::did_finish(bool success)
+{
+    if (!m_body_file)
+        return;
+    if (!success || m_body_size == 0) {
+        abort();
+        return;
+    }
+
+    m_body_file = nullptr;
+    if (auto* cache = HttpCache::the())
+        cache->store(*this);
+    m_temporary_body_path = {};
+}
+
+void HttpCache::EntryWriter::abort()
+{
+    m_body_file = nullptr;
+    if (!m_temporary_body_path.is_null()) {
+        (void)Core::System::unlink(m_temporary_body_path);
+        m_temporary_body_path = {};
+    }
+}
+
+HttpCache::BodyWriter::BodyWriter(int fd, NonnullRefPtr<Core::MappedFile> body, Function<void(bool success)> on_finish)
+    : m_fd(fd)
+    , m_body(move(body))
+    , m_notifier(Core::Notifier::construct(fd, Core::Notifier::Event::Write))
+    , m_on_finish(move(on_finish))
+{
+    m_notifier->on_ready_to_write = [this] { write_some(); };
+}
+
+void HttpCache::BodyWriter::write_some()
+{
+    while (m_offset < m_body->size()) {
+        auto result = Core::System::write(m_fd, m_body->bytes().slice(m_offset));
+        if (result.is_error()) {
+            if (result.error().code() == EINTR)
+                continue;
+            // NOTE: The pipe is full, so we continue once the client has read some of it.
+            if (result.error().code() == EAGAIN)
+                return;
+            finish(false);
+            return;
+        }
+        m_offset += static_cast<size_t>(result.value());
+    }
+    finish(true);
+}
+
+void HttpCache::BodyWriter::finish(bool success)
+{
+    m_notifier->set_enabled(false);
+
+    // NOTE: Finishing gets rid of the request, and us along with it, so we don't do that from inside the notifier.
+    Core::deferred_invoke([weak_this = make_weak_ptr(), success] {
+        if (!weak_this)
+            return;
+        auto on_finish = move(weak_this->m_on_finish);
+        on_finish(success);
+    });
+}
+
+}
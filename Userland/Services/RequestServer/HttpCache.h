@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/DeprecatedString.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/OwnPtr.h>
+#include <AK/Stream.h>
+#include <AK/Time.h>
+#include <AK/URL.h>
+#include <AK/WeakPtr.h>
+#include <AK/Weakable.h>
+#include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
+#include <LibCore/Notifier.h>
+
+namespace RequestServer {
+
+using RequestHeaders = HashMap<DeprecatedString, DeprecatedString>;
+using HeaderMap = HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits>;
+
+// A persistent cache of HTTP responses to GET requests, kept in files that every RequestServer shares.
+// NOTE: We only keep the latest response for each URL. If it varies on request headers that don't match
+//       those of a new request, that's a miss, and the new response replaces it.
+class HttpCache {
+public:
+    static DeprecatedString default_directory();
+
+    static void initialize(DeprecatedString directory);
+    static HttpCache* the();
+
+    struct Entry {
+        URL url;
+        u32 status_code { 0 };
+        HeaderMap response_headers;
+        HeaderMap vary_request_headers;
+        Time request_time;
+        Time response_time;
+        NonnullRefPtr<Core::MappedFile> body;
+
+        bool is_fresh() const;
+        bool can_be_revalidated() const;
+        void add_revalidation_headers(RequestHeaders&) const;
+    };
+
+    static bool can_use_cache_for(StringView method, URL const&, RequestHeaders const&);
+    Optional<Entry> find(URL const&, RequestHeaders const&);
+
+    // Updates an entry with the headers of a 304 (Not Modified) response to revalidating it.
+    void did_revalidate(Entry&, HeaderMap const&, Time request_time);
+
+    // Sits between a job and the pipe to the client, copying the body of a cacheable response into the cache.
+    class EntryWriter final : public Stream {
+        friend class HttpCache;
+
+    public:
+        EntryWriter(Stream& destination, URL, RequestHeaders const&);
+        virtual ~EntryWriter() override;
+
+        Time request_time() const { return m_request_time; }
+
+        void did_receive_headers(u32 status_code, HeaderMap const&);
+        void did_finish(bool success);
+
+        virtual ErrorOr<Bytes> read(Bytes) override { return Error::from_errno(EBADF); }
+        virtual ErrorOr<size_t> write(ReadonlyBytes) override;
+        virtual bool is_eof() const override { return m_destination.is_eof(); }
+        virtual bool is_open() const override { return m_destination.is_open(); }
+        virtual void close() override { m_destination.close(); }
+
+    private:
+        void abort();
+
+        Stream& m_destination;
+        URL m_url;
+        HeaderMap m_request_headers;
+        Time m_request_time;
+        Time m_response_time;
+
+        u32 m_status_code { 0 };
+        HeaderMap m_response_headers;
+        DeprecatedString m_temporary_body_path;
+        OwnPtr<Core::File> m_body_file;
+        size_t m_body_size { 0 };
+    };
+
+    // Writes a cached body into a request's pipe as fast as the client reads it.
+    class BodyWriter final : public Weakable<BodyWriter> {
+    public:
+        BodyWriter(int fd, NonnullRefPtr<Core::MappedFile> body, Function<void(bool success)> on_finish);
+
+    private:
+        void write_some();
+        void finish(bool success);
+
+        int m_fd { -1 };
+        NonnullRefPtr<Core::MappedFile> m_body;
+        size_t m_offset { 0 };
+        NonnullRefPtr<Core::Notifier> m_notifier;
+        Function<void(bool success)> m_on_finish;
+    };
+
+private:
+    explicit HttpCache(DeprecatedString directory);
+
+    DeprecatedString path_for(URL const&, StringView extension) const;
+    void store(EntryWriter const&);
+    void did_use(DeprecatedString const& body_path, size_t size);
+    void evict_until_under_budget();
+
+    DeprecatedString m_directory;
+
+    struct StoredBody {
+        size_t size { 0 };
+        time_t last_used { 0 };
+    };
+    HashMap<DeprecatedString, StoredBody> m_stored_bodies;
+    size_t m_total_size { 0 };
+};
+
+}
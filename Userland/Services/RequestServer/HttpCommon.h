@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/Debug.h>
 #include <AK/DeprecatedString.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
@@ -14,8 +15,10 @@
 #include <AK/OwnPtr.h>
 #include <AK/Types.h>
 #include <LibHTTP/HttpRequest.h>
+#include <RequestServer/CachedRequest.h>
 #include <RequestServer/ConnectionCache.h>
 #include <RequestServer/ConnectionFromClient.h>
+#include <RequestServer/HttpCache.h>
 #include <RequestServer/Request.h>
 
 namespace RequestServer::Detail {
@@ -24,15 +27,38 @@ template<typename TSelf, typename TJob>
 void init(TSelf* self, TJob job)
 {
     job->on_headers_received = [self](auto& headers, auto response_code) {
+        if (auto& entry = self->cache_entry_to_revalidate(); entry.has_value()) {
+            if (response_code.has_value() && response_code.value() == 304) {
+                HttpCache::the()->did_revalidate(*entry, headers, self->cache_entry_writer()->request_time());
+                self->set_status_code(entry->status_code);
+                self->set_response_headers(entry->response_headers);
+                return;
+            }
+            entry.clear();
+        }
+        if (auto* writer = self->cache_entry_writer(); writer && response_code.has_value())
+            writer->did_receive_headers(response_code.value(), headers);
+
         if (response_code.has_value())
             self->set_status_code(response_code.value());
         self->set_response_headers(headers);
     };
 
     job->on_finish = [self](bool success) {
+        if (auto* response = self->job().response(); response && success) {
+            if (auto keep_alive = response->headers().get("Keep-Alive"); keep_alive.has_value())
+                ConnectionCache::did_receive_keep_alive_header(self->job().url(), *keep_alive);
+        }
         Core::deferred_invoke([url = self->job().url(), socket = self->job().socket()] {
             ConnectionCache::request_did_finish(url, socket);
         });
+
+        // The server told us that our cached response is still good, so that's what the client gets.
+        if (auto& entry = self->cache_entry_to_revalidate(); entry.has_value() && success) {
+            self->send_cached_body(entry->body);
+            return;
+        }
+
         if (auto* response = self->job().response()) {
             self->set_status_code(response->code());
             self->set_response_headers(response->headers());
@@ -44,6 +70,9 @@ void init(TSelf* self, TJob job)
         if (!self->total_size().has_value())
             self->did_progress(self->downloaded_size(), self->downloaded_size());
 
+        if (auto* writer = self->cache_entry_writer())
+            writer->did_finish(success);
+
         self->did_finish(success);
     };
     job->on_progress = [self](Optional<u32> total, u32 current) {
@@ -61,7 +90,7 @@ void init(TSelf* self, TJob job)
 }
 
 template<typename TBadgedProtocol, typename TPipeResult>
-OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ConnectionFromClient& client, DeprecatedString const& method, const URL& url, HashMap<DeprecatedString, DeprecatedString> const& headers, ReadonlyBytes body, TPipeResult&& pipe_result, Core::ProxyData proxy_data = {})
+OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ConnectionFromClient& client, DeprecatedString const& method, const URL& url, HashMap<DeprecatedString, DeprecatedString> const& headers, RequestBody body, TPipeResult&& pipe_result, Core::ProxyData proxy_data = {})
 {
     using TJob = typename TBadgedProtocol::Type::JobType;
     using TRequest = typename TBadgedProtocol::Type::RequestType;
@@ -90,17 +119,58 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ConnectionFromClient&
     else
         request.set_method(HTTP::HttpRequest::Method::GET);
     request.set_url(url);
-    request.set_headers(headers);
 
-    auto allocated_body_result = ByteBuffer::copy(body);
-    if (allocated_body_result.is_error())
+    auto* cache = HttpCache::the();
+    bool can_use_cache = cache && HttpCache::can_use_cache_for(method, url, headers);
+    Optional<HttpCache::Entry> cache_entry;
+    if (can_use_cache)
+        cache_entry = cache->find(url, headers);
+
+    if (cache_entry.has_value() && cache_entry->is_fresh()) {
+        dbgln_if(CACHE_DEBUG, "HttpCache: Using fresh entry for {}", url);
+        auto output_stream = MUST(Core::File::adopt_fd(pipe_result.value().write_fd, Core::File::OpenMode::Write));
+        auto cached_request = CachedRequest::create(client, cache_entry.release_value(), move(output_stream));
+        cached_request->set_request_fd(pipe_result.value().read_fd);
+        return cached_request;
+    }
+
+    if (cache_entry.has_value() && cache_entry->can_be_revalidated()) {
+        dbgln_if(CACHE_DEBUG, "HttpCache: Revalidating entry for {}", url);
+        auto conditional_headers = headers;
+        cache_entry->add_revalidation_headers(conditional_headers);
+        request.set_headers(conditional_headers);
+    } else {
+        cache_entry.clear();
+        request.set_headers(headers);
+    }
+
+    OwnPtr<Core::File> body_stream;
+    auto body_result = body.visit(
+        [&](ReadonlyBytes bytes) -> ErrorOr<void> {
+            request.set_body(TRY(ByteBuffer::copy(bytes)));
+            return {};
+        },
+        [&](StreamedRequestBody& streamed_body) -> ErrorOr<void> {
+            request.set_streamed_body(streamed_body.encoding);
+            body_stream = move(streamed_body.stream);
+            return {};
+        });
+    if (body_result.is_error())
         return {};
-    request.set_body(allocated_body_result.release_value());
 
     auto output_stream = MUST(Core::File::adopt_fd(pipe_result.value().write_fd, Core::File::OpenMode::Write));
-    auto job = TJob::construct(move(request), *output_stream);
+    OwnPtr<HttpCache::EntryWriter> cache_entry_writer;
+    if (can_use_cache)
+        cache_entry_writer = make<HttpCache::EntryWriter>(*output_stream, url, headers);
+    auto job = TJob::construct(move(request), cache_entry_writer ? static_cast<Stream&>(*cache_entry_writer) : *output_stream);
+    if (body_stream)
+        job->set_request_body_stream(body_stream.release_nonnull());
     auto protocol_request = TRequest::create_with_job(forward<TBadgedProtocol>(protocol), client, (TJob&)*job, move(output_stream));
     protocol_request->set_request_fd(pipe_result.value().read_fd);
+    if (cache_entry_writer)
+        protocol_request->set_cache_entry_writer(cache_entry_writer.release_nonnull());
+    if (cache_entry.has_value())
+        protocol_request->set_cache_entry_to_revalidate(cache_entry.release_value());
 
     if constexpr (IsSame<typename TBadgedProtocol::Type, HttpsProtocol>)
         ConnectionCache::get_or_create_connection(ConnectionCache::g_tls_connection_cache, url, *job, proxy_data);
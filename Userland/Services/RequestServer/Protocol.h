@@ -8,17 +8,29 @@
 
 #include <AK/RefPtr.h>
 #include <AK/URL.h>
+#include <AK/Variant.h>
+#include <LibCore/File.h>
 #include <LibCore/Proxy.h>
+#include <LibHTTP/HttpRequest.h>
 #include <RequestServer/Forward.h>
 
 namespace RequestServer {
 
+// A body that's read from the file (usually a pipe the client is still writing to) while the request is being sent,
+// rather than being handed over all at once.
+struct StreamedRequestBody {
+    NonnullOwnPtr<Core::File> stream;
+    HTTP::HttpRequest::BodyEncoding encoding { HTTP::HttpRequest::BodyEncoding::Identity };
+};
+
+using RequestBody = Variant<ReadonlyBytes, StreamedRequestBody>;
+
 class Protocol {
 public:
     virtual ~Protocol();
 
     DeprecatedString const& name() const { return m_name; }
-    virtual OwnPtr<Request> start_request(ConnectionFromClient&, DeprecatedString const& method, const URL&, HashMap<DeprecatedString, DeprecatedString> const& headers, ReadonlyBytes body, Core::ProxyData proxy_data = {}) = 0;
+    virtual OwnPtr<Request> start_request(ConnectionFromClient&, DeprecatedString const& method, const URL&, HashMap<DeprecatedString, DeprecatedString> const& headers, RequestBody body, Core::ProxyData proxy_data = {}) = 0;
 
     static Protocol* find_by_name(DeprecatedString const&);
 
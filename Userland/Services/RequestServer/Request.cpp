@@ -46,6 +46,15 @@ void Request::did_progress(Optional<u32> total_size, u32 downloaded_size)
     m_client.did_progress_request({}, *this);
 }
 
+void Request::send_cached_body(NonnullRefPtr<Core::MappedFile> body)
+{
+    auto size = body->size();
+    m_cached_body_writer = make<HttpCache::BodyWriter>(m_output_stream->fd(), move(body), [this, size](bool success) {
+        did_progress(static_cast<u32>(size), static_cast<u32>(size));
+        did_finish(success);
+    });
+}
+
 void Request::did_request_certificates()
 {
     m_client.did_request_certificates({}, *this);
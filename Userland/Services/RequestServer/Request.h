@@ -12,6 +12,7 @@
 #include <AK/RefCounted.h>
 #include <AK/URL.h>
 #include <RequestServer/Forward.h>
+#include <RequestServer/HttpCache.h>
 
 namespace RequestServer {
 
@@ -42,6 +43,16 @@ public:
     void set_downloaded_size(size_t size) { m_downloaded_size = size; }
     Core::File const& output_stream() const { return *m_output_stream; }
 
+    HttpCache::EntryWriter* cache_entry_writer() { return m_cache_entry_writer.ptr(); }
+    void set_cache_entry_writer(NonnullOwnPtr<HttpCache::EntryWriter> writer) { m_cache_entry_writer = move(writer); }
+
+    // The cached response we asked the server about with a conditional request, which we use if it's still fine.
+    Optional<HttpCache::Entry>& cache_entry_to_revalidate() { return m_cache_entry_to_revalidate; }
+    void set_cache_entry_to_revalidate(HttpCache::Entry entry) { m_cache_entry_to_revalidate = move(entry); }
+
+    bool is_sending_cached_body() const { return m_cached_body_writer; }
+    void send_cached_body(NonnullRefPtr<Core::MappedFile>);
+
 protected:
     explicit Request(ConnectionFromClient&, NonnullOwnPtr<Core::File>&&);
 
@@ -54,6 +65,9 @@ private:
     size_t m_downloaded_size { 0 };
     NonnullOwnPtr<Core::File> m_output_stream;
     HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> m_response_headers;
+    OwnPtr<HttpCache::EntryWriter> m_cache_entry_writer;
+    Optional<HttpCache::Entry> m_cache_entry_to_revalidate;
+    OwnPtr<HttpCache::BodyWriter> m_cached_body_writer;
 };
 
 }
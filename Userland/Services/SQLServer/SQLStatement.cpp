@@ -6,6 +6,7 @@
 
 #include <LibCore/Object.h>
 #include <LibSQL/AST/Parser.h>
+#include <LibSQL/AST/SelectCursor.h>
 #include <SQLServer/ConnectionFromClient.h>
 #include <SQLServer/DatabaseConnection.h>
 #include <SQLServer/SQLStatement.h>
@@ -15,6 +16,10 @@ namespace SQLServer {
 static HashMap<SQL::StatementID, NonnullRefPtr<SQLStatement>> s_statements;
 static SQL::StatementID s_next_statement_id = 0;
 
+// Results are sent this many rows at a time, giving the event loop a turn in between, so that a large result is never
+// held in memory all at once and doesn't keep everyone else waiting while it's being sent.
+static constexpr size_t max_rows_per_batch = 64;
+
 RefPtr<SQLStatement> SQLStatement::statement_for(SQL::StatementID statement_id)
 {
     if (s_statements.contains(statement_id))
@@ -72,6 +77,18 @@ Optional<SQL::ExecutionID> SQLStatement::execute(Vector<SQL::Value> placeholder_
     m_ongoing_executions.set(execution_id);
 
     deferred_invoke([this, placeholder_values = move(placeholder_values), execution_id] {
+        if (is<SQL::AST::Select>(*m_statement)) {
+            auto cursor = SQL::AST::SelectCursor::create(connection()->database(), static_cast<SQL::AST::Select const&>(*m_statement), placeholder_values);
+            if (cursor.is_error()) {
+                m_ongoing_executions.remove(execution_id);
+                report_error(cursor.release_error(), execution_id);
+                return;
+            }
+
+            next(execution_id, cursor.release_value(), 0);
+            return;
+        }
+
         auto execution_result = m_statement->execute(connection()->database(), placeholder_values);
         m_ongoing_executions.remove(execution_id);
 
@@ -131,8 +148,15 @@ void SQLStatement::next(SQL::ExecutionID execution_id, SQL::ResultSet result, si
     }
 
     if (!result.is_empty()) {
-        auto result_row = result.take_first();
-        client_connection->async_next_result(statement_id(), execution_id, result_row.row.take_data());
+        auto batch_size = min(result.size(), max_rows_per_batch);
+
+        Vector<Vector<SQL::Value>> rows;
+        rows.ensure_capacity(batch_size);
+        for (size_t i = 0; i < batch_size; ++i)
+            rows.unchecked_append(result[i].row.take_data());
+        result.remove(0, batch_size);
+
+        client_connection->async_next_results(statement_id(), execution_id, move(rows));
 
         deferred_invoke([this, execution_id, result = move(result), result_size]() mutable {
             next(execution_id, move(result), result_size);
@@ -142,4 +166,53 @@ void SQLStatement::next(SQL::ExecutionID execution_id, SQL::ResultSet result, si
     }
 }
 
+
+void SQLStatement::next(SQL::ExecutionID execution_id, NonnullOwnPtr<SQL::AST::SelectCursor> cursor, size_t sent_rows)
+{
+    auto client_connection = ConnectionFromClient::client_connection_for(connection()->client_id());
+    if (!client_connection) {
+        m_ongoing_executions.remove(execution_id);
+        warnln("Cannot yield next result. Client disconnected");
+        return;
+    }
+
+    Vector<Vector<SQL::Value>> rows;
+    while (rows.size() < max_rows_per_batch) {
+        auto row = cursor->next();
+        if (row.is_error()) {
+            m_ongoing_executions.remove(execution_id);
+            report_error(row.release_error(), execution_id);
+            return;
+        }
+
+        if (!row.value().has_value())
+            break;
+        rows.append(row.value()->take_data());
+    }
+
+    auto is_exhausted = rows.size() < max_rows_per_batch;
+
+    // Whether there are any results at all isn't known before the first batch has been produced.
+    if (sent_rows == 0) {
+        client_connection->async_execution_success(statement_id(), execution_id, cursor->column_names(), !rows.is_empty(), 0, 0, 0);
+        if (rows.is_empty()) {
+            m_ongoing_executions.remove(execution_id);
+            return;
+        }
+    }
+
+    sent_rows += rows.size();
+    client_connection->async_next_results(statement_id(), execution_id, move(rows));
+
+    if (is_exhausted) {
+        m_ongoing_executions.remove(execution_id);
+        client_connection->async_results_exhausted(statement_id(), execution_id, sent_rows);
+        return;
+    }
+
+    deferred_invoke([this, execution_id, cursor = move(cursor), sent_rows]() mutable {
+        next(execution_id, move(cursor), sent_rows);
+    });
+}
+
 }
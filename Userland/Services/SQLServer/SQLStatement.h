@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/DeprecatedString.h>
+#include <AK/NonnullOwnPtr.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/Vector.h>
 #include <LibCore/Object.h>
@@ -36,6 +37,7 @@ private:
 
     bool should_send_result_rows(SQL::ResultSet const& result) const;
     void next(SQL::ExecutionID execution_id, SQL::ResultSet result, size_t result_size);
+    void next(SQL::ExecutionID execution_id, NonnullOwnPtr<SQL::AST::SelectCursor>, size_t sent_rows);
     void report_error(SQL::Result, SQL::ExecutionID execution_id);
 
     SQL::StatementID m_statement_id { 0 };
@@ -294,6 +294,11 @@ static ErrorOr<void> populate_devtmpfs_devices_based_on_devctl()
             }
             break;
         }
+        case 31: {
+            if (!is_block_device)
+                TRY(create_devtmpfs_char_device("/dev/tracepoints"sv, 0600, 31, minor_number));
+            break;
+        }
         case 3: {
             if (is_block_device) {
                 auto name = TRY(String::formatted("/dev/hd{}", offset_character_with_number('a', minor_number)));
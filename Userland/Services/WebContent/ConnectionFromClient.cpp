@@ -43,6 +43,8 @@ ConnectionFromClient::ConnectionFromClient(NonnullOwnPtr<Core::LocalSocket> sock
     , m_page_host(PageHost::create(*this))
 {
     m_paint_flush_timer = Web::Platform::Timer::create_single_shot(0, [this] { flush_pending_paint_requests(); });
+    // Input events and paint requests come in at a high rate, so they're worth keeping off the socket.
+    set_accepts_shared_ring_transport(true);
 }
 
 void ConnectionFromClient::die()
@@ -103,7 +105,7 @@ void ConnectionFromClient::load_url(const URL& url)
     page().load(url);
 }
 
-void ConnectionFromClient::load_html(DeprecatedString const& html, const URL& url)
+void ConnectionFromClient::load_html(StringView html, const URL& url)
 {
     dbgln_if(SPAM_DEBUG, "handle: WebContentServer::LoadHTML: html={}, url={}", html, url);
     page().load_html(html, url);
@@ -117,11 +119,15 @@ void ConnectionFromClient::set_viewport_rect(Gfx::IntRect const& rect)
 
 void ConnectionFromClient::add_backing_store(i32 backing_store_id, Gfx::ShareableBitmap const& bitmap)
 {
+    if (m_last_painted_frame.has_value() && m_last_painted_frame->bitmap_id == backing_store_id)
+        m_last_painted_frame.clear();
     m_backing_stores.set(backing_store_id, *bitmap.bitmap());
 }
 
 void ConnectionFromClient::remove_backing_store(i32 backing_store_id)
 {
+    if (m_last_painted_frame.has_value() && m_last_painted_frame->bitmap_id == backing_store_id)
+        m_last_painted_frame.clear();
     m_backing_stores.remove(backing_store_id);
     m_pending_paint_requests.remove_all_matching([backing_store_id](auto& pending_repaint_request) { return pending_repaint_request.bitmap_id == backing_store_id; });
 }
@@ -149,7 +155,17 @@ void ConnectionFromClient::paint(Gfx::IntRect const& content_rect, i32 backing_s
 void ConnectionFromClient::flush_pending_paint_requests()
 {
     for (auto& pending_paint : m_pending_paint_requests) {
-        m_page_host->paint(pending_paint.content_rect.to_type<Web::DevicePixels>(), *pending_paint.bitmap);
+        Gfx::Bitmap const* previous_frame = nullptr;
+        Gfx::IntRect previous_content_rect;
+        if (m_last_painted_frame.has_value() && m_last_painted_frame->bitmap_id != pending_paint.bitmap_id) {
+            if (auto it = m_backing_stores.find(m_last_painted_frame->bitmap_id); it != m_backing_stores.end()) {
+                previous_frame = it->value.ptr();
+                previous_content_rect = m_last_painted_frame->content_rect;
+            }
+        }
+
+        m_page_host->paint_frame(pending_paint.content_rect.to_type<Web::DevicePixels>(), *pending_paint.bitmap, previous_content_rect.to_type<Web::DevicePixels>(), previous_frame);
+        m_last_painted_frame = PaintedFrame { pending_paint.content_rect, pending_paint.bitmap_id };
         async_did_paint(pending_paint.content_rect, pending_paint.bitmap_id);
     }
     m_pending_paint_requests.clear();
@@ -195,7 +211,7 @@ void ConnectionFromClient::report_finished_handling_input_event(bool event_was_h
     async_did_finish_handling_input_event(event_was_handled);
 }
 
-void ConnectionFromClient::debug_request(DeprecatedString const& request, DeprecatedString const& argument)
+void ConnectionFromClient::debug_request(StringView request, StringView argument)
 {
     if (request == "dump-dom-tree") {
         if (auto* doc = page().top_level_browsing_context().active_document())
@@ -227,6 +243,16 @@ void ConnectionFromClient::debug_request(DeprecatedString const& request, Deprec
         }
     }
 
+    if (request == "dump-style-memory") {
+        if (auto* doc = page().top_level_browsing_context().active_document())
+            Web::dump_style_memory(*doc);
+    }
+
+    if (request == "dump-rendering-timings") {
+        if (auto* doc = page().top_level_browsing_context().active_document())
+            Web::dump_rendering_timings(*doc);
+    }
+
     if (request == "collect-garbage") {
         Web::Bindings::main_thread_vm().heap().collect_garbage(JS::Heap::CollectionType::CollectGarbage, true);
     }
@@ -52,7 +52,7 @@ private:
     virtual void update_system_fonts(DeprecatedString const&, DeprecatedString const&, DeprecatedString const&) override;
     virtual void update_screen_rects(Vector<Gfx::IntRect> const&, u32) override;
     virtual void load_url(URL const&) override;
-    virtual void load_html(DeprecatedString const&, URL const&) override;
+    virtual void load_html(StringView, URL const&) override;
     virtual void paint(Gfx::IntRect const&, i32) override;
     virtual void set_viewport_rect(Gfx::IntRect const&) override;
     virtual void mouse_down(Gfx::IntPoint, unsigned, unsigned, unsigned) override;
@@ -64,7 +64,7 @@ private:
     virtual void key_up(i32, unsigned, u32) override;
     virtual void add_backing_store(i32, Gfx::ShareableBitmap const&) override;
     virtual void remove_backing_store(i32) override;
-    virtual void debug_request(DeprecatedString const&, DeprecatedString const&) override;
+    virtual void debug_request(StringView, StringView) override;
     virtual void get_source() override;
     virtual void inspect_dom_tree() override;
     virtual Messages::WebContentServer::InspectDomNodeResponse inspect_dom_node(i32 node_id, Optional<Web::CSS::Selector::PseudoElement> const& pseudo_element) override;
@@ -109,6 +109,13 @@ private:
         i32 bitmap_id { -1 };
     };
     Vector<PaintRequest> m_pending_paint_requests;
+
+    // The backing store we painted last, which the client keeps showing (and doesn't touch) until the next one.
+    struct PaintedFrame {
+        Gfx::IntRect content_rect;
+        i32 bitmap_id { -1 };
+    };
+    Optional<PaintedFrame> m_last_painted_frame;
     RefPtr<Web::Platform::Timer> m_paint_flush_timer;
 
     HashMap<i32, NonnullRefPtr<Gfx::Bitmap>> m_backing_stores;
@@ -13,7 +13,7 @@ namespace WebContent {
 ImageCodecPluginSerenity::ImageCodecPluginSerenity() = default;
 ImageCodecPluginSerenity::~ImageCodecPluginSerenity() = default;
 
-Optional<Web::Platform::DecodedImage> ImageCodecPluginSerenity::decode_image(ReadonlyBytes bytes)
+ImageDecoderClient::Client& ImageCodecPluginSerenity::client()
 {
     if (!m_client) {
         m_client = ImageDecoderClient::Client::try_create().release_value_but_fixme_should_propagate_errors();
@@ -21,8 +21,11 @@ Optional<Web::Platform::DecodedImage> ImageCodecPluginSerenity::decode_image(Rea
             m_client = nullptr;
         };
     }
+    return *m_client;
+}
 
-    auto result_or_empty = m_client->decode_image(bytes);
+static Optional<Web::Platform::DecodedImage> to_web_decoded_image(Optional<ImageDecoderClient::DecodedImage> result_or_empty)
+{
     if (!result_or_empty.has_value())
         return {};
     auto result = result_or_empty.release_value();
@@ -37,4 +40,16 @@ Optional<Web::Platform::DecodedImage> ImageCodecPluginSerenity::decode_image(Rea
     return decoded_image;
 }
 
+Optional<Web::Platform::DecodedImage> ImageCodecPluginSerenity::decode_image(ReadonlyBytes bytes)
+{
+    return to_web_decoded_image(client().decode_image(bytes));
+}
+
+void ImageCodecPluginSerenity::decode_image_async(ReadonlyBytes bytes, Function<void(Optional<Web::Platform::DecodedImage>)> on_decoded)
+{
+    client().decode_image_async(bytes, [on_decoded = move(on_decoded)](auto result) {
+        on_decoded(to_web_decoded_image(move(result)));
+    });
+}
+
 }
@@ -22,8 +22,11 @@ public:
     virtual ~ImageCodecPluginSerenity() override;
 
     virtual Optional<Web::Platform::DecodedImage> decode_image(ReadonlyBytes) override;
+    virtual void decode_image_async(ReadonlyBytes, Function<void(Optional<Web::Platform::DecodedImage>)> on_decoded) override;
 
 private:
+    ImageDecoderClient::Client& client();
+
     RefPtr<ImageDecoderClient::Client> m_client;
 };
 
@@ -7,11 +7,13 @@
 
 #include "PageHost.h"
 #include "ConnectionFromClient.h"
+#include <AK/ScopeGuard.h>
 #include <LibGfx/Painter.h>
 #include <LibGfx/ShareableBitmap.h>
 #include <LibGfx/SystemTheme.h>
 #include <LibWeb/Cookie/ParsedCookie.h>
 #include <LibWeb/HTML/BrowsingContext.h>
+#include <LibWeb/HighResolutionTime/TimeOrigin.h>
 #include <LibWeb/Layout/InitialContainingBlock.h>
 #include <LibWeb/Painting/PaintableBox.h>
 #include <LibWeb/Platform/Timer.h>
@@ -36,6 +38,7 @@ PageHost::~PageHost() = default;
 void PageHost::set_has_focus(bool has_focus)
 {
     m_has_focus = has_focus;
+    m_content_changed_since_last_frame = true;
 }
 
 void PageHost::setup_palette()
@@ -63,6 +66,7 @@ Gfx::Palette PageHost::palette() const
 void PageHost::set_palette_impl(Gfx::PaletteImpl const& impl)
 {
     m_palette_impl = impl;
+    m_content_changed_since_last_frame = true;
     if (auto* document = page().top_level_browsing_context().active_document())
         document->invalidate_style();
 }
@@ -70,6 +74,7 @@ void PageHost::set_palette_impl(Gfx::PaletteImpl const& impl)
 void PageHost::set_preferred_color_scheme(Web::CSS::PreferredColorScheme color_scheme)
 {
     m_preferred_color_scheme = color_scheme;
+    m_content_changed_since_last_frame = true;
     if (auto* document = page().top_level_browsing_context().active_document())
         document->invalidate_style();
 }
@@ -104,10 +109,53 @@ Web::Layout::InitialContainingBlock* PageHost::layout_root()
     return document->layout_node();
 }
 
+// FIXME: Painting reads the paintable tree directly, so it has to happen on the thread that runs layout and script.
+//        Moving rasterization to another thread first needs painting to record commands that can be replayed
+//        without the tree.
 void PageHost::paint(Web::DevicePixelRect const& content_rect, Gfx::Bitmap& target)
+{
+    ScopeGuard record_paint_time_guard = [this, start_time = Web::HighResolutionTime::unsafe_shared_current_time()] { record_paint_time(start_time); };
+    paint(content_rect, target, {});
+}
+
+void PageHost::paint_frame(Web::DevicePixelRect const& content_rect, Gfx::Bitmap& target, Web::DevicePixelRect const& previous_content_rect, Gfx::Bitmap const* previous_frame)
+{
+    ScopeGuard record_paint_time_guard = [this, start_time = Web::HighResolutionTime::unsafe_shared_current_time()] { record_paint_time(start_time); };
+
+    // NOTE: Layout may change what we'd paint, so it has to happen before we decide whether the previous frame is usable.
+    if (auto* document = page().top_level_browsing_context().active_document())
+        document->update_layout();
+
+    bool can_reuse_previous_frame = previous_frame
+        && !m_content_changed_since_last_frame
+        && previous_frame->size() == target.size()
+        && previous_content_rect.size() == content_rect.size();
+    m_content_changed_since_last_frame = false;
+
+    auto still_visible_rect = previous_content_rect.intersected(content_rect);
+    if (!can_reuse_previous_frame || still_visible_rect.is_empty()) {
+        paint(content_rect, target, {});
+        return;
+    }
+
+    Gfx::Painter painter(target);
+    painter.blit((still_visible_rect.location() - content_rect.location()).to_type<int>(), *previous_frame, still_visible_rect.translated(-previous_content_rect.location()).to_type<int>());
+    for (auto const& exposed_rect : content_rect.shatter(still_visible_rect))
+        paint(content_rect, target, exposed_rect);
+}
+
+void PageHost::record_paint_time(double start_time)
+{
+    if (auto* document = page().top_level_browsing_context().active_document())
+        document->last_rendering_timings().paint = Web::HighResolutionTime::unsafe_shared_current_time() - start_time;
+}
+
+void PageHost::paint(Web::DevicePixelRect const& content_rect, Gfx::Bitmap& target, Optional<Web::DevicePixelRect> const& clip_rect)
 {
     Gfx::Painter painter(target);
     Gfx::IntRect bitmap_rect { {}, content_rect.size().to_type<int>() };
+    if (clip_rect.has_value())
+        painter.add_clip_rect(clip_rect->translated(-content_rect.location()).to_type<int>());
 
     if (auto* document = page().top_level_browsing_context().active_document())
         document->update_layout();
@@ -123,6 +171,10 @@ void PageHost::paint(Web::DevicePixelRect const& content_rect, Gfx::Bitmap& targ
     context.set_device_viewport_rect(content_rect);
     context.set_has_focus(m_has_focus);
     layout_root->paint_all_phases(context);
+
+    // NOTE: Content painted relative to the viewport would end up in the wrong place if we scrolled this frame.
+    if (context.did_paint_viewport_relative_content())
+        m_content_changed_since_last_frame = true;
 }
 
 void PageHost::set_viewport_rect(Web::DevicePixelRect const& rect)
@@ -132,6 +184,7 @@ void PageHost::set_viewport_rect(Web::DevicePixelRect const& rect)
 
 void PageHost::page_did_invalidate(Web::CSSPixelRect const& content_rect)
 {
+    m_content_changed_since_last_frame = true;
     m_invalidation_rect = m_invalidation_rect.united(page().enclosing_device_rect(content_rect));
     if (!m_invalidation_coalescing_timer->is_active())
         m_invalidation_coalescing_timer->start();
@@ -139,6 +192,7 @@ void PageHost::page_did_invalidate(Web::CSSPixelRect const& content_rect)
 
 void PageHost::page_did_change_selection()
 {
+    m_content_changed_since_last_frame = true;
     m_client.async_did_change_selection();
 }
 
@@ -149,6 +203,7 @@ void PageHost::page_did_request_cursor_change(Gfx::StandardCursor cursor)
 
 void PageHost::page_did_layout()
 {
+    m_content_changed_since_last_frame = true;
     auto* layout_root = this->layout_root();
     VERIFY(layout_root);
     if (layout_root->paint_box()->has_overflow())
@@ -264,6 +319,7 @@ void PageHost::page_did_start_loading(const URL& url, bool is_redirect)
 
 void PageHost::page_did_create_main_document()
 {
+    m_content_changed_since_last_frame = true;
     m_client.initialize_js_console({});
 }
 
@@ -29,12 +29,24 @@ public:
 
     virtual void paint(Web::DevicePixelRect const& content_rect, Gfx::Bitmap&) override;
 
+    // Paints a frame into a backing store. If nothing changed since the previous frame was painted, the part of it
+    // that is still in view is copied over, and only the newly exposed parts are painted.
+    void paint_frame(Web::DevicePixelRect const& content_rect, Gfx::Bitmap& target, Web::DevicePixelRect const& previous_content_rect, Gfx::Bitmap const* previous_frame);
+
     void set_palette_impl(Gfx::PaletteImpl const&);
     void set_viewport_rect(Web::DevicePixelRect const&);
     void set_screen_rects(Vector<Gfx::IntRect, 4> const& rects, size_t main_screen_index) { m_screen_rect = rects[main_screen_index].to_type<Web::DevicePixels>(); }
-    void set_device_pixels_per_css_pixel(float device_pixels_per_css_pixel) { m_device_pixels_per_css_pixel = device_pixels_per_css_pixel; }
+    void set_device_pixels_per_css_pixel(float device_pixels_per_css_pixel)
+    {
+        m_device_pixels_per_css_pixel = device_pixels_per_css_pixel;
+        m_content_changed_since_last_frame = true;
+    }
     void set_preferred_color_scheme(Web::CSS::PreferredColorScheme);
-    void set_should_show_line_box_borders(bool b) { m_should_show_line_box_borders = b; }
+    void set_should_show_line_box_borders(bool b)
+    {
+        m_should_show_line_box_borders = b;
+        m_content_changed_since_last_frame = true;
+    }
     void set_has_focus(bool);
     void set_is_scripting_enabled(bool);
     void set_window_position(Web::DevicePixelPoint);
@@ -103,6 +115,8 @@ private:
 
     Web::Layout::InitialContainingBlock* layout_root();
     void setup_palette();
+    void paint(Web::DevicePixelRect const& content_rect, Gfx::Bitmap&, Optional<Web::DevicePixelRect> const& clip_rect);
+    void record_paint_time(double start_time);
 
     ConnectionFromClient& m_client;
     NonnullOwnPtr<Web::Page> m_page;
@@ -113,6 +127,10 @@ private:
     bool m_should_show_line_box_borders { false };
     bool m_has_focus { false };
 
+    // Set whenever the page may look different than it did when the last frame was painted, so that frame can't be
+    // reused for the next one.
+    bool m_content_changed_since_last_frame { true };
+
     RefPtr<Web::Platform::Timer> m_invalidation_coalescing_timer;
     Web::DevicePixelRect m_invalidation_rect;
     Web::CSS::PreferredColorScheme m_preferred_color_scheme { Web::CSS::PreferredColorScheme::Auto };
@@ -16,9 +16,10 @@
 #include <LibCore/DateTime.h>
 #include <LibCore/DeprecatedFile.h>
 #include <LibCore/DirIterator.h>
-#include <LibCore/File.h>
 #include <LibCore/MappedFile.h>
 #include <LibCore/MimeData.h>
+#include <LibCore/System.h>
+#include <LibCore/Timer.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/HttpResponse.h>
 #include <WebServer/Client.h>
@@ -29,6 +30,9 @@
 
 namespace WebServer {
 
+// How long a kept-alive connection may sit idle before we close it.
+static constexpr int idle_timeout_seconds = 10;
+
 Client::Client(NonnullOwnPtr<Core::BufferedTCPSocket> socket, Core::Object* parent)
     : Core::Object(parent)
     , m_socket(move(socket))
@@ -37,68 +41,89 @@ Client::Client(NonnullOwnPtr<Core::BufferedTCPSocket> socket, Core::Object* pare
 
 void Client::die()
 {
+    if (m_is_dead)
+        return;
+    m_is_dead = true;
+    if (m_idle_timer)
+        m_idle_timer->stop();
     m_socket->close();
     deferred_invoke([this] { remove_from_parent(); });
 }
 
 void Client::start()
 {
-    m_socket->on_ready_to_read = [this] {
-        StringBuilder builder;
+    m_idle_timer = Core::Timer::create_single_shot(idle_timeout_seconds * 1000, [this] { die(); }, this).release_value_but_fixme_should_propagate_errors();
+    m_idle_timer->set_precision(Core::TimerPrecision::Coarse);
+    m_idle_timer->start();
 
-        auto maybe_buffer = ByteBuffer::create_uninitialized(m_socket->buffer_size());
-        if (maybe_buffer.is_error()) {
-            warnln("Could not create buffer for client: {}", maybe_buffer.error());
+    m_socket->on_ready_to_read = [this] {
+        if (auto result = read_requests(); result.is_error()) {
+            warnln("Failed to handle the request: {}", result.error());
             die();
-            return;
         }
+    };
+}
 
-        auto buffer = maybe_buffer.release_value();
-        for (;;) {
-            auto maybe_can_read = m_socket->can_read_without_blocking();
-            if (maybe_can_read.is_error()) {
-                warnln("Failed to get the blocking status for the socket: {}", maybe_can_read.error());
-                die();
-                return;
-            }
+static bool should_keep_alive(HTTP::HeaderParser const& parser)
+{
+    // Connections are persistent by default since HTTP/1.1, but HTTP/1.0 clients have to ask for it.
+    auto keep_alive = parser.major_version() > 1 || (parser.major_version() == 1 && parser.minor_version() >= 1);
+    parser.for_each_field([&](auto const& field) {
+        if (!field.name.equals_ignoring_case("Connection"sv))
+            return;
+        if (field.value.equals_ignoring_case("close"sv))
+            keep_alive = false;
+        else if (field.value.equals_ignoring_case("keep-alive"sv))
+            keep_alive = true;
+    });
+    return keep_alive;
+}
 
-            if (!maybe_can_read.value())
-                break;
+ErrorOr<void> Client::read_requests()
+{
+    auto buffer = TRY(ByteBuffer::create_uninitialized(m_socket->buffer_size()));
+    while (TRY(m_socket->can_read_without_blocking())) {
+        auto bytes_read = TRY(m_socket->read(buffer));
+        if (m_socket->is_eof()) {
+            die();
+            return {};
+        }
+        TRY(m_request_buffer.try_append(bytes_read));
+    }
 
-            auto maybe_bytes_read = m_socket->read_until_any_of(buffer, Array { "\r"sv, "\n"sv, "\r\n"sv });
-            if (maybe_bytes_read.is_error()) {
-                warnln("Failed to read a line from the request: {}", maybe_bytes_read.error());
-                die();
-                return;
-            }
+    while (!m_is_dead && !m_request_buffer.is_empty()) {
+        // The parser keeps what it has seen of the request so far, so every byte only has to be looked at once,
+        // however many reads the headers are spread over.
+        auto consumed = m_header_parser.parse(m_request_buffer);
+        if (consumed == m_request_buffer.size())
+            m_request_buffer.clear();
+        else
+            m_request_buffer = TRY(ByteBuffer::copy(m_request_buffer.bytes().slice(consumed)));
 
-            if (m_socket->is_eof()) {
-                die();
-                break;
-            }
+        if (m_header_parser.has_failed())
+            return Error::from_string_view(m_header_parser.failure_reason());
+        if (!m_header_parser.is_done())
+            break;
 
-            builder.append(StringView { maybe_bytes_read.value() });
-            builder.append("\r\n"sv);
-        }
+        auto request = HTTP::HttpRequest::from_parsed_headers(m_header_parser);
+        if (!request.has_value())
+            return Error::from_string_literal("Malformed request");
 
-        auto request = builder.to_byte_buffer();
-        dbgln_if(WEBSERVER_DEBUG, "Got raw request: '{}'", DeprecatedString::copy(request));
+        m_keep_alive = should_keep_alive(m_header_parser);
+        m_header_parser.reset(HTTP::HeaderParser::Kind::Request);
+        TRY(handle_request(*request));
 
-        auto maybe_did_handle = handle_request(request);
-        if (maybe_did_handle.is_error()) {
-            warnln("Failed to handle the request: {}", maybe_did_handle.error());
-        }
+        if (!m_keep_alive)
+            die();
+    }
 
-        die();
-    };
+    if (!m_is_dead)
+        m_idle_timer->restart();
+    return {};
 }
 
-ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
+ErrorOr<void> Client::handle_request(HTTP::HttpRequest const& request)
 {
-    auto request_or_error = HTTP::HttpRequest::from_raw_request(raw_request);
-    if (!request_or_error.has_value())
-        return false;
-    auto& request = request_or_error.value();
     auto resource_decoded = URL::percent_decode(request.resource());
 
     if constexpr (WEBSERVER_DEBUG) {
@@ -109,8 +134,10 @@ ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
     }
 
     if (request.method() != HTTP::HttpRequest::Method::GET) {
+        // We don't know where the request's body (if any) ends, so there's no telling where the next request starts.
+        m_keep_alive = false;
         TRY(send_error_response(501, request));
-        return false;
+        return {};
     }
 
     // Check for credentials if they are required
@@ -121,7 +148,7 @@ ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
             Vector<String> headers {};
             TRY(headers.try_append(basic_auth_header));
             TRY(send_error_response(401, request, move(headers)));
-            return false;
+            return {};
         }
     }
 
@@ -133,7 +160,14 @@ ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
     path_builder.append(requested_path);
     auto real_path = TRY(path_builder.to_string());
 
-    if (Core::DeprecatedFile::is_directory(real_path.bytes_as_string_view())) {
+    auto file_or_error = FileCache::the().get(real_path);
+    if (file_or_error.is_error()) {
+        TRY(send_error_response(404, request));
+        return {};
+    }
+    auto file = file_or_error.release_value();
+
+    if (file->is_directory()) {
         if (!resource_decoded.ends_with('/')) {
             StringBuilder red;
 
@@ -141,46 +175,36 @@ ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
             red.append("/"sv);
 
             TRY(send_redirect(red.to_deprecated_string(), request));
-            return true;
+            return {};
         }
 
         StringBuilder index_html_path_builder;
         index_html_path_builder.append(real_path);
         index_html_path_builder.append("/index.html"sv);
         auto index_html_path = TRY(index_html_path_builder.to_string());
-        if (!Core::DeprecatedFile::exists(index_html_path)) {
+        auto index_html_file_or_error = FileCache::the().get(index_html_path);
+        if (index_html_file_or_error.is_error()) {
             TRY(handle_directory_listing(requested_path, real_path, request));
-            return true;
+            return {};
         }
-        real_path = index_html_path;
+        file = index_html_file_or_error.release_value();
     }
 
-    auto file = Core::DeprecatedFile::construct(real_path.bytes_as_string_view());
-    if (!file->open(Core::OpenMode::ReadOnly)) {
-        TRY(send_error_response(404, request));
-        return false;
-    }
-
-    if (file->is_device()) {
+    if (!file->is_regular_file()) {
         TRY(send_error_response(403, request));
-        return false;
+        return {};
     }
 
-    auto stream = TRY(Core::File::open(real_path.bytes_as_string_view(), Core::File::OpenMode::Read));
-
-    auto const info = ContentInfo {
-        .type = TRY(String::from_deprecated_string(Core::guess_mime_type_based_on_filename(real_path.bytes_as_string_view()))),
-        .length = TRY(Core::DeprecatedFile::size(real_path.bytes_as_string_view()))
-    };
-    TRY(send_response(*stream, request, move(info)));
-    return true;
+    TRY(send_file_response(*file, request));
+    return {};
 }
 
-ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+ErrorOr<void> Client::send_response_header(HTTP::HttpRequest const& request, ContentInfo const& content_info)
 {
     StringBuilder builder;
-    builder.append("HTTP/1.0 200 OK\r\n"sv);
+    builder.append("HTTP/1.1 200 OK\r\n"sv);
     builder.append("Server: WebServer (SerenityOS)\r\n"sv);
+    append_connection_headers(builder);
     builder.append("X-Frame-Options: SAMEORIGIN\r\n"sv);
     builder.append("X-Content-Type-Options: nosniff\r\n"sv);
     builder.append("Pragma: no-cache\r\n"sv);
@@ -194,6 +218,42 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
     auto builder_contents = builder.to_byte_buffer();
     TRY(m_socket->write(builder_contents));
     log_response(200, request);
+    return {};
+}
+
+void Client::append_connection_headers(StringBuilder& builder) const
+{
+    if (m_keep_alive) {
+        builder.append("Connection: keep-alive\r\n"sv);
+        builder.appendff("Keep-Alive: timeout={}\r\n", idle_timeout_seconds);
+    } else {
+        builder.append("Connection: close\r\n"sv);
+    }
+}
+
+ErrorOr<void> Client::send_file_response(FileCache::Entry const& file, HTTP::HttpRequest const& request)
+{
+    TRY(send_response_header(request, { .type = file.mime_type(), .length = file.size() }));
+
+    // Let the kernel move the file contents straight into the socket instead of copying them through our own buffer.
+    // The file is shared with other responses, so we keep track of where we are ourselves (sendfile() moves the offset along).
+    off_t offset = 0;
+    size_t remaining = file.size();
+    while (remaining > 0) {
+        auto nsent = TRY(Core::System::sendfile(m_socket->fd(), file.fd(), &offset, remaining));
+        if (nsent == 0) {
+            // The file got truncated after we've sent out its size, nothing we can do about that now.
+            break;
+        }
+        remaining -= nsent;
+    }
+
+    return {};
+}
+
+ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+{
+    TRY(send_response_header(request, content_info));
 
     char buffer[PAGE_SIZE];
     do {
@@ -213,24 +273,18 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
         }
     } while (true);
 
-    auto keep_alive = false;
-    if (auto it = request.headers().find_if([](auto& header) { return header.name.equals_ignoring_case("Connection"sv); }); !it.is_end()) {
-        if (it->value.trim_whitespace().equals_ignoring_case("keep-alive"sv))
-            keep_alive = true;
-    }
-    if (!keep_alive)
-        m_socket->close();
-
     return {};
 }
 
 ErrorOr<void> Client::send_redirect(StringView redirect_path, HTTP::HttpRequest const& request)
 {
     StringBuilder builder;
-    builder.append("HTTP/1.0 301 Moved Permanently\r\n"sv);
+    builder.append("HTTP/1.1 301 Moved Permanently\r\n"sv);
     builder.append("Location: "sv);
     builder.append(redirect_path);
     builder.append("\r\n"sv);
+    append_connection_headers(builder);
+    builder.append("Content-Length: 0\r\n"sv);
     builder.append("\r\n"sv);
 
     auto builder_contents = builder.to_byte_buffer();
@@ -352,9 +406,10 @@ ErrorOr<void> Client::send_error_response(unsigned code, HTTP::HttpRequest const
     content_builder.append("</h1></body></html>"sv);
 
     StringBuilder header_builder;
-    header_builder.appendff("HTTP/1.0 {} ", code);
+    header_builder.appendff("HTTP/1.1 {} ", code);
     header_builder.append(reason_phrase);
     header_builder.append("\r\n"sv);
+    append_connection_headers(header_builder);
 
     for (auto& header : headers) {
         header_builder.append(header);
@@ -8,10 +8,13 @@
 #pragma once
 
 #include <AK/String.h>
+#include <LibCore/Forward.h>
 #include <LibCore/Object.h>
 #include <LibCore/Socket.h>
 #include <LibHTTP/Forward.h>
+#include <LibHTTP/HeaderParser.h>
 #include <LibHTTP/HttpRequest.h>
+#include <WebServer/FileCache.h>
 
 namespace WebServer {
 
@@ -29,8 +32,13 @@ private:
         size_t length {};
     };
 
-    ErrorOr<bool> handle_request(ReadonlyBytes);
+    // Clients may send more requests without waiting for the responses (pipelining), which they get in order.
+    ErrorOr<void> read_requests();
+    ErrorOr<void> handle_request(HTTP::HttpRequest const&);
+    ErrorOr<void> send_response_header(HTTP::HttpRequest const&, ContentInfo const&);
     ErrorOr<void> send_response(Stream&, HTTP::HttpRequest const&, ContentInfo);
+    ErrorOr<void> send_file_response(FileCache::Entry const&, HTTP::HttpRequest const&);
+    void append_connection_headers(StringBuilder&) const;
     ErrorOr<void> send_redirect(StringView redirect, HTTP::HttpRequest const&);
     ErrorOr<void> send_error_response(unsigned code, HTTP::HttpRequest const&, Vector<String> const& headers = {});
     void die();
@@ -39,6 +47,13 @@ private:
     bool verify_credentials(Vector<HTTP::HttpRequest::Header> const&);
 
     NonnullOwnPtr<Core::BufferedTCPSocket> m_socket;
+    // What has been received of requests that we haven't gotten to yet.
+    ByteBuffer m_request_buffer;
+    HTTP::HeaderParser m_header_parser { HTTP::HeaderParser::Kind::Request };
+    // Whether the connection can be used for another request after the current one.
+    bool m_keep_alive { false };
+    bool m_is_dead { false };
+    RefPtr<Core::Timer> m_idle_timer;
 };
 
 }
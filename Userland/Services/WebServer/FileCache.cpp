@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/MimeData.h>
+#include <LibCore/System.h>
+#include <WebServer/FileCache.h>
+#include <fcntl.h>
+
+namespace WebServer {
+
+FileCache& FileCache::the()
+{
+    static thread_local FileCache s_the;
+    return s_the;
+}
+
+FileCache::Entry::Entry(struct stat stat, int fd, String mime_type)
+    : m_stat(stat)
+    , m_fd(fd)
+    , m_mime_type(move(mime_type))
+    , m_last_validated(Time::now_monotonic_coarse())
+{
+}
+
+FileCache::Entry::~Entry()
+{
+    if (m_fd >= 0)
+        (void)Core::System::close(m_fd);
+}
+
+bool FileCache::Entry::is_same_file_as(struct stat const& stat) const
+{
+    return m_stat.st_dev == stat.st_dev
+        && m_stat.st_ino == stat.st_ino
+        && m_stat.st_mode == stat.st_mode
+        && m_stat.st_size == stat.st_size
+        && m_stat.st_mtime == stat.st_mtime;
+}
+
+ErrorOr<NonnullRefPtr<FileCache::Entry>> FileCache::get(String const& path)
+{
+    auto now = Time::now_monotonic_coarse();
+    if (auto it = m_entries.find(path); it != m_entries.end()) {
+        auto& entry = it->value;
+        if (now - entry->m_last_validated < validity_period)
+            return entry;
+
+        auto stat_or_error = Core::System::stat(path);
+        if (!stat_or_error.is_error() && entry->is_same_file_as(stat_or_error.value())) {
+            entry->m_last_validated = now;
+            return entry;
+        }
+        m_entries.remove(it);
+        if (stat_or_error.is_error())
+            return stat_or_error.release_error();
+        return open(path, stat_or_error.release_value());
+    }
+
+    return open(path, TRY(Core::System::stat(path)));
+}
+
+ErrorOr<NonnullRefPtr<FileCache::Entry>> FileCache::open(String const& path, struct stat stat)
+{
+    int fd = -1;
+    if (S_ISREG(stat.st_mode)) {
+        fd = TRY(Core::System::open(path, O_RDONLY | O_CLOEXEC));
+        // The file may have been replaced since we've looked at it.
+        stat = TRY(Core::System::fstat(fd));
+    }
+    auto mime_type = TRY(String::from_utf8(Core::guess_mime_type_based_on_filename(path)));
+    auto entry = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Entry(stat, fd, move(mime_type))));
+
+    if (m_entries.size() >= max_entries) {
+        // Make room by closing whichever file we've been sure about for the longest time.
+        auto least_recently_validated = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->value->m_last_validated < least_recently_validated->value->m_last_validated)
+                least_recently_validated = it;
+        }
+        m_entries.remove(least_recently_validated);
+    }
+    TRY(m_entries.try_set(path, entry));
+    return entry;
+}
+
+}
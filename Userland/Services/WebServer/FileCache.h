@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/String.h>
+#include <AK/Time.h>
+#include <sys/stat.h>
+
+namespace WebServer {
+
+// Keeps the files that were asked for recently open, along with what we know about them, so that serving one again
+// doesn't mean resolving its path, stat'ing and opening it all over. Every thread has a cache of its own.
+class FileCache {
+public:
+    class Entry : public RefCounted<Entry> {
+        friend class FileCache;
+
+    public:
+        ~Entry();
+
+        bool is_directory() const { return S_ISDIR(m_stat.st_mode); }
+        bool is_regular_file() const { return S_ISREG(m_stat.st_mode); }
+        size_t size() const { return m_stat.st_size; }
+        String const& mime_type() const { return m_mime_type; }
+
+        // Only regular files are kept open. Don't use the file offset, other responses may be sending the same file.
+        int fd() const { return m_fd; }
+
+    private:
+        Entry(struct stat, int fd, String mime_type);
+
+        bool is_same_file_as(struct stat const&) const;
+
+        struct stat m_stat;
+        int m_fd { -1 };
+        String m_mime_type;
+        Time m_last_validated;
+    };
+
+    static FileCache& the();
+
+    ErrorOr<NonnullRefPtr<Entry>> get(String const& path);
+
+private:
+    // How long we trust that a file hasn't changed before we go and check, and how many we keep open.
+    static constexpr Time validity_period = Time::from_seconds(1);
+    static constexpr size_t max_entries = 128;
+
+    ErrorOr<NonnullRefPtr<Entry>> open(String const& path, struct stat);
+
+    HashMap<String, NonnullRefPtr<Entry>> m_entries;
+};
+
+}
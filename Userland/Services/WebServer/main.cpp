@@ -15,11 +15,40 @@
 #include <LibCore/TCPServer.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibMain/Main.h>
+#include <LibThreading/EventLoopGroup.h>
 #include <WebServer/Client.h>
 #include <WebServer/Configuration.h>
 #include <stdio.h>
 #include <unistd.h>
 
+// Every thread serves the clients it accepted itself.
+static thread_local RefPtr<Core::TCPServer> s_shared_server;
+
+static void accept_clients(Core::TCPServer& server)
+{
+    server.on_ready_to_accept = [&server] {
+        auto maybe_client_socket = server.accept();
+        if (maybe_client_socket.is_error()) {
+            // Another thread got to the client first.
+            if (maybe_client_socket.error().code() == EAGAIN)
+                return;
+            warnln("Failed to accept the client: {}", maybe_client_socket.error());
+            return;
+        }
+
+        auto maybe_buffered_socket = Core::BufferedTCPSocket::create(maybe_client_socket.release_value());
+        if (maybe_buffered_socket.is_error()) {
+            warnln("Could not obtain a buffered socket for the client: {}", maybe_buffered_socket.error());
+            return;
+        }
+
+        // FIXME: Propagate errors
+        MUST(maybe_buffered_socket.value()->set_blocking(true));
+        auto client = WebServer::Client::construct(maybe_buffered_socket.release_value(), &server);
+        client->start();
+    };
+}
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     static auto const default_listen_address = TRY(String::from_utf8("0.0.0.0"sv));
@@ -31,12 +60,14 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     DeprecatedString username;
     DeprecatedString password;
     DeprecatedString document_root_path = default_document_root_path.to_deprecated_string();
+    size_t thread_count = 1;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(listen_address, "IP address to listen on", "listen-address", 'l', "listen_address");
     args_parser.add_option(port, "Port to listen on", "port", 'p', "port");
     args_parser.add_option(username, "HTTP basic authentication username", "user", 'U', "username");
     args_parser.add_option(password, "HTTP basic authentication password", "pass", 'P', "password");
+    args_parser.add_option(thread_count, "Number of threads that serve clients", "threads", 't', "count");
     args_parser.add_positional_argument(document_root_path, "Path to serve the contents of", "path", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
@@ -51,6 +82,11 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return 1;
     }
 
+    if (thread_count == 0) {
+        warnln("At least one thread has to serve clients");
+        return 1;
+    }
+
     if (username.is_empty() != password.is_empty()) {
         warnln("Both username and password are required for HTTP basic authentication.");
         return 1;
@@ -62,7 +98,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return 1;
     }
 
-    TRY(Core::System::pledge("stdio accept rpath inet unix"));
+    TRY(Core::System::pledge("stdio accept rpath inet unix thread"));
 
     Optional<HTTP::HttpRequest::BasicAuthenticationCredentials> credentials;
     if (!username.is_empty() && !password.is_empty())
@@ -73,27 +109,18 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     Core::EventLoop loop;
 
     auto server = TRY(Core::TCPServer::try_create());
-
-    server->on_ready_to_accept = [&] {
-        auto maybe_client_socket = server->accept();
-        if (maybe_client_socket.is_error()) {
-            warnln("Failed to accept the client: {}", maybe_client_socket.error());
-            return;
-        }
-
-        auto maybe_buffered_socket = Core::BufferedTCPSocket::create(maybe_client_socket.release_value());
-        if (maybe_buffered_socket.is_error()) {
-            warnln("Could not obtain a buffered socket for the client: {}", maybe_buffered_socket.error());
-            return;
-        }
-
-        // FIXME: Propagate errors
-        MUST(maybe_buffered_socket.value()->set_blocking(true));
-        auto client = WebServer::Client::construct(maybe_buffered_socket.release_value(), server);
-        client->start();
-    };
-
     TRY(server->listen(ipv4_address.value(), port));
+    accept_clients(*server);
+
+    // The main thread serves clients as well, so it only needs help from the others.
+    OwnPtr<Threading::EventLoopGroup> helper_threads;
+    if (thread_count > 1) {
+        helper_threads = TRY(Threading::EventLoopGroup::create(thread_count - 1, [&server](size_t) -> ErrorOr<void> {
+            s_shared_server = TRY(Core::TCPServer::try_create_sharing(*server));
+            accept_clients(*s_shared_server);
+            return {};
+        }));
+    }
 
     out("Listening on ");
     out("\033]8;;http://{}:{}\033\\", ipv4_address.value(), port);
@@ -105,6 +132,6 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     TRY(Core::System::unveil(real_document_root_path, "r"sv));
     TRY(Core::System::unveil(nullptr, nullptr));
 
-    TRY(Core::System::pledge("stdio accept rpath"));
+    TRY(Core::System::pledge("stdio accept rpath thread"));
     return loop.exec();
 }
@@ -9,6 +9,7 @@
 #include "ConnectionFromClient.h"
 #include "Event.h"
 #include "EventLoop.h"
+#include "GPUCompositor.h"
 #include "MultiScaleBitmaps.h"
 #include "Screen.h"
 #include "Window.h"
@@ -16,6 +17,7 @@
 #include <AK/Debug.h>
 #include <AK/Memory.h>
 #include <AK/ScopeGuard.h>
+#include <LibCore/ElapsedTimer.h>
 #include <LibCore/Timer.h>
 #include <LibGfx/AntiAliasingPainter.h>
 #include <LibGfx/Font/Font.h>
@@ -44,10 +46,15 @@ static WallpaperMode mode_to_enum(DeprecatedString const& name)
 
 Compositor::Compositor()
 {
-    m_display_link_notify_timer = add<Core::Timer>(
-        1000 / 60, [this] {
+    m_display_link_notify_timer = Core::Timer::create_single_shot(
+        1000 / 60,
+        [this] {
             notify_display_links();
-        });
+            // Re-arm for the next frame instead of repeating, so that rounding to milliseconds doesn't make us drift.
+            m_display_link_notify_timer->start(milliseconds_until_next_frame());
+        },
+        this)
+                                      .release_value_but_fixme_should_propagate_errors();
 
     m_compose_timer = Core::Timer::create_single_shot(
         1000 / 60,
@@ -67,9 +74,25 @@ Compositor::Compositor()
                                     .release_value_but_fixme_should_propagate_errors();
     m_compose_timer->start();
 
+    m_frame_clock_epoch = Time::now_monotonic();
+    update_frame_interval();
+
     init_bitmaps();
 }
 
+void Compositor::update_frame_interval()
+{
+    m_frame_interval = Time::from_nanoseconds(1'000'000'000'000ll / Screen::main().refresh_rate_in_millihertz());
+}
+
+int Compositor::milliseconds_until_next_frame() const
+{
+    // Without vblank events from the device, frames start at multiples of the refresh interval of the main screen.
+    auto interval = m_frame_interval.to_nanoseconds();
+    auto into_frame = (Time::now_monotonic() - m_frame_clock_epoch).to_nanoseconds() % interval;
+    return max(1, static_cast<int>(Time::from_nanoseconds(interval - into_frame).to_milliseconds()));
+}
+
 Gfx::Bitmap const* Compositor::cursor_bitmap_for_screenshot(Badge<ConnectionFromClient>, Screen& screen) const
 {
     if (!m_current_cursor)
@@ -134,6 +157,8 @@ void Compositor::init_bitmaps()
         screen.compositor_screen_data().init_bitmaps(*this, screen);
         return IterationDecision::Continue;
     });
+    if (m_gpu_compositor)
+        m_gpu_compositor->did_change_screens();
 
     invalidate_screen();
 }
@@ -147,6 +172,27 @@ void Compositor::did_construct_window_manager(Badge<WindowManager>)
     m_wallpaper_mode = mode_to_enum(g_config->read_entry("Background", "Mode", "Center"));
     m_custom_background_color = Color::from_string(g_config->read_entry("Background", "Color", ""));
 
+    if (g_config->read_entry("Graphics", "Composition", "Software") == "GPU") {
+        auto gpu_compositor_or_error = GPUCompositor::try_create();
+        if (gpu_compositor_or_error.is_error())
+            dbgln("Compositor: Couldn't compose on the GPU, falling back to software: {}", gpu_compositor_or_error.error());
+        else
+            m_gpu_compositor = gpu_compositor_or_error.release_value();
+    }
+
+    if (g_config->read_bool_entry("Graphics", "ShowCompositorStats", false)) {
+        m_stats_overlay = create_overlay<CompositorStatsOverlay>();
+        m_stats_overlay->set_enabled(true);
+        m_stats_timer = add<Core::Timer>(1000, [this] {
+            auto milliseconds_per_frame = m_stats_frame_count ? static_cast<float>(m_stats_compose_time.to_microseconds()) / 1000.0f / m_stats_frame_count : 0.0f;
+            auto flushed_rects_per_frame = m_stats_frame_count ? m_stats_flushed_rect_count / m_stats_frame_count : 0;
+            m_stats_overlay->set_stats(milliseconds_per_frame, m_stats_frame_count, flushed_rects_per_frame);
+            m_stats_frame_count = 0;
+            m_stats_flushed_rect_count = 0;
+            m_stats_compose_time = {};
+        });
+    }
+
     invalidate_screen();
     invalidate_occlusions();
     compose();
@@ -188,6 +234,8 @@ void Compositor::compose()
     // We should have recomputed occlusions if any overlay rects were changed
     VERIFY(!m_overlay_rects_changed);
 
+    auto compose_timer = Core::ElapsedTimer::start_new();
+
     auto dirty_screen_rects = move(m_dirty_screen_rects);
 
     bool window_stack_transition_in_progress = m_transitioning_to_window_stack != nullptr;
@@ -235,9 +283,9 @@ void Compositor::compose()
         return IterationDecision::Continue;
     });
 
-    Color background_color = wm.palette().desktop_background();
-    if (m_custom_background_color.has_value())
-        background_color = m_custom_background_color.value();
+    auto background_color = desktop_background_color();
+    if (m_wallpaper && background_color != m_wallpaper_background_color)
+        update_wallpaper_bitmap();
 
     if constexpr (COMPOSE_DEBUG) {
         dbgln("COMPOSE: invalidated: window: {} cursor: {}, any: {}", m_invalidated_window, m_invalidated_cursor, m_invalidated_any);
@@ -256,12 +304,15 @@ void Compositor::compose()
         return IterationDecision::Continue;
     });
 
+    bool cursor_is_in_hardware = update_hardware_cursor();
     auto cursor_rect = current_cursor_rect();
 
     bool need_to_draw_cursor = false;
     Gfx::IntRect previous_cursor_rect;
     Screen* previous_cursor_screen = nullptr;
     auto check_restore_cursor_back = [&](Screen& screen, Gfx::IntRect const& rect) {
+        if (cursor_is_in_hardware)
+            return;
         if (&screen == &cursor_screen && !previous_cursor_screen && !need_to_draw_cursor && rect.intersects(cursor_rect)) {
             // Restore what's behind the cursor if anything touches the area of the cursor
             need_to_draw_cursor = true;
@@ -270,7 +321,13 @@ void Compositor::compose()
         }
     };
 
-    if (&cursor_screen != m_current_cursor_screen) {
+    if (cursor_is_in_hardware) {
+        // Take down the cursor we've drawn ourselves until now, if any
+        if (m_current_cursor_screen) {
+            m_current_cursor_screen->compositor_screen_data().restore_cursor_back(*m_current_cursor_screen, previous_cursor_rect);
+            m_current_cursor_screen = nullptr;
+        }
+    } else if (&cursor_screen != m_current_cursor_screen) {
         // Cursor moved to another screen, restore on the cursor's background on the previous screen
         need_to_draw_cursor = true;
         if (m_current_cursor_screen) {
@@ -308,24 +365,22 @@ void Compositor::compose()
         check_restore_cursor_back(cursor_screen, cursor_rect);
 
     auto paint_wallpaper = [&](Screen& screen, Gfx::Painter& painter, Gfx::IntRect const& rect, Gfx::IntRect const& screen_rect) {
-        if (m_wallpaper) {
-            if (m_wallpaper_mode == WallpaperMode::Center) {
-                Gfx::IntPoint offset { (screen.width() - m_wallpaper->width()) / 2, (screen.height() - m_wallpaper->height()) / 2 };
-
-                // FIXME: If the wallpaper is opaque and covers the whole rect, no need to fill with color!
+        if (!m_wallpaper) {
+            if (m_gpu_compositor)
+                m_gpu_compositor->fill_rect(screen, rect, background_color);
+            else
                 painter.fill_rect(rect, background_color);
-                painter.blit_offset(rect.location(), *m_wallpaper, rect.translated(-screen_rect.location()), offset);
-            } else if (m_wallpaper_mode == WallpaperMode::Tile) {
-                painter.draw_tiled_bitmap(rect, *m_wallpaper);
-            } else if (m_wallpaper_mode == WallpaperMode::Stretch) {
-                VERIFY(screen.compositor_screen_data().m_wallpaper_bitmap);
-                painter.blit(rect.location(), *screen.compositor_screen_data().m_wallpaper_bitmap, rect);
-            } else {
-                VERIFY_NOT_REACHED();
-            }
-        } else {
-            painter.fill_rect(rect, background_color);
+            return;
         }
+
+        // The wallpaper has already been rendered for this screen, whatever its mode, so this is just a copy.
+        VERIFY(screen.compositor_screen_data().m_wallpaper_bitmap);
+        auto& wallpaper_bitmap = *screen.compositor_screen_data().m_wallpaper_bitmap;
+        auto render_rect = rect.intersected(screen_rect);
+        if (m_gpu_compositor)
+            m_gpu_compositor->paint_bitmap(screen, screen_rect.location(), wallpaper_bitmap, wallpaper_bitmap.rect(), render_rect);
+        else
+            painter.blit(render_rect.location(), wallpaper_bitmap, render_rect.translated(-screen_rect.location()));
     };
 
     {
@@ -377,6 +432,10 @@ void Compositor::compose()
         auto compose_window_rect = [&](Screen& screen, Gfx::Painter& painter, const Gfx::IntRect& rect) {
             if (!window.is_fullscreen()) {
                 rect.for_each_intersected(frame_rects, [&](const Gfx::IntRect& intersected_rect) {
+                    if (m_gpu_compositor) {
+                        m_gpu_compositor->paint_window_frame(screen, window, intersected_rect, transition_offset);
+                        return IterationDecision::Continue;
+                    }
                     Gfx::PainterStateSaver saver(painter);
                     painter.add_clip_rect(intersected_rect);
                     painter.translate(transition_offset);
@@ -394,7 +453,10 @@ void Compositor::compose()
                 auto fill_color = wm.palette().window();
                 if (!window.is_opaque())
                     fill_color.set_alpha(255 * window.opacity());
-                painter.fill_rect(clear_rect, fill_color);
+                if (m_gpu_compositor)
+                    m_gpu_compositor->fill_rect(screen, clear_rect, fill_color);
+                else
+                    painter.fill_rect(clear_rect, fill_color);
             };
 
             if (!backing_store) {
@@ -443,8 +505,11 @@ void Compositor::compose()
 
             if (!dirty_rect_in_backing_coordinates.is_empty()) {
                 auto dst = backing_rect.location().translated(dirty_rect_in_backing_coordinates.location());
+                bool is_unresponsive = window.client() && window.client()->is_unresponsive();
 
-                if (window.client() && window.client()->is_unresponsive()) {
+                if (m_gpu_compositor) {
+                    m_gpu_compositor->paint_window_contents(screen, window, dst, dirty_rect_in_backing_coordinates, window.opacity(), is_unresponsive);
+                } else if (is_unresponsive) {
                     if (window.is_opaque()) {
                         painter.blit_filtered(dst, *backing_store, dirty_rect_in_backing_coordinates, [](Color src) {
                             return src.to_grayscale().darkened(0.75f);
@@ -572,7 +637,27 @@ void Compositor::compose()
             });
             return is_overlapping;
         }());
+    }
+
+    if (m_gpu_compositor) {
+        // Everything above was drawn into the GPU's copy of each screen, so bring back what we're about to flush.
+        Screen::for_each([&](auto& screen) {
+            auto& screen_data = screen.compositor_screen_data();
+            for (auto& rect : screen_data.m_flush_rects.rects())
+                m_gpu_compositor->read_back(screen, rect, *screen_data.m_back_bitmap);
+            for (auto& rect : screen_data.m_flush_transparent_rects.rects())
+                m_gpu_compositor->read_back(screen, rect, *screen_data.m_temp_bitmap);
+            return IterationDecision::Continue;
+        });
+        if (auto result = m_gpu_compositor->finish_frame(); result.is_error()) {
+            dbgln("Compositor: Composing on the GPU failed, falling back to software: {}", result.error());
+            m_gpu_compositor = nullptr;
+            // We're still in the middle of composing, and would miss out on invalidating the screen now.
+            deferred_invoke([this] { invalidate_screen(); });
+        }
+    }
 
+    if (m_invalidated_window) {
         if (!m_overlay_list.is_empty()) {
             // Render everything to the temporary buffer before we copy it back
             render_overlays();
@@ -610,10 +695,25 @@ void Compositor::compose()
         screen_data.draw_cursor(cursor_screen, cursor_rect);
     }
 
+    if (m_stats_overlay) {
+        size_t flushed_rect_count = 0;
+        Screen::for_each([&](auto& screen) {
+            auto& screen_data = screen.compositor_screen_data();
+            if (screen_data.m_have_flush_rects)
+                flushed_rect_count += screen_data.m_flush_rects.size() + screen_data.m_flush_transparent_rects.size() + screen_data.m_flush_special_rects.size();
+            return IterationDecision::Continue;
+        });
+        ++m_stats_frame_count;
+        m_stats_flushed_rect_count += flushed_rect_count;
+    }
+
     Screen::for_each([&](auto& screen) {
         flush(screen);
         return IterationDecision::Continue;
     });
+
+    if (m_stats_overlay)
+        m_stats_compose_time += compose_timer.elapsed_time();
 }
 
 void Compositor::flush(Screen& screen)
@@ -776,11 +876,11 @@ void Compositor::invalidate_window()
 
 void Compositor::start_compose_async_timer()
 {
-    // We delay composition by a timer interval, but to not affect latency too
+    // We delay composition until the next frame, but to not affect latency too
     // much, if a pending compose is not already scheduled, we also schedule an
     // immediate compose the next spin of the event loop.
     if (!m_compose_timer->is_active()) {
-        m_compose_timer->start();
+        m_compose_timer->start(milliseconds_until_next_frame());
         m_immediate_compose_timer->start();
     }
 }
@@ -830,21 +930,48 @@ bool Compositor::set_wallpaper(RefPtr<Gfx::Bitmap> bitmap)
     return true;
 }
 
+Color Compositor::desktop_background_color() const
+{
+    if (m_custom_background_color.has_value())
+        return m_custom_background_color.value();
+    return WindowManager::the().palette().desktop_background();
+}
+
 void Compositor::update_wallpaper_bitmap()
 {
+    m_wallpaper_background_color = desktop_background_color();
+
     Screen::for_each([&](Screen& screen) {
         auto& screen_data = screen.compositor_screen_data();
-        if (m_wallpaper_mode != WallpaperMode::Stretch || !m_wallpaper) {
+        if (!m_wallpaper) {
             screen_data.clear_wallpaper_bitmap();
             return IterationDecision::Continue;
         }
         if (!screen_data.m_wallpaper_bitmap)
             screen_data.init_wallpaper_bitmap(screen);
 
-        auto rect = screen_data.m_wallpaper_bitmap->rect();
+        auto screen_rect = screen.rect();
         auto& painter = *screen_data.m_wallpaper_painter;
 
-        painter.draw_scaled_bitmap(rect, *m_wallpaper, m_wallpaper->rect());
+        switch (m_wallpaper_mode) {
+        case WallpaperMode::Center: {
+            Gfx::IntPoint offset { (screen.width() - m_wallpaper->width()) / 2, (screen.height() - m_wallpaper->height()) / 2 };
+            // FIXME: If the wallpaper is opaque and covers the whole screen, no need to fill with color!
+            painter.fill_rect(screen_rect, m_wallpaper_background_color);
+            painter.blit_offset(screen_rect.location(), *m_wallpaper, { {}, screen_rect.size() }, offset);
+            break;
+        }
+        case WallpaperMode::Tile:
+            painter.draw_tiled_bitmap(screen_rect, *m_wallpaper);
+            break;
+        case WallpaperMode::Stretch:
+            painter.draw_scaled_bitmap(screen_rect, *m_wallpaper, m_wallpaper->rect());
+            break;
+        default:
+            VERIFY_NOT_REACHED();
+        }
+        if (m_gpu_compositor)
+            m_gpu_compositor->did_change_bitmap(*screen_data.m_wallpaper_bitmap);
 
         return IterationDecision::Continue;
     });
@@ -876,8 +1003,11 @@ void Compositor::screen_resolution_changed()
 {
     // Screens may be gone now, invalidate any references to them
     m_current_cursor_screen = nullptr;
+    m_hardware_cursor_screen = nullptr;
+    m_hardware_cursor = nullptr;
 
     init_bitmaps();
+    update_frame_interval();
     invalidate_occlusions();
     overlay_rects_changed();
     update_wallpaper_bitmap();
@@ -902,6 +1032,13 @@ Gfx::IntRect Compositor::current_cursor_rect() const
 
 void Compositor::invalidate_cursor(bool compose_immediately)
 {
+    // While the cursor's screen draws it for us, moving or changing it doesn't require composing anything.
+    if (m_hardware_cursor_screen && m_hardware_cursor_screen == &ScreenInput::the().cursor_location_screen()) {
+        change_cursor(&WindowManager::the().active_cursor());
+        if (update_hardware_cursor())
+            return;
+    }
+
     if (m_invalidated_cursor && !compose_immediately)
         return;
     m_invalidated_cursor = true;
@@ -913,6 +1050,53 @@ void Compositor::invalidate_cursor(bool compose_immediately)
         start_compose_async_timer();
 }
 
+// Shows the current cursor on the screen it is on, if that screen can draw it for us.
+bool Compositor::update_hardware_cursor()
+{
+    auto& wm = WindowManager::the();
+    auto& cursor_screen = ScreenInput::the().cursor_location_screen();
+    auto& cursor = m_current_cursor ? *m_current_cursor : wm.active_cursor();
+
+    if (m_hardware_cursor_screen != &cursor_screen)
+        hide_hardware_cursor();
+
+    // FIXME: Draw the highlight into the cursor image, so that it works with hardware cursors.
+    if (!cursor_screen.can_use_hardware_cursor() || wm.is_cursor_highlight_enabled()) {
+        hide_hardware_cursor();
+        return false;
+    }
+
+    if (m_hardware_cursor_screen != &cursor_screen || m_hardware_cursor != &cursor || m_hardware_cursor_frame != m_current_cursor_frame) {
+        auto& bitmap = cursor.bitmap(cursor_screen.scale_factor());
+        if (cursor_screen.set_hardware_cursor(bitmap, cursor.source_rect(m_current_cursor_frame), cursor.params().hotspot()).is_error()) {
+            hide_hardware_cursor();
+            return false;
+        }
+        m_hardware_cursor_screen = &cursor_screen;
+        m_hardware_cursor = &cursor;
+        m_hardware_cursor_frame = m_current_cursor_frame;
+    }
+
+    if (auto result = cursor_screen.move_hardware_cursor(ScreenInput::the().cursor_location()); result.is_error()) {
+        dbgln("Compositor: Failed to move the hardware cursor: {}", result.error());
+        hide_hardware_cursor();
+        return false;
+    }
+    return true;
+}
+
+void Compositor::hide_hardware_cursor()
+{
+    if (!m_hardware_cursor_screen)
+        return;
+    if (m_hardware_cursor_screen->can_use_hardware_cursor()) {
+        if (auto result = m_hardware_cursor_screen->hide_hardware_cursor(); result.is_error())
+            dbgln("Compositor: Failed to hide the hardware cursor: {}", result.error());
+    }
+    m_hardware_cursor_screen = nullptr;
+    m_hardware_cursor = nullptr;
+}
+
 void Compositor::change_cursor(Cursor const* cursor)
 {
     if (m_current_cursor == cursor)
@@ -1051,7 +1235,7 @@ void Compositor::increment_display_link_count(Badge<ConnectionFromClient>)
 {
     ++m_display_link_count;
     if (m_display_link_count == 1)
-        m_display_link_notify_timer->start();
+        m_display_link_notify_timer->start(milliseconds_until_next_frame());
 }
 
 void Compositor::decrement_display_link_count(Badge<ConnectionFromClient>)
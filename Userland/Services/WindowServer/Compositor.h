@@ -8,6 +8,7 @@
 
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
+#include <AK/Time.h>
 #include <LibCore/Object.h>
 #include <LibGfx/Color.h>
 #include <LibGfx/DisjointRectSet.h>
@@ -19,7 +20,9 @@ namespace WindowServer {
 class Animation;
 class ConnectionFromClient;
 class Compositor;
+class CompositorStatsOverlay;
 class Cursor;
+class GPUCompositor;
 class MultiScaleBitmaps;
 class Window;
 class WindowManager;
@@ -207,6 +210,8 @@ private:
     void recompute_overlay_rects();
     void recompute_occlusions();
     void change_cursor(Cursor const*);
+    bool update_hardware_cursor();
+    void hide_hardware_cursor();
     void flush(Screen&);
     Gfx::IntPoint window_transition_offset(Window&);
     void update_animations(Screen&, Gfx::DisjointIntRectSet& flush_rects);
@@ -216,9 +221,14 @@ private:
     void start_window_stack_switch_overlay_timer();
     void finish_window_stack_switch();
     void update_wallpaper_bitmap();
+    Color desktop_background_color() const;
+    void update_frame_interval();
+    int milliseconds_until_next_frame() const;
 
     RefPtr<Core::Timer> m_compose_timer;
     RefPtr<Core::Timer> m_immediate_compose_timer;
+    Time m_frame_clock_epoch;
+    Time m_frame_interval;
     bool m_flash_flush { false };
     bool m_occlusions_dirty { true };
     bool m_invalidated_any { true };
@@ -234,12 +244,22 @@ private:
 
     WallpaperMode m_wallpaper_mode { WallpaperMode::Unchecked };
     RefPtr<Gfx::Bitmap> m_wallpaper;
+    // Every screen keeps the wallpaper rendered, on top of this color, in its m_wallpaper_bitmap.
+    Color m_wallpaper_background_color;
+
+    // Only set when composing on the GPU, see GPUCompositor.
+    OwnPtr<GPUCompositor> m_gpu_compositor;
 
     Cursor const* m_current_cursor { nullptr };
     Screen* m_current_cursor_screen { nullptr };
     unsigned m_current_cursor_frame { 0 };
     RefPtr<Core::Timer> m_cursor_timer;
 
+    // The screen that draws the cursor for us, and which cursor frame it has.
+    Screen* m_hardware_cursor_screen { nullptr };
+    Cursor const* m_hardware_cursor { nullptr };
+    unsigned m_hardware_cursor_frame { 0 };
+
     RefPtr<Core::Timer> m_display_link_notify_timer;
     size_t m_display_link_count { 0 };
 
@@ -252,6 +272,13 @@ private:
     Optional<Gfx::Color> m_custom_background_color;
 
     HashTable<Animation*> m_animations;
+
+    // Only set when [Graphics] ShowCompositorStats is enabled.
+    OwnPtr<CompositorStatsOverlay> m_stats_overlay;
+    RefPtr<Core::Timer> m_stats_timer;
+    size_t m_stats_frame_count { 0 };
+    size_t m_stats_flushed_rect_count { 0 };
+    Time m_stats_compose_time;
 };
 
 }
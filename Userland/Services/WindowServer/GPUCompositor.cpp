@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StdLibExtras.h>
+#include <LibGfx/Painter.h>
+#include <WindowServer/GPUCompositor.h>
+#include <WindowServer/Screen.h>
+#include <WindowServer/Window.h>
+#include <WindowServer/WindowFrame.h>
+
+namespace WindowServer {
+
+// Textures are handed out in sizes that are multiples of this, so that windows which are being resized can keep
+// reusing the same few of them.
+static constexpr int texture_size_granularity = 64;
+
+GPUWindowTextures::GPUWindowTextures(GPUCompositor& compositor)
+    : m_compositor(compositor.make_weak_ptr())
+{
+}
+
+GPUWindowTextures::~GPUWindowTextures()
+{
+    if (!m_compositor)
+        return;
+    for (auto& backing_store : m_backing_stores) {
+        if (backing_store.texture.has_value())
+            m_compositor->release_texture(*backing_store.texture);
+    }
+    if (m_frame_texture.has_value())
+        m_compositor->release_texture(*m_frame_texture);
+}
+
+void GPUWindowTextures::did_invalidate_contents()
+{
+    for (auto& backing_store : m_backing_stores) {
+        if (backing_store.bitmap)
+            backing_store.stale_rects = Gfx::DisjointIntRectSet { backing_store.bitmap->rect() };
+    }
+}
+
+void GPUWindowTextures::did_invalidate_contents(Gfx::IntRect const& rect)
+{
+    // The client copies what it painted into one backing store over to the other after flipping them, so both are stale.
+    for (auto& backing_store : m_backing_stores) {
+        if (backing_store.bitmap)
+            backing_store.stale_rects.add(rect.intersected(backing_store.bitmap->rect()));
+    }
+}
+
+ErrorOr<NonnullOwnPtr<GPUCompositor>> GPUCompositor::try_create()
+{
+    auto renderer = TRY(VirtGPU::QuadRenderer::create());
+    return adopt_nonnull_own_or_enomem(new (nothrow) GPUCompositor(move(renderer)));
+}
+
+GPUCompositor::GPUCompositor(NonnullOwnPtr<VirtGPU::QuadRenderer> renderer)
+    : m_renderer(move(renderer))
+{
+}
+
+void GPUCompositor::did_fail(Error error)
+{
+    if (!m_error.has_value())
+        m_error = move(error);
+}
+
+ErrorOr<VirtGPU::QuadRenderer::Texture> GPUCompositor::acquire_texture(Gfx::IntSize size)
+{
+    for (size_t i = 0; i < m_free_textures.size(); ++i) {
+        auto& texture = m_free_textures[i];
+        if (texture.size.width() >= size.width() && texture.size.height() >= size.height())
+            return m_free_textures.take(i);
+    }
+    Gfx::IntSize texture_size {
+        round_up_to_power_of_two(max(size.width(), 1), texture_size_granularity),
+        round_up_to_power_of_two(max(size.height(), 1), texture_size_granularity),
+    };
+    return m_renderer->create_texture(texture_size);
+}
+
+void GPUCompositor::release_texture(VirtGPU::QuadRenderer::Texture const& texture)
+{
+    m_free_textures.append(texture);
+}
+
+ErrorOr<void> GPUCompositor::target_screen(Screen& screen)
+{
+    if (m_target_screen == &screen)
+        return {};
+
+    auto it = m_screen_textures.find(&screen);
+    if (it == m_screen_textures.end()) {
+        auto texture = TRY(acquire_texture(screen.physical_size()));
+        TRY(m_screen_textures.try_set(&screen, texture));
+        it = m_screen_textures.find(&screen);
+    }
+    TRY(m_renderer->set_target(it->value));
+    m_target_screen = &screen;
+    return {};
+}
+
+ErrorOr<void> GPUCompositor::draw(Screen& screen, VirtGPU::QuadRenderer::Texture const& texture, Gfx::IntPoint position, int source_scale, Gfx::IntRect const& source_rect, Gfx::IntRect const& clip_rect, Color color, VirtGPU::QuadDrawOptions options)
+{
+    Gfx::IntRect destination_rect { position, source_rect.size() };
+    auto clipped_rect = destination_rect.intersected(clip_rect).intersected(screen.rect());
+    if (clipped_rect.is_empty())
+        return {};
+
+    Gfx::IntRect clipped_source_rect { source_rect.location() + (clipped_rect.location() - position), clipped_rect.size() };
+    TRY(target_screen(screen));
+    return m_renderer->draw(texture, clipped_source_rect * source_scale, clipped_rect.translated(-screen.rect().location()) * screen.scale_factor(), color, options);
+}
+
+void GPUCompositor::fill_rect(Screen& screen, Gfx::IntRect const& rect, Color color)
+{
+    if (m_error.has_value())
+        return;
+    auto clipped_rect = rect.intersected(screen.rect());
+    if (clipped_rect.is_empty())
+        return;
+
+    auto result = [&]() -> ErrorOr<void> {
+        TRY(target_screen(screen));
+        return m_renderer->fill(clipped_rect.translated(-screen.rect().location()) * screen.scale_factor(), color);
+    }();
+    if (result.is_error())
+        did_fail(result.release_error());
+}
+
+void GPUCompositor::paint_bitmap(Screen& screen, Gfx::IntPoint position, Gfx::Bitmap const& bitmap, Gfx::IntRect const& source_rect, Gfx::IntRect const& clip_rect)
+{
+    if (m_error.has_value())
+        return;
+    if (auto result = paint_bitmap_impl(screen, position, bitmap, source_rect, clip_rect); result.is_error())
+        did_fail(result.release_error());
+}
+
+ErrorOr<void> GPUCompositor::paint_bitmap_impl(Screen& screen, Gfx::IntPoint position, Gfx::Bitmap const& bitmap, Gfx::IntRect const& source_rect, Gfx::IntRect const& clip_rect)
+{
+    auto it = m_bitmap_textures.find(&bitmap);
+    if (it == m_bitmap_textures.end()) {
+        auto texture = TRY(acquire_texture(bitmap.size()));
+        TRY(m_renderer->upload(texture, {}, bitmap, bitmap.physical_rect()));
+        TRY(m_bitmap_textures.try_set(&bitmap, { bitmap, texture }));
+        it = m_bitmap_textures.find(&bitmap);
+    }
+    return draw(screen, it->value.texture, position, bitmap.scale(), source_rect, clip_rect, Color::White, { .source_is_opaque = !bitmap.has_alpha_channel() });
+}
+
+void GPUCompositor::paint_window_frame(Screen& screen, Window& window, Gfx::IntRect const& rect, Gfx::IntPoint transition_offset)
+{
+    if (m_error.has_value())
+        return;
+    if (auto result = paint_window_frame_impl(screen, window, rect, transition_offset); result.is_error())
+        did_fail(result.release_error());
+}
+
+ErrorOr<void> GPUCompositor::paint_window_frame_impl(Screen& screen, Window& window, Gfx::IntRect const& rect, Gfx::IntPoint transition_offset)
+{
+    if (!window.gpu_textures())
+        window.set_gpu_textures(TRY(adopt_nonnull_own_or_enomem(new (nothrow) GPUWindowTextures(*this))));
+    auto& textures = *window.gpu_textures();
+
+    // The frame is painted by the CPU, and only uploaded where it's about to be shown.
+    auto render_rect = window.frame().render_rect();
+    int scale = screen.scale_factor();
+    if (!textures.m_frame_bitmap || textures.m_frame_bitmap->size() != render_rect.size() || textures.m_frame_bitmap->scale() != scale)
+        textures.m_frame_bitmap = TRY(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, render_rect.size(), scale));
+    auto physical_size = render_rect.size() * scale;
+    if (!textures.m_frame_texture.has_value() || textures.m_frame_texture->size.width() < physical_size.width() || textures.m_frame_texture->size.height() < physical_size.height()) {
+        if (textures.m_frame_texture.has_value())
+            release_texture(*textures.m_frame_texture);
+        textures.m_frame_texture.clear();
+        textures.m_frame_texture = TRY(acquire_texture(physical_size));
+    }
+
+    auto local_rect = rect.translated(-transition_offset).intersected(render_rect);
+    if (local_rect.is_empty())
+        return {};
+    {
+        Gfx::Painter painter(*textures.m_frame_bitmap);
+        painter.translate(-render_rect.location());
+        painter.add_clip_rect(local_rect);
+        painter.clear_rect(local_rect, Color::Transparent);
+        window.frame().paint(screen, painter, local_rect);
+    }
+
+    auto source_rect = local_rect.translated(-render_rect.location());
+    TRY(m_renderer->upload(*textures.m_frame_texture, source_rect.location() * scale, *textures.m_frame_bitmap, source_rect * scale));
+    return draw(screen, *textures.m_frame_texture, local_rect.location() + transition_offset, scale, source_rect, rect, Color::White, {});
+}
+
+void GPUCompositor::paint_window_contents(Screen& screen, Window& window, Gfx::IntPoint position, Gfx::IntRect const& source_rect, float opacity, bool darkened_grayscale)
+{
+    if (m_error.has_value())
+        return;
+    if (auto result = paint_window_contents_impl(screen, window, position, source_rect, opacity, darkened_grayscale); result.is_error())
+        did_fail(result.release_error());
+}
+
+ErrorOr<void> GPUCompositor::paint_window_contents_impl(Screen& screen, Window& window, Gfx::IntPoint position, Gfx::IntRect const& source_rect, float opacity, bool darkened_grayscale)
+{
+    auto* bitmap = window.backing_store();
+    if (!bitmap)
+        return {};
+    if (!window.gpu_textures())
+        window.set_gpu_textures(TRY(adopt_nonnull_own_or_enomem(new (nothrow) GPUWindowTextures(*this))));
+    auto& textures = *window.gpu_textures();
+
+    GPUWindowTextures::BackingStore* backing_store = nullptr;
+    for (auto& candidate : textures.m_backing_stores) {
+        if (candidate.bitmap == bitmap)
+            backing_store = &candidate;
+    }
+    if (!backing_store) {
+        // Replace whichever texture doesn't hold the other backing store, which the client is likely to flip back to.
+        auto* last_bitmap = window.last_backing_store();
+        backing_store = textures.m_backing_stores[0].bitmap && textures.m_backing_stores[0].bitmap == last_bitmap ? &textures.m_backing_stores[1] : &textures.m_backing_stores[0];
+        backing_store->bitmap = bitmap;
+        backing_store->stale_rects = Gfx::DisjointIntRectSet { bitmap->rect() };
+
+        auto physical_size = bitmap->physical_size();
+        if (backing_store->texture.has_value() && (backing_store->texture->size.width() < physical_size.width() || backing_store->texture->size.height() < physical_size.height())) {
+            release_texture(*backing_store->texture);
+            backing_store->texture.clear();
+        }
+        if (!backing_store->texture.has_value())
+            backing_store->texture = TRY(acquire_texture(physical_size));
+    }
+
+    auto stale_rects = backing_store->stale_rects.intersected(source_rect);
+    if (!stale_rects.is_empty()) {
+        int scale = bitmap->scale();
+        for (auto& stale_rect : stale_rects.rects())
+            TRY(m_renderer->upload(*backing_store->texture, stale_rect.location() * scale, *bitmap, stale_rect * scale));
+        backing_store->stale_rects = backing_store->stale_rects.shatter(stale_rects);
+    }
+
+    Color color { 255, 255, 255, static_cast<u8>(clamp(opacity, 0.0f, 1.0f) * 255) };
+    VirtGPU::QuadDrawOptions options {
+        .source_is_opaque = window.is_opaque(),
+        .darkened_grayscale = darkened_grayscale,
+    };
+    return draw(screen, *backing_store->texture, position, bitmap->scale(), source_rect, { position, source_rect.size() }, color, options);
+}
+
+void GPUCompositor::did_change_bitmap(Gfx::Bitmap const& bitmap)
+{
+    auto texture = m_bitmap_textures.take(&bitmap);
+    if (texture.has_value())
+        release_texture(texture->texture);
+}
+
+void GPUCompositor::read_back(Screen& screen, Gfx::IntRect const& rect, Gfx::Bitmap& bitmap)
+{
+    if (m_error.has_value())
+        return;
+    auto texture = m_screen_textures.get(&screen);
+    if (!texture.has_value())
+        return;
+    auto clipped_rect = rect.intersected(screen.rect()).translated(-screen.rect().location());
+    if (clipped_rect.is_empty())
+        return;
+
+    auto physical_rect = clipped_rect * screen.scale_factor();
+    if (auto result = m_renderer->read_back(*texture, physical_rect, bitmap, physical_rect.location()); result.is_error())
+        did_fail(result.release_error());
+}
+
+void GPUCompositor::did_change_screens()
+{
+    for (auto& it : m_screen_textures)
+        release_texture(it.value);
+    m_screen_textures.clear();
+    m_target_screen = nullptr;
+}
+
+ErrorOr<void> GPUCompositor::finish_frame()
+{
+    // Let go of the textures of bitmaps that nobody else is holding on to anymore, like old wallpapers.
+    Vector<Gfx::Bitmap const*> unused_bitmaps;
+    for (auto& it : m_bitmap_textures) {
+        if (it.value.bitmap->ref_count() == 1)
+            unused_bitmaps.append(it.key);
+    }
+    for (auto* bitmap : unused_bitmaps)
+        did_change_bitmap(*bitmap);
+
+    if (!m_error.has_value()) {
+        if (auto result = m_renderer->flush(); result.is_error())
+            did_fail(result.release_error());
+    }
+
+    if (m_error.has_value())
+        return m_error.release_value();
+    return {};
+}
+
+}
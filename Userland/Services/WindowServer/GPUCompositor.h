@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2023, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <AK/WeakPtr.h>
+#include <AK/Weakable.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/DisjointRectSet.h>
+#include <LibVirtGPU/QuadRenderer.h>
+
+namespace WindowServer {
+
+class GPUCompositor;
+class Screen;
+class Window;
+
+// The textures holding a window's backing stores and frame, and which parts of the backing stores the client
+// has painted since they were last uploaded.
+class GPUWindowTextures {
+public:
+    explicit GPUWindowTextures(GPUCompositor&);
+    ~GPUWindowTextures();
+
+    void did_invalidate_contents();
+    void did_invalidate_contents(Gfx::IntRect const&);
+
+private:
+    friend class GPUCompositor;
+
+    struct BackingStore {
+        RefPtr<Gfx::Bitmap const> bitmap;
+        Optional<VirtGPU::QuadRenderer::Texture> texture;
+        Gfx::DisjointIntRectSet stale_rects;
+    };
+
+    WeakPtr<GPUCompositor> m_compositor;
+    // Clients flip between two backing stores, so we keep a texture for each.
+    Array<BackingStore, 2> m_backing_stores;
+    RefPtr<Gfx::Bitmap> m_frame_bitmap;
+    Optional<VirtGPU::QuadRenderer::Texture> m_frame_texture;
+};
+
+// Composes the window stack with the host's GPU on VirtIO-GPU machines with 3D support, when
+// WindowServer.ini sets [Graphics] Composition=GPU.
+// The Compositor hands it everything it would otherwise paint into its back and temporary buffers, in the
+// same order: the wallpaper, and the frames and backing stores of windows. Those live in textures, which only
+// get uploaded where they changed, and are blended into a texture for each screen. The rects the Compositor
+// is about to flush are then read back into its buffers, so the cursor, overlays and flushing work as before.
+// NOTE: We read the screens back because the kernel can't scan out a 3D resource.
+class GPUCompositor : public Weakable<GPUCompositor> {
+public:
+    static ErrorOr<NonnullOwnPtr<GPUCompositor>> try_create();
+
+    explicit GPUCompositor(NonnullOwnPtr<VirtGPU::QuadRenderer>);
+
+    // These all take logical rects in screen coordinates, and only paint where they intersect `clip_rect`.
+    void fill_rect(Screen&, Gfx::IntRect const&, Color);
+    void paint_bitmap(Screen&, Gfx::IntPoint, Gfx::Bitmap const&, Gfx::IntRect const& source_rect, Gfx::IntRect const& clip_rect);
+    void paint_window_frame(Screen&, Window&, Gfx::IntRect const&, Gfx::IntPoint transition_offset);
+    void paint_window_contents(Screen&, Window&, Gfx::IntPoint, Gfx::IntRect const& source_rect, float opacity, bool darkened_grayscale);
+
+    // Bitmaps are only uploaded once, unless they're changed in place.
+    void did_change_bitmap(Gfx::Bitmap const&);
+
+    void read_back(Screen&, Gfx::IntRect const&, Gfx::Bitmap&);
+    void did_change_screens();
+
+    // Returns the first error since the last call, after which nothing was painted.
+    ErrorOr<void> finish_frame();
+
+private:
+    friend class GPUWindowTextures;
+
+    ErrorOr<void> target_screen(Screen&);
+    ErrorOr<void> draw(Screen&, VirtGPU::QuadRenderer::Texture const&, Gfx::IntPoint, int source_scale, Gfx::IntRect const& source_rect, Gfx::IntRect const& clip_rect, Color, VirtGPU::QuadDrawOptions);
+    ErrorOr<void> paint_window_contents_impl(Screen&, Window&, Gfx::IntPoint, Gfx::IntRect const& source_rect, float opacity, bool darkened_grayscale);
+    ErrorOr<void> paint_window_frame_impl(Screen&, Window&, Gfx::IntRect const&, Gfx::IntPoint transition_offset);
+    ErrorOr<void> paint_bitmap_impl(Screen&, Gfx::IntPoint, Gfx::Bitmap const&, Gfx::IntRect const& source_rect, Gfx::IntRect const& clip_rect);
+
+    ErrorOr<VirtGPU::QuadRenderer::Texture> acquire_texture(Gfx::IntSize);
+    void release_texture(VirtGPU::QuadRenderer::Texture const&);
+
+    void did_fail(Error);
+
+    NonnullOwnPtr<VirtGPU::QuadRenderer> m_renderer;
+    Vector<VirtGPU::QuadRenderer::Texture> m_free_textures;
+
+    HashMap<Screen const*, VirtGPU::QuadRenderer::Texture> m_screen_textures;
+    Screen const* m_target_screen { nullptr };
+
+    struct BitmapTexture {
+        NonnullRefPtr<Gfx::Bitmap const> bitmap;
+        VirtGPU::QuadRenderer::Texture texture;
+    };
+    HashMap<Gfx::Bitmap const*, BitmapTexture> m_bitmap_textures;
+
+    Optional<Error> m_error;
+};
+
+}
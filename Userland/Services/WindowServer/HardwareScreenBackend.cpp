@@ -33,6 +33,7 @@ ErrorOr<void> HardwareScreenBackend::open()
     m_can_device_flush_buffers = (properties.partial_flushing_support != 0);
     m_can_device_flush_entire_framebuffer = (properties.flushing_support != 0);
     m_can_set_head_buffer = (properties.doublebuffer_support != 0);
+    m_can_use_hardware_cursor = (properties.hardware_cursor_support != 0);
     m_max_size_in_bytes = properties.max_buffer_bytes;
     return {};
 }
@@ -40,6 +41,9 @@ ErrorOr<void> HardwareScreenBackend::open()
 HardwareScreenBackend::~HardwareScreenBackend()
 {
     if (m_display_connector_fd >= 0) {
+        // Don't leave our cursor behind for whoever uses the device next.
+        if (m_can_use_hardware_cursor)
+            [[maybe_unused]] auto result = set_head_cursor({}, {});
         close(m_display_connector_fd);
         m_display_connector_fd = -1;
     }
@@ -162,6 +166,27 @@ ErrorOr<void> HardwareScreenBackend::flush_framebuffer_rects(int buffer_index, R
     return {};
 }
 
+ErrorOr<void> HardwareScreenBackend::set_head_cursor(ReadonlySpan<Gfx::ARGB32> pixels, Gfx::IntPoint hotspot)
+{
+    VERIFY(pixels.is_empty() || pixels.size() == GRAPHICS_HEAD_CURSOR_SIZE * GRAPHICS_HEAD_CURSOR_SIZE);
+    GraphicsHeadCursor cursor {};
+    cursor.hotspot_x = hotspot.x();
+    cursor.hotspot_y = hotspot.y();
+    cursor.pixels = pixels.is_empty() ? nullptr : pixels.data();
+    int rc = graphics_connector_set_head_cursor(m_display_connector_fd, &cursor);
+    if (rc != 0)
+        return Error::from_syscall("graphics_connector_set_head_cursor"sv, rc);
+    return {};
+}
+
+ErrorOr<void> HardwareScreenBackend::move_head_cursor(Gfx::IntPoint position)
+{
+    int rc = graphics_connector_move_head_cursor(m_display_connector_fd, position.x(), position.y());
+    if (rc != 0)
+        return Error::from_syscall("graphics_connector_move_head_cursor"sv, rc);
+    return {};
+}
+
 ErrorOr<void> HardwareScreenBackend::flush_framebuffer()
 {
     int rc = fb_flush_head(m_display_connector_fd);
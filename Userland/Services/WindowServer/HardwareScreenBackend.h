@@ -36,6 +36,9 @@ public:
     virtual ErrorOr<void> set_head_mode_setting(GraphicsHeadModeSetting) override;
     virtual ErrorOr<GraphicsHeadModeSetting> get_head_mode_setting() override;
 
+    virtual ErrorOr<void> set_head_cursor(ReadonlySpan<Gfx::ARGB32> pixels, Gfx::IntPoint hotspot) override;
+    virtual ErrorOr<void> move_head_cursor(Gfx::IntPoint) override;
+
     DeprecatedString m_device {};
     int m_display_connector_fd { -1 };
 
@@ -352,4 +352,31 @@ WindowStackSwitchOverlay::WindowStackSwitchOverlay(Screen& screen, WindowStack&
     set_rect(calculate_frame_rect(Gfx::IntRect({}, m_content_size).inflated(2 * default_screen_rect_margin, 2 * default_screen_rect_margin)).centered_within(screen.rect()));
 }
 
+CompositorStatsOverlay::CompositorStatsOverlay()
+{
+    set_stats(0, 0, 0);
+}
+
+void CompositorStatsOverlay::set_stats(float milliseconds_per_frame, size_t frames_per_second, size_t flushed_rects_per_frame)
+{
+    m_label = DeprecatedString::formatted("{:.2} ms/frame, {} fps, {} rects/frame", milliseconds_per_frame, frames_per_second, flushed_rects_per_frame);
+    update_rect();
+    invalidate_content();
+}
+
+void CompositorStatsOverlay::update_rect()
+{
+    auto& wm = WindowManager::the();
+    Gfx::IntSize label_size { static_cast<int>(ceilf(wm.font().width(m_label))) + 16, wm.font().glyph_height() + 10 };
+    auto desktop_rect = wm.desktop_rect(Screen::main());
+    auto rect = calculate_frame_rect({ {}, label_size });
+    rect.set_location({ desktop_rect.right() + 1 - rect.width() - default_offset, desktop_rect.top() + default_offset });
+    set_rect(rect);
+}
+
+void CompositorStatsOverlay::render_overlay_bitmap(Gfx::Painter& painter)
+{
+    painter.draw_text(Gfx::IntRect { {}, rect().size() }, m_label, WindowManager::the().font(), Gfx::TextAlignment::Center, Color::White);
+}
+
 }
@@ -30,6 +30,7 @@ public:
         Dnd,
         WindowStackSwitch,
         ScreenNumber,
+        CompositorStats,
     };
     [[nodiscard]] virtual ZOrder zorder() const = 0;
     virtual void render(Gfx::Painter&, Screen const&) = 0;
@@ -190,4 +191,21 @@ private:
     int const m_target_column;
 };
 
+class CompositorStatsOverlay : public RectangularOverlay {
+public:
+    static constexpr int default_offset = 8;
+
+    CompositorStatsOverlay();
+
+    void set_stats(float milliseconds_per_frame, size_t frames_per_second, size_t flushed_rects_per_frame);
+
+    virtual ZOrder zorder() const override { return ZOrder::CompositorStats; }
+    virtual void render_overlay_bitmap(Gfx::Painter&) override;
+
+private:
+    void update_rect();
+
+    DeprecatedString m_label;
+};
+
 }
@@ -314,6 +314,20 @@ void Screen::update_bounding_rect()
     }
 }
 
+static int calculate_refresh_rate_in_millihertz(GraphicsHeadModeSetting const& mode_setting)
+{
+    u64 horizontal_total = mode_setting.horizontal_active + mode_setting.horizontal_blank_pixels;
+    u64 vertical_total = mode_setting.vertical_active + mode_setting.vertical_blank_lines;
+    if (mode_setting.pixel_clock_in_khz <= 0 || horizontal_total == 0 || vertical_total == 0)
+        return Screen::default_refresh_rate_in_millihertz;
+
+    auto refresh_rate = static_cast<u64>(mode_setting.pixel_clock_in_khz) * 1'000'000 / (horizontal_total * vertical_total);
+    // Anything outside of this range is more likely to be made up than real.
+    if (refresh_rate < 20'000 || refresh_rate > 500'000)
+        return Screen::default_refresh_rate_in_millihertz;
+    return static_cast<int>(refresh_rate);
+}
+
 bool Screen::set_resolution(bool initial)
 {
     // Remember the screen that the cursor is on. Make sure it stays on the same screen if we change its resolution...
@@ -351,6 +365,7 @@ bool Screen::set_resolution(bool initial)
         }
         auto mode_setting = TRY(m_backend->get_head_mode_setting());
         info.resolution = { mode_setting.horizontal_active, mode_setting.vertical_active };
+        m_refresh_rate_in_millihertz = calculate_refresh_rate_in_millihertz(mode_setting);
 
         update_virtual_and_physical_rects();
 
@@ -395,6 +410,44 @@ size_t Screen::buffer_offset(int index) const
     VERIFY_NOT_REACHED();
 }
 
+ErrorOr<void> Screen::set_hardware_cursor(Gfx::Bitmap const& bitmap, Gfx::IntRect const& source_rect, Gfx::IntPoint hotspot)
+{
+    VERIFY(can_use_hardware_cursor());
+    // The device can't scale the cursor for us, so let the compositor draw cursors that don't fit.
+    if (bitmap.scale() != scale_factor())
+        return Error::from_errno(ENOTSUP);
+    auto physical_source_rect = source_rect * bitmap.scale();
+    if (physical_source_rect.width() > GRAPHICS_HEAD_CURSOR_SIZE || physical_source_rect.height() > GRAPHICS_HEAD_CURSOR_SIZE)
+        return Error::from_errno(ENOTSUP);
+
+    Vector<Gfx::ARGB32> pixels;
+    TRY(pixels.try_resize(GRAPHICS_HEAD_CURSOR_SIZE * GRAPHICS_HEAD_CURSOR_SIZE));
+    for (int y = 0; y < physical_source_rect.height(); ++y) {
+        for (int x = 0; x < physical_source_rect.width(); ++x)
+            pixels[y * GRAPHICS_HEAD_CURSOR_SIZE + x] = bitmap.get_pixel(physical_source_rect.x() + x, physical_source_rect.y() + y).value();
+    }
+
+    auto result = m_backend->set_head_cursor(pixels.span(), hotspot * bitmap.scale());
+    if (result.is_error()) {
+        dbgln("Screen #{}: Failed to set the hardware cursor, drawing it ourselves from now on: {}", index(), result.error());
+        [[maybe_unused]] auto hide_result = m_backend->set_head_cursor({}, {});
+        m_backend->m_can_use_hardware_cursor = false;
+    }
+    return result;
+}
+
+ErrorOr<void> Screen::hide_hardware_cursor()
+{
+    VERIFY(can_use_hardware_cursor());
+    return m_backend->set_head_cursor({}, {});
+}
+
+ErrorOr<void> Screen::move_hardware_cursor(Gfx::IntPoint position)
+{
+    VERIFY(can_use_hardware_cursor());
+    return m_backend->move_head_cursor((position - rect().location()) * scale_factor());
+}
+
 void ScreenInput::set_acceleration_factor(double factor)
 {
     VERIFY(factor >= mouse_accel_min && factor <= mouse_accel_max);
@@ -167,6 +167,10 @@ public:
     Gfx::IntSize size() const { return { m_virtual_rect.width(), m_virtual_rect.height() }; }
     Gfx::IntRect rect() const { return m_virtual_rect; }
 
+    // Devices that don't report their timings are assumed to refresh at 60 Hz.
+    static constexpr int default_refresh_rate_in_millihertz = 60'000;
+    int refresh_rate_in_millihertz() const { return m_refresh_rate_in_millihertz; }
+
     bool can_device_flush_buffers() const { return m_backend->m_can_device_flush_buffers; }
     bool can_device_flush_entire_buffer() const { return m_backend->m_can_device_flush_entire_framebuffer; }
     void queue_flush_display_rect(Gfx::IntRect const& rect);
@@ -174,6 +178,12 @@ public:
     void flush_display_front_buffer(int front_buffer_index, Gfx::IntRect&);
     void flush_display_entire_framebuffer();
 
+    bool can_use_hardware_cursor() const { return m_backend->m_can_use_hardware_cursor; }
+    // These take logical coordinates. The hotspot is relative to `source_rect`, and the position is on the desktop.
+    ErrorOr<void> set_hardware_cursor(Gfx::Bitmap const& bitmap, Gfx::IntRect const& source_rect, Gfx::IntPoint hotspot);
+    ErrorOr<void> hide_hardware_cursor();
+    ErrorOr<void> move_hardware_cursor(Gfx::IntPoint);
+
     CompositorScreenData& compositor_screen_data() { return *m_compositor_screen_data; }
 
 private:
@@ -209,6 +219,7 @@ private:
 
     Gfx::IntRect m_virtual_rect;
     Gfx::IntRect m_physical_rect;
+    int m_refresh_rate_in_millihertz { default_refresh_rate_in_millihertz };
 
     NonnullOwnPtr<FlushRectData> m_flush_rects;
     NonnullOwnPtr<CompositorScreenData> m_compositor_screen_data;
@@ -10,6 +10,7 @@
 #include <AK/Error.h>
 #include <AK/Span.h>
 #include <LibGfx/Color.h>
+#include <LibGfx/Point.h>
 #include <sys/ioctl.h>
 
 namespace WindowServer {
@@ -38,9 +39,15 @@ public:
     virtual ErrorOr<void> set_safe_head_mode_setting() = 0;
     virtual ErrorOr<GraphicsHeadModeSetting> get_head_mode_setting() = 0;
 
+    // The hardware cursor is drawn by the device on top of the framebuffer, so moving it doesn't touch the framebuffer.
+    // The pixels are GRAPHICS_HEAD_CURSOR_SIZE by GRAPHICS_HEAD_CURSOR_SIZE, and no pixels hide the cursor.
+    virtual ErrorOr<void> set_head_cursor(ReadonlySpan<Gfx::ARGB32> pixels, Gfx::IntPoint hotspot) = 0;
+    virtual ErrorOr<void> move_head_cursor(Gfx::IntPoint) = 0;
+
     bool m_can_device_flush_buffers { true };
     bool m_can_device_flush_entire_framebuffer { true };
     bool m_can_set_head_buffer { false };
+    bool m_can_use_hardware_cursor { false };
 
     Gfx::ARGB32* m_framebuffer { nullptr };
     size_t m_size_in_bytes { 0 };
@@ -39,6 +39,9 @@ private:
     virtual ErrorOr<void> set_head_mode_setting(GraphicsHeadModeSetting) override;
     virtual ErrorOr<GraphicsHeadModeSetting> get_head_mode_setting() override;
 
+    virtual ErrorOr<void> set_head_cursor(ReadonlySpan<Gfx::ARGB32>, Gfx::IntPoint) override { return Error::from_errno(ENOTSUP); }
+    virtual ErrorOr<void> move_head_cursor(Gfx::IntPoint) override { return Error::from_errno(ENOTSUP); }
+
     int m_height { 0 };
     int m_width { 0 };
     bool m_first_buffer_active { true };
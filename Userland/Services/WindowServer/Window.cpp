@@ -11,6 +11,7 @@
 #include "ConnectionFromClient.h"
 #include "Event.h"
 #include "EventLoop.h"
+#include "GPUCompositor.h"
 #include "Screen.h"
 #include "WindowManager.h"
 #include <AK/Badge.h>
@@ -577,11 +578,16 @@ void Window::invalidate(bool invalidate_frame, bool re_render_frame)
     if (re_render_frame)
         frame().set_dirty(true);
     m_dirty_rects.clear();
+    if (m_gpu_textures)
+        m_gpu_textures->did_invalidate_contents();
     Compositor::the().invalidate_window();
 }
 
 void Window::invalidate(Gfx::IntRect const& rect, bool invalidate_frame)
 {
+    if (m_gpu_textures)
+        m_gpu_textures->did_invalidate_contents(rect);
+
     if (type() == WindowType::Applet) {
         AppletManager::the().invalidate_applet(*this, rect);
         return;
@@ -639,6 +645,11 @@ void Window::refresh_client_size()
     client()->async_window_resized(m_window_id, m_rect);
 }
 
+void Window::set_gpu_textures(OwnPtr<GPUWindowTextures> textures)
+{
+    m_gpu_textures = move(textures);
+}
+
 void Window::prepare_dirty_rects()
 {
     if (m_invalidated_all) {
@@ -649,12 +660,9 @@ void Window::prepare_dirty_rects()
     } else {
         m_dirty_rects.move_by(frame().render_rect().location());
         if (m_invalidated_frame) {
-            if (m_invalidated) {
-                m_dirty_rects.add(frame().render_rect());
-            } else {
-                for (auto& rects : frame().render_rect().shatter(rect()))
-                    m_dirty_rects.add(rects);
-            }
+            // The parts of the window itself that need to be redrawn are already in m_dirty_rects.
+            for (auto& rects : frame().render_rect().shatter(rect()))
+                m_dirty_rects.add(rects);
         }
     }
 }
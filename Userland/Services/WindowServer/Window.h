@@ -25,6 +25,7 @@ namespace WindowServer {
 class Animation;
 class ConnectionFromClient;
 class Cursor;
+class GPUWindowTextures;
 class KeyEvent;
 class Menu;
 class MenuItem;
@@ -254,6 +255,9 @@ public:
     Gfx::Bitmap* last_backing_store() { return m_last_backing_store.ptr(); }
     i32 last_backing_store_serial() const { return m_last_backing_store_serial; }
 
+    GPUWindowTextures* gpu_textures() { return m_gpu_textures.ptr(); }
+    void set_gpu_textures(OwnPtr<GPUWindowTextures>);
+
     void set_automatic_cursor_tracking_enabled(bool enabled) { m_automatic_cursor_tracking_enabled = enabled; }
     bool is_automatic_cursor_tracking() const { return m_automatic_cursor_tracking_enabled; }
 
@@ -435,6 +439,7 @@ private:
     bool m_occluded { false };
     RefPtr<Gfx::Bitmap> m_backing_store;
     RefPtr<Gfx::Bitmap> m_last_backing_store;
+    OwnPtr<GPUWindowTextures> m_gpu_textures;
     Gfx::IntSize m_backing_store_visible_size {};
     i32 m_backing_store_serial { -1 };
     i32 m_last_backing_store_serial { -1 };
@@ -8,6 +8,7 @@
 #include "Formatter.h"
 #include "Shell.h"
 #include <AK/DeprecatedString.h>
+#include <AK/GenericLexer.h>
 #include <AK/LexicalPath.h>
 #include <AK/ScopeGuard.h>
 #include <AK/Statistics.h>
@@ -18,6 +19,9 @@
 #include <inttypes.h>
 #include <limits.h>
 #include <signal.h>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
@@ -979,6 +983,28 @@ int Shell::builtin_source(int argc, char const** argv)
     return 0;
 }
 
+struct CPUTime {
+    i64 user_ms { 0 };
+    i64 system_ms { 0 };
+};
+
+// The CPU time used by the shell and all its children that have been waited for.
+static CPUTime cpu_time_used()
+{
+    auto to_milliseconds = [](timeval const& time) {
+        return static_cast<i64>(time.tv_sec) * 1000 + time.tv_usec / 1000;
+    };
+
+    rusage self_usage {};
+    rusage children_usage {};
+    getrusage(RUSAGE_SELF, &self_usage);
+    getrusage(RUSAGE_CHILDREN, &children_usage);
+    return {
+        .user_ms = to_milliseconds(self_usage.ru_utime) + to_milliseconds(children_usage.ru_utime),
+        .system_ms = to_milliseconds(self_usage.ru_stime) + to_milliseconds(children_usage.ru_stime),
+    };
+}
+
 int Shell::builtin_time(int argc, char const** argv)
 {
     AST::Command command;
@@ -999,6 +1025,7 @@ int Shell::builtin_time(int argc, char const** argv)
     auto commands = expand_aliases({ move(command) });
 
     AK::Statistics iteration_times;
+    auto cpu_time_before = cpu_time_used();
 
     int exit_code = 1;
     for (int i = 0; i < number_of_iterations; ++i) {
@@ -1010,8 +1037,12 @@ int Shell::builtin_time(int argc, char const** argv)
         iteration_times.add(static_cast<float>(timer.elapsed()));
     }
 
+    auto cpu_time_after = cpu_time_used();
+    auto user_time = cpu_time_after.user_ms - cpu_time_before.user_ms;
+    auto system_time = cpu_time_after.system_ms - cpu_time_before.system_ms;
+
     if (number_of_iterations == 1) {
-        warnln("Time: {} ms", iteration_times.values().first());
+        warnln("Time: {} ms (user: {} ms, system: {} ms)", iteration_times.values().first(), user_time, system_time);
     } else {
         AK::Statistics iteration_times_excluding_first;
         for (size_t i = 1; i < iteration_times.size(); i++)
@@ -1028,6 +1059,9 @@ int Shell::builtin_time(int argc, char const** argv)
             iteration_times_excluding_first.average(), iteration_times_excluding_first.median(),
             iteration_times_excluding_first.standard_deviation(),
             iteration_times_excluding_first.min(), iteration_times_excluding_first.max());
+        warnln("CPU time:        {:.2} ms user, {:.2} ms system per iteration",
+            static_cast<double>(user_time) / number_of_iterations,
+            static_cast<double>(system_time) / number_of_iterations);
     }
 
     return exit_code;
@@ -1214,6 +1248,443 @@ int Shell::builtin_kill(int argc, char const** argv)
     return exit_code;
 }
 
+namespace {
+
+// Evaluates an expression given to `test' or `[' the same way the `test' utility does, but reports problems instead
+// of exiting.
+class TestExpression {
+public:
+    explicit TestExpression(Span<StringView const> arguments)
+        : m_arguments(arguments)
+    {
+    }
+
+    ErrorOr<bool> evaluate()
+    {
+        auto result = TRY(parse_complex_expression());
+        if (m_position != m_arguments.size())
+            return Error::from_string_literal("Too many arguments");
+        return result.value_or(false);
+    }
+
+    bool there_was_an_error() const { return m_there_was_an_error; }
+
+private:
+    bool has_argument(size_t offset = 0) const { return m_position + offset < m_arguments.size(); }
+    StringView peek() const { return has_argument() ? m_arguments[m_position] : StringView {}; }
+    StringView take() { return has_argument() ? m_arguments[m_position++] : StringView {}; }
+
+    static bool should_treat_expression_as_single_string(StringView arg_after)
+    {
+        return arg_after.is_null() || arg_after == "-a"sv || arg_after == "-o"sv;
+    }
+
+    Optional<struct stat> stat_file(StringView path, bool follow_links = true)
+    {
+        struct stat statbuf;
+        auto path_string = DeprecatedString(path);
+        auto rc = follow_links ? stat(path_string.characters(), &statbuf) : lstat(path_string.characters(), &statbuf);
+        if (rc < 0) {
+            if (errno != ENOENT) {
+                perror(path_string.characters());
+                m_there_was_an_error = true;
+            }
+            return {};
+        }
+        return statbuf;
+    }
+
+    ErrorOr<Optional<bool>> evaluate_unary_operator(char op, StringView value)
+    {
+        auto const has_mode = [&](auto predicate, bool follow_links = true) -> bool {
+            auto statbuf = stat_file(value, follow_links);
+            return statbuf.has_value() && predicate(statbuf.value());
+        };
+        auto const has_access = [&](int mode) {
+            return access(DeprecatedString(value).characters(), mode) == 0;
+        };
+
+        switch (op) {
+        case 'b':
+            return Optional<bool> { has_mode([](auto& statbuf) { return S_ISBLK(statbuf.st_mode); }) };
+        case 'c':
+            return Optional<bool> { has_mode([](auto& statbuf) { return S_ISCHR(statbuf.st_mode); }) };
+        case 'd':
+            return Optional<bool> { has_mode([](auto& statbuf) { return S_ISDIR(statbuf.st_mode); }) };
+        case 'f':
+            return Optional<bool> { has_mode([](auto& statbuf) { return S_ISREG(statbuf.st_mode); }) };
+        case 'h':
+        case 'L':
+            return Optional<bool> { has_mode([](auto& statbuf) { return S_ISLNK(statbuf.st_mode); }, false) };
+        case 'p':
+            return Optional<bool> { has_mode([](auto& statbuf) { return S_ISFIFO(statbuf.st_mode); }) };
+        case 'S':
+            return Optional<bool> { has_mode([](auto& statbuf) { return S_ISSOCK(statbuf.st_mode); }) };
+        case 's':
+            return Optional<bool> { has_mode([](auto& statbuf) { return statbuf.st_size > 0; }) };
+        case 'g':
+            return Optional<bool> { has_mode([](auto& statbuf) { return (statbuf.st_mode & S_ISGID) != 0; }) };
+        case 'k':
+            return Optional<bool> { has_mode([](auto& statbuf) { return (statbuf.st_mode & S_ISVTX) != 0; }) };
+        case 'u':
+            return Optional<bool> { has_mode([](auto& statbuf) { return (statbuf.st_mode & S_ISUID) != 0; }) };
+        case 'G':
+            return Optional<bool> { has_mode([](auto& statbuf) { return statbuf.st_gid == getgid(); }) };
+        case 'O':
+            return Optional<bool> { has_mode([](auto& statbuf) { return statbuf.st_uid == getuid(); }) };
+        case 'r':
+            return Optional<bool> { has_access(R_OK) };
+        case 'w':
+            return Optional<bool> { has_access(W_OK) };
+        case 'x':
+            return Optional<bool> { has_access(X_OK) };
+        case 'e':
+            return Optional<bool> { has_access(F_OK) };
+        case 'n':
+            return Optional<bool> { !value.is_empty() };
+        case 'z':
+            return Optional<bool> { value.is_empty() };
+        case 'N':
+            return Error::from_string_literal("Unsupported operator -N");
+        default:
+            return Optional<bool> {};
+        }
+    }
+
+    ErrorOr<Optional<bool>> evaluate_binary_operator(StringView lhs, StringView op, StringView rhs)
+    {
+        auto const compare_numbers = [&](auto compare) -> ErrorOr<bool> {
+            auto lhs_number = lhs.trim_whitespace().to_int();
+            auto rhs_number = rhs.trim_whitespace().to_int();
+            if (!lhs_number.has_value() || !rhs_number.has_value())
+                return Error::from_string_literal("Expected an integer expression");
+            return compare(lhs_number.value(), rhs_number.value());
+        };
+        auto const compare_files = [&](auto compare) -> bool {
+            auto lhs_stat = stat_file(lhs);
+            auto rhs_stat = stat_file(rhs);
+            return lhs_stat.has_value() && rhs_stat.has_value() && compare(lhs_stat.value(), rhs_stat.value());
+        };
+
+        if (op == "="sv)
+            return Optional<bool> { lhs == rhs };
+        if (op == "!="sv)
+            return Optional<bool> { lhs != rhs };
+        if (op == "-eq"sv)
+            return Optional<bool> { TRY(compare_numbers([](int a, int b) { return a == b; })) };
+        if (op == "-ne"sv)
+            return Optional<bool> { TRY(compare_numbers([](int a, int b) { return a != b; })) };
+        if (op == "-gt"sv)
+            return Optional<bool> { TRY(compare_numbers([](int a, int b) { return a > b; })) };
+        if (op == "-ge"sv)
+            return Optional<bool> { TRY(compare_numbers([](int a, int b) { return a >= b; })) };
+        if (op == "-lt"sv)
+            return Optional<bool> { TRY(compare_numbers([](int a, int b) { return a < b; })) };
+        if (op == "-le"sv)
+            return Optional<bool> { TRY(compare_numbers([](int a, int b) { return a <= b; })) };
+        if (op == "-ef"sv)
+            return Optional<bool> { compare_files([](auto& a, auto& b) { return a.st_dev == b.st_dev && a.st_ino == b.st_ino; }) };
+        if (op == "-nt"sv)
+            return Optional<bool> { compare_files([](auto& a, auto& b) { return a.st_mtime > b.st_mtime; }) };
+        if (op == "-ot"sv)
+            return Optional<bool> { compare_files([](auto& a, auto& b) { return a.st_mtime < b.st_mtime; }) };
+        return Optional<bool> {};
+    }
+
+    ErrorOr<Optional<bool>> parse_simple_expression()
+    {
+        if (!has_argument())
+            return Optional<bool> {};
+
+        auto arg = take();
+        if (arg == "("sv) {
+            auto result = TRY(parse_complex_expression());
+            if (!result.has_value() || take() != ")"sv)
+                return Error::from_string_literal("Unmatched (");
+            return result;
+        }
+
+        // Try to read a unary operator.
+        if (arg.starts_with('-') && arg.length() == 2) {
+            if (!has_argument())
+                return Error::from_string_literal("Expected an argument");
+            if (should_treat_expression_as_single_string(peek()))
+                return Optional<bool> { true };
+
+            // '-a' and '-o' are boolean operators, which are part of a complex expression.
+            if (arg == "-a"sv || arg == "-o"sv) {
+                --m_position;
+                return Optional<bool> {};
+            }
+
+            if (auto result = TRY(evaluate_unary_operator(arg[1], peek())); result.has_value()) {
+                take();
+                return result;
+            }
+        }
+
+        // Try to read a binary operator, comparing strings, integers or files.
+        auto op = peek();
+        if (has_argument(1) || op == "="sv || op == "!="sv) {
+            if (auto result = TRY(evaluate_binary_operator(arg, op, has_argument(1) ? m_arguments[m_position + 1] : StringView {})); result.has_value()) {
+                m_position = min(m_position + 2, m_arguments.size());
+                return result;
+            }
+        }
+
+        if (arg == "!"sv && !should_treat_expression_as_single_string(op)) {
+            auto result = TRY(parse_complex_expression());
+            if (!result.has_value())
+                return Error::from_string_literal("Expected an expression after !");
+            return Optional<bool> { !result.value() };
+        }
+
+        return Optional<bool> { !arg.is_empty() };
+    }
+
+    ErrorOr<Optional<bool>> parse_complex_expression()
+    {
+        auto result = TRY(parse_simple_expression());
+
+        while (peek() == "-a"sv || peek() == "-o"sv) {
+            if (!result.has_value())
+                return Error::from_string_literal("Expected an expression");
+
+            auto is_and = take() == "-a"sv;
+            if (!has_argument())
+                return Error::from_string_literal("Expected an expression");
+
+            auto rhs = TRY(parse_complex_expression());
+            if (!rhs.has_value())
+                return Error::from_string_literal("Missing right-hand side");
+
+            result = is_and ? (result.value() && rhs.value()) : (result.value() || rhs.value());
+        }
+
+        return result;
+    }
+
+    Span<StringView const> m_arguments;
+    size_t m_position { 0 };
+    bool m_there_was_an_error { false };
+};
+
+}
+
+int Shell::builtin_test(int argc, char const** argv)
+{
+    Vector<StringView> arguments;
+    for (int i = 1; i < argc; ++i)
+        arguments.append({ argv[i], strlen(argv[i]) });
+
+    if (StringView { argv[0], strlen(argv[0]) } == "["sv) {
+        if (arguments.is_empty() || arguments.last() != "]"sv) {
+            warnln("[: Missing closing ]");
+            return 126;
+        }
+        arguments.take_last();
+    }
+
+    // Exit false when no arguments are given.
+    if (arguments.is_empty())
+        return 1;
+
+    TestExpression expression { arguments };
+    auto result = expression.evaluate();
+    if (result.is_error()) {
+        warnln("{}: {}", argv[0], result.error());
+        return 126;
+    }
+    if (expression.there_was_an_error())
+        return 126;
+    return result.value() ? 0 : 1;
+}
+
+int Shell::builtin_basename(int argc, char const** argv)
+{
+    StringView path;
+    StringView suffix;
+
+    Core::ArgsParser parser;
+    parser.add_positional_argument(path, "Path to get basename from", "path");
+    parser.add_positional_argument(suffix, "Suffix to strip from name", "suffix", Core::ArgsParser::Required::No);
+
+    if (!parser.parse(argc, const_cast<char**>(argv), Core::ArgsParser::FailureBehavior::PrintUsage))
+        return 1;
+
+    auto result = LexicalPath::basename(path);
+    if (!suffix.is_null() && result.length() != suffix.length() && result.ends_with(suffix))
+        result = result.substring_view(0, result.length() - suffix.length());
+
+    outln("{}", result);
+    return 0;
+}
+
+int Shell::builtin_dirname(int argc, char const** argv)
+{
+    StringView path;
+
+    Core::ArgsParser parser;
+    parser.add_positional_argument(path, "Path", "path");
+
+    if (!parser.parse(argc, const_cast<char**>(argv), Core::ArgsParser::FailureBehavior::PrintUsage))
+        return 1;
+
+    outln("{}", LexicalPath::dirname(path));
+    return 0;
+}
+
+// Appends the character for the escape sequence after a backslash, and returns false for \c, which ends the output.
+static ErrorOr<bool> append_printf_escape(StringBuilder& builder, GenericLexer& lexer)
+{
+    if (lexer.is_eof()) {
+        builder.append('\\');
+        return true;
+    }
+
+    auto c = lexer.consume();
+    switch (c) {
+    case 'a':
+        builder.append('\a');
+        break;
+    case 'b':
+        builder.append('\b');
+        break;
+    case 'c':
+        return false;
+    case 'e':
+        builder.append('\e');
+        break;
+    case 'f':
+        builder.append('\f');
+        break;
+    case 'n':
+        builder.append('\n');
+        break;
+    case 'r':
+        builder.append('\r');
+        break;
+    case 't':
+        builder.append('\t');
+        break;
+    case 'v':
+        builder.append('\v');
+        break;
+    case 'x':
+    case 'u':
+    case 'U':
+        return Error::from_string_literal("Unsupported escape");
+    default:
+        builder.append(c);
+    }
+    return true;
+}
+
+template<typename T>
+static void append_with_c_format(StringBuilder& builder, DeprecatedString const& format, T value)
+{
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+    auto length = snprintf(nullptr, 0, format.characters(), value);
+    if (length <= 0)
+        return;
+    Vector<char> buffer;
+    buffer.resize(length + 1);
+    snprintf(buffer.data(), buffer.size(), format.characters(), value);
+#pragma GCC diagnostic pop
+    builder.append({ buffer.data(), static_cast<size_t>(length) });
+}
+
+int Shell::builtin_printf(int argc, char const** argv)
+{
+    if (argc < 2) {
+        warnln("printf: Missing format");
+        return 1;
+    }
+
+    StringView format { argv[1], strlen(argv[1]) };
+    Span<char const*> arguments { argv + 2, static_cast<size_t>(argc - 2) };
+    size_t next_argument = 0;
+    auto take_argument = [&]() -> char const* {
+        return next_argument < arguments.size() ? arguments[next_argument++] : "";
+    };
+
+    StringBuilder builder;
+    auto const print_once = [&]() -> ErrorOr<bool> {
+        GenericLexer lexer { format };
+        while (!lexer.is_eof()) {
+            if (lexer.consume_specific('\\')) {
+                if (!TRY(append_printf_escape(builder, lexer)))
+                    return false;
+                continue;
+            }
+            if (!lexer.consume_specific('%')) {
+                builder.append(lexer.consume());
+                continue;
+            }
+            if (lexer.consume_specific('%')) {
+                builder.append('%');
+                continue;
+            }
+
+            // The flags, width and precision are handed to the C library's printf as they are.
+            auto specification = lexer.consume_while(is_any_of("-+ #0123456789."sv));
+            if (lexer.is_eof())
+                return Error::from_string_literal("Incomplete conversion specification");
+            auto conversion = lexer.consume();
+            auto argument = take_argument();
+
+            switch (conversion) {
+            case 'c': {
+                // This prints the first character of the argument, and nothing for an empty one.
+                auto flags_and_width = specification.substring_view(0, specification.find('.').value_or(specification.length()));
+                append_with_c_format(builder, DeprecatedString::formatted("%{}.1s", flags_and_width), argument);
+                break;
+            }
+            case 'd':
+            case 'i':
+                append_with_c_format(builder, DeprecatedString::formatted("%{}ll{}", specification, conversion), strtoll(argument, nullptr, 0));
+                break;
+            case 'o':
+            case 'u':
+            case 'x':
+            case 'X':
+                append_with_c_format(builder, DeprecatedString::formatted("%{}ll{}", specification, conversion), strtoull(argument, nullptr, 0));
+                break;
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+                append_with_c_format(builder, DeprecatedString::formatted("%{}{}", specification, conversion), strtod(argument, nullptr));
+                break;
+            case 's':
+                append_with_c_format(builder, DeprecatedString::formatted("%{}s", specification), argument);
+                break;
+            default:
+                return Error::from_string_literal("Unsupported conversion");
+            }
+        }
+        return true;
+    };
+
+    // The format is reused for as long as there are arguments left for it.
+    do {
+        auto previous_argument = next_argument;
+        auto result = print_once();
+        if (result.is_error()) {
+            warnln("printf: {}", result.error());
+            return 1;
+        }
+        if (!result.value() || next_argument == previous_argument)
+            break;
+    } while (next_argument < arguments.size());
+
+    out("{}", builder.string_view());
+    return 0;
+}
+
 bool Shell::run_builtin(const AST::Command& command, NonnullRefPtrVector<AST::Rewiring> const& rewirings, int& retval)
 {
     if (command.argv.is_empty())
@@ -1245,6 +1716,8 @@ bool Shell::run_builtin(const AST::Command& command, NonnullRefPtrVector<AST::Re
 
     if (name == ":"sv)
         name = "noop"sv;
+    else if (name == "["sv)
+        name = "test"sv;
 
 #define __ENUMERATE_SHELL_BUILTIN(builtin)                               \
     if (name == #builtin) {                                              \
@@ -1680,7 +2153,7 @@ int Shell::builtin_argsparser_parse(int argc, char const** argv)
 
 bool Shell::has_builtin(StringView name) const
 {
-    if (name == ":"sv)
+    if (name == ":"sv || name == "["sv)
         return true;
 
 #define __ENUMERATE_SHELL_BUILTIN(builtin) \
@@ -11,6 +11,7 @@
 #include <AK/Debug.h>
 #include <AK/Function.h>
 #include <AK/GenericLexer.h>
+#include <AK/HashTable.h>
 #include <AK/JsonParser.h>
 #include <AK/LexicalPath.h>
 #include <AK/QuickSort.h>
@@ -566,11 +567,6 @@ int Shell::run_command(StringView cmd, Optional<SourcePosition> source_position_
     // should not be used for execution!
     VERIFY(!m_default_constructed);
 
-    take_error();
-
-    if (!last_return_code.has_value())
-        last_return_code = 0;
-
     ScopedValueRollback source_position_rollback { m_source_position };
     if (source_position_override.has_value())
         m_source_position = move(source_position_override);
@@ -578,10 +574,21 @@ int Shell::run_command(StringView cmd, Optional<SourcePosition> source_position_
     if (!m_source_position.has_value())
         m_source_position = SourcePosition { .source_file = {}, .literal_source_text = cmd, .position = {} };
 
-    if (cmd.is_empty())
-        return 0;
+    RefPtr<AST::Node> command;
+    if (!cmd.is_empty())
+        command = parse(cmd, m_is_interactive);
+
+    return run_parsed_command(command);
+}
 
-    auto command = parse(cmd, m_is_interactive);
+int Shell::run_parsed_command(RefPtr<AST::Node> const& command)
+{
+    VERIFY(!m_default_constructed);
+
+    take_error();
+
+    if (!last_return_code.has_value())
+        last_return_code = 0;
 
     if (!command)
         return 0;
@@ -1055,8 +1062,44 @@ bool Shell::run_file(DeprecatedString const& filename, bool explicitly_invoked)
         return false;
     }
     auto file = file_result.value();
-    auto data = file->read_all();
-    return run_command(data) == 0;
+
+    struct stat st;
+    if (fstat(file->fd(), &st) < 0) {
+        auto data = file->read_all();
+        return run_command(data) == 0;
+    }
+
+    auto is_same_file = [&](ParsedFile const& entry) {
+        return entry.device == st.st_dev
+            && entry.inode == st.st_ino
+            && entry.modification_time.tv_sec == st.st_mtim.tv_sec
+            && entry.modification_time.tv_nsec == st.st_mtim.tv_nsec
+            && entry.size == st.st_size
+            && entry.parsed_in_posix_mode == m_in_posix_mode;
+    };
+
+    auto it = m_parsed_file_cache.find(filename);
+    if (it == m_parsed_file_cache.end() || !is_same_file(it->value)) {
+        auto data = file->read_all();
+        if (m_parsed_file_cache.size() >= MaxParsedFileCacheSize && it == m_parsed_file_cache.end())
+            m_parsed_file_cache.clear();
+
+        // The stat() was done on the open file, so the entry describes exactly the contents it was parsed from.
+        m_parsed_file_cache.set(filename,
+            ParsedFile {
+                .device = st.st_dev,
+                .inode = st.st_ino,
+                .modification_time = st.st_mtim,
+                .size = st.st_size,
+                .parsed_in_posix_mode = m_in_posix_mode,
+                .node = data.is_empty() ? nullptr : parse(data, false),
+            });
+        it = m_parsed_file_cache.find(filename);
+    }
+
+    // The entry may be replaced while the file runs (e.g. if it sources itself), so hold on to the AST.
+    auto node = it->value.node;
+    return run_parsed_command(node) == 0;
 }
 
 bool Shell::is_allowed_to_modify_termios(const AST::Command& command) const
@@ -1344,45 +1387,102 @@ void Shell::cache_path()
     if (!cached_path.is_empty())
         cached_path.clear_with_capacity();
 
+    // Earlier kinds take precedence over later ones, and PATH directories over the ones after them.
+    HashTable<DeprecatedString> seen_names;
+    auto append_if_unseen = [&](RunnablePath::Kind kind, DeprecatedString name) {
+        if (seen_names.set(name) != HashSetResult::InsertedNewEntry)
+            return;
+        cached_path.append({ kind, move(name) });
+    };
+
     // Add shell builtins to the cache.
     for (auto const& builtin_name : builtin_names)
-        cached_path.append({ RunnablePath::Kind::Builtin, escape_token(builtin_name) });
+        append_if_unseen(RunnablePath::Kind::Builtin, escape_token(builtin_name));
 
     // Add functions to the cache.
-    for (auto& function : m_functions) {
-        auto name = escape_token(function.key);
-        if (cached_path.contains_slow(name))
-            continue;
-        cached_path.append({ RunnablePath::Kind::Function, name });
-    }
+    for (auto& function : m_functions)
+        append_if_unseen(RunnablePath::Kind::Function, escape_token(function.key));
 
     // Add aliases to the cache.
-    for (auto const& alias : m_aliases) {
-        auto name = escape_token(alias.key);
-        if (cached_path.contains_slow(name))
-            continue;
-        cached_path.append({ RunnablePath::Kind::Alias, name });
-    }
+    for (auto const& alias : m_aliases)
+        append_if_unseen(RunnablePath::Kind::Alias, escape_token(alias.key));
 
     // TODO: Can we make this rely on Core::DeprecatedFile::resolve_executable_from_environment()?
     DeprecatedString path = getenv("PATH");
+    Vector<DeprecatedString> directories;
     if (!path.is_empty()) {
-        auto directories = path.split(':');
+        directories = path.split(':');
         for (auto const& directory : directories) {
             Core::DirIterator programs(directory.characters(), Core::DirIterator::SkipDots);
             while (programs.has_next()) {
                 auto program = programs.next_path();
-                auto program_path = DeprecatedString::formatted("{}/{}", directory, program);
                 auto escaped_name = escape_token(program);
-                if (cached_path.contains_slow(escaped_name))
+                if (seen_names.contains(escaped_name))
                     continue;
+                auto program_path = DeprecatedString::formatted("{}/{}", directory, program);
                 if (access(program_path.characters(), X_OK) == 0)
-                    cached_path.append({ RunnablePath::Kind::Executable, escaped_name });
+                    append_if_unseen(RunnablePath::Kind::Executable, move(escaped_name));
             }
         }
     }
 
     quick_sort(cached_path);
+
+    watch_path_directories(directories);
+}
+
+void Shell::watch_path_directories(Vector<DeprecatedString> const& directories)
+{
+    if (!m_path_watcher) {
+        auto watcher_or_error = Core::FileWatcher::create(Core::FileWatcherFlags::CloseOnExec);
+        if (watcher_or_error.is_error()) {
+            dbgln("Failed to create a watcher for the PATH directories: {}", watcher_or_error.error());
+            return;
+        }
+        m_path_watcher = watcher_or_error.release_value();
+        m_path_watcher->on_change = [this](auto& event) { handle_path_directory_change(event); };
+    }
+
+    for (auto const& directory : m_watched_path_directories) {
+        if (!directories.contains_slow(directory))
+            (void)m_path_watcher->remove_watch(directory);
+    }
+
+    m_watched_path_directories.clear_with_capacity();
+    for (auto const& directory : directories) {
+        if (directory.is_empty() || m_watched_path_directories.contains_slow(directory))
+            continue;
+        if (!m_path_watcher->is_watching(directory)) {
+            auto result = m_path_watcher->add_watch(directory, Core::FileWatcherEvent::Type::ChildCreated | Core::FileWatcherEvent::Type::ChildDeleted);
+            if (result.is_error() || !result.value())
+                continue;
+        }
+        m_watched_path_directories.append(directory);
+    }
+}
+
+void Shell::handle_path_directory_change(Core::FileWatcherEvent const& event)
+{
+    auto program = LexicalPath::basename(event.event_path);
+    auto escaped_name = escape_token(program);
+
+    if (has_flag(event.type, Core::FileWatcherEvent::Type::ChildCreated)) {
+        if (access(event.event_path.characters(), X_OK) == 0)
+            add_entry_to_cache({ RunnablePath::Kind::Executable, move(escaped_name) });
+        return;
+    }
+
+    if (has_flag(event.type, Core::FileWatcherEvent::Type::ChildDeleted)) {
+        // Builtins, functions and aliases don't go away with the file, and neither does a program that's in another
+        // directory in PATH as well.
+        size_t index = 0;
+        auto* entry = binary_search(cached_path.span(), escaped_name.view(), &index, RunnablePathComparator {});
+        if (!entry || entry->kind != RunnablePath::Kind::Executable)
+            return;
+        if (Core::DeprecatedFile::resolve_executable_from_environment(program).has_value())
+            return;
+        cached_path.remove(index);
+    }
 }
 
 void Shell::add_entry_to_cache(RunnablePath const& entry)
@@ -18,42 +18,47 @@
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
+#include <LibCore/FileWatcher.h>
 #include <LibCore/Notifier.h>
 #include <LibCore/Object.h>
 #include <LibLine/Editor.h>
 #include <termios.h>
 
-#define ENUMERATE_SHELL_BUILTINS()     \
-    __ENUMERATE_SHELL_BUILTIN(alias)   \
-    __ENUMERATE_SHELL_BUILTIN(where)   \
-    __ENUMERATE_SHELL_BUILTIN(cd)      \
-    __ENUMERATE_SHELL_BUILTIN(cdh)     \
-    __ENUMERATE_SHELL_BUILTIN(pwd)     \
-    __ENUMERATE_SHELL_BUILTIN(type)    \
-    __ENUMERATE_SHELL_BUILTIN(exec)    \
-    __ENUMERATE_SHELL_BUILTIN(exit)    \
-    __ENUMERATE_SHELL_BUILTIN(export)  \
-    __ENUMERATE_SHELL_BUILTIN(glob)    \
-    __ENUMERATE_SHELL_BUILTIN(unalias) \
-    __ENUMERATE_SHELL_BUILTIN(unset)   \
-    __ENUMERATE_SHELL_BUILTIN(history) \
-    __ENUMERATE_SHELL_BUILTIN(umask)   \
-    __ENUMERATE_SHELL_BUILTIN(not )    \
-    __ENUMERATE_SHELL_BUILTIN(dirs)    \
-    __ENUMERATE_SHELL_BUILTIN(pushd)   \
-    __ENUMERATE_SHELL_BUILTIN(popd)    \
-    __ENUMERATE_SHELL_BUILTIN(setopt)  \
-    __ENUMERATE_SHELL_BUILTIN(shift)   \
-    __ENUMERATE_SHELL_BUILTIN(source)  \
-    __ENUMERATE_SHELL_BUILTIN(time)    \
-    __ENUMERATE_SHELL_BUILTIN(jobs)    \
-    __ENUMERATE_SHELL_BUILTIN(disown)  \
-    __ENUMERATE_SHELL_BUILTIN(fg)      \
-    __ENUMERATE_SHELL_BUILTIN(bg)      \
-    __ENUMERATE_SHELL_BUILTIN(wait)    \
-    __ENUMERATE_SHELL_BUILTIN(dump)    \
-    __ENUMERATE_SHELL_BUILTIN(kill)    \
-    __ENUMERATE_SHELL_BUILTIN(noop)    \
+#define ENUMERATE_SHELL_BUILTINS()      \
+    __ENUMERATE_SHELL_BUILTIN(alias)    \
+    __ENUMERATE_SHELL_BUILTIN(where)    \
+    __ENUMERATE_SHELL_BUILTIN(cd)       \
+    __ENUMERATE_SHELL_BUILTIN(cdh)      \
+    __ENUMERATE_SHELL_BUILTIN(pwd)      \
+    __ENUMERATE_SHELL_BUILTIN(type)     \
+    __ENUMERATE_SHELL_BUILTIN(exec)     \
+    __ENUMERATE_SHELL_BUILTIN(exit)     \
+    __ENUMERATE_SHELL_BUILTIN(export)   \
+    __ENUMERATE_SHELL_BUILTIN(glob)     \
+    __ENUMERATE_SHELL_BUILTIN(unalias)  \
+    __ENUMERATE_SHELL_BUILTIN(unset)    \
+    __ENUMERATE_SHELL_BUILTIN(history)  \
+    __ENUMERATE_SHELL_BUILTIN(umask)    \
+    __ENUMERATE_SHELL_BUILTIN(not )     \
+    __ENUMERATE_SHELL_BUILTIN(dirs)     \
+    __ENUMERATE_SHELL_BUILTIN(pushd)    \
+    __ENUMERATE_SHELL_BUILTIN(popd)     \
+    __ENUMERATE_SHELL_BUILTIN(setopt)   \
+    __ENUMERATE_SHELL_BUILTIN(shift)    \
+    __ENUMERATE_SHELL_BUILTIN(source)   \
+    __ENUMERATE_SHELL_BUILTIN(time)     \
+    __ENUMERATE_SHELL_BUILTIN(jobs)     \
+    __ENUMERATE_SHELL_BUILTIN(disown)   \
+    __ENUMERATE_SHELL_BUILTIN(fg)       \
+    __ENUMERATE_SHELL_BUILTIN(bg)       \
+    __ENUMERATE_SHELL_BUILTIN(wait)     \
+    __ENUMERATE_SHELL_BUILTIN(dump)     \
+    __ENUMERATE_SHELL_BUILTIN(kill)     \
+    __ENUMERATE_SHELL_BUILTIN(noop)     \
+    __ENUMERATE_SHELL_BUILTIN(test)     \
+    __ENUMERATE_SHELL_BUILTIN(basename) \
+    __ENUMERATE_SHELL_BUILTIN(dirname)  \
+    __ENUMERATE_SHELL_BUILTIN(printf)   \
     __ENUMERATE_SHELL_BUILTIN(argsparser_parse)
 
 #define ENUMERATE_SHELL_OPTIONS()                                                                                    \
@@ -403,6 +408,9 @@ private:
     Optional<int> resolve_job_spec(StringView);
     void add_entry_to_cache(RunnablePath const&);
     void remove_entry_from_cache(StringView);
+    void watch_path_directories(Vector<DeprecatedString> const&);
+    void handle_path_directory_change(Core::FileWatcherEvent const&);
+    int run_parsed_command(RefPtr<AST::Node> const&);
     void stop_all_jobs();
     Job const* m_current_job { nullptr };
     LocalFrame* find_frame_containing_local_variable(StringView name);
@@ -442,6 +450,7 @@ private:
 #undef __ENUMERATE_SHELL_BUILTIN
 
             ":"sv, // POSIX-y name for "noop".
+            "["sv, // Name for "test" that expects a closing "]".
     };
 
     bool m_should_ignore_jobs_on_next_exit { false };
@@ -478,6 +487,22 @@ private:
 
     Optional<size_t> m_history_autosave_time;
 
+    // Keeps the executables in cached_path up to date as programs are added to and removed from the PATH directories.
+    RefPtr<Core::FileWatcher> m_path_watcher;
+    Vector<DeprecatedString> m_watched_path_directories;
+
+    // Files that are sourced more than once (e.g. from a loop or a function) are only parsed again after they've changed.
+    struct ParsedFile {
+        dev_t device { 0 };
+        ino_t inode { 0 };
+        struct timespec modification_time {};
+        off_t size { 0 };
+        bool parsed_in_posix_mode { false };
+        RefPtr<AST::Node> node;
+    };
+    static constexpr size_t MaxParsedFileCacheSize = 32;
+    HashMap<DeprecatedString, ParsedFile> m_parsed_file_cache;
+
     StackInfo m_completion_stack_info;
 };
 
@@ -0,0 +1,29 @@
+#!/bin/Shell
+
+source $(dirname "$0")/test-commons.inc
+
+# These are builtins, so they must behave like the utilities of the same name.
+if not [ "$(type test)" = "test is a shell builtin" ] { fail "'test' is not a builtin" }
+if not [ "$(type [)" = "[ is a shell builtin" ] { fail "'[' is not a builtin" }
+
+if not test a = a { fail "'test' string equality" }
+if test a = b { fail "'test' string inequality" }
+if not test 3 -gt 2 -a 2 -le 2 { fail "'test' numeric comparison" }
+if test -z "x" -o -n "" { fail "'test' -z and -n" }
+if not test ! -e /this/does/not/exist { fail "'test' negation" }
+if not test -d / { fail "'test' -d" }
+if not [ \( a = b \) -o a = a ] { fail "'test' parentheses" }
+
+test 1 -eq one 2> /dev/null
+if not test $? -eq 126 { fail "'test' does not fail on a malformed expression" }
+
+if not test "$(basename /usr/bin/Shell)" = "Shell" { fail "'basename' of a path" }
+if not test "$(basename /tmp/file.txt .txt)" = "file" { fail "'basename' with a suffix" }
+if not test "$(dirname /usr/bin/Shell)" = "/usr/bin" { fail "'dirname' of a path" }
+if not test "$(dirname file)" = "." { fail "'dirname' of a file name" }
+
+if not test "$(printf '%s-%d' a 42)" = "a-42" { fail "'printf' conversions" }
+if not test "$(printf '%03d,' 1 2 3)" = "001,002,003," { fail "'printf' reusing its format" }
+if not test "$(printf '%5s|%-3s|%x' ab c 255)" = "   ab|c  |ff" { fail "'printf' widths" }
+
+echo PASS
@@ -7,6 +7,7 @@
 #include <AK/NumericLimits.h>
 #include <AK/Types.h>
 #include <LibAudio/Loader.h>
+#include <LibAudio/Resampler.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/DeprecatedFile.h>
 #include <LibCore/ElapsedTimer.h>
@@ -21,11 +22,13 @@ ErrorOr<int> serenity_main(Main::Arguments args)
 {
     StringView path {};
     int sample_count = -1;
+    int resample_rate = -1;
 
     Core::ArgsParser args_parser;
     args_parser.set_general_help("Benchmark audio loading");
     args_parser.add_positional_argument(path, "Path to audio file", "path");
     args_parser.add_option(sample_count, "How many samples to load at maximum", "sample-count", 's', "samples");
+    args_parser.add_option(resample_rate, "Also benchmark resampling the loaded samples to this sample rate", "resample-to", 'r', "rate");
     args_parser.parse(args);
 
     TRY(Core::System::unveil(Core::DeprecatedFile::absolute_path(path), "r"sv));
@@ -39,6 +42,12 @@ ErrorOr<int> serenity_main(Main::Arguments args)
     }
     auto loader = maybe_loader.release_value();
 
+    Optional<Audio::SincResampler> resampler;
+    if (resample_rate > 0)
+        resampler = TRY(Audio::SincResampler::try_create(loader->sample_rate(), static_cast<u32>(resample_rate)));
+    Vector<Audio::Sample> resampled_samples;
+    i64 total_resampler_time = 0;
+
     Core::ElapsedTimer sample_timer { true };
     i64 total_loader_time = 0;
     int remaining_samples = sample_count > 0 ? sample_count : NumericLimits<int>::max();
@@ -54,6 +63,13 @@ ErrorOr<int> serenity_main(Main::Arguments args)
                 total_loaded_samples += samples.value().size();
                 if (samples.value().size() == 0)
                     break;
+
+                if (resampler.has_value()) {
+                    resampled_samples.clear_with_capacity();
+                    sample_timer = sample_timer.start_new();
+                    TRY(resampler->try_resample_into_end(resampled_samples, samples.value().span()));
+                    total_resampler_time += sample_timer.elapsed();
+                }
             } else {
                 warnln("Error while loading audio: {}", samples.error().description);
                 return 1;
@@ -67,5 +83,10 @@ ErrorOr<int> serenity_main(Main::Arguments args)
 
     outln("Loaded {:10d} samples in {:06.3f} s, {:9.3f} µs/sample, {:6.1f}% speed (realtime {:9.3f} µs/sample)", total_loaded_samples, static_cast<double>(total_loader_time) / 1000., time_per_sample, playback_time_per_sample / time_per_sample * 100., playback_time_per_sample);
 
+    if (resampler.has_value()) {
+        auto resample_time_per_sample = static_cast<double>(total_resampler_time) / static_cast<double>(total_loaded_samples) * 1000.;
+        outln("Resampled to {} Hz in {:06.3f} s, {:9.3f} µs/sample, {:6.1f}% speed", resample_rate, static_cast<double>(total_resampler_time) / 1000., resample_time_per_sample, playback_time_per_sample / resample_time_per_sample * 100.);
+    }
+
     return 0;
 }
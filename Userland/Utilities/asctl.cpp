@@ -20,7 +20,9 @@
 enum AudioVariable : u32 {
     Volume,
     Mute,
-    SampleRate
+    SampleRate,
+    BufferSize,
+    Latency,
 };
 
 // asctl: audio server control utility
@@ -37,7 +39,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     Core::ArgsParser args_parser;
     args_parser.set_general_help("Send control signals to the audio server and hardware.");
     args_parser.add_option(human_mode, "Print human-readable output", "human-readable", 'h');
-    args_parser.add_positional_argument(command, "Command, either (g)et or (s)et\n\n\tThe get command accepts a list of variables to print.\n\tThey are printed in the given order.\n\tIf no value is specified, all are printed.\n\n\tThe set command accepts a any number of variables\n\tfollowed by the value they should be set to.\n\n\tPossible variables are (v)olume, (m)ute, sample(r)ate.\n", "command");
+    args_parser.add_positional_argument(command, "Command, either (g)et or (s)et\n\n\tThe get command accepts a list of variables to print.\n\tThey are printed in the given order.\n\tIf no value is specified, all are printed.\n\n\tThe set command accepts a any number of variables\n\tfollowed by the value they should be set to.\n\n\tPossible variables are (v)olume, (m)ute, sample(r)ate.\n\tThe get command also accepts (b)uffersize and (l)atency.\n", "command");
     args_parser.add_positional_argument(command_arguments, "Arguments for the command", "args", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
@@ -51,6 +53,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             values_to_print.append(AudioVariable::Volume);
             values_to_print.append(AudioVariable::Mute);
             values_to_print.append(AudioVariable::SampleRate);
+            values_to_print.append(AudioVariable::BufferSize);
+            values_to_print.append(AudioVariable::Latency);
         } else {
             for (auto& variable : command_arguments) {
                 if (variable.is_one_of("v"sv, "volume"sv))
@@ -59,6 +63,10 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                     values_to_print.append(AudioVariable::Mute);
                 else if (variable.is_one_of("r"sv, "samplerate"sv))
                     values_to_print.append(AudioVariable::SampleRate);
+                else if (variable.is_one_of("b"sv, "buffersize"sv))
+                    values_to_print.append(AudioVariable::BufferSize);
+                else if (variable.is_one_of("l"sv, "latency"sv))
+                    values_to_print.append(AudioVariable::Latency);
                 else {
                     warnln("Error: Unrecognized variable {}", variable);
                     return 1;
@@ -92,6 +100,25 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                     out("{} ", sample_rate);
                 break;
             }
+            case AudioVariable::BufferSize: {
+                u32 buffer_size = audio_client->get_buffer_size();
+                if (human_mode)
+                    outln("Buffer size: {} samples", buffer_size);
+                else
+                    out("{} ", buffer_size);
+                break;
+            }
+            case AudioVariable::Latency: {
+                // How long one buffer of the mixer plays for, which is how far ahead of the device it runs.
+                u32 sample_rate = audio_client->get_sample_rate();
+                u32 buffer_size = audio_client->get_buffer_size();
+                auto latency = sample_rate == 0 ? 0.0 : static_cast<double>(buffer_size) * 1000 / sample_rate;
+                if (human_mode)
+                    outln("Latency: {:.1} ms", latency);
+                else
+                    out("{:.1} ", latency);
+                break;
+            }
             }
         }
         if (!human_mode)
@@ -158,6 +185,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                 audio_client->set_sample_rate(sample_rate);
                 break;
             }
+            case AudioVariable::BufferSize:
+            case AudioVariable::Latency:
+                VERIFY_NOT_REACHED();
             }
         }
     }
@@ -17,7 +17,7 @@
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
-    TRY(Core::System::pledge("stdio rpath"));
+    TRY(Core::System::pledge("stdio rpath wpath cpath"));
     auto hostname = TRY(Core::System::gethostname());
 
     Core::ArgsParser args_parser;
@@ -7,6 +7,7 @@
 #include <AK/DeprecatedString.h>
 #include <AK/LexicalPath.h>
 #include <AK/NumberFormat.h>
+#include <AK/StringBuilder.h>
 #include <AK/Vector.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/DateTime.h>
@@ -14,6 +15,7 @@
 #include <LibCore/File.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <LibThreading/ThreadPool.h>
 #include <limits.h>
 #include <string.h>
 
@@ -37,7 +39,7 @@ struct DuOption {
 };
 
 static ErrorOr<void> parse_args(Main::Arguments arguments, Vector<DeprecatedString>& files, DuOption& du_option);
-static ErrorOr<u64> print_space_usage(DeprecatedString const& path, DuOption const& du_option, size_t current_depth, bool inside_dir = false);
+static ErrorOr<u64> print_space_usage(DeprecatedString const& path, DuOption const& du_option, size_t current_depth, StringBuilder& output, bool inside_dir = false);
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
@@ -46,8 +48,12 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     TRY(parse_args(arguments, files, du_option));
 
-    for (auto const& file : files)
-        TRY(print_space_usage(file, du_option, 0));
+    for (auto const& file : files) {
+        StringBuilder output;
+        auto result = print_space_usage(file, du_option, 0, output);
+        out("{}", output.string_view());
+        TRY(result);
+    }
 
     return 0;
 }
@@ -135,7 +141,9 @@ ErrorOr<void> parse_args(Main::Arguments arguments, Vector<DeprecatedString>& fi
     return {};
 }
 
-ErrorOr<u64> print_space_usage(DeprecatedString const& path, DuOption const& du_option, size_t current_depth, bool inside_dir)
+// The output is collected instead of printed, since the entries of a directory are looked at in parallel, but have to be
+// printed in order.
+ErrorOr<u64> print_space_usage(DeprecatedString const& path, DuOption const& du_option, size_t current_depth, StringBuilder& output, bool inside_dir)
 {
     u64 size = 0;
     struct stat path_stat = TRY(Core::System::lstat(path));
@@ -143,13 +151,29 @@ ErrorOr<u64> print_space_usage(DeprecatedString const& path, DuOption const& du_
     if (is_directory) {
         auto di = Core::DirIterator(path, Core::DirIterator::SkipParentAndBaseDir);
         if (di.has_error()) {
-            outln("du: cannot read directory '{}': {}", path, di.error_string());
+            output.appendff("du: cannot read directory '{}': {}\n", path, di.error_string());
             return Error::from_string_literal("An error occurred. See previous error.");
         }
 
-        while (di.has_next()) {
-            auto const child_path = di.next_full_path();
-            size += TRY(print_space_usage(child_path, du_option, current_depth + 1, true));
+        Vector<DeprecatedString> child_paths;
+        while (di.has_next())
+            child_paths.append(di.next_full_path());
+
+        // Waiting on the disk for one entry at a time is what takes the longest, so the pool has a few of them at once.
+        struct ChildResult {
+            ErrorOr<u64> size { 0 };
+            StringBuilder output;
+        };
+        Vector<ChildResult> child_results;
+        child_results.resize(child_paths.size());
+        Threading::parallel_for(child_paths.size(), [&](size_t i) {
+            auto& result = child_results[i];
+            result.size = print_space_usage(child_paths[i], du_option, current_depth + 1, result.output, true);
+        });
+
+        for (auto& result : child_results) {
+            output.append(result.output.string_view());
+            size += TRY(result.size);
         }
     }
 
@@ -175,15 +199,15 @@ ErrorOr<u64> print_space_usage(DeprecatedString const& path, DuOption const& du_
         return size;
 
     if (du_option.human_readable) {
-        out("{}", human_readable_size(size));
+        output.append(human_readable_size(size));
     } else if (du_option.human_readable_si) {
-        out("{}", human_readable_size(size, AK::HumanReadableBasedOn::Base10));
+        output.append(human_readable_size(size, AK::HumanReadableBasedOn::Base10));
     } else {
-        out("{}", ceil_div(size, du_option.block_size));
+        output.appendff("{}", ceil_div(size, du_option.block_size));
     }
 
     if (du_option.time_type == DuOption::TimeType::NotUsed) {
-        outln("\t{}", path);
+        output.appendff("\t{}\n", path);
     } else {
         auto time = path_stat.st_mtime;
         switch (du_option.time_type) {
@@ -198,7 +222,7 @@ ErrorOr<u64> print_space_usage(DeprecatedString const& path, DuOption const& du_
         }
 
         auto const formatted_time = Core::DateTime::from_timestamp(time).to_deprecated_string();
-        outln("\t{}\t{}", formatted_time, path);
+        output.appendff("\t{}\t{}\n", formatted_time, path);
     }
 
     return { size };
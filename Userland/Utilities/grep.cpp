@@ -4,9 +4,13 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
 #include <AK/Assertions.h>
+#include <AK/Atomic.h>
+#include <AK/ByteSearch.h>
 #include <AK/DeprecatedString.h>
 #include <AK/LexicalPath.h>
+#include <AK/MemMem.h>
 #include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
 #include <AK/Vector.h>
@@ -14,9 +18,12 @@
 #include <LibCore/DeprecatedFile.h>
 #include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
 #include <LibRegex/Regex.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/ThreadPool.h>
 #include <stdio.h>
 #include <unistd.h>
 
@@ -50,9 +57,45 @@ static DeprecatedString escape_characters(StringView string, StringView characte
     return builder.to_deprecated_string();
 }
 
+// What searching one file came up with, which is only printed once the files before it are done.
+struct SearchResult {
+    StringBuilder output;
+    size_t matched_line_count { 0 };
+    bool did_match { false };
+    Optional<Error> error;
+};
+
+struct FileContents {
+    RefPtr<Core::MappedFile> mapped_file;
+    ByteBuffer buffer;
+
+    StringView view() const { return mapped_file ? StringView { mapped_file->bytes() } : StringView { buffer.bytes() }; }
+};
+
+static ErrorOr<FileContents> read_file(StringView filename)
+{
+    // Mapping the file saves copying it, but that doesn't work for everything (e.g. empty files or pipes).
+    if (auto mapped_file = Core::MappedFile::map(filename); !mapped_file.is_error())
+        return FileContents { mapped_file.release_value(), {} };
+
+    auto file = TRY(Core::File::open(filename, Core::File::OpenMode::Read));
+    return FileContents { nullptr, TRY(file->read_until_eof()) };
+}
+
+static size_t count_newlines(StringView text)
+{
+    size_t count = 0;
+    auto bytes = text.bytes();
+    for (auto index = find_byte(bytes, '\n'); index.has_value(); index = find_byte(bytes, '\n')) {
+        ++count;
+        bytes = bytes.slice(*index + 1);
+    }
+    return count;
+}
+
 ErrorOr<int> serenity_main(Main::Arguments args)
 {
-    TRY(Core::System::pledge("stdio rpath"));
+    TRY(Core::System::pledge("stdio rpath thread"));
 
     DeprecatedString program_name = AK::LexicalPath::basename(args.strings[0]);
 
@@ -71,7 +114,6 @@ ErrorOr<int> serenity_main(Main::Arguments args)
     bool colored_output = isatty(STDOUT_FILENO);
     bool count_lines = false;
 
-    size_t matched_line_count = 0;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(recursive, "Recursively scan files", "recursive", 'r');
@@ -160,6 +202,20 @@ ErrorOr<int> serenity_main(Main::Arguments args)
     if (case_insensitive)
         options |= PosixFlags::Insensitive;
 
+    // If all patterns match only themselves, the lines that contain none of them can be skipped without running the
+    // regex engine on them at all.
+    Vector<DeprecatedString> literal_patterns;
+    if (!case_insensitive && !invert_match) {
+        auto special_characters = use_ere ? ere_special_characters : basic_special_characters;
+        for (auto const& pattern : patterns) {
+            if (pattern.is_empty() || (!fixed_strings && any_of(pattern, [&](char ch) { return special_characters.contains(ch); }))) {
+                literal_patterns.clear();
+                break;
+            }
+            literal_patterns.append(pattern);
+        }
+    }
+
     auto grep_logic = [&](auto&& regular_expressions) {
         for (auto& re : regular_expressions) {
             if (re.parser_result.error != regex::Error::NoError) {
@@ -168,41 +224,46 @@ ErrorOr<int> serenity_main(Main::Arguments args)
             }
         }
 
-        auto matches = [&](StringView str, StringView filename, size_t line_number, bool print_filename, bool is_binary) {
+        using RegexType = RemoveCVReference<decltype(regular_expressions[0])>;
+
+        auto matches = [&](Vector<RegexType> const& regular_expressions, StringView str, StringView filename, size_t line_number, bool print_filename, bool is_binary, SearchResult& result) {
             size_t last_printed_char_pos { 0 };
             if (is_binary && binary_mode == BinaryFileMode::Skip)
                 return false;
 
             for (auto& re : regular_expressions) {
-                auto result = re.match(str, PosixFlags::Global);
-                if (!(result.success ^ invert_match))
+                auto match_result = re.match(str, PosixFlags::Global);
+                if (!(match_result.success ^ invert_match))
                     continue;
 
                 if (quiet_mode)
                     return true;
 
                 if (count_lines) {
-                    matched_line_count++;
+                    result.matched_line_count++;
                     return true;
                 }
 
+                auto& output = result.output;
                 if (is_binary && binary_mode == BinaryFileMode::Binary) {
-                    outln(colored_output ? "binary file \x1B[34m{}\x1B[0m matches"sv : "binary file {} matches"sv, filename);
+                    output.appendff(colored_output ? "binary file \x1B[34m{}\x1B[0m matches"sv : "binary file {} matches"sv, filename);
+                    output.append('\n');
                 } else {
-                    if ((result.matches.size() || invert_match) && print_filename)
-                        out(colored_output ? "\x1B[34m{}:\x1B[0m"sv : "{}:"sv, filename);
-                    if ((result.matches.size() || invert_match) && line_numbers)
-                        out(colored_output ? "\x1B[35m{}:\x1B[0m"sv : "{}:"sv, line_number);
+                    if ((match_result.matches.size() || invert_match) && print_filename)
+                        output.appendff(colored_output ? "\x1B[34m{}:\x1B[0m"sv : "{}:"sv, filename);
+                    if ((match_result.matches.size() || invert_match) && line_numbers)
+                        output.appendff(colored_output ? "\x1B[35m{}:\x1B[0m"sv : "{}:"sv, line_number);
 
-                    for (auto& match : result.matches) {
+                    for (auto& match : match_result.matches) {
                         auto pre_match_length = match.global_offset - last_printed_char_pos;
-                        out(colored_output ? "{}\x1B[32m{}\x1B[0m"sv : "{}{}"sv,
+                        output.appendff(colored_output ? "{}\x1B[32m{}\x1B[0m"sv : "{}{}"sv,
                             pre_match_length > 0 ? StringView(&str[last_printed_char_pos], pre_match_length) : ""sv,
                             match.view.to_deprecated_string());
                         last_printed_char_pos = match.global_offset + match.view.length();
                     }
                     auto remaining_length = str.length() - last_printed_char_pos;
-                    outln("{}", remaining_length > 0 ? StringView(&str[last_printed_char_pos], remaining_length) : ""sv);
+                    output.append(remaining_length > 0 ? StringView(&str[last_printed_char_pos], remaining_length) : ""sv);
+                    output.append('\n');
                 }
 
                 return true;
@@ -211,45 +272,154 @@ ErrorOr<int> serenity_main(Main::Arguments args)
             return false;
         };
 
-        bool did_match_something = false;
+        auto search_contents = [&](Vector<RegexType> const& regular_expressions, StringView contents, StringView filename, bool print_filename, SearchResult& result) {
+            // Without literal patterns every line is a candidate, otherwise only the lines that contain one of them.
+            Vector<Optional<size_t>> next_literal_offsets;
+            next_literal_offsets.resize(literal_patterns.size());
+            auto next_candidate_line = [&](size_t position) -> Optional<size_t> {
+                if (literal_patterns.is_empty())
+                    return position;
+
+                auto candidate = NumericLimits<size_t>::max();
+                for (size_t i = 0; i < literal_patterns.size(); ++i) {
+                    auto& offset = next_literal_offsets[i];
+                    if (!offset.has_value() || *offset < position) {
+                        auto const& literal = literal_patterns[i];
+                        auto found = AK::memmem_optional(contents.characters_without_null_termination() + position, contents.length() - position, literal.characters(), literal.length());
+                        offset = found.has_value() ? position + *found : NumericLimits<size_t>::max();
+                    }
+                    candidate = min(candidate, *offset);
+                }
+                if (candidate == NumericLimits<size_t>::max())
+                    return {};
+
+                // The position is always at the start of a line, which is as far back as we need to look.
+                while (candidate > position && contents[candidate - 1] != '\n')
+                    --candidate;
+                return candidate;
+            };
+
+            size_t line_number = 1;
+            size_t line_number_position = 0;
+            size_t position = 0;
+            while (position < contents.length()) {
+                auto line_start = next_candidate_line(position);
+                if (!line_start.has_value())
+                    break;
 
-        auto handle_file = [&matches, binary_mode, count_lines, quiet_mode,
-                               user_specified_multiple_files, &matched_line_count, &did_match_something](StringView filename, bool print_filename) -> ErrorOr<void> {
-            auto file = TRY(Core::File::open(filename, Core::File::OpenMode::Read));
-            auto buffered_file = TRY(Core::BufferedFile::create(move(file)));
+                auto rest = contents.substring_view(*line_start);
+                auto line = rest.substring_view(0, find_byte(rest.bytes(), '\n').value_or(rest.length()));
+                position = *line_start + line.length() + 1;
 
-            for (size_t line_number = 1; TRY(buffered_file->can_read_line()); ++line_number) {
-                Array<u8, PAGE_SIZE> buffer;
-                auto line = TRY(buffered_file->read_line(buffer));
+                if (line_numbers) {
+                    line_number += count_newlines(contents.substring_view(line_number_position, *line_start - line_number_position));
+                    line_number_position = *line_start;
+                }
 
                 auto is_binary = line.contains('\0');
 
-                auto matched = matches(line, filename, line_number, print_filename, is_binary);
-                did_match_something = did_match_something || matched;
-                if (matched && is_binary && binary_mode == BinaryFileMode::Binary)
+                auto matched = matches(regular_expressions, line, filename, line_number, print_filename, is_binary, result);
+                result.did_match = result.did_match || matched;
+                if (matched && (quiet_mode || (is_binary && binary_mode == BinaryFileMode::Binary)))
                     break;
             }
 
             if (count_lines && !quiet_mode) {
                 if (user_specified_multiple_files)
-                    outln("{}:{}", filename, matched_line_count);
+                    result.output.appendff("{}:{}\n", filename, result.matched_line_count);
                 else
-                    outln("{}", matched_line_count);
-                matched_line_count = 0;
+                    result.output.appendff("{}\n", result.matched_line_count);
+            }
+        };
+
+        auto search_file = [&](Vector<RegexType> const& regular_expressions, StringView filename, bool print_filename, SearchResult& result) {
+            auto contents = read_file(filename);
+            if (contents.is_error()) {
+                result.error = contents.release_error();
+                return;
+            }
+            search_contents(regular_expressions, contents.value().view(), filename, print_filename, result);
+        };
+
+        bool did_match_something = false;
+
+        // The matchers keep state while they run, so every thread that searches files at the same time needs its own.
+        Vector<Vector<RegexType>> spare_regular_expressions;
+        Threading::Mutex spare_regular_expressions_mutex;
+        auto search_files = [&](Vector<DeprecatedString> const& filenames, bool print_filename, bool stop_at_error) -> bool {
+            Vector<SearchResult> results;
+            results.resize(filenames.size());
+
+            if (filenames.size() == 1) {
+                search_file(regular_expressions, filenames.first(), print_filename, results.first());
+            } else {
+                auto& pool = Threading::ThreadPool::the();
+                if (spare_regular_expressions.is_empty()) {
+                    for (size_t i = 0; i <= pool.worker_count(); ++i) {
+                        Vector<RegexType> copies;
+                        for (auto& re : regular_expressions)
+                            copies.append(RegexType(re.pattern_value, options));
+                        spare_regular_expressions.append(move(copies));
+                    }
+                }
+
+                Atomic<bool> found_match { false };
+                Threading::parallel_for(filenames.size(), [&](size_t i) {
+                    // Once something matched, quiet mode has its answer.
+                    if (quiet_mode && found_match.load(AK::MemoryOrder::memory_order_relaxed))
+                        return;
+
+                    Vector<RegexType> own_regular_expressions;
+                    {
+                        Threading::MutexLocker locker { spare_regular_expressions_mutex };
+                        own_regular_expressions = spare_regular_expressions.take_last();
+                    }
+
+                    search_file(own_regular_expressions, filenames[i], print_filename, results[i]);
+                    if (results[i].did_match)
+                        found_match.store(true, AK::MemoryOrder::memory_order_relaxed);
+
+                    Threading::MutexLocker locker { spare_regular_expressions_mutex };
+                    spare_regular_expressions.append(move(own_regular_expressions));
+                });
             }
 
-            return {};
+            // The files are searched in any order, but their results are printed in the order they were given in.
+            for (size_t i = 0; i < filenames.size(); ++i) {
+                auto& result = results[i];
+                if (result.error.has_value()) {
+                    if (!suppress_errors)
+                        warnln("Failed with file {}: {}", filenames[i], result.error.release_value());
+                    if (stop_at_error)
+                        return false;
+                    continue;
+                }
+                out("{}", result.output.string_view());
+                did_match_something = did_match_something || result.did_match;
+            }
+            return true;
         };
 
-        auto add_directory = [&handle_file, user_has_specified_files, suppress_errors](DeprecatedString base, Optional<DeprecatedString> recursive, auto handle_directory) -> void {
+        // Found files are searched in batches, so that the output starts before the whole tree has been walked.
+        static constexpr size_t files_per_batch = 256;
+        Vector<DeprecatedString> pending_files;
+        auto flush_pending_files = [&] {
+            if (pending_files.is_empty())
+                return;
+            if (!(quiet_mode && did_match_something))
+                search_files(pending_files, true, false);
+            pending_files.clear_with_capacity();
+        };
+
+        auto add_directory = [&pending_files, &flush_pending_files, user_has_specified_files](DeprecatedString base, Optional<DeprecatedString> recursive, auto handle_directory) -> void {
             Core::DirIterator it(recursive.value_or(base), Core::DirIterator::Flags::SkipDots);
             while (it.has_next()) {
                 auto path = it.next_full_path();
                 if (!Core::DeprecatedFile::is_directory(path)) {
-                    auto key = user_has_specified_files ? path.view() : path.substring_view(base.length() + 1, path.length() - base.length() - 1);
-                    if (auto result = handle_file(key, true); result.is_error() && !suppress_errors)
-                        warnln("Failed with file {}: {}", key, result.release_error());
-
+                    auto key = user_has_specified_files ? path : path.substring(base.length() + 1, path.length() - base.length() - 1);
+                    pending_files.append(move(key));
+                    if (pending_files.size() >= files_per_batch)
+                        flush_pending_files();
                 } else {
                     handle_directory(base, path, handle_directory);
                 }
@@ -262,6 +432,7 @@ ErrorOr<int> serenity_main(Main::Arguments args)
             ssize_t nread = 0;
             ScopeGuard free_line = [line] { free(line); };
             size_t line_number = 0;
+            SearchResult result;
             while ((nread = getline(&line, &line_len, stdin)) != -1) {
                 VERIFY(nread > 0);
                 if (line[nread - 1] == '\n')
@@ -274,14 +445,16 @@ ErrorOr<int> serenity_main(Main::Arguments args)
                 if (is_binary && binary_mode == BinaryFileMode::Skip)
                     return 1;
 
-                auto matched = matches(line_view, "stdin"sv, line_number, false, is_binary);
+                auto matched = matches(regular_expressions, line_view, "stdin"sv, line_number, false, is_binary, result);
                 did_match_something = did_match_something || matched;
+                out("{}", result.output.string_view());
+                result.output.clear();
                 if (matched && is_binary && binary_mode == BinaryFileMode::Binary)
                     break;
             }
 
             if (count_lines && !quiet_mode)
-                outln("{}", matched_line_count);
+                outln("{}", result.matched_line_count);
         } else {
             if (recursive) {
                 if (user_has_specified_files) {
@@ -291,17 +464,12 @@ ErrorOr<int> serenity_main(Main::Arguments args)
                 } else {
                     add_directory(".", {}, add_directory);
                 }
+                flush_pending_files();
 
             } else {
                 bool print_filename { files.size() > 1 };
-                for (auto& filename : files) {
-                    auto result = handle_file(filename, print_filename);
-                    if (result.is_error()) {
-                        if (!suppress_errors)
-                            warnln("Failed with file {}: {}", filename, result.release_error());
-                        return 1;
-                    }
-                }
+                if (!search_files(files, print_filename, true))
+                    return 1;
             }
         }
 
@@ -10,6 +10,7 @@
 #include <LibCore/MappedFile.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <LibThreading/ThreadPool.h>
 #include <unistd.h>
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
@@ -18,17 +19,23 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool keep_input_files { false };
     bool write_to_stdout { false };
     bool decompress { false };
+    size_t thread_count { 1 };
 
     Core::ArgsParser args_parser;
     args_parser.add_option(keep_input_files, "Keep (don't delete) input files", "keep", 'k');
     args_parser.add_option(write_to_stdout, "Write to stdout, keep original files unchanged", "stdout", 'c');
     args_parser.add_option(decompress, "Decompress", "decompress", 'd');
+    args_parser.add_option(thread_count, "Compress on this many threads (0 for one per processor)", "threads", 'T', "count");
     args_parser.add_positional_argument(filenames, "Files", "FILES");
     args_parser.parse(arguments);
 
     if (write_to_stdout)
         keep_input_files = true;
 
+    OwnPtr<Threading::ThreadPool> thread_pool;
+    if (!decompress && thread_count != 1)
+        thread_pool = TRY(try_make<Threading::ThreadPool>(thread_count == 0 ? Threading::ThreadPool::default_worker_count() : thread_count));
+
     for (auto const& input_filename : filenames) {
         DeprecatedString output_filename;
         if (decompress) {
@@ -54,7 +61,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         if (decompress)
             output_bytes = TRY(Compress::GzipDecompressor::decompress_all(input_bytes));
         else
-            output_bytes = TRY(Compress::GzipCompressor::compress_all(input_bytes));
+            output_bytes = TRY(Compress::GzipCompressor::compress_all(input_bytes, thread_pool.ptr()));
 
         auto output_stream = write_to_stdout ? TRY(Core::File::standard_output()) : TRY(Core::File::open(output_filename, Core::File::OpenMode::Write));
         TRY(output_stream->write_entire_buffer(output_bytes));
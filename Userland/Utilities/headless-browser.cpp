@@ -8,6 +8,7 @@
 #include <AK/ByteBuffer.h>
 #include <AK/Format.h>
 #include <AK/HashTable.h>
+#include <AK/JsonObject.h>
 #include <AK/LexicalPath.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/StringBuilder.h>
@@ -34,7 +35,9 @@
 #include <LibMain/Main.h>
 #include <LibWeb/Cookie/ParsedCookie.h>
 #include <LibWeb/DOM/Document.h>
+#include <LibWeb/Dump.h>
 #include <LibWeb/HTML/BrowsingContext.h>
+#include <LibWeb/HighResolutionTime/TimeOrigin.h>
 #include <LibWeb/Layout/InitialContainingBlock.h>
 #include <LibWeb/Loader/ResourceLoader.h>
 #include <LibWeb/Page/Page.h>
@@ -47,6 +50,7 @@
 #include <LibWebSocket/Message.h>
 #include <LibWebSocket/WebSocket.h>
 #include <WebContent/WebDriverConnection.h>
+#include <sys/resource.h>
 
 class HeadlessBrowserPageClient final : public Web::PageClient {
 public:
@@ -75,7 +79,8 @@ public:
     {
         Gfx::Painter painter(target);
 
-        if (auto* document = page().top_level_browsing_context().active_document())
+        auto* document = page().top_level_browsing_context().active_document();
+        if (document)
             document->update_layout();
 
         painter.fill_rect({ {}, content_rect.size().to_type<int>() }, palette().base());
@@ -85,11 +90,13 @@ public:
             return;
         }
 
+        auto start_time = Web::HighResolutionTime::unsafe_shared_current_time();
         Web::PaintContext context(painter, palette(), device_pixels_per_css_pixel());
         context.set_should_show_line_box_borders(false);
         context.set_device_viewport_rect(content_rect);
         context.set_has_focus(true);
         layout_root->paint_all_phases(context);
+        document->last_rendering_timings().paint = Web::HighResolutionTime::unsafe_shared_current_time() - start_time;
     }
 
     void setup_palette(Core::AnonymousBuffer theme_buffer)
@@ -150,10 +157,23 @@ public:
     {
     }
 
+    virtual void page_did_create_main_document() override
+    {
+        m_document_creation_time = Web::HighResolutionTime::unsafe_shared_current_time();
+    }
+
     virtual void page_did_finish_loading(AK::URL const&) override
     {
+        // NOTE: The main document is parsed in one go once it has been fetched, so this is how long parsing took.
+        m_parse_time = Web::HighResolutionTime::unsafe_shared_current_time() - m_document_creation_time;
+        if (on_finish_loading)
+            on_finish_loading();
     }
 
+    double parse_time() const { return m_parse_time; }
+
+    Function<void()> on_finish_loading;
+
     virtual void page_did_change_selection() override
     {
     }
@@ -251,6 +271,8 @@ private:
 
     RefPtr<Gfx::PaletteImpl> m_palette_impl;
     Web::DevicePixelRect m_screen_rect { 0, 0, 800, 600 };
+    double m_document_creation_time { 0 };
+    double m_parse_time { 0 };
     Web::CSS::PreferredColorScheme m_preferred_color_scheme { Web::CSS::PreferredColorScheme::Auto };
 
     RefPtr<WebContent::WebDriverConnection> m_webdriver;
@@ -679,7 +701,7 @@ private:
     HeadlessWebSocketClientManager() { }
 };
 
-static void load_page_for_screenshot_and_exit(HeadlessBrowserPageClient& page_client, int take_screenshot_after)
+static void load_page_for_screenshot_and_exit(HeadlessBrowserPageClient& page_client, int take_screenshot_after, bool dump_rendering_timings)
 {
     dbgln("Taking screenshot after {} seconds", take_screenshot_after);
 
@@ -703,12 +725,67 @@ static void load_page_for_screenshot_and_exit(HeadlessBrowserPageClient& page_cl
             auto image_buffer = MUST(Gfx::PNGWriter::encode(output_bitmap));
             MUST(output_file->write(image_buffer.bytes()));
 
+            if (dump_rendering_timings) {
+                if (auto* document = page_client.page().top_level_browsing_context().active_document())
+                    Web::dump_rendering_timings(*document);
+            }
+
             exit(0);
         }).release_value_but_fixme_should_propagate_errors();
 
     timer->start();
 }
 
+static size_t peak_memory_usage_in_bytes()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) < 0)
+        return 0;
+#if defined(AK_OS_MACOS)
+    return usage.ru_maxrss;
+#else
+    return usage.ru_maxrss * KiB;
+#endif
+}
+
+// Prints how long each phase of rendering the page took, and the peak memory usage of the process, as JSON.
+static void run_benchmark_and_exit(HeadlessBrowserPageClient& page_client, StringView url)
+{
+    page_client.on_finish_loading = [&page_client, url] {
+        // NOTE: Let anything that was queued while parsing run first, so it doesn't end up in our measurements.
+        Core::deferred_invoke([&page_client, url] {
+            auto* document = page_client.page().top_level_browsing_context().active_document();
+            if (!document) {
+                warnln("Failed to load {}", url);
+                exit(1);
+            }
+
+            // NOTE: Style and layout have likely happened in bits and pieces while loading already.
+            //       Redo them from scratch, so that every run measures the same amount of work.
+            document->invalidate_style();
+            auto style_start_time = Web::HighResolutionTime::unsafe_shared_current_time();
+            document->update_style();
+            auto layout_start_time = Web::HighResolutionTime::unsafe_shared_current_time();
+            document->force_layout();
+            auto paint_start_time = Web::HighResolutionTime::unsafe_shared_current_time();
+            auto output_bitmap = MUST(Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, page_client.screen_rect().size().to_type<int>()));
+            page_client.paint(page_client.screen_rect(), output_bitmap);
+            auto end_time = Web::HighResolutionTime::unsafe_shared_current_time();
+
+            JsonObject result;
+            result.set("url", url);
+            result.set("parse_ms", page_client.parse_time());
+            result.set("style_ms", layout_start_time - style_start_time);
+            result.set("layout_ms", paint_start_time - layout_start_time);
+            result.set("paint_ms", end_time - paint_start_time);
+            result.set("peak_memory_bytes", static_cast<u64>(peak_memory_usage_in_bytes()));
+            outln("{}", result.to_deprecated_string());
+
+            exit(0);
+        });
+    };
+}
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     int take_screenshot_after = 1;
@@ -717,6 +794,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     StringView error_page_url;
     StringView ca_certs_path;
     StringView webdriver_ipc_path;
+    bool dump_rendering_timings = false;
+    bool benchmark = false;
 
     Core::EventLoop event_loop;
     Core::ArgsParser args_parser;
@@ -726,6 +805,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(error_page_url, "URL for the error page (defaults to file:///res/html/error.html)", "error-page", 'e', "error-page-url");
     args_parser.add_option(ca_certs_path, "The bundled ca certificates file", "certs", 'c', "ca-certs-path");
     args_parser.add_option(webdriver_ipc_path, "Path to the WebDriver IPC socket", "webdriver-ipc-path", 0, "path");
+    args_parser.add_option(dump_rendering_timings, "Dump the timings of the last rendering update after taking the screenshot", "dump-rendering-timings", 0);
+    args_parser.add_option(benchmark, "Print how long parsing, style, layout and paint took for the page as JSON, then exit", "benchmark", 0);
     args_parser.add_positional_argument(url, "URL to open", "url", Core::ArgsParser::Required::Yes);
     args_parser.parse(arguments);
 
@@ -766,6 +847,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         page_client->setup_palette(system_theme);
     }
 
+    if (benchmark)
+        run_benchmark_and_exit(*page_client, url);
+
     dbgln("Loading {}", url);
     page_client->load(AK::URL(url));
 
@@ -775,8 +859,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     if (!webdriver_ipc_path.is_empty())
         TRY(page_client->connect_to_webdriver(webdriver_ipc_path));
-    else
-        load_page_for_screenshot_and_exit(*page_client, take_screenshot_after);
+    else if (!benchmark)
+        load_page_for_screenshot_and_exit(*page_client, take_screenshot_after, dump_rendering_timings);
 
     return event_loop.exec();
 }
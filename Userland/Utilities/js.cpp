@@ -19,11 +19,14 @@
 #include <LibJS/Print.h>
 #include <LibJS/Runtime/ConsoleObject.h>
 #include <LibJS/Runtime/JSONObject.h>
+#include <LibJS/Runtime/Shape.h>
 #include <LibJS/Runtime/StringPrototype.h>
 #include <LibJS/Runtime/ThrowableStringBuilder.h>
+#include <LibJS/SamplingProfiler.h>
 #include <LibJS/SourceTextModule.h>
 #include <LibLine/Editor.h>
 #include <LibMain/Main.h>
+#include <LibRegex/Regex.h>
 #include <LibTextCodec/Decoder.h>
 #include <signal.h>
 
@@ -76,6 +79,10 @@ static bool s_as_module = false;
 static bool s_print_last_result = false;
 static bool s_strip_ansi = false;
 static bool s_disable_source_location_hints = false;
+static bool s_dump_regex_cache_statistics = false;
+static bool s_dump_shape_statistics = false;
+static StringView s_profile_path;
+static OwnPtr<JS::SamplingProfiler> s_sampling_profiler;
 static RefPtr<Line::Editor> s_editor;
 static String s_history_path = String {};
 static int s_repl_line_level = 0;
@@ -415,8 +422,41 @@ JS_DEFINE_NATIVE_FUNCTION(ReplObject::save_to_file)
     return JS::Value(false);
 }
 
+static void write_profile_if_requested()
+{
+    if (!s_sampling_profiler)
+        return;
+    auto trace = s_sampling_profiler->to_chrome_trace();
+    auto file_or_error = Core::File::open(s_profile_path, Core::File::OpenMode::Write, 0666);
+    if (file_or_error.is_error()) {
+        warnln("Failed to open {} for writing the profile: {}", s_profile_path, file_or_error.error());
+        return;
+    }
+    if (auto result = file_or_error.value()->write_entire_buffer(trace.bytes()); result.is_error()) {
+        warnln("Failed to write the profile to {}: {}", s_profile_path, result.error());
+        return;
+    }
+    warnln("Wrote {} samples to {}", s_sampling_profiler->sample_count(), s_profile_path);
+}
+
+static void dump_statistics_if_requested()
+{
+    write_profile_if_requested();
+    if (s_dump_regex_cache_statistics) {
+        auto statistics = Regex<ECMA262>::compiled_pattern_cache_statistics();
+        warnln("Compiled regex cache: {} hits, {} misses, {} patterns cached", statistics.hits, statistics.misses, statistics.size);
+    }
+    if (s_dump_shape_statistics) {
+        auto statistics = JS::Shape::statistics(g_vm->heap());
+        warnln("Shapes: {} live, {} unique", statistics.shape_count, statistics.unique_shape_count);
+        warnln("Shape property tables: {} tables, {} entries", statistics.shapes_with_property_table, statistics.property_table_entry_count);
+        warnln("Shape transitions: {} forward, {} prototype", statistics.forward_transition_count, statistics.prototype_transition_count);
+    }
+}
+
 JS_DEFINE_NATIVE_FUNCTION(ReplObject::exit_interpreter)
 {
+    dump_statistics_if_requested();
     if (!vm.argument_count())
         exit(0);
     exit(TRY(vm.argument(0).to_number(vm)).as_double());
@@ -589,7 +629,7 @@ private:
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
-    TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction"));
+    TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction prot_exec"));
 
     bool gc_on_every_allocation = false;
     bool disable_syntax_highlight = false;
@@ -602,16 +642,24 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
     args_parser.add_option(s_run_bytecode, "Run the bytecode", "run-bytecode", 'b');
     args_parser.add_option(s_opt_bytecode, "Optimize the bytecode", "optimize-bytecode", 'p');
+    args_parser.add_option(JS::Bytecode::g_jit_enabled, "Compile hot bytecode to machine code", "jit", 'j');
     args_parser.add_option(s_as_module, "Treat as module", "as-module", 'm');
     args_parser.add_option(s_print_last_result, "Print last result", "print-last-result", 'l');
     args_parser.add_option(s_strip_ansi, "Disable ANSI colors", "disable-ansi-colors", 'i');
     args_parser.add_option(s_disable_source_location_hints, "Disable source location hints", "disable-source-location-hints", 'h');
+    args_parser.add_option(s_dump_regex_cache_statistics, "Dump compiled regex cache statistics on exit", "dump-regex-cache-statistics", 0);
+    args_parser.add_option(s_dump_shape_statistics, "Dump shape statistics on exit", "dump-shapes", 0);
+    args_parser.add_option(s_profile_path, "Write a sampling profile of the JS call stack to a Chrome trace file", "profile", 0, "path");
     args_parser.add_option(gc_on_every_allocation, "GC on every allocation", "gc-on-every-allocation", 'g');
     args_parser.add_option(disable_syntax_highlight, "Disable live syntax highlighting", "no-syntax-highlight", 's');
     args_parser.add_option(evaluate_script, "Evaluate argument as a script", "evaluate", 'c', "script");
     args_parser.add_positional_argument(script_paths, "Path to script files", "scripts", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
+    // Only the JIT compiler needs to make memory executable.
+    if (!JS::Bytecode::g_jit_enabled)
+        TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction"));
+
     bool syntax_highlight = !disable_syntax_highlight;
 
     s_history_path = TRY(String::formatted("{}/.js-history", Core::StandardPaths::home_directory()));
@@ -619,6 +667,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     g_vm = JS::VM::create();
     g_vm->enable_default_host_import_module_dynamically_hook();
 
+    if (!s_profile_path.is_empty())
+        s_sampling_profiler = make<JS::SamplingProfiler>(*g_vm);
+
     // NOTE: These will print out both warnings when using something like Promise.reject().catch(...) -
     // which is, as far as I can tell, correct - a promise is created, rejected without handler, and a
     // handler then attached to it. The Node.js REPL doesn't warn in this case, so it's something we
@@ -897,5 +948,6 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             return 1;
     }
 
+    dump_statistics_if_requested();
     return 0;
 }
@@ -7,8 +7,10 @@
 
 #include <AK/Function.h>
 #include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
 #include <LibMain/Main.h>
 #include <LibVideo/Containers/Matroska/Reader.h>
+#include <LibVideo/VP9/Decoder.h>
 
 #define TRY_PARSE(expression)                                                                        \
     ({                                                                                               \
@@ -27,11 +29,13 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     StringView filename;
     bool blocks = false;
     bool cues = false;
+    bool decode = false;
     u64 track_number = 0;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(blocks, "Print blocks for each track.", "blocks", 'b');
     args_parser.add_option(cues, "Print cue points for each track.", "cues", 'c');
+    args_parser.add_option(decode, "Decode the frames of VP9 video tracks, and print how fast that was.", "decode", 'd');
     args_parser.add_option<u64>(track_number, "Specify a track number to print info for, omit to print all of them.", "track", 't', "tracknumber");
     args_parser.add_positional_argument(filename, "The video file to display.", "filename", Core::ArgsParser::Required::Yes);
     args_parser.parse(arguments);
@@ -107,6 +111,34 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             }
         }
 
+        if (decode && track_entry.track_type() == Video::Matroska::TrackEntry::TrackType::Video) {
+            if (track_entry.codec_id() != "V_VP9"sv) {
+                outln("\tCan't decode codec \"{}\"", track_entry.codec_id());
+            } else {
+                auto iterator = TRY(reader.create_sample_iterator(track_entry.track_number()));
+                Video::VP9::Decoder decoder;
+                size_t frame_count = 0;
+                auto timer = Core::ElapsedTimer::start_new();
+
+                while (true) {
+                    auto block_result = iterator.next_block();
+                    if (block_result.is_error()) {
+                        if (block_result.error().category() == Video::DecoderErrorCategory::EndOfStream)
+                            break;
+                        return block_result.release_error();
+                    }
+                    for (auto const& frame : block_result.value().frames()) {
+                        TRY(decoder.receive_sample(frame));
+                        while (!decoder.get_decoded_frame().is_error())
+                            frame_count++;
+                    }
+                }
+
+                auto elapsed_microseconds = max<i64>(timer.elapsed_time().to_microseconds(), 1);
+                outln("\tDecoded {} frames in {}ms, at {:.1} frames per second", frame_count, elapsed_microseconds / 1000, static_cast<double>(frame_count) * 1'000'000 / static_cast<double>(elapsed_microseconds));
+            }
+        }
+
         if (track_number != 0)
             return IterationDecision::Break;
 
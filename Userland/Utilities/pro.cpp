@@ -152,6 +152,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool should_follow_url = false;
     bool verbose_output = false;
     char const* data = nullptr;
+    StringView upload_file;
+    StringView upload_encoding;
     StringView proxy_spec;
     DeprecatedString method = "GET";
     StringView method_override;
@@ -164,6 +166,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         "and thus supports at least http, https, and gemini.");
     args_parser.add_option(save_at_provided_name, "Write to a file named as the remote file", nullptr, 'O');
     args_parser.add_option(data, "(HTTP only) Send the provided data via an HTTP POST request", "data", 'd', "data");
+    args_parser.add_option(upload_file, "(HTTP only) Send the contents of the file (or '-' for stdin) via an HTTP PUT request, while it's being read", "upload-file", 'T', "path");
+    args_parser.add_option(upload_encoding, "(HTTP only) Compress the uploaded file on the way, with 'gzip' or 'deflate'", "upload-encoding", 0, "encoding");
     args_parser.add_option(method_override, "(HTTP only) HTTP method to use for the request (eg, GET, POST, etc)", "method", 'm', "method");
     args_parser.add_option(should_follow_url, "(HTTP only) Follow the Location header if a 3xx status is encountered", "follow", 'l');
     args_parser.add_option(Core::ArgsParser::Option {
@@ -214,6 +218,18 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     } else if (data) {
         method = "POST";
         // FIXME: Content-Type?
+    } else if (!upload_file.is_empty()) {
+        method = "PUT";
+    }
+
+    auto body_encoding = HTTP::HttpRequest::BodyEncoding::Identity;
+    if (upload_encoding == "gzip"sv) {
+        body_encoding = HTTP::HttpRequest::BodyEncoding::Gzip;
+    } else if (upload_encoding == "deflate"sv) {
+        body_encoding = HTTP::HttpRequest::BodyEncoding::Deflate;
+    } else if (!upload_encoding.is_empty()) {
+        warnln("Unknown upload encoding '{}'", upload_encoding);
+        return 1;
     }
 
     URL url(url_str);
@@ -401,7 +417,16 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         request->stream_into(output_stream);
     };
 
-    request = protocol_client->start_request(method, url, request_headers, data ? StringView { data, strlen(data) }.bytes() : ReadonlyBytes {}, proxy_data);
+    if (!upload_file.is_empty()) {
+        auto body_fd = upload_file == "-"sv ? TRY(Core::System::dup(STDIN_FILENO)) : TRY(Core::System::open(upload_file, O_RDONLY));
+        request = protocol_client->start_request_with_body_stream(method, url, request_headers, body_fd, body_encoding, proxy_data);
+    } else {
+        request = protocol_client->start_request(method, url, request_headers, data ? StringView { data, strlen(data) }.bytes() : ReadonlyBytes {}, proxy_data);
+    }
+    if (!request) {
+        warnln("Failed to start request for '{}'", url_str);
+        return 1;
+    }
     setup_request();
 
     dbgln("started request with id {}", request->id());
@@ -4,12 +4,120 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
+#include <Kernel/API/Tracepoint.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
 #include <serenity.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static StringView tracepoint_type_name(u16 type)
+{
+    switch (static_cast<TracepointType>(type)) {
+    case TracepointType::SyscallEntry:
+        return "syscall_entry"sv;
+    case TracepointType::SyscallExit:
+        return "syscall_exit"sv;
+    case TracepointType::BlockIOSubmit:
+        return "block_io_submit"sv;
+    case TracepointType::BlockIOComplete:
+        return "block_io_complete"sv;
+    case TracepointType::PageFault:
+        return "page_fault"sv;
+    case TracepointType::ContextSwitch:
+        return "context_switch"sv;
+    case TracepointType::SocketEnqueue:
+        return "socket_enqueue"sv;
+    case TracepointType::SocketDequeue:
+        return "socket_dequeue"sv;
+    default:
+        return "unknown"sv;
+    }
+}
+
+static ErrorOr<u64> parse_tracepoint_mask(StringView names)
+{
+    u64 mask = 0;
+    for (auto name : names.split_view(',')) {
+        if (name == "all"sv)
+            mask |= TRACEPOINT_ALL;
+        else if (name == "syscall"sv)
+            mask |= tracepoint_type_bit(TracepointType::SyscallEntry) | tracepoint_type_bit(TracepointType::SyscallExit);
+        else if (name == "block_io"sv)
+            mask |= tracepoint_type_bit(TracepointType::BlockIOSubmit) | tracepoint_type_bit(TracepointType::BlockIOComplete);
+        else if (name == "page_fault"sv)
+            mask |= tracepoint_type_bit(TracepointType::PageFault);
+        else if (name == "context_switch"sv)
+            mask |= tracepoint_type_bit(TracepointType::ContextSwitch);
+        else if (name == "socket"sv)
+            mask |= tracepoint_type_bit(TracepointType::SocketEnqueue) | tracepoint_type_bit(TracepointType::SocketDequeue);
+        else
+            return Error::from_string_view("Unknown tracepoint group"sv);
+    }
+    return mask;
+}
+
+static Atomic<bool> s_stop_streaming;
+
+// Drains the per-CPU tracepoint rings and prints one line per record until interrupted.
+static ErrorOr<int> stream_tracepoints(u64 mask, Optional<pid_t> filter_pid)
+{
+    int fd = TRY(Core::System::open("/dev/tracepoints"sv, O_RDWR | O_CLOEXEC));
+
+    u32 cpu_count = 0;
+    TRY(Core::System::ioctl(fd, TRACEPOINT_GET_CPU_COUNT, &cpu_count));
+    size_t ring_size = tracepoint_ring_size();
+    auto* rings = static_cast<u8*>(TRY(Core::System::mmap(nullptr, cpu_count * ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0, 0, "Tracepoint rings"sv)));
+
+    // Skip whatever a previous consumer left behind.
+    for (u32 cpu = 0; cpu < cpu_count; ++cpu) {
+        auto& header = *reinterpret_cast<TracepointRingHeader*>(rings + cpu * ring_size);
+        AK::atomic_store(&header.tail, AK::atomic_load(&header.head, AK::MemoryOrder::memory_order_acquire), AK::MemoryOrder::memory_order_release);
+    }
+
+    signal(SIGINT, [](int) { s_stop_streaming = true; });
+
+    TRY(Core::System::ioctl(fd, TRACEPOINT_SET_MASK, static_cast<FlatPtr>(mask)));
+    outln("Streaming tracepoints from {} CPU(s), press Ctrl+C to stop...", cpu_count);
+
+    while (!s_stop_streaming) {
+        bool saw_records = false;
+        for (u32 cpu = 0; cpu < cpu_count; ++cpu) {
+            auto* ring = rings + cpu * ring_size;
+            auto& header = *reinterpret_cast<TracepointRingHeader*>(ring);
+            auto const* entries = reinterpret_cast<TracepointRecord const*>(ring + header.entries_offset);
+            auto head = AK::atomic_load(&header.head, AK::MemoryOrder::memory_order_acquire);
+            auto tail = header.tail;
+            for (; tail != head; ++tail) {
+                auto const& record = entries[tail & header.mask];
+                saw_records = true;
+                if (filter_pid.has_value() && record.pid != filter_pid.value())
+                    continue;
+                outln("{}.{:09} cpu={} pid={} tid={} {} {:#x} {:#x} {:#x}",
+                    record.timestamp_ns / 1'000'000'000, record.timestamp_ns % 1'000'000'000,
+                    record.cpu, record.pid, record.tid, tracepoint_type_name(record.type),
+                    record.args[0], record.args[1], record.args[2]);
+            }
+            AK::atomic_store(&header.tail, tail, AK::MemoryOrder::memory_order_release);
+        }
+        if (!saw_records)
+            usleep(10'000);
+    }
+
+    TRY(Core::System::ioctl(fd, TRACEPOINT_SET_MASK, static_cast<FlatPtr>(0)));
+    for (u32 cpu = 0; cpu < cpu_count; ++cpu) {
+        auto& header = *reinterpret_cast<TracepointRingHeader*>(rings + cpu * ring_size);
+        if (header.dropped)
+            warnln("CPU {}: {} records dropped", cpu, header.dropped);
+    }
+    return 0;
+}
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
@@ -26,6 +134,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         | PERF_EVENT_PROCESS_EXEC | PERF_EVENT_PROCESS_EXIT | PERF_EVENT_THREAD_CREATE | PERF_EVENT_THREAD_EXIT
         | PERF_EVENT_SIGNPOST;
     bool seen_event_type_arg = false;
+    StringView tracepoints_argument {};
 
     args_parser.add_option(pid_argument, "Target PID", nullptr, 'p', "PID");
     args_parser.add_option(all_processes, "Profile all processes (super-user only), result at /sys/kernel/profile", nullptr, 'a');
@@ -52,18 +161,22 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                 event_mask |= PERF_EVENT_SYSCALL;
             else if (event_type == "read")
                 event_mask |= PERF_EVENT_READ;
+            else if (event_type == "off_cpu")
+                event_mask |= PERF_EVENT_OFF_CPU;
             else {
                 warnln("Unknown event type '{}' specified.", event_type);
                 exit(1);
             }
             return true;
         } });
+    args_parser.add_option(tracepoints_argument, "Stream kernel tracepoints live (super-user only)", "tracepoints", 'T', "group,...");
     args_parser.add_positional_argument(command, "Command to profile", "command", Core::ArgsParser::Required::No);
     args_parser.set_stop_on_first_non_option(true);
 
     auto print_types = [] {
         outln();
-        outln("Event type can be one of: sample, context_switch, page_fault, syscall, read, kmalloc and kfree.");
+        outln("Event type can be one of: sample, context_switch, page_fault, syscall, read, off_cpu, kmalloc and kfree.");
+        outln("Tracepoint groups can be any of: syscall, block_io, page_fault, context_switch, socket and all.");
     };
 
     if (!args_parser.parse(arguments, Core::ArgsParser::FailureBehavior::PrintUsage)) {
@@ -71,6 +184,25 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         exit(0);
     }
 
+    if (!tracepoints_argument.is_empty()) {
+        auto mask_or_error = parse_tracepoint_mask(tracepoints_argument);
+        if (mask_or_error.is_error()) {
+            warnln("Unknown tracepoint group in '{}'.", tracepoints_argument);
+            print_types();
+            return 1;
+        }
+        Optional<pid_t> filter_pid;
+        if (!pid_argument.is_empty()) {
+            auto maybe_pid = pid_argument.to_int();
+            if (!maybe_pid.has_value()) {
+                warnln("Invalid PID '{}'.", pid_argument);
+                return 1;
+            }
+            filter_pid = maybe_pid.value();
+        }
+        return stream_tracepoints(mask_or_error.value(), filter_pid);
+    }
+
     if (pid_argument.is_empty() && command.is_empty() && !all_processes) {
         args_parser.print_usage(stdout, arguments.argv[0]);
         print_types();
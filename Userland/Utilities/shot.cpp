@@ -22,6 +22,7 @@
 #include <LibGfx/PNGWriter.h>
 #include <LibGfx/Palette.h>
 #include <LibMain/Main.h>
+#include <LibThreading/ThreadPool.h>
 #include <unistd.h>
 
 class SelectableLayover final : public GUI::Widget {
@@ -150,7 +151,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return 0;
     }
 
-    auto encoded_bitmap_or_error = Gfx::PNGWriter::encode(*bitmap);
+    Gfx::PNGWriter::set_encoding_thread_pool(&Threading::ThreadPool::the());
+    auto encoded_bitmap_or_error = Gfx::PNGWriter::encode(*bitmap, { .compression_level = Compress::ZlibCompressionLevel::Fast });
     if (encoded_bitmap_or_error.is_error()) {
         warnln("Failed to encode PNG");
         return 1;
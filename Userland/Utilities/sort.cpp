@@ -6,14 +6,18 @@
  */
 
 #include <AK/DeprecatedString.h>
+#include <AK/Function.h>
 #include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
 #include <AK/QuickSort.h>
 #include <AK/Vector.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/File.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <LibThreading/ThreadPool.h>
 #include <ctype.h>
+#include <string.h>
 
 struct Line {
     StringView key;
@@ -51,15 +55,150 @@ struct AK::Traits<Line> : public GenericTraits<Line> {
     }
 };
 
+// Once the lines that are held in memory take up this much, they're sorted and written to a temporary file, and the
+// sorted files are merged at the end.
+static constexpr size_t default_buffer_size = 64 * MiB;
+// How many temporary files are merged at once. If there are more, groups of them are merged into one first.
+static constexpr size_t max_merged_runs = 16;
+static constexpr size_t parallel_sort_threshold = 64 * KiB;
+
 struct Options {
     size_t key_field { 0 };
     bool unique { false };
     bool numeric { false };
     StringView separator { "\0", 1 };
+    size_t buffer_size { default_buffer_size };
     Vector<DeprecatedString> files;
 };
 
-static ErrorOr<void> load_file(Options options, StringView filename, Vector<Line>& lines, HashTable<Line>& seen)
+// A sorted part of the input, which is read back one line at a time while merging.
+struct Run {
+    NonnullOwnPtr<Core::BufferedFile> file;
+    Optional<Line> current_line;
+};
+
+struct SortState {
+    Vector<Line> lines;
+    HashTable<Line> seen;
+    size_t buffered_bytes { 0 };
+    Vector<Run> runs;
+};
+
+static Line make_line(Options const& options, DeprecatedString line)
+{
+    StringView key = line;
+    if (options.key_field != 0) {
+        auto split = (options.separator[0])
+            ? line.split_view(options.separator[0])
+            : line.split_view(isspace);
+        if (options.key_field - 1 >= split.size()) {
+            key = ""sv;
+        } else {
+            key = split[options.key_field - 1];
+        }
+    }
+
+    return { key, key.to_int().value_or(0), move(line), options.numeric };
+}
+
+static ErrorOr<void> read_next_line(Options const& options, Run& run, ByteBuffer& buffer)
+{
+    if (!TRY(run.file->can_read_line())) {
+        run.current_line.clear();
+        return {};
+    }
+    run.current_line = make_line(options, TRY(run.file->read_line(buffer)));
+    return {};
+}
+
+static ErrorOr<Run> create_run(Options const& options, Function<ErrorOr<void>(Function<ErrorOr<void>(Line const&)>)> produce_lines)
+{
+    char path[] = "/tmp/sort.XXXXXX";
+    auto fd = TRY(Core::System::mkstemp(path));
+    // Nobody else needs to find the file, and this way it's gone as soon as we're done with it.
+    TRY(Core::System::unlink({ path, strlen(path) }));
+    auto file = TRY(Core::File::adopt_fd(fd, Core::File::OpenMode::ReadWrite));
+
+    StringBuilder output;
+    TRY(produce_lines([&](Line const& line) -> ErrorOr<void> {
+        TRY(output.try_append(line.line));
+        TRY(output.try_append('\n'));
+        if (output.length() >= 64 * KiB) {
+            TRY(file->write_entire_buffer(output.string_view().bytes()));
+            output.clear();
+        }
+        return {};
+    }));
+    TRY(file->write_entire_buffer(output.string_view().bytes()));
+    TRY(file->seek(0, SeekMode::SetPosition));
+
+    Run run { TRY(Core::BufferedFile::create(move(file))), {} };
+    auto buffer = TRY(ByteBuffer::create_uninitialized(4096));
+    TRY(read_next_line(options, run, buffer));
+    return run;
+}
+
+// Calls the callback with the lines of all runs in order. With ties, lines from earlier runs come first, as they came
+// first in the input.
+static ErrorOr<void> merge_runs(Options const& options, Span<Run> runs, Function<ErrorOr<void>(Line const&)> const& callback)
+{
+    auto buffer = TRY(ByteBuffer::create_uninitialized(4096));
+    Optional<Line> last_line;
+    while (true) {
+        Run* next_run = nullptr;
+        for (auto& run : runs) {
+            if (run.current_line.has_value() && (!next_run || *run.current_line < *next_run->current_line))
+                next_run = &run;
+        }
+        if (!next_run)
+            return {};
+
+        // Every run is unique by itself already, so only lines from different runs can be the same.
+        if (!options.unique || !last_line.has_value() || !(*last_line == *next_run->current_line))
+            TRY(callback(*next_run->current_line));
+
+        if (options.unique)
+            last_line = next_run->current_line.release_value();
+        TRY(read_next_line(options, *next_run, buffer));
+    }
+}
+
+static ErrorOr<void> sort_lines(Vector<Line>& lines)
+{
+    // Starting up the thread pool isn't worth it for the small inputs sort is usually given.
+    if (lines.size() < parallel_sort_threshold) {
+        quick_sort(lines);
+        return {};
+    }
+    return Threading::parallel_sort(lines.span());
+}
+
+// Writes the lines held in memory to a temporary file, which is merged with the others at the end.
+static ErrorOr<void> spill_lines(Options const& options, SortState& state)
+{
+    TRY(sort_lines(state.lines));
+    auto run = TRY(create_run(options, [&](auto callback) -> ErrorOr<void> {
+        for (auto& line : state.lines)
+            TRY(callback(line));
+        return {};
+    }));
+    TRY(state.runs.try_append(move(run)));
+
+    state.lines.clear();
+    state.seen.clear();
+    state.buffered_bytes = 0;
+
+    if (state.runs.size() >= max_merged_runs) {
+        auto merged_run = TRY(create_run(options, [&](auto callback) {
+            return merge_runs(options, state.runs.span(), callback);
+        }));
+        state.runs.clear();
+        TRY(state.runs.try_append(move(merged_run)));
+    }
+    return {};
+}
+
+static ErrorOr<void> load_file(Options const& options, StringView filename, SortState& state)
 {
     auto file = TRY(Core::BufferedFile::create(
         TRY(Core::File::open_file_or_standard_stream(filename, Core::File::OpenMode::Read))));
@@ -68,25 +207,18 @@ static ErrorOr<void> load_file(Options options, StringView filename, Vector<Line
     auto buffer = TRY(ByteBuffer::create_uninitialized(4096));
     while (TRY(file->can_read_line())) {
         DeprecatedString line = TRY(file->read_line(buffer));
+        auto line_length = line.length();
 
-        StringView key = line;
-        if (options.key_field != 0) {
-            auto split = (options.separator[0])
-                ? line.split_view(options.separator[0])
-                : line.split_view(isspace);
-            if (options.key_field - 1 >= split.size()) {
-                key = ""sv;
-            } else {
-                key = split[options.key_field - 1];
-            }
-        }
-
-        Line l = { key, key.to_int().value_or(0), line, options.numeric };
+        Line l = make_line(options, move(line));
 
-        if (!options.unique || !seen.contains(l)) {
-            lines.append(l);
+        if (!options.unique || !state.seen.contains(l)) {
+            state.lines.append(l);
             if (options.unique)
-                seen.set(l);
+                state.seen.set(l);
+
+            state.buffered_bytes += line_length + sizeof(Line);
+            if (state.buffered_bytes >= options.buffer_size)
+                TRY(spill_lines(options, state));
         }
     }
 
@@ -95,7 +227,7 @@ static ErrorOr<void> load_file(Options options, StringView filename, Vector<Line
 
 ErrorOr<int> serenity_main([[maybe_unused]] Main::Arguments arguments)
 {
-    TRY(Core::System::pledge("stdio rpath"));
+    TRY(Core::System::pledge("stdio rpath wpath cpath thread"));
 
     Options options;
 
@@ -104,25 +236,37 @@ ErrorOr<int> serenity_main([[maybe_unused]] Main::Arguments arguments)
     args_parser.add_option(options.unique, "Don't emit duplicate lines", "unique", 'u');
     args_parser.add_option(options.numeric, "treat the key field as a number", "numeric", 'n');
     args_parser.add_option(options.separator, "The separator to split fields by", "sep", 't', "char");
+    args_parser.add_option(options.buffer_size, "How many bytes of lines to sort in memory before using temporary files", "buffer-size", 'S', "size");
     args_parser.add_positional_argument(options.files, "Files to sort", "file", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
-    Vector<Line> lines;
-    HashTable<Line> seen;
+    SortState state;
 
     if (options.files.size() == 0) {
-        TRY(load_file(options, "-"sv, lines, seen));
+        TRY(load_file(options, "-"sv, state));
     } else {
         for (auto& file : options.files) {
-            TRY(load_file(options, file, lines, seen));
+            TRY(load_file(options, file, state));
         }
     }
 
-    quick_sort(lines);
+    if (state.runs.is_empty()) {
+        TRY(sort_lines(state.lines));
 
-    for (auto& line : lines) {
-        outln("{}", line.line);
+        for (auto& line : state.lines) {
+            outln("{}", line.line);
+        }
+
+        return 0;
     }
 
+    if (!state.lines.is_empty())
+        TRY(spill_lines(options, state));
+
+    TRY(merge_runs(options, state.runs.span(), [](Line const& line) -> ErrorOr<void> {
+        outln("{}", line.line);
+        return {};
+    }));
+
     return 0;
 }
@@ -73,6 +73,28 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         HashMap<DeprecatedString, DeprecatedString> global_overrides;
         HashMap<DeprecatedString, DeprecatedString> local_overrides;
 
+        // Only the members that were asked for are listed or extracted. The contents of all the others are skipped,
+        // which is a seek rather than a read if the archive is an uncompressed file.
+        Vector<DeprecatedString> selected_paths;
+        for (auto const& path : paths)
+            selected_paths.append(LexicalPath::canonicalized_path(path));
+        Vector<bool> path_was_found;
+        path_was_found.resize(paths.size());
+        auto is_selected = [&](StringView filename) {
+            if (paths.is_empty())
+                return true;
+            auto member_path = LexicalPath::canonicalized_path(filename);
+            bool is_selected = false;
+            for (size_t i = 0; i < selected_paths.size(); ++i) {
+                auto const& path = selected_paths[i];
+                if (member_path == path || (member_path.starts_with(path) && member_path[path.length()] == '/')) {
+                    path_was_found[i] = true;
+                    is_selected = true;
+                }
+            }
+            return is_selected;
+        };
+
         auto get_override = [&](StringView key) -> Optional<DeprecatedString> {
             Optional<DeprecatedString> maybe_local = local_overrides.get(key);
 
@@ -145,6 +167,12 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                 path = path.prepend(header.prefix());
             DeprecatedString filename = get_override("path"sv).value_or(path.string());
 
+            if (!is_selected(filename)) {
+                local_overrides.clear();
+                TRY(tar_stream->advance());
+                continue;
+            }
+
             if (list || verbose)
                 outln("{}", filename);
 
@@ -196,7 +224,15 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             TRY(tar_stream->advance());
         }
 
-        return 0;
+        bool all_paths_were_found = true;
+        for (size_t i = 0; i < paths.size(); ++i) {
+            if (!path_was_found[i]) {
+                warnln("{}: Not found in archive", paths[i]);
+                all_paths_were_found = false;
+            }
+        }
+
+        return all_paths_were_found ? 0 : 1;
     }
 
     if (create) {
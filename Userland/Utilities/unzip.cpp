@@ -5,17 +5,20 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/Atomic.h>
 #include <AK/DOSPackedTime.h>
+#include <AK/MemoryStream.h>
 #include <AK/NumberFormat.h>
 #include <AK/StringUtils.h>
 #include <LibArchive/Zip.h>
 #include <LibCompress/Deflate.h>
 #include <LibCore/ArgsParser.h>
-#include <LibCore/DeprecatedFile.h>
 #include <LibCore/Directory.h>
+#include <LibCore/File.h>
 #include <LibCore/MappedFile.h>
 #include <LibCore/System.h>
 #include <LibCrypto/Checksum/CRC32.h>
+#include <LibThreading/ThreadPool.h>
 #include <sys/stat.h>
 
 static ErrorOr<void> adjust_modification_time(Archive::ZipMember const& zip_member)
@@ -30,71 +33,76 @@ static ErrorOr<void> adjust_modification_time(Archive::ZipMember const& zip_memb
     return Core::System::utime(zip_member.name, buf);
 }
 
-static bool unpack_zip_member(Archive::ZipMember zip_member, bool quiet)
+static bool create_zip_directory(Archive::ZipMember const& zip_member, bool quiet)
 {
-    if (zip_member.is_directory) {
-        if (auto maybe_error = Core::System::mkdir(zip_member.name, 0755); maybe_error.is_error()) {
-            warnln("Failed to create directory '{}': {}", zip_member.name, maybe_error.error());
-            return false;
-        }
-        if (!quiet)
-            outln(" extracting: {}", zip_member.name);
-        return true;
-    }
-    MUST(Core::Directory::create(LexicalPath(zip_member.name.to_deprecated_string()).parent(), Core::Directory::CreateDirectories::Yes));
-    auto new_file = Core::DeprecatedFile::construct(zip_member.name.to_deprecated_string());
-    if (!new_file->open(Core::OpenMode::WriteOnly)) {
-        warnln("Can't write file {}: {}", zip_member.name, new_file->error_string());
+    if (auto maybe_error = Core::System::mkdir(zip_member.name, 0755); maybe_error.is_error()) {
+        warnln("Failed to create directory '{}': {}", zip_member.name, maybe_error.error());
         return false;
     }
-
     if (!quiet)
         outln(" extracting: {}", zip_member.name);
+    return true;
+}
 
-    Crypto::Checksum::CRC32 checksum;
+static ErrorOr<void> write_zip_member_contents(Archive::ZipMember const& zip_member, Stream& output_file, Crypto::Checksum::CRC32& checksum)
+{
     switch (zip_member.compression_method) {
     case Archive::ZipCompressionMethod::Store: {
-        if (!new_file->write(zip_member.compressed_data.data(), zip_member.compressed_data.size())) {
-            warnln("Can't write file contents in {}: {}", zip_member.name, new_file->error_string());
-            return false;
-        }
-        checksum.update({ zip_member.compressed_data.data(), zip_member.compressed_data.size() });
-        break;
+        // The contents are written straight out of the mapped archive.
+        TRY(output_file.write_entire_buffer(zip_member.compressed_data));
+        checksum.update(zip_member.compressed_data);
+        return {};
     }
     case Archive::ZipCompressionMethod::Deflate: {
-        auto decompressed_data = Compress::DeflateDecompressor::decompress_all(zip_member.compressed_data);
-        if (decompressed_data.is_error()) {
-            warnln("Failed decompressing file {}: {}", zip_member.name, decompressed_data.error());
-            return false;
-        }
-        if (decompressed_data.value().size() != zip_member.uncompressed_size) {
-            warnln("Failed decompressing file {}", zip_member.name);
-            return false;
+        // The contents are decompressed a buffer at a time, so that a large member being extracted on each thread
+        // doesn't have to fit in memory all at once.
+        FixedMemoryStream compressed_stream { zip_member.compressed_data };
+        auto deflate_stream = TRY(Compress::DeflateDecompressor::construct(MaybeOwned<Stream>(compressed_stream)));
+        auto buffer = TRY(ByteBuffer::create_uninitialized(64 * KiB));
+        size_t decompressed_size = 0;
+        while (!deflate_stream->is_eof()) {
+            auto slice = TRY(deflate_stream->read(buffer));
+            if (slice.is_empty())
+                break;
+            TRY(output_file.write_entire_buffer(slice));
+            checksum.update(slice);
+            decompressed_size += slice.size();
         }
-        if (!new_file->write(decompressed_data.value().data(), decompressed_data.value().size())) {
-            warnln("Can't write file contents in {}: {}", zip_member.name, new_file->error_string());
-            return false;
-        }
-        checksum.update({ decompressed_data.value().data(), decompressed_data.value().size() });
-        break;
+        if (decompressed_size != zip_member.uncompressed_size)
+            return Error::from_string_literal("Decompressed size doesn't match the archive");
+        return {};
     }
     default:
         VERIFY_NOT_REACHED();
     }
+}
 
-    if (adjust_modification_time(zip_member).is_error()) {
-        warnln("Failed setting modification_time for file {}", zip_member.name);
+// NOTE: This runs on the threads of the pool, so it mustn't copy the member, or anything else that's reference counted.
+static bool unpack_zip_member(Archive::ZipMember const& zip_member)
+{
+    auto name = zip_member.name.bytes_as_string_view();
+    auto new_file_or_error = Core::File::open(name, Core::File::OpenMode::Write);
+    if (new_file_or_error.is_error()) {
+        warnln("Can't write file {}: {}", name, new_file_or_error.error());
+        return false;
+    }
+    auto new_file = new_file_or_error.release_value();
+
+    Crypto::Checksum::CRC32 checksum;
+    if (auto result = write_zip_member_contents(zip_member, *new_file, checksum); result.is_error()) {
+        warnln("Failed decompressing file {}: {}", name, result.error());
         return false;
     }
+    new_file->close();
 
-    if (!new_file->close()) {
-        warnln("Can't close file {}: {}", zip_member.name, new_file->error_string());
+    if (adjust_modification_time(zip_member).is_error()) {
+        warnln("Failed setting modification_time for file {}", name);
         return false;
     }
 
     if (checksum.digest() != zip_member.crc32) {
-        warnln("Failed decompressing file {}: CRC32 mismatch", zip_member.name);
-        MUST(Core::DeprecatedFile::remove(zip_member.name, Core::DeprecatedFile::RecursionMode::Disallowed));
+        warnln("Failed decompressing file {}: CRC32 mismatch", name);
+        MUST(Core::System::unlink(name));
         return false;
     }
 
@@ -107,10 +115,12 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool quiet { false };
     StringView output_directory_path;
     Vector<StringView> file_filters;
+    size_t thread_count { 0 };
 
     Core::ArgsParser args_parser;
     args_parser.add_option(output_directory_path, "Directory to receive the archive content", "output-directory", 'd', "path");
     args_parser.add_option(quiet, "Be less verbose", "quiet", 'q');
+    args_parser.add_option(thread_count, "Extract on this many threads (0 for one per processor)", "threads", 'T', "count");
     args_parser.add_positional_argument(zip_file_path, "File to unzip", "path", Core::ArgsParser::Required::Yes);
     args_parser.add_positional_argument(file_filters, "Files or filters in the archive to extract", "files", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
@@ -142,6 +152,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     }
 
     Vector<Archive::ZipMember> zip_directories;
+    Vector<Archive::ZipMember> zip_files;
 
     auto success = TRY(zip_file->for_each_member([&](auto zip_member) {
         bool keep_file = false;
@@ -160,10 +171,20 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         }
 
         if (keep_file) {
-            if (!unpack_zip_member(zip_member, quiet))
-                return IterationDecision::Break;
-            if (zip_member.is_directory)
+            if (zip_member.is_directory) {
+                if (!create_zip_directory(zip_member, quiet))
+                    return IterationDecision::Break;
                 zip_directories.append(zip_member);
+            } else {
+                // Members don't depend on each other, so the files are only extracted below, all at once.
+                if (auto result = Core::Directory::create(LexicalPath(zip_member.name.to_deprecated_string()).parent(), Core::Directory::CreateDirectories::Yes); result.is_error()) {
+                    warnln("Failed to create the directory for '{}': {}", zip_member.name, result.error());
+                    return IterationDecision::Break;
+                }
+                if (!quiet)
+                    outln(" extracting: {}", zip_member.name);
+                zip_files.append(zip_member);
+            }
         }
 
         return IterationDecision::Continue;
@@ -173,6 +194,18 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return 1;
     }
 
+    auto thread_pool = TRY(try_make<Threading::ThreadPool>(thread_count == 0 ? Threading::ThreadPool::default_worker_count() : thread_count));
+    Atomic<bool> all_files_unpacked { true };
+    Threading::parallel_for(
+        zip_files.size(), [&](size_t i) {
+            if (!unpack_zip_member(zip_files[i]))
+                all_files_unpacked.store(false);
+        },
+        1, *thread_pool);
+
+    if (!all_files_unpacked.load())
+        return 1;
+
     for (auto& directory : zip_directories) {
         if (adjust_modification_time(directory).is_error()) {
             warnln("Failed setting modification time for directory {}", directory.name);